@@ -0,0 +1,982 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+// afft-bench: sweeps the spst cpu dft plans over the enabled backends and reports the planning and the execution
+// times in JSON or CSV. Given a baseline from a previous run, it flags the cases that became significantly slower.
+// Run `afft-bench --help` for the options.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <afft/afft.hpp>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief Benchmark options.
+  struct Options
+  {
+    std::vector<std::vector<std::size_t>> shapes{{1024}, {4096}, {256, 256}};
+    std::vector<std::size_t>              batches{1};
+    std::vector<afft::Precision>          precisions{afft::Precision::f32, afft::Precision::f64};
+    std::vector<afft::dft::Type>          types{afft::dft::Type::complexToComplex};
+    std::vector<afft::Placement>          placements{afft::Placement::outOfPlace};
+    std::vector<afft::ComplexFormat>      layouts{afft::ComplexFormat::interleaved};
+    std::vector<afft::Backend>            backends{};
+    std::size_t                           iterations{20};
+    std::size_t                           repeats{1};
+    unsigned                              threadLimit{1};
+    bool                                  csv{};
+    std::string                           output{};
+    std::string                           baseline{};
+    double                                threshold{0.05};
+  };
+
+  /// @brief Result of one benchmark case.
+  struct Result
+  {
+    afft::Backend            backend{};
+    std::vector<std::size_t> shape{};
+    std::size_t              batch{};
+    afft::Precision          precision{};
+    afft::dft::Type          type{};
+    afft::Placement          placement{};
+    afft::ComplexFormat      layout{};
+    std::string              status{};
+    double                   planTime{};
+    double                   firstExecTime{};
+    double                   meanExecTime{};
+    double                   minExecTime{};
+    double                   gflops{};
+    double                   bytesPerSecond{};
+    std::size_t              workspaceBytes{};
+    std::size_t              hostMemoryBytes{};
+    double                   medianExecTime{};
+    double                   ciLowExecTime{};
+    double                   ciHighExecTime{};
+    std::optional<double>    baselineMedianExecTime{};
+    std::string              verdict{};
+    double                   cyclesPerExec{};
+    double                   llcMissesPerExec{};
+    double                   dramBytesPerExec{};
+    double                   flopsPerDramByte{};
+  };
+
+  /// @brief Baseline of one benchmark case, read from the JSON output of a previous run.
+  struct BaselineCase
+  {
+    std::string key{};
+    bool        isOk{};
+    double      medianExecTime{};
+    double      ciLowExecTime{};
+    double      ciHighExecTime{};
+  };
+
+  /// @brief Backend names accepted on the command line.
+  constexpr std::pair<std::string_view, afft::Backend> backendNames[]
+  {
+    {"clfft",     afft::Backend::clfft},
+    {"cufft",     afft::Backend::cufft},
+    {"fftw3",     afft::Backend::fftw3},
+    {"heffte",    afft::Backend::heffte},
+    {"hipfft",    afft::Backend::hipfft},
+    {"mkl",       afft::Backend::mkl},
+    {"pocketfft", afft::Backend::pocketfft},
+    {"rocfft",    afft::Backend::rocfft},
+    {"vkfft",     afft::Backend::vkfft},
+    {"codelet",   afft::Backend::codelet},
+  };
+
+  [[noreturn]] void fail(const std::string& message)
+  {
+    std::fprintf(stderr, "afft-bench: %s, see --help\n", message.c_str());
+    std::exit(EXIT_FAILURE);
+  }
+
+  void printHelp()
+  {
+    std::printf(
+      "Usage: afft-bench [options]\n"
+      "Benchmarks the spst cpu dft plans of every enabled backend.\n"
+      "\n"
+      "  --shapes LIST      comma separated shapes, dimensions joined by 'x' (default 1024,4096,256x256)\n"
+      "  --batches LIST     comma separated batch sizes, an outer non-transformed axis (default 1)\n"
+      "  --precisions LIST  f32,f64 (default f32,f64)\n"
+      "  --types LIST       c2c,r2c,c2r (default c2c)\n"
+      "  --placements LIST  out,in (default out)\n"
+      "  --layouts LIST     interleaved,planar (default interleaved)\n"
+      "  --backends LIST    backend names (default every cpu backend, unavailable ones are reported as failed)\n"
+      "  --corpus FILE      read the shapes from the file, one per line, '#' starts a comment\n"
+      "  --iterations N     measured executions per repeat (default 20)\n"
+      "  --repeats N        repeats of the measured executions, each gives one sample of the mean (default 1)\n"
+      "  --threads N        thread limit, 0 for no limit (default 1)\n"
+      "  --format FORMAT    json or csv (default json)\n"
+      "  --output FILE      write the results to the file instead of the standard output\n"
+      "  --baseline FILE    compare against the JSON output of a previous run, exit with 1 on a regression\n"
+      "  --threshold R      relative slowdown of the median counted as a regression (default 0.05)\n"
+      "\n"
+      "GFLOP/s follow the 5 N log2(N) convention per complex transform of N elements, 2.5 N log2(N) for\n"
+      "the real ones. Bytes/s count the source read and the destination written by each execution.\n"
+      "The csv output calibrates the cost model of afft::estimate(), see afft::CalibrationTable.\n"
+      "\n"
+      "The median and its 95%% distribution free confidence interval are taken over the repeats. A case regressed\n"
+      "if its median is slower than the baseline one by more than the threshold and the confidence intervals do\n"
+      "not overlap, or if it failed while the baseline succeeded. Use 10 or more repeats for a baseline.\n");
+  }
+
+  [[nodiscard]] std::vector<std::string> split(std::string_view str, char delim)
+  {
+    std::vector<std::string> parts{};
+
+    while (true)
+    {
+      const auto pos = str.find(delim);
+
+      parts.emplace_back(str.substr(0, pos));
+
+      if (pos == std::string_view::npos)
+      {
+        break;
+      }
+
+      str.remove_prefix(pos + 1);
+    }
+
+    return parts;
+  }
+
+  [[nodiscard]] std::size_t parseSize(const std::string& str)
+  {
+    char* end{};
+
+    const auto value = std::strtoull(str.c_str(), &end, 10);
+
+    if (str.empty() || *end != '\0')
+    {
+      fail("invalid number '" + str + "'");
+    }
+
+    return static_cast<std::size_t>(value);
+  }
+
+  [[nodiscard]] double parseReal(const std::string& str)
+  {
+    char* end{};
+
+    const auto value = std::strtod(str.c_str(), &end);
+
+    if (str.empty() || *end != '\0')
+    {
+      fail("invalid number '" + str + "'");
+    }
+
+    return value;
+  }
+
+  [[nodiscard]] std::vector<std::size_t> parseShape(const std::string& str)
+  {
+    std::vector<std::size_t> shape{};
+
+    for (const auto& dim : split(str, 'x'))
+    {
+      shape.push_back(parseSize(dim));
+    }
+
+    return shape;
+  }
+
+  /**
+   * @brief Read the shapes of a corpus file, one per line. Blank lines and the text after '#' are ignored.
+   * @param path Path to the file.
+   * @return Shapes.
+   */
+  [[nodiscard]] std::vector<std::vector<std::size_t>> readCorpus(const std::string& path)
+  {
+    std::ifstream file{path};
+
+    if (!file.is_open())
+    {
+      fail("cannot open corpus '" + path + "'");
+    }
+
+    std::vector<std::vector<std::size_t>> shapes{};
+    std::string                           line{};
+
+    while (std::getline(file, line))
+    {
+      line = line.substr(0, line.find('#'));
+
+      const auto first = line.find_first_not_of(" \t\r");
+
+      if (first == std::string::npos)
+      {
+        continue;
+      }
+
+      shapes.push_back(parseShape(line.substr(first, line.find_last_not_of(" \t\r") - first + 1)));
+    }
+
+    if (shapes.empty())
+    {
+      fail("corpus '" + path + "' has no shapes");
+    }
+
+    return shapes;
+  }
+
+  template<typename T>
+  [[nodiscard]] std::vector<T> parseList(const std::string& list, const std::function<T(const std::string&)>& parse)
+  {
+    std::vector<T> values{};
+
+    for (const auto& item : split(list, ','))
+    {
+      values.push_back(parse(item));
+    }
+
+    return values;
+  }
+
+  [[nodiscard]] Options parseOptions(int argc, char** argv)
+  {
+    Options options{};
+
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string_view arg{argv[i]};
+
+      if (arg == "--help" || arg == "-h")
+      {
+        printHelp();
+        std::exit(EXIT_SUCCESS);
+      }
+
+      if (i + 1 >= argc)
+      {
+        fail("missing value of '" + std::string{arg} + "'");
+      }
+
+      const std::string value{argv[++i]};
+
+      if (arg == "--shapes")
+      {
+        options.shapes = parseList<std::vector<std::size_t>>(value, parseShape);
+      }
+      else if (arg == "--corpus")
+      {
+        options.shapes = readCorpus(value);
+      }
+      else if (arg == "--batches")
+      {
+        options.batches = parseList<std::size_t>(value, parseSize);
+      }
+      else if (arg == "--precisions")
+      {
+        options.precisions = parseList<afft::Precision>(value, [](const std::string& item)
+        {
+          if (item == "f32") return afft::Precision::f32;
+          if (item == "f64") return afft::Precision::f64;
+          fail("invalid precision '" + item + "'");
+        });
+      }
+      else if (arg == "--types")
+      {
+        options.types = parseList<afft::dft::Type>(value, [](const std::string& item)
+        {
+          if (item == "c2c") return afft::dft::Type::complexToComplex;
+          if (item == "r2c") return afft::dft::Type::realToComplex;
+          if (item == "c2r") return afft::dft::Type::complexToReal;
+          fail("invalid type '" + item + "'");
+        });
+      }
+      else if (arg == "--placements")
+      {
+        options.placements = parseList<afft::Placement>(value, [](const std::string& item)
+        {
+          if (item == "out") return afft::Placement::outOfPlace;
+          if (item == "in") return afft::Placement::inPlace;
+          fail("invalid placement '" + item + "'");
+        });
+      }
+      else if (arg == "--layouts")
+      {
+        options.layouts = parseList<afft::ComplexFormat>(value, [](const std::string& item)
+        {
+          if (item == "interleaved") return afft::ComplexFormat::interleaved;
+          if (item == "planar") return afft::ComplexFormat::planar;
+          fail("invalid layout '" + item + "'");
+        });
+      }
+      else if (arg == "--backends")
+      {
+        options.backends = parseList<afft::Backend>(value, [](const std::string& item)
+        {
+          const auto it = std::find_if(std::begin(backendNames), std::end(backendNames), [&](const auto& name)
+          {
+            return name.first == item;
+          });
+
+          if (it == std::end(backendNames))
+          {
+            fail("invalid backend '" + item + "'");
+          }
+
+          return it->second;
+        });
+      }
+      else if (arg == "--iterations")
+      {
+        options.iterations = std::max(parseSize(value), std::size_t{1});
+      }
+      else if (arg == "--repeats")
+      {
+        options.repeats = std::max(parseSize(value), std::size_t{1});
+      }
+      else if (arg == "--threads")
+      {
+        options.threadLimit = static_cast<unsigned>(parseSize(value));
+      }
+      else if (arg == "--format")
+      {
+        if (value != "json" && value != "csv")
+        {
+          fail("invalid format '" + value + "'");
+        }
+
+        options.csv = (value == "csv");
+      }
+      else if (arg == "--output")
+      {
+        options.output = value;
+      }
+      else if (arg == "--baseline")
+      {
+        options.baseline = value;
+      }
+      else if (arg == "--threshold")
+      {
+        options.threshold = parseReal(value);
+
+        if (!(options.threshold >= 0.0))
+        {
+          fail("threshold must not be negative");
+        }
+      }
+      else
+      {
+        fail("unknown option '" + std::string{arg} + "'");
+      }
+    }
+
+    if (options.backends.empty())
+    {
+      for (const auto& [name, backend] : backendNames)
+      {
+        if ((afft::cpu::supportedBackendMask & backend) != afft::BackendMask::empty)
+        {
+          options.backends.push_back(backend);
+        }
+      }
+    }
+
+    return options;
+  }
+
+  [[nodiscard]] double secondsSince(Clock::time_point start)
+  {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  /**
+   * @brief Set the median of the samples and its 95% confidence interval. The interval is bounded by the order
+   *        statistics of ranks n/2 -+ 0.98 sqrt(n), the normal approximation of the binomial distribution of the rank
+   *        of the median, so it assumes nothing about the distribution of the times.
+   * @param samples Samples, reordered.
+   * @param result Result.
+   */
+  void setMedian(std::vector<double>& samples, Result& result)
+  {
+    std::sort(samples.begin(), samples.end());
+
+    const std::size_t n      = samples.size();
+    const double      spread = 0.98 * std::sqrt(static_cast<double>(n));
+    const double      center = static_cast<double>(n) / 2.0;
+
+    result.medianExecTime = (n % 2 == 1) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+    result.ciLowExecTime  = samples[static_cast<std::size_t>(std::max(std::floor(center - spread), 0.0))];
+    result.ciHighExecTime = samples[std::min(static_cast<std::size_t>(std::ceil(center + spread)), n - 1)];
+  }
+
+  /**
+   * @brief Plan and execute one case.
+   * @param options Benchmark options.
+   * @param result Result with the case set, the measurements are filled in.
+   */
+  void runCase(const Options& options, Result& result)
+  {
+    std::vector<std::size_t> shape{result.batch};
+    std::vector<std::size_t> axes{};
+
+    for (const auto dim : result.shape)
+    {
+      axes.push_back(shape.size());
+      shape.push_back(dim);
+    }
+
+    if (result.batch == 1)
+    {
+      shape.erase(shape.begin());
+      std::for_each(axes.begin(), axes.end(), [](auto& axis) { --axis; });
+    }
+
+    if (shape.size() > afft::maxDimCount)
+    {
+      result.status = "shape rank exceeds AFFT_MAX_DIM_COUNT";
+      return;
+    }
+
+    const bool        isReal      = (result.type != afft::dft::Type::complexToComplex);
+    const std::size_t realSize    = (result.precision == afft::Precision::f32) ? sizeof(float) : sizeof(double);
+    const std::size_t lastDim     = shape.back();
+    const std::size_t outerCount  = std::accumulate(shape.begin(), shape.end() - 1, std::size_t{1}, std::multiplies<>{});
+    const std::size_t fullCount   = outerCount * lastDim;
+    const std::size_t halfCount   = outerCount * (lastDim / 2 + 1);
+    const std::size_t cmplCount   = (isReal) ? halfCount : fullCount;
+    const std::size_t realBytes   = fullCount * realSize;
+    const std::size_t cmplBytes   = cmplCount * 2 * realSize;
+    const std::size_t srcBytes    = (result.type == afft::dft::Type::realToComplex) ? realBytes : cmplBytes;
+    const std::size_t dstBytes    = (result.type == afft::dft::Type::complexToReal) ? realBytes : cmplBytes;
+    const std::size_t bufferBytes = std::max({realBytes, cmplBytes, 2 * halfCount * realSize});
+    const bool        isPlanar    = (result.layout == afft::ComplexFormat::planar);
+
+    afft::dft::Parameters dftParams{};
+    dftParams.direction = (result.type == afft::dft::Type::complexToReal) ? afft::Direction::backward
+                                                                          : afft::Direction::forward;
+    dftParams.precision = {result.precision, result.precision, result.precision};
+    dftParams.shape     = shape;
+    dftParams.axes      = axes;
+    dftParams.placement = result.placement;
+    dftParams.type      = result.type;
+
+    // each buffer holds either side, the planar format uses the halves of a buffer pair
+    using Buffer = std::vector<std::byte, afft::cpu::AlignedAllocator<std::byte>>;
+
+    Buffer srcBuffer(bufferBytes);
+    Buffer srcImagBuffer((isPlanar) ? bufferBytes : 0);
+    Buffer dstBuffer((result.placement == afft::Placement::outOfPlace) ? bufferBytes : 0);
+    Buffer dstImagBuffer((isPlanar && result.placement == afft::Placement::outOfPlace) ? bufferBytes : 0);
+
+    void* src     = srcBuffer.data();
+    void* srcImag = srcImagBuffer.data();
+    void* dst     = (result.placement == afft::Placement::inPlace) ? src : dstBuffer.data();
+    void* dstImag = (result.placement == afft::Placement::inPlace) ? srcImag : dstImagBuffer.data();
+
+    afft::cpu::Parameters cpuParams{};
+    cpuParams.complexFormat  = result.layout;
+    cpuParams.preserveSource = false;
+    cpuParams.alignment      = afft::alignmentOf(src, dst);
+    cpuParams.threadLimit    = options.threadLimit;
+
+    afft::cpu::BackendParameters backendParams{};
+    backendParams.mask = afft::BackendMask::empty | result.backend;
+
+    auto execute = [&, isSrcPlanar = isPlanar && result.type != afft::dft::Type::realToComplex,
+                       isDstPlanar = isPlanar && result.type != afft::dft::Type::complexToReal](afft::Plan& plan)
+    {
+      if (isSrcPlanar && isDstPlanar)
+      {
+        plan.executeUnsafe(afft::PlanarComplex<void>{src, srcImag}, afft::PlanarComplex<void>{dst, dstImag});
+      }
+      else if (isSrcPlanar)
+      {
+        plan.executeUnsafe(afft::PlanarComplex<void>{src, srcImag}, dst);
+      }
+      else if (isDstPlanar)
+      {
+        plan.executeUnsafe(src, afft::PlanarComplex<void>{dst, dstImag});
+      }
+      else
+      {
+        plan.executeUnsafe(src, dst);
+      }
+    };
+
+    try
+    {
+      auto start = Clock::now();
+      auto plan  = afft::makePlan(dftParams, cpuParams, backendParams);
+      result.planTime = secondsSince(start);
+
+      for (const auto size : plan->getWorkspaceSize())
+      {
+        result.workspaceBytes += size;
+      }
+
+      result.hostMemoryBytes = plan->getMemoryFootprint().hostSize;
+
+      start = Clock::now();
+      execute(*plan);
+      result.firstExecTime = secondsSince(start);
+
+      result.minExecTime = result.firstExecTime;
+
+      std::vector<double> samples{};
+
+      for (std::size_t repeat{}; repeat < options.repeats; ++repeat)
+      {
+        const auto repeatStart = Clock::now();
+
+        for (std::size_t i{}; i < options.iterations; ++i)
+        {
+          start = Clock::now();
+          execute(*plan);
+          result.minExecTime = std::min(result.minExecTime, secondsSince(start));
+        }
+
+        samples.push_back(secondsSince(repeatStart) / static_cast<double>(options.iterations));
+      }
+
+      result.meanExecTime = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+
+      setMedian(samples, result);
+
+      // the hardware counters are recorded only if afft is configured with AFFT_ENABLE_COUNTERS
+      const auto stats = plan->getStats();
+
+      if (stats.executionCount > 0 && stats.cycles > 0)
+      {
+        const auto count = static_cast<double>(stats.executionCount);
+
+        result.cyclesPerExec    = static_cast<double>(stats.cycles) / count;
+        result.llcMissesPerExec = static_cast<double>(stats.llcMisses) / count;
+        result.dramBytesPerExec = static_cast<double>(stats.dramBytes) / count;
+        result.flopsPerDramByte = (stats.dramBytes > 0) ? stats.flopsPerExecution / result.dramBytesPerExec : 0.0;
+      }
+    }
+    catch (const std::exception& e)
+    {
+      result.status = e.what();
+      return;
+    }
+
+    const double transformLength = static_cast<double>(std::accumulate(result.shape.begin(),
+                                                                       result.shape.end(),
+                                                                       std::size_t{1},
+                                                                       std::multiplies<>{}));
+    const double flops = ((isReal) ? 2.5 : 5.0) * transformLength * std::log2(transformLength) *
+                         static_cast<double>(result.batch);
+
+    result.status         = "ok";
+    result.gflops         = flops / result.meanExecTime * 1e-9;
+    result.bytesPerSecond = static_cast<double>(srcBytes + dstBytes) / result.meanExecTime;
+  }
+
+  [[nodiscard]] std::string shapeString(const std::vector<std::size_t>& shape)
+  {
+    std::string str{};
+
+    for (std::size_t i{}; i < shape.size(); ++i)
+    {
+      str += ((i > 0) ? "x" : "") + std::to_string(shape[i]);
+    }
+
+    return str;
+  }
+
+  [[nodiscard]] std::string_view typeString(afft::dft::Type type)
+  {
+    switch (type)
+    {
+    case afft::dft::Type::realToComplex: return "r2c";
+    case afft::dft::Type::complexToReal: return "c2r";
+    default:                             return "c2c";
+    }
+  }
+
+  /// @brief Escape a string for JSON and CSV quoting.
+  [[nodiscard]] std::string quote(std::string_view str, char quoteChar)
+  {
+    std::string quoted{quoteChar};
+
+    for (const char c : str)
+    {
+      if (c == quoteChar)
+      {
+        quoted += (quoteChar == '"' && c == '"') ? "\\\"" : std::string(2, c);
+      }
+      else if (c == '\\' && quoteChar == '"')
+      {
+        quoted += "\\\\";
+      }
+      else if (c != '\n')
+      {
+        quoted += c;
+      }
+    }
+
+    return quoted += quoteChar;
+  }
+
+  [[nodiscard]] std::string_view precisionString(afft::Precision precision)
+  {
+    return (precision == afft::Precision::f32) ? "f32" : "f64";
+  }
+
+  [[nodiscard]] std::string_view placementString(afft::Placement placement)
+  {
+    return (placement == afft::Placement::inPlace) ? "in" : "out";
+  }
+
+  [[nodiscard]] std::string_view layoutString(afft::ComplexFormat layout)
+  {
+    return (layout == afft::ComplexFormat::planar) ? "planar" : "interleaved";
+  }
+
+  /// @brief Make the key identifying the case in the baseline.
+  [[nodiscard]] std::string makeCaseKey(std::string_view backend,
+                                        std::string_view shape,
+                                        std::string_view batch,
+                                        std::string_view precision,
+                                        std::string_view type,
+                                        std::string_view placement,
+                                        std::string_view layout)
+  {
+    std::string key{};
+
+    for (const auto part : {backend, shape, batch, precision, type, placement, layout})
+    {
+      key += part;
+      key += '|';
+    }
+
+    return key;
+  }
+
+  [[nodiscard]] std::string makeCaseKey(const Result& result)
+  {
+    return makeCaseKey(afft::toString(result.backend),
+                       shapeString(result.shape),
+                       std::to_string(result.batch),
+                       precisionString(result.precision),
+                       typeString(result.type),
+                       placementString(result.placement),
+                       layoutString(result.layout));
+  }
+
+  /**
+   * @brief Find the raw value of a key in a JSON object printed on a single line, strings are unescaped.
+   * @param line Line.
+   * @param key Key.
+   * @return Value, empty if not found.
+   */
+  [[nodiscard]] std::string findJsonValue(std::string_view line, std::string_view key)
+  {
+    const std::string quotedKey = "\"" + std::string{key} + "\":";
+
+    auto pos = line.find(quotedKey);
+
+    if (pos == std::string_view::npos)
+    {
+      return {};
+    }
+
+    pos = line.find_first_not_of(' ', pos + quotedKey.size());
+
+    if (pos == std::string_view::npos)
+    {
+      return {};
+    }
+
+    std::string value{};
+
+    if (line[pos] == '"')
+    {
+      for (++pos; pos < line.size() && line[pos] != '"'; ++pos)
+      {
+        if (line[pos] == '\\' && pos + 1 < line.size())
+        {
+          ++pos;
+        }
+
+        value += line[pos];
+      }
+    }
+    else
+    {
+      const auto end = line.find_first_of(",}", pos);
+
+      value = line.substr(pos, end - pos);
+    }
+
+    return value;
+  }
+
+  /**
+   * @brief Read the baseline, the JSON output of a previous run.
+   * @param path Path to the file.
+   * @return Baseline cases.
+   */
+  [[nodiscard]] std::vector<BaselineCase> readBaseline(const std::string& path)
+  {
+    std::ifstream file{path};
+
+    if (!file.is_open())
+    {
+      fail("cannot open baseline '" + path + "'");
+    }
+
+    std::vector<BaselineCase> cases{};
+    std::string               line{};
+
+    while (std::getline(file, line))
+    {
+      if (line.find('{') == std::string::npos)
+      {
+        continue;
+      }
+
+      auto readTime = [&](std::string_view key, std::string_view fallbackKey)
+      {
+        auto value = findJsonValue(line, key);
+
+        if (value.empty())
+        {
+          value = findJsonValue(line, fallbackKey);
+        }
+
+        return std::strtod(value.c_str(), nullptr);
+      };
+
+      BaselineCase baselineCase{};
+      baselineCase.key            = makeCaseKey(findJsonValue(line, "backend"),
+                                                findJsonValue(line, "shape"),
+                                                findJsonValue(line, "batch"),
+                                                findJsonValue(line, "precision"),
+                                                findJsonValue(line, "type"),
+                                                findJsonValue(line, "placement"),
+                                                findJsonValue(line, "layout"));
+      baselineCase.isOk           = (findJsonValue(line, "status") == "ok");
+      baselineCase.medianExecTime = readTime("median_exec_time_s", "mean_exec_time_s");
+      baselineCase.ciLowExecTime  = readTime("ci_low_exec_time_s", "median_exec_time_s");
+      baselineCase.ciHighExecTime = readTime("ci_high_exec_time_s", "median_exec_time_s");
+
+      cases.push_back(std::move(baselineCase));
+    }
+
+    return cases;
+  }
+
+  /**
+   * @brief Compare the result with its baseline case and set the verdict.
+   * @param options Benchmark options.
+   * @param baseline Baseline cases.
+   * @param result Result.
+   */
+  void compareWithBaseline(const Options& options, const std::vector<BaselineCase>& baseline, Result& result)
+  {
+    const auto key = makeCaseKey(result);
+
+    const auto it = std::find_if(baseline.begin(), baseline.end(), [&](const BaselineCase& baselineCase)
+    {
+      return baselineCase.key == key;
+    });
+
+    const bool isOk = (result.status == "ok");
+
+    if (it == baseline.end() || (!it->isOk && !isOk))
+    {
+      result.verdict = "new";
+    }
+    else if (!it->isOk)
+    {
+      result.verdict = "fixed";
+    }
+    else if (!isOk)
+    {
+      result.verdict = "regressed";
+    }
+    else
+    {
+      result.baselineMedianExecTime = it->medianExecTime;
+
+      const double change = result.medianExecTime / it->medianExecTime - 1.0;
+
+      if (change > options.threshold && result.ciLowExecTime > it->ciHighExecTime)
+      {
+        result.verdict = "regressed";
+      }
+      else if (change < -options.threshold && result.ciHighExecTime < it->ciLowExecTime)
+      {
+        result.verdict = "improved";
+      }
+      else
+      {
+        result.verdict = "unchanged";
+      }
+    }
+  }
+
+  void printResult(std::FILE* out, const Result& result, bool csv, bool isFirst)
+  {
+    const auto backend   = std::string{afft::toString(result.backend)};
+    const auto shape     = shapeString(result.shape);
+    const auto precision = std::string{precisionString(result.precision)};
+    const auto placement = std::string{placementString(result.placement)};
+    const auto layout    = std::string{layoutString(result.layout)};
+    const auto baseline  = result.baselineMedianExecTime.value_or(0.0);
+
+    if (csv)
+    {
+      if (isFirst)
+      {
+        std::fprintf(out, "backend,shape,batch,precision,type,placement,layout,status,"
+                          "plan_time_s,first_exec_time_s,mean_exec_time_s,min_exec_time_s,gflops,bytes_per_s,"
+                          "workspace_bytes,median_exec_time_s,ci_low_exec_time_s,ci_high_exec_time_s,"
+                          "baseline_median_exec_time_s,verdict,host_memory_bytes,cycles_per_exec,llc_misses_per_exec,"
+                          "dram_bytes_per_exec,flops_per_dram_byte\n");
+      }
+
+      std::fprintf(out, "%s,%s,%zu,%s,%s,%s,%s,%s,%.9g,%.9g,%.9g,%.9g,%.6g,%.6g,%zu,%.9g,%.9g,%.9g,%.9g,%s,%zu,%.6g,%.6g,%.6g,%.6g\n",
+                   quote(backend, '"').c_str(), shape.c_str(), result.batch, precision.c_str(),
+                   std::string{typeString(result.type)}.c_str(), placement.c_str(), layout.c_str(),
+                   quote(result.status, '"').c_str(), result.planTime, result.firstExecTime, result.meanExecTime,
+                   result.minExecTime, result.gflops, result.bytesPerSecond, result.workspaceBytes,
+                   result.medianExecTime, result.ciLowExecTime, result.ciHighExecTime, baseline,
+                   result.verdict.c_str(), result.hostMemoryBytes, result.cyclesPerExec, result.llcMissesPerExec,
+                   result.dramBytesPerExec, result.flopsPerDramByte);
+    }
+    else
+    {
+      std::fprintf(out, "%s\n  {\"backend\": %s, \"shape\": \"%s\", \"batch\": %zu, \"precision\": \"%s\", "
+                        "\"type\": \"%s\", \"placement\": \"%s\", \"layout\": \"%s\", \"status\": %s, "
+                        "\"plan_time_s\": %.9g, \"first_exec_time_s\": %.9g, \"mean_exec_time_s\": %.9g, "
+                        "\"min_exec_time_s\": %.9g, \"gflops\": %.6g, \"bytes_per_s\": %.6g, "
+                        "\"workspace_bytes\": %zu, \"median_exec_time_s\": %.9g, \"ci_low_exec_time_s\": %.9g, "
+                        "\"ci_high_exec_time_s\": %.9g, \"host_memory_bytes\": %zu, \"cycles_per_exec\": %.6g, "
+                        "\"llc_misses_per_exec\": %.6g, \"dram_bytes_per_exec\": %.6g, \"flops_per_dram_byte\": %.6g",
+                   (isFirst) ? "[" : ",", quote(backend, '"').c_str(), shape.c_str(), result.batch, precision.c_str(),
+                   std::string{typeString(result.type)}.c_str(), placement.c_str(), layout.c_str(),
+                   quote(result.status, '"').c_str(), result.planTime, result.firstExecTime, result.meanExecTime,
+                   result.minExecTime, result.gflops, result.bytesPerSecond, result.workspaceBytes,
+                   result.medianExecTime, result.ciLowExecTime, result.ciHighExecTime, result.hostMemoryBytes,
+                   result.cyclesPerExec, result.llcMissesPerExec, result.dramBytesPerExec, result.flopsPerDramByte);
+
+      if (!result.verdict.empty())
+      {
+        std::fprintf(out, ", \"baseline_median_exec_time_s\": %.9g, \"verdict\": \"%s\"", baseline, result.verdict.c_str());
+      }
+
+      std::fprintf(out, "}");
+    }
+  }
+} // namespace
+
+int main(int argc, char** argv)
+{
+  const auto options = parseOptions(argc, argv);
+
+  const auto baseline = (options.baseline.empty()) ? std::vector<BaselineCase>{} : readBaseline(options.baseline);
+
+  std::FILE* out = stdout;
+
+  if (!options.output.empty())
+  {
+    out = std::fopen(options.output.c_str(), "w");
+
+    if (out == nullptr)
+    {
+      fail("cannot open output '" + options.output + "'");
+    }
+  }
+
+  afft::init();
+
+  bool        isFirst{true};
+  std::size_t regressionCount{};
+
+  for (const auto& shape : options.shapes)
+  for (const auto batch : options.batches)
+  for (const auto precision : options.precisions)
+  for (const auto type : options.types)
+  for (const auto placement : options.placements)
+  for (const auto layout : options.layouts)
+  for (const auto backend : options.backends)
+  {
+    Result result{backend, shape, batch, precision, type, placement, layout};
+
+    runCase(options, result);
+
+    if (!options.baseline.empty())
+    {
+      compareWithBaseline(options, baseline, result);
+
+      if (result.verdict == "regressed")
+      {
+        ++regressionCount;
+
+        std::fprintf(stderr,
+                     "afft-bench: regression %s %s batch %zu %s %s %s %s: %s, median %.3g s, baseline %.3g s\n",
+                     std::string{afft::toString(backend)}.c_str(), shapeString(shape).c_str(), batch,
+                     std::string{precisionString(precision)}.c_str(), std::string{typeString(type)}.c_str(),
+                     std::string{placementString(placement)}.c_str(), std::string{layoutString(layout)}.c_str(),
+                     result.status.c_str(), result.medianExecTime, result.baselineMedianExecTime.value_or(0.0));
+      }
+    }
+
+    printResult(out, result, options.csv, isFirst);
+
+    isFirst = false;
+  }
+
+  if (!options.csv)
+  {
+    std::fprintf(out, "%s\n", (isFirst) ? "[]" : "\n]");
+  }
+
+  if (out != stdout)
+  {
+    std::fclose(out);
+  }
+
+  afft::finalize();
+
+  if (!options.baseline.empty())
+  {
+    std::fprintf(stderr, "afft-bench: %zu regression(s) against '%s'\n", regressionCount, options.baseline.c_str());
+  }
+
+  return (regressionCount > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
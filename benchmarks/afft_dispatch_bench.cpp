@@ -0,0 +1,497 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+// afft-dispatch-bench: measures the per-call cost afft adds on top of the backends. A plan with an empty backend
+// implementation breaks the cost of Plan::execute down into the virtual dispatch of the backend implementation, the
+// buffer checks, the view construction, the type checks and the default execution parameters conversion. Tiny
+// transforms executed by afft are then compared with the direct calls of the backends.
+// Run `afft-dispatch-bench --help` for the options.
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <afft/afft.hpp>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  using C = std::complex<float>;
+
+  /// @brief Benchmark options.
+  struct Options
+  {
+    std::vector<std::size_t> sizes{1, 2, 4, 8, 16, 32};
+    std::size_t              iterations{100000};
+    std::size_t              repeats{7};
+    bool                     csv{};
+  };
+
+  /**
+   * @class NullPlan
+   * @brief Spst cpu plan whose backend implementation does nothing, isolates the cost of afft itself.
+   */
+  class NullPlan : public afft::Plan
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param desc Plan description.
+       */
+      explicit NullPlan(const afft::detail::Desc& desc)
+      : afft::Plan{desc}
+      {}
+
+      /// @brief The null plan is reported as a codelet plan.
+      [[nodiscard]] afft::Backend getBackend() const noexcept override
+      {
+        return afft::Backend::codelet;
+      }
+
+      /**
+       * @brief Call the backend implementation of the plan through the virtual dispatch only.
+       * @param plan The plan.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      static void dispatch(afft::Plan&                                 plan,
+                           afft::View<void*>                           src,
+                           afft::View<void*>                           dst,
+                           const afft::spst::cpu::ExecutionParameters& execParams)
+      {
+        executeBackendImplOf(plan, src, dst, execParams);
+      }
+    protected:
+      void executeBackendImpl(afft::View<void*>, afft::View<void*>, const afft::spst::cpu::ExecutionParameters&) override
+      {}
+  };
+
+  [[noreturn]] void fail(const std::string& message)
+  {
+    std::fprintf(stderr, "afft-dispatch-bench: %s, see --help\n", message.c_str());
+    std::exit(EXIT_FAILURE);
+  }
+
+  void printHelp()
+  {
+    std::printf(
+      "Usage: afft-dispatch-bench [options]\n"
+      "Measures the per-call overhead of Plan::execute against the direct backend calls.\n"
+      "\n"
+      "  --sizes LIST       comma separated 1D c2c f32 transform sizes (default 1,2,4,8,16,32)\n"
+      "  --iterations N     calls per repeat (default 100000)\n"
+      "  --repeats N        repeats, the median time per call is reported (default 7)\n"
+      "  --format FORMAT    text or csv (default text)\n"
+      "\n"
+      "The layers of the null plan are cumulative, each adds the cost of one step of Plan::execute:\n"
+      "  loop               the measurement loop itself\n"
+      "  virtual_dispatch   the virtual call of the backend implementation\n"
+      "  buffer_checks      executeUnsafe on views, the placement, null pointer and parameter checks\n"
+      "  view_construction  executeUnsafe on pointers, the views built by afft\n"
+      "  type_checks        execute on typed pointers, the precision and complexity checks\n"
+      "  param_conversion   execute without execution parameters, the default ones resolved by afft\n"
+      "Plan statistics and tracing add their own cost when afft is configured with them.\n");
+  }
+
+  [[nodiscard]] std::vector<std::size_t> parseSizes(std::string_view list)
+  {
+    std::vector<std::size_t> sizes{};
+
+    while (!list.empty())
+    {
+      const auto        pos = list.find(',');
+      const std::string item{list.substr(0, pos)};
+
+      char* end{};
+
+      const auto value = std::strtoull(item.c_str(), &end, 10);
+
+      if (item.empty() || *end != '\0' || value == 0)
+      {
+        fail("invalid size '" + item + "'");
+      }
+
+      sizes.push_back(static_cast<std::size_t>(value));
+
+      list.remove_prefix((pos == std::string_view::npos) ? list.size() : pos + 1);
+    }
+
+    return sizes;
+  }
+
+  [[nodiscard]] Options parseOptions(int argc, char** argv)
+  {
+    Options options{};
+
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string_view arg{argv[i]};
+
+      if (arg == "--help" || arg == "-h")
+      {
+        printHelp();
+        std::exit(EXIT_SUCCESS);
+      }
+
+      if (i + 1 >= argc)
+      {
+        fail("missing value of '" + std::string{arg} + "'");
+      }
+
+      const std::string_view value{argv[++i]};
+
+      if (arg == "--sizes")
+      {
+        options.sizes = parseSizes(value);
+      }
+      else if (arg == "--iterations")
+      {
+        options.iterations = parseSizes(value).front();
+      }
+      else if (arg == "--repeats")
+      {
+        options.repeats = parseSizes(value).front();
+      }
+      else if (arg == "--format")
+      {
+        if (value != "text" && value != "csv")
+        {
+          fail("unknown format '" + std::string{value} + "'");
+        }
+
+        options.csv = (value == "csv");
+      }
+      else
+      {
+        fail("unknown option '" + std::string{arg} + "'");
+      }
+    }
+
+    return options;
+  }
+
+  /**
+   * @brief Keep the value observable, so the measured calls are not optimized away.
+   * @param value The value.
+   */
+  template<typename T>
+  void doNotOptimize(T& value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile T sink{};
+    sink = value;
+#endif
+  }
+
+  /**
+   * @brief Measure the median time of a call over the repeats.
+   * @tparam FnT Function type.
+   * @tparam SyncT Synchronization function type.
+   * @param options Benchmark options.
+   * @param fn The measured call.
+   * @param sync Called after the calls of each repeat, waits for the asynchronous ones.
+   * @return Median time per call in nanoseconds.
+   */
+  template<typename FnT, typename SyncT>
+  [[nodiscard]] double measure(const Options& options, FnT&& fn, SyncT&& sync)
+  {
+    // warm up the caches and the lazily initialized state
+    for (std::size_t i{}; i < std::min<std::size_t>(options.iterations, 1000); ++i)
+    {
+      fn();
+    }
+    sync();
+
+    std::vector<double> samples(options.repeats);
+
+    for (auto& sample : samples)
+    {
+      const auto start = Clock::now();
+
+      for (std::size_t i{}; i < options.iterations; ++i)
+      {
+        fn();
+      }
+      sync();
+
+      const std::chrono::duration<double, std::nano> time = Clock::now() - start;
+
+      sample = time.count() / static_cast<double>(options.iterations);
+    }
+
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+
+    return samples[samples.size() / 2];
+  }
+
+  template<typename FnT>
+  [[nodiscard]] double measure(const Options& options, FnT&& fn)
+  {
+    return measure(options, std::forward<FnT>(fn), []{});
+  }
+
+  /**
+   * @brief Print a row of the results.
+   * @param options Benchmark options.
+   * @param name Name of the measured layer or call.
+   * @param size Transform size.
+   * @param time Time per call in nanoseconds.
+   * @param reference Time of the reference call the overhead is relative to.
+   */
+  void printRow(const Options& options, std::string_view name, std::size_t size, double time, double reference)
+  {
+    if (options.csv)
+    {
+      std::printf("%.*s,%zu,%.3f,%.3f\n", static_cast<int>(name.size()), name.data(), size, time, time - reference);
+    }
+    else
+    {
+      std::printf("%-28.*s %8zu %12.2f %+12.2f\n", static_cast<int>(name.size()), name.data(), size, time, time - reference);
+    }
+  }
+
+  /**
+   * @brief Make the 1D c2c f32 transform parameters.
+   * @param size Transform size.
+   * @return Transform parameters.
+   */
+  [[nodiscard]] afft::dft::Parameters<> makeDftParams(const std::size_t& size)
+  {
+    afft::dft::Parameters<> dftParams{};
+    dftParams.direction = afft::Direction::forward;
+    dftParams.precision = {afft::Precision::f32, afft::Precision::f32, afft::Precision::f32};
+    dftParams.shape     = afft::View<std::size_t>{&size, 1};
+    dftParams.placement = afft::Placement::outOfPlace;
+    dftParams.type      = afft::dft::Type::complexToComplex;
+
+    return dftParams;
+  }
+
+  /**
+   * @brief Measure the layers of Plan::execute on the null plan.
+   * @param options Benchmark options.
+   */
+  void runNullPlan(const Options& options)
+  {
+    const std::size_t size{options.sizes.front()};
+
+    afft::cpu::Parameters cpuParams{};
+    cpuParams.preserveSource = false;
+
+    NullPlan nullPlan{afft::detail::Desc{makeDftParams(size), cpuParams}};
+
+    std::vector<C> srcBuffer(size);
+    std::vector<C> dstBuffer(size);
+
+    C*    src     = srcBuffer.data();
+    C*    dst     = dstBuffer.data();
+    void* srcVoid = src;
+    void* dstVoid = dst;
+
+    afft::Plan* plan = &nullPlan;
+    doNotOptimize(plan);
+
+    const afft::spst::cpu::ExecutionParameters execParams{};
+
+    const double loop = measure(options, [&]{ doNotOptimize(srcVoid); });
+
+    const double virtualDispatch = measure(options, [&]
+    {
+      NullPlan::dispatch(*plan, afft::View<void*>{&srcVoid, 1}, afft::View<void*>{&dstVoid, 1}, execParams);
+    });
+
+    const double bufferChecks = measure(options, [&]
+    {
+      plan->executeUnsafe(afft::View<void*>{&srcVoid, 1}, afft::View<void*>{&dstVoid, 1}, execParams);
+    });
+
+    const double viewConstruction = measure(options, [&]{ plan->executeUnsafe(srcVoid, dstVoid, execParams); });
+
+    const double typeChecks = measure(options, [&]{ plan->execute(src, dst, execParams); });
+
+    const double paramConversion = measure(options, [&]{ plan->execute(src, dst); });
+
+    printRow(options, "null.loop", size, loop, loop);
+    printRow(options, "null.virtual_dispatch", size, virtualDispatch, loop);
+    printRow(options, "null.buffer_checks", size, bufferChecks, virtualDispatch);
+    printRow(options, "null.view_construction", size, viewConstruction, bufferChecks);
+    printRow(options, "null.type_checks", size, typeChecks, viewConstruction);
+    printRow(options, "null.param_conversion", size, paramConversion, typeChecks);
+    printRow(options, "null.total", size, paramConversion, loop);
+  }
+
+#if defined(AFFT_ENABLE_POCKETFFT)
+  /**
+   * @brief Compare the PocketFFT plan with the direct pocketfft::c2c call.
+   * @param options Benchmark options.
+   * @param size Transform size.
+   */
+  void runPocketfft(const Options& options, std::size_t size)
+  {
+    afft::cpu::Parameters cpuParams{};
+    cpuParams.preserveSource = false;
+    cpuParams.threadLimit    = 1;
+
+    afft::cpu::BackendParameters backendParams{};
+    backendParams.mask = afft::BackendMask::empty | afft::Backend::pocketfft;
+
+    auto plan = afft::makePlan(makeDftParams(size), cpuParams, backendParams);
+
+    std::vector<C> srcBuffer(size);
+    std::vector<C> dstBuffer(size);
+
+    C* src = srcBuffer.data();
+    C* dst = dstBuffer.data();
+
+    const pocketfft::shape_t  shape{size};
+    const pocketfft::stride_t strides{static_cast<std::ptrdiff_t>(sizeof(C))};
+    const pocketfft::shape_t  axes{0};
+
+    const double direct = measure(options, [&]
+    {
+      pocketfft::c2c(shape, strides, strides, axes, pocketfft::FORWARD, src, dst, 1.f, 1);
+      doNotOptimize(dst);
+    });
+
+    const double viaAfft = measure(options, [&]
+    {
+      plan->execute(src, dst);
+      doNotOptimize(dst);
+    });
+
+    printRow(options, "pocketfft.direct", size, direct, direct);
+    printRow(options, "pocketfft.afft_execute", size, viaAfft, direct);
+  }
+#endif
+
+#if defined(AFFT_ENABLE_CUFFT)
+  /**
+   * @brief Compare the cuFFT plan with the direct cufftExecC2C call. Both enqueue the executions on the same stream,
+   *        the stream is synchronized after the calls of each repeat.
+   * @param options Benchmark options.
+   * @param size Transform size.
+   */
+  void runCufft(const Options& options, std::size_t size)
+  {
+    cudaStream_t stream{};
+    afft::detail::cuda::checkError(cudaStreamCreate(&stream));
+
+    void* src{};
+    void* dst{};
+    afft::detail::cuda::checkError(cudaMalloc(&src, size * sizeof(C)));
+    afft::detail::cuda::checkError(cudaMalloc(&dst, size * sizeof(C)));
+
+    cufftHandle handle{};
+    afft::detail::cufft::checkError(cufftPlan1d(&handle, static_cast<int>(size), CUFFT_C2C, 1));
+    afft::detail::cufft::checkError(cufftSetStream(handle, stream));
+
+    afft::gpu::Parameters gpuParams{};
+    gpuParams.preserveSource = false;
+
+    afft::gpu::BackendParameters backendParams{};
+    backendParams.mask = afft::BackendMask::empty | afft::Backend::cufft;
+
+    auto plan = afft::makePlan(makeDftParams(size), gpuParams, backendParams);
+
+    afft::gpu::ExecutionParameters execParams{};
+    execParams.stream = stream;
+
+    auto sync = [&]{ afft::detail::cuda::checkError(cudaStreamSynchronize(stream)); };
+
+    const double direct = measure(options, [&]
+    {
+      cufftExecC2C(handle, static_cast<cufftComplex*>(src), static_cast<cufftComplex*>(dst), CUFFT_FORWARD);
+    }, sync);
+
+    const double viaAfft = measure(options, [&]
+    {
+      plan->execute(static_cast<C*>(src), static_cast<C*>(dst), execParams);
+    }, sync);
+
+    printRow(options, "cufft.direct", size, direct, direct);
+    printRow(options, "cufft.afft_execute", size, viaAfft, direct);
+
+    plan.reset();
+    cufftDestroy(handle);
+    cudaFree(src);
+    cudaFree(dst);
+    cudaStreamDestroy(stream);
+  }
+#endif
+} // namespace
+
+int main(int argc, char** argv)
+{
+  const auto options = parseOptions(argc, argv);
+
+  if (options.sizes.empty() || options.iterations == 0 || options.repeats == 0)
+  {
+    fail("nothing to measure");
+  }
+
+  afft::init();
+
+  if (options.csv)
+  {
+    std::printf("name,size,ns_per_call,overhead_ns\n");
+  }
+  else
+  {
+    std::printf("%-28s %8s %12s %12s\n", "name", "size", "ns/call", "overhead");
+  }
+
+  try
+  {
+    runNullPlan(options);
+
+    for ([[maybe_unused]] const auto size : options.sizes)
+    {
+#   if defined(AFFT_ENABLE_POCKETFFT)
+      runPocketfft(options, size);
+#   endif
+#   if defined(AFFT_ENABLE_CUFFT)
+      runCufft(options, size);
+#   endif
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::fprintf(stderr, "afft-dispatch-bench: %s\n", e.what());
+    afft::finalize();
+    return EXIT_FAILURE;
+  }
+
+  afft::finalize();
+
+  return EXIT_SUCCESS;
+}
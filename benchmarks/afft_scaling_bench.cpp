@@ -0,0 +1,1173 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+// afft-scaling-bench: measures the strong and the weak scaling of the distributed c2c dft plans. Launched by mpirun,
+// it runs the mpst plans on the communicators of 1, 2, 4, ... processes up to the world size, or the spmt plans of the
+// first process on 1, 2, 4, ... devices. Each case is broken down into the phases of a slab decomposed reference
+// pipeline on the same decomposition (local transforms, pack, all-to-all, unpack), so the backends are comparable
+// with each other and with the bare exchange. Run `mpirun -n 1 afft-scaling-bench --help` for the options.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <afft/afft.hpp>
+
+namespace
+{
+  /// @brief Scaling mode.
+  enum class Scaling
+  {
+    strong, ///< The global shape is fixed
+    weak,   ///< The first axis of the global shape grows with the process count
+  };
+
+  /// @brief Benchmark options.
+  struct Options
+  {
+    std::vector<std::vector<std::size_t>> shapes{{1024, 1024}, {128, 128, 128}};
+    std::vector<Scaling>                  scalings{Scaling::strong, Scaling::weak};
+    std::vector<afft::Precision>          precisions{afft::Precision::f32};
+    std::vector<afft::Backend>            backends{};
+    afft::Target                          target{afft::Target::cpu};
+    afft::Distribution                    distribution{afft::Distribution::mpst};
+    std::size_t                           maxDeviceCount{};
+    std::size_t                           iterations{10};
+    std::size_t                           repeats{5};
+    bool                                  phases{true};
+    bool                                  csv{};
+  };
+
+  /// @brief Times of the phases of the reference pipeline, the maximum over the processes.
+  struct Phases
+  {
+    double localFft{};  ///< Local transforms before and after the exchange
+    double pack{};      ///< Packing the blocks sent to each process
+    double allToAll{};  ///< The all-to-all exchange
+    double unpack{};    ///< Unpacking the received blocks
+  };
+
+  /// @brief Result of one benchmark case.
+  struct Result
+  {
+    afft::Backend            backend{};
+    Scaling                  scaling{};
+    std::vector<std::size_t> shape{};
+    std::size_t              processCount{};
+    afft::Precision          precision{};
+    std::string              status{};
+    double                   planTime{};
+    double                   medianExecTime{};
+    double                   minExecTime{};
+    double                   gflops{};
+    std::optional<double>    efficiency{};
+    std::optional<Phases>    phases{};
+  };
+
+  /// @brief Slab decomposition of a global shape, the source split along the first axis, the destination along the
+  ///        second one.
+  struct Slabs
+  {
+    std::vector<std::size_t> shape{};     ///< Global shape
+    std::size_t              count{};     ///< Number of slabs, the process count
+    std::size_t              innerSize{}; ///< Product of the axes behind the second one
+
+    [[nodiscard]] std::size_t srcStart(std::size_t i) const { return shape[0] * i / count; }
+    [[nodiscard]] std::size_t srcSize(std::size_t i) const { return srcStart(i + 1) - srcStart(i); }
+    [[nodiscard]] std::size_t dstStart(std::size_t i) const { return shape[1] * i / count; }
+    [[nodiscard]] std::size_t dstSize(std::size_t i) const { return dstStart(i + 1) - dstStart(i); }
+
+    [[nodiscard]] std::size_t srcElemCount(std::size_t i) const { return srcSize(i) * shape[1] * innerSize; }
+    [[nodiscard]] std::size_t dstElemCount(std::size_t i) const { return shape[0] * dstSize(i) * innerSize; }
+  };
+
+  /// @brief Memory blocks of the slabs of one process, keeps the viewed arrays alive.
+  struct SlabBlocks
+  {
+    std::vector<std::size_t> srcStarts{};
+    std::vector<std::size_t> srcSizes{};
+    std::vector<std::size_t> srcStrides{};
+    std::vector<std::size_t> dstStarts{};
+    std::vector<std::size_t> dstSizes{};
+    std::vector<std::size_t> dstStrides{};
+  };
+
+  /// @brief Backend names accepted on the command line, the backends of the distributed plans.
+  constexpr std::pair<std::string_view, afft::Backend> backendNames[]
+  {
+    {"cufft",  afft::Backend::cufft},
+    {"fftw3",  afft::Backend::fftw3},
+    {"heffte", afft::Backend::heffte},
+    {"mkl",    afft::Backend::mkl},
+    {"rocfft", afft::Backend::rocfft},
+  };
+
+  int worldRank{};
+  int worldSize{1};
+
+  [[noreturn]] void fail(const std::string& message)
+  {
+    if (worldRank == 0)
+    {
+      std::fprintf(stderr, "afft-scaling-bench: %s, see --help\n", message.c_str());
+    }
+
+    MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    std::exit(EXIT_FAILURE);
+  }
+
+  void printHelp()
+  {
+    std::printf(
+      "Usage: mpirun -n P afft-scaling-bench [options]\n"
+      "Measures the strong and the weak scaling of the distributed c2c dft plans.\n"
+      "\n"
+      "  --shapes LIST        comma separated 2D or 3D global shapes, dimensions joined by 'x'\n"
+      "                       (default 1024x1024,128x128x128)\n"
+      "  --scaling LIST       strong,weak (default strong,weak)\n"
+      "  --precisions LIST    f32,f64 (default f32)\n"
+      "  --target TARGET      cpu or gpu (default cpu)\n"
+      "  --distribution DIST  mpst or spmt (default mpst), spmt runs on the first process only\n"
+      "  --devices N          maximum device count of the spmt plans (default every device)\n"
+      "  --backends LIST      backend names (default every backend of the distribution)\n"
+      "  --iterations N       measured executions per repeat (default 10)\n"
+      "  --repeats N          repeats, the median time per execution is reported (default 5)\n"
+      "  --no-phases          skip the reference pipeline\n"
+      "  --format FORMAT      json or csv (default json)\n"
+      "\n"
+      "The mpst plans run on the communicators of 1, 2, 4, ... processes and the world size, the spmt plans on\n"
+      "1, 2, 4, ... devices. The strong scaling keeps the global shape, the weak scaling multiplies its first axis\n"
+      "by the process count. The time of an execution is the maximum over the processes. The efficiency is\n"
+      "T1 / (P TP) for the strong and T1 / TP for the weak scaling, relative to the single process run.\n"
+      "\n"
+      "The gpu processes use the device of their rank modulo the device count. The mpst plans use the slab\n"
+      "decomposition, the source split along the first axis and the destination along the second one. The phases\n"
+      "are measured by a host reference pipeline on the same decomposition: the local transforms of the trailing\n"
+      "axes and of the first axis by the spst cpu plans, the pack, the MPI_Alltoallv and the unpack.\n");
+  }
+
+  [[nodiscard]] std::vector<std::string> split(std::string_view str, char delim)
+  {
+    std::vector<std::string> parts{};
+
+    while (true)
+    {
+      const auto pos = str.find(delim);
+
+      parts.emplace_back(str.substr(0, pos));
+
+      if (pos == std::string_view::npos)
+      {
+        break;
+      }
+
+      str.remove_prefix(pos + 1);
+    }
+
+    return parts;
+  }
+
+  [[nodiscard]] std::size_t parseSize(const std::string& str)
+  {
+    char* end{};
+
+    const auto value = std::strtoull(str.c_str(), &end, 10);
+
+    if (str.empty() || *end != '\0')
+    {
+      fail("invalid number '" + str + "'");
+    }
+
+    return static_cast<std::size_t>(value);
+  }
+
+  [[nodiscard]] std::vector<std::size_t> parseShape(const std::string& str)
+  {
+    std::vector<std::size_t> shape{};
+
+    for (const auto& dim : split(str, 'x'))
+    {
+      shape.push_back(parseSize(dim));
+    }
+
+    if (shape.size() < 2 || shape.size() > 3 || std::find(shape.begin(), shape.end(), 0) != shape.end())
+    {
+      fail("invalid shape '" + str + "', 2D and 3D shapes are supported");
+    }
+
+    return shape;
+  }
+
+  [[nodiscard]] Scaling parseScaling(const std::string& str)
+  {
+    if (str == "strong")
+    {
+      return Scaling::strong;
+    }
+    else if (str == "weak")
+    {
+      return Scaling::weak;
+    }
+
+    fail("unknown scaling '" + str + "'");
+  }
+
+  [[nodiscard]] afft::Precision parsePrecision(const std::string& str)
+  {
+    if (str == "f32")
+    {
+      return afft::Precision::f32;
+    }
+    else if (str == "f64")
+    {
+      return afft::Precision::f64;
+    }
+
+    fail("unknown precision '" + str + "'");
+  }
+
+  [[nodiscard]] afft::Backend parseBackend(const std::string& str)
+  {
+    const auto it = std::find_if(std::begin(backendNames), std::end(backendNames), [&](const auto& name)
+    {
+      return name.first == str;
+    });
+
+    if (it == std::end(backendNames))
+    {
+      fail("invalid backend '" + str + "'");
+    }
+
+    return it->second;
+  }
+
+  template<typename T>
+  [[nodiscard]] std::vector<T> parseList(const std::string& list, const std::function<T(const std::string&)>& parse)
+  {
+    std::vector<T> values{};
+
+    for (const auto& item : split(list, ','))
+    {
+      values.push_back(parse(item));
+    }
+
+    return values;
+  }
+
+  [[nodiscard]] Options parseOptions(int argc, char** argv)
+  {
+    Options options{};
+
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string_view arg{argv[i]};
+
+      if (arg == "--help" || arg == "-h")
+      {
+        if (worldRank == 0)
+        {
+          printHelp();
+        }
+
+        MPI_Finalize();
+        std::exit(EXIT_SUCCESS);
+      }
+
+      if (arg == "--no-phases")
+      {
+        options.phases = false;
+        continue;
+      }
+
+      if (i + 1 >= argc)
+      {
+        fail("missing value of '" + std::string{arg} + "'");
+      }
+
+      const std::string value{argv[++i]};
+
+      if (arg == "--shapes")
+      {
+        options.shapes = parseList<std::vector<std::size_t>>(value, parseShape);
+      }
+      else if (arg == "--scaling")
+      {
+        options.scalings = parseList<Scaling>(value, parseScaling);
+      }
+      else if (arg == "--precisions")
+      {
+        options.precisions = parseList<afft::Precision>(value, parsePrecision);
+      }
+      else if (arg == "--target")
+      {
+        if (value != "cpu" && value != "gpu")
+        {
+          fail("unknown target '" + value + "'");
+        }
+
+        options.target = (value == "cpu") ? afft::Target::cpu : afft::Target::gpu;
+      }
+      else if (arg == "--distribution")
+      {
+        if (value != "mpst" && value != "spmt")
+        {
+          fail("unknown distribution '" + value + "'");
+        }
+
+        options.distribution = (value == "mpst") ? afft::Distribution::mpst : afft::Distribution::spmt;
+      }
+      else if (arg == "--devices")
+      {
+        options.maxDeviceCount = parseSize(value);
+      }
+      else if (arg == "--backends")
+      {
+        options.backends = parseList<afft::Backend>(value, parseBackend);
+      }
+      else if (arg == "--iterations")
+      {
+        options.iterations = std::max<std::size_t>(parseSize(value), 1);
+      }
+      else if (arg == "--repeats")
+      {
+        options.repeats = std::max<std::size_t>(parseSize(value), 1);
+      }
+      else if (arg == "--format")
+      {
+        if (value != "json" && value != "csv")
+        {
+          fail("unknown format '" + value + "'");
+        }
+
+        options.csv = (value == "csv");
+      }
+      else
+      {
+        fail("unknown option '" + std::string{arg} + "'");
+      }
+    }
+
+    if (options.distribution == afft::Distribution::spmt && options.target != afft::Target::gpu)
+    {
+      fail("the spmt distribution requires the gpu target");
+    }
+
+    if (options.backends.empty())
+    {
+      if (options.distribution == afft::Distribution::spmt)
+      {
+        options.backends = {afft::Backend::cufft, afft::Backend::rocfft};
+      }
+      else if (options.target == afft::Target::cpu)
+      {
+        options.backends = {afft::Backend::heffte, afft::Backend::fftw3, afft::Backend::mkl};
+      }
+      else
+      {
+        options.backends = {afft::Backend::cufft, afft::Backend::heffte};
+      }
+    }
+
+    return options;
+  }
+
+  /**
+   * @brief Get the counts of the processes or devices the cases run on, 1, 2, 4, ... and the maximum.
+   * @param maxCount Maximum count.
+   * @return Counts.
+   */
+  [[nodiscard]] std::vector<std::size_t> getCounts(std::size_t maxCount)
+  {
+    std::vector<std::size_t> counts{};
+
+    for (std::size_t count{1}; count < maxCount; count *= 2)
+    {
+      counts.push_back(count);
+    }
+
+    counts.push_back(maxCount);
+
+    return counts;
+  }
+
+  /**
+   * @brief Get the device count of the gpu target.
+   * @return Device count, 0 without gpu support.
+   */
+  [[nodiscard]] std::size_t getDeviceCount()
+  {
+#if defined(AFFT_ENABLE_CUDA)
+    return static_cast<std::size_t>(afft::detail::cuda::getDeviceCount());
+#elif defined(AFFT_ENABLE_HIP)
+    return static_cast<std::size_t>(afft::detail::hip::getDeviceCount());
+#else
+    return 0;
+#endif
+  }
+
+  /**
+   * @brief Buffer of the target memory.
+   */
+  class Buffer
+  {
+    public:
+      Buffer() = default;
+
+      /**
+       * @brief Constructor.
+       * @param target Target of the memory.
+       * @param size Size in bytes.
+       */
+      Buffer(afft::Target target, std::size_t size)
+      : mTarget{target}
+      {
+        size = std::max<std::size_t>(size, 1);
+
+        if (mTarget == afft::Target::cpu)
+        {
+          mPtr = std::calloc(size, 1);
+        }
+        else
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          afft::detail::cuda::checkError(cudaMalloc(&mPtr, size));
+          afft::detail::cuda::checkError(cudaMemset(mPtr, 0, size));
+#       elif defined(AFFT_ENABLE_HIP)
+          afft::detail::hip::checkError(hipMalloc(&mPtr, size));
+          afft::detail::hip::checkError(hipMemset(mPtr, 0, size));
+#       endif
+        }
+
+        if (mPtr == nullptr)
+        {
+          throw std::bad_alloc{};
+        }
+      }
+
+      Buffer(const Buffer&) = delete;
+
+      Buffer(Buffer&& other) noexcept
+      : mTarget{other.mTarget}, mPtr{std::exchange(other.mPtr, nullptr)}
+      {}
+
+      ~Buffer()
+      {
+        if (mPtr == nullptr)
+        {
+          return;
+        }
+
+        if (mTarget == afft::Target::cpu)
+        {
+          std::free(mPtr);
+        }
+        else
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          cudaFree(mPtr);
+#       elif defined(AFFT_ENABLE_HIP)
+          (void)hipFree(mPtr);
+#       endif
+        }
+      }
+
+      Buffer& operator=(const Buffer&) = delete;
+      Buffer& operator=(Buffer&&) = delete;
+
+      [[nodiscard]] void* get() const noexcept
+      {
+        return mPtr;
+      }
+    private:
+      afft::Target mTarget{afft::Target::cpu};
+      void*        mPtr{};
+  };
+
+  /**
+   * @brief Get the size of a complex element.
+   * @param precision Precision.
+   * @return Size in bytes.
+   */
+  [[nodiscard]] std::size_t complexSizeOf(afft::Precision precision)
+  {
+    return 2 * ((precision == afft::Precision::f32) ? sizeof(float) : sizeof(double));
+  }
+
+  /**
+   * @brief Make the c2c dft parameters.
+   * @param shape Shape.
+   * @param axes Transformed axes.
+   * @param precision Precision.
+   * @return Dft parameters.
+   */
+  [[nodiscard]] afft::dft::Parameters<> makeDftParams(const std::vector<std::size_t>& shape,
+                                                      const std::vector<std::size_t>& axes,
+                                                      afft::Precision                 precision)
+  {
+    afft::dft::Parameters<> dftParams{};
+    dftParams.direction = afft::Direction::forward;
+    dftParams.precision = {precision, precision, precision};
+    dftParams.shape     = shape;
+    dftParams.axes      = axes;
+    dftParams.placement = afft::Placement::outOfPlace;
+    dftParams.type      = afft::dft::Type::complexToComplex;
+
+    return dftParams;
+  }
+
+  /**
+   * @brief Make the slab memory blocks of a process.
+   * @param slabs Slab decomposition.
+   * @param rank Rank of the process.
+   * @return Memory blocks.
+   */
+  [[nodiscard]] SlabBlocks makeSlabBlocks(const Slabs& slabs, std::size_t rank)
+  {
+    const auto rank3 = slabs.shape.size();
+
+    SlabBlocks blocks{};
+    blocks.srcStarts.assign(rank3, 0);
+    blocks.srcSizes = slabs.shape;
+    blocks.dstStarts.assign(rank3, 0);
+    blocks.dstSizes = slabs.shape;
+
+    blocks.srcStarts[0] = slabs.srcStart(rank);
+    blocks.srcSizes[0]  = slabs.srcSize(rank);
+    blocks.dstStarts[1] = slabs.dstStart(rank);
+    blocks.dstSizes[1]  = slabs.dstSize(rank);
+
+    const auto makeStrides = [rank3](const std::vector<std::size_t>& sizes)
+    {
+      std::vector<std::size_t> strides(rank3, 1);
+
+      for (std::size_t i = rank3 - 1; i > 0; --i)
+      {
+        strides[i - 1] = strides[i] * sizes[i];
+      }
+
+      return strides;
+    };
+
+    blocks.srcStrides = makeStrides(blocks.srcSizes);
+    blocks.dstStrides = makeStrides(blocks.dstSizes);
+
+    return blocks;
+  }
+
+  /**
+   * @brief Measure the time of an execution, the maximum over the processes of the communicator.
+   * @param options Benchmark options.
+   * @param comm Communicator.
+   * @param fn The execution.
+   * @param sync Waits for the asynchronous executions.
+   * @param minTime Set to the minimum time.
+   * @return Median time over the repeats.
+   */
+  template<typename FnT, typename SyncT>
+  [[nodiscard]] double measure(const Options& options, MPI_Comm comm, FnT&& fn, SyncT&& sync, double& minTime)
+  {
+    fn();
+    sync();
+
+    std::vector<double> samples(options.repeats);
+
+    for (auto& sample : samples)
+    {
+      MPI_Barrier(comm);
+
+      const double start = MPI_Wtime();
+
+      for (std::size_t i{}; i < options.iterations; ++i)
+      {
+        fn();
+      }
+      sync();
+
+      double time = (MPI_Wtime() - start) / static_cast<double>(options.iterations);
+
+      MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+      sample = time;
+    }
+
+    minTime = *std::min_element(samples.begin(), samples.end());
+
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+
+    return samples[samples.size() / 2];
+  }
+
+  /**
+   * @brief Synchronize the device of the gpu target.
+   * @param target Target.
+   */
+  void synchronize([[maybe_unused]] afft::Target target)
+  {
+#if defined(AFFT_ENABLE_CUDA)
+    if (target == afft::Target::gpu)
+    {
+      afft::detail::cuda::checkError(cudaDeviceSynchronize());
+    }
+#elif defined(AFFT_ENABLE_HIP)
+    if (target == afft::Target::gpu)
+    {
+      afft::detail::hip::checkError(hipDeviceSynchronize());
+    }
+#endif
+  }
+
+  /**
+   * @brief Measure the phases of the slab reference pipeline on the host.
+   * @param options Benchmark options.
+   * @param comm Communicator of the slab processes.
+   * @param slabs Slab decomposition.
+   * @param precision Precision.
+   * @return Phase times, the maximum over the processes.
+   */
+  [[nodiscard]] Phases runReferencePipeline(const Options&  options,
+                                            MPI_Comm        comm,
+                                            const Slabs&    slabs,
+                                            afft::Precision precision)
+  {
+    int commRank{};
+    MPI_Comm_rank(comm, &commRank);
+
+    const auto rank      = static_cast<std::size_t>(commRank);
+    const auto elemSize  = complexSizeOf(precision);
+    const auto rowSize   = slabs.innerSize * elemSize;
+    const auto srcCount  = slabs.srcElemCount(rank);
+    const auto dstCount  = slabs.dstElemCount(rank);
+
+    // local transforms of the trailing axes of the source slab and of the first axis of the destination slab
+    auto srcShape = slabs.shape;
+    srcShape[0]   = std::max<std::size_t>(slabs.srcSize(rank), 1);
+    auto dstShape = slabs.shape;
+    dstShape[1]   = std::max<std::size_t>(slabs.dstSize(rank), 1);
+
+    std::vector<std::size_t> trailingAxes(slabs.shape.size() - 1);
+    std::iota(trailingAxes.begin(), trailingAxes.end(), std::size_t{1});
+
+    afft::cpu::Parameters cpuParams{};
+    cpuParams.preserveSource = false;
+
+    auto trailingPlan = afft::makePlan(makeDftParams(srcShape, trailingAxes, precision), cpuParams);
+    auto firstPlan    = afft::makePlan(makeDftParams(dstShape, {0}, precision), cpuParams);
+
+    const auto maxCount = std::max({srcCount, dstCount, std::size_t{1}});
+
+    Buffer src{afft::Target::cpu, maxCount * elemSize};
+    Buffer dst{afft::Target::cpu, maxCount * elemSize};
+    Buffer send{afft::Target::cpu, maxCount * elemSize};
+    Buffer recv{afft::Target::cpu, maxCount * elemSize};
+
+    std::vector<int> sendCounts(slabs.count);
+    std::vector<int> sendOffsets(slabs.count);
+    std::vector<int> recvCounts(slabs.count);
+    std::vector<int> recvOffsets(slabs.count);
+
+    for (std::size_t i{}; i < slabs.count; ++i)
+    {
+      const auto sendBytes = slabs.srcSize(rank) * slabs.dstSize(i) * rowSize;
+      const auto recvBytes = slabs.srcSize(i) * slabs.dstSize(rank) * rowSize;
+
+      if (sendBytes > static_cast<std::size_t>(std::numeric_limits<int>::max()) ||
+          recvBytes > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+      {
+        throw std::runtime_error{"exchanged blocks exceed the MPI count limit"};
+      }
+
+      sendCounts[i] = static_cast<int>(sendBytes);
+      recvCounts[i] = static_cast<int>(recvBytes);
+
+      if (i > 0)
+      {
+        sendOffsets[i] = sendOffsets[i - 1] + sendCounts[i - 1];
+        recvOffsets[i] = recvOffsets[i - 1] + recvCounts[i - 1];
+      }
+    }
+
+    auto* srcBytes  = static_cast<std::byte*>(src.get());
+    auto* dstBytes  = static_cast<std::byte*>(dst.get());
+    auto* sendBytes = static_cast<std::byte*>(send.get());
+    auto* recvBytes = static_cast<std::byte*>(recv.get());
+
+    // the block of destination i holds the rows of the source slab within its range of the second axis
+    auto pack = [&]
+    {
+      for (std::size_t i{}; i < slabs.count; ++i)
+      {
+        auto* out = sendBytes + sendOffsets[i];
+
+        for (std::size_t j{}; j < slabs.srcSize(rank); ++j)
+        {
+          const auto* in   = srcBytes + (j * slabs.shape[1] + slabs.dstStart(i)) * rowSize;
+          const auto  size = slabs.dstSize(i) * rowSize;
+
+          std::memcpy(out, in, size);
+          out += size;
+        }
+      }
+    };
+
+    // the block of source i holds its rows of the first axis within the own range of the second axis
+    auto unpack = [&]
+    {
+      for (std::size_t i{}; i < slabs.count; ++i)
+      {
+        const auto size = static_cast<std::size_t>(recvCounts[i]);
+
+        std::memcpy(dstBytes + slabs.srcStart(i) * slabs.dstSize(rank) * rowSize, recvBytes + recvOffsets[i], size);
+      }
+    };
+
+    auto allToAll = [&]
+    {
+      MPI_Alltoallv(sendBytes, sendCounts.data(), sendOffsets.data(), MPI_BYTE,
+                    recvBytes, recvCounts.data(), recvOffsets.data(), MPI_BYTE, comm);
+    };
+
+    const auto noSync = []{};
+
+    double minTime{};
+    Phases phases{};
+
+    phases.localFft  = measure(options, comm, [&]{ trailingPlan->executeUnsafe(src.get(), dst.get()); }, noSync, minTime);
+    phases.localFft += measure(options, comm, [&]{ firstPlan->executeUnsafe(dst.get(), src.get()); }, noSync, minTime);
+    phases.pack      = measure(options, comm, pack, noSync, minTime);
+    phases.allToAll  = measure(options, comm, allToAll, noSync, minTime);
+    phases.unpack    = measure(options, comm, unpack, noSync, minTime);
+
+    return phases;
+  }
+
+  /**
+   * @brief Run an mpst case on the communicator.
+   * @param options Benchmark options.
+   * @param comm Communicator of the processes of the case.
+   * @param slabs Slab decomposition.
+   * @param result Result of the case.
+   */
+  void runMpstCase([[maybe_unused]] const Options& options,
+                   [[maybe_unused]] MPI_Comm       comm,
+                   [[maybe_unused]] const Slabs&   slabs,
+                   Result&                         result)
+  {
+#if defined(AFFT_ENABLE_MPI)
+    int commRank{};
+    MPI_Comm_rank(comm, &commRank);
+
+    const auto rank     = static_cast<std::size_t>(commRank);
+    const auto elemSize = complexSizeOf(result.precision);
+    const auto blocks   = makeSlabBlocks(slabs, rank);
+
+    std::vector<std::size_t> axes(slabs.shape.size());
+    std::iota(axes.begin(), axes.end(), std::size_t{});
+
+    const auto dftParams = makeDftParams(slabs.shape, axes, result.precision);
+
+    afft::mpst::MemoryLayout<> memoryLayout{};
+    memoryLayout.srcBlock = afft::MemoryBlock<>{blocks.srcStarts, blocks.srcSizes, blocks.srcStrides};
+    memoryLayout.dstBlock = afft::MemoryBlock<>{blocks.dstStarts, blocks.dstSizes, blocks.dstStrides};
+
+    const auto bufferSize = std::max(slabs.srcElemCount(rank), slabs.dstElemCount(rank)) * elemSize;
+
+    Buffer src{options.target, bufferSize};
+    Buffer dst{options.target, bufferSize};
+
+    std::unique_ptr<afft::Plan> plan{};
+
+    const double start = MPI_Wtime();
+
+    if (options.target == afft::Target::cpu)
+    {
+      afft::mpst::cpu::Parameters<> cpuParams{};
+      cpuParams.memoryLayout   = memoryLayout;
+      cpuParams.preserveSource = false;
+      cpuParams.communicator   = comm;
+
+      afft::mpst::cpu::BackendParameters backendParams{};
+      backendParams.mask = afft::BackendMask::empty | result.backend;
+
+      plan = afft::makePlan(dftParams, cpuParams, backendParams);
+    }
+    else
+    {
+      afft::mpst::gpu::Parameters<> gpuParams{};
+      gpuParams.memoryLayout   = memoryLayout;
+      gpuParams.preserveSource = false;
+      gpuParams.communicator   = comm;
+
+      afft::mpst::gpu::BackendParameters backendParams{};
+      backendParams.mask = afft::BackendMask::empty | result.backend;
+
+      plan = afft::makePlan(dftParams, gpuParams, backendParams);
+    }
+
+    double planTime = MPI_Wtime() - start;
+    MPI_Allreduce(MPI_IN_PLACE, &planTime, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+    result.planTime       = planTime;
+    result.medianExecTime = measure(options, comm, [&]{ plan->executeUnsafe(src.get(), dst.get()); },
+                                    [&]{ synchronize(options.target); }, result.minExecTime);
+#else
+    result.status = "afft is built without MPI";
+#endif
+  }
+
+  /**
+   * @brief Run an spmt case on the devices.
+   * @param options Benchmark options.
+   * @param shape Global shape.
+   * @param deviceCount Device count.
+   * @param result Result of the case.
+   */
+  void runSpmtCase([[maybe_unused]] const Options&                  options,
+                   [[maybe_unused]] const std::vector<std::size_t>& shape,
+                   [[maybe_unused]] std::size_t                     deviceCount,
+                   Result&                                          result)
+  {
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+    const auto elemSize  = complexSizeOf(result.precision);
+    const auto elemCount = std::accumulate(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>{});
+
+    std::vector<std::size_t> axes(shape.size());
+    std::iota(axes.begin(), axes.end(), std::size_t{});
+
+    std::vector<int> devices(deviceCount);
+    std::iota(devices.begin(), devices.end(), 0);
+
+    afft::spmt::gpu::Parameters<> gpuParams{};
+    gpuParams.preserveSource = false;
+    gpuParams.devices        = devices;
+
+    afft::spmt::gpu::BackendParameters backendParams{};
+    backendParams.mask = afft::BackendMask::empty | result.backend;
+
+    // each device holds a buffer of the global size, enough for any default decomposition of the backend
+    std::vector<Buffer> srcBuffers{};
+    std::vector<Buffer> dstBuffers{};
+    std::vector<void*>  srcs{};
+    std::vector<void*>  dsts{};
+
+    for (const auto device : devices)
+    {
+#   if defined(AFFT_ENABLE_CUDA)
+      afft::detail::cuda::ScopedDevice scopedDevice{device};
+#   else
+      afft::detail::hip::ScopedDevice scopedDevice{device};
+#   endif
+
+      srcs.push_back(srcBuffers.emplace_back(afft::Target::gpu, elemCount * elemSize).get());
+      dsts.push_back(dstBuffers.emplace_back(afft::Target::gpu, elemCount * elemSize).get());
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    auto plan = afft::makePlan(makeDftParams(shape, axes, result.precision), gpuParams, backendParams);
+
+    result.planTime = std::chrono::duration<double>{std::chrono::steady_clock::now() - start}.count();
+
+    auto sync = [&]
+    {
+      for (const auto device : devices)
+      {
+#     if defined(AFFT_ENABLE_CUDA)
+        afft::detail::cuda::ScopedDevice scopedDevice{device};
+#     else
+        afft::detail::hip::ScopedDevice scopedDevice{device};
+#     endif
+
+        synchronize(afft::Target::gpu);
+      }
+    };
+
+    result.medianExecTime = measure(options, MPI_COMM_SELF, [&]
+    {
+      plan->executeUnsafe(afft::View<void*>{srcs}, afft::View<void*>{dsts});
+    }, sync, result.minExecTime);
+#else
+    result.status = "afft is built without gpu support";
+#endif
+  }
+
+  [[nodiscard]] std::string shapeString(const std::vector<std::size_t>& shape)
+  {
+    std::string str{};
+
+    for (std::size_t i{}; i < shape.size(); ++i)
+    {
+      str += ((i > 0) ? "x" : "") + std::to_string(shape[i]);
+    }
+
+    return str;
+  }
+
+  [[nodiscard]] std::string quote(std::string_view str)
+  {
+    std::string quoted{"\""};
+
+    for (const char c : str)
+    {
+      if (c == '"' || c == '\\')
+      {
+        quoted += '\\';
+      }
+
+      quoted += (c == '\n') ? ' ' : c;
+    }
+
+    quoted += '"';
+
+    return quoted;
+  }
+
+  void printResult(const Options& options, const Result& result, bool isFirst)
+  {
+    const auto backend   = std::string{afft::toString(result.backend)};
+    const auto shape     = shapeString(result.shape);
+    const auto scaling   = (result.scaling == Scaling::strong) ? "strong" : "weak";
+    const auto precision = (result.precision == afft::Precision::f32) ? "f32" : "f64";
+    const auto target    = (options.target == afft::Target::cpu) ? "cpu" : "gpu";
+    const auto dist      = (options.distribution == afft::Distribution::mpst) ? "mpst" : "spmt";
+    const auto phases    = result.phases.value_or(Phases{});
+
+    if (options.csv)
+    {
+      if (isFirst)
+      {
+        std::printf("backend,target,distribution,scaling,shape,processes,precision,status,plan_time_s,"
+                    "median_exec_time_s,min_exec_time_s,gflops,efficiency,local_fft_s,pack_s,alltoall_s,unpack_s\n");
+      }
+
+      std::printf("%s,%s,%s,%s,%s,%zu,%s,%s,%.9g,%.9g,%.9g,%.6g,%.6g,%.9g,%.9g,%.9g,%.9g\n",
+                  quote(backend).c_str(), target, dist, scaling, shape.c_str(), result.processCount, precision,
+                  quote(result.status).c_str(), result.planTime, result.medianExecTime, result.minExecTime,
+                  result.gflops, result.efficiency.value_or(0.0), phases.localFft, phases.pack, phases.allToAll,
+                  phases.unpack);
+    }
+    else
+    {
+      std::printf("%s\n  {\"backend\": %s, \"target\": \"%s\", \"distribution\": \"%s\", \"scaling\": \"%s\", "
+                  "\"shape\": \"%s\", \"processes\": %zu, \"precision\": \"%s\", \"status\": %s, "
+                  "\"plan_time_s\": %.9g, \"median_exec_time_s\": %.9g, \"min_exec_time_s\": %.9g, \"gflops\": %.6g",
+                  (isFirst) ? "[" : ",", quote(backend).c_str(), target, dist, scaling, shape.c_str(),
+                  result.processCount, precision, quote(result.status).c_str(), result.planTime,
+                  result.medianExecTime, result.minExecTime, result.gflops);
+
+      if (result.efficiency)
+      {
+        std::printf(", \"efficiency\": %.6g", *result.efficiency);
+      }
+
+      if (result.phases)
+      {
+        std::printf(", \"local_fft_s\": %.9g, \"pack_s\": %.9g, \"alltoall_s\": %.9g, \"unpack_s\": %.9g",
+                    phases.localFft, phases.pack, phases.allToAll, phases.unpack);
+      }
+
+      std::printf("}");
+    }
+  }
+
+  /**
+   * @brief Set the throughput and the efficiency relative to the single process result.
+   * @param result Result.
+   * @param single Single process result of the same case, if measured.
+   */
+  void setDerived(Result& result, const Result* single)
+  {
+    if (!result.status.empty() || result.medianExecTime <= 0.0)
+    {
+      return;
+    }
+
+    const auto elemCount = std::accumulate(result.shape.begin(), result.shape.end(), 1.0, std::multiplies<>{});
+
+    result.gflops = 5.0 * elemCount * std::log2(elemCount) / result.medianExecTime * 1e-9;
+
+    if (single != nullptr && single->status.empty() && single->medianExecTime > 0.0)
+    {
+      result.efficiency = (result.scaling == Scaling::strong)
+        ? single->medianExecTime / (static_cast<double>(result.processCount) * result.medianExecTime)
+        : single->medianExecTime / result.medianExecTime;
+    }
+  }
+} // namespace
+
+int main(int argc, char** argv)
+{
+  int provided{};
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+  MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+
+  const auto options = parseOptions(argc, argv);
+
+#if defined(AFFT_ENABLE_CUDA)
+  if (options.target == afft::Target::gpu && getDeviceCount() > 0)
+  {
+    afft::detail::cuda::checkError(cudaSetDevice(worldRank % static_cast<int>(getDeviceCount())));
+  }
+#elif defined(AFFT_ENABLE_HIP)
+  if (options.target == afft::Target::gpu && getDeviceCount() > 0)
+  {
+    afft::detail::hip::checkError(hipSetDevice(worldRank % static_cast<int>(getDeviceCount())));
+  }
+#endif
+
+  afft::init();
+
+  const bool isSpmt   = (options.distribution == afft::Distribution::spmt);
+  const auto maxCount = (isSpmt) ? std::max<std::size_t>(std::min(getDeviceCount(), (options.maxDeviceCount > 0)
+                                                                    ? options.maxDeviceCount : getDeviceCount()), 1)
+                                 : static_cast<std::size_t>(worldSize);
+
+  bool isFirst{true};
+
+  for (const auto& baseShape : options.shapes)
+  for (const auto scaling : options.scalings)
+  for (const auto precision : options.precisions)
+  for (const auto backend : options.backends)
+  {
+    std::optional<Result> single{};
+
+    for (const auto count : getCounts(maxCount))
+    {
+      Result result{};
+      result.backend      = backend;
+      result.scaling      = scaling;
+      result.shape        = baseShape;
+      result.processCount = count;
+      result.precision    = precision;
+
+      if (scaling == Scaling::weak)
+      {
+        result.shape[0] *= count;
+      }
+
+      if (isSpmt)
+      {
+        if (worldRank == 0)
+        {
+          try
+          {
+            runSpmtCase(options, result.shape, count, result);
+          }
+          catch (const std::exception& e)
+          {
+            result.status = e.what();
+          }
+        }
+      }
+      else
+      {
+        MPI_Comm comm{};
+        MPI_Comm_split(MPI_COMM_WORLD, (static_cast<std::size_t>(worldRank) < count) ? 0 : MPI_UNDEFINED, worldRank, &comm);
+
+        if (comm != MPI_COMM_NULL)
+        {
+          const Slabs slabs{result.shape, count, (result.shape.size() > 2) ? result.shape[2] : 1};
+
+          // a failure of one process fails the case on all of them, the collectives stay matched
+          std::string status{};
+
+          try
+          {
+            runMpstCase(options, comm, slabs, result);
+          }
+          catch (const std::exception& e)
+          {
+            status = e.what();
+          }
+
+          int failed = !status.empty();
+          MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, comm);
+
+          if (failed && result.status.empty())
+          {
+            result.status = (status.empty()) ? "failed on another process" : status;
+          }
+
+          // the reference pipeline depends on the decomposition only, it is measured with the first backend
+          if (options.phases && backend == options.backends.front())
+          {
+            try
+            {
+              result.phases = runReferencePipeline(options, comm, slabs, precision);
+            }
+            catch (const std::exception&)
+            {
+              result.phases.reset();
+            }
+          }
+
+          MPI_Comm_free(&comm);
+        }
+      }
+
+      MPI_Barrier(MPI_COMM_WORLD);
+
+      setDerived(result, (single) ? &*single : nullptr);
+
+      if (count == 1)
+      {
+        single = result;
+      }
+
+      if (worldRank == 0)
+      {
+        printResult(options, result, isFirst);
+        std::fflush(stdout);
+        isFirst = false;
+      }
+    }
+  }
+
+  if (worldRank == 0 && !options.csv)
+  {
+    std::printf("%s\n", (isFirst) ? "[]" : "\n]");
+  }
+
+  afft::finalize();
+
+  MPI_Finalize();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+#include <afft/afft.hpp>
+
+template<typename T>
+using AlignedVector = std::vector<T, afft::cpu::AlignedAllocator<T>>;
+
+template<typename F>
+double measureNsPerCall(std::size_t iterations, F&& fn)
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  for (std::size_t i{}; i < iterations; ++i)
+  {
+    fn();
+  }
+
+  const auto stop = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(iterations);
+}
+
+int main(void)
+{
+  using PrecT = float;
+
+  constexpr std::size_t size{64};           // small transform, the per call overhead is significant
+  constexpr std::size_t iterations{100000}; // number of measured executions
+
+  afft::init(); // initialize afft library
+
+  AlignedVector<std::complex<PrecT>> src(size); // source vector
+  AlignedVector<std::complex<PrecT>> dst(size); // destination vector
+
+  afft::dft::Parameters dftParams{}; // parameters for dft
+  dftParams.direction = afft::Direction::forward; // it will be a forward transform
+  dftParams.precision = afft::makePrecision<PrecT>(); // set up precision of the transform
+  dftParams.shape     = {{size}}; // set up the dimensions
+  dftParams.type      = afft::dft::Type::complexToComplex; // let's use complex-to-complex transform
+
+  afft::cpu::Parameters cpuParams{}; // it will run on a cpu
+  cpuParams.alignment   = afft::alignmentOf(src.data(), dst.data()); // get alignment of the pointers
+  cpuParams.threadLimit = 1; // single thread, we measure the library overhead
+
+  auto plan = afft::makePlan(dftParams, cpuParams); // generate the plan of the transform
+
+  // validate the types and the execution parameters once, calls skip all checks
+  auto exec = plan->bind<std::complex<PrecT>, std::complex<PrecT>>();
+
+  // warm up both paths
+  plan->execute(src.data(), dst.data());
+  exec(src.data(), dst.data());
+
+  const double executeNs = measureNsPerCall(iterations, [&]{ plan->execute(src.data(), dst.data()); });
+  const double boundNs   = measureNsPerCall(iterations, [&]{ exec(src.data(), dst.data()); });
+
+  std::printf("execute(): %8.1f ns per call\n", executeNs);
+  std::printf("bind():    %8.1f ns per call\n", boundNs);
+  std::printf("overhead:  %8.1f ns per call\n", executeNs - boundNs);
+}
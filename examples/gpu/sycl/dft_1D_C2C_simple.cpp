@@ -0,0 +1,45 @@
+#include <complex>
+
+#include <afft/afft.hpp>
+
+int main(void)
+{
+  using PrecT = float;
+
+  constexpr std::size_t size{1024}; // size of the transform
+
+  afft::init(); // initialize afft library
+
+  sycl::queue queue{sycl::gpu_selector_v}; // queue on a gpu, it must outlive the plan
+
+  auto* src = sycl::malloc_shared<std::complex<PrecT>>(size, queue); // source buffer
+  auto* dst = sycl::malloc_shared<std::complex<PrecT>>(size, queue); // destination buffer
+
+  // initialize source buffer
+
+  afft::dft::Parameters dftParams{}; // parameters for dft
+  dftParams.direction     = afft::Direction::forward; // it will be a forward transform
+  dftParams.precision     = afft::makePrecision<PrecT>(); // set up precision of the transform
+  dftParams.shape         = {{size}}; // set up the dimensions
+  dftParams.type          = afft::dft::Type::complexToComplex; // let's use complex-to-complex transform
+
+  afft::gpu::Parameters gpuParams{}; // it will run on a gpu
+  gpuParams.queue          = &queue; // set up the queue the plan is committed to
+  gpuParams.preserveSource = false; // allow to destroy source data
+
+  auto plan = afft::makePlan(dftParams, gpuParams); // generate the plan of the transform
+
+  sycl::event event{}; // completion event of the transform
+
+  afft::gpu::ExecutionParameters execParams{};
+  execParams.completionEvent = &event; // get the event of the transform
+
+  plan->execute(src, dst, execParams); // submit the transform to the queue
+
+  event.wait(); // wait for the transform to finish
+
+  // use results from dst buffer
+
+  sycl::free(src, queue);
+  sycl::free(dst, queue);
+}
@@ -0,0 +1,391 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_BATCHED_EXECUTOR_HPP
+#define AFFT_BATCHED_EXECUTOR_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "makePlan.hpp"
+#include "Plan.hpp"
+#include "PlanCache.hpp"
+
+AFFT_EXPORT namespace afft
+{
+  /**
+   * @class BatchedExecutor
+   * @brief Executes a transform over a batch whose count and distances are given at execution time. The batch is
+   *        split into power of two parts, each executed by a plan batching the transform along a new outermost axis,
+   *        so the plans of at most log2(maxBatchCount) + 1 batch counts are created for each pair of distances and
+   *        reused from the internal plan cache. Only spst plans with the interleaved complex format are supported,
+   *        the transform must not use a logical source shape or a destination window. The executor is not thread
+   *        safe.
+   */
+  class BatchedExecutor
+  {
+    public:
+      /**
+       * @brief Constructor, no plan is created until the first execution.
+       * @tparam TransformParamsT Transform parameters type
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param transformParams Parameters of a single transform of the batch
+       * @param archParams Architecture parameters, the memory layout describes a single transform
+       * @param maxBatchCount The largest batch count a single plan is created for, larger batches are executed in
+       *                      parts of at most this count
+       * @param backendParams Backend parameters, the memory they reference must outlive the executor
+       */
+      template<typename TransformParamsT, typename ArchParamsT, typename BackendParamsT = detail::DefaultBackendParameters>
+      BatchedExecutor(const TransformParamsT& transformParams,
+                      const ArchParamsT&      archParams,
+                      std::size_t             maxBatchCount,
+                      const BackendParamsT&   backendParams = {})
+      : mDesc{transformParams, archParams}
+      {
+        static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+        static_assert(ArchParamsT::distribution == Distribution::spst, "batched execution supports only spst plans");
+
+        if (maxBatchCount == 0)
+        {
+          throw std::invalid_argument("maximum batch count must be greater than zero");
+        }
+
+        if (mDesc.getShapeRank() >= maxDimCount)
+        {
+          throw std::invalid_argument("batched execution requires a shape rank lower than the maximum dimension count");
+        }
+
+        if (mDesc.getComplexFormat() != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument("batched execution supports only interleaved complex format");
+        }
+
+        if (mDesc.hasLogicalSrcShape() || mDesc.hasDstWindow())
+        {
+          throw std::invalid_argument("batched execution does not support logical source shape or destination window");
+        }
+
+        mDesc.fillDefaultMemoryLayoutStrides();
+
+        mMaxPartCount = std::size_t{1};
+
+        while (mMaxPartCount <= maxBatchCount / 2)
+        {
+          mMaxPartCount *= 2;
+        }
+
+        mMakePlan = [backendParams](const detail::Desc& desc) -> std::unique_ptr<Plan>
+        {
+          if constexpr (std::is_same_v<BackendParamsT, detail::DefaultBackendParameters>)
+          {
+            return detail::makePlan(desc, BackendParameters<ArchParamsT::target, ArchParamsT::distribution>{});
+          }
+          else
+          {
+            return detail::makePlan(desc, backendParams);
+          }
+        };
+      }
+
+      /// @brief Copy constructor is deleted.
+      BatchedExecutor(const BatchedExecutor&) = delete;
+
+      /// @brief Move constructor.
+      BatchedExecutor(BatchedExecutor&&) = default;
+
+      /// @brief Destructor.
+      ~BatchedExecutor() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      BatchedExecutor& operator=(const BatchedExecutor&) = delete;
+
+      /// @brief Move assignment operator.
+      BatchedExecutor& operator=(BatchedExecutor&&) = default;
+
+      /**
+       * @brief Get the default source distance, the element count spanned by the source of a single transform.
+       * @return Source distance in elements.
+       */
+      [[nodiscard]] std::size_t getDefaultSrcDistance() const
+      {
+        const auto srcShape = mDesc.getSrcShape();
+
+        return getSpan(View<std::size_t>{srcShape.data(), mDesc.getShapeRank()},
+                       mDesc.getMemoryLayout<Distribution::spst>().getSrcStrides());
+      }
+
+      /**
+       * @brief Get the default destination distance, the element count spanned by the destination of a single
+       *        transform.
+       * @return Destination distance in elements.
+       */
+      [[nodiscard]] std::size_t getDefaultDstDistance() const
+      {
+        const auto dstShape = mDesc.getDstShape();
+
+        return getSpan(View<std::size_t>{dstShape.data(), mDesc.getShapeRank()},
+                       mDesc.getMemoryLayout<Distribution::spst>().getDstStrides());
+      }
+
+      /**
+       * @brief Get the internal plan cache, e.g. to limit its size or to serialize the plans.
+       * @return Plan cache.
+       */
+      [[nodiscard]] PlanCache& getPlanCache() noexcept
+      {
+        return mCache;
+      }
+
+      /**
+       * @brief Execute the batch with the default distances, see getDefaultSrcDistance() and getDefaultDstDistance().
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @param src Source buffer.
+       * @param dst Destination buffer, equal to the source for in-place transforms.
+       * @param batchCount The number of transforms.
+       */
+      template<typename SrcT, typename DstT>
+      void execute(SrcT* src, DstT* dst, std::size_t batchCount)
+      {
+        execute(src, dst, batchCount, getDefaultSrcDistance(), getDefaultDstDistance());
+      }
+
+      /**
+       * @brief Execute the batch.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @param src Source buffer.
+       * @param dst Destination buffer, equal to the source for in-place transforms.
+       * @param batchCount The number of transforms.
+       * @param srcDistance Distance between the sources of consecutive transforms in elements.
+       * @param dstDistance Distance between the destinations of consecutive transforms in elements.
+       */
+      template<typename SrcT, typename DstT>
+      void execute(SrcT* src, DstT* dst, std::size_t batchCount, std::size_t srcDistance, std::size_t dstDistance)
+      {
+        executeParts(src, dst, batchCount, srcDistance, dstDistance, [](Plan& plan, SrcT* partSrc, DstT* partDst)
+        {
+          plan.execute(partSrc, partDst);
+        });
+      }
+
+      /**
+       * @brief Execute the batch with execution parameters.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param src Source buffer.
+       * @param dst Destination buffer, equal to the source for in-place transforms.
+       * @param batchCount The number of transforms.
+       * @param srcDistance Distance between the sources of consecutive transforms in elements.
+       * @param dstDistance Distance between the destinations of consecutive transforms in elements.
+       * @param execParams Execution parameters, passed to every part.
+       */
+      template<typename SrcT, typename DstT, typename ExecParamsT>
+      void execute(SrcT*              src,
+                   DstT*              dst,
+                   std::size_t        batchCount,
+                   std::size_t        srcDistance,
+                   std::size_t        dstDistance,
+                   const ExecParamsT& execParams)
+      {
+        static_assert(isExecutionParameters<ExecParamsT>, "invalid execution parameters type");
+
+        executeParts(src, dst, batchCount, srcDistance, dstDistance, [&](Plan& plan, SrcT* partSrc, DstT* partDst)
+        {
+          plan.execute(partSrc, partDst, execParams);
+        });
+      }
+
+    private:
+      /**
+       * @brief Get the element count spanned by a strided array.
+       * @param shape The shape.
+       * @param strides The strides.
+       * @return Element count.
+       */
+      [[nodiscard]] static std::size_t getSpan(View<std::size_t> shape, View<std::size_t> strides)
+      {
+        std::size_t span{1};
+
+        for (std::size_t i{}; i < shape.size(); ++i)
+        {
+          span += (shape[i] - 1) * strides[i];
+        }
+
+        return span;
+      }
+
+      /**
+       * @brief Split the batch into power of two parts and execute each of them.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @tparam ExecuteFnT Execute function type.
+       * @param src Source buffer.
+       * @param dst Destination buffer.
+       * @param batchCount The number of transforms.
+       * @param srcDistance Source distance in elements.
+       * @param dstDistance Destination distance in elements.
+       * @param executeFn Function executing a plan on a part.
+       */
+      template<typename SrcT, typename DstT, typename ExecuteFnT>
+      void executeParts(SrcT*        src,
+                        DstT*        dst,
+                        std::size_t  batchCount,
+                        std::size_t  srcDistance,
+                        std::size_t  dstDistance,
+                        ExecuteFnT&& executeFn)
+      {
+        static_assert(!std::is_void_v<SrcT> && !std::is_void_v<DstT>, "batched execution requires typed buffers");
+
+        if (batchCount == 0)
+        {
+          return;
+        }
+
+        if (src == nullptr || dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as batch buffer");
+        }
+
+        if (srcDistance == 0 || dstDistance == 0)
+        {
+          throw std::invalid_argument("batch distances must be greater than zero");
+        }
+
+        std::size_t partCount{mMaxPartCount};
+
+        while (batchCount > 0)
+        {
+          while (partCount > batchCount)
+          {
+            partCount /= 2;
+          }
+
+          auto plan = getPlan(partCount, srcDistance, dstDistance);
+
+          executeFn(*plan, src, dst);
+
+          src        += partCount * srcDistance;
+          dst        += partCount * dstDistance;
+          batchCount -= partCount;
+        }
+      }
+
+      /**
+       * @brief Get the plan of a batch count, created on the first use.
+       * @param batchCount The batch count.
+       * @param srcDistance Source distance in elements.
+       * @param dstDistance Destination distance in elements.
+       * @return Plan.
+       */
+      [[nodiscard]] std::shared_ptr<Plan> getPlan(std::size_t batchCount, std::size_t srcDistance, std::size_t dstDistance)
+      {
+        switch (mDesc.getTransform())
+        {
+        case Transform::dft:
+          return getPlan(mDesc.getTransformParameters<Transform::dft>(), batchCount, srcDistance, dstDistance);
+        case Transform::dht:
+          return getPlan(mDesc.getTransformParameters<Transform::dht>(), batchCount, srcDistance, dstDistance);
+        case Transform::dtt:
+          return getPlan(mDesc.getTransformParameters<Transform::dtt>(), batchCount, srcDistance, dstDistance);
+        default:
+          detail::cxx::unreachable();
+        }
+      }
+
+      /**
+       * @brief Get the plan batching the transform along a new outermost axis.
+       * @tparam TransformParamsT Transform parameters type.
+       * @param transformParams Parameters of a single transform.
+       * @param batchCount The batch count.
+       * @param srcDistance Source distance in elements.
+       * @param dstDistance Destination distance in elements.
+       * @return Plan.
+       */
+      template<typename TransformParamsT>
+      [[nodiscard]] std::shared_ptr<Plan> getPlan(TransformParamsT transformParams,
+                                                  std::size_t      batchCount,
+                                                  std::size_t      srcDistance,
+                                                  std::size_t      dstDistance)
+      {
+        const std::size_t shapeRank = mDesc.getShapeRank();
+
+        detail::MaxDimArray<std::size_t> shape{};
+        detail::MaxDimArray<std::size_t> axes{};
+        detail::MaxDimArray<std::size_t> srcStrides{};
+        detail::MaxDimArray<std::size_t> dstStrides{};
+
+        shape[0] = batchCount;
+        std::copy(transformParams.shape.begin(), transformParams.shape.end(), shape.begin() + 1);
+        std::transform(transformParams.axes.begin(), transformParams.axes.end(), axes.begin(), [](std::size_t axis)
+        {
+          return axis + 1;
+        });
+
+        const auto& memoryLayout = mDesc.getMemoryLayout<Distribution::spst>();
+
+        srcStrides[0] = srcDistance;
+        dstStrides[0] = dstDistance;
+        std::copy(memoryLayout.getSrcStrides().begin(), memoryLayout.getSrcStrides().end(), srcStrides.begin() + 1);
+        std::copy(memoryLayout.getDstStrides().begin(), memoryLayout.getDstStrides().end(), dstStrides.begin() + 1);
+
+        transformParams.shape = View<std::size_t>{shape.data(), shapeRank + 1};
+        transformParams.axes  = View<std::size_t>{axes.data(), transformParams.axes.size()};
+
+        auto findOrCreate = [&](auto archParams)
+        {
+          archParams.memoryLayout.srcStrides = View<std::size_t>{srcStrides.data(), shapeRank + 1};
+          archParams.memoryLayout.dstStrides = View<std::size_t>{dstStrides.data(), shapeRank + 1};
+
+          return mCache.findOrCreate(transformParams, archParams, [&]()
+          {
+            return mMakePlan(detail::Desc{transformParams, archParams});
+          });
+        };
+
+        switch (mDesc.getTarget())
+        {
+        case Target::cpu:
+          return findOrCreate(mDesc.getArchitectureParameters<Target::cpu, Distribution::spst>());
+#     if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        case Target::gpu:
+          return findOrCreate(mDesc.getArchitectureParameters<Target::gpu, Distribution::spst>());
+#     endif
+        default:
+          throw std::invalid_argument("unsupported batched execution target");
+        }
+      }
+
+      detail::Desc                                              mDesc;           ///< Description of a single transform.
+      std::size_t                                               mMaxPartCount{}; ///< The largest part batch count.
+      std::function<std::unique_ptr<Plan>(const detail::Desc&)> mMakePlan{};     ///< Creates the plan of a description.
+      PlanCache                                                 mCache{};        ///< The plans of the parts.
+  };
+} // namespace afft
+
+#endif /* AFFT_BATCHED_EXECUTOR_HPP */
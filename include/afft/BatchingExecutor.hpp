@@ -0,0 +1,440 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_BATCHING_EXECUTOR_HPP
+#define AFFT_BATCHING_EXECUTOR_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "BatchedExecutor.hpp"
+
+AFFT_EXPORT namespace afft::gpu
+{
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+  /**
+   * @class BatchingExecutor
+   * @brief Executes single transforms submitted concurrently by many threads as batched launches. The requests are
+   *        collected until maxBatchCount of them are pending or maxDelay passed since the first one. The sources of a
+   *        collected batch are gathered into a contiguous device staging buffer and transformed by the batched plans
+   *        of a BatchedExecutor with one launch per power of two part. The results are then scattered into the
+   *        destinations, and the futures of the requests complete after the executor's stream synchronizes. All work
+   *        runs on the executor's worker thread and stream, so a source must be ready on the device when it is
+   *        submitted, and its buffers must not be touched until its future completes. Only spst gpu plans with the
+   *        interleaved complex format are supported, and the buffers may be device, managed or page-locked host
+   *        memory.
+   * @tparam SrcT Source type.
+   * @tparam DstT Destination type.
+   */
+  template<typename SrcT, typename DstT>
+  class BatchingExecutor
+  {
+    static_assert(!std::is_void_v<SrcT> && !std::is_void_v<DstT>, "batching execution requires typed buffers");
+    static_assert(!std::is_const_v<SrcT> && !std::is_const_v<DstT>, "batching execution requires non-const types");
+
+    public:
+#   if defined(AFFT_ENABLE_CUDA)
+      /// @brief Stream type.
+      using Stream = cudaStream_t;
+#   elif defined(AFFT_ENABLE_HIP)
+      /// @brief Stream type.
+      using Stream = hipStream_t;
+#   endif
+
+      /// @brief Default largest number of requests launched as one batch.
+      static constexpr std::size_t defaultMaxBatchCount{64};
+
+      /// @brief Default time the first pending request waits for others to join its batch.
+      static constexpr std::chrono::microseconds defaultMaxDelay{100};
+
+      /**
+       * @brief Constructor, allocates the staging buffers and starts the worker thread. No plan is created until the
+       *        first batch.
+       * @tparam TransformParamsT Transform parameters type
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param transformParams Parameters of a single transform
+       * @param archParams Architecture parameters of a spst gpu transform, the memory layout describes a single
+       *                   transform
+       * @param maxBatchCount The largest number of requests launched as one batch
+       * @param maxDelay The longest time the first pending request waits for others to join its batch
+       * @param backendParams Backend parameters, the memory they reference must outlive the executor
+       */
+      template<typename TransformParamsT, typename ArchParamsT, typename BackendParamsT = detail::DefaultBackendParameters>
+      BatchingExecutor(const TransformParamsT&   transformParams,
+                       const ArchParamsT&        archParams,
+                       std::size_t               maxBatchCount = defaultMaxBatchCount,
+                       std::chrono::microseconds maxDelay      = defaultMaxDelay,
+                       const BackendParamsT&     backendParams = {})
+      : mBatched{transformParams, archParams, maxBatchCount, backendParams},
+        mMaxBatchCount{maxBatchCount},
+        mMaxDelay{maxDelay},
+        mDevice{archParams.device}
+      {
+        static_assert(ArchParamsT::target == Target::gpu, "batching execution supports only gpu plans");
+
+        const bool isInPlace = (transformParams.placement == Placement::inPlace);
+
+        mSrcSize = mBatched.getDefaultSrcDistance() * sizeof(SrcT);
+        mDstSize = mBatched.getDefaultDstDistance() * sizeof(DstT);
+
+        // in-place requests occupy the same span in the staging buffer, aligned to both element types
+        if (isInPlace)
+        {
+          const std::size_t elemSize = std::max(sizeof(SrcT), sizeof(DstT));
+
+          mSrcStride = mDstStride = (std::max(mSrcSize, mDstSize) + elemSize - 1) / elemSize * elemSize;
+        }
+        else
+        {
+          mSrcStride = mSrcSize;
+          mDstStride = mDstSize;
+        }
+
+        try
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+          detail::cuda::checkError(cudaStreamCreateWithFlags(&mStream, cudaStreamNonBlocking));
+          detail::cuda::checkError(cudaMalloc(&mSrcStaging, mMaxBatchCount * mSrcStride));
+
+          if (isInPlace)
+          {
+            mDstStaging = mSrcStaging;
+          }
+          else
+          {
+            detail::cuda::checkError(cudaMalloc(&mDstStaging, mMaxBatchCount * mDstStride));
+          }
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{mDevice};
+
+          detail::hip::checkError(hipStreamCreateWithFlags(&mStream, hipStreamNonBlocking));
+          detail::hip::checkError(hipMalloc(&mSrcStaging, mMaxBatchCount * mSrcStride));
+
+          if (isInPlace)
+          {
+            mDstStaging = mSrcStaging;
+          }
+          else
+          {
+            detail::hip::checkError(hipMalloc(&mDstStaging, mMaxBatchCount * mDstStride));
+          }
+#       endif
+
+          mWorker = std::thread{[this] { run(); }};
+        }
+        catch (...)
+        {
+          destroyStaging();
+          throw;
+        }
+      }
+
+      /// @brief Copy constructor is deleted.
+      BatchingExecutor(const BatchingExecutor&) = delete;
+
+      /// @brief Move constructor is deleted.
+      BatchingExecutor(BatchingExecutor&&) = delete;
+
+      /// @brief Destructor, executes the pending requests, stops the worker and frees the staging buffers.
+      ~BatchingExecutor()
+      {
+        {
+          std::lock_guard lock{mMutex};
+          mStop = true;
+        }
+
+        mCondition.notify_all();
+        mWorker.join();
+
+        destroyStaging();
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      BatchingExecutor& operator=(const BatchingExecutor&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      BatchingExecutor& operator=(BatchingExecutor&&) = delete;
+
+      /**
+       * @brief Submit a single transform, thread safe.
+       * @param src Source buffer of a single transform.
+       * @param dst Destination buffer of a single transform, equal to the source for in-place transforms.
+       * @return Future completed when the destination holds the result, it holds the exception if the batch failed.
+       */
+      [[nodiscard]] std::future<void> submit(SrcT* src, DstT* dst)
+      {
+        if (src == nullptr || dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as request buffer");
+        }
+
+        Request request{src, dst, {}};
+
+        auto future = request.promise.get_future();
+
+        bool isFull{};
+
+        {
+          std::lock_guard lock{mMutex};
+
+          if (mStop)
+          {
+            throw std::runtime_error("batching executor is stopped");
+          }
+
+          if (mQueue.empty())
+          {
+            mFirstRequestTime = std::chrono::steady_clock::now();
+          }
+
+          mQueue.push_back(std::move(request));
+
+          isFull = (mQueue.size() == 1 || mQueue.size() >= mMaxBatchCount);
+        }
+
+        // the worker waits either for the first request or for a full batch
+        if (isFull)
+        {
+          mCondition.notify_one();
+        }
+
+        return future;
+      }
+
+      /**
+       * @brief Get the number of requests executed so far.
+       * @return The request count.
+       */
+      [[nodiscard]] std::size_t getRequestCount() const noexcept
+      {
+        return mRequestCount.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Get the number of batches executed so far, getRequestCount() / getBatchCount() is the mean batch size.
+       * @return The batch count.
+       */
+      [[nodiscard]] std::size_t getBatchCount() const noexcept
+      {
+        return mBatchCount.load(std::memory_order_relaxed);
+      }
+
+    private:
+      /// @brief A submitted transform.
+      struct Request
+      {
+        SrcT*              src{};     ///< The source buffer.
+        DstT*              dst{};     ///< The destination buffer.
+        std::promise<void> promise{}; ///< The promise completed after the result is copied.
+      };
+
+      /// @brief Collect and execute the batches until stopped, then execute the remaining requests.
+      void run()
+      {
+        std::vector<Request> batch{};
+
+        batch.reserve(mMaxBatchCount);
+
+        while (true)
+        {
+          {
+            std::unique_lock lock{mMutex};
+
+            mCondition.wait(lock, [this] { return mStop || !mQueue.empty(); });
+
+            if (mQueue.empty())
+            {
+              return;
+            }
+
+            mCondition.wait_until(lock, mFirstRequestTime + mMaxDelay, [this]
+            {
+              return mStop || mQueue.size() >= mMaxBatchCount;
+            });
+
+            const auto count = std::min(mQueue.size(), mMaxBatchCount);
+
+            std::move(mQueue.begin(), mQueue.begin() + static_cast<std::ptrdiff_t>(count), std::back_inserter(batch));
+            mQueue.erase(mQueue.begin(), mQueue.begin() + static_cast<std::ptrdiff_t>(count));
+
+            // the remaining requests waited since the batch was collected
+            mFirstRequestTime = std::chrono::steady_clock::now();
+          }
+
+          executeBatch(batch);
+
+          batch.clear();
+        }
+      }
+
+      /**
+       * @brief Gather the sources, execute the batch and scatter the destinations, completes the futures.
+       * @param batch The requests.
+       */
+      void executeBatch(std::vector<Request>& batch) noexcept
+      {
+        try
+        {
+          auto* srcStaging = static_cast<std::byte*>(mSrcStaging);
+          auto* dstStaging = static_cast<std::byte*>(mDstStaging);
+
+          afft::spst::gpu::ExecutionParameters execParams{};
+          execParams.stream = mStream;
+
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+          for (std::size_t i{}; i < batch.size(); ++i)
+          {
+            detail::cuda::checkError(cudaMemcpyAsync(srcStaging + i * mSrcStride, batch[i].src, mSrcSize,
+                                                     cudaMemcpyDefault, mStream));
+          }
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{mDevice};
+
+          for (std::size_t i{}; i < batch.size(); ++i)
+          {
+            detail::hip::checkError(hipMemcpyAsync(srcStaging + i * mSrcStride, batch[i].src, mSrcSize,
+                                                   hipMemcpyDefault, mStream));
+          }
+#       endif
+
+          mBatched.execute(reinterpret_cast<SrcT*>(srcStaging),
+                           reinterpret_cast<DstT*>(dstStaging),
+                           batch.size(),
+                           mSrcStride / sizeof(SrcT),
+                           mDstStride / sizeof(DstT),
+                           execParams);
+
+#       if defined(AFFT_ENABLE_CUDA)
+          for (std::size_t i{}; i < batch.size(); ++i)
+          {
+            detail::cuda::checkError(cudaMemcpyAsync(batch[i].dst, dstStaging + i * mDstStride, mDstSize,
+                                                     cudaMemcpyDefault, mStream));
+          }
+
+          detail::cuda::checkError(cudaStreamSynchronize(mStream));
+#       elif defined(AFFT_ENABLE_HIP)
+          for (std::size_t i{}; i < batch.size(); ++i)
+          {
+            detail::hip::checkError(hipMemcpyAsync(batch[i].dst, dstStaging + i * mDstStride, mDstSize,
+                                                   hipMemcpyDefault, mStream));
+          }
+
+          detail::hip::checkError(hipStreamSynchronize(mStream));
+#       endif
+
+          mRequestCount.fetch_add(batch.size(), std::memory_order_relaxed);
+          mBatchCount.fetch_add(1, std::memory_order_relaxed);
+
+          for (auto& request : batch)
+          {
+            request.promise.set_value();
+          }
+        }
+        catch (...)
+        {
+          for (auto& request : batch)
+          {
+            request.promise.set_exception(std::current_exception());
+          }
+        }
+      }
+
+      /// @brief Wait for the stream, free the staging buffers and destroy the stream, errors are ignored.
+      void destroyStaging() noexcept
+      {
+        try
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+          if (mStream != nullptr)
+          {
+            cudaStreamSynchronize(mStream);
+            cudaStreamDestroy(mStream);
+          }
+
+          if (mDstStaging != mSrcStaging)
+          {
+            cudaFree(mDstStaging);
+          }
+
+          cudaFree(mSrcStaging);
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{mDevice};
+
+          if (mStream != nullptr)
+          {
+            hipStreamSynchronize(mStream);
+            hipStreamDestroy(mStream);
+          }
+
+          if (mDstStaging != mSrcStaging)
+          {
+            hipFree(mDstStaging);
+          }
+
+          hipFree(mSrcStaging);
+#       endif
+        }
+        catch (...)
+        {
+          // The device may already be torn down at exit
+        }
+
+        mStream     = {};
+        mSrcStaging = nullptr;
+        mDstStaging = nullptr;
+      }
+
+      BatchedExecutor                       mBatched;            ///< The batched plans, used by the worker only.
+      std::size_t                           mMaxBatchCount{};    ///< The largest number of requests of a batch.
+      std::chrono::microseconds             mMaxDelay{};         ///< The longest wait of the first pending request.
+      int                                   mDevice{};           ///< The device of the plans.
+      std::size_t                           mSrcSize{};          ///< The source size of a request in bytes.
+      std::size_t                           mDstSize{};          ///< The destination size of a request in bytes.
+      std::size_t                           mSrcStride{};        ///< The source staging stride between requests in bytes.
+      std::size_t                           mDstStride{};        ///< The destination staging stride between requests in bytes.
+      Stream                                mStream{};           ///< The stream of the whole batch.
+      void*                                 mSrcStaging{};       ///< The source staging buffer.
+      void*                                 mDstStaging{};       ///< The destination staging buffer, the source one for in-place plans.
+      std::mutex                            mMutex{};            ///< Guards the queue and the stop flag.
+      std::condition_variable               mCondition{};        ///< Signals the worker.
+      std::deque<Request>                   mQueue{};            ///< The pending requests.
+      std::chrono::steady_clock::time_point mFirstRequestTime{}; ///< When the oldest pending request started waiting.
+      bool                                  mStop{};             ///< The destructor stops the worker.
+      std::atomic<std::size_t>              mRequestCount{};     ///< The executed requests.
+      std::atomic<std::size_t>              mBatchCount{};       ///< The executed batches.
+      std::thread                           mWorker{};           ///< The worker thread.
+  };
+#endif
+} // namespace afft::gpu
+
+#endif /* AFFT_BATCHING_EXECUTOR_HPP */
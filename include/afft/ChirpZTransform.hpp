@@ -0,0 +1,317 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_CHIRP_Z_TRANSFORM_HPP
+#define AFFT_CHIRP_Z_TRANSFORM_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "alloc.hpp"
+#include "architecture.hpp"
+#include "makePlan.hpp"
+#include "Plan.hpp"
+#include "detail/chirpZ.hpp"
+
+AFFT_EXPORT namespace afft
+{
+namespace czt
+{
+  /**
+   * @struct Parameters
+   * @brief Parameters of the chirp z-transform X[k] = sum_n x[n] e^{-i (startAngle + stepAngle k) n} along one axis,
+   *        the outputs lie on an arc of the unit circle. The zoomed DFT of the band [startAngle, startAngle +
+   *        stepAngle * dstLength) is the transform of an arc of stepAngle smaller than 2pi / length.
+   * @tparam shapeExt Extent of the shape
+   */
+  template<std::size_t shapeExt = dynamicExtent>
+  struct Parameters
+  {
+    Precision                   precision{Precision::f32}; ///< precision of the source, destination and execution, f32 or f64
+    View<std::size_t, shapeExt> shape{};                   ///< shape of the source
+    std::size_t                 axis{};                    ///< axis of the transform
+    std::size_t                 dstLength{};               ///< number of outputs along the axis
+    double                      startAngle{};              ///< angle of the first output in radians
+    double                      stepAngle{};               ///< angle between the neighbouring outputs in radians
+  };
+} // namespace czt
+
+  /**
+   * @class ChirpZTransform
+   * @brief Chirp z-transform of complex data along one axis by the Bluestein algorithm. Owns the power of two plans,
+   *        the chirp sequences and the kernel spectrum, so repeated executions do not allocate. The source and the
+   *        destination are contiguous interleaved complex arrays, the destination has the dstLength outputs along the
+   *        axis. Only spst cpu architecture is supported. Executions must not overlap as they share the work buffer.
+   */
+  class ChirpZTransform
+  {
+    public:
+      /**
+       * @brief Constructor
+       * @tparam shapeExt Extent of the shape
+       * @tparam archShapeExt Extent of the shape of the architecture parameters
+       * @tparam BackendParamsT Backend parameters type
+       * @param cztParams Parameters of the chirp z-transform
+       * @param archParams Architecture parameters, the memory layout must be the default one, the complex format
+       *                   interleaved
+       * @param backendParams Backend parameters of the power of two plans
+       */
+      template<std::size_t shapeExt,
+               std::size_t archShapeExt,
+               typename BackendParamsT = detail::DefaultBackendParameters>
+      ChirpZTransform(const czt::Parameters<shapeExt>&   cztParams,
+                      const cpu::Parameters<archShapeExt>& archParams,
+                      const BackendParamsT&              backendParams = {})
+      {
+        const auto shapeRank = cztParams.shape.size();
+
+        if (shapeRank == 0 || shapeRank > maxDimCount)
+        {
+          throw std::invalid_argument{"chirp z-transform shape rank is invalid"};
+        }
+
+        if (cztParams.axis >= shapeRank)
+        {
+          throw std::invalid_argument{"chirp z-transform axis is out of the shape"};
+        }
+
+        if (cztParams.precision != Precision::f32 && cztParams.precision != Precision::f64)
+        {
+          throw std::invalid_argument{"chirp z-transform supports only f32 and f64 precision"};
+        }
+
+        if (std::any_of(cztParams.shape.begin(), cztParams.shape.end(), [](auto n) { return n == 0; }) ||
+            cztParams.dstLength == 0)
+        {
+          throw std::invalid_argument{"chirp z-transform lengths must be positive"};
+        }
+
+        if (!archParams.memoryLayout.srcStrides.empty() || !archParams.memoryLayout.dstStrides.empty() ||
+            archParams.complexFormat != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument{"chirp z-transform supports only contiguous interleaved data"};
+        }
+
+        const std::size_t srcLength = cztParams.shape[cztParams.axis];
+        const std::size_t dstLength = cztParams.dstLength;
+        const std::size_t fftLength = detail::chirpZ::nextPowerOfTwo(srcLength + dstLength - 1);
+
+        std::size_t outerCount{1};
+        std::size_t innerCount{1};
+
+        for (std::size_t i{}; i < shapeRank; ++i)
+        {
+          mSrcShape[i] = cztParams.shape[i];
+          mDstShape[i] = (i == cztParams.axis) ? dstLength : cztParams.shape[i];
+
+          if (i < cztParams.axis)
+          {
+            outerCount *= cztParams.shape[i];
+          }
+          else if (i > cztParams.axis)
+          {
+            innerCount *= cztParams.shape[i];
+          }
+        }
+
+        mShapeRank = shapeRank;
+        mPrecision = cztParams.precision;
+        mSrcStride = innerCount;
+        mDstStride = innerCount;
+
+        const std::size_t rowCount = outerCount * innerCount;
+
+        mSrcRowOffsets.resize(rowCount);
+        mDstRowOffsets.resize(rowCount);
+
+        for (std::size_t row{}; row < rowCount; ++row)
+        {
+          const std::size_t outer = row / innerCount;
+          const std::size_t inner = row % innerCount;
+
+          mSrcRowOffsets[row] = outer * srcLength * innerCount + inner;
+          mDstRowOffsets[row] = outer * dstLength * innerCount + inner;
+        }
+
+        const std::size_t fftShape[]{rowCount, fftLength};
+        const std::size_t fftAxes[]{1};
+
+        dft::Parameters<> fftParams{};
+        fftParams.precision     = {cztParams.precision, cztParams.precision, cztParams.precision};
+        fftParams.shape         = fftShape;
+        fftParams.axes          = fftAxes;
+        fftParams.normalization = Normalization::none;
+        fftParams.placement     = Placement::inPlace;
+        fftParams.type          = dft::Type::complexToComplex;
+
+        cpu::Parameters<> fftArchParams{};
+        fftArchParams.alignment      = archParams.alignment;
+        fftArchParams.threadLimit    = archParams.threadLimit;
+        fftArchParams.numaSplit      = archParams.numaSplit;
+        fftArchParams.hugePagePolicy = archParams.hugePagePolicy;
+
+        auto makeFftPlan = [&](Direction direction)
+        {
+          fftParams.direction = direction;
+
+          return makePlan(fftParams, fftArchParams, backendParams);
+        };
+
+        const auto alignment   = (archParams.alignment == Alignment{}) ? cpu::getDefaultAlignment() : archParams.alignment;
+        const auto chirpAngles = detail::chirpZ::makeChirpAngles(cztParams.stepAngle, std::max(srcLength, dstLength));
+
+        auto makeEngine = [&](auto real)
+        {
+          using T = decltype(real);
+
+          return detail::chirpZ::Engine<T>{rowCount,
+                                           srcLength,
+                                           dstLength,
+                                           fftLength,
+                                           cztParams.startAngle,
+                                           chirpAngles,
+                                           T{1},
+                                           makeFftPlan(Direction::forward),
+                                           makeFftPlan(Direction::backward),
+                                           alignment,
+                                           archParams.hugePagePolicy,
+                                           archParams.threadLimit};
+        };
+
+        if (mPrecision == Precision::f32)
+        {
+          mEngine.emplace<detail::chirpZ::Engine<float>>(makeEngine(float{}));
+        }
+        else
+        {
+          mEngine.emplace<detail::chirpZ::Engine<double>>(makeEngine(double{}));
+        }
+      }
+
+      /// @brief Copy constructor is deleted.
+      ChirpZTransform(const ChirpZTransform&) = delete;
+
+      /// @brief Move constructor.
+      ChirpZTransform(ChirpZTransform&&) = default;
+
+      /// @brief Destructor.
+      ~ChirpZTransform() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      ChirpZTransform& operator=(const ChirpZTransform&) = delete;
+
+      /// @brief Move assignment operator.
+      ChirpZTransform& operator=(ChirpZTransform&&) = default;
+
+      /**
+       * @brief Get the precision of the transform.
+       * @return Precision.
+       */
+      [[nodiscard]] constexpr Precision getPrecision() const noexcept
+      {
+        return mPrecision;
+      }
+
+      /**
+       * @brief Get the source shape.
+       * @return Source shape.
+       */
+      [[nodiscard]] View<std::size_t> getSrcShape() const noexcept
+      {
+        return View<std::size_t>{mSrcShape.data(), mShapeRank};
+      }
+
+      /**
+       * @brief Get the destination shape, the source shape with the dstLength outputs along the axis.
+       * @return Destination shape.
+       */
+      [[nodiscard]] View<std::size_t> getDstShape() const noexcept
+      {
+        return View<std::size_t>{mDstShape.data(), mShapeRank};
+      }
+
+      /**
+       * @brief Get the memory held by the power of two plans and the internal buffers.
+       * @return Memory size in bytes.
+       */
+      [[nodiscard]] std::size_t getMemorySize() const noexcept
+      {
+        const std::size_t offsetsSize = (mSrcRowOffsets.size() + mDstRowOffsets.size()) * sizeof(std::size_t);
+
+        if (const auto* engine = std::get_if<detail::chirpZ::Engine<float>>(&mEngine))
+        {
+          return engine->getMemorySize() + offsetsSize;
+        }
+
+        return std::get<detail::chirpZ::Engine<double>>(mEngine).getMemorySize() + offsetsSize;
+      }
+
+      /**
+       * @brief Execute the chirp z-transform.
+       * @tparam T Real type, float for f32 and double for f64 precision.
+       * @param src Source, preserved unless it aliases the destination.
+       * @param dst Destination, may alias the source if the destination is not larger.
+       */
+      template<typename T>
+      void execute(const std::complex<T>* src, std::complex<T>* dst)
+      {
+        static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Invalid chirp z-transform type");
+
+        auto* engine = std::get_if<detail::chirpZ::Engine<T>>(&mEngine);
+
+        if (engine == nullptr)
+        {
+          throw std::invalid_argument{"chirp z-transform precision does not match the data type"};
+        }
+
+        if (src == nullptr || dst == nullptr)
+        {
+          throw std::invalid_argument{"chirp z-transform buffers must not be null"};
+        }
+
+        engine->execute(src,
+                        View<std::size_t>{mSrcRowOffsets.data(), mSrcRowOffsets.size()},
+                        mSrcStride,
+                        dst,
+                        View<std::size_t>{mDstRowOffsets.data(), mDstRowOffsets.size()},
+                        mDstStride);
+      }
+
+    private:
+      std::variant<std::monostate,
+                   detail::chirpZ::Engine<float>,
+                   detail::chirpZ::Engine<double>> mEngine{};        ///< Chirp z-transform engine of the precision.
+      Precision                                    mPrecision{};     ///< Precision of the transform.
+      std::size_t                                  mShapeRank{};     ///< Rank of the shape.
+      detail::MaxDimArray<std::size_t>             mSrcShape{};      ///< Source shape.
+      detail::MaxDimArray<std::size_t>             mDstShape{};      ///< Destination shape.
+      std::vector<std::size_t>                     mSrcRowOffsets{}; ///< Source row offsets.
+      std::vector<std::size_t>                     mDstRowOffsets{}; ///< Destination row offsets.
+      std::size_t                                  mSrcStride{};     ///< Source element stride along the axis.
+      std::size_t                                  mDstStride{};     ///< Destination element stride along the axis.
+  };
+} // namespace afft
+
+#endif /* AFFT_CHIRP_Z_TRANSFORM_HPP */
@@ -0,0 +1,660 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_CONCURRENT_PLAN_CACHE_HPP
+#define AFFT_CONCURRENT_PLAN_CACHE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "makePlan.hpp"
+#include "Plan.hpp"
+#include "PlanCache.hpp"
+#include "detail/Desc.hpp"
+#include "detail/ThreadPool.hpp"
+
+AFFT_EXPORT namespace afft
+{
+  /**
+   * @class ConcurrentPlanCache
+   * @brief Thread-safe plan cache. The plans are distributed into shards by the hash of their description, each shard
+   *        is an LRU cache guarded by its own mutex. Concurrent requests to create the same plan are coalesced,
+   *        the plan is created only once and shared by all requesting threads.
+   */
+  class ConcurrentPlanCache
+  {
+    public:
+      /// @brief The default number of shards.
+      static constexpr std::size_t defaultShardCount{16};
+
+      /// @brief Constructs a new concurrent plan cache with the default maximum size and shard count.
+      ConcurrentPlanCache()
+      : ConcurrentPlanCache{PlanCache::defaultMaxSize}
+      {}
+
+      /**
+       * @brief Constructs a new concurrent plan cache. The planner thread pool is constructed first, so a static cache
+       *        is destroyed before the pool and its prefetched plans are not dropped from the queue.
+       * @param maxSize The maximum number of plans that the cache can hold, at least the number of shards. It is split
+       *                evenly between the shards.
+       * @param shardCount The number of shards.
+       */
+      ConcurrentPlanCache(std::size_t maxSize, std::size_t shardCount = defaultShardCount)
+      : mShards(checkShardCount(shardCount)),
+        mPlannerThreadPool{detail::getPlannerThreadPool()}
+      {
+        setMaxSize(maxSize);
+      }
+
+      /// @brief Copy constructor is deleted.
+      ConcurrentPlanCache(const ConcurrentPlanCache&) = delete;
+
+      /// @brief Move constructor is deleted.
+      ConcurrentPlanCache(ConcurrentPlanCache&&) = delete;
+
+      /// @brief Destructor, waits for the prefetched plans being created.
+      ~ConcurrentPlanCache()
+      {
+        std::unique_lock lock{mPrefetchMutex};
+        mPrefetchCondition.wait(lock, [this]{ return mPrefetchCount == 0; });
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      ConcurrentPlanCache& operator=(const ConcurrentPlanCache&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      ConcurrentPlanCache& operator=(ConcurrentPlanCache&&) = delete;
+
+      /**
+       * @brief Get the number of shards.
+       * @return The number of shards.
+       */
+      [[nodiscard]] std::size_t shardCount() const noexcept
+      {
+        return mShards.size();
+      }
+
+      /**
+       * @brief Get the number of plans in the cache. The value may be outdated when other threads modify the cache.
+       * @return The number of plans in the cache.
+       */
+      [[nodiscard]] std::size_t size() const
+      {
+        std::size_t totalSize{};
+
+        for (auto& shard : mShards)
+        {
+          std::lock_guard lock{shard.mutex};
+          totalSize += shard.cache.size();
+        }
+
+        return totalSize;
+      }
+
+      /**
+       * @brief Set the maximum number of plans that the cache can hold. It is split evenly between the shards, the
+       *        remainder is distributed one plan per shard, so the shard limits sum up to the maximum size.
+       * @param maxSize The maximum number of plans that the cache can hold, at least the number of shards.
+       */
+      void setMaxSize(std::size_t maxSize)
+      {
+        if (PlanCache::checkMaxSize(maxSize) < mShards.size())
+        {
+          throw std::invalid_argument{"The maximum size of the cache must not be less than the number of shards"};
+        }
+
+        const auto shardMaxSize = detail::div(maxSize, mShards.size());
+
+        for (std::size_t i{}; i < mShards.size(); ++i)
+        {
+          std::lock_guard lock{mShards[i].mutex};
+          mShards[i].cache.setMaxSize(shardMaxSize.quotient + std::size_t{i < shardMaxSize.remainder});
+        }
+      }
+
+      /**
+       * @brief Get the cache statistics accumulated over all shards.
+       * @return The cache statistics.
+       */
+      [[nodiscard]] PlanCache::Statistics statistics() const
+      {
+        PlanCache::Statistics statistics{};
+
+        for (const auto& shard : mShards)
+        {
+          std::lock_guard lock{shard.mutex};
+
+          const auto shardStatistics = shard.cache.statistics();
+
+          statistics.hitCount         += shardStatistics.hitCount;
+          statistics.missCount        += shardStatistics.missCount;
+          statistics.evictionCount    += shardStatistics.evictionCount;
+          statistics.hibernationCount += shardStatistics.hibernationCount;
+          statistics.rehydrationCount += shardStatistics.rehydrationCount;
+          statistics.memorySize       += shardStatistics.memorySize;
+          statistics.planningTime     += shardStatistics.planningTime;
+          statistics.warmupTime       += shardStatistics.warmupTime;
+          statistics.rehydrationTime  += shardStatistics.rehydrationTime;
+        }
+
+        return statistics;
+      }
+
+      /// @brief Resets the cache statistics counters.
+      void resetStatistics()
+      {
+        for (auto& shard : mShards)
+        {
+          std::lock_guard lock{shard.mutex};
+          shard.cache.resetStatistics();
+        }
+      }
+
+      /**
+       * @brief Get the number of hibernated plans in the cache. The value may be outdated when other threads modify
+       *        the cache.
+       * @return The number of hibernated plans.
+       */
+      [[nodiscard]] std::size_t hibernatedSize() const
+      {
+        std::size_t totalSize{};
+
+        for (auto& shard : mShards)
+        {
+          std::lock_guard lock{shard.mutex};
+          totalSize += shard.cache.hibernatedSize();
+        }
+
+        return totalSize;
+      }
+
+      /**
+       * @brief Enable or disable the hibernation of the plans over the memory budget in all shards, see
+       *        PlanCache::setHibernation(). A hibernated plan is recreated under the lock of its shard, so the
+       *        lookups of the other plans of the shard wait for it.
+       * @param hibernation True to enable the hibernation, false to disable it.
+       */
+      void setHibernation(bool hibernation)
+      {
+        for (auto& shard : mShards)
+        {
+          std::lock_guard lock{shard.mutex};
+          shard.cache.setHibernation(hibernation);
+        }
+      }
+
+      /**
+       * @brief Hibernate the idle plans of all shards not looked up for the specified time, see
+       *        PlanCache::hibernateIdle().
+       * @param idleTime The minimum time since the last lookup or insertion of the plan.
+       * @return The number of hibernated plans.
+       */
+      std::size_t hibernateIdle(std::chrono::duration<double> idleTime = {})
+      {
+        std::size_t hibernatedCount{};
+
+        for (auto& shard : mShards)
+        {
+          std::lock_guard lock{shard.mutex};
+          hibernatedCount += shard.cache.hibernateIdle(idleTime);
+        }
+
+        return hibernatedCount;
+      }
+
+      /**
+       * @brief Enable or disable the recording of the used plan descriptions in all shards, see
+       *        PlanCache::setRecording(). Requests waiting for a plan being created are not counted as uses.
+       * @param recording True to enable the recording, false to disable it.
+       */
+      void setRecording(bool recording)
+      {
+        for (auto& shard : mShards)
+        {
+          std::lock_guard lock{shard.mutex};
+          shard.cache.setRecording(recording);
+        }
+      }
+
+      /// @brief Clears the recorded plan descriptions of all shards.
+      void clearTrace()
+      {
+        for (auto& shard : mShards)
+        {
+          std::lock_guard lock{shard.mutex};
+          shard.cache.clearTrace();
+        }
+      }
+
+      /**
+       * @brief Serialize the recorded plan descriptions of all shards, see PlanCache::serializeTrace().
+       * @return Serialized trace.
+       */
+      [[nodiscard]] std::string serializeTrace() const
+      {
+        PlanCache::TraceMap trace{};
+
+        for (const auto& shard : mShards)
+        {
+          std::lock_guard lock{shard.mutex};
+          trace.insert(shard.cache.mTrace.begin(), shard.cache.mTrace.end());
+        }
+
+        return PlanCache::writeTrace(trace);
+      }
+
+      /**
+       * @brief Save the serialized trace to a file, see serializeTrace().
+       * @param path Path to the file.
+       */
+      void saveTrace(const std::string& path) const
+      {
+        PlanCache::writeTraceFile(path, serializeTrace());
+      }
+
+      /**
+       * @brief Start creating the hottest plans of a trace in the background, see prefetch() and
+       *        PlanCache::warmFromTrace(). Each plan is created by the backend it was recorded with, findOrCreate calls
+       *        requesting a plan being created wait for it.
+       * @param trace Serialized trace.
+       * @param maxPlanCount The maximum number of the hottest records to be planned.
+       */
+      void warmFromTrace(std::string_view trace, std::size_t maxPlanCount = PlanCache::defaultMaxSize)
+      {
+        for (const auto record : PlanCache::readTrace(trace, maxPlanCount))
+        {
+          PlanCache::readTraceRecord(record, [&](const auto& transformParams, auto& archParams, const auto& backendParams)
+          {
+            prefetch(transformParams, archParams, backendParams);
+          });
+        }
+      }
+
+      /**
+       * @brief Start creating the hottest plans of a trace saved by saveTrace() in the background, see
+       *        warmFromTrace(). A missing file is not an error.
+       * @param path Path to the file.
+       * @param maxPlanCount The maximum number of the hottest records to be planned.
+       */
+      void warmFrom(const std::string& path, std::size_t maxPlanCount = PlanCache::defaultMaxSize)
+      {
+        if (const auto trace = PlanCache::readTraceFile(path))
+        {
+          warmFromTrace(*trace, maxPlanCount);
+        }
+      }
+
+      /// @brief Clear the cache. Plans being currently created are not affected.
+      void clear()
+      {
+        for (auto& shard : mShards)
+        {
+          std::lock_guard lock{shard.mutex};
+          shard.cache.clear();
+        }
+      }
+
+      /**
+       * @brief Insert a plan into the cache. If a plan with the same description is already cached, it is replaced.
+       * @param plan The plan to insert into the cache.
+       */
+      void insert(std::shared_ptr<Plan> plan)
+      {
+        if (!plan)
+        {
+          throw std::invalid_argument{"Cannot insert a null plan into the cache"};
+        }
+
+        auto  key   = PlanCache::makeKey(detail::DescGetter::get(*plan));
+        auto& shard = getShard(key);
+
+        std::lock_guard lock{shard.mutex};
+        shard.cache.insertEntry(PlanCache::Entry{std::move(key), std::move(plan)});
+      }
+
+      /**
+       * @brief Insert a plan into the cache. If a plan with the same description is already cached, it is replaced.
+       * @param plan The plan to insert into the cache.
+       */
+      void insert(std::unique_ptr<Plan> plan)
+      {
+        insert(std::shared_ptr<Plan>{std::move(plan)});
+      }
+
+      /**
+       * @brief Erase a plan from the cache that matches the specified parameters.
+       * @param transformParams The parameters of the transform.
+       * @param archParams The parameters of the architecture.
+       */
+      template<typename TransformParamsT, typename ArchParamsT>
+      void erase(const TransformParamsT& transformParams, const ArchParamsT& archParams)
+      {
+        static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+
+        const auto key   = PlanCache::makeKey(detail::Desc{transformParams, archParams});
+        auto&      shard = getShard(key);
+
+        std::lock_guard lock{shard.mutex};
+        shard.cache.eraseKey(key);
+      }
+
+      /**
+       * @brief Finds a plan in the cache that matches the specified parameters and marks it as the most recently used.
+       * @param transformParams The parameters of the transform.
+       * @param archParams The parameters of the architecture.
+       * @return The plan that matches the specified parameters or nullptr if there is no such plan.
+       */
+      template<typename TransformParamsT, typename ArchParamsT>
+      [[nodiscard]] std::shared_ptr<Plan> find(const TransformParamsT& transformParams, const ArchParamsT& archParams)
+      {
+        static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+
+        const auto key   = PlanCache::makeKey(detail::Desc{transformParams, archParams});
+        auto&      shard = getShard(key);
+
+        std::lock_guard lock{shard.mutex};
+
+        return shard.cache.lookup(key);
+      }
+
+      /**
+       * @brief Finds a plan in the cache or creates it using the create function. When multiple threads request the same
+       *        missing plan, only one of them calls the create function and the others wait for its result. If the
+       *        creation fails, the exception is rethrown in all waiting threads.
+       * @tparam TransformParamsT Transform parameters type.
+       * @tparam ArchParamsT Architecture parameters type.
+       * @tparam CreateFnT Create function type, must return std::unique_ptr<Plan> or std::shared_ptr<Plan>.
+       * @param transformParams The parameters of the transform.
+       * @param archParams The parameters of the architecture.
+       * @param createFn The create function.
+       * @return The plan.
+       */
+      template<typename TransformParamsT, typename ArchParamsT, typename CreateFnT>
+      [[nodiscard]] auto findOrCreate(const TransformParamsT& transformParams,
+                                      const ArchParamsT&      archParams,
+                                      CreateFnT&&             createFn)
+        -> AFFT_RET_REQUIRES(std::shared_ptr<Plan>, std::is_invocable_v<CreateFnT>)
+      {
+        static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+
+        auto  key   = PlanCache::makeKey(detail::Desc{transformParams, archParams});
+        auto& shard = getShard(key);
+
+        std::promise<std::shared_ptr<Plan>> promise{};
+
+        {
+          std::unique_lock lock{shard.mutex};
+
+          if (auto plan = shard.cache.lookup(key))
+          {
+            return plan;
+          }
+
+          if (auto pendingIter = shard.pending.find(key); pendingIter != shard.pending.end())
+          {
+            auto future = pendingIter->second;
+
+            lock.unlock();
+
+            return future.get();
+          }
+
+          shard.pending.emplace(key, promise.get_future().share());
+        }
+
+        return create(shard, std::move(key), promise, std::forward<CreateFnT>(createFn), true);
+      }
+
+      /**
+       * @brief Finds a plan in the cache or creates it using makePlan. Concurrent requests are coalesced.
+       * @tparam TransformParamsT Transform parameters type.
+       * @tparam ArchParamsT Architecture parameters type.
+       * @tparam BackendParamsT Backend parameters type.
+       * @param transformParams The parameters of the transform.
+       * @param archParams The parameters of the architecture.
+       * @param backendParams The parameters of the backend.
+       * @return The plan.
+       */
+      template<typename TransformParamsT, typename ArchParamsT, typename BackendParamsT = detail::DefaultBackendParameters>
+      [[nodiscard]] auto findOrCreate(const TransformParamsT& transformParams,
+                                      ArchParamsT&            archParams,
+                                      const BackendParamsT&   backendParams = {})
+        -> AFFT_RET_REQUIRES(std::shared_ptr<Plan>, !std::is_invocable_v<BackendParamsT>)
+      {
+        return findOrCreate(transformParams, archParams, [&]()
+        {
+          return afft::makePlan(transformParams, archParams, backendParams);
+        });
+      }
+
+      /**
+       * @brief Starts creating the plan in the background on the planner thread pool unless it is already cached or
+       *        being created. Subsequent find calls do not see the plan until it is created, findOrCreate calls wait
+       *        for it. Planning errors are reported to the waiting findOrCreate calls only. The created plan is then
+       *        warmed up on scratch buffers if supported, the waiting calls may get it before the warmup completes.
+       *        A hibernated plan is recreated at once under the shard lock, as PlanCache::prefetch() does. Memory
+       *        referenced by the backend parameters must stay valid until the plan is created.
+       * @tparam TransformParamsT Transform parameters type.
+       * @tparam ArchParamsT Architecture parameters type.
+       * @tparam BackendParamsT Backend parameters type.
+       * @param transformParams The parameters of the transform.
+       * @param archParams The parameters of the architecture.
+       * @param backendParams The parameters of the backend.
+       */
+      template<typename TransformParamsT, typename ArchParamsT, typename BackendParamsT = detail::DefaultBackendParameters>
+      void prefetch(const TransformParamsT& transformParams,
+                    ArchParamsT&            archParams,
+                    const BackendParamsT&   backendParams = {})
+      {
+        static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+
+        detail::Desc desc{transformParams, archParams};
+
+        auto  key   = PlanCache::makeKey(desc);
+        auto& shard = getShard(key);
+
+        auto promise = std::make_shared<std::promise<std::shared_ptr<Plan>>>();
+
+        {
+          std::lock_guard lock{shard.mutex};
+
+          if (shard.pending.count(key) != 0 || shard.cache.prefetchCached(key))
+          {
+            return;
+          }
+
+          shard.pending.emplace(key, promise->get_future().share());
+        }
+
+        auto createFn = detail::makeDeferredPlan<ArchParamsT>(std::move(desc), backendParams);
+
+        {
+          std::lock_guard lock{mPrefetchMutex};
+          ++mPrefetchCount;
+        }
+
+        try
+        {
+          (void)mPlannerThreadPool.submit(
+            [this, &shard, key, promise, createFn = std::move(createFn)]() mutable
+          {
+            try
+            {
+              auto plan = create(shard, std::move(key), *promise, std::move(createFn), false);
+
+              if (plan->hasWarmupScratchBuffers())
+              {
+                const auto warmupTime = plan->warmup().measuredTime;
+
+                std::lock_guard lock{shard.mutex};
+                shard.cache.mStatistics.warmupTime += warmupTime;
+              }
+            }
+            catch (...)
+            {
+              // Planning errors are reported to the waiting findOrCreate calls, a failed warmup leaves the plan cold
+            }
+
+            endPrefetch();
+          });
+        }
+        catch (...)
+        {
+          {
+            std::lock_guard lock{shard.mutex};
+            shard.pending.erase(key);
+          }
+
+          promise->set_exception(std::current_exception());
+          endPrefetch();
+          throw;
+        }
+      }
+
+    private:
+      /// @brief Cache shard.
+      struct Shard
+      {
+        /// @brief Pending plan creations.
+        using PendingMap = std::unordered_map<detail::Desc, std::shared_future<std::shared_ptr<Plan>>>;
+
+        mutable std::mutex mutex{};   ///< The mutex guarding the shard.
+        PlanCache          cache{};   ///< The cache of the shard.
+        PendingMap         pending{}; ///< The plans being created.
+      };
+
+      /**
+       * @brief Checks if the shard count is valid.
+       * @param shardCount The shard count.
+       * @return The shard count.
+       */
+      [[nodiscard]] static std::size_t checkShardCount(std::size_t shardCount)
+      {
+        if (shardCount == 0)
+        {
+          throw std::invalid_argument{"The number of cache shards must be greater than zero"};
+        }
+
+        return shardCount;
+      }
+
+      /**
+       * @brief Get the shard for the normalized description.
+       * @param key The normalized plan description.
+       * @return The shard.
+       */
+      [[nodiscard]] Shard& getShard(const detail::Desc& key)
+      {
+        return mShards[std::hash<detail::Desc>{}(key) % mShards.size()];
+      }
+
+      /**
+       * @brief Creates the plan registered as pending in the shard, inserts it into the cache and fulfills the promise.
+       * @tparam CreateFnT Create function type.
+       * @param shard The shard.
+       * @param key The normalized plan description.
+       * @param promise The promise of the pending plan.
+       * @param createFn The create function.
+       * @param isUse True if the plan was requested, false if it was prefetched.
+       * @return The plan.
+       */
+      template<typename CreateFnT>
+      std::shared_ptr<Plan> create(Shard&                               shard,
+                                   detail::Desc                         key,
+                                   std::promise<std::shared_ptr<Plan>>& promise,
+                                   CreateFnT&&                          createFn,
+                                   bool                                 isUse)
+      {
+        std::shared_ptr<Plan> plan{};
+
+        const auto start = std::chrono::steady_clock::now();
+
+        try
+        {
+          plan = std::shared_ptr<Plan>{std::forward<CreateFnT>(createFn)()};
+
+          if (!plan)
+          {
+            throw std::runtime_error{"Plan create function returned a null plan"};
+          }
+        }
+        catch (...)
+        {
+          {
+            std::lock_guard lock{shard.mutex};
+            shard.pending.erase(key);
+            shard.cache.mStatistics.planningTime += std::chrono::steady_clock::now() - start;
+          }
+
+          promise.set_exception(std::current_exception());
+          throw;
+        }
+
+        // The waiting threads must not be left with a broken promise if the plan cannot be inserted
+        try
+        {
+          const std::chrono::duration<double> planningTime = std::chrono::steady_clock::now() - start;
+
+          std::lock_guard lock{shard.mutex};
+          shard.pending.erase(key);
+          shard.cache.mStatistics.planningTime += planningTime;
+          shard.cache.record(key, plan->getBackend(), isUse, planningTime);
+          shard.cache.insertEntry(PlanCache::Entry{std::move(key), plan});
+        }
+        catch (...)
+        {
+          promise.set_exception(std::current_exception());
+          throw;
+        }
+
+        promise.set_value(plan);
+
+        return plan;
+      }
+
+      /// @brief Marks a prefetch as finished.
+      void endPrefetch()
+      {
+        // Notified under the lock, otherwise the destructor could see the zero count and destroy the condition
+        // variable while it is being notified
+        std::lock_guard lock{mPrefetchMutex};
+
+        --mPrefetchCount;
+        mPrefetchCondition.notify_all();
+      }
+
+      std::vector<Shard>      mShards;               ///< The shards.
+      std::mutex              mPrefetchMutex{};      ///< The mutex guarding the prefetch count.
+      std::condition_variable mPrefetchCondition{};  ///< The condition signaling a finished prefetch.
+      std::size_t             mPrefetchCount{};      ///< The number of prefetched plans being created.
+      detail::ThreadPool&     mPlannerThreadPool;    ///< The planner thread pool outliving the cache.
+  };
+} // namespace afft
+
+#endif /* AFFT_CONCURRENT_PLAN_CACHE_HPP */
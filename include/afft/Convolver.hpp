@@ -0,0 +1,518 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_CONVOLVER_HPP
+#define AFFT_CONVOLVER_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "alloc.hpp"
+#include "makePlan.hpp"
+#include "Plan.hpp"
+#include "PlanCache.hpp"
+#include "detail/convolve.hpp"
+#if defined(AFFT_ENABLE_CUDA)
+# include "detail/cuda/cuda.hpp"
+#endif
+
+AFFT_EXPORT namespace afft
+{
+  /// @brief Type of the FFT based convolution
+  enum class ConvolutionType : std::uint8_t
+  {
+    convolution, ///< circular convolution
+    correlation, ///< circular cross-correlation
+  };
+
+  /**
+   * @class Convolver
+   * @brief Circular convolution of real data via real-to-complex transforms. Owns the forward and the inverse plan,
+   *        the kernel spectrum and the intermediate spectrum, so repeated executions do not allocate. The kernel has
+   *        the same shape and source layout as the signal and is transformed once by setKernel(). On cpu the spectra
+   *        are multiplied by a separate pass over the half-spectrum, on gpu the multiplication is fused into the load
+   *        callback of the inverse cuFFT plan. Both plans share the execution parameters, including the workspace.
+   *        Executions must not overlap as they share the intermediate spectrum.
+   */
+  class Convolver
+  {
+    public:
+      /**
+       * @brief Constructor
+       * @tparam shapeExt Extent of the shape
+       * @tparam transformExt Extent of the transform
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param transformParams Parameters of the forward real-to-complex transform, the normalization and the
+       *                        placement are ignored
+       * @param archParams Architecture parameters, spst distribution only
+       * @param type Type of the convolution
+       * @param backendParams Backend parameters
+       */
+      template<std::size_t shapeExt,
+               std::size_t transformExt,
+               typename ArchParamsT,
+               typename BackendParamsT = detail::DefaultBackendParameters>
+      Convolver(const dft::Parameters<shapeExt, transformExt>& transformParams,
+                const ArchParamsT&                             archParams,
+                ConvolutionType                                type          = ConvolutionType::convolution,
+                const BackendParamsT&                          backendParams = {})
+      : mType{type}
+      {
+        init(transformParams, archParams, [&](const auto& planTransformParams, auto& planArchParams)
+        {
+          return makePlan(planTransformParams, planArchParams, backendParams);
+        });
+      }
+
+      /**
+       * @brief Constructor taking the plans from the plan cache
+       * @tparam shapeExt Extent of the shape
+       * @tparam transformExt Extent of the transform
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param planCache Plan cache the plans are found in or inserted into
+       * @param transformParams Parameters of the forward real-to-complex transform, the normalization and the
+       *                        placement are ignored
+       * @param archParams Architecture parameters, spst distribution only
+       * @param type Type of the convolution
+       * @param backendParams Backend parameters
+       */
+      template<std::size_t shapeExt,
+               std::size_t transformExt,
+               typename ArchParamsT,
+               typename BackendParamsT = detail::DefaultBackendParameters>
+      Convolver(PlanCache&                                     planCache,
+                const dft::Parameters<shapeExt, transformExt>& transformParams,
+                const ArchParamsT&                             archParams,
+                ConvolutionType                                type          = ConvolutionType::convolution,
+                const BackendParamsT&                          backendParams = {})
+      : mType{type}
+      {
+        init(transformParams, archParams, [&](const auto& planTransformParams, auto& planArchParams)
+        {
+          return planCache.findOrCreate(planTransformParams, planArchParams, backendParams);
+        });
+      }
+
+      /// @brief Copy constructor is deleted.
+      Convolver(const Convolver&) = delete;
+
+      /// @brief Move constructor.
+      Convolver(Convolver&&) = default;
+
+      /// @brief Destructor.
+      ~Convolver() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      Convolver& operator=(const Convolver&) = delete;
+
+      /// @brief Move assignment operator.
+      Convolver& operator=(Convolver&&) = default;
+
+      /**
+       * @brief Get the type of the convolution.
+       * @return Type of the convolution.
+       */
+      [[nodiscard]] constexpr ConvolutionType getType() const noexcept
+      {
+        return mType;
+      }
+
+      /**
+       * @brief Get the forward plan.
+       * @return Forward plan.
+       */
+      [[nodiscard]] const Plan& getForwardPlan() const noexcept
+      {
+        return *mForwardPlan;
+      }
+
+      /**
+       * @brief Get the inverse plan.
+       * @return Inverse plan.
+       */
+      [[nodiscard]] const Plan& getInversePlan() const noexcept
+      {
+        return *mInversePlan;
+      }
+
+      /**
+       * @brief Get the size of the workspace shared by both plans.
+       * @return Size of the workspace in bytes.
+       */
+      [[nodiscard]] std::size_t getWorkspaceSize() const noexcept
+      {
+        const auto fwdSize = mForwardPlan->getWorkspaceSize();
+        const auto invSize = mInversePlan->getWorkspaceSize();
+
+        return std::max((fwdSize.empty()) ? std::size_t{} : fwdSize.front(),
+                        (invSize.empty()) ? std::size_t{} : invSize.front());
+      }
+
+      /**
+       * @brief Has the kernel been set?
+       * @return True if the kernel has been set, false otherwise.
+       */
+      [[nodiscard]] constexpr bool hasKernel() const noexcept
+      {
+        return mHasKernel;
+      }
+
+      /**
+       * @brief Set the kernel with the default execution parameters. The kernel spectrum is computed once and reused by
+       *        all subsequent executions.
+       * @param kernel Kernel in the signal domain, preserved if the plans preserve the source.
+       */
+      void setKernel(const void* kernel)
+      {
+        switch (mTarget)
+        {
+        case Target::cpu:
+          setKernel(kernel, afft::spst::cpu::ExecutionParameters{});
+          break;
+        case Target::gpu:
+          setKernel(kernel, afft::spst::gpu::ExecutionParameters{});
+          break;
+        default:
+          detail::cxx::unreachable();
+        }
+      }
+
+      /**
+       * @brief Set the kernel.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param kernel Kernel in the signal domain, preserved if the plans preserve the source.
+       * @param execParams Execution parameters, the kernel transform is complete when the function returns.
+       */
+      template<typename ExecParamsT>
+      void setKernel(const void* kernel, const ExecParamsT& execParams)
+      {
+        static_assert(isExecutionParameters<ExecParamsT>, "Invalid execution parameters type");
+
+        mHasKernel = false;
+
+        mForwardPlan->executeUnsafe(kernel, mKernelSpectrum.get(), execParams);
+
+        if constexpr (ExecParamsT::target == Target::cpu)
+        {
+          const bool conjugate = (mType == ConvolutionType::correlation);
+
+          if (mPrecision == Precision::f32)
+          {
+            detail::prepareKernelSpectrum(static_cast<float*>(mKernelSpectrum.get()),
+                                          mSpectrumCount,
+                                          static_cast<float>(mScale),
+                                          conjugate);
+          }
+          else
+          {
+            detail::prepareKernelSpectrum(static_cast<double*>(mKernelSpectrum.get()), mSpectrumCount, mScale, conjugate);
+          }
+        }
+        else if constexpr (ExecParamsT::target == Target::gpu)
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::checkError(cudaStreamSynchronize(execParams.stream));
+#       endif
+        }
+
+        mHasKernel = true;
+      }
+
+      /**
+       * @brief Execute the convolution with the default execution parameters.
+       * @param src Source signal, preserved if the plans preserve the source.
+       * @param dst Destination signal, in the source layout.
+       */
+      void execute(const void* src, void* dst)
+      {
+        switch (mTarget)
+        {
+        case Target::cpu:
+          execute(src, dst, afft::spst::cpu::ExecutionParameters{});
+          break;
+        case Target::gpu:
+          execute(src, dst, afft::spst::gpu::ExecutionParameters{});
+          break;
+        default:
+          detail::cxx::unreachable();
+        }
+      }
+
+      /**
+       * @brief Execute the convolution.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param src Source signal, preserved if the plans preserve the source.
+       * @param dst Destination signal, in the source layout.
+       * @param execParams Execution parameters shared by both plans.
+       */
+      template<typename ExecParamsT>
+      void execute(const void* src, void* dst, const ExecParamsT& execParams)
+      {
+        static_assert(isExecutionParameters<ExecParamsT>, "Invalid execution parameters type");
+
+        if (!mHasKernel)
+        {
+          throw std::runtime_error{"convolver kernel is not set"};
+        }
+
+        mForwardPlan->executeUnsafe(src, mSpectrum.get(), execParams);
+
+        if constexpr (ExecParamsT::target == Target::cpu)
+        {
+          if (mPrecision == Precision::f32)
+          {
+            detail::multiplySpectra(static_cast<float*>(mSpectrum.get()),
+                                    static_cast<const float*>(mKernelSpectrum.get()),
+                                    mSpectrumCount);
+          }
+          else
+          {
+            detail::multiplySpectra(static_cast<double*>(mSpectrum.get()),
+                                    static_cast<const double*>(mKernelSpectrum.get()),
+                                    mSpectrumCount);
+          }
+        }
+
+        mInversePlan->executeUnsafe(mSpectrum.get(), dst, execParams);
+      }
+    private:
+      /**
+       * @brief Initialize the convolver.
+       * @tparam shapeExt Extent of the shape
+       * @tparam transformExt Extent of the transform
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam MakePlanFnT Function making a plan from the transform and the architecture parameters
+       * @param transformParams Parameters of the forward real-to-complex transform
+       * @param archParams Architecture parameters
+       * @param makePlanFn Function making the plans
+       */
+      template<std::size_t shapeExt, std::size_t transformExt, typename ArchParamsT, typename MakePlanFnT>
+      void init(const dft::Parameters<shapeExt, transformExt>& transformParams,
+                const ArchParamsT&                             archParams,
+                MakePlanFnT&&                                  makePlanFn)
+      {
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+        static_assert(ArchParamsT::distribution == Distribution::spst, "Convolver supports only spst distribution");
+
+        if (transformParams.type != dft::Type::realToComplex || transformParams.direction != Direction::forward)
+        {
+          throw std::invalid_argument{"convolver requires a forward real-to-complex transform"};
+        }
+
+        const auto& precision = transformParams.precision;
+
+        if (precision.source != precision.execution || precision.destination != precision.execution)
+        {
+          throw std::invalid_argument{"convolver requires uniform precision"};
+        }
+
+        if (precision.execution != Precision::f32 && precision.execution != Precision::f64)
+        {
+          throw std::invalid_argument{"convolver supports only f32 and f64 precision"};
+        }
+
+        mTarget    = ArchParamsT::target;
+        mPrecision = precision.execution;
+
+        if constexpr (ArchParamsT::target == Target::cpu)
+        {
+          mAlignment = (archParams.alignment == Alignment{}) ? cpu::getDefaultAlignment() : archParams.alignment;
+        }
+
+        auto fwdParams          = transformParams;
+        fwdParams.normalization = Normalization::none;
+        fwdParams.placement     = Placement::outOfPlace;
+
+        // The intermediate spectrum is always stored contiguously
+        auto fwdArchParams                    = archParams;
+        fwdArchParams.memoryLayout.dstStrides = {};
+
+        {
+          const detail::Desc desc{fwdParams, fwdArchParams};
+
+          const auto dstShape = desc.getDstShape();
+          const auto dims     = desc.getTransformDimsAs<std::size_t>();
+
+          makeStrides(View<std::size_t>{dstShape.data(), desc.getShapeRank()},
+                      Span<std::size_t>{mSpectrumStrides.data(), desc.getShapeRank()});
+
+          mSpectrumCount = std::accumulate(dstShape.data(),
+                                           dstShape.data() + desc.getShapeRank(),
+                                           std::size_t{1},
+                                           std::multiplies<>{});
+          mScale         = 1.0 / static_cast<double>(std::accumulate(dims.data(),
+                                                                     dims.data() + desc.getTransformRank(),
+                                                                     std::size_t{1},
+                                                                     std::multiplies<>{}));
+        }
+
+        mSpectrum       = allocateSpectrum();
+        mKernelSpectrum = allocateSpectrum();
+
+        auto invParams      = fwdParams;
+        invParams.direction = Direction::backward;
+        invParams.type      = dft::Type::complexToReal;
+
+        const View<std::size_t, shapeExt> spectrumStrides{mSpectrumStrides.data(), transformParams.shape.size()};
+
+        // The inverse transform reads the contiguous spectrum and writes the result in the layout of the source
+        auto invArchParams                    = archParams;
+        invArchParams.memoryLayout.srcStrides = spectrumStrides;
+        invArchParams.memoryLayout.dstStrides = archParams.memoryLayout.srcStrides;
+        invArchParams.preserveSource          = false;
+
+        if constexpr (ArchParamsT::target == Target::gpu)
+        {
+          if (!archParams.callbacks.load.srcCode.empty() || archParams.callbacks.load.devicePtr != nullptr ||
+              !archParams.callbacks.store.srcCode.empty() || archParams.callbacks.store.devicePtr != nullptr)
+          {
+            throw std::invalid_argument{"convolver does not support user callbacks"};
+          }
+
+#       if defined(AFFT_ENABLE_CUDA)
+          mLoadCallbackSrcCode = detail::makeConvolutionLoadCallbackSrcCode(mPrecision,
+                                                                            mScale,
+                                                                            mType == ConvolutionType::correlation);
+
+          invArchParams.callbacks.load.srcCode      = mLoadCallbackSrcCode;
+          invArchParams.callbacks.load.functionName = detail::convolutionLoadCallbackName;
+          invArchParams.callbacks.load.callerInfo   = mKernelSpectrum.get();
+#       else
+          throw std::runtime_error{"gpu convolver requires CUDA"};
+#       endif
+        }
+
+        mForwardPlan = makePlanFn(fwdParams, fwdArchParams);
+        mInversePlan = makePlanFn(invParams, invArchParams);
+      }
+
+      /// @brief Owning pointer to a spectrum buffer.
+      using SpectrumPtr = std::unique_ptr<void, std::function<void(void*)>>;
+
+      /**
+       * @brief Allocate a spectrum buffer on the target.
+       * @return Spectrum buffer.
+       */
+      [[nodiscard]] SpectrumPtr allocateSpectrum() const
+      {
+        const std::size_t size = mSpectrumCount * 2 * ((mPrecision == Precision::f32) ? sizeof(float) : sizeof(double));
+
+        switch (mTarget)
+        {
+        case Target::cpu:
+          return SpectrumPtr{::operator new(size, static_cast<std::align_val_t>(mAlignment)), [alignment = mAlignment](void* ptr)
+          {
+            ::operator delete(ptr, static_cast<std::align_val_t>(alignment));
+          }};
+        case Target::gpu:
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          void* ptr{};
+
+          detail::cuda::checkError(cudaMalloc(&ptr, size));
+
+          return SpectrumPtr{ptr, [](void* ptr)
+          {
+            cudaFree(ptr);
+          }};
+#       else
+          throw std::runtime_error{"gpu convolver requires CUDA"};
+#       endif
+        }
+        default:
+          detail::cxx::unreachable();
+        }
+      }
+
+      ConvolutionType                  mType{};                           ///< Type of the convolution.
+      Target                           mTarget{};                         ///< Target of the plans.
+      Precision                        mPrecision{};                      ///< Precision of the plans.
+      Alignment                        mAlignment{};                      ///< Alignment of the cpu spectrum buffers.
+      std::size_t                      mSpectrumCount{};                  ///< Number of complex elements of the spectrum.
+      detail::MaxDimArray<std::size_t> mSpectrumStrides{};                ///< Strides of the contiguous spectrum.
+      double                           mScale{};                          ///< Normalization scale of the inverse transform.
+      SpectrumPtr                      mSpectrum{nullptr, nullptr};       ///< Intermediate spectrum.
+      SpectrumPtr                      mKernelSpectrum{nullptr, nullptr}; ///< Kernel spectrum, scaled and conjugated on cpu.
+      std::string                      mLoadCallbackSrcCode{};            ///< Source code of the fused multiply callback.
+      std::shared_ptr<Plan>            mForwardPlan{};                    ///< Forward plan.
+      std::shared_ptr<Plan>            mInversePlan{};                    ///< Inverse plan.
+      bool                             mHasKernel{};                      ///< Kernel has been set.
+  };
+
+  /**
+   * @class Correlator
+   * @brief Circular cross-correlation of real data, a Convolver conjugating the kernel spectrum.
+   */
+  class Correlator : public Convolver
+  {
+    public:
+      /**
+       * @brief Constructor
+       * @tparam shapeExt Extent of the shape
+       * @tparam transformExt Extent of the transform
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param transformParams Parameters of the forward real-to-complex transform
+       * @param archParams Architecture parameters, spst distribution only
+       * @param backendParams Backend parameters
+       */
+      template<std::size_t shapeExt,
+               std::size_t transformExt,
+               typename ArchParamsT,
+               typename BackendParamsT = detail::DefaultBackendParameters>
+      Correlator(const dft::Parameters<shapeExt, transformExt>& transformParams,
+                 const ArchParamsT&                             archParams,
+                 const BackendParamsT&                          backendParams = {})
+      : Convolver{transformParams, archParams, ConvolutionType::correlation, backendParams}
+      {}
+
+      /**
+       * @brief Constructor taking the plans from the plan cache
+       * @tparam shapeExt Extent of the shape
+       * @tparam transformExt Extent of the transform
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param planCache Plan cache the plans are found in or inserted into
+       * @param transformParams Parameters of the forward real-to-complex transform
+       * @param archParams Architecture parameters, spst distribution only
+       * @param backendParams Backend parameters
+       */
+      template<std::size_t shapeExt,
+               std::size_t transformExt,
+               typename ArchParamsT,
+               typename BackendParamsT = detail::DefaultBackendParameters>
+      Correlator(PlanCache&                                     planCache,
+                 const dft::Parameters<shapeExt, transformExt>& transformParams,
+                 const ArchParamsT&                             archParams,
+                 const BackendParamsT&                          backendParams = {})
+      : Convolver{planCache, transformParams, archParams, ConvolutionType::correlation, backendParams}
+      {}
+  };
+} // namespace afft
+
+#endif /* AFFT_CONVOLVER_HPP */
@@ -0,0 +1,266 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_GRAPH_EXECUTOR_HPP
+#define AFFT_GRAPH_EXECUTOR_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "Plan.hpp"
+
+AFFT_EXPORT namespace afft::gpu
+{
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+  /**
+   * @class GraphExecutor
+   * @brief Replays a spst gpu plan execution captured into an executable graph. Every launch issued by the plan
+   *        execution, including the backend kernels and the callbacks, is recorded once, so a replay costs a single
+   *        graph launch. The buffers, the workspace and the execution parameters are fixed by the capture, the buffer
+   *        contents may change between launches. Managed memory prefetching is not captured. The plan and the buffers
+   *        must outlive the executor.
+   */
+  class GraphExecutor
+  {
+    public:
+#   if defined(AFFT_ENABLE_CUDA)
+      /// @brief Stream type.
+      using Stream = cudaStream_t;
+#   elif defined(AFFT_ENABLE_HIP)
+      /// @brief Stream type.
+      using Stream = hipStream_t;
+#   endif
+
+      /**
+       * @brief Constructor, captures the plan execution into an executable graph.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @param plan The spst gpu plan.
+       * @param src Device source buffer.
+       * @param dst Device destination buffer.
+       * @param execParams Execution parameters, the stream is the default stream of launch().
+       */
+      template<typename SrcT, typename DstT>
+      GraphExecutor(Plan&                                       plan,
+                    SrcT*                                       src,
+                    DstT*                                       dst,
+                    const afft::spst::gpu::ExecutionParameters& execParams = {})
+      : mStream{execParams.stream}
+      {
+        const auto& desc = detail::DescGetter::get(plan);
+
+        if (desc.getTarget() != Target::gpu || desc.getDistribution() != Distribution::spst)
+        {
+          throw std::invalid_argument("graph execution requires a spst gpu plan");
+        }
+
+        mDevice = desc.getArchDesc<Target::gpu, Distribution::spst>().device;
+
+        // prefetching and advising are not stream ordered work the graph could replay
+        afft::spst::gpu::ExecutionParameters captureParams{execParams};
+        captureParams.prefetchManagedMemory = false;
+        captureParams.adviseManagedMemory   = false;
+
+#     if defined(AFFT_ENABLE_CUDA)
+        detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+        // the legacy default stream cannot be captured, the graph is captured on a private stream instead
+        cudaStream_t captureStream{};
+        detail::cuda::checkError(cudaStreamCreateWithFlags(&captureStream, cudaStreamNonBlocking));
+
+        cudaGraph_t graph{};
+
+        try
+        {
+          captureParams.stream = captureStream;
+
+          detail::cuda::checkError(cudaStreamBeginCapture(captureStream, cudaStreamCaptureModeThreadLocal));
+
+          try
+          {
+            plan.execute(src, dst, captureParams);
+          }
+          catch (...)
+          {
+            cudaStreamEndCapture(captureStream, &graph);
+            throw;
+          }
+
+          detail::cuda::checkError(cudaStreamEndCapture(captureStream, &graph));
+          detail::cuda::checkError(cudaGraphInstantiateWithFlags(&mGraphExec, graph, 0));
+        }
+        catch (...)
+        {
+          if (graph != nullptr)
+          {
+            cudaGraphDestroy(graph);
+          }
+          cudaStreamDestroy(captureStream);
+          throw;
+        }
+
+        cudaGraphDestroy(graph);
+        cudaStreamDestroy(captureStream);
+#     elif defined(AFFT_ENABLE_HIP)
+        detail::hip::ScopedDevice scopedDevice{mDevice};
+
+        // the legacy default stream cannot be captured, the graph is captured on a private stream instead
+        hipStream_t captureStream{};
+        detail::hip::checkError(hipStreamCreateWithFlags(&captureStream, hipStreamNonBlocking));
+
+        hipGraph_t graph{};
+
+        try
+        {
+          captureParams.stream = captureStream;
+
+          detail::hip::checkError(hipStreamBeginCapture(captureStream, hipStreamCaptureModeThreadLocal));
+
+          try
+          {
+            plan.execute(src, dst, captureParams);
+          }
+          catch (...)
+          {
+            hipStreamEndCapture(captureStream, &graph);
+            throw;
+          }
+
+          detail::hip::checkError(hipStreamEndCapture(captureStream, &graph));
+          detail::hip::checkError(hipGraphInstantiate(&mGraphExec, graph, nullptr, nullptr, 0));
+        }
+        catch (...)
+        {
+          if (graph != nullptr)
+          {
+            hipGraphDestroy(graph);
+          }
+          hipStreamDestroy(captureStream);
+          throw;
+        }
+
+        hipGraphDestroy(graph);
+        hipStreamDestroy(captureStream);
+#     endif
+      }
+
+      /// @brief Copy constructor is deleted.
+      GraphExecutor(const GraphExecutor&) = delete;
+
+      /// @brief Move constructor.
+      GraphExecutor(GraphExecutor&& other) noexcept
+      : mGraphExec{std::exchange(other.mGraphExec, nullptr)},
+        mStream{other.mStream},
+        mDevice{other.mDevice}
+      {}
+
+      /// @brief Destructor, destroys the executable graph.
+      ~GraphExecutor()
+      {
+        destroyGraph();
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      GraphExecutor& operator=(const GraphExecutor&) = delete;
+
+      /// @brief Move assignment operator.
+      GraphExecutor& operator=(GraphExecutor&& other) noexcept
+      {
+        if (this != &other)
+        {
+          destroyGraph();
+
+          mGraphExec = std::exchange(other.mGraphExec, nullptr);
+          mStream    = other.mStream;
+          mDevice    = other.mDevice;
+        }
+
+        return *this;
+      }
+
+      /// @brief Launch the captured execution on the stream of the capture execution parameters.
+      void launch() const
+      {
+        launch(mStream);
+      }
+
+      /**
+       * @brief Launch the captured execution.
+       * @param stream The stream to launch on.
+       */
+      void launch(Stream stream) const
+      {
+        if (mGraphExec == nullptr)
+        {
+          throw std::runtime_error("graph executor holds no graph");
+        }
+
+#     if defined(AFFT_ENABLE_CUDA)
+        detail::cuda::checkError(cudaGraphLaunch(mGraphExec, stream));
+#     elif defined(AFFT_ENABLE_HIP)
+        detail::hip::checkError(hipGraphLaunch(mGraphExec, stream));
+#     endif
+      }
+
+      /**
+       * @brief Get the default launch stream.
+       * @return The stream.
+       */
+      [[nodiscard]] constexpr Stream getStream() const noexcept
+      {
+        return mStream;
+      }
+    private:
+#   if defined(AFFT_ENABLE_CUDA)
+      /// @brief Executable graph type.
+      using GraphExec = cudaGraphExec_t;
+#   elif defined(AFFT_ENABLE_HIP)
+      /// @brief Executable graph type.
+      using GraphExec = hipGraphExec_t;
+#   endif
+
+      /// @brief Destroy the executable graph, errors are ignored.
+      void destroyGraph() noexcept
+      {
+        if (mGraphExec != nullptr)
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          cudaGraphExecDestroy(mGraphExec);
+#       elif defined(AFFT_ENABLE_HIP)
+          hipGraphExecDestroy(mGraphExec);
+#       endif
+          mGraphExec = nullptr;
+        }
+      }
+
+      GraphExec mGraphExec{}; ///< The executable graph.
+      Stream    mStream{};    ///< The default launch stream.
+      int       mDevice{};    ///< The device of the plan.
+  };
+#endif
+} // namespace afft::gpu
+
+#endif /* AFFT_GRAPH_EXECUTOR_HPP */
@@ -0,0 +1,456 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_GROUPED_EXECUTOR_HPP
+#define AFFT_GROUPED_EXECUTOR_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "Plan.hpp"
+
+AFFT_EXPORT namespace afft
+{
+  /**
+   * @class GroupedTransform
+   * @brief Transform of a grouped execution, a plan with its buffers. Unlike a batch, the transforms of a group may
+   *        have different shapes and plans. The buffers are type checked by the plan when the transform is executed.
+   *        The plan and the buffers must stay valid until the grouped execution finishes.
+   */
+  class GroupedTransform
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @tparam SrcT Source type, may be void.
+       * @tparam DstT Destination type, may be void.
+       * @param plan The spst plan.
+       * @param src Source buffer.
+       * @param dst Destination buffer, equal to the source for in-place plans.
+       * @param workspace Workspace of the transform on gpu, taken from the workspace pool if null, ignored on cpu.
+       */
+      template<typename SrcT, typename DstT>
+      GroupedTransform(Plan& plan, SrcT* src, DstT* dst, void* workspace = nullptr)
+      : mPlan{&plan},
+        mSrc{const_cast<std::remove_const_t<SrcT>*>(src)},
+        mDst{dst},
+        mWorkspace{workspace},
+        mCpuExecuteFn{&executeOf<SrcT, DstT, afft::spst::cpu::ExecutionParameters>}
+#     if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        , mGpuExecuteFn{&executeOf<SrcT, DstT, afft::spst::gpu::ExecutionParameters>}
+#     endif
+      {
+        static_assert(!std::is_const_v<DstT>, "destination type must be non-const");
+        static_assert(std::is_void_v<std::remove_const_t<SrcT>> == std::is_void_v<DstT>,
+                      "invalid source and destination types");
+      }
+
+      /**
+       * @brief Get the plan.
+       * @return The plan.
+       */
+      [[nodiscard]] Plan& getPlan() const noexcept
+      {
+        return *mPlan;
+      }
+
+      /**
+       * @brief Execute the transform on cpu.
+       * @param execParams Execution parameters.
+       */
+      void execute(const afft::spst::cpu::ExecutionParameters& execParams) const
+      {
+        mCpuExecuteFn(*mPlan, mSrc, mDst, execParams);
+      }
+
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      /**
+       * @brief Execute the transform on gpu.
+       * @param execParams Execution parameters, the workspace of the transform is used if set.
+       */
+      void execute(afft::spst::gpu::ExecutionParameters execParams) const
+      {
+        if (mWorkspace != nullptr)
+        {
+          execParams.workspace = mWorkspace;
+        }
+
+        mGpuExecuteFn(*mPlan, mSrc, mDst, execParams);
+      }
+#   endif
+    private:
+      /// @brief Function executing the transform with the execution parameters.
+      template<typename ExecParamsT>
+      using ExecuteFn = void(*)(Plan&, void*, void*, const ExecParamsT&);
+
+      /**
+       * @brief Execute the plan with the buffers of the original types.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param plan The plan.
+       * @param src Source buffer.
+       * @param dst Destination buffer.
+       * @param execParams Execution parameters.
+       */
+      template<typename SrcT, typename DstT, typename ExecParamsT>
+      static void executeOf(Plan& plan, void* src, void* dst, const ExecParamsT& execParams)
+      {
+        if constexpr (std::is_void_v<DstT>)
+        {
+          plan.executeUnsafe(static_cast<SrcT*>(src), dst, execParams);
+        }
+        else
+        {
+          plan.execute(static_cast<SrcT*>(src), static_cast<DstT*>(dst), execParams);
+        }
+      }
+
+      Plan*                                           mPlan{};         ///< The plan.
+      void*                                           mSrc{};          ///< The source buffer.
+      void*                                           mDst{};          ///< The destination buffer.
+      void*                                           mWorkspace{};    ///< The workspace, null if not given.
+      ExecuteFn<afft::spst::cpu::ExecutionParameters> mCpuExecuteFn{}; ///< Executes the transform on cpu.
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      ExecuteFn<afft::spst::gpu::ExecutionParameters> mGpuExecuteFn{}; ///< Executes the transform on gpu.
+#   endif
+  };
+
+namespace cpu
+{
+  /**
+   * @brief Execute a group of spst cpu transforms of different shapes in one parallel region. The transforms are
+   *        distributed over the threads of the cpu thread pool, threads that finished their transforms steal the
+   *        remaining ones of the others, see WorkStealingThreadPool. Each transform is executed by a single thread, a
+   *        plan parallelizing its transform shares the pool with the group. The same plan may appear several times as
+   *        long as its transforms use distinct buffers. The plan targets are checked before any transform is executed,
+   *        the buffers are checked by each execution, and the first execution error is rethrown after the others
+   *        finished.
+   * @param transforms The transforms.
+   * @param threadLimit The maximum number of threads including the calling one, 0 for the thread pool size.
+   */
+  inline void executeGrouped(View<GroupedTransform> transforms, std::size_t threadLimit = 0)
+  {
+    for (const auto& transform : transforms)
+    {
+      const auto& desc = detail::DescGetter::get(transform.getPlan());
+
+      if (desc.getTarget() != Target::cpu || desc.getDistribution() != Distribution::spst)
+      {
+        throw std::invalid_argument("grouped cpu execution requires spst cpu plans");
+      }
+    }
+
+    detail::parallelFor(transforms.size(), threadLimit, [&](std::size_t i)
+    {
+      transforms[i].execute(afft::spst::cpu::ExecutionParameters{});
+    });
+  }
+} // namespace cpu
+
+namespace gpu
+{
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+  /**
+   * @class GroupedExecutor
+   * @brief Executes groups of spst gpu transforms of different shapes issued from a single stream. The transforms fan
+   *        out to the executor's streams after the work already enqueued on the issuing stream, and the issuing stream
+   *        waits for all of them, so the group behaves as one stream ordered operation without host synchronization.
+   *        Small transforms of different plans then run concurrently on the device instead of one after another. The
+   *        transforms are assigned to the streams round robin. All plans must be on the device of the executor. The
+   *        executor is not thread safe.
+   */
+  class GroupedExecutor
+  {
+    public:
+#   if defined(AFFT_ENABLE_CUDA)
+      /// @brief Stream type.
+      using Stream = cudaStream_t;
+#   elif defined(AFFT_ENABLE_HIP)
+      /// @brief Stream type.
+      using Stream = hipStream_t;
+#   endif
+
+      /// @brief Default number of streams the transforms fan out to.
+      static constexpr std::size_t defaultStreamCount{4};
+
+      /**
+       * @brief Constructor, creates the streams on the current device.
+       * @param streamCount The number of streams the transforms fan out to.
+       */
+      explicit GroupedExecutor(std::size_t streamCount = defaultStreamCount)
+      {
+        if (streamCount == 0)
+        {
+          throw std::invalid_argument("grouped execution requires at least one stream");
+        }
+
+        mFanOuts.resize(streamCount);
+
+        try
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          mDevice = detail::cuda::getCurrentDevice();
+
+          detail::cuda::checkError(cudaEventCreateWithFlags(&mForkEvent, cudaEventDisableTiming));
+
+          for (auto& fanOut : mFanOuts)
+          {
+            detail::cuda::checkError(cudaStreamCreateWithFlags(&fanOut.stream, cudaStreamNonBlocking));
+            detail::cuda::checkError(cudaEventCreateWithFlags(&fanOut.joinEvent, cudaEventDisableTiming));
+          }
+#       elif defined(AFFT_ENABLE_HIP)
+          mDevice = detail::hip::getCurrentDevice();
+
+          detail::hip::checkError(hipEventCreateWithFlags(&mForkEvent, hipEventDisableTiming));
+
+          for (auto& fanOut : mFanOuts)
+          {
+            detail::hip::checkError(hipStreamCreateWithFlags(&fanOut.stream, hipStreamNonBlocking));
+            detail::hip::checkError(hipEventCreateWithFlags(&fanOut.joinEvent, hipEventDisableTiming));
+          }
+#       endif
+        }
+        catch (...)
+        {
+          destroyFanOuts();
+          throw;
+        }
+      }
+
+      /// @brief Copy constructor is deleted.
+      GroupedExecutor(const GroupedExecutor&) = delete;
+
+      /// @brief Move constructor is deleted.
+      GroupedExecutor(GroupedExecutor&&) = delete;
+
+      /// @brief Destructor, waits for the enqueued work and destroys the streams.
+      ~GroupedExecutor()
+      {
+        destroyFanOuts();
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      GroupedExecutor& operator=(const GroupedExecutor&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      GroupedExecutor& operator=(GroupedExecutor&&) = delete;
+
+      /**
+       * @brief Get the number of streams.
+       * @return The number of streams.
+       */
+      [[nodiscard]] std::size_t getStreamCount() const noexcept
+      {
+        return mFanOuts.size();
+      }
+
+      /**
+       * @brief Get the device of the executor.
+       * @return The device.
+       */
+      [[nodiscard]] constexpr int getDevice() const noexcept
+      {
+        return mDevice;
+      }
+
+      /**
+       * @brief Enqueue the transforms, returns without waiting for them. Work enqueued to the stream afterwards
+       *        starts after all the transforms finished.
+       * @param transforms The transforms.
+       * @param stream The issuing stream.
+       */
+      void execute(View<GroupedTransform> transforms, Stream stream = 0)
+      {
+        for (const auto& transform : transforms)
+        {
+          const auto& desc = detail::DescGetter::get(transform.getPlan());
+
+          if (desc.getTarget() != Target::gpu || desc.getDistribution() != Distribution::spst)
+          {
+            throw std::invalid_argument("grouped gpu execution requires spst gpu plans");
+          }
+
+          if (desc.getArchDesc<Target::gpu, Distribution::spst>().device != mDevice)
+          {
+            throw std::invalid_argument("grouped gpu execution requires the plans on the device of the executor");
+          }
+        }
+
+        if (transforms.empty())
+        {
+          return;
+        }
+
+        // a single transform needs no fan out
+        if (transforms.size() == 1)
+        {
+          afft::spst::gpu::ExecutionParameters execParams{};
+          execParams.stream = stream;
+
+          transforms.front().execute(execParams);
+          return;
+        }
+
+        const auto usedStreamCount = std::min(transforms.size(), mFanOuts.size());
+
+#     if defined(AFFT_ENABLE_CUDA)
+        detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+        detail::cuda::checkError(cudaEventRecord(mForkEvent, stream));
+
+        for (std::size_t i{}; i < usedStreamCount; ++i)
+        {
+          detail::cuda::checkError(cudaStreamWaitEvent(mFanOuts[i].stream, mForkEvent, 0));
+        }
+#     elif defined(AFFT_ENABLE_HIP)
+        detail::hip::ScopedDevice scopedDevice{mDevice};
+
+        detail::hip::checkError(hipEventRecord(mForkEvent, stream));
+
+        for (std::size_t i{}; i < usedStreamCount; ++i)
+        {
+          detail::hip::checkError(hipStreamWaitEvent(mFanOuts[i].stream, mForkEvent, 0));
+        }
+#     endif
+
+        // the issuing stream is joined even if an enqueue failed, so it never runs ahead of the enqueued transforms
+        std::exception_ptr exception{};
+
+        try
+        {
+          for (std::size_t i{}; i < transforms.size(); ++i)
+          {
+            afft::spst::gpu::ExecutionParameters execParams{};
+            execParams.stream = mFanOuts[i % usedStreamCount].stream;
+
+            transforms[i].execute(execParams);
+          }
+        }
+        catch (...)
+        {
+          exception = std::current_exception();
+        }
+
+        for (std::size_t i{}; i < usedStreamCount; ++i)
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::checkError(cudaEventRecord(mFanOuts[i].joinEvent, mFanOuts[i].stream));
+          detail::cuda::checkError(cudaStreamWaitEvent(stream, mFanOuts[i].joinEvent, 0));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::checkError(hipEventRecord(mFanOuts[i].joinEvent, mFanOuts[i].stream));
+          detail::hip::checkError(hipStreamWaitEvent(stream, mFanOuts[i].joinEvent, 0));
+#       endif
+        }
+
+        if (exception)
+        {
+          std::rethrow_exception(exception);
+        }
+      }
+    private:
+#   if defined(AFFT_ENABLE_CUDA)
+      /// @brief Event type.
+      using Event = cudaEvent_t;
+#   elif defined(AFFT_ENABLE_HIP)
+      /// @brief Event type.
+      using Event = hipEvent_t;
+#   endif
+
+      /// @brief Stream the transforms fan out to with the event joining it back to the issuing stream.
+      struct FanOut
+      {
+        Stream stream{};    ///< The stream.
+        Event  joinEvent{}; ///< The event recorded after the transforms of the stream.
+      };
+
+      /// @brief Wait for the streams and destroy them with the events, errors are ignored.
+      void destroyFanOuts() noexcept
+      {
+        try
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+          for (auto& fanOut : mFanOuts)
+          {
+            if (fanOut.stream != nullptr)
+            {
+              cudaStreamSynchronize(fanOut.stream);
+              cudaStreamDestroy(fanOut.stream);
+            }
+
+            if (fanOut.joinEvent != nullptr)
+            {
+              cudaEventDestroy(fanOut.joinEvent);
+            }
+          }
+
+          if (mForkEvent != nullptr)
+          {
+            cudaEventDestroy(mForkEvent);
+          }
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{mDevice};
+
+          for (auto& fanOut : mFanOuts)
+          {
+            if (fanOut.stream != nullptr)
+            {
+              hipStreamSynchronize(fanOut.stream);
+              hipStreamDestroy(fanOut.stream);
+            }
+
+            if (fanOut.joinEvent != nullptr)
+            {
+              hipEventDestroy(fanOut.joinEvent);
+            }
+          }
+
+          if (mForkEvent != nullptr)
+          {
+            hipEventDestroy(mForkEvent);
+          }
+#       endif
+        }
+        catch (...)
+        {
+          // The device may already be torn down at exit
+        }
+
+        mFanOuts.clear();
+        mForkEvent = nullptr;
+      }
+
+      int                 mDevice{};    ///< The device of the executor.
+      Event               mForkEvent{}; ///< The event recorded on the issuing stream before the transforms.
+      std::vector<FanOut> mFanOuts{};   ///< The streams the transforms fan out to.
+  };
+#endif
+} // namespace gpu
+} // namespace afft
+
+#endif /* AFFT_GROUPED_EXECUTOR_HPP */
@@ -0,0 +1,308 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_HYBRID_EXECUTOR_HPP
+#define AFFT_HYBRID_EXECUTOR_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "Plan.hpp"
+#include "StagedExecutor.hpp"
+
+AFFT_EXPORT namespace afft::gpu
+{
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+  /**
+   * @class HybridExecutor
+   * @brief Executes a batch of host chunks split between a spst gpu plan and a spst cpu plan of the same transform.
+   *        The leading chunks are transformed by the gpu plan through a StagedExecutor pipeline on the calling thread
+   *        while the trailing chunks are transformed concurrently by the cpu plan on a host thread, the cpu plan
+   *        parallelizes each chunk on the cpu thread pool. The split follows the gpu share of the total throughput,
+   *        smoothed over the measured throughputs of the previous executions. Both plans must use the default memory
+   *        layout and the interleaved complex format and must outlive the executor. The executor is not thread safe.
+   */
+  class HybridExecutor
+  {
+    public:
+      /// @brief Default gpu share of the chunks before any throughput was measured.
+      static constexpr double defaultGpuShare{0.8};
+
+      /// @brief Weight of the latest measurement in the smoothed throughputs.
+      static constexpr double throughputSmoothing{0.5};
+
+      /// @brief Minimum share of each side, keeps both throughputs measured.
+      static constexpr double minShare{1.0 / 64.0};
+
+      /**
+       * @brief Constructor.
+       * @param gpuPlan The spst gpu plan transforming one chunk.
+       * @param cpuPlan The spst cpu plan transforming one chunk.
+       * @param streamCount The number of streams of the gpu pipeline.
+       * @param gpuShare The initial gpu share of the chunks in [0, 1].
+       */
+      HybridExecutor(Plan&       gpuPlan,
+                     Plan&       cpuPlan,
+                     std::size_t streamCount = StagedExecutor::defaultStreamCount,
+                     double      gpuShare    = defaultGpuShare)
+      : mStagedExecutor{gpuPlan, streamCount},
+        mCpuPlan{&cpuPlan},
+        mGpuShare{gpuShare}
+      {
+        const auto& gpuDesc = detail::DescGetter::get(gpuPlan);
+        const auto& cpuDesc = detail::DescGetter::get(cpuPlan);
+
+        if (cpuDesc.getTarget() != Target::cpu || cpuDesc.getDistribution() != Distribution::spst)
+        {
+          throw std::invalid_argument("hybrid execution requires a spst cpu plan");
+        }
+
+        if (cpuDesc.getComplexFormat() != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument("hybrid execution supports only the interleaved complex format");
+        }
+
+        const auto& memoryLayout = cpuDesc.getMemoryLayout<Distribution::spst>();
+
+        if (!memoryLayout.hasDefaultSrcStrides() || !memoryLayout.hasDefaultDstStrides())
+        {
+          throw std::invalid_argument("hybrid execution supports only the default memory layout");
+        }
+
+        if (static_cast<const detail::TransformDesc&>(cpuDesc) != static_cast<const detail::TransformDesc&>(gpuDesc))
+        {
+          throw std::invalid_argument("hybrid execution requires the cpu and gpu plans of the same transform");
+        }
+
+        if (!(gpuShare >= 0.0 && gpuShare <= 1.0))
+        {
+          throw std::invalid_argument("gpu share must be in [0, 1]");
+        }
+      }
+
+      /// @brief Copy constructor is deleted.
+      HybridExecutor(const HybridExecutor&) = delete;
+
+      /// @brief Move constructor is deleted.
+      HybridExecutor(HybridExecutor&&) = delete;
+
+      /// @brief Destructor.
+      ~HybridExecutor() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      HybridExecutor& operator=(const HybridExecutor&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      HybridExecutor& operator=(HybridExecutor&&) = delete;
+
+      /**
+       * @brief Get the gpu share of the chunks of the next execution.
+       * @return The gpu share in [0, 1].
+       */
+      [[nodiscard]] constexpr double getGpuShare() const noexcept
+      {
+        return mGpuShare;
+      }
+
+      /**
+       * @brief Set the gpu share of the chunks and forget the measured throughputs.
+       * @param gpuShare The gpu share in [0, 1].
+       */
+      void setGpuShare(double gpuShare)
+      {
+        if (!(gpuShare >= 0.0 && gpuShare <= 1.0))
+        {
+          throw std::invalid_argument("gpu share must be in [0, 1]");
+        }
+
+        mGpuShare      = gpuShare;
+        mGpuThroughput = 0.0;
+        mCpuThroughput = 0.0;
+      }
+
+      /**
+       * @brief Get the smoothed gpu throughput.
+       * @return Chunks per second, 0 if not measured yet.
+       */
+      [[nodiscard]] constexpr double getGpuThroughput() const noexcept
+      {
+        return mGpuThroughput;
+      }
+
+      /**
+       * @brief Get the smoothed cpu throughput.
+       * @return Chunks per second, 0 if not measured yet.
+       */
+      [[nodiscard]] constexpr double getCpuThroughput() const noexcept
+      {
+        return mCpuThroughput;
+      }
+
+      /**
+       * @brief Get the underlying gpu pipeline.
+       * @return The staged executor.
+       */
+      [[nodiscard]] StagedExecutor& getStagedExecutor() noexcept
+      {
+        return mStagedExecutor;
+      }
+
+      /**
+       * @brief Transform the chunks of the host source into the host destination, returns after all the chunks are
+       *        transformed. For in-place plans the source and the destination may be the same buffer. The gpu
+       *        transfers overlap only if the host memory is page-locked, see gpu::PinnedAllocator.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @param src Host source buffer holding chunkCount chunks.
+       * @param dst Host destination buffer holding chunkCount chunks.
+       * @param chunkCount The number of chunks.
+       */
+      template<typename SrcT, typename DstT>
+      void execute(const SrcT* src, DstT* dst, std::size_t chunkCount)
+      {
+        static_assert(!std::is_const_v<DstT>, "destination buffer cannot be const");
+
+        if (src == nullptr || dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as host buffer");
+        }
+
+        const std::size_t gpuChunkCount = getGpuChunkCount(chunkCount);
+        const std::size_t cpuChunkCount = chunkCount - gpuChunkCount;
+
+        const auto* hostSrc = reinterpret_cast<const std::byte*>(src);
+        auto*       hostDst = reinterpret_cast<std::byte*>(dst);
+
+        const std::size_t srcChunkSize = mStagedExecutor.getSrcChunkSize();
+        const std::size_t dstChunkSize = mStagedExecutor.getDstChunkSize();
+
+        double cpuSeconds{};
+
+        // the cpu side runs on its own thread so its chunks overlap the gpu pipeline driven by this thread
+        auto cpuFuture = std::async((cpuChunkCount > 0) ? std::launch::async : std::launch::deferred, [&]
+        {
+          using Clock = std::chrono::steady_clock;
+
+          const auto start = Clock::now();
+
+          for (std::size_t i = gpuChunkCount; i < chunkCount; ++i)
+          {
+            mCpuPlan->execute(reinterpret_cast<std::remove_const_t<SrcT>*>(const_cast<std::byte*>(hostSrc + i * srcChunkSize)),
+                              reinterpret_cast<DstT*>(hostDst + i * dstChunkSize));
+          }
+
+          cpuSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        });
+
+        double gpuSeconds{};
+
+        try
+        {
+          using Clock = std::chrono::steady_clock;
+
+          const auto start = Clock::now();
+
+          if (gpuChunkCount > 0)
+          {
+            mStagedExecutor.execute(src, dst, gpuChunkCount);
+          }
+
+          gpuSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        catch (...)
+        {
+          if (cpuFuture.valid())
+          {
+            cpuFuture.wait();
+          }
+          throw;
+        }
+
+        cpuFuture.get();
+
+        updateThroughput(mGpuThroughput, gpuChunkCount, gpuSeconds);
+        updateThroughput(mCpuThroughput, cpuChunkCount, cpuSeconds);
+
+        if (mGpuThroughput > 0.0 && mCpuThroughput > 0.0)
+        {
+          mGpuShare = mGpuThroughput / (mGpuThroughput + mCpuThroughput);
+        }
+      }
+    private:
+      /**
+       * @brief Get the number of leading chunks transformed by the gpu.
+       * @param chunkCount The number of chunks.
+       * @return The gpu chunk count.
+       */
+      [[nodiscard]] std::size_t getGpuChunkCount(std::size_t chunkCount) const noexcept
+      {
+        // a side with a nonzero share keeps at least the minimum share so its throughput stays measured
+        double share = mGpuShare;
+
+        if (share > 0.0 && share < 1.0)
+        {
+          share = std::clamp(share, minShare, 1.0 - minShare);
+        }
+
+        auto gpuChunkCount = static_cast<std::size_t>(std::llround(share * static_cast<double>(chunkCount)));
+
+        if (chunkCount >= 2 && share > 0.0 && share < 1.0)
+        {
+          gpuChunkCount = std::clamp(gpuChunkCount, std::size_t{1}, chunkCount - 1);
+        }
+
+        return std::min(gpuChunkCount, chunkCount);
+      }
+
+      /**
+       * @brief Update a smoothed throughput by a measurement.
+       * @param throughput The smoothed throughput in chunks per second.
+       * @param chunkCount The number of measured chunks.
+       * @param seconds The measured time.
+       */
+      static void updateThroughput(double& throughput, std::size_t chunkCount, double seconds) noexcept
+      {
+        if (chunkCount == 0 || !(seconds > 0.0))
+        {
+          return;
+        }
+
+        const double measured = static_cast<double>(chunkCount) / seconds;
+
+        throughput = (throughput > 0.0) ? throughputSmoothing * measured + (1.0 - throughputSmoothing) * throughput
+                                        : measured;
+      }
+
+      StagedExecutor mStagedExecutor;   ///< The gpu pipeline.
+      Plan*          mCpuPlan{};        ///< The cpu plan.
+      double         mGpuShare{};       ///< The gpu share of the chunks of the next execution.
+      double         mGpuThroughput{};  ///< The smoothed gpu throughput in chunks per second.
+      double         mCpuThroughput{};  ///< The smoothed cpu throughput in chunks per second.
+  };
+#endif
+} // namespace afft::gpu
+
+#endif /* AFFT_HYBRID_EXECUTOR_HPP */
@@ -0,0 +1,872 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_OUT_OF_CORE_EXECUTOR_HPP
+#define AFFT_OUT_OF_CORE_EXECUTOR_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "alloc.hpp"
+#include "io.hpp"
+#include "makePlan.hpp"
+#include "Plan.hpp"
+
+AFFT_EXPORT namespace afft::gpu
+{
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+  /**
+   * @class OutOfCoreExecutor
+   * @brief Executes a single complex-to-complex transform over all axes of host data too large for the device memory.
+   *        The transform is split into two passes streamed through bounded device tiles. The first pass transforms
+   *        tiles of consecutive planes along the trailing axes, the second pass gathers tiles of columns and
+   *        transforms them along the leading axis. The tile sizes are the largest divisors of the leading extent and
+   *        of the trailing element count fitting the memory budget. Each stream owns one tile, so the copies of one
+   *        tile overlap the transform of another, only if the host memory is page-locked, see gpu::PinnedAllocator.
+   *        The data use the default memory layout and the interleaved complex format, the destination is used as the
+   *        intermediate buffer of the passes. With AFFT_ENABLE_GDS a CUDA executor reads the source from an
+   *        io::DeviceFile by GPUDirect Storage, bypassing the host memory in the first pass.
+   */
+  class OutOfCoreExecutor
+  {
+    public:
+#   if defined(AFFT_ENABLE_CUDA)
+      /// @brief Stream type.
+      using Stream = cudaStream_t;
+#   elif defined(AFFT_ENABLE_HIP)
+      /// @brief Stream type.
+      using Stream = hipStream_t;
+#   endif
+
+      /// @brief Default number of streams, double buffering the copies against the transforms.
+      static constexpr std::size_t defaultStreamCount{2};
+
+      /**
+       * @brief Constructor, chooses the tile sizes, creates the pass plans and allocates the device tiles.
+       * @tparam shapeExt Extent of the shape
+       * @tparam transformExt Extent of the transform
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param transformParams Parameters of the complex-to-complex transform, the placement is ignored
+       * @param archParams Architecture parameters, spst gpu only
+       * @param memoryBudget Device memory the executor may use in bytes, the free device memory if zero. Half of the
+       *                     budget of each stream is left to the plan workspace.
+       * @param streamCount The number of streams, usually two or three.
+       * @param backendParams Backend parameters of the pass plans
+       */
+      template<std::size_t shapeExt,
+               std::size_t transformExt,
+               typename ArchParamsT,
+               typename BackendParamsT = detail::DefaultBackendParameters>
+      OutOfCoreExecutor(const dft::Parameters<shapeExt, transformExt>& transformParams,
+                        const ArchParamsT&                             archParams,
+                        std::size_t                                    memoryBudget  = 0,
+                        std::size_t                                    streamCount   = defaultStreamCount,
+                        const BackendParamsT&                          backendParams = {})
+      {
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+        static_assert(ArchParamsT::target == Target::gpu && ArchParamsT::distribution == Distribution::spst,
+                      "out-of-core execution requires spst gpu architecture");
+
+        if (transformParams.type != dft::Type::complexToComplex)
+        {
+          throw std::invalid_argument("out-of-core execution supports only complex-to-complex transforms");
+        }
+
+        const auto& precision = transformParams.precision;
+
+        if (precision.source != precision.execution || precision.destination != precision.execution)
+        {
+          throw std::invalid_argument("out-of-core execution requires uniform precision");
+        }
+
+        if (archParams.complexFormat != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument("out-of-core execution supports only the interleaved complex format");
+        }
+
+        if (!archParams.memoryLayout.srcStrides.empty() || !archParams.memoryLayout.dstStrides.empty())
+        {
+          throw std::invalid_argument("out-of-core execution supports only the default memory layout");
+        }
+
+        if (!archParams.callbacks.load.srcCode.empty() || archParams.callbacks.load.devicePtr != nullptr ||
+            !archParams.callbacks.store.srcCode.empty() || archParams.callbacks.store.devicePtr != nullptr)
+        {
+          throw std::invalid_argument("out-of-core execution does not support user callbacks");
+        }
+
+        if (streamCount == 0)
+        {
+          throw std::invalid_argument("out-of-core execution requires at least one stream");
+        }
+
+        const detail::Desc desc{transformParams, archParams};
+
+        const auto shapeRank = desc.getShapeRank();
+        const auto shape     = desc.getShape();
+
+        if (shapeRank < 2 || desc.getTransformRank() != shapeRank)
+        {
+          throw std::invalid_argument("out-of-core execution requires a multidimensional transform over all axes");
+        }
+
+        mDevice     = archParams.device;
+        mElemSize   = desc.sizeOfSrcElem();
+        mPlaneCount = shape[0];
+        mPlaneSize  = std::accumulate(shape.begin() + 1, shape.begin() + shapeRank, std::size_t{1}, std::multiplies<>{});
+
+        if (memoryBudget == 0)
+        {
+          std::size_t freeMemory{};
+          std::size_t totalMemory{};
+
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{mDevice};
+          detail::cuda::checkError(cudaMemGetInfo(&freeMemory, &totalMemory));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{mDevice};
+          detail::hip::checkError(hipMemGetInfo(&freeMemory, &totalMemory));
+#       endif
+
+          memoryBudget = freeMemory;
+        }
+
+        const std::size_t tileBudget = memoryBudget / streamCount / 2;
+
+        // the largest divisor of the extent whose tile of the given element stride fits the budget
+        auto selectTileExtent = [&](std::size_t extent, std::size_t elemStride)
+        {
+          for (std::size_t tileExtent = std::min(extent, tileBudget / (elemStride * mElemSize)); tileExtent > 0; --tileExtent)
+          {
+            if (extent % tileExtent == 0)
+            {
+              return tileExtent;
+            }
+          }
+
+          throw std::invalid_argument("out-of-core execution tile does not fit the memory budget");
+        };
+
+        mPlanesPerTile  = selectTileExtent(mPlaneCount, mPlaneSize);
+        mColumnsPerTile = selectTileExtent(mPlaneSize, mPlaneCount);
+        mTileSize       = std::max(mPlanesPerTile * mPlaneSize, mColumnsPerTile * mPlaneCount) * mElemSize;
+
+        std::vector<std::size_t> passShape(shape.begin(), shape.begin() + shapeRank);
+        std::vector<std::size_t> passAxes(shapeRank - 1);
+        std::iota(passAxes.begin(), passAxes.end(), std::size_t{1});
+
+        dft::Parameters<> passParams{};
+        passParams.direction     = transformParams.direction;
+        passParams.precision     = precision;
+        passParams.normalization = transformParams.normalization;
+        passParams.placement     = Placement::inPlace;
+        passParams.type          = dft::Type::complexToComplex;
+
+        afft::spst::gpu::Parameters<> passArchParams{};
+        passArchParams.device = mDevice;
+
+        // the first pass transforms the trailing axes of the planes, the normalization factors of the passes multiply
+        // to the normalization factor of the whole transform
+        passShape[0]      = mPlanesPerTile;
+        passParams.shape  = passShape;
+        passParams.axes   = passAxes;
+        mPlanePlan        = makePlan(passParams, passArchParams, backendParams);
+
+        // the second pass transforms the leading axis of the gathered columns
+        const std::size_t columnShape[]{mPlaneCount, mColumnsPerTile};
+        const std::size_t columnAxes[]{0};
+
+        passParams.shape  = columnShape;
+        passParams.axes   = columnAxes;
+        mColumnPlan       = makePlan(passParams, passArchParams, backendParams);
+
+        mStages.resize(streamCount);
+
+        try
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+          for (auto& stage : mStages)
+          {
+            detail::cuda::checkError(cudaStreamCreateWithFlags(&stage.stream, cudaStreamNonBlocking));
+            detail::cuda::checkError(cudaMalloc(&stage.tile, mTileSize));
+          }
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{mDevice};
+
+          for (auto& stage : mStages)
+          {
+            detail::hip::checkError(hipStreamCreateWithFlags(&stage.stream, hipStreamNonBlocking));
+            detail::hip::checkError(hipMalloc(&stage.tile, mTileSize));
+          }
+#       endif
+        }
+        catch (...)
+        {
+          destroyStages();
+          throw;
+        }
+      }
+
+      /// @brief Copy constructor is deleted.
+      OutOfCoreExecutor(const OutOfCoreExecutor&) = delete;
+
+      /// @brief Move constructor is deleted.
+      OutOfCoreExecutor(OutOfCoreExecutor&&) = delete;
+
+      /// @brief Destructor, waits for the enqueued work and frees the device tiles.
+      ~OutOfCoreExecutor()
+      {
+        destroyStages();
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      OutOfCoreExecutor& operator=(const OutOfCoreExecutor&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      OutOfCoreExecutor& operator=(OutOfCoreExecutor&&) = delete;
+
+      /**
+       * @brief Get the number of streams.
+       * @return The number of streams.
+       */
+      [[nodiscard]] std::size_t getStreamCount() const noexcept
+      {
+        return mStages.size();
+      }
+
+      /**
+       * @brief Get the size of one device tile.
+       * @return The tile size in bytes.
+       */
+      [[nodiscard]] constexpr std::size_t getTileSize() const noexcept
+      {
+        return mTileSize;
+      }
+
+      /**
+       * @brief Get the number of leading axis planes transformed by one tile of the first pass.
+       * @return The number of planes.
+       */
+      [[nodiscard]] constexpr std::size_t getPlanesPerTile() const noexcept
+      {
+        return mPlanesPerTile;
+      }
+
+      /**
+       * @brief Get the number of leading axis columns transformed by one tile of the second pass.
+       * @return The number of columns.
+       */
+      [[nodiscard]] constexpr std::size_t getColumnsPerTile() const noexcept
+      {
+        return mColumnsPerTile;
+      }
+
+      /**
+       * @brief Transform the host source into the host destination, returns after both passes are copied back. The
+       *        source and the destination may be the same buffer.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @param src Host source buffer.
+       * @param dst Host destination buffer.
+       */
+      template<typename SrcT, typename DstT>
+      void execute(const SrcT* src, DstT* dst)
+      {
+        static_assert(!std::is_const_v<DstT>, "destination buffer cannot be const");
+
+        if (src == nullptr || dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as host buffer");
+        }
+
+        const auto* hostSrc = reinterpret_cast<const std::byte*>(src);
+        auto*       hostDst = reinterpret_cast<std::byte*>(dst);
+
+        const std::size_t planeTileSize = mPlanesPerTile * mPlaneSize * mElemSize;
+
+#     if defined(AFFT_ENABLE_CUDA)
+        detail::cuda::ScopedDevice scopedDevice{mDevice};
+#     elif defined(AFFT_ENABLE_HIP)
+        detail::hip::ScopedDevice scopedDevice{mDevice};
+#     endif
+
+        for (std::size_t i{}; i < mPlaneCount / mPlanesPerTile; ++i)
+        {
+          // the previous tile of the stage is ordered before on its stream, so the tile is free to reuse
+          auto& stage = mStages[i % mStages.size()];
+
+          afft::spst::gpu::ExecutionParameters execParams{};
+          execParams.stream = stage.stream;
+
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::checkError(cudaMemcpyAsync(stage.tile, hostSrc + i * planeTileSize, planeTileSize,
+                                                   cudaMemcpyHostToDevice, stage.stream));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::checkError(hipMemcpyAsync(stage.tile, hostSrc + i * planeTileSize, planeTileSize,
+                                                 hipMemcpyHostToDevice, stage.stream));
+#       endif
+
+          mPlanePlan->executeUnsafe(stage.tile, stage.tile, execParams);
+
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::checkError(cudaMemcpyAsync(hostDst + i * planeTileSize, stage.tile, planeTileSize,
+                                                   cudaMemcpyDeviceToHost, stage.stream));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::checkError(hipMemcpyAsync(hostDst + i * planeTileSize, stage.tile, planeTileSize,
+                                                 hipMemcpyDeviceToHost, stage.stream));
+#       endif
+        }
+
+        // the columns span the planes of all the tiles of the first pass
+        synchronizeStages();
+
+        transformColumns(hostDst);
+      }
+
+#   if defined(AFFT_ENABLE_CUDA) && defined(AFFT_ENABLE_GDS)
+      /**
+       * @brief Transform a file into the host destination, returns after both passes are copied back. The tiles of
+       *        the first pass are read by GPUDirect Storage straight into the device tiles, the read of a tile
+       *        overlaps the transforms and the copies enqueued on the other streams. The second pass works on the
+       *        destination as for host sources.
+       * @tparam DstT Destination type.
+       * @param src Source file.
+       * @param dst Host destination buffer.
+       * @param fileOffset Offset of the data in the file in bytes, a multiple of 4 KiB keeps the reads direct.
+       */
+      template<typename DstT>
+      void execute(const io::DeviceFile& src, DstT* dst, std::size_t fileOffset = 0)
+      {
+        static_assert(!std::is_const_v<DstT>, "destination buffer cannot be const");
+
+        if (dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as host buffer");
+        }
+
+        const std::size_t planeTileSize = mPlanesPerTile * mPlaneSize * mElemSize;
+        const std::size_t dataSize      = mPlaneCount * mPlaneSize * mElemSize;
+
+        if (fileOffset > src.size() || src.size() - fileOffset < dataSize)
+        {
+          throw std::invalid_argument("the file is smaller than the transformed data");
+        }
+
+        auto* hostDst = reinterpret_cast<std::byte*>(dst);
+
+        detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+        // registered tiles are the targets of the direct transfers, cuFile stages the reads of unregistered ones
+        for (auto& stage : mStages)
+        {
+          if (!stage.isFileRegistered)
+          {
+            stage.isFileRegistered = detail::cuda::isOk(cuFileBufRegister(stage.tile, mTileSize, 0));
+          }
+        }
+
+        for (std::size_t i{}; i < mPlaneCount / mPlanesPerTile; ++i)
+        {
+          auto& stage = mStages[i % mStages.size()];
+
+          afft::spst::gpu::ExecutionParameters execParams{};
+          execParams.stream = stage.stream;
+
+          // the read is synchronous, the tile is free once the copy back of its previous tile is done
+          detail::cuda::checkError(cudaStreamSynchronize(stage.stream));
+
+          src.read(stage.tile, planeTileSize, fileOffset + i * planeTileSize);
+
+          mPlanePlan->executeUnsafe(stage.tile, stage.tile, execParams);
+
+          detail::cuda::checkError(cudaMemcpyAsync(hostDst + i * planeTileSize, stage.tile, planeTileSize,
+                                                   cudaMemcpyDeviceToHost, stage.stream));
+        }
+
+        synchronizeStages();
+
+        transformColumns(hostDst);
+      }
+#   endif
+    private:
+      /// @brief Device tile and stream of one pipeline stage.
+      struct Stage
+      {
+        Stream stream{};           ///< The stream.
+        void*  tile{};             ///< The device tile, transformed in place.
+        bool   isFileRegistered{}; ///< The tile is registered with cuFile.
+      };
+
+      /**
+       * @brief Run the second pass over the columns of the host destination, returns after the columns are copied
+       *        back.
+       * @param hostDst Host destination holding the result of the first pass.
+       */
+      void transformColumns(std::byte* hostDst)
+      {
+        const std::size_t columnWidth = mColumnsPerTile * mElemSize;
+        const std::size_t rowPitch    = mPlaneSize * mElemSize;
+
+        for (std::size_t i{}; i < mPlaneSize / mColumnsPerTile; ++i)
+        {
+          auto& stage = mStages[i % mStages.size()];
+
+          afft::spst::gpu::ExecutionParameters execParams{};
+          execParams.stream = stage.stream;
+
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::checkError(cudaMemcpy2DAsync(stage.tile, columnWidth, hostDst + i * columnWidth, rowPitch,
+                                                     columnWidth, mPlaneCount, cudaMemcpyHostToDevice, stage.stream));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::checkError(hipMemcpy2DAsync(stage.tile, columnWidth, hostDst + i * columnWidth, rowPitch,
+                                                   columnWidth, mPlaneCount, hipMemcpyHostToDevice, stage.stream));
+#       endif
+
+          mColumnPlan->executeUnsafe(stage.tile, stage.tile, execParams);
+
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::checkError(cudaMemcpy2DAsync(hostDst + i * columnWidth, rowPitch, stage.tile, columnWidth,
+                                                     columnWidth, mPlaneCount, cudaMemcpyDeviceToHost, stage.stream));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::checkError(hipMemcpy2DAsync(hostDst + i * columnWidth, rowPitch, stage.tile, columnWidth,
+                                                   columnWidth, mPlaneCount, hipMemcpyDeviceToHost, stage.stream));
+#       endif
+        }
+
+        synchronizeStages();
+      }
+
+      /// @brief Wait for the work enqueued on the stages.
+      void synchronizeStages()
+      {
+        for (const auto& stage : mStages)
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::checkError(cudaStreamSynchronize(stage.stream));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::checkError(hipStreamSynchronize(stage.stream));
+#       endif
+        }
+      }
+
+      /// @brief Wait for the stages, free their tiles and destroy their streams, errors are ignored.
+      void destroyStages() noexcept
+      {
+        try
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+          for (auto& stage : mStages)
+          {
+            if (stage.stream != nullptr)
+            {
+              cudaStreamSynchronize(stage.stream);
+              cudaStreamDestroy(stage.stream);
+            }
+
+#         if defined(AFFT_ENABLE_GDS)
+            if (stage.isFileRegistered)
+            {
+              cuFileBufDeregister(stage.tile);
+            }
+#         endif
+
+            cudaFree(stage.tile);
+          }
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{mDevice};
+
+          for (auto& stage : mStages)
+          {
+            if (stage.stream != nullptr)
+            {
+              hipStreamSynchronize(stage.stream);
+              hipStreamDestroy(stage.stream);
+            }
+
+            hipFree(stage.tile);
+          }
+#       endif
+        }
+        catch (...)
+        {
+          // The device may already be torn down at exit
+        }
+
+        mStages.clear();
+      }
+
+      int                   mDevice{};         ///< The device of the plans.
+      std::size_t           mElemSize{};       ///< The size of one complex element in bytes.
+      std::size_t           mPlaneCount{};     ///< The extent of the leading axis.
+      std::size_t           mPlaneSize{};      ///< The number of elements of one leading axis plane.
+      std::size_t           mPlanesPerTile{};  ///< The number of planes of one first pass tile.
+      std::size_t           mColumnsPerTile{}; ///< The number of columns of one second pass tile.
+      std::size_t           mTileSize{};       ///< The size of one device tile in bytes.
+      std::unique_ptr<Plan> mPlanePlan{};      ///< The first pass plan over the trailing axes.
+      std::unique_ptr<Plan> mColumnPlan{};     ///< The second pass plan over the leading axis.
+      std::vector<Stage>    mStages{};         ///< The pipeline stages, one per stream.
+  };
+#endif
+} // namespace afft::gpu
+
+AFFT_EXPORT namespace afft::cpu
+{
+  /**
+   * @class OutOfCoreExecutor
+   * @brief Executes a single complex-to-complex transform over all axes of data too large for the host memory, usually
+   *        files mapped by io::MappedArray. The transform is split into two passes over bounded in-memory tiles, as
+   *        gpu::OutOfCoreExecutor does. The first pass reads slabs of consecutive planes sequentially and transforms
+   *        them along the trailing axes, the second pass gathers pencils of columns and transforms them along the
+   *        leading axis. The tile sizes are the largest divisors of the leading extent and of the trailing element
+   *        count fitting the memory budget, so the pencil rows read at once are as long as possible. Two tiles are
+   *        double buffered: while one is transformed, a background thread stores the previous tile and loads the next
+   *        one, whose successor is read ahead by the kernel. The data use the default memory layout and the
+   *        interleaved complex format, the destination is used as the intermediate buffer of the passes.
+   */
+  class OutOfCoreExecutor
+  {
+    public:
+      /**
+       * @brief Constructor, chooses the tile sizes, creates the pass plans and allocates the tiles.
+       * @tparam shapeExt Extent of the shape
+       * @tparam transformExt Extent of the transform
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param transformParams Parameters of the complex-to-complex transform, the placement is ignored
+       * @param archParams Architecture parameters, spst cpu only, the thread limit and the huge page policy are used by
+       *                   the pass plans
+       * @param memoryBudget Host memory the executor may use in bytes, a half of the available memory if zero. Half of
+       *                     the budget is left to the plan scratch buffers and the page cache.
+       * @param backendParams Backend parameters of the pass plans, the best strategy selects the fastest cpu backend
+       */
+      template<std::size_t shapeExt,
+               std::size_t transformExt,
+               typename ArchParamsT,
+               typename BackendParamsT = detail::DefaultBackendParameters>
+      OutOfCoreExecutor(const dft::Parameters<shapeExt, transformExt>& transformParams,
+                        const ArchParamsT&                             archParams,
+                        std::size_t                                    memoryBudget  = 0,
+                        const BackendParamsT&                          backendParams = {})
+      {
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+        static_assert(ArchParamsT::target == Target::cpu && ArchParamsT::distribution == Distribution::spst,
+                      "out-of-core execution requires spst cpu architecture");
+
+        if (transformParams.type != dft::Type::complexToComplex)
+        {
+          throw std::invalid_argument("out-of-core execution supports only complex-to-complex transforms");
+        }
+
+        const auto& precision = transformParams.precision;
+
+        if (precision.source != precision.execution || precision.destination != precision.execution)
+        {
+          throw std::invalid_argument("out-of-core execution requires uniform precision");
+        }
+
+        if (archParams.complexFormat != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument("out-of-core execution supports only the interleaved complex format");
+        }
+
+        if (!archParams.memoryLayout.srcStrides.empty() || !archParams.memoryLayout.dstStrides.empty())
+        {
+          throw std::invalid_argument("out-of-core execution supports only the default memory layout");
+        }
+
+        const detail::Desc desc{transformParams, archParams};
+
+        const auto shapeRank = desc.getShapeRank();
+        const auto shape     = desc.getShape();
+
+        if (shapeRank < 2 || desc.getTransformRank() != shapeRank)
+        {
+          throw std::invalid_argument("out-of-core execution requires a multidimensional transform over all axes");
+        }
+
+        mElemSize   = desc.sizeOfSrcElem();
+        mPlaneCount = shape[0];
+        mPlaneSize  = std::accumulate(shape.begin() + 1, shape.begin() + shapeRank, std::size_t{1}, std::multiplies<>{});
+
+        if (memoryBudget == 0)
+        {
+#       if defined(__linux__)
+          memoryBudget = static_cast<std::size_t>(::sysconf(_SC_AVPHYS_PAGES)) *
+                         static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)) / 2;
+#       else
+          throw std::invalid_argument("out-of-core execution requires a memory budget on this platform");
+#       endif
+        }
+
+        const std::size_t tileBudget = memoryBudget / tileCount / 2;
+
+        // the largest divisor of the extent whose tile of the given element stride fits the budget
+        auto selectTileExtent = [&](std::size_t extent, std::size_t elemStride)
+        {
+          for (std::size_t tileExtent = std::min(extent, tileBudget / (elemStride * mElemSize)); tileExtent > 0; --tileExtent)
+          {
+            if (extent % tileExtent == 0)
+            {
+              return tileExtent;
+            }
+          }
+
+          throw std::invalid_argument("out-of-core execution tile does not fit the memory budget");
+        };
+
+        mPlanesPerTile  = selectTileExtent(mPlaneCount, mPlaneSize);
+        mColumnsPerTile = selectTileExtent(mPlaneSize, mPlaneCount);
+        mTileSize       = std::max(mPlanesPerTile * mPlaneSize, mColumnsPerTile * mPlaneCount) * mElemSize;
+
+        std::vector<std::size_t> passShape(shape.begin(), shape.begin() + shapeRank);
+        std::vector<std::size_t> passAxes(shapeRank - 1);
+        std::iota(passAxes.begin(), passAxes.end(), std::size_t{1});
+
+        dft::Parameters<> passParams{};
+        passParams.direction     = transformParams.direction;
+        passParams.precision     = precision;
+        passParams.normalization = transformParams.normalization;
+        passParams.placement     = Placement::inPlace;
+        passParams.type          = dft::Type::complexToComplex;
+
+        afft::spst::cpu::Parameters<> passArchParams{};
+        passArchParams.alignment      = getDefaultAlignment();
+        passArchParams.threadLimit    = archParams.threadLimit;
+        passArchParams.hugePagePolicy = archParams.hugePagePolicy;
+
+        // the first pass transforms the trailing axes of the planes, the normalization factors of the passes multiply
+        // to the normalization factor of the whole transform
+        passShape[0]      = mPlanesPerTile;
+        passParams.shape  = passShape;
+        passParams.axes   = passAxes;
+        mPlanePlan        = makePlan(passParams, passArchParams, backendParams);
+
+        // the second pass transforms the leading axis of the gathered columns
+        const std::size_t columnShape[]{mPlaneCount, mColumnsPerTile};
+        const std::size_t columnAxes[]{0};
+
+        passParams.shape  = columnShape;
+        passParams.axes   = columnAxes;
+        mColumnPlan       = makePlan(passParams, passArchParams, backendParams);
+
+        // large tiles are backed by transparent huge pages to spare the TLB
+        for (auto& tile : mTiles)
+        {
+          tile = makeAlignedUniqueForOverwrite<std::byte[]>(getDefaultAlignment(), HugePagePolicy::transparent, mTileSize);
+        }
+      }
+
+      /**
+       * @brief Get the size of one tile.
+       * @return The tile size in bytes.
+       */
+      [[nodiscard]] constexpr std::size_t getTileSize() const noexcept
+      {
+        return mTileSize;
+      }
+
+      /**
+       * @brief Get the size of the source and destination data.
+       * @return The data size in bytes.
+       */
+      [[nodiscard]] constexpr std::size_t getDataSize() const noexcept
+      {
+        return mPlaneCount * mPlaneSize * mElemSize;
+      }
+
+      /**
+       * @brief Get the number of leading axis planes transformed by one slab of the first pass.
+       * @return The number of planes.
+       */
+      [[nodiscard]] constexpr std::size_t getPlanesPerTile() const noexcept
+      {
+        return mPlanesPerTile;
+      }
+
+      /**
+       * @brief Get the number of leading axis columns transformed by one pencil tile of the second pass.
+       * @return The number of columns.
+       */
+      [[nodiscard]] constexpr std::size_t getColumnsPerTile() const noexcept
+      {
+        return mColumnsPerTile;
+      }
+
+      /**
+       * @brief Transform the source into the destination. The source and the destination may be the same buffer.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @param src Source buffer of getDataSize() bytes.
+       * @param dst Destination buffer of getDataSize() bytes.
+       */
+      template<typename SrcT, typename DstT>
+      void execute(const SrcT* src, DstT* dst)
+      {
+        static_assert(!std::is_const_v<DstT>, "destination buffer cannot be const");
+
+        if (src == nullptr || dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as buffer");
+        }
+
+        const auto* srcBytes = reinterpret_cast<const std::byte*>(src);
+        auto*       dstBytes = reinterpret_cast<std::byte*>(dst);
+
+        const std::size_t slabSize    = mPlanesPerTile * mPlaneSize * mElemSize;
+        const std::size_t columnWidth = mColumnsPerTile * mElemSize;
+        const std::size_t rowPitch    = mPlaneSize * mElemSize;
+
+        // the slabs are read in the address order
+        io::advise(srcBytes, getDataSize(), io::Access::sequential);
+
+        runPass(mPlaneCount / mPlanesPerTile, *mPlanePlan,
+                [&](std::size_t i, std::byte* tile)
+                {
+                  if ((i + 1) * slabSize < getDataSize())
+                  {
+                    io::prefetch(srcBytes + (i + 1) * slabSize, slabSize);
+                  }
+
+                  std::memcpy(tile, srcBytes + i * slabSize, slabSize);
+                },
+                [&](std::size_t i, const std::byte* tile)
+                {
+                  std::memcpy(dstBytes + i * slabSize, tile, slabSize);
+                });
+
+        // the pencil rows are scattered over the planes, the default read-ahead serves the rows of the next columns
+        io::advise(dstBytes, getDataSize(), io::Access::normal);
+
+        runPass(mPlaneSize / mColumnsPerTile, *mColumnPlan,
+                [&](std::size_t i, std::byte* tile)
+                {
+                  for (std::size_t row{}; row < mPlaneCount; ++row)
+                  {
+                    if ((i + 1) * columnWidth < rowPitch)
+                    {
+                      io::prefetch(dstBytes + row * rowPitch + (i + 1) * columnWidth, columnWidth);
+                    }
+
+                    std::memcpy(tile + row * columnWidth, dstBytes + row * rowPitch + i * columnWidth, columnWidth);
+                  }
+                },
+                [&](std::size_t i, const std::byte* tile)
+                {
+                  for (std::size_t row{}; row < mPlaneCount; ++row)
+                  {
+                    std::memcpy(dstBytes + row * rowPitch + i * columnWidth, tile + row * columnWidth, columnWidth);
+                  }
+                });
+      }
+
+      /**
+       * @brief Transform the source mapping into the destination mapping. The mappings may be the same. The written
+       *        pages are stored by the kernel, see io::MappedArray::flush().
+       * @param src Source mapping of at least getDataSize() bytes.
+       * @param dst Destination mapping of at least getDataSize() bytes.
+       */
+      void execute(const io::MappedArray& src, io::MappedArray& dst)
+      {
+        if (src.size() < getDataSize() || dst.size() < getDataSize())
+        {
+          throw std::invalid_argument("the mapped file is smaller than the transformed data");
+        }
+
+        if (!dst.isWritable())
+        {
+          throw std::invalid_argument("the destination mapping is not writable");
+        }
+
+        execute(src.data(), dst.data());
+      }
+    private:
+      /// @brief Number of tiles, one transformed while the other is stored and loaded.
+      static constexpr std::size_t tileCount{2};
+
+      /**
+       * @brief Run one pass over the tiles, storing the previous tile and loading the next one in the background while
+       *        the current tile is transformed.
+       * @param count The number of tiles of the pass.
+       * @param plan The in-place pass plan.
+       * @param load Loads the tile of the given index.
+       * @param store Stores the tile of the given index.
+       */
+      template<typename LoadFnT, typename StoreFnT>
+      void runPass(std::size_t count, Plan& plan, LoadFnT&& load, StoreFnT&& store)
+      {
+        load(0, mTiles[0].get());
+
+        for (std::size_t i{}; i < count; ++i)
+        {
+          auto* tile      = mTiles[i % tileCount].get();
+          auto* otherTile = mTiles[(i + 1) % tileCount].get();
+
+          auto future = std::async((count > 1) ? std::launch::async : std::launch::deferred, [&]
+          {
+            if (i > 0)
+            {
+              store(i - 1, otherTile);
+            }
+
+            if (i + 1 < count)
+            {
+              load(i + 1, otherTile);
+            }
+          });
+
+          try
+          {
+            plan.executeUnsafe(static_cast<void*>(tile), static_cast<void*>(tile));
+          }
+          catch (...)
+          {
+            future.wait();
+            throw;
+          }
+
+          future.get();
+        }
+
+        store(count - 1, mTiles[(count - 1) % tileCount].get());
+      }
+
+      std::size_t                   mElemSize{};       ///< The size of one complex element in bytes.
+      std::size_t                   mPlaneCount{};     ///< The extent of the leading axis.
+      std::size_t                   mPlaneSize{};      ///< The number of elements of one leading axis plane.
+      std::size_t                   mPlanesPerTile{};  ///< The number of planes of one first pass slab.
+      std::size_t                   mColumnsPerTile{}; ///< The number of columns of one second pass pencil tile.
+      std::size_t                   mTileSize{};       ///< The size of one tile in bytes.
+      std::unique_ptr<Plan>         mPlanePlan{};      ///< The first pass plan over the trailing axes.
+      std::unique_ptr<Plan>         mColumnPlan{};     ///< The second pass plan over the leading axis.
+      AlignedUniquePtr<std::byte[]> mTiles[tileCount]; ///< The double buffered tiles.
+  };
+} // namespace afft::cpu
+
+#endif /* AFFT_OUT_OF_CORE_EXECUTOR_HPP */
@@ -43,6 +43,32 @@ extern "C"
 /// @brief Opaque plan structure
 typedef struct _afft_Plan afft_Plan;
 
+/// @brief Opaque bound executor structure, see afft::Plan::BoundExecutor
+typedef struct _afft_BoundExecutor afft_BoundExecutor;
+
+/**
+ * @brief Completion callback of an asynchronous execution.
+ * @param error Error code of the execution.
+ * @param userData User data passed to afft_Plan_executeAsync.
+ */
+typedef void (*afft_Plan_CompletionCallback)(afft_Error error, void* userData);
+
+/// @brief Plan statistics, see afft::PlanStats, the times are in seconds
+typedef struct
+{
+  uint64_t executionCount;     ///< Number of the executions
+  double   totalExecutionTime; ///< Total time of the executions
+  double   minExecutionTime;   ///< Minimum time of an execution
+  double   maxExecutionTime;   ///< Maximum time of an execution
+  double   planningTime;       ///< Time of the plan creation
+  double   flopsPerExecution;  ///< Estimated floating point operations of an execution
+  size_t   bytesPerExecution;  ///< Estimated bytes of an execution
+  uint64_t cycles;             ///< CPU cycles of the executions
+  uint64_t instructions;       ///< Retired instructions of the executions
+  uint64_t llcMisses;          ///< Last level cache misses of the executions
+  uint64_t dramBytes;          ///< Estimated DRAM bytes of the executions
+} afft_PlanStats;
+
 #if defined(__cplusplus) || (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L)
   /**
    * @brief Create a plan for a given transform and architecture.
@@ -149,6 +175,44 @@ afft_Error afft_Plan_getBackend(const afft_Plan* plan, afft_Backend* backend);
  */
 afft_Error afft_Plan_getWorkspaceSize(const afft_Plan* plan, size_t* count, const size_t** workspaceSizes);
 
+/**
+ * @brief Get the plan execution statistics. The execution times are recorded only if afft is configured with
+ *        AFFT_ENABLE_PLAN_STATS.
+ * @param plan Plan object.
+ * @param stats Pointer to the statistics variable.
+ * @return Error code.
+ */
+afft_Error afft_Plan_getStats(const afft_Plan* plan, afft_PlanStats* stats);
+
+/**
+ * @brief Get a latency percentile of the plan executions, see afft::LatencyHistogram.
+ * @param plan Plan object.
+ * @param percentile Percentile in range [0, 100], e.g. 99 for the p99 latency.
+ * @param latency Pointer to the latency variable, in seconds.
+ * @return Error code.
+ */
+afft_Error afft_Plan_getLatencyPercentile(const afft_Plan* plan, double percentile, double* latency);
+
+/**
+ * @brief Clear the latency histogram of the plan executions.
+ * @param plan Plan object.
+ * @return Error code.
+ */
+afft_Error afft_Plan_resetLatencyHistogram(afft_Plan* plan);
+
+/**
+ * @brief Get the plan memory footprint. The workspace allocated by the plan itself is counted to the target memory.
+ * @param plan Plan object.
+ * @param hostSize Pointer to the host memory size variable.
+ * @param deviceSizes Device memory size array of target count size, may be NULL. Zeroed for cpu plans.
+ * @param workspaceSizes External workspace size array of target count size, may be NULL.
+ * @return Error code.
+ */
+afft_Error afft_Plan_getMemoryFootprint(const afft_Plan* plan,
+                                        size_t*          hostSize,
+                                        size_t*          deviceSizes,
+                                        size_t*          workspaceSizes);
+
 /**
  * @brief Execute a plan.
  * @param plan Plan object.
@@ -166,6 +230,8 @@ afft_Error afft_Plan_execute(afft_Plan* plan, void* const* src, void* const* dst
    * @param dst Destination data pointer array of target count size (x2 if planar complex).
    * @param execParams Execution parameters. Any of afft_*target*_*distribution*_Parameters or generic parameters.
    * @return Error code.
+   * @note The parameters are converted and validated on every call. When they do not change between the calls, bind
+   *       them once with afft_Plan_bind and execute through the bound executor.
    */
 # define afft_Plan_executeWithParameters(plan, src, dst, execParams) \
     _afft_Plan_executeWithParameters(plan, src, dst, afft_makeExecutionParameters(execParams))
@@ -174,6 +240,85 @@ afft_Error afft_Plan_execute(afft_Plan* plan, void* const* src, void* const* dst
     _afft_Plan_executeWithParameters(plan, src, dst, execParams)
 #endif
 
+/**
+ * @brief Execute a plan for a batch of unrelated buffers of the plan's shape, see afft::Plan::executeBatch. Only single
+ *        target plans with interleaved complex format are supported.
+ * @param plan Plan object.
+ * @param batchSize Number of the source and destination buffers.
+ * @param srcs Source buffer array of batchSize size.
+ * @param dsts Destination buffer array of batchSize size, equal to the sources for in-place plans.
+ * @return Error code.
+ */
+afft_Error afft_Plan_executeBatch(afft_Plan* plan, size_t batchSize, void* const* srcs, void* const* dsts);
+
+#if defined(__cplusplus) || (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L)
+  /**
+   * @brief Execute a plan for a batch of unrelated buffers with execution parameters. Only spst plans are supported.
+   * @param plan Plan object.
+   * @param batchSize Number of the source and destination buffers.
+   * @param srcs Source buffer array of batchSize size.
+   * @param dsts Destination buffer array of batchSize size, equal to the sources for in-place plans.
+   * @param execParams Execution parameters. Any of afft_spst_*target*_ExecutionParameters or generic parameters.
+   * @return Error code.
+   */
+# define afft_Plan_executeBatchWithParameters(plan, batchSize, srcs, dsts, execParams) \
+    _afft_Plan_executeBatchWithParameters(plan, batchSize, srcs, dsts, afft_makeExecutionParameters(execParams))
+#else
+# define afft_Plan_executeBatchWithParameters(plan, batchSize, srcs, dsts, execParams) \
+    _afft_Plan_executeBatchWithParameters(plan, batchSize, srcs, dsts, execParams)
+#endif
+
+/**
+ * @brief Execute a spst cpu plan asynchronously on the afft executor thread pool. The callback is invoked from the pool
+ *        thread once the execution finishes. The plan and the buffers must stay valid until then, the pointer arrays
+ *        are copied. Gpu plans execute asynchronously to the stream passed in the execution parameters already.
+ * @param plan Plan object.
+ * @param src Source data pointer array (x2 if planar complex).
+ * @param dst Destination data pointer array (x2 if planar complex).
+ * @param execParams Execution parameters, may be NULL.
+ * @param callback Completion callback, may be NULL.
+ * @param userData User data passed to the callback.
+ * @return Error code of the submission.
+ */
+afft_Error afft_Plan_executeAsync(afft_Plan*                               plan,
+                                  void* const*                             src,
+                                  void* const*                             dst,
+                                  const afft_spst_cpu_ExecutionParameters* execParams,
+                                  afft_Plan_CompletionCallback             callback,
+                                  void*                                    userData);
+
+#if defined(__cplusplus) || (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L)
+  /**
+   * @brief Bind a plan to execution parameters, see afft::Plan::bind. The parameters are converted and validated once,
+   *        so afft_BoundExecutor_execute has minimal per call overhead. Only single target spst plans with interleaved
+   *        complex format can be bound. The plan must outlive the executor.
+   * @param plan Plan object.
+   * @param execParams Execution parameters. Any of afft_spst_*target*_ExecutionParameters or generic parameters.
+   * @param executorPtr Pointer to the bound executor.
+   * @return Error code.
+   */
+# define afft_Plan_bind(plan, execParams, executorPtr) \
+    _afft_Plan_bind(plan, afft_makeExecutionParameters(execParams), executorPtr)
+#else
+# define afft_Plan_bind(plan, execParams, executorPtr) \
+    _afft_Plan_bind(plan, execParams, executorPtr)
+#endif
+
+/**
+ * @brief Destroy a bound executor.
+ * @param executor Bound executor.
+ */
+void afft_BoundExecutor_destroy(afft_BoundExecutor* executor);
+
+/**
+ * @brief Execute the bound plan. No checks are done, the buffers must not be null and must match the plan placement.
+ * @param executor Bound executor.
+ * @param src Source buffer.
+ * @param dst Destination buffer.
+ * @return Error code.
+ */
+afft_Error afft_BoundExecutor_execute(const afft_BoundExecutor* executor, void* src, void* dst);
+
 /**********************************************************************************************************************/
 // Private functions
 /**********************************************************************************************************************/
@@ -190,6 +335,16 @@ afft_Error _afft_Plan_executeWithParameters(afft_Plan*               plan,
                                             void* const*             src,
                                             void* const*             dst,
                                             afft_ExecutionParameters execParams);
+
+afft_Error _afft_Plan_executeBatchWithParameters(afft_Plan*               plan,
+                                                 size_t                   batchSize,
+                                                 void* const*             srcs,
+                                                 void* const*             dsts,
+                                                 afft_ExecutionParameters execParams);
+
+afft_Error _afft_Plan_bind(afft_Plan*               plan,
+                           afft_ExecutionParameters execParams,
+                           afft_BoundExecutor**     executorPtr);
 #ifdef __cplusplus
 }
 #endif
@@ -33,12 +33,159 @@
 #include "common.hpp"
 #include "transform.hpp"
 #include "detail/Desc.hpp"
+#include "detail/PlanStatsRecorder.hpp"
+#include "detail/serialize.hpp"
+#include "detail/trace.hpp"
+#include "WorkspacePool.hpp"
+#include "detail/ThreadPool.hpp"
 
 AFFT_EXPORT namespace afft
 {
+  /**
+   * @struct PlanStats
+   * @brief Statistics of the plan executions. The execution times are recorded only if afft is configured with
+   *        AFFT_ENABLE_PLAN_STATS, otherwise the execution count and times stay zero. Spst gpu executions are timed by
+   *        events on the execution stream, other executions by the steady clock. Each transform of a batched execution
+   *        is counted as one execution of the average time. Executions of realtime plans are not recorded. The
+   *        hardware counters are sampled only for cpu executions if afft is configured with AFFT_ENABLE_COUNTERS, they
+   *        count the user space events of all the process threads during the executions. The DRAM traffic is
+   *        estimated from the last level cache misses, the floating point operations by the flopsPerExecution model.
+   */
+  struct PlanStats
+  {
+    std::uint64_t                 executionCount{};     ///< Number of the executions
+    std::chrono::duration<double> totalExecutionTime{}; ///< Total time of the executions
+    std::chrono::duration<double> minExecutionTime{};   ///< Minimum time of an execution
+    std::chrono::duration<double> maxExecutionTime{};   ///< Maximum time of an execution
+    std::chrono::duration<double> planningTime{};       ///< Time of the plan creation by makePlan()
+    double                        flopsPerExecution{};  ///< Estimated floating point operations of an execution, 5 N log2(N) per complex transform
+    std::size_t                   bytesPerExecution{};  ///< Estimated bytes of an execution, the source read and the destination written once
+    std::uint64_t                 cycles{};             ///< CPU cycles of the executions
+    std::uint64_t                 instructions{};       ///< Retired instructions of the executions
+    std::uint64_t                 llcMisses{};          ///< Last level cache misses of the executions
+    std::uint64_t                 dramBytes{};          ///< Estimated DRAM bytes of the executions, a cache line per last level cache miss
+  };
+
+  /**
+   * @struct LatencyHistogram
+   * @brief Histogram of the execution latencies of a plan. The buckets are log-linear: latencies below 16 ns are
+   *        counted exactly, each larger power of two range is split into 16 buckets, so a latency is known up to 1/16
+   *        of its value. The executions are counted like in PlanStats, the histogram stays empty unless afft is
+   *        configured with AFFT_ENABLE_PLAN_STATS.
+   */
+  struct LatencyHistogram
+  {
+    /// @brief Number of the buckets.
+    static constexpr std::size_t bucketCount{detail::latencyBucketCount};
+
+    std::array<std::uint64_t, bucketCount> counts{}; ///< Number of the executions of each bucket
+
+    /**
+     * @brief Get the smallest latency of a bucket.
+     * @param index Bucket index.
+     * @return Lower bound of the bucket.
+     */
+    [[nodiscard]] static constexpr std::chrono::nanoseconds getBucketLowerBound(std::size_t index)
+    {
+      if (index >= bucketCount)
+      {
+        throw std::out_of_range{"latency bucket index out of range"};
+      }
+
+      return std::chrono::nanoseconds{detail::getLatencyBucketLowerBound(index)};
+    }
+
+    /**
+     * @brief Get the latency past the end of a bucket.
+     * @param index Bucket index.
+     * @return Upper bound of the bucket, exclusive.
+     */
+    [[nodiscard]] static constexpr std::chrono::nanoseconds getBucketUpperBound(std::size_t index)
+    {
+      if (index >= bucketCount)
+      {
+        throw std::out_of_range{"latency bucket index out of range"};
+      }
+
+      return std::chrono::nanoseconds{(index + 1 < bucketCount)
+                                        ? detail::getLatencyBucketLowerBound(index + 1)
+                                        : std::uint64_t{1} << detail::latencyMaxBits};
+    }
+
+    /**
+     * @brief Get the number of the counted executions.
+     * @return Execution count.
+     */
+    [[nodiscard]] std::uint64_t getCount() const noexcept
+    {
+      return std::accumulate(counts.begin(), counts.end(), std::uint64_t{});
+    }
+
+    /**
+     * @brief Get a latency percentile, the upper bound of the bucket holding it.
+     * @param percentile Percentile in range [0, 100], e.g. 99 for the p99 latency.
+     * @return Latency not exceeded by the given percentage of the executions, zero if no execution was counted.
+     */
+    [[nodiscard]] std::chrono::nanoseconds getPercentile(double percentile) const
+    {
+      if (!(percentile >= 0.0 && percentile <= 100.0))
+      {
+        throw std::invalid_argument{"percentile must be in range [0, 100]"};
+      }
+
+      const auto totalCount = getCount();
+
+      if (totalCount == 0)
+      {
+        return std::chrono::nanoseconds{};
+      }
+
+      const auto rank = std::max(static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(totalCount))),
+                                 std::uint64_t{1});
+
+      std::uint64_t cumulativeCount{};
+
+      for (std::size_t i{}; i < bucketCount; ++i)
+      {
+        cumulativeCount += counts[i];
+
+        if (cumulativeCount >= rank)
+        {
+          return getBucketUpperBound(i);
+        }
+      }
+
+      return getBucketUpperBound(bucketCount - 1);
+    }
+  };
+
+  /**
+   * @struct MemoryFootprint
+   * @brief Memory held by the plan. The backend internal allocations (plan data, twiddle factors, internally allocated
+   *        workspace) are counted as accurately as the backend allows, backends not reporting them count zero.
+   */
+  struct MemoryFootprint
+  {
+    std::size_t              hostSize{};       ///< Host memory held by the plan
+    std::vector<std::size_t> deviceSizes{};    ///< Device memory held by the plan for each target, empty for cpu plans
+    std::vector<std::size_t> workspaceSizes{}; ///< External workspace required for each target, not held by the plan
+  };
+
+  /// @brief Status of a non-throwing execution, see Plan::tryExecute()
+  enum class ExecutionStatus : std::uint8_t
+  {
+    success,         ///< the transform was executed
+    invalidArgument, ///< the buffers or the execution parameters do not match the plan, nothing was executed
+    backendError,    ///< the backend failed to execute the transform
+    internalError,   ///< any other error
+  };
+
   class Plan : public std::enable_shared_from_this<Plan>
   {
     friend struct detail::DescGetter; 
+    friend struct detail::InversePlanSetter;
+    friend struct detail::PlanStatsSetter;
+    friend struct detail::trace::LabelSetter;
 
     private:
       /// @brief Default execution parameters helper.
@@ -180,6 +327,188 @@ AFFT_EXPORT namespace afft
         return {};
       }
 
+      /**
+       * @brief Get the size of memory held internally by the backend for each target (plan data, twiddle factors,
+       *        internally allocated workspace), not including the workspace reported by getWorkspaceSize().
+       * @return Internal memory size for each target, empty if unknown.
+       */
+      [[nodiscard]] virtual View<std::size_t> getBackendMemorySize() const noexcept
+      {
+        return {};
+      }
+
+      /**
+       * @brief Get the memory footprint of the plan. The workspace allocated by the plan itself is counted to the memory
+       *        of the targets, the external one is reported separately.
+       * @return Memory footprint.
+       */
+      [[nodiscard]] MemoryFootprint getMemoryFootprint() const
+      {
+        const auto targetCount       = getTargetCount();
+        const auto workspaceSize     = getWorkspaceSize();
+        const auto backendMemorySize = getBackendMemorySize();
+
+        MemoryFootprint footprint{};
+
+        std::vector<std::size_t> targetSizes(targetCount);
+
+        for (std::size_t i{}; i < targetCount; ++i)
+        {
+          targetSizes[i] = (i < backendMemorySize.size()) ? backendMemorySize[i] : 0;
+
+          if (!mDesc.useExternalWorkspace() && i < workspaceSize.size())
+          {
+            targetSizes[i] += workspaceSize[i];
+          }
+        }
+
+        if (mDesc.useExternalWorkspace())
+        {
+          footprint.workspaceSizes.resize(targetCount);
+
+          std::copy_n(workspaceSize.begin(), std::min(targetCount, workspaceSize.size()), footprint.workspaceSizes.begin());
+        }
+
+        if (getTarget() == Target::cpu)
+        {
+          footprint.hostSize = std::accumulate(targetSizes.begin(), targetSizes.end(), std::size_t{});
+        }
+        else
+        {
+          footprint.deviceSizes = std::move(targetSizes);
+        }
+
+        return footprint;
+      }
+
+      /**
+       * @brief Get the description of the choices made by the backend when the plan was created, e.g. an
+       *        automatically selected decomposition. It is recorded as the feedback message.
+       * @return Backend feedback, empty if there is nothing to report.
+       */
+      [[nodiscard]] virtual std::string getBackendFeedback() const
+      {
+        return {};
+      }
+
+      /**
+       * @brief Serialize the plan, see afft::deserializePlan(). The descriptor, the backend and the backend native
+       *        state (the FFTW3 wisdom) are stored. Only spst plans without runtime handles can be serialized, the
+       *        plan buffers are not stored.
+       * @return Serialized plan.
+       */
+      [[nodiscard]] std::string serialize() const
+      {
+        return detail::serializePlan(mDesc, getBackend());
+      }
+
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      /**
+       * @brief Create the same spst gpu plan on another device by the backend of this plan. The compiled code of the
+       *        runtime compiled callbacks, the VkFFT kernels and the rocFFT kernels are taken from the process-wide
+       *        caches when the device has the same architecture, only the device-resident state is created again.
+       *        Callbacks given by a device function pointer cannot be cloned. Defined in afft/makePlan.hpp.
+       * @param device Device of the new plan.
+       * @return Plan
+       */
+      [[nodiscard]] std::unique_ptr<Plan> cloneToDevice(int device) const;
+
+      /**
+       * @brief Create the same spst gpu plan on another device by the backend of this plan with the backend specific
+       *        parameters, e.g. the VkFFT tuning parameters the plan was created with. The backend mask and order are
+       *        replaced by the backend of this plan. Defined in afft/makePlan.hpp.
+       * @param device Device of the new plan.
+       * @param backendParams Backend parameters.
+       * @return Plan
+       */
+      [[nodiscard]] std::unique_ptr<Plan>
+      cloneToDevice(int device, const afft::spst::gpu::BackendParameters& backendParams) const;
+#   endif
+
+      /**
+       * @brief Get the execution statistics of the plan. Waits for the pending timed gpu executions.
+       * @return Plan statistics.
+       */
+      [[nodiscard]] PlanStats getStats() const
+      {
+        PlanStats stats{};
+
+#     ifdef AFFT_ENABLE_PLAN_STATS
+        mStatsRecorder.get(stats.executionCount,
+                           stats.totalExecutionTime,
+                           stats.minExecutionTime,
+                           stats.maxExecutionTime);
+#     endif
+
+#     ifdef AFFT_ENABLE_COUNTERS
+        const auto counters = mStatsRecorder.getCounters();
+
+        stats.cycles       = counters.cycles;
+        stats.instructions = counters.instructions;
+        stats.llcMisses    = counters.llcMisses;
+        stats.dramBytes    = counters.llcMisses * detail::perf::cacheLineSize;
+#     endif
+
+        stats.planningTime      = mPlanningTime;
+        stats.flopsPerExecution = detail::estimateFlops(mDesc);
+        stats.bytesPerExecution = detail::estimateBytes(mDesc);
+
+        return stats;
+      }
+
+      /**
+       * @brief Make the plan of the inverse transform of the same layout and backend. The direction is reversed and
+       *        the real-to-complex and the complex-to-real transforms are swapped, as are the source and the
+       *        destination precisions and strides. The unitary normalization moves to the other direction, so both
+       *        plans compose to the identity. The shape, the axes and the placement are kept. The backend selected
+       *        for this plan is reused with its backend parameters and the first select strategy, so the inverse plan
+       *        is not autotuned again, and the backends caching their setup per shape, such as the pocketfft and the
+       *        codelet twiddles, share it between both plans. Only spst plans made by makePlan() are supported.
+       * @return The inverse plan.
+       * @throw std::invalid_argument if the plan has no inverse of the same shape.
+       */
+      [[nodiscard]] std::unique_ptr<Plan> makeInverse() const
+      {
+        if (!mMakeInversePlanFn)
+        {
+          throw std::invalid_argument{"only plans made by makePlan() can make their inverse plan"};
+        }
+
+        return mMakeInversePlanFn(detail::makeInverseDesc(mDesc));
+      }
+
+      /**
+       * @brief Get the latency histogram of the plan executions. Waits for the pending timed gpu executions.
+       * @return Latency histogram.
+       */
+      [[nodiscard]] LatencyHistogram getLatencyHistogram() const
+      {
+        LatencyHistogram histogram{};
+
+#     ifdef AFFT_ENABLE_PLAN_STATS
+        histogram.counts = mStatsRecorder.getLatencyCounts(false);
+#     endif
+
+        return histogram;
+      }
+
+      /**
+       * @brief Clear the latency histogram of the plan executions, e.g. at the end of a monitoring interval. Waits for
+       *        the pending timed gpu executions. Each execution is counted by exactly one interval, the executions
+       *        concurrent to the reset may fall to either of the neighbouring ones.
+       * @return Latency histogram before the reset.
+       */
+      LatencyHistogram resetLatencyHistogram()
+      {
+        LatencyHistogram histogram{};
+
+#     ifdef AFFT_ENABLE_PLAN_STATS
+        histogram.counts = mStatsRecorder.getLatencyCounts(true);
+#     endif
+
+        return histogram;
+      }
+
       /**
        * @brief Execute the plan.
        * @tparam SrcDstT Source/destination type.
@@ -410,6 +739,70 @@ AFFT_EXPORT namespace afft
         executeImpl1(src, dst, execParams);
       }
 
+      /**
+       * @brief Execute the plan without throwing, see tryExecute(SrcT*, DstT*, const ExecParamsT&).
+       * @tparam SrcDstT Source/destination type.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param srcDst Source/destination buffer.
+       * @param execParams Execution parameters.
+       * @return Execution status.
+       */
+      template<typename SrcDstT, typename ExecParamsT = DefaultExecParams>
+      [[nodiscard]] ExecutionStatus tryExecute(SrcDstT* srcDst, const ExecParamsT execParams = {}) noexcept
+      {
+        static_assert(isKnownType<SrcDstT>, "unknown source/destination type");
+        static_assert(!std::is_const_v<SrcDstT>, "source/destination type must be non-const");
+        static_assert(isKnownExecParams<ExecParamsT>, "invalid execution parameters type");
+
+        return tryExecute(srcDst, srcDst, execParams);
+      }
+
+      /**
+       * @brief Execute the plan without throwing. The buffers and the execution parameters are checked before the
+       *        execution, a mismatch returns ExecutionStatus::invalidArgument without executing anything, so a valid
+       *        call does not raise an exception internally. The errors of the backend are reported by the status. With
+       *        a spst cpu realtime plan the execution neither allocates nor locks.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param src Source buffer.
+       * @param dst Destination buffer.
+       * @param execParams Execution parameters.
+       * @return Execution status.
+       */
+      template<typename SrcT, typename DstT, typename ExecParamsT = DefaultExecParams>
+      [[nodiscard]] ExecutionStatus tryExecute(SrcT* src, DstT* dst, const ExecParamsT execParams = {}) noexcept
+      {
+        static_assert(isKnownType<SrcT>, "unknown source type");
+        static_assert(isKnownType<DstT>, "unknown destination type");
+        static_assert(!std::is_const_v<DstT>, "destination type must be non-const");
+        static_assert(isKnownExecParams<ExecParamsT>, "invalid execution parameters type");
+
+        try
+        {
+          if (!isExecutable(src, dst, execParams))
+          {
+            return ExecutionStatus::invalidArgument;
+          }
+
+          execute(src, dst, execParams);
+        }
+        catch (const std::invalid_argument&)
+        {
+          return ExecutionStatus::invalidArgument;
+        }
+        catch (const Exception&)
+        {
+          return ExecutionStatus::backendError;
+        }
+        catch (...)
+        {
+          return ExecutionStatus::internalError;
+        }
+
+        return ExecutionStatus::success;
+      }
+
       /**
        * @brief Execute the plan without type checking.
        * @tparam ExecParamsT Execution parameters type.
@@ -650,84 +1043,759 @@ AFFT_EXPORT namespace afft
         executeImpl1(src, dst, execParams);
       }
 
-    protected:
-      /// @brief Default constructor is deleted.
-      Plan() = delete;
-
-      /// @brief Constructor.
-      Plan(const detail::Desc& desc)
-      : mDesc{desc}
-      {}
-
-      /// @brief Get the plan description.
-      [[nodiscard]] const detail::Desc& getDesc() const noexcept
-      {
-        return mDesc;
-      }
-
       /**
-       * @brief Execute the plan backend implementation.
-       * @param src Source buffers.
-       * @param dst Destination buffers.
-       * @param execParams Execution parameters.
+       * @brief Check if the plan can be warmed up on internally allocated scratch buffers. Supported for spst cpu plans
+       *        and spst gpu plans on CUDA or HIP.
+       * @return True if warmup() can be called without buffers, false otherwise.
        */
-      virtual void executeBackendImpl([[maybe_unused]] View<void*>                                 src,
-                                      [[maybe_unused]] View<void*>                                 dst,
-                                      [[maybe_unused]] const afft::spst::cpu::ExecutionParameters& execParams)
+      [[nodiscard]] bool hasWarmupScratchBuffers() const noexcept
       {
-        throw std::logic_error{"backend does not implement spst cpu execution"};
-      }
+        if (getDistribution() != Distribution::spst)
+        {
+          return false;
+        }
 
-      /**
-       * @brief Execute the plan backend implementation.
-       * @param src Source buffers.
-       * @param dst Destination buffers.
-       * @param execParams Execution parameters.
-       */
-      virtual void executeBackendImpl([[maybe_unused]] View<void*>                                 src,
-                                      [[maybe_unused]] View<void*>                                 dst,
-                                      [[maybe_unused]] const afft::spst::gpu::ExecutionParameters& execParams)
-      {
-        throw std::logic_error{"backend does not implement spst gpu execution"};
+        switch (getTarget())
+        {
+        case Target::cpu:
+          return true;
+#     if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        case Target::gpu:
+          return true;
+#     endif
+        default:
+          return false;
+        }
       }
 
       /**
-       * @brief Execute the plan backend implementation.
-       * @param src Source buffers.
-       * @param dst Destination buffers.
+       * @brief Warm up the plan by executing it once on internally allocated scratch buffers. Backends do lazy work on
+       *        the first execution, such as kernel loading, module JIT compilation or autotuning, calling warmup moves
+       *        it out of the latency critical executions. Gpu executions are synchronized with the stream before the
+       *        time is measured. The scratch buffers are freed before returning.
+       * @tparam ExecParamsT Execution parameters type.
        * @param execParams Execution parameters.
+       * @return Feedback holding the measured time of the warmup execution.
        */
-      virtual void executeBackendImpl([[maybe_unused]] View<void*>                                 src,
-                                      [[maybe_unused]] View<void*>                                 dst,
-                                      [[maybe_unused]] const afft::spmt::gpu::ExecutionParameters& execParams)
+      template<typename ExecParamsT = DefaultExecParams>
+      Feedback warmup(const ExecParamsT& execParams = {})
       {
-        throw std::logic_error{"backend does not implement spmt gpu execution"};
+        static_assert(isKnownExecParams<ExecParamsT>, "invalid execution parameters type");
+
+        if (!hasWarmupScratchBuffers())
+        {
+          throw std::invalid_argument{"plan cannot be warmed up on scratch buffers, pass the buffers to warmup"};
+        }
+
+        detail::Desc desc{mDesc};
+        desc.fillDefaultMemoryLayoutStrides();
+
+        const auto [srcSize, dstSize]   = desc.getSpstSrcDstBufferSize();
+        const auto [srcCount, dstCount] = desc.getSrcDstBufferCount();
+        const bool isInPlace            = (desc.getPlacement() == Placement::inPlace);
+
+        std::vector<ScratchBufferPtr> buffers{};
+        buffers.reserve(srcCount + dstCount);
+
+        std::vector<void*> srcs(srcCount);
+        std::vector<void*> dsts(dstCount);
+
+        for (auto& src : srcs)
+        {
+          src = buffers.emplace_back(allocateScratchBuffer(srcSize)).get();
+        }
+
+        for (std::size_t i{}; i < dstCount; ++i)
+        {
+          dsts[i] = (isInPlace && i < srcCount) ? srcs[i] : buffers.emplace_back(allocateScratchBuffer(dstSize)).get();
+        }
+
+        const auto [srcCmpl, dstCmpl] = desc.getSrcDstComplexity();
+        const bool isPlanar           = (desc.getComplexFormat() == ComplexFormat::planar);
+        const bool isSrcPlanar        = isPlanar && (srcCmpl == Complexity::complex);
+        const bool isDstPlanar        = isPlanar && (dstCmpl == Complexity::complex);
+
+        PlanarComplex<void> srcPlanar{srcs.front(), srcs.back()};
+        PlanarComplex<void> dstPlanar{dsts.front(), dsts.back()};
+
+        if (isSrcPlanar && isDstPlanar)
+        {
+          return warmup(srcPlanar, dstPlanar, execParams);
+        }
+        else if (isSrcPlanar)
+        {
+          return warmup(srcPlanar, dsts.front(), execParams);
+        }
+        else if (isDstPlanar)
+        {
+          return warmup(srcs.front(), dstPlanar, execParams);
+        }
+        else
+        {
+          return warmup(srcs.front(), dsts.front(), execParams);
+        }
       }
 
       /**
-       * @brief Execute the plan backend implementation.
-       * @param src Source buffers.
-       * @param dst Destination buffers.
+       * @brief Warm up the plan by executing it once on the given buffers, their contents are overwritten. Accepts
+       *        the same buffers as executeUnsafe().
+       * @tparam SrcT Source buffer type.
+       * @tparam DstT Destination buffer type.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param src Source buffer.
+       * @param dst Destination buffer.
        * @param execParams Execution parameters.
+       * @return Feedback holding the measured time of the warmup execution.
        */
-      virtual void executeBackendImpl([[maybe_unused]] View<void*>                                 src,
-                                      [[maybe_unused]] View<void*>                                 dst,
-                                      [[maybe_unused]] const afft::mpst::cpu::ExecutionParameters& execParams)
+      template<typename SrcT, typename DstT, typename ExecParamsT = DefaultExecParams>
+      Feedback warmup(SrcT src, DstT dst, const ExecParamsT& execParams = {})
       {
-        throw std::logic_error{"backend does not implement mpst cpu execution"};
+        static_assert(isKnownExecParams<ExecParamsT>, "invalid execution parameters type");
+
+        const auto start = std::chrono::steady_clock::now();
+
+        executeUnsafe(src, dst, execParams);
+        synchronizeWarmup(execParams);
+
+        Feedback feedback{getBackend(), "warmup", std::chrono::steady_clock::now() - start};
+
+        detail::trace::emit(trace::EventType::planWarmup, feedback.backend, {}, feedback.measuredTime);
+
+        return feedback;
       }
 
       /**
-       * @brief Execute the plan backend implementation.
-       * @param src Source buffers.
-       * @param dst Destination buffers.
+       * @brief Execute the plan for a batch of unrelated buffers of the plan's shape. Unlike execute(), where a view
+       *        holds one buffer per target, each source and destination pair is a separate transform. The buffers are
+       *        validated once for the whole batch. Only single target plans with interleaved complex format are
+       *        supported. On cpu the transforms run in one parallel region, on gpu they are issued to the stream
+       *        without host synchronization, backends may map them to a single batched launch.
+       * @tparam SrcT Source type, may be void.
+       * @tparam DstT Destination type, may be void.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param srcs Source buffers.
+       * @param dsts Destination buffers, equal to the sources for in-place transforms.
        * @param execParams Execution parameters.
        */
-      virtual void executeBackendImpl([[maybe_unused]] View<void*>                                 src,
-                                      [[maybe_unused]] View<void*>                                 dst,
-                                      [[maybe_unused]] const afft::mpst::gpu::ExecutionParameters& execParams)
+      template<typename SrcT, typename DstT, typename ExecParamsT = DefaultExecParams>
+      void executeBatch(View<SrcT*> srcs, View<DstT*> dsts, const ExecParamsT execParams = {})
       {
-        throw std::logic_error{"backend does not implement mpst gpu execution"};
+        static_assert(isKnownExecParams<ExecParamsT>, "invalid execution parameters type");
+        static_assert((std::is_void_v<std::remove_const_t<SrcT>> && std::is_void_v<DstT>) ||
+                      (!std::is_void_v<std::remove_const_t<SrcT>> && !std::is_void_v<DstT>),
+                      "invalid source and destination types");
+
+        using NonConstSrcT = std::remove_const_t<SrcT>;
+
+        if constexpr (std::is_const_v<SrcT>)
+        {
+          checkSrcIsPreserved();
+        }
+
+        if constexpr (!std::is_void_v<NonConstSrcT> && !std::is_void_v<DstT>)
+        {
+          checkExecTypeProps(typePrecision<SrcT>, typeComplexity<SrcT>, typePrecision<DstT>, typeComplexity<DstT>);
+        }
+
+        if (srcs.size() != dsts.size())
+        {
+          throw std::invalid_argument{"source and destination batch sizes differ"};
+        }
+
+        if (mDesc.getTargetCount() != 1)
+        {
+          throw std::invalid_argument{"batched execution supports only single target plans"};
+        }
+
+        if (mDesc.getComplexFormat() != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument{"batched execution supports only interleaved complex format"};
+        }
+
+        const bool isInPlace = (mDesc.getPlacement() == Placement::inPlace);
+
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          if (srcs[i] == nullptr)
+          {
+            throw std::invalid_argument("a null pointer was passed as source buffer");
+          }
+
+          if (dsts[i] == nullptr)
+          {
+            throw std::invalid_argument("a null pointer was passed as destination buffer");
+          }
+
+          const bool isItemInPlace = (reinterpret_cast<std::uintptr_t>(srcs[i]) ==
+                                      reinterpret_cast<std::uintptr_t>(dsts[i]));
+
+          if (isItemInPlace != isInPlace)
+          {
+            throw std::invalid_argument("placement does not match plan placement");
+          }
+        }
+
+        if (srcs.empty())
+        {
+          return;
+        }
+
+        View<void*> srcVoid{reinterpret_cast<void* const*>(const_cast<NonConstSrcT* const*>(srcs.data())), srcs.size()};
+        View<void*> dstVoid{reinterpret_cast<void* const*>(dsts.data()), dsts.size()};
+
+        if constexpr (std::is_same_v<ExecParamsT, DefaultExecParams>)
+        {
+          requireSpstBatch();
+
+          recordExecution(execParams, srcs.size(), [&]
+          {
+            switch (getTarget())
+            {
+            case Target::cpu:
+              executeBatchBackendImpl(srcVoid, dstVoid, afft::spst::cpu::ExecutionParameters{});
+              break;
+            case Target::gpu:
+              executeBatchBackendImpl(srcVoid, dstVoid, resolveWorkspace(afft::spst::gpu::ExecutionParameters{}));
+              break;
+            default:
+              detail::cxx::unreachable();
+            }
+          });
+        }
+        else
+        {
+          static_assert(ExecParamsT::distribution == Distribution::spst, "batched execution supports only spst plans");
+
+          if (execParams.target != getTarget())
+          {
+            throw std::invalid_argument("execution parameters target does not match plan target");
+          }
+
+          if (execParams.distribution != getDistribution())
+          {
+            throw std::invalid_argument("execution parameters distribution does not match plan distribution");
+          }
+
+          checkBatchCount(execParams);
+
+          prefetchManagedMemory(srcVoid, dstVoid, execParams);
+
+          recordExecution(execParams, srcs.size(), [&]
+          {
+            if constexpr (std::is_same_v<ExecParamsT, afft::spst::gpu::ExecutionParameters>)
+            {
+              const auto& resolvedExecParams = resolveWorkspace(execParams);
+              const auto  l2Window           = makeL2PersistingWindow(srcVoid, dstVoid, resolvedExecParams);
+
+              executeBatchBackendImpl(srcVoid, dstVoid, resolvedExecParams);
+            }
+            else
+            {
+              executeBatchBackendImpl(srcVoid, dstVoid, execParams);
+            }
+          });
+        }
+      }
+
+      /**
+       * @class BoundExecutor
+       * @brief Executor of a plan with the types and the execution parameters validated when bound. A call dispatches
+       *        straight to the backend without any checks, the caller guarantees the buffers are not null and match
+       *        the plan placement. The plan must outlive the executor.
+       * @tparam SrcT Source type, may be void.
+       * @tparam DstT Destination type, may be void.
+       * @tparam ExecParamsT Execution parameters type.
+       */
+      template<typename SrcT, typename DstT, typename ExecParamsT>
+      class BoundExecutor
+      {
+        friend class Plan;
+
+        public:
+          /// @brief Default constructor is deleted.
+          BoundExecutor() = delete;
+
+          /// @brief Copy constructor.
+          BoundExecutor(const BoundExecutor&) = default;
+
+          /// @brief Move constructor.
+          BoundExecutor(BoundExecutor&&) = default;
+
+          /// @brief Destructor.
+          ~BoundExecutor() = default;
+
+          /// @brief Copy assignment operator.
+          BoundExecutor& operator=(const BoundExecutor&) = default;
+
+          /// @brief Move assignment operator.
+          BoundExecutor& operator=(BoundExecutor&&) = default;
+
+          /**
+           * @brief Execute the plan with the bound execution parameters.
+           * @param src Source buffer.
+           * @param dst Destination buffer.
+           */
+          void operator()(SrcT* src, DstT* dst) const
+          {
+            (*this)(src, dst, mExecParams);
+          }
+
+          /**
+           * @brief Execute the plan.
+           * @param src Source buffer.
+           * @param dst Destination buffer.
+           * @param execParams Execution parameters.
+           */
+          void operator()(SrcT* src, DstT* dst, const ExecParamsT& execParams) const
+          {
+            void* srcVoid = const_cast<std::remove_const_t<SrcT>*>(src);
+            void* dstVoid = dst;
+
+            mPlan->prefetchManagedMemory(View<void*>{&srcVoid, 1}, View<void*>{&dstVoid, 1}, execParams);
+
+            mPlan->recordExecution(execParams, 1, [&]
+            {
+              if constexpr (std::is_same_v<ExecParamsT, afft::spst::gpu::ExecutionParameters>)
+              {
+                const auto resolvedExecParams = mPlan->resolveWorkspace(execParams);
+                const auto l2Window           = mPlan->makeL2PersistingWindow(View<void*>{&srcVoid, 1},
+                                                                              View<void*>{&dstVoid, 1},
+                                                                              resolvedExecParams);
+
+                mPlan->executeBackendImpl(View<void*>{&srcVoid, 1}, View<void*>{&dstVoid, 1}, resolvedExecParams);
+              }
+              else
+              {
+                mPlan->executeBackendImpl(View<void*>{&srcVoid, 1}, View<void*>{&dstVoid, 1}, execParams);
+              }
+            });
+          }
+        private:
+          /**
+           * @brief Constructor.
+           * @param plan The plan.
+           * @param execParams Execution parameters.
+           */
+          BoundExecutor(Plan& plan, const ExecParamsT& execParams)
+          : mPlan{&plan}, mExecParams{execParams}
+          {}
+
+          Plan*       mPlan{};       ///< The plan.
+          ExecParamsT mExecParams{}; ///< The bound execution parameters.
+      };
+
+      /**
+       * @brief Bind the plan to the source and destination types and the execution parameters. The checks done by
+       *        execute() on every call are done once here, so the returned executor has minimal per call overhead.
+       *        Only single target plans with interleaved complex format can be bound.
+       * @tparam SrcT Source type, may be void.
+       * @tparam DstT Destination type, may be void.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param execParams Execution parameters.
+       * @return The bound executor.
+       */
+      template<typename SrcT, typename DstT, typename ExecParamsT = afft::spst::cpu::ExecutionParameters>
+      [[nodiscard]] BoundExecutor<SrcT, DstT, ExecParamsT> bind(const ExecParamsT& execParams = {})
+      {
+        static_assert(isExecutionParameters<ExecParamsT>, "invalid execution parameters type");
+        static_assert((std::is_void_v<std::remove_const_t<SrcT>> && std::is_void_v<DstT>) ||
+                      (!std::is_void_v<std::remove_const_t<SrcT>> && !std::is_void_v<DstT>),
+                      "invalid source and destination types");
+
+        if constexpr (std::is_const_v<SrcT>)
+        {
+          checkSrcIsPreserved();
+        }
+
+        if constexpr (!std::is_void_v<std::remove_const_t<SrcT>> && !std::is_void_v<DstT>)
+        {
+          checkExecTypeProps(typePrecision<SrcT>, typeComplexity<SrcT>, typePrecision<DstT>, typeComplexity<DstT>);
+        }
+
+        if (mDesc.getTargetCount() != 1)
+        {
+          throw std::invalid_argument{"only single target plans can be bound"};
+        }
+
+        if (mDesc.getComplexFormat() != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument{"only plans with interleaved complex format can be bound"};
+        }
+
+        if (execParams.target != getTarget())
+        {
+          throw std::invalid_argument("execution parameters target does not match plan target");
+        }
+
+        if (execParams.distribution != getDistribution())
+        {
+          throw std::invalid_argument("execution parameters distribution does not match plan distribution");
+        }
+
+        checkBatchCount(execParams);
+
+        return BoundExecutor<SrcT, DstT, ExecParamsT>{*this, execParams};
+      }
+
+      /**
+       * @brief Execute the spst cpu plan asynchronously on the afft executor thread pool. The plan and the buffers must
+       *        stay valid until the future is ready. Concurrent executions of the same plan must use distinct buffers.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @param src Source buffer.
+       * @param dst Destination buffer, may be the same as the source buffer for in-place plans.
+       * @param execParams Execution parameters.
+       * @return Future of the execution, rethrows the execution error on get().
+       */
+      template<typename SrcT, typename DstT>
+      [[nodiscard]] std::future<void>
+      executeAsync(SrcT* src, DstT* dst, const afft::spst::cpu::ExecutionParameters& execParams = {})
+      {
+        return executeAsync([](std::function<void()> task)
+        {
+          (void)detail::getExecutorThreadPool().submit(std::move(task));
+        }, src, dst, execParams);
+      }
+
+      /**
+       * @brief Execute the spst cpu plan asynchronously on the user provided executor. The plan and the buffers must
+       *        stay valid until the future is ready. Concurrent executions of the same plan must use distinct buffers.
+       * @tparam ExecutorT Executor type, invocable with a `std::function<void()>` task it must run exactly once.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @param executor The executor.
+       * @param src Source buffer.
+       * @param dst Destination buffer, may be the same as the source buffer for in-place plans.
+       * @param execParams Execution parameters.
+       * @return Future of the execution, rethrows the execution error on get().
+       */
+      template<typename ExecutorT, typename SrcT, typename DstT>
+      [[nodiscard]] auto executeAsync(ExecutorT&&                                 executor,
+                                      SrcT*                                       src,
+                                      DstT*                                       dst,
+                                      const afft::spst::cpu::ExecutionParameters& execParams = {})
+        -> AFFT_RET_REQUIRES(std::future<void>, AFFT_PARAM(std::is_invocable_v<ExecutorT&, std::function<void()>>))
+      {
+        static_assert(isKnownType<SrcT>, "unknown source type");
+        static_assert(isKnownType<DstT>, "unknown destination type");
+        static_assert(!std::is_const_v<DstT>, "destination type must be non-const");
+
+        if (getTarget() != Target::cpu || getDistribution() != Distribution::spst)
+        {
+          throw std::invalid_argument{"asynchronous execution is supported only for spst cpu plans"};
+        }
+
+        auto task   = std::make_shared<std::packaged_task<void()>>([this, src, dst, execParams]
+        {
+          execute(src, dst, execParams);
+        });
+        auto future = task->get_future();
+
+        executor(std::function<void()>{[task = std::move(task)]{ (*task)(); }});
+
+        return future;
+      }
+
+#     if defined(AFFT_CXX_HAS_COROUTINE) && (defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP))
+      /**
+       * @class ExecuteAwaitable
+       * @brief Awaitable execution of a spst gpu plan. Awaiting it enqueues the transform on the stream of the execution
+       *        parameters followed by a host function, the host function hands the resumption of the coroutine over to
+       *        the afft executor thread pool, so no thread is blocked while the transform runs and the coroutine does
+       *        not resume on the driver callback thread, where gpu api calls are not allowed. The awaiting coroutine
+       *        resumes on an executor thread, the enqueue errors are rethrown from the co_await expression.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       */
+      template<typename SrcT, typename DstT>
+      class ExecuteAwaitable
+      {
+        friend class Plan;
+
+        public:
+          /// @brief Default constructor is deleted.
+          ExecuteAwaitable() = delete;
+
+          /// @brief Copy constructor.
+          ExecuteAwaitable(const ExecuteAwaitable&) = default;
+
+          /// @brief Move constructor.
+          ExecuteAwaitable(ExecuteAwaitable&&) = default;
+
+          /// @brief Destructor.
+          ~ExecuteAwaitable() = default;
+
+          /// @brief Copy assignment operator.
+          ExecuteAwaitable& operator=(const ExecuteAwaitable&) = default;
+
+          /// @brief Move assignment operator.
+          ExecuteAwaitable& operator=(ExecuteAwaitable&&) = default;
+
+          /// @brief The execution always suspends the awaiting coroutine.
+          [[nodiscard]] constexpr bool await_ready() const noexcept
+          {
+            return false;
+          }
+
+          /**
+           * @brief Enqueue the execution and the resumption of the coroutine on the stream.
+           * @param handle The awaiting coroutine.
+           * @return False if the enqueue failed and the coroutine continues immediately, true otherwise.
+           */
+          bool await_suspend(std::coroutine_handle<> handle) noexcept
+          {
+            mHandle = handle;
+
+            try
+            {
+              mPlan->execute(mSrc, mDst, mExecParams);
+#           if defined(AFFT_ENABLE_CUDA)
+              detail::cuda::checkError(cudaLaunchHostFunc(mExecParams.stream, resume, this));
+#           elif defined(AFFT_ENABLE_HIP)
+              detail::hip::checkError(hipLaunchHostFunc(mExecParams.stream, resume, this));
+#           endif
+            }
+            catch (...)
+            {
+              mError = std::current_exception();
+              return false;
+            }
+
+            return true;
+          }
+
+          /// @brief Rethrow the enqueue error if any.
+          void await_resume() const
+          {
+            if (mError)
+            {
+              std::rethrow_exception(mError);
+            }
+          }
+
+        private:
+          /**
+           * @brief Constructor.
+           * @param plan The plan.
+           * @param src Source buffer.
+           * @param dst Destination buffer.
+           * @param execParams Execution parameters.
+           */
+          ExecuteAwaitable(Plan& plan, SrcT* src, DstT* dst, const afft::spst::gpu::ExecutionParameters& execParams)
+          : mPlan{&plan}, mSrc{src}, mDst{dst}, mExecParams{execParams}
+          {}
+
+          /**
+           * @brief Host function reached by the stream after the transform, submits the resumption to the executor.
+           * @param data The awaitable.
+           */
+          static void resume(void* data) noexcept
+          {
+            auto handle = static_cast<ExecuteAwaitable*>(data)->mHandle;
+
+            try
+            {
+              (void)detail::getExecutorThreadPool().submit(std::function<void()>{[handle]{ handle.resume(); }});
+            }
+            catch (...)
+            {
+              // the pool cannot take the task, resume on the callback thread rather than never
+              handle.resume();
+            }
+          }
+
+          Plan*                                mPlan{};       ///< The plan.
+          SrcT*                                mSrc{};        ///< Source buffer.
+          DstT*                                mDst{};        ///< Destination buffer.
+          afft::spst::gpu::ExecutionParameters mExecParams{}; ///< Execution parameters.
+          std::coroutine_handle<>              mHandle{};     ///< The awaiting coroutine.
+          std::exception_ptr                   mError{};      ///< The enqueue error.
+      };
+
+      /**
+       * @brief Execute the spst gpu plan asynchronously by `co_await plan.executeAsync(src, dst, execParams)`, see
+       *        ExecuteAwaitable. The plan and the buffers must stay valid until the coroutine resumes.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @param src Source buffer.
+       * @param dst Destination buffer, may be the same as the source buffer for in-place plans.
+       * @param execParams Execution parameters.
+       * @return The awaitable execution.
+       */
+      template<typename SrcT, typename DstT>
+      [[nodiscard]] ExecuteAwaitable<SrcT, DstT>
+      executeAsync(SrcT* src, DstT* dst, const afft::spst::gpu::ExecutionParameters& execParams)
+      {
+        static_assert(isKnownType<SrcT>, "unknown source type");
+        static_assert(isKnownType<DstT>, "unknown destination type");
+        static_assert(!std::is_const_v<DstT>, "destination type must be non-const");
+
+        if (getTarget() != Target::gpu || getDistribution() != Distribution::spst)
+        {
+          throw std::invalid_argument{"awaitable execution is supported only for spst gpu plans"};
+        }
+
+        return ExecuteAwaitable<SrcT, DstT>{*this, src, dst, execParams};
+      }
+#     endif
+
+    protected:
+      /// @brief Default constructor is deleted.
+      Plan() = delete;
+
+      /// @brief Constructor.
+      Plan(const detail::Desc& desc)
+      : mDesc{desc}
+      {}
+
+      /// @brief Get the plan description.
+      [[nodiscard]] const detail::Desc& getDesc() const noexcept
+      {
+        return mDesc;
+      }
+
+      /**
+       * @brief Execute the plan backend implementation.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      virtual void executeBackendImpl([[maybe_unused]] View<void*>                                 src,
+                                      [[maybe_unused]] View<void*>                                 dst,
+                                      [[maybe_unused]] const afft::spst::cpu::ExecutionParameters& execParams)
+      {
+        throw std::logic_error{"backend does not implement spst cpu execution"};
+      }
+
+      /**
+       * @brief Execute the plan backend implementation.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      virtual void executeBackendImpl([[maybe_unused]] View<void*>                                 src,
+                                      [[maybe_unused]] View<void*>                                 dst,
+                                      [[maybe_unused]] const afft::spst::gpu::ExecutionParameters& execParams)
+      {
+        throw std::logic_error{"backend does not implement spst gpu execution"};
+      }
+
+      /**
+       * @brief Execute the plan backend implementation.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      virtual void executeBackendImpl([[maybe_unused]] View<void*>                                 src,
+                                      [[maybe_unused]] View<void*>                                 dst,
+                                      [[maybe_unused]] const afft::spmt::gpu::ExecutionParameters& execParams)
+      {
+        throw std::logic_error{"backend does not implement spmt gpu execution"};
+      }
+
+      /**
+       * @brief Execute the plan backend implementation.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      virtual void executeBackendImpl([[maybe_unused]] View<void*>                                 src,
+                                      [[maybe_unused]] View<void*>                                 dst,
+                                      [[maybe_unused]] const afft::mpst::cpu::ExecutionParameters& execParams)
+      {
+        throw std::logic_error{"backend does not implement mpst cpu execution"};
+      }
+
+      /**
+       * @brief Execute the plan backend implementation.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      virtual void executeBackendImpl([[maybe_unused]] View<void*>                                 src,
+                                      [[maybe_unused]] View<void*>                                 dst,
+                                      [[maybe_unused]] const afft::mpst::gpu::ExecutionParameters& execParams)
+      {
+        throw std::logic_error{"backend does not implement mpst gpu execution"};
+      }
+    
+      /**
+       * @brief Execute the batch backend implementation, the buffers are already validated. The default runs the
+       *        transforms in one parallel region limited by the plan thread limit, the backend must support concurrent
+       *        execution of the plan on distinct buffers.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      virtual void executeBatchBackendImpl(View<void*>                                 srcs,
+                                           View<void*>                                 dsts,
+                                           const afft::spst::cpu::ExecutionParameters& execParams)
+      {
+        const auto threadLimit = mDesc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        detail::parallelFor(srcs.size(), threadLimit, [&](std::size_t i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        });
+      }
+
+      /**
+       * @brief Execute the batch backend implementation, the buffers are already validated. The default issues the
+       *        transforms one by one to the stream.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      virtual void executeBatchBackendImpl(View<void*>                                 srcs,
+                                           View<void*>                                 dsts,
+                                           const afft::spst::gpu::ExecutionParameters& execParams)
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+      /**
+       * @brief Execute the backend implementation of another plan. Allows plans wrapping other plans to forward the
+       *        execution.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param plan The plan.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      template<typename ExecParamsT>
+      static void executeBackendImplOf(Plan& plan, View<void*> src, View<void*> dst, const ExecParamsT& execParams)
+      {
+        plan.executeBackendImpl(src, dst, execParams);
+      }
+
+      /**
+       * @brief Execute the batch backend implementation of another plan. Allows plans wrapping other plans to forward
+       *        the batched execution.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param plan The plan.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      template<typename ExecParamsT>
+      static void executeBatchBackendImplOf(Plan& plan, View<void*> srcs, View<void*> dsts, const ExecParamsT& execParams)
+      {
+        plan.executeBatchBackendImpl(srcs, dsts, execParams);
+      }
+
+      /**
+       * @brief Lock the internal buffers of the plan for an execution. Realtime plans take no lock, they must not be
+       *        executed by several threads at once.
+       * @param mutex The mutex guarding the buffers.
+       * @return The lock, not owning the mutex for realtime plans.
+       */
+      [[nodiscard]] std::unique_lock<std::mutex> lockExecution(std::mutex& mutex) const
+      {
+        return (mDesc.isRealtime()) ? std::unique_lock<std::mutex>{mutex, std::defer_lock}
+                                    : std::unique_lock<std::mutex>{mutex};
       }
     
       detail::Desc mDesc;
@@ -786,6 +1854,109 @@ AFFT_EXPORT namespace afft
         }
       }
 
+      /**
+       * @brief Check the execution type properties without throwing.
+       * @param srcPrecision Source precision.
+       * @param srcComplexity Source complexity.
+       * @param dstPrecision Destination precision.
+       * @param dstComplexity Destination complexity.
+       * @return True if the types match the plan, false otherwise.
+       */
+      [[nodiscard]] bool matchesExecTypeProps(const Precision  srcPrecision,
+                                              const Complexity srcComplexity,
+                                              const Precision  dstPrecision,
+                                              const Complexity dstComplexity) const
+      {
+        const auto& prec = mDesc.getPrecision();
+        const auto [refSrcCmpl, refDstCmpl] = mDesc.getSrcDstComplexity();
+
+        if (mDesc.getPlacement() == Placement::inPlace)
+        {
+          return (srcPrecision == prec.source || srcPrecision == prec.destination) &&
+                 (srcComplexity == refSrcCmpl || srcComplexity == refDstCmpl);
+        }
+
+        return srcPrecision == prec.source && dstPrecision == prec.destination &&
+               srcComplexity == refSrcCmpl && dstComplexity == refDstCmpl;
+      }
+
+      /**
+       * @brief Check the buffers and the execution parameters of an execution without throwing, mirrors the checks of
+       *        execute().
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param src Source buffer.
+       * @param dst Destination buffer.
+       * @param execParams Execution parameters.
+       * @return True if the execution is valid, false otherwise.
+       */
+      template<typename SrcT, typename DstT, typename ExecParamsT>
+      [[nodiscard]] bool isExecutable(SrcT* src, DstT* dst, [[maybe_unused]] const ExecParamsT& execParams) const
+      {
+        if (src == nullptr || dst == nullptr || mDesc.getTargetCount() != 1)
+        {
+          return false;
+        }
+
+        if constexpr (std::is_const_v<SrcT>)
+        {
+          if (!mDesc.getPreserveSource())
+          {
+            return false;
+          }
+        }
+
+        const bool isInPlace = reinterpret_cast<std::uintptr_t>(src) == reinterpret_cast<std::uintptr_t>(dst);
+
+        if (((isInPlace) ? Placement::inPlace : Placement::outOfPlace) != mDesc.getPlacement())
+        {
+          return false;
+        }
+
+        if (!matchesExecTypeProps(typePrecision<std::remove_const_t<SrcT>>,
+                                  typeComplexity<std::remove_const_t<SrcT>>,
+                                  typePrecision<DstT>,
+                                  typeComplexity<DstT>))
+        {
+          return false;
+        }
+
+        std::size_t batchCount{};
+
+        if constexpr (std::is_same_v<ExecParamsT, afft::spst::cpu::ExecutionParameters>)
+        {
+          batchCount = execParams.batchCount;
+        }
+
+        if constexpr (!std::is_same_v<ExecParamsT, DefaultExecParams>)
+        {
+          if (execParams.target != getTarget() || execParams.distribution != getDistribution())
+          {
+            return false;
+          }
+        }
+
+        if (getTarget() == Target::cpu && getDistribution() == Distribution::spst)
+        {
+          if (batchCount > mDesc.getOuterBatchCount())
+          {
+            return false;
+          }
+        }
+
+        return true;
+      }
+
+      /// @brief Check the plan supports batched execution with the default execution parameters.
+      void requireSpstBatch() const
+      {
+        if (getDistribution() != Distribution::spst)
+        {
+          throw std::invalid_argument{"batched execution supports only spst plans"};
+        }
+      }
+
       /// @brief Check if the source is preserved.
       void checkSrcIsPreserved() const
       {
@@ -795,6 +1966,113 @@ AFFT_EXPORT namespace afft
         }
       }
 
+      /// @brief Owning pointer to a warmup scratch buffer, the deleter depends on the target.
+      using ScratchBufferPtr = std::shared_ptr<void>;
+
+      /**
+       * @brief Allocate a zeroed warmup scratch buffer on the plan target.
+       * @param size Size of the buffer in bytes.
+       * @return Scratch buffer.
+       */
+      [[nodiscard]] ScratchBufferPtr allocateScratchBuffer(std::size_t size) const
+      {
+        // the backends reject null buffers, empty transforms get a minimal one
+        size = std::max(size, std::size_t{1});
+
+        switch (getTarget())
+        {
+        case Target::cpu:
+        {
+          const auto& cpuDesc   = mDesc.getArchDesc<Target::cpu, Distribution::spst>();
+          const auto  alignment = static_cast<std::align_val_t>(std::max(cpuDesc.alignment, cpu::getDefaultAlignment()));
+
+          ScratchBufferPtr buffer{::operator new(size, alignment), [alignment](void* ptr)
+          {
+            ::operator delete(ptr, alignment);
+          }};
+
+          std::memset(buffer.get(), 0, size);
+
+          return buffer;
+        }
+#     if defined(AFFT_ENABLE_CUDA)
+        case Target::gpu:
+        {
+          detail::cuda::ScopedDevice scopedDevice{mDesc.getArchDesc<Target::gpu, Distribution::spst>().device};
+
+          void* ptr{};
+
+          detail::cuda::checkError(cudaMalloc(&ptr, size));
+
+          ScratchBufferPtr buffer{ptr, [](void* ptr)
+          {
+            cudaFree(ptr);
+          }};
+
+          detail::cuda::checkError(cudaMemset(ptr, 0, size));
+
+          return buffer;
+        }
+#     elif defined(AFFT_ENABLE_HIP)
+        case Target::gpu:
+        {
+          detail::hip::ScopedDevice scopedDevice{mDesc.getArchDesc<Target::gpu, Distribution::spst>().device};
+
+          void* ptr{};
+
+          detail::hip::checkError(hipMalloc(&ptr, size));
+
+          ScratchBufferPtr buffer{ptr, [](void* ptr)
+          {
+            (void)hipFree(ptr);
+          }};
+
+          detail::hip::checkError(hipMemset(ptr, 0, size));
+
+          return buffer;
+        }
+#     endif
+        default:
+          throw std::invalid_argument{"scratch buffers are not supported for the plan target"};
+        }
+      }
+
+      /**
+       * @brief Wait for the warmup execution to complete. Gpu executions are synchronized with the execution stream.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param execParams Execution parameters.
+       */
+      template<typename ExecParamsT>
+      void synchronizeWarmup([[maybe_unused]] const ExecParamsT& execParams) const
+      {
+#     if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        if (getTarget() != Target::gpu)
+        {
+          return;
+        }
+
+#       if defined(AFFT_ENABLE_CUDA)
+        cudaStream_t stream{0};
+#       else
+        hipStream_t stream{0};
+#       endif
+
+        if constexpr (!std::is_same_v<ExecParamsT, DefaultExecParams>)
+        {
+          if constexpr (ExecParamsT::target == Target::gpu)
+          {
+            stream = execParams.stream;
+          }
+        }
+
+#       if defined(AFFT_ENABLE_CUDA)
+        detail::cuda::checkError(cudaStreamSynchronize(stream));
+#       else
+        detail::hip::checkError(hipStreamSynchronize(stream));
+#       endif
+#     endif
+      }
+
       /**
        * @brief Check execution buffer count.
        * @param srcCount Source buffer count.
@@ -827,6 +2105,29 @@ AFFT_EXPORT namespace afft
         }
       }
 
+      /**
+       * @brief Check the batch count requested by the spst execution parameters.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param execParams Execution parameters.
+       */
+      template<typename ExecParamsT>
+      void checkBatchCount([[maybe_unused]] const ExecParamsT& execParams) const
+      {
+        constexpr bool hasBatchCount = std::is_same_v<ExecParamsT, afft::spst::cpu::ExecutionParameters>
+#     if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+                                    || std::is_same_v<ExecParamsT, afft::spst::gpu::ExecutionParameters>
+#     endif
+                                    ;
+
+        if constexpr (hasBatchCount)
+        {
+          if (execParams.batchCount > mDesc.getOuterBatchCount())
+          {
+            throw std::invalid_argument("execution batch count exceeds the plan outermost batch count");
+          }
+        }
+      }
+
       /**
        * @brief Level 1 implementation of the execute method.
        * @tparam SrcT Source type.
@@ -889,7 +2190,7 @@ AFFT_EXPORT namespace afft
           checkSrcIsPreserved();
         }
 
-        View<NonConstSrcT> srcNonConst{const_cast<PlanarComplex<NonConstSrcT>* const*>(src.data()), src.size()};
+        View<PlanarComplex<NonConstSrcT>> srcNonConst{reinterpret_cast<const PlanarComplex<NonConstSrcT>*>(src.data()), src.size()};
 
         checkBufferCount(src.size(), dst.size());
         
@@ -930,7 +2231,7 @@ AFFT_EXPORT namespace afft
           checkSrcIsPreserved();
         }
 
-        View<NonConstSrcT> srcNonConst{const_cast<NonConstSrcT* const*>(src.data()), src.size()};
+        View<NonConstSrcT*> srcNonConst{const_cast<NonConstSrcT* const*>(src.data()), src.size()};
 
         checkBufferCount(src.size(), dst.size());
         
@@ -971,7 +2272,7 @@ AFFT_EXPORT namespace afft
           checkSrcIsPreserved();
         }
 
-        View<NonConstSrcT> srcNonConst{const_cast<PlanarComplex<NonConstSrcT>* const*>(src.data()), src.size()};
+        View<PlanarComplex<NonConstSrcT>> srcNonConst{reinterpret_cast<const PlanarComplex<NonConstSrcT>*>(src.data()), src.size()};
 
         checkBufferCount(src.size(), dst.size());
         
@@ -1003,7 +2304,17 @@ AFFT_EXPORT namespace afft
       template<typename SrcT, typename DstT, typename ExecParamsT>
       void executeImpl2(View<SrcT> src, View<DstT> dst, const ExecParamsT& execParams)
       {
-        auto isNullPtr = [](const auto* ptr) { return ptr == nullptr; };
+        auto isNullPtr = [](const auto& ptr)
+        {
+          if constexpr (std::is_pointer_v<std::decay_t<decltype(ptr)>>)
+          {
+            return ptr == nullptr;
+          }
+          else
+          {
+            return ptr.real == nullptr || ptr.imag == nullptr;
+          }
+        };
 
         if (std::any_of(src.begin(), src.end(), isNullPtr))
         {
@@ -1015,45 +2326,49 @@ AFFT_EXPORT namespace afft
           throw std::invalid_argument("a null pointer was passed as destination buffer");
         }
 
-        View<void*> srcVoid{reinterpret_cast<void* const*>(src.data()), src.size()};
-        View<void*> dstVoid{reinterpret_cast<void* const*>(dst.data()), dst.size()};
+        // planar complex buffers are passed to the backend as consecutive real and imaginary pointers
+        View<void*> srcVoid{reinterpret_cast<void* const*>(src.data()), src.size() * (sizeof(SrcT) / sizeof(void*))};
+        View<void*> dstVoid{reinterpret_cast<void* const*>(dst.data()), dst.size() * (sizeof(DstT) / sizeof(void*))};
 
         if constexpr (std::is_same_v<ExecParamsT, DefaultExecParams>)
         {
-          switch (getTarget())
+          recordExecution(execParams, 1, [&]
           {
-          case Target::cpu:
-            switch (getDistribution())
-            {
-            case Distribution::spst:
-              executeBackendImpl(srcVoid, dstVoid, afft::spst::cpu::ExecutionParameters{});
-              break;
-            case Distribution::mpst:
-              executeBackendImpl(srcVoid, dstVoid, afft::mpst::cpu::ExecutionParameters{});
-              break;
-            default:
-              detail::cxx::unreachable();
-            }
-            break;
-          case Target::gpu:
-            switch (getDistribution())
+            switch (getTarget())
             {
-            case Distribution::spst:
-              executeBackendImpl(srcVoid, dstVoid, afft::spst::gpu::ExecutionParameters{});
-              break;
-            case Distribution::spmt:
-              executeBackendImpl(srcVoid, dstVoid, afft::spmt::gpu::ExecutionParameters{});
+            case Target::cpu:
+              switch (getDistribution())
+              {
+              case Distribution::spst:
+                executeBackendImpl(srcVoid, dstVoid, afft::spst::cpu::ExecutionParameters{});
+                break;
+              case Distribution::mpst:
+                executeBackendImpl(srcVoid, dstVoid, afft::mpst::cpu::ExecutionParameters{});
+                break;
+              default:
+                detail::cxx::unreachable();
+              }
               break;
-            case Distribution::mpst:
-              executeBackendImpl(srcVoid, dstVoid, afft::mpst::gpu::ExecutionParameters{});
+            case Target::gpu:
+              switch (getDistribution())
+              {
+              case Distribution::spst:
+                executeBackendImpl(srcVoid, dstVoid, resolveWorkspace(afft::spst::gpu::ExecutionParameters{}));
+                break;
+              case Distribution::spmt:
+                executeBackendImpl(srcVoid, dstVoid, afft::spmt::gpu::ExecutionParameters{});
+                break;
+              case Distribution::mpst:
+                executeBackendImpl(srcVoid, dstVoid, afft::mpst::gpu::ExecutionParameters{});
+                break;
+              default:
+                detail::cxx::unreachable();
+              }
               break;
             default:
               detail::cxx::unreachable();
             }
-            break;
-          default:
-            detail::cxx::unreachable();
-          }
+          });
         }
         else
         {
@@ -1067,9 +2382,246 @@ AFFT_EXPORT namespace afft
             throw std::invalid_argument("execution parameters distribution does not match plan distribution");
           }
 
-          executeBackendImpl(srcVoid, dstVoid, execParams);
+          checkBatchCount(execParams);
+
+          prefetchManagedMemory(srcVoid, dstVoid, execParams);
+
+          recordExecution(execParams, 1, [&]
+          {
+            if constexpr (std::is_same_v<ExecParamsT, afft::spst::gpu::ExecutionParameters>)
+            {
+              const auto& resolvedExecParams = resolveWorkspace(execParams);
+              const auto  l2Window           = makeL2PersistingWindow(srcVoid, dstVoid, resolvedExecParams);
+
+              executeBackendImpl(srcVoid, dstVoid, resolvedExecParams);
+            }
+            else
+            {
+              executeBackendImpl(srcVoid, dstVoid, execParams);
+            }
+          });
+        }
+      }
+
+      /**
+       * @brief Prefetch the managed source, destination and workspace buffers to the device on the execution stream if
+       *        requested by the spst gpu execution parameters. Other buffers are left untouched.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      template<typename ExecParamsT>
+      void prefetchManagedMemory([[maybe_unused]] View<void*>        src,
+                                 [[maybe_unused]] View<void*>        dst,
+                                 [[maybe_unused]] const ExecParamsT& execParams) const
+      {
+#     if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        if constexpr (std::is_same_v<ExecParamsT, afft::spst::gpu::ExecutionParameters>)
+        {
+          if (!execParams.prefetchManagedMemory)
+          {
+            return;
+          }
+
+          const auto [srcSize, dstSize] = mDesc.getSpstSrcDstBufferSize();
+          const auto device             = mDesc.getArchDesc<Target::gpu, Distribution::spst>().device;
+          const auto workspaceSize      = getWorkspaceSize();
+
+          auto prefetch = [&](const void* ptr, std::size_t size)
+          {
+#         if defined(AFFT_ENABLE_CUDA)
+            detail::cuda::prefetchManagedMemory(ptr, size, device, execParams.stream, execParams.adviseManagedMemory);
+#         elif defined(AFFT_ENABLE_HIP)
+            detail::hip::prefetchManagedMemory(ptr, size, device, execParams.stream, execParams.adviseManagedMemory);
+#         endif
+          };
+
+          for (void* ptr : src)
+          {
+            prefetch(ptr, srcSize);
+          }
+
+          // in-place destination buffers are already prefetched as the source ones
+          for (std::size_t i{}; i < dst.size(); ++i)
+          {
+            if (i >= src.size() || dst[i] != src[i])
+            {
+              prefetch(dst[i], dstSize);
+            }
+          }
+
+          if (!workspaceSize.empty())
+          {
+            prefetch(execParams.workspace, workspaceSize.front());
+          }
+        }
+#     endif
+      }
+
+      /// @brief Access policy window of the stream marking a buffer as persisting in the L2 cache, empty without CUDA.
+#   ifdef AFFT_ENABLE_CUDA
+      using L2PersistingWindow = detail::cuda::L2PersistingWindow;
+#   else
+      struct L2PersistingWindow {};
+#   endif
+
+      /**
+       * @brief Make the access policy window of the execution stream for the buffer selected by the spst gpu execution
+       *        parameters. Other executions do not set any window.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters with the workspace resolved.
+       * @return The window, it is kept until its destruction.
+       */
+      template<typename ExecParamsT>
+      [[nodiscard]] L2PersistingWindow makeL2PersistingWindow([[maybe_unused]] View<void*>        src,
+                                                              [[maybe_unused]] View<void*>        dst,
+                                                              [[maybe_unused]] const ExecParamsT& execParams) const
+      {
+#     ifdef AFFT_ENABLE_CUDA
+        if constexpr (std::is_same_v<ExecParamsT, afft::spst::gpu::ExecutionParameters>)
+        {
+          const auto device = mDesc.getArchDesc<Target::gpu, Distribution::spst>().device;
+
+          switch (execParams.l2Persistence)
+          {
+          case afft::spst::gpu::L2Persistence::workspace:
+          {
+            const auto workspaceSize = getWorkspaceSize();
+
+            if (!workspaceSize.empty())
+            {
+              return L2PersistingWindow{execParams.workspace, workspaceSize.front(), device, execParams.stream};
+            }
+            break;
+          }
+          case afft::spst::gpu::L2Persistence::source:
+            if (!src.empty())
+            {
+              return L2PersistingWindow{src.front(), mDesc.getSpstSrcDstBufferSize().first, device, execParams.stream};
+            }
+            break;
+          case afft::spst::gpu::L2Persistence::destination:
+            if (!dst.empty())
+            {
+              return L2PersistingWindow{dst.front(), mDesc.getSpstSrcDstBufferSize().second, device, execParams.stream};
+            }
+            break;
+          default:
+            break;
+          }
+        }
+#     endif
+
+        return L2PersistingWindow{};
+      }
+
+      /**
+       * @brief Take the workspace from the workspace pool if the plan uses the external workspace and none was given.
+       * @param execParams Execution parameters.
+       * @return Execution parameters with the workspace set.
+       */
+      [[nodiscard]] afft::spst::gpu::ExecutionParameters
+      resolveWorkspace(const afft::spst::gpu::ExecutionParameters& execParams) const
+      {
+        auto resolvedExecParams = execParams;
+
+#     if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        const auto workspaceSize = getWorkspaceSize();
+
+        if (mDesc.useExternalWorkspace() &&
+            resolvedExecParams.workspace == nullptr &&
+            !workspaceSize.empty() &&
+            workspaceSize.front() > 0)
+        {
+          auto& workspacePool = (resolvedExecParams.workspacePool != nullptr)
+                                  ? *resolvedExecParams.workspacePool : gpu::getDefaultWorkspacePool();
+
+          resolvedExecParams.workspace = workspacePool.acquire(workspaceSize.front(),
+                                                               mDesc.getArchDesc<Target::gpu, Distribution::spst>().device,
+                                                               resolvedExecParams.stream);
+        }
+#     endif
+
+        return resolvedExecParams;
+      }
+
+      /**
+       * @brief Run the executions in a traced range and record their time if the plan statistics are enabled.
+       * @tparam ExecParamsT Execution parameters type.
+       * @tparam FnT Function type.
+       * @param execParams Execution parameters, the spst gpu ones give the stream the executions are timed on.
+       * @param count Number of the executions run by the function.
+       * @param fn Function running the executions.
+       */
+      template<typename ExecParamsT, typename FnT>
+      void recordExecution([[maybe_unused]] const ExecParamsT& execParams, [[maybe_unused]] std::size_t count, FnT&& fn)
+      {
+#     ifdef AFFT_ENABLE_TRACING
+        detail::trace::Range range{mTraceLabel};
+#     endif
+
+#     ifdef AFFT_ENABLE_PLAN_STATS
+        // the recorder takes a lock, realtime executions are not recorded
+        if (mDesc.isRealtime())
+        {
+          fn();
+          return;
+        }
+
+#       if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        if constexpr (std::is_same_v<ExecParamsT, afft::spst::gpu::ExecutionParameters> ||
+                      std::is_same_v<ExecParamsT, DefaultExecParams>)
+        {
+          if (getTarget() == Target::gpu && getDistribution() == Distribution::spst)
+          {
+            detail::PlanStatsRecorder::Stream stream{};
+
+            if constexpr (std::is_same_v<ExecParamsT, afft::spst::gpu::ExecutionParameters>)
+            {
+              stream = execParams.stream;
+            }
+
+            const auto events = mStatsRecorder.startGpu(stream);
+            fn();
+            mStatsRecorder.stopGpu(events, stream, count);
+            return;
+          }
+        }
+#       endif
+
+#       ifdef AFFT_ENABLE_COUNTERS
+        if (getTarget() == Target::cpu)
+        {
+          auto& sampler = detail::perf::Sampler::get();
+
+          const auto startCounters = sampler.sample();
+          const auto start         = std::chrono::steady_clock::now();
+          fn();
+          const auto time          = std::chrono::steady_clock::now() - start;
+          mStatsRecorder.record(time, sampler.sample() - startCounters, count);
+          return;
         }
+#       endif
+
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        mStatsRecorder.record(std::chrono::steady_clock::now() - start, count);
+#     else
+        fn();
+#     endif
       }
+
+      std::chrono::duration<double> mPlanningTime{};  ///< Time of the plan creation.
+      std::function<std::unique_ptr<Plan>(const detail::Desc&)> mMakeInversePlanFn{}; ///< Makes the inverse plan of the same backend.
+#   ifdef AFFT_ENABLE_PLAN_STATS
+      mutable detail::PlanStatsRecorder mStatsRecorder{}; ///< Recorder of the execution times.
+#   endif
+#   ifdef AFFT_ENABLE_TRACING
+      std::string mTraceLabel{"afft execute"}; ///< Label of the traced executions.
+#   endif
   };
 } // namespace afft
 
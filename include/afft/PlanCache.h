@@ -0,0 +1,246 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_PLAN_CACHE_H
+#define AFFT_PLAN_CACHE_H
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.h"
+#endif
+
+#include "architecture.h"
+#include "backend.h"
+#include "error.h"
+#include "Plan.h"
+#include "transform.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Opaque plan cache structure, see afft::PlanCache. The cached plans are owned by the cache, a plan returned by
+ *        the cache must not be destroyed by afft_Plan_destroy() and stays valid until it is evicted, erased, replaced
+ *        or the cache is cleared or destroyed.
+ */
+typedef struct _afft_PlanCache afft_PlanCache;
+
+/// @brief Plan cache statistics, see afft::PlanCache::Statistics, the times are in seconds
+typedef struct
+{
+  size_t hitCount;      ///< Number of the lookups that found a plan
+  size_t missCount;     ///< Number of the lookups that did not find a plan
+  size_t evictionCount; ///< Number of the plans evicted because a limit was exceeded
+  size_t memorySize;    ///< Memory in bytes currently held by the cached plans
+  double planningTime;  ///< Time spent creating plans on misses
+} afft_PlanCacheStatistics;
+
+/**
+ * @brief Create a plan cache.
+ * @param maxSize Maximum number of cached plans, 0 for no limit.
+ * @param threadSafe If true, the cache may be used by multiple threads concurrently. Plans are created under the
+ *                   cache lock, so concurrent misses are planned one by one.
+ * @param cachePtr Pointer to the plan cache.
+ * @return Error code.
+ */
+afft_Error afft_PlanCache_create(size_t maxSize, bool threadSafe, afft_PlanCache** cachePtr);
+
+/**
+ * @brief Destroy a plan cache and all the cached plans.
+ * @param cache Plan cache.
+ */
+void afft_PlanCache_destroy(afft_PlanCache* cache);
+
+/**
+ * @brief Get the number of the cached plans.
+ * @param cache Plan cache.
+ * @param size Pointer to the size variable.
+ * @return Error code.
+ */
+afft_Error afft_PlanCache_getSize(afft_PlanCache* cache, size_t* size);
+
+/**
+ * @brief Set the maximum number of the cached plans, the least recently used plans are evicted.
+ * @param cache Plan cache.
+ * @param maxSize Maximum number of cached plans, 0 for no limit.
+ * @return Error code.
+ */
+afft_Error afft_PlanCache_setMaxSize(afft_PlanCache* cache, size_t maxSize);
+
+/**
+ * @brief Set the default maximum memory held by the cached plans in each memory domain (the host or a device).
+ * @param cache Plan cache.
+ * @param maxMemorySize Maximum memory size in bytes, SIZE_MAX for no limit.
+ * @return Error code.
+ */
+afft_Error afft_PlanCache_setMaxMemorySize(afft_PlanCache* cache, size_t maxMemorySize);
+
+/**
+ * @brief Set the maximum host memory held by the cached plans.
+ * @param cache Plan cache.
+ * @param maxMemorySize Maximum memory size in bytes.
+ * @return Error code.
+ */
+afft_Error afft_PlanCache_setMaxHostMemorySize(afft_PlanCache* cache, size_t maxMemorySize);
+
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+/**
+ * @brief Set the maximum memory of a device held by the cached plans.
+ * @param cache Plan cache.
+ * @param device Device.
+ * @param maxMemorySize Maximum memory size in bytes.
+ * @return Error code.
+ */
+afft_Error afft_PlanCache_setMaxDeviceMemorySize(afft_PlanCache* cache, int device, size_t maxMemorySize);
+#endif
+
+/**
+ * @brief Get the plan cache statistics.
+ * @param cache Plan cache.
+ * @param stats Pointer to the statistics variable.
+ * @return Error code.
+ */
+afft_Error afft_PlanCache_getStatistics(afft_PlanCache* cache, afft_PlanCacheStatistics* stats);
+
+/**
+ * @brief Reset the plan cache statistics.
+ * @param cache Plan cache.
+ * @return Error code.
+ */
+afft_Error afft_PlanCache_resetStatistics(afft_PlanCache* cache);
+
+/**
+ * @brief Erase all the cached plans.
+ * @param cache Plan cache.
+ * @return Error code.
+ */
+afft_Error afft_PlanCache_clear(afft_PlanCache* cache);
+
+/**
+ * @brief Insert a plan into the cache, a cached plan with the same description is replaced. The cache takes the
+ *        ownership of the plan even if the call fails.
+ * @param cache Plan cache.
+ * @param plan Plan created by afft_Plan_create() or afft_Plan_createWithBackendParameters().
+ * @return Error code.
+ */
+afft_Error afft_PlanCache_insert(afft_PlanCache* cache, afft_Plan* plan);
+
+#if defined(__cplusplus) || (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L)
+  /**
+   * @brief Find a cached plan for a given transform and architecture.
+   * @param cache Plan cache.
+   * @param transformParams Transform parameters. May be any of afft_*transform*_Parameters or general parameters.
+   * @param archParams Architecture parameters. May be any of afft_*target*_*distribution*_Parameters or general parameters.
+   * @param planPtr Pointer to the plan owned by the cache, set to NULL if there is no such plan.
+   * @return Error code.
+   */
+# define afft_PlanCache_find(cache, transformParams, archParams, planPtr) \
+    _afft_PlanCache_find(cache, \
+                         afft_makeTransformParameters(transformParams), \
+                         afft_makeArchitectureParameters(archParams), \
+                         planPtr)
+
+  /**
+   * @brief Erase the cached plan for a given transform and architecture.
+   * @param cache Plan cache.
+   * @param transformParams Transform parameters. May be any of afft_*transform*_Parameters or general parameters.
+   * @param archParams Architecture parameters. May be any of afft_*target*_*distribution*_Parameters or general parameters.
+   * @return Error code.
+   */
+# define afft_PlanCache_erase(cache, transformParams, archParams) \
+    _afft_PlanCache_erase(cache, afft_makeTransformParameters(transformParams), afft_makeArchitectureParameters(archParams))
+
+  /**
+   * @brief Find a cached plan for a given transform and architecture, create and cache it if there is none.
+   * @param cache Plan cache.
+   * @param transformParams Transform parameters. May be any of afft_*transform*_Parameters or general parameters.
+   * @param archParams Architecture parameters. May be any of afft_*target*_*distribution*_Parameters or general parameters.
+   * @param planPtr Pointer to the plan owned by the cache.
+   * @return Error code.
+   */
+# define afft_PlanCache_findOrCreate(cache, transformParams, archParams, planPtr) \
+    _afft_PlanCache_findOrCreate(cache, \
+                                 afft_makeTransformParameters(transformParams), \
+                                 afft_makeArchitectureParameters(archParams), \
+                                 planPtr)
+
+  /**
+   * @brief Find a cached plan for a given transform and architecture, create it with the backend parameters and cache
+   *        it if there is none.
+   * @param cache Plan cache.
+   * @param transformParams Transform parameters. May be any of afft_*transform*_Parameters or general parameters.
+   * @param archParams Architecture parameters. May be any of afft_*target*_*distribution*_Parameters or general parameters.
+   * @param backendParams Backend parameters. May be any of afft_*target*_*distribution*_Parameters or general parameters.
+   * @param planPtr Pointer to the plan owned by the cache.
+   * @return Error code.
+   */
+# define afft_PlanCache_findOrCreateWithBackendParameters(cache, transformParams, archParams, backendParams, planPtr) \
+    _afft_PlanCache_findOrCreateWithBackendParameters(cache, \
+                                                      afft_makeTransformParameters(transformParams), \
+                                                      afft_makeArchitectureParameters(archParams), \
+                                                      afft_makeBackendParameters(backendParams), \
+                                                      planPtr)
+#else
+# define afft_PlanCache_find(cache, transformParams, archParams, planPtr) \
+    _afft_PlanCache_find(cache, transformParams, archParams, planPtr)
+
+# define afft_PlanCache_erase(cache, transformParams, archParams) \
+    _afft_PlanCache_erase(cache, transformParams, archParams)
+
+# define afft_PlanCache_findOrCreate(cache, transformParams, archParams, planPtr) \
+    _afft_PlanCache_findOrCreate(cache, transformParams, archParams, planPtr)
+
+# define afft_PlanCache_findOrCreateWithBackendParameters(cache, transformParams, archParams, backendParams, planPtr) \
+    _afft_PlanCache_findOrCreateWithBackendParameters(cache, transformParams, archParams, backendParams, planPtr)
+#endif
+
+/**********************************************************************************************************************/
+// Private functions
+/**********************************************************************************************************************/
+afft_Error _afft_PlanCache_find(afft_PlanCache*             cache,
+                                afft_TransformParameters    transformParams,
+                                afft_ArchitectureParameters archParams,
+                                afft_Plan**                 planPtr);
+
+afft_Error _afft_PlanCache_erase(afft_PlanCache*             cache,
+                                 afft_TransformParameters    transformParams,
+                                 afft_ArchitectureParameters archParams);
+
+afft_Error _afft_PlanCache_findOrCreate(afft_PlanCache*             cache,
+                                        afft_TransformParameters    transformParams,
+                                        afft_ArchitectureParameters archParams,
+                                        afft_Plan**                 planPtr);
+
+afft_Error _afft_PlanCache_findOrCreateWithBackendParameters(afft_PlanCache*             cache,
+                                                             afft_TransformParameters    transformParams,
+                                                             afft_ArchitectureParameters archParams,
+                                                             afft_BackendParameters      backendParams,
+                                                             afft_Plan**                 planPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AFFT_PLAN_CACHE_H */
@@ -29,18 +29,41 @@
 # include "detail/include.hpp"
 #endif
 #include "common.hpp"
+#include "makePlan.hpp"
 #include "Plan.hpp"
-#include "detail/Config.hpp"
-#include "detail/PlanImpl.hpp"
+#include "trace.hpp"
+#include "detail/Desc.hpp"
 
 AFFT_EXPORT namespace afft
 {
+  // Forward declaration
+  class ConcurrentPlanCache;
+
   class PlanCache
   {
+    friend class ConcurrentPlanCache;
+
     public:
       /// @brief The default maximum size of the cache.
       static constexpr std::size_t defaultMaxSize = std::numeric_limits<std::size_t>::max();
 
+      /// @brief The default maximum memory size of the cache in bytes per memory domain.
+      static constexpr std::size_t defaultMaxMemorySize = std::numeric_limits<std::size_t>::max();
+
+      /// @brief The cache statistics. The counters are cumulative, they are not reset when the cache is cleared.
+      struct Statistics
+      {
+        std::size_t                   hitCount{};         ///< The number of lookups that found a plan.
+        std::size_t                   missCount{};        ///< The number of lookups that did not find a plan.
+        std::size_t                   evictionCount{};    ///< The number of plans evicted because a limit was exceeded.
+        std::size_t                   hibernationCount{}; ///< The number of plans hibernated.
+        std::size_t                   rehydrationCount{}; ///< The number of hibernated plans recreated on lookups.
+        std::size_t                   memorySize{};       ///< The memory in bytes currently held by the cached plans.
+        std::chrono::duration<double> planningTime{};     ///< The time spent creating plans on misses.
+        std::chrono::duration<double> warmupTime{};       ///< The time spent warming up prefetched plans.
+        std::chrono::duration<double> rehydrationTime{};  ///< The time spent recreating hibernated plans.
+      };
+
       /// @brief Constructs a new plan cache with the default maximum size.
       PlanCache() = default;
 
@@ -56,7 +79,7 @@ AFFT_EXPORT namespace afft
        * @brief Constructs a new plan cache with the default maximum size and a list of plans.
        * @param plans A list of plans to insert into the cache.
        */
-      PlanCache(std::initializer_list<Plan> plans)
+      PlanCache(std::initializer_list<std::shared_ptr<Plan>> plans)
       : PlanCache{defaultMaxSize, plans}
       {}
 
@@ -65,12 +88,12 @@ AFFT_EXPORT namespace afft
        * @param maxSize The maximum number of plans that the cache can hold.
        * @param plans A list of plans to insert into the cache.
        */
-      PlanCache(std::size_t maxSize, std::initializer_list<Plan> plans)
+      PlanCache(std::size_t maxSize, std::initializer_list<std::shared_ptr<Plan>> plans)
       : PlanCache(maxSize)
       {
         for (const auto& plan : plans)
         {
-          insert(plan.mImpl);
+          insert(plan);
         }
       }
       
@@ -99,7 +122,7 @@ AFFT_EXPORT namespace afft
       }
 
       /**
-       * @brief Get the number of plans in the cache.
+       * @brief Get the number of plans in the cache, including the hibernated ones.
        * @return The number of plans in the cache.
        */
       [[nodiscard]] std::size_t size() const noexcept
@@ -107,6 +130,15 @@ AFFT_EXPORT namespace afft
         return mList.size();
       }
 
+      /**
+       * @brief Get the number of hibernated plans in the cache, see setHibernation().
+       * @return The number of hibernated plans.
+       */
+      [[nodiscard]] std::size_t hibernatedSize() const noexcept
+      {
+        return mHibernatedSize;
+      }
+
       /**
        * @brief Get the maximum number of plans that the cache can hold.
        * @return The maximum number of plans that the cache can hold.
@@ -126,11 +158,89 @@ AFFT_EXPORT namespace afft
 
         while (mList.size() > mMaxSize)
         {
-          mMap.erase(mList.back()->getConfig());
-          mList.pop_back();
+          popBack();
         }
       }
 
+      /**
+       * @brief Get the default maximum memory size in bytes the cached plans may hold on a single device or host.
+       * @return The default maximum memory size.
+       */
+      [[nodiscard]] std::size_t maxMemorySize() const noexcept
+      {
+        return mMaxMemorySize;
+      }
+
+      /**
+       * @brief Set the default maximum memory size in bytes the cached plans may hold on a single device or host.
+       *        The memory of a plan is its workspace size plus the backend's internal memory size. When exceeded,
+       *        the least recently used plans holding memory on that device are evicted, or hibernated if enabled by
+       *        setHibernation(). A plan exceeding the budget on its own is not kept in the cache.
+       * @param maxMemorySize The maximum memory size.
+       */
+      void setMaxMemorySize(std::size_t maxMemorySize)
+      {
+        mMaxMemorySize = maxMemorySize;
+
+        evictOverBudget();
+      }
+
+      /**
+       * @brief Set the maximum memory size in bytes the cached plans may hold in the host memory. Overrides the default
+       *        maximum memory size.
+       * @param maxMemorySize The maximum memory size.
+       */
+      void setMaxHostMemorySize(std::size_t maxMemorySize)
+      {
+        mMaxMemorySizes.insert_or_assign(MemoryDomain{Target::cpu, 0}, maxMemorySize);
+
+        evictOverBudget();
+      }
+
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      /**
+       * @brief Set the maximum memory size in bytes the cached plans may hold on the device. Overrides the default
+       *        maximum memory size.
+       * @param device The device.
+       * @param maxMemorySize The maximum memory size.
+       */
+      void setMaxDeviceMemorySize(int device, std::size_t maxMemorySize)
+      {
+        mMaxMemorySizes.insert_or_assign(MemoryDomain{Target::gpu, makeDeviceId(device)}, maxMemorySize);
+
+        evictOverBudget();
+      }
+#   elif defined(AFFT_ENABLE_OPENCL)
+      /**
+       * @brief Set the maximum memory size in bytes the cached plans may hold on the device. Overrides the default
+       *        maximum memory size.
+       * @param device The device.
+       * @param maxMemorySize The maximum memory size.
+       */
+      void setMaxDeviceMemorySize(cl_device_id device, std::size_t maxMemorySize)
+      {
+        mMaxMemorySizes.insert_or_assign(MemoryDomain{Target::gpu, makeDeviceId(device)}, maxMemorySize);
+
+        evictOverBudget();
+      }
+#   endif
+
+      /**
+       * @brief Get the total memory size in bytes held by the cached plans on all devices and host.
+       * @return The memory size.
+       */
+      [[nodiscard]] std::size_t memorySize() const noexcept
+      {
+        std::size_t totalSize{};
+
+        for (const auto& [domain, size] : mMemorySizes)
+        {
+          totalSize += size;
+        }
+
+        return totalSize;
+      }
+
       /**
        * @brief Clear the cache.
        */
@@ -138,35 +248,99 @@ AFFT_EXPORT namespace afft
       {
         mMap.clear();
         mList.clear();
+        mMemorySizes.clear();
+        mHibernatedSize = 0;
       }
 
       /**
-       * @brief Insert a plan into the cache.
-       * @param plan The plan to insert into the cache.
+       * @brief Enable or disable the hibernation of the plans over the memory budget. Instead of being evicted, the
+       *        least recently used idle plans are hibernated: the plan is released together with its workspace and
+       *        device buffers (e.g. the twiddles and the VkFFT buffers), while the cache keeps its description and
+       *        the function recreating it by the backend it was created with. The next lookup recreates the plan
+       *        without selecting nor autotuning the backend again, and the compiled kernels and the wisdom kept by
+       *        the backends make the replanning cheap. Hibernated plans hold no memory and count into the maximum
+       *        size, so the least recently used ones are evicted by the count limit. A plan is idle when it is not
+       *        referenced outside the cache, plans in use, plans not made by makePlan() and mpst plans (recreating
+       *        them is collective) are evicted as before. Disabling the hibernation keeps the hibernated plans.
+       * @param hibernation True to enable the hibernation, false to disable it.
        */
-      void insert(const Plan& plan)
+      void setHibernation(bool hibernation)
       {
-        insert(plan.mImpl);
+        mHibernation = hibernation;
+
+        evictOverBudget();
       }
 
       /**
-       * @brief Erase a plan from the cache that matches the specified parameters.
-       * @param params The parameters of the transform.
-       * @param targetParams The parameters of the target transform.
+       * @brief Is the hibernation of the plans over the memory budget enabled?
+       * @return True if the hibernation is enabled, otherwise false.
+       */
+      [[nodiscard]] bool isHibernationEnabled() const noexcept
+      {
+        return mHibernation;
+      }
+
+      /**
+       * @brief Hibernate the idle plans not looked up for the specified time, see setHibernation(). Works even when
+       *        the hibernation over the memory budget is disabled, so the memory of plans left by a finished workload
+       *        phase can be released while the next lookup still avoids the full replanning.
+       * @param idleTime The minimum time since the last lookup or insertion of the plan, zero hibernates all idle
+       *                 plans.
+       * @return The number of hibernated plans.
        */
-      template<typename TransformParametersT, typename TargetParametersT>
-      void erase(const TransformParametersT& params, const TargetParametersT& targetParams)
+      std::size_t hibernateIdle(std::chrono::duration<double> idleTime = {})
       {
-        static_assert(isTransformParameters<TransformParametersT>, "Invalid transform parameters type");
-        static_assert(isTargetParameters<TargetParametersT>, "Invalid target parameters type");
+        const auto now = std::chrono::steady_clock::now();
 
-        const auto config = detail::Config{params, targetParams};
+        std::size_t hibernatedCount{};
 
-        if (auto mapIter = mMap.find(config); mapIter != mMap.end())
+        for (auto& entry : mList)
         {
-          mList.erase(mapIter->second);
-          mMap.erase(mapIter);
+          if (canHibernate(entry) && now - entry.lastUseTime >= idleTime)
+          {
+            hibernate(entry);
+            ++hibernatedCount;
+          }
         }
+
+        return hibernatedCount;
+      }
+
+      /**
+       * @brief Insert a plan into the cache. If a plan with the same description is already cached, it is replaced.
+       * @param plan The plan to insert into the cache.
+       */
+      void insert(std::shared_ptr<Plan> plan)
+      {
+        if (!plan)
+        {
+          throw std::invalid_argument{"Cannot insert a null plan into the cache"};
+        }
+
+        insertEntry(Entry{makeKey(detail::DescGetter::get(*plan)), std::move(plan)});
+      }
+
+      /**
+       * @brief Insert a plan into the cache. If a plan with the same description is already cached, it is replaced.
+       * @param plan The plan to insert into the cache.
+       */
+      void insert(std::unique_ptr<Plan> plan)
+      {
+        insert(std::shared_ptr<Plan>{std::move(plan)});
+      }
+
+      /**
+       * @brief Erase a plan from the cache that matches the specified parameters.
+       * @param transformParams The parameters of the transform.
+       * @param archParams The parameters of the architecture.
+       */
+      template<typename TransformParamsT, typename ArchParamsT>
+      void erase(const TransformParamsT& transformParams, const ArchParamsT& archParams)
+      {
+        static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+
+        eraseKey(makeKey(detail::Desc{transformParams, archParams}));
       }
 
       /**
@@ -177,7 +351,15 @@ AFFT_EXPORT namespace afft
       {
         mMap.swap(other.mMap);
         mList.swap(other.mList);
+        mMemorySizes.swap(other.mMemorySizes);
+        mMaxMemorySizes.swap(other.mMaxMemorySizes);
+        std::swap(mHibernatedSize, other.mHibernatedSize);
+        std::swap(mHibernation, other.mHibernation);
+        std::swap(mStatistics, other.mStatistics);
         std::swap(mMaxSize, other.mMaxSize);
+        std::swap(mMaxMemorySize, other.mMaxMemorySize);
+        mTrace.swap(other.mTrace);
+        std::swap(mRecording, other.mRecording);
       }
 
       /**
@@ -196,44 +378,374 @@ AFFT_EXPORT namespace afft
           throw std::runtime_error{"Cannot merge caches because the maximum size would be exceeded"};
         }
 
-        for (auto& plan : other.mList)
+        // Insert from the least recently used so the recency order of the other cache is preserved, the hibernated
+        // plans stay hibernated
+        for (auto it = other.mList.rbegin(); it != other.mList.rend(); ++it)
         {
-          insert(std::move(plan));
+          insertEntry(std::move(*it));
         }
 
         other.clear();
       }
 
+      /**
+       * @brief Serialize the cached plans, see deserialize(). Plans that cannot be serialized (e.g. distributed plans)
+       *        are skipped, the hibernated plans are serialized too. The backend native state is stored once for all
+       *        plans.
+       * @return Serialized cache.
+       */
+      [[nodiscard]] std::string serialize() const
+      {
+        detail::SerialWriter                       writer{detail::serializedPlanCacheHeader};
+        std::vector<std::pair<Backend, Precision>> states{};
+
+        // Write from the least recently used so the recency order is restored by deserialize()
+        for (auto it = mList.rbegin(); it != mList.rend(); ++it)
+        {
+          const auto& desc    = (it->plan) ? detail::DescGetter::get(*it->plan) : it->desc;
+          const auto  backend = it->backend;
+          const auto  state   = std::make_pair(backend, desc.getPrecision().execution);
+
+          if (desc.getDistribution() != Distribution::spst)
+          {
+            continue;
+          }
+
+          try
+          {
+            writer.writeBlob("plan", detail::serializePlan(desc, backend, false));
+          }
+          catch (const std::invalid_argument&)
+          {
+            continue;
+          }
+
+          if (std::find(states.begin(), states.end(), state) == states.end())
+          {
+            detail::writeBackendState(writer, state.first, state.second);
+            states.push_back(state);
+          }
+        }
+
+        return std::move(writer).release();
+      }
+
+      /**
+       * @brief Restore the plans serialized by serialize() and insert them into the cache. The backend native state
+       *        is restored before the plans are created. Errors of the plan creation are propagated.
+       * @param data Serialized cache.
+       */
+      void deserialize(std::string_view data)
+      {
+        const detail::SerialReader reader{data, detail::serializedPlanCacheHeader};
+
+        detail::readBackendState(reader);
+
+        for (const auto& [name, value] : reader.getEntries())
+        {
+          if (name == "plan")
+          {
+            insert(deserializePlan(value));
+          }
+        }
+      }
+
       /**
        * @brief Finds a plan in the cache that matches the specified parameters.
-       * @param params The parameters of the transform.
-       * @param targetParams The parameters of the target transform.
-       * @return The plan that matches the specified parameters.
+       * @param transformParams The parameters of the transform.
+       * @param archParams The parameters of the architecture.
+       * @return The plan that matches the specified parameters or nullptr if there is no such plan.
        */
-      template<typename TransformParametersT, typename TargetParametersT>
-      [[nodiscard]] std::optional<Plan> find(const TransformParametersT& params, const TargetParametersT& targetParams)
+      template<typename TransformParamsT, typename ArchParamsT>
+      [[nodiscard]] std::shared_ptr<Plan> find(const TransformParamsT& transformParams, const ArchParamsT& archParams)
       {
-        static_assert(isTransformParameters<TransformParametersT>, "Invalid transform parameters type");
-        static_assert(isTargetParameters<TargetParametersT>, "Invalid target parameters type");
+        static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
 
-        std::optional<Plan> plan{};
+        return lookup(makeKey(detail::Desc{transformParams, archParams}));
+      }
 
-        const auto config = detail::Config{params, targetParams};
+      /**
+       * @brief Finds a plan in the cache or creates it using the create function and inserts it into the cache.
+       * @tparam TransformParamsT Transform parameters type.
+       * @tparam ArchParamsT Architecture parameters type.
+       * @tparam CreateFnT Create function type, must return std::unique_ptr<Plan> or std::shared_ptr<Plan>.
+       * @param transformParams The parameters of the transform.
+       * @param archParams The parameters of the architecture.
+       * @param createFn The create function.
+       * @return The plan.
+       */
+      template<typename TransformParamsT, typename ArchParamsT, typename CreateFnT>
+      [[nodiscard]] auto findOrCreate(const TransformParamsT& transformParams,
+                                      const ArchParamsT&      archParams,
+                                      CreateFnT&&             createFn)
+        -> AFFT_RET_REQUIRES(std::shared_ptr<Plan>, std::is_invocable_v<CreateFnT>)
+      {
+        static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+
+        auto key = makeKey(detail::Desc{transformParams, archParams});
+
+        if (auto plan = lookup(key))
+        {
+          return plan;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::shared_ptr<Plan> plan{std::forward<CreateFnT>(createFn)()};
 
-        if (auto mapIter = mMap.find(config); mapIter != mMap.end())
+        const std::chrono::duration<double> planningTime = std::chrono::steady_clock::now() - start;
+
+        mStatistics.planningTime += planningTime;
+
+        if (!plan)
         {
-          plan = Plan{*(mapIter->second)};
+          throw std::runtime_error{"Plan create function returned a null plan"};
         }
 
+        record(key, plan->getBackend(), true, planningTime);
+
+        insertEntry(Entry{std::move(key), plan});
+
         return plan;
       }
+
+      /**
+       * @brief Finds a plan in the cache or creates it using makePlan and inserts it into the cache.
+       * @tparam TransformParamsT Transform parameters type.
+       * @tparam ArchParamsT Architecture parameters type.
+       * @tparam BackendParamsT Backend parameters type.
+       * @param transformParams The parameters of the transform.
+       * @param archParams The parameters of the architecture.
+       * @param backendParams The parameters of the backend.
+       * @return The plan.
+       */
+      template<typename TransformParamsT, typename ArchParamsT, typename BackendParamsT = detail::DefaultBackendParameters>
+      [[nodiscard]] auto findOrCreate(const TransformParamsT& transformParams,
+                                      ArchParamsT&            archParams,
+                                      const BackendParamsT&   backendParams = {})
+        -> AFFT_RET_REQUIRES(std::shared_ptr<Plan>, !std::is_invocable_v<BackendParamsT>)
+      {
+        return findOrCreate(transformParams, archParams, [&]()
+        {
+          return afft::makePlan(transformParams, archParams, backendParams);
+        });
+      }
+
+      /**
+       * @brief Creates the plan unless it is cached and warms it up on scratch buffers, so that a later findOrCreate
+       *        call pays neither the planning nor the lazy first execution work of the backend. Plans that cannot be
+       *        warmed up on scratch buffers are only created, a hibernated plan is recreated.
+       * @tparam TransformParamsT Transform parameters type.
+       * @tparam ArchParamsT Architecture parameters type.
+       * @tparam BackendParamsT Backend parameters type.
+       * @param transformParams The parameters of the transform.
+       * @param archParams The parameters of the architecture.
+       * @param backendParams The parameters of the backend.
+       */
+      template<typename TransformParamsT, typename ArchParamsT, typename BackendParamsT = detail::DefaultBackendParameters>
+      void prefetch(const TransformParamsT& transformParams,
+                    ArchParamsT&            archParams,
+                    const BackendParamsT&   backendParams = {})
+      {
+        static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+
+        const auto key = makeKey(detail::Desc{transformParams, archParams});
+
+        if (prefetchCached(key))
+        {
+          return;
+        }
+
+        auto plan = findOrCreate(transformParams, archParams, backendParams);
+
+        if (plan->hasWarmupScratchBuffers())
+        {
+          mStatistics.warmupTime += plan->warmup().measuredTime;
+        }
+      }
+
+      /**
+       * @brief Get the cache statistics.
+       * @return The cache statistics.
+       */
+      [[nodiscard]] Statistics statistics() const noexcept
+      {
+        Statistics statistics{mStatistics};
+        statistics.memorySize = memorySize();
+
+        return statistics;
+      }
+
+      /// @brief Resets the cache statistics counters.
+      void resetStatistics() noexcept
+      {
+        mStatistics = Statistics{};
+      }
+
+      /**
+       * @brief Enable or disable the recording of the used plan descriptions. Each lookup that finds a plan and each
+       *        plan creation on a miss counts as a use, the creations add their planning time. The records are kept
+       *        when the recording is disabled, see clearTrace().
+       * @param recording True to enable the recording, false to disable it.
+       */
+      void setRecording(bool recording) noexcept
+      {
+        mRecording = recording;
+      }
+
+      /**
+       * @brief Is the recording of the used plan descriptions enabled?
+       * @return True if the recording is enabled, otherwise false.
+       */
+      [[nodiscard]] bool isRecording() const noexcept
+      {
+        return mRecording;
+      }
+
+      /// @brief Clears the recorded plan descriptions.
+      void clearTrace() noexcept
+      {
+        mTrace.clear();
+      }
+
+      /**
+       * @brief Serialize the recorded plan descriptions with their use counts, planning times and backends, see
+       *        warmFromTrace(). Unlike serialize(), no plan nor backend state is stored, so the trace is compact and
+       *        works for every backend. Descriptions that cannot be serialized (e.g. distributed plans) are skipped.
+       * @return Serialized trace.
+       */
+      [[nodiscard]] std::string serializeTrace() const
+      {
+        return writeTrace(mTrace);
+      }
+
+      /**
+       * @brief Save the serialized trace to a file, see serializeTrace().
+       * @param path Path to the file.
+       */
+      void saveTrace(const std::string& path) const
+      {
+        writeTraceFile(path, serializeTrace());
+      }
+
+      /**
+       * @brief Create the hottest plans of a trace concurrently on the planner thread pool and insert them into the
+       *        cache, see makePlans(). The plans are ranked by the use count, then by the planning time, and each is
+       *        created by the backend it was recorded with. Plans already cached are skipped, plans that fail to be
+       *        created (e.g. the backend is not available on this machine) are ignored.
+       * @param trace Serialized trace.
+       * @param maxPlanCount The maximum number of the hottest records to be planned.
+       * @return The number of created plans.
+       */
+      std::size_t warmFromTrace(std::string_view trace, std::size_t maxPlanCount = defaultMaxSize)
+      {
+        std::vector<PlanRequest> requests{};
+
+        for (const auto record : readTrace(trace, maxPlanCount))
+        {
+          readTraceRecord(record, [&](const auto& transformParams, auto& archParams, const auto& backendParams)
+          {
+            const auto key = makeKey(detail::Desc{transformParams, archParams});
+
+            if (mMap.count(key) == 0)
+            {
+              requests.emplace_back(transformParams, archParams, backendParams);
+            }
+          });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        auto results = makePlans(View<PlanRequest>{requests});
+
+        mStatistics.planningTime += std::chrono::steady_clock::now() - start;
+
+        std::size_t planCount{};
+
+        // Insert from the coldest plan so the hottest one becomes the most recently used
+        for (auto it = results.rbegin(); it != results.rend(); ++it)
+        {
+          if (it->plan)
+          {
+            insert(std::move(it->plan));
+            ++planCount;
+          }
+        }
+
+        return planCount;
+      }
+
+      /**
+       * @brief Create the hottest plans of a trace saved by saveTrace(), see warmFromTrace(). A missing file is not an
+       *        error, so the first run of a deployment simply starts cold.
+       * @param path Path to the file.
+       * @param maxPlanCount The maximum number of the hottest records to be planned.
+       * @return The number of created plans.
+       */
+      std::size_t warmFrom(const std::string& path, std::size_t maxPlanCount = defaultMaxSize)
+      {
+        const auto trace = readTraceFile(path);
+
+        return (trace) ? warmFromTrace(*trace, maxPlanCount) : std::size_t{};
+      }
       
     protected:
     private:
-      using Key      = std::reference_wrapper<const detail::Config>;         ///< The key type of the cache.
-      using Value    = std::shared_ptr<detail::PlanImpl>;                    ///< The value type of the cache.
+      /// @brief Memory domain, the host memory or a device memory.
+      struct MemoryDomain
+      {
+        Target         target{}; ///< The target.
+        std::uintptr_t device{}; ///< The device identifier, always 0 for the host.
+
+        /// @brief Equality operator.
+        [[nodiscard]] friend bool operator==(const MemoryDomain& lhs, const MemoryDomain& rhs) noexcept
+        {
+          return lhs.target == rhs.target && lhs.device == rhs.device;
+        }
+      };
+
+      /// @brief Hash of the memory domain.
+      struct MemoryDomainHash
+      {
+        [[nodiscard]] std::size_t operator()(const MemoryDomain& domain) const noexcept
+        {
+          std::size_t seed{};
+          detail::hashCombine(seed, domain.target);
+          detail::hashCombine(seed, domain.device);
+          return seed;
+        }
+      };
+
+      /// @brief Memory held by a plan in a memory domain.
+      struct MemoryUsage
+      {
+        MemoryDomain domain{}; ///< The memory domain.
+        std::size_t  size{};   ///< The memory size in bytes.
+      };
+
+      /// @brief The function recreating a hibernated plan by the backend it was created with.
+      using MakePlanFn = std::function<std::unique_ptr<Plan>(const detail::Desc&)>;
+
+      /// @brief The cache entry, holds the normalized description as the key. A hibernated entry holds no plan.
+      struct Entry
+      {
+        detail::Desc                          desc;           ///< The normalized plan description.
+        std::shared_ptr<Plan>                 plan;           ///< The plan, nullptr if hibernated.
+        std::vector<MemoryUsage>              memoryUsages{}; ///< The memory held by the plan.
+        Backend                               backend{};      ///< The backend of the plan.
+        MakePlanFn                            makePlanFn{};   ///< Recreates the hibernated plan.
+        std::chrono::steady_clock::time_point lastUseTime{};  ///< The time of the last lookup or insertion.
+      };
+
+      /// @brief Memory size per memory domain.
+      using MemorySizeMap = std::unordered_map<MemoryDomain, std::size_t, MemoryDomainHash>;
 
-      using List     = std::list<std::shared_ptr<detail::PlanImpl>>;         ///< The list type of the cache.
+      using Key      = std::reference_wrapper<const detail::Desc>;           ///< The key type of the cache.
+
+      using List     = std::list<Entry>;                                     ///< The list type of the cache.
       using ListIter = List::iterator;                                       ///< The list iterator type of the cache.
 
       using MapValue = ListIter;                                             ///< The value type of the map.
@@ -241,14 +753,25 @@ AFFT_EXPORT namespace afft
       {
         [[nodiscard]] std::size_t operator()(Key key) const noexcept
         {
-          return std::hash<detail::Config>{}(key.get());
+          return std::hash<detail::Desc>{}(key.get());
         }
       };
-      using MapEqual = std::equal_to<detail::Config>;                        ///< The equality function of the map.
+      using MapEqual = std::equal_to<detail::Desc>;                          ///< The equality function of the map.
 
       using Map      = std::unordered_map<Key, MapValue, MapHash, MapEqual>; ///< The map type of the cache.
       using MapIter  = Map::iterator;                                        ///< The map iterator type of the cache.
 
+      /// @brief Trace record of a used plan description.
+      struct TraceRecord
+      {
+        Backend                       backend{};      ///< The backend of the plan.
+        std::size_t                   useCount{};     ///< The number of uses of the plan.
+        std::chrono::duration<double> planningTime{}; ///< The time spent creating the plan.
+      };
+
+      /// @brief Trace records by the normalized description.
+      using TraceMap = std::unordered_map<detail::Desc, TraceRecord>;
+
       /**
        * @brief Checks if the maximum size of the cache is valid.
        * @param maxSize The maximum size of the cache.
@@ -265,37 +788,637 @@ AFFT_EXPORT namespace afft
       }
 
       /**
-       * @brief Inserts a new element into the cache.
-       * @param value The value of the new element.
-       * @return An iterator to the newly inserted element.
+       * @brief Makes the cache key from the description. Default strides are filled so that explicitly passed
+       *        default strides and omitted strides describe the same plan.
+       * @param desc The plan description.
+       * @return The normalized description.
+       */
+      [[nodiscard]] static detail::Desc makeKey(const detail::Desc& desc)
+      {
+        detail::Desc key{desc};
+        key.fillDefaultMemoryLayoutStrides();
+
+        return key;
+      }
+
+      /**
+       * @brief Looks up a plan by the normalized description and marks it as the most recently used.
+       * @param key The normalized plan description.
+       * @return The plan or nullptr if there is no such plan.
+       */
+      [[nodiscard]] std::shared_ptr<Plan> lookup(const detail::Desc& key)
+      {
+        if (auto mapIter = mMap.find(key); mapIter != mMap.end())
+        {
+          const auto listIter = mapIter->second;
+
+          mList.splice(mList.begin(), mList, listIter);
+
+          const bool isHibernated = !listIter->plan;
+
+          if (!isHibernated || rehydrate(listIter))
+          {
+            auto plan = listIter->plan;
+
+            listIter->lastUseTime = std::chrono::steady_clock::now();
+
+            ++mStatistics.hitCount;
+
+            record(key, listIter->backend, true, {});
+
+            detail::trace::emit(trace::EventType::cacheHit, listIter->backend);
+
+            if (isHibernated)
+            {
+              evictOverBudget();
+            }
+
+            return plan;
+          }
+        }
+
+        ++mStatistics.missCount;
+
+        detail::trace::emit(trace::EventType::cacheMiss, std::nullopt);
+
+        return nullptr;
+      }
+
+      /**
+       * @brief Marks a cached plan as the most recently used without counting a lookup, a hibernated plan is recreated
+       *        now. A failed recreation erases the plan, so it is created anew by the caller.
+       * @param key The normalized plan description.
+       * @return True if the plan is cached, otherwise false.
+       */
+      bool prefetchCached(const detail::Desc& key)
+      {
+        const auto mapIter = mMap.find(key);
+
+        if (mapIter == mMap.end())
+        {
+          return false;
+        }
+
+        const auto listIter = mapIter->second;
+
+        mList.splice(mList.begin(), mList, listIter);
+
+        if (listIter->plan)
+        {
+          return true;
+        }
+
+        if (!rehydrate(listIter))
+        {
+          return false;
+        }
+
+        evictOverBudget();
+
+        return true;
+      }
+
+      /**
+       * @brief Makes the device identifier.
+       * @tparam DeviceT The device type.
+       * @param device The device.
+       * @return The device identifier.
+       */
+      template<typename DeviceT>
+      [[nodiscard]] static std::uintptr_t makeDeviceId(DeviceT device) noexcept
+      {
+        if constexpr (std::is_pointer_v<DeviceT>)
+        {
+          return reinterpret_cast<std::uintptr_t>(device);
+        }
+        else
+        {
+          return static_cast<std::uintptr_t>(device);
+        }
+      }
+
+      /**
+       * @brief Gets the memory domain of each target of the plan.
+       * @param desc The plan description.
+       * @return The memory domains.
+       */
+      [[nodiscard]] static std::vector<MemoryDomain> getMemoryDomains(const detail::Desc& desc)
+      {
+        std::vector<MemoryDomain> domains(desc.getTargetCount(), MemoryDomain{desc.getTarget(), 0});
+
+        if (desc.getTarget() == Target::gpu)
+        {
+          switch (desc.getDistribution())
+          {
+#         if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP) || defined(AFFT_ENABLE_OPENCL)
+          case Distribution::spst:
+            domains.front().device = makeDeviceId(desc.getArchDesc<Target::gpu, Distribution::spst>().device);
+            break;
+          case Distribution::spmt:
+          {
+            const auto& devices = desc.getArchDesc<Target::gpu, Distribution::spmt>().devices;
+
+            for (std::size_t i{}; i < domains.size() && i < devices.size(); ++i)
+            {
+              domains[i].device = makeDeviceId(devices[i]);
+            }
+            break;
+          }
+          case Distribution::mpst:
+            domains.front().device = makeDeviceId(desc.getArchDesc<Target::gpu, Distribution::mpst>().device);
+            break;
+#         endif
+          default:
+            break;
+          }
+        }
+
+        return domains;
+      }
+
+      /**
+       * @brief Gets the memory held by the plan in each memory domain.
+       * @param entry The cache entry.
+       * @return The memory usages.
+       */
+      [[nodiscard]] static std::vector<MemoryUsage> getMemoryUsages(const Entry& entry)
+      {
+        const auto domains   = getMemoryDomains(entry.desc);
+        const auto footprint = entry.plan->getMemoryFootprint();
+
+        std::vector<MemoryUsage> memoryUsages{};
+        memoryUsages.reserve(domains.size());
+
+        for (std::size_t i{}; i < domains.size(); ++i)
+        {
+          std::size_t size = (i < footprint.workspaceSizes.size()) ? footprint.workspaceSizes[i] : 0;
+
+          if (footprint.deviceSizes.empty())
+          {
+            size += (i == 0) ? footprint.hostSize : 0;
+          }
+          else if (i < footprint.deviceSizes.size())
+          {
+            size += footprint.deviceSizes[i];
+          }
+
+          if (size > 0)
+          {
+            memoryUsages.push_back(MemoryUsage{domains[i], size});
+          }
+        }
+
+        return memoryUsages;
+      }
+
+      /**
+       * @brief Gets the maximum memory size of the memory domain.
+       * @param domain The memory domain.
+       * @return The maximum memory size.
+       */
+      [[nodiscard]] std::size_t getMaxMemorySize(const MemoryDomain& domain) const
+      {
+        if (auto it = mMaxMemorySizes.find(domain); it != mMaxMemorySizes.end())
+        {
+          return it->second;
+        }
+
+        return mMaxMemorySize;
+      }
+
+      /**
+       * @brief Checks if the memory domain exceeds its budget.
+       * @param domain The memory domain.
+       * @return True if the budget is exceeded, otherwise false.
+       */
+      [[nodiscard]] bool isOverBudget(const MemoryDomain& domain) const
+      {
+        const auto it = mMemorySizes.find(domain);
+
+        return (it != mMemorySizes.end()) && (it->second > getMaxMemorySize(domain));
+      }
+
+      /// @brief Evicts the least recently used plans holding memory in the memory domains over budget.
+      void evictOverBudget()
+      {
+        auto isEntryOverBudget = [&](const Entry& entry)
+        {
+          return std::any_of(entry.memoryUsages.begin(), entry.memoryUsages.end(), [&](const MemoryUsage& usage)
+          {
+            return isOverBudget(usage.domain);
+          });
+        };
+
+        for (auto it = mList.end(); it != mList.begin();)
+        {
+          --it;
+
+          if (isEntryOverBudget(*it))
+          {
+            if (mHibernation && canHibernate(*it))
+            {
+              hibernate(*it);
+            }
+            else
+            {
+              countEviction(*it);
+              it = eraseEntry(it);
+            }
+          }
+        }
+      }
+
+      /**
+       * @brief Checks if the plan of the element can be hibernated, see setHibernation().
+       * @param entry The element.
+       * @return True if the plan is idle and can be recreated, otherwise false.
+       */
+      [[nodiscard]] static bool canHibernate(const Entry& entry)
+      {
+        return entry.plan != nullptr &&
+               entry.plan.use_count() == 1 &&
+               entry.desc.getDistribution() != Distribution::mpst &&
+               detail::InversePlanSetter::getMakePlanFn(*entry.plan);
+      }
+
+      /**
+       * @brief Hibernates the plan of the element, its memory is released.
+       * @param entry The element.
+       */
+      void hibernate(Entry& entry)
+      {
+        std::size_t memorySize{};
+
+        for (const auto& usage : entry.memoryUsages)
+        {
+          memorySize += usage.size;
+        }
+
+        releaseMemory(entry);
+
+        entry.makePlanFn = detail::InversePlanSetter::getMakePlanFn(*entry.plan);
+        entry.plan.reset();
+
+        ++mHibernatedSize;
+        ++mStatistics.hibernationCount;
+
+        detail::trace::emit(trace::EventType::cacheHibernate, entry.backend, {}, {}, memorySize);
+      }
+
+      /**
+       * @brief Recreates the hibernated plan of the element. If the recreation fails (e.g. the device memory is
+       *        exhausted), the element is erased. The memory budget is not enforced, see evictOverBudget().
+       * @param listIter The list iterator of the element.
+       * @return True if the plan was recreated, false if the element was erased.
+       */
+      bool rehydrate(ListIter listIter)
+      {
+        auto& entry = *listIter;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        try
+        {
+          entry.plan = entry.makePlanFn(entry.desc);
+        }
+        catch (const std::exception&)
+        {
+          entry.plan.reset();
+        }
+
+        if (!entry.plan)
+        {
+          eraseEntry(listIter);
+          return false;
+        }
+
+        const std::chrono::duration<double> rehydrationTime = std::chrono::steady_clock::now() - start;
+
+        entry.makePlanFn   = {};
+        entry.memoryUsages = getMemoryUsages(entry);
+
+        std::size_t memorySize{};
+
+        for (const auto& usage : entry.memoryUsages)
+        {
+          mMemorySizes[usage.domain] += usage.size;
+          memorySize                 += usage.size;
+        }
+
+        --mHibernatedSize;
+        ++mStatistics.rehydrationCount;
+        mStatistics.rehydrationTime += rehydrationTime;
+
+        detail::trace::emit(trace::EventType::cacheRehydrate, entry.backend, {}, rehydrationTime, memorySize);
+
+        return true;
+      }
+
+      /**
+       * @brief Releases the memory held by the element from the memory sizes.
+       * @param entry The element.
+       */
+      void releaseMemory(Entry& entry)
+      {
+        for (const auto& usage : entry.memoryUsages)
+        {
+          if (auto it = mMemorySizes.find(usage.domain); it != mMemorySizes.end())
+          {
+            it->second -= usage.size;
+
+            if (it->second == 0)
+            {
+              mMemorySizes.erase(it);
+            }
+          }
+        }
+
+        entry.memoryUsages.clear();
+      }
+
+      /**
+       * @brief Erases the element from the cache.
+       * @param listIter The list iterator of the element.
+       * @return The list iterator following the erased element.
+       */
+      ListIter eraseEntry(ListIter listIter)
+      {
+        releaseMemory(*listIter);
+
+        if (!listIter->plan)
+        {
+          --mHibernatedSize;
+        }
+
+        mMap.erase(listIter->desc);
+
+        return mList.erase(listIter);
+      }
+
+      /**
+       * @brief Erases the element with the normalized description from the cache.
+       * @param key The normalized plan description.
        */
-      ListIter insert(Value value)
+      void eraseKey(const detail::Desc& key)
+      {
+        if (auto mapIter = mMap.find(key); mapIter != mMap.end())
+        {
+          eraseEntry(mapIter->second);
+        }
+      }
+
+      /// @brief Removes the least recently used element from the cache.
+      void popBack()
       {
+        countEviction(mList.back());
+        eraseEntry(std::prev(mList.end()));
+      }
+
+      /**
+       * @brief Counts the eviction of the element and traces it.
+       * @param entry The evicted element.
+       */
+      void countEviction(const Entry& entry)
+      {
+        ++mStatistics.evictionCount;
+
+        detail::trace::emit(trace::EventType::cacheEvict, entry.backend);
+      }
+
+      /**
+       * @brief Records a use or a creation of a plan if the recording is enabled.
+       * @param key The normalized plan description.
+       * @param backend The backend of the plan.
+       * @param isUse True if the plan was requested, false if it was only created (e.g. prefetched).
+       * @param planningTime The time spent creating the plan, zero for a cached plan.
+       */
+      void record(const detail::Desc&           key,
+                  Backend                       backend,
+                  bool                          isUse,
+                  std::chrono::duration<double> planningTime)
+      {
+        if (!mRecording)
+        {
+          return;
+        }
+
+        auto& traceRecord = mTrace[key];
+
+        traceRecord.backend       = backend;
+        traceRecord.useCount     += std::size_t{isUse};
+        traceRecord.planningTime += planningTime;
+      }
+
+      /**
+       * @brief Serialize the trace records. Each record is a blob in the serialized plan format extended by the use
+       *        count and the planning time in nanoseconds.
+       * @param trace The trace records.
+       * @return Serialized trace.
+       */
+      [[nodiscard]] static std::string writeTrace(const TraceMap& trace)
+      {
+        detail::SerialWriter writer{detail::serializedPlanCacheTraceHeader};
+
+        for (const auto& [desc, traceRecord] : trace)
+        {
+          detail::SerialWriter recordWriter{detail::serializedPlanHeader};
+
+          recordWriter.write("backend", traceRecord.backend);
+          recordWriter.write("useCount", traceRecord.useCount);
+          recordWriter.write("planningTime",
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(traceRecord.planningTime).count());
+
+          try
+          {
+            detail::writeDesc(recordWriter, desc);
+          }
+          catch (const std::invalid_argument&)
+          {
+            continue;
+          }
+
+          writer.writeBlob("record", std::move(recordWriter).release());
+        }
+
+        return std::move(writer).release();
+      }
+
+      /**
+       * @brief Read the trace records ranked by the use count, then by the planning time.
+       * @param trace Serialized trace, the returned records refer to it.
+       * @param maxRecordCount The maximum number of the returned records.
+       * @return The hottest serialized records.
+       */
+      [[nodiscard]] static std::vector<std::string_view> readTrace(std::string_view trace, std::size_t maxRecordCount)
+      {
+        const detail::SerialReader reader{trace, detail::serializedPlanCacheTraceHeader};
+
+        std::vector<std::tuple<std::size_t, std::size_t, std::string_view>> ranks{};
+
+        for (const auto& [name, value] : reader.getEntries())
+        {
+          if (name == "record")
+          {
+            const detail::SerialReader recordReader{value, detail::serializedPlanHeader};
+
+            ranks.emplace_back(recordReader.read<std::size_t>("useCount"),
+                               recordReader.read<std::size_t>("planningTime"),
+                               value);
+          }
+        }
+
+        std::stable_sort(ranks.begin(), ranks.end(), [](const auto& lhs, const auto& rhs)
+        {
+          return std::tie(std::get<0>(lhs), std::get<1>(lhs)) > std::tie(std::get<0>(rhs), std::get<1>(rhs));
+        });
+
+        std::vector<std::string_view> records{};
+        records.reserve(std::min(ranks.size(), maxRecordCount));
+
+        for (std::size_t i{}; i < std::min(ranks.size(), maxRecordCount); ++i)
+        {
+          records.push_back(std::get<2>(ranks[i]));
+        }
+
+        return records;
+      }
+
+      /**
+       * @brief Reconstruct the parameters of a trace record and pass them to a function. The backend parameters
+       *        select just the recorded backend.
+       * @tparam FnT Function type.
+       * @param traceRecord Serialized trace record.
+       * @param fn Function called with the transform, architecture and backend parameters.
+       */
+      template<typename FnT>
+      static void readTraceRecord(std::string_view traceRecord, FnT&& fn)
+      {
+        const detail::SerialReader reader{traceRecord, detail::serializedPlanHeader};
+
+        const auto backend = reader.read<Backend>("backend");
+
+        detail::readDesc(reader, [&](const auto& transformParams, auto& archParams)
+        {
+          using ArchParamsT = std::decay_t<decltype(archParams)>;
+
+          BackendParameters<ArchParamsT::target, ArchParamsT::distribution> backendParams{};
+          backendParams.mask = BackendMask::empty | backend;
+
+          fn(transformParams, archParams, backendParams);
+        });
+      }
+
+      /**
+       * @brief Read a trace file.
+       * @param path Path to the file.
+       * @return The file contents, std::nullopt if the file does not exist.
+       */
+      [[nodiscard]] static std::optional<std::string> readTraceFile(const std::string& path)
+      {
+        std::ifstream file{path, std::ios::binary};
+
+        if (!file.is_open())
+        {
+          return std::nullopt;
+        }
+
+        return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+      }
+
+      /**
+       * @brief Write a trace file.
+       * @param path Path to the file.
+       * @param trace Serialized trace.
+       */
+      static void writeTraceFile(const std::string& path, std::string_view trace)
+      {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+
+        if (!file.is_open())
+        {
+          throw std::runtime_error{"failed to open plan cache trace file for writing"};
+        }
+
+        file.write(trace.data(), static_cast<std::streamsize>(trace.size()));
+      }
+
+      /**
+       * @brief Inserts a new element into the cache. A hibernated element stays hibernated.
+       * @param entry The new element.
+       */
+      void insertEntry(Entry entry)
+      {
+        // Replace the element with the same key
+        eraseKey(entry.desc);
+
+        if (entry.plan)
+        {
+          entry.backend      = entry.plan->getBackend();
+          entry.memoryUsages = getMemoryUsages(entry);
+        }
+        else
+        {
+          entry.memoryUsages.clear();
+        }
+
+        if (entry.lastUseTime == std::chrono::steady_clock::time_point{})
+        {
+          entry.lastUseTime = std::chrono::steady_clock::now();
+        }
+
+        // Do not cache a plan exceeding the memory budget on its own, it would flush the whole cache
+        for (const auto& usage : entry.memoryUsages)
+        {
+          if (usage.size > getMaxMemorySize(usage.domain))
+          {
+            countEviction(entry);
+            return;
+          }
+        }
+
         // Check if the capacity has been reached
         if (mList.size() >= mMaxSize)
         {
           // Remove the last element from the list and the map
-          mMap.erase(mList.back()->getConfig());
-          mList.pop_back();
+          popBack();
         }
 
         // Insert the new element at the front of the list
-        mList.emplace_front(std::move(value));
+        mList.emplace_front(std::move(entry));
 
         // Insert the new element into the map
-        auto [it, inserted] = mMap.emplace(mList.front()->getConfig(), mList.begin());
+        auto [it, inserted] = mMap.emplace(mList.front().desc, mList.begin());
 
         if (!inserted)
         {
+          mList.pop_front();
           throw std::runtime_error{"Failed to insert plan into cache"};
         }
 
-        return it->second;
+        for (const auto& usage : mList.front().memoryUsages)
+        {
+          mMemorySizes[usage.domain] += usage.size;
+        }
+
+        if (!mList.front().plan)
+        {
+          ++mHibernatedSize;
+        }
+
+        evictOverBudget();
       }
 
-      Map         mMap{};                   ///< The map of the cache.
-      List        mList{};                  ///< The list of the cache.
-      std::size_t mMaxSize{defaultMaxSize}; ///< The maximum size of the cache.
+      Map           mMap{};                               ///< The map of the cache.
+      List          mList{};                              ///< The list of the cache.
+      std::size_t   mMaxSize{defaultMaxSize};             ///< The maximum size of the cache.
+      std::size_t   mMaxMemorySize{defaultMaxMemorySize}; ///< The default maximum memory size per memory domain.
+      MemorySizeMap mMaxMemorySizes{};                    ///< The maximum memory sizes overriding the default.
+      MemorySizeMap mMemorySizes{};                       ///< The memory held by the cached plans.
+      std::size_t   mHibernatedSize{};                    ///< The number of hibernated plans.
+      Statistics    mStatistics{};                        ///< The cache statistics.
+      TraceMap      mTrace{};                             ///< The recorded plan descriptions.
+      bool          mRecording{};                         ///< Is the recording of the used plans enabled?
+      bool          mHibernation{};                       ///< Is the hibernation over the memory budget enabled?
   };
 } // namespace afft
 
@@ -0,0 +1,647 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_PLAN_GRAPH_HPP
+#define AFFT_PLAN_GRAPH_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "Plan.hpp"
+#if defined(AFFT_ENABLE_CUDA)
+# include "detail/cuda/cuda.hpp"
+#elif defined(AFFT_ENABLE_HIP)
+# include "detail/hip/hip.hpp"
+#endif
+
+AFFT_EXPORT namespace afft
+{
+  /**
+   * @class PlanGraph
+   * @brief Multi-stage pipeline of spst plans and user stages connected by buffers, e. g. a real-to-complex transform,
+   *        a pointwise pass, a complex-to-complex transform of another axis and a complex-to-real transform. Stages
+   *        declare the buffers they read and write and run in the order they were added. The external buffers are
+   *        bound at execution, the intermediate buffers are owned by the graph. On the first execution (or finalize())
+   *        the lifetime of every intermediate buffer is computed from the first to the last stage using it, buffers
+   *        with disjoint lifetimes are aliased in one arena. The external workspaces of the plans live only during
+   *        their stage, so they share the arena with the intermediates not alive at that stage. On gpu all the stages
+   *        are enqueued on the stream of the execution parameters, so the whole graph can be captured into a CUDA or
+   *        HIP graph by stream capture. On cpu the stages run one after another, the plans use the thread pool. The
+   *        plans must target the graph's target and outlive the graph.
+   */
+  class PlanGraph
+  {
+    public:
+      /// @brief Buffer identifier.
+      using BufferId = std::size_t;
+
+      /// @brief Buffers and execution parameters passed to a user stage.
+      struct StageContext
+      {
+        View<void*>                          inputs{};        ///< buffers read by the stage, in the declared order
+        View<void*>                          outputs{};       ///< buffers written by the stage, in the declared order
+        afft::spst::cpu::ExecutionParameters cpuExecParams{}; ///< execution parameters of a cpu graph
+        afft::spst::gpu::ExecutionParameters gpuExecParams{}; ///< execution parameters of a gpu graph, the stage work must be enqueued on its stream
+      };
+
+      /// @brief User stage function.
+      using StageFn = std::function<void(const StageContext&)>;
+
+      /**
+       * @brief Constructor.
+       * @param target The target of the plans and of the intermediate buffers, cpu or gpu.
+       */
+      explicit PlanGraph(Target target = Target::cpu)
+      : mTarget{target}
+      {
+        if (target != Target::cpu && target != Target::gpu)
+        {
+          throw std::invalid_argument("plan graph supports only cpu and gpu targets");
+        }
+
+#     if !defined(AFFT_ENABLE_CUDA) && !defined(AFFT_ENABLE_HIP)
+        if (target == Target::gpu)
+        {
+          throw std::invalid_argument("gpu plan graph requires CUDA or HIP");
+        }
+#     endif
+      }
+
+      /// @brief Copy constructor is deleted.
+      PlanGraph(const PlanGraph&) = delete;
+
+      /// @brief Move constructor.
+      PlanGraph(PlanGraph&&) = default;
+
+      /// @brief Destructor.
+      ~PlanGraph() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      PlanGraph& operator=(const PlanGraph&) = delete;
+
+      /// @brief Move assignment operator.
+      PlanGraph& operator=(PlanGraph&&) = default;
+
+      /**
+       * @brief Get the target of the graph.
+       * @return The target.
+       */
+      [[nodiscard]] constexpr Target getTarget() const noexcept
+      {
+        return mTarget;
+      }
+
+      /**
+       * @brief Add an external buffer, bound at execution by the order of addition.
+       * @return The buffer identifier.
+       */
+      BufferId addExternal()
+      {
+        checkNotFinalized();
+
+        mBuffers.push_back(Buffer{true, mExternalCount++});
+
+        return mBuffers.size() - 1;
+      }
+
+      /**
+       * @brief Add an intermediate buffer owned by the graph.
+       * @param size The size of the buffer in bytes.
+       * @return The buffer identifier.
+       */
+      BufferId addIntermediate(std::size_t size)
+      {
+        checkNotFinalized();
+
+        if (size == 0)
+        {
+          throw std::invalid_argument("intermediate buffer size must be positive");
+        }
+
+        mBuffers.push_back(Buffer{false, 0, size});
+
+        return mBuffers.size() - 1;
+      }
+
+      /**
+       * @brief Add a stage executing the plan. The intermediate buffers must span the plan's buffers.
+       * @param plan The spst plan of the graph's target using the interleaved complex format.
+       * @param src The source buffer.
+       * @param dst The destination buffer, same as the source for in-place plans.
+       */
+      void addPlan(std::shared_ptr<Plan> plan, BufferId src, BufferId dst)
+      {
+        checkNotFinalized();
+
+        if (plan == nullptr)
+        {
+          throw std::invalid_argument("plan graph stage requires a plan");
+        }
+
+        const auto& desc = detail::DescGetter::get(*plan);
+
+        if (desc.getTarget() != mTarget || desc.getDistribution() != Distribution::spst || desc.getTargetCount() != 1)
+        {
+          throw std::invalid_argument("plan graph requires single target spst plans of the graph's target");
+        }
+
+        if (desc.getComplexFormat() != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument("plan graph supports only the interleaved complex format");
+        }
+
+        if ((desc.getPlacement() == Placement::inPlace) != (src == dst))
+        {
+          throw std::invalid_argument("in-place plan stages require the same source and destination buffer");
+        }
+
+        checkBuffer(src);
+        checkBuffer(dst);
+
+        const auto [srcSize, dstSize] = desc.getSpstSrcDstBufferSize();
+
+        if ((!mBuffers[src].isExternal && mBuffers[src].size < srcSize) ||
+            (!mBuffers[dst].isExternal && mBuffers[dst].size < dstSize))
+        {
+          throw std::invalid_argument("intermediate buffer is smaller than the plan buffer");
+        }
+
+        Stage stage{};
+        stage.plan    = std::move(plan);
+        stage.inputs  = {src};
+        stage.outputs = {dst};
+
+        const auto workspaceSize = stage.plan->getWorkspaceSize();
+
+        if (desc.useExternalWorkspace() && !workspaceSize.empty() && workspaceSize.front() > 0)
+        {
+          // the workspace is a transient buffer alive only during the stage
+          mBuffers.push_back(Buffer{false, 0, workspaceSize.front(), true});
+          stage.workspace = mBuffers.size() - 1;
+        }
+
+        mStages.push_back(std::move(stage));
+      }
+
+      /**
+       * @brief Add a user stage, e. g. a pointwise pass between two transforms.
+       * @param fn The stage function.
+       * @param inputs The buffers read by the stage.
+       * @param outputs The buffers written by the stage, may repeat inputs updated in place.
+       */
+      void addStage(StageFn fn, View<BufferId> inputs, View<BufferId> outputs)
+      {
+        checkNotFinalized();
+
+        if (!fn)
+        {
+          throw std::invalid_argument("plan graph stage requires a function");
+        }
+
+        std::for_each(inputs.begin(), inputs.end(), [this](BufferId id) { checkBuffer(id); });
+        std::for_each(outputs.begin(), outputs.end(), [this](BufferId id) { checkBuffer(id); });
+
+        Stage stage{};
+        stage.fn = std::move(fn);
+        stage.inputs.assign(inputs.begin(), inputs.end());
+        stage.outputs.assign(outputs.begin(), outputs.end());
+
+        mStages.push_back(std::move(stage));
+      }
+
+      /**
+       * @brief Analyze the buffer lifetimes, assign the arena offsets and allocate the arena. Called by the first
+       *        execution, no stages or buffers can be added afterwards.
+       */
+      void finalize()
+      {
+        if (mIsFinalized)
+        {
+          return;
+        }
+
+        const std::size_t stageCount = mStages.size();
+        constexpr auto    unused     = std::numeric_limits<std::size_t>::max();
+
+        // lifetimes of the intermediate buffers [first stage, last stage]
+        for (auto& buffer : mBuffers)
+        {
+          buffer.first = unused;
+          buffer.last  = 0;
+        }
+
+        auto touch = [&](BufferId id, std::size_t stage, bool isWrite)
+        {
+          auto& buffer = mBuffers[id];
+
+          if (buffer.isExternal)
+          {
+            return;
+          }
+
+          if (buffer.first == unused)
+          {
+            if (!isWrite)
+            {
+              throw std::invalid_argument("intermediate buffer is read before it is written");
+            }
+
+            buffer.first = stage;
+          }
+
+          buffer.last = stage;
+        };
+
+        for (std::size_t i{}; i < stageCount; ++i)
+        {
+          const auto& stage = mStages[i];
+
+          std::for_each(stage.inputs.begin(), stage.inputs.end(), [&](BufferId id) { touch(id, i, false); });
+          std::for_each(stage.outputs.begin(), stage.outputs.end(), [&](BufferId id) { touch(id, i, true); });
+
+          if (stage.workspace != noBuffer)
+          {
+            touch(stage.workspace, i, true);
+          }
+        }
+
+        // place the largest buffers first, each at the lowest offset free during its lifetime
+        std::vector<BufferId> order{};
+
+        for (BufferId id{}; id < mBuffers.size(); ++id)
+        {
+          if (!mBuffers[id].isExternal && mBuffers[id].first != unused)
+          {
+            order.push_back(id);
+          }
+        }
+
+        std::stable_sort(order.begin(), order.end(), [&](BufferId lhs, BufferId rhs)
+        {
+          return mBuffers[lhs].size > mBuffers[rhs].size;
+        });
+
+        const std::size_t alignment = getAlignment();
+
+        std::vector<BufferId> placed{};
+        std::vector<std::pair<std::size_t, std::size_t>> occupied{};
+
+        mArenaSize     = 0;
+        mUnaliasedSize = 0;
+
+        for (const auto id : order)
+        {
+          auto& buffer = mBuffers[id];
+
+          occupied.clear();
+
+          for (const auto other : placed)
+          {
+            const auto& otherBuffer = mBuffers[other];
+
+            if (otherBuffer.first <= buffer.last && buffer.first <= otherBuffer.last)
+            {
+              occupied.emplace_back(otherBuffer.offset, otherBuffer.offset + otherBuffer.size);
+            }
+          }
+
+          std::sort(occupied.begin(), occupied.end());
+
+          std::size_t offset{};
+
+          for (const auto& [begin, end] : occupied)
+          {
+            if (offset + buffer.size <= begin)
+            {
+              break;
+            }
+
+            offset = std::max(offset, alignUp(end, alignment));
+          }
+
+          buffer.offset = offset;
+          placed.push_back(id);
+
+          mArenaSize      = std::max(mArenaSize, offset + buffer.size);
+          mUnaliasedSize += alignUp(buffer.size, alignment);
+        }
+
+        mArena       = allocateArena(mArenaSize);
+        mIsFinalized = true;
+      }
+
+      /**
+       * @brief Has the graph been finalized?
+       * @return True if finalized, false otherwise.
+       */
+      [[nodiscard]] constexpr bool isFinalized() const noexcept
+      {
+        return mIsFinalized;
+      }
+
+      /**
+       * @brief Get the number of stages.
+       * @return The number of stages.
+       */
+      [[nodiscard]] std::size_t getStageCount() const noexcept
+      {
+        return mStages.size();
+      }
+
+      /**
+       * @brief Get the number of external buffers.
+       * @return The number of external buffers.
+       */
+      [[nodiscard]] constexpr std::size_t getExternalCount() const noexcept
+      {
+        return mExternalCount;
+      }
+
+      /**
+       * @brief Get the size of the arena holding the aliased intermediate buffers and workspaces. Valid once finalized.
+       * @return The arena size in bytes.
+       */
+      [[nodiscard]] constexpr std::size_t getArenaSize() const noexcept
+      {
+        return mArenaSize;
+      }
+
+      /**
+       * @brief Get the size the intermediate buffers and workspaces would take without aliasing. Valid once finalized.
+       * @return The size in bytes.
+       */
+      [[nodiscard]] constexpr std::size_t getUnaliasedSize() const noexcept
+      {
+        return mUnaliasedSize;
+      }
+
+      /**
+       * @brief Execute the graph with the default execution parameters.
+       * @param externals The external buffers in the order of addition.
+       */
+      void execute(View<void*> externals)
+      {
+        switch (mTarget)
+        {
+        case Target::cpu:
+          execute(externals, afft::spst::cpu::ExecutionParameters{});
+          break;
+        case Target::gpu:
+          execute(externals, afft::spst::gpu::ExecutionParameters{});
+          break;
+        default:
+          detail::cxx::unreachable();
+        }
+      }
+
+      /**
+       * @brief Execute the graph.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param externals The external buffers in the order of addition.
+       * @param execParams Execution parameters shared by the stages, the workspace is provided by the graph.
+       */
+      template<typename ExecParamsT>
+      void execute(View<void*> externals, const ExecParamsT& execParams)
+      {
+        static_assert(isExecutionParameters<ExecParamsT>, "Invalid execution parameters type");
+        static_assert(ExecParamsT::distribution == Distribution::spst, "plan graph supports only spst distribution");
+
+        if (ExecParamsT::target != mTarget)
+        {
+          throw std::invalid_argument("execution parameters do not match the graph target");
+        }
+
+        if (externals.size() != mExternalCount)
+        {
+          throw std::invalid_argument("invalid number of external buffers");
+        }
+
+        if (std::any_of(externals.begin(), externals.end(), [](void* ptr) { return ptr == nullptr; }))
+        {
+          throw std::invalid_argument("a null pointer was passed as an external buffer");
+        }
+
+        finalize();
+
+        std::vector<void*> inputs{};
+        std::vector<void*> outputs{};
+
+        for (const auto& stage : mStages)
+        {
+          if (stage.plan != nullptr)
+          {
+            auto stageParams = execParams;
+
+#         if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+            // only spst gpu plans use the external workspace
+            if constexpr (ExecParamsT::target == Target::gpu)
+            {
+              if (stage.workspace != noBuffer)
+              {
+                stageParams.workspace = getBufferPtr(stage.workspace, externals);
+              }
+            }
+#         endif
+
+            stage.plan->executeUnsafe(getBufferPtr(stage.inputs.front(), externals),
+                                      getBufferPtr(stage.outputs.front(), externals),
+                                      stageParams);
+          }
+          else
+          {
+            inputs.resize(stage.inputs.size());
+            outputs.resize(stage.outputs.size());
+
+            std::transform(stage.inputs.begin(), stage.inputs.end(), inputs.begin(), [&](BufferId id)
+            {
+              return getBufferPtr(id, externals);
+            });
+            std::transform(stage.outputs.begin(), stage.outputs.end(), outputs.begin(), [&](BufferId id)
+            {
+              return getBufferPtr(id, externals);
+            });
+
+            StageContext context{};
+            context.inputs  = View<void*>{inputs.data(), inputs.size()};
+            context.outputs = View<void*>{outputs.data(), outputs.size()};
+
+            if constexpr (ExecParamsT::target == Target::cpu)
+            {
+              context.cpuExecParams = execParams;
+            }
+            else if constexpr (ExecParamsT::target == Target::gpu)
+            {
+              context.gpuExecParams = execParams;
+            }
+
+            stage.fn(context);
+          }
+        }
+      }
+    private:
+      /// @brief Invalid buffer identifier.
+      static constexpr BufferId noBuffer{std::numeric_limits<BufferId>::max()};
+
+      /// @brief Buffer of the graph.
+      struct Buffer
+      {
+        bool        isExternal{};  ///< Is the buffer bound at execution?
+        std::size_t index{};       ///< The index of the external buffer.
+        std::size_t size{};        ///< The size of the intermediate buffer in bytes.
+        bool        isWorkspace{}; ///< Is the buffer the workspace of a plan stage?
+        std::size_t first{};       ///< The first stage using the buffer.
+        std::size_t last{};        ///< The last stage using the buffer.
+        std::size_t offset{};      ///< The offset of the intermediate buffer in the arena.
+      };
+
+      /// @brief Stage of the graph, either a plan or a user function.
+      struct Stage
+      {
+        std::shared_ptr<Plan> plan{};              ///< The plan.
+        StageFn               fn{};                ///< The user function.
+        std::vector<BufferId> inputs{};            ///< The buffers read by the stage.
+        std::vector<BufferId> outputs{};           ///< The buffers written by the stage.
+        BufferId              workspace{noBuffer}; ///< The workspace of the plan, noBuffer if none.
+      };
+
+      /// @brief Owning pointer to the arena.
+      using ArenaPtr = std::unique_ptr<void, void(*)(void*)>;
+
+      /**
+       * @brief Round the size up to a multiple of the alignment.
+       * @param size The size.
+       * @param alignment The alignment.
+       * @return The rounded size.
+       */
+      [[nodiscard]] static constexpr std::size_t alignUp(std::size_t size, std::size_t alignment) noexcept
+      {
+        return (size + alignment - 1) / alignment * alignment;
+      }
+
+      /// @brief Throw if the graph has been finalized.
+      void checkNotFinalized() const
+      {
+        if (mIsFinalized)
+        {
+          throw std::runtime_error("plan graph is already finalized");
+        }
+      }
+
+      /**
+       * @brief Throw if the buffer does not exist or is a workspace.
+       * @param id The buffer identifier.
+       */
+      void checkBuffer(BufferId id) const
+      {
+        if (id >= mBuffers.size() || mBuffers[id].isWorkspace)
+        {
+          throw std::invalid_argument("invalid plan graph buffer");
+        }
+      }
+
+      /**
+       * @brief Get the alignment of the buffers in the arena.
+       * @return The alignment in bytes.
+       */
+      [[nodiscard]] std::size_t getAlignment() const noexcept
+      {
+        // gpu allocations are aligned to 256 bytes
+        return (mTarget == Target::cpu) ? static_cast<std::size_t>(cpu::getDefaultAlignment()) : std::size_t{256};
+      }
+
+      /**
+       * @brief Get the pointer of a buffer.
+       * @param id The buffer identifier.
+       * @param externals The external buffers.
+       * @return The pointer.
+       */
+      [[nodiscard]] void* getBufferPtr(BufferId id, View<void*> externals) const
+      {
+        const auto& buffer = mBuffers[id];
+
+        return (buffer.isExternal) ? externals[buffer.index] : static_cast<std::byte*>(mArena.get()) + buffer.offset;
+      }
+
+      /**
+       * @brief Allocate the arena on the target.
+       * @param size The size in bytes.
+       * @return The arena.
+       */
+      [[nodiscard]] ArenaPtr allocateArena(std::size_t size) const
+      {
+        if (size == 0)
+        {
+          return ArenaPtr{nullptr, [](void*) {}};
+        }
+
+        switch (mTarget)
+        {
+        case Target::cpu:
+          return ArenaPtr{::operator new(size, static_cast<std::align_val_t>(cpu::getDefaultAlignment())), [](void* ptr)
+          {
+            ::operator delete(ptr, static_cast<std::align_val_t>(cpu::getDefaultAlignment()));
+          }};
+        case Target::gpu:
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          void* ptr{};
+
+          detail::cuda::checkError(cudaMalloc(&ptr, size));
+
+          return ArenaPtr{ptr, [](void* ptr)
+          {
+            cudaFree(ptr);
+          }};
+#       elif defined(AFFT_ENABLE_HIP)
+          void* ptr{};
+
+          detail::hip::checkError(hipMalloc(&ptr, size));
+
+          return ArenaPtr{ptr, [](void* ptr)
+          {
+            hipFree(ptr);
+          }};
+#       else
+          throw std::runtime_error("gpu plan graph requires CUDA or HIP");
+#       endif
+        }
+        default:
+          detail::cxx::unreachable();
+        }
+      }
+
+      Target              mTarget{};                ///< The target of the graph.
+      std::vector<Buffer> mBuffers{};               ///< The buffers.
+      std::vector<Stage>  mStages{};                ///< The stages in the execution order.
+      std::size_t         mExternalCount{};         ///< The number of external buffers.
+      std::size_t         mArenaSize{};             ///< The size of the arena in bytes.
+      std::size_t         mUnaliasedSize{};         ///< The size without aliasing in bytes.
+      ArenaPtr            mArena{nullptr, nullptr}; ///< The arena of the intermediate buffers and workspaces.
+      bool                mIsFinalized{};           ///< Has the graph been finalized?
+  };
+} // namespace afft
+
+#endif /* AFFT_PLAN_GRAPH_HPP */
@@ -0,0 +1,407 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_PREPROCESSING_EXECUTOR_HPP
+#define AFFT_PREPROCESSING_EXECUTOR_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "alloc.hpp"
+#include "Plan.hpp"
+
+AFFT_EXPORT namespace afft
+{
+  /// @brief Window function applied to the frames before the transform
+  enum class WindowFunction : std::uint8_t
+  {
+    rectangular, ///< no windowing
+    hann,        ///< Hann window, 0.5 - 0.5 cos(2 pi i / n)
+    hamming,     ///< Hamming window, 0.54 - 0.46 cos(2 pi i / n)
+    blackman,    ///< Blackman window, 0.42 - 0.5 cos(2 pi i / n) + 0.08 cos(4 pi i / n)
+    kaiser,      ///< Kaiser window, I0(beta sqrt(1 - (2 i / n - 1)^2)) / I0(beta)
+  };
+
+  /// @brief Default Kaiser window shape parameter, the side lobes are about 90 dB below the main lobe
+  inline constexpr double defaultKaiserBeta{8.6};
+
+  /**
+   * @brief Make the periodic window of a length, the window is the symmetric window of length + 1 without its last
+   *        sample, as spectral analysis with hopped frames expects.
+   * @param function Window function.
+   * @param length Window length.
+   * @param kaiserBeta Shape parameter of the Kaiser window, ignored by the other windows.
+   * @return The window samples.
+   */
+  [[nodiscard]] inline std::vector<double> makeWindow(WindowFunction function,
+                                                      std::size_t    length,
+                                                      double         kaiserBeta = defaultKaiserBeta)
+  {
+    constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+    // modified Bessel function of the first kind of order zero, the series converges for all arguments
+    auto besselI0 = [](long double x)
+    {
+      const long double quarterX2 = x * x / 4.0L;
+
+      long double sum{1.0L};
+      long double term{1.0L};
+
+      for (unsigned k{1}; term > sum * 1e-20L; ++k)
+      {
+        term *= quarterX2 / (static_cast<long double>(k) * static_cast<long double>(k));
+        sum  += term;
+      }
+
+      return sum;
+    };
+
+    std::vector<double> window(length);
+
+    for (std::size_t i{}; i < length; ++i)
+    {
+      const long double phase = 2.0L * pi * static_cast<long double>(i) / static_cast<long double>(length);
+
+      long double value{};
+
+      switch (function)
+      {
+      case WindowFunction::rectangular:
+        value = 1.0L;
+        break;
+      case WindowFunction::hann:
+        value = 0.5L - 0.5L * std::cos(phase);
+        break;
+      case WindowFunction::hamming:
+        value = 0.54L - 0.46L * std::cos(phase);
+        break;
+      case WindowFunction::blackman:
+        value = 0.42L - 0.5L * std::cos(phase) + 0.08L * std::cos(2.0L * phase);
+        break;
+      case WindowFunction::kaiser:
+      {
+        const long double x = 2.0L * static_cast<long double>(i) / static_cast<long double>(length) - 1.0L;
+
+        value = besselI0(kaiserBeta * std::sqrt(std::max(1.0L - x * x, 0.0L))) / besselI0(kaiserBeta);
+        break;
+      }
+      default:
+        throw std::invalid_argument("invalid window function");
+      }
+
+      window[i] = static_cast<double>(value);
+    }
+
+    return window;
+  }
+} // namespace afft
+
+AFFT_EXPORT namespace afft::cpu
+{
+  /**
+   * @class PreprocessingExecutor
+   * @brief Executes a spst cpu plan over frames of samples, converting the samples to the plan precision and applying
+   *        a window in the pass that feeds the transform. The frames are processed in blocks fitting the L2 cache: a
+   *        block is converted and windowed into an internal buffer and transformed right away by the plan, so the
+   *        backend reads the data from the cache. The frames are hopped from one sample buffer, as short time Fourier
+   *        transforms need, so no frame is copied out of the signal first.
+   *
+   *        The plan must be a real-to-complex or complex-to-complex dft of the shape {frameCount, frameLength} or
+   *        {frameLength} transforming the last axis, out-of-place, of the interleaved complex format and of the default
+   *        source strides, the source precision must be f32 or f64. Complex samples are interleaved pairs. The plan
+   *        must outlive the executor. The executor is not thread safe.
+   */
+  class PreprocessingExecutor
+  {
+    public:
+      /// @brief Size of the buffer converted and transformed at once, about a half of a common L2 cache.
+      static constexpr std::size_t blockSize{std::size_t{256} << 10};
+
+      /**
+       * @brief Constructor, allocates the internal buffer.
+       * @param plan The spst cpu plan.
+       * @param window Window of the frame length, see makeWindow(), empty for no windowing.
+       * @param sampleScale Scale applied to the samples, e.g. 1 / 32768 for full scale int16 samples.
+       */
+      explicit PreprocessingExecutor(Plan& plan, View<double> window = {}, double sampleScale = 1.0)
+      : mPlan{&plan}
+      {
+        const auto& desc = detail::DescGetter::get(plan);
+
+        if (desc.getTarget() != Target::cpu || desc.getDistribution() != Distribution::spst)
+        {
+          throw std::invalid_argument("preprocessing requires a spst cpu plan");
+        }
+
+        if (desc.getTransform() != Transform::dft ||
+            desc.getTransformDesc<Transform::dft>().type == dft::Type::complexToReal)
+        {
+          throw std::invalid_argument("preprocessing supports only real-to-complex and complex-to-complex dft plans");
+        }
+
+        const auto shapeRank = desc.getShapeRank();
+        const auto axes      = desc.getTransformAxes();
+
+        if (shapeRank > 2 || axes.size() != 1 || axes.front() != shapeRank - 1)
+        {
+          throw std::invalid_argument("preprocessing requires a plan transforming the last axis of frames");
+        }
+
+        if (desc.getPlacement() != Placement::outOfPlace)
+        {
+          throw std::invalid_argument("preprocessing requires an out-of-place plan");
+        }
+
+        if (desc.getComplexFormat() != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument("preprocessing supports only the interleaved complex format");
+        }
+
+        if (!desc.getMemoryLayout<Distribution::spst>().hasDefaultSrcStrides() || desc.hasLogicalSrcShape() ||
+            desc.hasShift())
+        {
+          throw std::invalid_argument("preprocessing requires the default source layout");
+        }
+
+        mPrecision = desc.getPrecision().source;
+
+        if (mPrecision != Precision::f32 && mPrecision != Precision::f64)
+        {
+          throw std::invalid_argument("preprocessing supports only f32 and f64 source precision");
+        }
+
+        const auto shape = desc.getShape();
+
+        mFrameLength = shape[shapeRank - 1];
+        mFrameCount  = (shapeRank == 2) ? shape[0] : 1;
+        mComponents  = (desc.getSrcDstComplexity().first == Complexity::complex) ? 2 : 1;
+
+        if (!window.empty() && window.size() != mFrameLength)
+        {
+          throw std::invalid_argument("window length must match the frame length");
+        }
+
+        mWindow.resize(mFrameLength);
+        mWindowF.resize(mFrameLength);
+
+        for (std::size_t i{}; i < mFrameLength; ++i)
+        {
+          mWindow[i]  = sampleScale * ((window.empty()) ? 1.0 : window[i]);
+          mWindowF[i] = static_cast<float>(mWindow[i]);
+        }
+
+        detail::Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto dstStrides = layoutDesc.getMemoryLayout<Distribution::spst>().getDstStrides();
+
+        mDstFrameSize = (shapeRank == 2) ? dstStrides[0] * desc.sizeOfDstElem() : 0;
+        mFrameSize    = mFrameLength * desc.sizeOfSrcElem();
+
+        // blocks of a power of two frames are executed by one part of the batch count plan
+        mBlockFrameCount = mFrameCount;
+
+        if (desc.getOuterBatchCount() != 0)
+        {
+          mBlockFrameCount = 1;
+
+          while (mBlockFrameCount * 2 <= mFrameCount && mBlockFrameCount * 2 * mFrameSize <= blockSize)
+          {
+            mBlockFrameCount *= 2;
+          }
+        }
+
+        const auto& cpuDesc   = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  alignment = (cpuDesc.alignment == Alignment{}) ? getDefaultAlignment() : cpuDesc.alignment;
+
+        mThreadLimit = cpuDesc.threadLimit;
+        mBuffer      = makeAlignedUnique<std::byte[]>(alignment, cpuDesc.hugePagePolicy, mBlockFrameCount * mFrameSize);
+      }
+
+      /// @brief Copy constructor is deleted.
+      PreprocessingExecutor(const PreprocessingExecutor&) = delete;
+
+      /// @brief Move constructor.
+      PreprocessingExecutor(PreprocessingExecutor&&) = default;
+
+      /// @brief Destructor.
+      ~PreprocessingExecutor() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      PreprocessingExecutor& operator=(const PreprocessingExecutor&) = delete;
+
+      /// @brief Move assignment operator.
+      PreprocessingExecutor& operator=(PreprocessingExecutor&&) = default;
+
+      /**
+       * @brief Get the number of frames converted and transformed at once.
+       * @return The number of frames of a block.
+       */
+      [[nodiscard]] constexpr std::size_t getBlockFrameCount() const noexcept
+      {
+        return mBlockFrameCount;
+      }
+
+      /**
+       * @brief Transform the frames of the samples. Frame i starts at sample i * hopSize, the samples must hold
+       *        (frameCount - 1) * hopSize + frameLength samples.
+       * @tparam SampleT Sample type, std::int16_t, std::int32_t, float or double.
+       * @tparam DstT Destination type.
+       * @param samples The samples, interleaved pairs for a complex-to-complex plan.
+       * @param hopSize The distance of the frames in samples.
+       * @param dst The destination buffer of the plan.
+       * @param execParams Execution parameters of the plan, the batch count and the workspace are forwarded.
+       */
+      template<typename SampleT, typename DstT>
+      void execute(const SampleT*                 samples,
+                   std::size_t                    hopSize,
+                   DstT*                          dst,
+                   spst::cpu::ExecutionParameters execParams = {})
+      {
+        static_assert(std::is_same_v<SampleT, std::int16_t> || std::is_same_v<SampleT, std::int32_t> ||
+                      std::is_same_v<SampleT, float> || std::is_same_v<SampleT, double>,
+                      "samples must be std::int16_t, std::int32_t, float or double");
+        static_assert(!std::is_const_v<DstT>, "destination type must be non-const");
+
+        if (samples == nullptr || dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as a buffer");
+        }
+
+        const std::size_t frameCount = (execParams.batchCount != 0) ? execParams.batchCount : mFrameCount;
+
+        if (frameCount > mFrameCount)
+        {
+          throw std::invalid_argument("batch count exceeds the planned frame count");
+        }
+
+        auto* dstBytes = reinterpret_cast<std::byte*>(dst);
+
+        for (std::size_t first{}; first < frameCount; first += mBlockFrameCount)
+        {
+          const std::size_t count = std::min(mBlockFrameCount, frameCount - first);
+
+          if (mPrecision == Precision::f32)
+          {
+            convert<float>(samples, hopSize, first, count);
+          }
+          else
+          {
+            convert<double>(samples, hopSize, first, count);
+          }
+
+          auto blockParams = execParams;
+          blockParams.batchCount = (count != mFrameCount) ? count : 0;
+
+          auto* blockDst = reinterpret_cast<DstT*>(dstBytes + first * mDstFrameSize);
+
+          if (mPrecision == Precision::f32)
+          {
+            executeBlock<float>(blockDst, blockParams);
+          }
+          else
+          {
+            executeBlock<double>(blockDst, blockParams);
+          }
+        }
+      }
+
+    private:
+      /**
+       * @brief Convert and window a block of frames into the internal buffer.
+       * @tparam T Real type of the plan source.
+       * @tparam SampleT Sample type.
+       * @param samples The samples.
+       * @param hopSize The distance of the frames in samples.
+       * @param first The first frame of the block.
+       * @param count The number of frames of the block.
+       */
+      template<typename T, typename SampleT>
+      void convert(const SampleT* samples, std::size_t hopSize, std::size_t first, std::size_t count)
+      {
+        T*       buffer = reinterpret_cast<T*>(mBuffer.get());
+        const T* window = (std::is_same_v<T, float>) ? reinterpret_cast<const T*>(mWindowF.data())
+                                                     : reinterpret_cast<const T*>(mWindow.data());
+
+        detail::parallelFor(count, mThreadLimit, [&](std::size_t i)
+        {
+          const SampleT* frame = samples + (first + i) * hopSize * mComponents;
+          T*             out   = buffer + i * mFrameLength * mComponents;
+
+          if (mComponents == 1)
+          {
+            for (std::size_t j{}; j < mFrameLength; ++j)
+            {
+              out[j] = static_cast<T>(frame[j]) * window[j];
+            }
+          }
+          else
+          {
+            for (std::size_t j{}; j < mFrameLength; ++j)
+            {
+              out[2 * j]     = static_cast<T>(frame[2 * j]) * window[j];
+              out[2 * j + 1] = static_cast<T>(frame[2 * j + 1]) * window[j];
+            }
+          }
+        });
+      }
+
+      /**
+       * @brief Transform the converted block.
+       * @tparam T Real type of the plan source.
+       * @tparam DstT Destination type.
+       * @param dst The destination of the block.
+       * @param execParams Execution parameters.
+       */
+      template<typename T, typename DstT>
+      void executeBlock(DstT* dst, const spst::cpu::ExecutionParameters& execParams)
+      {
+        if (mComponents == 1)
+        {
+          mPlan->execute(reinterpret_cast<T*>(mBuffer.get()), dst, execParams);
+        }
+        else
+        {
+          mPlan->execute(reinterpret_cast<std::complex<T>*>(mBuffer.get()), dst, execParams);
+        }
+      }
+
+      Plan*                         mPlan{};            ///< The plan.
+      Precision                     mPrecision{};       ///< The source precision of the plan.
+      std::size_t                   mFrameLength{};     ///< The frame length in samples.
+      std::size_t                   mFrameCount{};      ///< The planned number of frames.
+      std::size_t                   mComponents{};      ///< The number of components of a sample, 2 for complex.
+      std::size_t                   mFrameSize{};       ///< The size of a converted frame in bytes.
+      std::size_t                   mDstFrameSize{};    ///< The distance of the destination frames in bytes.
+      std::size_t                   mBlockFrameCount{}; ///< The number of frames of a block.
+      unsigned                      mThreadLimit{};     ///< The thread limit of the plan.
+      std::vector<double>           mWindow{};          ///< The window multiplied by the sample scale.
+      std::vector<float>            mWindowF{};         ///< The window multiplied by the sample scale in f32.
+      AlignedUniquePtr<std::byte[]> mBuffer{};          ///< The converted block.
+  };
+} // namespace afft::cpu
+
+#endif /* AFFT_PREPROCESSING_EXECUTOR_HPP */
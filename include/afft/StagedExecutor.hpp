@@ -0,0 +1,333 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_STAGED_EXECUTOR_HPP
+#define AFFT_STAGED_EXECUTOR_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "Plan.hpp"
+
+AFFT_EXPORT namespace afft::gpu
+{
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+  /**
+   * @class StagedExecutor
+   * @brief Executes a spst gpu plan over host data larger than the device memory. The host data is split into chunks
+   *        of one plan execution each, every chunk is copied to the device, transformed and copied back on one of the
+   *        executor's streams, so the copies of one chunk overlap the transform of another. The transfers overlap only
+   *        if the host memory is page-locked, see gpu::PinnedAllocator. The plan must use the default memory layout
+   *        and the interleaved complex format, the chunks are stored contiguously in the host buffers. The plan must
+   *        outlive the executor.
+   */
+  class StagedExecutor
+  {
+    public:
+#   if defined(AFFT_ENABLE_CUDA)
+      /// @brief Stream type.
+      using Stream = cudaStream_t;
+#   elif defined(AFFT_ENABLE_HIP)
+      /// @brief Stream type.
+      using Stream = hipStream_t;
+#   endif
+
+      /// @brief Default number of streams, double buffering the copies against the transforms.
+      static constexpr std::size_t defaultStreamCount{2};
+
+      /**
+       * @brief Constructor, allocates the device buffers of each stream.
+       * @param plan The spst gpu plan.
+       * @param streamCount The number of streams, usually two or three.
+       */
+      explicit StagedExecutor(Plan& plan, std::size_t streamCount = defaultStreamCount)
+      : mPlan{&plan}
+      {
+        const auto& desc = detail::DescGetter::get(plan);
+
+        if (desc.getTarget() != Target::gpu || desc.getDistribution() != Distribution::spst)
+        {
+          throw std::invalid_argument("staged execution requires a spst gpu plan");
+        }
+
+        if (desc.getComplexFormat() != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument("staged execution supports only the interleaved complex format");
+        }
+
+        const auto& memoryLayout = desc.getMemoryLayout<Distribution::spst>();
+
+        if (!memoryLayout.hasDefaultSrcStrides() || !memoryLayout.hasDefaultDstStrides())
+        {
+          throw std::invalid_argument("staged execution supports only the default memory layout");
+        }
+
+        if (streamCount == 0)
+        {
+          throw std::invalid_argument("staged execution requires at least one stream");
+        }
+
+        const auto shapeRank = desc.getShapeRank();
+        const auto srcShape  = desc.getSrcShape();
+        const auto dstShape  = desc.getDstShape();
+
+        mSrcChunkSize = std::accumulate(srcShape.begin(), srcShape.begin() + shapeRank, desc.sizeOfSrcElem(),
+                                        std::multiplies<>{});
+        mDstChunkSize = std::accumulate(dstShape.begin(), dstShape.begin() + shapeRank, desc.sizeOfDstElem(),
+                                        std::multiplies<>{});
+
+        // in-place chunks occupy the same span in both host buffers
+        if (desc.getPlacement() == Placement::inPlace)
+        {
+          mSrcChunkSize = mDstChunkSize = std::max(mSrcChunkSize, mDstChunkSize);
+        }
+
+        mDevice = desc.getArchDesc<Target::gpu, Distribution::spst>().device;
+
+        mStages.resize(streamCount);
+
+        try
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+          for (auto& stage : mStages)
+          {
+            detail::cuda::checkError(cudaStreamCreateWithFlags(&stage.stream, cudaStreamNonBlocking));
+            detail::cuda::checkError(cudaMalloc(&stage.src, mSrcChunkSize));
+
+            if (desc.getPlacement() == Placement::inPlace)
+            {
+              stage.dst = stage.src;
+            }
+            else
+            {
+              detail::cuda::checkError(cudaMalloc(&stage.dst, mDstChunkSize));
+            }
+          }
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{mDevice};
+
+          for (auto& stage : mStages)
+          {
+            detail::hip::checkError(hipStreamCreateWithFlags(&stage.stream, hipStreamNonBlocking));
+            detail::hip::checkError(hipMalloc(&stage.src, mSrcChunkSize));
+
+            if (desc.getPlacement() == Placement::inPlace)
+            {
+              stage.dst = stage.src;
+            }
+            else
+            {
+              detail::hip::checkError(hipMalloc(&stage.dst, mDstChunkSize));
+            }
+          }
+#       endif
+        }
+        catch (...)
+        {
+          destroyStages();
+          throw;
+        }
+      }
+
+      /// @brief Copy constructor is deleted.
+      StagedExecutor(const StagedExecutor&) = delete;
+
+      /// @brief Move constructor is deleted.
+      StagedExecutor(StagedExecutor&&) = delete;
+
+      /// @brief Destructor, waits for the enqueued work and frees the device buffers.
+      ~StagedExecutor()
+      {
+        destroyStages();
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      StagedExecutor& operator=(const StagedExecutor&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      StagedExecutor& operator=(StagedExecutor&&) = delete;
+
+      /**
+       * @brief Get the number of streams.
+       * @return The number of streams.
+       */
+      [[nodiscard]] std::size_t getStreamCount() const noexcept
+      {
+        return mStages.size();
+      }
+
+      /**
+       * @brief Get the size of one source chunk.
+       * @return The source chunk size in bytes.
+       */
+      [[nodiscard]] constexpr std::size_t getSrcChunkSize() const noexcept
+      {
+        return mSrcChunkSize;
+      }
+
+      /**
+       * @brief Get the size of one destination chunk.
+       * @return The destination chunk size in bytes.
+       */
+      [[nodiscard]] constexpr std::size_t getDstChunkSize() const noexcept
+      {
+        return mDstChunkSize;
+      }
+
+      /**
+       * @brief Transform the chunks of the host source into the host destination, returns after all the chunks are
+       *        copied back. For in-place plans the source and the destination may be the same buffer.
+       * @tparam SrcT Source type.
+       * @tparam DstT Destination type.
+       * @param src Host source buffer holding chunkCount chunks.
+       * @param dst Host destination buffer holding chunkCount chunks.
+       * @param chunkCount The number of chunks.
+       */
+      template<typename SrcT, typename DstT>
+      void execute(const SrcT* src, DstT* dst, std::size_t chunkCount)
+      {
+        static_assert(!std::is_const_v<DstT>, "destination buffer cannot be const");
+
+        if (src == nullptr || dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as host buffer");
+        }
+
+        const auto* hostSrc = reinterpret_cast<const std::byte*>(src);
+        auto*       hostDst = reinterpret_cast<std::byte*>(dst);
+
+#     if defined(AFFT_ENABLE_CUDA)
+        detail::cuda::ScopedDevice scopedDevice{mDevice};
+#     elif defined(AFFT_ENABLE_HIP)
+        detail::hip::ScopedDevice scopedDevice{mDevice};
+#     endif
+
+        for (std::size_t i{}; i < chunkCount; ++i)
+        {
+          // the previous chunk of the stage is ordered before on its stream, so the buffers are free to reuse
+          auto& stage = mStages[i % mStages.size()];
+
+          const auto* chunkSrc = hostSrc + i * mSrcChunkSize;
+          auto*       chunkDst = hostDst + i * mDstChunkSize;
+
+          afft::spst::gpu::ExecutionParameters execParams{};
+          execParams.stream = stage.stream;
+
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::checkError(cudaMemcpyAsync(stage.src, chunkSrc, mSrcChunkSize, cudaMemcpyHostToDevice, stage.stream));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::checkError(hipMemcpyAsync(stage.src, chunkSrc, mSrcChunkSize, hipMemcpyHostToDevice, stage.stream));
+#       endif
+
+          mPlan->execute(static_cast<std::remove_const_t<SrcT>*>(stage.src), static_cast<DstT*>(stage.dst), execParams);
+
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::checkError(cudaMemcpyAsync(chunkDst, stage.dst, mDstChunkSize, cudaMemcpyDeviceToHost, stage.stream));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::checkError(hipMemcpyAsync(chunkDst, stage.dst, mDstChunkSize, hipMemcpyDeviceToHost, stage.stream));
+#       endif
+        }
+
+        for (const auto& stage : mStages)
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::checkError(cudaStreamSynchronize(stage.stream));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::checkError(hipStreamSynchronize(stage.stream));
+#       endif
+        }
+      }
+    private:
+      /// @brief Device buffers and stream of one pipeline stage.
+      struct Stage
+      {
+        Stream stream{}; ///< The stream.
+        void*  src{};    ///< The device source buffer.
+        void*  dst{};    ///< The device destination buffer, same as the source for in-place plans.
+      };
+
+      /// @brief Wait for the stages, free their buffers and destroy their streams, errors are ignored.
+      void destroyStages() noexcept
+      {
+        try
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{mDevice};
+
+          for (auto& stage : mStages)
+          {
+            if (stage.stream != nullptr)
+            {
+              cudaStreamSynchronize(stage.stream);
+              cudaStreamDestroy(stage.stream);
+            }
+
+            if (stage.dst != stage.src)
+            {
+              cudaFree(stage.dst);
+            }
+
+            cudaFree(stage.src);
+          }
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{mDevice};
+
+          for (auto& stage : mStages)
+          {
+            if (stage.stream != nullptr)
+            {
+              hipStreamSynchronize(stage.stream);
+              hipStreamDestroy(stage.stream);
+            }
+
+            if (stage.dst != stage.src)
+            {
+              hipFree(stage.dst);
+            }
+
+            hipFree(stage.src);
+          }
+#       endif
+        }
+        catch (...)
+        {
+          // The device may already be torn down at exit
+        }
+
+        mStages.clear();
+      }
+
+      Plan*              mPlan{};         ///< The plan.
+      int                mDevice{};       ///< The device of the plan.
+      std::size_t        mSrcChunkSize{}; ///< The source chunk size in bytes.
+      std::size_t        mDstChunkSize{}; ///< The destination chunk size in bytes.
+      std::vector<Stage> mStages{};       ///< The pipeline stages, one per stream.
+  };
+#endif
+} // namespace afft::gpu
+
+#endif /* AFFT_STAGED_EXECUTOR_HPP */
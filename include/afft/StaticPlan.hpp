@@ -0,0 +1,311 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_STATIC_PLAN_HPP
+#define AFFT_STATIC_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "makePlan.hpp"
+#include "typeTraits.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Real type of the precision of a static plan.
+   * @tparam prec The precision.
+   */
+  template<Precision prec>
+  using StaticPlanRealType = std::conditional_t<prec == Precision::_float,
+                                                float,
+                                                std::conditional_t<prec == Precision::_double, double, long double>>;
+
+  /**
+   * @brief Selects the backend plan class of a static plan, the backend is not supported by default.
+   * @tparam backend The backend.
+   * @tparam prec The precision.
+   */
+  template<Backend backend, Precision prec>
+  struct StaticBackendPlanSelect
+  {
+    static constexpr bool isSupported{false}; ///< The backend and the precision are not supported
+  };
+
+#ifdef AFFT_HEADER_ONLY
+# ifdef AFFT_ENABLE_POCKETFFT
+  /// @brief Specialization for the pocketfft backend.
+  template<Precision prec>
+  struct StaticBackendPlanSelect<Backend::pocketfft, prec>
+  {
+    /// @brief The precision is supported by the pocketfft plans.
+    static constexpr bool isSupported{prec == Precision::_float ||
+                                      prec == Precision::_double ||
+                                      prec == Precision::_longDouble};
+
+    /// @brief The backend plan type.
+    using Type = pocketfft::spst::cpu::Plan<StaticPlanRealType<prec>>;
+
+    /**
+     * @brief Make the backend plan, the description is validated by the backend.
+     * @param desc Plan description.
+     * @return The backend plan.
+     */
+    [[nodiscard]] static std::unique_ptr<Type> make(const Desc& desc)
+    {
+      // the plan of a uniform precision is always made as Type
+      return std::unique_ptr<Type>{static_cast<Type*>(
+        pocketfft::makePlan(desc, BackendParameters<Target::cpu, Distribution::spst>{}).release())};
+    }
+  };
+# endif
+
+# ifdef AFFT_ENABLE_CODELET
+  /// @brief Specialization for the codelet backend.
+  template<Precision prec>
+  struct StaticBackendPlanSelect<Backend::codelet, prec>
+  {
+    /// @brief The precision is supported by the codelet plans, double-double plans are not static.
+    static constexpr bool isSupported{prec == Precision::_float || prec == Precision::_double};
+
+    /// @brief The backend plan type.
+    using Type = codelet::spst::cpu::Plan<StaticPlanRealType<prec>>;
+
+    /**
+     * @brief Make the backend plan, the description is validated by the backend.
+     * @param desc Plan description.
+     * @return The backend plan.
+     */
+    [[nodiscard]] static std::unique_ptr<Type> make(const Desc& desc)
+    {
+      // the plan of a single or double precision is always made as Type
+      return std::unique_ptr<Type>{static_cast<Type*>(
+        codelet::makePlan(desc, BackendParameters<Target::cpu, Distribution::spst>{}).release())};
+    }
+  };
+# endif
+#endif /* AFFT_HEADER_ONLY */
+
+  /**
+   * @brief Check if the transform parameters type matches the static plan, a dynamic shape extent is checked by the
+   *        constructor.
+   * @tparam transform The transform.
+   * @tparam shapeExt The shape extent of the static plan.
+   * @tparam T The transform parameters type.
+   */
+  template<Transform transform, std::size_t shapeExt, typename T>
+  struct IsStaticPlanTransformParameters : std::false_type {};
+
+  /// @brief Specialization for dft parameters.
+  template<std::size_t shapeExt, std::size_t paramsShapeExt, std::size_t transformExt>
+  struct IsStaticPlanTransformParameters<Transform::dft, shapeExt, dft::Parameters<paramsShapeExt, transformExt>>
+    : std::bool_constant<shapeExt == dynamicExtent || paramsShapeExt == dynamicExtent || shapeExt == paramsShapeExt> {};
+
+  /// @brief Specialization for dht parameters.
+  template<std::size_t shapeExt, std::size_t paramsShapeExt, std::size_t transformExt>
+  struct IsStaticPlanTransformParameters<Transform::dht, shapeExt, dht::Parameters<paramsShapeExt, transformExt>>
+    : std::bool_constant<shapeExt == dynamicExtent || paramsShapeExt == dynamicExtent || shapeExt == paramsShapeExt> {};
+
+  /// @brief Specialization for dtt parameters.
+  template<std::size_t shapeExt, std::size_t paramsShapeExt, std::size_t transformExt>
+  struct IsStaticPlanTransformParameters<Transform::dtt, shapeExt, dtt::Parameters<paramsShapeExt, transformExt>>
+    : std::bool_constant<shapeExt == dynamicExtent || paramsShapeExt == dynamicExtent || shapeExt == paramsShapeExt> {};
+} // namespace afft::detail
+
+AFFT_EXPORT namespace afft
+{
+  /**
+   * @class StaticPlan
+   * @brief Spst cpu plan of a backend and buffer types known at compile time. The backend plan is held by its final
+   *        type, so an execution is a direct, inlinable call of the backend without the virtual dispatch, the type,
+   *        buffer and alignment checks, the statistics and the tracing of Plan::execute(). The description is
+   *        validated once by the constructor. Only the transforms the backend computes by itself are supported, the
+   *        planar complex format, the DTT axes, the logical source shape, the destination window, the full spectrum,
+   *        the shifts and the unpadded in-place real layouts are rejected. Requires the header-only build.
+   * @tparam backend The backend, pocketfft or codelet.
+   * @tparam transform The transform.
+   * @tparam SrcT Source type, may be const.
+   * @tparam DstT Destination type.
+   * @tparam shapeExt Extent of the shape, dynamic by default.
+   */
+  template<Backend backend, Transform transform, typename SrcT, typename DstT, std::size_t shapeExt = dynamicExtent>
+  class StaticPlan
+  {
+    static_assert(isKnownType<SrcT> && isKnownType<DstT>, "static plans require known source and destination types");
+    static_assert(typePrecision<SrcT> == typePrecision<DstT>,
+                  "source and destination types must have the same precision");
+    static_assert(transform == Transform::dft || (isRealType<SrcT> && isRealType<DstT>),
+                  "dht and dtt require real source and destination types");
+    static_assert(transform != Transform::dft || !(isRealType<SrcT> && isRealType<DstT>),
+                  "dft requires a complex source or destination type");
+    static_assert(!std::is_const_v<DstT>, "destination type must not be const");
+    static_assert(detail::StaticBackendPlanSelect<backend, typePrecision<SrcT>>::isSupported,
+                  "backend is not enabled, not supported by static plans or does not support the precision, static "
+                  "plans require the header-only build");
+
+    private:
+      /// @brief The backend plan type.
+      using BackendPlan = typename detail::StaticBackendPlanSelect<backend, typePrecision<SrcT>>::Type;
+
+    public:
+      /**
+       * @brief Constructor, makes the backend plan.
+       * @tparam TransformParamsT Transform parameters type.
+       * @tparam ArchParamsT Architecture parameters type.
+       * @param transformParams Transform parameters, the precision must be the precision of the types.
+       * @param archParams Spst cpu architecture parameters.
+       * @throw std::invalid_argument if the parameters do not match the types or need features of the dynamic plans.
+       * @throw BackendError if the backend does not support the transform.
+       */
+      template<typename TransformParamsT, typename ArchParamsT>
+      StaticPlan(const TransformParamsT& transformParams, const ArchParamsT& archParams)
+      {
+        static_assert(detail::IsStaticPlanTransformParameters<transform, shapeExt, TransformParamsT>::value,
+                      "transform parameters do not match the transform or the shape extent");
+        static_assert(isArchitectureParameters<ArchParamsT>, "invalid architecture parameters type");
+        static_assert(ArchParamsT::target == Target::cpu && ArchParamsT::distribution == Distribution::spst,
+                      "static plans support only spst cpu architecture parameters");
+
+        const detail::Desc desc{transformParams, archParams};
+
+        if constexpr (shapeExt != dynamicExtent)
+        {
+          if (desc.getShapeRank() != shapeExt)
+          {
+            throw std::invalid_argument{"shape rank does not match the shape extent"};
+          }
+        }
+
+        const auto& precision = desc.getPrecision();
+
+        if (precision.execution != typePrecision<SrcT> ||
+            precision.source != typePrecision<SrcT> ||
+            precision.destination != typePrecision<SrcT>)
+        {
+          throw std::invalid_argument{"precision does not match the source and destination types"};
+        }
+
+        if (desc.getSrcDstComplexity() != std::make_pair(typeComplexity<SrcT>, typeComplexity<DstT>))
+        {
+          throw std::invalid_argument{"transform type does not match the source and destination types"};
+        }
+
+        if (desc.getComplexFormat() != ComplexFormat::interleaved)
+        {
+          throw std::invalid_argument{"static plans support only the interleaved complex format"};
+        }
+
+        if (desc.hasDttAxes() ||
+            desc.hasLogicalSrcShape() ||
+            desc.hasDstWindow() ||
+            desc.hasFullSpectrum() ||
+            desc.hasShift() ||
+            detail::isUnpaddedRealLayout(desc))
+        {
+          throw std::invalid_argument{"static plans do not support transforms composed by the dynamic plans"};
+        }
+
+        detail::Initializer::getInstance().initBackend(backend);
+
+        mPlan = detail::StaticBackendPlanSelect<backend, typePrecision<SrcT>>::make(desc);
+        mPlacement = desc.getPlacement();
+      }
+
+      /// @brief Copy constructor is deleted.
+      StaticPlan(const StaticPlan&) = delete;
+
+      /// @brief Move constructor.
+      StaticPlan(StaticPlan&&) = default;
+
+      /// @brief Destructor.
+      ~StaticPlan() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      StaticPlan& operator=(const StaticPlan&) = delete;
+
+      /// @brief Move assignment operator.
+      StaticPlan& operator=(StaticPlan&&) = default;
+
+      /**
+       * @brief Get the backend.
+       * @return The backend.
+       */
+      [[nodiscard]] static constexpr Backend getBackend() noexcept
+      {
+        return backend;
+      }
+
+      /**
+       * @brief Get the transform.
+       * @return The transform.
+       */
+      [[nodiscard]] static constexpr Transform getTransform() noexcept
+      {
+        return transform;
+      }
+
+      /**
+       * @brief Get the placement.
+       * @return The placement.
+       */
+      [[nodiscard]] Placement getPlacement() const noexcept
+      {
+        return mPlacement;
+      }
+
+      /**
+       * @brief Execute the plan, the buffers are not checked. They must not be null, must be distinct for an
+       *        out-of-place plan and equal for an in-place plan.
+       * @param src Source buffer.
+       * @param dst Destination buffer.
+       * @param execParams Execution parameters.
+       */
+      void execute(SrcT* src, DstT* dst, const afft::spst::cpu::ExecutionParameters& execParams = {})
+      {
+        void* srcVoid = const_cast<std::remove_const_t<SrcT>*>(src);
+        void* dstVoid = dst;
+
+        mPlan->BackendPlan::executeBackendImpl(View<void*>{&srcVoid, 1}, View<void*>{&dstVoid, 1}, execParams);
+      }
+
+      /**
+       * @brief Execute the in-place plan, the buffer is not checked.
+       * @param srcDst Source and destination buffer.
+       * @param execParams Execution parameters.
+       */
+      void execute(std::remove_const_t<SrcT>* srcDst, const afft::spst::cpu::ExecutionParameters& execParams = {})
+      {
+        void* srcDstVoid = srcDst;
+
+        mPlan->BackendPlan::executeBackendImpl(View<void*>{&srcDstVoid, 1}, View<void*>{&srcDstVoid, 1}, execParams);
+      }
+
+    private:
+      std::unique_ptr<BackendPlan> mPlan{};      ///< The backend plan.
+      Placement                    mPlacement{}; ///< The placement.
+  };
+} // namespace afft
+
+#endif /* AFFT_STATIC_PLAN_HPP */
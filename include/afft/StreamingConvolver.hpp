@@ -0,0 +1,298 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_STREAMING_CONVOLVER_HPP
+#define AFFT_STREAMING_CONVOLVER_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "alloc.hpp"
+#include "Convolver.hpp"
+#include "PlanCache.hpp"
+#include "typeTraits.hpp"
+#include "detail/convolve.hpp"
+
+AFFT_EXPORT namespace afft
+{
+  /// @brief Parameters of the streaming convolver
+  struct StreamingConvolverParameters
+  {
+    std::size_t blockSize{};   ///< FFT block size, 0 selects it from the filter size
+    std::size_t maxLatency{};  ///< maximum latency in samples when selecting the block size, 0 for no limit
+    unsigned    threadLimit{}; ///< thread limit of the transforms, 0 for no limit
+  };
+
+  /**
+   * @class StreamingConvolver
+   * @brief Linear convolution of an unbounded 1D real signal using the overlap-save method. The signal is processed in
+   *        chunks of arbitrary size, every chunk produces the same number of output samples delayed by the latency,
+   *        which is the number of samples produced by one block. All buffers are allocated by the constructor, so
+   *        processing does not allocate.
+   * @tparam T Real type of the samples, float or double.
+   */
+  template<typename T>
+  class StreamingConvolver
+  {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "StreamingConvolver supports only float and double");
+
+    public:
+      /**
+       * @brief Constructor
+       * @tparam BackendParamsT Backend parameters type
+       * @param filter Filter impulse response
+       * @param params Streaming convolver parameters
+       * @param backendParams Backend parameters
+       */
+      template<typename BackendParamsT = detail::DefaultBackendParameters>
+      StreamingConvolver(View<T>                             filter,
+                         const StreamingConvolverParameters& params        = {},
+                         const BackendParamsT&               backendParams = {})
+      : mFilterSize{filter.size()},
+        mBlockSize{selectBlockSize(filter.size(), params)},
+        mConvolver{makeConvolver(nullptr, mBlockSize, params, backendParams)}
+      {
+        init(filter);
+      }
+
+      /**
+       * @brief Constructor taking the plans from the plan cache
+       * @tparam BackendParamsT Backend parameters type
+       * @param planCache Plan cache the plans are found in or inserted into
+       * @param filter Filter impulse response
+       * @param params Streaming convolver parameters
+       * @param backendParams Backend parameters
+       */
+      template<typename BackendParamsT = detail::DefaultBackendParameters>
+      StreamingConvolver(PlanCache&                          planCache,
+                         View<T>                             filter,
+                         const StreamingConvolverParameters& params        = {},
+                         const BackendParamsT&               backendParams = {})
+      : mFilterSize{filter.size()},
+        mBlockSize{selectBlockSize(filter.size(), params)},
+        mConvolver{makeConvolver(&planCache, mBlockSize, params, backendParams)}
+      {
+        init(filter);
+      }
+
+      /// @brief Copy constructor is deleted.
+      StreamingConvolver(const StreamingConvolver&) = delete;
+
+      /// @brief Move constructor.
+      StreamingConvolver(StreamingConvolver&&) = default;
+
+      /// @brief Destructor.
+      ~StreamingConvolver() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      StreamingConvolver& operator=(const StreamingConvolver&) = delete;
+
+      /// @brief Move assignment operator.
+      StreamingConvolver& operator=(StreamingConvolver&&) = default;
+
+      /**
+       * @brief Get the filter size.
+       * @return Filter size.
+       */
+      [[nodiscard]] constexpr std::size_t getFilterSize() const noexcept
+      {
+        return mFilterSize;
+      }
+
+      /**
+       * @brief Get the FFT block size.
+       * @return Block size.
+       */
+      [[nodiscard]] constexpr std::size_t getBlockSize() const noexcept
+      {
+        return mBlockSize;
+      }
+
+      /**
+       * @brief Get the latency, the output lags the input by this number of samples.
+       * @return Latency in samples.
+       */
+      [[nodiscard]] constexpr std::size_t getLatency() const noexcept
+      {
+        return getHopSize();
+      }
+
+      /**
+       * @brief Process a chunk of the signal.
+       * @param src Source samples.
+       * @param dst Destination samples, receives src.size() samples of the output, may alias the source.
+       */
+      void process(View<T> src, Span<T> dst)
+      {
+        if (dst.size() < src.size())
+        {
+          throw std::invalid_argument{"destination is smaller than the source"};
+        }
+
+        process(src.data(), dst.data(), src.size());
+      }
+
+      /**
+       * @brief Process a chunk of the signal.
+       * @param src Source samples.
+       * @param dst Destination samples, receives count samples of the output, may alias the source.
+       * @param count Number of samples.
+       */
+      void process(const T* src, T* dst, std::size_t count)
+      {
+        const std::size_t historySize = mFilterSize - 1;
+        const std::size_t hopSize     = getHopSize();
+
+        while (count > 0)
+        {
+          const std::size_t n = std::min(count, hopSize - mFill);
+
+          // Read the source before writing the destination, they may alias
+          std::copy_n(src, n, mBlock.get() + historySize + mFill);
+          std::copy_n(mOutput.get() + historySize + mFill, n, dst);
+
+          mFill += n;
+          src   += n;
+          dst   += n;
+          count -= n;
+
+          if (mFill == hopSize)
+          {
+            mConvolver.execute(mBlock.get(), mOutput.get(), afft::spst::cpu::ExecutionParameters{});
+
+            // Keep the last filterSize - 1 samples as the history of the next block
+            std::copy(mBlock.get() + hopSize, mBlock.get() + mBlockSize, mBlock.get());
+
+            mFill = 0;
+          }
+        }
+      }
+
+      /// @brief Reset the signal history and the pending output.
+      void reset() noexcept
+      {
+        std::fill_n(mBlock.get(), mBlockSize, T{});
+        std::fill_n(mOutput.get(), mBlockSize, T{});
+        mFill = 0;
+      }
+    private:
+      /**
+       * @brief Get the number of samples produced by one block.
+       * @return Hop size.
+       */
+      [[nodiscard]] constexpr std::size_t getHopSize() const noexcept
+      {
+        return mBlockSize - mFilterSize + 1;
+      }
+
+      /**
+       * @brief Select the block size.
+       * @param filterSize Filter size.
+       * @param params Streaming convolver parameters.
+       * @return Block size.
+       */
+      [[nodiscard]] static std::size_t selectBlockSize(std::size_t filterSize, const StreamingConvolverParameters& params)
+      {
+        if (filterSize == 0)
+        {
+          throw std::invalid_argument{"filter must not be empty"};
+        }
+
+        if (params.blockSize == 0)
+        {
+          return detail::selectOverlapSaveBlockSize(filterSize, params.maxLatency);
+        }
+
+        if (params.blockSize < filterSize)
+        {
+          throw std::invalid_argument{"block size must not be smaller than the filter size"};
+        }
+
+        return params.blockSize;
+      }
+
+      /**
+       * @brief Make the block convolver.
+       * @tparam BackendParamsT Backend parameters type
+       * @param planCache Plan cache, may be null
+       * @param blockSize Block size
+       * @param params Streaming convolver parameters
+       * @param backendParams Backend parameters
+       * @return Convolver
+       */
+      template<typename BackendParamsT>
+      [[nodiscard]] static Convolver makeConvolver(PlanCache*                          planCache,
+                                                   std::size_t                         blockSize,
+                                                   const StreamingConvolverParameters& params,
+                                                   const BackendParamsT&               backendParams)
+      {
+        const std::array<std::size_t, 1> shape{blockSize};
+
+        dft::Parameters<> transformParams{};
+        transformParams.direction = Direction::forward;
+        transformParams.precision = {typePrecision<T>, typePrecision<T>, typePrecision<T>};
+        transformParams.shape     = shape;
+        transformParams.type      = dft::Type::realToComplex;
+
+        afft::spst::cpu::Parameters<> archParams{};
+        archParams.threadLimit = params.threadLimit;
+
+        if (planCache != nullptr)
+        {
+          return Convolver{*planCache, transformParams, archParams, ConvolutionType::convolution, backendParams};
+        }
+
+        return Convolver{transformParams, archParams, ConvolutionType::convolution, backendParams};
+      }
+
+      /**
+       * @brief Allocate the buffers and set the zero padded filter as the convolver kernel.
+       * @param filter Filter impulse response
+       */
+      void init(View<T> filter)
+      {
+        mBlock  = cpu::makeAlignedUnique<T[]>(mBlockSize);
+        mOutput = cpu::makeAlignedUnique<T[]>(mBlockSize);
+
+        // The output buffer is zeroed, use it to zero pad the filter before it receives the first block
+        std::copy(filter.begin(), filter.end(), mOutput.get());
+
+        mConvolver.setKernel(mOutput.get(), afft::spst::cpu::ExecutionParameters{});
+
+        std::fill_n(mOutput.get(), mBlockSize, T{});
+      }
+
+      std::size_t                mFilterSize{}; ///< Filter size.
+      std::size_t                mBlockSize{};  ///< FFT block size.
+      Convolver                  mConvolver;    ///< Circular convolver of a single block.
+      cpu::AlignedUniquePtr<T[]> mBlock{};      ///< Current block, the history followed by the new samples.
+      cpu::AlignedUniquePtr<T[]> mOutput{};     ///< Output of the last block, its first filterSize - 1 samples are invalid.
+      std::size_t                mFill{};       ///< Number of new samples in the current block.
+  };
+} // namespace afft
+
+#endif /* AFFT_STREAMING_CONVOLVER_HPP */
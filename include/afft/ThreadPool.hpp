@@ -0,0 +1,479 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_THREAD_POOL_HPP
+#define AFFT_THREAD_POOL_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "Span.hpp"
+#include "detail/numa.hpp"
+
+AFFT_EXPORT namespace afft::cpu
+{
+  /**
+   * @class ThreadPool
+   * @brief Interface of the thread pool running the parallel loops of all cpu backends. Implement it to share the cores
+   *        with the threading runtime of the application, e.g. by forwarding the loops to a TBB arena.
+   */
+  class ThreadPool
+  {
+    public:
+      /// @brief Destructor.
+      virtual ~ThreadPool() = default;
+
+      /**
+       * @brief Get the maximum number of threads running a loop concurrently, including the calling thread.
+       * @return The number of threads.
+       */
+      [[nodiscard]] virtual std::size_t getThreadCount() const noexcept = 0;
+
+      /**
+       * @brief Run the function for each index in [0, count) and wait for all of them. The calling thread should take
+       *        part in the work, the function may be called recursively from the loop body. The first exception thrown
+       *        by the function is rethrown, the indices not yet started are skipped.
+       * @param count The number of indices.
+       * @param threadLimit The maximum number of threads including the calling one, 0 for no limit.
+       * @param fn The function invoked with the index.
+       */
+      virtual void parallelFor(std::size_t count, std::size_t threadLimit, const std::function<void(std::size_t)>& fn) = 0;
+  };
+
+  /**
+   * @class WorkStealingThreadPool
+   * @brief The default thread pool. Every loop is split into a contiguous range per thread, the i-th range is always
+   *        started by the i-th thread, the calling thread being the first one. A thread that finished its range steals
+   *        half of the remaining range of the nearest busy thread. The threads are started lazily on the first loop.
+   */
+  class WorkStealingThreadPool final : public ThreadPool
+  {
+    public:
+      /**
+       * @brief Constructs a new thread pool.
+       * @param threadCount The number of threads including the calling one, 0 for the hardware concurrency.
+       */
+      explicit WorkStealingThreadPool(std::size_t threadCount = 0)
+      : mThreadCount{(threadCount == 0) ? std::max(std::thread::hardware_concurrency(), 1u) : threadCount}
+      {}
+
+      /**
+       * @brief Constructs a new thread pool with the threads pinned to the cpus. The i-th thread is pinned to the i-th
+       *        cpu, the first cpu is expected to run the calling thread, it is not pinned by the pool.
+       * @param cpus The cpus, one per thread including the calling one.
+       */
+      explicit WorkStealingThreadPool(View<unsigned> cpus)
+      : mThreadCount{std::max(cpus.size(), std::size_t{1})},
+        mCpus{cpus.begin(), cpus.end()}
+      {}
+
+      /// @brief Copy constructor is deleted.
+      WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+
+      /// @brief Move constructor is deleted.
+      WorkStealingThreadPool(WorkStealingThreadPool&&) = delete;
+
+      /// @brief Destructor, stops and joins the threads.
+      ~WorkStealingThreadPool() override
+      {
+        {
+          std::lock_guard lock{mMutex};
+          mStop = true;
+        }
+
+        for (std::size_t i{}; i < mWorkerCount; ++i)
+        {
+          mWorkers[i].condition.notify_one();
+        }
+
+        for (std::size_t i{}; i < mWorkerCount; ++i)
+        {
+          mWorkers[i].thread.join();
+        }
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      WorkStealingThreadPool& operator=(WorkStealingThreadPool&&) = delete;
+
+      /**
+       * @brief Get the number of threads including the calling one.
+       * @return The number of threads.
+       */
+      [[nodiscard]] std::size_t getThreadCount() const noexcept override
+      {
+        return mThreadCount;
+      }
+
+      /**
+       * @brief Run the function for each index in [0, count) and wait for all of them.
+       * @param count The number of indices.
+       * @param threadLimit The maximum number of threads including the calling one, 0 for no limit.
+       * @param fn The function invoked with the index.
+       */
+      void parallelFor(std::size_t count, std::size_t threadLimit, const std::function<void(std::size_t)>& fn) override
+      {
+        const std::size_t maxThreadCount = (threadLimit == 0) ? mThreadCount : std::min(threadLimit, mThreadCount);
+        const std::size_t slotCount      = std::min(count, maxThreadCount);
+
+        if (slotCount <= 1)
+        {
+          for (std::size_t i{}; i < count; ++i)
+          {
+            fn(i);
+          }
+          return;
+        }
+
+        auto job = std::make_shared<Job>(fn, count, slotCount);
+
+        {
+          std::lock_guard lock{mMutex};
+
+          if (!mWorkers)
+          {
+            startThreads();
+          }
+
+          // The calling thread takes the first slot, the i-th worker the slot i + 1
+          for (std::size_t i{1}; i < slotCount; ++i)
+          {
+            mWorkers[i - 1].jobs.push_back(job);
+          }
+        }
+
+        for (std::size_t i{1}; i < slotCount; ++i)
+        {
+          mWorkers[i - 1].condition.notify_one();
+        }
+
+        work(*job, 0);
+
+        {
+          std::unique_lock lock{job->mutex};
+          job->done.wait(lock, [&]{ return job->pending.load(std::memory_order_acquire) == 0; });
+        }
+
+        // Drop the entries no worker has picked up yet
+        {
+          std::lock_guard lock{mMutex};
+
+          for (std::size_t i{1}; i < slotCount; ++i)
+          {
+            auto& jobs = mWorkers[i - 1].jobs;
+            jobs.erase(std::remove(jobs.begin(), jobs.end(), job), jobs.end());
+          }
+        }
+
+        if (job->exception)
+        {
+          std::rethrow_exception(job->exception);
+        }
+      }
+    private:
+      /// @brief Range of indices owned by a thread.
+      struct Range
+      {
+        std::mutex  mutex{}; ///< The mutex guarding the range.
+        std::size_t begin{}; ///< The first index.
+        std::size_t end{};   ///< The past the end index.
+      };
+
+      /// @brief A parallel loop.
+      struct Job
+      {
+        /**
+         * @brief Constructor.
+         * @param function The function.
+         * @param count The number of indices.
+         * @param slots The number of threads.
+         */
+        Job(const std::function<void(std::size_t)>& function, std::size_t count, std::size_t slots)
+        : fn{function}, ranges{std::make_unique<Range[]>(slots)}, slotCount{slots}, pending{count}
+        {
+          for (std::size_t i{}; i < slotCount; ++i)
+          {
+            ranges[i].begin = count * i / slotCount;
+            ranges[i].end   = count * (i + 1) / slotCount;
+          }
+        }
+
+        const std::function<void(std::size_t)>& fn;          ///< The function.
+        std::unique_ptr<Range[]>                ranges;      ///< The ranges, one per slot.
+        std::size_t                             slotCount{}; ///< The number of slots.
+        std::atomic<std::size_t>                pending{};   ///< The number of indices not yet finished.
+        std::atomic<bool>                       cancelled{}; ///< Set when the function has thrown.
+        std::mutex                              mutex{};     ///< The mutex guarding the exception and completion.
+        std::condition_variable                 done{};      ///< Signaled when all indices are finished.
+        std::exception_ptr                      exception{}; ///< The first exception thrown by the function.
+      };
+
+      /**
+       * @brief Take the next index from the own range.
+       * @param range The own range.
+       * @param index The taken index.
+       * @return True if an index was taken.
+       */
+      [[nodiscard]] static bool pop(Range& range, std::size_t& index)
+      {
+        std::lock_guard lock{range.mutex};
+
+        if (range.begin == range.end)
+        {
+          return false;
+        }
+
+        index = range.begin++;
+        return true;
+      }
+
+      /**
+       * @brief Steal the upper half of the range of another slot, the stolen range except the taken index becomes
+       *        the own range.
+       * @param job The job.
+       * @param slot The own slot.
+       * @param index The taken index.
+       * @return True if an index was stolen.
+       */
+      [[nodiscard]] static bool steal(Job& job, std::size_t slot, std::size_t& index)
+      {
+        for (std::size_t offset{1}; offset < job.slotCount; ++offset)
+        {
+          Range& victim = job.ranges[(slot + offset) % job.slotCount];
+
+          std::size_t begin{};
+          std::size_t end{};
+
+          {
+            std::lock_guard lock{victim.mutex};
+
+            if (victim.begin == victim.end)
+            {
+              continue;
+            }
+
+            end        = victim.end;
+            begin      = end - (end - victim.begin + 1) / 2;
+            victim.end = begin;
+          }
+
+          index = begin;
+
+          if (end - begin > 1)
+          {
+            Range& own = job.ranges[slot];
+
+            std::lock_guard lock{own.mutex};
+            own.begin = begin + 1;
+            own.end   = end;
+          }
+
+          return true;
+        }
+
+        return false;
+      }
+
+      /**
+       * @brief Run the loop body until there is no index left to take.
+       * @param job The job.
+       * @param slot The own slot.
+       */
+      static void work(Job& job, std::size_t slot)
+      {
+        std::size_t index{};
+
+        while (pop(job.ranges[slot], index) || steal(job, slot, index))
+        {
+          if (!job.cancelled.load(std::memory_order_relaxed))
+          {
+            try
+            {
+              job.fn(index);
+            }
+            catch (...)
+            {
+              std::lock_guard lock{job.mutex};
+
+              if (!job.exception)
+              {
+                job.exception = std::current_exception();
+              }
+
+              job.cancelled.store(true, std::memory_order_relaxed);
+            }
+          }
+
+          if (job.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+          {
+            std::lock_guard lock{job.mutex};
+            job.done.notify_all();
+          }
+        }
+      }
+
+      /// @brief A helping thread.
+      struct Worker
+      {
+        std::thread                      thread{};    ///< The thread.
+        std::condition_variable          condition{}; ///< The condition signaling a new job or stop.
+        std::deque<std::shared_ptr<Job>> jobs{};      ///< The queued jobs of the worker.
+      };
+
+      /// @brief Starts the helping threads, must be called with the mutex locked.
+      void startThreads()
+      {
+        mWorkerCount = mThreadCount - 1;
+        mWorkers     = std::make_unique<Worker[]>(mWorkerCount);
+
+        for (std::size_t i{}; i < mWorkerCount; ++i)
+        {
+          mWorkers[i].thread = std::thread{[this, i]{ run(i); }};
+        }
+      }
+
+      /**
+       * @brief The helping thread loop.
+       * @param index The worker index, it runs the slot index + 1.
+       */
+      void run(std::size_t index)
+      {
+        if (!mCpus.empty())
+        {
+          detail::numa::pinCurrentThread(mCpus[index + 1]);
+        }
+
+        Worker& worker = mWorkers[index];
+
+        while (true)
+        {
+          std::shared_ptr<Job> job{};
+
+          {
+            std::unique_lock lock{mMutex};
+
+            worker.condition.wait(lock, [&]{ return mStop || !worker.jobs.empty(); });
+
+            if (mStop)
+            {
+              return;
+            }
+
+            job = std::move(worker.jobs.front());
+            worker.jobs.pop_front();
+          }
+
+          work(*job, index + 1);
+        }
+      }
+
+      std::size_t               mThreadCount{}; ///< The number of threads including the calling one.
+      std::vector<unsigned>     mCpus{};        ///< The cpus the threads are pinned to, empty for no pinning.
+      std::mutex                mMutex{};       ///< The mutex guarding the job queues.
+      std::size_t               mWorkerCount{}; ///< The number of started helping threads.
+      std::unique_ptr<Worker[]> mWorkers{};     ///< The helping threads.
+      bool                      mStop{};        ///< Stop flag.
+  };
+} // namespace afft::cpu
+
+namespace afft::detail
+{
+  /**
+   * @brief Get the mutex guarding the installed cpu thread pool.
+   * @return The mutex.
+   */
+  [[nodiscard]] inline std::mutex& getCpuThreadPoolMutex()
+  {
+    static std::mutex mutex{};
+
+    return mutex;
+  }
+
+  /**
+   * @brief Get the installed cpu thread pool.
+   * @return The installed thread pool, null if the default one was not created yet.
+   */
+  [[nodiscard]] inline std::shared_ptr<cpu::ThreadPool>& getCpuThreadPoolStorage()
+  {
+    static std::shared_ptr<cpu::ThreadPool> threadPool{};
+
+    return threadPool;
+  }
+} // namespace afft::detail
+
+AFFT_EXPORT namespace afft::cpu
+{
+  /**
+   * @brief Get the thread pool used by all cpu backends. The default work stealing thread pool is created on first use.
+   * @return The thread pool.
+   */
+  [[nodiscard]] inline std::shared_ptr<ThreadPool> getThreadPool()
+  {
+    std::lock_guard lock{detail::getCpuThreadPoolMutex()};
+
+    auto& threadPool = detail::getCpuThreadPoolStorage();
+
+    if (!threadPool)
+    {
+      threadPool = std::make_shared<WorkStealingThreadPool>();
+    }
+
+    return threadPool;
+  }
+
+  /**
+   * @brief Make a work stealing thread pool with one thread per cpu, pinned in the order of the NUMA nodes. The loops
+   *        are split into contiguous per node parts, so data allocated with NumaPolicy::blocked is mostly processed by
+   *        the threads of the node owning it.
+   * @return The thread pool.
+   */
+  [[nodiscard]] inline std::shared_ptr<ThreadPool> makeNumaThreadPool()
+  {
+    std::vector<unsigned> cpus{};
+
+    for (const auto& node : detail::numa::getNodes())
+    {
+      cpus.insert(cpus.end(), node.cpus.begin(), node.cpus.end());
+    }
+
+    return std::make_shared<WorkStealingThreadPool>(View<unsigned>{cpus});
+  }
+
+  /**
+   * @brief Set the thread pool used by all cpu backends. Loops already running keep the previous thread pool.
+   * @param threadPool The thread pool, null to restore the default one.
+   */
+  inline void setThreadPool(std::shared_ptr<ThreadPool> threadPool)
+  {
+    std::lock_guard lock{detail::getCpuThreadPoolMutex()};
+
+    detail::getCpuThreadPoolStorage() = std::move(threadPool);
+  }
+} // namespace afft::cpu
+
+#endif /* AFFT_THREAD_POOL_HPP */
@@ -0,0 +1,240 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_WORKSPACE_POOL_HPP
+#define AFFT_WORKSPACE_POOL_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "trace.hpp"
+#if defined(AFFT_ENABLE_CUDA)
+# include "detail/cuda/cuda.hpp"
+#elif defined(AFFT_ENABLE_HIP)
+# include "detail/hip/hip.hpp"
+#endif
+
+AFFT_EXPORT namespace afft::gpu
+{
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+  /**
+   * @class WorkspacePool
+   * @brief Pool of gpu workspaces shared by plans created with the external workspace. There is one arena per device
+   *        and stream, it grows to the largest workspace requested on that stream. The transforms enqueued to a stream
+   *        run in order, so all plans executing on the stream may share its arena. The memory is allocated and freed
+   *        stream ordered, the returned workspace is valid for the work enqueued to the stream until a larger one is
+   *        acquired for it.
+   */
+  class WorkspacePool
+  {
+    public:
+#   if defined(AFFT_ENABLE_CUDA)
+      /// @brief Stream type.
+      using Stream = cudaStream_t;
+#   elif defined(AFFT_ENABLE_HIP)
+      /// @brief Stream type.
+      using Stream = hipStream_t;
+#   endif
+
+      /// @brief Default constructor.
+      WorkspacePool() = default;
+
+      /// @brief Copy constructor is deleted.
+      WorkspacePool(const WorkspacePool&) = delete;
+
+      /// @brief Move constructor is deleted.
+      WorkspacePool(WorkspacePool&&) = delete;
+
+      /// @brief Destructor, frees all arenas.
+      ~WorkspacePool()
+      {
+        try
+        {
+          release();
+        }
+        catch (...)
+        {
+          // The device may already be torn down at exit
+        }
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      WorkspacePool& operator=(const WorkspacePool&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      WorkspacePool& operator=(WorkspacePool&&) = delete;
+
+      /**
+       * @brief Acquire a workspace of at least the given size for the work enqueued to the stream.
+       * @param size The workspace size in bytes.
+       * @param device The device.
+       * @param stream The stream.
+       * @return The workspace, null if the size is zero.
+       */
+      [[nodiscard]] void* acquire(std::size_t size, int device, Stream stream)
+      {
+        if (size == 0)
+        {
+          return nullptr;
+        }
+
+        std::lock_guard lock{mMutex};
+
+        auto it = std::find_if(mArenas.begin(), mArenas.end(), [&](const Arena& arena)
+        {
+          return arena.device == device && arena.stream == stream;
+        });
+
+        if (it == mArenas.end())
+        {
+          it = mArenas.insert(mArenas.end(), Arena{device, stream, nullptr, 0});
+        }
+
+        if (it->size < size)
+        {
+          void* ptr{};
+
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{device};
+
+          if (it->ptr != nullptr)
+          {
+            detail::cuda::checkError(cudaFreeAsync(it->ptr, stream));
+            it->ptr  = nullptr;
+            it->size = 0;
+          }
+
+          detail::cuda::checkError(cudaMallocAsync(&ptr, size, stream));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{device};
+
+          if (it->ptr != nullptr)
+          {
+            detail::hip::checkError(hipFreeAsync(it->ptr, stream));
+            it->ptr  = nullptr;
+            it->size = 0;
+          }
+
+          detail::hip::checkError(hipMallocAsync(&ptr, size, stream));
+#       endif
+
+          it->ptr  = ptr;
+          it->size = size;
+
+          detail::trace::emit(trace::EventType::workspaceAlloc, std::nullopt, "workspace pool", {}, size);
+        }
+
+        return it->ptr;
+      }
+
+      /**
+       * @brief Release the arena of the stream, the memory is freed stream ordered.
+       * @param device The device.
+       * @param stream The stream.
+       */
+      void release(int device, Stream stream)
+      {
+        std::lock_guard lock{mMutex};
+
+        auto it = std::find_if(mArenas.begin(), mArenas.end(), [&](const Arena& arena)
+        {
+          return arena.device == device && arena.stream == stream;
+        });
+
+        if (it != mArenas.end())
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{device};
+          detail::cuda::checkError(cudaFreeAsync(it->ptr, stream));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{device};
+          detail::hip::checkError(hipFreeAsync(it->ptr, stream));
+#       endif
+
+          mArenas.erase(it);
+        }
+      }
+
+      /// @brief Release all arenas, waits for the work using them to finish.
+      void release()
+      {
+        std::lock_guard lock{mMutex};
+
+        for (const auto& arena : mArenas)
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          detail::cuda::ScopedDevice scopedDevice{arena.device};
+          detail::cuda::checkError(cudaFree(arena.ptr));
+#       elif defined(AFFT_ENABLE_HIP)
+          detail::hip::ScopedDevice scopedDevice{arena.device};
+          detail::hip::checkError(hipFree(arena.ptr));
+#       endif
+        }
+
+        mArenas.clear();
+      }
+
+      /**
+       * @brief Get the memory size held by all arenas.
+       * @return The memory size in bytes.
+       */
+      [[nodiscard]] std::size_t getSize() const
+      {
+        std::lock_guard lock{mMutex};
+
+        return std::accumulate(mArenas.begin(), mArenas.end(), std::size_t{}, [](std::size_t sum, const Arena& arena)
+        {
+          return sum + arena.size;
+        });
+      }
+    private:
+      /// @brief Workspace arena of a stream.
+      struct Arena
+      {
+        int         device{}; ///< The device.
+        Stream      stream{}; ///< The stream.
+        void*       ptr{};    ///< The workspace.
+        std::size_t size{};   ///< The workspace size.
+      };
+
+      mutable std::mutex mMutex{};  ///< The mutex guarding the arenas.
+      std::vector<Arena> mArenas{}; ///< The arenas.
+  };
+
+  /**
+   * @brief Get the default workspace pool, used by plans with the external workspace executed without a workspace.
+   * @return The default workspace pool.
+   */
+  [[nodiscard]] inline WorkspacePool& getDefaultWorkspacePool()
+  {
+    static WorkspacePool workspacePool{};
+
+    return workspacePool;
+  }
+#endif
+} // namespace afft::gpu
+
+#endif /* AFFT_WORKSPACE_POOL_HPP */
@@ -0,0 +1,152 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_AFFT_CONFIG_H
+#define AFFT_AFFT_CONFIG_H
+
+/**********************************************************************************************************************/
+// General defines
+/**********************************************************************************************************************/
+#define AFFT_VERSION_MAJOR 0
+#define AFFT_VERSION_MINOR 1
+#define AFFT_VERSION_PATCH 0
+
+#define AFFT_MAX_DIM_COUNT 4
+
+/* #undef AFFT_ENABLE_PLAN_STATS */
+
+/* #undef AFFT_ENABLE_COUNTERS */
+
+/* #undef AFFT_ENABLE_TRACING */
+
+/* #undef AFFT_ENABLE_STDEXEC */
+
+/* #undef AFFT_ENABLE_DLPACK */
+
+/**********************************************************************************************************************/
+// GPU backend defines
+/**********************************************************************************************************************/
+/* #undef AFFT_ENABLE_CUDA */
+#ifdef AFFT_ENABLE_CUDA
+/* #undef AFFT_CUDA_ROOT_DIR */
+/* #undef AFFT_ENABLE_GDS */
+#endif
+
+/* #undef AFFT_ENABLE_HIP */
+#ifdef AFFT_ENABLE_HIP
+/* #undef AFFT_HIP_ROOT_DIR */
+#endif
+
+/* #undef AFFT_ENABLE_OPENCL */
+
+/* #undef AFFT_ENABLE_SYCL */
+
+/**********************************************************************************************************************/
+// Multi-process backend defines
+/**********************************************************************************************************************/
+/* #undef AFFT_ENABLE_MPI */
+
+/**********************************************************************************************************************/
+// Backend defines
+/**********************************************************************************************************************/
+// clFFT
+#ifdef AFFT_ENABLE_OPENCL
+/* #undef AFFT_ENABLE_CLFFT */
+#endif
+
+// cuFFT
+#ifdef AFFT_ENABLE_CUDA
+/* #undef AFFT_ENABLE_CUFFT */
+# if defined(AFFT_ENABLE_CUFFT) && defined(AFFT_ENABLE_MPI)
+/* #undef AFFT_CUFFT_HAS_MP */
+# endif
+#endif
+
+// FFTW3
+/* #undef AFFT_ENABLE_FFTW3 */
+#ifdef AFFT_ENABLE_FFTW3
+/* #undef AFFT_FFTW3_HAS_FLOAT */
+# ifdef AFFT_FFTW3_HAS_FLOAT
+/* #undef AFFT_FFTW3_HAS_FLOAT_THREADS */
+#   ifdef AFFT_ENABLE_MPI
+/* #undef AFFT_FFTW3_HAS_MPI_FLOAT */
+#   endif
+# endif
+/* #undef AFFT_FFTW3_HAS_DOUBLE */
+# ifdef AFFT_FFTW3_HAS_DOUBLE
+/* #undef AFFT_FFTW3_HAS_DOUBLE_THREADS */
+#   ifdef AFFT_ENABLE_MPI
+/* #undef AFFT_FFTW3_HAS_MPI_DOUBLE */
+#   endif
+# endif
+/* #undef AFFT_FFTW3_HAS_LONG */
+# ifdef AFFT_FFTW3_HAS_LONG
+/* #undef AFFT_FFTW3_HAS_LONG_THREADS */
+#   ifdef AFFT_ENABLE_MPI
+/* #undef AFFT_FFTW3_HAS_MPI_LONG */
+#   endif
+# endif
+/* #undef AFFT_FFTW3_HAS_QUAD */
+# ifdef AFFT_FFTW3_HAS_QUAD
+/* #undef AFFT_FFTW3_HAS_QUAD_THREADS */
+# endif
+/* #undef AFFT_FFTW3_HAS_THREADS_CALLBACK */
+#endif
+
+// HeFFTe
+#ifdef AFFT_ENABLE_MPI
+/* #undef AFFT_ENABLE_HEFFTE */
+#endif
+
+// hipFFT
+#ifdef AFFT_ENABLE_HIP
+/* #undef AFFT_ENABLE_HIPFFT */
+#endif
+
+// MKL
+/* #undef AFFT_ENABLE_MKL */
+#if defined(AFFT_ENABLE_MKL) && defined(AFFT_ENABLE_MPI)
+/* #undef AFFT_MKL_HAS_CDFT */
+#endif
+
+// PocketFFT
+/* #undef AFFT_ENABLE_POCKETFFT */
+
+// afft codelets
+#define AFFT_ENABLE_CODELET
+
+// rocFFT
+#ifdef AFFT_ENABLE_HIP
+/* #undef AFFT_ENABLE_ROCFFT */
+#endif
+
+// VKFFT
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP) || defined(AFFT_ENABLE_OPENCL)
+/* #undef AFFT_ENABLE_VKFFT */
+# ifdef AFFT_ENABLE_VKFFT
+/* #undef AFFT_VKFFT_HAS_DOUBLE_DOUBLE */
+# endif
+#endif
+
+#endif /* AFFT_AFFT_CONFIG_H */
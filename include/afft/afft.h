@@ -37,6 +37,7 @@
 #include "error.h"
 #include "init.h"
 #include "Plan.h"
+#include "PlanCache.h"
 #include "transform.h"
 #include "utils.h"
 #include "version.h"
@@ -48,6 +48,37 @@
 #include "Plan.hpp"
 #include "makePlan.hpp"
 #include "PlanCache.hpp"
+#include "rocfft.hpp"
+#include "ConcurrentPlanCache.hpp"
+#include "estimate.hpp"
+#include "BatchedExecutor.hpp"
+#include "BatchingExecutor.hpp"
+#include "ChirpZTransform.hpp"
+#include "Convolver.hpp"
+#include "decomposition.hpp"
+#include "dlpack.hpp"
+#include "GraphExecutor.hpp"
+#include "GroupedExecutor.hpp"
+#include "HybridExecutor.hpp"
+#include "io.hpp"
+#include "nufft.hpp"
+#include "OutOfCoreExecutor.hpp"
+#include "pfb.hpp"
+#include "PlanGraph.hpp"
+#include "PreprocessingExecutor.hpp"
+#include "redistribute.hpp"
+#include "sender.hpp"
+#include "sliding.hpp"
+#include "spectral.hpp"
+#include "StagedExecutor.hpp"
+#include "StaticPlan.hpp"
+#include "StreamingConvolver.hpp"
+#include "stft.hpp"
+#include "ThreadPool.hpp"
+#include "trace.hpp"
+#include "WorkspacePool.hpp"
+#include "transpose.hpp"
+#include "tuning.hpp"
 #include "utils.hpp"
 #include "version.hpp"
 
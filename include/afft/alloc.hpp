@@ -30,12 +30,15 @@
 #endif
 
 #include "architecture.hpp"
+#include "detail/cpuFeatures.hpp"
+#include "detail/hugePages.hpp"
+#include "detail/numa.hpp"
 
 AFFT_EXPORT namespace afft
 {
 namespace cpu
 {
-  /// @brief Default alignment for memory allocation
+  /// @brief Default alignment for memory allocation assumed at compile time
 #if defined(__AVX512F__)
   inline constexpr auto defaultAlignment = Alignment::avx512;
 #elif defined(__AVX2__)
@@ -62,6 +65,19 @@ namespace cpu
   inline constexpr auto defaultAlignment = Alignment::defaultNew;
 #endif
 
+  /**
+   * @brief Get the default alignment for memory allocation of the cpu the process runs on. The cpu is inspected once,
+   *        the alignment is never lower than defaultAlignment.
+   * @return Default alignment.
+   */
+  [[nodiscard]] inline Alignment getDefaultAlignment() noexcept
+  {
+    static const Alignment alignment = std::max(defaultAlignment,
+                                                detail::cpuFeatures::getAlignment(detail::cpuFeatures::get()));
+
+    return alignment;
+  }
+
   /**
    * @brief Aligned memory deleter
    * @tparam T Type of the memory
@@ -157,10 +173,18 @@ namespace cpu
       : mAlignment{alignment}
       {}
 
+      /// @brief Constructor for memory mapped with huge pages
+      constexpr AlignedDeleter(HugePagePolicy hugePagePolicy, std::size_t size) noexcept
+      : mHugePagePolicy{hugePagePolicy},
+        mSize{size}
+      {}
+
       /// @brief Copy constructor
       template<typename U>
       constexpr AlignedDeleter(const AlignedDeleter<U[]>& other) noexcept
-      : mAlignment{other.mAlignment}
+      : mAlignment{other.mAlignment},
+        mHugePagePolicy{other.mHugePagePolicy},
+        mSize{other.mSize}
       {
         static_assert(std::is_convertible_v<U(*)[], T(*)[]>, "U(*)[] must be convertible to T(*)[]");
       }
@@ -168,7 +192,9 @@ namespace cpu
       /// @brief Move constructor
       template<typename U>
       constexpr AlignedDeleter(AlignedDeleter<U[]>&& other) noexcept
-      : mAlignment{std::move(other.mAlignment)}
+      : mAlignment{std::move(other.mAlignment)},
+        mHugePagePolicy{std::move(other.mHugePagePolicy)},
+        mSize{std::move(other.mSize)}
       {
         static_assert(std::is_convertible_v<U(*)[], T(*)[]>, "U(*)[] must be convertible to T(*)[]");
       }
@@ -184,7 +210,9 @@ namespace cpu
 
         if (this != &other)
         {
-          mAlignment = other.mAlignment;
+          mAlignment      = other.mAlignment;
+          mHugePagePolicy = other.mHugePagePolicy;
+          mSize           = other.mSize;
         }
         return *this;
       }
@@ -197,7 +225,9 @@ namespace cpu
 
         if (this != &other)
         {
-          mAlignment = std::move(other.mAlignment);
+          mAlignment      = std::move(other.mAlignment);
+          mHugePagePolicy = std::move(other.mHugePagePolicy);
+          mSize           = std::move(other.mSize);
         }
         return *this;
       }
@@ -211,11 +241,20 @@ namespace cpu
 
         if (ptr != nullptr)
         {
-          ::operator delete[](ptr, static_cast<std::align_val_t>(mAlignment));
+          if (mHugePagePolicy != HugePagePolicy::none)
+          {
+            detail::hugePages::unmap(ptr, mSize, mHugePagePolicy);
+          }
+          else
+          {
+            ::operator delete[](ptr, static_cast<std::align_val_t>(mAlignment));
+          }
         }
       }
     private:
-      Alignment mAlignment{defaultAlignment}; ///< Alignment for memory allocation
+      Alignment      mAlignment{defaultAlignment};           ///< Alignment for memory allocation
+      HugePagePolicy mHugePagePolicy{HugePagePolicy::none}; ///< Huge page policy of the mapped memory
+      std::size_t    mSize{};                               ///< Size of the mapped memory in bytes
   };
 
   /**
@@ -253,7 +292,7 @@ namespace cpu
   [[nodiscard]] auto makeAlignedUnique(Args&&... args)
     -> AFFT_RET_REQUIRES(AlignedUniquePtr<T>, !detail::cxx::is_unbounded_array_v<T>)
   {
-    return makeAlignedUnique<T>(defaultAlignment, std::forward<Args>(args)...);
+    return makeAlignedUnique<T>(getDefaultAlignment(), std::forward<Args>(args)...);
   }
 
   /**
@@ -284,7 +323,35 @@ namespace cpu
   [[nodiscard]] auto makeAlignedUnique(std::size_t n)
     -> AFFT_RET_REQUIRES(AlignedUniquePtr<T>, detail::cxx::is_unbounded_array_v<T>)
   {
-    return makeAlignedUnique<T>(defaultAlignment, n);
+    return makeAlignedUnique<T>(getDefaultAlignment(), n);
+  }
+
+  /**
+   * @brief Make aligned unique pointer for arrays backed by huge pages
+   * @tparam T Type of the memory, must be trivially destructible
+   * @param alignment Alignment for memory allocation, used if the huge page policy is none
+   * @param hugePagePolicy Huge page policy
+   * @param n Number of elements
+   * @return Aligned unique pointer
+   */
+  template<typename T>
+  [[nodiscard]] auto makeAlignedUnique(Alignment alignment, HugePagePolicy hugePagePolicy, std::size_t n)
+    -> AFFT_RET_REQUIRES(AlignedUniquePtr<T>, detail::cxx::is_unbounded_array_v<T>)
+  {
+    using U = std::remove_extent_t<T>;
+
+    static_assert(std::is_trivially_destructible_v<U>, "U must be trivially destructible");
+
+    if (hugePagePolicy == HugePagePolicy::none)
+    {
+      return makeAlignedUnique<T>(alignment, n);
+    }
+
+    auto* ptr = static_cast<U*>(detail::hugePages::map(n * sizeof(U), hugePagePolicy));
+
+    std::uninitialized_value_construct_n(ptr, n);
+
+    return AlignedUniquePtr<T>(ptr, AlignedDeleter<T>{hugePagePolicy, n * sizeof(U)});
   }
 
   /**
@@ -311,7 +378,7 @@ namespace cpu
   [[nodiscard]] auto makeAlignedUniqueForOverwrite()
     -> AFFT_RET_REQUIRES(AlignedUniquePtr<T>, !detail::cxx::is_unbounded_array_v<T>)
   {
-    return makeAlignedUniqueForOverwrite<T>(defaultAlignment);
+    return makeAlignedUniqueForOverwrite<T>(getDefaultAlignment());
   }
 
   /**
@@ -342,7 +409,35 @@ namespace cpu
   [[nodiscard]] auto makeAlignedUniqueForOverwrite(std::size_t n)
     -> AFFT_RET_REQUIRES(AlignedUniquePtr<T>, detail::cxx::is_unbounded_array_v<T>)
   {
-    return makeAlignedUniqueForOverwrite<T>(defaultAlignment, n);
+    return makeAlignedUniqueForOverwrite<T>(getDefaultAlignment(), n);
+  }
+
+  /**
+   * @brief Make aligned unique pointer for arrays backed by huge pages to be overwritten
+   * @tparam T Type of the memory, must be trivially destructible
+   * @param alignment Alignment for memory allocation, used if the huge page policy is none
+   * @param hugePagePolicy Huge page policy
+   * @param n Number of elements
+   * @return Aligned unique pointer
+   */
+  template<typename T>
+  [[nodiscard]] auto makeAlignedUniqueForOverwrite(Alignment alignment, HugePagePolicy hugePagePolicy, std::size_t n)
+    -> AFFT_RET_REQUIRES(AlignedUniquePtr<T>, detail::cxx::is_unbounded_array_v<T>)
+  {
+    using U = std::remove_extent_t<T>;
+
+    static_assert(std::is_trivially_destructible_v<U>, "U must be trivially destructible");
+
+    if (hugePagePolicy == HugePagePolicy::none)
+    {
+      return makeAlignedUniqueForOverwrite<T>(alignment, n);
+    }
+
+    auto* ptr = static_cast<U*>(detail::hugePages::map(n * sizeof(U), hugePagePolicy));
+
+    std::uninitialized_default_construct_n(ptr, n);
+
+    return AlignedUniquePtr<T>(ptr, AlignedDeleter<T>{hugePagePolicy, n * sizeof(U)});
   }
 
   /**
@@ -366,16 +461,24 @@ namespace cpu
       : mAlignment{alignment}
       {}
 
+      /// @brief Constructor with alignment and huge page policy, huge page memory is at least 2 MiB aligned
+      constexpr AlignedAllocator(Alignment alignment, HugePagePolicy hugePagePolicy) noexcept
+      : mAlignment{alignment},
+        mHugePagePolicy{hugePagePolicy}
+      {}
+
       /// @brief Copy constructor
       template<typename U>
       constexpr AlignedAllocator(const AlignedAllocator<U>& other) noexcept
-      : mAlignment{other.getAlignment()}
+      : mAlignment{other.getAlignment()},
+        mHugePagePolicy{other.getHugePagePolicy()}
       {}
 
       /// @brief Move constructor
       template<typename U>
       constexpr AlignedAllocator(AlignedAllocator<U>&& other) noexcept
-      : mAlignment{std::move(other.mAlignment)}
+      : mAlignment{other.getAlignment()},
+        mHugePagePolicy{other.getHugePagePolicy()}
       {}
 
       /// @brief Destructor
@@ -387,7 +490,8 @@ namespace cpu
       {
         if (this != &other)
         {
-          mAlignment = other.mAlignment;
+          mAlignment      = other.getAlignment();
+          mHugePagePolicy = other.getHugePagePolicy();
         }
         return *this;
       }
@@ -398,7 +502,8 @@ namespace cpu
       {
         if (this != &other)
         {
-          mAlignment = std::move(other.mAlignment);
+          mAlignment      = other.getAlignment();
+          mHugePagePolicy = other.getHugePagePolicy();
         }
         return *this;
       }
@@ -410,6 +515,11 @@ namespace cpu
        */
       [[nodiscard]] T* allocate(std::size_t n)
       {
+        if (mHugePagePolicy != HugePagePolicy::none)
+        {
+          return static_cast<T*>(detail::hugePages::map(n * sizeof(T), mHugePagePolicy));
+        }
+
         return static_cast<T*>(::operator new(n * sizeof(T), static_cast<std::align_val_t>(mAlignment)));
       }
 
@@ -418,9 +528,16 @@ namespace cpu
        * @param p Pointer to the memory
        * @param n Number of elements
        */
-      void deallocate(T* p, std::size_t) noexcept
+      void deallocate(T* p, std::size_t n) noexcept
       {
-        ::operator delete(p, static_cast<std::align_val_t>(mAlignment));
+        if (mHugePagePolicy != HugePagePolicy::none)
+        {
+          detail::hugePages::unmap(p, n * sizeof(T), mHugePagePolicy);
+        }
+        else
+        {
+          ::operator delete(p, static_cast<std::align_val_t>(mAlignment));
+        }
       }
 
       /**
@@ -431,9 +548,131 @@ namespace cpu
       {
         return mAlignment;
       }
+
+      /**
+       * @brief Get huge page policy
+       * @return Huge page policy
+       */
+      [[nodiscard]] constexpr HugePagePolicy getHugePagePolicy() const noexcept
+      {
+        return mHugePagePolicy;
+      }
     protected:
     private:
-      Alignment mAlignment{Alignment::defaultNew}; ///< Alignment for memory allocation
+      Alignment      mAlignment{Alignment::defaultNew};     ///< Alignment for memory allocation
+      HugePagePolicy mHugePagePolicy{HugePagePolicy::none}; ///< Huge page policy of the allocated memory
+  };
+
+  /// @brief NUMA placement policy of the allocated pages
+  enum class NumaPolicy : std::uint8_t
+  {
+    firstTouch, ///< pages are placed on the node of the thread touching them first
+    interleave, ///< pages are interleaved round robin over all nodes
+    blocked,    ///< memory is split into one contiguous block per node, matching the batch split of the numa thread pool
+  };
+
+  /**
+   * @brief Get the number of NUMA nodes with cpus.
+   * @return The number of nodes, 1 if the platform does not report NUMA information.
+   */
+  [[nodiscard]] inline std::size_t getNumaNodeCount()
+  {
+    return detail::numa::getNodes().size();
+  }
+
+  /**
+   * @class NumaAllocator
+   * @brief Allocator named concept implementation for page aligned CPU memory placed according to a NUMA policy. Every
+   *        allocation maps its own pages, so it is meant for large transform buffers. The placement is a hint, it is
+   *        ignored on platforms without NUMA support.
+   * @tparam T Type of the memory
+   */
+  template<typename T = void>
+  class NumaAllocator
+  {
+    public:
+      /// @brief Type of the memory
+      using value_type = T;
+
+      /// @brief Default constructor
+      constexpr NumaAllocator() = default;
+
+      /// @brief Constructor with policy
+      constexpr NumaAllocator(NumaPolicy policy) noexcept
+      : mPolicy{policy}
+      {}
+
+      /// @brief Copy constructor
+      template<typename U>
+      constexpr NumaAllocator(const NumaAllocator<U>& other) noexcept
+      : mPolicy{other.getPolicy()}
+      {}
+
+      /// @brief Destructor
+      ~NumaAllocator() noexcept = default;
+
+      /**
+       * @brief Allocate memory
+       * @param n Number of elements
+       * @return Pointer to the allocated memory
+       */
+      [[nodiscard]] T* allocate(std::size_t n)
+      {
+        const std::size_t sizeInBytes = n * sizeof(T);
+
+        void* ptr = detail::numa::mapPages(sizeInBytes);
+
+        switch (mPolicy)
+        {
+        case NumaPolicy::firstTouch:
+          break;
+        case NumaPolicy::interleave:
+          detail::numa::bindInterleaved(ptr, sizeInBytes);
+          break;
+        case NumaPolicy::blocked:
+          detail::numa::bindBlocked(ptr, sizeInBytes);
+          break;
+        default:
+          detail::cxx::unreachable();
+        }
+
+        return static_cast<T*>(ptr);
+      }
+
+      /**
+       * @brief Deallocate memory
+       * @param p Pointer to the memory
+       * @param n Number of elements
+       */
+      void deallocate(T* p, std::size_t n) noexcept
+      {
+        detail::numa::unmapPages(p, n * sizeof(T));
+      }
+
+      /**
+       * @brief Get the NUMA policy
+       * @return NUMA policy
+       */
+      [[nodiscard]] constexpr NumaPolicy getPolicy() const noexcept
+      {
+        return mPolicy;
+      }
+
+      /// @brief Equality operator
+      template<typename U>
+      [[nodiscard]] friend constexpr bool operator==(const NumaAllocator& lhs, const NumaAllocator<U>& rhs) noexcept
+      {
+        return lhs.getPolicy() == rhs.getPolicy();
+      }
+
+      /// @brief Inequality operator
+      template<typename U>
+      [[nodiscard]] friend constexpr bool operator!=(const NumaAllocator& lhs, const NumaAllocator<U>& rhs) noexcept
+      {
+        return !(lhs == rhs);
+      }
+    private:
+      NumaPolicy mPolicy{NumaPolicy::firstTouch}; ///< NUMA placement policy
   };
 } // namespace cpu
 
@@ -571,7 +810,108 @@ namespace gpu
 #   elif defined(AFFT_ENABLE_HIP)
 #   elif defined(AFFT_ENABLE_OPENCL)
       cl_context mContext; ///< OpenCL context
-#   endif  
+#   endif
+  }
+#endif
+   ;
+
+  /**
+   * @class PinnedAllocator
+   * @brief Allocator named concept implementation implementation for page-locked host memory to be used with
+   *        std::vector and others. Copies between the pinned memory and the device run asynchronously, so the
+   *        transfers may overlap the transforms, see gpu::StagedExecutor.
+   * @tparam T Type of the memory
+   */
+  template<typename T>
+  class PinnedAllocator
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+  {
+    public:
+      /// @brief Type of the memory
+      using value_type = T;
+
+      /// @brief Default constructor
+      constexpr PinnedAllocator() noexcept = default;
+
+      /// @brief Copy constructor
+      template<typename U>
+      constexpr PinnedAllocator(const PinnedAllocator<U>&) noexcept
+      {}
+
+      /// @brief Move constructor
+      template<typename U>
+      constexpr PinnedAllocator(PinnedAllocator<U>&&) noexcept
+      {}
+
+      /// @brief Destructor
+      ~PinnedAllocator() noexcept = default;
+
+      /// @brief Copy assignment operator
+      template<typename U>
+      constexpr PinnedAllocator& operator=(const PinnedAllocator<U>&) noexcept
+      {
+        return *this;
+      }
+
+      /// @brief Move assignment operator
+      template<typename U>
+      constexpr PinnedAllocator& operator=(PinnedAllocator<U>&&) noexcept
+      {
+        return *this;
+      }
+
+      /**
+       * @brief Allocate memory
+       * @param n Number of elements
+       * @return Pointer to the allocated memory
+       */
+      [[nodiscard]] T* allocate(std::size_t n)
+      {
+        void* ptr{};
+
+        const std::size_t sizeInBytes = n * sizeof(T);
+
+#     if defined(AFFT_ENABLE_CUDA)
+        detail::cuda::checkError(cudaHostAlloc(&ptr, sizeInBytes, cudaHostAllocPortable));
+#     elif defined(AFFT_ENABLE_HIP)
+        detail::hip::checkError(hipHostMalloc(&ptr, sizeInBytes, hipHostMallocPortable));
+#     endif
+
+        if (ptr == nullptr)
+        {
+          throw std::bad_alloc();
+        }
+
+        return static_cast<T*>(ptr);
+      }
+
+      /**
+       * @brief Deallocate memory
+       * @param p Pointer to the memory
+       * @param n Number of elements
+       */
+      void deallocate(T* p, std::size_t) noexcept
+      {
+#     if defined(AFFT_ENABLE_CUDA)
+        cudaFreeHost(p);
+#     elif defined(AFFT_ENABLE_HIP)
+        hipHostFree(p);
+#     endif
+      }
+
+      /// @brief Pinned allocators are always equal
+      template<typename U>
+      [[nodiscard]] friend constexpr bool operator==(const PinnedAllocator&, const PinnedAllocator<U>&) noexcept
+      {
+        return true;
+      }
+
+      /// @brief Pinned allocators are always equal
+      template<typename U>
+      [[nodiscard]] friend constexpr bool operator!=(const PinnedAllocator&, const PinnedAllocator<U>&) noexcept
+      {
+        return false;
+      }
   }
 #endif
    ;
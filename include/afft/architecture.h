@@ -57,13 +57,37 @@ typedef struct
 /// @brief CPU parameters structure for spst architecture
 typedef struct
 {
-  afft_spst_MemoryLayout memoryLayout;   ///< Memory layout
-  afft_ComplexFormat     complexFormat;  ///< Complex format
-  bool                   preserveSource; ///< Preserve source flag
-  afft_Alignment         alignment;      ///< Alignment
-  unsigned               threadLimit;    ///< Thread limit
+  afft_spst_MemoryLayout memoryLayout;        ///< Memory layout
+  afft_ComplexFormat     complexFormat;       ///< Complex format
+  bool                   preserveSource;      ///< Preserve source flag
+  afft_Alignment         alignment;           ///< Alignment
+  bool                   acceptUnaligned;     ///< Accept buffers of any alignment, see afft::spst::cpu::Parameters
+  bool                   unpaddedInPlaceReal; ///< In-place real data is not padded, see afft::spst::cpu::Parameters
+  unsigned               threadLimit;         ///< Thread limit
+  bool                   autoThreadLimit;     ///< Select the thread count up to threadLimit, see afft::spst::cpu::Parameters
+  bool                   numaSplit;           ///< Split the batch into contiguous parts in the outermost non transformed axis
+  afft_HugePagePolicy    hugePagePolicy;      ///< Huge page policy for the scratch buffers allocated by afft
+  bool                   realtime;            ///< Execute on the calling thread without allocations or locks
+  size_t                 memoryBudget;        ///< Memory budget of the automatic placement in bytes, 0 for no limit
+  bool                   sparseLines;         ///< Skip the zero lines along the first transform axis, see afft::spst::cpu::Parameters
 } afft_spst_cpu_Parameters;
 
+/// @brief GPU user callback structure for spst architecture
+typedef struct
+{
+  const char* srcCode;      ///< Null-terminated CUDA/HIP source code defining the callback function, may be NULL
+  const char* functionName; ///< Null-terminated name of the callback function defined in the source code, may be NULL
+  void*       devicePtr;    ///< Precompiled device function pointer
+  void*       callerInfo;   ///< Device pointer passed to the callback as the caller info
+} afft_spst_gpu_Callback;
+
+/// @brief GPU user load and store callbacks structure for spst architecture
+typedef struct
+{
+  afft_spst_gpu_Callback load;  ///< Load callback
+  afft_spst_gpu_Callback store; ///< Store callback
+} afft_spst_gpu_Callbacks;
+
 /// @brief GPU parameters structure for spst architecture
 typedef struct
 {
@@ -79,28 +103,43 @@ typedef struct
   cl_context             context;              ///< OpenCL context
   cl_device_id           device;               ///< OpenCL device
 #endif
+  afft_spst_gpu_Callbacks callbacks;           ///< User load and store callbacks
 } afft_spst_gpu_Parameters;
 
 /// @brief CPU execution parameters structure for spst architecture
 typedef struct
 {
-  uint8_t _dummy; ///< Dummy field to avoid empty struct
+  size_t      batchCount;   ///< Execute only the first batchCount transforms along the outermost batch axis, 0 for all
+  const bool* lineMask;     ///< Source line occupancy, see afft::spst::cpu::ExecutionParameters, may be NULL
+  size_t      lineMaskSize; ///< Number of the line mask elements
 } afft_spst_cpu_ExecutionParameters;
 
 /// @brief GPU execution parameters structure for spst architecture
 typedef struct
 {
 #if defined(AFFT_ENABLE_CUDA)
-  cudaStream_t     stream;       ///< CUDA stream
-  void*            workspace;    ///< Workspace
+  cudaStream_t     stream;                ///< CUDA stream
+  void*            workspace;             ///< Workspace
+  bool             prefetchManagedMemory; ///< Prefetch managed memory to the device on the stream
+  bool             adviseManagedMemory;   ///< Advise the device as the preferred location of the prefetched managed memory
+  size_t           batchCount;            ///< Execute only the first batchCount transforms along the outermost batch axis, 0 for all
 #elif defined(AFFT_ENABLE_HIP)
-  hipStream_t      stream;       ///< HIP stream
-  void*            workspace;    ///< Workspace
+  hipStream_t      stream;                ///< HIP stream
+  void*            workspace;             ///< Workspace
+  bool             prefetchManagedMemory; ///< Prefetch managed memory to the device on the stream
+  bool             adviseManagedMemory;   ///< Advise the device as the preferred location of the prefetched managed memory
+  size_t           batchCount;            ///< Execute only the first batchCount transforms along the outermost batch axis, 0 for all
 #elif defined(AFFT_ENABLE_OPENCL)
-  cl_command_queue commandQueue; ///< OpenCL command queue
-  cl_mem           workspace;    ///< Workspace
+  cl_command_queue        commandQueue;          ///< OpenCL command queue, used if commandQueueCount is 0
+  size_t                  commandQueueCount;     ///< Number of OpenCL command queues the transform is split across
+  const cl_command_queue* commandQueues;         ///< OpenCL command queues
+  size_t                  waitEventCount;        ///< Number of events the transform waits for
+  const cl_event*         waitEvents;            ///< Events the transform waits for
+  size_t                  completionEventCount;  ///< Number of completion events, 0 or one per command queue
+  cl_event*               completionEvents;      ///< Receives an event completing with the transform per command queue
+  cl_mem                  workspace;             ///< Workspace
 #else
-  uint8_t _dummy;                ///< Dummy field to avoid empty struct
+  uint8_t _dummy;                         ///< Dummy field to avoid empty struct
 #endif
 } afft_spst_gpu_ExecutionParameters;
 
@@ -188,6 +227,7 @@ typedef struct
 #if defined(AFFT_ENABLE_MPI)
   MPI_Comm               communicator;         ///< MPI communicator
 #endif
+  afft_Transport         transport;            ///< Transport of the exchanged data
 #if defined(AFFT_ENABLE_CUDA)
   int                    device;               ///< CUDA device
 #elif defined(AFFT_ENABLE_HIP)
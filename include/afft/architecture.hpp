@@ -75,8 +75,14 @@ inline namespace spst
   } // namespace cpu
   namespace gpu
   {
+# if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+    class WorkspacePool;
+# endif
+    struct Callback;
+    struct Callbacks;
     template<std::size_t shapeExt = dynamicExtent>
     struct Parameters;
+    enum class L2Persistence : std::uint8_t;
     struct ExecutionParameters;
   } // namespace gpu
 
@@ -103,12 +109,45 @@ inline namespace spst
     bool                   preserveSource{true};                      ///< preserve source data
     static constexpr bool  useExternalWorkspace{false};               ///< use external workspace, disabled for now as no backend supports it
     Alignment              alignment{Alignment::defaultNew};          ///< Alignment for CPU memory allocation, defaults to `alignments::defaultNew`
+    bool                   acceptUnaligned{};                         ///< accept buffers of any alignment, buffers not meeting the alignment are executed by a second plan built without it
+    bool                   unpaddedInPlaceReal{};                     ///< in-place real data of default strides is not padded to 2 * (n / 2 + 1) elements along the last axis, the buffer must still hold the complex data
     unsigned               threadLimit{};                             ///< Thread limit for CPU transform, 0 for no limit
+    bool                   autoThreadLimit{};                         ///< select the thread count up to threadLimit from the transform size and the batch count, measured by the best select strategy, Plan::getArchitectureParameters() reports the selected one
+    bool                   numaSplit{};                               ///< split the batch into contiguous parts in the outermost non transformed axis, see cpu::makeNumaThreadPool()
+    HugePagePolicy         hugePagePolicy{HugePagePolicy::none};      ///< Huge page policy for the scratch buffers allocated by afft
+    bool                   realtime{};                                ///< execute on the calling thread without allocations, locks or backends that allocate, see Plan::tryExecute()
+    std::size_t            memoryBudget{};                            ///< bytes of backend memory and workspace the plan may hold with Placement::automatic, 0 for no limit
+    bool                   sparseLines{};                             ///< skip the zero source lines along the first transform axis of c2c transforms of interleaved format along two or more axes, the lines masked out by ExecutionParameters::lineMask or detected while read, ignored by other plans
   };
 
   /// @brief Execution parameters for spst cpu architecture
   struct cpu::ExecutionParameters : detail::ArchitectureExecutionParametersBase<Target::cpu, Distribution::spst>
-  {};
+  {
+    std::size_t batchCount{}; ///< execute only the first batchCount transforms along the outermost batch axis, 0 for all
+    View<bool>  lineMask{};   ///< false for the source lines along the first transform axis that are zero, ordered row-major over the other axes, used by plans with Parameters::sparseLines, empty to detect the zero lines
+  };
+
+  /**
+   * @brief User callback fused into the load or the store of the transform elements. The callback follows the backend's
+   *        callback signature, e.g. `cufftCallbackLoadC` for a cuFFT single precision complex load callback. Either
+   *        the source code or the device function pointer may be set, the callback is disabled if neither is. With
+   *        cuFFT 11.3 or later, the source code is compiled to LTO IR and inlined into the FFT kernels, it then follows
+   *        the `cufftJITCallback*` signatures.
+   */
+  struct gpu::Callback
+  {
+    std::string_view srcCode{};      ///< CUDA/HIP source code defining the callback function, compiled at runtime
+    std::string_view functionName{}; ///< name of the callback function defined in the source code
+    void*            devicePtr{};    ///< precompiled device function pointer, e.g. copied by cudaMemcpyFromSymbol
+    void*            callerInfo{};   ///< device pointer passed to the callback as the caller info
+  };
+
+  /// @brief User load and store callbacks for spst gpu architecture
+  struct gpu::Callbacks
+  {
+    Callback load{};  ///< called for each source element instead of loading it
+    Callback store{}; ///< called for each destination element instead of storing it
+  };
 
   /**
    * @brief Parameters for spst gpu architecture
@@ -128,21 +167,49 @@ inline namespace spst
 # elif defined(AFFT_ENABLE_OPENCL)
     cl_context             context{};                                 ///< OpenCL context
     cl_device_id           device{};                                  ///< OpenCL device
+# elif defined(AFFT_ENABLE_SYCL)
+    sycl::queue*           queue{};                                   ///< SYCL queue the plan is committed to, selects the device and the context
 # endif
+    Callbacks              callbacks{};                               ///< User load and store callbacks
+  };
+
+  /// @brief Buffer kept persisting in the L2 cache during a spst gpu execution
+  enum class gpu::L2Persistence : std::uint8_t
+  {
+    none,        ///< no buffer, the access policy window of the stream is left untouched
+    workspace,   ///< the external workspace, a workspace held by the plan is not known
+    source,      ///< the first source buffer
+    destination, ///< the first destination buffer
   };
 
   /// @brief Execution parameters for spst gpu architecture
   struct gpu::ExecutionParameters : detail::ArchitectureExecutionParametersBase<Target::gpu, Distribution::spst>
   {
 # if defined(AFFT_ENABLE_CUDA)
-    cudaStream_t     stream{0};   ///< CUDA stream
-    void*            workspace{}; ///< workspace for spst gpu transform
+    cudaStream_t     stream{0};               ///< CUDA stream
+    void*            workspace{};             ///< workspace for spst gpu transform, taken from the workspace pool if null
+    WorkspacePool*   workspacePool{};         ///< workspace pool used for a null workspace, null for the default pool
+    bool             prefetchManagedMemory{}; ///< prefetch managed source, destination and workspace to the device on the stream
+    bool             adviseManagedMemory{};   ///< advise the device as the preferred location of the prefetched managed memory
+    std::size_t      batchCount{};            ///< execute only the first batchCount transforms along the outermost batch axis, 0 for all
+    L2Persistence    l2Persistence{};         ///< buffer marked as persisting in L2 by the access policy window of the stream during the execution, the window is restored afterwards
 # elif defined(AFFT_ENABLE_HIP)
-    hipStream_t      stream{0};   ///< HIP stream
-    void*            workspace{}; ///< workspace for spst gpu transform
+    hipStream_t      stream{0};               ///< HIP stream
+    void*            workspace{};             ///< workspace for spst gpu transform, taken from the workspace pool if null
+    WorkspacePool*   workspacePool{};         ///< workspace pool used for a null workspace, null for the default pool
+    bool             prefetchManagedMemory{}; ///< prefetch managed source, destination and workspace to the device on the stream
+    bool             adviseManagedMemory{};   ///< advise the device as the preferred location of the prefetched managed memory
+    std::size_t      batchCount{};            ///< execute only the first batchCount transforms along the outermost batch axis, 0 for all
 # elif defined(AFFT_ENABLE_OPENCL)
-    cl_command_queue queue{};     ///< OpenCL command queue
-    cl_mem           workspace{}; ///< workspace for spst gpu transform
+    cl_command_queue       commandQueue{};     ///< OpenCL command queue, used if commandQueues is empty
+    View<cl_command_queue> commandQueues{};    ///< OpenCL command queues the transform is split across (clFFT), VkFFT takes a single one
+    View<cl_event>         waitEvents{};       ///< events the transform waits for before it starts
+    Span<cl_event>         completionEvents{}; ///< receives an event completing with the transform per command queue, empty if not needed
+    cl_mem                 workspace{};        ///< workspace for spst gpu transform
+# elif defined(AFFT_ENABLE_SYCL)
+    View<sycl::event>      dependencies{};     ///< events the transform depends on, it is submitted to the plan queue
+    sycl::event*           completionEvent{};  ///< receives the event of the transform, null if not needed
+    void*                  workspace{};        ///< USM device workspace for spst gpu transform
 # endif
   };
 } // inline namespace spst
@@ -255,7 +322,7 @@ namespace mpst
     MPI_Comm               communicator{MPI_COMM_WORLD};              ///< MPI communicator
 # endif
     Alignment              alignment{Alignment::defaultNew};          ///< Alignment for CPU memory allocation
-    unsigned               threadLimit{1};                            ///< Thread limit for CPU transform
+    unsigned               threadLimit{1};                            ///< Thread limit of the local transforms of a process, 0 for no limit, shared by the pipelined chunks
   };
 
   /// @brief Execution parameters for mpst cpu architecture
@@ -278,6 +345,7 @@ namespace mpst
 # ifdef AFFT_ENABLE_MPI
     MPI_Comm               communicator{MPI_COMM_WORLD};              ///< MPI communicator
 # endif
+    Transport              transport{Transport::automatic};           ///< Transport of the exchanged data
 # if defined(AFFT_ENABLE_CUDA)
     int                    device{cuda::getCurrentDevice()};          ///< CUDA device
 # elif defined(AFFT_ENABLE_HIP)
@@ -51,10 +51,11 @@ enum
   afft_Backend_pocketfft = (1 << 6), ///< PocketFFT
   afft_Backend_rocfft    = (1 << 7), ///< rocFFT
   afft_Backend_vkfft     = (1 << 8), ///< VkFFT
+  afft_Backend_codelet   = (1 << 9), ///< afft codelets for small lengths and double-double transforms of any length
 };
 
 /// @brief Backend count
-#define AFFT_BACKEND_COUNT 9
+#define AFFT_BACKEND_COUNT 10
 
 /// @brief Backend mask type
 typedef uint16_t afft_BackendMask;
@@ -72,8 +73,9 @@ typedef uint8_t afft_SelectStrategy;
 /// @brief Select strategy enumeration
 enum
 {
-  afft_SelectStrategy_first, ///< Select the first available backend
-  afft_SelectStrategy_best,  ///< Select the best available backend
+  afft_SelectStrategy_first,       ///< Select the first available backend
+  afft_SelectStrategy_best,        ///< Select the best available backend
+  afft_SelectStrategy_progressive, ///< Select the first available backend, replace it with the best one found in the background
 };
 
 /**********************************************************************************************************************/
@@ -184,10 +186,12 @@ enum
 /// @brief HeFFTe backend parameters for mpst cpu architecture
 typedef struct
 {
-  afft_heffte_cpu_Backend backend;     ///< HeFFTe backend
-  bool                    useReorder;  ///< Use reorder flag
-  bool                    useAllToAll; ///< Use all-to-all flag
-  bool                    usePencils;  ///< Use pencils flag
+  afft_heffte_cpu_Backend backend;            ///< HeFFTe backend
+  bool                    useReorder;         ///< Use reorder flag
+  bool                    useAllToAll;        ///< Use all-to-all flag
+  bool                    usePencils;         ///< Use pencils flag
+  size_t                  pipelineChunkCount; ///< Number of batch chunks transformed concurrently, 0 or 1 disables pipelining
+  bool                    autoSelect;         ///< Select the flags by measuring the candidate decompositions
 } afft_mpst_cpu_heffte_Parameters;
 
 /// @brief HeFFTe backend parameters for mpst gpu architecture
@@ -199,6 +203,26 @@ typedef struct
   bool                    usePencils;  ///< Use pencils flag
 } afft_mpst_gpu_heffte_Parameters;
 
+/**********************************************************************************************************************/
+// VkFFT
+/**********************************************************************************************************************/
+/// @brief VkFFT backend parameters for spst gpu architecture, zero memory values are derived from the device, zero tuning values keep the VkFFT defaults
+typedef struct
+{
+  size_t      coalescedMemory;        ///< Size of a coalesced memory transaction in bytes
+  size_t      numSharedBanks;         ///< Number of shared memory banks
+  size_t      sharedMemorySize;       ///< Shared memory available to a block in bytes
+  size_t      maxThreadsNum;          ///< Maximum number of threads in a block
+  size_t      warpSize;               ///< Number of threads in a warp (wavefront)
+  const char* cacheDirectory;         ///< Null-terminated directory where the compiled kernels are cached across processes, may be NULL
+  size_t      registerBoost;          ///< Register file multiple of the shared memory holding a sequence
+  int64_t     performBandwidthBoost;  ///< Bandwidth boost of the axis split kernels, -1 disables it
+  int         useLUT;                 ///< Twiddle factors read from a lookup table if 1 or computed on the fly if -1
+  size_t      aimThreads;             ///< Number of threads per block VkFFT aims for
+  bool        disableReorderFourStep; ///< Disable the reordering of the four-step algorithm
+  size_t      fixMaxRadixBefore87;    ///< Maximum radix used before the radix 7 and 8 kernels are preferred
+} afft_spst_gpu_vkfft_Parameters;
+
 /**********************************************************************************************************************/
 // Backend parameters for spst distribution
 /**********************************************************************************************************************/
@@ -221,6 +245,7 @@ typedef struct
   const afft_Backend*            order;     ///< Order of the backends
   afft_spst_gpu_clfft_Parameters clfft;     ///< clFFT parameters
   afft_spst_gpu_cufft_Parameters cufft;     ///< cuFFT parameters
+  afft_spst_gpu_vkfft_Parameters vkfft;     ///< VkFFT parameters
 } afft_spst_gpu_BackendParameters;
 
 /**********************************************************************************************************************/
@@ -282,6 +307,7 @@ typedef struct
 
 typedef afft_spst_gpu_clfft_Parameters afft_gpu_clfft_Parameters;
 typedef afft_spst_gpu_cufft_Parameters afft_gpu_cufft_Parameters;
+typedef afft_spst_gpu_vkfft_Parameters afft_gpu_vkfft_Parameters;
 typedef afft_spst_cpu_fftw3_Parameters afft_cpu_fftw3_Parameters;
 
 typedef afft_spst_cpu_BackendParameters afft_cpu_BackendParameters;
@@ -48,10 +48,16 @@ AFFT_EXPORT namespace afft
     pocketfft = (1 << 6), ///< PocketFFT
     rocfft    = (1 << 7), ///< rocFFT
     vkfft     = (1 << 8), ///< VkFFT
+    codelet   = (1 << 9), ///< afft codelets for small lengths and double-double transforms of any length
   };
 
   /// @brief Number of backends
-  inline constexpr std::size_t backendCount = 9;
+  inline constexpr std::size_t backendCount = 10;
+
+  namespace tuning
+  {
+    class Database;
+  } // namespace tuning
 
   /// @brief Bitmask of backends
   enum class BackendMask : detail::BackendMaskUnderlyingType
@@ -67,8 +73,10 @@ AFFT_EXPORT namespace afft
   /// @brief Backend select strategy
   enum class SelectStrategy : std::uint8_t
   {
-    first, ///< Select the first available backend
-    best,  ///< Select the best available backend
+    first,       ///< Select the first available backend
+    best,        ///< Select the best available backend
+    progressive, ///< Select the first available backend with the fastest planning, replace it with the best one once
+                 ///< it is found in the background
   };
 
   /**
@@ -184,6 +192,41 @@ namespace cufft
     std::size_t     userWorkspaceSize{};                           ///< Workspace size in bytes when using user-defined workspace policy.
   };
 
+  /**
+   * @brief Select the largest workspace policy fitting the memory budget. Both sizes are obtained by querying
+   *        getWorkspaceSize() of plans created with the performance and the minimal policy.
+   * @param performanceWorkspaceSize Workspace size required by the performance policy.
+   * @param minimalWorkspaceSize Workspace size required by the minimal policy.
+   * @param budget Memory budget in bytes.
+   * @param params Parameters to be updated, the other members are kept.
+   * @return Parameters with the workspace policy set. If even the minimal workspace does not fit the budget,
+   *         the minimal policy is selected.
+   */
+  [[nodiscard]] constexpr spst::gpu::Parameters
+  fitWorkspaceBudget(std::size_t           performanceWorkspaceSize,
+                     std::size_t           minimalWorkspaceSize,
+                     std::size_t           budget,
+                     spst::gpu::Parameters params = {}) noexcept
+  {
+    if (performanceWorkspaceSize <= budget)
+    {
+      params.workspacePolicy   = WorkspacePolicy::performance;
+      params.userWorkspaceSize = {};
+    }
+    else if (minimalWorkspaceSize < budget)
+    {
+      params.workspacePolicy   = WorkspacePolicy::user;
+      params.userWorkspaceSize = budget;
+    }
+    else
+    {
+      params.workspacePolicy   = WorkspacePolicy::minimal;
+      params.userWorkspaceSize = {};
+    }
+
+    return params;
+  }
+
   /// @brief cuFFT initialization parameters for the spmt gpu architecture
   struct spmt::gpu::Parameters
   {
@@ -310,10 +353,15 @@ namespace heffte
       }
     }
 
-    Backend backend{};         ///< Backend
-    bool    useReorder{true};  ///< Use reorder flag
-    bool    useAllToAll{true}; ///< Use alltoall flag
-    bool    usePencils{true};  ///< Use pencils flag
+    Backend     backend{};            ///< Backend
+    bool        useReorder{true};     ///< Use reorder flag
+    bool        useAllToAll{true};    ///< Use alltoall flag
+    bool        usePencils{true};     ///< Use pencils flag
+    std::size_t pipelineChunkCount{}; ///< Number of batch chunks transformed concurrently to overlap the exchange with
+                                      ///< the local transforms, requires MPI_THREAD_MULTIPLE, 0 or 1 disables pipelining,
+                                      ///< the chunks share the thread limit of the local transforms
+    bool        autoSelect{false};    ///< Select the reorder, alltoall and pencils flags by measuring the candidate
+                                      ///< decompositions, the flags above are ignored, the choice is in the feedback
   };
 
   /// @brief HeFFTe initialization parameters for the mpst gpu architecture
@@ -351,6 +399,38 @@ namespace heffte
   };
 } // namespace heffte
 
+/**********************************************************************************************************************/
+// VkFFT
+/**********************************************************************************************************************/
+namespace vkfft
+{
+  namespace spst::gpu
+  {
+    struct Parameters;
+  } // namespace spst::gpu
+
+  /**
+   * @brief VkFFT initialization parameters for the spst gpu architecture, zero memory parameters are derived from the
+   *        device and zero tuning parameters keep the VkFFT defaults. With SelectStrategy::best, the tuning parameters
+   *        left zero are searched on a small grid per shape and device on CUDA and HIP.
+   */
+  struct spst::gpu::Parameters
+  {
+    std::size_t      coalescedMemory{};        ///< Size of a coalesced memory transaction in bytes
+    std::size_t      numSharedBanks{};         ///< Number of shared memory banks
+    std::size_t      sharedMemorySize{};       ///< Shared memory available to a block in bytes
+    std::size_t      maxThreadsNum{};          ///< Maximum number of threads in a block
+    std::size_t      warpSize{};               ///< Number of threads in a warp (wavefront)
+    std::string_view cacheDirectory{};         ///< Directory where the compiled kernels are cached across processes, it must exist, empty disables the cache
+    std::size_t      registerBoost{};          ///< Register file multiple of the shared memory holding a sequence, enables longer single kernel sequences
+    std::int64_t     performBandwidthBoost{};  ///< Bandwidth boost of the axis split kernels, -1 disables it
+    int              useLUT{};                 ///< Twiddle factors read from a lookup table if 1 or computed on the fly if -1
+    std::size_t      aimThreads{};             ///< Number of threads per block VkFFT aims for
+    bool             disableReorderFourStep{}; ///< Disable the reordering of the four-step algorithm, the last transposition is kept
+    std::size_t      fixMaxRadixBefore87{};    ///< Maximum radix used before the radix 7 and 8 kernels are preferred
+  };
+} // namespace vkfft
+
 /**********************************************************************************************************************/
 // Backend parameters for spst distribution
 /**********************************************************************************************************************/
@@ -364,12 +444,17 @@ inline namespace spst
     } // namespace fftw3
 
     /// @brief Supported backends for spst cpu architecture
-    inline constexpr BackendMask supportedBackendMask = Backend::fftw3 |
+    inline constexpr BackendMask supportedBackendMask = Backend::codelet |
+                                                        Backend::fftw3 |
                                                         Backend::mkl |
                                                         Backend::pocketfft;
 
+    /// @brief Backends accepted by spst cpu realtime plans, their executions neither allocate nor lock
+    inline constexpr BackendMask realtimeBackendMask = Backend::codelet | Backend::fftw3;
+
     /// @brief Default backend order for spst cpu architecture
-    inline constexpr std::array defaultBackendOrder = detail::makeArray<Backend>(Backend::mkl,
+    inline constexpr std::array defaultBackendOrder = detail::makeArray<Backend>(Backend::codelet, // rejects lengths above 64 except for f64f64
+                                                                                 Backend::mkl,
                                                                                  Backend::fftw3,
                                                                                  Backend::pocketfft);
 
@@ -385,11 +470,16 @@ inline namespace spst
     {
       using afft::cufft::spst::gpu::Parameters;
     } // namespace cufft
+    namespace vkfft
+    {
+      using afft::vkfft::spst::gpu::Parameters;
+    } // namespace vkfft
 
     /// @brief Supported backends for spst gpu architecture
     inline constexpr BackendMask supportedBackendMask = Backend::clfft |
                                                         Backend::cufft |
                                                         Backend::hipfft |
+                                                        Backend::mkl |
                                                         Backend::rocfft |
                                                         Backend::vkfft;
 
@@ -410,6 +500,8 @@ inline namespace spst
 #   elif defined(AFFT_ENABLE_OPENCL)
       Backend::vkfft,  // prefer vkfft
       Backend::clfft   // fallback to clfft
+#   elif defined(AFFT_ENABLE_SYCL)
+      Backend::mkl     // oneMKL dft on the SYCL queue
 #   endif
     );
 
@@ -423,6 +515,7 @@ inline namespace spst
     BackendMask       mask{supportedBackendMask};      ///< Backend mask
     View<Backend>     order{defaultBackendOrder};      ///< Backend initialization order, empty view means default order for the target
     fftw3::Parameters fftw3{};                         ///< FFTW3 backend initialization parameters
+    tuning::Database* tuningDatabase{};                ///< Tuning database used by the best select strategy, may be null
   };
 
   /// @brief Backend parameters for the spst distribution on the GPU
@@ -433,6 +526,7 @@ inline namespace spst
     View<Backend>     order{defaultBackendOrder};      ///< Backend initialization order, empty view means default order for the target
     clfft::Parameters clfft{};                         ///< clFFT backend initialization parameters
     cufft::Parameters cufft{};                         ///< cuFFT backend initialization parameters
+    vkfft::Parameters vkfft{};                         ///< VkFFT backend initialization parameters
   };
 } // inline namespace spst
 
@@ -563,9 +657,10 @@ namespace mpst
    */
   struct Feedback
   {
-    Backend                       backend{};      ///< Backend that was initialized
-    std::string                   message{};      ///< Message from the backend
-    std::chrono::duration<double> measuredTime{}; ///< Measured time of the backend's transformation (if available)
+    Backend                       backend{};       ///< Backend that was initialized
+    std::string                   message{};       ///< Message from the backend
+    std::chrono::duration<double> measuredTime{};  ///< Measured time of the backend's transformation (if available)
+    double                        relativeError{}; ///< Validated or estimated relative L2 error, see makeAccuratePlan() (if available)
   };
 
   /**
@@ -595,6 +690,8 @@ namespace mpst
       return "rocFFT";
     case Backend::vkfft:
       return "VkFFT";
+    case Backend::codelet:
+      return "afft codelet";
     default:
       return "<invalid backend>";
     }
@@ -92,6 +92,30 @@ enum
   afft_Alignment_sve    = afft_Alignment_simd2048, ///< SVE alignment
 };
 
+/// @brief Huge page policy type
+typedef uint8_t afft_HugePagePolicy;
+
+/// @brief Huge page policy enumeration
+enum
+{
+  afft_HugePagePolicy_none,        ///< Regular pages
+  afft_HugePagePolicy_transparent, ///< Transparent huge pages
+  afft_HugePagePolicy_huge2MiB,    ///< Explicit 2 MiB huge pages
+  afft_HugePagePolicy_huge1GiB,    ///< Explicit 1 GiB huge pages
+};
+
+/// @brief Transport type
+typedef uint8_t afft_Transport;
+
+/// @brief Transport enumeration
+enum
+{
+  afft_Transport_automatic,  ///< GPU aware MPI if supported, host staged MPI otherwise
+  afft_Transport_hostStaged, ///< Host staged MPI
+  afft_Transport_gpuAware,   ///< GPU aware MPI
+  afft_Transport_nccl,       ///< NCCL (RCCL on HIP) all-to-all
+};
+
 /// @brief Complexity type
 typedef uint8_t afft_Complexity;
 
@@ -134,6 +158,8 @@ enum
   afft_Placement_outOfPlace, ///< Out-of-place
 
   afft_Placement_notInPlace = afft_Placement_outOfPlace, ///< Alias for outOfPlace
+
+  afft_Placement_automatic = afft_Placement_outOfPlace + 1, ///< Out-of-place, placement chosen by afft, see afft::Placement
 };
 
 /// @brief Transform type
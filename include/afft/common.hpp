@@ -69,6 +69,34 @@ AFFT_EXPORT namespace afft
     _quad         = f128,   ///< Precision of quad
   };
 
+  /**
+   * @brief Converts a Precision to a string.
+   * @param precision Precision to convert.
+   * @return String representation of the precision.
+   */
+  [[nodiscard]] constexpr std::string_view toString(Precision precision) noexcept
+  {
+    switch (precision)
+    {
+    case Precision::bf16:
+      return "bf16";
+    case Precision::f16:
+      return "f16";
+    case Precision::f32:
+      return "f32";
+    case Precision::f64:
+      return "f64";
+    case Precision::f80:
+      return "f80";
+    case Precision::f64f64:
+      return "f64f64";
+    case Precision::f128:
+      return "f128";
+    default:
+      return "<invalid precision>";
+    }
+  }
+
   /// @brief Alignment of a data type
   enum class Alignment : std::size_t
   {
@@ -92,6 +120,24 @@ AFFT_EXPORT namespace afft
     sve    = simd2048, ///< SVE alignment
   };
 
+  /// @brief Huge page policy of large CPU allocations
+  enum class HugePagePolicy : std::uint8_t
+  {
+    none,        ///< regular pages
+    transparent, ///< 2 MiB aligned memory advised to be backed by transparent huge pages
+    huge2MiB,    ///< explicit 2 MiB huge pages, falls back to transparent huge pages if none are available
+    huge1GiB,    ///< explicit 1 GiB huge pages, falls back to transparent huge pages if none are available
+  };
+
+  /// @brief Transport of the data exchanged between the processes of distributed GPU transforms
+  enum class Transport : std::uint8_t
+  {
+    automatic,  ///< GPU aware MPI if the MPI library supports it, host staged MPI otherwise
+    hostStaged, ///< MPI exchanging copies of the data in host memory
+    gpuAware,   ///< MPI exchanging the GPU memory directly
+    nccl,       ///< NCCL (RCCL on HIP) all-to-all
+  };
+
   /// @brief Complexity of a data type
   enum class Complexity : std::uint8_t
   {
@@ -120,6 +166,7 @@ AFFT_EXPORT namespace afft
     inPlace,                 ///< in-place transform
     outOfPlace,              ///< out-of-place transform
     notInPlace = outOfPlace, ///< alias for outOfPlace transform
+    automatic,               ///< out-of-place transform, computed in-place in the destination if it is faster or fits the memory budget, spst cpu only
   };
 
   /// @brief Transform type
@@ -38,16 +38,17 @@
 # define AFFT_MAX_DIM_COUNT     4
 #endif
 
-#if defined(AFFT_ENABLE_CUDA) && !defined(AFFT_ENABLE_HIP) && !defined(AFFT_ENABLE_OPENCL)
+#if defined(AFFT_ENABLE_CUDA) && !defined(AFFT_ENABLE_HIP) && !defined(AFFT_ENABLE_OPENCL) && !defined(AFFT_ENABLE_SYCL)
 # ifndef AFFT_CUDA_ROOT_DIR
 #   error "AFFT_CUDA_ROOT_DIR must be defined"
 # endif
-#elif !defined(AFFT_ENABLE_CUDA) && defined(AFFT_ENABLE_HIP) && !defined(AFFT_ENABLE_OPENCL)
+#elif !defined(AFFT_ENABLE_CUDA) && defined(AFFT_ENABLE_HIP) && !defined(AFFT_ENABLE_OPENCL) && !defined(AFFT_ENABLE_SYCL)
 # ifndef AFFT_HIP_ROOT_DIR
 #   error "AFFT_HIP_ROOT_DIR must be defined"
 # endif
-#elif !defined(AFFT_ENABLE_CUDA) && !defined(AFFT_ENABLE_HIP) && defined(AFFT_ENABLE_OPENCL)
-#elif !defined(AFFT_ENABLE_CUDA) && !defined(AFFT_ENABLE_HIP) && !defined(AFFT_ENABLE_OPENCL)
+#elif !defined(AFFT_ENABLE_CUDA) && !defined(AFFT_ENABLE_HIP) && defined(AFFT_ENABLE_OPENCL) && !defined(AFFT_ENABLE_SYCL)
+#elif !defined(AFFT_ENABLE_CUDA) && !defined(AFFT_ENABLE_HIP) && !defined(AFFT_ENABLE_OPENCL) && defined(AFFT_ENABLE_SYCL)
+#elif !defined(AFFT_ENABLE_CUDA) && !defined(AFFT_ENABLE_HIP) && !defined(AFFT_ENABLE_OPENCL) && !defined(AFFT_ENABLE_SYCL)
 # define AFFT_DISABLE_GPU
 #else
 # error "Exactly one GPU backend must be enabled"
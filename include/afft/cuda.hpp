@@ -37,6 +37,17 @@ AFFT_EXPORT namespace afft::cuda
   {
     return detail::cuda::getCurrentDevice();
   }
+
+  /**
+   * @brief Set the directory where the runtime compiled kernels are cached across processes. The directory must exist.
+   *        The cached kernels are the normalization callbacks of the cuFFT multi-GPU plans, spst cuFFT plans are not
+   *        created by makePlan().
+   * @param directory The cache directory, empty directory disables the on-disk cache.
+   */
+  inline void setRtcCacheDirectory(std::string_view directory)
+  {
+    detail::cuda::ModuleCache::getInstance().setDirectory(directory);
+  }
 } // namespace afft::cuda
 
 #endif /* AFFT_CUDA_HPP */
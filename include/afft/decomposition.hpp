@@ -0,0 +1,297 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DECOMPOSITION_HPP
+#define AFFT_DECOMPOSITION_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "architecture.hpp"
+#ifdef AFFT_ENABLE_MPI
+# include "detail/mpi/mpi.hpp"
+#endif
+
+namespace afft::detail
+{
+  /**
+   * @brief Split an axis into consecutive parts of sizes proportional to the weights. Equal weights give sizes
+   *        differing by at most one, the remainder is spread over the parts instead of landing on a single one.
+   * @param size Size of the axis.
+   * @param weights Weights of the parts, their sum must be positive.
+   * @return The part boundaries, weights.size() + 1 values from 0 to size.
+   */
+  [[nodiscard]] inline std::vector<std::size_t> splitAxis(std::size_t size, View<double> weights)
+  {
+    const double totalWeight = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+    std::vector<std::size_t> bounds(weights.size() + 1);
+
+    double prefixWeight{};
+
+    for (std::size_t i{}; i < weights.size(); ++i)
+    {
+      prefixWeight += weights[i];
+
+      const auto bound = static_cast<std::size_t>(std::llround(static_cast<double>(size) * prefixWeight / totalWeight));
+
+      bounds[i + 1] = std::clamp(bound, bounds[i], size);
+    }
+
+    bounds.back() = size;
+
+    return bounds;
+  }
+
+  /**
+   * @brief Find the process grid over the split axes minimizing the largest block volume, ties are broken by the
+   *        smallest block surface, which bounds the data the block exchanges.
+   * @param shape Global shape.
+   * @param splitAxes Split axes.
+   * @param processCount Number of processes.
+   * @return The number of processes along each split axis.
+   */
+  [[nodiscard]] inline MaxDimArray<std::size_t>
+  findProcessGrid(View<std::size_t> shape, View<std::size_t> splitAxes, std::size_t processCount)
+  {
+    const std::size_t splitRank = splitAxes.size();
+
+    MaxDimArray<std::size_t> grid{};
+    MaxDimArray<std::size_t> bestGrid{};
+    double                   bestVolume{std::numeric_limits<double>::infinity()};
+    double                   bestSurface{std::numeric_limits<double>::infinity()};
+
+    auto evaluate = [&]()
+    {
+      MaxDimArray<std::size_t> extents{};
+      std::copy(shape.begin(), shape.end(), extents.begin());
+
+      for (std::size_t i{}; i < splitRank; ++i)
+      {
+        extents[splitAxes[i]] = (shape[splitAxes[i]] + grid[i] - 1) / grid[i];
+      }
+
+      const double volume = std::accumulate(extents.begin(), extents.begin() + shape.size(), 1.0, std::multiplies<>{});
+
+      double surface{};
+
+      for (std::size_t i{}; i < shape.size(); ++i)
+      {
+        surface += (extents[i] > 0) ? volume / static_cast<double>(extents[i]) : 0.0;
+      }
+
+      if (volume < bestVolume || (volume == bestVolume && surface < bestSurface))
+      {
+        bestVolume  = volume;
+        bestSurface = surface;
+        bestGrid    = grid;
+      }
+    };
+
+    // enumerate the ordered factorizations of the process count
+    auto factorize = [&](auto& self, std::size_t axis, std::size_t remaining) -> void
+    {
+      if (axis + 1 == splitRank)
+      {
+        grid[axis] = remaining;
+        evaluate();
+        return;
+      }
+
+      for (std::size_t factor{1}; factor <= remaining; ++factor)
+      {
+        if (remaining % factor == 0)
+        {
+          grid[axis] = factor;
+          self(self, axis + 1, remaining / factor);
+        }
+      }
+    };
+
+    factorize(factorize, 0, processCount);
+
+    return bestGrid;
+  }
+} // namespace afft::detail
+
+AFFT_EXPORT namespace afft::mpst
+{
+  /// @brief Block of a distributed array owning its starts and sizes
+  struct Block
+  {
+    std::vector<std::size_t> starts{}; ///< starts of the block
+    std::vector<std::size_t> sizes{};  ///< sizes of the block
+
+    /**
+     * @brief Get the memory block viewing the starts and sizes, the strides are the default ones.
+     * @return The memory block, valid while the block is alive.
+     */
+    [[nodiscard]] MemoryBlock<> getMemoryBlock() const noexcept
+    {
+      return MemoryBlock<>{View<std::size_t>{starts.data(), starts.size()},
+                           View<std::size_t>{sizes.data(), sizes.size()},
+                           {}};
+    }
+  };
+
+  /**
+   * @brief Make the blocks of processes of the given relative throughputs decomposing the global shape. The processes
+   *        form a grid over the split axes, e.g. one split axis makes slabs and two make pencils, the first split
+   *        axis varies the slowest with the process index. The grid minimizes the largest block volume and then the
+   *        block surface. Along each split axis the extents are proportional to the summed throughputs of the
+   *        processes in the grid slices, so equal throughputs give extents differing by at most one.
+   * @param shape Global shape.
+   * @param throughputs Relative throughput of each process, the number of processes is their count.
+   * @param splitAxes Axes split among the processes.
+   * @return The block of each process.
+   */
+  [[nodiscard]] inline std::vector<Block>
+  makeBalancedBlocks(View<std::size_t> shape, View<double> throughputs, View<std::size_t> splitAxes)
+  {
+    const std::size_t rank         = shape.size();
+    const std::size_t processCount = throughputs.size();
+
+    if (rank == 0 || rank > maxDimCount)
+    {
+      throw std::invalid_argument{"decomposed shape rank must be between 1 and maxDimCount"};
+    }
+
+    if (processCount == 0)
+    {
+      throw std::invalid_argument{"decomposition requires at least one process"};
+    }
+
+    if (splitAxes.empty() || splitAxes.size() > rank)
+    {
+      throw std::invalid_argument{"decomposition requires between 1 and rank split axes"};
+    }
+
+    std::bitset<maxDimCount> seenAxes{};
+
+    for (const auto axis : splitAxes)
+    {
+      if (axis >= rank || seenAxes.test(axis))
+      {
+        throw std::invalid_argument{"split axes must be unique axes of the shape"};
+      }
+
+      seenAxes.set(axis);
+    }
+
+    if (std::any_of(throughputs.begin(), throughputs.end(), [](double t) { return !std::isfinite(t) || t < 0.0; }) ||
+        std::accumulate(throughputs.begin(), throughputs.end(), 0.0) <= 0.0)
+    {
+      throw std::invalid_argument{"process throughputs must be non-negative and not all zero"};
+    }
+
+    const std::size_t splitRank = splitAxes.size();
+    const auto        grid      = detail::findProcessGrid(shape, splitAxes, processCount);
+
+    // grid coordinate of the process along the split axis
+    auto getCoord = [&](std::size_t process, std::size_t i)
+    {
+      for (std::size_t j = splitRank; j-- > i + 1;)
+      {
+        process /= grid[j];
+      }
+
+      return process % grid[i];
+    };
+
+    std::vector<std::vector<std::size_t>> bounds(splitRank);
+
+    for (std::size_t i{}; i < splitRank; ++i)
+    {
+      std::vector<double> sliceThroughputs(grid[i]);
+
+      for (std::size_t p{}; p < processCount; ++p)
+      {
+        sliceThroughputs[getCoord(p, i)] += throughputs[p];
+      }
+
+      // slices of no throughput are left empty, unless all are
+      if (std::all_of(sliceThroughputs.begin(), sliceThroughputs.end(), [](double t) { return t == 0.0; }))
+      {
+        std::fill(sliceThroughputs.begin(), sliceThroughputs.end(), 1.0);
+      }
+
+      bounds[i] = detail::splitAxis(shape[splitAxes[i]],
+                                    View<double>{sliceThroughputs.data(), sliceThroughputs.size()});
+    }
+
+    std::vector<Block> blocks(processCount);
+
+    for (std::size_t p{}; p < processCount; ++p)
+    {
+      auto& block = blocks[p];
+
+      block.starts.assign(rank, 0);
+      block.sizes.assign(shape.begin(), shape.end());
+
+      for (std::size_t i{}; i < splitRank; ++i)
+      {
+        const std::size_t coord = getCoord(p, i);
+
+        block.starts[splitAxes[i]] = bounds[i][coord];
+        block.sizes[splitAxes[i]]  = bounds[i][coord + 1] - bounds[i][coord];
+      }
+    }
+
+    return blocks;
+  }
+
+#ifdef AFFT_ENABLE_MPI
+  /**
+   * @brief Make the blocks of the processes of the communicator decomposing the global shape, collective over the
+   *        communicator. See makeBalancedBlocks() above, the block of a process is at its rank.
+   * @param shape Global shape.
+   * @param comm MPI communicator.
+   * @param splitAxes Axes split among the processes.
+   * @param throughput Relative throughput of the calling process.
+   * @return The block of each process of the communicator.
+   */
+  [[nodiscard]] inline std::vector<Block>
+  makeBalancedBlocks(View<std::size_t> shape, MPI_Comm comm, View<std::size_t> splitAxes, double throughput = 1.0)
+  {
+    if (!detail::mpi::isValidComm(comm))
+    {
+      throw std::invalid_argument{"invalid MPI communicator"};
+    }
+
+    int commSize{};
+
+    detail::mpi::checkError(MPI_Comm_size(comm, &commSize));
+
+    std::vector<double> throughputs(static_cast<std::size_t>(commSize));
+
+    detail::mpi::checkError(MPI_Allgather(&throughput, 1, MPI_DOUBLE, throughputs.data(), 1, MPI_DOUBLE, comm));
+
+    return makeBalancedBlocks(shape, View<double>{throughputs.data(), throughputs.size()}, splitAxes);
+  }
+#endif /* AFFT_ENABLE_MPI */
+} // namespace afft::mpst
+
+#endif /* AFFT_DECOMPOSITION_HPP */
@@ -0,0 +1,247 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_ALIGNMENT_DISPATCH_PLAN_HPP
+#define AFFT_DETAIL_ALIGNMENT_DISPATCH_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Get the alignment every buffer of a spst cpu plan has, the largest power of two dividing the size of one
+   *        element of each buffer, a half of the complex element for planar format.
+   * @param desc Plan description.
+   * @return Alignment in bytes.
+   */
+  [[nodiscard]] inline std::size_t getElemAlignment(const Desc& desc)
+  {
+    const bool isPlanar           = (desc.getComplexFormat() == ComplexFormat::planar);
+    const auto [srcCmpl, dstCmpl] = desc.getSrcDstComplexity();
+
+    const std::size_t srcElemSize = desc.sizeOfSrcElem() / ((isPlanar && srcCmpl == Complexity::complex) ? 2 : 1);
+    const std::size_t dstElemSize = desc.sizeOfDstElem() / ((isPlanar && dstCmpl == Complexity::complex) ? 2 : 1);
+
+    auto lowestBit = [](std::size_t value)
+    {
+      return value & (~value + 1);
+    };
+
+    return std::min(lowestBit(srcElemSize), lowestBit(dstElemSize));
+  }
+
+  /**
+   * @brief Get the alignment the plan assumes for its buffers.
+   * @param desc Plan description.
+   * @return Alignment in bytes.
+   */
+  [[nodiscard]] inline std::size_t getPlanAlignment(const Desc& desc)
+  {
+    const auto alignment = desc.getArchDesc<Target::cpu, Distribution::spst>().alignment;
+
+    return cxx::to_underlying((alignment == Alignment{}) ? cpu::getDefaultAlignment() : alignment);
+  }
+
+  /**
+   * @brief Check if a spst cpu plan accepting unaligned buffers needs a second plan for them. Plans assuming only the
+   *        element alignment already accept any buffer.
+   * @param desc Plan description.
+   * @return True if the alignment dispatch plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isAlignmentDispatchLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu || desc.getDistribution() != Distribution::spst)
+    {
+      return false;
+    }
+
+    return desc.getArchDesc<Target::cpu, Distribution::spst>().acceptUnaligned &&
+           getPlanAlignment(desc) > getElemAlignment(desc);
+  }
+
+  /**
+   * @brief Make the description of the plan executing the buffers meeting the plan alignment.
+   * @param desc Plan description accepting unaligned buffers.
+   * @return Plan description of the aligned plan.
+   */
+  [[nodiscard]] inline Desc makeAlignedDesc(const Desc& desc)
+  {
+    Desc alignedDesc{desc};
+
+    alignedDesc.getArchDesc<Target::cpu, Distribution::spst>().acceptUnaligned = false;
+
+    return alignedDesc;
+  }
+
+  /**
+   * @brief Make the description of the plan executing the buffers not meeting the plan alignment.
+   * @param desc Plan description accepting unaligned buffers.
+   * @return Plan description assuming only the element alignment.
+   */
+  [[nodiscard]] inline Desc makeUnalignedDesc(const Desc& desc)
+  {
+    Desc unalignedDesc{desc};
+
+    auto& cpuDesc = unalignedDesc.getArchDesc<Target::cpu, Distribution::spst>();
+    cpuDesc.alignment       = static_cast<Alignment>(getElemAlignment(desc));
+    cpuDesc.acceptUnaligned = false;
+
+    return unalignedDesc;
+  }
+
+  /**
+   * @class AlignmentDispatchPlan
+   * @brief Plan holding a plan built for the requested alignment and a plan assuming only the element alignment. Each
+   *        execution checks the actual buffer pointers and runs the aligned plan if all of them meet the alignment,
+   *        otherwise the unaligned one. One plan thus serves views at arbitrary offsets into larger arrays. Only spst
+   *        cpu plans are supported.
+   */
+  class AlignmentDispatchPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param desc Plan description accepting unaligned buffers.
+       * @param alignedPlan Plan created from makeAlignedDesc(desc).
+       * @param unalignedPlan Plan created from makeUnalignedDesc(desc).
+       */
+      AlignmentDispatchPlan(const Desc& desc, std::unique_ptr<Plan> alignedPlan, std::unique_ptr<Plan> unalignedPlan)
+      : Plan{desc},
+        mAlignedPlan{std::move(alignedPlan)},
+        mUnalignedPlan{std::move(unalignedPlan)},
+        mAlignment{getPlanAlignment(desc)}
+      {
+        if (!mAlignedPlan || !mUnalignedPlan)
+        {
+          throw std::invalid_argument{"Aligned and unaligned plans must not be null"};
+        }
+
+        // Either plan may execute with the external workspace, so it must fit both of them
+        const auto alignedWorkspaceSize   = mAlignedPlan->getWorkspaceSize();
+        const auto unalignedWorkspaceSize = mUnalignedPlan->getWorkspaceSize();
+
+        mWorkspaceSize.resize(std::max(alignedWorkspaceSize.size(), unalignedWorkspaceSize.size()));
+
+        for (std::size_t i{}; i < mWorkspaceSize.size(); ++i)
+        {
+          mWorkspaceSize[i] = std::max((i < alignedWorkspaceSize.size()) ? alignedWorkspaceSize[i] : 0,
+                                       (i < unalignedWorkspaceSize.size()) ? unalignedWorkspaceSize[i] : 0);
+        }
+
+        for (const auto& plan : {mAlignedPlan.get(), mUnalignedPlan.get()})
+        {
+          const auto planMemorySize = plan->getBackendMemorySize();
+
+          mBackendMemorySize += planMemorySize.empty() ? 0 : planMemorySize.front();
+        }
+      }
+
+      /// @brief Destructor.
+      ~AlignmentDispatchPlan() override = default;
+
+      /**
+       * @brief Get backend of the aligned plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mAlignedPlan->getBackend();
+      }
+
+      /**
+       * @brief Get the workspace size fitting both plans.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return View<std::size_t>{mWorkspaceSize.data(), mWorkspaceSize.size()};
+      }
+
+      /**
+       * @brief Get the memory held by both plans.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the aligned plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mAlignedPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        feedback += "unaligned buffers executed by a ";
+        feedback += toString(mUnalignedPlan->getBackend());
+        feedback += " plan";
+
+        return feedback;
+      }
+
+    protected:
+      /**
+       * @brief Execute the aligned plan if all the buffers meet the alignment, otherwise the unaligned plan.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        auto isAligned = [alignment = mAlignment](void* ptr)
+        {
+          return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+        };
+
+        const bool useAlignedPlan = std::all_of(src.begin(), src.end(), isAligned) &&
+                                    std::all_of(dst.begin(), dst.end(), isAligned);
+
+        executeBackendImplOf((useAlignedPlan) ? *mAlignedPlan : *mUnalignedPlan, src, dst, execParams);
+      }
+
+    private:
+      std::unique_ptr<Plan>    mAlignedPlan{};       ///< The plan for the buffers meeting the alignment.
+      std::unique_ptr<Plan>    mUnalignedPlan{};     ///< The plan assuming only the element alignment.
+      std::size_t              mAlignment{};         ///< The alignment of the aligned plan in bytes.
+      std::vector<std::size_t> mWorkspaceSize{};     ///< The workspace size fitting both plans.
+      std::size_t              mBackendMemorySize{}; ///< The memory held by both plans.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_ALIGNMENT_DISPATCH_PLAN_HPP */
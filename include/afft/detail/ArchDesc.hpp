@@ -165,6 +165,20 @@ namespace afft::detail
         return Span<std::size_t>{mDstStrides.data(), mShapeRank};
       }
 
+      /// @brief Reset the source strides to the default contiguous ones.
+      constexpr void resetSrcStrides() noexcept
+      {
+        mSrcStrides           = {};
+        mHasDefaultSrcStrides = true;
+      }
+
+      /// @brief Reset the destination strides to the default contiguous ones.
+      constexpr void resetDstStrides() noexcept
+      {
+        mDstStrides           = {};
+        mHasDefaultDstStrides = true;
+      }
+
       /**
        * @brief Get the memory layout.
        * @return Memory layout.
@@ -177,18 +191,25 @@ namespace afft::detail
         return memLayout;
       }
 
-      // [[nodiscard]] friend bool operator==(const SpstMemoryLayout& lhs, const SpstMemoryLayout& rhs) noexcept
-      // {
-      //   return std::equal(lhs.getSrcStrides().begin(), lhs.getSrcStrides().end(),
-      //                     rhs.getSrcStrides().begin(), rhs.getSrcStrides().end()) &&
-      //          std::equal(lhs.getDstStrides().begin(), lhs.getDstStrides().end(),
-      //                     rhs.getDstStrides().begin(), rhs.getDstStrides().end());
-      // }
+      /**
+       * @brief Equality operator. Compares the stored strides, default strides should be filled before comparison.
+       * @param lhs Left-hand side.
+       * @param rhs Right-hand side.
+       * @return True if equal, false otherwise.
+       */
+      [[nodiscard]] friend bool operator==(const SpstMemoryLayout& lhs, const SpstMemoryLayout& rhs) noexcept
+      {
+        return std::equal(lhs.getSrcStrides().begin(), lhs.getSrcStrides().end(),
+                          rhs.getSrcStrides().begin(), rhs.getSrcStrides().end()) &&
+               std::equal(lhs.getDstStrides().begin(), lhs.getDstStrides().end(),
+                          rhs.getDstStrides().begin(), rhs.getDstStrides().end());
+      }
 
-      // [[nodiscard]] friend bool operator!=(const SpstMemoryLayout& lhs, const SpstMemoryLayout& rhs) noexcept
-      // {
-      //   return !(lhs == rhs);
-      // }
+      /// @brief Inequality operator.
+      [[nodiscard]] friend bool operator!=(const SpstMemoryLayout& lhs, const SpstMemoryLayout& rhs) noexcept
+      {
+        return !(lhs == rhs);
+      }
 
     private:
       std::size_t              mShapeRank{};                ///< Shape rank.
@@ -249,6 +270,7 @@ namespace afft::detail
             if (srcBlocks[i].strides.size() == shapeRank)
             {
               std::copy(srcBlocks[i].strides.begin(), srcBlocks[i].strides.end(), mData[i].mSrcStrides.begin());
+              mData[i].mHasDefaultSrcStrides = false;
             }
             else if (srcBlocks[i].strides.empty())
             {
@@ -296,6 +318,7 @@ namespace afft::detail
             if (dstBlocks[i].strides.size() == shapeRank)
             {
               std::copy(dstBlocks[i].strides.begin(), dstBlocks[i].strides.end(), mData[i].mDstStrides.begin());
+              mData[i].mHasDefaultDstStrides = false;
             }
             else if (dstBlocks[i].strides.empty())
             {
@@ -663,18 +686,50 @@ namespace afft::detail
         memLayout.dstAxesOrder = getDstAxesOrder();
         return memLayout;
       }
+
+      /**
+       * @brief Equality operator.
+       * @param lhs Left-hand side.
+       * @param rhs Right-hand side.
+       * @return True if equal, false otherwise.
+       */
+      [[nodiscard]] friend bool operator==(const SpmtMemoryLayout& lhs, const SpmtMemoryLayout& rhs) noexcept
+      {
+        return lhs.mShapeRank == rhs.mShapeRank &&
+               lhs.mData == rhs.mData &&
+               lhs.mSrcAxesOrder == rhs.mSrcAxesOrder &&
+               lhs.mDstAxesOrder == rhs.mDstAxesOrder;
+      }
+
+      /// @brief Inequality operator.
+      [[nodiscard]] friend bool operator!=(const SpmtMemoryLayout& lhs, const SpmtMemoryLayout& rhs) noexcept
+      {
+        return !(lhs == rhs);
+      }
     private:
       /// @brief Per target data.
       struct PerTargetData
       {
+        /// @brief Equality operator, the default flags are not compared.
+        [[nodiscard]] friend bool operator==(const PerTargetData& lhs, const PerTargetData& rhs) noexcept
+        {
+          return lhs.mSrcStarts == rhs.mSrcStarts &&
+                 lhs.mSrcSizes == rhs.mSrcSizes &&
+                 lhs.mSrcStrides == rhs.mSrcStrides &&
+                 lhs.mDstStarts == rhs.mDstStarts &&
+                 lhs.mDstSizes == rhs.mDstSizes &&
+                 lhs.mDstStrides == rhs.mDstStrides;
+        }
+
+
         MaxDimArray<std::size_t> mSrcStarts{};            ///< Source starts.
         MaxDimArray<std::size_t> mSrcSizes{};             ///< Source sizes.
         MaxDimArray<std::size_t> mSrcStrides{};           ///< Source strides.
         MaxDimArray<std::size_t> mDstStarts{};            ///< Destination starts.
         MaxDimArray<std::size_t> mDstSizes{};             ///< Destination sizes.
         MaxDimArray<std::size_t> mDstStrides{};           ///< Destination strides.
-        bool                     mHasDefaultSrcStrides{}; ///< Has default source strides.
-        bool                     mHasDefaultDstStrides{}; ///< Has default destination strides.
+        bool                     mHasDefaultSrcStrides{true}; ///< Has default source strides.
+        bool                     mHasDefaultDstStrides{true}; ///< Has default destination strides.
       };
 
       std::size_t                mShapeRank{};                 ///< Shape rank.
@@ -1079,6 +1134,31 @@ namespace afft::detail
         memLayout.dstAxesOrder = getDstAxesOrder();
         return memLayout;
       }
+
+      /**
+       * @brief Equality operator.
+       * @param lhs Left-hand side.
+       * @param rhs Right-hand side.
+       * @return True if equal, false otherwise.
+       */
+      [[nodiscard]] friend bool operator==(const MpstMemoryLayout& lhs, const MpstMemoryLayout& rhs) noexcept
+      {
+        return lhs.mShapeRank == rhs.mShapeRank &&
+               lhs.mSrcStarts == rhs.mSrcStarts &&
+               lhs.mSrcSizes == rhs.mSrcSizes &&
+               lhs.mSrcStrides == rhs.mSrcStrides &&
+               lhs.mDstStarts == rhs.mDstStarts &&
+               lhs.mDstSizes == rhs.mDstSizes &&
+               lhs.mDstStrides == rhs.mDstStrides &&
+               lhs.mSrcAxesOrder == rhs.mSrcAxesOrder &&
+               lhs.mDstAxesOrder == rhs.mDstAxesOrder;
+      }
+
+      /// @brief Inequality operator.
+      [[nodiscard]] friend bool operator!=(const MpstMemoryLayout& lhs, const MpstMemoryLayout& rhs) noexcept
+      {
+        return !(lhs == rhs);
+      }
     private:
       std::size_t              mShapeRank{};                 ///< Shape rank.
       MaxDimArray<std::size_t> mSrcStarts{};                 ///< Source starts.
@@ -1100,23 +1180,159 @@ namespace afft::detail
   /// @brief Describes the spst cpu target.
   struct SpstCpuDesc
   {
-    SpstMemoryLayout memoryLayout{}; ///< Memory layout.
-    Alignment        alignment{};    ///< Alignment.
-    unsigned         threadLimit{};  ///< Thread limit.
+    SpstMemoryLayout memoryLayout{};        ///< Memory layout.
+    Alignment        alignment{};           ///< Alignment.
+    bool             acceptUnaligned{};     ///< Accept buffers of any alignment.
+    bool             unpaddedInPlaceReal{}; ///< In-place real data is not padded.
+    unsigned         threadLimit{};         ///< Thread limit, the selected one for the automatic thread limit.
+    bool             autoThreadLimit{};     ///< Select the thread limit from the transform size.
+    unsigned         maxThreadLimit{};      ///< Upper bound of the automatic thread limit, 0 for no limit.
+    bool             numaSplit{};           ///< Split the batch per NUMA node.
+    HugePagePolicy   hugePagePolicy{};      ///< Huge page policy for the scratch buffers.
+    bool             realtime{};            ///< Allocation and lock free execution on the calling thread.
+    std::size_t      memoryBudget{};        ///< Memory budget of the automatic placement.
+    bool             sparseLines{};         ///< Skip the zero lines along the first transform axis.
+
+    /// @brief Equality operator, ignores the selected automatic thread limit.
+    [[nodiscard]] friend bool operator==(const SpstCpuDesc& lhs, const SpstCpuDesc& rhs) noexcept
+    {
+      return lhs.memoryLayout == rhs.memoryLayout &&
+             lhs.alignment == rhs.alignment &&
+             lhs.acceptUnaligned == rhs.acceptUnaligned &&
+             lhs.unpaddedInPlaceReal == rhs.unpaddedInPlaceReal &&
+             lhs.autoThreadLimit == rhs.autoThreadLimit &&
+             ((lhs.autoThreadLimit) ? lhs.maxThreadLimit == rhs.maxThreadLimit : lhs.threadLimit == rhs.threadLimit) &&
+             lhs.numaSplit == rhs.numaSplit &&
+             lhs.hugePagePolicy == rhs.hugePagePolicy &&
+             lhs.realtime == rhs.realtime &&
+             lhs.memoryBudget == rhs.memoryBudget &&
+             lhs.sparseLines == rhs.sparseLines;
+    }
+
+    /// @brief Inequality operator.
+    [[nodiscard]] friend bool operator!=(const SpstCpuDesc& lhs, const SpstCpuDesc& rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
+  };
+
+  /// @brief Describes a spst gpu user callback, owns the source code.
+  struct SpstGpuCallbackDesc
+  {
+    std::string srcCode{};      ///< Source code.
+    std::string functionName{}; ///< Function name.
+    void*       devicePtr{};    ///< Device function pointer.
+    void*       callerInfo{};   ///< Caller info.
+
+    /**
+     * @brief Make the callback description.
+     * @param callback The callback.
+     * @return The callback description.
+     */
+    [[nodiscard]] static SpstGpuCallbackDesc make(const spst::gpu::Callback& callback)
+    {
+      if (!callback.srcCode.empty() && callback.devicePtr != nullptr)
+      {
+        throw std::invalid_argument{"callback cannot have both source code and device pointer"};
+      }
+
+      if (!callback.srcCode.empty() && callback.functionName.empty())
+      {
+        throw std::invalid_argument{"callback source code requires a function name"};
+      }
+
+      return SpstGpuCallbackDesc{std::string{callback.srcCode},
+                                 std::string{callback.functionName},
+                                 callback.devicePtr,
+                                 callback.callerInfo};
+    }
+
+    /**
+     * @brief Is the callback enabled?
+     * @return True if the callback is enabled, false otherwise.
+     */
+    [[nodiscard]] bool isEnabled() const noexcept
+    {
+      return !srcCode.empty() || devicePtr != nullptr;
+    }
+
+    /**
+     * @brief Get the callback view.
+     * @return The callback view.
+     */
+    [[nodiscard]] spst::gpu::Callback getView() const noexcept
+    {
+      return spst::gpu::Callback{srcCode, functionName, devicePtr, callerInfo};
+    }
+
+    /// @brief Equality operator.
+    [[nodiscard]] friend bool operator==(const SpstGpuCallbackDesc& lhs, const SpstGpuCallbackDesc& rhs) noexcept
+    {
+      return lhs.srcCode == rhs.srcCode &&
+             lhs.functionName == rhs.functionName &&
+             lhs.devicePtr == rhs.devicePtr &&
+             lhs.callerInfo == rhs.callerInfo;
+    }
+
+    /// @brief Inequality operator.
+    [[nodiscard]] friend bool operator!=(const SpstGpuCallbackDesc& lhs, const SpstGpuCallbackDesc& rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
   };
 
   /// @brief Describes the spst gpu target.
   struct SpstGpuDesc
   {
-    SpstMemoryLayout memoryLayout{}; ///< Memory layout.
+    SpstMemoryLayout    memoryLayout{};  ///< Memory layout.
 # if defined(AFFT_ENABLE_CUDA)
-    int              device{};       ///< CUDA device.
+    int                 device{};        ///< CUDA device.
 # elif defined(AFFT_ENABLE_HIP)
-    int              device{};       ///< HIP device.
+    int                 device{};        ///< HIP device.
 # elif defined(AFFT_ENABLE_OPENCL)
-    cl_context       context{};      ///< OpenCL context.
-    cl_device_id     device{};       ///< OpenCL device.
+    cl_context          context{};       ///< OpenCL context.
+    cl_device_id        device{};        ///< OpenCL device.
+# elif defined(AFFT_ENABLE_SYCL)
+    sycl::queue*        queue{};         ///< SYCL queue, it must outlive the plan.
 # endif
+    SpstGpuCallbackDesc loadCallback{};  ///< Load callback.
+    SpstGpuCallbackDesc storeCallback{}; ///< Store callback.
+
+    /**
+     * @brief Has any user callback?
+     * @return True if the load or the store callback is enabled, false otherwise.
+     */
+    [[nodiscard]] bool hasCallbacks() const noexcept
+    {
+      return loadCallback.isEnabled() || storeCallback.isEnabled();
+    }
+
+    /// @brief Equality operator.
+    [[nodiscard]] friend bool operator==(const SpstGpuDesc& lhs, const SpstGpuDesc& rhs) noexcept
+    {
+      const bool callbacksEqual = lhs.loadCallback == rhs.loadCallback && lhs.storeCallback == rhs.storeCallback;
+
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      return lhs.memoryLayout == rhs.memoryLayout && lhs.device == rhs.device && callbacksEqual;
+#   elif defined(AFFT_ENABLE_OPENCL)
+      return lhs.memoryLayout == rhs.memoryLayout && lhs.context == rhs.context && lhs.device == rhs.device &&
+             callbacksEqual;
+#   elif defined(AFFT_ENABLE_SYCL)
+      // distinct queue objects may refer to the same queue
+      const bool queuesEqual = (lhs.queue == rhs.queue) ||
+                               (lhs.queue != nullptr && rhs.queue != nullptr && *lhs.queue == *rhs.queue);
+
+      return lhs.memoryLayout == rhs.memoryLayout && queuesEqual && callbacksEqual;
+#   else
+      return lhs.memoryLayout == rhs.memoryLayout && callbacksEqual;
+#   endif
+    }
+
+    /// @brief Inequality operator.
+    [[nodiscard]] friend bool operator!=(const SpstGpuDesc& lhs, const SpstGpuDesc& rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
   };
 
   /// @brief Describes the spmt gpu architecture.
@@ -1131,6 +1347,24 @@ namespace afft::detail
     cl_context                context{};      ///< OpenCL context.
     std::vector<cl_device_id> devices{};      ///< OpenCL devices.
 # endif
+
+    /// @brief Equality operator.
+    [[nodiscard]] friend bool operator==(const SpmtGpuDesc& lhs, const SpmtGpuDesc& rhs) noexcept
+    {
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      return lhs.memoryLayout == rhs.memoryLayout && lhs.devices == rhs.devices;
+#   elif defined(AFFT_ENABLE_OPENCL)
+      return lhs.memoryLayout == rhs.memoryLayout && lhs.context == rhs.context && lhs.devices == rhs.devices;
+#   else
+      return lhs.memoryLayout == rhs.memoryLayout;
+#   endif
+    }
+
+    /// @brief Inequality operator.
+    [[nodiscard]] friend bool operator!=(const SpmtGpuDesc& lhs, const SpmtGpuDesc& rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
   };
 
   /// @brief Describes the mpst cpu architecture.
@@ -1142,6 +1376,24 @@ namespace afft::detail
 # endif
     Alignment        alignment{};    ///< Alignment.
     unsigned         threadLimit{};  ///< Thread limit.
+
+    /// @brief Equality operator.
+    [[nodiscard]] friend bool operator==(const MpstCpuDesc& lhs, const MpstCpuDesc& rhs) noexcept
+    {
+      bool equal = lhs.memoryLayout == rhs.memoryLayout &&
+                   lhs.alignment == rhs.alignment &&
+                   lhs.threadLimit == rhs.threadLimit;
+#   if defined(AFFT_ENABLE_MPI)
+      equal = equal && lhs.comm == rhs.comm;
+#   endif
+      return equal;
+    }
+
+    /// @brief Inequality operator.
+    [[nodiscard]] friend bool operator!=(const MpstCpuDesc& lhs, const MpstCpuDesc& rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
   };
 
   /// @brief Describes the mpst gpu architecture.
@@ -1151,6 +1403,7 @@ namespace afft::detail
 # if defined(AFFT_ENABLE_MPI)
     MPI_Comm         comm{};         ///< MPI communicator.
 # endif
+    Transport        transport{};    ///< Transport of the exchanged data, never automatic.
 # if defined(AFFT_ENABLE_CUDA)
     int              device{};       ///< CUDA device.
 # elif defined(AFFT_ENABLE_HIP)
@@ -1159,6 +1412,27 @@ namespace afft::detail
     cl_context       context{};      ///< OpenCL context.
     cl_device_id     device{};       ///< OpenCL device.
 # endif
+
+    /// @brief Equality operator.
+    [[nodiscard]] friend bool operator==(const MpstGpuDesc& lhs, const MpstGpuDesc& rhs) noexcept
+    {
+      bool equal = lhs.memoryLayout == rhs.memoryLayout && lhs.transport == rhs.transport;
+#   if defined(AFFT_ENABLE_MPI)
+      equal = equal && lhs.comm == rhs.comm;
+#   endif
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      equal = equal && lhs.device == rhs.device;
+#   elif defined(AFFT_ENABLE_OPENCL)
+      equal = equal && lhs.context == rhs.context && lhs.device == rhs.device;
+#   endif
+      return equal;
+    }
+
+    /// @brief Inequality operator.
+    [[nodiscard]] friend bool operator!=(const MpstGpuDesc& lhs, const MpstGpuDesc& rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
   };
 
   /// @brief Architecture description.
@@ -1350,6 +1624,14 @@ namespace afft::detail
         cxx::unreachable();
       }
 
+      /// @brief Check if the plan is a spst cpu realtime plan, executed on the calling thread without allocations or locks.
+      [[nodiscard]] constexpr bool isRealtime() const
+      {
+        return getTarget() == Target::cpu &&
+               getDistribution() == Distribution::spst &&
+               getArchDesc<Target::cpu, Distribution::spst>().realtime;
+      }
+
       /// @brief Get the external workspace flag.
       [[nodiscard]] constexpr bool useExternalWorkspace() const noexcept
       {
@@ -1362,12 +1644,24 @@ namespace afft::detail
         return mComplexFormat;
       }
 
+      /// @brief Set the complex format. Should be used carefully.
+      constexpr void setComplexFormat(ComplexFormat complexFormat) noexcept
+      {
+        mComplexFormat = complexFormat;
+      }
+
       /// @brief Get the preserve source flag.
       [[nodiscard]] constexpr bool getPreserveSource() const noexcept
       {
         return mPreserveSource;
       }
 
+      /// @brief Set the preserve source flag. Should be used carefully.
+      constexpr void setPreserveSource(bool preserveSource) noexcept
+      {
+        mPreserveSource = preserveSource;
+      }
+
       /**
        * @brief Reconstruction of the architecture parameters.
        * @tparam target Target.
@@ -1378,18 +1672,31 @@ namespace afft::detail
       [[nodiscard]] ArchitectureParameters<target, distrib> getArchitectureParameters() const
       {
         ArchitectureParameters<target, distrib> params{};
-        params.complexFormat        = mComplexFormat;
-        params.preserveSource       = mPreserveSource;
-        params.useExternalWorkspace = mUseExternalWorkspace;
+        params.complexFormat  = mComplexFormat;
+        params.preserveSource = mPreserveSource;
+
+        // spst cpu plans never use the external workspace, their flag is a constant
+        if constexpr (target != Target::cpu || distrib != Distribution::spst)
+        {
+          params.useExternalWorkspace = mUseExternalWorkspace;
+        }
 
         if constexpr (target == Target::cpu)
         {
           if constexpr (distrib == Distribution::spst)
           {
             const auto& desc = getArchDesc<Target::cpu, Distribution::spst>();
-            params.memoryLayout = desc.memoryLayout.getView();
-            params.alignment    = desc.alignment;
-            params.threadLimit  = desc.threadLimit;
+            params.memoryLayout        = desc.memoryLayout.getView();
+            params.alignment           = desc.alignment;
+            params.acceptUnaligned     = desc.acceptUnaligned;
+            params.unpaddedInPlaceReal = desc.unpaddedInPlaceReal;
+            params.threadLimit         = desc.threadLimit;
+            params.autoThreadLimit     = desc.autoThreadLimit;
+            params.numaSplit           = desc.numaSplit;
+            params.hugePagePolicy      = desc.hugePagePolicy;
+            params.realtime            = desc.realtime;
+            params.memoryBudget        = desc.memoryBudget;
+            params.sparseLines         = desc.sparseLines;
           }
           else if constexpr (distrib == Distribution::mpst)
           {
@@ -1415,7 +1722,10 @@ namespace afft::detail
 #         elif defined(AFFT_ENABLE_OPENCL)
             params.context = desc.context;
             params.device  = desc.device;
+#         elif defined(AFFT_ENABLE_SYCL)
+            params.queue = desc.queue;
 #         endif
+            params.callbacks = spst::gpu::Callbacks{desc.loadCallback.getView(), desc.storeCallback.getView()};
           }
           else if constexpr (distrib == Distribution::spmt)
           {
@@ -1504,18 +1814,25 @@ namespace afft::detail
         }
       }
 
-      // [[nodiscard]] friend bool operator==(const ArchDesc& lhs, const ArchDesc& rhs) noexcept
-      // {
-      //   return lhs.mComplexFormat == rhs.mComplexFormat &&
-      //          lhs.mPreserveSource == rhs.mPreserveSource &&
-      //          lhs.mUseExternalWorkspace == rhs.mUseExternalWorkspace &&
-      //          lhs.mArchVariant == rhs.mArchVariant;
-      // }
+      /**
+       * @brief Equality operator.
+       * @param lhs Left-hand side.
+       * @param rhs Right-hand side.
+       * @return True if equal, false otherwise.
+       */
+      [[nodiscard]] friend bool operator==(const ArchDesc& lhs, const ArchDesc& rhs) noexcept
+      {
+        return lhs.mComplexFormat == rhs.mComplexFormat &&
+               lhs.mPreserveSource == rhs.mPreserveSource &&
+               lhs.mUseExternalWorkspace == rhs.mUseExternalWorkspace &&
+               lhs.mArchVariant == rhs.mArchVariant;
+      }
 
-      // [[nodiscard]] friend bool operator!=(const ArchDesc& lhs, const ArchDesc& rhs) noexcept
-      // {
-      //   return !(lhs == rhs);
-      // }
+      /// @brief Inequality operator.
+      [[nodiscard]] friend bool operator!=(const ArchDesc& lhs, const ArchDesc& rhs) noexcept
+      {
+        return !(lhs == rhs);
+      }
 
     private:
       /// @brief Architecture variant.
@@ -1546,9 +1863,18 @@ namespace afft::detail
       makeArchVariant(const spst::cpu::Parameters<shapeExt>& params, std::size_t shapeRank)
       {
         SpstCpuDesc desc{};
-        desc.memoryLayout = SpstMemoryLayout{shapeRank, params.memoryLayout};
-        desc.alignment    = params.alignment;
-        desc.threadLimit  = params.threadLimit;
+        desc.memoryLayout        = SpstMemoryLayout{shapeRank, params.memoryLayout};
+        desc.alignment           = params.alignment;
+        desc.acceptUnaligned     = params.acceptUnaligned;
+        desc.unpaddedInPlaceReal = params.unpaddedInPlaceReal;
+        desc.threadLimit         = (params.realtime) ? 1u : params.threadLimit;
+        desc.autoThreadLimit     = params.autoThreadLimit && !params.realtime;
+        desc.maxThreadLimit      = desc.threadLimit;
+        desc.numaSplit           = params.numaSplit;
+        desc.hugePagePolicy      = params.hugePagePolicy;
+        desc.realtime            = params.realtime;
+        desc.memoryBudget        = params.memoryBudget;
+        desc.sparseLines         = params.sparseLines;
 
         return desc;
       }
@@ -1589,7 +1915,15 @@ namespace afft::detail
           throw std::invalid_argument{"invalid CUDA device"};
         }
         desc.device = params.device;
+#     elif defined(AFFT_ENABLE_SYCL)
+        if (params.queue == nullptr || !params.queue->get_device().is_gpu())
+        {
+          throw std::invalid_argument{"invalid SYCL queue, a gpu device queue is required"};
+        }
+        desc.queue = params.queue;
 #     endif
+        desc.loadCallback  = SpstGpuCallbackDesc::make(params.callbacks.load);
+        desc.storeCallback = SpstGpuCallbackDesc::make(params.callbacks.store);
 
         return desc;
       }
@@ -1610,10 +1944,10 @@ namespace afft::detail
         desc.memoryLayout = SpmtMemoryLayout{shapeRank, params.devices.size(), params.memoryLayout};
 #     if defined(AFFT_ENABLE_CUDA)
         desc.devices.resize(targetCount);
-        std::copy(params.devices.begin(), params.devices.end(), desc.devices);
+        std::copy(params.devices.begin(), params.devices.end(), desc.devices.begin());
 #     elif defined(AFFT_ENABLE_HIP)
         desc.devices.resize(targetCount);
-        std::copy(params.devices.begin(), params.devices.end(), desc.devices);
+        std::copy(params.devices.begin(), params.devices.end(), desc.devices.begin());
 #     endif
 
         return desc;
@@ -1632,11 +1966,11 @@ namespace afft::detail
         MpstCpuDesc desc{};
         desc.memoryLayout = MpstMemoryLayout{shapeRank, params.memoryLayout};
 #     if defined(AFFT_ENABLE_MPI)
-        if (!mpi::isValidComm(params.comm))
+        if (!mpi::isValidComm(params.communicator))
         {
           throw std::invalid_argument{"invalid MPI communicator"};
         }
-        desc.comm         = params.comm;
+        desc.comm         = params.communicator;
 #     endif
         desc.alignment    = params.alignment;
         desc.threadLimit  = params.threadLimit;
@@ -1657,12 +1991,22 @@ namespace afft::detail
         MpstGpuDesc desc{};
         desc.memoryLayout = MpstMemoryLayout{shapeRank, params.memoryLayout};
 #     if defined(AFFT_ENABLE_MPI)
-        if (!mpi::isValidComm(params.comm))
+        if (!mpi::isValidComm(params.communicator))
         {
           throw std::invalid_argument{"invalid MPI communicator"};
         }
-        desc.comm         = params.comm;
+        desc.comm         = params.communicator;
 #     endif
+        desc.transport    = validateAndReturn(params.transport);
+
+        if (desc.transport == Transport::automatic)
+        {
+#       if defined(AFFT_ENABLE_MPI)
+          desc.transport = (mpi::isGpuAware()) ? Transport::gpuAware : Transport::hostStaged;
+#       else
+          desc.transport = Transport::hostStaged;
+#       endif
+        }
 #     if defined(AFFT_ENABLE_CUDA)
         if (!cuda::isValidDevice(params.device))
         {
@@ -1699,4 +2043,44 @@ namespace afft::detail
   };
 } // namespace afft::detail
 
+  /// @brief Specialization of std::hash for afft::detail::ArchDesc.
+  template<>
+  struct std::hash<afft::detail::ArchDesc>
+  {
+    [[nodiscard]] std::size_t operator()(const afft::detail::ArchDesc& desc) const noexcept
+    {
+      using namespace afft;
+      using namespace afft::detail;
+
+      std::size_t seed{};
+
+      hashCombine(seed, desc.getTarget());
+      hashCombine(seed, desc.getDistribution());
+      hashCombine(seed, desc.getTargetCount());
+      hashCombine(seed, desc.getComplexFormat());
+
+      switch (desc.getDistribution())
+      {
+      case Distribution::spst:
+      {
+        const auto& memoryLayout = desc.getMemoryLayout<Distribution::spst>();
+        hashCombine(seed, memoryLayout.getSrcStrides());
+        hashCombine(seed, memoryLayout.getDstStrides());
+        break;
+      }
+      case Distribution::mpst:
+      {
+        const auto& memoryLayout = desc.getMemoryLayout<Distribution::mpst>();
+        hashCombine(seed, memoryLayout.getSrcSizes());
+        hashCombine(seed, memoryLayout.getDstSizes());
+        break;
+      }
+      default:
+        break;
+      }
+
+      return seed;
+    }
+  };
+
 #endif /* AFFT_DETAIL_ARCH_DESC_HPP */
@@ -0,0 +1,342 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_BATCH_COUNT_PLAN_HPP
+#define AFFT_DETAIL_BATCH_COUNT_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Get the byte distance between two consecutive transforms along the outermost axis of each buffer.
+   * @param desc Plan description.
+   * @param isSrc True for the source buffers, false for the destination buffers.
+   * @return Distance in bytes.
+   */
+  [[nodiscard]] inline std::size_t getOuterBatchDistance(const Desc& desc, bool isSrc)
+  {
+    const auto  shapeRank    = desc.getShapeRank();
+    const auto& memoryLayout = desc.getMemoryLayout<Distribution::spst>();
+    const auto  complexity   = (isSrc) ? desc.getSrcDstComplexity().first : desc.getSrcDstComplexity().second;
+    const bool  isPlanarCmpl = (desc.getComplexFormat() == ComplexFormat::planar) && (complexity == Complexity::complex);
+    const auto  elemSize     = ((isSrc) ? desc.sizeOfSrcElem() : desc.sizeOfDstElem()) / (isPlanarCmpl ? 2 : 1);
+
+    if (isSrc && !memoryLayout.hasDefaultSrcStrides())
+    {
+      return memoryLayout.getSrcStrides()[0] * elemSize;
+    }
+    else if (!isSrc && !memoryLayout.hasDefaultDstStrides())
+    {
+      return memoryLayout.getDstStrides()[0] * elemSize;
+    }
+
+    const auto shape = (isSrc) ? desc.getSrcShape() : desc.getDstShape();
+
+    return std::accumulate(shape.begin() + 1, shape.begin() + shapeRank, elemSize, std::multiplies<>{});
+  }
+
+  /**
+   * @class BatchCountPlan
+   * @brief Plan executing only the first transforms along the outermost batch axis when the execution parameters
+   *        request a smaller batch count. The reduced count is split into power-of-two parts, each executed by a plan
+   *        of the same backend created on the first use and reused afterwards.
+   */
+  class BatchCountPlan final : public Plan
+  {
+    public:
+      /// @brief Function making the plan of the given outermost batch count.
+      using PartPlanFactory = std::function<std::unique_ptr<Plan>(std::size_t)>;
+
+      /**
+       * @brief Constructor.
+       * @param desc Plan description.
+       * @param plan Plan executing the full batch.
+       * @param makePartPlan Function making the plans of the power-of-two batch counts.
+       */
+      BatchCountPlan(const Desc& desc, std::unique_ptr<Plan> plan, PartPlanFactory makePartPlan)
+      : Plan{desc},
+        mPlan{std::move(plan)},
+        mMakePartPlan{std::move(makePartPlan)},
+        mBatchCount{desc.getOuterBatchCount()},
+        mSrcDistance{getOuterBatchDistance(desc, true)},
+        mDstDistance{getOuterBatchDistance(desc, false)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Plan must not be null"};
+        }
+
+        if (!mMakePartPlan)
+        {
+          throw std::invalid_argument{"Part plan factory must not be empty"};
+        }
+
+        std::size_t partPlanCount{};
+
+        while ((std::size_t{1} << partPlanCount) < mBatchCount)
+        {
+          ++partPlanCount;
+        }
+
+        mPartPlans.resize(partPlanCount);
+      }
+
+      /// @brief Destructor.
+      ~BatchCountPlan() override = default;
+
+      /**
+       * @brief Get backend of the plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the full batch plan, the part plans fit into it.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the full batch plan, the part plans are not counted.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return mPlan->getBackendMemorySize();
+      }
+
+      /**
+       * @brief Get the backend feedback of the full batch plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        return mPlan->getBackendFeedback();
+      }
+
+    protected:
+      /**
+       * @brief Execute the requested number of transforms.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        executeParts(src, dst, execParams);
+      }
+
+      /**
+       * @brief Execute the batch, forwarded to the full batch plan if all transforms are requested.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        if (execParams.batchCount == 0 || execParams.batchCount == mBatchCount)
+        {
+          executeBatchBackendImplOf(*mPlan, srcs, dsts, execParams);
+        }
+        else
+        {
+          Plan::executeBatchBackendImpl(srcs, dsts, execParams);
+        }
+      }
+
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      /**
+       * @brief Execute the requested number of transforms.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::gpu::ExecutionParameters& execParams) override
+      {
+        executeParts(src, dst, execParams);
+      }
+
+      /**
+       * @brief Execute the batch, forwarded to the full batch plan if all transforms are requested.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::gpu::ExecutionParameters& execParams) override
+      {
+        if (execParams.batchCount == 0 || execParams.batchCount == mBatchCount)
+        {
+          executeBatchBackendImplOf(*mPlan, srcs, dsts, execParams);
+        }
+        else
+        {
+          Plan::executeBatchBackendImpl(srcs, dsts, execParams);
+        }
+      }
+#   endif
+
+    private:
+      /// @brief Maximum number of buffers of a spst plan, the real and imaginary parts of planar complex data.
+      static constexpr std::size_t maxBufferCount{2};
+
+      /**
+       * @brief Execute the requested number of transforms by the full plan or by the power-of-two part plans.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      template<typename ExecParamsT>
+      void executeParts(View<void*> src, View<void*> dst, const ExecParamsT& execParams)
+      {
+        if (execParams.batchCount == 0 || execParams.batchCount == mBatchCount)
+        {
+          executeBackendImplOf(*mPlan, src, dst, execParams);
+          return;
+        }
+
+        ExecParamsT partExecParams{execParams};
+        partExecParams.batchCount = 0;
+
+        // the line mask of the sparse line plans holds the lines of each transform consecutively
+        std::size_t linesPerBatch{};
+
+        if constexpr (std::is_same_v<ExecParamsT, afft::spst::cpu::ExecutionParameters>)
+        {
+          if (execParams.lineMask.size() % mBatchCount != 0)
+          {
+            throw std::invalid_argument{"line mask size does not match the line count of the plan"};
+          }
+
+          linesPerBatch = execParams.lineMask.size() / mBatchCount;
+        }
+
+        std::array<void*, maxBufferCount> partSrc{};
+        std::array<void*, maxBufferCount> partDst{};
+
+        std::size_t offset{};
+
+        for (std::size_t i = mPartPlans.size(); i-- > 0;)
+        {
+          const std::size_t partCount = std::size_t{1} << i;
+
+          if ((execParams.batchCount & partCount) == 0)
+          {
+            continue;
+          }
+
+          for (std::size_t j{}; j < src.size(); ++j)
+          {
+            partSrc[j] = static_cast<std::byte*>(src[j]) + offset * mSrcDistance;
+          }
+
+          for (std::size_t j{}; j < dst.size(); ++j)
+          {
+            partDst[j] = static_cast<std::byte*>(dst[j]) + offset * mDstDistance;
+          }
+
+          if constexpr (std::is_same_v<ExecParamsT, afft::spst::cpu::ExecutionParameters>)
+          {
+            if (linesPerBatch > 0)
+            {
+              partExecParams.lineMask = execParams.lineMask.subspan(offset * linesPerBatch, partCount * linesPerBatch);
+            }
+          }
+
+          executeBackendImplOf(getPartPlan(i),
+                               View<void*>{partSrc.data(), src.size()},
+                               View<void*>{partDst.data(), dst.size()},
+                               partExecParams);
+
+          offset += partCount;
+        }
+      }
+
+      /**
+       * @brief Get the part plan, make it on the first use.
+       * @param log2Count Binary logarithm of the part batch count.
+       * @return The part plan.
+       */
+      [[nodiscard]] Plan& getPartPlan(std::size_t log2Count)
+      {
+        std::lock_guard lock{mMutex};
+
+        auto& partPlan = mPartPlans[log2Count];
+
+        if (!partPlan)
+        {
+          auto plan = mMakePartPlan(std::size_t{1} << log2Count);
+
+          if (!plan)
+          {
+            throw std::runtime_error{"Failed to create batch count part plan"};
+          }
+
+          const auto workspaceSize     = mPlan->getWorkspaceSize();
+          const auto partWorkspaceSize = plan->getWorkspaceSize();
+
+          if (partWorkspaceSize.size() > workspaceSize.size() ||
+              !std::equal(partWorkspaceSize.begin(), partWorkspaceSize.end(), workspaceSize.begin(), std::less_equal<>{}))
+          {
+            throw std::runtime_error{"Batch count part plan requires a larger workspace than the full plan"};
+          }
+
+          partPlan = std::move(plan);
+        }
+
+        return *partPlan;
+      }
+
+      std::unique_ptr<Plan>              mPlan{};         ///< The full batch plan.
+      PartPlanFactory                    mMakePartPlan{}; ///< Makes the power-of-two batch count plans.
+      std::vector<std::unique_ptr<Plan>> mPartPlans{};    ///< The part plans indexed by the binary logarithm of the count.
+      std::size_t                        mBatchCount{};   ///< The full outermost batch count.
+      std::size_t                        mSrcDistance{};  ///< The source byte distance of consecutive transforms.
+      std::size_t                        mDstDistance{};  ///< The destination byte distance of consecutive transforms.
+      std::mutex                         mMutex{};        ///< Guards the creation of the part plans.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_BATCH_COUNT_PLAN_HPP */
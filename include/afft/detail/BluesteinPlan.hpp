@@ -0,0 +1,307 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_BLUESTEIN_PLAN_HPP
+#define AFFT_DETAIL_BLUESTEIN_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "chirpZ.hpp"
+#include "Desc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Check if a spst cpu plan is a one-dimensional c2c transform of a length with a large prime factor, so a
+   *        Bluestein plan may compute it by power of two transforms.
+   * @param desc Plan description.
+   * @return True if the Bluestein plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isBluesteinLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu ||
+        desc.getDistribution() != Distribution::spst ||
+        desc.getTransform() != Transform::dft ||
+        desc.getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex ||
+        desc.getTransformRank() != 1 ||
+        desc.getComplexFormat() != ComplexFormat::interleaved ||
+        desc.hasLogicalSrcShape() ||
+        desc.hasDstWindow())
+    {
+      return false;
+    }
+
+    const auto precision = desc.getPrecision().execution;
+
+    if (!desc.hasUniformPrecision() || (precision != Precision::f32 && precision != Precision::f64))
+    {
+      return false;
+    }
+
+    return chirpZ::hasLargePrimeFactor(desc.getShape()[desc.getTransformAxes().front()]);
+  }
+
+  /**
+   * @brief Get the fft length of the Bluestein plan.
+   * @param desc Plan description, see isBluesteinLayout().
+   * @return Power of two fft length.
+   */
+  [[nodiscard]] inline std::size_t getBluesteinFftLength(const Desc& desc)
+  {
+    return chirpZ::nextPowerOfTwo(2 * desc.getShape()[desc.getTransformAxes().front()] - 1);
+  }
+
+  /**
+   * @brief Make the description of a power of two plan of the Bluestein plan. It transforms the rows of the work
+   *        buffer in-place without normalization.
+   * @param desc Plan description, see isBluesteinLayout().
+   * @param direction Direction of the power of two plan.
+   * @return Plan description of shape {rowCount, fftLength} transformed along axis 1.
+   */
+  [[nodiscard]] inline Desc makeBluesteinFftDesc(const Desc& desc, Direction direction)
+  {
+    const auto        shape    = desc.getShape();
+    const std::size_t length   = shape[desc.getTransformAxes().front()];
+    const std::size_t rowCount = std::accumulate(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>{}) / length;
+
+    const std::size_t fftShape[]{rowCount, getBluesteinFftLength(desc)};
+    const std::size_t fftAxes[]{1};
+
+    dft::Parameters<> fftParams{};
+    fftParams.direction     = direction;
+    fftParams.precision     = desc.getPrecision();
+    fftParams.shape         = fftShape;
+    fftParams.axes          = fftAxes;
+    fftParams.normalization = Normalization::none;
+    fftParams.placement     = Placement::inPlace;
+    fftParams.type          = dft::Type::complexToComplex;
+
+    auto archParams = desc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+    archParams.memoryLayout = {};
+
+    return Desc{fftParams, archParams};
+  }
+
+  /**
+   * @class BluesteinPlan
+   * @brief Plan computing a one-dimensional c2c transform of a length with a large prime factor by the Bluestein
+   *        algorithm. The transform is a convolution with a chirp computed by power of two transforms, the chirp
+   *        sequences and the kernel spectrum are precomputed. The rows along the transform axis may have any strides.
+   *        Only spst cpu plans are supported. Executions of the plan are serialized, they share the work buffer.
+   */
+  class BluesteinPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the work buffer and computes the kernel spectrum.
+       * @param desc Plan description, see isBluesteinLayout().
+       * @param forwardPlan Plan created from makeBluesteinFftDesc(desc, Direction::forward).
+       * @param backwardPlan Plan created from makeBluesteinFftDesc(desc, Direction::backward).
+       */
+      BluesteinPlan(const Desc& desc, std::unique_ptr<Plan> forwardPlan, std::unique_ptr<Plan> backwardPlan)
+      : Plan{desc}
+      {
+        const auto& cpuDesc   = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  alignment = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+        const auto  shapeRank = desc.getShapeRank();
+        const auto  shape     = desc.getShape();
+        const auto  axis      = desc.getTransformAxes().front();
+        const auto  length    = shape[axis];
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto& memoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+        const auto  srcStrides   = memoryLayout.getSrcStrides();
+        const auto  dstStrides   = memoryLayout.getDstStrides();
+
+        mSrcStride = srcStrides[axis];
+        mDstStride = dstStrides[axis];
+
+        // rows enumerate the indices of the other axes, the last axis varies fastest
+        const std::size_t rowCount = std::accumulate(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>{}) / length;
+
+        mSrcRowOffsets.resize(rowCount);
+        mDstRowOffsets.resize(rowCount);
+
+        for (std::size_t row{}; row < rowCount; ++row)
+        {
+          std::size_t index = row;
+
+          for (std::size_t i = shapeRank; i > 0; --i)
+          {
+            if (i - 1 == axis)
+            {
+              continue;
+            }
+
+            mSrcRowOffsets[row] += (index % shape[i - 1]) * srcStrides[i - 1];
+            mDstRowOffsets[row] += (index % shape[i - 1]) * dstStrides[i - 1];
+            index               /= shape[i - 1];
+          }
+        }
+
+        const auto chirpAngles = chirpZ::makeDftChirpAngles(length, desc.getDirection(), length);
+
+        auto makeEngine = [&](auto real)
+        {
+          using T = decltype(real);
+
+          return chirpZ::Engine<T>{rowCount,
+                                   length,
+                                   length,
+                                   getBluesteinFftLength(desc),
+                                   0.0L,
+                                   chirpAngles,
+                                   desc.getNormalizationFactor<T>(),
+                                   std::move(forwardPlan),
+                                   std::move(backwardPlan),
+                                   alignment,
+                                   cpuDesc.hugePagePolicy,
+                                   cpuDesc.threadLimit};
+        };
+
+        auto setEngine = [&](auto& engine)
+        {
+          mForwardPlan       = &engine.getForwardPlan();
+          mBackendMemorySize = engine.getMemorySize() + (mSrcRowOffsets.size() + mDstRowOffsets.size()) * sizeof(std::size_t);
+        };
+
+        if (desc.getPrecision().execution == Precision::f32)
+        {
+          setEngine(mEngine.emplace<chirpZ::Engine<float>>(makeEngine(float{})));
+        }
+        else
+        {
+          setEngine(mEngine.emplace<chirpZ::Engine<double>>(makeEngine(double{})));
+        }
+      }
+
+      /// @brief Destructor.
+      ~BluesteinPlan() override = default;
+
+      /**
+       * @brief Get backend of the power of two plans.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mForwardPlan->getBackend();
+      }
+
+      /**
+       * @brief Get the memory held by the power of two plans and the internal buffers.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the power of two plans.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mForwardPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "computed by the Bluestein algorithm";
+      }
+
+    protected:
+      /**
+       * @brief Execute the Bluestein algorithm.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters&) override
+      {
+        const auto lock = lockExecution(mMutex);
+
+        auto execute = [&](auto& engine)
+        {
+          using EngineType = std::decay_t<decltype(engine)>;
+          using T          = std::conditional_t<std::is_same_v<EngineType, chirpZ::Engine<float>>, float, double>;
+
+          engine.execute(static_cast<const std::complex<T>*>(src.front()),
+                         View<std::size_t>{mSrcRowOffsets.data(), mSrcRowOffsets.size()},
+                         mSrcStride,
+                         static_cast<std::complex<T>*>(dst.front()),
+                         View<std::size_t>{mDstRowOffsets.data(), mDstRowOffsets.size()},
+                         mDstStride);
+        };
+
+        if (auto* engine = std::get_if<chirpZ::Engine<float>>(&mEngine))
+        {
+          execute(*engine);
+        }
+        else
+        {
+          execute(std::get<chirpZ::Engine<double>>(mEngine));
+        }
+      }
+
+      /**
+       * @brief Execute the batch one transform after another, the transforms share the work buffer.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      std::variant<std::monostate,
+                   chirpZ::Engine<float>,
+                   chirpZ::Engine<double>> mEngine{};            ///< The chirp z-transform engine of the precision.
+      const Plan*                          mForwardPlan{};       ///< The forward power of two plan held by the engine.
+      std::vector<std::size_t>             mSrcRowOffsets{};     ///< The source row offsets.
+      std::vector<std::size_t>             mDstRowOffsets{};     ///< The destination row offsets.
+      std::size_t                          mSrcStride{};         ///< The source element stride.
+      std::size_t                          mDstStride{};         ///< The destination element stride.
+      std::size_t                          mBackendMemorySize{}; ///< The internal memory size.
+      std::mutex                           mMutex{};             ///< Serializes the executions.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_BLUESTEIN_PLAN_HPP */
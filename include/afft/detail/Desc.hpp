@@ -161,16 +161,122 @@ namespace afft::detail
         return bufferCounts;
       }
 
-      // [[nodiscard]] friend bool operator==(const Desc& lhs, const Desc& rhs) noexcept
-      // {
-      //   return static_cast<const TransformDesc&>(lhs) == static_cast<const TransformDesc&>(rhs) &&
-      //          static_cast<const ArchDesc&>(lhs) == static_cast<const ArchDesc&>(rhs);
-      // }
-
-      // [[nodiscard]] friend bool operator!=(const Desc& lhs, const Desc& rhs) noexcept
-      // {
-      //   return !(lhs == rhs);
-      // }
+      /**
+       * @brief Get the size of the spst source and destination buffers spanned by the memory layout. For the planar
+       *        complex format it is the size of each of the real and imaginary buffers. In-place buffers have the size
+       *        of the larger one.
+       * @return A pair of the source and destination buffer sizes in bytes.
+       */
+      [[nodiscard]] std::pair<std::size_t, std::size_t> getSpstSrcDstBufferSize() const
+      {
+        const auto  shapeRank    = getShapeRank();
+        const auto& memoryLayout = getMemoryLayout<Distribution::spst>();
+        const auto  planarScale  = (getComplexFormat() == ComplexFormat::planar) ? std::size_t{2} : std::size_t{1};
+        const auto [srcCmpl, dstCmpl] = getSrcDstComplexity();
+
+        auto getBufferSize = [&](const MaxDimArray<std::size_t>& shape,
+                                 bool                            hasDefaultStrides,
+                                 View<std::size_t>               strides,
+                                 std::size_t                     elemSize)
+        {
+          if (std::any_of(shape.begin(), shape.begin() + shapeRank, [](std::size_t size) { return size == 0; }))
+          {
+            return std::size_t{};
+          }
+
+          std::size_t elemCount{1};
+
+          for (std::size_t i{}; i < shapeRank; ++i)
+          {
+            elemCount = (hasDefaultStrides) ? elemCount * shape[i] : elemCount + (shape[i] - 1) * strides[i];
+          }
+
+          return elemCount * elemSize;
+        };
+
+        auto srcSize = getBufferSize(getSrcShape(),
+                                     memoryLayout.hasDefaultSrcStrides(),
+                                     memoryLayout.getSrcStrides(),
+                                     sizeOfSrcElem() / ((srcCmpl == Complexity::complex) ? planarScale : 1));
+        auto dstSize = getBufferSize(getDstShape(),
+                                     memoryLayout.hasDefaultDstStrides(),
+                                     memoryLayout.getDstStrides(),
+                                     sizeOfDstElem() / ((dstCmpl == Complexity::complex) ? planarScale : 1));
+
+        if (getPlacement() == Placement::inPlace)
+        {
+          srcSize = dstSize = std::max(srcSize, dstSize);
+        }
+
+        return std::make_pair(srcSize, dstSize);
+      }
+
+      /**
+       * @brief Get the number of transforms along the outermost axis when it is a batch axis whose count may be reduced
+       *        at execution time.
+       * @return The batch count, 0 if the outermost axis cannot be reduced.
+       */
+      [[nodiscard]] constexpr std::size_t getOuterBatchCount() const
+      {
+        if (getDistribution() != Distribution::spst || getTargetCount() != 1)
+        {
+          return 0;
+        }
+
+        switch (getTarget())
+        {
+        case Target::cpu:
+          // unpadded in-place real rows shift with the batch count, the parts would overlap
+          if (getArchDesc<Target::cpu, Distribution::spst>().unpaddedInPlaceReal && getPlacement() == Placement::inPlace)
+          {
+            return 0;
+          }
+
+          // the part plans of a reduced batch count are made on their first use
+          if (isRealtime())
+          {
+            return 0;
+          }
+          break;
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        case Target::gpu:
+          break;
+#endif
+        default:
+          return 0;
+        }
+
+        const auto transformAxes = getTransformAxes();
+        const auto dttAxes       = getDttAxes();
+
+        if (getShapeRank() < 2 ||
+            std::find(transformAxes.begin(), transformAxes.end(), std::size_t{0}) != transformAxes.end() ||
+            std::find(dttAxes.begin(), dttAxes.end(), std::size_t{0}) != dttAxes.end() ||
+            hasLogicalSrcShape() || hasDstWindow() || hasFullSpectrum() || hasShift())
+        {
+          return 0;
+        }
+
+        return getShape()[0];
+      }
+
+      /**
+       * @brief Equality operator. Default memory layout strides should be filled before comparison.
+       * @param lhs Left-hand side.
+       * @param rhs Right-hand side.
+       * @return True if equal, false otherwise.
+       */
+      [[nodiscard]] friend bool operator==(const Desc& lhs, const Desc& rhs) noexcept
+      {
+        return static_cast<const TransformDesc&>(lhs) == static_cast<const TransformDesc&>(rhs) &&
+               static_cast<const ArchDesc&>(lhs) == static_cast<const ArchDesc&>(rhs);
+      }
+
+      /// @brief Inequality operator.
+      [[nodiscard]] friend bool operator!=(const Desc& lhs, const Desc& rhs) noexcept
+      {
+        return !(lhs == rhs);
+      }
   };
 
   /// @brief Helper struct to get the Desc object from an object.
@@ -188,16 +294,146 @@ namespace afft::detail
       return obj.getDesc();
     }
   };
+
+  /// @brief Helper struct to access the function making the inverse plan of a plan, see Plan::makeInverse().
+  struct InversePlanSetter
+  {
+    /**
+     * @brief Set the function making the inverse plan.
+     * @tparam PlanT Plan type.
+     * @tparam FnT Function type.
+     * @param plan The plan.
+     * @param fn Function making a plan of the inverse description.
+     */
+    template<typename PlanT, typename FnT>
+    static void setMakeInversePlanFn(PlanT& plan, FnT&& fn)
+    {
+      plan.mMakeInversePlanFn = std::forward<FnT>(fn);
+    }
+
+    /**
+     * @brief Get the function making a plan of a description by the backend of the plan, see setMakeInversePlanFn().
+     * @tparam PlanT Plan type.
+     * @param plan The plan.
+     * @return The function, empty if the plan was not made by makePlan().
+     */
+    template<typename PlanT>
+    [[nodiscard]] static const auto& getMakePlanFn(const PlanT& plan)
+    {
+      return plan.mMakeInversePlanFn;
+    }
+  };
+
+  /**
+   * @brief Make the description of the inverse transform. The direction is reversed, the real-to-complex and the
+   *        complex-to-real transforms are swapped, as are the source and the destination precisions and strides, and
+   *        the unitary normalization moves to the other direction. The shape, the axes and the placement are kept.
+   * @param desc Plan description.
+   * @return The inverse description.
+   * @throw std::invalid_argument if the description has no inverse of the same shape.
+   */
+  [[nodiscard]] inline Desc makeInverseDesc(const Desc& desc)
+  {
+    if (desc.getDistribution() != Distribution::spst)
+    {
+      throw std::invalid_argument{"inverse plans support only the spst distribution"};
+    }
+
+    if (desc.hasLogicalSrcShape() || desc.hasDstWindow() || desc.hasFullSpectrum() || desc.hasShift())
+    {
+      throw std::invalid_argument{"inverse plans do not support the logical source shape, the destination window, "
+                                  "the full spectrum and the shifts"};
+    }
+
+    Desc layoutDesc{desc};
+    layoutDesc.fillDefaultMemoryLayoutStrides();
+
+    const auto& memoryLayout       = desc.getMemoryLayout<Distribution::spst>();
+    const auto& filledMemoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+
+    auto makeDesc = [&](auto transformParams)
+    {
+      using TransformParamsT = decltype(transformParams);
+
+      transformParams.direction = (desc.getDirection() == Direction::forward) ? Direction::backward : Direction::forward;
+      std::swap(transformParams.precision.source, transformParams.precision.destination);
+
+      // the 1/N factor moves to the other direction, so the plans compose to the identity
+      switch (transformParams.normalization)
+      {
+      case Normalization::none:
+        transformParams.normalization = Normalization::unitary;
+        break;
+      case Normalization::unitary:
+        transformParams.normalization = Normalization::none;
+        break;
+      default:
+        break;
+      }
+
+      if constexpr (std::is_same_v<TransformParamsT, TransformParameters<Transform::dft>>)
+      {
+        switch (transformParams.type)
+        {
+        case dft::Type::realToComplex:
+          transformParams.type = dft::Type::complexToReal;
+          break;
+        case dft::Type::complexToReal:
+          transformParams.type = dft::Type::realToComplex;
+          break;
+        default:
+          break;
+        }
+      }
+
+      auto swapStrides = [&](auto archParams)
+      {
+        archParams.memoryLayout.srcStrides = (memoryLayout.hasDefaultDstStrides())
+                                               ? View<std::size_t>{} : filledMemoryLayout.getDstStrides();
+        archParams.memoryLayout.dstStrides = (memoryLayout.hasDefaultSrcStrides())
+                                               ? View<std::size_t>{} : filledMemoryLayout.getSrcStrides();
+
+        return Desc{transformParams, archParams};
+      };
+
+      switch (desc.getTarget())
+      {
+      case Target::cpu:
+        return swapStrides(layoutDesc.getArchitectureParameters<Target::cpu, Distribution::spst>());
+#   ifndef AFFT_DISABLE_GPU
+      case Target::gpu:
+        return swapStrides(layoutDesc.getArchitectureParameters<Target::gpu, Distribution::spst>());
+#   endif
+      default:
+        throw std::invalid_argument{"inverse plans do not support the target"};
+      }
+    };
+
+    switch (desc.getTransform())
+    {
+    case Transform::dft:
+      return makeDesc(layoutDesc.getTransformParameters<Transform::dft>());
+    case Transform::dht:
+      return makeDesc(layoutDesc.getTransformParameters<Transform::dht>());
+    case Transform::dtt:
+      return makeDesc(layoutDesc.getTransformParameters<Transform::dtt>());
+    default:
+      cxx::unreachable();
+    }
+  }
 } // namespace afft::detail
 
   /// @brief Specialization of std::hash for afft::detail::Desc.
   template<>
   struct std::hash<afft::detail::Desc>
   {
-    [[nodiscard]] constexpr std::size_t operator()(const afft::detail::Desc&) const noexcept
+    [[nodiscard]] std::size_t operator()(const afft::detail::Desc& desc) const noexcept
     {
-      return 0;
-      // return std::hash<TransformDesc>{}(desc) ^ std::hash<ArchDesc>{}(desc);
+      std::size_t seed = std::hash<afft::detail::TransformDesc>{}(desc);
+
+      afft::detail::hashCombine(seed, std::hash<afft::detail::ArchDesc>{}(desc));
+
+      return seed;
     }
   };
 
@@ -0,0 +1,276 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_FULL_SPECTRUM_PLAN_HPP
+#define AFFT_DETAIL_FULL_SPECTRUM_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Make the description of the plan computing the reduced spectrum of a full spectrum plan. The reduced
+   *        spectrum is stored in the destination strides of the full spectrum, the mirrored part is left untouched.
+   * @param desc Plan description storing the full spectrum.
+   * @return Plan description of the reduced spectrum.
+   */
+  [[nodiscard]] inline Desc makeReducedSpectrumDesc(const Desc& desc)
+  {
+    Desc layoutDesc{desc};
+    layoutDesc.fillDefaultMemoryLayoutStrides();
+
+    const auto  shapeRank        = desc.getShapeRank();
+    const auto& memoryLayout     = desc.getMemoryLayout<Distribution::spst>();
+    const auto& fullMemoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+
+    const auto srcStrides = (memoryLayout.hasDefaultSrcStrides()) ? View<std::size_t>{} : memoryLayout.getSrcStrides();
+    const auto dstStrides = fullMemoryLayout.getDstStrides();
+
+    Desc reducedDesc{desc};
+    reducedDesc.resetFullSpectrum();
+
+    auto& cpuDesc = reducedDesc.getArchDesc<Target::cpu, Distribution::spst>();
+    cpuDesc.memoryLayout = SpstMemoryLayout{shapeRank, afft::spst::MemoryLayout<>{srcStrides, dstStrides}};
+
+    return reducedDesc;
+  }
+
+  /**
+   * @class FullSpectrumPlan
+   * @brief Plan storing the full Hermitian spectrum of a real-to-complex transform. The plan of the reduced spectrum
+   *        writes the first n / 2 + 1 elements of the last transformed axis into the destination, the rest is filled by
+   *        one pass over the destination rows, X[k] = conj(X[-k]) with the indices of all transformed axes negated.
+   *        Only spst cpu plans are supported.
+   */
+  class FullSpectrumPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param desc Plan description storing the full spectrum.
+       * @param reducedPlan Plan created from makeReducedSpectrumDesc(desc).
+       */
+      FullSpectrumPlan(const Desc& desc, std::unique_ptr<Plan> reducedPlan)
+      : Plan{desc},
+        mPlan{std::move(reducedPlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Reduced spectrum plan must not be null"};
+        }
+
+        switch (desc.getPrecision().destination)
+        {
+        case Precision::_float:
+        case Precision::_double:
+          break;
+        default:
+          throw std::invalid_argument{"Full spectrum supports only float and double destination precision"};
+        }
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto shape      = desc.getShape();
+        const auto dstStrides = layoutDesc.getMemoryLayout<Distribution::spst>().getDstStrides();
+
+        mShapeRank = desc.getShapeRank();
+        mLastAxis  = desc.getTransformAxes().back();
+        std::copy(shape.begin(), shape.begin() + mShapeRank, mShape.begin());
+        std::copy(dstStrides.begin(), dstStrides.end(), mDstStrides.begin());
+
+        for (const auto axis : desc.getTransformAxes())
+        {
+          mIsTransformedAxis[axis] = true;
+        }
+      }
+
+      /// @brief Destructor.
+      ~FullSpectrumPlan() override = default;
+
+      /**
+       * @brief Get backend of the reduced spectrum plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the reduced spectrum plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the reduced spectrum plan.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return mPlan->getBackendMemorySize();
+      }
+
+      /**
+       * @brief Get the backend feedback of the reduced spectrum plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "full spectrum mirrored from the reduced one";
+      }
+
+    protected:
+      /**
+       * @brief Execute the reduced spectrum plan and mirror the rest of the spectrum.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        executeBackendImplOf(*mPlan, src, dst, execParams);
+
+        const bool isPlanar = (mDesc.getComplexFormat() == ComplexFormat::planar);
+
+        if (mDesc.getPrecision().destination == Precision::_float)
+        {
+          mirror<float>(dst, isPlanar);
+        }
+        else
+        {
+          mirror<double>(dst, isPlanar);
+        }
+      }
+
+    private:
+      /// @brief Number of destination elements mirrored by one task of the thread pool.
+      static constexpr std::size_t elemsPerTask{std::size_t{1} << 14};
+
+      /**
+       * @brief Fill the upper part of the last transformed axis by the conjugates of the mirrored elements. The written
+       *        elements k > n / 2 read only elements n - k < n / 2 + 1, so the rows may be mirrored in parallel.
+       * @tparam T Real type of the destination.
+       * @param dst Destination buffers, the real and imaginary parts for the planar complex format.
+       * @param isPlanar Is the complex format planar?
+       */
+      template<typename T>
+      void mirror(View<void*> dst, bool isPlanar) const
+      {
+        const auto        threadLimit = mDesc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+        const std::size_t length      = mShape[mLastAxis];
+        const std::size_t stride      = mDstStrides[mLastAxis];
+        const std::size_t rowCount    = std::accumulate(mShape.begin(),
+                                                        mShape.begin() + mShapeRank,
+                                                        std::size_t{1},
+                                                        std::multiplies<>{}) / length;
+        const std::size_t rowsPerTask = std::max(elemsPerTask / length, std::size_t{1});
+        const std::size_t taskCount   = (rowCount + rowsPerTask - 1) / rowsPerTask;
+
+        if (length < 3)
+        {
+          return;
+        }
+
+        parallelFor(taskCount, threadLimit, [&](std::size_t task)
+        {
+          const std::size_t end = std::min(rowCount, (task + 1) * rowsPerTask);
+
+          for (std::size_t row = task * rowsPerTask; row < end; ++row)
+          {
+            std::size_t index        = row;
+            std::size_t offset       = 0;
+            std::size_t mirrorOffset = 0;
+
+            // rows enumerate the indices of the other axes, the last axis varies fastest
+            for (std::size_t i = mShapeRank; i > 0; --i)
+            {
+              if (i - 1 == mLastAxis)
+              {
+                continue;
+              }
+
+              const std::size_t extent      = mShape[i - 1];
+              const std::size_t axisIndex   = index % extent;
+              const std::size_t mirrorIndex = (mIsTransformedAxis[i - 1] && axisIndex != 0) ? extent - axisIndex
+                                                                                              : axisIndex;
+
+              offset       += axisIndex * mDstStrides[i - 1];
+              mirrorOffset += mirrorIndex * mDstStrides[i - 1];
+              index        /= extent;
+            }
+
+            if (isPlanar)
+            {
+              T* re = static_cast<T*>(dst[0]);
+              T* im = static_cast<T*>(dst[1]);
+
+              for (std::size_t k = length / 2 + 1; k < length; ++k)
+              {
+                re[offset + k * stride] =  re[mirrorOffset + (length - k) * stride];
+                im[offset + k * stride] = -im[mirrorOffset + (length - k) * stride];
+              }
+            }
+            else
+            {
+              std::complex<T>* data = static_cast<std::complex<T>*>(dst.front());
+
+              for (std::size_t k = length / 2 + 1; k < length; ++k)
+              {
+                data[offset + k * stride] = std::conj(data[mirrorOffset + (length - k) * stride]);
+              }
+            }
+          }
+        });
+      }
+
+      std::unique_ptr<Plan>    mPlan{};              ///< The plan of the reduced spectrum.
+      std::size_t              mShapeRank{};         ///< The rank of the shape.
+      std::size_t              mLastAxis{};          ///< The last transformed axis.
+      MaxDimArray<std::size_t> mShape{};             ///< The shape of the transform.
+      MaxDimArray<std::size_t> mDstStrides{};        ///< The destination element strides.
+      MaxDimArray<bool>        mIsTransformedAxis{}; ///< Is the axis transformed?
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_FULL_SPECTRUM_PLAN_HPP */
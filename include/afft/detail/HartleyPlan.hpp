@@ -0,0 +1,386 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_HARTLEY_PLAN_HPP
+#define AFFT_DETAIL_HARTLEY_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "ThreadPool.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Check if a spst cpu DHT plan may be computed by a Hartley plan from a real-to-complex DFT.
+   * @param desc Plan description.
+   * @return True if the Hartley plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isHartleyLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu ||
+        desc.getDistribution() != Distribution::spst ||
+        desc.getTransform() != Transform::dht)
+    {
+      return false;
+    }
+
+    const auto precision = desc.getPrecision().execution;
+
+    return desc.hasUniformPrecision() && (precision == Precision::f32 || precision == Precision::f64);
+  }
+
+  /**
+   * @brief Make the description of the real-to-complex plan of a Hartley plan. It reads the source of the DHT and
+   *        stores the half spectrum contiguously into the internal buffer.
+   * @param desc Plan description, see isHartleyLayout().
+   * @return Plan description of the forward real-to-complex DFT of the same shape, axes and normalization.
+   */
+  [[nodiscard]] inline Desc makeHartleySpectrumDesc(const Desc& desc)
+  {
+    dft::Parameters<> spectrumParams{};
+    spectrumParams.direction     = Direction::forward;
+    spectrumParams.precision     = desc.getPrecision();
+    spectrumParams.shape         = desc.getShape();
+    spectrumParams.axes          = desc.getTransformAxes();
+    spectrumParams.normalization = desc.getNormalization();
+    spectrumParams.placement     = Placement::outOfPlace;
+    spectrumParams.type          = dft::Type::realToComplex;
+
+    // the default strides are viewed as zeros, they must be filled to keep the source layout
+    Desc layoutDesc{desc};
+    layoutDesc.fillDefaultMemoryLayoutStrides();
+
+    auto archParams = layoutDesc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+    archParams.memoryLayout.dstStrides = {};
+    archParams.complexFormat           = ComplexFormat::interleaved;
+
+    // an in-place DHT overwrites the source anyway
+    if (desc.getPlacement() == Placement::inPlace)
+    {
+      archParams.preserveSource = false;
+    }
+
+    return Desc{spectrumParams, archParams};
+  }
+
+  /**
+   * @class HartleyPlan
+   * @brief Plan computing a DHT from the half spectrum X of a real-to-complex DFT. The non-separable DHT is
+   *        Re X(k) - Im X(k). The separable one combines the spectra mirrored along the subsets of the r transform
+   *        axes, prod_i cas(t_i) = 2^-r sum_s prod_i c(s_i) e^{i s_i t_i} with c(+1) = 1 - i and c(-1) = 1 + i, whose
+   *        real part is summed over the 2^(r-1) conjugate pairs of subsets. The elements of the other half of the
+   *        spectrum are the conjugates of the mirrored ones. Only spst cpu plans are supported. Executions of the plan
+   *        are serialized, they share the internal spectrum.
+   */
+  class HartleyPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the internal spectrum.
+       * @param desc Plan description, see isHartleyLayout().
+       * @param spectrumPlan Plan created from makeHartleySpectrumDesc(desc).
+       */
+      HartleyPlan(const Desc& desc, std::unique_ptr<Plan> spectrumPlan)
+      : Plan{desc},
+        mPlan{std::move(spectrumPlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Spectrum plan must not be null"};
+        }
+
+        const auto& cpuDesc   = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  alignment = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+        const auto  shape     = desc.getShape();
+        const auto  axes      = desc.getTransformAxes();
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        Desc spectrumDesc{makeHartleySpectrumDesc(desc)};
+        spectrumDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto dstStrides      = layoutDesc.getMemoryLayout<Distribution::spst>().getDstStrides();
+        const auto spectrumStrides = spectrumDesc.getMemoryLayout<Distribution::spst>().getDstStrides();
+
+        mShapeRank = desc.getShapeRank();
+        mLastAxis  = axes.back();
+
+        std::copy(shape.begin(), shape.end(), mShape.begin());
+        std::copy(dstStrides.begin(), dstStrides.end(), mDstStrides.begin());
+        std::copy(spectrumStrides.begin(), spectrumStrides.end(), mSpectrumStrides.begin());
+
+        for (const auto axis : axes)
+        {
+          mTransformAxisMask |= (1u << axis);
+        }
+
+        // the terms of the opposite subsets are conjugate, so only the subsets reading the last axis at k are summed
+        // with the doubled coefficients, a set bit of the mask reads the axis at k, a clear one at -k
+        const std::size_t transformRank = axes.size();
+
+        if (desc.getTransformDesc<Transform::dht>().type == dht::Type::nonSeparable)
+        {
+          mTerms.push_back(Term{mTransformAxisMask, std::complex<double>{1.0, 1.0}});
+        }
+        else
+        {
+          for (unsigned subset = (1u << (transformRank - 1)); subset < (1u << transformRank); ++subset)
+          {
+            std::complex<double> coefficient{2.0 / static_cast<double>(1u << transformRank), 0.0};
+            unsigned             mask{};
+
+            for (std::size_t i{}; i < transformRank; ++i)
+            {
+              if (subset & (1u << i))
+              {
+                coefficient *= std::complex<double>{1.0, 1.0};
+                mask        |= (1u << axes[i]);
+              }
+              else
+              {
+                coefficient *= std::complex<double>{1.0, -1.0};
+              }
+            }
+
+            mTerms.push_back(Term{mask, coefficient});
+          }
+        }
+
+        mSpectrumSize = spectrumDesc.getSpstSrcDstBufferSize().second;
+        mSpectrum     = cpu::makeAlignedUnique<std::byte[]>(alignment, cpuDesc.hugePagePolicy, mSpectrumSize);
+
+        const auto planMemorySize = mPlan->getBackendMemorySize();
+
+        mBackendMemorySize = mSpectrumSize + (planMemorySize.empty() ? 0 : planMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~HartleyPlan() override = default;
+
+      /**
+       * @brief Get backend of the spectrum plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the spectrum plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the spectrum plan and the internal spectrum.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the spectrum plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "DHT computed from a real-to-complex DFT";
+      }
+
+    protected:
+      /**
+       * @brief Execute the spectrum plan and combine the spectrum into the DHT.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const auto lock = lockExecution(mMutex);
+
+        void* spectrum = mSpectrum.get();
+
+        executeBackendImplOf(*mPlan, src, View<void*>{&spectrum, 1}, execParams);
+
+        if (DescGetter::get(*this).getPrecision().execution == Precision::f32)
+        {
+          combine(static_cast<const std::complex<float>*>(spectrum), static_cast<float*>(dst.front()));
+        }
+        else
+        {
+          combine(static_cast<const std::complex<double>*>(spectrum), static_cast<double*>(dst.front()));
+        }
+      }
+
+      /**
+       * @brief Execute the batch one transform after another, the transforms share the internal spectrum.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      /// @brief Term of the DHT, the coefficient times the spectrum mirrored along the axes missing in the mask.
+      struct Term
+      {
+        unsigned             mask{};        ///< Axes read at k, the other transform axes are read at -k.
+        std::complex<double> coefficient{}; ///< Coefficient of the term.
+      };
+
+      /// @brief Number of elements combined by one task of the thread pool
+      static constexpr std::size_t elemsPerTask{4096};
+
+      /**
+       * @brief Combine the half spectrum into the DHT.
+       * @tparam T Real type.
+       * @param spectrum Half spectrum.
+       * @param dst Destination, may alias the source of the spectrum plan.
+       */
+      template<typename T>
+      void combine(const std::complex<T>* spectrum, T* dst) const
+      {
+        const auto        threadLimit = DescGetter::get(*this).getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+        const std::size_t halfLength  = mShape[mLastAxis] / 2 + 1;
+        const std::size_t elemCount   = std::accumulate(mShape.data(),
+                                                        mShape.data() + mShapeRank,
+                                                        std::size_t{1},
+                                                        std::multiplies<>{});
+        const std::size_t taskCount   = (elemCount + elemsPerTask - 1) / elemsPerTask;
+
+        parallelFor(taskCount, threadLimit, [&](std::size_t task)
+        {
+          MaxDimArray<std::size_t> index{};
+
+          const std::size_t end = std::min(elemCount, (task + 1) * elemsPerTask);
+
+          for (std::size_t e = task * elemsPerTask; e < end; ++e)
+          {
+            std::size_t linear    = e;
+            std::size_t dstOffset = 0;
+
+            for (std::size_t i = mShapeRank; i > 0; --i)
+            {
+              index[i - 1] = linear % mShape[i - 1];
+              linear      /= mShape[i - 1];
+              dstOffset   += index[i - 1] * mDstStrides[i - 1];
+            }
+
+            std::complex<T> acc{};
+
+            for (const auto& term : mTerms)
+            {
+              acc += std::complex<T>{term.coefficient} * getSpectrumElem(spectrum, index, term.mask, halfLength);
+            }
+
+            dst[dstOffset] = acc.real();
+          }
+        });
+      }
+
+      /**
+       * @brief Get the spectrum element at the index mirrored along the transform axes missing in the mask.
+       * @tparam T Real type.
+       * @param spectrum Half spectrum.
+       * @param index Index in the full spectrum.
+       * @param mask Axes read unmirrored.
+       * @param halfLength Length of the half spectrum along the last transform axis.
+       * @return Spectrum element, the conjugate of the mirrored one in the other half.
+       */
+      template<typename T>
+      [[nodiscard]] std::complex<T> getSpectrumElem(const std::complex<T>*          spectrum,
+                                                    const MaxDimArray<std::size_t>& index,
+                                                    unsigned                        mask,
+                                                    std::size_t                     halfLength) const
+      {
+        auto mirror = [&](std::size_t axis, std::size_t i)
+        {
+          return (i == 0) ? i : mShape[axis] - i;
+        };
+
+        const auto getIndex = [&](std::size_t axis, bool isMirrored)
+        {
+          const bool isTransformAxis = (mTransformAxisMask & (1u << axis)) != 0;
+          const bool mirrors         = isTransformAxis && ((mask & (1u << axis)) == 0) != isMirrored;
+
+          return (mirrors) ? mirror(axis, index[axis]) : index[axis];
+        };
+
+        const bool isStored = getIndex(mLastAxis, false) < halfLength;
+
+        std::size_t offset{};
+
+        for (std::size_t i{}; i < mShapeRank; ++i)
+        {
+          offset += getIndex(i, !isStored) * mSpectrumStrides[i];
+        }
+
+        return (isStored) ? spectrum[offset] : std::conj(spectrum[offset]);
+      }
+
+      std::unique_ptr<Plan>              mPlan{};              ///< The spectrum plan.
+      std::size_t                        mShapeRank{};         ///< The rank of the shape.
+      MaxDimArray<std::size_t>           mShape{};             ///< The shape.
+      MaxDimArray<std::size_t>           mDstStrides{};        ///< The destination strides.
+      MaxDimArray<std::size_t>           mSpectrumStrides{};   ///< The strides of the half spectrum.
+      std::size_t                        mLastAxis{};          ///< The reduced transform axis of the half spectrum.
+      unsigned                           mTransformAxisMask{}; ///< The transform axes.
+      std::vector<Term>                  mTerms{};             ///< The terms of the DHT.
+      std::size_t                        mSpectrumSize{};      ///< The internal spectrum size in bytes.
+      cpu::AlignedUniquePtr<std::byte[]> mSpectrum{};          ///< The internal half spectrum.
+      std::size_t                        mBackendMemorySize{}; ///< The internal memory size.
+      std::mutex                         mMutex{};             ///< Serializes the executions.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_HARTLEY_PLAN_HPP */
@@ -0,0 +1,254 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_IN_PLACE_DST_PLAN_HPP
+#define AFFT_DETAIL_IN_PLACE_DST_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "TransposedPlan.hpp"
+#include "transpose.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Make the out-of-place description of a plan with the automatic placement, the caller's view of the plan.
+   * @param desc Plan description with the automatic placement.
+   * @return Plan description with the out-of-place placement.
+   */
+  [[nodiscard]] inline Desc makeOutOfPlaceDesc(const Desc& desc)
+  {
+    Desc outOfPlaceDesc{desc};
+
+    outOfPlaceDesc.setPlacement(Placement::outOfPlace);
+
+    return outOfPlaceDesc;
+  }
+
+  /**
+   * @brief Check if an out-of-place spst cpu plan may be computed in-place in the destination buffer. The source and
+   *        the destination must have the same element type and shape, so the destination holds a copy of the source,
+   *        and the destination layout must be the default one or the layout of the source.
+   * @param desc Out-of-place plan description.
+   * @return True if the in-place destination plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isInPlaceDstLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu ||
+        desc.getDistribution() != Distribution::spst ||
+        desc.getPlacement() != Placement::outOfPlace ||
+        desc.hasLogicalSrcShape() || desc.hasDstWindow() || desc.hasFullSpectrum() || desc.hasShift())
+    {
+      return false;
+    }
+
+    const auto& prec = desc.getPrecision();
+
+    if (prec.source != prec.destination || desc.getSrcDstComplexity().first != desc.getSrcDstComplexity().second)
+    {
+      return false;
+    }
+
+    if (!transpose::isSupportedElemSize(getDstBufferElemSize(desc)))
+    {
+      return false;
+    }
+
+    Desc layoutDesc{desc};
+    layoutDesc.fillDefaultMemoryLayoutStrides();
+
+    const auto& memoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+    const auto  srcStrides   = memoryLayout.getSrcStrides();
+    const auto  dstStrides   = memoryLayout.getDstStrides();
+
+    return desc.getMemoryLayout<Distribution::spst>().hasDefaultDstStrides() ||
+           std::equal(srcStrides.begin(), srcStrides.end(), dstStrides.begin(), dstStrides.end());
+  }
+
+  /**
+   * @brief Make the description of the in-place plan computed in the destination of an out-of-place plan.
+   * @param desc Out-of-place plan description, see isInPlaceDstLayout().
+   * @return In-place plan description with the destination layout, the source is not preserved.
+   */
+  [[nodiscard]] inline Desc makeInPlaceDstDesc(const Desc& desc)
+  {
+    Desc inPlaceDesc{desc};
+
+    inPlaceDesc.setPlacement(Placement::inPlace);
+    inPlaceDesc.setPreserveSource(false);
+
+    auto& cpuDesc = inPlaceDesc.getArchDesc<Target::cpu, Distribution::spst>();
+
+    if (cpuDesc.memoryLayout.hasDefaultDstStrides())
+    {
+      cpuDesc.memoryLayout.resetSrcStrides();
+    }
+
+    return inPlaceDesc;
+  }
+
+  /**
+   * @class InPlaceDstPlan
+   * @brief Plan computing an out-of-place transform in-place in the destination buffer. The source is copied into the
+   *        destination, which is then transformed by an in-place plan, so the source is preserved without any internal
+   *        buffer. Selected by the automatic placement where the in-place plan is faster or needs less memory. Only
+   *        spst cpu plans are supported.
+   */
+  class InPlaceDstPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param desc Out-of-place plan description.
+       * @param inPlacePlan Plan created from makeInPlaceDstDesc(desc).
+       */
+      InPlaceDstPlan(const Desc& desc, std::unique_ptr<Plan> inPlacePlan)
+      : Plan{desc},
+        mPlan{std::move(inPlacePlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"In-place plan must not be null"};
+        }
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto& memoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+        const auto  srcStrides   = memoryLayout.getSrcStrides();
+        const auto  dstStrides   = memoryLayout.getDstStrides();
+
+        mShape    = desc.getSrcShape();
+        mElemSize = getDstBufferElemSize(desc);
+
+        std::copy(srcStrides.begin(), srcStrides.end(), mSrcStrides.begin());
+        std::copy(dstStrides.begin(), dstStrides.end(), mDstStrides.begin());
+      }
+
+      /// @brief Destructor.
+      ~InPlaceDstPlan() override = default;
+
+      /**
+       * @brief Get backend of the in-place plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the in-place plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the in-place plan.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return mPlan->getBackendMemorySize();
+      }
+
+      /**
+       * @brief Get the backend feedback of the in-place plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "computed in-place in the destination";
+      }
+
+    protected:
+      /**
+       * @brief Copy the source into the destination and execute the in-place plan on the destination.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const auto& desc        = DescGetter::get(*this);
+        const auto  shapeRank   = desc.getShapeRank();
+        const auto  threadLimit = desc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        for (std::size_t i{}; i < dst.size(); ++i)
+        {
+          transpose::copy(src[i],
+                          View<std::size_t>{mSrcStrides.data(), shapeRank},
+                          dst[i],
+                          View<std::size_t>{mDstStrides.data(), shapeRank},
+                          View<std::size_t>{mShape.data(), shapeRank},
+                          mElemSize,
+                          threadLimit);
+        }
+
+        executeBackendImplOf(*mPlan, dst, dst, execParams);
+      }
+
+      /**
+       * @brief Execute the batch one transform after another.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      std::unique_ptr<Plan>    mPlan{};       ///< The in-place plan.
+      MaxDimArray<std::size_t> mShape{};      ///< The shape.
+      MaxDimArray<std::size_t> mSrcStrides{}; ///< The source strides.
+      MaxDimArray<std::size_t> mDstStrides{}; ///< The destination strides.
+      std::size_t              mElemSize{};   ///< The buffer element size in bytes.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_IN_PLACE_DST_PLAN_HPP */
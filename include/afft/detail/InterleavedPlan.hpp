@@ -0,0 +1,304 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_INTERLEAVED_PLAN_HPP
+#define AFFT_DETAIL_INTERLEAVED_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "complexFormat.hpp"
+#include "Desc.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Check if a spst cpu plan has planar complex data an interleaved plan may convert.
+   * @param desc Plan description.
+   * @return True if the interleaved plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isPlanarLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu ||
+        desc.getDistribution() != Distribution::spst ||
+        desc.getComplexFormat() != ComplexFormat::planar)
+    {
+      return false;
+    }
+
+    const auto [srcCmpl, dstCmpl] = desc.getSrcDstComplexity();
+
+    if (srcCmpl != Complexity::complex && dstCmpl != Complexity::complex)
+    {
+      return false;
+    }
+
+    // an in-place buffer cannot hold planar and real data at once
+    return desc.getPlacement() == Placement::outOfPlace || srcCmpl == dstCmpl;
+  }
+
+  /**
+   * @brief Check if the interleaved plan applies the normalization while deinterleaving the destination.
+   * @param desc Plan description with the planar complex format.
+   * @return True if the normalization is fused, false if the backend plan normalizes.
+   */
+  [[nodiscard]] inline bool isNormalizationFused(const Desc& desc)
+  {
+    return desc.getNormalization() != Normalization::none &&
+           desc.getSrcDstComplexity().second == Complexity::complex &&
+           complexFormat::isScalable(desc.getPrecision().destination);
+  }
+
+  /**
+   * @brief Make the description of the plan transforming the interleaved data of an interleaved plan.
+   * @param desc Plan description with the planar complex format, see isPlanarLayout().
+   * @return Plan description with the interleaved complex format.
+   */
+  [[nodiscard]] inline Desc makeInterleavedDesc(const Desc& desc)
+  {
+    Desc interleavedDesc{desc};
+
+    interleavedDesc.setComplexFormat(ComplexFormat::interleaved);
+
+    if (isNormalizationFused(desc))
+    {
+      interleavedDesc.setNormalization(Normalization::none);
+    }
+
+    return interleavedDesc;
+  }
+
+  /**
+   * @class InterleavedPlan
+   * @brief Plan converting planar complex data to the interleaved complex format for a backend lacking the planar
+   *        format. The planar source is interleaved into an internal buffer, the backend plan transforms it and its
+   *        interleaved destination is deinterleaved into the planar destination. The normalization is applied during
+   *        the deinterleaving for f32 and f64 complex destinations. Only spst cpu plans are supported. Executions of
+   *        the plan are serialized, they share the internal buffers.
+   */
+  class InterleavedPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the internal buffers.
+       * @param desc Plan description with the planar complex format.
+       * @param interleavedPlan Plan created from makeInterleavedDesc(desc).
+       */
+      InterleavedPlan(const Desc& desc, std::unique_ptr<Plan> interleavedPlan)
+      : Plan{desc},
+        mPlan{std::move(interleavedPlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Interleaved plan must not be null"};
+        }
+
+        const auto& cpuDesc   = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  alignment = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+        const auto [srcCmpl, dstCmpl] = desc.getSrcDstComplexity();
+        const auto [srcSize, dstSize] = desc.getSpstSrcDstBufferSize();
+
+        mSrcIsComplex = (srcCmpl == Complexity::complex);
+        mDstIsComplex = (dstCmpl == Complexity::complex);
+        mScale        = (isNormalizationFused(desc)) ? desc.getNormalizationFactor<double>() : 1.0;
+
+        // the planar buffer sizes are the sizes of each of the real and imaginary parts
+        if (mSrcIsComplex)
+        {
+          mSrcCount  = srcSize / (desc.sizeOfSrcElem() / 2);
+          mSrcBuffer = cpu::makeAlignedUnique<std::byte[]>(alignment, cpuDesc.hugePagePolicy, 2 * srcSize);
+        }
+
+        if (mDstIsComplex)
+        {
+          mDstCount = dstSize / (desc.sizeOfDstElem() / 2);
+
+          if (desc.getPlacement() == Placement::outOfPlace)
+          {
+            mDstBuffer = cpu::makeAlignedUnique<std::byte[]>(alignment, cpuDesc.hugePagePolicy, 2 * dstSize);
+          }
+        }
+
+        const auto planMemorySize = mPlan->getBackendMemorySize();
+
+        mBackendMemorySize = ((mSrcBuffer) ? 2 * srcSize : 0) + ((mDstBuffer) ? 2 * dstSize : 0) +
+                             (planMemorySize.empty() ? 0 : planMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~InterleavedPlan() override = default;
+
+      /**
+       * @brief Get backend of the interleaved plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the interleaved plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the interleaved plan and the internal buffers.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the interleaved plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "planar complex format converted to interleaved";
+      }
+
+    protected:
+      /**
+       * @brief Interleave the source, execute the interleaved plan and deinterleave the destination.
+       * @param src Source buffers, the real and imaginary parts for a complex source.
+       * @param dst Destination buffers, the real and imaginary parts for a complex destination.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const auto lock = lockExecution(mMutex);
+
+        executeLocked(src, dst, execParams);
+      }
+
+      /**
+       * @brief Execute the batch of transforms one after another under a single lock, they share the internal
+       *        buffers. The buffers of the transforms follow one another, each transform takes the real and imaginary
+       *        parts of a complex side and one buffer of a real side, as executeBackendImpl() does.
+       * @param srcs Source buffers of all transforms.
+       * @param dsts Destination buffers of all transforms.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const std::size_t srcStride = (mSrcIsComplex) ? 2 : 1;
+        const std::size_t dstStride = (mDstIsComplex) ? 2 : 1;
+
+        if (srcs.size() % srcStride != 0 || dsts.size() % dstStride != 0 ||
+            srcs.size() / srcStride != dsts.size() / dstStride)
+        {
+          throw std::invalid_argument{"planar batch buffers do not match the number of transforms"};
+        }
+
+        const auto lock = lockExecution(mMutex);
+
+        for (std::size_t i{}; i < srcs.size() / srcStride; ++i)
+        {
+          executeLocked(View<void*>{&srcs[i * srcStride], srcStride},
+                        View<void*>{&dsts[i * dstStride], dstStride},
+                        execParams);
+        }
+      }
+
+    private:
+      /**
+       * @brief Interleave the source, execute the interleaved plan and deinterleave the destination. The caller holds
+       *        the execution lock.
+       * @param src Source buffers, the real and imaginary parts for a complex source.
+       * @param dst Destination buffers, the real and imaginary parts for a complex destination.
+       * @param execParams Execution parameters.
+       */
+      void executeLocked(View<void*>                                 src,
+                         View<void*>                                 dst,
+                         const afft::spst::cpu::ExecutionParameters& execParams)
+      {
+        const auto& desc        = DescGetter::get(*this);
+        const auto  precision   = desc.getPrecision();
+        const auto  threadLimit = desc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        void* planSrc = (mSrcIsComplex) ? mSrcBuffer.get() : src.front();
+        void* planDst = (mDstIsComplex) ? ((mDstBuffer) ? mDstBuffer.get() : planSrc) : dst.front();
+
+        if (mSrcIsComplex)
+        {
+          complexFormat::interleave(precision.source,
+                                    desc.sizeOfSrcElem() / 2,
+                                    src[0],
+                                    src[1],
+                                    planSrc,
+                                    mSrcCount,
+                                    1.0,
+                                    threadLimit);
+        }
+
+        executeBackendImplOf(*mPlan, View<void*>{&planSrc, 1}, View<void*>{&planDst, 1}, execParams);
+
+        if (mDstIsComplex)
+        {
+          complexFormat::deinterleave(precision.destination,
+                                      desc.sizeOfDstElem() / 2,
+                                      planDst,
+                                      dst[0],
+                                      dst[1],
+                                      mDstCount,
+                                      mScale,
+                                      threadLimit);
+        }
+      }
+
+      std::unique_ptr<Plan>              mPlan{};              ///< The interleaved plan.
+      cpu::AlignedUniquePtr<std::byte[]> mSrcBuffer{};         ///< The interleaved source, also the in-place destination.
+      cpu::AlignedUniquePtr<std::byte[]> mDstBuffer{};         ///< The interleaved out-of-place destination.
+      std::size_t                        mSrcCount{};          ///< The number of converted source elements.
+      std::size_t                        mDstCount{};          ///< The number of converted destination elements.
+      double                             mScale{1.0};          ///< The normalization applied while deinterleaving.
+      bool                               mSrcIsComplex{};      ///< Is the source complex?
+      bool                               mDstIsComplex{};      ///< Is the destination complex?
+      std::size_t                        mBackendMemorySize{}; ///< The internal memory size.
+      std::mutex                         mMutex{};             ///< Serializes the executions.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_INTERLEAVED_PLAN_HPP */
@@ -0,0 +1,283 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_MIXED_PRECISION_PLAN_HPP
+#define AFFT_DETAIL_MIXED_PRECISION_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "halfPrecision.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Check if a spst cpu plan stores or computes in 16-bit precision, so a mixed precision plan may compute it
+   *        in f32. All the precisions must be f16, bf16 or f32 and an in-place plan must store both sides in the same
+   *        precision.
+   * @param desc Plan description.
+   * @return True if the mixed precision plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isMixedPrecisionLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu || desc.getDistribution() != Distribution::spst)
+    {
+      return false;
+    }
+
+    const auto& prec = desc.getPrecision();
+
+    auto isStorable = [](Precision p)
+    {
+      return halfPrecision::isHalf(p) || p == Precision::f32;
+    };
+
+    if (!isStorable(prec.execution) || !isStorable(prec.source) || !isStorable(prec.destination))
+    {
+      return false;
+    }
+
+    if (prec.execution == Precision::f32 && prec.source == Precision::f32 && prec.destination == Precision::f32)
+    {
+      return false;
+    }
+
+    return desc.getPlacement() == Placement::outOfPlace || prec.source == prec.destination;
+  }
+
+  /**
+   * @brief Make the description of the plan computing the f32 data of a mixed precision plan.
+   * @param desc Plan description with a 16-bit precision, see isMixedPrecisionLayout().
+   * @return Plan description with the uniform f32 precision.
+   */
+  [[nodiscard]] inline Desc makeSinglePrecisionDesc(const Desc& desc)
+  {
+    Desc singleDesc{desc};
+
+    singleDesc.setPrecision(PrecisionTriad{Precision::f32, Precision::f32, Precision::f32});
+
+    return singleDesc;
+  }
+
+  /**
+   * @class MixedPrecisionPlan
+   * @brief Plan storing the data in f16 or bf16 and computing in f32. The 16-bit source is widened into internal f32
+   *        buffers, the f32 plan transforms them and the result is narrowed into the 16-bit destination, rounding to
+   *        nearest even. F32 sides are passed to the f32 plan unchanged. Only spst cpu plans are supported. Executions
+   *        of the plan are serialized, they share the internal buffers.
+   */
+  class MixedPrecisionPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the internal buffers.
+       * @param desc Plan description with a 16-bit precision.
+       * @param singlePlan Plan created from makeSinglePrecisionDesc(desc).
+       */
+      MixedPrecisionPlan(const Desc& desc, std::unique_ptr<Plan> singlePlan)
+      : Plan{desc},
+        mPlan{std::move(singlePlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Single precision plan must not be null"};
+        }
+
+        const auto& cpuDesc   = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  alignment = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+        const auto& prec      = desc.getPrecision();
+        const auto [srcSize, dstSize]   = desc.getSpstSrcDstBufferSize();
+        const auto [srcCount, dstCount] = desc.getSrcDstBufferCount();
+
+        mSrcCount = srcSize / sizeOf(prec.source);
+        mDstCount = dstSize / sizeOf(prec.destination);
+
+        auto allocate = [&](std::vector<cpu::AlignedUniquePtr<float[]>>& buffers, std::size_t count, std::size_t size)
+        {
+          for (std::size_t i{}; i < count; ++i)
+          {
+            buffers.push_back(cpu::makeAlignedUnique<float[]>(alignment, cpuDesc.hugePagePolicy, size));
+          }
+
+          mBackendMemorySize += count * size * sizeof(float);
+        };
+
+        if (desc.getPlacement() == Placement::inPlace)
+        {
+          // both sides share the buffers, the source precision equals the destination one
+          allocate(mSrcBuffers, std::max(srcCount, dstCount), std::max(mSrcCount, mDstCount));
+        }
+        else
+        {
+          if (halfPrecision::isHalf(prec.source))
+          {
+            allocate(mSrcBuffers, srcCount, mSrcCount);
+          }
+
+          if (halfPrecision::isHalf(prec.destination))
+          {
+            allocate(mDstBuffers, dstCount, mDstCount);
+          }
+        }
+
+        const auto planMemorySize = mPlan->getBackendMemorySize();
+
+        mBackendMemorySize += (planMemorySize.empty() ? 0 : planMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~MixedPrecisionPlan() override = default;
+
+      /**
+       * @brief Get backend of the single precision plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the single precision plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the single precision plan and the internal buffers.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the single precision plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "16-bit data computed in f32";
+      }
+
+    protected:
+      /**
+       * @brief Widen the source, execute the single precision plan and narrow the destination.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const auto& desc        = DescGetter::get(*this);
+        const auto& prec        = desc.getPrecision();
+        const auto  threadLimit = desc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+        const bool  isInPlace   = (desc.getPlacement() == Placement::inPlace);
+
+        const auto lock = lockExecution(mMutex);
+
+        MaxDimArray<void*> planSrc{};
+        MaxDimArray<void*> planDst{};
+
+        for (std::size_t i{}; i < src.size(); ++i)
+        {
+          if (mSrcBuffers.empty())
+          {
+            planSrc[i] = src[i];
+          }
+          else
+          {
+            planSrc[i] = mSrcBuffers[i].get();
+            halfPrecision::widen(prec.source, src[i], mSrcBuffers[i].get(), mSrcCount, threadLimit);
+          }
+        }
+
+        for (std::size_t i{}; i < dst.size(); ++i)
+        {
+          if (isInPlace)
+          {
+            planDst[i] = mSrcBuffers[i].get();
+          }
+          else
+          {
+            planDst[i] = (mDstBuffers.empty()) ? dst[i] : mDstBuffers[i].get();
+          }
+        }
+
+        executeBackendImplOf(*mPlan, View<void*>{planSrc.data(), src.size()}, View<void*>{planDst.data(), dst.size()}, execParams);
+
+        if (halfPrecision::isHalf(prec.destination))
+        {
+          for (std::size_t i{}; i < dst.size(); ++i)
+          {
+            halfPrecision::narrow(prec.destination, static_cast<float*>(planDst[i]), dst[i], mDstCount, threadLimit);
+          }
+        }
+      }
+
+      /**
+       * @brief Execute the batch one transform after another, the transforms share the internal buffers.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      std::unique_ptr<Plan>                       mPlan{};              ///< The single precision plan.
+      std::vector<cpu::AlignedUniquePtr<float[]>> mSrcBuffers{};        ///< The widened source, also the in-place destination.
+      std::vector<cpu::AlignedUniquePtr<float[]>> mDstBuffers{};        ///< The f32 out-of-place destination.
+      std::size_t                                 mSrcCount{};          ///< The number of real values per source buffer.
+      std::size_t                                 mDstCount{};          ///< The number of real values per destination buffer.
+      std::size_t                                 mBackendMemorySize{}; ///< The internal memory size.
+      std::mutex                                  mMutex{};             ///< Serializes the executions.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_MIXED_PRECISION_PLAN_HPP */
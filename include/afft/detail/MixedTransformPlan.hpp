@@ -0,0 +1,339 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_MIXED_TRANSFORM_PLAN_HPP
+#define AFFT_DETAIL_MIXED_TRANSFORM_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Validate the layout of a mixed transform plan, a DFT with some axes transformed by the DTT.
+   * @param desc Plan description with the DTT axes.
+   * @throw std::invalid_argument if the DTT pass cannot view the data as real.
+   */
+  inline void validateMixedTransformLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu || desc.getDistribution() != Distribution::spst)
+    {
+      throw std::invalid_argument{"DTT axes of a DFT are supported only by spst cpu plans"};
+    }
+
+    if (desc.getComplexFormat() != ComplexFormat::interleaved)
+    {
+      throw std::invalid_argument{"DTT axes of a DFT require the interleaved complex format"};
+    }
+
+    if (!desc.hasUniformPrecision())
+    {
+      throw std::invalid_argument{"DTT axes of a DFT require the uniform precision"};
+    }
+
+    if (desc.hasLogicalSrcShape() || desc.hasDstWindow() || desc.hasFullSpectrum() || desc.hasShift())
+    {
+      throw std::invalid_argument{"DTT axes of a DFT support neither a logical source shape, a destination window, "
+                                  "the full spectrum nor shifts"};
+    }
+
+    switch (desc.getTransformDesc<Transform::dft>().type)
+    {
+    case dft::Type::complexToComplex:
+      if (desc.getShapeRank() == maxDimCount)
+      {
+        throw std::invalid_argument{"DTT axes of a complex-to-complex DFT require a shape rank below the maximum"};
+      }
+      break;
+    case dft::Type::realToComplex:
+      if (desc.getPlacement() == Placement::outOfPlace)
+      {
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto dstStrides = layoutDesc.getMemoryLayout<Distribution::spst>().getDstStrides();
+
+        if (dstStrides[desc.getTransformAxes().back()] != 1)
+        {
+          throw std::invalid_argument{"DTT axes of an out-of-place real-to-complex DFT require a unit destination "
+                                      "stride along the reduced axis"};
+        }
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  /**
+   * @brief Make the description of the DFT pass of a mixed transform plan. A real-to-complex DFT transforms the
+   *        destination in-place, the DTT pass stored the real data in it padded along the reduced axis.
+   * @param desc Plan description, see validateMixedTransformLayout().
+   * @return Plan description without the DTT axes.
+   */
+  [[nodiscard]] inline Desc makeMixedDftDesc(const Desc& desc)
+  {
+    const auto shapeRank = desc.getShapeRank();
+    const bool isR2c     = (desc.getTransformDesc<Transform::dft>().type == dft::Type::realToComplex);
+
+    auto dftParams = desc.getTransformParameters<Transform::dft>();
+    dftParams.dttAxes  = {};
+    dftParams.dttTypes = {};
+
+    const auto& memoryLayout = desc.getMemoryLayout<Distribution::spst>();
+
+    auto archParams = desc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+
+    if (!isR2c || desc.getPlacement() == Placement::inPlace)
+    {
+      archParams.memoryLayout = {(memoryLayout.hasDefaultSrcStrides()) ? View<std::size_t>{} : memoryLayout.getSrcStrides(),
+                                 (memoryLayout.hasDefaultDstStrides()) ? View<std::size_t>{} : memoryLayout.getDstStrides()};
+
+      return Desc{dftParams, archParams};
+    }
+
+    Desc layoutDesc{desc};
+    layoutDesc.fillDefaultMemoryLayoutStrides();
+
+    const auto dstStrides  = layoutDesc.getMemoryLayout<Distribution::spst>().getDstStrides();
+    const auto reducedAxis = desc.getTransformAxes().back();
+
+    MaxDimArray<std::size_t> realStrides{};
+
+    for (std::size_t i{}; i < shapeRank; ++i)
+    {
+      realStrides[i] = (i == reducedAxis) ? std::size_t{1} : 2 * dstStrides[i];
+    }
+
+    dftParams.placement = Placement::inPlace;
+
+    archParams.memoryLayout        = {View<std::size_t>{realStrides.data(), shapeRank}, dstStrides};
+    archParams.unpaddedInPlaceReal = false;
+
+    return Desc{dftParams, archParams};
+  }
+
+  /**
+   * @brief Make the description of the DTT pass of a mixed transform plan. It transforms the real source of a
+   *        real-to-complex DFT into the destination viewed as the padded real data, the real destination of
+   *        a complex-to-real DFT in-place, or the real and imaginary parts of a complex-to-complex DFT destination
+   *        in-place along an extra innermost axis of size 2.
+   * @param desc Plan description, see validateMixedTransformLayout().
+   * @return Plan description of the DTT along the DTT axes.
+   */
+  [[nodiscard]] inline Desc makeMixedDttDesc(const Desc& desc)
+  {
+    Desc layoutDesc{desc};
+    layoutDesc.fillDefaultMemoryLayoutStrides();
+
+    const auto& memoryLayout  = layoutDesc.getMemoryLayout<Distribution::spst>();
+    const auto  srcStrides    = memoryLayout.getSrcStrides();
+    const auto  dstStrides    = memoryLayout.getDstStrides();
+    const auto  transformType = desc.getTransformDesc<Transform::dft>().type;
+
+    std::size_t              shapeRank = desc.getShapeRank();
+    MaxDimArray<std::size_t> shape{};
+    MaxDimArray<std::size_t> dttSrcStrides{};
+    MaxDimArray<std::size_t> dttDstStrides{};
+    Placement                placement{Placement::inPlace};
+
+    std::copy(desc.getShape().begin(), desc.getShape().end(), shape.begin());
+
+    switch (transformType)
+    {
+    case dft::Type::complexToComplex:
+      for (std::size_t i{}; i < shapeRank; ++i)
+      {
+        dttSrcStrides[i] = dttDstStrides[i] = 2 * dstStrides[i];
+      }
+
+      shape[shapeRank]         = 2;
+      dttSrcStrides[shapeRank] = dttDstStrides[shapeRank] = 1;
+      ++shapeRank;
+      break;
+    case dft::Type::realToComplex:
+    {
+      const auto reducedAxis = desc.getTransformAxes().back();
+
+      placement = desc.getPlacement();
+
+      for (std::size_t i{}; i < shapeRank; ++i)
+      {
+        dttSrcStrides[i] = srcStrides[i];
+        dttDstStrides[i] = (placement == Placement::inPlace)
+                             ? srcStrides[i] : ((i == reducedAxis) ? std::size_t{1} : 2 * dstStrides[i]);
+      }
+      break;
+    }
+    case dft::Type::complexToReal:
+      std::copy(dstStrides.begin(), dstStrides.end(), dttSrcStrides.begin());
+      std::copy(dstStrides.begin(), dstStrides.end(), dttDstStrides.begin());
+      break;
+    default:
+      cxx::unreachable();
+    }
+
+    dtt::Parameters<> dttParams{};
+    dttParams.direction     = desc.getDirection();
+    dttParams.precision     = desc.getPrecision();
+    dttParams.shape         = View<std::size_t>{shape.data(), shapeRank};
+    dttParams.axes          = desc.getDttAxes();
+    dttParams.normalization = desc.getNormalization();
+    dttParams.placement     = placement;
+    dttParams.types         = desc.getDttTypes();
+
+    auto archParams = desc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+    archParams.memoryLayout        = {View<std::size_t>{dttSrcStrides.data(), shapeRank},
+                                      View<std::size_t>{dttDstStrides.data(), shapeRank}};
+    archParams.unpaddedInPlaceReal = false;
+    archParams.sparseLines         = false;
+
+    return Desc{dttParams, archParams};
+  }
+
+  /**
+   * @class MixedTransformPlan
+   * @brief Plan of a DFT with some axes transformed by the DTT instead, e.g. the DCT along a non-periodic axis and the
+   *        DFT along the periodic ones. The passes along distinct axes commute, so the DFT and the DTT are computed
+   *        one after another over their axes, the DTT transforms the real data before a real-to-complex DFT and after
+   *        a complex-to-real one, the real and imaginary parts are transformed independently for a complex-to-complex
+   *        DFT. Normalizing each pass along its axes normalizes the whole transform. Only spst cpu plans are
+   *        supported.
+   */
+  class MixedTransformPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param desc Plan description, see validateMixedTransformLayout().
+       * @param dftPlan Plan created from makeMixedDftDesc(desc).
+       * @param dttPlan Plan created from makeMixedDttDesc(desc).
+       */
+      MixedTransformPlan(const Desc& desc, std::unique_ptr<Plan> dftPlan, std::unique_ptr<Plan> dttPlan)
+      : Plan{desc},
+        mDftPlan{std::move(dftPlan)},
+        mDttPlan{std::move(dttPlan)},
+        mIsDttFirst{desc.getTransformDesc<Transform::dft>().type == dft::Type::realToComplex}
+      {
+        if (!mDftPlan || !mDttPlan)
+        {
+          throw std::invalid_argument{"DFT and DTT plans must not be null"};
+        }
+
+        const auto dftMemorySize = mDftPlan->getBackendMemorySize();
+        const auto dttMemorySize = mDttPlan->getBackendMemorySize();
+
+        mBackendMemorySize = (dftMemorySize.empty() ? 0 : dftMemorySize.front()) +
+                             (dttMemorySize.empty() ? 0 : dttMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~MixedTransformPlan() override = default;
+
+      /**
+       * @brief Get backend of the DFT plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mDftPlan->getBackend();
+      }
+
+      /**
+       * @brief Get the memory held by the DFT and DTT plans.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the DFT plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mDftPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "DTT axes transformed in a separate pass";
+      }
+
+    protected:
+      /**
+       * @brief Execute the DTT and DFT passes.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters&) override
+      {
+        if (mIsDttFirst)
+        {
+          executeBackendImplOf(*mDttPlan, src, dst, afft::spst::cpu::ExecutionParameters{});
+          executeBackendImplOf(*mDftPlan, dst, dst, afft::spst::cpu::ExecutionParameters{});
+        }
+        else
+        {
+          executeBackendImplOf(*mDftPlan, src, dst, afft::spst::cpu::ExecutionParameters{});
+          executeBackendImplOf(*mDttPlan, dst, dst, afft::spst::cpu::ExecutionParameters{});
+        }
+      }
+
+      /**
+       * @brief Execute the batch one transform after another.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      std::unique_ptr<Plan> mDftPlan{};           ///< The plan of the DFT axes.
+      std::unique_ptr<Plan> mDttPlan{};           ///< The plan of the DTT axes.
+      bool                  mIsDttFirst{};        ///< The DTT pass runs before the DFT pass.
+      std::size_t           mBackendMemorySize{}; ///< The internal memory size.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_MIXED_TRANSFORM_PLAN_HPP */
@@ -0,0 +1,464 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_PLAN_STATS_RECORDER_HPP
+#define AFFT_DETAIL_PLAN_STATS_RECORDER_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "cxx.hpp"
+#include "Desc.hpp"
+#ifdef AFFT_ENABLE_COUNTERS
+# include "perfCounters.hpp"
+#endif
+#if defined(AFFT_ENABLE_CUDA)
+# include "cuda/cuda.hpp"
+#elif defined(AFFT_ENABLE_HIP)
+# include "hip/hip.hpp"
+#endif
+
+namespace afft::detail
+{
+  /**
+   * @brief Estimate the floating point operations of one execution of the plan. A complex transform of N elements
+   *        takes 5 N log2(N) operations, a real one half of it. Batched transforms are counted separately.
+   * @param desc Plan description.
+   * @return Estimated number of floating point operations.
+   */
+  [[nodiscard]] inline double estimateFlops(const Desc& desc)
+  {
+    const auto shape = desc.getShape();
+    const auto axes  = desc.getTransformAxes();
+
+    double transformSize{1.0};
+    double totalSize{1.0};
+
+    for (std::size_t i{}; i < desc.getShapeRank(); ++i)
+    {
+      totalSize *= static_cast<double>(shape[i]);
+    }
+
+    for (const auto axis : axes)
+    {
+      transformSize *= static_cast<double>(shape[axis]);
+    }
+
+    const bool isComplex = desc.getTransform() == Transform::dft &&
+                           desc.getTransformDesc<Transform::dft>().type == dft::Type::complexToComplex;
+
+    return ((isComplex) ? 5.0 : 2.5) * totalSize * std::log2(transformSize);
+  }
+
+  /**
+   * @brief Estimate the bytes moved by one execution of the plan, the source elements read and the destination ones
+   *        written once.
+   * @param desc Plan description.
+   * @return Estimated number of bytes.
+   */
+  [[nodiscard]] inline std::size_t estimateBytes(const Desc& desc)
+  {
+    const auto srcShape = desc.getSrcShape();
+    const auto dstShape = desc.getDstShape();
+
+    std::size_t srcCount{1};
+    std::size_t dstCount{1};
+
+    for (std::size_t i{}; i < desc.getShapeRank(); ++i)
+    {
+      srcCount *= srcShape[i];
+      dstCount *= dstShape[i];
+    }
+
+    return srcCount * desc.sizeOfSrcElem() + dstCount * desc.sizeOfDstElem();
+  }
+
+  /**
+   * @brief Latency histogram buckets. Latencies are counted in nanoseconds, the ones below 2^latencySubBucketBits
+   *        exactly, each larger power of two range is split into 2^latencySubBucketBits linear buckets, so a bucket
+   *        spans at most 1/16 of its lower bound. Latencies over 2^latencyMaxBits ns (about 68 s) fall to the last one.
+   */
+  inline constexpr std::size_t latencySubBucketBits{4};
+  inline constexpr std::size_t latencyMaxBits{36};
+  inline constexpr std::size_t latencyBucketCount{(latencyMaxBits - latencySubBucketBits + 1) << latencySubBucketBits};
+
+  /**
+   * @brief Get the latency histogram bucket of a latency.
+   * @param nanoseconds Latency in nanoseconds.
+   * @return Bucket index.
+   */
+  [[nodiscard]] constexpr std::size_t getLatencyBucketIndex(std::uint64_t nanoseconds) noexcept
+  {
+    constexpr std::uint64_t subBucketCount{std::uint64_t{1} << latencySubBucketBits};
+
+    nanoseconds = std::min(nanoseconds, (std::uint64_t{1} << latencyMaxBits) - 1);
+
+    if (nanoseconds < subBucketCount)
+    {
+      return static_cast<std::size_t>(nanoseconds);
+    }
+
+    const auto shift = static_cast<std::size_t>(cxx::bit_width(nanoseconds)) - 1 - latencySubBucketBits;
+
+    return ((shift + 1) << latencySubBucketBits) + static_cast<std::size_t>((nanoseconds >> shift) - subBucketCount);
+  }
+
+  /**
+   * @brief Get the lower bound of a latency histogram bucket.
+   * @param index Bucket index.
+   * @return The smallest latency of the bucket in nanoseconds.
+   */
+  [[nodiscard]] constexpr std::uint64_t getLatencyBucketLowerBound(std::size_t index) noexcept
+  {
+    constexpr std::size_t subBucketCount{std::size_t{1} << latencySubBucketBits};
+
+    if (index < subBucketCount)
+    {
+      return index;
+    }
+
+    const auto shift = (index >> latencySubBucketBits) - 1;
+
+    return static_cast<std::uint64_t>(subBucketCount + (index & (subBucketCount - 1))) << shift;
+  }
+
+  /// @brief Sets the statistics of a plan known only to its creator.
+  struct PlanStatsSetter
+  {
+    /**
+     * @brief Set the planning time of the plan.
+     * @tparam PlanT Plan type.
+     * @param plan The plan.
+     * @param time Time of the plan creation.
+     */
+    template<typename PlanT>
+    static void setPlanningTime(PlanT& plan, std::chrono::duration<double> time)
+    {
+      plan.mPlanningTime = time;
+    }
+  };
+
+  /**
+   * @class PlanStatsRecorder
+   * @brief Accumulates the execution times of a plan. Cpu executions are timed by the steady clock, spst gpu ones by
+   *        the events recorded on the execution stream, they are resolved on the first read after the execution. The
+   *        recorder is thread safe, the latency histogram is updated without locking.
+   */
+  class PlanStatsRecorder
+  {
+    public:
+      using Duration      = std::chrono::duration<double>;
+      using LatencyCounts = std::array<std::uint64_t, latencyBucketCount>;
+
+      /// @brief Default constructor.
+      PlanStatsRecorder() = default;
+
+      /// @brief Copy constructor is deleted.
+      PlanStatsRecorder(const PlanStatsRecorder&) = delete;
+
+      /// @brief Move constructor, takes over the accumulated times.
+      PlanStatsRecorder(PlanStatsRecorder&& other)
+      {
+        std::lock_guard lock{other.mMutex};
+
+        mCount         = other.mCount;
+        mTotal         = other.mTotal;
+        mMin           = other.mMin;
+        mMax           = other.mMax;
+
+        for (std::size_t i{}; i < latencyBucketCount; ++i)
+        {
+          mLatencyCounts[i].store(other.mLatencyCounts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+#     ifdef AFFT_ENABLE_COUNTERS
+        mCounters      = other.mCounters;
+#     endif
+#     if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        mPendingEvents = std::move(other.mPendingEvents);
+#     endif
+      }
+
+      /// @brief Destructor. Releases the unresolved events.
+      ~PlanStatsRecorder()
+      {
+#     if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        for (auto& events : mPendingEvents)
+        {
+          destroyEvents(events);
+        }
+#     endif
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      PlanStatsRecorder& operator=(const PlanStatsRecorder&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      PlanStatsRecorder& operator=(PlanStatsRecorder&&) = delete;
+
+      /**
+       * @brief Record the executions of a measured time.
+       * @param time Time of all the executions.
+       * @param count Number of the executions, the time of each is the average one.
+       */
+      void record(Duration time, std::size_t count = 1)
+      {
+        recordLatency(time, count);
+
+        std::lock_guard lock{mMutex};
+
+        recordLocked(time, count);
+      }
+
+#   ifdef AFFT_ENABLE_COUNTERS
+      /**
+       * @brief Record the executions of measured hardware counters.
+       * @param time Time of all the executions.
+       * @param counters Hardware counters of all the executions.
+       * @param count Number of the executions.
+       */
+      void record(Duration time, const perf::Counters& counters, std::size_t count = 1)
+      {
+        recordLatency(time, count);
+
+        std::lock_guard lock{mMutex};
+
+        recordLocked(time, count);
+        mCounters += counters;
+      }
+
+      /**
+       * @brief Get the accumulated hardware counters of the cpu executions.
+       * @return Hardware counters.
+       */
+      [[nodiscard]] perf::Counters getCounters()
+      {
+        std::lock_guard lock{mMutex};
+
+        return mCounters;
+      }
+#   endif
+
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+#     if defined(AFFT_ENABLE_CUDA)
+      using Stream = cudaStream_t;
+      using Event  = cudaEvent_t;
+#     else
+      using Stream = hipStream_t;
+      using Event  = hipEvent_t;
+#     endif
+
+      /// @brief Events enclosing the executions enqueued to a stream.
+      struct Events
+      {
+        Event       start{}; ///< Recorded before the executions.
+        Event       stop{};  ///< Recorded after the executions.
+        std::size_t count{}; ///< Number of the executions.
+      };
+
+      /**
+       * @brief Record the start event of gpu executions on the stream.
+       * @param stream Execution stream.
+       * @return Events, pass them to stopGpu() after enqueuing the executions.
+       */
+      [[nodiscard]] Events startGpu(Stream stream)
+      {
+        Events events{};
+
+#     if defined(AFFT_ENABLE_CUDA)
+        cuda::checkError(cudaEventCreate(&events.start));
+        cuda::checkError(cudaEventCreate(&events.stop));
+        cuda::checkError(cudaEventRecord(events.start, stream));
+#     else
+        hip::checkError(hipEventCreate(&events.start));
+        hip::checkError(hipEventCreate(&events.stop));
+        hip::checkError(hipEventRecord(events.start, stream));
+#     endif
+
+        return events;
+      }
+
+      /**
+       * @brief Record the stop event of gpu executions on the stream, the time is resolved when read.
+       * @param events Events returned by startGpu().
+       * @param stream Execution stream.
+       * @param count Number of the enqueued executions.
+       */
+      void stopGpu(Events events, Stream stream, std::size_t count = 1)
+      {
+        events.count = count;
+
+#     if defined(AFFT_ENABLE_CUDA)
+        cuda::checkError(cudaEventRecord(events.stop, stream));
+#     else
+        hip::checkError(hipEventRecord(events.stop, stream));
+#     endif
+
+        std::lock_guard lock{mMutex};
+
+        mPendingEvents.push_back(events);
+      }
+#   endif
+
+      /**
+       * @brief Get the accumulated times, waits for the pending gpu executions.
+       * @param count Number of the executions.
+       * @param total Total time.
+       * @param min Minimum time.
+       * @param max Maximum time.
+       */
+      void get(std::uint64_t& count, Duration& total, Duration& min, Duration& max)
+      {
+        std::lock_guard lock{mMutex};
+
+        resolvePendingLocked();
+
+        count = mCount;
+        total = mTotal;
+        min   = mMin;
+        max   = mMax;
+      }
+
+      /**
+       * @brief Get the latency histogram, waits for the pending gpu executions.
+       * @param reset Clear the histogram, each execution is counted by exactly one of the consecutive reads.
+       * @return Execution counts of the latency buckets.
+       */
+      [[nodiscard]] LatencyCounts getLatencyCounts(bool reset)
+      {
+        {
+          std::lock_guard lock{mMutex};
+
+          resolvePendingLocked();
+        }
+
+        LatencyCounts counts{};
+
+        for (std::size_t i{}; i < latencyBucketCount; ++i)
+        {
+          counts[i] = (reset) ? mLatencyCounts[i].exchange(0, std::memory_order_relaxed)
+                              : mLatencyCounts[i].load(std::memory_order_relaxed);
+        }
+
+        return counts;
+      }
+    private:
+      /**
+       * @brief Count the executions in the latency histogram.
+       * @param time Time of all the executions.
+       * @param count Number of the executions, each of the average time.
+       */
+      void recordLatency(Duration time, std::size_t count) noexcept
+      {
+        if (count == 0)
+        {
+          return;
+        }
+
+        const auto average  = std::chrono::duration_cast<std::chrono::nanoseconds>(time / static_cast<double>(count));
+        const auto bucketId = getLatencyBucketIndex(static_cast<std::uint64_t>(std::max<std::int64_t>(average.count(), 0)));
+
+        mLatencyCounts[bucketId].fetch_add(count, std::memory_order_relaxed);
+      }
+
+      /// @brief Record the resolved pending gpu executions, the mutex must be locked.
+      void resolvePendingLocked()
+      {
+#     if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+        for (auto& events : mPendingEvents)
+        {
+          float milliseconds{};
+
+#       if defined(AFFT_ENABLE_CUDA)
+          cuda::checkError(cudaEventSynchronize(events.stop));
+          cuda::checkError(cudaEventElapsedTime(&milliseconds, events.start, events.stop));
+#       else
+          hip::checkError(hipEventSynchronize(events.stop));
+          hip::checkError(hipEventElapsedTime(&milliseconds, events.start, events.stop));
+#       endif
+
+          const std::chrono::duration<double, std::milli> time{milliseconds};
+
+          recordLatency(time, events.count);
+          recordLocked(time, events.count);
+          destroyEvents(events);
+        }
+
+        mPendingEvents.clear();
+#     endif
+      }
+
+      /**
+       * @brief Record the executions, the mutex must be locked.
+       * @param time Time of all the executions.
+       * @param count Number of the executions.
+       */
+      void recordLocked(Duration time, std::size_t count)
+      {
+        if (count == 0)
+        {
+          return;
+        }
+
+        const Duration average = time / static_cast<double>(count);
+
+        mMin    = (mCount == 0) ? average : std::min(mMin, average);
+        mMax    = (mCount == 0) ? average : std::max(mMax, average);
+        mCount += count;
+        mTotal += time;
+      }
+
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      /**
+       * @brief Destroy the events.
+       * @param events Events.
+       */
+      static void destroyEvents(Events& events) noexcept
+      {
+#     if defined(AFFT_ENABLE_CUDA)
+        cudaEventDestroy(events.start);
+        cudaEventDestroy(events.stop);
+#     else
+        (void)hipEventDestroy(events.start);
+        (void)hipEventDestroy(events.stop);
+#     endif
+      }
+
+      std::vector<Events> mPendingEvents{}; ///< Events of the gpu executions whose time was not read yet.
+#   endif
+
+      std::mutex    mMutex{};   ///< Guards the accumulated times.
+      std::uint64_t mCount{};   ///< Number of the executions.
+      Duration      mTotal{};   ///< Total time of the executions.
+      Duration      mMin{};     ///< Minimum time of an execution.
+      Duration      mMax{};     ///< Maximum time of an execution.
+
+      std::array<std::atomic<std::uint64_t>, latencyBucketCount> mLatencyCounts{}; ///< Executions of the latency buckets.
+#   ifdef AFFT_ENABLE_COUNTERS
+      perf::Counters mCounters{}; ///< Hardware counters of the cpu executions.
+#   endif
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_PLAN_STATS_RECORDER_HPP */
@@ -0,0 +1,258 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_PROGRESSIVE_PLAN_HPP
+#define AFFT_DETAIL_PROGRESSIVE_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "ThreadPool.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @class ProgressivePlan
+   * @brief Plan executing a quickly created initial plan until a better plan created in the background is ready, then
+   *        the better plan replaces the initial one. Only spst cpu plans are supported. With external workspace, a
+   *        better plan requiring more workspace than the initial one is discarded, so the workspace sized by the caller
+   *        stays sufficient.
+   */
+  class ProgressivePlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Submits the creation of the better plan to the planner thread pool.
+       * @tparam CreateFnT Create function type, must return std::unique_ptr<Plan>.
+       * @param desc Plan description.
+       * @param initialPlan The initial plan.
+       * @param createFn The function creating the better plan, executed on a planner thread.
+       */
+      template<typename CreateFnT>
+      ProgressivePlan(const Desc& desc, std::unique_ptr<Plan> initialPlan, CreateFnT&& createFn)
+      : Plan{desc},
+        mState{std::make_shared<State>()}
+      {
+        if (!initialPlan)
+        {
+          throw std::invalid_argument{"Initial plan must not be null"};
+        }
+
+        mState->plan = std::move(initialPlan);
+        copySizes(*mState->plan, mState->initialSizes);
+        mState->sizes = &mState->initialSizes;
+
+        // The task keeps the state alive, so it may safely outlive the plan. Failing to create the better plan keeps
+        // the initial one.
+        (void)getPlannerThreadPool().submit([state = mState, createFn = std::forward<CreateFnT>(createFn)]() mutable
+        {
+          std::shared_ptr<Plan> plan{};
+
+          try
+          {
+            plan = createFn();
+          }
+          catch (...)
+          {}
+
+          if (plan && !fitsWorkspace(*plan, state->initialSizes.workspace))
+          {
+            plan.reset();
+          }
+
+          // The final sizes are written before they are published, readers only access them through State::sizes
+          if (plan)
+          {
+            copySizes(*plan, state->finalSizes);
+          }
+
+          std::lock_guard lock{state->mutex};
+
+          if (plan)
+          {
+            state->plan  = std::move(plan);
+            state->sizes = &state->finalSizes;
+          }
+
+          state->isFinal = true;
+        });
+      }
+
+      /// @brief Destructor.
+      ~ProgressivePlan() override = default;
+
+      /**
+       * @brief Get backend of the currently used plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return getCurrentPlan()->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the currently used plan. The view stays valid after the plan is replaced.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        std::lock_guard lock{mState->mutex};
+        return View<std::size_t>{mState->sizes->workspace.data(), mState->sizes->workspace.size()};
+      }
+
+      /**
+       * @brief Get the memory held by the currently used plan. The view stays valid after the plan is replaced.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        std::lock_guard lock{mState->mutex};
+        return View<std::size_t>{mState->sizes->backendMemory.data(), mState->sizes->backendMemory.size()};
+      }
+
+      /**
+       * @brief Get the backend feedback of the currently used plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        return getCurrentPlan()->getBackendFeedback();
+      }
+
+      /**
+       * @brief Has the background planning finished?
+       * @return True if the currently used plan will not be replaced anymore, otherwise false.
+       */
+      [[nodiscard]] bool isFinal() const noexcept
+      {
+        std::lock_guard lock{mState->mutex};
+        return mState->isFinal;
+      }
+
+    protected:
+      /**
+       * @brief Execute the currently used plan.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        executeBackendImplOf(*getCurrentPlan(), src, dst, execParams);
+      }
+
+      /**
+       * @brief Execute the batch of transforms by the currently used plan, all of them by the same plan.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        executeBatchBackendImplOf(*getCurrentPlan(), srcs, dsts, execParams);
+      }
+
+    private:
+      /// @brief Workspace and backend memory sizes of a plan, kept by the state so the views outlive the plan.
+      struct Sizes
+      {
+        std::vector<std::size_t> workspace{};     ///< The workspace size.
+        std::vector<std::size_t> backendMemory{}; ///< The backend memory size.
+      };
+
+      /// @brief State shared with the background planning task.
+      struct State
+      {
+        mutable std::mutex    mutex{};        ///< The mutex guarding the state.
+        std::shared_ptr<Plan> plan{};         ///< The currently used plan.
+        Sizes                 initialSizes{}; ///< The sizes of the initial plan.
+        Sizes                 finalSizes{};   ///< The sizes of the better plan, written once before it is used.
+        const Sizes*          sizes{};        ///< The sizes of the currently used plan.
+        bool                  isFinal{};      ///< Has the background planning finished?
+      };
+
+      /**
+       * @brief Copy the sizes of a plan.
+       * @param plan The plan.
+       * @param sizes The sizes to be filled.
+       */
+      static void copySizes(const Plan& plan, Sizes& sizes)
+      {
+        const auto workspaceSize     = plan.getWorkspaceSize();
+        const auto backendMemorySize = plan.getBackendMemorySize();
+
+        sizes.workspace.assign(workspaceSize.begin(), workspaceSize.end());
+        sizes.backendMemory.assign(backendMemorySize.begin(), backendMemorySize.end());
+      }
+
+      /**
+       * @brief Check if the plan fits the workspace of the initial plan. Only external workspace is sized by the
+       *        caller, a workspace held by the plan always fits.
+       * @param plan The plan.
+       * @param initialWorkspaceSize The workspace size of the initial plan.
+       * @return True if the plan may replace the initial one, otherwise false.
+       */
+      [[nodiscard]] static bool fitsWorkspace(const Plan& plan, const std::vector<std::size_t>& initialWorkspaceSize)
+      {
+        if (!DescGetter::get(plan).useExternalWorkspace())
+        {
+          return true;
+        }
+
+        const auto workspaceSize = plan.getWorkspaceSize();
+
+        for (std::size_t i{}; i < workspaceSize.size(); ++i)
+        {
+          if (workspaceSize[i] > ((i < initialWorkspaceSize.size()) ? initialWorkspaceSize[i] : 0))
+          {
+            return false;
+          }
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Get the currently used plan. The returned plan stays valid even if it is replaced meanwhile.
+       * @return The currently used plan.
+       */
+      [[nodiscard]] std::shared_ptr<Plan> getCurrentPlan() const noexcept
+      {
+        std::lock_guard lock{mState->mutex};
+        return mState->plan;
+      }
+
+      std::shared_ptr<State> mState; ///< The shared state.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_PROGRESSIVE_PLAN_HPP */
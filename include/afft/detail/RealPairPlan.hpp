@@ -0,0 +1,404 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_REAL_PAIR_PLAN_HPP
+#define AFFT_DETAIL_REAL_PAIR_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "ThreadPool.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Get the number of transforms of a plan, the product of the extents of the non-transformed axes.
+   * @param desc Plan description.
+   * @return Number of transforms.
+   */
+  [[nodiscard]] inline std::size_t getTransformCount(const Desc& desc)
+  {
+    const auto shape = desc.getShape();
+    const auto dims  = desc.getTransformDimsAs<std::size_t>();
+
+    return std::accumulate(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>{}) /
+           std::accumulate(dims.data(), dims.data() + desc.getTransformRank(), std::size_t{1}, std::multiplies<>{});
+  }
+
+  /**
+   * @brief Check if a spst cpu real-to-complex plan of an even number of transforms may be computed by a real pair
+   *        plan packing two real transforms into one complex one.
+   * @param desc Plan description.
+   * @return True if the real pair plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isRealPairLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu ||
+        desc.getDistribution() != Distribution::spst ||
+        desc.getTransform() != Transform::dft ||
+        desc.getTransformDesc<Transform::dft>().type != dft::Type::realToComplex ||
+        desc.getComplexFormat() != ComplexFormat::interleaved ||
+        desc.hasLogicalSrcShape() ||
+        desc.hasDstWindow())
+    {
+      return false;
+    }
+
+    const auto precision = desc.getPrecision().execution;
+
+    if (!desc.hasUniformPrecision() || (precision != Precision::f32 && precision != Precision::f64))
+    {
+      return false;
+    }
+
+    const auto transformCount = getTransformCount(desc);
+
+    return transformCount >= 2 && transformCount % 2 == 0;
+  }
+
+  /**
+   * @brief Make the description of the complex plan of a real pair plan. It transforms the packed pairs in-place.
+   * @param desc Plan description, see isRealPairLayout().
+   * @return Plan description of shape {pairCount, transform dims...} transformed along the trailing axes.
+   */
+  [[nodiscard]] inline Desc makeRealPairComplexDesc(const Desc& desc)
+  {
+    const auto transformRank = desc.getTransformRank();
+    const auto dims          = desc.getTransformDimsAs<std::size_t>();
+
+    MaxDimArray<std::size_t> pairShape{};
+    MaxDimArray<std::size_t> pairAxes{};
+
+    pairShape[0] = getTransformCount(desc) / 2;
+
+    for (std::size_t i{}; i < transformRank; ++i)
+    {
+      pairShape[i + 1] = dims[i];
+      pairAxes[i]      = i + 1;
+    }
+
+    dft::Parameters<> pairParams{};
+    pairParams.direction     = Direction::forward;
+    pairParams.precision     = desc.getPrecision();
+    pairParams.shape         = View<std::size_t>{pairShape.data(), transformRank + 1};
+    pairParams.axes          = View<std::size_t>{pairAxes.data(), transformRank};
+    pairParams.normalization = desc.getNormalization();
+    pairParams.placement     = Placement::inPlace;
+    pairParams.type          = dft::Type::complexToComplex;
+
+    auto archParams = desc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+    archParams.memoryLayout = {};
+
+    return Desc{pairParams, archParams};
+  }
+
+  /**
+   * @class RealPairPlan
+   * @brief Plan computing pairs of real-to-complex transforms by one complex transform. The transforms 2p and 2p + 1
+   *        are packed as the real and the imaginary part of the complex pair p, the complex plan transforms all pairs
+   *        and the split pass recovers both spectra from the Hermitian symmetry, X = (Z[k] + conj(Z[-k])) / 2 and
+   *        Y = (Z[k] - conj(Z[-k])) / 2i. The source and the destination may have any strides, in-place plans are
+   *        supported as the whole source is packed before the destination is written. Only spst cpu plans are
+   *        supported. Executions of the plan are serialized, they share the packed buffer.
+   */
+  class RealPairPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the packed buffer.
+       * @param desc Plan description, see isRealPairLayout().
+       * @param complexPlan Plan created from makeRealPairComplexDesc(desc).
+       */
+      RealPairPlan(const Desc& desc, std::unique_ptr<Plan> complexPlan)
+      : Plan{desc},
+        mPlan{std::move(complexPlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Complex plan must not be null"};
+        }
+
+        const auto& cpuDesc       = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  alignment     = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+        const auto  shapeRank     = desc.getShapeRank();
+        const auto  shape         = desc.getShape();
+        const auto  transformRank = desc.getTransformRank();
+        const auto  axes          = desc.getTransformAxes();
+        const auto  dims          = desc.getTransformDimsAs<std::size_t>();
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto& memoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+        const auto  srcStrides   = memoryLayout.getSrcStrides();
+        const auto  dstStrides   = memoryLayout.getDstStrides();
+
+        auto isTransformAxis = [&](std::size_t axis)
+        {
+          return std::find(axes.begin(), axes.end(), axis) != axes.end();
+        };
+
+        // transforms enumerate the indices of the non-transformed axes, the last axis varies fastest
+        const std::size_t transformCount = getTransformCount(desc);
+
+        mSrcTransformOffsets.resize(transformCount);
+        mDstTransformOffsets.resize(transformCount);
+
+        for (std::size_t t{}; t < transformCount; ++t)
+        {
+          std::size_t index = t;
+
+          for (std::size_t i = shapeRank; i > 0; --i)
+          {
+            if (isTransformAxis(i - 1))
+            {
+              continue;
+            }
+
+            mSrcTransformOffsets[t] += (index % shape[i - 1]) * srcStrides[i - 1];
+            mDstTransformOffsets[t] += (index % shape[i - 1]) * dstStrides[i - 1];
+            index                   /= shape[i - 1];
+          }
+        }
+
+        // the packed elements are row-major in the transform dims, the destination has the last one reduced
+        MaxDimArray<std::size_t> reducedDims{dims};
+        reducedDims[transformRank - 1] = dims[transformRank - 1] / 2 + 1;
+
+        mElemCount    = std::accumulate(dims.data(), dims.data() + transformRank, std::size_t{1}, std::multiplies<>{});
+        mReducedCount = std::accumulate(reducedDims.data(),
+                                        reducedDims.data() + transformRank,
+                                        std::size_t{1},
+                                        std::multiplies<>{});
+
+        mSrcElemOffsets.resize(mElemCount);
+
+        for (std::size_t l{}; l < mElemCount; ++l)
+        {
+          std::size_t index = l;
+
+          for (std::size_t i = transformRank; i > 0; --i)
+          {
+            mSrcElemOffsets[l] += (index % dims[i - 1]) * srcStrides[axes[i - 1]];
+            index              /= dims[i - 1];
+          }
+        }
+
+        mDstElemOffsets.resize(mReducedCount);
+        mSpectrumIndices.resize(mReducedCount);
+        mMirroredIndices.resize(mReducedCount);
+
+        for (std::size_t l{}; l < mReducedCount; ++l)
+        {
+          std::size_t index    = l;
+          std::size_t linear   = 0;
+          std::size_t mirrored = 0;
+          std::size_t extent   = 1;
+
+          for (std::size_t i = transformRank; i > 0; --i)
+          {
+            const std::size_t k = index % reducedDims[i - 1];
+            const std::size_t n = dims[i - 1];
+
+            mDstElemOffsets[l] += k * dstStrides[axes[i - 1]];
+            linear             += k * extent;
+            mirrored           += ((n - k) % n) * extent;
+            extent             *= n;
+            index              /= reducedDims[i - 1];
+          }
+
+          mSpectrumIndices[l] = linear;
+          mMirroredIndices[l] = mirrored;
+        }
+
+        const std::size_t cmplSize = 2 * sizeOf(desc.getPrecision().execution);
+
+        mPackedSize = transformCount / 2 * mElemCount * cmplSize;
+        mPacked     = cpu::makeAlignedUnique<std::byte[]>(alignment, cpuDesc.hugePagePolicy, mPackedSize);
+
+        const auto planMemorySize = mPlan->getBackendMemorySize();
+
+        mBackendMemorySize = mPackedSize +
+                             (mSrcTransformOffsets.size() + mDstTransformOffsets.size() + mSrcElemOffsets.size() +
+                              mDstElemOffsets.size() + mSpectrumIndices.size() + mMirroredIndices.size()) *
+                               sizeof(std::size_t) +
+                             (planMemorySize.empty() ? 0 : planMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~RealPairPlan() override = default;
+
+      /**
+       * @brief Get backend of the complex plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the complex plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the complex plan and the internal buffers.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the complex plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "real transforms computed in pairs by a complex transform";
+      }
+
+    protected:
+      /**
+       * @brief Pack the source pairs, execute the complex plan and split the spectra into the destination.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const auto lock = lockExecution(mMutex);
+
+        if (DescGetter::get(*this).getPrecision().execution == Precision::f32)
+        {
+          computePairs(static_cast<const float*>(src.front()), static_cast<std::complex<float>*>(dst.front()), execParams);
+        }
+        else
+        {
+          computePairs(static_cast<const double*>(src.front()), static_cast<std::complex<double>*>(dst.front()), execParams);
+        }
+      }
+
+      /**
+       * @brief Execute the batch one transform after another, the transforms share the packed buffer.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      /**
+       * @brief Execute the real pair transform.
+       * @tparam T Real type.
+       * @param src Source buffer.
+       * @param dst Destination buffer, may alias the source.
+       * @param execParams Execution parameters.
+       */
+      template<typename T>
+      void computePairs(const T* src, std::complex<T>* dst, const afft::spst::cpu::ExecutionParameters& execParams)
+      {
+        const auto        threadLimit = DescGetter::get(*this).getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+        const std::size_t pairCount   = mSrcTransformOffsets.size() / 2;
+
+        auto* packed = reinterpret_cast<std::complex<T>*>(mPacked.get());
+
+        parallelFor(pairCount, threadLimit, [&](std::size_t p)
+        {
+          const T*         re        = src + mSrcTransformOffsets[2 * p];
+          const T*         im        = src + mSrcTransformOffsets[2 * p + 1];
+          std::complex<T>* packedRow = packed + p * mElemCount;
+
+          for (std::size_t l{}; l < mElemCount; ++l)
+          {
+            packedRow[l] = std::complex<T>{re[mSrcElemOffsets[l]], im[mSrcElemOffsets[l]]};
+          }
+        });
+
+        void* packedPtr = packed;
+
+        executeBackendImplOf(*mPlan, View<void*>{&packedPtr, 1}, View<void*>{&packedPtr, 1}, execParams);
+
+        parallelFor(pairCount, threadLimit, [&](std::size_t p)
+        {
+          const std::complex<T>* spectrum = packed + p * mElemCount;
+          std::complex<T>*       first    = dst + mDstTransformOffsets[2 * p];
+          std::complex<T>*       second   = dst + mDstTransformOffsets[2 * p + 1];
+
+          for (std::size_t l{}; l < mReducedCount; ++l)
+          {
+            const std::complex<T> z = spectrum[mSpectrumIndices[l]];
+            const std::complex<T> w = std::conj(spectrum[mMirroredIndices[l]]);
+            const std::complex<T> d = z - w;
+
+            first[mDstElemOffsets[l]]  = (z + w) * T{0.5};
+            second[mDstElemOffsets[l]] = std::complex<T>{d.imag(), -d.real()} * T{0.5};
+          }
+        });
+      }
+
+      std::unique_ptr<Plan>              mPlan{};                ///< The complex plan.
+      std::vector<std::size_t>           mSrcTransformOffsets{}; ///< The source offset of each transform.
+      std::vector<std::size_t>           mDstTransformOffsets{}; ///< The destination offset of each transform.
+      std::vector<std::size_t>           mSrcElemOffsets{};      ///< The source offset of each element of a transform.
+      std::vector<std::size_t>           mDstElemOffsets{};      ///< The destination offset of each spectrum element.
+      std::vector<std::size_t>           mSpectrumIndices{};     ///< The packed index of each spectrum element.
+      std::vector<std::size_t>           mMirroredIndices{};     ///< The packed index of the mirrored element.
+      std::size_t                        mElemCount{};           ///< The number of elements of a transform.
+      std::size_t                        mReducedCount{};        ///< The number of spectrum elements of a transform.
+      std::size_t                        mPackedSize{};          ///< The packed buffer size in bytes.
+      cpu::AlignedUniquePtr<std::byte[]> mPacked{};              ///< The packed pairs, transformed in-place.
+      std::size_t                        mBackendMemorySize{};   ///< The internal memory size.
+      std::mutex                         mMutex{};               ///< Serializes the executions.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_REAL_PAIR_PLAN_HPP */
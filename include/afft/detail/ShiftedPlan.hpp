@@ -0,0 +1,584 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_SHIFTED_PLAN_HPP
+#define AFFT_DETAIL_SHIFTED_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "TransposedPlan.hpp"
+#include "transpose.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Check if the source shifts of a plan are applied by rotating the source. A complex-to-real transform has a
+   *        real destination, so the phase ramp equivalent to the source shift cannot be applied to it.
+   * @param desc Plan description.
+   * @return True if the source is rotated into an internal buffer, false otherwise.
+   */
+  [[nodiscard]] inline bool isSrcShiftRotated(const Desc& desc)
+  {
+    return !desc.getSrcShiftAxes().empty() &&
+           desc.getTransformDesc<Transform::dft>().type == dft::Type::complexToReal;
+  }
+
+  /**
+   * @brief Check if the source shifts of a plan are applied as a phase ramp on the destination.
+   * @param desc Plan description.
+   * @return True if the destination is modulated, false otherwise.
+   */
+  [[nodiscard]] inline bool isSrcShiftModulated(const Desc& desc)
+  {
+    return !desc.getSrcShiftAxes().empty() && !isSrcShiftRotated(desc);
+  }
+
+  /**
+   * @brief Make the description of the plan computing the unshifted transform. A rotated side is computed from or into
+   *        an internal buffer of the default strides.
+   * @param desc Plan description with shifts.
+   * @return Plan description without shifts.
+   */
+  [[nodiscard]] inline Desc makeUnshiftedDesc(const Desc& desc)
+  {
+    const bool isSrcRotated = isSrcShiftRotated(desc);
+    const bool isDstRotated = !desc.getDstShiftAxes().empty();
+
+    Desc unshiftedDesc{desc};
+    unshiftedDesc.resetShift();
+
+    if (isSrcRotated || isDstRotated)
+    {
+      auto& cpuDesc = unshiftedDesc.getArchDesc<Target::cpu, Distribution::spst>();
+
+      unshiftedDesc.setPlacement(Placement::outOfPlace);
+
+      if (isSrcRotated)
+      {
+        cpuDesc.memoryLayout.resetSrcStrides();
+      }
+
+      if (isDstRotated)
+      {
+        cpuDesc.memoryLayout.resetDstStrides();
+      }
+    }
+
+    return unshiftedDesc;
+  }
+
+  /**
+   * @class ShiftedPlan
+   * @brief Plan storing the source or the destination centered along some transform axes, as fftshift and ifftshift do.
+   *        Along a shifted axis of size n the element of index i is stored at (i + n / 2) % n. The cpu backends have no
+   *        load or store callbacks, so the shifts are fused into a single pass over the destination. A source shift
+   *        multiplies the spectrum by the phase ramp exp(+-2 pi i k (n / 2) / n), which is the (-1)^k checkerboard for
+   *        even sizes, a destination shift rotates the output of the unshifted plan computed into an internal buffer.
+   *        The source of a complex-to-real transform is rotated into an internal buffer instead, its real destination
+   *        cannot be modulated. Only spst cpu plans are supported. Executions using internal buffers are serialized.
+   */
+  class ShiftedPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the internal buffers.
+       * @param desc Plan description with shifts.
+       * @param unshiftedPlan Plan created from makeUnshiftedDesc(desc).
+       */
+      ShiftedPlan(const Desc& desc, std::unique_ptr<Plan> unshiftedPlan)
+      : Plan{desc},
+        mPlan{std::move(unshiftedPlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Unshifted plan must not be null"};
+        }
+
+        mIsSrcRotated   = isSrcShiftRotated(desc);
+        mIsDstRotated   = !desc.getDstShiftAxes().empty();
+        mIsDstModulated = isSrcShiftModulated(desc);
+
+        if (mIsDstModulated)
+        {
+          switch (desc.getPrecision().destination)
+          {
+          case Precision::_float:
+          case Precision::_double:
+            break;
+          default:
+            throw std::invalid_argument{"Source shifts support only float and double destination precision"};
+          }
+        }
+
+        const auto& cpuDesc   = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  shapeRank = desc.getShapeRank();
+        const auto  shape     = desc.getShape();
+        const auto  alignment = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        Desc unshiftedDesc{makeUnshiftedDesc(desc)};
+        unshiftedDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto& memoryLayout          = layoutDesc.getMemoryLayout<Distribution::spst>();
+        const auto& unshiftedMemoryLayout = unshiftedDesc.getMemoryLayout<Distribution::spst>();
+
+        mShapeRank = shapeRank;
+        mSrcShape  = desc.getSrcShape();
+        mDstShape  = desc.getDstShape();
+
+        std::copy_n(memoryLayout.getSrcStrides().begin(), shapeRank, mSrcStrides.begin());
+        std::copy_n(memoryLayout.getDstStrides().begin(), shapeRank, mDstStrides.begin());
+        std::copy_n(unshiftedMemoryLayout.getSrcStrides().begin(), shapeRank, mUnshiftedSrcStrides.begin());
+        std::copy_n(unshiftedMemoryLayout.getDstStrides().begin(), shapeRank, mUnshiftedDstStrides.begin());
+
+        // the source element of index i is stored at (i + n / 2) % n, it is moved back by n - n / 2
+        for (const auto axis : desc.getSrcShiftAxes())
+        {
+          mSrcRotation[axis] = (mIsSrcRotated) ? shape[axis] - shape[axis] / 2 : 0;
+        }
+
+        for (const auto axis : desc.getDstShiftAxes())
+        {
+          mDstRotation[axis] = shape[axis] / 2;
+        }
+
+        if (mIsDstModulated)
+        {
+          makePhases(desc);
+        }
+
+        const auto [srcBufferCount, dstBufferCount] = desc.getSrcDstBufferCount();
+        const auto [srcSize, dstSize]               = unshiftedDesc.getSpstSrcDstBufferSize();
+
+        auto allocate = [&](std::size_t count, std::size_t size, std::vector<void*>& ptrs)
+        {
+          for (std::size_t i{}; i < count; ++i)
+          {
+            ptrs.push_back(mBuffers.emplace_back(cpu::makeAlignedUnique<std::byte[]>(alignment,
+                                                                                     cpuDesc.hugePagePolicy,
+                                                                                     size)).get());
+          }
+
+          mBackendMemorySize += count * size;
+        };
+
+        if (mIsSrcRotated)
+        {
+          allocate(srcBufferCount, srcSize, mSrcBufferPtrs);
+        }
+
+        if (mIsDstRotated)
+        {
+          allocate(dstBufferCount, dstSize, mDstBufferPtrs);
+        }
+
+        const bool isPlanarSrc = (desc.getComplexFormat() == ComplexFormat::planar) &&
+                                 (desc.getSrcDstComplexity().first == Complexity::complex);
+
+        mSrcElemSize = desc.sizeOfSrcElem() / (isPlanarSrc ? 2 : 1);
+        mDstElemSize = getDstBufferElemSize(desc);
+
+        const auto planMemorySize = mPlan->getBackendMemorySize();
+
+        mBackendMemorySize += (planMemorySize.empty() ? 0 : planMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~ShiftedPlan() override = default;
+
+      /**
+       * @brief Get backend of the unshifted plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the unshifted plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the unshifted plan and the internal buffers.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the unshifted plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        auto append = [&](std::string_view note)
+        {
+          if (!feedback.empty())
+          {
+            feedback += "; ";
+          }
+
+          feedback += note;
+        };
+
+        if (mIsSrcRotated)
+        {
+          append("source shift rotated into an internal buffer");
+        }
+
+        if (mIsDstModulated)
+        {
+          append("source shift applied as a destination phase ramp");
+        }
+
+        if (mIsDstRotated)
+        {
+          append("destination shift rotated from an internal buffer");
+        }
+
+        return feedback;
+      }
+
+    protected:
+      /**
+       * @brief Execute the unshifted plan and apply the shifts.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const auto threadLimit = mDesc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        std::unique_lock lock{mMutex, std::defer_lock};
+
+        if (!mBuffers.empty() && !mDesc.isRealtime())
+        {
+          lock.lock();
+        }
+
+        View<void*> unshiftedSrc = src;
+        View<void*> unshiftedDst = dst;
+
+        if (mIsSrcRotated)
+        {
+          unshiftedSrc = View<void*>{mSrcBufferPtrs.data(), mSrcBufferPtrs.size()};
+
+          for (std::size_t i{}; i < src.size(); ++i)
+          {
+            copyRotated(src[i], mSrcStrides, unshiftedSrc[i], mUnshiftedSrcStrides, mSrcShape, mSrcRotation, mSrcElemSize);
+          }
+        }
+
+        if (mIsDstRotated)
+        {
+          unshiftedDst = View<void*>{mDstBufferPtrs.data(), mDstBufferPtrs.size()};
+        }
+
+        executeBackendImplOf(*mPlan, unshiftedSrc, unshiftedDst, execParams);
+
+        if (mIsDstModulated)
+        {
+          if (mDesc.getPrecision().destination == Precision::_float)
+          {
+            modulate<float>(unshiftedDst, dst, threadLimit);
+          }
+          else
+          {
+            modulate<double>(unshiftedDst, dst, threadLimit);
+          }
+        }
+        else if (mIsDstRotated)
+        {
+          for (std::size_t i{}; i < dst.size(); ++i)
+          {
+            copyRotated(unshiftedDst[i], mUnshiftedDstStrides, dst[i], mDstStrides, mDstShape, mDstRotation, mDstElemSize);
+          }
+        }
+      }
+
+      /**
+       * @brief Execute the batch, the transforms run one after another if they share the internal buffers.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        if (mBuffers.empty())
+        {
+          Plan::executeBatchBackendImpl(srcs, dsts, execParams);
+          return;
+        }
+
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      /// @brief Number of destination elements modulated by one task of the thread pool.
+      static constexpr std::size_t elemsPerTask{std::size_t{1} << 14};
+
+      /**
+       * @brief Make the phase ramps of the source shift axes over the unshifted destination. The ramp is exactly +-1
+       *        for even sizes.
+       * @param desc Plan description.
+       */
+      void makePhases(const Desc& desc)
+      {
+        constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+        const auto        shape = desc.getShape();
+        const long double sign  = (desc.getDirection() == Direction::forward) ? 1.0L : -1.0L;
+
+        mPhases.resize(mShapeRank);
+
+        for (const auto axis : desc.getSrcShiftAxes())
+        {
+          const std::size_t n = shape[axis];
+          const std::size_t h = n / 2;
+
+          auto& phases = mPhases[axis];
+          phases.resize(mDstShape[axis]);
+
+          for (std::size_t k{}; k < phases.size(); ++k)
+          {
+            const std::size_t m = (h * k) % n;
+
+            if (m == 0 || 2 * m == n)
+            {
+              phases[k] = std::complex<double>{(m == 0) ? 1.0 : -1.0, 0.0};
+            }
+            else
+            {
+              const long double angle = sign * 2.0L * pi * static_cast<long double>(m) / static_cast<long double>(n);
+
+              phases[k] = std::complex<double>{static_cast<double>(std::cos(angle)), static_cast<double>(std::sin(angle))};
+            }
+          }
+        }
+      }
+
+      /**
+       * @brief Copy an array, the element of index i along an axis of size n is stored at (i + rotation) % n.
+       * @param src Source buffer.
+       * @param srcStrides Source strides in elements.
+       * @param dst Destination buffer, must not overlap the source.
+       * @param dstStrides Destination strides in elements.
+       * @param shape Shape of the array.
+       * @param rotation Rotation of each axis.
+       * @param elemSize Size of the element in bytes.
+       */
+      void copyRotated(const void*                     src,
+                       const MaxDimArray<std::size_t>& srcStrides,
+                       void*                           dst,
+                       const MaxDimArray<std::size_t>& dstStrides,
+                       const MaxDimArray<std::size_t>& shape,
+                       const MaxDimArray<std::size_t>& rotation,
+                       std::size_t                     elemSize) const
+      {
+        const auto threadLimit = mDesc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        MaxDimArray<std::size_t> rotatedAxes{};
+        std::size_t              rotatedRank{};
+
+        for (std::size_t i{}; i < mShapeRank; ++i)
+        {
+          if (rotation[i] != 0)
+          {
+            rotatedAxes[rotatedRank++] = i;
+          }
+        }
+
+        // each rotated axis splits into two blocks, [0, n - r) moves to [r, n) and [n - r, n) moves to [0, r)
+        for (std::size_t block{}; block < (std::size_t{1} << rotatedRank); ++block)
+        {
+          MaxDimArray<std::size_t> blockShape{shape};
+          std::size_t              srcOffset{};
+          std::size_t              dstOffset{};
+
+          for (std::size_t j{}; j < rotatedRank; ++j)
+          {
+            const auto axis = rotatedAxes[j];
+            const auto r    = rotation[axis];
+            const auto n    = shape[axis];
+
+            if ((block >> j) & 1)
+            {
+              blockShape[axis]  = r;
+              srcOffset        += (n - r) * srcStrides[axis];
+            }
+            else
+            {
+              blockShape[axis]  = n - r;
+              dstOffset        += r * dstStrides[axis];
+            }
+          }
+
+          transpose::copy(static_cast<const std::byte*>(src) + srcOffset * elemSize,
+                          View<std::size_t>{srcStrides.data(), mShapeRank},
+                          static_cast<std::byte*>(dst) + dstOffset * elemSize,
+                          View<std::size_t>{dstStrides.data(), mShapeRank},
+                          View<std::size_t>{blockShape.data(), mShapeRank},
+                          elemSize,
+                          threadLimit);
+        }
+      }
+
+      /**
+       * @brief Multiply the unshifted destination by the phase ramps and store it rotated by the destination shifts.
+       *        The rows along the last axis are processed in parallel. Without destination shifts the destination is
+       *        modulated in place.
+       * @tparam T Real type of the destination.
+       * @param unshiftedDst Unshifted destination buffers.
+       * @param dst Destination buffers.
+       * @param threadLimit Maximum number of threads.
+       */
+      template<typename T>
+      void modulate(View<void*> unshiftedDst, View<void*> dst, std::size_t threadLimit) const
+      {
+        const bool        isPlanar    = (dst.size() == 2);
+        const std::size_t lastAxis    = mShapeRank - 1;
+        const std::size_t length      = mDstShape[lastAxis];
+        const std::size_t srcStride   = mUnshiftedDstStrides[lastAxis];
+        const std::size_t dstStride   = mDstStrides[lastAxis];
+        const std::size_t rotation    = mDstRotation[lastAxis];
+        const auto&       lastPhases  = mPhases[lastAxis];
+        const std::size_t rowCount    = std::accumulate(mDstShape.begin(),
+                                                        mDstShape.begin() + lastAxis,
+                                                        std::size_t{1},
+                                                        std::multiplies<>{});
+        const std::size_t rowsPerTask = std::max(elemsPerTask / std::max(length, std::size_t{1}), std::size_t{1});
+        const std::size_t taskCount   = (rowCount + rowsPerTask - 1) / rowsPerTask;
+
+        auto load = [&](std::size_t offset) -> std::complex<double>
+        {
+          if (isPlanar)
+          {
+            return {static_cast<const T*>(unshiftedDst[0])[offset], static_cast<const T*>(unshiftedDst[1])[offset]};
+          }
+
+          return static_cast<const std::complex<T>*>(unshiftedDst[0])[offset];
+        };
+
+        auto store = [&](std::size_t offset, std::complex<double> value)
+        {
+          if (isPlanar)
+          {
+            static_cast<T*>(dst[0])[offset] = static_cast<T>(value.real());
+            static_cast<T*>(dst[1])[offset] = static_cast<T>(value.imag());
+          }
+          else
+          {
+            static_cast<std::complex<T>*>(dst[0])[offset] = std::complex<T>{value};
+          }
+        };
+
+        parallelFor(taskCount, threadLimit, [&](std::size_t task)
+        {
+          const std::size_t end = std::min(rowCount, (task + 1) * rowsPerTask);
+
+          for (std::size_t row = task * rowsPerTask; row < end; ++row)
+          {
+            std::size_t          index     = row;
+            std::size_t          srcOffset = 0;
+            std::size_t          dstOffset = 0;
+            std::complex<double> rowPhase{1.0};
+
+            for (std::size_t i = lastAxis; i > 0; --i)
+            {
+              const std::size_t axis      = i - 1;
+              const std::size_t extent    = mDstShape[axis];
+              const std::size_t axisIndex = index % extent;
+
+              srcOffset += axisIndex * mUnshiftedDstStrides[axis];
+              dstOffset += ((axisIndex + mDstRotation[axis]) % extent) * mDstStrides[axis];
+              index     /= extent;
+
+              if (!mPhases[axis].empty())
+              {
+                rowPhase *= mPhases[axis][axisIndex];
+              }
+            }
+
+            for (std::size_t k{}; k < length; ++k)
+            {
+              const auto phase = (lastPhases.empty()) ? rowPhase : rowPhase * lastPhases[k];
+              const auto kDst  = (k + rotation < length) ? k + rotation : k + rotation - length;
+
+              store(dstOffset + kDst * dstStride, load(srcOffset + k * srcStride) * phase);
+            }
+          }
+        });
+      }
+
+      std::unique_ptr<Plan>                           mPlan{};                ///< The unshifted plan.
+      std::size_t                                     mShapeRank{};           ///< The rank of the shape.
+      MaxDimArray<std::size_t>                        mSrcShape{};            ///< The source shape.
+      MaxDimArray<std::size_t>                        mDstShape{};            ///< The destination shape.
+      MaxDimArray<std::size_t>                        mSrcStrides{};          ///< The source strides.
+      MaxDimArray<std::size_t>                        mDstStrides{};          ///< The destination strides.
+      MaxDimArray<std::size_t>                        mUnshiftedSrcStrides{}; ///< The source strides of the unshifted plan.
+      MaxDimArray<std::size_t>                        mUnshiftedDstStrides{}; ///< The destination strides of the unshifted plan.
+      MaxDimArray<std::size_t>                        mSrcRotation{};         ///< The rotation of the source into the unshifted source.
+      MaxDimArray<std::size_t>                        mDstRotation{};         ///< The rotation of the unshifted destination.
+      std::vector<std::vector<std::complex<double>>>  mPhases{};              ///< The phase ramps of the axes, empty if not shifted.
+      bool                                            mIsSrcRotated{};        ///< Is the source rotated into an internal buffer?
+      bool                                            mIsDstRotated{};        ///< Is the destination rotated from an internal buffer?
+      bool                                            mIsDstModulated{};      ///< Is the destination modulated by the phase ramps?
+      std::size_t                                     mSrcElemSize{};         ///< The source buffer element size in bytes.
+      std::size_t                                     mDstElemSize{};         ///< The destination buffer element size in bytes.
+      std::vector<cpu::AlignedUniquePtr<std::byte[]>> mBuffers{};             ///< The internal buffers.
+      std::vector<void*>                              mSrcBufferPtrs{};       ///< The internal source buffer pointers.
+      std::vector<void*>                              mDstBufferPtrs{};       ///< The internal destination buffer pointers.
+      std::size_t                                     mBackendMemorySize{};   ///< The internal memory size.
+      std::mutex                                      mMutex{};               ///< Serializes the executions using internal buffers.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_SHIFTED_PLAN_HPP */
@@ -0,0 +1,485 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_SIX_STEP_PLAN_HPP
+#define AFFT_DETAIL_SIX_STEP_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "transpose.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /// @brief Minimum length of a transform computed by the six-step plan, shorter transforms fit the last level cache.
+  inline constexpr std::size_t sixStepMinLength{std::size_t{1} << 26};
+
+  /// @brief Minimum length of both factors of the six-step decomposition.
+  inline constexpr std::size_t sixStepMinFactor{64};
+
+  /**
+   * @brief Get the factor n1 of the six-step decomposition of the length n = n1 * n2, the largest divisor not exceeding
+   *        the square root.
+   * @param length Transform length.
+   * @return The factor n1, smaller than sixStepMinFactor if the length has no suitable factorization.
+   */
+  [[nodiscard]] inline std::size_t getSixStepFactor(std::size_t length)
+  {
+    auto n1 = static_cast<std::size_t>(std::sqrt(static_cast<double>(length)));
+
+    while (n1 > 1 && length % n1 != 0)
+    {
+      --n1;
+    }
+
+    return n1;
+  }
+
+  /**
+   * @brief Check if a spst cpu plan is a one-dimensional c2c transform longer than the last level cache, so a six-step
+   *        plan may compute it by cache sized transforms of the backends.
+   * @param desc Plan description.
+   * @return True if the six-step plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isSixStepLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu ||
+        desc.getDistribution() != Distribution::spst ||
+        desc.getTransform() != Transform::dft ||
+        desc.getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex ||
+        desc.getTransformRank() != 1 ||
+        desc.getComplexFormat() != ComplexFormat::interleaved ||
+        desc.hasLogicalSrcShape() ||
+        desc.hasDstWindow())
+    {
+      return false;
+    }
+
+    const auto precision = desc.getPrecision().execution;
+
+    if (!desc.hasUniformPrecision() || (precision != Precision::f32 && precision != Precision::f64))
+    {
+      return false;
+    }
+
+    const auto length = desc.getShape()[desc.getTransformAxes().front()];
+
+    return length >= sixStepMinLength && getSixStepFactor(length) >= sixStepMinFactor;
+  }
+
+  /**
+   * @brief Make the description of a row plan of the six-step plan. It transforms the rows of a work buffer in-place
+   *        without normalization.
+   * @param desc Plan description, see isSixStepLayout().
+   * @param rowCount Number of rows.
+   * @param rowLength Length of the rows.
+   * @return Plan description of shape {rowCount, rowLength} transformed along axis 1.
+   */
+  [[nodiscard]] inline Desc makeSixStepRowsDesc(const Desc& desc, std::size_t rowCount, std::size_t rowLength)
+  {
+    const std::size_t rowsShape[]{rowCount, rowLength};
+    const std::size_t rowsAxes[]{1};
+
+    dft::Parameters<> rowsParams{};
+    rowsParams.direction     = desc.getDirection();
+    rowsParams.precision     = desc.getPrecision();
+    rowsParams.shape         = rowsShape;
+    rowsParams.axes          = rowsAxes;
+    rowsParams.normalization = Normalization::none;
+    rowsParams.placement     = Placement::inPlace;
+    rowsParams.type          = dft::Type::complexToComplex;
+
+    auto archParams = desc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+    archParams.memoryLayout = {};
+
+    return Desc{rowsParams, archParams};
+  }
+
+  /**
+   * @brief Make the description of the first row plan of the six-step plan, n2 rows of length n1.
+   * @param desc Plan description, see isSixStepLayout().
+   * @return Plan description.
+   */
+  [[nodiscard]] inline Desc makeSixStepFirstDesc(const Desc& desc)
+  {
+    const auto length = desc.getShape()[desc.getTransformAxes().front()];
+    const auto n1     = getSixStepFactor(length);
+
+    return makeSixStepRowsDesc(desc, length / n1, n1);
+  }
+
+  /**
+   * @brief Make the description of the second row plan of the six-step plan, n1 rows of length n2.
+   * @param desc Plan description, see isSixStepLayout().
+   * @return Plan description.
+   */
+  [[nodiscard]] inline Desc makeSixStepSecondDesc(const Desc& desc)
+  {
+    const auto length = desc.getShape()[desc.getTransformAxes().front()];
+    const auto n1     = getSixStepFactor(length);
+
+    return makeSixStepRowsDesc(desc, n1, length / n1);
+  }
+
+  /**
+   * @class SixStepPlan
+   * @brief Plan computing a long one-dimensional c2c transform of length n = n1 * n2 by the six-step algorithm. The
+   *        source is transposed into n2 rows of length n1 transformed by the first plan, multiplied by the twiddle
+   *        factors while transposed into n1 rows of length n2 transformed by the second plan, and transposed into the
+   *        destination. All transforms run on contiguous cache sized rows and all passes over the memory are cache
+   *        blocked. The rows along the transform axis may have any strides. Only spst cpu plans are supported.
+   *        Executions of the plan are serialized, they share the work buffers.
+   */
+  class SixStepPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the work buffers and computes the twiddle factors.
+       * @param desc Plan description, see isSixStepLayout().
+       * @param firstPlan Plan created from makeSixStepFirstDesc(desc).
+       * @param secondPlan Plan created from makeSixStepSecondDesc(desc).
+       */
+      SixStepPlan(const Desc& desc, std::unique_ptr<Plan> firstPlan, std::unique_ptr<Plan> secondPlan)
+      : Plan{desc},
+        mFirstPlan{std::move(firstPlan)},
+        mSecondPlan{std::move(secondPlan)}
+      {
+        if (!mFirstPlan || !mSecondPlan)
+        {
+          throw std::invalid_argument{"Row plans must not be null"};
+        }
+
+        const auto& cpuDesc   = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  alignment = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+        const auto  shapeRank = desc.getShapeRank();
+        const auto  shape     = desc.getShape();
+        const auto  axis      = desc.getTransformAxes().front();
+        const auto  length    = shape[axis];
+
+        mN1       = getSixStepFactor(length);
+        mN2       = length / mN1;
+        mElemSize = desc.sizeOfSrcElem();
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto& memoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+        const auto  srcStrides   = memoryLayout.getSrcStrides();
+        const auto  dstStrides   = memoryLayout.getDstStrides();
+
+        mSrcStride = srcStrides[axis];
+        mDstStride = dstStrides[axis];
+
+        // rows enumerate the indices of the other axes, the last axis varies fastest
+        const std::size_t rowCount = std::accumulate(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>{}) / length;
+
+        mSrcRowOffsets.resize(rowCount);
+        mDstRowOffsets.resize(rowCount);
+
+        for (std::size_t row{}; row < rowCount; ++row)
+        {
+          std::size_t index = row;
+
+          for (std::size_t i = shapeRank; i > 0; --i)
+          {
+            if (i - 1 == axis)
+            {
+              continue;
+            }
+
+            mSrcRowOffsets[row] += (index % shape[i - 1]) * srcStrides[i - 1];
+            mDstRowOffsets[row] += (index % shape[i - 1]) * dstStrides[i - 1];
+            index               /= shape[i - 1];
+          }
+        }
+
+        for (auto& work : mWork)
+        {
+          work = cpu::makeAlignedUnique<std::byte[]>(alignment, cpuDesc.hugePagePolicy, length * mElemSize);
+        }
+
+        // w^m = coarse[m / fineCount] * fine[m % fineCount] keeps the tables at about 2 sqrt(n) elements
+        mFineCount = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(length))));
+
+        const auto coarseCount = length / mFineCount + 1;
+
+        auto makeTwiddles = [&](auto real)
+        {
+          using T = decltype(real);
+
+          constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+          const long double sign  = (desc.getDirection() == Direction::forward) ? -1.0L : 1.0L;
+          const long double scale = static_cast<long double>(desc.getNormalizationFactor<T>());
+
+          auto unitRoot = [&](std::size_t m, long double factor)
+          {
+            const long double angle = sign * 2.0L * pi * static_cast<long double>(m) / static_cast<long double>(length);
+
+            return std::complex<T>{static_cast<T>(factor * std::cos(angle)), static_cast<T>(factor * std::sin(angle))};
+          };
+
+          Twiddles<T> twiddles{};
+          twiddles.coarse.resize(coarseCount);
+          twiddles.fine.resize(mFineCount);
+
+          for (std::size_t i{}; i < coarseCount; ++i)
+          {
+            twiddles.coarse[i] = unitRoot((i * mFineCount) % length, scale);
+          }
+
+          for (std::size_t i{}; i < mFineCount; ++i)
+          {
+            twiddles.fine[i] = unitRoot(i, 1.0L);
+          }
+
+          return twiddles;
+        };
+
+        if (desc.getPrecision().execution == Precision::f32)
+        {
+          mTwiddles = makeTwiddles(float{});
+        }
+        else
+        {
+          mTwiddles = makeTwiddles(double{});
+        }
+
+        const auto firstMemorySize  = mFirstPlan->getBackendMemorySize();
+        const auto secondMemorySize = mSecondPlan->getBackendMemorySize();
+
+        mBackendMemorySize = mWork.size() * length * mElemSize +
+                             (coarseCount + mFineCount) * mElemSize +
+                             (mSrcRowOffsets.size() + mDstRowOffsets.size()) * sizeof(std::size_t) +
+                             (firstMemorySize.empty() ? 0 : firstMemorySize.front()) +
+                             (secondMemorySize.empty() ? 0 : secondMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~SixStepPlan() override = default;
+
+      /**
+       * @brief Get backend of the row plans.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mFirstPlan->getBackend();
+      }
+
+      /**
+       * @brief Get the memory held by the row plans and the internal buffers.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the row plans.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mFirstPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "computed by the six-step algorithm";
+      }
+
+    protected:
+      /**
+       * @brief Execute the six-step algorithm row by row.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters&) override
+      {
+        const auto& desc        = DescGetter::get(*this);
+        const auto  threadLimit = desc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        const std::size_t srcStrides[]{mN2 * mSrcStride, mSrcStride};
+        const std::size_t dstStrides[]{mDstStride, mN1 * mDstStride};
+        const std::size_t firstStrides[]{1, mN1};
+        const std::size_t secondStrides[]{mN2, 1};
+        const std::size_t shape[]{mN1, mN2};
+
+        void* work[]{mWork[0].get(), mWork[1].get()};
+
+        const auto lock = lockExecution(mMutex);
+
+        for (std::size_t row{}; row < mSrcRowOffsets.size(); ++row)
+        {
+          const auto srcRow = static_cast<const std::byte*>(src.front()) + mSrcRowOffsets[row] * mElemSize;
+          const auto dstRow = static_cast<std::byte*>(dst.front()) + mDstRowOffsets[row] * mElemSize;
+
+          // x[n1 * n2 + j] is transposed into n2 rows of length n1
+          transpose::copy(srcRow, srcStrides, work[0], firstStrides, shape, mElemSize, threadLimit);
+
+          executeBackendImplOf(*mFirstPlan, View<void*>{&work[0], 1}, View<void*>{&work[0], 1}, afft::spst::cpu::ExecutionParameters{});
+
+          std::visit([&](const auto& twiddles)
+          {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(twiddles)>, std::monostate>)
+            {
+              twiddleTranspose(twiddles, work[0], work[1], threadLimit);
+            }
+          }, mTwiddles);
+
+          executeBackendImplOf(*mSecondPlan, View<void*>{&work[1], 1}, View<void*>{&work[1], 1}, afft::spst::cpu::ExecutionParameters{});
+
+          // the n1 rows of length n2 hold X[k1 + n1 * k2], transposed into the destination
+          transpose::copy(work[1], secondStrides, dstRow, dstStrides, shape, mElemSize, threadLimit);
+        }
+      }
+
+      /**
+       * @brief Execute the batch one transform after another, the transforms share the work buffers.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      /**
+       * @brief Twiddle factor tables, w^m = coarse[m / fineCount] * fine[m % fineCount]. The coarse table holds the
+       *        normalization factor.
+       * @tparam T Real type.
+       */
+      template<typename T>
+      struct Twiddles
+      {
+        std::vector<std::complex<T>> coarse{}; ///< The powers w^(i * fineCount) scaled by the normalization factor.
+        std::vector<std::complex<T>> fine{};   ///< The powers w^i, i < fineCount.
+      };
+
+      /**
+       * @brief Multiply the n2 rows of length n1 by the twiddle factors w^(j * k1) and transpose them into n1 rows of
+       *        length n2. The rows are processed in tiles, each work item owns a row of tiles of the destination.
+       * @tparam T Real type.
+       * @param twiddles Twiddle factor tables.
+       * @param src Source work buffer, element (j, k1) at j * n1 + k1.
+       * @param dst Destination work buffer, element (k1, j) at k1 * n2 + j.
+       * @param threadLimit Maximum number of threads, 0 for the thread pool size.
+       */
+      template<typename T>
+      void twiddleTranspose(const Twiddles<T>& twiddles, const void* src, void* dst, std::size_t threadLimit) const
+      {
+        const auto* srcCmpl = static_cast<const T*>(src);
+        auto*       dstCmpl = static_cast<T*>(dst);
+
+        const auto* coarse = reinterpret_cast<const T*>(twiddles.coarse.data());
+        const auto* fine   = reinterpret_cast<const T*>(twiddles.fine.data());
+
+        const std::size_t n1         = mN1;
+        const std::size_t n2         = mN2;
+        const std::size_t fineCount  = mFineCount;
+        const std::size_t tileCountK = (n1 + transpose::tileExtent - 1) / transpose::tileExtent;
+
+        parallelFor(tileCountK, threadLimit, [&](std::size_t tile)
+        {
+          const std::size_t k0 = tile * transpose::tileExtent;
+          const std::size_t k1 = std::min(k0 + transpose::tileExtent, n1);
+
+          for (std::size_t j0{}; j0 < n2; j0 += transpose::tileExtent)
+          {
+            const std::size_t j1 = std::min(j0 + transpose::tileExtent, n2);
+
+            for (std::size_t k = k0; k < k1; ++k)
+            {
+              // m = j * k is split into m / fineCount and m % fineCount, advanced by k without a division
+              const std::size_t stepHi = k / fineCount;
+              const std::size_t stepLo = k % fineCount;
+
+              std::size_t hi = (j0 * k) / fineCount;
+              std::size_t lo = (j0 * k) % fineCount;
+
+              for (std::size_t j = j0; j < j1; ++j)
+              {
+                const T* x = srcCmpl + 2 * (j * n1 + k);
+                const T* c = coarse + 2 * hi;
+                const T* f = fine + 2 * lo;
+
+                const T wRe = c[0] * f[0] - c[1] * f[1];
+                const T wIm = c[0] * f[1] + c[1] * f[0];
+
+                T* y = dstCmpl + 2 * (k * n2 + j);
+
+                y[0] = x[0] * wRe - x[1] * wIm;
+                y[1] = x[0] * wIm + x[1] * wRe;
+
+                hi += stepHi;
+                lo += stepLo;
+
+                if (lo >= fineCount)
+                {
+                  lo -= fineCount;
+                  ++hi;
+                }
+              }
+            }
+          }
+        });
+      }
+
+      std::unique_ptr<Plan>                                           mFirstPlan{};         ///< The plan of n2 rows of length n1.
+      std::unique_ptr<Plan>                                           mSecondPlan{};        ///< The plan of n1 rows of length n2.
+      std::array<cpu::AlignedUniquePtr<std::byte[]>, 2>               mWork{};              ///< The work buffers.
+      std::variant<std::monostate, Twiddles<float>, Twiddles<double>> mTwiddles{};          ///< The twiddle factors of the precision.
+      std::vector<std::size_t>                                        mSrcRowOffsets{};     ///< The source row offsets.
+      std::vector<std::size_t>                                        mDstRowOffsets{};     ///< The destination row offsets.
+      std::size_t                                                     mN1{};                ///< The length of the first rows.
+      std::size_t                                                     mN2{};                ///< The length of the second rows.
+      std::size_t                                                     mFineCount{};         ///< The size of the fine twiddle table.
+      std::size_t                                                     mElemSize{};          ///< The complex element size in bytes.
+      std::size_t                                                     mSrcStride{};         ///< The source element stride.
+      std::size_t                                                     mDstStride{};         ///< The destination element stride.
+      std::size_t                                                     mBackendMemorySize{}; ///< The internal memory size.
+      std::mutex                                                      mMutex{};             ///< Serializes the executions.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_SIX_STEP_PLAN_HPP */
@@ -0,0 +1,384 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_SLAB_PLAN_HPP
+#define AFFT_DETAIL_SLAB_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "transpose.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /// @brief Maximum size in bytes of a slab transformed at once by the slab plan, the slab stays in the L2 cache.
+  inline constexpr std::size_t slabPlanMaxSlabSize{std::size_t{1} << 20};
+
+  /// @brief Size in bytes of the block of columns transformed at once along the outer axis by the slab plan.
+  inline constexpr std::size_t slabPlanColumnBlockSize{std::size_t{1} << 18};
+
+  /// @brief Destination size in bytes from which the slab plan is preferred without measuring, smaller arrays are not
+  ///        memory bound.
+  inline constexpr std::size_t slabPlanMinDstSize{std::size_t{1} << 25};
+
+  /**
+   * @brief Get the axes of a three-dimensional plan ordered by the destination strides, the outer one first.
+   * @param desc Plan description with the default memory layout strides filled.
+   * @return Outer, middle and inner axis.
+   */
+  [[nodiscard]] inline std::array<std::size_t, 3> getSlabAxes(const Desc& desc)
+  {
+    const auto dstStrides = desc.getMemoryLayout<Distribution::spst>().getDstStrides();
+
+    std::array<std::size_t, 3> axes{0, 1, 2};
+
+    std::sort(axes.begin(), axes.end(), [&](std::size_t lhs, std::size_t rhs)
+    {
+      return dstStrides[lhs] > dstStrides[rhs];
+    });
+
+    return axes;
+  }
+
+  /**
+   * @brief Check if a spst cpu plan is a three-dimensional c2c transform whose slabs along the outer axis fit the cache,
+   *        so a slab plan may compute it by two passes over the memory instead of three.
+   * @param desc Plan description.
+   * @return True if the slab plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isSlabLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu ||
+        desc.getDistribution() != Distribution::spst ||
+        desc.getTransform() != Transform::dft ||
+        desc.getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex ||
+        desc.getShapeRank() != 3 ||
+        desc.getTransformRank() != 3 ||
+        desc.getComplexFormat() != ComplexFormat::interleaved ||
+        desc.hasLogicalSrcShape() ||
+        desc.hasDstWindow())
+    {
+      return false;
+    }
+
+    const auto precision = desc.getPrecision().execution;
+
+    if (!desc.hasUniformPrecision() || (precision != Precision::f32 && precision != Precision::f64))
+    {
+      return false;
+    }
+
+    if (!transpose::isSupportedElemSize(desc.sizeOfDstElem()))
+    {
+      return false;
+    }
+
+    Desc layoutDesc{desc};
+    layoutDesc.fillDefaultMemoryLayoutStrides();
+
+    const auto shape = desc.getShape();
+    const auto axes  = getSlabAxes(layoutDesc);
+
+    return shape[axes[0]] > 1 && shape[axes[1]] * shape[axes[2]] * desc.sizeOfDstElem() <= slabPlanMaxSlabSize;
+  }
+
+  /**
+   * @brief Make the description of the slab plan of the slab plan. It transforms one slab along the middle and inner
+   *        axes from the source into the destination layout without normalization, single threaded.
+   * @param desc Plan description, see isSlabLayout().
+   * @return Plan description of shape {middle, inner} transformed along both axes.
+   */
+  [[nodiscard]] inline Desc makeSlabDesc(const Desc& desc)
+  {
+    Desc layoutDesc{desc};
+    layoutDesc.fillDefaultMemoryLayoutStrides();
+
+    const auto  shape        = desc.getShape();
+    const auto  axes         = getSlabAxes(layoutDesc);
+    const auto& memoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+
+    const std::size_t slabShape[]{shape[axes[1]], shape[axes[2]]};
+    const std::size_t slabAxes[]{0, 1};
+    const std::size_t srcStrides[]{memoryLayout.getSrcStrides()[axes[1]], memoryLayout.getSrcStrides()[axes[2]]};
+    const std::size_t dstStrides[]{memoryLayout.getDstStrides()[axes[1]], memoryLayout.getDstStrides()[axes[2]]};
+
+    dft::Parameters<> slabParams{};
+    slabParams.direction     = desc.getDirection();
+    slabParams.precision     = desc.getPrecision();
+    slabParams.shape         = slabShape;
+    slabParams.axes          = slabAxes;
+    slabParams.normalization = Normalization::none;
+    slabParams.placement     = desc.getPlacement();
+    slabParams.type          = dft::Type::complexToComplex;
+
+    auto archParams = desc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+    archParams.memoryLayout = {srcStrides, dstStrides};
+    archParams.threadLimit  = 1;
+
+    return Desc{slabParams, archParams};
+  }
+
+  /**
+   * @brief Make the description of the column plan of the slab plan. It transforms one contiguous column of the work
+   *        buffer along the outer axis in-place without normalization, single threaded.
+   * @param desc Plan description, see isSlabLayout().
+   * @return Plan description of shape {outer}.
+   */
+  [[nodiscard]] inline Desc makeSlabColumnDesc(const Desc& desc)
+  {
+    Desc layoutDesc{desc};
+    layoutDesc.fillDefaultMemoryLayoutStrides();
+
+    const std::size_t columnShape[]{desc.getShape()[getSlabAxes(layoutDesc)[0]]};
+    const std::size_t columnAxes[]{0};
+
+    dft::Parameters<> columnParams{};
+    columnParams.direction     = desc.getDirection();
+    columnParams.precision     = desc.getPrecision();
+    columnParams.shape         = columnShape;
+    columnParams.axes          = columnAxes;
+    columnParams.normalization = Normalization::none;
+    columnParams.placement     = Placement::inPlace;
+    columnParams.type          = dft::Type::complexToComplex;
+
+    auto archParams = desc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+    archParams.memoryLayout = {};
+    archParams.threadLimit  = 1;
+
+    return Desc{columnParams, archParams};
+  }
+
+  /**
+   * @class SlabPlan
+   * @brief Plan computing a three-dimensional c2c transform by two passes over the memory. The slabs along the outer
+   *        axis are transformed along the middle and inner axes from the source into the destination while they stay
+   *        in the cache. Then blocks of columns along the outer axis are transposed into a work buffer, transformed
+   *        and normalized there and transposed back. The passes run on the cpu thread pool, the single threaded slab
+   *        and column plans must support concurrent execution on distinct buffers. Only spst cpu plans are supported.
+   */
+  class SlabPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param desc Plan description, see isSlabLayout().
+       * @param slabPlan Plan created from makeSlabDesc(desc).
+       * @param columnPlan Plan created from makeSlabColumnDesc(desc).
+       */
+      SlabPlan(const Desc& desc, std::unique_ptr<Plan> slabPlan, std::unique_ptr<Plan> columnPlan)
+      : Plan{desc},
+        mSlabPlan{std::move(slabPlan)},
+        mColumnPlan{std::move(columnPlan)}
+      {
+        if (!mSlabPlan || !mColumnPlan)
+        {
+          throw std::invalid_argument{"Slab and column plans must not be null"};
+        }
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto& cpuDesc      = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto& memoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+        const auto  shape        = desc.getShape();
+        const auto  axes         = getSlabAxes(layoutDesc);
+
+        for (std::size_t i{}; i < axes.size(); ++i)
+        {
+          mShape[i]      = shape[axes[i]];
+          mSrcStrides[i] = memoryLayout.getSrcStrides()[axes[i]];
+          mDstStrides[i] = memoryLayout.getDstStrides()[axes[i]];
+        }
+
+        mAlignment      = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+        mHugePagePolicy = cpuDesc.hugePagePolicy;
+        mElemSize       = desc.sizeOfDstElem();
+        mThreadLimit    = cpuDesc.threadLimit;
+        mBlockWidth     = std::clamp(slabPlanColumnBlockSize / (mShape[0] * mElemSize), std::size_t{1}, mShape[2]);
+
+        if (desc.getPrecision().execution == Precision::f32)
+        {
+          mNormFactor.emplace<float>(desc.getNormalizationFactor<float>());
+        }
+        else
+        {
+          mNormFactor.emplace<double>(desc.getNormalizationFactor<double>());
+        }
+
+        const auto slabMemorySize   = mSlabPlan->getBackendMemorySize();
+        const auto columnMemorySize = mColumnPlan->getBackendMemorySize();
+
+        mBackendMemorySize = (slabMemorySize.empty() ? 0 : slabMemorySize.front()) +
+                             (columnMemorySize.empty() ? 0 : columnMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~SlabPlan() override = default;
+
+      /**
+       * @brief Get backend of the slab plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mSlabPlan->getBackend();
+      }
+
+      /**
+       * @brief Get the memory held by the slab and column plans, the work buffers are allocated per execution.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the slab plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mSlabPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "computed by slabs and column blocks";
+      }
+
+    protected:
+      /**
+       * @brief Execute the slab pass and the column pass.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters&) override
+      {
+        auto* srcBytes = static_cast<std::byte*>(src.front());
+        auto* dstBytes = static_cast<std::byte*>(dst.front());
+
+        parallelFor(mShape[0], mThreadLimit, [&](std::size_t i)
+        {
+          void* slabSrc = srcBytes + i * mSrcStrides[0] * mElemSize;
+          void* slabDst = dstBytes + i * mDstStrides[0] * mElemSize;
+
+          executeBackendImplOf(*mSlabPlan,
+                               View<void*>{&slabSrc, 1},
+                               View<void*>{&slabDst, 1},
+                               afft::spst::cpu::ExecutionParameters{});
+        });
+
+        const std::size_t blocksPerRow = (mShape[2] + mBlockWidth - 1) / mBlockWidth;
+
+        parallelFor(mShape[1] * blocksPerRow, mThreadLimit, [&](std::size_t item)
+        {
+          const std::size_t middle = item / blocksPerRow;
+          const std::size_t begin  = (item % blocksPerRow) * mBlockWidth;
+          const std::size_t width  = std::min(mBlockWidth, mShape[2] - begin);
+
+          const std::size_t blockShape[]{mShape[0], width};
+          const std::size_t blockStrides[]{mDstStrides[0], mDstStrides[2]};
+          const std::size_t workStrides[]{1, mShape[0]};
+
+          auto  work  = cpu::makeAlignedUnique<std::byte[]>(mAlignment, mHugePagePolicy, width * mShape[0] * mElemSize);
+          void* block = dstBytes + (middle * mDstStrides[1] + begin * mDstStrides[2]) * mElemSize;
+
+          transpose::copy(block, blockStrides, work.get(), workStrides, blockShape, mElemSize, 1);
+
+          for (std::size_t column{}; column < width; ++column)
+          {
+            void* columnPtr = work.get() + column * mShape[0] * mElemSize;
+
+            executeBackendImplOf(*mColumnPlan,
+                                 View<void*>{&columnPtr, 1},
+                                 View<void*>{&columnPtr, 1},
+                                 afft::spst::cpu::ExecutionParameters{});
+          }
+
+          std::visit([&](auto normFactor)
+          {
+            using T = decltype(normFactor);
+
+            if constexpr (!std::is_same_v<T, std::monostate>)
+            {
+              if (normFactor != T{1})
+              {
+                auto* values = reinterpret_cast<T*>(work.get());
+
+                for (std::size_t i{}; i < 2 * width * mShape[0]; ++i)
+                {
+                  values[i] *= normFactor;
+                }
+              }
+            }
+          }, mNormFactor);
+
+          transpose::copy(work.get(), workStrides, block, blockStrides, blockShape, mElemSize, 1);
+        });
+      }
+
+      /**
+       * @brief Execute the batch one transform after another, each transform uses all threads.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      std::unique_ptr<Plan>                       mSlabPlan{};          ///< The plan of one slab.
+      std::unique_ptr<Plan>                       mColumnPlan{};        ///< The plan of one column along the outer axis.
+      std::array<std::size_t, 3>                  mShape{};             ///< The shape ordered outer, middle, inner.
+      std::array<std::size_t, 3>                  mSrcStrides{};        ///< The source element strides of mShape.
+      std::array<std::size_t, 3>                  mDstStrides{};        ///< The destination element strides of mShape.
+      std::variant<std::monostate, float, double> mNormFactor{};        ///< The normalization factor of the precision.
+      Alignment                                   mAlignment{};         ///< The alignment of the work buffers.
+      HugePagePolicy                              mHugePagePolicy{};    ///< The huge page policy of the work buffers.
+      std::size_t                                 mElemSize{};          ///< The complex element size in bytes.
+      std::size_t                                 mThreadLimit{};       ///< The thread limit of both passes.
+      std::size_t                                 mBlockWidth{};        ///< The columns of a block along the inner axis.
+      std::size_t                                 mBackendMemorySize{}; ///< The internal memory size.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_SLAB_PLAN_HPP */
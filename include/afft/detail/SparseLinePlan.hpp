@@ -0,0 +1,431 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_SPARSE_LINE_PLAN_HPP
+#define AFFT_DETAIL_SPARSE_LINE_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "ThreadPool.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /// @brief Size in bytes of the block of lines gathered at once by the sparse line plan, the block stays in the L2
+  ///        cache.
+  inline constexpr std::size_t sparseLinePlanBlockSize{std::size_t{1} << 18};
+
+  /**
+   * @brief Check if a spst cpu plan requested the sparse lines and is a c2c transform along at least two axes, so a
+   *        sparse line plan may skip the zero lines of its first axis pass.
+   * @param desc Plan description.
+   * @return True if the sparse line plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isSparseLineLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu ||
+        desc.getDistribution() != Distribution::spst ||
+        !desc.getArchDesc<Target::cpu, Distribution::spst>().sparseLines ||
+        desc.getTransform() != Transform::dft ||
+        desc.getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex ||
+        desc.getTransformRank() < 2 ||
+        desc.getComplexFormat() != ComplexFormat::interleaved ||
+        desc.getPrecision().source != desc.getPrecision().destination ||
+        desc.hasLogicalSrcShape() ||
+        desc.hasDstWindow() ||
+        desc.hasFullSpectrum() ||
+        desc.hasShift() ||
+        desc.isRealtime())
+    {
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Make the description of the line plan of the sparse line plan. It transforms a block of contiguous lines
+   *        along the first transform axis in-place, single threaded, normalized along the line only.
+   * @param desc Plan description, see isSparseLineLayout().
+   * @param blockLineCount Number of the lines of a block.
+   * @return Plan description of shape {blockLineCount, line size} transformed along the last axis.
+   */
+  [[nodiscard]] inline Desc makeSparseLineDesc(const Desc& desc, std::size_t blockLineCount)
+  {
+    const std::size_t lineShape[]{blockLineCount, desc.getShape()[desc.getTransformAxes()[0]]};
+    const std::size_t lineAxes[]{1};
+
+    dft::Parameters<> lineParams{};
+    lineParams.direction     = desc.getDirection();
+    lineParams.precision     = desc.getPrecision();
+    lineParams.shape         = lineShape;
+    lineParams.axes          = lineAxes;
+    lineParams.normalization = desc.getNormalization();
+    lineParams.placement     = Placement::inPlace;
+    lineParams.type          = dft::Type::complexToComplex;
+
+    auto archParams = desc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+    archParams.memoryLayout    = {};
+    archParams.acceptUnaligned = false;
+    archParams.sparseLines     = false;
+    archParams.threadLimit     = 1;
+
+    return Desc{lineParams, archParams};
+  }
+
+  /**
+   * @brief Make the description of the rest plan of the sparse line plan. It transforms the destination in-place along
+   *        the remaining transform axes, normalized along them only.
+   * @param desc Plan description, see isSparseLineLayout().
+   * @return Plan description of the same shape without the first transform axis.
+   */
+  [[nodiscard]] inline Desc makeSparseLineRestDesc(const Desc& desc)
+  {
+    Desc layoutDesc{desc};
+    layoutDesc.fillDefaultMemoryLayoutStrides();
+
+    const auto transformAxes = desc.getTransformAxes();
+    const auto dstStrides    = layoutDesc.getMemoryLayout<Distribution::spst>().getDstStrides();
+
+    MaxDimArray<std::size_t> restAxes{};
+    std::copy(transformAxes.begin() + 1, transformAxes.end(), restAxes.begin());
+
+    dft::Parameters<> restParams{};
+    restParams.direction     = desc.getDirection();
+    restParams.precision     = desc.getPrecision();
+    restParams.shape         = View<std::size_t>{desc.getShape().data(), desc.getShapeRank()};
+    restParams.axes          = View<std::size_t>{restAxes.data(), transformAxes.size() - 1};
+    restParams.normalization = desc.getNormalization();
+    restParams.placement     = Placement::inPlace;
+    restParams.type          = dft::Type::complexToComplex;
+
+    auto archParams = desc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+    archParams.memoryLayout = {dstStrides, dstStrides};
+    archParams.sparseLines  = false;
+
+    return Desc{restParams, archParams};
+  }
+
+  /**
+   * @class SparseLinePlan
+   * @brief Plan skipping the zero source lines in the pass along the first transform axis. The lines are processed in
+   *        cache sized blocks on the cpu thread pool: the lines not masked out by the execution parameters, or not
+   *        entirely zero if no mask is given, are gathered into a work buffer, transformed by the line plan and
+   *        scattered into the destination, the other lines of the destination are zeroed. The remaining axes are then
+   *        transformed in the destination by the rest plan densely. Normalizing each pass along its axes normalizes
+   *        the whole transform. The single threaded line plan must support concurrent execution on distinct buffers.
+   *        Only spst cpu plans are supported.
+   */
+  class SparseLinePlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param desc Plan description, see isSparseLineLayout().
+       * @param blockLineCount Number of the lines of a block.
+       * @param linePlan Plan created from makeSparseLineDesc(desc, blockLineCount), accepting a reduced batch count.
+       * @param restPlan Plan created from makeSparseLineRestDesc(desc).
+       */
+      SparseLinePlan(const Desc&           desc,
+                     std::size_t           blockLineCount,
+                     std::unique_ptr<Plan> linePlan,
+                     std::unique_ptr<Plan> restPlan)
+      : Plan{desc},
+        mLinePlan{std::move(linePlan)},
+        mRestPlan{std::move(restPlan)},
+        mBlockLineCount{blockLineCount}
+      {
+        if (!mLinePlan || !mRestPlan)
+        {
+          throw std::invalid_argument{"Line and rest plans must not be null"};
+        }
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto& cpuDesc      = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto& memoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+        const auto  shape        = desc.getShape();
+        const auto  lineAxis     = desc.getTransformAxes()[0];
+
+        for (std::size_t i{}; i < desc.getShapeRank(); ++i)
+        {
+          if (i == lineAxis)
+          {
+            mLineSize      = shape[i];
+            mLineSrcStride = memoryLayout.getSrcStrides()[i];
+            mLineDstStride = memoryLayout.getDstStrides()[i];
+          }
+          else
+          {
+            mLineShape[mLineRank]      = shape[i];
+            mLineSrcStrides[mLineRank] = memoryLayout.getSrcStrides()[i];
+            mLineDstStrides[mLineRank] = memoryLayout.getDstStrides()[i];
+            ++mLineRank;
+          }
+        }
+
+        mLineCount      = std::accumulate(mLineShape.begin(), mLineShape.begin() + mLineRank, std::size_t{1}, std::multiplies<>{});
+        mAlignment      = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+        mHugePagePolicy = cpuDesc.hugePagePolicy;
+        mElemSize       = desc.sizeOfDstElem();
+        mThreadLimit    = cpuDesc.threadLimit;
+
+        const auto lineMemorySize = mLinePlan->getBackendMemorySize();
+        const auto restMemorySize = mRestPlan->getBackendMemorySize();
+
+        mBackendMemorySize = (lineMemorySize.empty() ? 0 : lineMemorySize.front()) +
+                             (restMemorySize.empty() ? 0 : restMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~SparseLinePlan() override = default;
+
+      /**
+       * @brief Get backend of the rest plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mRestPlan->getBackend();
+      }
+
+      /**
+       * @brief Get the memory held by the line and rest plans, the work buffers are allocated per execution.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the rest plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mRestPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "zero lines of the first axis skipped";
+      }
+
+    protected:
+      /**
+       * @brief Execute the sparse line pass and the rest pass.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters, the line mask selects the transformed lines.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const auto lineMask = execParams.lineMask;
+
+        if (!lineMask.empty() && lineMask.size() != mLineCount)
+        {
+          throw std::invalid_argument{"line mask size does not match the line count of the plan"};
+        }
+
+        const auto* srcBytes = static_cast<const std::byte*>(src.front());
+        auto*       dstBytes = static_cast<std::byte*>(dst.front());
+
+        const std::size_t lineBytes  = mLineSize * mElemSize;
+        const std::size_t blockCount = (mLineCount + mBlockLineCount - 1) / mBlockLineCount;
+
+        parallelFor(blockCount, mThreadLimit, [&](std::size_t block)
+        {
+          const std::size_t begin = block * mBlockLineCount;
+          const std::size_t end   = std::min(begin + mBlockLineCount, mLineCount);
+
+          cpu::AlignedUniquePtr<std::byte[]> work{};
+          std::vector<std::byte*>            workDsts{};
+
+          for (std::size_t line = begin; line < end; ++line)
+          {
+            const auto [srcOffset, dstOffset] = getLineOffsets(line);
+
+            const std::byte* srcLine = srcBytes + srcOffset * mElemSize;
+            std::byte*       dstLine = dstBytes + dstOffset * mElemSize;
+
+            if (!lineMask.empty() && !lineMask[line])
+            {
+              zeroLine(dstLine);
+              continue;
+            }
+
+            if (!work)
+            {
+              work = cpu::makeAlignedUnique<std::byte[]>(mAlignment, mHugePagePolicy, (end - begin) * lineBytes);
+              workDsts.reserve(end - begin);
+            }
+
+            std::byte* workLine = work.get() + workDsts.size() * lineBytes;
+
+            copyLine(srcLine, mLineSrcStride, workLine, 1);
+
+            // the line is zero in the destination already if it is computed in-place
+            if (lineMask.empty() && std::all_of(workLine, workLine + lineBytes, [](std::byte b) { return b == std::byte{}; }))
+            {
+              if (static_cast<const void*>(srcLine) != static_cast<const void*>(dstLine))
+              {
+                zeroLine(dstLine);
+              }
+              continue;
+            }
+
+            workDsts.push_back(dstLine);
+          }
+
+          if (workDsts.empty())
+          {
+            return;
+          }
+
+          afft::spst::cpu::ExecutionParameters lineExecParams{};
+          lineExecParams.batchCount = (workDsts.size() < mBlockLineCount) ? workDsts.size() : 0;
+
+          void* workPtr = work.get();
+
+          executeBackendImplOf(*mLinePlan, View<void*>{&workPtr, 1}, View<void*>{&workPtr, 1}, lineExecParams);
+
+          for (std::size_t i{}; i < workDsts.size(); ++i)
+          {
+            copyLine(work.get() + i * lineBytes, 1, workDsts[i], mLineDstStride);
+          }
+        });
+
+        executeBackendImplOf(*mRestPlan, dst, dst, afft::spst::cpu::ExecutionParameters{});
+      }
+
+      /**
+       * @brief Execute the batch one transform after another, the line mask applies to each of them.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      /**
+       * @brief Get the element offsets of a line, the lines are ordered row-major over the axes other than the first
+       *        transform axis.
+       * @param line Line index.
+       * @return Source and destination element offsets.
+       */
+      [[nodiscard]] std::pair<std::size_t, std::size_t> getLineOffsets(std::size_t line) const noexcept
+      {
+        std::size_t srcOffset{};
+        std::size_t dstOffset{};
+
+        for (std::size_t i = mLineRank; i-- > 0;)
+        {
+          const std::size_t coord = line % mLineShape[i];
+          line /= mLineShape[i];
+
+          srcOffset += coord * mLineSrcStrides[i];
+          dstOffset += coord * mLineDstStrides[i];
+        }
+
+        return std::make_pair(srcOffset, dstOffset);
+      }
+
+      /**
+       * @brief Copy a line between strided elements.
+       * @param src Source line.
+       * @param srcStride Source element stride.
+       * @param dst Destination line.
+       * @param dstStride Destination element stride.
+       */
+      void copyLine(const std::byte* src, std::size_t srcStride, std::byte* dst, std::size_t dstStride) const noexcept
+      {
+        if (srcStride == 1 && dstStride == 1)
+        {
+          std::memcpy(dst, src, mLineSize * mElemSize);
+          return;
+        }
+
+        for (std::size_t i{}; i < mLineSize; ++i)
+        {
+          std::memcpy(dst + i * dstStride * mElemSize, src + i * srcStride * mElemSize, mElemSize);
+        }
+      }
+
+      /**
+       * @brief Zero a destination line.
+       * @param dst Destination line.
+       */
+      void zeroLine(std::byte* dst) const noexcept
+      {
+        if (mLineDstStride == 1)
+        {
+          std::memset(dst, 0, mLineSize * mElemSize);
+          return;
+        }
+
+        for (std::size_t i{}; i < mLineSize; ++i)
+        {
+          std::memset(dst + i * mLineDstStride * mElemSize, 0, mElemSize);
+        }
+      }
+
+      std::unique_ptr<Plan>    mLinePlan{};          ///< The plan of a block of lines.
+      std::unique_ptr<Plan>    mRestPlan{};          ///< The plan of the remaining axes.
+      std::size_t              mBlockLineCount{};    ///< The lines of a block.
+      std::size_t              mLineSize{};          ///< The elements of a line.
+      std::size_t              mLineSrcStride{};     ///< The source element stride along a line.
+      std::size_t              mLineDstStride{};     ///< The destination element stride along a line.
+      MaxDimArray<std::size_t> mLineShape{};         ///< The shape of the other axes indexing the lines.
+      MaxDimArray<std::size_t> mLineSrcStrides{};    ///< The source element strides of mLineShape.
+      MaxDimArray<std::size_t> mLineDstStrides{};    ///< The destination element strides of mLineShape.
+      std::size_t              mLineRank{};          ///< The rank of mLineShape.
+      std::size_t              mLineCount{};         ///< The number of the lines.
+      Alignment                mAlignment{};         ///< The alignment of the work buffers.
+      HugePagePolicy           mHugePagePolicy{};    ///< The huge page policy of the work buffers.
+      std::size_t              mElemSize{};          ///< The complex element size in bytes.
+      std::size_t              mThreadLimit{};       ///< The thread limit of the line pass.
+      std::size_t              mBackendMemorySize{}; ///< The internal memory size.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_SPARSE_LINE_PLAN_HPP */
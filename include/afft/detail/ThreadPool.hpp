@@ -0,0 +1,244 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_THREAD_POOL_HPP
+#define AFFT_DETAIL_THREAD_POOL_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "../ThreadPool.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @class ThreadPool
+   * @brief Fixed size thread pool executing tasks in the submission order. The threads are started lazily on the first
+   *        submission. Tasks not started before the pool is destroyed are dropped, their futures report a broken promise.
+   */
+  class ThreadPool
+  {
+    public:
+      /**
+       * @brief Constructs a new thread pool.
+       * @param threadCount The number of threads.
+       */
+      explicit ThreadPool(std::size_t threadCount)
+      : mThreadCount{threadCount}
+      {
+        if (mThreadCount == 0)
+        {
+          throw std::invalid_argument{"The number of threads must be greater than zero"};
+        }
+      }
+
+      /// @brief Copy constructor is deleted.
+      ThreadPool(const ThreadPool&) = delete;
+
+      /// @brief Move constructor is deleted.
+      ThreadPool(ThreadPool&&) = delete;
+
+      /// @brief Destructor, stops and joins the threads.
+      ~ThreadPool()
+      {
+        {
+          std::lock_guard lock{mMutex};
+          mStop = true;
+          mTasks.clear();
+        }
+
+        mCondition.notify_all();
+
+        for (auto& thread : mThreads)
+        {
+          thread.join();
+        }
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      ThreadPool& operator=(const ThreadPool&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      ThreadPool& operator=(ThreadPool&&) = delete;
+
+      /**
+       * @brief Get the number of threads.
+       * @return The number of threads.
+       */
+      [[nodiscard]] std::size_t getThreadCount() const noexcept
+      {
+        return mThreadCount;
+      }
+
+      /**
+       * @brief Submits a task to the pool.
+       * @tparam FnT Function type.
+       * @param fn The function.
+       * @return The future of the function result. Exceptions thrown by the function are stored in the future.
+       */
+      template<typename FnT>
+      [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<FnT>&>> submit(FnT&& fn)
+      {
+        using ResultT = std::invoke_result_t<std::decay_t<FnT>&>;
+
+        auto task   = std::make_shared<std::packaged_task<ResultT()>>(std::forward<FnT>(fn));
+        auto future = task->get_future();
+
+        {
+          std::lock_guard lock{mMutex};
+
+          if (mStop)
+          {
+            throw std::runtime_error{"Cannot submit a task to a stopped thread pool"};
+          }
+
+          if (mThreads.empty())
+          {
+            startThreads();
+          }
+
+          mTasks.emplace_back([task = std::move(task)]{ (*task)(); });
+        }
+
+        mCondition.notify_one();
+
+        return future;
+      }
+    private:
+      /// @brief Starts the threads, must be called with the mutex locked.
+      void startThreads()
+      {
+        mThreads.reserve(mThreadCount);
+
+        for (std::size_t i{}; i < mThreadCount; ++i)
+        {
+          mThreads.emplace_back([this]{ run(); });
+        }
+      }
+
+      /// @brief The thread loop.
+      void run()
+      {
+        while (true)
+        {
+          std::function<void()> task{};
+
+          {
+            std::unique_lock lock{mMutex};
+
+            mCondition.wait(lock, [this]{ return mStop || !mTasks.empty(); });
+
+            if (mStop)
+            {
+              return;
+            }
+
+            task = std::move(mTasks.front());
+            mTasks.pop_front();
+          }
+
+          task();
+        }
+      }
+
+      std::size_t                       mThreadCount{}; ///< The number of threads.
+      std::mutex                        mMutex{};       ///< The mutex guarding the queue.
+      std::condition_variable           mCondition{};   ///< The condition signaling a new task or stop.
+      std::deque<std::function<void()>> mTasks{};       ///< The queued tasks.
+      std::vector<std::thread>          mThreads{};     ///< The threads.
+      bool                              mStop{};        ///< Stop flag.
+  };
+
+  /**
+   * @brief Get the default number of planner threads.
+   * @return The default number of planner threads.
+   */
+  [[nodiscard]] inline std::size_t getDefaultPlannerThreadCount() noexcept
+  {
+    return std::max(std::thread::hardware_concurrency() / 2u, 1u);
+  }
+
+  /**
+   * @brief Get the thread pool used for asynchronous plan creation.
+   * @return The planner thread pool.
+   */
+  [[nodiscard]] inline ThreadPool& getPlannerThreadPool()
+  {
+    static ThreadPool plannerThreadPool{getDefaultPlannerThreadCount()};
+
+    return plannerThreadPool;
+  }
+
+  /**
+   * @brief Get the default number of threads executing asynchronous cpu transforms.
+   * @return The default number of executor threads, at least one.
+   */
+  [[nodiscard]] inline std::size_t getDefaultExecutorThreadCount() noexcept
+  {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  /**
+   * @brief Get the thread pool executing asynchronous cpu transforms. It is separate from the planner thread pool, so
+   *        executions are not queued behind long running planning tasks.
+   * @return The executor thread pool.
+   */
+  [[nodiscard]] inline ThreadPool& getExecutorThreadPool()
+  {
+    static ThreadPool executorThreadPool{getDefaultExecutorThreadCount()};
+
+    return executorThreadPool;
+  }
+
+  /**
+   * @brief Run the function for each index in [0, count) in parallel on the cpu thread pool shared by all backends.
+   *        The calling thread takes part in the work. The first exception is rethrown after all workers finished.
+   * @tparam FnT Function type, invocable with the index.
+   * @param count The number of indices.
+   * @param threadCount The maximum number of threads including the calling one, 0 for the thread pool size.
+   * @param fn The function.
+   */
+  template<typename FnT>
+  void parallelFor(std::size_t count, std::size_t threadCount, FnT&& fn)
+  {
+    if (count == 0)
+    {
+      return;
+    }
+    else if (count == 1 || threadCount == 1)
+    {
+      for (std::size_t i{}; i < count; ++i)
+      {
+        fn(i);
+      }
+      return;
+    }
+
+    cpu::getThreadPool()->parallelFor(count, threadCount, std::function<void(std::size_t)>{std::ref(fn)});
+  }
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_THREAD_POOL_HPP */
@@ -38,11 +38,33 @@ namespace afft::detail
   /// @brief Description of a DFT transform.
   struct DftDesc
   {
-    dft::Type type{}; ///< Type of the transform.
+    dft::Type                type{};            ///< Type of the transform.
+    MaxDimArray<std::size_t> logicalSrcShape{}; ///< Logical source shape, zeros for the full shape.
+    MaxDimArray<std::size_t> dstWindowStart{};  ///< Start of the destination window.
+    MaxDimArray<std::size_t> dstWindowShape{};  ///< Shape of the destination window, zeros for the full destination.
+    bool                     fullSpectrum{};    ///< Store the full Hermitian spectrum of a real-to-complex transform.
+    MaxDimArray<std::size_t> srcShiftAxes{};    ///< Sorted axes along which the source is stored centered.
+    std::size_t              srcShiftRank{};    ///< Number of the source shift axes.
+    MaxDimArray<std::size_t> dstShiftAxes{};    ///< Sorted axes along which the destination is stored centered.
+    std::size_t              dstShiftRank{};    ///< Number of the destination shift axes.
+    MaxDimArray<std::size_t> dttAxes{};         ///< Axes transformed by the DTT instead of the DFT.
+    MaxDimArray<dtt::Type>   dttTypes{};        ///< DTT types of the DTT axes.
+    std::size_t              dttRank{};         ///< Number of the DTT axes.
 
     [[nodiscard]] friend bool operator==(const DftDesc& lhs, const DftDesc& rhs) noexcept
     {
-      return lhs.type == rhs.type;
+      return lhs.type == rhs.type &&
+             lhs.logicalSrcShape == rhs.logicalSrcShape &&
+             lhs.dstWindowStart == rhs.dstWindowStart &&
+             lhs.dstWindowShape == rhs.dstWindowShape &&
+             lhs.fullSpectrum == rhs.fullSpectrum &&
+             lhs.srcShiftAxes == rhs.srcShiftAxes &&
+             lhs.srcShiftRank == rhs.srcShiftRank &&
+             lhs.dstShiftAxes == rhs.dstShiftAxes &&
+             lhs.dstShiftRank == rhs.dstShiftRank &&
+             lhs.dttAxes == rhs.dttAxes &&
+             lhs.dttTypes == rhs.dttTypes &&
+             lhs.dttRank == rhs.dttRank;
     }
 
     [[nodiscard]] friend bool operator!=(const DftDesc& lhs, const DftDesc& rhs) noexcept
@@ -103,11 +125,13 @@ namespace afft::detail
         mPrecision(validateAndReturn(transformParams.precision)),
         mShapeRank(transformParams.shape.size()),
         mShape(makeShape(transformParams.shape)),
-        mTransformRank(transformParams.axes.empty() ? mShapeRank : transformParams.axes.size()),
-        mTransformAxes(makeTransformAxes(transformParams.axes, mShapeRank)),
+        mTransformRank(transformParams.axes.empty()
+                         ? mShapeRank - std::min(getExcludedAxes(transformParams).size(), mShapeRank)
+                         : transformParams.axes.size()),
+        mTransformAxes(makeTransformAxes(transformParams.axes, mShapeRank, getExcludedAxes(transformParams))),
         mNormalization(validateAndReturn(transformParams.normalization)),
         mPlacement(validateAndReturn(transformParams.placement)),
-        mTransformVariant(makeTransformVariant(transformParams, mTransformRank))
+        mTransformVariant(makeTransformVariant(transformParams, getShape(), getTransformAxes()))
       {}
 
       /// @brief Copy constructor.
@@ -152,6 +176,15 @@ namespace afft::detail
         return mPrecision.execution == mPrecision.source && mPrecision.execution == mPrecision.destination;
       }
 
+      /**
+       * @brief Set the precision triad of the transform. Should be used carefully.
+       * @param precision Precision triad of the transform.
+       */
+      constexpr void setPrecision(const PrecisionTriad& precision) noexcept
+      {
+        mPrecision = precision;
+      }
+
       /**
        * @brief Get the transform description.
        * @tparam transform Transform type.
@@ -212,7 +245,173 @@ namespace afft::detail
       }
 
       /**
-       * @brief Get the shape of the source.
+       * @brief Set the extent of a non-transformed axis. Should be used carefully.
+       * @param axis The axis.
+       * @param extent The extent.
+       */
+      constexpr void setBatchExtent(std::size_t axis, std::size_t extent) noexcept
+      {
+        mShape[axis] = extent;
+      }
+
+      /**
+       * @brief Check if the source has a logical shape smaller than the shape, the rest is zero-padded.
+       * @return True if the source is zero-padded, false otherwise.
+       */
+      [[nodiscard]] constexpr bool hasLogicalSrcShape() const
+      {
+        return getTransform() == Transform::dft && getTransformDesc<Transform::dft>().logicalSrcShape[0] != 0;
+      }
+
+      /**
+       * @brief Reset the logical source shape to the full shape. Should be used carefully.
+       */
+      constexpr void resetLogicalSrcShape()
+      {
+        if (getTransform() == Transform::dft)
+        {
+          std::get<DftDesc>(mTransformVariant).logicalSrcShape = {};
+        }
+      }
+
+      /**
+       * @brief Check if only a window of the destination is stored.
+       * @return True if the destination is a window, false otherwise.
+       */
+      [[nodiscard]] constexpr bool hasDstWindow() const
+      {
+        return getTransform() == Transform::dft && getTransformDesc<Transform::dft>().dstWindowShape[0] != 0;
+      }
+
+      /**
+       * @brief Get the start of the destination window, zeros if there is no window.
+       * @return Start of the destination window. Only first getShapeRank() elements are valid.
+       */
+      [[nodiscard]] constexpr MaxDimArray<std::size_t> getDstWindowStart() const
+      {
+        return (getTransform() == Transform::dft) ? getTransformDesc<Transform::dft>().dstWindowStart
+                                                  : MaxDimArray<std::size_t>{};
+      }
+
+      /**
+       * @brief Reset the destination window to the full destination. Should be used carefully.
+       */
+      constexpr void resetDstWindow()
+      {
+        if (getTransform() == Transform::dft)
+        {
+          auto& dftDesc = std::get<DftDesc>(mTransformVariant);
+
+          dftDesc.dstWindowStart = {};
+          dftDesc.dstWindowShape = {};
+        }
+      }
+
+      /**
+       * @brief Check if a real-to-complex transform stores the full Hermitian spectrum.
+       * @return True if the full spectrum is stored, false otherwise.
+       */
+      [[nodiscard]] constexpr bool hasFullSpectrum() const
+      {
+        return getTransform() == Transform::dft && getTransformDesc<Transform::dft>().fullSpectrum;
+      }
+
+      /**
+       * @brief Reset the destination to the reduced spectrum. Should be used carefully.
+       */
+      constexpr void resetFullSpectrum()
+      {
+        if (getTransform() == Transform::dft)
+        {
+          std::get<DftDesc>(mTransformVariant).fullSpectrum = false;
+        }
+      }
+
+      /**
+       * @brief Check if the source or the destination is stored centered along any axis.
+       * @return True if any axis is shifted, false otherwise.
+       */
+      [[nodiscard]] constexpr bool hasShift() const
+      {
+        return getTransform() == Transform::dft &&
+               (getTransformDesc<Transform::dft>().srcShiftRank != 0 || getTransformDesc<Transform::dft>().dstShiftRank != 0);
+      }
+
+      /**
+       * @brief Get the axes along which the source is stored centered.
+       * @return Source shift axes, empty if there is no shift.
+       */
+      [[nodiscard]] constexpr View<std::size_t> getSrcShiftAxes() const
+      {
+        return (getTransform() == Transform::dft)
+          ? View<std::size_t>{getTransformDesc<Transform::dft>().srcShiftAxes.data(),
+                              getTransformDesc<Transform::dft>().srcShiftRank}
+          : View<std::size_t>{};
+      }
+
+      /**
+       * @brief Get the axes along which the destination is stored centered.
+       * @return Destination shift axes, empty if there is no shift.
+       */
+      [[nodiscard]] constexpr View<std::size_t> getDstShiftAxes() const
+      {
+        return (getTransform() == Transform::dft)
+          ? View<std::size_t>{getTransformDesc<Transform::dft>().dstShiftAxes.data(),
+                              getTransformDesc<Transform::dft>().dstShiftRank}
+          : View<std::size_t>{};
+      }
+
+      /**
+       * @brief Reset the source and destination shifts. Should be used carefully.
+       */
+      constexpr void resetShift()
+      {
+        if (getTransform() == Transform::dft)
+        {
+          auto& dftDesc = std::get<DftDesc>(mTransformVariant);
+
+          dftDesc.srcShiftAxes = {};
+          dftDesc.srcShiftRank = 0;
+          dftDesc.dstShiftAxes = {};
+          dftDesc.dstShiftRank = 0;
+        }
+      }
+
+      /**
+       * @brief Check if some axes of a DFT are transformed by the DTT instead.
+       * @return True if there are DTT axes, false otherwise.
+       */
+      [[nodiscard]] constexpr bool hasDttAxes() const
+      {
+        return getTransform() == Transform::dft && getTransformDesc<Transform::dft>().dttRank != 0;
+      }
+
+      /**
+       * @brief Get the axes of a DFT transformed by the DTT instead.
+       * @return DTT axes, empty if there are none.
+       */
+      [[nodiscard]] constexpr View<std::size_t> getDttAxes() const
+      {
+        return (getTransform() == Transform::dft)
+          ? View<std::size_t>{getTransformDesc<Transform::dft>().dttAxes.data(),
+                              getTransformDesc<Transform::dft>().dttRank}
+          : View<std::size_t>{};
+      }
+
+      /**
+       * @brief Get the DTT types of the DTT axes of a DFT.
+       * @return DTT types, one per DTT axis.
+       */
+      [[nodiscard]] constexpr View<dtt::Type> getDttTypes() const
+      {
+        return (getTransform() == Transform::dft)
+          ? View<dtt::Type>{getTransformDesc<Transform::dft>().dttTypes.data(),
+                            getTransformDesc<Transform::dft>().dttRank}
+          : View<dtt::Type>{};
+      }
+
+      /**
+       * @brief Get the shape of the source. A logical source shape replaces the shape.
        * @tparam I Integral type.
        * @return Shape of the source.
        */
@@ -224,6 +423,11 @@ namespace afft::detail
         switch (getTransform())
         {
         case Transform::dft:
+          if (hasLogicalSrcShape())
+          {
+            srcShape = getTransformDesc<Transform::dft>().logicalSrcShape.template cast<I>();
+          }
+
           switch (getTransformDesc<Transform::dft>().type)
           {
           case dft::Type::complexToReal:
@@ -245,7 +449,7 @@ namespace afft::detail
       }
 
       /**
-       * @brief Get the shape of the destination.
+       * @brief Get the shape of the destination. A destination window replaces the shape.
        * @tparam I Integral type.
        * @return Shape of the destination.
        */
@@ -261,14 +465,22 @@ namespace afft::detail
           {
           case dft::Type::realToComplex:
           {
-            auto& reducedElem = dstShape[getTransformAxes().back()];
+            if (!hasFullSpectrum())
+            {
+              auto& reducedElem = dstShape[getTransformAxes().back()];
 
-            reducedElem = reducedElem / 2 + 1;
+              reducedElem = reducedElem / 2 + 1;
+            }
             break;
           }
           default:
             break;
           }
+
+          if (hasDstWindow())
+          {
+            dstShape = getTransformDesc<Transform::dft>().dstWindowShape.template cast<I>();
+          }
           break;
         default:
           break;
@@ -359,6 +571,15 @@ namespace afft::detail
         return mNormalization;
       }
 
+      /**
+       * @brief Set the normalization of the transform. Should be used carefully.
+       * @param normalization Normalization of the transform.
+       */
+      constexpr void setNormalization(Normalization normalization) noexcept
+      {
+        mNormalization = normalization;
+      }
+
       /**
        * @brief Get the placement of the transform.
        * @return Placement of the transform.
@@ -368,6 +589,15 @@ namespace afft::detail
         return mPlacement;
       }
 
+      /**
+       * @brief Set the placement of the transform. Should be used carefully.
+       * @param placement Placement of the transform.
+       */
+      constexpr void setPlacement(Placement placement) noexcept
+      {
+        mPlacement = placement;
+      }
+
       /**
        * @brief Get the transform type.
        * @return Transform type.
@@ -503,10 +733,31 @@ namespace afft::detail
         transformParams.shape         = getShape();
         transformParams.axes          = getTransformAxes();
         transformParams.normalization = getNormalization();
+        transformParams.placement     = getPlacement();
 
         if constexpr (transform == Transform::dft)
         {
           transformParams.type = getTransformDesc<Transform::dft>().type;
+
+          if (hasLogicalSrcShape())
+          {
+            transformParams.logicalSrcShape = View<std::size_t>{getTransformDesc<Transform::dft>().logicalSrcShape.data(),
+                                                                getShapeRank()};
+          }
+
+          if (hasDstWindow())
+          {
+            transformParams.dstWindowStart = View<std::size_t>{getTransformDesc<Transform::dft>().dstWindowStart.data(),
+                                                               getShapeRank()};
+            transformParams.dstWindowShape = View<std::size_t>{getTransformDesc<Transform::dft>().dstWindowShape.data(),
+                                                               getShapeRank()};
+          }
+
+          transformParams.fullSpectrum = getTransformDesc<Transform::dft>().fullSpectrum;
+          transformParams.srcShiftAxes = getSrcShiftAxes();
+          transformParams.dstShiftAxes = getDstShiftAxes();
+          transformParams.dttAxes      = getDttAxes();
+          transformParams.dttTypes     = getDttTypes();
         }
         else if constexpr (transform == Transform::dht)
         {
@@ -542,21 +793,28 @@ namespace afft::detail
         return sizeOf(getPrecision().destination) * cmplScale;
       }
 
-      // [[nodiscard]] friend bool operator==(const TransformDesc& lhs, const TransformDesc& rhs) noexcept
-      // {
-      //   return (lhs.mDirection == rhs.mDirection) &&
-      //          (lhs.mPrecision == rhs.mPrecision) &&
-      //          std::equal(lhs.getShape().begin(), lhs.getShape().end(), rhs.getShape().begin(), rhs.getShape().end()) &&
-      //          std::equal(lhs.getTransformAxes().begin(), lhs.getTransformAxes().end(), rhs.getTransformAxes().begin(), rhs.getTransformAxes().end()) &&
-      //          (lhs.mNormalization == rhs.mNormalization) &&
-      //          (lhs.mPlacement == rhs.mPlacement) &&
-      //          (lhs.mTransformVariant == rhs.mTransformVariant);
-      // }
+      /**
+       * @brief Equality operator.
+       * @param lhs Left-hand side.
+       * @param rhs Right-hand side.
+       * @return True if equal, false otherwise.
+       */
+      [[nodiscard]] friend bool operator==(const TransformDesc& lhs, const TransformDesc& rhs) noexcept
+      {
+        return (lhs.mDirection == rhs.mDirection) &&
+               (lhs.mPrecision == rhs.mPrecision) &&
+               std::equal(lhs.getShape().begin(), lhs.getShape().end(), rhs.getShape().begin(), rhs.getShape().end()) &&
+               std::equal(lhs.getTransformAxes().begin(), lhs.getTransformAxes().end(), rhs.getTransformAxes().begin(), rhs.getTransformAxes().end()) &&
+               (lhs.mNormalization == rhs.mNormalization) &&
+               (lhs.mPlacement == rhs.mPlacement) &&
+               (lhs.mTransformVariant == rhs.mTransformVariant);
+      }
 
-      // [[nodiscard]] friend bool operator!=(const TransformDesc& lhs, const TransformDesc& rhs) noexcept
-      // {
-      //   return !(lhs == rhs);
-      // }
+      /// @brief Inequality operator.
+      [[nodiscard]] friend bool operator!=(const TransformDesc& lhs, const TransformDesc& rhs) noexcept
+      {
+        return !(lhs == rhs);
+      }
 
     private:
       /// @brief Transform variant type.
@@ -593,20 +851,66 @@ namespace afft::detail
         return shape;
       }
 
+      /**
+       * @brief Get the axes excluded from all axes of the transform.
+       * @tparam TransformParamsT Type of the transform parameters.
+       * @return Excluded axes, none.
+       */
+      template<typename TransformParamsT>
+      [[nodiscard]] static constexpr View<std::size_t> getExcludedAxes(const TransformParamsT&)
+      {
+        return View<std::size_t>{};
+      }
+
+      /**
+       * @brief Get the axes excluded from all axes of a DFT, its DTT axes.
+       * @tparam shapeExt Extent of the shape.
+       * @tparam transformExt Extent of the transform axes.
+       * @param dftParams DFT parameters.
+       * @return Excluded axes.
+       */
+      template<std::size_t shapeExt, std::size_t transformExt>
+      [[nodiscard]] static constexpr View<std::size_t>
+      getExcludedAxes(const dft::Parameters<shapeExt, transformExt>& dftParams)
+      {
+        return dftParams.dttAxes;
+      }
+
       /**
        * @brief Make the transform axes.
        * @param axesView Axes view.
        * @param shapeRank Rank of the shape.
+       * @param excludedAxes Axes excluded from all axes when the axes view is empty.
        * @return Transform axes.
        */
       [[nodiscard]] static MaxDimArray<std::size_t>
-      makeTransformAxes(View<std::size_t> axesView, std::size_t shapeRank)
+      makeTransformAxes(View<std::size_t> axesView, std::size_t shapeRank, View<std::size_t> excludedAxes)
       {
         MaxDimArray<std::size_t> axes{};
 
         if (axesView.empty())
         {
-          std::iota(axes.begin(), std::next(axes.begin(), static_cast<std::ptrdiff_t>(shapeRank)), 0);
+          std::bitset<maxDimCount> isExcluded{};
+
+          for (const auto axis : excludedAxes)
+          {
+            if (axis >= shapeRank || isExcluded.test(axis))
+            {
+              throw std::invalid_argument("DTT axes must be unique and within the shape");
+            }
+
+            isExcluded.set(axis);
+          }
+
+          std::size_t rank{};
+
+          for (std::size_t i{}; i < shapeRank; ++i)
+          {
+            if (!isExcluded.test(i))
+            {
+              axes[rank++] = i;
+            }
+          }
         }
         else if (axesView.size() <= shapeRank)
         {
@@ -641,14 +945,279 @@ namespace afft::detail
        * @tparam shapeExt Extent of the shape.
        * @tparam transformExt Extent of the transform axes.
        * @param dftParams DFT parameters.
-       * @param transformRank Rank of the transform.
+       * @param shape Shape of the transform.
+       * @param axes Axes of the transform.
        * @return Transform variant.
        */
       template<std::size_t shapeExt, std::size_t transformExt>
       [[nodiscard]] static TransformVariant
-      makeTransformVariant(const dft::Parameters<shapeExt, transformExt>& dftParams, std::size_t)
+      makeTransformVariant(const dft::Parameters<shapeExt, transformExt>& dftParams,
+                           View<std::size_t>                              shape,
+                           View<std::size_t>                              axes)
+      {
+        DftDesc dftDesc{validateAndReturn(dftParams.type)};
+
+        if (dftParams.fullSpectrum)
+        {
+          if (dftDesc.type != dft::Type::realToComplex)
+          {
+            throw std::invalid_argument("Full spectrum is supported only by real-to-complex transforms");
+          }
+
+          if (dftParams.placement == Placement::inPlace)
+          {
+            throw std::invalid_argument("Full spectrum is not supported by in-place transforms");
+          }
+
+          dftDesc.fullSpectrum = true;
+        }
+
+        makeLogicalSrcShape(dftDesc, dftParams.logicalSrcShape, shape, axes);
+        makeDstWindow(dftDesc, dftParams.dstWindowStart, dftParams.dstWindowShape, shape, axes);
+        makeShiftAxes(dftDesc, dftParams.srcShiftAxes, dftParams.dstShiftAxes, dftParams.placement, axes);
+        makeDttAxes(dftDesc, dftParams.dttAxes, dftParams.dttTypes, shape, axes);
+
+        return dftDesc;
+      }
+
+      /**
+       * @brief Validate the DTT axes of a DFT and store them with their types in the DFT description.
+       * @param dftDesc DFT description.
+       * @param dttAxes Axes transformed by the DTT instead of the DFT.
+       * @param dttTypes DTT types of the DTT axes.
+       * @param shape Shape of the transform.
+       * @param axes Axes of the transform.
+       */
+      static void makeDttAxes(DftDesc&          dftDesc,
+                              View<std::size_t> dttAxes,
+                              View<dtt::Type>   dttTypes,
+                              View<std::size_t> shape,
+                              View<std::size_t> axes)
       {
-        return DftDesc{validateAndReturn(dftParams.type)};
+        if (dttAxes.empty())
+        {
+          if (!dttTypes.empty())
+          {
+            throw std::invalid_argument("DTT types require the DTT axes");
+          }
+
+          return;
+        }
+        else if (dttTypes.size() != 1 && dttTypes.size() != dttAxes.size())
+        {
+          throw std::invalid_argument("Invalid number of DTT types, must be 1 or equal to the number of DTT axes");
+        }
+        else if (axes.empty())
+        {
+          throw std::invalid_argument("DTT axes require at least one DFT axis");
+        }
+
+        std::bitset<maxDimCount> isDttAxis{};
+
+        for (std::size_t i{}; i < dttAxes.size(); ++i)
+        {
+          const auto axis = dttAxes[i];
+
+          if (axis >= shape.size() || isDttAxis.test(axis))
+          {
+            throw std::invalid_argument("DTT axes must be unique and within the shape");
+          }
+          else if (std::find(axes.begin(), axes.end(), axis) != axes.end())
+          {
+            throw std::invalid_argument("DTT axes must not be transform axes");
+          }
+
+          isDttAxis.set(axis);
+
+          dftDesc.dttAxes[i]  = axis;
+          dftDesc.dttTypes[i] = validateAndReturn(dttTypes[(dttTypes.size() == 1) ? 0 : i]);
+        }
+
+        dftDesc.dttRank = dttAxes.size();
+      }
+
+      /**
+       * @brief Validate the logical source shape and store it in the DFT description.
+       * @param dftDesc DFT description.
+       * @param logicalSrcShape Logical source shape.
+       * @param shape Shape of the transform.
+       * @param axes Axes of the transform.
+       */
+      static void makeLogicalSrcShape(DftDesc&          dftDesc,
+                                      View<std::size_t> logicalSrcShape,
+                                      View<std::size_t> shape,
+                                      View<std::size_t> axes)
+      {
+        if (logicalSrcShape.empty())
+        {
+          return;
+        }
+        else if (logicalSrcShape.size() != shape.size())
+        {
+          throw std::invalid_argument("Logical source shape rank must match the shape rank");
+        }
+
+        std::bitset<maxDimCount> isTransformAxis{};
+
+        for (const auto axis : axes)
+        {
+          isTransformAxis.set(axis);
+        }
+
+        bool isPadded{};
+
+        for (std::size_t i{}; i < shape.size(); ++i)
+        {
+          const auto extent = logicalSrcShape[i];
+
+          if (extent == 0 || extent > shape[i])
+          {
+            throw std::invalid_argument("Invalid logical source shape dimension size");
+          }
+          else if (extent != shape[i] && !isTransformAxis.test(i))
+          {
+            throw std::invalid_argument("Logical source shape may differ from the shape only along the transform axes");
+          }
+
+          isPadded = isPadded || (extent != shape[i]);
+        }
+
+        if (isPadded && dftDesc.type == dft::Type::complexToReal)
+        {
+          throw std::invalid_argument("Logical source shape is not supported by complex-to-real transforms");
+        }
+
+        if (isPadded)
+        {
+          std::copy(logicalSrcShape.begin(), logicalSrcShape.end(), dftDesc.logicalSrcShape.begin());
+        }
+      }
+
+      /**
+       * @brief Validate the destination window and store it in the DFT description.
+       * @param dftDesc DFT description.
+       * @param dstWindowStart Start of the destination window.
+       * @param dstWindowShape Shape of the destination window.
+       * @param shape Shape of the transform.
+       * @param axes Axes of the transform.
+       */
+      static void makeDstWindow(DftDesc&          dftDesc,
+                                View<std::size_t> dstWindowStart,
+                                View<std::size_t> dstWindowShape,
+                                View<std::size_t> shape,
+                                View<std::size_t> axes)
+      {
+        if (dstWindowShape.empty())
+        {
+          if (!dstWindowStart.empty())
+          {
+            throw std::invalid_argument("Destination window start requires the destination window shape");
+          }
+
+          return;
+        }
+        else if (dstWindowShape.size() != shape.size() || (!dstWindowStart.empty() && dstWindowStart.size() != shape.size()))
+        {
+          throw std::invalid_argument("Destination window rank must match the shape rank");
+        }
+
+        bool isWindowed{};
+
+        for (std::size_t i{}; i < shape.size(); ++i)
+        {
+          const bool isReduced = dftDesc.type == dft::Type::realToComplex && !dftDesc.fullSpectrum && i == axes.back();
+          const auto dstExtent = (isReduced) ? shape[i] / 2 + 1 : shape[i];
+          const auto start     = (dstWindowStart.empty()) ? std::size_t{} : dstWindowStart[i];
+          const auto extent    = dstWindowShape[i];
+
+          if (extent == 0 || start >= dstExtent || extent > dstExtent - start)
+          {
+            throw std::invalid_argument("Destination window exceeds the destination");
+          }
+
+          isWindowed = isWindowed || (extent != dstExtent);
+        }
+
+        if (isWindowed)
+        {
+          std::copy(dstWindowShape.begin(), dstWindowShape.end(), dftDesc.dstWindowShape.begin());
+
+          if (!dstWindowStart.empty())
+          {
+            std::copy(dstWindowStart.begin(), dstWindowStart.end(), dftDesc.dstWindowStart.begin());
+          }
+        }
+      }
+
+      /**
+       * @brief Validate the source and destination shift axes and store them sorted in the DFT description.
+       * @param dftDesc DFT description.
+       * @param srcShiftAxes Axes along which the source is stored centered.
+       * @param dstShiftAxes Axes along which the destination is stored centered.
+       * @param placement Placement of the transform.
+       * @param axes Axes of the transform.
+       */
+      static void makeShiftAxes(DftDesc&          dftDesc,
+                                View<std::size_t> srcShiftAxes,
+                                View<std::size_t> dstShiftAxes,
+                                Placement         placement,
+                                View<std::size_t> axes)
+      {
+        if (srcShiftAxes.empty() && dstShiftAxes.empty())
+        {
+          return;
+        }
+
+        if (dftDesc.logicalSrcShape[0] != 0 || dftDesc.dstWindowShape[0] != 0)
+        {
+          throw std::invalid_argument("Shifts are not supported with a logical source shape or a destination window");
+        }
+
+        const bool isR2c = (dftDesc.type == dft::Type::realToComplex);
+        const bool isC2r = (dftDesc.type == dft::Type::complexToReal);
+
+        if (placement == Placement::inPlace && (isR2c || isC2r) && (!dstShiftAxes.empty() || isC2r))
+        {
+          throw std::invalid_argument("In-place real transforms support only source shifts of real-to-complex transforms");
+        }
+
+        auto makeAxes = [&](View<std::size_t> shiftAxes, bool isReducedSide, MaxDimArray<std::size_t>& dstAxes)
+        {
+          std::bitset<maxDimCount> isShifted{};
+
+          for (const auto axis : shiftAxes)
+          {
+            if (std::find(axes.begin(), axes.end(), axis) == axes.end())
+            {
+              throw std::invalid_argument("Shift axes must be transform axes");
+            }
+            else if (isShifted.test(axis))
+            {
+              throw std::invalid_argument("Shift axes must be unique");
+            }
+            else if (isReducedSide && axis == axes.back())
+            {
+              throw std::invalid_argument("Shift is not supported along the reduced axis of the complex data");
+            }
+
+            isShifted.set(axis);
+          }
+
+          std::size_t rank{};
+
+          for (std::size_t i{}; i < maxDimCount; ++i)
+          {
+            if (isShifted.test(i))
+            {
+              dstAxes[rank++] = i;
+            }
+          }
+
+          return rank;
+        };
+
+        dftDesc.srcShiftRank = makeAxes(srcShiftAxes, isC2r, dftDesc.srcShiftAxes);
+        dftDesc.dstShiftRank = makeAxes(dstShiftAxes, isR2c && !dftDesc.fullSpectrum, dftDesc.dstShiftAxes);
       }
 
       /**
@@ -656,12 +1225,11 @@ namespace afft::detail
        * @tparam shapeExt Extent of the shape.
        * @tparam transformExt Extent of the transform axes.
        * @param dhtParams DHT parameters.
-       * @param transformRank Rank of the transform.
        * @return Transform variant.
        */
       template<std::size_t shapeExt, std::size_t transformExt>
       [[nodiscard]] static TransformVariant
-      makeTransformVariant(const dht::Parameters<shapeExt, transformExt>& dhtParams, std::size_t)
+      makeTransformVariant(const dht::Parameters<shapeExt, transformExt>& dhtParams, View<std::size_t>, View<std::size_t>)
       {
         return DhtDesc{validateAndReturn(dhtParams.type)};
       }
@@ -671,13 +1239,15 @@ namespace afft::detail
        * @tparam shapeExt Extent of the shape.
        * @tparam transformExt Extent of the transform axes.
        * @param dttParams DTT parameters.
-       * @param transformRank Rank of the transform.
+       * @param axes Axes of the transform.
        * @return Transform variant.
        */
       template<std::size_t shapeExt, std::size_t transformExt>
       [[nodiscard]] static TransformVariant
-      makeTransformVariant(const dtt::Parameters<shapeExt, transformExt>& dttParams, std::size_t transformRank)
+      makeTransformVariant(const dtt::Parameters<shapeExt, transformExt>& dttParams, View<std::size_t>, View<std::size_t> axes)
       {
+        const std::size_t transformRank = axes.size();
+
         if ((dttParams.types.size() != 1) && (dttParams.types.size() != transformRank))
         {
           throw std::invalid_argument("Invalid number of dtt types, must be 1 or equal to the number of axes");
@@ -705,4 +1275,28 @@ namespace afft::detail
   };
 } // namespace afft::detail
 
+  /// @brief Specialization of std::hash for afft::detail::TransformDesc.
+  template<>
+  struct std::hash<afft::detail::TransformDesc>
+  {
+    [[nodiscard]] std::size_t operator()(const afft::detail::TransformDesc& desc) const noexcept
+    {
+      using afft::detail::hashCombine;
+
+      const auto& prec = desc.getPrecision();
+
+      std::size_t seed{};
+
+      hashCombine(seed, desc.getShape());
+      hashCombine(seed, desc.getTransformAxes());
+      hashCombine(seed, prec.execution);
+      hashCombine(seed, prec.source);
+      hashCombine(seed, prec.destination);
+      hashCombine(seed, desc.getDirection());
+      hashCombine(seed, desc.getPlacement());
+
+      return seed;
+    }
+  };
+
 #endif /* AFFT_DETAIL_TRANSFORM_DESC_HPP */
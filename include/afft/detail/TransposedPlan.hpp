@@ -0,0 +1,255 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_TRANSPOSED_PLAN_HPP
+#define AFFT_DETAIL_TRANSPOSED_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "transpose.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /// @brief Destination size in bytes from which the transposed plan is preferred without measuring, smaller arrays
+  ///        stay in the cache during the strided stores of the backend.
+  inline constexpr std::size_t transposedPlanMinDstSize{std::size_t{1} << 20};
+
+  /**
+   * @brief Get the size of one element of each destination buffer, a half of the complex element for planar format.
+   * @param desc Plan description.
+   * @return Element size in bytes.
+   */
+  [[nodiscard]] inline std::size_t getDstBufferElemSize(const Desc& desc)
+  {
+    const bool isPlanarCmpl = (desc.getComplexFormat() == ComplexFormat::planar) &&
+                              (desc.getSrcDstComplexity().second == Complexity::complex);
+
+    return desc.sizeOfDstElem() / (isPlanarCmpl ? 2 : 1);
+  }
+
+  /**
+   * @brief Check if the destination layout of a spst cpu plan is transposed, so a transposed plan may replace the
+   *        backend's strided stores. The innermost destination axis must differ from the last axis.
+   * @param desc Plan description.
+   * @return True if the transposed plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isTransposedDstLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu || desc.getDistribution() != Distribution::spst)
+    {
+      return false;
+    }
+
+    const auto  shapeRank    = desc.getShapeRank();
+    const auto& memoryLayout = desc.getMemoryLayout<Distribution::spst>();
+
+    if (shapeRank < 2 || desc.getPlacement() != Placement::outOfPlace || memoryLayout.hasDefaultDstStrides())
+    {
+      return false;
+    }
+
+    if (!transpose::isSupportedElemSize(getDstBufferElemSize(desc)))
+    {
+      return false;
+    }
+
+    const auto dstStrides = memoryLayout.getDstStrides();
+
+    return std::min_element(dstStrides.begin(), dstStrides.end()) != dstStrides.begin() + (shapeRank - 1);
+  }
+
+  /**
+   * @brief Make the description of the plan computing the contiguous destination of a transposed plan.
+   * @param desc Plan description with the transposed destination layout.
+   * @return Plan description with the default destination strides.
+   */
+  [[nodiscard]] inline Desc makeContiguousDstDesc(const Desc& desc)
+  {
+    Desc contiguousDesc{desc};
+
+    auto& cpuDesc = contiguousDesc.getArchDesc<Target::cpu, Distribution::spst>();
+    cpuDesc.memoryLayout.resetDstStrides();
+
+    return contiguousDesc;
+  }
+
+  /**
+   * @class TransposedPlan
+   * @brief Plan computing the transform contiguously into an internal buffer and copying it into the transposed
+   *        destination strides by a cache blocked SIMD transpose. Only spst cpu out-of-place plans are supported.
+   *        Executions of the plan are serialized, they share the internal buffer.
+   */
+  class TransposedPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the internal buffers.
+       * @param desc Plan description with the transposed destination layout.
+       * @param contiguousPlan Plan created from makeContiguousDstDesc(desc).
+       */
+      TransposedPlan(const Desc& desc, std::unique_ptr<Plan> contiguousPlan)
+      : Plan{desc},
+        mPlan{std::move(contiguousPlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Contiguous plan must not be null"};
+        }
+
+        const auto& cpuDesc   = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  shapeRank = desc.getShapeRank();
+        const auto  alignment = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+
+        mDstShape = desc.getDstShape();
+        mElemSize = getDstBufferElemSize(desc);
+        makeStrides(View<std::size_t>{mDstShape.data(), shapeRank}, Span<std::size_t>{mContiguousStrides.data(), shapeRank});
+
+        const std::size_t bufferSize = std::accumulate(mDstShape.begin(),
+                                                       mDstShape.begin() + shapeRank,
+                                                       mElemSize,
+                                                       std::multiplies<>{});
+
+        for (std::size_t i{}; i < desc.getSrcDstBufferCount().second; ++i)
+        {
+          mBufferPtrs.push_back(mBuffers.emplace_back(cpu::makeAlignedUnique<std::byte[]>(alignment,
+                                                                                          cpuDesc.hugePagePolicy,
+                                                                                          bufferSize)).get());
+        }
+
+        const auto planMemorySize = mPlan->getBackendMemorySize();
+
+        mBackendMemorySize = mBuffers.size() * bufferSize + (planMemorySize.empty() ? 0 : planMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~TransposedPlan() override = default;
+
+      /**
+       * @brief Get backend of the contiguous plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the contiguous plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the contiguous plan and the internal buffers.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the contiguous plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "destination transposed by a blocked copy";
+      }
+
+    protected:
+      /**
+       * @brief Execute the contiguous plan into the internal buffers and transpose them into the destination.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const auto& desc        = DescGetter::get(*this);
+        const auto  shapeRank   = desc.getShapeRank();
+        const auto  threadLimit = desc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        const auto lock = lockExecution(mMutex);
+
+        executeBackendImplOf(*mPlan, src, View<void*>{mBufferPtrs.data(), mBufferPtrs.size()}, execParams);
+
+        for (std::size_t i{}; i < dst.size(); ++i)
+        {
+          transpose::copy(mBufferPtrs[i],
+                          View<std::size_t>{mContiguousStrides.data(), shapeRank},
+                          dst[i],
+                          desc.getMemoryLayout<Distribution::spst>().getDstStrides(),
+                          View<std::size_t>{mDstShape.data(), shapeRank},
+                          mElemSize,
+                          threadLimit);
+        }
+      }
+
+      /**
+       * @brief Execute the batch one transform after another, the transforms share the internal buffers.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      std::unique_ptr<Plan>                           mPlan{};              ///< The contiguous plan.
+      MaxDimArray<std::size_t>                        mDstShape{};          ///< The destination shape.
+      MaxDimArray<std::size_t>                        mContiguousStrides{}; ///< The internal buffer strides.
+      std::size_t                                     mElemSize{};          ///< The buffer element size in bytes.
+      std::vector<cpu::AlignedUniquePtr<std::byte[]>> mBuffers{};           ///< The internal buffers.
+      std::vector<void*>                              mBufferPtrs{};        ///< The internal buffer pointers.
+      std::size_t                                     mBackendMemorySize{}; ///< The internal memory size.
+      std::mutex                                      mMutex{};             ///< Serializes the executions.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_TRANSPOSED_PLAN_HPP */
@@ -0,0 +1,252 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_UNPADDED_REAL_PLAN_HPP
+#define AFFT_DETAIL_UNPADDED_REAL_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Check if a spst cpu plan is an in-place real-to-complex or complex-to-real transform whose real data is not
+   *        padded along the last axis, so the rows must be shifted to the padded layout of the backends.
+   * @param desc Plan description.
+   * @return True if the unpadded real plan is applicable, false otherwise.
+   */
+  [[nodiscard]] inline bool isUnpaddedRealLayout(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::cpu ||
+        desc.getDistribution() != Distribution::spst ||
+        !desc.getArchDesc<Target::cpu, Distribution::spst>().unpaddedInPlaceReal ||
+        desc.getPlacement() != Placement::inPlace ||
+        desc.getTransform() != Transform::dft)
+    {
+      return false;
+    }
+
+    switch (desc.getTransformDesc<Transform::dft>().type)
+    {
+    case dft::Type::realToComplex:
+    case dft::Type::complexToReal:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  /**
+   * @brief Validate the layout of an unpadded real plan.
+   * @param desc Plan description, see isUnpaddedRealLayout().
+   * @throw std::invalid_argument if the rows of the layout cannot be shifted in place.
+   */
+  inline void validateUnpaddedRealLayout(const Desc& desc)
+  {
+    const auto& memoryLayout = desc.getMemoryLayout<Distribution::spst>();
+
+    if (!memoryLayout.hasDefaultSrcStrides() || !memoryLayout.hasDefaultDstStrides())
+    {
+      throw std::invalid_argument{"Unpadded in-place real data requires the default memory layout"};
+    }
+
+    if (desc.getComplexFormat() != ComplexFormat::interleaved)
+    {
+      throw std::invalid_argument{"Unpadded in-place real data requires the interleaved complex format"};
+    }
+
+    if (desc.hasLogicalSrcShape() || desc.hasDstWindow())
+    {
+      throw std::invalid_argument{"Unpadded in-place real data supports neither a logical source shape nor a destination window"};
+    }
+
+    if (desc.getTransformAxes().back() + 1 != desc.getShapeRank())
+    {
+      throw std::invalid_argument{"Unpadded in-place real data requires the last transformed axis to be the last axis"};
+    }
+  }
+
+  /**
+   * @brief Make the description of the plan transforming the padded real rows of an unpadded real plan.
+   * @param desc Plan description, see isUnpaddedRealLayout().
+   * @return Plan description with the real rows padded to 2 * (n / 2 + 1) elements.
+   */
+  [[nodiscard]] inline Desc makePaddedRealDesc(const Desc& desc)
+  {
+    const auto shapeRank = desc.getShapeRank();
+    const bool isR2c     = (desc.getTransformDesc<Transform::dft>().type == dft::Type::realToComplex);
+    auto       realShape = (isR2c) ? desc.getSrcShape() : desc.getDstShape();
+    const auto cmplShape = (isR2c) ? desc.getDstShape() : desc.getSrcShape();
+
+    realShape[shapeRank - 1] = 2 * cmplShape[shapeRank - 1];
+
+    MaxDimArray<std::size_t> realStrides{};
+    MaxDimArray<std::size_t> cmplStrides{};
+
+    makeStrides(View<std::size_t>{realShape.data(), shapeRank}, Span<std::size_t>{realStrides.data(), shapeRank});
+    makeStrides(View<std::size_t>{cmplShape.data(), shapeRank}, Span<std::size_t>{cmplStrides.data(), shapeRank});
+
+    const View<std::size_t> srcStrides{(isR2c) ? realStrides.data() : cmplStrides.data(), shapeRank};
+    const View<std::size_t> dstStrides{(isR2c) ? cmplStrides.data() : realStrides.data(), shapeRank};
+
+    Desc paddedDesc{desc};
+
+    auto& cpuDesc = paddedDesc.getArchDesc<Target::cpu, Distribution::spst>();
+    cpuDesc.memoryLayout        = SpstMemoryLayout{shapeRank, afft::spst::MemoryLayout<>{srcStrides, dstStrides}};
+    cpuDesc.unpaddedInPlaceReal = false;
+
+    return paddedDesc;
+  }
+
+  /**
+   * @class UnpaddedRealPlan
+   * @brief Plan transforming in-place real data that is not padded along the last axis. A real-to-complex transform
+   *        shifts the real rows to the padded layout from the last row to the first before the padded plan runs, a
+   *        complex-to-real transform compacts them from the first row to the last afterwards. Each row moves within
+   *        the buffer, so no second buffer is needed, but the buffer must hold the complex data. Only spst cpu plans
+   *        are supported.
+   */
+  class UnpaddedRealPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param desc Plan description, see isUnpaddedRealLayout().
+       * @param paddedPlan Plan created from makePaddedRealDesc(desc).
+       */
+      UnpaddedRealPlan(const Desc& desc, std::unique_ptr<Plan> paddedPlan)
+      : Plan{desc},
+        mPlan{std::move(paddedPlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Padded plan must not be null"};
+        }
+
+        const auto shapeRank = desc.getShapeRank();
+        const auto shape     = desc.getShape();
+
+        mIsR2c = (desc.getTransformDesc<Transform::dft>().type == dft::Type::realToComplex);
+
+        const auto realSize = (mIsR2c) ? desc.sizeOfSrcElem() : desc.sizeOfDstElem();
+
+        mRowSize  = shape[shapeRank - 1] * realSize;
+        mRowPitch = 2 * (shape[shapeRank - 1] / 2 + 1) * realSize;
+        mRowCount = std::accumulate(shape.begin(), shape.begin() + shapeRank - 1, std::size_t{1}, std::multiplies<>{});
+      }
+
+      /// @brief Destructor.
+      ~UnpaddedRealPlan() override = default;
+
+      /**
+       * @brief Get backend of the padded plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the padded plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the padded plan.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return mPlan->getBackendMemorySize();
+      }
+
+      /**
+       * @brief Get the backend feedback of the padded plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + "real rows padded in place";
+      }
+
+    protected:
+      /**
+       * @brief Shift the real rows and execute the padded plan.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        auto* buffer = static_cast<std::byte*>(src.front());
+
+        if (mIsR2c)
+        {
+          // rows move to higher addresses, the last one first does not overwrite the rows still to be moved
+          for (std::size_t row = mRowCount; row > 1; --row)
+          {
+            std::memmove(buffer + (row - 1) * mRowPitch, buffer + (row - 1) * mRowSize, mRowSize);
+          }
+        }
+
+        executeBackendImplOf(*mPlan, src, dst, execParams);
+
+        if (!mIsR2c)
+        {
+          for (std::size_t row{1}; row < mRowCount; ++row)
+          {
+            std::memmove(buffer + row * mRowSize, buffer + row * mRowPitch, mRowSize);
+          }
+        }
+      }
+
+    private:
+      std::unique_ptr<Plan> mPlan{};     ///< The plan of the padded real rows.
+      bool                  mIsR2c{};    ///< Is the transform real-to-complex?
+      std::size_t           mRowSize{};  ///< The unpadded row size in bytes.
+      std::size_t           mRowPitch{}; ///< The padded row size in bytes.
+      std::size_t           mRowCount{}; ///< The number of rows along the last axis.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_UNPADDED_REAL_PLAN_HPP */
@@ -0,0 +1,257 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_WINDOWED_DST_PLAN_HPP
+#define AFFT_DETAIL_WINDOWED_DST_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "TransposedPlan.hpp"
+#include "transpose.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+
+namespace afft::detail
+{
+  /**
+   * @brief Check if a windowed plan may compute the full destination inside the source buffer. The out-of-place
+   *        complex-to-complex transform not preserving its source is then computed in-place in the source without any
+   *        internal buffer.
+   * @param desc Plan description with a destination window.
+   * @return True if the source buffer holds the full destination, false if an internal buffer is needed.
+   */
+  [[nodiscard]] inline bool isDstComputedInSrc(const Desc& desc)
+  {
+    const auto& prec = desc.getPrecision();
+
+    return desc.getPlacement() == Placement::outOfPlace &&
+           !desc.getPreserveSource() &&
+           !desc.hasLogicalSrcShape() &&
+           desc.getTransformDesc<Transform::dft>().type == dft::Type::complexToComplex &&
+           prec.source == prec.destination &&
+           desc.getMemoryLayout<Distribution::spst>().hasDefaultSrcStrides();
+  }
+
+  /**
+   * @brief Make the description of the plan computing the full destination of a windowed plan.
+   * @param desc Plan description with a destination window.
+   * @return Plan description with the full destination shape and the default destination strides.
+   */
+  [[nodiscard]] inline Desc makeFullDstDesc(const Desc& desc)
+  {
+    Desc fullDesc{desc};
+
+    fullDesc.resetDstWindow();
+
+    auto& cpuDesc = fullDesc.getArchDesc<Target::cpu, Distribution::spst>();
+    cpuDesc.memoryLayout.resetDstStrides();
+
+    fullDesc.setPlacement((isDstComputedInSrc(desc)) ? Placement::inPlace : Placement::outOfPlace);
+
+    return fullDesc;
+  }
+
+  /**
+   * @class WindowedDstPlan
+   * @brief Plan storing only a window of the destination. An out-of-place complex-to-complex transform not preserving
+   *        its source is computed in-place in the source buffer, other transforms compute into an internal buffer. The
+   *        window is then copied into the destination, so the destination buffer holds only the window. Only spst cpu
+   *        plans are supported. Executions of the plan are serialized, they share the internal buffers.
+   */
+  class WindowedDstPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the internal buffers.
+       * @param desc Plan description with a destination window.
+       * @param fullPlan Plan created from makeFullDstDesc(desc).
+       */
+      WindowedDstPlan(const Desc& desc, std::unique_ptr<Plan> fullPlan)
+      : Plan{desc},
+        mPlan{std::move(fullPlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Full destination plan must not be null"};
+        }
+
+        const auto& cpuDesc   = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  shapeRank = desc.getShapeRank();
+        const auto  alignment = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        Desc fullDesc{makeFullDstDesc(desc)};
+        fullDesc.fillDefaultMemoryLayoutStrides();
+
+        mWindowShape        = desc.getDstShape();
+        mElemSize           = getDstBufferElemSize(desc);
+        mIsDstComputedInSrc = isDstComputedInSrc(desc);
+
+        const auto dstStrides  = layoutDesc.getMemoryLayout<Distribution::spst>().getDstStrides();
+        const auto fullStrides = fullDesc.getMemoryLayout<Distribution::spst>().getDstStrides();
+        const auto start       = desc.getDstWindowStart();
+
+        std::copy(dstStrides.begin(), dstStrides.end(), mDstStrides.begin());
+        std::copy(fullStrides.begin(), fullStrides.end(), mFullStrides.begin());
+
+        mWindowOffset = std::inner_product(start.begin(), start.begin() + shapeRank, fullStrides.begin(), std::size_t{}) *
+                        mElemSize;
+
+        if (!mIsDstComputedInSrc)
+        {
+          const auto fullSize = fullDesc.getSpstSrcDstBufferSize().second;
+
+          for (std::size_t i{}; i < desc.getSrcDstBufferCount().second; ++i)
+          {
+            mBufferPtrs.push_back(mBuffers.emplace_back(cpu::makeAlignedUnique<std::byte[]>(alignment,
+                                                                                            cpuDesc.hugePagePolicy,
+                                                                                            fullSize)).get());
+          }
+
+          mBackendMemorySize = mBuffers.size() * fullSize;
+        }
+
+        const auto planMemorySize = mPlan->getBackendMemorySize();
+
+        mBackendMemorySize += (planMemorySize.empty() ? 0 : planMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~WindowedDstPlan() override = default;
+
+      /**
+       * @brief Get backend of the full destination plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the full destination plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the full destination plan and the internal buffers.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the full destination plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + ((mIsDstComputedInSrc) ? "destination window computed in the source"
+                                                 : "destination window computed in an internal buffer");
+      }
+
+    protected:
+      /**
+       * @brief Execute the full destination plan and copy the window into the destination.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const auto& desc        = DescGetter::get(*this);
+        const auto  shapeRank   = desc.getShapeRank();
+        const auto  threadLimit = desc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        const auto lock = lockExecution(mMutex);
+
+        const View<void*> full = (mIsDstComputedInSrc) ? src : View<void*>{mBufferPtrs.data(), mBufferPtrs.size()};
+
+        executeBackendImplOf(*mPlan, src, full, execParams);
+
+        for (std::size_t i{}; i < dst.size(); ++i)
+        {
+          transpose::copy(static_cast<const std::byte*>(full[i]) + mWindowOffset,
+                          View<std::size_t>{mFullStrides.data(), shapeRank},
+                          dst[i],
+                          View<std::size_t>{mDstStrides.data(), shapeRank},
+                          View<std::size_t>{mWindowShape.data(), shapeRank},
+                          mElemSize,
+                          threadLimit);
+        }
+      }
+
+      /**
+       * @brief Execute the batch one transform after another, the transforms share the internal buffers.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      std::unique_ptr<Plan>                           mPlan{};               ///< The full destination plan.
+      MaxDimArray<std::size_t>                        mWindowShape{};        ///< The destination window shape.
+      MaxDimArray<std::size_t>                        mDstStrides{};         ///< The destination strides.
+      MaxDimArray<std::size_t>                        mFullStrides{};        ///< The full destination strides.
+      std::size_t                                     mWindowOffset{};       ///< The window offset in bytes.
+      std::size_t                                     mElemSize{};           ///< The buffer element size in bytes.
+      bool                                            mIsDstComputedInSrc{}; ///< Is the destination computed in the source?
+      std::vector<cpu::AlignedUniquePtr<std::byte[]>> mBuffers{};            ///< The internal full destination buffers.
+      std::vector<void*>                              mBufferPtrs{};         ///< The internal buffer pointers.
+      std::size_t                                     mBackendMemorySize{};  ///< The internal memory size.
+      std::mutex                                      mMutex{};              ///< Serializes the executions.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_WINDOWED_DST_PLAN_HPP */
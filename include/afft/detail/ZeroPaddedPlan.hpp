@@ -0,0 +1,276 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_ZERO_PADDED_PLAN_HPP
+#define AFFT_DETAIL_ZERO_PADDED_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "transpose.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Get the size of one element of each source buffer, a half of the complex element for planar format.
+   * @param desc Plan description.
+   * @return Element size in bytes.
+   */
+  [[nodiscard]] inline std::size_t getSrcBufferElemSize(const Desc& desc)
+  {
+    const bool isPlanarCmpl = (desc.getComplexFormat() == ComplexFormat::planar) &&
+                              (desc.getSrcDstComplexity().first == Complexity::complex);
+
+    return desc.sizeOfSrcElem() / (isPlanarCmpl ? 2 : 1);
+  }
+
+  /**
+   * @brief Check if a zero padded plan may pad the source inside the destination buffer. The out-of-place
+   *        complex-to-complex transform is then computed in-place in the destination without any internal buffer.
+   * @param desc Plan description with a logical source shape.
+   * @return True if the destination buffer holds the padded source, false if an internal buffer is needed.
+   */
+  [[nodiscard]] inline bool isSrcPaddedInDst(const Desc& desc)
+  {
+    const auto& prec = desc.getPrecision();
+
+    return desc.getPlacement() == Placement::outOfPlace &&
+           desc.getTransformDesc<Transform::dft>().type == dft::Type::complexToComplex &&
+           prec.source == prec.destination &&
+           desc.getMemoryLayout<Distribution::spst>().hasDefaultDstStrides();
+  }
+
+  /**
+   * @brief Make the description of the plan transforming the padded source of a zero padded plan.
+   * @param desc Plan description with a logical source shape.
+   * @return Plan description with the full source shape and the default source strides.
+   */
+  [[nodiscard]] inline Desc makePaddedSrcDesc(const Desc& desc)
+  {
+    Desc paddedDesc{desc};
+
+    paddedDesc.resetLogicalSrcShape();
+
+    auto& cpuDesc = paddedDesc.getArchDesc<Target::cpu, Distribution::spst>();
+    cpuDesc.memoryLayout.resetSrcStrides();
+
+    if (isSrcPaddedInDst(desc))
+    {
+      paddedDesc.setPlacement(Placement::inPlace);
+    }
+    else
+    {
+      // the zeros written once into the internal buffer must survive the executions
+      paddedDesc.setPlacement(Placement::outOfPlace);
+      paddedDesc.setPreserveSource(true);
+    }
+
+    return paddedDesc;
+  }
+
+  /**
+   * @class ZeroPaddedPlan
+   * @brief Plan transforming a source of a logical shape smaller than the transform shape, implicitly zero-padded
+   *        to it. An out-of-place complex-to-complex source is padded in the destination buffer and transformed
+   *        in-place there, so no padded copy is allocated. Other transforms pad into an internal buffer zeroed once,
+   *        each execution copies only the logical source into it and transforms it out-of-place. Only spst cpu plans
+   *        are supported. Executions of the plan are serialized, they share the internal buffers.
+   */
+  class ZeroPaddedPlan final : public Plan
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the internal buffers.
+       * @param desc Plan description with a logical source shape.
+       * @param paddedPlan Plan created from makePaddedSrcDesc(desc).
+       */
+      ZeroPaddedPlan(const Desc& desc, std::unique_ptr<Plan> paddedPlan)
+      : Plan{desc},
+        mPlan{std::move(paddedPlan)}
+      {
+        if (!mPlan)
+        {
+          throw std::invalid_argument{"Padded plan must not be null"};
+        }
+
+        const auto& cpuDesc   = desc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  alignment = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        Desc paddedDesc{makePaddedSrcDesc(desc)};
+        paddedDesc.fillDefaultMemoryLayoutStrides();
+
+        mSrcShape = desc.getSrcShape();
+        mElemSize = getSrcBufferElemSize(desc);
+        mIsSrcPaddedInDst = isSrcPaddedInDst(desc);
+
+        const auto srcStrides    = layoutDesc.getMemoryLayout<Distribution::spst>().getSrcStrides();
+        const auto paddedStrides = paddedDesc.getMemoryLayout<Distribution::spst>().getSrcStrides();
+
+        std::copy(srcStrides.begin(), srcStrides.end(), mSrcStrides.begin());
+        std::copy(paddedStrides.begin(), paddedStrides.end(), mPaddedStrides.begin());
+
+        mPaddedSize = paddedDesc.getSpstSrcDstBufferSize().first;
+
+        if (!mIsSrcPaddedInDst)
+        {
+          for (std::size_t i{}; i < desc.getSrcDstBufferCount().first; ++i)
+          {
+            auto& buffer = mBuffers.emplace_back(cpu::makeAlignedUnique<std::byte[]>(alignment,
+                                                                                      cpuDesc.hugePagePolicy,
+                                                                                      mPaddedSize));
+            std::memset(buffer.get(), 0, mPaddedSize);
+            mBufferPtrs.push_back(buffer.get());
+          }
+        }
+
+        const auto planMemorySize = mPlan->getBackendMemorySize();
+
+        mBackendMemorySize = mBuffers.size() * mPaddedSize + (planMemorySize.empty() ? 0 : planMemorySize.front());
+      }
+
+      /// @brief Destructor.
+      ~ZeroPaddedPlan() override = default;
+
+      /**
+       * @brief Get backend of the padded plan.
+       * @return Backend
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return mPlan->getBackend();
+      }
+
+      /**
+       * @brief Get workspace size of the padded plan.
+       * @return Workspace size.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return mPlan->getWorkspaceSize();
+      }
+
+      /**
+       * @brief Get the memory held by the padded plan and the internal buffers.
+       * @return Internal memory size.
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback of the padded plan.
+       * @return Backend feedback.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        auto feedback = mPlan->getBackendFeedback();
+
+        if (!feedback.empty())
+        {
+          feedback += "; ";
+        }
+
+        return feedback + ((mIsSrcPaddedInDst) ? "source zero-padded in the destination"
+                                               : "source zero-padded in an internal buffer");
+      }
+
+    protected:
+      /**
+       * @brief Copy the logical source into the padded buffers and execute the padded plan.
+       * @param src Source buffers.
+       * @param dst Destination buffers.
+       * @param execParams Execution parameters.
+       */
+      void executeBackendImpl(View<void*>                                 src,
+                              View<void*>                                 dst,
+                              const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        const auto& desc        = DescGetter::get(*this);
+        const auto  shapeRank   = desc.getShapeRank();
+        const auto  threadLimit = desc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        const auto lock = lockExecution(mMutex);
+
+        const View<void*> padded = (mIsSrcPaddedInDst) ? dst : View<void*>{mBufferPtrs.data(), mBufferPtrs.size()};
+
+        for (std::size_t i{}; i < src.size(); ++i)
+        {
+          // the destination is overwritten by the transform, its padding must be zeroed each time
+          if (mIsSrcPaddedInDst)
+          {
+            std::memset(padded[i], 0, mPaddedSize);
+          }
+
+          transpose::copy(src[i],
+                          View<std::size_t>{mSrcStrides.data(), shapeRank},
+                          padded[i],
+                          View<std::size_t>{mPaddedStrides.data(), shapeRank},
+                          View<std::size_t>{mSrcShape.data(), shapeRank},
+                          mElemSize,
+                          threadLimit);
+        }
+
+        executeBackendImplOf(*mPlan, padded, dst, execParams);
+      }
+
+      /**
+       * @brief Execute the batch one transform after another, the transforms share the internal buffers.
+       * @param srcs Source buffers, one per transform.
+       * @param dsts Destination buffers, one per transform.
+       * @param execParams Execution parameters.
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::cpu::ExecutionParameters& execParams) override
+      {
+        for (std::size_t i{}; i < srcs.size(); ++i)
+        {
+          executeBackendImpl(View<void*>{&srcs[i], 1}, View<void*>{&dsts[i], 1}, execParams);
+        }
+      }
+
+    private:
+      std::unique_ptr<Plan>                           mPlan{};              ///< The padded plan.
+      MaxDimArray<std::size_t>                        mSrcShape{};          ///< The logical source shape.
+      MaxDimArray<std::size_t>                        mSrcStrides{};        ///< The logical source strides.
+      MaxDimArray<std::size_t>                        mPaddedStrides{};     ///< The padded source strides.
+      std::size_t                                     mElemSize{};          ///< The buffer element size in bytes.
+      std::size_t                                     mPaddedSize{};        ///< The padded buffer size in bytes.
+      bool                                            mIsSrcPaddedInDst{};  ///< Is the source padded in the destination?
+      std::vector<cpu::AlignedUniquePtr<std::byte[]>> mBuffers{};           ///< The internal padded buffers.
+      std::vector<void*>                              mBufferPtrs{};        ///< The internal buffer pointers.
+      std::size_t                                     mBackendMemorySize{}; ///< The internal memory size.
+      std::mutex                                      mMutex{};             ///< Serializes the executions.
+  };
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_ZERO_PADDED_PLAN_HPP */
@@ -104,6 +104,24 @@ namespace detail
     static constexpr Target       target{_target};
     static constexpr Distribution distribution{_distrib};
   };
+
+  /**
+   * @brief Result of the side effect free check of a backend capabilities made before the plan construction is
+   *        attempted, see the supports() function of each backend.
+   */
+  struct BackendSupport
+  {
+    const char* reason{}; ///< Reason of the rejection, null if the plan may be supported
+
+    /**
+     * @brief Check if the plan may be supported by the backend.
+     * @return True if the backend did not reject the plan, false otherwise.
+     */
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+      return reason == nullptr;
+    }
+  };
 } // namespace detail
 } // namespace afft
 
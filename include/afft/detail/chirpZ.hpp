@@ -0,0 +1,342 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_CHIRP_Z_HPP
+#define AFFT_DETAIL_CHIRP_Z_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "ThreadPool.hpp"
+#include "../alloc.hpp"
+#include "../Plan.hpp"
+
+namespace afft::detail::chirpZ
+{
+  /// @brief Largest prime factor every backend handles by its own kernels.
+  inline constexpr std::size_t maxNativePrimeFactor{7};
+
+  /**
+   * @brief Get the smallest power of two greater than or equal to the value.
+   * @param value Value.
+   * @return Power of two.
+   */
+  [[nodiscard]] constexpr std::size_t nextPowerOfTwo(std::size_t value) noexcept
+  {
+    std::size_t result{1};
+
+    while (result < value)
+    {
+      result <<= 1;
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Check if the length has a prime factor greater than maxNativePrimeFactor.
+   * @param length Length.
+   * @return True if the length has a large prime factor, false otherwise.
+   */
+  [[nodiscard]] constexpr bool hasLargePrimeFactor(std::size_t length) noexcept
+  {
+    for (std::size_t factor{2}; factor <= maxNativePrimeFactor; ++factor)
+    {
+      while (length % factor == 0)
+      {
+        length /= factor;
+      }
+    }
+
+    return length > 1;
+  }
+
+  /**
+   * @brief Make the chirp angles phi * m^2 / 2 of a DFT, phi = +-2pi / length. The angles are reduced exactly modulo
+   *        2pi by an integer recurrence, so long transforms keep the accuracy of the backend.
+   * @param length Transform length.
+   * @param direction Direction of the transform.
+   * @param count Number of angles.
+   * @return Chirp angles.
+   */
+  [[nodiscard]] inline std::vector<long double> makeDftChirpAngles(std::size_t length, Direction direction, std::size_t count)
+  {
+    constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+    const long double sign   = (direction == Direction::forward) ? 1.0L : -1.0L;
+    const std::size_t period = 2 * length;
+
+    std::vector<long double> angles(count);
+
+    // m^2 mod 2 * length, (m + 1)^2 = m^2 + 2m + 1
+    for (std::size_t m{}, square{}; m < count; ++m)
+    {
+      angles[m] = sign * pi * static_cast<long double>(square) / static_cast<long double>(length);
+      square    = (square + (2 * m + 1) % period) % period;
+    }
+
+    return angles;
+  }
+
+  /**
+   * @brief Make the chirp angles phi * m^2 / 2 of a chirp z-transform with the step angle phi.
+   * @param stepAngle Angle between the neighbouring outputs on the unit circle.
+   * @param count Number of angles.
+   * @return Chirp angles.
+   */
+  [[nodiscard]] inline std::vector<long double> makeChirpAngles(long double stepAngle, std::size_t count)
+  {
+    std::vector<long double> angles(count);
+
+    for (std::size_t m{}; m < count; ++m)
+    {
+      const auto ml = static_cast<long double>(m);
+
+      angles[m] = stepAngle * ml * ml / 2.0L;
+    }
+
+    return angles;
+  }
+
+  /**
+   * @class Engine
+   * @brief Chirp z-transform by the Bluestein algorithm. Computes X[k] = sum_n x[n] e^{-i (s n + phi (n k))} for
+   *        n < srcLength and k < dstLength along rows of the source, s is the start angle and phi the step angle given
+   *        by the chirp angles. The convolution with the chirp is computed by a forward and a backward power of two
+   *        transform of the fft length. Both plans are in-place c2c transforms of shape {rowCount, fftLength} along
+   *        axis 1 without normalization. The chirp sequences and the kernel spectrum are computed once. Executions
+   *        must not overlap, they share the work buffer.
+   * @tparam T Real type, float or double.
+   */
+  template<typename T>
+  class Engine
+  {
+    public:
+      /**
+       * @brief Constructor. Computes the chirp sequences and the kernel spectrum.
+       * @param rowCount Number of rows.
+       * @param srcLength Length of the source rows.
+       * @param dstLength Length of the destination rows.
+       * @param fftLength Length of the plans, a power of two of at least srcLength + dstLength - 1.
+       * @param startAngle Angle of the first output on the unit circle.
+       * @param chirpAngles Chirp angles of max(srcLength, dstLength) elements, see makeDftChirpAngles() and
+       *                    makeChirpAngles().
+       * @param scale Scale applied to the outputs.
+       * @param forwardPlan Forward plan.
+       * @param backwardPlan Backward plan.
+       * @param alignment Alignment of the internal buffers.
+       * @param hugePagePolicy Huge page policy of the internal buffers.
+       * @param threadLimit Maximum number of threads, 0 for the thread pool size.
+       */
+      Engine(std::size_t                     rowCount,
+             std::size_t                     srcLength,
+             std::size_t                     dstLength,
+             std::size_t                     fftLength,
+             long double                     startAngle,
+             const std::vector<long double>& chirpAngles,
+             T                               scale,
+             std::unique_ptr<Plan>           forwardPlan,
+             std::unique_ptr<Plan>           backwardPlan,
+             Alignment                       alignment,
+             HugePagePolicy                  hugePagePolicy,
+             std::size_t                     threadLimit)
+      : mRowCount{rowCount},
+        mSrcLength{srcLength},
+        mDstLength{dstLength},
+        mFftLength{fftLength},
+        mForwardPlan{std::move(forwardPlan)},
+        mBackwardPlan{std::move(backwardPlan)},
+        mThreadLimit{threadLimit}
+      {
+        if (!mForwardPlan || !mBackwardPlan)
+        {
+          throw std::invalid_argument{"Chirp z-transform plans must not be null"};
+        }
+
+        if (fftLength < srcLength + dstLength - 1 || chirpAngles.size() < std::max(srcLength, dstLength))
+        {
+          throw std::invalid_argument{"Chirp z-transform fft length is too short"};
+        }
+
+        auto phasor = [](long double angle)
+        {
+          return std::complex<T>{static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle))};
+        };
+
+        mSrcChirp.resize(srcLength);
+        mDstChirp.resize(dstLength);
+
+        for (std::size_t n{}; n < srcLength; ++n)
+        {
+          const long double startPhase = std::fmod(startAngle * static_cast<long double>(n),
+                                                   2.0L * 3.141592653589793238462643383279502884L);
+
+          mSrcChirp[n] = phasor(-(startPhase + chirpAngles[n]));
+        }
+
+        for (std::size_t k{}; k < dstLength; ++k)
+        {
+          mDstChirp[k] = phasor(-chirpAngles[k]) * scale;
+        }
+
+        mWork = cpu::makeAlignedUnique<std::complex<T>[]>(alignment, hugePagePolicy, rowCount * fftLength);
+
+        // the kernel e^{i phi m^2 / 2} for -srcLength < m < dstLength, wrapped around the fft length
+        for (std::size_t m{}; m < dstLength; ++m)
+        {
+          mWork[m] = phasor(chirpAngles[m]);
+        }
+
+        for (std::size_t m{1}; m < srcLength; ++m)
+        {
+          mWork[fftLength - m] = phasor(chirpAngles[m]);
+        }
+
+        mForwardPlan->executeUnsafe(static_cast<void*>(mWork.get()), static_cast<void*>(mWork.get()));
+
+        mKernelSpectrum.resize(fftLength);
+
+        // the 1 / fftLength of the unnormalized backward transform is folded into the kernel spectrum
+        for (std::size_t i{}; i < fftLength; ++i)
+        {
+          mKernelSpectrum[i] = mWork[i] / static_cast<T>(fftLength);
+        }
+      }
+
+      /// @brief Copy constructor is deleted.
+      Engine(const Engine&) = delete;
+
+      /// @brief Move constructor.
+      Engine(Engine&&) = default;
+
+      /// @brief Destructor.
+      ~Engine() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      Engine& operator=(const Engine&) = delete;
+
+      /// @brief Move assignment operator.
+      Engine& operator=(Engine&&) = default;
+
+      /**
+       * @brief Get the memory held by the engine and its plans.
+       * @return Memory size in bytes.
+       */
+      [[nodiscard]] std::size_t getMemorySize() const noexcept
+      {
+        auto getPlanMemorySize = [](const Plan& plan)
+        {
+          const auto planMemorySize = plan.getBackendMemorySize();
+
+          return std::accumulate(planMemorySize.begin(), planMemorySize.end(), std::size_t{});
+        };
+
+        return (mRowCount * mFftLength + mKernelSpectrum.size() + mSrcChirp.size() + mDstChirp.size()) *
+                 sizeof(std::complex<T>) +
+               getPlanMemorySize(*mForwardPlan) + getPlanMemorySize(*mBackwardPlan);
+      }
+
+      /**
+       * @brief Get the forward plan.
+       * @return Forward plan.
+       */
+      [[nodiscard]] const Plan& getForwardPlan() const noexcept
+      {
+        return *mForwardPlan;
+      }
+
+      /**
+       * @brief Execute the transform of all rows.
+       * @param src Source buffer.
+       * @param srcRowOffsets Offset of each source row in elements.
+       * @param srcStride Stride of the elements of a source row.
+       * @param dst Destination buffer, may alias the source.
+       * @param dstRowOffsets Offset of each destination row in elements.
+       * @param dstStride Stride of the elements of a destination row.
+       */
+      void execute(const std::complex<T>* src,
+                   View<std::size_t>      srcRowOffsets,
+                   std::size_t            srcStride,
+                   std::complex<T>*       dst,
+                   View<std::size_t>      dstRowOffsets,
+                   std::size_t            dstStride)
+      {
+        std::complex<T>* work = mWork.get();
+
+        parallelFor(mRowCount, mThreadLimit, [&](std::size_t row)
+        {
+          const std::complex<T>* srcRow  = src + srcRowOffsets[row];
+          std::complex<T>*       workRow = work + row * mFftLength;
+
+          for (std::size_t n{}; n < mSrcLength; ++n)
+          {
+            workRow[n] = srcRow[n * srcStride] * mSrcChirp[n];
+          }
+
+          std::fill(workRow + mSrcLength, workRow + mFftLength, std::complex<T>{});
+        });
+
+        mForwardPlan->executeUnsafe(static_cast<void*>(work), static_cast<void*>(work));
+
+        parallelFor(mRowCount, mThreadLimit, [&](std::size_t row)
+        {
+          std::complex<T>* workRow = work + row * mFftLength;
+
+          for (std::size_t i{}; i < mFftLength; ++i)
+          {
+            workRow[i] *= mKernelSpectrum[i];
+          }
+        });
+
+        mBackwardPlan->executeUnsafe(static_cast<void*>(work), static_cast<void*>(work));
+
+        parallelFor(mRowCount, mThreadLimit, [&](std::size_t row)
+        {
+          const std::complex<T>* workRow = work + row * mFftLength;
+          std::complex<T>*       dstRow  = dst + dstRowOffsets[row];
+
+          for (std::size_t k{}; k < mDstLength; ++k)
+          {
+            dstRow[k * dstStride] = workRow[k] * mDstChirp[k];
+          }
+        });
+      }
+
+    private:
+      std::size_t                              mRowCount{};       ///< Number of rows.
+      std::size_t                              mSrcLength{};      ///< Length of the source rows.
+      std::size_t                              mDstLength{};      ///< Length of the destination rows.
+      std::size_t                              mFftLength{};      ///< Length of the plans.
+      std::vector<std::complex<T>>             mSrcChirp{};       ///< Chirp multiplying the source.
+      std::vector<std::complex<T>>             mDstChirp{};       ///< Chirp multiplying the destination, scaled.
+      std::vector<std::complex<T>>             mKernelSpectrum{}; ///< Spectrum of the chirp kernel, scaled.
+      cpu::AlignedUniquePtr<std::complex<T>[]> mWork{};           ///< Work buffer of the rows.
+      std::unique_ptr<Plan>                    mForwardPlan{};    ///< Forward power of two plan.
+      std::unique_ptr<Plan>                    mBackwardPlan{};   ///< Backward power of two plan.
+      std::size_t                              mThreadLimit{};    ///< Maximum number of threads.
+  };
+} // namespace afft::detail::chirpZ
+
+#endif /* AFFT_DETAIL_CHIRP_Z_HPP */
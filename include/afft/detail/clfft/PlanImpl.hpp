@@ -30,6 +30,7 @@
 #endif
 
 #include "error.hpp"
+#include "PlanRegistry.hpp"
 #include "../common.hpp"
 #include "../PlanImpl.hpp"
 
@@ -59,100 +60,104 @@ namespace afft::detail::clfft
         const auto& dftParams    = getConfig().getTransformConfig<Transform::dft>();
         const auto& commonParams = getConfig().getCommonParameters();
 
-        const auto clfftDirection = (getConfig().getTransformDirection() == Direction::forward)
-                                      ? CLFFT_FORWARD : CLFFT_BACKWARD;
+        PlanKey key{};
+
+        key.direction = (getConfig().getTransformDirection() == Direction::forward) ? CLFFT_FORWARD : CLFFT_BACKWARD;
 
-        clfftDim clfftDim{};
         switch (getConfig().getTransformRank())
         {
-        case 1: clfftDim = CLFFT_1D; break;
-        case 2: clfftDim = CLFFT_2D; break;
-        case 3: clfftDim = CLFFT_3D; break;
+        case 1: key.dim = CLFFT_1D; break;
+        case 2: key.dim = CLFFT_2D; break;
+        case 3: key.dim = CLFFT_3D; break;
         default:
           throw std::runtime_error("Unsupported rank");
         }
 
-        const auto clfftLengths = getConfig().getTransformDims<SizeT>();
+        const auto clfftLengths   = getConfig().getTransformDims<SizeT>();
+        const auto clfftInStride  = getConfig().getTransformSrcStrides<SizeT>();
+        const auto clfftOutStride = getConfig().getTransformDstStrides<SizeT>();
 
+        for (std::size_t i{}; i < getConfig().getTransformRank(); ++i)
         {
-          clfftPlanHandle planHandle{};
-
-          Error::check(clfftCreateDefaultPlan(&planHandle,
-                                              gpuConfig.context,
-                                              clfftDim,
-                                              clfftLengths.data()));
-
-          mPlanHandle = planHandle;
+          key.lengths[i]    = clfftLengths[i];
+          key.inStrides[i]  = clfftInStride[i];
+          key.outStrides[i] = clfftOutStride[i];
         }
 
-        clfftPrecision clfftPrecision{};
         switch (getConfig().getTransformPrecision().execution)
         {
-        case Precision::f32: clfftPrecision = CLFFT_SINGLE; break;
-        case Precision::f64: clfftPrecision = CLFFT_DOUBLE; break;
+        case Precision::f32: key.precision = CLFFT_SINGLE; break;
+        case Precision::f64: key.precision = CLFFT_DOUBLE; break;
         default:
           throw std::runtime_error("Unsupported precision");
         }
 
-        Error::check(clfftSetPlanPrecision(mPlanHandle.value(), clfftPrecision));
-
-        const auto clfftScale = getConfig().getTransformNormFactor<Precision::f32>();
-
-        Error::check(clfftSetPlanScale(mPlanHandle.value(), clfftDirection, clfftScale));
+        key.scale = getConfig().getTransformNormFactor<Precision::f32>();
 
-        const auto clfftBatchSize = (getConfig().getTransformHowManyRank() > 0)
-                                      ? getConfig().getTransformHowManyDims<SizeT>()[0] : SizeT{1};
-
-        Error::check(clfftSetPlanBatchSize(mPlanHandle.value(), clfftBatchSize));
-
-        auto clfftInStride  = getConfig().getTransformSrcStrides<SizeT>();
-        auto clfftOutStride = getConfig().getTransformDstStrides<SizeT>();
-
-        Error::check(clfftSetPlanInStride(mPlanHandle.value(), clfftDim, clfftInStride.data()));
-        Error::check(clfftSetPlanOutStride(mPlanHandle.value(), clfftDim, clfftOutStride.data()));
+        key.batchSize = (getConfig().getTransformHowManyRank() > 0)
+                          ? getConfig().getTransformHowManyDims<SizeT>()[0] : SizeT{1};
 
         if (getConfig().getTransformHowManyRank() > 0)
         {
-          auto clfftInDist  = getConfig().getTransformHowManySrcStrides<SizeT>()[0];
-          auto clfftOutDist = getConfig().getTransformHowManyDstStrides<SizeT>()[0];
-
-          Error::check(clfftSetPlanDistance(mPlanHandle.value(), clfftInDist, clfftOutDist));
+          key.inDistance  = getConfig().getTransformHowManySrcStrides<SizeT>()[0];
+          key.outDistance = getConfig().getTransformHowManyDstStrides<SizeT>()[0];
         }
 
-        clfftLayout clfftInLayout{};
-        clfftLayout clfftOutLayout{};
         switch (dftParams.type)
         {
         case dft::Type::complexToComplex:
-          clfftInLayout  = (commonParams.complexFormat == ComplexFormat::interleaved)
-                             ? CLFFT_COMPLEX_INTERLEAVED : CLFFT_COMPLEX_PLANAR;
-          clfftOutLayout = (commonParams.complexFormat == ComplexFormat::interleaved)
-                             ? CLFFT_COMPLEX_INTERLEAVED : CLFFT_COMPLEX_PLANAR;
+          key.inLayout  = (commonParams.complexFormat == ComplexFormat::interleaved)
+                            ? CLFFT_COMPLEX_INTERLEAVED : CLFFT_COMPLEX_PLANAR;
+          key.outLayout = (commonParams.complexFormat == ComplexFormat::interleaved)
+                            ? CLFFT_COMPLEX_INTERLEAVED : CLFFT_COMPLEX_PLANAR;
           break;
         case dft::Type::realToComplex:
-          clfftInLayout  = (commonParams.complexFormat == ComplexFormat::interleaved)
-                             ? CLFFT_REAL : CLFFT_REAL;
-          clfftOutLayout = (commonParams.complexFormat == ComplexFormat::interleaved)
-                             ? CLFFT_HERMITIAN_INTERLEAVED : CLFFT_HERMITIAN_PLANAR;
+          key.inLayout  = CLFFT_REAL;
+          key.outLayout = (commonParams.complexFormat == ComplexFormat::interleaved)
+                            ? CLFFT_HERMITIAN_INTERLEAVED : CLFFT_HERMITIAN_PLANAR;
           break;
         case dft::Type::complexToReal:
-          clfftInLayout  = (commonParams.complexFormat == ComplexFormat::interleaved)
-                             ? CLFFT_HERMITIAN_INTERLEAVED : CLFFT_HERMITIAN_PLANAR;
-          clfftOutLayout = (commonParams.complexFormat == ComplexFormat::interleaved)
-                             ? CLFFT_REAL : CLFFT_REAL;
+          key.inLayout  = (commonParams.complexFormat == ComplexFormat::interleaved)
+                            ? CLFFT_HERMITIAN_INTERLEAVED : CLFFT_HERMITIAN_PLANAR;
+          key.outLayout = CLFFT_REAL;
           break;
         default:
           cxx::unreachable();
         }
 
-        Error::check(clfftSetLayout(mPlanHandle.value(), clfftInLayout, clfftOutLayout));
+        key.resultLocation = (commonParams.placement == Placement::inPlace) ? CLFFT_INPLACE : CLFFT_OUTOFPLACE;
+
+        // the same plan made for another context is copied rather than configured again
+        if (auto planHandle = PlanRegistry::get().copy(key, gpuConfig.context))
+        {
+          mPlanHandle = *planHandle;
+        }
+        else
+        {
+          clfftPlanHandle newPlanHandle{};
+
+          checkError(clfftCreateDefaultPlan(&newPlanHandle, gpuConfig.context, key.dim, key.lengths.data()));
+
+          mPlanHandle = newPlanHandle;
+
+          checkError(clfftSetPlanPrecision(newPlanHandle, key.precision));
+          checkError(clfftSetPlanScale(newPlanHandle, key.direction, key.scale));
+          checkError(clfftSetPlanBatchSize(newPlanHandle, key.batchSize));
+          checkError(clfftSetPlanInStride(newPlanHandle, key.dim, key.inStrides.data()));
+          checkError(clfftSetPlanOutStride(newPlanHandle, key.dim, key.outStrides.data()));
 
-        const auto clfftResultLocation = (commonParams.placement == Placement::inPlace)
-                                           ? CLFFT_INPLACE : CLFFT_OUTOFPLACE;
+          if (getConfig().getTransformHowManyRank() > 0)
+          {
+            checkError(clfftSetPlanDistance(newPlanHandle, key.inDistance, key.outDistance));
+          }
 
-        Error::check(clfftSetResultLocation(mPlanHandle.value(), clfftResultLocation));
+          checkError(clfftSetLayout(newPlanHandle, key.inLayout, key.outLayout));
+          checkError(clfftSetResultLocation(newPlanHandle, key.resultLocation));
 
-        Error::check(clfftBakePlan(mPlanHandle.value(), 0, nullptr, nullptr, nullptr));
+          PlanRegistry::get().add(key, gpuConfig.context, newPlanHandle);
+        }
+
+        checkError(clfftBakePlan(mPlanHandle.value(), 0, nullptr, nullptr, nullptr));
       }
 
       /// @brief Destructor
@@ -160,7 +165,7 @@ namespace afft::detail::clfft
       {
         if (mPlanHandle)
         {
-          Error::check(clfftDestroyPlan(&mPlanHandle.value()));
+          checkError(clfftDestroyPlan(&mPlanHandle.value()));
         }
       }
 
@@ -178,30 +183,46 @@ namespace afft::detail::clfft
         const auto clfftDirection = (getConfig().getTransformDirection() == Direction::forward)
                                       ? CLFFT_FORWARD : CLFFT_BACKWARD;
 
-        auto tmpBuffer = (getConfig().getTargetConfig<Target::gpu>().externalWorkspace)
-                           ? execParams.workspace : nullptr;
-
-        Error::check(clfftEnqueueTransform(mPlanHandle.value(),
-                                           clfftDirection,
-                                           1,
-                                           &execParams.commandQueue,
-                                           0,
-                                           nullptr,
-                                           nullptr,
-                                           reinterpret_cast<cl_mem*>(src.data()),
-                                           reinterpret_cast<cl_mem*>(dst.data()),
-                                           tmpBuffer));
+        // a user provided workspace keeps clFFT from allocating its temporary buffer on the first execution
+        cl_mem tmpBuffer = execParams.workspace;
+
+        if (tmpBuffer == nullptr && getConfig().getTargetConfig<Target::gpu>().externalWorkspace && getWorkspaceSize() > 0)
+        {
+          throw std::invalid_argument{"the plan requires an external workspace"};
+        }
+
+        const auto commandQueues = (execParams.commandQueues.empty())
+                                     ? View<cl_command_queue>{&execParams.commandQueue, 1}
+                                     : execParams.commandQueues;
+
+        if (!execParams.completionEvents.empty() && execParams.completionEvents.size() != commandQueues.size())
+        {
+          throw std::invalid_argument{"there must be one completion event per command queue"};
+        }
+
+        checkError(clfftEnqueueTransform(mPlanHandle.value(),
+                                         clfftDirection,
+                                         static_cast<cl_uint>(commandQueues.size()),
+                                         const_cast<cl_command_queue*>(commandQueues.data()),
+                                         static_cast<cl_uint>(execParams.waitEvents.size()),
+                                         execParams.waitEvents.data(),
+                                         (execParams.completionEvents.empty())
+                                           ? nullptr : execParams.completionEvents.data(),
+                                         reinterpret_cast<cl_mem*>(src.data()),
+                                         reinterpret_cast<cl_mem*>(dst.data()),
+                                         tmpBuffer));
       }
 
       /**
-       * @brief Get the workspace size
+       * @brief Get the workspace size, the size of the clFFT temporary buffer of the baked plan. A workspace of this size
+       *        passed in the execution parameters is used instead of the buffer clFFT would allocate itself.
        * @return Workspace size
        */
       [[nodiscard]] std::size_t getWorkspaceSize() const override
       {
         std::size_t workspaceSize{};
 
-        Error::check(clfftGetTmpBufSize(mPlanHandle.value(), &workspaceSize));
+        checkError(clfftGetTmpBufSize(mPlanHandle.value(), &workspaceSize));
 
         return workspaceSize;
       }
@@ -0,0 +1,158 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_CLFFT_PLAN_REGISTRY_HPP
+#define AFFT_DETAIL_CLFFT_PLAN_REGISTRY_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "error.hpp"
+
+namespace afft::detail::clfft
+{
+  /// @brief Parameters of a clFFT plan, plans with equal keys differ only in their context
+  struct PlanKey
+  {
+    clfftDim                   dim{};            ///< transform dimension
+    std::array<std::size_t, 3> lengths{};        ///< transform lengths
+    clfftPrecision             precision{};      ///< precision
+    clfftDirection             direction{};      ///< direction the scale applies to
+    float                      scale{};          ///< scale of the direction
+    std::size_t                batchSize{};      ///< batch size
+    std::array<std::size_t, 3> inStrides{};      ///< input strides
+    std::array<std::size_t, 3> outStrides{};     ///< output strides
+    std::size_t                inDistance{};     ///< input batch distance
+    std::size_t                outDistance{};    ///< output batch distance
+    clfftLayout                inLayout{};       ///< input layout
+    clfftLayout                outLayout{};      ///< output layout
+    clfftResultLocation        resultLocation{}; ///< in-place or out-of-place
+
+    /// @brief Equality operator.
+    [[nodiscard]] friend bool operator==(const PlanKey& lhs, const PlanKey& rhs) noexcept
+    {
+      return lhs.dim == rhs.dim && lhs.lengths == rhs.lengths && lhs.precision == rhs.precision &&
+             lhs.direction == rhs.direction && lhs.scale == rhs.scale && lhs.batchSize == rhs.batchSize &&
+             lhs.inStrides == rhs.inStrides && lhs.outStrides == rhs.outStrides &&
+             lhs.inDistance == rhs.inDistance && lhs.outDistance == rhs.outDistance &&
+             lhs.inLayout == rhs.inLayout && lhs.outLayout == rhs.outLayout &&
+             lhs.resultLocation == rhs.resultLocation;
+    }
+  };
+
+  /**
+   * @class PlanRegistry
+   * @brief Process wide registry of configured clFFT plans. A plan with the parameters of a registered one is made by
+   *        clfftCopyPlan into its own context instead of being configured again, so creating the same plan for each
+   *        context of a deployment repeats only the bake, whose kernel binaries clFFT caches per device. The
+   *        registered plans are owned by the registry and destroyed by clear() before the library teardown.
+   */
+  class PlanRegistry
+  {
+    public:
+      /**
+       * @brief Get the registry.
+       * @return The registry.
+       */
+      [[nodiscard]] static PlanRegistry& get()
+      {
+        static PlanRegistry registry{};
+
+        return registry;
+      }
+
+      /**
+       * @brief Make a plan copied from the registered plan of the parameters.
+       * @param key The parameters.
+       * @param context The context of the new plan.
+       * @return The new plan, std::nullopt if no plan of the parameters is registered.
+       */
+      [[nodiscard]] std::optional<clfftPlanHandle> copy(const PlanKey& key, cl_context context)
+      {
+        std::lock_guard lock{mMutex};
+
+        const auto it = std::find_if(mPlans.begin(), mPlans.end(), [&](const auto& entry)
+        {
+          return entry.first == key;
+        });
+
+        if (it == mPlans.end())
+        {
+          return std::nullopt;
+        }
+
+        clfftPlanHandle planHandle{};
+
+        checkError(clfftCopyPlan(&planHandle, context, it->second));
+
+        return planHandle;
+      }
+
+      /**
+       * @brief Register a copy of the configured plan unless the parameters are registered already.
+       * @param key The parameters.
+       * @param context The context of the plan.
+       * @param planHandle The plan.
+       */
+      void add(const PlanKey& key, cl_context context, clfftPlanHandle planHandle)
+      {
+        std::lock_guard lock{mMutex};
+
+        if (std::any_of(mPlans.begin(), mPlans.end(), [&](const auto& entry) { return entry.first == key; }))
+        {
+          return;
+        }
+
+        clfftPlanHandle copyHandle{};
+
+        checkError(clfftCopyPlan(&copyHandle, context, planHandle));
+
+        mPlans.emplace_back(key, copyHandle);
+      }
+
+      /// @brief Destroy the registered plans.
+      void clear()
+      {
+        std::lock_guard lock{mMutex};
+
+        for (auto& [key, planHandle] : mPlans)
+        {
+          clfftDestroyPlan(&planHandle);
+        }
+
+        mPlans.clear();
+      }
+
+    private:
+      /// @brief Default constructor.
+      PlanRegistry() = default;
+
+      std::mutex                                       mMutex{}; ///< guards the plans
+      std::vector<std::pair<PlanKey, clfftPlanHandle>> mPlans{}; ///< the registered plans
+  };
+} // namespace afft::detail::clfft
+
+#endif /* AFFT_DETAIL_CLFFT_PLAN_REGISTRY_HPP */
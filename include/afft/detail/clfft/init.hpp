@@ -30,6 +30,7 @@
 #endif
 
 #include "error.hpp"
+#include "PlanRegistry.hpp"
 
 namespace afft::detail::clfft
 {
@@ -45,6 +46,8 @@ namespace afft::detail::clfft
   /// @brief Finalize the clFFT library.
   inline void finalize()
   {
+    PlanRegistry::get().clear();
+
     checkError(clfftTeardown());
   }
 } // namespace afft::detail::clfft
@@ -0,0 +1,677 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_CODELET_DOUBLE_DOUBLE_HPP
+#define AFFT_DETAIL_CODELET_DOUBLE_DOUBLE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../ThreadPool.hpp"
+#include "../../common.hpp"
+
+namespace afft::detail::codelet::dd
+{
+  /// @brief Double-double real, the unevaluated sum hi + lo with |lo| <= ulp(hi) / 2, the layout of Precision::f64f64.
+  struct Real
+  {
+    double hi; ///< The leading part.
+    double lo; ///< The trailing part.
+  };
+
+  /// @brief Double-double complex, the interleaved layout of complex Precision::f64f64 data.
+  struct Complex
+  {
+    Real re; ///< The real part.
+    Real im; ///< The imaginary part.
+  };
+
+  /// @brief Largest prime radix computed by the butterflies, lengths of larger prime factors use the Bluestein method.
+  inline constexpr std::size_t maxRadix{32};
+
+  /// @brief Scalar operations on doubles.
+  struct ScalarOps
+  {
+    /// @brief Vector type.
+    using V = double;
+
+    /// @brief Number of doubles in a vector.
+    static constexpr std::size_t width{1};
+
+    static V    load(const double* ptr) noexcept   { return *ptr; }
+    static void store(double* ptr, V v) noexcept   { *ptr = v; }
+    static V    set(double value) noexcept         { return value; }
+    static V    add(V a, V b) noexcept             { return a + b; }
+    static V    sub(V a, V b) noexcept             { return a - b; }
+    static V    mul(V a, V b) noexcept             { return a * b; }
+
+    /**
+     * @brief Error-free product, a * b = p + e exactly.
+     * @param a The first factor.
+     * @param b The second factor.
+     * @param p The rounded product.
+     * @param e The rounding error of the product.
+     */
+    static void twoProd(V a, V b, V& p, V& e) noexcept
+    {
+      p = a * b;
+#   if defined(__FMA__) || defined(FP_FAST_FMA) || defined(__ARM_FEATURE_FMA)
+      e = std::fma(a, b, -p);
+#   else
+      // Dekker's product splits the factors into halves of 26 bits, whose products are exact
+      constexpr double splitter = 134217729.0; // 2^27 + 1
+
+      const double aSplit = splitter * a;
+      const double aHi    = aSplit - (aSplit - a);
+      const double aLo    = a - aHi;
+      const double bSplit = splitter * b;
+      const double bHi    = bSplit - (bSplit - b);
+      const double bLo    = b - bHi;
+
+      e = ((aHi * bHi - p) + aHi * bLo + aLo * bHi) + aLo * bLo;
+#   endif
+    }
+  };
+
+#if defined(__AVX512F__)
+  /// @brief AVX-512 operations on eight doubles.
+  struct SimdOps
+  {
+    using V = __m512d;
+
+    static constexpr std::size_t width{8};
+
+    static V    load(const double* ptr) noexcept   { return _mm512_loadu_pd(ptr); }
+    static void store(double* ptr, V v) noexcept   { _mm512_storeu_pd(ptr, v); }
+    static V    set(double value) noexcept         { return _mm512_set1_pd(value); }
+    static V    add(V a, V b) noexcept             { return _mm512_add_pd(a, b); }
+    static V    sub(V a, V b) noexcept             { return _mm512_sub_pd(a, b); }
+    static V    mul(V a, V b) noexcept             { return _mm512_mul_pd(a, b); }
+
+    static void twoProd(V a, V b, V& p, V& e) noexcept
+    {
+      p = _mm512_mul_pd(a, b);
+      e = _mm512_fmsub_pd(a, b, p);
+    }
+  };
+#elif defined(__AVX2__) && defined(__FMA__)
+  /// @brief AVX2 operations on four doubles.
+  struct SimdOps
+  {
+    using V = __m256d;
+
+    static constexpr std::size_t width{4};
+
+    static V    load(const double* ptr) noexcept   { return _mm256_loadu_pd(ptr); }
+    static void store(double* ptr, V v) noexcept   { _mm256_storeu_pd(ptr, v); }
+    static V    set(double value) noexcept         { return _mm256_set1_pd(value); }
+    static V    add(V a, V b) noexcept             { return _mm256_add_pd(a, b); }
+    static V    sub(V a, V b) noexcept             { return _mm256_sub_pd(a, b); }
+    static V    mul(V a, V b) noexcept             { return _mm256_mul_pd(a, b); }
+
+    static void twoProd(V a, V b, V& p, V& e) noexcept
+    {
+      p = _mm256_mul_pd(a, b);
+      e = _mm256_fmsub_pd(a, b, p);
+    }
+  };
+#else
+  /// @brief No SIMD operations are available, the scalar ones are used.
+  using SimdOps = ScalarOps;
+#endif
+
+  /**
+   * @brief Double-double real of vectors.
+   * @tparam Ops The vector operations.
+   */
+  template<typename Ops>
+  struct RealV
+  {
+    typename Ops::V hi; ///< The leading parts.
+    typename Ops::V lo; ///< The trailing parts.
+  };
+
+  /**
+   * @brief Double-double complex of vectors.
+   * @tparam Ops The vector operations.
+   */
+  template<typename Ops>
+  struct ComplexV
+  {
+    RealV<Ops> re; ///< The real parts.
+    RealV<Ops> im; ///< The imaginary parts.
+  };
+
+  /// @brief Error-free sum, a + b = s + e exactly.
+  template<typename Ops>
+  [[nodiscard]] inline RealV<Ops> twoSum(typename Ops::V a, typename Ops::V b) noexcept
+  {
+    const auto s  = Ops::add(a, b);
+    const auto bb = Ops::sub(s, a);
+
+    return {s, Ops::add(Ops::sub(a, Ops::sub(s, bb)), Ops::sub(b, bb))};
+  }
+
+  /// @brief Error-free sum of |a| >= |b|, a + b = s + e exactly.
+  template<typename Ops>
+  [[nodiscard]] inline RealV<Ops> quickTwoSum(typename Ops::V a, typename Ops::V b) noexcept
+  {
+    const auto s = Ops::add(a, b);
+
+    return {s, Ops::sub(b, Ops::sub(s, a))};
+  }
+
+  /// @brief Double-double sum, relative error of about 2^-106.
+  template<typename Ops>
+  [[nodiscard]] inline RealV<Ops> add(const RealV<Ops>& a, const RealV<Ops>& b) noexcept
+  {
+    auto s = twoSum<Ops>(a.hi, b.hi);
+    auto t = twoSum<Ops>(a.lo, b.lo);
+
+    s = quickTwoSum<Ops>(s.hi, Ops::add(s.lo, t.hi));
+
+    return quickTwoSum<Ops>(s.hi, Ops::add(s.lo, t.lo));
+  }
+
+  /// @brief Double-double negation.
+  template<typename Ops>
+  [[nodiscard]] inline RealV<Ops> neg(const RealV<Ops>& a) noexcept
+  {
+    return {Ops::sub(Ops::set(0.0), a.hi), Ops::sub(Ops::set(0.0), a.lo)};
+  }
+
+  /// @brief Double-double difference.
+  template<typename Ops>
+  [[nodiscard]] inline RealV<Ops> sub(const RealV<Ops>& a, const RealV<Ops>& b) noexcept
+  {
+    return add<Ops>(a, neg<Ops>(b));
+  }
+
+  /// @brief Double-double product, the error-free product of the leading parts is corrected by the cross terms.
+  template<typename Ops>
+  [[nodiscard]] inline RealV<Ops> mul(const RealV<Ops>& a, const RealV<Ops>& b) noexcept
+  {
+    typename Ops::V p{};
+    typename Ops::V e{};
+
+    Ops::twoProd(a.hi, b.hi, p, e);
+
+    e = Ops::add(e, Ops::add(Ops::mul(a.hi, b.lo), Ops::mul(a.lo, b.hi)));
+
+    return quickTwoSum<Ops>(p, e);
+  }
+
+  /// @brief Double-double complex sum.
+  template<typename Ops>
+  [[nodiscard]] inline ComplexV<Ops> add(const ComplexV<Ops>& a, const ComplexV<Ops>& b) noexcept
+  {
+    return {add<Ops>(a.re, b.re), add<Ops>(a.im, b.im)};
+  }
+
+  /// @brief Double-double complex difference.
+  template<typename Ops>
+  [[nodiscard]] inline ComplexV<Ops> sub(const ComplexV<Ops>& a, const ComplexV<Ops>& b) noexcept
+  {
+    return {sub<Ops>(a.re, b.re), sub<Ops>(a.im, b.im)};
+  }
+
+  /// @brief Double-double complex product.
+  template<typename Ops>
+  [[nodiscard]] inline ComplexV<Ops> mul(const ComplexV<Ops>& a, const ComplexV<Ops>& b) noexcept
+  {
+    return {sub<Ops>(mul<Ops>(a.re, b.re), mul<Ops>(a.im, b.im)), add<Ops>(mul<Ops>(a.re, b.im), mul<Ops>(a.im, b.re))};
+  }
+
+  /// @brief Double-double complex product by a real.
+  template<typename Ops>
+  [[nodiscard]] inline ComplexV<Ops> mul(const ComplexV<Ops>& a, const RealV<Ops>& b) noexcept
+  {
+    return {mul<Ops>(a.re, b), mul<Ops>(a.im, b)};
+  }
+
+  /// @brief Product by -i for forward transforms or by i for backward ones, exact.
+  template<typename Ops>
+  [[nodiscard]] inline ComplexV<Ops> mulByUnit(const ComplexV<Ops>& a, bool isForward) noexcept
+  {
+    return (isForward) ? ComplexV<Ops>{a.im, neg<Ops>(a.re)} : ComplexV<Ops>{neg<Ops>(a.im), a.re};
+  }
+
+  /// @brief Broadcast a double-double real to all vector lanes.
+  template<typename Ops>
+  [[nodiscard]] inline RealV<Ops> broadcast(const Real& a) noexcept
+  {
+    return {Ops::set(a.hi), Ops::set(a.lo)};
+  }
+
+  /// @brief Broadcast a double-double complex to all vector lanes.
+  template<typename Ops>
+  [[nodiscard]] inline ComplexV<Ops> broadcast(const Complex& a) noexcept
+  {
+    return {broadcast<Ops>(a.re), broadcast<Ops>(a.im)};
+  }
+
+  /// @brief Convert a double-double scalar complex to the storage type.
+  [[nodiscard]] inline Complex toComplex(const ComplexV<ScalarOps>& a) noexcept
+  {
+    return {{a.re.hi, a.re.lo}, {a.im.hi, a.im.lo}};
+  }
+
+  /**
+   * @brief Get the quotient of two integers below 2^53 as a double-double.
+   * @param num The numerator.
+   * @param den The denominator, nonzero.
+   * @return The quotient.
+   */
+  [[nodiscard]] inline RealV<ScalarOps> divide(std::size_t num, std::size_t den) noexcept
+  {
+    const double a  = static_cast<double>(num);
+    const double b  = static_cast<double>(den);
+    const double q1 = a / b;
+    const double q2 = std::fma(-q1, b, a) / b;
+
+    return quickTwoSum<ScalarOps>(q1, q2);
+  }
+
+  /**
+   * @brief Get the inverse square root of an integer below 2^53 as a double-double, one Newton step refines the
+   *        double estimate.
+   * @param value The value, nonzero.
+   * @return The inverse square root.
+   */
+  [[nodiscard]] inline RealV<ScalarOps> inverseSqrt(std::size_t value) noexcept
+  {
+    const RealV<ScalarOps> x{1.0 / std::sqrt(static_cast<double>(value)), 0.0};
+    const RealV<ScalarOps> v{static_cast<double>(value), 0.0};
+    const RealV<ScalarOps> half{0.5, 0.0};
+    const RealV<ScalarOps> one{1.0, 0.0};
+
+    // x + x (1 - v x^2) / 2
+    return add<ScalarOps>(x, mul<ScalarOps>(mul<ScalarOps>(x, half), sub<ScalarOps>(one, mul<ScalarOps>(v, mul<ScalarOps>(x, x)))));
+  }
+
+  /**
+   * @brief Get e^{-+2pi i j / n} as a double-double. The angle is reduced exactly to the first quadrant using the
+   *        integer j / n, where the Taylor series converge to the double-double precision.
+   * @param j The index.
+   * @param n The length.
+   * @param isForward Is the transform forward?
+   * @return The root of unity.
+   */
+  [[nodiscard]] inline ComplexV<ScalarOps> rootOfUnity(std::size_t j, std::size_t n, bool isForward) noexcept
+  {
+    using R = RealV<ScalarOps>;
+
+    constexpr R halfPi{1.5707963267948966, 6.123233995736766e-17};
+
+    // 4j / n = quadrant + remainder / n
+    const std::size_t quadrant  = ((4 * j) / n) % 4;
+    const std::size_t remainder = (4 * j) % n;
+    const R           angle     = mul<ScalarOps>(halfPi, divide(remainder, n));
+
+    R sinValue{};
+    R cosValue{};
+    R term{1.0, 0.0};
+
+    for (std::size_t k{}; k < 48 && term.hi != 0.0; ++k)
+    {
+      auto& value = (k % 2 == 0) ? cosValue : sinValue;
+
+      value = ((k / 2) % 2 == 0) ? add<ScalarOps>(value, term) : sub<ScalarOps>(value, term);
+      term  = mul<ScalarOps>(mul<ScalarOps>(term, angle), divide(1, k + 1));
+    }
+
+    // e^{i (quadrant pi / 2 + angle)}
+    R re{};
+    R im{};
+
+    switch (quadrant)
+    {
+    case 0:  re = cosValue;                 im = sinValue;                 break;
+    case 1:  re = neg<ScalarOps>(sinValue); im = cosValue;                 break;
+    case 2:  re = neg<ScalarOps>(cosValue); im = neg<ScalarOps>(sinValue); break;
+    default: re = sinValue;                 im = neg<ScalarOps>(cosValue); break;
+    }
+
+    return {re, (isForward) ? neg<ScalarOps>(im) : im};
+  }
+
+  /**
+   * @brief Make the roots of unity e^{-+2pi i j / n} for j < n. Only about 2 sqrt(n) roots are evaluated by the Taylor
+   *        series, the others are products of a coarse and a fine root.
+   * @param n The length.
+   * @param isForward Is the transform forward?
+   * @return The roots of unity.
+   */
+  [[nodiscard]] inline std::vector<Complex> makeRootsOfUnity(std::size_t n, bool isForward)
+  {
+    const auto fineCount = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+
+    std::vector<ComplexV<ScalarOps>> fine(fineCount);
+    std::vector<ComplexV<ScalarOps>> coarse(n / fineCount + 1);
+
+    for (std::size_t j{}; j < fine.size(); ++j)
+    {
+      fine[j] = rootOfUnity(j, n, isForward);
+    }
+
+    for (std::size_t j{}; j < coarse.size(); ++j)
+    {
+      coarse[j] = rootOfUnity(j * fineCount, n, isForward);
+    }
+
+    std::vector<Complex> roots(n);
+
+    for (std::size_t j{}; j < n; ++j)
+    {
+      roots[j] = (j % fineCount == 0) ? toComplex(coarse[j / fineCount])
+                                      : toComplex(mul<ScalarOps>(coarse[j / fineCount], fine[j % fineCount]));
+    }
+
+    return roots;
+  }
+
+  /// @brief Planar double-double complex buffer, the four parts are separate arrays, so the butterflies vectorize.
+  struct Planes
+  {
+    double* reHi{}; ///< The leading parts of the real parts.
+    double* reLo{}; ///< The trailing parts of the real parts.
+    double* imHi{}; ///< The leading parts of the imaginary parts.
+    double* imLo{}; ///< The trailing parts of the imaginary parts.
+
+    /**
+     * @brief Make the planes of a contiguous buffer.
+     * @param data The buffer of 4 * length doubles.
+     * @param length The number of complex elements.
+     * @return The planes.
+     */
+    [[nodiscard]] static Planes make(double* data, std::size_t length) noexcept
+    {
+      return {data, data + length, data + 2 * length, data + 3 * length};
+    }
+
+    /// @brief Load the elements starting at the index.
+    template<typename Ops>
+    [[nodiscard]] ComplexV<Ops> load(std::size_t i) const noexcept
+    {
+      return {{Ops::load(reHi + i), Ops::load(reLo + i)}, {Ops::load(imHi + i), Ops::load(imLo + i)}};
+    }
+
+    /// @brief Store the elements starting at the index.
+    template<typename Ops>
+    void store(std::size_t i, const ComplexV<Ops>& value) const noexcept
+    {
+      Ops::store(reHi + i, value.re.hi);
+      Ops::store(reLo + i, value.re.lo);
+      Ops::store(imHi + i, value.im.hi);
+      Ops::store(imLo + i, value.im.lo);
+    }
+
+    /// @brief Get the element at the index.
+    [[nodiscard]] Complex get(std::size_t i) const noexcept
+    {
+      return {{reHi[i], reLo[i]}, {imHi[i], imLo[i]}};
+    }
+
+    /// @brief Set the element at the index.
+    void set(std::size_t i, const Complex& value) const noexcept
+    {
+      reHi[i] = value.re.hi;
+      reLo[i] = value.re.lo;
+      imHi[i] = value.im.hi;
+      imLo[i] = value.im.lo;
+    }
+  };
+
+  /**
+   * @class Schedule
+   * @brief Mixed radix Stockham autosort transform of one length. Each stage reads one buffer and writes the other in
+   *        the natural order, the butterflies of a stage share their twiddle factors along runs of stride elements, so
+   *        the runs are computed by the SIMD operations once the stride reaches the vector width.
+   */
+  class Schedule
+  {
+    public:
+      /// @brief Default constructor, no length.
+      Schedule() = default;
+
+      /**
+       * @brief Constructor, factors the length and makes the roots of unity.
+       * @param length The length, its prime factors must not exceed maxRadix.
+       * @param direction The direction.
+       */
+      Schedule(std::size_t length, Direction direction)
+      : mLength{length},
+        mIsForward{direction == Direction::forward},
+        mRoots{makeRootsOfUnity(length, mIsForward)}
+      {
+        for (; length % 4 == 0; length /= 4)
+        {
+          mRadices.push_back(4);
+        }
+
+        for (std::size_t radix{2}; radix <= maxRadix; ++radix)
+        {
+          for (; length % radix == 0; length /= radix)
+          {
+            mRadices.push_back(radix);
+          }
+        }
+
+        if (length != 1)
+        {
+          throw std::invalid_argument{"double-double schedule length has a prime factor above the largest radix"};
+        }
+      }
+
+      /**
+       * @brief Check if every prime factor of the length is computed by a butterfly.
+       * @param length The length.
+       * @return True if the length is supported, false otherwise.
+       */
+      [[nodiscard]] static bool isSupported(std::size_t length) noexcept
+      {
+        for (std::size_t radix{2}; radix <= maxRadix && length > 1; ++radix)
+        {
+          for (; length % radix == 0; length /= radix) {}
+        }
+
+        return length == 1;
+      }
+
+      /**
+       * @brief Get the length.
+       * @return The length.
+       */
+      [[nodiscard]] std::size_t getLength() const noexcept
+      {
+        return mLength;
+      }
+
+      /**
+       * @brief Transform the buffer, the other buffer is overwritten.
+       * @param x The source, overwritten.
+       * @param y The other buffer.
+       * @param threadLimit The thread limit of the stages, 1 to compute them on the calling thread.
+       * @return The buffer holding the result, x or y.
+       */
+      Planes execute(Planes x, Planes y, std::size_t threadLimit) const
+      {
+        std::size_t n = mLength;
+        std::size_t s = 1;
+
+        for (const auto radix : mRadices)
+        {
+          const std::size_t m          = n / radix;
+          const std::size_t pPerTask   = std::max(elemsPerTask / (radix * s), std::size_t{1});
+          const std::size_t taskCount  = (threadLimit == 1) ? 1 : (m + pPerTask - 1) / pPerTask;
+          const std::size_t pTaskCount = (taskCount == 1) ? m : pPerTask;
+
+          parallelFor(taskCount, threadLimit, [&](std::size_t task)
+          {
+            runStage(x, y, n, s, radix, task * pTaskCount, std::min(m, (task + 1) * pTaskCount));
+          });
+
+          std::swap(x, y);
+          n  = m;
+          s *= radix;
+        }
+
+        return x;
+      }
+    private:
+      /// @brief Number of elements computed by one task of a parallel stage.
+      static constexpr std::size_t elemsPerTask{4096};
+
+      /**
+       * @brief Compute the butterflies of the stage for the given range of p.
+       * @param x The source.
+       * @param y The destination.
+       * @param n The current length.
+       * @param s The current stride.
+       * @param radix The radix of the stage.
+       * @param pBegin The first butterfly group.
+       * @param pEnd The end of the butterfly groups.
+       */
+      void runStage(const Planes& x,
+                    const Planes& y,
+                    std::size_t   n,
+                    std::size_t   s,
+                    std::size_t   radix,
+                    std::size_t   pBegin,
+                    std::size_t   pEnd) const
+      {
+        const std::size_t m = n / radix;
+
+        std::array<Complex, maxRadix> omegas{};
+        std::array<Complex, maxRadix> twiddles{};
+
+        for (std::size_t j{}; j < radix; ++j)
+        {
+          omegas[j] = mRoots[j * (mLength / radix)];
+        }
+
+        for (std::size_t p = pBegin; p < pEnd; ++p)
+        {
+          // w_n^{p k} = w_N^{p k s}, the index is below N
+          for (std::size_t k{}; k < radix; ++k)
+          {
+            twiddles[k] = mRoots[p * k * s];
+          }
+
+          std::size_t q{};
+
+          if constexpr (SimdOps::width > 1)
+          {
+            for (; q + SimdOps::width <= s; q += SimdOps::width)
+            {
+              butterfly<SimdOps>(x, y, q, s, p, m, radix, twiddles.data(), omegas.data());
+            }
+          }
+
+          for (; q < s; ++q)
+          {
+            butterfly<ScalarOps>(x, y, q, s, p, m, radix, twiddles.data(), omegas.data());
+          }
+        }
+      }
+
+      /**
+       * @brief Compute one butterfly of the radix for width consecutive q.
+       * @tparam Ops The vector operations.
+       */
+      template<typename Ops>
+      void butterfly(const Planes&  x,
+                     const Planes&  y,
+                     std::size_t    q,
+                     std::size_t    s,
+                     std::size_t    p,
+                     std::size_t    m,
+                     std::size_t    radix,
+                     const Complex* twiddles,
+                     const Complex* omegas) const noexcept
+      {
+        switch (radix)
+        {
+        case 2:
+        {
+          const auto a0 = x.template load<Ops>(q + s * p);
+          const auto a1 = x.template load<Ops>(q + s * (p + m));
+
+          y.template store<Ops>(q + s * (2 * p), add<Ops>(a0, a1));
+          y.template store<Ops>(q + s * (2 * p + 1), mul<Ops>(sub<Ops>(a0, a1), broadcast<Ops>(twiddles[1])));
+          break;
+        }
+        case 4:
+        {
+          const auto a0 = x.template load<Ops>(q + s * p);
+          const auto a1 = x.template load<Ops>(q + s * (p + m));
+          const auto a2 = x.template load<Ops>(q + s * (p + 2 * m));
+          const auto a3 = x.template load<Ops>(q + s * (p + 3 * m));
+
+          const auto t0 = add<Ops>(a0, a2);
+          const auto t1 = sub<Ops>(a0, a2);
+          const auto t2 = add<Ops>(a1, a3);
+          const auto t3 = mulByUnit<Ops>(sub<Ops>(a1, a3), mIsForward);
+
+          y.template store<Ops>(q + s * (4 * p), add<Ops>(t0, t2));
+          y.template store<Ops>(q + s * (4 * p + 1), mul<Ops>(add<Ops>(t1, t3), broadcast<Ops>(twiddles[1])));
+          y.template store<Ops>(q + s * (4 * p + 2), mul<Ops>(sub<Ops>(t0, t2), broadcast<Ops>(twiddles[2])));
+          y.template store<Ops>(q + s * (4 * p + 3), mul<Ops>(sub<Ops>(t1, t3), broadcast<Ops>(twiddles[3])));
+          break;
+        }
+        default:
+        {
+          std::array<ComplexV<Ops>, maxRadix> a{};
+
+          for (std::size_t t{}; t < radix; ++t)
+          {
+            a[t] = x.template load<Ops>(q + s * (p + t * m));
+          }
+
+          for (std::size_t k{}; k < radix; ++k)
+          {
+            auto acc = a[0];
+
+            for (std::size_t t{1}; t < radix; ++t)
+            {
+              acc = add<Ops>(acc, mul<Ops>(a[t], broadcast<Ops>(omegas[(t * k) % radix])));
+            }
+
+            y.template store<Ops>(q + s * (radix * p + k), (k == 0) ? acc : mul<Ops>(acc, broadcast<Ops>(twiddles[k])));
+          }
+          break;
+        }
+        }
+      }
+
+      std::size_t              mLength{};    ///< The length.
+      bool                     mIsForward{}; ///< Is the transform forward?
+      std::vector<Complex>     mRoots{};     ///< The roots of unity e^{-+2pi i j / N}.
+      std::vector<std::size_t> mRadices{};   ///< The radix of each stage.
+  };
+} // namespace afft::detail::codelet::dd
+
+#endif /* AFFT_DETAIL_CODELET_DOUBLE_DOUBLE_HPP */
@@ -0,0 +1,422 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_CODELET_KERNEL_HPP
+#define AFFT_DETAIL_CODELET_KERNEL_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../../common.hpp"
+
+namespace afft::detail::codelet
+{
+  /// @brief Largest length computed by the codelets.
+  inline constexpr std::size_t maxLength{64};
+
+  /// @brief Number of transforms computed at once by the lane codelets, one per SIMD lane.
+  inline constexpr std::size_t laneCount{8};
+
+  /**
+   * @brief Kernel computing one transform of a compile time length, reads the strided source and writes
+   *        the contiguous destination. The destination must not alias the source.
+   * @tparam T Real type.
+   */
+  template<typename T>
+  using Kernel = void(*)(const std::complex<T>* src, std::size_t srcStride, std::complex<T>* dst);
+
+  /**
+   * @brief Kernel computing laneCount transforms of a compile time length at once. The planar source holds element n
+   *        of lane l at index n * srcStride * laneCount + l, the contiguous destination at n * laneCount + l. The
+   *        destination must not alias the source.
+   * @tparam T Real type.
+   */
+  template<typename T>
+  using LaneKernel = void(*)(const T* srcRe, const T* srcIm, std::size_t srcStride, T* dstRe, T* dstIm);
+
+  /**
+   * @brief Get the smallest prime factor of the value.
+   * @param value Value greater than 1.
+   * @return Smallest prime factor.
+   */
+  [[nodiscard]] constexpr std::size_t getSmallestPrimeFactor(std::size_t value) noexcept
+  {
+    for (std::size_t factor{2}; factor * factor <= value; ++factor)
+    {
+      if (value % factor == 0)
+      {
+        return factor;
+      }
+    }
+
+    return value;
+  }
+
+  /**
+   * @brief Compute the twiddle factors e^{-+2pi i j / N} at compile time. The angle is reduced exactly to the first
+   *        quadrant using the integer j / N, where the Taylor series of sin and cos converge in long double.
+   * @tparam T Real type.
+   * @tparam N Length.
+   * @tparam isForward Is the transform forward?
+   * @return Twiddle factors for j < N.
+   */
+  template<typename T, std::size_t N, bool isForward>
+  [[nodiscard]] constexpr std::array<std::complex<T>, N> makeTwiddles() noexcept
+  {
+    constexpr long double halfPi = 1.570796326794896619231321691639751442L;
+
+    std::array<std::complex<T>, N> twiddles{};
+
+    for (std::size_t j{}; j < N; ++j)
+    {
+      // 4j / N = quadrant + remainder / N
+      const std::size_t quadrant  = (4 * j) / N;
+      const std::size_t remainder = (4 * j) % N;
+      const long double angle     = halfPi * static_cast<long double>(remainder) / static_cast<long double>(N);
+
+      long double sinValue{};
+      long double cosValue{};
+      long double term{1};
+
+      for (std::size_t n{}; n < 30; ++n)
+      {
+        if (n % 2 == 0)
+        {
+          cosValue += ((n / 2) % 2 == 0) ? term : -term;
+        }
+        else
+        {
+          sinValue += ((n / 2) % 2 == 0) ? term : -term;
+        }
+
+        term *= angle / static_cast<long double>(n + 1);
+      }
+
+      // e^{i (quadrant pi / 2 + angle)}
+      long double re{};
+      long double im{};
+
+      switch (quadrant)
+      {
+      case 0:  re =  cosValue; im =  sinValue; break;
+      case 1:  re = -sinValue; im =  cosValue; break;
+      case 2:  re = -cosValue; im = -sinValue; break;
+      default: re =  sinValue; im = -cosValue; break;
+      }
+
+      twiddles[j] = std::complex<T>{static_cast<T>(re), static_cast<T>(isForward ? -im : im)};
+    }
+
+    return twiddles;
+  }
+
+  /**
+   * @brief Twiddle factors of the length, evaluated at compile time.
+   * @tparam T Real type.
+   * @tparam N Length.
+   * @tparam isForward Is the transform forward?
+   */
+  template<typename T, std::size_t N, bool isForward>
+  inline constexpr std::array<std::complex<T>, N> twiddles = makeTwiddles<T, N, isForward>();
+
+  /**
+   * @struct Codelet
+   * @brief Transform of a compile time length by the mixed radix decimation in time. The length is split by its
+   *        smallest prime factor R into R transforms of N / R recursively, primes are computed directly. All loop
+   *        bounds and twiddle factors are constant, so the compiler unrolls and vectorizes the small lengths.
+   * @tparam T Real type.
+   * @tparam N Length.
+   * @tparam isForward Is the transform forward?
+   */
+  template<typename T, std::size_t N, bool isForward>
+  struct Codelet
+  {
+    /**
+     * @brief Compute the transform.
+     * @param src Source, strided.
+     * @param srcStride Stride of the source elements.
+     * @param dst Contiguous destination, must not alias the source.
+     */
+    static void apply(const std::complex<T>* src, std::size_t srcStride, std::complex<T>* dst) noexcept
+    {
+      constexpr auto& w = twiddles<T, N, isForward>;
+      constexpr std::size_t R = getSmallestPrimeFactor(N);
+      constexpr std::size_t M = N / R;
+
+      if constexpr (M == 1)
+      {
+        for (std::size_t k{}; k < N; ++k)
+        {
+          std::complex<T> acc{};
+
+          for (std::size_t n{}; n < N; ++n)
+          {
+            acc += src[n * srcStride] * w[(n * k) % N];
+          }
+
+          dst[k] = acc;
+        }
+      }
+      else
+      {
+        for (std::size_t r{}; r < R; ++r)
+        {
+          Codelet<T, M, isForward>::apply(src + r * srcStride, srcStride * R, dst + r * M);
+        }
+
+        for (std::size_t k{}; k < M; ++k)
+        {
+          std::array<std::complex<T>, R> y{};
+
+          y[0] = dst[k];
+
+          for (std::size_t r{1}; r < R; ++r)
+          {
+            y[r] = dst[k + r * M] * w[r * k];
+          }
+
+          if constexpr (R == 2)
+          {
+            dst[k]     = y[0] + y[1];
+            dst[k + M] = y[0] - y[1];
+          }
+          else
+          {
+            for (std::size_t q{}; q < R; ++q)
+            {
+              std::complex<T> acc{y[0]};
+
+              for (std::size_t r{1}; r < R; ++r)
+              {
+                acc += y[r] * w[(r * q * M) % N];
+              }
+
+              dst[k + q * M] = acc;
+            }
+          }
+        }
+      }
+    }
+  };
+
+  /// @brief Transform of length 1 copies the element.
+  template<typename T, bool isForward>
+  struct Codelet<T, 1, isForward>
+  {
+    static void apply(const std::complex<T>* src, std::size_t, std::complex<T>* dst) noexcept
+    {
+      dst[0] = src[0];
+    }
+  };
+
+  /**
+   * @struct LaneCodelet
+   * @brief Codelet computing laneCount transforms at once, the decomposition of Codelet is applied to rows of lanes.
+   *        The innermost loops run over the lanes with constant bounds, so the compiler maps them to SIMD lanes.
+   * @tparam T Real type.
+   * @tparam N Length.
+   * @tparam isForward Is the transform forward?
+   */
+  template<typename T, std::size_t N, bool isForward>
+  struct LaneCodelet
+  {
+    /**
+     * @brief Compute the transforms.
+     * @param srcRe Real parts of the source, planar rows of lanes.
+     * @param srcIm Imaginary parts of the source, planar rows of lanes.
+     * @param srcStride Stride of the source rows.
+     * @param dstRe Real parts of the contiguous destination, must not alias the source.
+     * @param dstIm Imaginary parts of the contiguous destination, must not alias the source.
+     */
+    static void apply(const T* srcRe, const T* srcIm, std::size_t srcStride, T* dstRe, T* dstIm) noexcept
+    {
+      constexpr auto& w = twiddles<T, N, isForward>;
+      constexpr std::size_t R = getSmallestPrimeFactor(N);
+      constexpr std::size_t M = N / R;
+      constexpr std::size_t L = laneCount;
+
+      if constexpr (M == 1)
+      {
+        for (std::size_t k{}; k < N; ++k)
+        {
+          std::array<T, L> accRe{};
+          std::array<T, L> accIm{};
+
+          for (std::size_t n{}; n < N; ++n)
+          {
+            const T  wRe = w[(n * k) % N].real();
+            const T  wIm = w[(n * k) % N].imag();
+            const T* xRe = srcRe + n * srcStride * L;
+            const T* xIm = srcIm + n * srcStride * L;
+
+            for (std::size_t l{}; l < L; ++l)
+            {
+              accRe[l] += xRe[l] * wRe - xIm[l] * wIm;
+              accIm[l] += xRe[l] * wIm + xIm[l] * wRe;
+            }
+          }
+
+          std::copy(accRe.begin(), accRe.end(), dstRe + k * L);
+          std::copy(accIm.begin(), accIm.end(), dstIm + k * L);
+        }
+      }
+      else
+      {
+        for (std::size_t r{}; r < R; ++r)
+        {
+          LaneCodelet<T, M, isForward>::apply(srcRe + r * srcStride * L,
+                                              srcIm + r * srcStride * L,
+                                              srcStride * R,
+                                              dstRe + r * M * L,
+                                              dstIm + r * M * L);
+        }
+
+        for (std::size_t k{}; k < M; ++k)
+        {
+          std::array<T, R * L> yRe{};
+          std::array<T, R * L> yIm{};
+
+          for (std::size_t r{}; r < R; ++r)
+          {
+            const T  wRe = w[r * k].real();
+            const T  wIm = w[r * k].imag();
+            const T* xRe = dstRe + (k + r * M) * L;
+            const T* xIm = dstIm + (k + r * M) * L;
+
+            for (std::size_t l{}; l < L; ++l)
+            {
+              yRe[r * L + l] = xRe[l] * wRe - xIm[l] * wIm;
+              yIm[r * L + l] = xRe[l] * wIm + xIm[l] * wRe;
+            }
+          }
+
+          for (std::size_t q{}; q < R; ++q)
+          {
+            T* outRe = dstRe + (k + q * M) * L;
+            T* outIm = dstIm + (k + q * M) * L;
+
+            for (std::size_t l{}; l < L; ++l)
+            {
+              outRe[l] = yRe[l];
+              outIm[l] = yIm[l];
+            }
+
+            for (std::size_t r{1}; r < R; ++r)
+            {
+              const T wRe = w[(r * q * M) % N].real();
+              const T wIm = w[(r * q * M) % N].imag();
+
+              for (std::size_t l{}; l < L; ++l)
+              {
+                outRe[l] += yRe[r * L + l] * wRe - yIm[r * L + l] * wIm;
+                outIm[l] += yRe[r * L + l] * wIm + yIm[r * L + l] * wRe;
+              }
+            }
+          }
+        }
+      }
+    }
+  };
+
+  /// @brief Transforms of length 1 copy the lanes.
+  template<typename T, bool isForward>
+  struct LaneCodelet<T, 1, isForward>
+  {
+    static void apply(const T* srcRe, const T* srcIm, std::size_t, T* dstRe, T* dstIm) noexcept
+    {
+      std::copy(srcRe, srcRe + laneCount, dstRe);
+      std::copy(srcIm, srcIm + laneCount, dstIm);
+    }
+  };
+
+  /**
+   * @brief Make the table of the kernels of lengths 1 to maxLength.
+   * @tparam T Real type.
+   * @tparam isForward Is the transform forward?
+   * @return Kernel table indexed by the length - 1.
+   */
+  template<typename T, bool isForward, std::size_t... lengths>
+  [[nodiscard]] constexpr std::array<Kernel<T>, sizeof...(lengths)> makeKernelTable(std::index_sequence<lengths...>) noexcept
+  {
+    return {&Codelet<T, lengths + 1, isForward>::apply...};
+  }
+
+  /**
+   * @brief Get the kernel of the length, selected once when the plan is created.
+   * @tparam T Real type.
+   * @param length Length, 1 to maxLength.
+   * @param direction Direction of the transform.
+   * @return Kernel.
+   */
+  template<typename T>
+  [[nodiscard]] inline Kernel<T> getKernel(std::size_t length, Direction direction)
+  {
+    static constexpr auto forwardKernels  = makeKernelTable<T, true>(std::make_index_sequence<maxLength>{});
+    static constexpr auto backwardKernels = makeKernelTable<T, false>(std::make_index_sequence<maxLength>{});
+
+    if (length == 0 || length > maxLength)
+    {
+      throw std::invalid_argument{"Codelet length is out of range"};
+    }
+
+    return (direction == Direction::forward) ? forwardKernels[length - 1] : backwardKernels[length - 1];
+  }
+
+  /**
+   * @brief Make the table of the lane kernels of lengths 1 to maxLength.
+   * @tparam T Real type.
+   * @tparam isForward Is the transform forward?
+   * @return Lane kernel table indexed by the length - 1.
+   */
+  template<typename T, bool isForward, std::size_t... lengths>
+  [[nodiscard]] constexpr std::array<LaneKernel<T>, sizeof...(lengths)>
+  makeLaneKernelTable(std::index_sequence<lengths...>) noexcept
+  {
+    return {&LaneCodelet<T, lengths + 1, isForward>::apply...};
+  }
+
+  /**
+   * @brief Get the lane kernel of the length, selected once when the plan is created.
+   * @tparam T Real type.
+   * @param length Length, 1 to maxLength.
+   * @param direction Direction of the transform.
+   * @return Lane kernel.
+   */
+  template<typename T>
+  [[nodiscard]] inline LaneKernel<T> getLaneKernel(std::size_t length, Direction direction)
+  {
+    static constexpr auto forwardKernels  = makeLaneKernelTable<T, true>(std::make_index_sequence<maxLength>{});
+    static constexpr auto backwardKernels = makeLaneKernelTable<T, false>(std::make_index_sequence<maxLength>{});
+
+    if (length == 0 || length > maxLength)
+    {
+      throw std::invalid_argument{"Codelet length is out of range"};
+    }
+
+    return (direction == Direction::forward) ? forwardKernels[length - 1] : backwardKernels[length - 1];
+  }
+} // namespace afft::detail::codelet
+
+#endif /* AFFT_DETAIL_CODELET_KERNEL_HPP */
@@ -0,0 +1,144 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_CODELET_MAKE_PLAN_HPP
+#define AFFT_DETAIL_CODELET_MAKE_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../../Plan.hpp"
+#include "kernel.hpp"
+#include "spst.hpp"
+
+namespace afft::detail::codelet
+{
+  /**
+   * @brief Check if the plan may be supported by the codelet backend, without any side effects.
+   * @param desc Plan description.
+   * @return Backend support, the reason of the rejection if the plan is not supported.
+   */
+  [[nodiscard]] inline BackendSupport supports(const Desc& desc)
+  {
+    if (desc.getComplexFormat() != ComplexFormat::interleaved)
+    {
+      return BackendSupport{"only interleaved complex format is supported"};
+    }
+
+    if (desc.getTarget() != Target::cpu)
+    {
+      return BackendSupport{"only cpu target is supported"};
+    }
+
+    if (desc.getDistribution() != Distribution::spst)
+    {
+      return BackendSupport{"only spst distribution is supported"};
+    }
+
+    if (desc.getTransform() != Transform::dft ||
+        desc.getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex)
+    {
+      return BackendSupport{"only complex-to-complex dft is supported"};
+    }
+
+    if (!desc.hasUniformPrecision())
+    {
+      return BackendSupport{"only same precision for execution, source and destination is supported"};
+    }
+
+    const auto prec = desc.getPrecision().execution;
+
+    if (prec != Precision::_float && prec != Precision::_double && prec != Precision::f64f64)
+    {
+      return BackendSupport{"unsupported precision"};
+    }
+
+    if (desc.getPlacement() == Placement::inPlace)
+    {
+      Desc layoutDesc{desc};
+      layoutDesc.fillDefaultMemoryLayoutStrides();
+
+      const auto& memLayout  = layoutDesc.getMemoryLayout<Distribution::spst>();
+      const auto  srcStrides = memLayout.getSrcStrides();
+      const auto  dstStrides = memLayout.getDstStrides();
+
+      if (!std::equal(srcStrides.begin(), srcStrides.end(), dstStrides.begin()))
+      {
+        return BackendSupport{"in-place transform requires equal strides"};
+      }
+    }
+
+    // double-double transforms are computed by their own engine of any length
+    if (prec != Precision::f64f64)
+    {
+      const auto shape = desc.getShape();
+
+      for (const auto axis : desc.getTransformAxes())
+      {
+        if (shape[axis] > maxLength)
+        {
+          return BackendSupport{"only transform lengths up to 64 are supported"};
+        }
+      }
+    }
+
+    return BackendSupport{};
+  }
+
+  /**
+   * @brief Create a plan implementation.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Plan description.
+   * @param backendParams Backend parameters.
+   * @return Plan implementation.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] std::unique_ptr<afft::Plan>
+  makePlan(const Desc& desc, const BackendParamsT&)
+  {
+    if (const auto support = supports(desc); !support)
+    {
+      throw BackendError{Backend::codelet, support.reason};
+    }
+
+    if constexpr (BackendParamsT::target == Target::cpu)
+    {
+      if constexpr (BackendParamsT::distribution == Distribution::spst)
+      {
+        return spst::cpu::makePlan(desc);
+      }
+      else
+      {
+        throw BackendError{Backend::codelet, "only spst distribution is supported"};
+      }
+    }
+    else
+    {
+      throw BackendError{Backend::codelet, "only cpu target is supported"};
+    }
+  }
+} // namespace afft::detail::codelet
+
+#endif /* AFFT_DETAIL_CODELET_MAKE_PLAN_HPP */
@@ -0,0 +1,952 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_CODELET_SPST_HPP
+#define AFFT_DETAIL_CODELET_SPST_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../../Plan.hpp"
+
+namespace afft::detail::codelet::spst::cpu
+{
+  /**
+   * @brief Create a codelet spst cpu plan implementation.
+   * @param desc Plan description.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] std::unique_ptr<afft::Plan> makePlan(const Desc& desc);
+} // namespace afft::detail::codelet::spst::cpu
+
+#ifdef AFFT_HEADER_ONLY
+
+#include "doubleDouble.hpp"
+#include "kernel.hpp"
+#include "../chirpZ.hpp"
+#include "../ThreadPool.hpp"
+
+namespace afft::detail::codelet::spst::cpu
+{
+  /**
+   * @class WorkClaim
+   * @brief Claim of the work buffer owned by a realtime plan, held for the object lifetime. Concurrent executions of
+   *        the plan, e.g. by executeAsync(), must not share the buffer, only the execution claiming it uses it and the
+   *        others allocate their own.
+   */
+  class WorkClaim
+  {
+    public:
+      /**
+       * @brief Constructor, claims the buffer if it is not claimed by another execution.
+       * @param inUse The flag of the buffer being used.
+       * @param hasWork Does the plan own the work buffer?
+       */
+      WorkClaim(std::atomic<bool>& inUse, bool hasWork) noexcept
+      : mInUse{inUse},
+        mIsClaimed{hasWork && !inUse.exchange(true, std::memory_order_acquire)}
+      {}
+
+      /// @brief Copy constructor is deleted.
+      WorkClaim(const WorkClaim&) = delete;
+
+      /// @brief Destructor, releases the claimed buffer.
+      ~WorkClaim()
+      {
+        if (mIsClaimed)
+        {
+          mInUse.store(false, std::memory_order_release);
+        }
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      WorkClaim& operator=(const WorkClaim&) = delete;
+
+      /**
+       * @brief Is the buffer claimed by this execution?
+       * @return True if the execution may use the buffer, otherwise false.
+       */
+      [[nodiscard]] bool isClaimed() const noexcept
+      {
+        return mIsClaimed;
+      }
+    private:
+      std::atomic<bool>& mInUse;     ///< The flag of the buffer being used.
+      bool               mIsClaimed; ///< Is the buffer claimed by this execution?
+  };
+
+  /**
+   * @class Plan
+   * @tparam T The real type.
+   * @brief Implementation of the plan for the spst cpu architecture using the codelets. The kernel of each transformed
+   *        axis is selected when the plan is created, the axes are transformed one after another, the first one from
+   *        the source to the destination and the others in-place in the destination. Every line is computed from a
+   *        copy on the stack, so any strides are supported. When another axis has a unit stride, as the batch axis of
+   *        structure of arrays layouts, the lines along it are gathered into lanes and computed by the lane kernels.
+   */
+  template<typename T>
+  class Plan final : public afft::Plan
+  {
+    private:
+      /// @brief Alias for the parent class
+      using Parent = afft::Plan;
+
+      /// @brief Alias for the interleaved complex type
+      using C = std::complex<T>;
+
+      /// @brief Number of lines transformed by one task of the thread pool
+      static constexpr std::size_t linesPerTask{256};
+
+      /// @brief Largest number of transformed elements of one pencil, laneCount pencils are kept in the L2 cache
+      static constexpr std::size_t maxPencilVolume{4096};
+
+    public:
+      /**
+       * @brief Constructor
+       * @param desc The plan description
+       */
+      Plan(const Desc& desc)
+      : Parent{desc},
+        mShapeRank{desc.getShapeRank()}
+      {
+        mDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto  shape     = mDesc.getShape();
+        const auto  axes      = mDesc.getTransformAxes();
+        const auto& memLayout = mDesc.template getMemoryLayout<Distribution::spst>();
+        const auto  srcStrides = memLayout.getSrcStrides();
+        const auto  dstStrides = memLayout.getDstStrides();
+
+        std::copy(shape.begin(), shape.end(), mShape.begin());
+        std::copy(srcStrides.begin(), srcStrides.end(), mSrcStrides.begin());
+        std::copy(dstStrides.begin(), dstStrides.end(), mDstStrides.begin());
+
+        mAxisCount = axes.size();
+
+        for (std::size_t i{}; i < mAxisCount; ++i)
+        {
+          mAxes[i]     = axes[i];
+          mKernels[i]  = getKernel<T>(shape[axes[i]], mDesc.getDirection());
+          mLaneAxes[i] = findLaneAxis(axes[i], (i == 0) ? srcStrides : dstStrides);
+
+          if (mLaneAxes[i] < mShapeRank)
+          {
+            mLaneKernels[i] = getLaneKernel<T>(shape[axes[i]], mDesc.getDirection());
+          }
+        }
+
+        mScale = mDesc.template getNormalizationFactor<T>();
+
+        initPencils(srcStrides, dstStrides);
+      }
+
+      /// @brief Default destructor
+      ~Plan() override = default;
+
+      /**
+       * @brief Get the backend.
+       * @return The backend.
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return Backend::codelet;
+      }
+
+      /**
+       * @brief Execute the plan
+       * @param src The source buffer
+       * @param dst The destination buffer
+       */
+      void executeBackendImpl(View<void*> src, View<void*> dst, const afft::spst::cpu::ExecutionParameters&) override
+      {
+        const auto threadLimit = mDesc.template getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        if (mPencilAxis < mShapeRank)
+        {
+          transformPencils(static_cast<const C*>(src.front()), static_cast<C*>(dst.front()), threadLimit);
+          return;
+        }
+
+        for (std::size_t i{}; i < mAxisCount; ++i)
+        {
+          const bool isFirst = (i == 0);
+          const bool isLast  = (i + 1 == mAxisCount);
+
+          const C*           axisSrc     = static_cast<const C*>(isFirst ? src.front() : dst.front());
+          const std::size_t* axisStrides = isFirst ? mSrcStrides.data() : mDstStrides.data();
+          C*                 axisDst     = static_cast<C*>(dst.front());
+          const T            axisScale   = isLast ? mScale : T{1};
+
+          if (mLaneAxes[i] < mShapeRank)
+          {
+            transformAxisLanes(mAxes[i],
+                               mLaneAxes[i],
+                               mLaneKernels[i],
+                               axisSrc,
+                               axisStrides,
+                               axisDst,
+                               axisScale,
+                               threadLimit);
+          }
+          else
+          {
+            transformAxis(mAxes[i], mKernels[i], axisSrc, axisStrides, axisDst, axisScale, threadLimit);
+          }
+        }
+      }
+
+    private:
+      /**
+       * @brief Check if the axis is transformed.
+       * @param axis The axis.
+       * @return True if the axis is transformed, false otherwise.
+       */
+      [[nodiscard]] bool isTransformedAxis(std::size_t axis) const
+      {
+        return std::find(mAxes.begin(), mAxes.begin() + mAxisCount, axis) != mAxes.begin() + mAxisCount;
+      }
+
+      /**
+       * @brief Select the pencil mode if a batch axis has a unit source stride and the transformed volume is small. The
+       *        pencil of one batch element holds all of its transformed elements, laneCount neighbouring pencils along
+       *        the batch axis are transformed along all axes at once.
+       * @param srcStrides The source strides.
+       * @param dstStrides The destination strides.
+       */
+      void initPencils(View<std::size_t> srcStrides, View<std::size_t> dstStrides)
+      {
+        mPencilAxis = mShapeRank;
+
+        std::size_t volume{1};
+
+        for (std::size_t i{}; i < mAxisCount; ++i)
+        {
+          volume *= mShape[mAxes[i]];
+        }
+
+        if (volume > maxPencilVolume)
+        {
+          return;
+        }
+
+        for (std::size_t i{}; i < mShapeRank; ++i)
+        {
+          if (!isTransformedAxis(i) && srcStrides[i] == 1 && mShape[i] >= laneCount)
+          {
+            mPencilAxis = i;
+            break;
+          }
+        }
+
+        if (mPencilAxis == mShapeRank)
+        {
+          return;
+        }
+
+        // the pencil is row-major over the transformed axes, the last one varies fastest
+        for (std::size_t i = mAxisCount; i > 0; --i)
+        {
+          mPencilStrides[i - 1] = (i == mAxisCount) ? 1 : mPencilStrides[i] * mShape[mAxes[i]];
+          mLaneKernels[i - 1]   = getLaneKernel<T>(mShape[mAxes[i - 1]], mDesc.getDirection());
+        }
+
+        mPencilSrcOffsets.resize(volume);
+        mPencilDstOffsets.resize(volume);
+
+        for (std::size_t e{}; e < volume; ++e)
+        {
+          std::size_t index = e;
+
+          for (std::size_t i = mAxisCount; i > 0; --i)
+          {
+            mPencilSrcOffsets[e] += (index % mShape[mAxes[i - 1]]) * srcStrides[mAxes[i - 1]];
+            mPencilDstOffsets[e] += (index % mShape[mAxes[i - 1]]) * dstStrides[mAxes[i - 1]];
+            index                /= mShape[mAxes[i - 1]];
+          }
+        }
+
+        // realtime plans run the tasks one by one on the calling thread, they share a work buffer made here
+        if (mDesc.isRealtime())
+        {
+          mPencilWork.resize(2 * volume * laneCount);
+        }
+      }
+
+      /**
+       * @brief Transform all pencils, laneCount neighbouring pencils along the pencil axis at once. The pencils are
+       *        gathered into planar rows of lanes, transformed along every axis while they stay in the cache and
+       *        scattered to the destination. The missing lanes of the last block are not stored.
+       * @param src The source buffer.
+       * @param dst The destination buffer, may alias the source.
+       * @param threadLimit The maximum number of threads.
+       */
+      void transformPencils(const C* src, C* dst, std::size_t threadLimit) const
+      {
+        const std::size_t volume       = mPencilSrcOffsets.size();
+        const std::size_t laneExtent   = mShape[mPencilAxis];
+        const std::size_t blockCount   = (laneExtent + laneCount - 1) / laneCount;
+        const std::size_t outerCount   = std::accumulate(mShape.data(),
+                                                         mShape.data() + mShapeRank,
+                                                         std::size_t{1},
+                                                         std::multiplies<>{}) / (volume * laneExtent);
+        const std::size_t itemCount    = outerCount * blockCount;
+        const std::size_t itemsPerTask = std::max(maxPencilVolume / volume, std::size_t{1});
+        const std::size_t taskCount    = (itemCount + itemsPerTask - 1) / itemsPerTask;
+
+        const WorkClaim workClaim{mPencilWorkInUse, !mPencilWork.empty()};
+        const bool      useSharedWork = workClaim.isClaimed();
+
+        parallelFor(taskCount, threadLimit, [&](std::size_t task)
+        {
+          std::vector<T> taskWork((useSharedWork) ? std::size_t{} : 2 * volume * laneCount);
+
+          alignas(64) std::array<T, maxLength * laneCount> lineRe{};
+          alignas(64) std::array<T, maxLength * laneCount> lineIm{};
+
+          T* re = (useSharedWork) ? mPencilWork.data() : taskWork.data();
+          T* im = re + volume * laneCount;
+
+          const std::size_t end = std::min(itemCount, (task + 1) * itemsPerTask);
+
+          for (std::size_t item = task * itemsPerTask; item < end; ++item)
+          {
+            std::size_t index     = item / blockCount;
+            std::size_t srcOffset = 0;
+            std::size_t dstOffset = 0;
+
+            // blocks enumerate the indices of the other axes, the last axis varies fastest
+            for (std::size_t i = mShapeRank; i > 0; --i)
+            {
+              if (i - 1 == mPencilAxis || isTransformedAxis(i - 1))
+              {
+                continue;
+              }
+
+              srcOffset += (index % mShape[i - 1]) * mSrcStrides[i - 1];
+              dstOffset += (index % mShape[i - 1]) * mDstStrides[i - 1];
+              index     /= mShape[i - 1];
+            }
+
+            const std::size_t firstLane = (item % blockCount) * laneCount;
+            const std::size_t lanes     = std::min(laneCount, laneExtent - firstLane);
+
+            srcOffset += firstLane * mSrcStrides[mPencilAxis];
+            dstOffset += firstLane * mDstStrides[mPencilAxis];
+
+            for (std::size_t e{}; e < volume; ++e)
+            {
+              const C* srcRow = src + srcOffset + mPencilSrcOffsets[e];
+
+              for (std::size_t l{}; l < lanes; ++l)
+              {
+                re[e * laneCount + l] = srcRow[l * mSrcStrides[mPencilAxis]].real();
+                im[e * laneCount + l] = srcRow[l * mSrcStrides[mPencilAxis]].imag();
+              }
+            }
+
+            for (std::size_t i{}; i < mAxisCount; ++i)
+            {
+              const std::size_t length = mShape[mAxes[i]];
+              const std::size_t stride = mPencilStrides[i];
+
+              for (std::size_t line{}; line < volume / length; ++line)
+              {
+                const std::size_t base = (line / stride) * stride * length + line % stride;
+
+                mLaneKernels[i](re + base * laneCount, im + base * laneCount, stride, lineRe.data(), lineIm.data());
+
+                for (std::size_t k{}; k < length; ++k)
+                {
+                  std::copy_n(lineRe.data() + k * laneCount, laneCount, re + (base + k * stride) * laneCount);
+                  std::copy_n(lineIm.data() + k * laneCount, laneCount, im + (base + k * stride) * laneCount);
+                }
+              }
+            }
+
+            for (std::size_t e{}; e < volume; ++e)
+            {
+              C* dstRow = dst + dstOffset + mPencilDstOffsets[e];
+
+              for (std::size_t l{}; l < lanes; ++l)
+              {
+                dstRow[l * mDstStrides[mPencilAxis]] = C{re[e * laneCount + l] * mScale, im[e * laneCount + l] * mScale};
+              }
+            }
+          }
+        });
+      }
+
+      /**
+       * @brief Find the axis whose lines are computed together by the lane kernels.
+       * @param axis The transformed axis.
+       * @param srcStrides The source strides of the axis pass.
+       * @return The axis of unit source stride and at least laneCount elements, mShapeRank if there is none.
+       */
+      [[nodiscard]] std::size_t findLaneAxis(std::size_t axis, View<std::size_t> srcStrides) const
+      {
+        for (std::size_t i{}; i < mShapeRank; ++i)
+        {
+          if (i != axis && srcStrides[i] == 1 && mShape[i] >= laneCount)
+          {
+            return i;
+          }
+        }
+
+        return mShapeRank;
+      }
+
+      /**
+       * @brief Transform all lines along the axis.
+       * @param axis The transformed axis.
+       * @param kernel The kernel of the axis length.
+       * @param src The source buffer.
+       * @param srcStrides The source strides.
+       * @param dst The destination buffer, may alias the source.
+       * @param scale The scale applied to the outputs.
+       * @param threadLimit The maximum number of threads.
+       */
+      void transformAxis(std::size_t        axis,
+                         Kernel<T>          kernel,
+                         const C*           src,
+                         const std::size_t* srcStrides,
+                         C*                 dst,
+                         T                  scale,
+                         std::size_t        threadLimit) const
+      {
+        const std::size_t length    = mShape[axis];
+        const std::size_t lineCount = std::accumulate(mShape.data(),
+                                                      mShape.data() + mShapeRank,
+                                                      std::size_t{1},
+                                                      std::multiplies<>{}) / length;
+        const std::size_t taskCount = (lineCount + linesPerTask - 1) / linesPerTask;
+
+        parallelFor(taskCount, threadLimit, [&](std::size_t task)
+        {
+          std::array<C, maxLength> line{};
+
+          const std::size_t end = std::min(lineCount, (task + 1) * linesPerTask);
+
+          for (std::size_t l = task * linesPerTask; l < end; ++l)
+          {
+            std::size_t index     = l;
+            std::size_t srcOffset = 0;
+            std::size_t dstOffset = 0;
+
+            // lines enumerate the indices of the other axes, the last axis varies fastest
+            for (std::size_t i = mShapeRank; i > 0; --i)
+            {
+              if (i - 1 == axis)
+              {
+                continue;
+              }
+
+              srcOffset += (index % mShape[i - 1]) * srcStrides[i - 1];
+              dstOffset += (index % mShape[i - 1]) * mDstStrides[i - 1];
+              index     /= mShape[i - 1];
+            }
+
+            kernel(src + srcOffset, srcStrides[axis], line.data());
+
+            C* dstLine = dst + dstOffset;
+
+            for (std::size_t k{}; k < length; ++k)
+            {
+              dstLine[k * mDstStrides[axis]] = line[k] * scale;
+            }
+          }
+        });
+      }
+
+      /**
+       * @brief Transform all lines along the axis, laneCount neighbouring lines along the lane axis at once. The lines
+       *        are gathered into planar rows of lanes on the stack, the missing lanes of the last block are not stored.
+       * @param axis The transformed axis.
+       * @param laneAxis The lane axis, see findLaneAxis().
+       * @param kernel The lane kernel of the axis length.
+       * @param src The source buffer.
+       * @param srcStrides The source strides.
+       * @param dst The destination buffer, may alias the source.
+       * @param scale The scale applied to the outputs.
+       * @param threadLimit The maximum number of threads.
+       */
+      void transformAxisLanes(std::size_t        axis,
+                              std::size_t        laneAxis,
+                              LaneKernel<T>      kernel,
+                              const C*           src,
+                              const std::size_t* srcStrides,
+                              C*                 dst,
+                              T                  scale,
+                              std::size_t        threadLimit) const
+      {
+        const std::size_t length       = mShape[axis];
+        const std::size_t laneExtent   = mShape[laneAxis];
+        const std::size_t blockCount   = (laneExtent + laneCount - 1) / laneCount;
+        const std::size_t outerCount   = std::accumulate(mShape.data(),
+                                                         mShape.data() + mShapeRank,
+                                                         std::size_t{1},
+                                                         std::multiplies<>{}) / (length * laneExtent);
+        const std::size_t itemCount    = outerCount * blockCount;
+        const std::size_t itemsPerTask = std::max(linesPerTask / laneCount, std::size_t{1});
+        const std::size_t taskCount    = (itemCount + itemsPerTask - 1) / itemsPerTask;
+
+        parallelFor(taskCount, threadLimit, [&](std::size_t task)
+        {
+          alignas(64) std::array<T, maxLength * laneCount> inRe{};
+          alignas(64) std::array<T, maxLength * laneCount> inIm{};
+          alignas(64) std::array<T, maxLength * laneCount> outRe{};
+          alignas(64) std::array<T, maxLength * laneCount> outIm{};
+
+          const std::size_t end = std::min(itemCount, (task + 1) * itemsPerTask);
+
+          for (std::size_t item = task * itemsPerTask; item < end; ++item)
+          {
+            std::size_t index     = item / blockCount;
+            std::size_t srcOffset = 0;
+            std::size_t dstOffset = 0;
+
+            // blocks enumerate the indices of the other axes, the last axis varies fastest
+            for (std::size_t i = mShapeRank; i > 0; --i)
+            {
+              if (i - 1 == axis || i - 1 == laneAxis)
+              {
+                continue;
+              }
+
+              srcOffset += (index % mShape[i - 1]) * srcStrides[i - 1];
+              dstOffset += (index % mShape[i - 1]) * mDstStrides[i - 1];
+              index     /= mShape[i - 1];
+            }
+
+            const std::size_t firstLane = (item % blockCount) * laneCount;
+            const std::size_t lanes     = std::min(laneCount, laneExtent - firstLane);
+
+            srcOffset += firstLane * srcStrides[laneAxis];
+            dstOffset += firstLane * mDstStrides[laneAxis];
+
+            for (std::size_t n{}; n < length; ++n)
+            {
+              const C* srcRow = src + srcOffset + n * srcStrides[axis];
+
+              for (std::size_t l{}; l < lanes; ++l)
+              {
+                inRe[n * laneCount + l] = srcRow[l * srcStrides[laneAxis]].real();
+                inIm[n * laneCount + l] = srcRow[l * srcStrides[laneAxis]].imag();
+              }
+            }
+
+            kernel(inRe.data(), inIm.data(), 1, outRe.data(), outIm.data());
+
+            for (std::size_t k{}; k < length; ++k)
+            {
+              C* dstRow = dst + dstOffset + k * mDstStrides[axis];
+
+              for (std::size_t l{}; l < lanes; ++l)
+              {
+                dstRow[l * mDstStrides[laneAxis]] = C{outRe[k * laneCount + l] * scale, outIm[k * laneCount + l] * scale};
+              }
+            }
+          }
+        });
+      }
+
+      std::size_t                mShapeRank{};        ///< The rank of the shape
+      MaxDimArray<std::size_t>   mShape{};            ///< The shape of the data
+      MaxDimArray<std::size_t>   mSrcStrides{};       ///< The strides of the source data
+      MaxDimArray<std::size_t>   mDstStrides{};       ///< The strides of the destination data
+      std::size_t                mAxisCount{};        ///< The number of transformed axes
+      MaxDimArray<std::size_t>   mAxes{};             ///< The transformed axes
+      MaxDimArray<Kernel<T>>     mKernels{};          ///< The kernel of each transformed axis
+      MaxDimArray<std::size_t>   mLaneAxes{};         ///< The lane axis of each transformed axis, mShapeRank if none
+      MaxDimArray<LaneKernel<T>> mLaneKernels{};      ///< The lane kernel of each transformed axis with a lane axis
+      T                          mScale{};            ///< The normalization factor
+      std::size_t                mPencilAxis{};       ///< The batch axis of the pencil mode, mShapeRank if not used
+      MaxDimArray<std::size_t>   mPencilStrides{};    ///< The stride of each transformed axis within a pencil
+      std::vector<std::size_t>   mPencilSrcOffsets{}; ///< The source offset of each element of a pencil
+      std::vector<std::size_t>   mPencilDstOffsets{}; ///< The destination offset of each element of a pencil
+      mutable std::vector<T>     mPencilWork{};       ///< The work buffer of the pencils of realtime plans
+      mutable std::atomic<bool>  mPencilWorkInUse{};  ///< Is the pencil work buffer used by an execution?
+  };
+
+  /**
+   * @class DoubleDoublePlan
+   * @brief Implementation of the plan for the spst cpu architecture computing f64f64 transforms of any length in
+   *        double-double arithmetic, about 32 significant digits. Each line is gathered into planar buffers and
+   *        transformed by the mixed radix Stockham schedule of its axis, whose error-free sums and FMA products run on
+   *        AVX2 or AVX-512 vectors when available. Lengths with a prime factor above dd::maxRadix are computed by the
+   *        Bluestein method over a power of two schedule. The lines are distributed over the shared thread pool, a
+   *        single line is parallelized over the butterflies of each stage instead.
+   */
+  class DoubleDoublePlan final : public afft::Plan
+  {
+    private:
+      /// @brief Alias for the parent class
+      using Parent = afft::Plan;
+
+      /// @brief Alias for the double-double complex type
+      using Complex = dd::Complex;
+
+      /// @brief Number of lines transformed by one task of the thread pool
+      static constexpr std::size_t linesPerTask{16};
+
+    public:
+      /**
+       * @brief Constructor
+       * @param desc The plan description
+       */
+      DoubleDoublePlan(const Desc& desc)
+      : Parent{desc},
+        mShapeRank{desc.getShapeRank()}
+      {
+        mDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto  shape      = mDesc.getShape();
+        const auto  axes       = mDesc.getTransformAxes();
+        const auto& memLayout  = mDesc.template getMemoryLayout<Distribution::spst>();
+        const auto  srcStrides = memLayout.getSrcStrides();
+        const auto  dstStrides = memLayout.getDstStrides();
+
+        std::copy(shape.begin(), shape.end(), mShape.begin());
+        std::copy(srcStrides.begin(), srcStrides.end(), mSrcStrides.begin());
+        std::copy(dstStrides.begin(), dstStrides.end(), mDstStrides.begin());
+
+        mAxisCount = axes.size();
+
+        std::size_t logicalSize{1};
+        std::size_t maxWorkLength{};
+
+        for (std::size_t i{}; i < mAxisCount; ++i)
+        {
+          mAxes[i]      = axes[i];
+          mEngines[i]   = makeEngine(shape[axes[i]], mDesc.getDirection());
+          logicalSize  *= shape[axes[i]];
+          maxWorkLength = std::max(maxWorkLength, mEngines[i].getWorkLength());
+        }
+
+        // the normalization factor is computed in double-double, 1 / N in double would limit the accuracy
+        switch (mDesc.getNormalization())
+        {
+        case Normalization::orthogonal:
+          mScale = dd::inverseSqrt(logicalSize);
+          break;
+        case Normalization::unitary:
+          mScale = dd::divide(1, logicalSize);
+          break;
+        default:
+          break;
+        }
+
+        // realtime plans run the tasks one by one on the calling thread, they share a work buffer made here
+        if (mDesc.isRealtime())
+        {
+          mWork.resize(8 * maxWorkLength);
+        }
+      }
+
+      /// @brief Default destructor
+      ~DoubleDoublePlan() override = default;
+
+      /**
+       * @brief Get the backend.
+       * @return The backend.
+       */
+      [[nodiscard]] Backend getBackend() const noexcept override
+      {
+        return Backend::codelet;
+      }
+
+      /**
+       * @brief Execute the plan
+       * @param src The source buffer
+       * @param dst The destination buffer
+       */
+      void executeBackendImpl(View<void*> src, View<void*> dst, const afft::spst::cpu::ExecutionParameters&) override
+      {
+        const auto threadLimit = mDesc.template getArchDesc<Target::cpu, Distribution::spst>().threadLimit;
+
+        for (std::size_t i{}; i < mAxisCount; ++i)
+        {
+          const bool isFirst = (i == 0);
+          const bool isLast  = (i + 1 == mAxisCount);
+
+          transformAxis(mAxes[i],
+                        mEngines[i],
+                        static_cast<const Complex*>(isFirst ? src.front() : dst.front()),
+                        isFirst ? mSrcStrides.data() : mDstStrides.data(),
+                        static_cast<Complex*>(dst.front()),
+                        isLast,
+                        threadLimit);
+        }
+      }
+
+    private:
+      /// @brief Transform of one axis length.
+      struct Engine
+      {
+        std::size_t          length{};           ///< The length of the axis.
+        dd::Schedule         schedule{};         ///< The schedule of the length, the forward one of the Bluestein length
+        dd::Schedule         backwardSchedule{}; ///< The backward schedule of the Bluestein length
+        std::vector<Complex> chirp{};            ///< The Bluestein chirp e^{-+pi i j^2 / n}, empty if not used
+        std::vector<Complex> filter{};           ///< The transformed conjugate chirp divided by the Bluestein length
+
+        /// @brief Get the number of elements of a work buffer.
+        [[nodiscard]] std::size_t getWorkLength() const noexcept
+        {
+          return schedule.getLength();
+        }
+      };
+
+      /**
+       * @brief Make the engine of the length.
+       * @param length The length.
+       * @param direction The direction.
+       * @return The engine.
+       */
+      [[nodiscard]] static Engine makeEngine(std::size_t length, Direction direction)
+      {
+        Engine engine{};
+        engine.length = length;
+
+        if (dd::Schedule::isSupported(length))
+        {
+          engine.schedule = dd::Schedule{length, direction};
+          return engine;
+        }
+
+        const std::size_t fftLength = chirpZ::nextPowerOfTwo(2 * length - 1);
+
+        engine.schedule         = dd::Schedule{fftLength, Direction::forward};
+        engine.backwardSchedule = dd::Schedule{fftLength, Direction::backward};
+
+        // c_j = e^{-+2pi i j^2 / 2n}, the exponent is reduced modulo 2n by the recurrence (j + 1)^2 = j^2 + 2j + 1
+        const auto roots = dd::makeRootsOfUnity(2 * length, direction == Direction::forward);
+
+        engine.chirp.resize(length);
+
+        for (std::size_t j{}, index{}; j < length; ++j)
+        {
+          engine.chirp[j] = roots[index];
+          index           = (index + 2 * j + 1) % (2 * length);
+        }
+
+        std::vector<double> work(8 * fftLength);
+
+        const auto x = dd::Planes::make(work.data(), fftLength);
+        const auto y = dd::Planes::make(work.data() + 4 * fftLength, fftLength);
+
+        for (std::size_t j{}; j < length; ++j)
+        {
+          const auto& c = engine.chirp[j];
+          const Complex conjChirp{c.re, {-c.im.hi, -c.im.lo}};
+
+          x.set(j, conjChirp);
+
+          if (j > 0)
+          {
+            x.set(fftLength - j, conjChirp);
+          }
+        }
+
+        const auto result = engine.schedule.execute(x, y, 1);
+
+        // the division by the power of two length is exact
+        const double inverseLength = 1.0 / static_cast<double>(fftLength);
+
+        engine.filter.resize(fftLength);
+
+        for (std::size_t k{}; k < fftLength; ++k)
+        {
+          const auto value = result.get(k);
+
+          engine.filter[k] = Complex{{value.re.hi * inverseLength, value.re.lo * inverseLength},
+                                     {value.im.hi * inverseLength, value.im.lo * inverseLength}};
+        }
+
+        return engine;
+      }
+
+      /**
+       * @brief Transform the gathered line.
+       * @param engine The engine of the axis.
+       * @param x The line, overwritten.
+       * @param y The other work buffer.
+       * @param threadLimit The thread limit of the stages.
+       * @return The buffer holding the transformed line, x or y.
+       */
+      [[nodiscard]] static dd::Planes transformLine(const Engine& engine, dd::Planes x, dd::Planes y, std::size_t threadLimit)
+      {
+        using Ops = dd::ScalarOps;
+
+        if (engine.chirp.empty())
+        {
+          return engine.schedule.execute(x, y, threadLimit);
+        }
+
+        const std::size_t fftLength = engine.getWorkLength();
+
+        for (std::size_t j{}; j < fftLength; ++j)
+        {
+          x.set(j, (j < engine.length) ? dd::toComplex(dd::mul<Ops>(x.load<Ops>(j), dd::broadcast<Ops>(engine.chirp[j])))
+                                       : Complex{});
+        }
+
+        const auto spectrum = engine.schedule.execute(x, y, threadLimit);
+
+        for (std::size_t k{}; k < fftLength; ++k)
+        {
+          spectrum.set(k, dd::toComplex(dd::mul<Ops>(spectrum.load<Ops>(k), dd::broadcast<Ops>(engine.filter[k]))));
+        }
+
+        const auto other  = (spectrum.reHi == x.reHi) ? y : x;
+        const auto result = engine.backwardSchedule.execute(spectrum, other, threadLimit);
+
+        for (std::size_t k{}; k < engine.length; ++k)
+        {
+          result.set(k, dd::toComplex(dd::mul<Ops>(result.load<Ops>(k), dd::broadcast<Ops>(engine.chirp[k]))));
+        }
+
+        return result;
+      }
+
+      /**
+       * @brief Transform all lines along the axis.
+       * @param axis The transformed axis.
+       * @param engine The engine of the axis.
+       * @param src The source buffer.
+       * @param srcStrides The source strides.
+       * @param dst The destination buffer, may alias the source.
+       * @param isScaled Apply the normalization factor to the outputs?
+       * @param threadLimit The maximum number of threads.
+       */
+      void transformAxis(std::size_t        axis,
+                         const Engine&      engine,
+                         const Complex*     src,
+                         const std::size_t* srcStrides,
+                         Complex*           dst,
+                         bool               isScaled,
+                         std::size_t        threadLimit) const
+      {
+        using Ops = dd::ScalarOps;
+
+        const std::size_t length     = mShape[axis];
+        const std::size_t workLength = engine.getWorkLength();
+        const std::size_t lineCount  = std::accumulate(mShape.data(),
+                                                       mShape.data() + mShapeRank,
+                                                       std::size_t{1},
+                                                       std::multiplies<>{}) / length;
+        const std::size_t taskCount  = (lineCount + linesPerTask - 1) / linesPerTask;
+
+        // a single line is parallelized over the butterflies of the stages
+        const std::size_t stageThreadLimit = (lineCount == 1) ? threadLimit : 1;
+
+        const bool isScaleOne = !isScaled || (mScale.hi == 1.0 && mScale.lo == 0.0);
+
+        const WorkClaim workClaim{mWorkInUse, !mWork.empty()};
+        const bool      useSharedWork = workClaim.isClaimed();
+
+        parallelFor(taskCount, (lineCount == 1) ? 1 : threadLimit, [&](std::size_t task)
+        {
+          std::vector<double> taskWork((useSharedWork) ? std::size_t{} : 8 * workLength);
+
+          double* work = (useSharedWork) ? mWork.data() : taskWork.data();
+
+          const auto x = dd::Planes::make(work, workLength);
+          const auto y = dd::Planes::make(work + 4 * workLength, workLength);
+
+          const std::size_t end = std::min(lineCount, (task + 1) * linesPerTask);
+
+          for (std::size_t l = task * linesPerTask; l < end; ++l)
+          {
+            std::size_t index     = l;
+            std::size_t srcOffset = 0;
+            std::size_t dstOffset = 0;
+
+            // lines enumerate the indices of the other axes, the last axis varies fastest
+            for (std::size_t i = mShapeRank; i > 0; --i)
+            {
+              if (i - 1 == axis)
+              {
+                continue;
+              }
+
+              srcOffset += (index % mShape[i - 1]) * srcStrides[i - 1];
+              dstOffset += (index % mShape[i - 1]) * mDstStrides[i - 1];
+              index     /= mShape[i - 1];
+            }
+
+            for (std::size_t n{}; n < length; ++n)
+            {
+              x.set(n, src[srcOffset + n * srcStrides[axis]]);
+            }
+
+            const auto result = transformLine(engine, x, y, stageThreadLimit);
+
+            Complex* dstLine = dst + dstOffset;
+
+            for (std::size_t k{}; k < length; ++k)
+            {
+              dstLine[k * mDstStrides[axis]] = (isScaleOne) ? result.get(k)
+                                                            : dd::toComplex(dd::mul<Ops>(result.load<Ops>(k), mScale));
+            }
+          }
+        });
+      }
+
+      std::size_t                 mShapeRank{};     ///< The rank of the shape
+      MaxDimArray<std::size_t>    mShape{};         ///< The shape of the data
+      MaxDimArray<std::size_t>    mSrcStrides{};    ///< The strides of the source data
+      MaxDimArray<std::size_t>    mDstStrides{};    ///< The strides of the destination data
+      std::size_t                 mAxisCount{};     ///< The number of transformed axes
+      MaxDimArray<std::size_t>    mAxes{};          ///< The transformed axes
+      MaxDimArray<Engine>         mEngines{};       ///< The engine of each transformed axis
+      dd::RealV<dd::ScalarOps>    mScale{1.0, 0.0}; ///< The normalization factor
+      mutable std::vector<double> mWork{};          ///< The work buffer of realtime plans
+      mutable std::atomic<bool>   mWorkInUse{};     ///< Is the work buffer used by an execution?
+  };
+
+  /**
+   * @brief Create a codelet spst cpu plan implementation.
+   * @param desc Plan description.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] AFFT_HEADER_ONLY_INLINE std::unique_ptr<afft::Plan> makePlan(const Desc& desc)
+  {
+    // the layout, the precision and the lengths are checked by supports() in makePlan.hpp
+    switch (desc.getPrecision().execution)
+    {
+      case Precision::f64f64:
+        return std::make_unique<DoubleDoublePlan>(desc);
+      case Precision::_float:
+        return std::make_unique<Plan<float>>(desc);
+      case Precision::_double:
+        return std::make_unique<Plan<double>>(desc);
+      default:
+        throw BackendError{Backend::codelet, "unsupported precision"};
+    }
+  }
+} // namespace afft::detail::codelet::spst::cpu
+
+#endif /* AFFT_HEADER_ONLY */
+
+#endif /* AFFT_DETAIL_CODELET_SPST_HPP */
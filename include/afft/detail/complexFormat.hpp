@@ -0,0 +1,415 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_COMPLEX_FORMAT_HPP
+#define AFFT_DETAIL_COMPLEX_FORMAT_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "cpuFeatures.hpp"
+#include "ThreadPool.hpp"
+#include "transpose.hpp"
+#include "../common.hpp"
+
+namespace afft::detail::complexFormat
+{
+  /// @brief Number of complex elements converted by one work item.
+  inline constexpr std::size_t chunkSize{std::size_t{1} << 16};
+
+#if defined(AFFT_DETAIL_CPU_TARGET_AVX2)
+  /**
+   * @brief Interleave the leading planar complex elements using AVX2, the elements are scaled.
+   * @param re Real parts.
+   * @param im Imaginary parts.
+   * @param dst Interleaved complex elements.
+   * @param count Number of complex elements.
+   * @param scale Scale factor.
+   * @return Number of converted complex elements, the rest is left to the scalar loop.
+   */
+  AFFT_DETAIL_CPU_TARGET_AVX2 inline std::size_t interleaveAvx2(const float* re, const float* im, float* dst, std::size_t count, float scale) noexcept
+  {
+    std::size_t i{};
+
+    const __m256 vScale = _mm256_set1_ps(scale);
+
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m256 vRe = _mm256_mul_ps(_mm256_loadu_ps(re + i), vScale);
+      const __m256 vIm = _mm256_mul_ps(_mm256_loadu_ps(im + i), vScale);
+      const __m256 lo  = _mm256_unpacklo_ps(vRe, vIm);
+      const __m256 hi  = _mm256_unpackhi_ps(vRe, vIm);
+
+      _mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+      _mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+
+    return i;
+  }
+
+  /**
+   * @brief Interleave the leading planar complex elements using AVX2, the elements are scaled.
+   * @param re Real parts.
+   * @param im Imaginary parts.
+   * @param dst Interleaved complex elements.
+   * @param count Number of complex elements.
+   * @param scale Scale factor.
+   * @return Number of converted complex elements, the rest is left to the scalar loop.
+   */
+  AFFT_DETAIL_CPU_TARGET_AVX2 inline std::size_t interleaveAvx2(const double* re, const double* im, double* dst, std::size_t count, double scale) noexcept
+  {
+    std::size_t i{};
+
+    const __m256d vScale = _mm256_set1_pd(scale);
+
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m256d vRe = _mm256_mul_pd(_mm256_loadu_pd(re + i), vScale);
+      const __m256d vIm = _mm256_mul_pd(_mm256_loadu_pd(im + i), vScale);
+      const __m256d lo  = _mm256_unpacklo_pd(vRe, vIm);
+      const __m256d hi  = _mm256_unpackhi_pd(vRe, vIm);
+
+      _mm256_storeu_pd(dst + 2 * i, _mm256_permute2f128_pd(lo, hi, 0x20));
+      _mm256_storeu_pd(dst + 2 * i + 4, _mm256_permute2f128_pd(lo, hi, 0x31));
+    }
+
+    return i;
+  }
+
+  /**
+   * @brief Deinterleave the leading complex elements into planar ones using AVX2, the elements are scaled.
+   * @param src Interleaved complex elements.
+   * @param re Real parts.
+   * @param im Imaginary parts.
+   * @param count Number of complex elements.
+   * @param scale Scale factor.
+   * @return Number of converted complex elements, the rest is left to the scalar loop.
+   */
+  AFFT_DETAIL_CPU_TARGET_AVX2 inline std::size_t deinterleaveAvx2(const float* src, float* re, float* im, std::size_t count, float scale) noexcept
+  {
+    std::size_t i{};
+
+    const __m256 vScale = _mm256_set1_ps(scale);
+
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m256 a = _mm256_loadu_ps(src + 2 * i);
+      const __m256 b = _mm256_loadu_ps(src + 2 * i + 8);
+
+      // the shuffles keep the elements of each 128-bit lane, the lanes are reordered afterwards
+      const __m256 vRe = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+      const __m256 vIm = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+      _mm256_storeu_ps(re + i, _mm256_mul_ps(_mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(vRe), 0xd8)), vScale));
+      _mm256_storeu_ps(im + i, _mm256_mul_ps(_mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(vIm), 0xd8)), vScale));
+    }
+
+    return i;
+  }
+
+  /**
+   * @brief Deinterleave the leading complex elements into planar ones using AVX2, the elements are scaled.
+   * @param src Interleaved complex elements.
+   * @param re Real parts.
+   * @param im Imaginary parts.
+   * @param count Number of complex elements.
+   * @param scale Scale factor.
+   * @return Number of converted complex elements, the rest is left to the scalar loop.
+   */
+  AFFT_DETAIL_CPU_TARGET_AVX2 inline std::size_t deinterleaveAvx2(const double* src, double* re, double* im, std::size_t count, double scale) noexcept
+  {
+    std::size_t i{};
+
+    const __m256d vScale = _mm256_set1_pd(scale);
+
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m256d a  = _mm256_loadu_pd(src + 2 * i);
+      const __m256d b  = _mm256_loadu_pd(src + 2 * i + 4);
+      const __m256d t0 = _mm256_permute2f128_pd(a, b, 0x20);
+      const __m256d t1 = _mm256_permute2f128_pd(a, b, 0x31);
+
+      _mm256_storeu_pd(re + i, _mm256_mul_pd(_mm256_unpacklo_pd(t0, t1), vScale));
+      _mm256_storeu_pd(im + i, _mm256_mul_pd(_mm256_unpackhi_pd(t0, t1), vScale));
+    }
+
+    return i;
+  }
+#endif
+
+  /**
+   * @brief Interleave planar complex elements, the floating point elements are scaled.
+   * @tparam T Real type, float, double or transpose::Elem for other precisions.
+   * @param re Real parts.
+   * @param im Imaginary parts.
+   * @param dst Interleaved complex elements.
+   * @param count Number of complex elements.
+   * @param scale Scale factor, ignored for non floating point types.
+   */
+  template<typename T>
+  void interleaveChunk(const T* re, const T* im, T* dst, std::size_t count, [[maybe_unused]] T scale) noexcept
+  {
+    std::size_t i{};
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+#   if defined(AFFT_DETAIL_CPU_TARGET_AVX2)
+      if (cpuFeatures::hasAvx2())
+      {
+        i = interleaveAvx2(re, im, dst, count, scale);
+      }
+#   elif defined(__ARM_NEON)
+      for (; i + 4 <= count; i += 4)
+      {
+        vst2q_f32(dst + 2 * i, float32x4x2_t{{vmulq_n_f32(vld1q_f32(re + i), scale), vmulq_n_f32(vld1q_f32(im + i), scale)}});
+      }
+#   endif
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+#   if defined(AFFT_DETAIL_CPU_TARGET_AVX2)
+      if (cpuFeatures::hasAvx2())
+      {
+        i = interleaveAvx2(re, im, dst, count, scale);
+      }
+#   elif defined(__ARM_NEON) && defined(__aarch64__)
+      for (; i + 2 <= count; i += 2)
+      {
+        vst2q_f64(dst + 2 * i, float64x2x2_t{{vmulq_n_f64(vld1q_f64(re + i), scale), vmulq_n_f64(vld1q_f64(im + i), scale)}});
+      }
+#   endif
+    }
+
+    for (; i < count; ++i)
+    {
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        dst[2 * i]     = re[i] * scale;
+        dst[2 * i + 1] = im[i] * scale;
+      }
+      else
+      {
+        dst[2 * i]     = re[i];
+        dst[2 * i + 1] = im[i];
+      }
+    }
+  }
+
+  /**
+   * @brief Deinterleave complex elements into planar ones, the floating point elements are scaled.
+   * @tparam T Real type, float, double or transpose::Elem for other precisions.
+   * @param src Interleaved complex elements.
+   * @param re Real parts.
+   * @param im Imaginary parts.
+   * @param count Number of complex elements.
+   * @param scale Scale factor, ignored for non floating point types.
+   */
+  template<typename T>
+  void deinterleaveChunk(const T* src, T* re, T* im, std::size_t count, [[maybe_unused]] T scale) noexcept
+  {
+    std::size_t i{};
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+#   if defined(AFFT_DETAIL_CPU_TARGET_AVX2)
+      if (cpuFeatures::hasAvx2())
+      {
+        i = deinterleaveAvx2(src, re, im, count, scale);
+      }
+#   elif defined(__ARM_NEON)
+      for (; i + 4 <= count; i += 4)
+      {
+        const float32x4x2_t v = vld2q_f32(src + 2 * i);
+
+        vst1q_f32(re + i, vmulq_n_f32(v.val[0], scale));
+        vst1q_f32(im + i, vmulq_n_f32(v.val[1], scale));
+      }
+#   endif
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+#   if defined(AFFT_DETAIL_CPU_TARGET_AVX2)
+      if (cpuFeatures::hasAvx2())
+      {
+        i = deinterleaveAvx2(src, re, im, count, scale);
+      }
+#   elif defined(__ARM_NEON) && defined(__aarch64__)
+      for (; i + 2 <= count; i += 2)
+      {
+        const float64x2x2_t v = vld2q_f64(src + 2 * i);
+
+        vst1q_f64(re + i, vmulq_n_f64(v.val[0], scale));
+        vst1q_f64(im + i, vmulq_n_f64(v.val[1], scale));
+      }
+#   endif
+    }
+
+    for (; i < count; ++i)
+    {
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        re[i] = src[2 * i] * scale;
+        im[i] = src[2 * i + 1] * scale;
+      }
+      else
+      {
+        re[i] = src[2 * i];
+        im[i] = src[2 * i + 1];
+      }
+    }
+  }
+
+  /**
+   * @brief Call the function with a null pointer of the real type of the precision.
+   * @tparam FnT Function type.
+   * @param prec Precision.
+   * @param realElemSize Size of the real element in bytes.
+   * @param fn Function.
+   */
+  template<typename FnT>
+  void dispatchRealType(Precision prec, std::size_t realElemSize, FnT&& fn)
+  {
+    if (prec == Precision::f32 && realElemSize == sizeof(float))
+    {
+      fn(static_cast<float*>(nullptr));
+      return;
+    }
+    else if (prec == Precision::f64 && realElemSize == sizeof(double))
+    {
+      fn(static_cast<double*>(nullptr));
+      return;
+    }
+
+    switch (realElemSize)
+    {
+    case 2:  fn(static_cast<transpose::Elem<2>*>(nullptr));  break;
+    case 4:  fn(static_cast<transpose::Elem<4>*>(nullptr));  break;
+    case 8:  fn(static_cast<transpose::Elem<8>*>(nullptr));  break;
+    case 16: fn(static_cast<transpose::Elem<16>*>(nullptr)); break;
+    default:
+      throw std::invalid_argument{"unsupported element size of the complex format conversion"};
+    }
+  }
+
+  /**
+   * @brief Check if the precision supports the scaled conversion.
+   * @param prec Precision.
+   * @return True for f32 and f64, false otherwise.
+   */
+  [[nodiscard]] constexpr bool isScalable(Precision prec) noexcept
+  {
+    return prec == Precision::f32 || prec == Precision::f64;
+  }
+
+  /**
+   * @brief Interleave planar complex elements in parallel.
+   * @param prec Precision of the real parts.
+   * @param realElemSize Size of the real element in bytes.
+   * @param re Real parts.
+   * @param im Imaginary parts.
+   * @param dst Interleaved complex elements, must not overlap the planar ones.
+   * @param count Number of complex elements.
+   * @param scale Scale factor, must be 1 unless isScalable(prec).
+   * @param threadCount Maximum number of threads, 0 for the thread pool size.
+   */
+  inline void interleave(Precision   prec,
+                         std::size_t realElemSize,
+                         const void* re,
+                         const void* im,
+                         void*       dst,
+                         std::size_t count,
+                         double      scale,
+                         std::size_t threadCount)
+  {
+    dispatchRealType(prec, realElemSize, [&](auto* typeTag)
+    {
+      using T = std::remove_pointer_t<decltype(typeTag)>;
+
+      const T* reT  = static_cast<const T*>(re);
+      const T* imT  = static_cast<const T*>(im);
+      T*       dstT = static_cast<T*>(dst);
+
+      T scaleT{};
+
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        scaleT = static_cast<T>(scale);
+      }
+
+      parallelFor((count + chunkSize - 1) / chunkSize, threadCount, [&](std::size_t chunk)
+      {
+        const std::size_t offset = chunk * chunkSize;
+
+        interleaveChunk(reT + offset, imT + offset, dstT + 2 * offset, std::min(chunkSize, count - offset), scaleT);
+      });
+    });
+  }
+
+  /**
+   * @brief Deinterleave complex elements into planar ones in parallel.
+   * @param prec Precision of the real parts.
+   * @param realElemSize Size of the real element in bytes.
+   * @param src Interleaved complex elements.
+   * @param re Real parts, must not overlap the interleaved elements.
+   * @param im Imaginary parts, must not overlap the interleaved elements.
+   * @param count Number of complex elements.
+   * @param scale Scale factor, must be 1 unless isScalable(prec).
+   * @param threadCount Maximum number of threads, 0 for the thread pool size.
+   */
+  inline void deinterleave(Precision   prec,
+                           std::size_t realElemSize,
+                           const void* src,
+                           void*       re,
+                           void*       im,
+                           std::size_t count,
+                           double      scale,
+                           std::size_t threadCount)
+  {
+    dispatchRealType(prec, realElemSize, [&](auto* typeTag)
+    {
+      using T = std::remove_pointer_t<decltype(typeTag)>;
+
+      const T* srcT = static_cast<const T*>(src);
+      T*       reT  = static_cast<T*>(re);
+      T*       imT  = static_cast<T*>(im);
+
+      T scaleT{};
+
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        scaleT = static_cast<T>(scale);
+      }
+
+      parallelFor((count + chunkSize - 1) / chunkSize, threadCount, [&](std::size_t chunk)
+      {
+        const std::size_t offset = chunk * chunkSize;
+
+        deinterleaveChunk(srcT + 2 * offset, reT + offset, imT + offset, std::min(chunkSize, count - offset), scaleT);
+      });
+    });
+  }
+} // namespace afft::detail::complexFormat
+
+#endif /* AFFT_DETAIL_COMPLEX_FORMAT_HPP */
@@ -85,6 +85,11 @@
 # define AFFT_CXX_HAS_SPAN
 #endif
 
+// Check if C++20 <coroutine> is supported
+#if defined(AFFT_CXX_HAS_VERSION) && defined(__cpp_lib_coroutine) && (__cpp_lib_coroutine >= 201902L)
+# define AFFT_CXX_HAS_COROUTINE
+#endif
+
 // Check if C++23 `import std` is supported
 #if defined(AFFT_CXX_HAS_VERSION) && defined(__cpp_lib_modules) && (__cpp_lib_modules >= 202207L)
 # define AFFT_CXX_HAS_IMPORT_STD
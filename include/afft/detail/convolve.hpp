@@ -0,0 +1,191 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_CONVOLVE_HPP
+#define AFFT_DETAIL_CONVOLVE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "utils.hpp"
+#include "../common.hpp"
+
+namespace afft::detail
+{
+  /// @brief Name of the load callback multiplying the spectrum by the kernel spectrum
+  inline constexpr std::string_view convolutionLoadCallbackName{"afftConvolutionLoadCallback"};
+
+  /**
+   * @brief Prepare the kernel spectrum for the pointwise multiplication. The inverse transform normalization is folded
+   *        into the kernel spectrum and the spectrum is conjugated for correlation, so the multiply pass does no extra
+   *        work.
+   * @tparam T Real type.
+   * @param spectrum Interleaved complex spectrum.
+   * @param count Number of complex elements.
+   * @param scale Scale factor.
+   * @param conjugate Conjugate the spectrum.
+   */
+  template<typename T>
+  void prepareKernelSpectrum(T* spectrum, std::size_t count, T scale, bool conjugate) noexcept
+  {
+    const T imagScale = (conjugate) ? -scale : scale;
+
+    for (std::size_t i{}; i < count; ++i)
+    {
+      spectrum[2 * i]     *= scale;
+      spectrum[2 * i + 1] *= imagScale;
+    }
+  }
+
+  /**
+   * @brief Multiply the spectrum by the kernel spectrum in place. The loop has no branches and works directly on the
+   *        interleaved real and imaginary parts, so the compiler vectorizes it.
+   * @tparam T Real type.
+   * @param spectrum Interleaved complex spectrum.
+   * @param kernelSpectrum Interleaved complex kernel spectrum, must not overlap the spectrum.
+   * @param count Number of complex elements.
+   */
+  template<typename T>
+  void multiplySpectra(T* spectrum, const T* kernelSpectrum, std::size_t count) noexcept
+  {
+    for (std::size_t i{}; i < count; ++i)
+    {
+      const T re  = spectrum[2 * i];
+      const T im  = spectrum[2 * i + 1];
+      const T kRe = kernelSpectrum[2 * i];
+      const T kIm = kernelSpectrum[2 * i + 1];
+
+      spectrum[2 * i]     = re * kRe - im * kIm;
+      spectrum[2 * i + 1] = re * kIm + im * kRe;
+    }
+  }
+
+  /**
+   * @brief Select the block size of the overlap-save method. The block size is a 5-smooth number, which every backend
+   *        transforms efficiently, minimizing the estimated cost per output sample. The cost of a block is its
+   *        transform cost plus a fixed per block overhead, non power of two sizes are penalized as they are slower in
+   *        practice.
+   * @param filterSize Size of the filter.
+   * @param maxLatency Maximum latency in samples, 0 for no limit.
+   * @return Block size.
+   */
+  [[nodiscard]] inline std::size_t selectOverlapSaveBlockSize(std::size_t filterSize, std::size_t maxLatency)
+  {
+    if (filterSize == 0)
+    {
+      throw std::invalid_argument{"filter size must be greater than zero"};
+    }
+
+    // The block produces blockSize - filterSize + 1 samples, the latency
+    const std::size_t minBlockSize = std::max(filterSize, std::size_t{2});
+    const std::size_t maxBlockSize = (maxLatency != 0)
+                                       ? filterSize - 1 + maxLatency
+                                       : std::max(std::size_t{1} << 22, 64 * filterSize);
+
+    if (maxBlockSize < minBlockSize)
+    {
+      throw std::invalid_argument{"maximum latency is too small for the filter size"};
+    }
+
+    // Per block overhead of the plan executions and the multiply pass in units of the transform cost
+    constexpr double blockOverhead{1024.0};
+
+    std::size_t bestBlockSize{};
+    double      bestCost{std::numeric_limits<double>::infinity()};
+
+    for (std::size_t pow2{1}; pow2 <= maxBlockSize; pow2 *= 2)
+    {
+      for (std::size_t pow3{pow2}; pow3 <= maxBlockSize; pow3 *= 3)
+      {
+        for (std::size_t blockSize{pow3}; blockSize <= maxBlockSize; blockSize *= 5)
+        {
+          if (blockSize < minBlockSize)
+          {
+            continue;
+          }
+
+          const auto   outputSize = static_cast<double>(blockSize - filterSize + 1);
+          const double penalty    = (blockSize == pow2) ? 1.0 : 1.25;
+          const double fftCost    = penalty * static_cast<double>(blockSize) * std::log2(static_cast<double>(blockSize));
+          const double cost       = (fftCost + blockOverhead) / outputSize;
+
+          if (cost < bestCost || (cost == bestCost && blockSize < bestBlockSize))
+          {
+            bestBlockSize = blockSize;
+            bestCost      = cost;
+          }
+        }
+      }
+    }
+
+    return bestBlockSize;
+  }
+
+  /**
+   * @brief Make the source code of the load callback multiplying the spectrum by the kernel spectrum. The kernel
+   *        spectrum is passed as the caller info, the scale and the conjugation are compiled in.
+   * @param prec Precision of the spectrum, f32 or f64.
+   * @param scale Scale factor.
+   * @param conjugate Conjugate the kernel spectrum.
+   * @return The source code.
+   */
+  [[nodiscard]] inline std::string makeConvolutionLoadCallbackSrcCode(Precision prec, double scale, bool conjugate)
+  {
+    std::string code{"#include <cuComplex.h>\n\n"};
+
+    switch (prec)
+    {
+    case Precision::f32:
+      code += "typedef cuComplex Complex;\ntypedef float Real;\n";
+      break;
+    case Precision::f64:
+      code += "typedef cuDoubleComplex Complex;\ntypedef double Real;\n";
+      break;
+    default:
+      throw std::invalid_argument{"convolution supports only f32 and f64 precision"};
+    }
+
+    code += cformat("\n#define SCALE     %.17g\n#define CONJUGATE %d\n", scale, conjugate ? 1 : 0);
+    code += R"(
+extern "C" __device__ Complex afftConvolutionLoadCallback(void* dataIn, size_t offset, void* callerInfo, void*)
+{
+  const Complex elem = static_cast<const Complex*>(dataIn)[offset];
+  const Complex k    = static_cast<const Complex*>(callerInfo)[offset];
+  const Real    kIm  = (CONJUGATE) ? -k.y : k.y;
+
+  Complex result;
+  result.x = (elem.x * k.x - elem.y * kIm) * Real(SCALE);
+  result.y = (elem.x * kIm + elem.y * k.x) * Real(SCALE);
+
+  return result;
+}
+)";
+
+    return code;
+  }
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_CONVOLVE_HPP */
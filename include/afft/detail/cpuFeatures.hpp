@@ -0,0 +1,176 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_CPU_FEATURES_HPP
+#define AFFT_DETAIL_CPU_FEATURES_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "../common.hpp"
+
+// Attribute of a function using AVX2 instructions, defined only if the AVX2 kernels can be built. Without the AVX2
+// compiler flags the kernels are built for the target attribute and selected at runtime.
+#if defined(__AVX2__)
+# define AFFT_DETAIL_CPU_TARGET_AVX2
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+# define AFFT_DETAIL_CPU_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace afft::detail::cpuFeatures
+{
+  /// @brief Instruction set extensions of the cpu the process runs on.
+  struct Features
+  {
+    bool sse2{};    ///< SSE2 support
+    bool sse4_2{};  ///< SSE4.2 support
+    bool avx{};     ///< AVX support
+    bool avx2{};    ///< AVX2 support
+    bool fma{};     ///< FMA support
+    bool avx512f{}; ///< AVX-512F support
+    bool neon{};    ///< NEON support
+    bool sve{};     ///< SVE support
+  };
+
+  /**
+   * @brief Get the features the compiler may assume for every cpu the binary runs on.
+   * @return The compile time features.
+   */
+  [[nodiscard]] constexpr Features getCompileTimeFeatures() noexcept
+  {
+    Features features{};
+
+#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP == 2)
+    features.sse2    = true;
+#endif
+#if defined(__SSE4_2__)
+    features.sse4_2  = true;
+#endif
+#if defined(__AVX__)
+    features.avx     = true;
+#endif
+#if defined(__AVX2__)
+    features.avx2    = true;
+#endif
+#if defined(__FMA__)
+    features.fma     = true;
+#endif
+#if defined(__AVX512F__)
+    features.avx512f = true;
+#endif
+#if defined(__ARM_NEON) || defined(_M_ARM_NEON)
+    features.neon    = true;
+#endif
+#if defined(__ARM_FEATURE_SVE)
+    features.sve     = true;
+#endif
+
+    return features;
+  }
+
+  /**
+   * @brief Detect the features of the cpu. Features the detection is not available for are taken from the compiler
+   *        flags.
+   * @return The detected features.
+   */
+  [[nodiscard]] inline Features detect() noexcept
+  {
+    Features features = getCompileTimeFeatures();
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+
+    features.sse2    = features.sse2    || __builtin_cpu_supports("sse2");
+    features.sse4_2  = features.sse4_2  || __builtin_cpu_supports("sse4.2");
+    features.avx     = features.avx     || __builtin_cpu_supports("avx");
+    features.avx2    = features.avx2    || __builtin_cpu_supports("avx2");
+    features.fma     = features.fma     || __builtin_cpu_supports("fma");
+    features.avx512f = features.avx512f || __builtin_cpu_supports("avx512f");
+#elif defined(__aarch64__) && defined(__linux__)
+    const auto hwcap = ::getauxval(AT_HWCAP);
+
+    features.neon = features.neon || (hwcap & HWCAP_ASIMD) != 0;
+# ifdef HWCAP_SVE
+    features.sve  = features.sve  || (hwcap & HWCAP_SVE) != 0;
+# endif
+#endif
+
+    return features;
+  }
+
+  /**
+   * @brief Get the features of the cpu, detected once per process.
+   * @return The cpu features.
+   */
+  [[nodiscard]] inline const Features& get() noexcept
+  {
+    static const Features features = detect();
+
+    return features;
+  }
+
+  /**
+   * @brief Get the alignment matching the widest vector registers of the cpu.
+   * @param features The cpu features.
+   * @return The alignment.
+   */
+  [[nodiscard]] constexpr Alignment getAlignment(const Features& features) noexcept
+  {
+    if (features.avx512f)
+    {
+      return Alignment::avx512;
+    }
+    else if (features.avx)
+    {
+      return Alignment::avx;
+    }
+    else if (features.sve)
+    {
+      return Alignment::sve;
+    }
+    else if (features.sse2 || features.neon)
+    {
+      return Alignment::simd128;
+    }
+
+    return Alignment::defaultNew;
+  }
+
+  /**
+   * @brief Check if the AVX2 kernels may be used.
+   * @return True if the cpu supports AVX2, false otherwise.
+   */
+  [[nodiscard]] inline bool hasAvx2() noexcept
+  {
+#if defined(__AVX2__)
+    return true;
+#else
+    return get().avx2;
+#endif
+  }
+} // namespace afft::detail::cpuFeatures
+
+#endif /* AFFT_DETAIL_CPU_FEATURES_HPP */
@@ -0,0 +1,285 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_CUDA_MODULE_CACHE_HPP
+#define AFFT_DETAIL_CUDA_MODULE_CACHE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "device.hpp"
+#include "Module.hpp"
+#include "rtc/rtc.hpp"
+
+namespace afft::detail::cuda
+{
+  /**
+   * @class ModuleCache
+   * @brief Process-wide cache of runtime compiled modules. The compiled code is cached by a key made of the source
+   *        code and the compilation options (including the target architecture), the loaded modules are cached per
+   *        code and device. Optionally, the compiled code is stored in a directory, so it is reused across processes.
+   *        Codes of different keys are compiled concurrently, concurrent requests of the same key wait for a single
+   *        compilation.
+   */
+  class ModuleCache
+  {
+    public:
+      /**
+       * @brief Get the singleton instance of the module cache.
+       * @return The module cache.
+       */
+      [[nodiscard]] static ModuleCache& getInstance()
+      {
+        static ModuleCache instance{};
+        return instance;
+      }
+
+      /**
+       * @brief Make the cache key.
+       * @param srcCode The source code of the program.
+       * @param options The compilation options, must include the target architecture option.
+       * @return The cache key.
+       */
+      [[nodiscard]] static std::string makeKey(std::string_view srcCode, Span<const char* const> options)
+      {
+        std::string key = std::to_string(std::hash<std::string_view>{}(srcCode));
+
+        for (const char* option : options)
+        {
+          key += ' ';
+          key += option;
+        }
+
+        return key;
+      }
+
+      /**
+       * @brief Set the directory where the compiled code is stored. Empty directory disables the on-disk cache.
+       * @param directory The directory, it must exist.
+       */
+      void setDirectory(std::string_view directory)
+      {
+        std::lock_guard lock{mMutex};
+        mDirectory = directory;
+      }
+
+      /**
+       * @brief Get the directory where the compiled code is stored.
+       * @return The directory, empty if the on-disk cache is disabled.
+       */
+      [[nodiscard]] std::string getDirectory() const
+      {
+        std::lock_guard lock{mMutex};
+        return mDirectory;
+      }
+
+      /**
+       * @brief Get the module for the key loaded on the device. If not cached, the code is loaded from the cache
+       *        directory or compiled by the compile function.
+       * @tparam CompileFnT Compile function type, must return rtc::Code.
+       * @param key The cache key made by makeKey().
+       * @param device The device.
+       * @param compileFn The compile function.
+       * @return The module.
+       */
+      template<typename CompileFnT>
+      [[nodiscard]] Module get(const std::string& key, int device, CompileFnT&& compileFn)
+      {
+        std::unique_lock lock{mMutex};
+
+        const auto moduleKey = key + " #" + std::to_string(device);
+
+        auto codeIt = mCodes.end();
+
+        while (true)
+        {
+          if (auto it = mModules.find(moduleKey); it != mModules.end())
+          {
+            return it->second;
+          }
+
+          if (codeIt = mCodes.find(key); codeIt != mCodes.end())
+          {
+            break;
+          }
+
+          // Another thread compiles the code, wait for it and look again, a failed compilation is retried here
+          if (auto it = mPendingCodes.find(key); it != mPendingCodes.end())
+          {
+            const auto pendingCode = it->second;
+
+            lock.unlock();
+            pendingCode.wait();
+            lock.lock();
+            continue;
+          }
+
+          std::promise<void> compiled{};
+          mPendingCodes.emplace(key, compiled.get_future().share());
+
+          const auto directory = mDirectory;
+
+          lock.unlock();
+
+          std::optional<rtc::Code> code{};
+          std::exception_ptr       error{};
+
+          try
+          {
+            code = loadCode(directory, key);
+
+            if (!code)
+            {
+              code.emplace(std::forward<CompileFnT>(compileFn)());
+              storeCode(directory, key, *code);
+            }
+          }
+          catch (...)
+          {
+            error = std::current_exception();
+          }
+
+          lock.lock();
+
+          mPendingCodes.erase(key);
+          compiled.set_value();
+
+          if (error)
+          {
+            std::rethrow_exception(error);
+          }
+
+          codeIt = mCodes.emplace(key, std::move(*code)).first;
+          break;
+        }
+
+        ScopedDevice scopedDevice{device};
+
+        return mModules.emplace(moduleKey, Module{codeIt->second}).first->second;
+      }
+
+      /// @brief Clears the in-memory cache. Modules in use stay loaded until released.
+      void clear()
+      {
+        std::lock_guard lock{mMutex};
+        mModules.clear();
+        mCodes.clear();
+      }
+
+    private:
+      /// @brief Default constructor.
+      ModuleCache() = default;
+
+      /**
+       * @brief Get the cache file path for the key.
+       * @param directory The cache directory.
+       * @param key The cache key.
+       * @return The cache file path.
+       */
+      [[nodiscard]] static std::string getFilePath(const std::string& directory, const std::string& key)
+      {
+        return directory + "/afft-" + std::to_string(std::hash<std::string>{}(key)) + ".bin";
+      }
+
+      /**
+       * @brief Loads the code from the cache directory. The file starts with the key line, so hash collisions are
+       *        detected.
+       * @param directory The cache directory, empty if disabled.
+       * @param key The cache key.
+       * @return The code or std::nullopt if not found.
+       */
+      [[nodiscard]] static std::optional<rtc::Code> loadCode(const std::string& directory, const std::string& key)
+      {
+        if (directory.empty())
+        {
+          return std::nullopt;
+        }
+
+        std::ifstream file{getFilePath(directory, key), std::ios::binary};
+
+        std::string fileKey{};
+        std::string codeType{};
+
+        if (!std::getline(file, fileKey) || fileKey != key || !std::getline(file, codeType))
+        {
+          return std::nullopt;
+        }
+
+        std::string data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+        rtc::Code code{static_cast<rtc::CodeType>(std::stoi(codeType)), data.size(), rtc::Code::PrivilegedToken{}};
+        std::copy(data.begin(), data.end(), code.data());
+
+        return code;
+      }
+
+      /**
+       * @brief Stores the code in the cache directory. The file is written to a temporary file first and then renamed,
+       *        so concurrent processes never read a partially written file. Failures are ignored, the cache is only an
+       *        optimization.
+       * @param directory The cache directory, empty if disabled.
+       * @param key The cache key.
+       * @param code The code.
+       */
+      static void storeCode(const std::string& directory, const std::string& key, const rtc::Code& code)
+      {
+        if (directory.empty())
+        {
+          return;
+        }
+
+        const auto filePath     = getFilePath(directory, key);
+        const auto tempFilePath = filePath + ".tmp" +
+                                  std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+
+        {
+          std::ofstream file{tempFilePath, std::ios::binary | std::ios::trunc};
+
+          file << key << '\n' << static_cast<int>(code.type()) << '\n';
+          file.write(code.data(), static_cast<std::streamsize>(code.size()));
+
+          if (!file)
+          {
+            std::remove(tempFilePath.c_str());
+            return;
+          }
+        }
+
+        if (std::rename(tempFilePath.c_str(), filePath.c_str()) != 0)
+        {
+          std::remove(tempFilePath.c_str());
+        }
+      }
+
+      mutable std::mutex                                        mMutex{};        ///< The mutex guarding the cache.
+      std::string                                               mDirectory{};    ///< The cache directory, empty if disabled.
+      std::unordered_map<std::string, rtc::Code>                mCodes{};        ///< The compiled code by the key.
+      std::unordered_map<std::string, std::shared_future<void>> mPendingCodes{}; ///< The codes being compiled by the key.
+      std::unordered_map<std::string, Module>                   mModules{};      ///< The loaded modules by the key and device.
+  };
+} // namespace afft::detail::cuda
+
+#endif /* AFFT_DETAIL_CUDA_MODULE_CACHE_HPP */
@@ -29,7 +29,9 @@
 #include "enviroment.hpp"
 #include "error.hpp"
 #include "init.hpp"
+#include "memory.hpp"
 #include "Module.hpp"
+#include "ModuleCache.hpp"
 #include "rtc/rtc.hpp"
 
 namespace afft::detail::cuda
@@ -85,6 +85,33 @@ namespace afft::detail::cuda
                                                           (errorStr != nullptr) ? errorName : "no description")};
     }
   }
+
+#ifdef AFFT_ENABLE_GDS
+  /**
+   * @brief Check if cuFile error is ok.
+   * @param error cuFile error.
+   * @return True if error is CU_FILE_SUCCESS, false otherwise.
+   */
+  [[nodiscard]] inline constexpr bool isOk(CUfileError_t error)
+  {
+    return (error.err == CU_FILE_SUCCESS);
+  }
+
+  /**
+   * @brief Check if cuFile error is valid.
+   * @param error cuFile error.
+   * @throw GpuBackendError if error is not valid.
+   */
+  inline void checkError(CUfileError_t error)
+  {
+    if (!isOk(error))
+    {
+      const char* errorStr = (error.err == CU_FILE_CUDA_DRIVER_ERROR) ? "CUDA driver error" : CUFILE_ERRSTR(error.err);
+
+      throw GpuBackendError{cformatNothrow("cuFile - %s", (errorStr != nullptr) ? errorStr : "no description")};
+    }
+  }
+#endif
 } // namespace afft::detail::cuda
 
 #endif /* AFFT_DETAIL_GPU_CUDA_ERROR_HPP */
@@ -0,0 +1,175 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_CUDA_MEMORY_HPP
+#define AFFT_DETAIL_CUDA_MEMORY_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "error.hpp"
+
+namespace afft::detail::cuda
+{
+  /**
+   * @brief Check if the pointer points to managed memory.
+   * @param ptr The pointer.
+   * @return True if the pointer points to managed memory, false otherwise.
+   */
+  [[nodiscard]] inline bool isManagedMemory(const void* ptr)
+  {
+    cudaPointerAttributes attributes{};
+
+    if (cudaPointerGetAttributes(&attributes, ptr) != cudaSuccess)
+    {
+      // CUDA prior to 11.0 fails for unregistered host memory, clear the error
+      static_cast<void>(cudaGetLastError());
+      return false;
+    }
+
+    return attributes.type == cudaMemoryTypeManaged;
+  }
+
+  /**
+   * @brief Prefetch the managed memory to the device on the stream, does nothing for other memory.
+   * @param ptr The pointer.
+   * @param size The size in bytes.
+   * @param device The device.
+   * @param stream The stream.
+   * @param advise Advise the device as the preferred location of the memory.
+   */
+  inline void prefetchManagedMemory(const void* ptr, std::size_t size, int device, cudaStream_t stream, bool advise)
+  {
+    if (ptr == nullptr || size == 0 || !isManagedMemory(ptr))
+    {
+      return;
+    }
+
+#if CUDART_VERSION >= 13000
+    const cudaMemLocation location{cudaMemLocationTypeDevice, device};
+
+    if (advise)
+    {
+      checkError(cudaMemAdvise(ptr, size, cudaMemAdviseSetPreferredLocation, location));
+    }
+
+    checkError(cudaMemPrefetchAsync(ptr, size, location, 0, stream));
+#else
+    if (advise)
+    {
+      checkError(cudaMemAdvise(ptr, size, cudaMemAdviseSetPreferredLocation, device));
+    }
+
+    checkError(cudaMemPrefetchAsync(ptr, size, device, stream));
+#endif
+  }
+
+  /**
+   * @class L2PersistingWindow
+   * @brief Marks a buffer as persisting in the L2 cache for the work enqueued on the stream while the object lives,
+   *        the previous access policy window of the stream is restored by the destructor. The window is limited to
+   *        the maximum access policy window size of the device and its hit ratio to the persisting L2 cache set aside
+   *        by cudaDeviceSetLimit(cudaLimitPersistingL2CacheSize). A default constructed window, a null buffer or a
+   *        device without the persisting L2 cache leave the stream untouched.
+   */
+  class L2PersistingWindow
+  {
+    public:
+      /// @brief Default constructor, the window is not set.
+      L2PersistingWindow() = default;
+
+      /**
+       * @brief Constructor, sets the access policy window of the stream.
+       * @param ptr The buffer.
+       * @param size The size of the buffer in bytes.
+       * @param device The device.
+       * @param stream The stream.
+       */
+      L2PersistingWindow(const void* ptr, std::size_t size, int device, cudaStream_t stream)
+      {
+        if (ptr == nullptr || size == 0)
+        {
+          return;
+        }
+
+        int maxWindowSize{};
+        checkError(cudaDeviceGetAttribute(&maxWindowSize, cudaDevAttrMaxAccessPolicyWindowSize, device));
+
+        if (maxWindowSize <= 0)
+        {
+          return;
+        }
+
+        std::size_t setAsideSize{};
+        checkError(cudaDeviceGetLimit(&setAsideSize, cudaLimitPersistingL2CacheSize));
+
+        const auto windowSize = std::min(size, static_cast<std::size_t>(maxWindowSize));
+
+        cudaStreamAttrValue value{};
+        value.accessPolicyWindow.base_ptr  = const_cast<void*>(ptr);
+        value.accessPolicyWindow.num_bytes = windowSize;
+        value.accessPolicyWindow.hitRatio  = (setAsideSize > 0)
+                                               ? std::min(1.f, static_cast<float>(setAsideSize) /
+                                                                 static_cast<float>(windowSize))
+                                               : 1.f;
+        value.accessPolicyWindow.hitProp   = cudaAccessPropertyPersisting;
+        value.accessPolicyWindow.missProp  = cudaAccessPropertyStreaming;
+
+        checkError(cudaStreamGetAttribute(stream, cudaStreamAttributeAccessPolicyWindow, &mPrevValue));
+        checkError(cudaStreamSetAttribute(stream, cudaStreamAttributeAccessPolicyWindow, &value));
+
+        mStream = stream;
+        mIsSet  = true;
+      }
+
+      /// @brief Copy constructor is deleted.
+      L2PersistingWindow(const L2PersistingWindow&) = delete;
+
+      /// @brief Move constructor is deleted.
+      L2PersistingWindow(L2PersistingWindow&&) = delete;
+
+      /// @brief Destructor, restores the previous access policy window of the stream.
+      ~L2PersistingWindow()
+      {
+        if (mIsSet)
+        {
+          static_cast<void>(cudaStreamSetAttribute(mStream, cudaStreamAttributeAccessPolicyWindow, &mPrevValue));
+        }
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      L2PersistingWindow& operator=(const L2PersistingWindow&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      L2PersistingWindow& operator=(L2PersistingWindow&&) = delete;
+
+    private:
+      cudaStream_t        mStream{};    ///< The stream.
+      cudaStreamAttrValue mPrevValue{}; ///< The previous access policy window of the stream.
+      bool                mIsSet{};     ///< The window of the stream is set.
+  };
+} // namespace afft::detail::cuda
+
+#endif /* AFFT_DETAIL_CUDA_MEMORY_HPP */
@@ -31,6 +31,13 @@
 
 #include "error.hpp"
 #include "../enviroment.hpp"
+#include "../../../trace.hpp"
+
+namespace afft::detail::cuda
+{
+  // Forward declaration
+  class ModuleCache;
+} // namespace afft::detail::cuda
 
 namespace afft::detail::cuda::rtc
 {
@@ -148,6 +155,7 @@ namespace afft::detail::cuda::rtc
       class PrivilegedToken
       {
         friend class Program;
+        friend class cuda::ModuleCache;
       };
 
       /// @brief Default constructor.
@@ -235,6 +243,7 @@ namespace afft::detail::cuda::rtc
        */
       template<std::size_t n = 0>
       Program(std::string_view srcCode, std::string_view programName, Span<Header, n> headers = {})
+      : mName{programName}
       {
         using CharPtrContainer = std::conditional_t<(n != dynamicExtent),
                                                     std::array<const char*, n>, std::vector<const char*>>;
@@ -311,8 +320,15 @@ namespace afft::detail::cuda::rtc
           throw std::runtime_error{"The program is already compiled"};
         }
 
+        const auto start = std::chrono::steady_clock::now();
+
         bool ok = isOk(nvrtcCompileProgram(mProgram.get(), static_cast<int>(options.size()), options.data()));
 
+        trace::emit(afft::trace::EventType::rtcCompile,
+                    std::nullopt,
+                    mName,
+                    std::chrono::steady_clock::now() - start);
+
         std::size_t logSize{};
 
         checkError(nvrtcGetProgramLogSize(mProgram.get(), &logSize));
@@ -419,6 +435,7 @@ namespace afft::detail::cuda::rtc
         }
       };
 
+      std::string                                          mName{};           ///< The program name.
       std::shared_ptr<std::remove_pointer_t<nvrtcProgram>> mProgram{};        ///< The program.
       bool                                                 mIsCompiled{};     ///< Program is compiled.
       std::string                                          mCompilationLog{}; ///< The compilation log.
@@ -472,6 +489,9 @@ namespace afft::detail::cuda::rtc
     return cformat("-I%s", includePath.data());
   }
 
+  /// @brief Option making the program emit relocatable LTO IR, see CodeType::LTOIR.
+  inline constexpr const char* ltoOption{"-dlto"};
+
   /**
    * @brief Make a preprocessor definition option.
    * @param name The name of the definition.
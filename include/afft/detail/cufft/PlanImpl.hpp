@@ -63,10 +63,6 @@ namespace afft::detail::gpu::cufft
 # error "COMPLEXITY must be either COMPLEXITY_REAL or COMPLEXITY_COMPLEX" 
 #endif
 
-#ifndef SCALE
-# error "SCALE must be defined"
-#endif
-
 /**********************************************************************************************************************/
 /* Copied from cufft.h and cufftXt.h to prevent include                                                               */
 /**********************************************************************************************************************/
@@ -93,27 +89,28 @@ typedef void (*cufftCallbackStoreD)(void *dataOut, size_t offset, cufftDoubleRea
 
 /**********************************************************************************************************************/
 
-#if PRECISION == PRECISION_F32
-constexpr cufftReal scale{SCALE};
-#else
-constexpr cufftDoubleReal scale{SCALE};
-#endif
-
 extern "C" __device__
 #if PRECISION == PRECISION_F32
 # if COMPLEXITY == COMPLEXITY_REAL
-    void cufftJITCallbackStoreReal(void* dataOut, size_t offset, cufftReal elem, void*, void*)
+    void cufftJITCallbackStoreReal(void* dataOut, size_t offset, cufftReal elem, void* callerInfo, void*)
 # else
-    void cufftJITCallbackStoreComplex(void* dataOut, size_t offset, cufftComplex elem, void*, void*)
+    void cufftJITCallbackStoreComplex(void* dataOut, size_t offset, cufftComplex elem, void* callerInfo, void*)
 # endif
 #elif PRECISION == PRECISION_F64
 # if COMPLEXITY == COMPLEXITY_REAL
-    void cufftJITCallbackStoreDoubleReal(void* dataOut, size_t offset, cufftDoubleReal elem, void*, void*)
+    void cufftJITCallbackStoreDoubleReal(void* dataOut, size_t offset, cufftDoubleReal elem, void* callerInfo, void*)
 # else
-    void cufftJITCallbackStoreDoubleComplex(void* dataOut, size_t offset, cufftDoubleComplex elem, void*, void*)
+    void cufftJITCallbackStoreDoubleComplex(void* dataOut, size_t offset, cufftDoubleComplex elem, void* callerInfo, void*)
 # endif
 #endif
 {
+  // The scale is passed at runtime, so a single compiled callback serves all plans
+#if PRECISION == PRECISION_F32
+  const cufftReal scale = *static_cast<const cufftReal*>(callerInfo);
+#else
+  const cufftDoubleReal scale = *static_cast<const cufftDoubleReal*>(callerInfo);
+#endif
+
 #if COMPLEXITY == COMPLEXITY_REAL
   elem *= scale;
 #else
@@ -271,46 +268,73 @@ extern "C" __device__ __constant__
                                          batch,
                                          &workSize,
                                          executionType));
-        
-        // FIXME: This is not working
-        // Error::check(cufftXtSetWorkAreaPolicy(mPlan, getWorkspacePolicy(commonParams.workspacePolicy), &workSize));
+
+#     if CUFFT_VERSION >= 9200
+        // cuFFT supports work area policies only for c2c transforms with all sizes up to 4096
+        if (dftParams.type == dft::Type::complexToComplex &&
+            std::all_of(n.begin(), n.end(), [](auto size){ return size <= 4096; }))
+        {
+          Error::check(cufftXtSetWorkAreaPolicy(mPlan,
+                                                getWorkspacePolicy(getConfig().getCommonParameters().workspacePolicy),
+                                                &workSize));
+        }
+#     endif
 
         if (const auto normalization = getConfig().getCommonParameters().normalization;
             normalization != Normalization::none)
         {
-          cuda::rtc::Program program{callbackSrcCode, "cufftCallbackFn.cu"};
-
           std::array options
           {
             cuda::rtc::makeDefinitionOption("PRECISION", std::to_string(cxx::to_underlying(precision.execution))),
             cuda::rtc::makeDefinitionOption("COMPLEXITY", std::to_string(dftParams.type == dft::Type::complexToReal
                                                                            ? cxx::to_underlying(Complexity::real)
                                                                            : cxx::to_underlying(Complexity::complex))),
-            cuda::rtc::makeDefinitionOption("SCALE", std::to_string(getConfig().getTransformNormFactor<Precision::f64>())),
             cuda::rtc::makeArchOption(device),
             cuda::rtc::makeIncludePathOption(cuda::getIncludePath()),
           };
 
           std::array optionPtrs = {options[0].c_str(), options[1].c_str(), options[2].c_str(), options[3].c_str(), "-dc"};
 
-          if (!program.compile(optionPtrs))
+          // The callback only depends on the options, compile it once per process
+          mModule = cuda::ModuleCache::getInstance().get(cuda::ModuleCache::makeKey(callbackSrcCode, optionPtrs),
+                                                         device,
+                                                         [&]()
           {
-            throw makeException<std::runtime_error>("Failed to compile callback function");
-          }
+            cuda::rtc::Program program{callbackSrcCode, "cufftCallbackFn.cu"};
 
-          mModule.load(program.getCode(cuda::rtc::CodeType::CUBIN));
+            if (!program.compile(optionPtrs))
+            {
+              throw makeException<std::runtime_error>("Failed to compile callback function");
+            }
+
+            return program.getCode(cuda::rtc::CodeType::CUBIN);
+          });
 
           auto [dStoreCallbackPtr, storeCallbackPtrSize] = mModule.getGlobal(storeCallbackPtrName);
 
           void** hStoreCallbackPtr{};
           Error::check(cuMemcpyDtoH(&hStoreCallbackPtr, dStoreCallbackPtr, storeCallbackPtrSize));
 
+          // Pass the scale to the callback as the caller info
+          const double scale = getConfig().getTransformNormFactor<Precision::f64>();
+
+          if (precision.execution == Precision::f32)
+          {
+            mCallerInfo = makeCallerInfo(static_cast<float>(scale));
+          }
+          else
+          {
+            mCallerInfo = makeCallerInfo(scale);
+          }
+
+          void* callerInfo = mCallerInfo.get();
+
           Error::check(cufftXtSetCallback(mPlan,
                                           hStoreCallbackPtr,
                                           makeStoreCallbackType(precision.execution,
                                                                 (dftParams.type == dft::Type::complexToReal)
                                                                   ? Complexity::real : Complexity::complex),
-                                          nullptr));
+                                          &callerInfo));
         }
       }
 
@@ -364,8 +388,41 @@ extern "C" __device__ __constant__
       }
     protected:
     private:
-      cuda::Module mModule{}; ///< The module containing the callback function.
-      Handle       mPlan{};   ///< The cuFFT plan.
+      /// @brief Deleter of the device memory.
+      struct DeviceMemoryDeleter
+      {
+        void operator()(void* ptr) const
+        {
+          cudaFree(ptr);
+        }
+      };
+
+      /// @brief Device memory of the callback caller info.
+      using CallerInfoPtr = std::unique_ptr<void, DeviceMemoryDeleter>;
+
+      /**
+       * @brief Makes the callback caller info holding the value in the device memory.
+       * @tparam T The value type.
+       * @param value The value.
+       * @return The caller info.
+       */
+      template<typename T>
+      [[nodiscard]] static CallerInfoPtr makeCallerInfo(const T& value)
+      {
+        void* ptr{};
+
+        cuda::checkError(cudaMalloc(&ptr, sizeof(T)));
+
+        CallerInfoPtr callerInfo{ptr};
+
+        cuda::checkError(cudaMemcpy(callerInfo.get(), &value, sizeof(T), cudaMemcpyHostToDevice));
+
+        return callerInfo;
+      }
+
+      cuda::Module  mModule{};     ///< The module containing the callback function.
+      CallerInfoPtr mCallerInfo{}; ///< The callback caller info holding the normalization scale.
+      Handle        mPlan{};       ///< The cuFFT plan.
   };
 
   /**
@@ -29,7 +29,8 @@
 # include "../include.hpp"
 #endif
 
-#include "../../gpu.hpp"
+#include "error.hpp"
+#include "../cuda/cuda.hpp"
 
 namespace afft::detail::cufft
 {
@@ -46,7 +47,7 @@ namespace afft::detail::cufft
       /// @brief Default constructor.
       Handle()
       {
-        Error::check(cufftCreate(&mHandle));
+        checkError(cufftCreate(&mHandle));
       }
 
       /// @brief Deleted copy constructor.
@@ -82,6 +83,8 @@ namespace afft::detail::cufft
   /// @brief cuFFT callback source code
   inline constexpr std::string_view callbackSrcCode
   {R"(
+#include <cuComplex.h>
+
 #define PRECISION_F32      3 // must match afft::Precision::f32
 #define PRECISION_F64      4 // must match afft::Precision::f64
 
@@ -100,10 +103,6 @@ namespace afft::detail::cufft
 # error "COMPLEXITY must be either COMPLEXITY_REAL or COMPLEXITY_COMPLEX" 
 #endif
 
-#ifndef SCALE
-# error "SCALE must be defined"
-#endif
-
 /**********************************************************************************************************************/
 /* Copied from cufft.h and cufftXt.h to prevent include                                                               */
 /**********************************************************************************************************************/
@@ -130,27 +129,28 @@ typedef void (*cufftCallbackStoreD)(void *dataOut, size_t offset, cufftDoubleRea
 
 /**********************************************************************************************************************/
 
-#if PRECISION == PRECISION_F32
-constexpr cufftReal scale{SCALE};
-#else
-constexpr cufftDoubleReal scale{SCALE};
-#endif
-
 extern "C" __device__
 #if PRECISION == PRECISION_F32
 # if COMPLEXITY == COMPLEXITY_REAL
-    void cufftJITCallbackStoreReal(void* dataOut, size_t offset, cufftReal elem, void*, void*)
+    void cufftJITCallbackStoreReal(void* dataOut, size_t offset, cufftReal elem, void* callerInfo, void*)
 # else
-    void cufftJITCallbackStoreComplex(void* dataOut, size_t offset, cufftComplex elem, void*, void*)
+    void cufftJITCallbackStoreComplex(void* dataOut, size_t offset, cufftComplex elem, void* callerInfo, void*)
 # endif
 #elif PRECISION == PRECISION_F64
 # if COMPLEXITY == COMPLEXITY_REAL
-    void cufftJITCallbackStoreDoubleReal(void* dataOut, size_t offset, cufftDoubleReal elem, void*, void*)
+    void cufftJITCallbackStoreDoubleReal(void* dataOut, size_t offset, cufftDoubleReal elem, void* callerInfo, void*)
 # else
-    void cufftJITCallbackStoreDoubleComplex(void* dataOut, size_t offset, cufftDoubleComplex elem, void*, void*)
+    void cufftJITCallbackStoreDoubleComplex(void* dataOut, size_t offset, cufftDoubleComplex elem, void* callerInfo, void*)
 # endif
 #endif
 {
+  // The scale is passed at runtime, so a single compiled callback serves all plans
+#if PRECISION == PRECISION_F32
+  const cufftReal scale = *static_cast<const cufftReal*>(callerInfo);
+#else
+  const cufftDoubleReal scale = *static_cast<const cufftDoubleReal*>(callerInfo);
+#endif
+
 #if COMPLEXITY == COMPLEXITY_REAL
   elem *= scale;
 #else
@@ -183,6 +183,39 @@ extern "C" __constant__
   /// @brief cuFFT callback function pointer name
   inline constexpr cuda::rtc::CSymbolName storeCallbackPtrName{"cufftCallbackStoreFnPtr"};
 
+  /// @brief User load callback function pointer name
+  inline constexpr cuda::rtc::CSymbolName userLoadCallbackPtrName{"afftUserCallbackLoadFnPtr"};
+
+  /// @brief User store callback function pointer name
+  inline constexpr cuda::rtc::CSymbolName userStoreCallbackPtrName{"afftUserCallbackStoreFnPtr"};
+
+  /// @brief Are the runtime compiled user callbacks set as LTO callbacks inlined into the FFT kernels?
+  inline constexpr bool hasLtoCallbacks{CUFFT_VERSION >= 11300};
+
+  /**
+   * @brief Make the source code of a user callback. A device function pointer to the user function is appended, so its
+   *        value can be read from the compiled module and passed to cuFFT.
+   * @param srcCode The user source code.
+   * @param functionName The name of the user callback function.
+   * @param ptrName The name of the device function pointer.
+   * @return The source code.
+   */
+  [[nodiscard]] inline std::string makeUserCallbackSrcCode(std::string_view       srcCode,
+                                                           std::string_view       functionName,
+                                                           cuda::rtc::CSymbolName ptrName)
+  {
+    std::string code{srcCode};
+    code += "\n\nextern \"C\" __device__ __constant__ decltype(&";
+    code += functionName;
+    code += ") ";
+    code += ptrName;
+    code += " = ";
+    code += functionName;
+    code += ";\n";
+
+    return code;
+  }
+
   /**
    * @brief Make the cuFFT direction.
    * @param dir The direction.
@@ -237,6 +270,45 @@ extern "C" __constant__
     }
   }
 
+  /**
+   * @brief Get the cuFFT transform type.
+   * @param prec The precision of the transform.
+   * @param type The DFT type.
+   * @return The cuFFT transform type.
+   */
+  [[nodiscard]] inline constexpr cufftType makeCufftType(const Precision prec, const dft::Type type)
+  {
+    switch (prec)
+    {
+    case Precision::f32:
+      switch (type)
+      {
+      case dft::Type::complexToComplex:
+        return CUFFT_C2C;
+      case dft::Type::realToComplex:
+        return CUFFT_R2C;
+      case dft::Type::complexToReal:
+        return CUFFT_C2R;
+      default:
+        cxx::unreachable();
+      }
+    case Precision::f64:
+      switch (type)
+      {
+      case dft::Type::complexToComplex:
+        return CUFFT_Z2Z;
+      case dft::Type::realToComplex:
+        return CUFFT_D2Z;
+      case dft::Type::complexToReal:
+        return CUFFT_Z2D;
+      default:
+        cxx::unreachable();
+      }
+    default:
+      throw BackendError{Backend::cufft, "unsupported precision"};
+    }
+  }
+
   /**
    * @brief Make the cuFFT workspace policy.
    * @param policy The workspace policy.
@@ -259,7 +331,26 @@ extern "C" __constant__
   }
 
   /**
-   * @brief Get the cuFFT callback type.
+   * @brief Get the cuFFT load callback type.
+   * @param prec The precision of the data type.
+   * @param comp The complexity of the data type.
+   * @return The cuFFT callback type.
+   */
+  [[nodiscard]] inline constexpr cufftXtCallbackType makeLoadCallbackType(const Precision prec, const Complexity comp)
+  {
+    switch (prec)
+    {
+    case Precision::f32:
+      return (comp == Complexity::real) ? CUFFT_CB_LD_REAL : CUFFT_CB_LD_COMPLEX;
+    case Precision::f64:
+      return (comp == Complexity::real) ? CUFFT_CB_LD_REAL_DOUBLE : CUFFT_CB_LD_COMPLEX_DOUBLE;
+    default:
+      throw BackendError{Backend::cufft, "unsupported precision for callback"};
+    }
+  }
+
+  /**
+   * @brief Get the cuFFT store callback type.
    * @param prec The precision of the data type.
    * @param comp The complexity of the data type.
    * @return The cuFFT callback type.
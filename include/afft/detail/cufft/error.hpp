@@ -95,7 +95,7 @@ namespace afft::detail::cufft
 
     if (!isOk(result))
     {
-      throw makeException<BackendError>(Backend::cufft, getErrorMsg(result));
+      throw BackendError{Backend::cufft, getErrorMsg(result)};
     }
   }
 } // namespace afft::detail::cufft
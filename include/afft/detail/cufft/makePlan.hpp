@@ -0,0 +1,222 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_CUFFT_MAKE_PLAN_HPP
+#define AFFT_DETAIL_CUFFT_MAKE_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../../Plan.hpp"
+#include "mpst.hpp"
+#include "spmt.hpp"
+
+namespace afft::detail::cufft
+{
+  /**
+   * @brief Check if the plan may be supported by the cufft backend, without any side effects.
+   * @param desc Plan description.
+   * @return Backend support, the reason of the rejection if the plan is not supported.
+   */
+  [[nodiscard]] inline BackendSupport supports(const Desc& desc)
+  {
+    if (const auto tRank = desc.getTransformRank(); tRank > 3 || tRank == 0)
+    {
+      return BackendSupport{"only 1D, 2D and 3D transforms are supported"};
+    }
+
+    if (desc.getTransform() != Transform::dft)
+    {
+      return BackendSupport{"only dft transform is supported"};
+    }
+
+    if (!desc.hasUniformPrecision())
+    {
+      return BackendSupport{"execution, source and destination precision must match"};
+    }
+
+    if (desc.getComplexFormat() != ComplexFormat::interleaved)
+    {
+      return BackendSupport{"only interleaved complex format is supported"};
+    }
+
+    if (desc.getTarget() != Target::gpu)
+    {
+      return BackendSupport{"only gpu target is supported"};
+    }
+
+#ifndef AFFT_DISABLE_GPU
+    switch (desc.getDistribution())
+    {
+    case Distribution::spmt:
+    {
+      if (desc.getTargetCount() < 2)
+      {
+        return BackendSupport{"multi-GPU plans require at least two devices"};
+      }
+
+      if (desc.getShapeRank() != desc.getTransformRank())
+      {
+        return BackendSupport{"batched multi-GPU plans are not supported"};
+      }
+
+      if (desc.getTransformRank() == 1)
+      {
+        return BackendSupport{"only 2D and 3D multi-GPU plans are supported"};
+      }
+
+      if (desc.getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex)
+      {
+        return BackendSupport{"only complex-to-complex multi-GPU plans are supported"};
+      }
+
+      if (const auto prec = desc.getPrecision().execution; prec == Precision::f16 || prec == Precision::bf16)
+      {
+        const auto dims = desc.getTransformDimsAs<std::size_t>();
+
+        // cuFFT computes the half precision transforms of power-of-two sizes only
+        if (!std::all_of(dims.begin(), dims.begin() + desc.getTransformRank(), [](std::size_t size)
+        {
+          return cxx::has_single_bit(size);
+        }))
+        {
+          return BackendSupport{"f16 and bf16 multi-GPU plans require power-of-two sizes"};
+        }
+      }
+      else if (prec != Precision::f32 && prec != Precision::f64)
+      {
+        return BackendSupport{"only f16, bf16, f32 and f64 multi-GPU plans are supported"};
+      }
+
+      if (desc.getPlacement() == Placement::outOfPlace && desc.getPreserveSource())
+      {
+        return BackendSupport{"out-of-place multi-GPU plans overwrite the source"};
+      }
+
+      // The normalization is applied by a store callback, cuFFT supports callbacks only in f32 and f64
+      if (const auto prec = desc.getPrecision().execution;
+          desc.getNormalization() != Normalization::none && prec != Precision::f32 && prec != Precision::f64)
+      {
+        return BackendSupport{"normalization of multi-GPU plans requires f32 or f64 precision"};
+      }
+
+      return BackendSupport{};
+    }
+    case Distribution::mpst:
+    {
+#   if defined(AFFT_ENABLE_MPI) && defined(AFFT_CUFFT_HAS_MP)
+      const auto& memLayout = desc.getMemoryLayout<Distribution::mpst>();
+
+      if (desc.getNormalization() != Normalization::none)
+      {
+        return BackendSupport{"normalization of multi-process plans is not supported"};
+      }
+
+      if (const auto rank = desc.getShapeRank(); rank != desc.getTransformRank() || rank < 2)
+      {
+        return BackendSupport{"only single 2D and 3D multi-process plans are supported"};
+      }
+
+      if (const auto prec = desc.getPrecision().execution; prec != Precision::f32 && prec != Precision::f64)
+      {
+        return BackendSupport{"only f32 and f64 multi-process plans are supported"};
+      }
+
+      if (memLayout.hasDefaultSrcMemoryBlock() || memLayout.hasDefaultDstMemoryBlock())
+      {
+        return BackendSupport{"the memory blocks of each process must be specified"};
+      }
+
+      if (!memLayout.hasDefaultSrcAxesOrder() || !memLayout.hasDefaultDstAxesOrder())
+      {
+        return BackendSupport{"custom axes order is not supported"};
+      }
+
+      if (desc.useExternalWorkspace())
+      {
+        return BackendSupport{"the NVSHMEM workspace of multi-process plans is held by the plan"};
+      }
+
+      return BackendSupport{};
+#   else
+      return BackendSupport{"multi-process support requires cuFFTMp"};
+#   endif
+    }
+    default:
+      return BackendSupport{"only spmt and mpst distributions are supported"};
+    }
+#else
+    return BackendSupport{"gpu support is disabled"};
+#endif
+  }
+
+  /**
+   * @brief Create a plan implementation.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Plan description.
+   * @param backendParams Backend parameters.
+   * @return Plan implementation.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] std::unique_ptr<afft::Plan>
+  makePlan([[maybe_unused]] const Desc& desc, [[maybe_unused]] const BackendParamsT& backendParams)
+  {
+    if (const auto support = supports(desc); !support)
+    {
+      throw BackendError{Backend::cufft, support.reason};
+    }
+
+    if constexpr (BackendParamsT::target == Target::gpu)
+    {
+#   ifndef AFFT_DISABLE_GPU
+      if constexpr (BackendParamsT::distribution == Distribution::spmt)
+      {
+        return spmt::gpu::makePlan(desc, backendParams.cufft);
+      }
+      else if constexpr (BackendParamsT::distribution == Distribution::mpst)
+      {
+#     if defined(AFFT_ENABLE_MPI) && defined(AFFT_CUFFT_HAS_MP)
+        return mpst::gpu::makePlan(desc, backendParams.cufft);
+#     else
+        throw BackendError{Backend::cufft, "multi-process support requires cuFFTMp"};
+#     endif
+      }
+      else
+      {
+        throw BackendError{Backend::cufft, "only spmt and mpst distributions are supported"};
+      }
+#   else
+      throw BackendError{Backend::cufft, "gpu support is disabled"};
+#   endif
+    }
+    else
+    {
+      throw BackendError{Backend::cufft, "only gpu target is supported"};
+    }
+  }
+} // namespace afft::detail::cufft
+
+#endif /* AFFT_DETAIL_CUFFT_MAKE_PLAN_HPP */
@@ -0,0 +1,187 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_CUFFT_MPST_HPP
+#define AFFT_DETAIL_CUFFT_MPST_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../../Plan.hpp"
+
+#if defined(AFFT_ENABLE_MPI) && defined(AFFT_CUFFT_HAS_MP)
+
+namespace afft::detail::cufft::mpst::gpu
+{
+  /**
+   * @brief Create a cufft mpst gpu plan implementation.
+   * @param desc Plan description.
+   * @param cufftParams cuFFT parameters.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] std::unique_ptr<afft::Plan>
+  makePlan(const Desc& desc, const afft::cufft::mpst::gpu::Parameters& cufftParams);
+} // namespace afft::detail::cufft::mpst::gpu
+
+#ifdef AFFT_HEADER_ONLY
+
+#include "Plan.hpp"
+
+namespace afft::detail::cufft::mpst::gpu
+{
+  /**
+   * @class Plan
+   * @brief Implementation of the plan for the mpst gpu architecture using cuFFTMp. The source and destination blocks
+   *        are passed to cufftXtSetDistribution, the buffers must be allocated on the NVSHMEM symmetric heap. The
+   *        NVSHMEM workspace is allocated by cuFFTMp when the plan is made and kept until the plan is destroyed.
+   */
+  class Plan final : public cufft::Plan
+  {
+    private:
+      /// @brief Alias for the parent class
+      using Parent = cufft::Plan;
+
+    public:
+      /// @brief inherit constructors
+      using Parent::Parent;
+
+      /**
+       * @brief Constructor
+       * @param desc The plan description
+       * @param cufftParams The cuFFT parameters
+       */
+      Plan(const Desc& desc, const afft::cufft::mpst::gpu::Parameters& cufftParams)
+      : Parent{desc}
+      {
+        mDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto& gpuDesc   = mDesc.getArchDesc<Target::gpu, Distribution::mpst>();
+        const auto& memLayout = mDesc.getMemoryLayout<Distribution::mpst>();
+        const auto  rank      = mDesc.getShapeRank();
+
+        cuda::ScopedDevice device{gpuDesc.device};
+
+        // cuFFTMp keeps the pointer to the communicator, it must outlive the attachment
+        mComm = gpuDesc.comm;
+
+        checkError(cufftMpAttachComm(mHandle, CUFFT_COMM_MPI, &mComm));
+
+        if (cufftParams.usePatientJit)
+        {
+#       if CUFFT_VERSION >= 11200
+          checkError(cufftSetPlanPropertyInt64(mHandle, NVFFT_PLAN_PROPERTY_INT64_PATIENT_JIT, 1));
+#       endif
+        }
+
+        std::array<long long, 3> srcLower{};
+        std::array<long long, 3> srcUpper{};
+        std::array<long long, 3> srcStrides{};
+        std::array<long long, 3> dstLower{};
+        std::array<long long, 3> dstUpper{};
+        std::array<long long, 3> dstStrides{};
+
+        for (std::size_t i{}; i < rank; ++i)
+        {
+          srcLower[i]   = static_cast<long long>(memLayout.getSrcStarts()[i]);
+          srcUpper[i]   = static_cast<long long>(memLayout.getSrcStarts()[i] + memLayout.getSrcSizes()[i]);
+          srcStrides[i] = static_cast<long long>(memLayout.getSrcStrides()[i]);
+          dstLower[i]   = static_cast<long long>(memLayout.getDstStarts()[i]);
+          dstUpper[i]   = static_cast<long long>(memLayout.getDstStarts()[i] + memLayout.getDstSizes()[i]);
+          dstStrides[i] = static_cast<long long>(memLayout.getDstStrides()[i]);
+        }
+
+        checkError(cufftXtSetDistribution(mHandle,
+                                          static_cast<int>(rank),
+                                          srcLower.data(),
+                                          srcUpper.data(),
+                                          dstLower.data(),
+                                          dstUpper.data(),
+                                          srcStrides.data(),
+                                          dstStrides.data()));
+
+        const auto n    = mDesc.getShapeAs<int>();
+        const auto type = makeCufftType(mDesc.getPrecision().execution, mDesc.getTransformDesc<Transform::dft>().type);
+
+        if (rank == 2)
+        {
+          checkError(cufftMakePlan2d(mHandle, n[0], n[1], type, &mBackendMemorySize));
+        }
+        else
+        {
+          checkError(cufftMakePlan3d(mHandle, n[0], n[1], n[2], type, &mBackendMemorySize));
+        }
+      }
+
+      /// @brief Destructor
+      ~Plan() = default;
+
+      /// @brief Inherit assignment operator
+      using Parent::operator=;
+
+      /**
+       * @brief Execute the plan
+       * @param src The source buffer
+       * @param dst The destination buffer
+       * @param execParams The execution parameters
+       */
+      void executeBackendImpl(View<void*> src, View<void*> dst, const afft::mpst::gpu::ExecutionParameters& execParams) override
+      {
+        checkError(cufftSetStream(mHandle, execParams.stream));
+
+        checkError(cufftXtExec(mHandle, src.front(), dst.front(), getCufftDirection()));
+      }
+
+      /**
+       * @brief Get the backend memory size
+       * @return The size of the NVSHMEM workspace held by the plan
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+    private:
+      MPI_Comm    mComm{};              ///< The communicator attached to the plan.
+      std::size_t mBackendMemorySize{}; ///< The size of the NVSHMEM workspace.
+  };
+
+  /**
+   * @brief Create a cufft mpst gpu plan implementation.
+   * @param desc Plan description.
+   * @param cufftParams cuFFT parameters.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] AFFT_HEADER_ONLY_INLINE std::unique_ptr<afft::Plan>
+  makePlan(const Desc& desc, const afft::cufft::mpst::gpu::Parameters& cufftParams)
+  {
+    return std::make_unique<Plan>(desc, cufftParams);
+  }
+} // namespace afft::detail::cufft::mpst::gpu
+
+#endif /* AFFT_HEADER_ONLY */
+
+#endif /* defined(AFFT_ENABLE_MPI) && defined(AFFT_CUFFT_HAS_MP) */
+
+#endif /* AFFT_DETAIL_CUFFT_MPST_HPP */
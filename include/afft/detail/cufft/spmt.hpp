@@ -0,0 +1,450 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_CUFFT_SPMT_HPP
+#define AFFT_DETAIL_CUFFT_SPMT_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../../Plan.hpp"
+
+namespace afft::detail::cufft::spmt::gpu
+{
+  /**
+   * @brief Create a cufft spmt gpu plan implementation.
+   * @param desc Plan description.
+   * @param cufftParams cuFFT parameters.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] std::unique_ptr<afft::Plan>
+  makePlan(const Desc& desc, const afft::cufft::spmt::gpu::Parameters& cufftParams);
+} // namespace afft::detail::cufft::spmt::gpu
+
+#ifdef AFFT_HEADER_ONLY
+
+#include "Plan.hpp"
+
+namespace afft::detail::cufft::spmt::gpu
+{
+  /**
+   * @class Plan
+   * @brief Implementation of the plan for the spmt gpu architecture using cuFFT. The transform is distributed by
+   *        cufftXtSetGPUs, the source and destination blocks split the first axis into contiguous slabs the way
+   *        cuFFT distributes the natural order data.
+   */
+  class Plan final : public cufft::Plan
+  {
+    private:
+      /// @brief Alias for the parent class
+      using Parent = cufft::Plan;
+
+    public:
+      /// @brief inherit constructors
+      using Parent::Parent;
+
+      /**
+       * @brief Constructor
+       * @param desc The plan description
+       * @param cufftParams The cuFFT parameters
+       */
+      Plan(const Desc& desc, const afft::cufft::spmt::gpu::Parameters& cufftParams)
+      : Parent{desc}
+      {
+        const auto& gpuDesc = mDesc.getArchDesc<Target::gpu, Distribution::spmt>();
+
+        std::vector<int> devices{gpuDesc.devices};
+
+        checkError(cufftXtSetGPUs(mHandle, static_cast<int>(devices.size()), devices.data()));
+
+        if (cufftParams.usePatientJit)
+        {
+#       if CUFFT_VERSION >= 11200
+          checkError(cufftSetPlanPropertyInt64(mHandle, NVFFT_PLAN_PROPERTY_INT64_PATIENT_JIT, 1));
+#       endif
+        }
+
+        if (mDesc.useExternalWorkspace())
+        {
+          checkError(cufftSetAutoAllocation(mHandle, 0));
+        }
+
+        auto n = mDesc.getTransformDimsAs<SizeT>();
+
+        mWorkspaceSizes.resize(devices.size());
+
+        checkError(cufftXtMakePlanMany(mHandle,
+                                       static_cast<int>(mDesc.getTransformRank()),
+                                       n.data(),
+                                       nullptr, 1, 0, getCufftSrcType(),
+                                       nullptr, 1, 0, getCufftDstType(),
+                                       1,
+                                       mWorkspaceSizes.data(),
+                                       getCufftExecutionType()));
+
+        setNormalizationCallback(devices);
+
+        setMemoryBlocks();
+
+        mDesc.fillDefaultMemoryLayoutStrides();
+
+        mSrcXtDesc = makeXtDesc(false);
+
+        if (mDesc.getPlacement() == Placement::outOfPlace)
+        {
+          mDstXtDesc = makeXtDesc(false);
+        }
+        else
+        {
+          mDstXtDesc = makeXtDesc(true);
+
+          mBackendMemorySizes.assign(mDstXtDesc->descriptor->size, mDstXtDesc->descriptor->size + devices.size());
+        }
+      }
+
+      /// @brief Destructor
+      ~Plan() = default;
+
+      /// @brief Inherit assignment operator
+      using Parent::operator=;
+
+      /**
+       * @brief Execute the plan. cuFFT leaves the result in the shuffled order, it is copied to the destination blocks
+       *        in the natural order. In-place plans copy it through an internal buffer.
+       * @param src The source buffers
+       * @param dst The destination buffers
+       * @param execParams The execution parameters
+       */
+      void executeBackendImpl(View<void*> src, View<void*> dst, const afft::spmt::gpu::ExecutionParameters& execParams) override
+      {
+        checkError(cufftSetStream(mHandle, execParams.stream));
+
+        if (mDesc.useExternalWorkspace())
+        {
+          checkError(cufftXtSetWorkArea(mHandle, const_cast<void**>(execParams.workspaces.data())));
+        }
+
+        std::copy(src.begin(), src.end(), mSrcXtDesc->descriptor->data);
+        mSrcXtDesc->subFormat = CUFFT_XT_FORMAT_INPLACE;
+
+        checkError(cufftXtExecDescriptor(mHandle, mSrcXtDesc.get(), mSrcXtDesc.get(), getCufftDirection()));
+
+        if (mDesc.getPlacement() == Placement::outOfPlace)
+        {
+          std::copy(dst.begin(), dst.end(), mDstXtDesc->descriptor->data);
+        }
+
+        checkError(cufftXtMemcpy(mHandle, mDstXtDesc.get(), mSrcXtDesc.get(), CUFFT_COPY_DEVICE_TO_DEVICE));
+
+        if (mDesc.getPlacement() == Placement::inPlace)
+        {
+          const auto& xtDesc = *mDstXtDesc->descriptor;
+
+          for (int i{}; i < xtDesc.nGPUs; ++i)
+          {
+            cuda::ScopedDevice device{xtDesc.GPUs[i]};
+
+            cuda::checkError(cudaMemcpy(dst[static_cast<std::size_t>(i)],
+                                        xtDesc.data[i],
+                                        xtDesc.size[i],
+                                        cudaMemcpyDeviceToDevice));
+          }
+        }
+      }
+
+      /**
+       * @brief Get the workspace size
+       * @return The workspace size for each device
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return View<std::size_t>{mWorkspaceSizes.data(), mWorkspaceSizes.size()};
+      }
+
+      /**
+       * @brief Get the backend memory size
+       * @return The size of the internal buffer of in-place plans for each device
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{mBackendMemorySizes.data(), mBackendMemorySizes.size()};
+      }
+    private:
+      /// @brief The cuFFT multi-GPU descriptor deleter, the buffers attached by afft are detached before freeing.
+      struct XtDescDeleter
+      {
+        void operator()(cudaLibXtDesc* xtDesc) const noexcept
+        {
+          if (!ownsBuffers)
+          {
+            std::fill_n(xtDesc->descriptor->data, xtDesc->descriptor->nGPUs, nullptr);
+          }
+
+          cufftXtFree(xtDesc);
+        }
+
+        bool ownsBuffers;   ///< True if the buffers were allocated by cuFFT.
+      };
+
+      /// @brief Alias for the cuFFT multi-GPU descriptor pointer.
+      using XtDescPtr = std::unique_ptr<cudaLibXtDesc, XtDescDeleter>;
+
+      /// @brief The device memory deleter.
+      struct DeviceMemoryDeleter
+      {
+        void operator()(void* ptr) const noexcept
+        {
+          cudaFree(ptr);
+        }
+      };
+
+      /// @brief Alias for the pointer to the normalization scale in the device memory.
+      using DeviceScalePtr = std::unique_ptr<void, DeviceMemoryDeleter>;
+
+      /**
+       * @brief Make the normalization scale in the memory of the current device.
+       * @param precision The execution precision, f32 or f64.
+       * @param scale The scale.
+       * @return The pointer to the scale.
+       */
+      [[nodiscard]] static DeviceScalePtr makeDeviceScale(Precision precision, double scale)
+      {
+        const float       scaleF32 = static_cast<float>(scale);
+        const void*       scalePtr = (precision == Precision::f32) ? static_cast<const void*>(&scaleF32) : &scale;
+        const std::size_t size     = (precision == Precision::f32) ? sizeof(float) : sizeof(double);
+
+        void* ptr{};
+
+        cuda::checkError(cudaMalloc(&ptr, size));
+
+        DeviceScalePtr deviceScale{ptr};
+
+        cuda::checkError(cudaMemcpy(deviceScale.get(), scalePtr, size, cudaMemcpyHostToDevice));
+
+        return deviceScale;
+      }
+
+      /**
+       * @brief Set the store callback applying the normalization, if any. The callback is compiled through the module
+       *        cache, so it is compiled once per process for each precision and device architecture. The scale is
+       *        passed as the caller info held in the memory of each device.
+       * @param devices The devices of the plan.
+       */
+      void setNormalizationCallback(const std::vector<int>& devices)
+      {
+        if (mDesc.getNormalization() == Normalization::none)
+        {
+          return;
+        }
+
+        const auto precision  = mDesc.getPrecision().execution;
+        const auto complexity = mDesc.getSrcDstComplexity().second;
+        const auto scale      = mDesc.getNormalizationFactor<double>();
+
+        std::vector<void*> callbackPtrs(devices.size());
+        std::vector<void*> callerInfos(devices.size());
+
+        mNormalizationModules.reserve(devices.size());
+        mNormalizationScales.reserve(devices.size());
+
+        for (std::size_t i{}; i < devices.size(); ++i)
+        {
+          cuda::ScopedDevice device{devices[i]};
+
+          std::array options
+          {
+            cuda::rtc::makeDefinitionOption("PRECISION", std::to_string(cxx::to_underlying(precision))),
+            cuda::rtc::makeDefinitionOption("COMPLEXITY", std::to_string(cxx::to_underlying(complexity))),
+            cuda::rtc::makeArchOption(devices[i]),
+            cuda::rtc::makeIncludePathOption(cuda::getIncludePath()),
+          };
+
+          std::array optionPtrs = {options[0].c_str(), options[1].c_str(), options[2].c_str(), options[3].c_str(), "-dc"};
+
+          const auto& module = mNormalizationModules.emplace_back(
+            cuda::ModuleCache::getInstance().get(cuda::ModuleCache::makeKey(callbackSrcCode, optionPtrs),
+                                                 devices[i],
+                                                 [&]()
+          {
+            cuda::rtc::Program program{callbackSrcCode, "cufftCallbackFn.cu"};
+
+            if (!program.compile(optionPtrs))
+            {
+              throw BackendError{Backend::cufft, "failed to compile the normalization callback"};
+            }
+
+            return program.getCode(cuda::rtc::CodeType::CUBIN);
+          }));
+
+          auto [dCallbackPtr, callbackPtrSize] = module.getGlobal(storeCallbackPtrName);
+
+          cuda::checkError(cuMemcpyDtoH(&callbackPtrs[i], dCallbackPtr, callbackPtrSize));
+
+          callerInfos[i] = mNormalizationScales.emplace_back(makeDeviceScale(precision, scale)).get();
+        }
+
+        checkError(cufftXtSetCallback(mHandle,
+                                      callbackPtrs.data(),
+                                      makeStoreCallbackType(precision, complexity),
+                                      callerInfos.data()));
+      }
+
+      /**
+       * @brief Get the slab of the first axis held by a device.
+       * @param size The size of the first axis.
+       * @param count The number of devices.
+       * @param index The device index.
+       * @return The start and size of the slab, the leading devices hold one more element if the size is not divisible.
+       */
+      [[nodiscard]] static constexpr std::pair<std::size_t, std::size_t>
+      getSlab(std::size_t size, std::size_t count, std::size_t index) noexcept
+      {
+        const auto base      = size / count;
+        const auto remainder = size % count;
+
+        return {index * base + std::min(index, remainder), base + ((index < remainder) ? 1 : 0)};
+      }
+
+      /**
+       * @brief Set the default source and destination memory blocks or check the user ones match the cuFFT
+       *        decomposition.
+       */
+      void setMemoryBlocks()
+      {
+        auto&       memLayout   = mDesc.getMemoryLayout<Distribution::spmt>();
+        const auto  shape       = mDesc.getShape();
+        const auto  shapeRank   = mDesc.getShapeRank();
+        const auto  deviceCount = mDesc.getTargetCount();
+
+        if (!memLayout.hasDefaultSrcAxesOrder() || !memLayout.hasDefaultDstAxesOrder())
+        {
+          throw BackendError{Backend::cufft, "custom axes order is not supported"};
+        }
+
+        auto isSlab = [&](View<std::size_t> starts, View<std::size_t> sizes, std::size_t start, std::size_t size)
+        {
+          return starts[0] == start && sizes[0] == size &&
+                 std::all_of(starts.begin() + 1, starts.end(), [](std::size_t s) { return s == 0; }) &&
+                 std::equal(sizes.begin() + 1, sizes.end(), shape.begin() + 1);
+        };
+
+        for (std::size_t i{}; i < deviceCount; ++i)
+        {
+          const auto [start, size] = getSlab(shape[0], deviceCount, i);
+
+          if (memLayout.hasDefaultSrcMemoryBlocks())
+          {
+            auto starts = memLayout.getSrcStartsWritable(i);
+            auto sizes  = memLayout.getSrcSizesWritable(i);
+
+            std::fill_n(starts.begin(), shapeRank, std::size_t{});
+            std::copy_n(shape.begin(), shapeRank, sizes.begin());
+            starts[0] = start;
+            sizes[0]  = size;
+          }
+          else if (!isSlab(memLayout.getSrcStarts(i), memLayout.getSrcSizes(i), start, size))
+          {
+            throw BackendError{Backend::cufft, "source memory blocks must split the first axis as cuFFT does"};
+          }
+
+          if (memLayout.hasDefaultDstMemoryBlocks())
+          {
+            auto starts = memLayout.getDstStartsWritable(i);
+            auto sizes  = memLayout.getDstSizesWritable(i);
+
+            std::fill_n(starts.begin(), shapeRank, std::size_t{});
+            std::copy_n(shape.begin(), shapeRank, sizes.begin());
+            starts[0] = start;
+            sizes[0]  = size;
+          }
+          else if (!isSlab(memLayout.getDstStarts(i), memLayout.getDstSizes(i), start, size))
+          {
+            throw BackendError{Backend::cufft, "destination memory blocks must split the first axis as cuFFT does"};
+          }
+
+          if (!memLayout.hasDefaultSrcStrides(i) || !memLayout.hasDefaultDstStrides(i))
+          {
+            throw BackendError{Backend::cufft, "custom memory block strides are not supported"};
+          }
+        }
+      }
+
+      /**
+       * @brief Make a cuFFT multi-GPU descriptor in the natural order.
+       * @param ownsBuffers If false, the buffers allocated by cuFFT are freed and the user buffers are attached on
+       *                    execution.
+       * @return The descriptor.
+       */
+      [[nodiscard]] XtDescPtr makeXtDesc(bool ownsBuffers)
+      {
+        cudaLibXtDesc* xtDesc{};
+
+        checkError(cufftXtMalloc(mHandle, &xtDesc, CUFFT_XT_FORMAT_INPLACE));
+
+        XtDescPtr xtDescPtr{xtDesc, XtDescDeleter{true}};
+
+        if (!ownsBuffers)
+        {
+          auto& desc = *xtDesc->descriptor;
+
+          for (int i{}; i < desc.nGPUs; ++i)
+          {
+            cuda::ScopedDevice device{desc.GPUs[i]};
+
+            cuda::checkError(cudaFree(desc.data[i]));
+            desc.data[i] = nullptr;
+          }
+
+          xtDescPtr.get_deleter().ownsBuffers = false;
+        }
+
+        return xtDescPtr;
+      }
+
+      std::vector<std::size_t>    mWorkspaceSizes{};       ///< The workspace size for each device.
+      std::vector<std::size_t>    mBackendMemorySizes{};   ///< The internal buffer size for each device.
+      XtDescPtr                   mSrcXtDesc{};            ///< The descriptor the source buffers are attached to.
+      XtDescPtr                   mDstXtDesc{};            ///< The descriptor of the destination, owns the buffers of in-place plans.
+      std::vector<cuda::Module>   mNormalizationModules{}; ///< The modules of the normalization callback for each device.
+      std::vector<DeviceScalePtr> mNormalizationScales{};  ///< The normalization scale for each device.
+  };
+
+  /**
+   * @brief Create a cufft spmt gpu plan implementation.
+   * @param desc Plan description.
+   * @param cufftParams cuFFT parameters.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] AFFT_HEADER_ONLY_INLINE std::unique_ptr<afft::Plan>
+  makePlan(const Desc& desc, const afft::cufft::spmt::gpu::Parameters& cufftParams)
+  {
+    return std::make_unique<Plan>(desc, cufftParams);
+  }
+} // namespace afft::detail::cufft::spmt::gpu
+
+#endif /* AFFT_HEADER_ONLY */
+
+#endif /* AFFT_DETAIL_CUFFT_SPMT_HPP */
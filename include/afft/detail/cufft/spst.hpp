@@ -32,6 +32,7 @@
 #include "common.hpp"
 #include "error.hpp"
 #include "../PlanImpl.hpp"
+#include "../cuda/cuda.hpp"
 
 namespace afft::detail::cufft::spst
 {
@@ -103,6 +104,26 @@ namespace afft::detail::cufft::spst
           checkError(cufftSetAutoAllocation(planImpl->mHandle, 0));
         }
 
+        if (gpuDesc.storeCallback.isEnabled() && desc.getNormalization() != Normalization::none)
+        {
+          throw BackendError{Backend::cufft, "store callback cannot be combined with normalization"};
+        }
+
+        const auto loadComplexity  = (dftDesc.type == dft::Type::realToComplex)
+                                       ? Complexity::real : Complexity::complex;
+        const auto storeComplexity = (dftDesc.type == dft::Type::complexToReal)
+                                       ? Complexity::real : Complexity::complex;
+
+        // LTO callbacks are linked into the FFT kernels, they must be set before the plan is made
+        planImpl->setLtoCallback(gpuDesc.loadCallback,
+                                 makeLoadCallbackType(precision.execution, loadComplexity),
+                                 gpuDesc.device,
+                                 planImpl->mLoadCallbackLtoIr);
+        planImpl->setLtoCallback(gpuDesc.storeCallback,
+                                 makeStoreCallbackType(precision.execution, storeComplexity),
+                                 gpuDesc.device,
+                                 planImpl->mStoreCallbackLtoIr);
+
         std::size_t workspaceSize{};
 
         checkError(cufftXtMakePlanMany(planImpl->mHandle, rank, n.data(),
@@ -110,14 +131,41 @@ namespace afft::detail::cufft::spst
                                        onembed.data(), ostride, odist, outputType,
                                        batch, &workspaceSize, executionType));
 
-        if (dftDesc.type == dft::Type::complexToComplex && std::all_of(n.begin(), n.end(), [](auto size){ return size <= 4096}))
+        planImpl->setCallback(gpuDesc.loadCallback,
+                              makeLoadCallbackType(precision.execution, loadComplexity),
+                              userLoadCallbackPtrName,
+                              gpuDesc.device,
+                              planImpl->mLoadCallbackModule);
+        planImpl->setCallback(gpuDesc.storeCallback,
+                              makeStoreCallbackType(precision.execution, storeComplexity),
+                              userStoreCallbackPtrName,
+                              gpuDesc.device,
+                              planImpl->mStoreCallbackModule);
+
+        // cuFFT supports work area policies only for c2c transforms with all sizes up to 4096
+        if (dftDesc.type == dft::Type::complexToComplex && std::all_of(n.begin(), n.end(), [](auto size){ return size <= 4096; }))
         {
 #       if CUFFT_VERSION >= 9200
+          std::size_t policyWorkspaceSize = cufftParams.userWorkspaceSize;
+
           checkError(cufftXtSetWorkAreaPolicy(planImpl->mHandle,
-                                              makeWorkAreaPolicy(cufftParams.workspacePolicy)),
-                                              &cufftParams.userWorkspaceSize);
+                                              makeWorkAreaPolicy(cufftParams.workspacePolicy),
+                                              &policyWorkspaceSize));
 #       endif
         }
+        else if (cufftParams.workspacePolicy == afft::cufft::WorkspacePolicy::user)
+        {
+          throw BackendError{Backend::cufft, "user workspace policy is supported only for c2c transforms of sizes up to 4096"};
+        }
+
+        // The policy may change the workspace size reported by cufftXtMakePlanMany
+        checkError(cufftGetSize(planImpl->mHandle, &planImpl->mWorkspaceSize));
+
+        if (cufftParams.workspacePolicy == afft::cufft::WorkspacePolicy::user &&
+            planImpl->mWorkspaceSize > cufftParams.userWorkspaceSize)
+        {
+          throw BackendError{Backend::cufft, "plan requires more workspace than the user workspace size"};
+        }
 
         return planImpl;
       }
@@ -177,6 +225,15 @@ namespace afft::detail::cufft::spst
 
         checkError(cufftXtExec(mHandle, src.front(), dst.front(), direction));
       }
+
+      /**
+       * @brief Get the workspace size.
+       * @return The workspace size resulting from the selected workspace policy.
+       */
+      [[nodiscard]] View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return {&mWorkspaceSize, 1};
+      }
     private:
       /// @brief Constructor.
       PlanImpl(const Desc& desc)
@@ -185,7 +242,130 @@ namespace afft::detail::cufft::spst
         checkError(cufftCreate(&mHandle));
       }
 
-      cufftHandle mHandle{}; ///< The cuFFT plan handle.
+      /**
+       * @brief Set the runtime compiled user callback to the plan as an LTO callback. Has no effect if the callback has
+       *        no source code or cuFFT does not support LTO callbacks.
+       * @param callback The callback description.
+       * @param callbackType The cuFFT callback type.
+       * @param device The device.
+       * @param ltoIr The LTO IR of the compiled callback, it is kept for the lifetime of the plan.
+       */
+      void setLtoCallback(const SpstGpuCallbackDesc&      callback,
+                          cufftXtCallbackType             callbackType,
+                          int                             device,
+                          std::optional<cuda::rtc::Code>& ltoIr)
+      {
+        if constexpr (hasLtoCallbacks)
+        {
+          if (callback.srcCode.empty())
+          {
+            return;
+          }
+
+          const cuda::rtc::CppSymbolName functionName{callback.functionName};
+
+          cuda::rtc::Program program{callback.srcCode, "afftUserLtoCallbackFn.cu"};
+          program.addNameExpression(functionName);
+
+          std::array options
+          {
+            cuda::rtc::makeArchOption(device),
+            cuda::rtc::makeIncludePathOption(cuda::getIncludePath()),
+          };
+
+          std::array optionPtrs = {options[0].c_str(), options[1].c_str(), cuda::rtc::ltoOption, "-dc"};
+
+          if (!program.compile(optionPtrs))
+          {
+            throw BackendError{Backend::cufft, "failed to compile user LTO callback function"};
+          }
+
+          ltoIr.emplace(program.getCode(cuda::rtc::CodeType::LTOIR));
+
+          const std::string symbolName{program.getLoweredSymbolName(functionName)};
+
+#       if CUFFT_VERSION >= 11300
+          void* callerInfo = callback.callerInfo;
+
+          checkError(cufftXtSetJITCallback(mHandle,
+                                           symbolName.c_str(),
+                                           ltoIr->data(),
+                                           ltoIr->size(),
+                                           callbackType,
+                                           &callerInfo));
+#       endif
+        }
+      }
+
+      /**
+       * @brief Set the user callback to the plan. Runtime compiled callbacks are skipped if they were set as LTO
+       *        callbacks by setLtoCallback().
+       * @param callback The callback description.
+       * @param callbackType The cuFFT callback type.
+       * @param ptrName The name of the device function pointer in the runtime compiled module.
+       * @param device The device.
+       * @param module The module holding the runtime compiled callback.
+       */
+      void setCallback(const SpstGpuCallbackDesc& callback,
+                       cufftXtCallbackType        callbackType,
+                       cuda::rtc::CSymbolName     ptrName,
+                       int                        device,
+                       cuda::Module&              module)
+      {
+        if (!callback.isEnabled())
+        {
+          return;
+        }
+
+        if (hasLtoCallbacks && !callback.srcCode.empty())
+        {
+          return;
+        }
+
+        void* callbackPtr = callback.devicePtr;
+
+        if (!callback.srcCode.empty())
+        {
+          const std::string srcCode = makeUserCallbackSrcCode(callback.srcCode, callback.functionName, ptrName);
+
+          std::array options
+          {
+            cuda::rtc::makeArchOption(device),
+            cuda::rtc::makeIncludePathOption(cuda::getIncludePath()),
+          };
+
+          std::array optionPtrs = {options[0].c_str(), options[1].c_str(), "-dc"};
+
+          module = cuda::ModuleCache::getInstance().get(cuda::ModuleCache::makeKey(srcCode, optionPtrs),
+                                                        device,
+                                                        [&]()
+          {
+            cuda::rtc::Program program{srcCode, "afftUserCallbackFn.cu"};
+
+            if (!program.compile(optionPtrs))
+            {
+              throw BackendError{Backend::cufft, "failed to compile user callback function"};
+            }
+
+            return program.getCode(cuda::rtc::CodeType::CUBIN);
+          });
+
+          auto [dCallbackPtr, callbackPtrSize] = module.getGlobal(ptrName);
+
+          cuda::checkError(cuMemcpyDtoH(&callbackPtr, dCallbackPtr, callbackPtrSize));
+        }
+
+        void* callerInfo = callback.callerInfo;
+
+        checkError(cufftXtSetCallback(mHandle, &callbackPtr, callbackType, &callerInfo));
+      }
+
+      cufftHandle                    mHandle{};              ///< The cuFFT plan handle.
+      std::size_t                    mWorkspaceSize{};       ///< The workspace size required by the plan.
+      cuda::Module                   mLoadCallbackModule{};  ///< The module containing the runtime compiled user load callback.
+      cuda::Module                   mStoreCallbackModule{}; ///< The module containing the runtime compiled user store callback.
+      std::optional<cuda::rtc::Code> mLoadCallbackLtoIr{};   ///< The LTO IR of the runtime compiled user load callback.
+      std::optional<cuda::rtc::Code> mStoreCallbackLtoIr{};  ///< The LTO IR of the runtime compiled user store callback.
   };
 } // namespace afft::detail::cufft::spst
 
@@ -259,6 +259,28 @@ inline namespace cxx20
     return x && !(x & (x - 1));
   }
 
+  /**
+   * @brief Finds the smallest number of bits needed to represent the given value. Taken from https://en.cppreference.com/w/cpp/numeric/bit_width
+   * @tparam T Type of the value.
+   * @param x Value.
+   * @return 1 + floor(log2(x)) if x is not zero, zero otherwise.
+   */
+  template<typename T>
+  [[nodiscard]] constexpr int bit_width(T x) noexcept
+  {
+    static_assert(std::is_unsigned_v<T>, "T must be an unsigned integral type.");
+    static_assert(!std::is_same_v<T, bool>, "T must not be a boolean type.");
+
+    int width{};
+
+    for (; x != 0; x >>= 1)
+    {
+      ++width;
+    }
+
+    return width;
+  }
+
   /**
    * @brief Finds the first element in the range [first, last) for which the predicate p returns true. Taken from https://en.cppreference.com/w/cpp/algorithm/find
    * @tparam InputIt Iterator type.
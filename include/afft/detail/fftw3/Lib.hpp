@@ -60,6 +60,9 @@ namespace afft::detail::fftw3
 
     static constexpr auto initThreads              = fftwf_init_threads;
     static constexpr auto planWithNThreads         = fftwf_plan_with_nthreads;
+#   ifdef AFFT_FFTW3_HAS_THREADS_CALLBACK
+    static constexpr auto threadsSetCallback       = fftwf_threads_set_callback;
+#   endif
     static constexpr auto importWisdomFromString   = fftwf_import_wisdom_from_string;
 
     static constexpr auto planGuruC2C              = fftwf_plan_guru64_dft;
@@ -106,6 +109,9 @@ namespace afft::detail::fftw3
 
     static constexpr auto initThreads              = fftw_init_threads;
     static constexpr auto planWithNThreads         = fftw_plan_with_nthreads;
+#   ifdef AFFT_FFTW3_HAS_THREADS_CALLBACK
+    static constexpr auto threadsSetCallback       = fftw_threads_set_callback;
+#   endif
     static constexpr auto importWisdomFromString   = fftw_import_wisdom_from_string;
 
     static constexpr auto planGuruC2C              = fftw_plan_guru64_dft;
@@ -152,6 +158,9 @@ namespace afft::detail::fftw3
 
     static constexpr auto initThreads              = fftwl_init_threads;
     static constexpr auto planWithNThreads         = fftwl_plan_with_nthreads;
+#   ifdef AFFT_FFTW3_HAS_THREADS_CALLBACK
+    static constexpr auto threadsSetCallback       = fftwl_threads_set_callback;
+#   endif
     static constexpr auto importWisdomFromString   = fftwl_import_wisdom_from_string;
 
     static constexpr auto planGuruC2C              = fftwl_plan_guru64_dft;
@@ -198,6 +207,9 @@ namespace afft::detail::fftw3
 
     static constexpr auto initThreads              = fftwq_init_threads;
     static constexpr auto planWithNThreads         = fftwq_plan_with_nthreads;
+#   ifdef AFFT_FFTW3_HAS_THREADS_CALLBACK
+    static constexpr auto threadsSetCallback       = fftwq_threads_set_callback;
+#   endif
     static constexpr auto importWisdomFromString   = fftwq_import_wisdom_from_string;
 
     static constexpr auto planGuruC2C              = fftwq_plan_guru64_dft;
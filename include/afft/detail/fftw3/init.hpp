@@ -31,9 +31,27 @@
 
 #include "Lib.hpp"
 #include "../../exception.hpp"
+#include "../../ThreadPool.hpp"
 
 namespace afft::detail::fftw3
 {
+#ifdef AFFT_FFTW3_HAS_THREADS_CALLBACK
+  /**
+   * @brief Parallel loop callback running the FFTW3 jobs on the cpu thread pool shared by all backends.
+   * @param work The job function.
+   * @param jobData The job data array.
+   * @param elemSize The size of one job data element.
+   * @param jobCount The number of jobs.
+   */
+  inline void parallelLoop(void* (*work)(char*), char* jobData, std::size_t elemSize, int jobCount, void*)
+  {
+    afft::cpu::getThreadPool()->parallelFor(static_cast<std::size_t>(jobCount), 0, [&](std::size_t i)
+    {
+      work(jobData + i * elemSize);
+    });
+  }
+#endif
+
   /// @brief Initialize the FFTW3 library.
   inline void init()
   {
@@ -48,6 +66,9 @@ namespace afft::detail::fftw3
 # ifdef AFFT_FFTW3_HAS_FLOAT
 #   ifdef AFFT_FFTW3_HAS_FLOAT_THREADS
     check(Lib<Precision::_float>::initThreads());
+#     ifdef AFFT_FFTW3_HAS_THREADS_CALLBACK
+    Lib<Precision::_float>::threadsSetCallback(parallelLoop, nullptr);
+#     endif
 #   endif
 #   ifdef AFFT_FFTW3_HAS_MPI_FLOAT
     MpiLib<Precision::_float>::init();
@@ -56,6 +77,9 @@ namespace afft::detail::fftw3
 # ifdef AFFT_FFTW3_HAS_DOUBLE
 #   ifdef AFFT_FFTW3_HAS_DOUBLE_THREADS
     check(Lib<Precision::_double>::initThreads());
+#     ifdef AFFT_FFTW3_HAS_THREADS_CALLBACK
+    Lib<Precision::_double>::threadsSetCallback(parallelLoop, nullptr);
+#     endif
 #   endif
 #   ifdef AFFT_FFTW3_HAS_MPI_DOUBLE
     MpiLib<Precision::_double>::init();
@@ -64,6 +88,9 @@ namespace afft::detail::fftw3
 # ifdef AFFT_FFTW3_HAS_LONG
 #   ifdef AFFT_FFTW3_HAS_LONG_THREADS
     check(Lib<Precision::_longDouble>::initThreads());
+#     ifdef AFFT_FFTW3_HAS_THREADS_CALLBACK
+    Lib<Precision::_longDouble>::threadsSetCallback(parallelLoop, nullptr);
+#     endif
 #   endif
 #   ifdef AFFT_FFTW3_HAS_MPI_LONG
     MpiLib<Precision::_longDouble>::init();
@@ -72,6 +99,9 @@ namespace afft::detail::fftw3
 # ifdef AFFT_FFTW3_HAS_QUAD
 #   ifdef AFFT_FFTW3_HAS_QUAD_THREADS
     check(Lib<Precision::_quad>::initThreads());
+#     ifdef AFFT_FFTW3_HAS_THREADS_CALLBACK
+    Lib<Precision::_quad>::threadsSetCallback(parallelLoop, nullptr);
+#     endif
 #   endif
 # endif
   }
@@ -0,0 +1,343 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_HALF_PRECISION_HPP
+#define AFFT_DETAIL_HALF_PRECISION_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "ThreadPool.hpp"
+#include "../common.hpp"
+
+namespace afft::detail::halfPrecision
+{
+  /// @brief Number of elements converted by one work item.
+  inline constexpr std::size_t chunkSize{std::size_t{1} << 16};
+
+  /**
+   * @brief Check if the precision is a 16-bit storage precision.
+   * @param prec Precision.
+   * @return True for f16 and bf16, false otherwise.
+   */
+  [[nodiscard]] constexpr bool isHalf(Precision prec) noexcept
+  {
+    return prec == Precision::f16 || prec == Precision::bf16;
+  }
+
+  /**
+   * @brief Convert an IEEE 754 half precision value to single precision.
+   * @param h Half precision bits.
+   * @return Single precision value.
+   */
+  [[nodiscard]] inline float f16ToF32(std::uint16_t h) noexcept
+  {
+    const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000u) << 16;
+    std::uint32_t       exp  = (h >> 10) & 0x1fu;
+    std::uint32_t       mant = h & 0x3ffu;
+    std::uint32_t       bits{};
+
+    if (exp == 0)
+    {
+      if (mant == 0)
+      {
+        bits = sign;
+      }
+      else
+      {
+        // normalize the subnormal value
+        exp = 113;
+
+        while ((mant & 0x400u) == 0)
+        {
+          mant <<= 1;
+          --exp;
+        }
+
+        bits = sign | (exp << 23) | ((mant & 0x3ffu) << 13);
+      }
+    }
+    else if (exp == 0x1f)
+    {
+      // NaNs are quieted like the hardware conversions do
+      bits = sign | 0x7f800000u | (mant << 13) | ((mant != 0) ? 0x400000u : 0u);
+    }
+    else
+    {
+      bits = sign | ((exp + 112) << 23) | (mant << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  /**
+   * @brief Convert a single precision value to IEEE 754 half precision, rounding to nearest even.
+   * @param value Single precision value.
+   * @return Half precision bits.
+   */
+  [[nodiscard]] inline std::uint16_t f32ToF16(float value) noexcept
+  {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const auto          sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+    const std::uint32_t absx = bits & 0x7fffffffu;
+
+    if (absx >= 0x7f800000u)
+    {
+      return static_cast<std::uint16_t>(sign | 0x7c00u | ((absx > 0x7f800000u) ? 0x200u : 0u));
+    }
+    else if (absx >= 0x477ff000u)
+    {
+      // rounds to infinity
+      return static_cast<std::uint16_t>(sign | 0x7c00u);
+    }
+    else if (absx < 0x38800000u)
+    {
+      if (absx < 0x33000000u)
+      {
+        return sign;
+      }
+
+      // subnormal result
+      const std::uint32_t exp    = absx >> 23;
+      const std::uint32_t mant   = (absx & 0x7fffffu) | 0x800000u;
+      const std::uint32_t shift  = 126 - exp;
+      std::uint32_t       result = mant >> shift;
+      const std::uint32_t rem    = mant & ((1u << shift) - 1);
+      const std::uint32_t half   = 1u << (shift - 1);
+
+      if (rem > half || (rem == half && (result & 1u)))
+      {
+        ++result;
+      }
+
+      return static_cast<std::uint16_t>(sign | result);
+    }
+
+    const std::uint32_t rebiased = absx - 0x38000000u;
+    std::uint32_t       result   = rebiased >> 13;
+    const std::uint32_t rem      = rebiased & 0x1fffu;
+
+    // a carry out of the mantissa correctly increments the exponent
+    if (rem > 0x1000u || (rem == 0x1000u && (result & 1u)))
+    {
+      ++result;
+    }
+
+    return static_cast<std::uint16_t>(sign | result);
+  }
+
+  /**
+   * @brief Convert a bfloat16 value to single precision.
+   * @param h Bfloat16 bits.
+   * @return Single precision value.
+   */
+  [[nodiscard]] inline float bf16ToF32(std::uint16_t h) noexcept
+  {
+    const std::uint32_t bits = static_cast<std::uint32_t>(h) << 16;
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  /**
+   * @brief Convert a single precision value to bfloat16, rounding to nearest even. NaNs stay quiet NaNs.
+   * @param value Single precision value.
+   * @return Bfloat16 bits.
+   */
+  [[nodiscard]] inline std::uint16_t f32ToBf16(float value) noexcept
+  {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    if ((bits & 0x7fffffffu) > 0x7f800000u)
+    {
+      return static_cast<std::uint16_t>((bits >> 16) | 0x40u);
+    }
+
+    return static_cast<std::uint16_t>((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+  }
+
+  /**
+   * @brief Widen a chunk of 16-bit values to single precision.
+   * @param prec Precision of the source, f16 or bf16.
+   * @param src Source bits.
+   * @param dst Destination values.
+   * @param count Number of values.
+   */
+  inline void widenChunk(Precision prec, const std::uint16_t* src, float* dst, std::size_t count) noexcept
+  {
+    std::size_t i{};
+
+    if (prec == Precision::f16)
+    {
+#   if defined(__F16C__)
+      for (; i + 8 <= count; i += 8)
+      {
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+      }
+#   elif defined(__ARM_NEON) && defined(__aarch64__)
+      for (; i + 4 <= count; i += 4)
+      {
+        vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+      }
+#   endif
+
+      for (; i < count; ++i)
+      {
+        dst[i] = f16ToF32(src[i]);
+      }
+    }
+    else
+    {
+#   if defined(__AVX2__)
+      for (; i + 8 <= count; i += 8)
+      {
+        const __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+
+        _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16)));
+      }
+#   elif defined(__ARM_NEON)
+      for (; i + 4 <= count; i += 4)
+      {
+        vst1q_f32(dst + i, vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(src + i), 16)));
+      }
+#   endif
+
+      for (; i < count; ++i)
+      {
+        dst[i] = bf16ToF32(src[i]);
+      }
+    }
+  }
+
+  /**
+   * @brief Narrow a chunk of single precision values to 16 bits, rounding to nearest even.
+   * @param prec Precision of the destination, f16 or bf16.
+   * @param src Source values.
+   * @param dst Destination bits.
+   * @param count Number of values.
+   */
+  inline void narrowChunk(Precision prec, const float* src, std::uint16_t* dst, std::size_t count) noexcept
+  {
+    std::size_t i{};
+
+    if (prec == Precision::f16)
+    {
+#   if defined(__F16C__)
+      for (; i + 8 <= count; i += 8)
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+      }
+#   elif defined(__ARM_NEON) && defined(__aarch64__)
+      for (; i + 4 <= count; i += 4)
+      {
+        vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+      }
+#   endif
+
+      for (; i < count; ++i)
+      {
+        dst[i] = f32ToF16(src[i]);
+      }
+    }
+    else
+    {
+#   if defined(__AVX2__)
+      const __m256i roundBias = _mm256_set1_epi32(0x7fff);
+      const __m256i one       = _mm256_set1_epi32(1);
+      const __m256i quietBit  = _mm256_set1_epi32(0x40);
+
+      for (; i + 8 <= count; i += 8)
+      {
+        const __m256  value   = _mm256_loadu_ps(src + i);
+        const __m256i bits    = _mm256_castps_si256(value);
+        const __m256i lsb     = _mm256_and_si256(_mm256_srli_epi32(bits, 16), one);
+        const __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(bits, _mm256_add_epi32(roundBias, lsb)), 16);
+        const __m256i quiet   = _mm256_or_si256(_mm256_srli_epi32(bits, 16), quietBit);
+        const __m256i isNan   = _mm256_castps_si256(_mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+        const __m256i result  = _mm256_blendv_epi8(rounded, quiet, isNan);
+
+        // the pack works within the 128-bit lanes, the lanes are reordered afterwards
+        const __m256i packed  = _mm256_permute4x64_epi64(_mm256_packus_epi32(result, result), 0xd8);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(packed));
+      }
+#   endif
+
+      for (; i < count; ++i)
+      {
+        dst[i] = f32ToBf16(src[i]);
+      }
+    }
+  }
+
+  /**
+   * @brief Widen 16-bit values to single precision in parallel.
+   * @param prec Precision of the source, f16 or bf16.
+   * @param src Source buffer.
+   * @param dst Destination buffer, must not overlap the source.
+   * @param count Number of values.
+   * @param threadCount Maximum number of threads, 0 for the thread pool size.
+   */
+  inline void widen(Precision prec, const void* src, float* dst, std::size_t count, std::size_t threadCount)
+  {
+    const auto* srcBits = static_cast<const std::uint16_t*>(src);
+
+    parallelFor((count + chunkSize - 1) / chunkSize, threadCount, [&](std::size_t chunk)
+    {
+      const std::size_t offset = chunk * chunkSize;
+
+      widenChunk(prec, srcBits + offset, dst + offset, std::min(chunkSize, count - offset));
+    });
+  }
+
+  /**
+   * @brief Narrow single precision values to 16 bits in parallel.
+   * @param prec Precision of the destination, f16 or bf16.
+   * @param src Source buffer.
+   * @param dst Destination buffer, must not overlap the source.
+   * @param count Number of values.
+   * @param threadCount Maximum number of threads, 0 for the thread pool size.
+   */
+  inline void narrow(Precision prec, const float* src, void* dst, std::size_t count, std::size_t threadCount)
+  {
+    auto* dstBits = static_cast<std::uint16_t*>(dst);
+
+    parallelFor((count + chunkSize - 1) / chunkSize, threadCount, [&](std::size_t chunk)
+    {
+      const std::size_t offset = chunk * chunkSize;
+
+      narrowChunk(prec, src + offset, dstBits + offset, std::min(chunkSize, count - offset));
+    });
+  }
+} // namespace afft::detail::halfPrecision
+
+#endif /* AFFT_DETAIL_HALF_PRECISION_HPP */
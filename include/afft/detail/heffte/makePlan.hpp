@@ -35,34 +35,61 @@
 namespace afft::detail::heffte
 {
   /**
-   * @brief Create a plan implementation.
-   * @tparam BackendParamsT Backend parameters type.
+   * @brief Check if the plan may be supported by the heffte backend, without any side effects.
    * @param desc Plan description.
-   * @param backendParams Backend parameters.
-   * @return Plan implementation.
+   * @return Backend support, the reason of the rejection if the plan is not supported.
    */
-  template<typename BackendParamsT>
-  [[nodiscard]] std::unique_ptr<Plan>
-  makePlan(const Desc& desc, const BackendParamsT& backendParams)
+  [[nodiscard]] inline BackendSupport supports(const Desc& desc)
   {
     if (desc.getComplexFormat() != ComplexFormat::interleaved)
     {
-      throw BackendError{Backend::heffte, "only interleaved complex format is supported"};
+      return BackendSupport{"only interleaved complex format is supported"};
     }
 
     if (!desc.hasUniformPrecision())
     {
-      throw BackendError{Backend::heffte, "only same precision for execution, source and destination is supported"};
+      return BackendSupport{"only same precision for execution, source and destination is supported"};
     }
 
     if (desc.getTransform() != Transform::dft)
     {
-      throw BackendError{Backend::heffte, "only DFT transform is supported"};
+      return BackendSupport{"only DFT transform is supported"};
     }
 
     if (desc.getPlacement() != Placement::outOfPlace)
     {
-      throw BackendError{Backend::heffte, "only out-of-place placement is supported"};
+      return BackendSupport{"only out-of-place placement is supported"};
+    }
+
+    if (desc.getDistribution() != Distribution::mpst)
+    {
+      return BackendSupport{"only mpst distribution is supported"};
+    }
+
+#if !defined(AFFT_ENABLE_CUDA) && !defined(AFFT_ENABLE_HIP)
+    if (desc.getTarget() == Target::gpu)
+    {
+      return BackendSupport{"unsupported GPU backend, only CUDA and HIP are supported"};
+    }
+#endif
+
+    return BackendSupport{};
+  }
+
+  /**
+   * @brief Create a plan implementation.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Plan description.
+   * @param backendParams Backend parameters.
+   * @return Plan implementation.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] std::unique_ptr<Plan>
+  makePlan(const Desc& desc, const BackendParamsT& backendParams)
+  {
+    if (const auto support = supports(desc); !support)
+    {
+      throw BackendError{Backend::heffte, support.reason};
     }
 
     if constexpr (backendParams.distribution == Distribution::mpst)
@@ -78,9 +105,6 @@ namespace afft::detail::heffte
 #       else
         throw BackendError{Backend::heffte, "unsupported GPU backend, only CUDA and HIP are supported"};
 #       endif
-#     else
-        throw BackendError{Backend::heffte, "gpu support is not enabled"};
-#     endif
       }
       else
       {
@@ -89,7 +113,7 @@ namespace afft::detail::heffte
     }
     else
     {
-      throw BackendError{Backend::heffte, "only spst distribution is supported"};
+      throw BackendError{Backend::heffte, "only mpst distribution is supported"};
     }
   }
 } // namespace afft::detail::heffte
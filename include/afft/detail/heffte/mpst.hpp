@@ -30,6 +30,10 @@
 #endif
 
 #include "Plan.hpp"
+#include "../../ThreadPool.hpp"
+#if defined(AFFT_ENABLE_FFTW3)
+# include "../fftw3/Lib.hpp"
+#endif
 
 namespace afft::detail::heffte::mpst
 {
@@ -66,6 +70,12 @@ namespace afft::detail::heffte::mpst
 
       /// @brief Alias for the backward destination type.
       using BwdDstT = std::conditional_t<fwdCmpl == Complexity::complex, C, R>;
+
+      /// @brief Number of untimed executions of each candidate when selecting the plan options.
+      static constexpr std::size_t measureWarmupRunCount{1};
+
+      /// @brief Number of timed executions of each candidate, the fastest one is taken.
+      static constexpr std::size_t measureRunCount{2};
     public:
       /// @brief Inherit constructor.
       using Parent::Parent;
@@ -78,15 +88,31 @@ namespace afft::detail::heffte::mpst
       template<typename HeffteParamsT>
       Plan(const Desc& desc, const HeffteParamsT& heffteParams)
       : Parent{desc},
-        mPlan{makePlan(desc, heffteParams)},
-        mBatch{1}, // TODO
+        mPlanOptions{selectPlanOptions(desc, heffteParams, mBackendFeedback)},
+        mPlan{makePlan(desc, mPlanOptions, getComm(desc))},
+        mBatch{makeBatch(desc)},
         mWorkspaceSize{mBatch * mPlan.size_workspace() * sizeof(C)}
       {
         mDesc.fillDefaultMemoryLayoutStrides();
+
+        if constexpr (std::is_same_v<HeffteParamsT, afft::mpst::cpu::heffte::Parameters>)
+        {
+          if (heffteParams.pipelineChunkCount > 1)
+          {
+            makeChunks(heffteParams.pipelineChunkCount);
+          }
+        }
       }
 
-      /// @brief Default destructor.
-      ~Plan() = default;
+      /// @brief Destructor, frees the communicators of the chunks.
+      ~Plan()
+      {
+        for (auto& chunk : mChunks)
+        {
+          chunk.plan.reset();
+          MPI_Comm_free(&chunk.comm);
+        }
+      }
 
       /// @brief Inherit assignment operator.
       using Parent::operator=;
@@ -96,6 +122,15 @@ namespace afft::detail::heffte::mpst
         return View<std::size_t>{&mWorkspaceSize, 1};
       }
 
+      /**
+       * @brief Get the backend feedback.
+       * @return The automatically selected plan options, empty if not selected automatically.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        return mBackendFeedback;
+      }
+
       /**
        * @brief Execute the plan.
        * @param src The source buffers.
@@ -106,11 +141,22 @@ namespace afft::detail::heffte::mpst
         -> AFFT_RET_REQUIRES(void, AFFT_PARAM(HeffteBackend == ::heffte::backend::fftw || \
                                               HeffteBackend == ::heffte::backend::mkl))
       {
-        executeBackendImplAny(src, dst, execParams.workspace);
+        // the planner thread count is global, it is set once for the chunks executed concurrently
+        ScopedLocalThreads localThreads{getLocalThreadCount(), true};
+
+        if (mChunks.empty())
+        {
+          executeBackendImplAny(mPlan, mBatch, src, dst, execParams.workspace);
+        }
+        else
+        {
+          executeChunks(src, dst, execParams.workspace);
+        }
       }
 
       /**
-       * @brief Execute the plan.
+       * @brief Execute the plan. The plan for a non-default stream is created on its first use, the creation is
+       *        collective, so all the processes have to execute the plan on a new stream together.
        * @param src The source buffers.
        * @param dst The destination buffers.
        * @param execParams The execution parameters.
@@ -120,83 +166,483 @@ namespace afft::detail::heffte::mpst
         -> AFFT_RET_REQUIRES(void, AFFT_PARAM(HeffteBackend == ::heffte::backend::cufft || \
                                               HeffteBackend == ::heffte::backend::rocfft))
       {
-#     if defined(AFFT_ENABLE_CUDA)
-        if (exceParams.stream != cudaStream_t{0})
-        {
-          throw BackendError{Backend::heffte, "execution can be launched only to the default stream"};
-        }
-#     elif defined(AFFT_ENABLE_HIP)
-        if (exceParams.stream != hipStream_t{0})
-        {
-          throw BackendError{Backend::heffte, "execution can be launched only to the default stream"};
-        }
-#     endif
+        HefftePlan& plan = (execParams.stream == Stream{0}) ? mPlan : getStreamPlan(execParams.stream);
 
-        executeBackendImplAny(src, dst, execParams.workspace);
+        executeBackendImplAny(plan, mBatch, src, dst, execParams.workspace);
       }
 #   endif
     private:
       /// @brief The heffte plan type.
-      using HefftePlan = std::conditional_t<dftType == dft::Type::complexToComplex,
+      using HefftePlan = std::conditional_t<fwdCmpl == Complexity::complex,
                                             ::heffte::fft3d<HeffteBackend, Index>,
                                             ::heffte::fft3d_r2c<HeffteBackend, Index>>;
 
+#   if defined(AFFT_ENABLE_CUDA)
+      /// @brief The stream type.
+      using Stream = cudaStream_t;
+#   elif defined(AFFT_ENABLE_HIP)
+      /// @brief The stream type.
+      using Stream = hipStream_t;
+#   endif
+
       /**
-       * @brief The heffte plan factory.
+       * @brief Sets the threads of the local transforms of the calling thread for its scope. HeFFTe plans the FFTW3
+       *        transforms on their first execution, so the planner thread count is set and the transforms run on the
+       *        afft cpu thread pool. MKL transforms run on the MKL threads of the calling thread. The local threads
+       *        never call MPI, all the communication is funneled through the executing thread.
+       */
+      class ScopedLocalThreads
+      {
+        public:
+          /**
+           * @brief Constructor, sets the local threads.
+           * @param threadCount The thread count of the local transforms.
+           * @param setPlanner Set the global FFTW3 planner thread count too.
+           */
+          ScopedLocalThreads(unsigned threadCount, bool setPlanner)
+          : mSetPlanner{setPlanner}
+          {
+            if (mSetPlanner)
+            {
+              setPlannerThreadCount(threadCount);
+            }
+
+#         if defined(AFFT_ENABLE_MKL)
+            if constexpr (std::is_same_v<HeffteBackend, ::heffte::backend::mkl>)
+            {
+              mPrevMklThreadCount = mkl_set_num_threads_local(safeIntCast<int>(threadCount));
+            }
+#         endif
+          }
+
+          /// @brief Copy constructor is deleted.
+          ScopedLocalThreads(const ScopedLocalThreads&) = delete;
+
+          /// @brief Destructor, restores the previous local threads.
+          ~ScopedLocalThreads()
+          {
+#         if defined(AFFT_ENABLE_MKL)
+            if constexpr (std::is_same_v<HeffteBackend, ::heffte::backend::mkl>)
+            {
+              mkl_set_num_threads_local(mPrevMklThreadCount);
+            }
+#         endif
+
+            if (mSetPlanner)
+            {
+              setPlannerThreadCount(1);
+            }
+          }
+
+          /// @brief Copy assignment operator is deleted.
+          ScopedLocalThreads& operator=(const ScopedLocalThreads&) = delete;
+        private:
+          /**
+           * @brief Set the FFTW3 planner thread count of the precision, the threads run by the afft thread pool
+           *        callback. Does nothing unless the FFTW3 backend of afft provides the threads.
+           * @param threadCount The thread count.
+           */
+          static void setPlannerThreadCount([[maybe_unused]] unsigned threadCount)
+          {
+            if constexpr (std::is_same_v<HeffteBackend, ::heffte::backend::fftw>)
+            {
+#           if defined(AFFT_ENABLE_FFTW3) && defined(AFFT_FFTW3_HAS_THREADS_CALLBACK)
+              if constexpr (std::is_same_v<PrecT, float>)
+              {
+#             ifdef AFFT_FFTW3_HAS_FLOAT_THREADS
+                afft::detail::fftw3::Lib<Precision::_float>::planWithNThreads(safeIntCast<int>(threadCount));
+#             endif
+              }
+              else
+              {
+#             ifdef AFFT_FFTW3_HAS_DOUBLE_THREADS
+                afft::detail::fftw3::Lib<Precision::_double>::planWithNThreads(safeIntCast<int>(threadCount));
+#             endif
+              }
+#           endif
+            }
+          }
+
+          bool mSetPlanner{};         ///< The planner thread count is set by the scope.
+          int  mPrevMklThreadCount{}; ///< The previous MKL thread count of the calling thread.
+      };
+
+      /// @brief A part of the batch transformed by its own plan and communicator.
+      struct Chunk
+      {
+        MPI_Comm                    comm{MPI_COMM_NULL}; ///< The duplicated communicator.
+        std::unique_ptr<HefftePlan> plan{};              ///< The heffte plan.
+        Index                       offset{};            ///< The offset of the chunk in the batch.
+        Index                       batch{};             ///< The batch size of the chunk.
+      };
+
+      /**
+       * @brief Select the heffte plan options.
        * @tparam HeffteParamsT The heffte parameters type.
        * @param desc The plan description.
        * @param heffteParams The heffte parameters.
-       * @return The heffte plan.
+       * @param feedback The feedback describing the automatically selected options.
+       * @return The plan options.
        */
       template<typename HeffteParamsT>
-      [[nodiscard]] static HefftePlan makePlan(const Desc& desc, const HeffteParamsT& heffteParams)
+      [[nodiscard]] static ::heffte::plan_options
+      selectPlanOptions(const Desc& desc, const HeffteParamsT& heffteParams, std::string& feedback)
       {
-        const auto r2cAxis = desc.getTransformAxes().back();
+        if constexpr (std::is_same_v<HeffteParamsT, afft::mpst::cpu::heffte::Parameters>)
+        {
+          if (heffteParams.autoSelect)
+          {
+            return measurePlanOptions(desc, feedback);
+          }
+        }
 
-        const auto& memLayout = desc.getMemoryLayout<Distribution::mpst>();
+        ::heffte::plan_options options{heffteParams.useReorder, heffteParams.useAllToAll, heffteParams.usePencils};
+
+        if constexpr (std::is_same_v<HeffteParamsT, afft::mpst::gpu::heffte::Parameters>)
+        {
+          switch (desc.getArchDesc<Target::gpu, Distribution::mpst>().transport)
+          {
+          case Transport::hostStaged:
+            options.use_gpu_aware = false;
+            break;
+          case Transport::gpuAware:
+            options.use_gpu_aware = true;
+            break;
+          default:
+            throw BackendError{Backend::heffte, "only host staged and GPU aware MPI transports are supported"};
+          }
+        }
+
+        return options;
+      }
+
+      /**
+       * @brief Select the fastest plan options by measuring the forward transform of each candidate. Slab
+       *        decompositions are skipped when the grid is too small to give each process a slab. The measured times
+       *        are reduced over the communicator, so all the processes select the same options.
+       * @param desc The plan description.
+       * @param feedback The feedback describing the selected options.
+       * @return The plan options.
+       */
+      [[nodiscard]] static ::heffte::plan_options measurePlanOptions(const Desc& desc, std::string& feedback)
+      {
+        const auto comm        = getComm(desc);
+        const auto howManyRank = desc.getShapeRank() - desc.getTransformRank();
+        const auto batch       = makeBatch(desc);
+
+        int commSize{};
+        MPI_Comm_size(comm, &commSize);
+
+        // A slab decomposition splits one axis into the processes and transposes it with the second one
+        MaxDimArray<std::size_t> extents{};
+        const auto transformShape = desc.getShape().subspan(howManyRank);
+        std::copy(transformShape.begin(), transformShape.end(), extents.begin());
+        std::sort(extents.begin(), extents.begin() + transformShape.size(), std::greater<>{});
 
-        const Box srcBox = makeBox(desc, memLayout.getSrcStarts(), memLayout.getSrcSizes());
-        const Box dstBox = makeBox(desc, memLayout.getDstStarts(), memLayout.getDstSizes());
+        const bool canUseSlabs = transformShape.size() >= 2 && extents[1] >= static_cast<std::size_t>(commSize);
 
-        MPI_Comm comm{MPI_COMM_NULL};
+        ::heffte::plan_options bestOptions{true, true, true};
+        double                 bestTime{std::numeric_limits<double>::infinity()};
 
+        for (const bool usePencils : {false, true})
+        {
+          if (!usePencils && !canUseSlabs)
+          {
+            continue;
+          }
+
+          for (const bool useAllToAll : {true, false})
+          {
+            for (const bool useReorder : {true, false})
+            {
+              const ::heffte::plan_options options{useReorder, useAllToAll, usePencils};
+
+              HefftePlan plan = makePlan(desc, options, comm);
+
+              std::vector<FwdSrcT> src(plan.size_inbox() * batch);
+              std::vector<FwdDstT> dst(plan.size_outbox() * batch);
+              std::vector<C>       workspace(plan.size_workspace() * batch);
+
+              double time{std::numeric_limits<double>::infinity()};
+
+              for (std::size_t run{}; run < measureWarmupRunCount + measureRunCount; ++run)
+              {
+                MPI_Barrier(comm);
+
+                const double start = MPI_Wtime();
+
+                safeCall([&]
+                {
+                  plan.forward(batch, src.data(), dst.data(), workspace.data());
+                });
+
+                if (run >= measureWarmupRunCount)
+                {
+                  time = std::min(time, MPI_Wtime() - start);
+                }
+              }
+
+              MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+              if (time < bestTime)
+              {
+                bestTime    = time;
+                bestOptions = options;
+              }
+            }
+          }
+        }
+
+        feedback = std::string{(bestOptions.use_pencils) ? "pencil" : "slab"} + " decomposition, " +
+                   ((bestOptions.use_alltoall) ? "all-to-all" : "point-to-point") +
+                   " exchange, " + ((bestOptions.use_reorder) ? "with" : "without") + " reorder, measured " +
+                   std::to_string(bestTime) + " s";
+
+        return bestOptions;
+      }
+
+      /**
+       * @brief Get the communicator of the plan description.
+       * @param desc The plan description.
+       * @return The communicator.
+       */
+      [[nodiscard]] static MPI_Comm getComm(const Desc& desc)
+      {
         switch (desc.getTarget())
         {
         case Target::cpu:
-          comm = desc.getArchDesc<Target::cpu, Distribution::mpst>().comm;
-          break;
+          return desc.getArchDesc<Target::cpu, Distribution::mpst>().comm;
         case Target::gpu:
-          comm = desc.getArchDesc<Target::gpu, Distribution::mpst>().comm;
-          break;
+          return desc.getArchDesc<Target::gpu, Distribution::mpst>().comm;
         default:
           cxx::unreachable();
         }
+      }
 
-        const ::heffte::plan_options heffteOptions{heffteParams.useReorder,
-                                                   heffteParams.useAllToAll,
-                                                   heffteParams.usePencils};
+      /**
+       * @brief The heffte plan factory.
+       * @tparam StreamT The stream type, the plan is created for the default stream if not given.
+       * @param desc The plan description.
+       * @param heffteOptions The heffte plan options.
+       * @param comm The communicator.
+       * @param stream The stream the plan is launched to.
+       * @return The heffte plan.
+       */
+      template<typename... StreamT>
+      [[nodiscard]] static HefftePlan
+      makePlan(const Desc& desc, const ::heffte::plan_options& heffteOptions, MPI_Comm comm, StreamT... stream)
+      {
+        static_assert(sizeof...(StreamT) <= 1, "at most one stream can be given");
 
-        safeCall([&]
+        // The leading omitted axes are the batch, the boxes span only the transformed axes
+        const auto howManyRank = desc.getShapeRank() - desc.getTransformRank();
+
+        const auto r2cAxis = desc.getTransformAxes().back() - howManyRank;
+
+        const auto& memLayout = desc.getMemoryLayout<Distribution::mpst>();
+
+        const Box srcBox = makeBox(memLayout.getSrcStarts().subspan(howManyRank),
+                                   memLayout.getSrcSizes().subspan(howManyRank));
+        const Box dstBox = makeBox(memLayout.getDstStarts().subspan(howManyRank),
+                                   memLayout.getDstSizes().subspan(howManyRank));
+
+        return safeCall([&]
         {
-          if constexpr (fwdCmpl == dft::Type::complexToComplex)
+          if constexpr (fwdCmpl == Complexity::complex)
           {
-            return HefftePlan{srcBox, dstBox, comm, r2cAxis, heffteOptions};
+            return HefftePlan{stream..., srcBox, dstBox, comm, heffteOptions};
           }
           else
           {
-            return HefftePlan{srcBox, dstBox, comm, heffteOptions};
+            return HefftePlan{stream..., srcBox, dstBox, static_cast<int>(r2cAxis), comm, heffteOptions};
           }
         });
       }
 
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      /**
+       * @brief Get the plan launched to the stream, creates it on the first use.
+       * @param stream The stream.
+       * @return The heffte plan.
+       */
+      [[nodiscard]] HefftePlan& getStreamPlan(Stream stream)
+      {
+        auto it = mStreamPlans.find(stream);
+
+        if (it == mStreamPlans.end())
+        {
+          it = mStreamPlans.emplace(stream, std::make_unique<HefftePlan>(makePlan(mDesc, mPlanOptions, getComm(mDesc), stream))).first;
+        }
+
+        return *it->second;
+      }
+#   endif
+
+      /**
+       * @brief Make the batch size from the omitted axes. HeFFTe expects the batch of boxes stored one after another,
+       *        so the omitted axes have to precede the transformed axes and cannot be distributed.
+       * @param desc The plan description.
+       * @return The batch size.
+       */
+      [[nodiscard]] static Index makeBatch(const Desc& desc)
+      {
+        const auto shape         = desc.getShape();
+        const auto transformAxes = desc.getTransformAxes();
+        const auto howManyRank   = desc.getShapeRank() - desc.getTransformRank();
+
+        const auto& memLayout = desc.getMemoryLayout<Distribution::mpst>();
+
+        Index batch{1};
+
+        for (std::size_t axis{}; axis < howManyRank; ++axis)
+        {
+          if (std::find(transformAxes.begin(), transformAxes.end(), axis) != transformAxes.end())
+          {
+            throw BackendError{Backend::heffte, "omitted axes must precede the transformed axes"};
+          }
+
+          if (memLayout.getSrcStarts()[axis] != 0 || memLayout.getSrcSizes()[axis] != shape[axis] ||
+              memLayout.getDstStarts()[axis] != 0 || memLayout.getDstSizes()[axis] != shape[axis])
+          {
+            throw BackendError{Backend::heffte, "omitted axes cannot be distributed"};
+          }
+
+          batch *= safeIntCast<Index>(shape[axis]);
+        }
+
+        return batch;
+      }
+
+      /**
+       * @brief Split the batch into chunks, each one gets a plan on a duplicated communicator, so the chunks can be
+       *        transformed concurrently. The exchange of one chunk then overlaps the local transforms of the others.
+       *        Requires MPI_THREAD_MULTIPLE.
+       * @param chunkCount The number of chunks.
+       */
+      void makeChunks(std::size_t chunkCount)
+      {
+        int threadLevel{};
+        MPI_Query_thread(&threadLevel);
+
+        if (threadLevel < MPI_THREAD_MULTIPLE)
+        {
+          throw BackendError{Backend::heffte, "pipelining requires MPI initialized with MPI_THREAD_MULTIPLE"};
+        }
+
+        const auto count = std::min(safeIntCast<Index>(chunkCount), mBatch);
+
+        mChunks.resize(count);
+
+        for (Index i{}, offset{}; i < count; ++i)
+        {
+          auto& chunk = mChunks[i];
+
+          chunk.offset = offset;
+          chunk.batch  = mBatch / count + ((i < mBatch % count) ? 1 : 0);
+
+          if (MPI_Comm_dup(getComm(mDesc), &chunk.comm) != MPI_SUCCESS)
+          {
+            throw BackendError{Backend::heffte, "failed to duplicate the communicator"};
+          }
+
+          chunk.plan = std::make_unique<HefftePlan>(makePlan(mDesc, mPlanOptions, chunk.comm));
+
+          offset += chunk.batch;
+        }
+      }
+
+      /**
+       * @brief Get the thread count of the local transforms of one chunk. The thread limit, the afft cpu thread pool
+       *        size if zero, is shared by the chunks executed concurrently.
+       * @return The thread count, at least one.
+       */
+      [[nodiscard]] unsigned getLocalThreadCount() const
+      {
+        const unsigned threadLimit = mDesc.getArchDesc<Target::cpu, Distribution::mpst>().threadLimit;
+
+        const std::size_t threadCount = (threadLimit != 0) ? threadLimit : afft::cpu::getThreadPool()->getThreadCount();
+
+        return static_cast<unsigned>(std::max(threadCount / std::max(mChunks.size(), std::size_t{1}), std::size_t{1}));
+      }
+
+      /**
+       * @brief Execute the chunks concurrently, the first chunk is executed by the calling thread.
+       * @param src The source buffers.
+       * @param dst The destination buffers.
+       * @param workspace The execution workspace, split between the chunks.
+       */
+      void executeChunks(View<void*> src, View<void*> dst, void* workspace)
+      {
+        const bool isForward = (mDesc.getDirection() == Direction::forward);
+
+        const std::size_t srcElemSize = (isForward) ? sizeof(FwdSrcT) : sizeof(BwdSrcT);
+        const std::size_t dstElemSize = (isForward) ? sizeof(FwdDstT) : sizeof(BwdDstT);
+
+        const std::size_t srcBoxSize = (isForward) ? mPlan.size_inbox() : mPlan.size_outbox();
+        const std::size_t dstBoxSize = (isForward) ? mPlan.size_outbox() : mPlan.size_inbox();
+
+        std::vector<std::exception_ptr> errors(mChunks.size());
+
+        const unsigned threadCount = getLocalThreadCount();
+
+        auto executeChunk = [&](std::size_t i)
+        {
+          const auto& chunk = mChunks[i];
+
+          ScopedLocalThreads localThreads{threadCount, false};
+
+          void* chunkSrc = static_cast<std::byte*>(src.front()) + chunk.offset * srcBoxSize * srcElemSize;
+          void* chunkDst = static_cast<std::byte*>(dst.front()) + chunk.offset * dstBoxSize * dstElemSize;
+          void* chunkWorkspace = (workspace != nullptr)
+            ? static_cast<std::byte*>(workspace) + chunk.offset * mPlan.size_workspace() * sizeof(C) : nullptr;
+
+          try
+          {
+            executeBackendImplAny(*chunk.plan,
+                                  chunk.batch,
+                                  View<void*>{&chunkSrc, 1},
+                                  View<void*>{&chunkDst, 1},
+                                  chunkWorkspace);
+          }
+          catch (...)
+          {
+            errors[i] = std::current_exception();
+          }
+        };
+
+        std::vector<std::thread> threads{};
+        threads.reserve(mChunks.size() - 1);
+
+        for (std::size_t i{1}; i < mChunks.size(); ++i)
+        {
+          threads.emplace_back(executeChunk, i);
+        }
+
+        executeChunk(0);
+
+        for (auto& thread : threads)
+        {
+          thread.join();
+        }
+
+        for (const auto& error : errors)
+        {
+          if (error)
+          {
+            std::rethrow_exception(error);
+          }
+        }
+      }
+
       /**
        * @brief Execute the plan.
+       * @param plan The heffte plan.
+       * @param batch The batch size.
        * @param src The source buffers.
        * @param dst The destination buffers.
        * @param workspace The execution workspace.
        */
-      template<typename ExecParamsT>
-      void executeBackendImplAny(View<void*> src, View<void*> dst, void* workspace)
+      void executeBackendImplAny(HefftePlan& plan, Index batch, View<void*> src, View<void*> dst, void* workspace)
       {
         safeCall([&]
         {
@@ -208,35 +654,35 @@ namespace afft::detail::heffte::mpst
           case Direction::forward:
             if (useExternalWorkspace)
             {
-              mPlan.forward(mBatch,
-                            reinterpret_cast<FwdSrcT*>(src.first()),
-                            reinterpret_cast<FwdDstT*>(dst.first()),
-                            reinterpret_cast<C*>(execParams.workspace),
-                            scale);
+              plan.forward(batch,
+                           reinterpret_cast<FwdSrcT*>(src.first()),
+                           reinterpret_cast<FwdDstT*>(dst.first()),
+                           reinterpret_cast<C*>(workspace),
+                           scale);
             }
             else
             {
-              mPlan.forward(mBatch,
-                            reinterpret_cast<FwdSrcT*>(src.first()),
-                            reinterpret_cast<FwdDstT*>(dst.first()),
-                            scale);
+              plan.forward(batch,
+                           reinterpret_cast<FwdSrcT*>(src.first()),
+                           reinterpret_cast<FwdDstT*>(dst.first()),
+                           scale);
             }
             break;
           case Direction::inverse:
             if (useExternalWorkspace)
             {
-              mPlan.backward(mBatch,
-                             reinterpret_cast<BwdSrcT*>(src.first()),
-                             reinterpret_cast<BwdDstT*>(dst.first()),
-                             reinterpret_cast<C*>(execParams.workspace),
-                             scale);
+              plan.backward(batch,
+                            reinterpret_cast<BwdSrcT*>(src.first()),
+                            reinterpret_cast<BwdDstT*>(dst.first()),
+                            reinterpret_cast<C*>(workspace),
+                            scale);
             }
             else
             {
-              mPlan.backward(mBatch,
-                             reinterpret_cast<BwdSrcT*>(src.first()),
-                             reinterpret_cast<BwdDstT*>(dst.first()),
-                             scale);
+              plan.backward(batch,
+                            reinterpret_cast<BwdSrcT*>(src.first()),
+                            reinterpret_cast<BwdDstT*>(dst.first()),
+                            scale);
             }
             break;
           default:
@@ -245,9 +691,15 @@ namespace afft::detail::heffte::mpst
         });
       }
 
-      HefftePlan  mPlan;            ///< The heffte plan.
-      Index       mBatch{1};        ///< The batch size.
-      std::size_t mWorkspaceSize{}; ///< The workspace size.
+      std::string            mBackendFeedback{}; ///< The feedback describing the selected plan options.
+      ::heffte::plan_options mPlanOptions;       ///< The heffte plan options.
+      HefftePlan             mPlan;              ///< The heffte plan launched to the default stream.
+      Index                  mBatch{1};          ///< The batch size, the product of the omitted axes.
+      std::size_t            mWorkspaceSize{};   ///< The workspace size for the whole batch.
+      std::vector<Chunk>     mChunks{};          ///< The pipelined chunks of the batch, empty if not pipelined.
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      std::unordered_map<Stream, std::unique_ptr<HefftePlan>> mStreamPlans{}; ///< The heffte plans launched to non-default streams.
+#   endif
   };
 
   template<typename HeffteBackend, typename HeffteParamsT>
@@ -28,6 +28,7 @@
 #include "device.hpp"
 #include "error.hpp"
 #include "init.hpp"
+#include "memory.hpp"
 
 namespace afft::detail::hip
 {
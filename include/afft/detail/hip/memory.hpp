@@ -0,0 +1,79 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_HIP_MEMORY_HPP
+#define AFFT_DETAIL_HIP_MEMORY_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "error.hpp"
+
+namespace afft::detail::hip
+{
+  /**
+   * @brief Check if the pointer points to managed memory.
+   * @param ptr The pointer.
+   * @return True if the pointer points to managed memory, false otherwise.
+   */
+  [[nodiscard]] inline bool isManagedMemory(const void* ptr)
+  {
+    hipPointerAttribute_t attributes{};
+
+    if (hipPointerGetAttributes(&attributes, ptr) != hipSuccess)
+    {
+      // unregistered host memory is reported as an error, clear it
+      static_cast<void>(hipGetLastError());
+      return false;
+    }
+
+    return attributes.type == hipMemoryTypeManaged;
+  }
+
+  /**
+   * @brief Prefetch the managed memory to the device on the stream, does nothing for other memory.
+   * @param ptr The pointer.
+   * @param size The size in bytes.
+   * @param device The device.
+   * @param stream The stream.
+   * @param advise Advise the device as the preferred location of the memory.
+   */
+  inline void prefetchManagedMemory(const void* ptr, std::size_t size, int device, hipStream_t stream, bool advise)
+  {
+    if (ptr == nullptr || size == 0 || !isManagedMemory(ptr))
+    {
+      return;
+    }
+
+    if (advise)
+    {
+      checkError(hipMemAdvise(ptr, size, hipMemAdviseSetPreferredLocation, device));
+    }
+
+    checkError(hipMemPrefetchAsync(ptr, size, device, stream));
+  }
+} // namespace afft::detail::hip
+
+#endif /* AFFT_DETAIL_HIP_MEMORY_HPP */
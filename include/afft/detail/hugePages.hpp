@@ -0,0 +1,159 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_HUGE_PAGES_HPP
+#define AFFT_DETAIL_HUGE_PAGES_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "cxx.hpp"
+#include "../common.hpp"
+
+namespace afft::detail::hugePages
+{
+  /// @brief Transparent huge page size.
+  inline constexpr std::size_t transparentPageSize{std::size_t{1} << 21};
+
+  /**
+   * @brief Get the page size of the policy.
+   * @param policy The huge page policy.
+   * @return The page size in bytes, 0 for regular pages.
+   */
+  [[nodiscard]] constexpr std::size_t getPageSize(HugePagePolicy policy) noexcept
+  {
+    switch (policy)
+    {
+    case HugePagePolicy::none:        return 0;
+    case HugePagePolicy::transparent: return transparentPageSize;
+    case HugePagePolicy::huge2MiB:    return std::size_t{1} << 21;
+    case HugePagePolicy::huge1GiB:    return std::size_t{1} << 30;
+    default:
+      cxx::unreachable();
+    }
+  }
+
+  /**
+   * @brief Get the size of the mapping holding the given size.
+   * @param size The size in bytes.
+   * @param policy The huge page policy, must not be none.
+   * @return The size rounded up to whole pages of the policy, at least one page.
+   */
+  [[nodiscard]] constexpr std::size_t getMappedSize(std::size_t size, HugePagePolicy policy) noexcept
+  {
+    const auto pageSize = getPageSize(policy);
+
+    return std::max((size + pageSize - 1) / pageSize, std::size_t{1}) * pageSize;
+  }
+
+  /**
+   * @brief Map memory backed by huge pages. Explicit huge pages are taken from the preallocated pool, if the pool is
+   *        exhausted the memory is advised to be backed by transparent huge pages instead.
+   * @param size The size in bytes.
+   * @param policy The huge page policy, must not be none.
+   * @return The memory aligned to at least transparentPageSize, release it with unmap().
+   */
+  [[nodiscard]] inline void* map(std::size_t size, HugePagePolicy policy)
+  {
+    const auto mappedSize = getMappedSize(size, policy);
+
+#   if defined(__linux__)
+#     if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    if (policy == HugePagePolicy::huge2MiB || policy == HugePagePolicy::huge1GiB)
+    {
+      const int hugeFlag = (policy == HugePagePolicy::huge2MiB) ? (21 << MAP_HUGE_SHIFT) : (30 << MAP_HUGE_SHIFT);
+
+      void* ptr = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | hugeFlag, -1, 0);
+
+      if (ptr != MAP_FAILED)
+      {
+        return ptr;
+      }
+    }
+#     endif
+
+    // over-map to align the memory to the transparent huge page size and unmap the excess
+    const auto reservedSize = mappedSize + transparentPageSize;
+
+    void* reserved = ::mmap(nullptr, reservedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (reserved == MAP_FAILED)
+    {
+      throw std::bad_alloc{};
+    }
+
+    const auto reservedAddr = reinterpret_cast<std::uintptr_t>(reserved);
+    const auto alignedAddr  = (reservedAddr + transparentPageSize - 1) / transparentPageSize * transparentPageSize;
+    const auto headSize     = static_cast<std::size_t>(alignedAddr - reservedAddr);
+    const auto tailSize     = reservedSize - headSize - mappedSize;
+
+    if (headSize > 0)
+    {
+      ::munmap(reserved, headSize);
+    }
+
+    if (tailSize > 0)
+    {
+      ::munmap(reinterpret_cast<void*>(alignedAddr + mappedSize), tailSize);
+    }
+
+    void* ptr = reinterpret_cast<void*>(alignedAddr);
+
+#     if defined(MADV_HUGEPAGE)
+    // the advice is a hint, transparent huge pages may be disabled
+    ::madvise(ptr, mappedSize, MADV_HUGEPAGE);
+#     endif
+
+    return ptr;
+#   else
+    return ::operator new(mappedSize, std::align_val_t{transparentPageSize});
+#   endif
+  }
+
+  /**
+   * @brief Unmap the memory mapped by map().
+   * @param ptr The memory.
+   * @param size The size in bytes passed to map().
+   * @param policy The huge page policy passed to map().
+   */
+  inline void unmap(void* ptr, std::size_t size, HugePagePolicy policy) noexcept
+  {
+    if (ptr == nullptr)
+    {
+      return;
+    }
+
+#   if defined(__linux__)
+    ::munmap(ptr, getMappedSize(size, policy));
+#   else
+    static_cast<void>(size);
+    static_cast<void>(policy);
+
+    ::operator delete(ptr, std::align_val_t{transparentPageSize});
+#   endif
+  }
+} // namespace afft::detail::hugePages
+
+#endif /* AFFT_DETAIL_HUGE_PAGES_HPP */
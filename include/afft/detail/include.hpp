@@ -34,22 +34,36 @@ import std;
 # else
 #   include <algorithm>
 #   include <array>
+#   include <atomic>
 #   include <bitset>
+#   include <cctype>
 #   include <cfloat>
 #   include <chrono>
 #   include <cinttypes>
 #   include <climits>
+#   include <cmath>
 #   include <complex>
+#   include <condition_variable>
+#   ifdef AFFT_CXX_HAS_COROUTINE
+#     include <coroutine>
+#   endif
 #   include <cstddef>
 #   include <cstdint>
 #   include <cstdio>
+#   include <cstdlib>
+#   include <cstring>
+#   include <deque>
+#   include <fstream>
 #   include <functional>
+#   include <future>
 #   include <limits>
 #   include <list>
 #   include <memory>
+#   include <mutex>
 #   include <new>
 #   include <numeric>
 #   include <optional>
+#   include <random>
 #   ifdef AFFT_CXX_HAS_SPAN
 #     include <span>
 #   else
@@ -62,6 +76,7 @@ import std;
 #   endif
 #   include <string>
 #   include <string_view>
+#   include <thread>
 #   include <tuple>
 #   include <type_traits>
 #   include <typeinfo>
@@ -72,11 +87,39 @@ import std;
 # endif
 #endif
 
+// Include platform headers used for NUMA placement, thread pinning and file mapping
+#if defined(__linux__)
+# include <fcntl.h>
+# include <linux/mempolicy.h>
+# include <pthread.h>
+# include <sched.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+// Include SIMD intrinsics used by the cpu layout kernels, x86 kernels may be built for a wider target than the flags
+#if defined(__AVX2__) || ((defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)))
+# include <immintrin.h>
+#elif defined(__ARM_NEON)
+# include <arm_neon.h>
+#endif
+
+// Include cpu feature detection headers
+#if defined(__aarch64__) && defined(__linux__)
+# include <asm/hwcap.h>
+# include <sys/auxv.h>
+#endif
+
 // Include GPU backend headers
 #if defined(AFFT_ENABLE_CUDA)
 # include <cuda.h>
 # include <cuda_runtime.h>
 # include <nvrtc.h>
+# if defined(AFFT_ENABLE_GDS)
+#   include <cufile.h>
+# endif
 #elif defined(AFFT_ENABLE_HIP)
 # include <hip/hip_runtime.h>
 #elif defined(AFFT_ENABLE_OPENCL)
@@ -85,11 +128,47 @@ import std;
 # else
 #   include <CL/cl.h>
 # endif
+#elif defined(AFFT_ENABLE_SYCL)
+# include <sycl/sycl.hpp>
 #endif
 
 // Include multi-processing backend headers
 #if defined(AFFT_ENABLE_MPI)
 # include <mpi.h>
+# if defined(OPEN_MPI) && OPEN_MPI
+#   include <mpi-ext.h>
+# endif
+#endif
+
+// Include the range annotation headers, NVTX for CUDA, roctx for HIP and ITT otherwise
+#if defined(AFFT_ENABLE_TRACING)
+# if defined(AFFT_ENABLE_CUDA)
+#   include <nvtx3/nvToolsExt.h>
+# elif defined(AFFT_ENABLE_HIP)
+#   include <roctracer/roctx.h>
+# else
+#   include <ittnotify.h>
+# endif
+#endif
+
+// Include the Linux perf_event headers, the hardware counters of the cpu executions are sampled
+#if defined(AFFT_ENABLE_COUNTERS)
+# if !defined(__linux__)
+#   error "Hardware performance counters require Linux perf_event"
+# endif
+# include <dirent.h>
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+#endif
+
+// Include the stdexec header, the execute senders become P2300 senders
+#ifdef AFFT_ENABLE_STDEXEC
+# include <stdexec/execution.hpp>
+#endif
+
+// Include the DLPack header, the tensors are described in afft terms
+#ifdef AFFT_ENABLE_DLPACK
+# include <dlpack/dlpack.h>
 #endif
 
 #ifdef AFFT_HEADER_ONLY
@@ -135,6 +214,12 @@ import std;
  // Include MKL header
 # ifdef AFFT_ENABLE_MKL
 #   include <mkl.h>
+#   ifdef AFFT_MKL_HAS_CDFT
+#     include <mkl_cdft.h>
+#   endif
+#   ifdef AFFT_ENABLE_SYCL
+#     include <oneapi/mkl/dft.hpp>
+#   endif
 # endif
 
  // Include PocketFFT header
@@ -30,6 +30,7 @@
 #endif
 
 #include "architecture.hpp"
+#include "cpuFeatures.hpp"
 #include "../backend.hpp"
 
 #ifdef AFFT_ENABLE_MPI
@@ -66,6 +67,12 @@
 
 namespace afft::detail
 {
+  /**
+   * @brief Library initializer. The core is initialized by init(), each backend (and the platform it depends on) is
+   *        initialized lazily on its first use or eagerly via init(BackendMask). A backend whose initialization
+   *        fails (e.g. a GPU backend on a node without a GPU) is remembered as unavailable until finalize(), so later
+   *        uses are rejected without retrying the initialization. All methods are thread-safe.
+   */
   class Initializer
   {
     public:
@@ -86,67 +93,96 @@ namespace afft::detail
       }
 
       /**
-       * @brief Initialize the library.
+       * @brief Initialize the library. The backends in the mask are initialized eagerly, the rest on their first use.
+       * @param eagerBackends Backends to initialize immediately. Backends that are not enabled are ignored.
        */
-      void init()
+      void init(BackendMask eagerBackends = BackendMask::empty)
       {
-        // std::scoped_lock lock{mMutex};
+        std::scoped_lock lock{mMutex};
 
-        if (isInitialized())
+        if (!isInitialized())
         {
-          return;
+          // detect the cpu features before the first plan so that the planning does not pay for it
+          static_cast<void>(cpuFeatures::get());
+
+          mTimeStamp = Clock::now();
         }
 
-        initImpl();
+        for (std::size_t i{}; i < backendCount; ++i)
+        {
+          const auto backend = static_cast<Backend>(BackendMaskUnderlyingType{1} << i);
+
+          if ((eagerBackends & backend) != BackendMask::empty)
+          {
+            initBackendImpl(backend);
+          }
+        }
       }
 
       /**
-       * @brief Finalize the library.
+       * @brief Initialize a backend if it has not been initialized yet. Called before the backend is first used.
+       * @param backend Backend to initialize.
        */
-      void finalize()
+      void initBackend(Backend backend)
       {
-        // std::unique_lock lock{mMutex};
-
-        // mCondition.wait(lock, [this]() { return mActiveThreads != 0; });
-
-        if (!isInitialized())
+        if ((mInitializedBackends.load(std::memory_order_acquire) & backendBit(backend)) != 0)
         {
           return;
         }
 
-        finalizeImpl();
+        std::scoped_lock lock{mMutex};
+
+        initBackendImpl(backend);
       }
 
       /**
-       * @brief Get the time stamp of the initialization.
-       * @return The time stamp of the initialization.
+       * @brief Check if a backend has been initialized.
+       * @param backend Backend to check.
+       * @return True if the backend has been initialized, false otherwise.
        */
-      [[nodiscard]] TimeStamp getTimeStamp()
+      [[nodiscard]] bool isBackendInitialized(Backend backend) const
       {
-        // std::scoped_lock lock{mMutex};
+        return (mInitializedBackends.load(std::memory_order_acquire) & backendBit(backend)) != 0;
+      }
 
-        return mTimeStamp;
+      /**
+       * @brief Check if a backend failed to initialize.
+       * @param backend Backend to check.
+       * @return True if the backend initialization failed, false otherwise.
+       */
+      [[nodiscard]] bool isBackendUnavailable(Backend backend)
+      {
+        std::scoped_lock lock{mMutex};
+
+        return (mFailedBackends & backendBit(backend)) != 0;
       }
 
       /**
-       * @brief Increment the number of active plans.
+       * @brief Finalize the library. Only the backends and platforms that were initialized are finalized.
        */
-      // void incrementActiveThreads()
-      // {
-      //   std::scoped_lock lock{mMutex};
+      void finalize()
+      {
+        std::scoped_lock lock{mMutex};
 
-      //   incrementActiveThreadsImpl();
-      // }
+        if (!isInitialized() && mInitializedBackends.load(std::memory_order_relaxed) == 0)
+        {
+          mFailedBackends = 0;
+          return;
+        }
+
+        finalizeImpl();
+      }
 
       /**
-       * @brief Decrement the number of active plans.
+       * @brief Get the time stamp of the initialization.
+       * @return The time stamp of the initialization.
        */
-      // void decrementActivePlans()
-      // {
-      //   std::scoped_lock lock{mMutex};
+      [[nodiscard]] TimeStamp getTimeStamp()
+      {
+        std::scoped_lock lock{mMutex};
 
-      //   decrementActiveThreadsImpl();
-      // }
+        return mTimeStamp;
+      }
     private:
       /// @brief Default constructor.
       Initializer() = default;
@@ -160,15 +196,7 @@ namespace afft::detail
       /// @brief Destructor finalizing the library if it was initialized.
       ~Initializer()
       {
-        // Do not lock the mutex here to avoid deadlocks.
-
         finalize();
-
-        // Notify all waiting potentially blocking threads.
-        // mCondition.notify_all();
-
-        // Wait for all threads to finish.
-        // std::unique_lock lock{mMutex};
       }
 
       /// @brief Deleted copy assignment operator.
@@ -177,6 +205,33 @@ namespace afft::detail
       /// @brief Deleted move assignment operator.
       Initializer& operator=(Initializer&&) = delete;
 
+      /**
+       * @brief Get the bit of a backend.
+       * @param backend Backend.
+       * @return The bit of the backend.
+       */
+      [[nodiscard]] static constexpr BackendMaskUnderlyingType backendBit(Backend backend)
+      {
+        return static_cast<BackendMaskUnderlyingType>(backend);
+      }
+
+      /**
+       * @brief Get the index of a backend.
+       * @param backend Backend.
+       * @return The index of the backend.
+       */
+      [[nodiscard]] static constexpr std::size_t backendIndex(Backend backend)
+      {
+        std::size_t index{};
+
+        for (auto bit = backendBit(backend); bit > 1; bit >>= 1)
+        {
+          ++index;
+        }
+
+        return index;
+      }
+
       /**
        * @brief Check if the library is initialized. Requires the mutex to be locked.
        * @return True if the library is initialized, false otherwise.
@@ -187,49 +242,157 @@ namespace afft::detail
       }
 
       /**
-       * @brief Initialize the library implementation. Requires the mutex to be locked.
+       * @brief Initialize the MPI platform if it is needed and has not been initialized yet. Requires the mutex to be
+       *        locked.
        */
-      void initImpl()
+      void initMpi()
       {
 #     ifdef AFFT_ENABLE_MPI
-        mpi::init();
+        if (!mMpiInitialized)
+        {
+          mpi::init();
+          mMpiInitialized = true;
+        }
 #     endif
+      }
 
-#     if defined(AFFT_ENABLE_CUDA)
-        cuda::init();
-#     elif defined(AFFT_ENABLE_HIP)
-        hip::init();
-#     elif defined(AFFT_ENABLE_OPENCL)
-        opencl::init();
-#     endif
+      /**
+       * @brief Initialize the gpu platform if it has not been initialized yet. Requires the mutex to be locked.
+       */
+      void initGpu()
+      {
+        if (!mGpuInitialized)
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          cuda::init();
+#       elif defined(AFFT_ENABLE_HIP)
+          hip::init();
+#       elif defined(AFFT_ENABLE_OPENCL)
+          opencl::init();
+#       endif
+          mGpuInitialized = true;
+        }
+      }
 
-#     ifdef AFFT_ENABLE_CLFFT
-        clfft::init();
-#     endif
-#     ifdef AFFT_ENABLE_CUFFT
-        cufft::init();
-#     endif
-#     ifdef AFFT_ENABLE_FFTW3
-        fftw3::init();
-#     endif
-#     ifdef AFFT_ENABLE_HEFFTE
-        heffte::init();
-#     endif
-#     ifdef AFFT_ENABLE_HIPFFT
-        hipfft::init();
-#     endif
-#     ifdef AFFT_ENABLE_MKL
-        mkl::init();
-#     endif
-#     ifdef AFFT_ENABLE_POCKETFFT
-        pocketfft::init();
-#     endif
-#     ifdef AFFT_ENABLE_ROCFFT
-        rocfft::init();
-#     endif
-#     ifdef AFFT_ENABLE_VKFFT
-        vkfft::init();
-#     endif
+      /**
+       * @brief Initialize a backend and the platforms it depends on. Requires the mutex to be locked. If the
+       *        initialization throws, the backend is marked unavailable and the failure is rethrown on every use until
+       *        the library is finalized.
+       * @param backend Backend to initialize.
+       */
+      void initBackendImpl(Backend backend)
+      {
+        const auto bit = backendBit(backend);
+
+        if ((mInitializedBackends.load(std::memory_order_relaxed) & bit) != 0)
+        {
+          return;
+        }
+
+        if ((mFailedBackends & bit) != 0)
+        {
+          throw std::runtime_error{mFailureMessages[backendIndex(backend)]};
+        }
+
+        try
+        {
+          if (initBackendAndPlatforms(backend))
+          {
+            mInitializedBackends.fetch_or(bit, std::memory_order_release);
+          }
+        }
+        catch (const std::exception& e)
+        {
+          mFailedBackends |= bit;
+          mFailureMessages[backendIndex(backend)] = std::string{"backend initialization failed: "} + e.what();
+          throw;
+        }
+      }
+
+      /**
+       * @brief Initialize a backend and the platforms it depends on. Requires the mutex to be locked.
+       * @param backend Backend to initialize.
+       * @return True if the backend is enabled and was initialized, false if it is not enabled.
+       */
+      [[nodiscard]] bool initBackendAndPlatforms(Backend backend)
+      {
+        bool enabled{};
+
+        switch (backend)
+        {
+#       ifdef AFFT_ENABLE_CLFFT
+        case Backend::clfft:
+          initGpu();
+          clfft::init();
+          enabled = true;
+          break;
+#       endif
+#       ifdef AFFT_ENABLE_CUFFT
+        case Backend::cufft:
+          initGpu();
+          cufft::init();
+          enabled = true;
+          break;
+#       endif
+#       ifdef AFFT_ENABLE_FFTW3
+        case Backend::fftw3:
+#         if defined(AFFT_FFTW3_HAS_MPI_FLOAT) || defined(AFFT_FFTW3_HAS_MPI_DOUBLE) || defined(AFFT_FFTW3_HAS_MPI_LONG)
+          initMpi();
+#         endif
+          fftw3::init();
+          enabled = true;
+          break;
+#       endif
+#       ifdef AFFT_ENABLE_HEFFTE
+        case Backend::heffte:
+          initMpi();
+          heffte::init();
+          enabled = true;
+          break;
+#       endif
+#       ifdef AFFT_ENABLE_HIPFFT
+        case Backend::hipfft:
+          initGpu();
+          hipfft::init();
+          enabled = true;
+          break;
+#       endif
+#       ifdef AFFT_ENABLE_MKL
+        case Backend::mkl:
+          mkl::init();
+          enabled = true;
+          break;
+#       endif
+#       ifdef AFFT_ENABLE_POCKETFFT
+        case Backend::pocketfft:
+          pocketfft::init();
+          enabled = true;
+          break;
+#       endif
+#       ifdef AFFT_ENABLE_ROCFFT
+        case Backend::rocfft:
+          initGpu();
+          rocfft::init();
+          enabled = true;
+          break;
+#       endif
+#       ifdef AFFT_ENABLE_VKFFT
+        case Backend::vkfft:
+          initGpu();
+          vkfft::init();
+          enabled = true;
+          break;
+#       endif
+#       ifdef AFFT_ENABLE_CODELET
+        case Backend::codelet:
+          enabled = true;
+          break;
+#       endif
+        default:
+          break;
+        }
+
+        return enabled;
       }
 
       /**
@@ -237,83 +400,73 @@ namespace afft::detail
        */
       void finalizeImpl()
       {
+        [[maybe_unused]] const auto initialized = mInitializedBackends.load(std::memory_order_relaxed);
+
+        [[maybe_unused]] auto wasInitialized = [initialized](Backend backend)
+        {
+          return (initialized & backendBit(backend)) != 0;
+        };
+
 #     ifdef AFFT_ENABLE_CLFFT
-        clfft::finalize();
+        if (wasInitialized(Backend::clfft)) clfft::finalize();
 #     endif
 #     ifdef AFFT_ENABLE_CUFFT
-        cufft::finalize();
+        if (wasInitialized(Backend::cufft)) cufft::finalize();
 #     endif
 #     ifdef AFFT_ENABLE_FFTW3
-        fftw3::finalize();
+        if (wasInitialized(Backend::fftw3)) fftw3::finalize();
 #     endif
 #     ifdef AFFT_ENABLE_HEFFTE
-        heffte::finalize();
+        if (wasInitialized(Backend::heffte)) heffte::finalize();
 #     endif
 #     ifdef AFFT_ENABLE_HIPFFT
-        hipfft::finalize();
+        if (wasInitialized(Backend::hipfft)) hipfft::finalize();
 #     endif
 #     ifdef AFFT_ENABLE_MKL
-        mkl::finalize();
+        if (wasInitialized(Backend::mkl)) mkl::finalize();
 #     endif
 #     ifdef AFFT_ENABLE_POCKETFFT
-        pocketfft::finalize();
+        if (wasInitialized(Backend::pocketfft)) pocketfft::finalize();
 #     endif
 #     ifdef AFFT_ENABLE_ROCFFT
-        rocfft::finalize();
+        if (wasInitialized(Backend::rocfft)) rocfft::finalize();
 #     endif
 #     ifdef AFFT_ENABLE_VKFFT
-        vkfft::finalize();
+        if (wasInitialized(Backend::vkfft)) vkfft::finalize();
 #     endif
 
-#     if defined(AFFT_ENABLE_CUDA)
-        cuda::finalize();
-#     elif defined(AFFT_ENABLE_HIP)
-        hip::finalize();
-#     elif defined(AFFT_ENABLE_OPENCL)
-        opencl::finalize();
-#     endif
+        if (mGpuInitialized)
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          cuda::finalize();
+#       elif defined(AFFT_ENABLE_HIP)
+          hip::finalize();
+#       elif defined(AFFT_ENABLE_OPENCL)
+          opencl::finalize();
+#       endif
+        }
 
 #     ifdef AFFT_ENABLE_MPI
-        mpi::finalize();
+        if (mMpiInitialized)
+        {
+          mpi::finalize();
+        }
 #     endif
 
-        mTimeStamp   = TimeStamp{};
-        // mActiveThreads = 0;
+        mInitializedBackends.store(0, std::memory_order_release);
+        mFailedBackends = 0;
+        mGpuInitialized = false;
+        mMpiInitialized = false;
+        mTimeStamp      = TimeStamp{};
       }
 
-      /**
-       * @brief Increment the number of active threads implementation. Requires the mutex to be locked.
-       */
-      // void incrementActiveThreadsImpl()
-      // {
-      //   if (!isInitialized())
-      //   {
-      //     initImpl();
-      //   }
-
-      //   ++mActiveThreads;
-      // }
-
-      /**
-       * @brief Decrement the number of active threads implementation. Requires the mutex to be locked.
-       */
-      // void decrementActiveThreadsImpl()
-      // {
-      //   if (mActiveThreads > 0)
-      //   {
-      //     --mActiveThreads;
-      //   }
-
-      //   if (mActiveThreads == 0)
-      //   {
-      //     mCondition.notify_all();
-      //   }
-      // }
-
-      // std::mutex              mMutex{};         ///< Mutex.
-      // std::atomic_size_t      mActiveThreads{}; ///< Disable finalize flag. 
-      TimeStamp               mTimeStamp{};     ///< Time stamp of the initialization.
-      // std::condition_variable mCondition{};     ///< Condition variable.
+      std::mutex                             mMutex{};               ///< Mutex guarding the initialization state.
+      std::atomic<BackendMaskUnderlyingType> mInitializedBackends{}; ///< Bits of the initialized backends.
+      BackendMaskUnderlyingType              mFailedBackends{};      ///< Bits of the backends that failed to initialize.
+      std::array<std::string, backendCount>  mFailureMessages{};     ///< Initialization failure messages.
+      bool                                   mGpuInitialized{};      ///< Gpu platform initialized flag.
+      bool                                   mMpiInitialized{};      ///< MPI platform initialized flag.
+      TimeStamp                              mTimeStamp{};           ///< Time stamp of the initialization.
   };
 } // namespace afft::detail
 
@@ -30,9 +30,33 @@
 #endif
 
 #include "common.hpp"
+#include "AlignmentDispatchPlan.hpp"
+#include "BatchCountPlan.hpp"
+#include "BluesteinPlan.hpp"
 #include "Desc.hpp"
+#include "FullSpectrumPlan.hpp"
+#include "HartleyPlan.hpp"
+#include "init.hpp"
+#include "InPlaceDstPlan.hpp"
+#include "InterleavedPlan.hpp"
+#include "MixedPrecisionPlan.hpp"
+#include "MixedTransformPlan.hpp"
+#include "ProgressivePlan.hpp"
+#include "RealPairPlan.hpp"
+#include "ShiftedPlan.hpp"
+#include "SixStepPlan.hpp"
+#include "SlabPlan.hpp"
+#include "SparseLinePlan.hpp"
+#include "TransposedPlan.hpp"
+#include "UnpaddedRealPlan.hpp"
+#include "tuning.hpp"
+#include "WindowedDstPlan.hpp"
+#include "ZeroPaddedPlan.hpp"
+#include "../alloc.hpp"
 #include "../Plan.hpp"
 #include "../backend.hpp"
+#include "../trace.hpp"
+#include "../tuning.hpp"
 
 #ifdef AFFT_ENABLE_CLFFT
 # include "clfft/makePlan.hpp"
@@ -61,6 +85,9 @@
 #ifdef AFFT_ENABLE_VKFFT
 # include "vkfft/makePlan.hpp"
 #endif
+#ifdef AFFT_ENABLE_CODELET
+# include "codelet/makePlan.hpp"
+#endif
 
 namespace afft::detail
 {
@@ -121,6 +148,48 @@ namespace afft::detail
     }
   }
 
+  /**
+   * @brief Get the mask of the backends enabled in the build.
+   * @return Enabled backend mask.
+   */
+  [[nodiscard]] constexpr BackendMask getEnabledBackendMask()
+  {
+    BackendMask mask{BackendMask::empty};
+
+# ifdef AFFT_ENABLE_CLFFT
+    mask = mask | Backend::clfft;
+# endif
+# ifdef AFFT_ENABLE_CUFFT
+    mask = mask | Backend::cufft;
+# endif
+# ifdef AFFT_ENABLE_FFTW3
+    mask = mask | Backend::fftw3;
+# endif
+# ifdef AFFT_ENABLE_HEFFTE
+    mask = mask | Backend::heffte;
+# endif
+# ifdef AFFT_ENABLE_HIPFFT
+    mask = mask | Backend::hipfft;
+# endif
+# ifdef AFFT_ENABLE_MKL
+    mask = mask | Backend::mkl;
+# endif
+# ifdef AFFT_ENABLE_POCKETFFT
+    mask = mask | Backend::pocketfft;
+# endif
+# ifdef AFFT_ENABLE_ROCFFT
+    mask = mask | Backend::rocfft;
+# endif
+# ifdef AFFT_ENABLE_VKFFT
+    mask = mask | Backend::vkfft;
+# endif
+# ifdef AFFT_ENABLE_CODELET
+    mask = mask | Backend::codelet;
+# endif
+
+    return mask;
+  }
+
   /**
    * @brief Get supported backend mask for the specified target and distribution.
    * @tparam target Target.
@@ -163,6 +232,50 @@ namespace afft::detail
     cxx::unreachable();
   }
 
+  /**
+   * @brief Check if the plan may be supported by the backend, without constructing it or initializing the backend.
+   * @param backend Backend.
+   * @param desc Descriptor.
+   * @return Backend support, the reason of the rejection if the plan is not supported. Backends without the check
+   *         are not rejected.
+   */
+  [[nodiscard]] inline BackendSupport supports(Backend backend, [[maybe_unused]] const Desc& desc)
+  {
+    switch (backend)
+    {
+#   ifdef AFFT_ENABLE_CUFFT
+    case Backend::cufft:
+      return cufft::supports(desc);
+#   endif
+#   ifdef AFFT_ENABLE_HEFFTE
+    case Backend::heffte:
+      return heffte::supports(desc);
+#   endif
+#   ifdef AFFT_ENABLE_MKL
+    case Backend::mkl:
+      return mkl::supports(desc);
+#   endif
+#   ifdef AFFT_ENABLE_POCKETFFT
+    case Backend::pocketfft:
+      return pocketfft::supports(desc);
+#   endif
+#   ifdef AFFT_ENABLE_ROCFFT
+    case Backend::rocfft:
+      return rocfft::supports(desc);
+#   endif
+#   ifdef AFFT_ENABLE_VKFFT
+    case Backend::vkfft:
+      return vkfft::supports(desc);
+#   endif
+#   ifdef AFFT_ENABLE_CODELET
+    case Backend::codelet:
+      return codelet::supports(desc);
+#   endif
+    default:
+      return BackendSupport{};
+    }
+  }
+
   /**
    * @brief Make plan implementation of the specified backend.
    * @tparam BackendParamsT Backend parameters type.
@@ -181,24 +294,42 @@ namespace afft::detail
   {
     static_assert(isBackendParameters<BackendParamsT>, "Invalid backend parameters type");
 
-    auto assignFeedbackMessage = [&](auto&& message)
+    std::string message{};
+
+    auto assignFeedbackMessage = [&](auto&& newMessage)
     {
-      if (feedbackMessage != nullptr)
-      {
-        *feedbackMessage = std::forward<decltype(message)>(message);
-      }
+      message = std::forward<decltype(newMessage)>(newMessage);
     };
 
     std::unique_ptr<Plan> plan{};
+
+    const auto start = std::chrono::steady_clock::now();
     
     if ((backend & getSupportedBackendMask<BackendParamsT::target, BackendParamsT::distribution>()) == BackendMask::empty)
     {
       assignFeedbackMessage("Backend not supported for target and distribution");
     }
+    else if (desc.isRealtime() && (backend & afft::spst::cpu::realtimeBackendMask) == BackendMask::empty)
+    {
+      assignFeedbackMessage("Backend does not support realtime execution");
+    }
     else
     {
       try
       {
+#     ifdef AFFT_ENABLE_TRACING
+        trace::Range range{trace::makeLabel("makePlan", desc, backend)};
+#     endif
+
+        // Impossible plans are rejected by the side effect free check before the backend is initialized
+        if (const auto support = supports(backend, desc); !support)
+        {
+          throw BackendError{backend, support.reason};
+        }
+
+        // Backends are initialized on their first use, a failure is reported as the feedback message
+        Initializer::getInstance().initBackend(backend);
+
         switch (backend)
         {
 #       ifdef AFFT_ENABLE_CLFFT
@@ -245,6 +376,11 @@ namespace afft::detail
         case Backend::vkfft:
           plan = vkfft::makePlan(desc, backendParams);
           break;
+#       endif
+#       ifdef AFFT_ENABLE_CODELET
+        case Backend::codelet:
+          plan = codelet::makePlan(desc, backendParams);
+          break;
 #       endif
         default:
           assignFeedbackMessage("Backend is disabled");
@@ -261,6 +397,34 @@ namespace afft::detail
       }
     }
 
+    if (plan)
+    {
+      if (auto backendFeedback = plan->getBackendFeedback(); !backendFeedback.empty())
+      {
+        assignFeedbackMessage(std::move(backendFeedback));
+      }
+    }
+
+    if (trace::isEnabled())
+    {
+      if (plan)
+      {
+        trace::emit(afft::trace::EventType::backendAccepted,
+                    backend,
+                    message,
+                    std::chrono::steady_clock::now() - start);
+      }
+      else
+      {
+        trace::emit(afft::trace::EventType::backendRejected, backend, message);
+      }
+    }
+
+    if (feedbackMessage != nullptr)
+    {
+      *feedbackMessage = std::move(message);
+    }
+
     return plan;
   }
 
@@ -299,8 +463,340 @@ namespace afft::detail
     return plan;
   }
 
+  /// @brief Number of untimed executions run before the plan is measured.
+  inline constexpr std::size_t autotuneWarmupRunCount{1};
+
+  /// @brief Number of timed executions, the fastest one is taken as the plan time.
+  inline constexpr std::size_t autotuneMeasuredRunCount{3};
+
+  /**
+   * @brief Scratch buffers used to measure spst cpu plans.
+   */
+  class SpstCpuScratchBuffers
+  {
+    public:
+      /**
+       * @brief Constructor. Allocates the buffers suitable for all plans created from the descriptor.
+       * @param desc Descriptor.
+       */
+      SpstCpuScratchBuffers(const Desc& desc)
+      {
+        Desc layoutDesc{desc};
+        layoutDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto& cpuDesc   = layoutDesc.getArchDesc<Target::cpu, Distribution::spst>();
+        const auto  shapeRank = layoutDesc.getShapeRank();
+        const auto  srcShape  = layoutDesc.getSrcShape();
+        const auto  dstShape  = layoutDesc.getDstShape();
+
+        const auto alignment      = (cpuDesc.alignment == Alignment{}) ? cpu::getDefaultAlignment() : cpuDesc.alignment;
+        const auto hugePagePolicy = cpuDesc.hugePagePolicy;
+
+        std::size_t srcSize = getBufferElemCount(View<std::size_t>{srcShape.data(), shapeRank},
+                                                 cpuDesc.memoryLayout.getSrcStrides()) * layoutDesc.sizeOfSrcElem();
+        std::size_t dstSize = getBufferElemCount(View<std::size_t>{dstShape.data(), shapeRank},
+                                                 cpuDesc.memoryLayout.getDstStrides()) * layoutDesc.sizeOfDstElem();
+
+        mDstSize = dstSize;
+
+        const auto [srcCount, dstCount] = layoutDesc.getSrcDstBufferCount();
+
+        mSrcPtrs.resize(srcCount);
+        mDstPtrs.resize(dstCount);
+
+        if (layoutDesc.getPlacement() == Placement::inPlace)
+        {
+          srcSize = std::max(srcSize, dstSize);
+
+          mSrcSize = srcSize;
+
+          for (std::size_t i{}; i < srcCount; ++i)
+          {
+            mSrcPtrs[i] = mBuffers.emplace_back(cpu::makeAlignedUnique<std::byte[]>(alignment, hugePagePolicy, srcSize)).get();
+          }
+
+          std::copy_n(mSrcPtrs.begin(), std::min(srcCount, dstCount), mDstPtrs.begin());
+        }
+        else
+        {
+          mSrcSize = srcSize;
+
+          for (std::size_t i{}; i < srcCount; ++i)
+          {
+            mSrcPtrs[i] = mBuffers.emplace_back(cpu::makeAlignedUnique<std::byte[]>(alignment, hugePagePolicy, srcSize)).get();
+          }
+
+          for (std::size_t i{}; i < dstCount; ++i)
+          {
+            mDstPtrs[i] = mBuffers.emplace_back(cpu::makeAlignedUnique<std::byte[]>(alignment, hugePagePolicy, dstSize)).get();
+          }
+        }
+
+        const auto isPlanar           = (layoutDesc.getComplexFormat() == ComplexFormat::planar);
+        const auto [srcCmpl, dstCmpl] = layoutDesc.getSrcDstComplexity();
+
+        mSrcIsPlanar = isPlanar && (srcCmpl == Complexity::complex);
+        mDstIsPlanar = isPlanar && (dstCmpl == Complexity::complex);
+      }
+
+      /**
+       * @brief Execute the plan on the scratch buffers.
+       * @param plan Plan.
+       */
+      void execute(Plan& plan)
+      {
+        const afft::spst::cpu::ExecutionParameters execParams{};
+
+        PlanarComplex<void> srcPlanar{mSrcPtrs.front(), mSrcPtrs.back()};
+        PlanarComplex<void> dstPlanar{mDstPtrs.front(), mDstPtrs.back()};
+
+        if (mSrcIsPlanar && mDstIsPlanar)
+        {
+          plan.executeUnsafe(srcPlanar, dstPlanar, execParams);
+        }
+        else if (mSrcIsPlanar)
+        {
+          plan.executeUnsafe(srcPlanar, mDstPtrs.front(), execParams);
+        }
+        else if (mDstIsPlanar)
+        {
+          plan.executeUnsafe(mSrcPtrs.front(), dstPlanar, execParams);
+        }
+        else
+        {
+          plan.executeUnsafe(mSrcPtrs.front(), mDstPtrs.front(), execParams);
+        }
+      }
+
+      /**
+       * @brief Get the source buffers.
+       * @return Source buffer pointers, the planar parts of a planar source.
+       */
+      [[nodiscard]] View<void*> getSrcPtrs() const noexcept
+      {
+        return View<void*>{mSrcPtrs.data(), mSrcPtrs.size()};
+      }
+
+      /**
+       * @brief Get the destination buffers.
+       * @return Destination buffer pointers, the planar parts of a planar destination.
+       */
+      [[nodiscard]] View<void*> getDstPtrs() const noexcept
+      {
+        return View<void*>{mDstPtrs.data(), mDstPtrs.size()};
+      }
+
+      /**
+       * @brief Get the size of one source buffer.
+       * @return Size in bytes.
+       */
+      [[nodiscard]] std::size_t getSrcSize() const noexcept
+      {
+        return mSrcSize;
+      }
+
+      /**
+       * @brief Get the size of the destination data in one destination buffer.
+       * @return Size in bytes.
+       */
+      [[nodiscard]] std::size_t getDstSize() const noexcept
+      {
+        return mDstSize;
+      }
+    private:
+      /**
+       * @brief Get the number of elements spanned by a strided buffer.
+       * @param shape Shape.
+       * @param strides Strides in elements.
+       * @return Number of elements.
+       */
+      [[nodiscard]] static std::size_t getBufferElemCount(View<std::size_t> shape, View<std::size_t> strides)
+      {
+        std::size_t lastElemOffset{};
+
+        for (std::size_t i{}; i < shape.size(); ++i)
+        {
+          if (shape[i] == 0)
+          {
+            return 0;
+          }
+
+          lastElemOffset += (shape[i] - 1) * strides[i];
+        }
+
+        return lastElemOffset + 1;
+      }
+
+      std::vector<cpu::AlignedUniquePtr<std::byte[]>> mBuffers{};     ///< Owned buffers.
+      std::vector<void*>                              mSrcPtrs{};     ///< Source buffer pointers.
+      std::vector<void*>                              mDstPtrs{};     ///< Destination buffer pointers.
+      std::size_t                                     mSrcSize{};     ///< Size of one source buffer in bytes.
+      std::size_t                                     mDstSize{};     ///< Size of the destination data in bytes.
+      bool                                            mSrcIsPlanar{}; ///< Is the source passed as planar complex?
+      bool                                            mDstIsPlanar{}; ///< Is the destination passed as planar complex?
+  };
+
+  /**
+   * @brief Measure the plan execution time.
+   * @tparam ScratchBuffersT Scratch buffers type.
+   * @param plan Plan.
+   * @param scratchBuffers Scratch buffers.
+   * @return Fastest measured execution time.
+   */
+  template<typename ScratchBuffersT>
+  [[nodiscard]] std::chrono::duration<double> measurePlan(Plan& plan, ScratchBuffersT& scratchBuffers)
+  {
+    using Clock = std::chrono::steady_clock;
+
+    for (std::size_t i{}; i < autotuneWarmupRunCount; ++i)
+    {
+      scratchBuffers.execute(plan);
+    }
+
+    auto bestTime = std::chrono::duration<double>::max();
+
+    for (std::size_t i{}; i < autotuneMeasuredRunCount; ++i)
+    {
+      const auto start = Clock::now();
+      scratchBuffers.execute(plan);
+      const auto end   = Clock::now();
+
+      bestTime = std::min<std::chrono::duration<double>>(bestTime, end - start);
+    }
+
+    return bestTime;
+  }
+
+  /**
+   * @brief Estimate the relative L2 error of a transform. The rms error of an FFT with accurate twiddle factors grows
+   *        with the square root of the number of radix-2 stages times the unit roundoff of the execution precision,
+   *        the rounding of the destination is added.
+   * @param desc Descriptor.
+   * @return Estimated relative L2 error.
+   */
+  [[nodiscard]] inline double estimateRelativeError(const Desc& desc)
+  {
+    auto getUnitRoundoff = [](Precision precision)
+    {
+      switch (precision)
+      {
+      case Precision::bf16:   return std::ldexp(1.0, -8);
+      case Precision::f16:    return std::ldexp(1.0, -11);
+      case Precision::f32:    return std::ldexp(1.0, -24);
+      case Precision::f64:    return std::ldexp(1.0, -53);
+      case Precision::f80:    return std::ldexp(1.0, -64);
+      case Precision::f64f64: return std::ldexp(1.0, -106);
+      case Precision::f128:   return std::ldexp(1.0, -113);
+      default:
+        cxx::unreachable();
+      }
+    };
+
+    const auto shape = desc.getShape();
+
+    double transformSize{1.0};
+
+    for (const auto axis : desc.getTransformAxes())
+    {
+      transformSize *= static_cast<double>(shape[axis]);
+    }
+
+    const auto& prec = desc.getPrecision();
+
+    return getUnitRoundoff(prec.execution) * (1.0 + std::sqrt(std::log2(std::max(transformSize, 2.0)))) +
+           getUnitRoundoff(prec.destination);
+  }
+
+  /**
+   * @brief Measure the relative L2 error of a spst cpu plan against a reference plan of the same descriptor executed
+   *        in a more accurate precision. Both plans transform the same uniformly distributed random data.
+   * @param desc Descriptor of the plan.
+   * @param plan Plan.
+   * @param referencePlan Reference plan.
+   * @return Relative L2 error, nullopt if the source or the destination precision is neither f32 nor f64.
+   */
+  [[nodiscard]] inline std::optional<double> measureRelativeError(const Desc& desc, Plan& plan, Plan& referencePlan)
+  {
+    // calls the function with a null pointer of the real type of the precision
+    auto visitRealType = [](Precision precision, auto&& fn)
+    {
+      switch (precision)
+      {
+      case Precision::f32:
+        fn(static_cast<float*>(nullptr));
+        return true;
+      case Precision::f64:
+        fn(static_cast<double*>(nullptr));
+        return true;
+      default:
+        return false;
+      }
+    };
+
+    const auto& prec = desc.getPrecision();
+
+    if (!visitRealType(prec.source, [](auto*) {}) || !visitRealType(prec.destination, [](auto*) {}))
+    {
+      return std::nullopt;
+    }
+
+    SpstCpuScratchBuffers planBuffers{desc};
+    SpstCpuScratchBuffers referenceBuffers{desc};
+
+    // the seed is fixed, so the validation is reproducible
+    std::mt19937 engine{};
+
+    visitRealType(prec.source, [&](auto* nullReal)
+    {
+      using R = std::remove_pointer_t<decltype(nullReal)>;
+
+      std::uniform_real_distribution<R> distribution{R{-1}, R{1}};
+
+      for (std::size_t i{}; i < planBuffers.getSrcPtrs().size(); ++i)
+      {
+        auto* src          = static_cast<R*>(planBuffers.getSrcPtrs()[i]);
+        auto* referenceSrc = static_cast<R*>(referenceBuffers.getSrcPtrs()[i]);
+
+        for (std::size_t j{}; j < planBuffers.getSrcSize() / sizeof(R); ++j)
+        {
+          src[j] = referenceSrc[j] = distribution(engine);
+        }
+      }
+    });
+
+    planBuffers.execute(plan);
+    referenceBuffers.execute(referencePlan);
+
+    double errorNorm{};
+    double referenceNorm{};
+
+    visitRealType(prec.destination, [&](auto* nullReal)
+    {
+      using R = std::remove_pointer_t<decltype(nullReal)>;
+
+      for (std::size_t i{}; i < planBuffers.getDstPtrs().size(); ++i)
+      {
+        const auto* dst          = static_cast<const R*>(planBuffers.getDstPtrs()[i]);
+        const auto* referenceDst = static_cast<const R*>(referenceBuffers.getDstPtrs()[i]);
+
+        for (std::size_t j{}; j < planBuffers.getDstSize() / sizeof(R); ++j)
+        {
+          const double diff = static_cast<double>(dst[j]) - static_cast<double>(referenceDst[j]);
+
+          errorNorm     += diff * diff;
+          referenceNorm += static_cast<double>(referenceDst[j]) * static_cast<double>(referenceDst[j]);
+        }
+      }
+    });
+
+    return (referenceNorm > 0.0) ? std::sqrt(errorNorm / referenceNorm) : 0.0;
+  }
+
   /**
-   * @brief Make the best plan implementation.
+   * @brief Make the best plan implementation. Each backend's plan is executed on scratch buffers and the fastest
+   *        one is kept. If a tuning database is provided, a previously recorded winner is used without measuring and
+   *        new winners are recorded. Only spst cpu plans are measured, other architectures fall back to the first
+   *        plan.
    * @tparam BackendParamsT Backend parameters type.
    * @param desc Descriptor.
    * @param backendParams Backend parameters.
@@ -309,15 +805,95 @@ namespace afft::detail
    */
   template<typename BackendParamsT>
   [[nodiscard]] inline std::unique_ptr<Plan>
-  makeBestPlan([[maybe_unused]] const Desc& desc,
-               [[maybe_unused]] const BackendParamsT& backendParams,
-               [[maybe_unused]] std::vector<Feedback>* feedbacks)
+  makeBestPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
   {
-    return {};
+    if constexpr (BackendParamsT::target == Target::cpu && BackendParamsT::distribution == Distribution::spst)
+    {
+      std::unique_ptr<Plan>                bestPlan{};
+      std::chrono::duration<double>        bestTime{};
+      std::optional<SpstCpuScratchBuffers> scratchBuffers{};
+      std::string                          tuningKey{};
+
+      auto getFeedback = [&](Feedback& localFeedback, Backend backend) -> Feedback&
+      {
+        Feedback& feedback = (feedbacks != nullptr) ? feedbacks->emplace_back() : localFeedback;
+        feedback.backend = backend;
+
+        return feedback;
+      };
+
+      if (backendParams.tuningDatabase != nullptr)
+      {
+        tuningKey = makeTuningKey(desc, backendParams);
+
+        if (const auto record = backendParams.tuningDatabase->find(tuningKey);
+            record && (backendParams.mask & record->backend) != BackendMask::empty)
+        {
+          Feedback  localFeedback{};
+          Feedback& feedback = getFeedback(localFeedback, record->backend);
+
+          feedback.measuredTime = record->measuredTime;
+
+          if (auto plan = makePlan(record->backend, desc, backendParams, &feedback.message))
+          {
+            return plan;
+          }
+        }
+      }
+
+      forEachBackend(backendParams.mask, backendParams.order, [&](Backend backend)
+      {
+        Feedback  localFeedback{};
+        Feedback& feedback = getFeedback(localFeedback, backend);
+
+        auto plan = makePlan(backend, desc, backendParams, &feedback.message);
+
+        if (!plan)
+        {
+          return;
+        }
+
+        try
+        {
+          if (!scratchBuffers)
+          {
+            scratchBuffers.emplace(desc);
+          }
+
+          feedback.measuredTime = measurePlan(*plan, *scratchBuffers);
+
+          trace::emit(afft::trace::EventType::autotuneCandidate, backend, {}, feedback.measuredTime);
+        }
+        catch (const std::exception& e)
+        {
+          feedback.message = e.what();
+          return;
+        }
+
+        if (!bestPlan || feedback.measuredTime < bestTime)
+        {
+          bestPlan = std::move(plan);
+          bestTime = feedback.measuredTime;
+        }
+      });
+
+      if (bestPlan && backendParams.tuningDatabase != nullptr)
+      {
+        backendParams.tuningDatabase->insert(std::move(tuningKey), tuning::Record{bestPlan->getBackend(), bestTime});
+      }
+
+      return bestPlan;
+    }
+    else
+    {
+      return makeFirstPlan(desc, backendParams, feedbacks);
+    }
   }
 
   /**
-   * @brief Make plan implementation.
+   * @brief Make the progressive plan implementation. The first plan is created with the fastest planning and returned
+   *        immediately, the best plan is searched for in the background and replaces the first one once found. Only spst
+   *        cpu plans are progressive, other architectures fall back to the best plan.
    * @tparam BackendParamsT Backend parameters type.
    * @param desc Descriptor.
    * @param backendParams Backend parameters.
@@ -326,30 +902,973 @@ namespace afft::detail
    */
   template<typename BackendParamsT>
   [[nodiscard]] inline std::unique_ptr<Plan>
-  makePlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks = nullptr)
+  makeProgressivePlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
   {
-    validate(backendParams.strategy);
+    if constexpr (BackendParamsT::target == Target::cpu && BackendParamsT::distribution == Distribution::spst)
+    {
+      auto initialBackendParams              = backendParams;
+      initialBackendParams.fftw3.plannerFlag = fftw3::PlannerFlag::estimate;
+      initialBackendParams.tuningDatabase    = nullptr;
 
-    std::unique_ptr<Plan> plan{};
+      auto initialPlan = makeFirstPlan(desc, initialBackendParams, feedbacks);
+
+      if (!initialPlan)
+      {
+        return nullptr;
+      }
+
+      auto bestBackendParams     = backendParams;
+      bestBackendParams.strategy = SelectStrategy::best;
+
+      return std::make_unique<ProgressivePlan>(desc, std::move(initialPlan), [desc, bestBackendParams]()
+      {
+        return makeBestPlan(desc, bestBackendParams, nullptr);
+      });
+    }
+    else
+    {
+      return makeBestPlan(desc, backendParams, feedbacks);
+    }
+  }
 
+  /**
+   * @brief Make the plan implementation with the select strategy of the backend parameters.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeStrategyPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
     switch (backendParams.strategy)
     {
     case SelectStrategy::first:
-      plan = makeFirstPlan(desc, backendParams, feedbacks);
-      break;
+      return makeFirstPlan(desc, backendParams, feedbacks);
     case SelectStrategy::best:
-      plan = makeBestPlan(desc, backendParams, feedbacks);
-      break;
+      return makeBestPlan(desc, backendParams, feedbacks);
+    case SelectStrategy::progressive:
+      return makeProgressivePlan(desc, backendParams, feedbacks);
     default:
       cxx::unreachable();
     }
+  }
 
-    if (!plan)
+  /**
+   * @brief Keep the faster of two spst cpu plans of the same descriptor, either may be null.
+   * @param desc Descriptor.
+   * @param lhs First plan.
+   * @param rhs Second plan.
+   * @return The faster plan, the other one if one is null.
+   */
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  selectFasterPlan(const Desc& desc, std::unique_ptr<Plan> lhs, std::unique_ptr<Plan> rhs)
+  {
+    if (!lhs || !rhs)
     {
-      throw std::runtime_error{"Failed to create plan implementation"};
+      return (lhs) ? std::move(lhs) : std::move(rhs);
     }
 
-    return plan;
+    SpstCpuScratchBuffers scratchBuffers{desc};
+
+    const auto lhsTime = measurePlan(*lhs, scratchBuffers);
+    const auto rhsTime = measurePlan(*rhs, scratchBuffers);
+
+    trace::emit(afft::trace::EventType::autotuneCandidate, lhs->getBackend(), {}, lhsTime);
+    trace::emit(afft::trace::EventType::autotuneCandidate, rhs->getBackend(), {}, rhsTime);
+
+    return (rhsTime < lhsTime) ? std::move(rhs) : std::move(lhs);
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for a length with a large prime factor. If the backends fail, the
+   *        Bluestein plan computes it by the power of two plans of the backends. The best strategy measures it against
+   *        the backends' plans.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeBluesteinFallbackPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    auto plan = makeStrategyPlan(desc, backendParams, feedbacks);
+
+    if (!isBluesteinLayout(desc) || (plan && backendParams.strategy != SelectStrategy::best))
+    {
+      return plan;
+    }
+
+    std::unique_ptr<Plan> bluesteinPlan{};
+
+    auto forwardPlan  = makeStrategyPlan(makeBluesteinFftDesc(desc, Direction::forward), backendParams, feedbacks);
+    auto backwardPlan = makeStrategyPlan(makeBluesteinFftDesc(desc, Direction::backward), backendParams, feedbacks);
+
+    if (forwardPlan && backwardPlan)
+    {
+      bluesteinPlan = std::make_unique<BluesteinPlan>(desc, std::move(forwardPlan), std::move(backwardPlan));
+    }
+
+    return selectFasterPlan(desc, std::move(plan), std::move(bluesteinPlan));
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for a DHT. If the backends fail, the Hartley plan computes it from a
+   *        real-to-complex plan of the backends. The best strategy measures it against the backends' DHT plans.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeHartleyFallbackPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    auto plan = makeBluesteinFallbackPlan(desc, backendParams, feedbacks);
+
+    if (!isHartleyLayout(desc) || (plan && backendParams.strategy != SelectStrategy::best))
+    {
+      return plan;
+    }
+
+    std::unique_ptr<Plan> hartleyPlan{};
+
+    if (auto spectrumPlan = makeStrategyPlan(makeHartleySpectrumDesc(desc), backendParams, feedbacks))
+    {
+      hartleyPlan = std::make_unique<HartleyPlan>(desc, std::move(spectrumPlan));
+    }
+
+    return selectFasterPlan(desc, std::move(plan), std::move(hartleyPlan));
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for an even number of real-to-complex transforms. If the backends
+   *        fail, the real pair plan computes the pairs of transforms by a complex plan of the backends. The best
+   *        strategy measures it against the backends' real-to-complex plans.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeRealPairFallbackPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    auto plan = makeHartleyFallbackPlan(desc, backendParams, feedbacks);
+
+    if (!isRealPairLayout(desc) || (plan && backendParams.strategy != SelectStrategy::best))
+    {
+      return plan;
+    }
+
+    std::unique_ptr<Plan> realPairPlan{};
+
+    if (auto complexPlan = makeStrategyPlan(makeRealPairComplexDesc(desc), backendParams, feedbacks))
+    {
+      realPairPlan = std::make_unique<RealPairPlan>(desc, std::move(complexPlan));
+    }
+
+    return selectFasterPlan(desc, std::move(plan), std::move(realPairPlan));
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for a three-dimensional c2c transform. The slab plan computes it by
+   *        cache sized slab transforms followed by transforms of column blocks along the outer axis, two passes over
+   *        the memory. The best strategy measures it against the backends' plans, the other strategies use it for
+   *        large destinations.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeSlabPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    const bool isBest = (backendParams.strategy == SelectStrategy::best);
+
+    // the column blocks are allocated by each execution
+    if (!isSlabLayout(desc) || desc.isRealtime() ||
+        (!isBest && desc.getSpstSrcDstBufferSize().second < slabPlanMinDstSize))
+    {
+      return makeRealPairFallbackPlan(desc, backendParams, feedbacks);
+    }
+
+    std::unique_ptr<Plan> slabPlan{};
+
+    auto slabsPlan  = makeStrategyPlan(makeSlabDesc(desc), backendParams, feedbacks);
+    auto columnPlan = makeStrategyPlan(makeSlabColumnDesc(desc), backendParams, feedbacks);
+
+    if (slabsPlan && columnPlan)
+    {
+      slabPlan = std::make_unique<SlabPlan>(desc, std::move(slabsPlan), std::move(columnPlan));
+    }
+
+    if (slabPlan && !isBest)
+    {
+      return slabPlan;
+    }
+
+    return selectFasterPlan(desc, makeRealPairFallbackPlan(desc, backendParams, feedbacks), std::move(slabPlan));
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for a long one-dimensional c2c transform. The six-step plan computes
+   *        it by cache sized row transforms of the backends. The best strategy measures it against the backends' plans,
+   *        the other strategies use it whenever it is applicable.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeSixStepPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    if (!isSixStepLayout(desc))
+    {
+      return makeSlabPlan(desc, backendParams, feedbacks);
+    }
+
+    std::unique_ptr<Plan> sixStepPlan{};
+
+    auto firstPlan  = makeStrategyPlan(makeSixStepFirstDesc(desc), backendParams, feedbacks);
+    auto secondPlan = makeStrategyPlan(makeSixStepSecondDesc(desc), backendParams, feedbacks);
+
+    if (firstPlan && secondPlan)
+    {
+      sixStepPlan = std::make_unique<SixStepPlan>(desc, std::move(firstPlan), std::move(secondPlan));
+    }
+
+    if (sixStepPlan && backendParams.strategy != SelectStrategy::best)
+    {
+      return sixStepPlan;
+    }
+
+    return selectFasterPlan(desc, makeSlabPlan(desc, backendParams, feedbacks), std::move(sixStepPlan));
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for the planar complex format. If the backends lack the planar
+   *        format, the interleaved plan converts the data for a backend plan of the interleaved format. The best
+   *        strategy measures it against the backends' planar plans.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeComplexFormatPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    auto plan = makeSixStepPlan(desc, backendParams, feedbacks);
+
+    if (!isPlanarLayout(desc) || (plan && backendParams.strategy != SelectStrategy::best))
+    {
+      return plan;
+    }
+
+    std::unique_ptr<Plan> interleavedPlan{};
+
+    if (auto backendPlan = makeStrategyPlan(makeInterleavedDesc(desc), backendParams, feedbacks))
+    {
+      interleavedPlan = std::make_unique<InterleavedPlan>(desc, std::move(backendPlan));
+    }
+
+    return selectFasterPlan(desc, std::move(plan), std::move(interleavedPlan));
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for a transposed destination layout. The backend plan computes the
+   *        destination contiguously and the transposed plan copies it into the destination strides. The best strategy
+   *        measures it against the backend's strided stores, the other strategies use it for large destinations.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor with the transposed destination layout, see isTransposedDstLayout().
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeTransposedPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    const bool isBest = (backendParams.strategy == SelectStrategy::best);
+
+    if (!isBest && desc.getSpstSrcDstBufferSize().second < transposedPlanMinDstSize)
+    {
+      return makeComplexFormatPlan(desc, backendParams, feedbacks);
+    }
+
+    std::unique_ptr<Plan> transposedPlan{};
+
+    if (auto contiguousPlan = makeComplexFormatPlan(makeContiguousDstDesc(desc), backendParams, feedbacks))
+    {
+      transposedPlan = std::make_unique<TransposedPlan>(desc, std::move(contiguousPlan));
+    }
+
+    if (transposedPlan && !isBest)
+    {
+      return transposedPlan;
+    }
+
+    return selectFasterPlan(desc, makeComplexFormatPlan(desc, backendParams, feedbacks), std::move(transposedPlan));
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for the destination layout, see makeTransposedPlan() and
+   *        makeComplexFormatPlan().
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeDstLayoutPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    return (isTransposedDstLayout(desc)) ? makeTransposedPlan(desc, backendParams, feedbacks)
+                                         : makeComplexFormatPlan(desc, backendParams, feedbacks);
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for 16-bit precisions. If the backends lack the precision, the mixed
+   *        precision plan converts the data for a backend plan computing in f32. The best strategy measures it against
+   *        the backends' native plans.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeMixedPrecisionPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    auto plan = makeDstLayoutPlan(desc, backendParams, feedbacks);
+
+    if (!isMixedPrecisionLayout(desc) || (plan && backendParams.strategy != SelectStrategy::best))
+    {
+      return plan;
+    }
+
+    std::unique_ptr<Plan> mixedPrecisionPlan{};
+
+    if (auto singlePlan = makeDstLayoutPlan(makeSinglePrecisionDesc(desc), backendParams, feedbacks))
+    {
+      mixedPrecisionPlan = std::make_unique<MixedPrecisionPlan>(desc, std::move(singlePlan));
+    }
+
+    return selectFasterPlan(desc, std::move(plan), std::move(mixedPrecisionPlan));
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for a source of a logical shape. The zero padded plan pads the source
+   *        for a backend plan of the full shape.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor with a logical source shape.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeZeroPaddedPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    auto paddedPlan = makeMixedPrecisionPlan(makePaddedSrcDesc(desc), backendParams, feedbacks);
+
+    return (paddedPlan) ? std::make_unique<ZeroPaddedPlan>(desc, std::move(paddedPlan)) : nullptr;
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation of a descriptor storing the full Hermitian spectrum. The full spectrum
+   *        plan mirrors the output of the reduced spectrum plan.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeFullSpectrumPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    auto makeSrcLayoutPlan = [&](const Desc& srcLayoutDesc)
+    {
+      return (srcLayoutDesc.hasLogicalSrcShape()) ? makeZeroPaddedPlan(srcLayoutDesc, backendParams, feedbacks)
+                                                  : makeMixedPrecisionPlan(srcLayoutDesc, backendParams, feedbacks);
+    };
+
+    if (!desc.hasFullSpectrum())
+    {
+      return makeSrcLayoutPlan(desc);
+    }
+
+    auto reducedPlan = makeSrcLayoutPlan(makeReducedSpectrumDesc(desc));
+
+    return (reducedPlan) ? std::make_unique<FullSpectrumPlan>(desc, std::move(reducedPlan)) : nullptr;
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation of a descriptor with a logical source shape or a destination window.
+   *        The windowed plan computes the full destination for the plan of the source layout and stores the window.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeWindowedPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    if (!desc.hasDstWindow())
+    {
+      return makeFullSpectrumPlan(desc, backendParams, feedbacks);
+    }
+
+    auto fullPlan = makeFullSpectrumPlan(makeFullDstDesc(desc), backendParams, feedbacks);
+
+    return (fullPlan) ? std::make_unique<WindowedDstPlan>(desc, std::move(fullPlan)) : nullptr;
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation of a descriptor accepting unaligned buffers. The alignment dispatch
+   *        plan holds a plan of the requested alignment and a plan assuming only the element alignment, and picks one
+   *        per execution from the actual buffer pointers.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeAlignmentDispatchPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    if (!isAlignmentDispatchLayout(desc))
+    {
+      return makeWindowedPlan(desc, backendParams, feedbacks);
+    }
+
+    auto alignedPlan = makeWindowedPlan(makeAlignedDesc(desc), backendParams, feedbacks);
+
+    if (!alignedPlan)
+    {
+      return nullptr;
+    }
+
+    auto unalignedPlan = makeWindowedPlan(makeUnalignedDesc(desc), backendParams, feedbacks);
+
+    return (unalignedPlan)
+      ? std::make_unique<AlignmentDispatchPlan>(desc, std::move(alignedPlan), std::move(unalignedPlan)) : nullptr;
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation of a descriptor storing the source or the destination centered. The
+   *        shifted plan applies the shifts around the unshifted plan.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeShiftedPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    if (!desc.hasShift())
+    {
+      return makeAlignmentDispatchPlan(desc, backendParams, feedbacks);
+    }
+
+    auto unshiftedPlan = makeAlignmentDispatchPlan(makeUnshiftedDesc(desc), backendParams, feedbacks);
+
+    return (unshiftedPlan) ? std::make_unique<ShiftedPlan>(desc, std::move(unshiftedPlan)) : nullptr;
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation for in-place real data that is not padded along the last axis. The
+   *        unpadded real plan shifts the rows in place for a plan of the padded layout.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeUnpaddedRealPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    if (!isUnpaddedRealLayout(desc))
+    {
+      return makeShiftedPlan(desc, backendParams, feedbacks);
+    }
+
+    validateUnpaddedRealLayout(desc);
+
+    auto paddedPlan = makeShiftedPlan(makePaddedRealDesc(desc), backendParams, feedbacks);
+
+    return (paddedPlan) ? std::make_unique<UnpaddedRealPlan>(desc, std::move(paddedPlan)) : nullptr;
+  }
+
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeBatchCountPlan(const Desc& desc, const BackendParamsT& backendParams, std::unique_ptr<Plan> plan);
+
+  /**
+   * @brief Make the spst cpu plan implementation skipping the zero lines of the first axis pass, see SparseLinePlan.
+   *        It is used whenever the plan requests the sparse lines and it is applicable, the gain depends on the data.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeSparseLinePlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    if (!isSparseLineLayout(desc))
+    {
+      return makeUnpaddedRealPlan(desc, backendParams, feedbacks);
+    }
+
+    const auto shape          = desc.getShape();
+    const auto lineSize       = shape[desc.getTransformAxes()[0]];
+    const auto lineCount      = std::accumulate(shape.begin(),
+                                                shape.begin() + desc.getShapeRank(),
+                                                std::size_t{1},
+                                                std::multiplies<>{}) / std::max(lineSize, std::size_t{1});
+    const auto blockLineCount = std::clamp(sparseLinePlanBlockSize / std::max(lineSize * desc.sizeOfDstElem(), std::size_t{1}),
+                                           std::size_t{1},
+                                           std::max(lineCount, std::size_t{1}));
+
+    const auto lineDesc = makeSparseLineDesc(desc, blockLineCount);
+
+    auto linePlan = makeBatchCountPlan(lineDesc, backendParams, makeStrategyPlan(lineDesc, backendParams, feedbacks));
+    auto restPlan = makeUnpaddedRealPlan(makeSparseLineRestDesc(desc), backendParams, feedbacks);
+
+    return (linePlan && restPlan)
+      ? std::make_unique<SparseLinePlan>(desc, blockLineCount, std::move(linePlan), std::move(restPlan)) : nullptr;
+  }
+
+  /**
+   * @brief Make the spst cpu plan implementation of a DFT with some axes transformed by the DTT, see
+   *        MixedTransformPlan.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeMixedTransformPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    if (!desc.hasDttAxes())
+    {
+      return makeSparseLinePlan(desc, backendParams, feedbacks);
+    }
+
+    validateMixedTransformLayout(desc);
+
+    auto dftPlan = makeSparseLinePlan(makeMixedDftDesc(desc), backendParams, feedbacks);
+    auto dttPlan = makeSparseLinePlan(makeMixedDttDesc(desc), backendParams, feedbacks);
+
+    return (dftPlan && dttPlan) ? std::make_unique<MixedTransformPlan>(desc, std::move(dftPlan), std::move(dttPlan)) : nullptr;
+  }
+
+  /**
+   * @brief Make the plan implementation of the architecture.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeArchPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    if constexpr (BackendParamsT::target == Target::cpu && BackendParamsT::distribution == Distribution::spst)
+    {
+      // the progressive plan swaps its plan from a background thread under a lock
+      if (desc.isRealtime() && backendParams.strategy == SelectStrategy::progressive)
+      {
+        throw std::invalid_argument{"Realtime plans do not support the progressive select strategy"};
+      }
+
+      return makeMixedTransformPlan(desc, backendParams, feedbacks);
+    }
+    else
+    {
+      if (desc.hasDttAxes())
+      {
+        throw std::invalid_argument{"DTT axes of a DFT are supported only by spst cpu plans"};
+      }
+
+      if (desc.hasLogicalSrcShape())
+      {
+        throw std::invalid_argument{"Logical source shape is supported only by spst cpu plans"};
+      }
+
+      if (desc.hasDstWindow())
+      {
+        throw std::invalid_argument{"Destination window is supported only by spst cpu plans"};
+      }
+
+      if (desc.hasFullSpectrum())
+      {
+        throw std::invalid_argument{"Full spectrum is supported only by spst cpu plans"};
+      }
+
+      if (desc.hasShift())
+      {
+        throw std::invalid_argument{"Shifts are supported only by spst cpu plans"};
+      }
+
+      return makeStrategyPlan(desc, backendParams, feedbacks);
+    }
+  }
+
+  /**
+   * @brief Make the plan implementation accepting a reduced outermost batch count at execution time. The part plans
+   *        are made on the first use by the backend of the full batch plan, the first backend selection strategy is
+   *        used as the backend is already known.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param plan Full batch plan.
+   * @return Plan implementation.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeBatchCountPlan(const Desc& desc, const BackendParamsT& backendParams, std::unique_ptr<Plan> plan)
+  {
+    if constexpr (BackendParamsT::distribution == Distribution::spst)
+    {
+      if (!plan || desc.getOuterBatchCount() < 2)
+      {
+        return plan;
+      }
+
+      BackendParamsT partBackendParams{backendParams};
+      partBackendParams.strategy = SelectStrategy::first;
+      partBackendParams.mask     = BackendMask::empty | plan->getBackend();
+      partBackendParams.order    = {};
+
+      Desc partDescBase{desc};
+
+      if constexpr (BackendParamsT::target == Target::cpu)
+      {
+        partBackendParams.tuningDatabase = nullptr;
+      }
+
+      auto makePartPlan = [partDescBase, partBackendParams](std::size_t batchCount)
+      {
+        Desc partDesc{partDescBase};
+        partDesc.setBatchExtent(0, batchCount);
+
+        return makeArchPlan(partDesc, partBackendParams, nullptr);
+      };
+
+      return std::make_unique<BatchCountPlan>(desc, std::move(plan), std::move(makePartPlan));
+    }
+    else
+    {
+      return plan;
+    }
+  }
+
+  /**
+   * @brief Get the memory held by a plan, the backend memory and the workspace, internal or external.
+   * @param plan Plan.
+   * @return Memory size in bytes.
+   */
+  [[nodiscard]] inline std::size_t getPlanMemorySize(const Plan& plan)
+  {
+    const auto backendMemorySize = plan.getBackendMemorySize();
+    const auto workspaceSize     = plan.getWorkspaceSize();
+
+    return std::accumulate(backendMemorySize.begin(), backendMemorySize.end(), std::size_t{}) +
+           std::accumulate(workspaceSize.begin(), workspaceSize.end(), std::size_t{});
+  }
+
+  /**
+   * @brief Make the plan implementation of the automatic placement. The out-of-place plan competes with the in-place
+   *        plan computed in the destination, see InPlaceDstPlan. Plans over the memory budget are dropped unless both
+   *        are over it, then the smaller one is kept. The best strategy measures the remaining plans, the other
+   *        strategies keep the out-of-place plan if it fits the budget.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor with the automatic placement.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeAutomaticPlacementPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    if constexpr (BackendParamsT::target == Target::cpu && BackendParamsT::distribution == Distribution::spst)
+    {
+      const auto outOfPlaceDesc = makeOutOfPlaceDesc(desc);
+      const auto memoryBudget   = desc.getArchDesc<Target::cpu, Distribution::spst>().memoryBudget;
+
+      auto plan = makeBatchCountPlan(outOfPlaceDesc,
+                                     backendParams,
+                                     makeArchPlan(outOfPlaceDesc, backendParams, feedbacks));
+
+      const bool fitsBudget = (plan && (memoryBudget == 0 || getPlanMemorySize(*plan) <= memoryBudget));
+
+      if (!isInPlaceDstLayout(outOfPlaceDesc) || (fitsBudget && backendParams.strategy != SelectStrategy::best))
+      {
+        return plan;
+      }
+
+      std::unique_ptr<Plan> inPlaceDstPlan{};
+
+      const auto inPlaceDesc = makeInPlaceDstDesc(outOfPlaceDesc);
+
+      if (auto inPlacePlan = makeBatchCountPlan(inPlaceDesc,
+                                                backendParams,
+                                                makeArchPlan(inPlaceDesc, backendParams, feedbacks)))
+      {
+        inPlaceDstPlan = std::make_unique<InPlaceDstPlan>(outOfPlaceDesc, std::move(inPlacePlan));
+      }
+
+      if (!plan || !inPlaceDstPlan)
+      {
+        return (plan) ? std::move(plan) : std::move(inPlaceDstPlan);
+      }
+
+      const auto size        = getPlanMemorySize(*plan);
+      const auto inPlaceSize = getPlanMemorySize(*inPlaceDstPlan);
+
+      const bool inPlaceFitsBudget = (memoryBudget == 0 || inPlaceSize <= memoryBudget);
+
+      if (fitsBudget && inPlaceFitsBudget)
+      {
+        return selectFasterPlan(outOfPlaceDesc, std::move(plan), std::move(inPlaceDstPlan));
+      }
+      else if (fitsBudget || inPlaceFitsBudget)
+      {
+        return (fitsBudget) ? std::move(plan) : std::move(inPlaceDstPlan);
+      }
+      else
+      {
+        return (inPlaceSize < size) ? std::move(inPlaceDstPlan) : std::move(plan);
+      }
+    }
+    else
+    {
+      throw std::invalid_argument{"Automatic placement is supported only by spst cpu plans"};
+    }
+  }
+
+  /// @brief Floating point operations each thread of a plan with the automatic thread limit computes at least, so they
+  ///        amortize waking up and synchronizing the thread pool threads, see estimateFlops().
+  inline constexpr double autoThreadMinFlops{262144.0};
+
+  /**
+   * @brief Get the largest thread limit of a spst cpu plan with the automatic thread limit, the requested limit bounded
+   *        by the thread pool size.
+   * @param desc Descriptor.
+   * @return Thread limit, at least 1.
+   */
+  [[nodiscard]] inline unsigned getMaxAutoThreadLimit(const Desc& desc)
+  {
+    const auto maxThreadLimit = desc.getArchDesc<Target::cpu, Distribution::spst>().maxThreadLimit;
+    const auto poolSize       = std::max(afft::cpu::getThreadPool()->getThreadCount(), std::size_t{1});
+
+    return static_cast<unsigned>((maxThreadLimit == 0) ? poolSize : std::min<std::size_t>(maxThreadLimit, poolSize));
+  }
+
+  /**
+   * @brief Get the automatic thread limit of a spst cpu plan. Each thread gets at least autoThreadMinFlops of the
+   *        estimated floating point operations of the transforms, so small transforms run on one thread.
+   * @param desc Descriptor.
+   * @return Thread limit, at least 1.
+   */
+  [[nodiscard]] inline unsigned getAutoThreadLimit(const Desc& desc)
+  {
+    const auto threadCount = std::floor(estimateFlops(desc) / autoThreadMinFlops);
+
+    return static_cast<unsigned>(std::clamp(threadCount, 1.0, static_cast<double>(getMaxAutoThreadLimit(desc))));
+  }
+
+  /**
+   * @brief Make the plan implementation of the placement, see makeAutomaticPlacementPlan().
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makePlacementPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    return (desc.getPlacement() == Placement::automatic)
+             ? makeAutomaticPlacementPlan(desc, backendParams, feedbacks)
+             : makeBatchCountPlan(desc, backendParams, makeArchPlan(desc, backendParams, feedbacks));
+  }
+
+  /**
+   * @brief Make the plan implementation selecting the automatic thread limit of spst cpu plans, see getAutoThreadLimit().
+   *        The best strategy measures the selected limit against a single thread and the largest limit.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation, null if no backend succeeded.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makeAutoThreadPlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks)
+  {
+    if constexpr (BackendParamsT::target == Target::cpu && BackendParamsT::distribution == Distribution::spst)
+    {
+      if (desc.getArchDesc<Target::cpu, Distribution::spst>().autoThreadLimit)
+      {
+        auto makeThreadLimitPlan = [&](unsigned threadLimit)
+        {
+          Desc threadLimitDesc{desc};
+          threadLimitDesc.getArchDesc<Target::cpu, Distribution::spst>().threadLimit = threadLimit;
+
+          return makePlacementPlan(threadLimitDesc, backendParams, feedbacks);
+        };
+
+        const auto threadLimit = getAutoThreadLimit(desc);
+
+        auto plan = makeThreadLimitPlan(threadLimit);
+
+        if (backendParams.strategy == SelectStrategy::best)
+        {
+          for (const auto candidate : {1u, getMaxAutoThreadLimit(desc)})
+          {
+            if (candidate != threadLimit)
+            {
+              plan = selectFasterPlan(desc, std::move(plan), makeThreadLimitPlan(candidate));
+            }
+          }
+        }
+
+        return plan;
+      }
+    }
+
+    return makePlacementPlan(desc, backendParams, feedbacks);
+  }
+
+  /**
+   * @brief Make plan implementation.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @param feedbacks Feedbacks.
+   * @return Plan implementation.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] inline std::unique_ptr<Plan>
+  makePlan(const Desc& desc, const BackendParamsT& backendParams, std::vector<Feedback>* feedbacks = nullptr)
+  {
+    validate(backendParams.strategy);
+
+#   ifdef AFFT_ENABLE_TRACING
+    trace::Range range{trace::makeLabel("plan", desc, std::nullopt)};
+#   endif
+
+    const auto start = std::chrono::steady_clock::now();
+
+    auto plan = makeAutoThreadPlan(desc, backendParams, feedbacks);
+
+    if (!plan)
+    {
+      throw std::runtime_error{"Failed to create plan implementation"};
+    }
+
+    const std::chrono::duration<double> planningTime = std::chrono::steady_clock::now() - start;
+
+    PlanStatsSetter::setPlanningTime(*plan, planningTime);
+
+    trace::emit(afft::trace::EventType::planCreated, plan->getBackend(), {}, planningTime);
+
+#   ifdef AFFT_ENABLE_TRACING
+    trace::LabelSetter::setExecutionLabel(*plan, trace::makeLabel("execute", desc, plan->getBackend()));
+#   endif
+
+    // The inverse plan reuses the selected backend. The views of the backend parameters may not outlive the call, so
+    // the order and the tuning database are dropped and the strings are owned by the function
+    auto inverseBackendParams     = backendParams;
+    inverseBackendParams.strategy = SelectStrategy::first;
+    inverseBackendParams.mask     = BackendMask::empty | plan->getBackend();
+    inverseBackendParams.order    = {};
+
+    std::string cacheDirectory{};
+
+    if constexpr (BackendParamsT::target == Target::cpu && BackendParamsT::distribution == Distribution::spst)
+    {
+      inverseBackendParams.tuningDatabase = nullptr;
+    }
+    else if constexpr (BackendParamsT::target == Target::gpu && BackendParamsT::distribution == Distribution::spst)
+    {
+      cacheDirectory                            = backendParams.vkfft.cacheDirectory;
+      inverseBackendParams.vkfft.cacheDirectory = {};
+    }
+
+    InversePlanSetter::setMakeInversePlanFn(*plan, [inverseBackendParams, cacheDirectory = std::move(cacheDirectory)]
+                                                   (const Desc& inverseDesc)
+    {
+      auto callBackendParams = inverseBackendParams;
+
+      if constexpr (BackendParamsT::target == Target::gpu && BackendParamsT::distribution == Distribution::spst)
+      {
+        callBackendParams.vkfft.cacheDirectory = cacheDirectory;
+      }
+
+      return makePlan(inverseDesc, callBackendParams);
+    });
+
+    return plan;
+  }
+
+  /**
+   * @brief Make a function creating the plan later, possibly on another thread. The descriptor and the backend
+   *        parameters are copied into the function. The function optionally takes the feedbacks to fill.
+   * @tparam ArchParamsT Architecture parameters type.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @return Function returning the plan.
+   */
+  template<typename ArchParamsT, typename BackendParamsT>
+  [[nodiscard]] inline auto makeDeferredPlan(Desc desc, [[maybe_unused]] const BackendParamsT& backendParams)
+  {
+    using ResolvedBackendParamsT = std::conditional_t<std::is_same_v<BackendParamsT, DefaultBackendParameters>,
+                                                      BackendParameters<ArchParamsT::target, ArchParamsT::distribution>,
+                                                      BackendParamsT>;
+
+    ResolvedBackendParamsT resolvedBackendParams{};
+
+    if constexpr (!std::is_same_v<BackendParamsT, DefaultBackendParameters>)
+    {
+      resolvedBackendParams = backendParams;
+    }
+
+    return [desc = std::move(desc), resolvedBackendParams](std::vector<Feedback>* feedbacks = nullptr)
+    {
+      return makePlan(desc, resolvedBackendParams, feedbacks);
+    };
   }
 } // namespace afft::detail
 
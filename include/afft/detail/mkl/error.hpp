@@ -62,6 +62,32 @@ namespace afft::detail::mkl
       throw BackendError{Backend::mkl, getErrorMsg(result)};
     }
   }
+
+#ifdef AFFT_ENABLE_SYCL
+  /**
+   * @brief Call a oneMKL SYCL function translating its exceptions.
+   * @tparam FnT Function type.
+   * @param fn Function calling oneMKL.
+   * @return The result of the function.
+   * @throw BackendError if oneMKL throws.
+   */
+  template<typename FnT>
+  decltype(auto) checkedCall(FnT&& fn)
+  {
+    try
+    {
+      return std::forward<FnT>(fn)();
+    }
+    catch (const oneapi::mkl::exception& e)
+    {
+      throw BackendError{Backend::mkl, e.what()};
+    }
+    catch (const sycl::exception& e)
+    {
+      throw BackendError{Backend::mkl, e.what()};
+    }
+  }
+#endif
 } // namespace afft::detail::mkl
 
 #endif /* AFFT_DETAIL_MKL_ERROR_HPP */
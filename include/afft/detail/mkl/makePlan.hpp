@@ -0,0 +1,166 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_MKL_MAKE_PLAN_HPP
+#define AFFT_DETAIL_MKL_MAKE_PLAN_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../../Plan.hpp"
+#include "mpst.hpp"
+#include "spst.hpp"
+
+namespace afft::detail::mkl
+{
+  /**
+   * @brief Check if the plan may be supported by the mkl backend, without any side effects.
+   * @param desc Plan description.
+   * @return Backend support, the reason of the rejection if the plan is not supported.
+   */
+  [[nodiscard]] inline BackendSupport supports(const Desc& desc)
+  {
+    if (desc.getTransform() != Transform::dft)
+    {
+      return BackendSupport{"only dft transform is supported"};
+    }
+
+    if (!desc.hasUniformPrecision())
+    {
+      return BackendSupport{"execution, source and destination precision must match"};
+    }
+
+    if (const auto prec = desc.getPrecision().execution; prec != Precision::f32 && prec != Precision::f64)
+    {
+      return BackendSupport{"only single and double precision are supported"};
+    }
+
+    if (desc.getShapeRank() - desc.getTransformRank() > 1)
+    {
+      return BackendSupport{"only single and batched transforms are supported"};
+    }
+
+    if (desc.getTarget() == Target::gpu)
+    {
+#   ifdef AFFT_ENABLE_SYCL
+      if (desc.getDistribution() != Distribution::spst)
+      {
+        return BackendSupport{"only spst distribution is supported"};
+      }
+
+      if (desc.getComplexFormat() != ComplexFormat::interleaved)
+      {
+        return BackendSupport{"only interleaved complex format is supported"};
+      }
+
+      if (desc.getArchDesc<Target::gpu, Distribution::spst>().hasCallbacks())
+      {
+        return BackendSupport{"callbacks are not supported"};
+      }
+#   else
+      return BackendSupport{"gpu support requires the SYCL gpu backend"};
+#   endif
+    }
+    else
+    {
+      if (desc.getDistribution() != Distribution::mpst)
+      {
+        return BackendSupport{"cpu plans are not available"};
+      }
+
+#   ifdef AFFT_MKL_HAS_CDFT
+      if (desc.getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex)
+      {
+        return BackendSupport{"only complex-to-complex transforms are supported by the Cluster DFT"};
+      }
+
+      if (desc.getComplexFormat() != ComplexFormat::interleaved)
+      {
+        return BackendSupport{"only interleaved complex format is supported"};
+      }
+
+      if (desc.getShapeRank() < 2 || desc.getTransformRank() != desc.getShapeRank())
+      {
+        return BackendSupport{"the Cluster DFT transforms all axes of a multidimensional shape"};
+      }
+#   else
+      return BackendSupport{"mpst support requires MKL with the Cluster DFT"};
+#   endif
+    }
+
+    return BackendSupport{};
+  }
+
+  /**
+   * @brief Create a plan implementation.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Plan description.
+   * @param backendParams Backend parameters.
+   * @return Plan implementation.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] std::unique_ptr<afft::Plan>
+  makePlan([[maybe_unused]] const Desc& desc, const BackendParamsT&)
+  {
+    if (const auto support = supports(desc); !support)
+    {
+      throw BackendError{Backend::mkl, support.reason};
+    }
+
+    if constexpr (BackendParamsT::target == Target::gpu)
+    {
+#   ifdef AFFT_ENABLE_SYCL
+      if constexpr (BackendParamsT::distribution == Distribution::spst)
+      {
+        return spst::gpu::makePlan(desc);
+      }
+      else
+      {
+        throw BackendError{Backend::mkl, "only spst distribution is supported"};
+      }
+#   else
+      throw BackendError{Backend::mkl, "gpu support requires the SYCL gpu backend"};
+#   endif
+    }
+    else
+    {
+      if constexpr (BackendParamsT::distribution == Distribution::mpst)
+      {
+#     ifdef AFFT_MKL_HAS_CDFT
+        return mpst::cpu::makePlan(desc);
+#     else
+        throw BackendError{Backend::mkl, "mpst support requires MKL with the Cluster DFT"};
+#     endif
+      }
+      else
+      {
+        throw BackendError{Backend::mkl, "cpu plans are not available"};
+      }
+    }
+  }
+} // namespace afft::detail::mkl
+
+#endif /* AFFT_DETAIL_MKL_MAKE_PLAN_HPP */
@@ -0,0 +1,391 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_MKL_MPST_HPP
+#define AFFT_DETAIL_MKL_MPST_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../../Plan.hpp"
+
+#ifdef AFFT_MKL_HAS_CDFT
+
+namespace afft::detail::mkl::mpst::cpu
+{
+  /**
+   * @brief Create a mkl mpst cpu plan implementation.
+   * @param desc Plan description.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] std::unique_ptr<afft::Plan> makePlan(const Desc& desc);
+} // namespace afft::detail::mkl::mpst::cpu
+
+#ifdef AFFT_HEADER_ONLY
+
+#include "error.hpp"
+#include "Plan.hpp"
+
+namespace afft::detail::mkl::mpst::cpu
+{
+  /// @brief Alias for the MKL integer type
+  using Long = MKL_LONG;
+
+  /**
+   * @class Plan
+   * @brief Implementation of the plan for the mpst cpu architecture using the MKL Cluster DFT. The data are distributed
+   *        in slabs of the first axis. The output of the forward transform and the input of the backward transform may
+   *        be transposed, the first two axes swapped and distributed in slabs of the second axis.
+   */
+  class Plan final : public mkl::Plan
+  {
+    private:
+      /// @brief Alias for the parent class
+      using Parent = mkl::Plan;
+
+    public:
+      /// @brief inherit constructors
+      using Parent::Parent;
+
+      /**
+       * @brief Constructor
+       * @param desc The plan description
+       */
+      Plan(const Desc& desc)
+      : Parent{desc}
+      {
+        const auto& cpuDesc   = mDesc.getArchDesc<Target::cpu, Distribution::mpst>();
+        const auto  shapeRank = mDesc.getShapeRank();
+        const auto  shape     = mDesc.getShape();
+        const bool  isForward = (mDesc.getDirection() == Direction::forward);
+
+        // the forward output and the backward input are the transposed side
+        const auto& memLayout  = cpuDesc.memoryLayout;
+        const auto  transAxes  = (isForward) ? memLayout.getDstAxesOrder() : memLayout.getSrcAxesOrder();
+        const auto  normalAxes = (isForward) ? memLayout.getSrcAxesOrder() : memLayout.getDstAxesOrder();
+
+        mIsTransposed = isTransposedAxesOrder(transAxes);
+
+        if (!isDefaultAxesOrder(normalAxes) || (!mIsTransposed && !isDefaultAxesOrder(transAxes)))
+        {
+          throw BackendError{Backend::mkl, "only the default axes order or the first two axes swapped are supported"};
+        }
+
+        std::vector<Long> lengths(shape.begin(), shape.begin() + shapeRank);
+
+        {
+          DFTI_DESCRIPTOR_DM_HANDLE handle{};
+
+          checkError(DftiCreateDescriptorDM(cpuDesc.comm,
+                                            &handle,
+                                            (mDesc.getPrecision().execution == Precision::f32) ? DFTI_SINGLE : DFTI_DOUBLE,
+                                            DFTI_COMPLEX,
+                                            safeIntCast<Long>(shapeRank),
+                                            lengths.data()));
+
+          mHandle.reset(handle);
+        }
+
+        checkError(DftiSetValueDM(mHandle.get(),
+                                  DFTI_PLACEMENT,
+                                  (mDesc.getPlacement() == Placement::inPlace) ? DFTI_INPLACE : DFTI_NOT_INPLACE));
+        checkError(DftiSetValueDM(mHandle.get(),
+                                  (isForward) ? DFTI_FORWARD_SCALE : DFTI_BACKWARD_SCALE,
+                                  mDesc.getNormalizationFactor<double>()));
+        checkError(DftiSetValueDM(mHandle.get(), DFTI_TRANSPOSE, (mIsTransposed) ? DFTI_ALLOW : DFTI_NONE));
+        checkError(DftiCommitDescriptorDM(mHandle.get()));
+
+        Long localSize{};
+        Long localNx{};
+        Long localXStart{};
+        Long localOutNx{};
+        Long localOutXStart{};
+
+        checkError(DftiGetValueDM(mHandle.get(), CDFT_LOCAL_SIZE, &localSize));
+        checkError(DftiGetValueDM(mHandle.get(), CDFT_LOCAL_NX, &localNx));
+        checkError(DftiGetValueDM(mHandle.get(), CDFT_LOCAL_X_START, &localXStart));
+        checkError(DftiGetValueDM(mHandle.get(), CDFT_LOCAL_OUT_NX, &localOutNx));
+        checkError(DftiGetValueDM(mHandle.get(), CDFT_LOCAL_OUT_X_START, &localOutXStart));
+
+        const Slab normalSlab{0, safeIntCast<std::size_t>(localXStart), safeIntCast<std::size_t>(localNx)};
+        const Slab transSlab{(mIsTransposed) ? std::size_t{1} : std::size_t{0},
+                             safeIntCast<std::size_t>(localOutXStart),
+                             safeIntCast<std::size_t>(localOutNx)};
+
+        const Slab& srcSlab = (isForward) ? normalSlab : transSlab;
+        const Slab& dstSlab = (isForward) ? transSlab : normalSlab;
+
+        if (!isSlabBlock(memLayout.getSrcStarts(), memLayout.getSrcSizes(), srcSlab))
+        {
+          throw BackendError{Backend::mkl, "the source memory block does not match the Cluster DFT local slab"};
+        }
+
+        if (!isSlabBlock(memLayout.getDstStarts(), memLayout.getDstSizes(), dstSlab))
+        {
+          throw BackendError{Backend::mkl, "the destination memory block does not match the Cluster DFT local slab"};
+        }
+
+        if (!isPackedStrides(memLayout.hasDefaultSrcStrides(), memLayout.getSrcStrides(), memLayout.getSrcSizes(),
+                             (isForward) ? normalAxes : transAxes) ||
+            !isPackedStrides(memLayout.hasDefaultDstStrides(), memLayout.getDstStrides(), memLayout.getDstSizes(),
+                             (isForward) ? transAxes : normalAxes))
+        {
+          throw BackendError{Backend::mkl, "only packed memory blocks are supported"};
+        }
+
+        // the local arrays are also used as the scratch of the exchange, they may need to be larger than the blocks
+        const auto localCount = safeIntCast<std::size_t>(localSize);
+
+        if (localCount > getElemCount(memLayout.getSrcSizes()) || localCount > getElemCount(memLayout.getDstSizes()))
+        {
+          throw BackendError{Backend::mkl, "the Cluster DFT requires " + std::to_string(localCount) +
+                                           " local elements, more than the memory blocks hold"};
+        }
+
+        if (mDesc.useExternalWorkspace())
+        {
+          mWorkspaceSize = localCount * mDesc.sizeOfSrcElem();
+        }
+
+        mDesc.fillDefaultMemoryLayoutStrides();
+      }
+
+      /// @brief Destructor
+      ~Plan() = default;
+
+      /// @brief Inherit assignment operator
+      using Parent::operator=;
+
+      /**
+       * @brief Execute the plan
+       * @param src The source buffer
+       * @param dst The destination buffer
+       * @param execParams The execution parameters
+       */
+      void executeBackendImpl(View<void*> src, View<void*> dst, const afft::mpst::cpu::ExecutionParameters& execParams) override
+      {
+        if (mDesc.useExternalWorkspace() && execParams.workspace == nullptr)
+        {
+          throw BackendError{Backend::mkl, "plan uses the external workspace, but no workspace was given"};
+        }
+
+        auto lock = lockExecution(mMutex);
+
+        if (mDesc.useExternalWorkspace() && execParams.workspace != mWorkspace)
+        {
+          checkError(DftiSetValueDM(mHandle.get(), CDFT_WORKSPACE, execParams.workspace));
+
+          mWorkspace = execParams.workspace;
+        }
+
+        const auto computeFn = (mDesc.getDirection() == Direction::forward) ? DftiComputeForwardDM : DftiComputeBackwardDM;
+
+        const int prevThreadCount = mkl_set_num_threads_local(
+          safeIntCast<int>(mDesc.getArchDesc<Target::cpu, Distribution::mpst>().threadLimit));
+
+        const auto result = (mDesc.getPlacement() == Placement::inPlace)
+                              ? computeFn(mHandle.get(), src.front())
+                              : computeFn(mHandle.get(), src.front(), dst.front());
+
+        mkl_set_num_threads_local(prevThreadCount);
+
+        checkError(result);
+      }
+
+      /**
+       * @brief Get the workspace size
+       * @return The workspace size
+       */
+      [[nodiscard]] constexpr View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return {&mWorkspaceSize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback.
+       * @return The data layout chosen by the Cluster DFT.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        return (mIsTransposed) ? "transposed output" : "slab output";
+      }
+    private:
+      /// @brief Local slab of the Cluster DFT, the range of a single distributed axis.
+      struct Slab
+      {
+        std::size_t axis{};  ///< Distributed axis.
+        std::size_t start{}; ///< Start of the local range.
+        std::size_t size{};  ///< Size of the local range.
+      };
+
+      /// @brief Deleter of the Cluster DFT descriptor handle.
+      struct Deleter
+      {
+        /**
+         * @brief Free the descriptor handle.
+         * @param handle The descriptor handle.
+         */
+        void operator()(DFTI_DESCRIPTOR_DM_HANDLE handle) const
+        {
+          if (handle != nullptr)
+          {
+            DftiFreeDescriptorDM(&handle);
+          }
+        }
+      };
+
+      /**
+       * @brief Check if the axes order is the default one.
+       * @param axesOrder The axes order.
+       * @return True if the axes are in the natural order.
+       */
+      [[nodiscard]] static bool isDefaultAxesOrder(View<std::size_t> axesOrder)
+      {
+        for (std::size_t i{}; i < axesOrder.size(); ++i)
+        {
+          if (axesOrder[i] != i)
+          {
+            return false;
+          }
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Check if the axes order swaps the first two axes.
+       * @param axesOrder The axes order.
+       * @return True if the first two axes are swapped and the others are in the natural order.
+       */
+      [[nodiscard]] static bool isTransposedAxesOrder(View<std::size_t> axesOrder)
+      {
+        if (axesOrder.size() < 2 || axesOrder[0] != 1 || axesOrder[1] != 0)
+        {
+          return false;
+        }
+
+        for (std::size_t i{2}; i < axesOrder.size(); ++i)
+        {
+          if (axesOrder[i] != i)
+          {
+            return false;
+          }
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Check if the memory block is the local slab.
+       * @param starts The block starts.
+       * @param sizes The block sizes.
+       * @param slab The local slab.
+       * @return True if the block spans the slab range of the distributed axis and the whole other axes.
+       */
+      [[nodiscard]] bool isSlabBlock(View<std::size_t> starts, View<std::size_t> sizes, const Slab& slab) const
+      {
+        const auto shape = mDesc.getShape();
+
+        for (std::size_t i{}; i < mDesc.getShapeRank(); ++i)
+        {
+          const auto start = (i == slab.axis) ? slab.start : std::size_t{};
+          const auto size  = (i == slab.axis) ? slab.size : shape[i];
+
+          if (starts[i] != start || sizes[i] != size)
+          {
+            return false;
+          }
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Check if the block strides are packed in the axes order.
+       * @param hasDefaultStrides True if the strides are the default ones.
+       * @param strides The block strides.
+       * @param sizes The block sizes.
+       * @param axesOrder The axes order.
+       * @return True if the block is packed, the default strides are packed.
+       */
+      [[nodiscard]] static bool isPackedStrides(bool              hasDefaultStrides,
+                                                View<std::size_t> strides,
+                                                View<std::size_t> sizes,
+                                                View<std::size_t> axesOrder)
+      {
+        if (hasDefaultStrides)
+        {
+          return true;
+        }
+
+        std::size_t stride{1};
+
+        for (std::size_t i = axesOrder.size(); i-- > 0;)
+        {
+          if (sizes[axesOrder[i]] > 1 && strides[axesOrder[i]] != stride)
+          {
+            return false;
+          }
+
+          stride *= sizes[axesOrder[i]];
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Get the number of the block elements.
+       * @param sizes The block sizes.
+       * @return The number of elements.
+       */
+      [[nodiscard]] static std::size_t getElemCount(View<std::size_t> sizes)
+      {
+        return std::accumulate(sizes.begin(), sizes.end(), std::size_t{1}, std::multiplies<>{});
+      }
+
+      std::unique_ptr<std::remove_pointer_t<DFTI_DESCRIPTOR_DM_HANDLE>, Deleter> mHandle{};        ///< The descriptor handle
+      bool                                                                       mIsTransposed{};  ///< The forward output is transposed
+      std::size_t                                                                mWorkspaceSize{}; ///< The external workspace size
+      void*                                                                      mWorkspace{};     ///< The external workspace set to the descriptor
+      std::mutex                                                                 mMutex{};         ///< Guards the workspace set to the descriptor
+  };
+
+  /**
+   * @brief Create a mkl mpst cpu plan implementation.
+   * @param desc Plan description.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] AFFT_HEADER_ONLY_INLINE std::unique_ptr<afft::Plan> makePlan(const Desc& desc)
+  {
+    return std::make_unique<Plan>(desc);
+  }
+} // namespace afft::detail::mkl::mpst::cpu
+
+#endif /* AFFT_HEADER_ONLY */
+
+#endif /* AFFT_MKL_HAS_CDFT */
+
+#endif /* AFFT_DETAIL_MKL_MPST_HPP */
@@ -0,0 +1,370 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_MKL_SPST_HPP
+#define AFFT_DETAIL_MKL_SPST_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../../Plan.hpp"
+
+#ifdef AFFT_ENABLE_SYCL
+
+namespace afft::detail::mkl::spst::gpu
+{
+  /**
+   * @brief Create a mkl spst gpu plan implementation.
+   * @param desc Plan description.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] std::unique_ptr<afft::Plan> makePlan(const Desc& desc);
+} // namespace afft::detail::mkl::spst::gpu
+
+#ifdef AFFT_HEADER_ONLY
+
+#include "Plan.hpp"
+
+namespace afft::detail::mkl::spst::gpu
+{
+  /**
+   * @class Plan
+   * @brief Implementation of the plan for the spst gpu architecture using oneMKL SYCL dft
+   */
+  class Plan final : public mkl::Plan
+  {
+    private:
+      /// @brief Alias for the parent class
+      using Parent = mkl::Plan;
+
+      /// @brief Alias for the oneMKL descriptor
+      template<oneapi::mkl::dft::precision prec, oneapi::mkl::dft::domain dom>
+      using Descriptor = oneapi::mkl::dft::descriptor<prec, dom>;
+
+      /// @brief Variant of the oneMKL descriptors, the precision and the domain are known at runtime only
+      using DescriptorVariant = std::variant<std::monostate,
+                                             Descriptor<oneapi::mkl::dft::precision::SINGLE,
+                                                        oneapi::mkl::dft::domain::COMPLEX>,
+                                             Descriptor<oneapi::mkl::dft::precision::SINGLE,
+                                                        oneapi::mkl::dft::domain::REAL>,
+                                             Descriptor<oneapi::mkl::dft::precision::DOUBLE,
+                                                        oneapi::mkl::dft::domain::COMPLEX>,
+                                             Descriptor<oneapi::mkl::dft::precision::DOUBLE,
+                                                        oneapi::mkl::dft::domain::REAL>>;
+
+      /// @brief Element types of a oneMKL descriptor
+      template<typename DescriptorT>
+      struct DescriptorTraits;
+
+      /// @brief Specialization for the oneMKL descriptor
+      template<oneapi::mkl::dft::precision prec, oneapi::mkl::dft::domain dom>
+      struct DescriptorTraits<Descriptor<prec, dom>>
+      {
+        using Real    = std::conditional_t<prec == oneapi::mkl::dft::precision::SINGLE, float, double>;
+        using Complex = std::complex<Real>;
+      };
+
+    public:
+      /// @brief inherit constructors
+      using Parent::Parent;
+
+      /**
+       * @brief Constructor
+       * @param Desc The plan description
+       */
+      Plan(const Desc& desc)
+      : Parent{desc}
+      {
+        mDesc.fillDefaultMemoryLayoutStrides();
+
+        const bool isDouble = (mDesc.getPrecision().execution == Precision::f64);
+        const bool isReal   = (mDesc.getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex);
+
+        const auto tRank = mDesc.getTransformRank();
+        const auto dims  = mDesc.getTransformDimsAs<std::int64_t>();
+
+        const std::vector<std::int64_t> lengths(dims.begin(), dims.begin() + tRank);
+
+        checkedCall([&]
+        {
+          if (isDouble)
+          {
+            if (isReal)
+            {
+              mDescriptor.emplace<Descriptor<oneapi::mkl::dft::precision::DOUBLE,
+                                             oneapi::mkl::dft::domain::REAL>>(lengths);
+            }
+            else
+            {
+              mDescriptor.emplace<Descriptor<oneapi::mkl::dft::precision::DOUBLE,
+                                             oneapi::mkl::dft::domain::COMPLEX>>(lengths);
+            }
+          }
+          else
+          {
+            if (isReal)
+            {
+              mDescriptor.emplace<Descriptor<oneapi::mkl::dft::precision::SINGLE,
+                                             oneapi::mkl::dft::domain::REAL>>(lengths);
+            }
+            else
+            {
+              mDescriptor.emplace<Descriptor<oneapi::mkl::dft::precision::SINGLE,
+                                             oneapi::mkl::dft::domain::COMPLEX>>(lengths);
+            }
+          }
+
+          std::visit([&](auto& descriptor)
+          {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(descriptor)>, std::monostate>)
+            {
+              configure(descriptor);
+            }
+          }, mDescriptor);
+        });
+      }
+
+      /// @brief Destructor
+      ~Plan() = default;
+
+      /// @brief Inherit assignment operator
+      using Parent::operator=;
+
+      /**
+       * @brief Execute the plan
+       * @param src The source buffer
+       * @param dst The destination buffer
+       * @param execParams The execution parameters
+       */
+      void executeBackendImpl(View<void*> src, View<void*> dst, const afft::spst::gpu::ExecutionParameters& execParams) override
+      {
+        if (mDesc.useExternalWorkspace() && mWorkspaceSize > 0 && execParams.workspace == nullptr)
+        {
+          throw BackendError{Backend::mkl, "plan uses the external workspace, but no workspace was given"};
+        }
+
+        const std::vector<sycl::event> dependencies(execParams.dependencies.begin(), execParams.dependencies.end());
+
+        auto lock = lockExecution(mMutex);
+
+        sycl::event event = checkedCall([&]
+        {
+          return std::visit([&](auto& descriptor)
+          {
+            if constexpr (std::is_same_v<std::decay_t<decltype(descriptor)>, std::monostate>)
+            {
+              cxx::unreachable();
+              return sycl::event{};
+            }
+            else
+            {
+              if (mDesc.useExternalWorkspace() && mWorkspaceSize > 0 && execParams.workspace != mWorkspace)
+              {
+                using Real = typename DescriptorTraits<std::decay_t<decltype(descriptor)>>::Real;
+
+                descriptor.set_workspace(static_cast<Real*>(execParams.workspace));
+
+                mWorkspace = execParams.workspace;
+              }
+
+              return compute(descriptor, src.front(), dst.front(), dependencies);
+            }
+          }, mDescriptor);
+        });
+
+        if (execParams.completionEvent != nullptr)
+        {
+          *execParams.completionEvent = std::move(event);
+        }
+      }
+
+      /**
+       * @brief Get the workspace size
+       * @return The workspace size
+       */
+      [[nodiscard]] constexpr View<std::size_t> getWorkspaceSize() const noexcept override
+      {
+        return {&mWorkspaceSize, 1};
+      }
+    private:
+      /**
+       * @brief Configure and commit the descriptor
+       * @tparam DescriptorT The descriptor type
+       * @param descriptor The descriptor
+       */
+      template<typename DescriptorT>
+      void configure(DescriptorT& descriptor)
+      {
+        using Real = typename DescriptorTraits<DescriptorT>::Real;
+
+        namespace dft = oneapi::mkl::dft;
+
+        const auto& gpuDesc      = mDesc.getArchDesc<Target::gpu, Distribution::spst>();
+        const auto& memoryLayout = gpuDesc.memoryLayout;
+        const bool  isForward    = (mDesc.getDirection() == Direction::forward);
+
+        // the forward domain is the source of a forward transform and the destination of a backward one
+        const auto fwdStrides = (isForward) ? memoryLayout.getSrcStrides() : memoryLayout.getDstStrides();
+        const auto bwdStrides = (isForward) ? memoryLayout.getDstStrides() : memoryLayout.getSrcStrides();
+
+        const auto transformAxes = mDesc.getTransformAxes();
+
+        auto getMklStrides = [&](View<std::size_t> strides)
+        {
+          std::vector<std::int64_t> mklStrides(transformAxes.size() + 1);
+
+          for (std::size_t i{}; i < transformAxes.size(); ++i)
+          {
+            mklStrides[i + 1] = safeIntCast<std::int64_t>(strides[transformAxes[i]]);
+          }
+
+          return mklStrides;
+        };
+
+        descriptor.set_value(dft::config_param::FWD_STRIDES, getMklStrides(fwdStrides));
+        descriptor.set_value(dft::config_param::BWD_STRIDES, getMklStrides(bwdStrides));
+
+        if (const auto shapeRank = mDesc.getShapeRank(); shapeRank > transformAxes.size())
+        {
+          std::size_t howManyAxis{};
+
+          while (std::find(transformAxes.begin(), transformAxes.end(), howManyAxis) != transformAxes.end())
+          {
+            ++howManyAxis;
+          }
+
+          descriptor.set_value(dft::config_param::NUMBER_OF_TRANSFORMS,
+                               safeIntCast<std::int64_t>(mDesc.getShape()[howManyAxis]));
+          descriptor.set_value(dft::config_param::FWD_DISTANCE, safeIntCast<std::int64_t>(fwdStrides[howManyAxis]));
+          descriptor.set_value(dft::config_param::BWD_DISTANCE, safeIntCast<std::int64_t>(bwdStrides[howManyAxis]));
+        }
+
+        descriptor.set_value(dft::config_param::PLACEMENT,
+                             (mDesc.getPlacement() == Placement::inPlace)
+                               ? dft::config_value::INPLACE : dft::config_value::NOT_INPLACE);
+
+        descriptor.set_value((isForward) ? dft::config_param::FORWARD_SCALE : dft::config_param::BACKWARD_SCALE,
+                             mDesc.getNormalizationFactor<Real>());
+
+        if (mDesc.useExternalWorkspace())
+        {
+          descriptor.set_value(dft::config_param::WORKSPACE_PLACEMENT, dft::config_value::WORKSPACE_EXTERNAL);
+        }
+
+        descriptor.commit(*gpuDesc.queue);
+
+        if (mDesc.useExternalWorkspace())
+        {
+          std::int64_t workspaceSize{};
+
+          descriptor.get_value(dft::config_param::WORKSPACE_EXTERNAL_BYTES, &workspaceSize);
+
+          mWorkspaceSize = safeIntCast<std::size_t>(workspaceSize);
+        }
+      }
+
+      /**
+       * @brief Submit the transform to the queue
+       * @tparam DescriptorT The descriptor type
+       * @param descriptor The descriptor
+       * @param src The source buffer
+       * @param dst The destination buffer
+       * @param dependencies The events the transform waits for
+       * @return The event of the transform
+       */
+      template<typename DescriptorT>
+      [[nodiscard]] sycl::event compute(DescriptorT&                    descriptor,
+                                        void*                           src,
+                                        void*                           dst,
+                                        const std::vector<sycl::event>& dependencies) const
+      {
+        using Real    = typename DescriptorTraits<DescriptorT>::Real;
+        using Complex = typename DescriptorTraits<DescriptorT>::Complex;
+
+        const bool isInPlace = (mDesc.getPlacement() == Placement::inPlace);
+
+        switch (mDesc.getTransformDesc<Transform::dft>().type)
+        {
+        case dft::Type::complexToComplex:
+          if (mDesc.getDirection() == Direction::forward)
+          {
+            return (isInPlace)
+                     ? oneapi::mkl::dft::compute_forward(descriptor, static_cast<Complex*>(src), dependencies)
+                     : oneapi::mkl::dft::compute_forward(descriptor,
+                                                         static_cast<Complex*>(src),
+                                                         static_cast<Complex*>(dst),
+                                                         dependencies);
+          }
+          else
+          {
+            return (isInPlace)
+                     ? oneapi::mkl::dft::compute_backward(descriptor, static_cast<Complex*>(src), dependencies)
+                     : oneapi::mkl::dft::compute_backward(descriptor,
+                                                          static_cast<Complex*>(src),
+                                                          static_cast<Complex*>(dst),
+                                                          dependencies);
+          }
+        case dft::Type::realToComplex:
+          return (isInPlace)
+                   ? oneapi::mkl::dft::compute_forward(descriptor, static_cast<Real*>(src), dependencies)
+                   : oneapi::mkl::dft::compute_forward(descriptor,
+                                                       static_cast<Real*>(src),
+                                                       static_cast<Complex*>(dst),
+                                                       dependencies);
+        case dft::Type::complexToReal:
+          return (isInPlace)
+                   ? oneapi::mkl::dft::compute_backward(descriptor, static_cast<Real*>(src), dependencies)
+                   : oneapi::mkl::dft::compute_backward(descriptor,
+                                                        static_cast<Complex*>(src),
+                                                        static_cast<Real*>(dst),
+                                                        dependencies);
+        default:
+          cxx::unreachable();
+        }
+      }
+
+      DescriptorVariant mDescriptor{};    ///< The oneMKL descriptor
+      std::size_t       mWorkspaceSize{}; ///< The external workspace size
+      void*             mWorkspace{};     ///< The external workspace set to the descriptor
+      std::mutex        mMutex{};         ///< Guards the workspace set to the descriptor
+  };
+
+  /**
+   * @brief Create a mkl spst gpu plan implementation.
+   * @param desc Plan description.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] AFFT_HEADER_ONLY_INLINE std::unique_ptr<afft::Plan> makePlan(const Desc& desc)
+  {
+    return std::make_unique<Plan>(desc);
+  }
+} // namespace afft::detail::mkl::spst::gpu
+
+#endif /* AFFT_HEADER_ONLY */
+
+#endif /* AFFT_ENABLE_SYCL */
+
+#endif /* AFFT_DETAIL_MKL_SPST_HPP */
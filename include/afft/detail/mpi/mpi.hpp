@@ -0,0 +1,84 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_MPI_MPI_HPP
+#define AFFT_DETAIL_MPI_MPI_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "error.hpp"
+
+namespace afft::detail::mpi
+{
+  /**
+   * @brief Check if a communicator is valid.
+   * @param comm The communicator to check.
+   * @return True if the communicator is valid, false otherwise.
+   */
+  [[nodiscard]] inline bool isValidComm(MPI_Comm comm)
+  {
+    return comm != MPI_COMM_NULL;
+  }
+
+  /**
+   * @brief Check if the MPI library can exchange GPU memory directly. Open MPI and MPICH are queried through their
+   *        extensions, Cray MPICH through the MPICH_GPU_SUPPORT_ENABLED environment variable.
+   * @return True if the MPI library is GPU aware, false otherwise.
+   */
+  [[nodiscard]] inline bool isGpuAware()
+  {
+# if defined(AFFT_ENABLE_CUDA) && defined(MPIX_CUDA_AWARE_SUPPORT) && MPIX_CUDA_AWARE_SUPPORT
+    if (MPIX_Query_cuda_support() == 1)
+    {
+      return true;
+    }
+# elif defined(AFFT_ENABLE_HIP) && defined(MPIX_ROCM_AWARE_SUPPORT) && MPIX_ROCM_AWARE_SUPPORT
+    if (MPIX_Query_rocm_support() == 1)
+    {
+      return true;
+    }
+# elif defined(MPIX_GPU_SUPPORT_CUDA) && (defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP))
+    int supported{};
+#   if defined(AFFT_ENABLE_CUDA)
+    const int result = MPIX_GPU_query_support(MPIX_GPU_SUPPORT_CUDA, &supported);
+#   else
+    const int result = MPIX_GPU_query_support(MPIX_GPU_SUPPORT_HIP, &supported);
+#   endif
+
+    if (isOk(result) && supported)
+    {
+      return true;
+    }
+# endif
+
+    const char* craySupport = std::getenv("MPICH_GPU_SUPPORT_ENABLED");
+
+    return craySupport != nullptr && std::string_view{craySupport} == "1";
+  }
+} // namespace afft::detail::mpi
+
+#endif /* AFFT_DETAIL_MPI_MPI_HPP */
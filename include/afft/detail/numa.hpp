@@ -0,0 +1,302 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_NUMA_HPP
+#define AFFT_DETAIL_NUMA_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "../Span.hpp"
+
+namespace afft::detail::numa
+{
+  /**
+   * @brief Parse a sysfs cpu or node list, e.g. "0-3,8-11".
+   * @param list The list.
+   * @return The parsed indices.
+   */
+  [[nodiscard]] inline std::vector<unsigned> parseList(std::string_view list)
+  {
+    std::vector<unsigned> indices{};
+
+    while (!list.empty())
+    {
+      const auto comma = list.find(',');
+      auto       range = list.substr(0, comma);
+
+      list = (comma == std::string_view::npos) ? std::string_view{} : list.substr(comma + 1);
+
+      while (!range.empty() && std::isspace(static_cast<unsigned char>(range.back())))
+      {
+        range.remove_suffix(1);
+      }
+
+      if (range.empty())
+      {
+        continue;
+      }
+
+      const auto dash  = range.find('-');
+      const auto first = static_cast<unsigned>(std::stoul(std::string{range.substr(0, dash)}));
+      const auto last  = (dash == std::string_view::npos)
+                           ? first : static_cast<unsigned>(std::stoul(std::string{range.substr(dash + 1)}));
+
+      for (unsigned i = first; i <= last; ++i)
+      {
+        indices.push_back(i);
+      }
+    }
+
+    return indices;
+  }
+
+  /**
+   * @brief Read a sysfs list file.
+   * @param path The file path.
+   * @return The parsed indices, empty if the file cannot be read.
+   */
+  [[nodiscard]] inline std::vector<unsigned> readList(const std::string& path)
+  {
+    std::ifstream file{path};
+    std::string   line{};
+
+    if (!file || !std::getline(file, line))
+    {
+      return {};
+    }
+
+    try
+    {
+      return parseList(line);
+    }
+    catch (const std::exception&)
+    {
+      return {};
+    }
+  }
+
+  /// @brief NUMA node.
+  struct Node
+  {
+    unsigned              index{}; ///< The node index.
+    std::vector<unsigned> cpus{};  ///< The cpus of the node.
+  };
+
+  /**
+   * @brief Get the online NUMA nodes with cpus. Without NUMA information a single node holding all cpus is reported.
+   * @return The nodes.
+   */
+  [[nodiscard]] inline const std::vector<Node>& getNodes()
+  {
+    static const std::vector<Node> nodes = []
+    {
+      std::vector<Node> onlineNodes{};
+
+#   if defined(__linux__)
+      for (const auto index : readList("/sys/devices/system/node/online"))
+      {
+        auto cpus = readList("/sys/devices/system/node/node" + std::to_string(index) + "/cpulist");
+
+        if (!cpus.empty())
+        {
+          onlineNodes.push_back(Node{index, std::move(cpus)});
+        }
+      }
+#   endif
+
+      if (onlineNodes.empty())
+      {
+        Node node{};
+        node.cpus.resize(std::max(std::thread::hardware_concurrency(), 1u));
+        std::iota(node.cpus.begin(), node.cpus.end(), 0u);
+
+        onlineNodes.push_back(std::move(node));
+      }
+
+      return onlineNodes;
+    }();
+
+    return nodes;
+  }
+
+  /**
+   * @brief Get the page size.
+   * @return The page size in bytes.
+   */
+  [[nodiscard]] inline std::size_t getPageSize() noexcept
+  {
+#   if defined(__linux__)
+    static const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+    return pageSize;
+#   else
+    return 4096;
+#   endif
+  }
+
+  /**
+   * @brief Map whole pages not touched yet, so the placement policy applies to all of them.
+   * @param size The size in bytes.
+   * @return The page aligned memory.
+   */
+  [[nodiscard]] inline void* mapPages(std::size_t size)
+  {
+#   if defined(__linux__)
+    void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (ptr == MAP_FAILED)
+    {
+      throw std::bad_alloc{};
+    }
+
+    return ptr;
+#   else
+    return ::operator new(size, std::align_val_t{getPageSize()});
+#   endif
+  }
+
+  /**
+   * @brief Unmap the pages mapped by mapPages().
+   * @param ptr The memory.
+   * @param size The size in bytes.
+   */
+  inline void unmapPages(void* ptr, [[maybe_unused]] std::size_t size) noexcept
+  {
+#   if defined(__linux__)
+    ::munmap(ptr, size);
+#   else
+    ::operator delete(ptr, std::align_val_t{getPageSize()});
+#   endif
+  }
+
+  /**
+   * @brief Set the memory policy of a page aligned range. The placement is a hint, failures are ignored, e.g. when
+   *        the process is not allowed to change the policy.
+   * @param ptr The page aligned memory.
+   * @param size The size in bytes.
+   * @param mode The memory policy mode.
+   * @param nodes The node indices of the policy.
+   */
+  inline void bind([[maybe_unused]] void*          ptr,
+                   [[maybe_unused]] std::size_t    size,
+                   [[maybe_unused]] int            mode,
+                   [[maybe_unused]] View<unsigned> nodes) noexcept
+  {
+#   if defined(__linux__) && defined(SYS_mbind)
+    if (size == 0 || nodes.empty())
+    {
+      return;
+    }
+
+    constexpr std::size_t bitsPerMask = sizeof(unsigned long) * CHAR_BIT;
+
+    const std::size_t maxNode = *std::max_element(nodes.begin(), nodes.end()) + 1;
+
+    std::vector<unsigned long> mask((maxNode + bitsPerMask - 1) / bitsPerMask);
+
+    for (const auto node : nodes)
+    {
+      mask[node / bitsPerMask] |= 1ul << (node % bitsPerMask);
+    }
+
+    ::syscall(SYS_mbind, ptr, size, mode, mask.data(), maxNode + 1, 0u);
+#   endif
+  }
+
+  /**
+   * @brief Interleave the pages of the range round robin over all nodes.
+   * @param ptr The page aligned memory.
+   * @param size The size in bytes.
+   */
+  inline void bindInterleaved([[maybe_unused]] void* ptr, [[maybe_unused]] std::size_t size) noexcept
+  {
+#   if defined(__linux__)
+    const auto& nodes = getNodes();
+
+    if (nodes.size() > 1)
+    {
+      std::vector<unsigned> indices(nodes.size());
+      std::transform(nodes.begin(), nodes.end(), indices.begin(), [](const Node& node) { return node.index; });
+
+      bind(ptr, size, MPOL_INTERLEAVE, indices);
+    }
+#   endif
+  }
+
+  /**
+   * @brief Split the range into one contiguous block per node in the node order, the pages of each block are
+   *        preferably placed on its node.
+   * @param ptr The page aligned memory.
+   * @param size The size in bytes.
+   */
+  inline void bindBlocked([[maybe_unused]] void* ptr, [[maybe_unused]] std::size_t size) noexcept
+  {
+#   if defined(__linux__)
+    const auto& nodes     = getNodes();
+    const auto  nodeCount = nodes.size();
+    const auto  pageCount = (size + getPageSize() - 1) / getPageSize();
+
+    if (nodeCount <= 1)
+    {
+      return;
+    }
+
+    for (std::size_t i{}; i < nodeCount; ++i)
+    {
+      const auto firstPage = pageCount * i / nodeCount;
+      const auto lastPage  = pageCount * (i + 1) / nodeCount;
+
+      bind(static_cast<std::byte*>(ptr) + firstPage * getPageSize(),
+           (lastPage - firstPage) * getPageSize(),
+           MPOL_PREFERRED,
+           View<unsigned>{&nodes[i].index, 1});
+    }
+#   endif
+  }
+
+  /**
+   * @brief Pin the calling thread to a cpu, failures are ignored.
+   * @param cpu The cpu index.
+   */
+  inline void pinCurrentThread([[maybe_unused]] unsigned cpu) noexcept
+  {
+#   if defined(__linux__)
+    if (cpu >= CPU_SETSIZE)
+    {
+      return;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet);
+#   endif
+  }
+} // namespace afft::detail::numa
+
+#endif /* AFFT_DETAIL_NUMA_HPP */
@@ -0,0 +1,284 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_PERF_COUNTERS_HPP
+#define AFFT_DETAIL_PERF_COUNTERS_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+namespace afft::detail::perf
+{
+  /// @brief Size of a cache line filled from the memory by a last level cache miss.
+  inline constexpr std::uint64_t cacheLineSize{64};
+
+  /// @brief Hardware counter values.
+  struct Counters
+  {
+    std::uint64_t cycles{};       ///< CPU cycles.
+    std::uint64_t instructions{}; ///< Retired instructions.
+    std::uint64_t llcMisses{};    ///< Last level cache misses.
+
+    /// @brief Accumulate the counters.
+    Counters& operator+=(const Counters& other) noexcept
+    {
+      cycles       += other.cycles;
+      instructions += other.instructions;
+      llcMisses    += other.llcMisses;
+      return *this;
+    }
+
+    /// @brief Get the counters elapsed since the earlier values, wrapped counters count zero.
+    [[nodiscard]] friend Counters operator-(const Counters& lhs, const Counters& rhs) noexcept
+    {
+      auto sub = [](std::uint64_t a, std::uint64_t b) { return (a > b) ? a - b : std::uint64_t{}; };
+
+      return Counters{sub(lhs.cycles, rhs.cycles),
+                      sub(lhs.instructions, rhs.instructions),
+                      sub(lhs.llcMisses, rhs.llcMisses)};
+    }
+  };
+
+  /**
+   * @class Sampler
+   * @brief Process wide sampler of the user space hardware counters of all the threads of the process. A perf_event
+   *        group (cycles, instructions, cache misses) is opened for each thread on the first sample it is seen in and
+   *        keeps counting, a sample reads all the groups. Counters of threads exiting between two samples are
+   *        lost. If perf_event is not permitted (see perf_event_paranoid) all the counters read zero. The sampler is
+   *        thread safe, concurrent work of other threads is counted as well.
+   */
+  class Sampler
+  {
+    public:
+      /// @brief Get the sampler instance.
+      [[nodiscard]] static Sampler& get()
+      {
+        static Sampler sampler{};
+        return sampler;
+      }
+
+      /// @brief Copy constructor is deleted.
+      Sampler(const Sampler&) = delete;
+
+      /// @brief Move constructor is deleted.
+      Sampler(Sampler&&) = delete;
+
+      /// @brief Destructor. Closes the counter groups.
+      ~Sampler()
+      {
+        for (auto& [tid, group] : mGroups)
+        {
+          closeGroup(group);
+        }
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      Sampler& operator=(const Sampler&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      Sampler& operator=(Sampler&&) = delete;
+
+      /**
+       * @brief Read the counters summed over the threads of the process, threads not seen before start counting.
+       * @return Counter values, pass the difference of two samples as the counters of the work between them.
+       */
+      [[nodiscard]] Counters sample()
+      {
+        std::lock_guard lock{mMutex};
+
+        if (!mAvailable)
+        {
+          return Counters{};
+        }
+
+        openNewThreads();
+
+        Counters counters{};
+
+        for (auto it = mGroups.begin(); it != mGroups.end();)
+        {
+          if (readGroup(it->second))
+          {
+            counters += it->second.last;
+            ++it;
+          }
+          else
+          {
+            // the thread has exited, keep its last values so the sum does not decrease
+            mExited += it->second.last;
+            closeGroup(it->second);
+            it = mGroups.erase(it);
+          }
+        }
+
+        return counters += mExited;
+      }
+    private:
+      /// @brief Counter group of a thread.
+      struct Group
+      {
+        std::array<int, 3> fds{-1, -1, -1}; ///< Counter file descriptors, the first one is the group leader.
+        Counters           last{};          ///< Last read values.
+      };
+
+      /// @brief Default constructor, opens the calling thread to probe the availability.
+      Sampler()
+      {
+        const auto tid = static_cast<pid_t>(::syscall(SYS_gettid));
+
+        Group group{};
+
+        mAvailable = openGroup(tid, group);
+
+        if (mAvailable)
+        {
+          mGroups.emplace(tid, group);
+        }
+      }
+
+      /**
+       * @brief Open a counter of the thread.
+       * @param tid Thread id.
+       * @param config Hardware event.
+       * @param groupFd Group leader file descriptor, -1 for the leader.
+       * @return File descriptor, -1 on failure.
+       */
+      [[nodiscard]] static int openCounter(pid_t tid, std::uint64_t config, int groupFd) noexcept
+      {
+        perf_event_attr attr{};
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.config         = config;
+        attr.read_format    = PERF_FORMAT_GROUP;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, tid, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+      }
+
+      /**
+       * @brief Open the counter group of the thread.
+       * @param tid Thread id.
+       * @param group Group to be opened.
+       * @return True if all the counters were opened, false otherwise.
+       */
+      [[nodiscard]] static bool openGroup(pid_t tid, Group& group) noexcept
+      {
+        static constexpr std::array<std::uint64_t, 3> configs{PERF_COUNT_HW_CPU_CYCLES,
+                                                              PERF_COUNT_HW_INSTRUCTIONS,
+                                                              PERF_COUNT_HW_CACHE_MISSES};
+
+        for (std::size_t i{}; i < configs.size(); ++i)
+        {
+          group.fds[i] = openCounter(tid, configs[i], group.fds[0]);
+
+          if (group.fds[i] < 0)
+          {
+            closeGroup(group);
+            return false;
+          }
+        }
+
+        return readGroup(group);
+      }
+
+      /**
+       * @brief Read the counters of the group.
+       * @param group Group.
+       * @return True if the group was read, false if the thread has exited.
+       */
+      [[nodiscard]] static bool readGroup(Group& group) noexcept
+      {
+        std::array<std::uint64_t, 4> values{};
+
+        if (::read(group.fds[0], values.data(), sizeof(values)) != static_cast<ssize_t>(sizeof(values)) ||
+            values[0] != 3)
+        {
+          return false;
+        }
+
+        group.last = Counters{values[1], values[2], values[3]};
+
+        return true;
+      }
+
+      /**
+       * @brief Close the counters of the group.
+       * @param group Group.
+       */
+      static void closeGroup(Group& group) noexcept
+      {
+        for (auto& fd : group.fds)
+        {
+          if (fd >= 0)
+          {
+            ::close(fd);
+            fd = -1;
+          }
+        }
+      }
+
+      /// @brief Open the counter groups of the threads not seen before, the mutex must be locked.
+      void openNewThreads()
+      {
+        DIR* dir = ::opendir("/proc/self/task");
+
+        if (dir == nullptr)
+        {
+          return;
+        }
+
+        while (const dirent* entry = ::readdir(dir))
+        {
+          if (entry->d_name[0] == '.')
+          {
+            continue;
+          }
+
+          const auto tid = static_cast<pid_t>(std::strtol(entry->d_name, nullptr, 10));
+
+          if (mGroups.find(tid) == mGroups.end())
+          {
+            Group group{};
+
+            if (openGroup(tid, group))
+            {
+              mGroups.emplace(tid, group);
+            }
+          }
+        }
+
+        ::closedir(dir);
+      }
+
+      std::mutex                       mMutex{};     ///< Guards the groups.
+      bool                             mAvailable{}; ///< True if perf_event counters can be opened.
+      std::unordered_map<pid_t, Group> mGroups{};    ///< Counter groups of the threads.
+      Counters                         mExited{};    ///< Last values of the exited threads.
+  };
+} // namespace afft::detail::perf
+
+#endif /* AFFT_DETAIL_PERF_COUNTERS_HPP */
@@ -0,0 +1,211 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_POCKETFFT_LINE_ITERATOR_HPP
+#define AFFT_DETAIL_POCKETFFT_LINE_ITERATOR_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+#include "../common.hpp"
+
+namespace afft::detail::pocketfft
+{
+  /// @brief Number of lines transformed at once by the pocketfft SIMD types, 1 if pocketfft has no vector support.
+  template<typename R>
+#ifndef POCKETFFT_NO_VECTORS
+  inline constexpr std::size_t laneCount = ::pocketfft::detail::VLEN<R>::val;
+#else
+  inline constexpr std::size_t laneCount = 1;
+#endif
+
+  /**
+   * @brief Get the value of a lane of a pocketfft SIMD value.
+   * @tparam VecT The SIMD or the scalar type.
+   * @param vec The value.
+   * @param lane The lane.
+   * @return The value of the lane.
+   */
+  template<typename VecT>
+  [[nodiscard]] auto getLane(const VecT& vec, [[maybe_unused]] std::size_t lane) noexcept
+  {
+    if constexpr (std::is_floating_point_v<VecT>)
+    {
+      return vec;
+    }
+    else
+    {
+      return vec[lane];
+    }
+  }
+
+  /**
+   * @brief Set the value of a lane of a pocketfft SIMD value.
+   * @tparam VecT The SIMD or the scalar type.
+   * @tparam R The real type.
+   * @param vec The value.
+   * @param lane The lane.
+   * @param value The value of the lane.
+   */
+  template<typename VecT, typename R>
+  void setLane(VecT& vec, [[maybe_unused]] std::size_t lane, R value) noexcept
+  {
+    if constexpr (std::is_floating_point_v<VecT>)
+    {
+      vec = value;
+    }
+    else
+    {
+      vec[lane] = value;
+    }
+  }
+
+  /**
+   * @class LineIterator
+   * @brief Iterates the lines of an axis of a strided array in row-major order of the other axes.
+   */
+  class LineIterator
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param shape The shape of the array.
+       * @param axis The axis of the lines.
+       * @param inStrides The input strides in bytes.
+       * @param outStrides The output strides in bytes.
+       * @param line The index of the first line.
+       */
+      LineIterator(const ::pocketfft::shape_t&  shape,
+                   std::size_t                  axis,
+                   const ::pocketfft::stride_t& inStrides,
+                   const ::pocketfft::stride_t& outStrides,
+                   std::size_t                  line)
+      : mShape{shape}, mAxis{axis}, mInStrides{inStrides}, mOutStrides{outStrides}
+      {
+        for (std::size_t i = mShape.size(); i-- > 0;)
+        {
+          if (i != mAxis)
+          {
+            mIndex[i]   = line % mShape[i];
+            line       /= mShape[i];
+            mInOffset  += static_cast<std::ptrdiff_t>(mIndex[i]) * mInStrides[i];
+            mOutOffset += static_cast<std::ptrdiff_t>(mIndex[i]) * mOutStrides[i];
+          }
+        }
+      }
+
+      /**
+       * @brief Get the input offset of the current line.
+       * @return The offset in bytes.
+       */
+      [[nodiscard]] std::ptrdiff_t getInOffset() const noexcept
+      {
+        return mInOffset;
+      }
+
+      /**
+       * @brief Get the output offset of the current line.
+       * @return The offset in bytes.
+       */
+      [[nodiscard]] std::ptrdiff_t getOutOffset() const noexcept
+      {
+        return mOutOffset;
+      }
+
+      /// @brief Move to the next line.
+      void advance() noexcept
+      {
+        for (std::size_t i = mShape.size(); i-- > 0;)
+        {
+          if (i != mAxis)
+          {
+            mInOffset  += mInStrides[i];
+            mOutOffset += mOutStrides[i];
+
+            if (++mIndex[i] < mShape[i])
+            {
+              return;
+            }
+
+            mInOffset  -= static_cast<std::ptrdiff_t>(mShape[i]) * mInStrides[i];
+            mOutOffset -= static_cast<std::ptrdiff_t>(mShape[i]) * mOutStrides[i];
+            mIndex[i]   = 0;
+          }
+        }
+      }
+    private:
+      const ::pocketfft::shape_t&  mShape;       ///< The shape of the array
+      std::size_t                  mAxis{};      ///< The axis of the lines
+      const ::pocketfft::stride_t& mInStrides;   ///< The input strides in bytes
+      const ::pocketfft::stride_t& mOutStrides;  ///< The output strides in bytes
+      MaxDimArray<std::size_t>     mIndex{};     ///< The index of the current line
+      std::ptrdiff_t               mInOffset{};  ///< The input offset of the current line in bytes
+      std::ptrdiff_t               mOutOffset{}; ///< The output offset of the current line in bytes
+  };
+
+  /**
+   * @brief Group of lines transformed at once, one per SIMD lane.
+   * @tparam InT The input element type.
+   * @tparam OutT The output element type.
+   * @tparam lanes The number of lines.
+   */
+  template<typename InT, typename OutT, std::size_t lanes>
+  struct LineGroup
+  {
+    static constexpr std::size_t laneCount{lanes}; ///< The number of lines
+
+    const std::byte*                  in{};         ///< The input buffer
+    std::array<std::ptrdiff_t, lanes> inOffsets{};  ///< The input offsets of the lines in bytes
+    std::ptrdiff_t                    inStride{};   ///< The input stride along the lines in bytes
+    std::byte*                        out{};        ///< The output buffer
+    std::array<std::ptrdiff_t, lanes> outOffsets{}; ///< The output offsets of the lines in bytes
+    std::ptrdiff_t                    outStride{};  ///< The output stride along the lines in bytes
+
+    /**
+     * @brief Get an input element.
+     * @param lane The line.
+     * @param i The index along the line.
+     * @return The element.
+     */
+    [[nodiscard]] const InT& load(std::size_t lane, std::size_t i) const noexcept
+    {
+      return *reinterpret_cast<const InT*>(in + inOffsets[lane] + static_cast<std::ptrdiff_t>(i) * inStride);
+    }
+
+    /**
+     * @brief Get an output element.
+     * @param lane The line.
+     * @param i The index along the line.
+     * @return The element.
+     */
+    [[nodiscard]] OutT& store(std::size_t lane, std::size_t i) const noexcept
+    {
+      return *reinterpret_cast<OutT*>(out + outOffsets[lane] + static_cast<std::ptrdiff_t>(i) * outStride);
+    }
+  };
+} // namespace afft::detail::pocketfft
+
+#endif /* AFFT_DETAIL_POCKETFFT_LINE_ITERATOR_HPP */
@@ -34,6 +34,42 @@
 
 namespace afft::detail::pocketfft
 {
+  /**
+   * @brief Check if the plan may be supported by the pocketfft backend, without any side effects.
+   * @param desc Plan description.
+   * @return Backend support, the reason of the rejection if the plan is not supported.
+   */
+  [[nodiscard]] inline BackendSupport supports(const Desc& desc)
+  {
+    if (desc.getComplexFormat() != ComplexFormat::interleaved)
+    {
+      return BackendSupport{"only interleaved complex format is supported"};
+    }
+
+    if (desc.getTarget() != Target::cpu)
+    {
+      return BackendSupport{"only cpu target is supported"};
+    }
+
+    if (desc.getDistribution() != Distribution::spst)
+    {
+      return BackendSupport{"only spst distribution is supported"};
+    }
+
+    if (!desc.hasUniformPrecision())
+    {
+      return BackendSupport{"only same precision for execution, source and destination is supported"};
+    }
+
+    if (const auto prec = desc.getPrecision().execution;
+        prec != Precision::_float && prec != Precision::_double && prec != Precision::_longDouble)
+    {
+      return BackendSupport{"unsupported precision"};
+    }
+
+    return BackendSupport{};
+  }
+
   /**
    * @brief Create a plan implementation.
    * @tparam BackendParamsT Backend parameters type.
@@ -45,11 +81,11 @@ namespace afft::detail::pocketfft
   [[nodiscard]] std::unique_ptr<afft::Plan>
   makePlan(const Desc& desc, const BackendParamsT&)
   {
-    if (desc.getComplexFormat() != ComplexFormat::interleaved)
+    if (const auto support = supports(desc); !support)
     {
-      throw BackendError{Backend::pocketfft, "only interleaved complex format is supported"};
+      throw BackendError{Backend::pocketfft, support.reason};
     }
-    
+
     if constexpr (BackendParamsT::target == Target::cpu)
     {
       if constexpr (BackendParamsT::distribution == Distribution::spst)
@@ -29,7 +29,9 @@
 # include "../include.hpp"
 #endif
 
+#include "../../alloc.hpp"
 #include "../../Plan.hpp"
+#include "../../utils.hpp"
 
 namespace afft::detail::pocketfft::spst::cpu
 {
@@ -43,10 +45,18 @@ namespace afft::detail::pocketfft::spst::cpu
 
 #ifdef AFFT_HEADER_ONLY
 
+#include "LineIterator.hpp"
 #include "Plan.hpp"
 
 namespace afft::detail::pocketfft::spst::cpu
 {
+  /// @brief Minimum length of a complex axis computed by the four-step decomposition when the axis has fewer lines
+  ///        than threads, pocketfft threads only across the lines.
+  inline constexpr std::size_t fourStepMinLength{std::size_t{1} << 16};
+
+  /// @brief Minimum length of both factors of the four-step decomposition.
+  inline constexpr std::size_t fourStepMinFactor{16};
+
   /**
    * @class Plan
    * @tparam prec The precision of the data.
@@ -59,77 +69,1090 @@ namespace afft::detail::pocketfft::spst::cpu
       /// @brief Alias for the parent class
       using Parent = pocketfft::Plan;
 
-      /// @brief Alias for the real type
-      using R = PrecT;
+      /// @brief Alias for the real type
+      using R = PrecT;
+
+      /// @brief Alias for the interleaved complex type
+      using C = std::complex<PrecT>;
+
+      /// @brief Alias for the pocketfft complex plan
+      using CPlan = ::pocketfft::detail::pocketfft_c<R>;
+
+      /// @brief Alias for the pocketfft real plan
+      using RPlan = ::pocketfft::detail::pocketfft_r<R>;
+
+      /// @brief Alias for the pocketfft DCT-I plan
+      using Dct1Plan = ::pocketfft::detail::T_dct1<R>;
+
+      /// @brief Alias for the pocketfft DST-I plan
+      using Dst1Plan = ::pocketfft::detail::T_dst1<R>;
+
+      /// @brief Alias for the pocketfft DCT-II, DCT-III, DST-II and DST-III plan
+      using Dcst23Plan = ::pocketfft::detail::T_dcst23<R>;
+
+      /// @brief Alias for the pocketfft DCT-IV and DST-IV plan
+      using Dcst4Plan = ::pocketfft::detail::T_dcst4<R>;
+
+      /// @brief The pocketfft plan of a transformed axis, plans of the same type and length are shared by the axes
+      using AxisPlan = std::variant<std::monostate,
+                                    std::shared_ptr<const CPlan>,
+                                    std::shared_ptr<const RPlan>,
+                                    std::shared_ptr<const Dct1Plan>,
+                                    std::shared_ptr<const Dst1Plan>,
+                                    std::shared_ptr<const Dcst23Plan>,
+                                    std::shared_ptr<const Dcst4Plan>>;
+    public:
+      /// @brief inherit constructors
+      using Parent::Parent;
+
+      /**
+       * @brief Constructor
+       * @param Desc The plan description
+       */
+      Plan(const Desc& desc)
+      : Parent{desc},
+        mShape{mDesc.getShape().begin(), mDesc.getShape().end()},
+        mSrcStrides(mShape.size()),
+        mDstStrides(mShape.size()),
+        mAxes{mDesc.getTransformAxes().begin(), mDesc.getTransformAxes().end()}
+      {
+        mDesc.fillDefaultMemoryLayoutStrides();
+
+        const auto& memLayout = mDesc.template getMemoryLayout<Distribution::spst>();
+
+        std::transform(memLayout.getSrcStrides().begin(),
+                       memLayout.getSrcStrides().end(),
+                       mSrcStrides.begin(),
+                       [this](const auto stride)
+        {
+          return safeIntCast<std::ptrdiff_t>(stride * mDesc.sizeOfSrcElem());
+        });
+
+        std::transform(memLayout.getDstStrides().begin(),
+                       memLayout.getDstStrides().end(),
+                       mDstStrides.begin(),
+                       [this](const auto stride)
+        {
+          return safeIntCast<std::ptrdiff_t>(stride * mDesc.sizeOfDstElem());
+        });
+
+        const auto& cpuDesc = mDesc.template getArchDesc<Target::cpu, Distribution::spst>();
+
+        mNumaSplit = cpuDesc.numaSplit;
+
+        // The batch is split along the longest axis that is not transformed, with numa split along the outermost one,
+        // so the parts are contiguous blocks of memory
+        for (std::size_t i{}; i < mShape.size(); ++i)
+        {
+          if (std::find(mAxes.begin(), mAxes.end(), i) == mAxes.end())
+          {
+            const auto isOuter = [&](const auto& strides)
+            {
+              return std::abs(strides[i]) > std::abs(strides[*mSplitAxis]);
+            };
+
+            if (!mSplitAxis ||
+                (mNumaSplit && isOuter(mSrcStrides) && isOuter(mDstStrides)) ||
+                (!mNumaSplit && mShape[i] > mShape[*mSplitAxis]))
+            {
+              mSplitAxis = i;
+            }
+          }
+        }
+
+        makeFourStepAxes();
+
+        makeAxisPlans();
+
+        makeC2rBuffer();
+
+        reserveScratch(getExecThreadCount());
+
+        mBackendMemorySize = estimateBackendMemorySize();
+      }
+
+      /// @brief Default destructor
+      ~Plan() = default;
+
+      /// @brief Inherit assignment operator
+      using Parent::operator=;
+
+      /**
+       * @brief Execute the plan
+       * @param src The source buffer
+       * @param dst The destination buffer
+       */
+      void executeBackendImpl(View<void*> src, View<void*> dst, const afft::spst::cpu::ExecutionParameters&) override
+      {
+        const auto lock = lockExecution(mMutex);
+
+        reserveScratch(getExecThreadCount());
+
+        switch (mDesc.getTransform())
+        {
+        case Transform::dft:
+          execDft(src.front(), dst.front());
+          break;
+        case Transform::dht:
+          execDht(src.front(), dst.front());
+          break;
+        case Transform::dtt:
+          execDtt(src.front(), dst.front());
+          break;
+        default:
+          cxx::unreachable();
+        }
+      }
+
+      /**
+       * @brief Get the backend memory size. The pocketfft plans are held by the plan, the size of their twiddle factors
+       *        is estimated from the lengths transformed. The scratch buffers of the threads are included.
+       * @return The estimated size of the pocketfft plans and the buffers
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Get the backend feedback, reports how the source of a complex-to-real DFT is preserved.
+       * @return Backend feedback, empty if the source is not copied.
+       */
+      [[nodiscard]] std::string getBackendFeedback() const override
+      {
+        if (!mC2rBuffer)
+        {
+          return {};
+        }
+
+        return ((mIsC2rStaged) ? "source preserved by staging the complex axes in the destination, "
+                               : "source preserved by a copy of the spectrum, ") +
+               std::to_string(mC2rBufferSize) + " bytes extra";
+      }
+    protected:
+    private:
+      /// @brief Four-step decomposition of a long axis, n = n1 * n2.
+      struct FourStepAxis
+      {
+        std::size_t                  n1{};       ///< The length of the first pass transforms
+        std::size_t                  n2{};       ///< The length of the second pass transforms
+        std::vector<C>               twiddles{}; ///< The twiddle factors applied between the passes, n1 x n2 row-major
+        std::vector<C>               work{};     ///< The result of the first pass of a line
+        std::shared_ptr<const CPlan> plan1{};    ///< The plan of the first pass transforms
+        std::shared_ptr<const CPlan> plan2{};    ///< The plan of the second pass transforms
+      };
+
+      /// @brief Part of the batch transformed by one call.
+      struct BatchPart
+      {
+        const ::pocketfft::shape_t& shape;          ///< The shape of the part
+        std::size_t                 offset{};       ///< The offset of the part along the split axis
+        std::size_t                 threadCount{};  ///< The thread count of the part
+        std::size_t                 scratchIndex{}; ///< The scratch buffer of the first thread of the part
+      };
+
+      /**
+       * @brief Prepare the four-step decomposition of the long axes of a complex-to-complex DFT. The axis of length
+       *        n = n1 * n2 is computed as n2 transforms of length n1, a twiddle multiplication and n1 transforms of
+       *        length n2 stored transposed, both passes have enough lines to keep all threads busy.
+       */
+      void makeFourStepAxes()
+      {
+        mFourStep.resize(mShape.size());
+
+        if (mDesc.getTransform() != Transform::dft ||
+            mDesc.template getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex)
+        {
+          return;
+        }
+
+        constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+        const long double sign = (mDesc.getDirection() == Direction::forward) ? -1.0L : 1.0L;
+
+        for (const auto axis : mAxes)
+        {
+          const auto n = mShape[axis];
+
+          if (n < fourStepMinLength)
+          {
+            continue;
+          }
+
+          // the largest divisor not exceeding the square root keeps both passes as long as possible
+          std::size_t n1 = static_cast<std::size_t>(std::sqrt(static_cast<double>(n)));
+
+          while (n1 > 1 && n % n1 != 0)
+          {
+            --n1;
+          }
+
+          if (n1 < fourStepMinFactor)
+          {
+            continue;
+          }
+
+          auto& fourStep = mFourStep[axis].emplace();
+
+          fourStep.n1 = n1;
+          fourStep.n2 = n / n1;
+          fourStep.twiddles.resize(n);
+          fourStep.work.resize(n);
+
+          for (std::size_t k1{}; k1 < fourStep.n1; ++k1)
+          {
+            for (std::size_t j{}; j < fourStep.n2; ++j)
+            {
+              const long double angle = sign * 2.0L * pi * static_cast<long double>(k1 * j) / static_cast<long double>(n);
+
+              fourStep.twiddles[k1 * fourStep.n2 + j] = C{static_cast<R>(std::cos(angle)), static_cast<R>(std::sin(angle))};
+            }
+          }
+        }
+      }
+
+      /**
+       * @brief Make the pocketfft plans of the transformed axes and of the four-step passes. The real DFT transforms the
+       *        last axis by a real plan, the other ones by complex plans. The genuine Hartley transform is not
+       *        separable into lines, it is left to pocketfft.
+       */
+      void makeAxisPlans()
+      {
+        mAxisPlans.resize(mShape.size());
+
+        switch (mDesc.getTransform())
+        {
+        case Transform::dft:
+        {
+          const bool isReal = (mDesc.template getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex);
+
+          for (std::size_t i{}; i < mAxes.size(); ++i)
+          {
+            if (isReal && i + 1 == mAxes.size())
+            {
+              mAxisPlans[mAxes[i]] = makeLinePlan<RPlan>(mShape[mAxes[i]]);
+            }
+            else
+            {
+              mAxisPlans[mAxes[i]] = makeLinePlan<CPlan>(mShape[mAxes[i]]);
+            }
+          }
+
+          for (auto& fourStep : mFourStep)
+          {
+            if (fourStep)
+            {
+              fourStep->plan1 = makeLinePlan<CPlan>(fourStep->n1);
+              fourStep->plan2 = makeLinePlan<CPlan>(fourStep->n2);
+            }
+          }
+          break;
+        }
+        case Transform::dht:
+          if (mDesc.template getTransformDesc<Transform::dht>().type == dht::Type::separable)
+          {
+            for (const auto axis : mAxes)
+            {
+              mAxisPlans[axis] = makeLinePlan<RPlan>(mShape[axis]);
+            }
+          }
+          break;
+        case Transform::dtt:
+        {
+          const auto& dttDesc = mDesc.template getTransformDesc<Transform::dtt>();
+
+          for (std::size_t i{}; i < mAxes.size(); ++i)
+          {
+            const auto axis = mAxes[i];
+
+            switch (dttDesc.types[i])
+            {
+            case dtt::Type::dct1:
+              mAxisPlans[axis] = makeLinePlan<Dct1Plan>(mShape[axis]);
+              break;
+            case dtt::Type::dst1:
+              mAxisPlans[axis] = makeLinePlan<Dst1Plan>(mShape[axis]);
+              break;
+            case dtt::Type::dct2: case dtt::Type::dct3: case dtt::Type::dst2: case dtt::Type::dst3:
+              mAxisPlans[axis] = makeLinePlan<Dcst23Plan>(mShape[axis]);
+              break;
+            case dtt::Type::dct4: case dtt::Type::dst4:
+              mAxisPlans[axis] = makeLinePlan<Dcst4Plan>(mShape[axis]);
+              break;
+            default:
+              cxx::unreachable();
+            }
+          }
+          break;
+        }
+        default:
+          cxx::unreachable();
+        }
+      }
+
+      /**
+       * @brief Make the pocketfft plan of the lines of the given length, or share the one already made by the plan.
+       * @tparam LinePlanT The pocketfft plan type.
+       * @param length The length of the lines
+       * @return The pocketfft plan
+       */
+      template<typename LinePlanT>
+      [[nodiscard]] std::shared_ptr<const LinePlanT> makeLinePlan(std::size_t length)
+      {
+        mMaxLineLength = std::max(mMaxLineLength, length);
+
+        for (const auto& axisPlan : mAxisPlans)
+        {
+          if (const auto plan = std::get_if<std::shared_ptr<const LinePlanT>>(&axisPlan);
+              plan != nullptr && *plan != nullptr && (*plan)->length() == length)
+          {
+            return *plan;
+          }
+        }
+
+        if constexpr (std::is_same_v<LinePlanT, CPlan>)
+        {
+          for (const auto& fourStep : mFourStep)
+          {
+            if (fourStep)
+            {
+              for (const auto& plan : {fourStep->plan1, fourStep->plan2})
+              {
+                if (plan != nullptr && plan->length() == length)
+                {
+                  return plan;
+                }
+              }
+            }
+          }
+        }
+
+        std::shared_ptr<const LinePlanT> plan{};
+
+        safeCall([&]{ plan = std::make_shared<LinePlanT>(length); });
+
+        return plan;
+      }
+
+      /**
+       * @brief Get the pocketfft plan of the axis
+       * @tparam LinePlanT The pocketfft plan type.
+       * @param axis The axis
+       * @return The pocketfft plan
+       */
+      template<typename LinePlanT>
+      [[nodiscard]] const LinePlanT& getAxisPlan(std::size_t axis) const
+      {
+        return *std::get<std::shared_ptr<const LinePlanT>>(mAxisPlans[axis]);
+      }
+
+      /**
+       * @brief Make the buffer the complex axes of a multidimensional complex-to-real DFT are transformed into before
+       *        the real axis. Without the source preservation the complex axes are transformed in the source. An
+       *        out-of-place DFT with contiguous destination rows is staged, the complex axes of the columns with a
+       *        complex result are transformed into the destination rows in the halfcomplex order and only the columns
+       *        with a real result (0 and n / 2 of an even length) need the buffer, see execStagedC2r().
+       */
+      void makeC2rBuffer()
+      {
+        if (mDesc.getTransform() != Transform::dft ||
+            mDesc.template getTransformDesc<Transform::dft>().type != dft::Type::complexToReal ||
+            mAxes.size() < 2 ||
+            !mDesc.getPreserveSource())
+        {
+          return;
+        }
+
+        const auto realAxis = mAxes.back();
+
+        mIsC2rStaged = (mDesc.getPlacement() == Placement::outOfPlace &&
+                        mDstStrides[realAxis] == static_cast<std::ptrdiff_t>(sizeof(R)));
+
+        mC2rStrides.resize(mShape.size());
+
+        std::size_t elemCount{1};
+
+        for (std::size_t i = mShape.size(); i-- > 0;)
+        {
+          mC2rStrides[i]  = safeIntCast<std::ptrdiff_t>(elemCount * sizeof(C));
+
+          if (i != realAxis)
+          {
+            elemCount *= mShape[i];
+          }
+          else
+          {
+            elemCount *= (mIsC2rStaged) ? getC2rRealColumnCount() : mShape[i] / 2 + 1;
+          }
+        }
+
+        if (mIsC2rStaged)
+        {
+          // the real columns are copied to the destination by lines of their count
+          mMaxLineLength = std::max(mMaxLineLength, getC2rRealColumnCount());
+        }
+
+        mC2rBuffer     = afft::cpu::makeAlignedUnique<C[]>(Alignment::simd512, elemCount);
+        mC2rBufferSize = elemCount * sizeof(C);
+      }
+
+      /**
+       * @brief Get the number of columns of the real axis whose complex-to-real input is real, 0 and n / 2 of an even
+       *        length, 0 of an odd one.
+       * @return The number of columns
+       */
+      [[nodiscard]] std::size_t getC2rRealColumnCount() const
+      {
+        return (mShape[mAxes.back()] % 2 == 0) ? 2 : 1;
+      }
+
+      /**
+       * @brief Reserve the scratch buffers, each holds a group of the longest lines transformed by one thread.
+       * @param threadCount The thread count
+       */
+      void reserveScratch(std::size_t threadCount)
+      {
+        if (mMaxLineLength == 0)
+        {
+          return;
+        }
+
+        while (mScratch.size() < std::max(threadCount, std::size_t{1}))
+        {
+          mScratch.push_back(afft::cpu::makeAlignedUnique<C[]>(Alignment::simd512, laneCount<R> * mMaxLineLength));
+        }
+      }
+
+      /**
+       * @brief Get the number of lines of the axis, the transforms computed along it in one pass.
+       * @param axis The axis
+       * @return The number of lines
+       */
+      [[nodiscard]] std::size_t getLineCount(std::size_t axis) const
+      {
+        std::size_t lineCount{1};
+
+        for (std::size_t i{}; i < mShape.size(); ++i)
+        {
+          if (i != axis)
+          {
+            lineCount *= mShape[i];
+          }
+        }
+
+        return lineCount;
+      }
+
+      /**
+       * @brief Get the number of threads of the execution, the plan thread limit bounded by the thread pool size.
+       * @return The thread count
+       */
+      [[nodiscard]] std::size_t getExecThreadCount() const
+      {
+        const auto threadPool  = afft::cpu::getThreadPool();
+        const auto threadLimit = getThreadCount();
+
+        return (threadLimit == 0) ? threadPool->getThreadCount() : std::min(threadLimit, threadPool->getThreadCount());
+      }
+
+      /**
+       * @brief Estimate the memory of the pocketfft plans, the twiddle factors of each distinct length and the chirp
+       *        and inner plan of the lengths transformed by Bluestein's algorithm, and of the buffers of the plan.
+       * @return The estimated size in bytes
+       */
+      [[nodiscard]] std::size_t estimateBackendMemorySize() const
+      {
+        const bool isReal = (mDesc.getTransform() != Transform::dft ||
+                             mDesc.template getTransformDesc<Transform::dft>().type != dft::Type::complexToComplex);
+
+        std::vector<std::pair<std::size_t, bool>> lengths{};
+
+        for (std::size_t i{}; i < mAxes.size(); ++i)
+        {
+          // The real dft transforms the last axis by a real plan, the other ones by complex plans
+          const bool isRealAxis = isReal && (mDesc.getTransform() != Transform::dft || i + 1 == mAxes.size());
+
+          if (std::find(lengths.begin(), lengths.end(), std::make_pair(mShape[mAxes[i]], isRealAxis)) == lengths.end())
+          {
+            lengths.emplace_back(mShape[mAxes[i]], isRealAxis);
+          }
+        }
+
+        std::size_t size{};
+
+        for (const auto& [length, isRealAxis] : lengths)
+        {
+          size += (isRealAxis) ? length * sizeof(R) : length * sizeof(C);
+
+          if (afft::nextFastSize(length, Backend::pocketfft) != length)
+          {
+            const auto bluesteinLength = afft::nextFastSize(2 * length - 1, Backend::pocketfft);
+
+            size += (length + bluesteinLength / 2 + 1 + bluesteinLength) * sizeof(C);
+          }
+        }
+
+        for (const auto& fourStep : mFourStep)
+        {
+          if (fourStep)
+          {
+            size += (fourStep->twiddles.size() + fourStep->work.size() + fourStep->n1 + fourStep->n2) * sizeof(C);
+          }
+        }
+
+        size += mScratch.size() * laneCount<R> * mMaxLineLength * sizeof(C);
+        size += mC2rBufferSize;
+
+        return size;
+      }
+
+      /**
+       * @brief Call the function for the batch. If the batch is at least as long as the thread count, it is split along
+       *        the split axis and the parts run single threaded on the cpu thread pool shared by all backends. Otherwise
+       *        the function threads across the lines. With numa split the batch is always split, the i-th part is
+       *        started by the i-th thread of the pool.
+       * @tparam SrcT The source type.
+       * @tparam DstT The destination type.
+       * @tparam FnT The function type, invocable with the batch part, the source and the destination.
+       * @param src The source buffer
+       * @param dst The destination buffer
+       * @param fn The function
+       */
+      template<typename SrcT, typename DstT, typename FnT>
+      void parallelCall(SrcT* src, DstT* dst, FnT&& fn)
+      {
+        const auto threadPool  = afft::cpu::getThreadPool();
+        const auto threadCount = getExecThreadCount();
+
+        if (!mSplitAxis || threadCount <= 1 || (!mNumaSplit && mShape[*mSplitAxis] < threadCount))
+        {
+          safeCall([&]{ fn(BatchPart{mShape, 0, threadCount, 0}, src, dst); });
+          return;
+        }
+
+        const auto axis       = *mSplitAxis;
+        const auto extent     = mShape[axis];
+        const auto chunkCount = std::min(extent, threadCount);
+
+        threadPool->parallelFor(chunkCount, chunkCount, [&](std::size_t i)
+        {
+          const auto begin = extent * i / chunkCount;
+          const auto end   = extent * (i + 1) / chunkCount;
+
+          auto shape  = mShape;
+          shape[axis] = end - begin;
+
+          auto srcPart = reinterpret_cast<SrcT*>(reinterpret_cast<std::byte*>(src) +
+                                                 static_cast<std::ptrdiff_t>(begin) * mSrcStrides[axis]);
+          auto dstPart = reinterpret_cast<DstT*>(reinterpret_cast<std::byte*>(dst) +
+                                                 static_cast<std::ptrdiff_t>(begin) * mDstStrides[axis]);
+
+          safeCall([&]{ fn(BatchPart{shape, begin, 1, i}, srcPart, dstPart); });
+        });
+      }
+
+      /**
+       * @brief Transform the lines of the axis by the held pocketfft plan. The lines are split between the threads,
+       *        each thread copies a group of lines into its scratch buffer, one line per SIMD lane, and transforms
+       *        them at once. In-place transforms are allowed, a group is read before it is written.
+       * @tparam InT The input type.
+       * @tparam OutT The output type.
+       * @tparam KernelT The kernel type, invocable with the scratch buffer and the line group.
+       * @param shape The shape
+       * @param axis The axis
+       * @param in The input buffer
+       * @param inStrides The input strides in bytes
+       * @param out The output buffer
+       * @param outStrides The output strides in bytes
+       * @param threadCount The thread count
+       * @param scratchIndex The scratch buffer of the first thread
+       * @param kernel The kernel
+       */
+      template<typename InT, typename OutT, typename KernelT>
+      void execAxis(const ::pocketfft::shape_t&  shape,
+                    std::size_t                  axis,
+                    const InT*                   in,
+                    const ::pocketfft::stride_t& inStrides,
+                    OutT*                        out,
+                    const ::pocketfft::stride_t& outStrides,
+                    std::size_t                  threadCount,
+                    std::size_t                  scratchIndex,
+                    KernelT&&                    kernel)
+      {
+        std::size_t lineCount{1};
+
+        for (std::size_t i{}; i < shape.size(); ++i)
+        {
+          if (i != axis)
+          {
+            lineCount *= shape[i];
+          }
+        }
+
+        if (lineCount == 0 || shape[axis] == 0)
+        {
+          return;
+        }
+
+        const auto chunkCount = std::min(std::max(threadCount, std::size_t{1}), lineCount);
+        const auto inBytes    = reinterpret_cast<const std::byte*>(in);
+        const auto outBytes   = reinterpret_cast<std::byte*>(out);
+
+        detail::parallelFor(chunkCount, chunkCount, [&](std::size_t chunk)
+        {
+          const auto begin = lineCount * chunk / chunkCount;
+          const auto end   = lineCount * (chunk + 1) / chunkCount;
+
+          auto* scratch = mScratch[scratchIndex + chunk].get();
+
+          LineIterator lineIt{shape, axis, inStrides, outStrides, begin};
+
+          auto execGroup = [&](auto* data, auto group)
+          {
+            for (std::size_t lane{}; lane < group.laneCount; ++lane, lineIt.advance())
+            {
+              group.inOffsets[lane]  = lineIt.getInOffset();
+              group.outOffsets[lane] = lineIt.getOutOffset();
+            }
+
+            kernel(data, group);
+          };
+
+          std::size_t line{begin};
+
+#       ifndef POCKETFFT_NO_VECTORS
+          if constexpr (laneCount<R> > 1)
+          {
+            for (; line + laneCount<R> <= end; line += laneCount<R>)
+            {
+              execGroup(reinterpret_cast<::pocketfft::detail::vtype_t<R>*>(scratch),
+                        LineGroup<InT, OutT, laneCount<R>>{inBytes, {}, inStrides[axis], outBytes, {}, outStrides[axis]});
+            }
+          }
+#       endif
+
+          for (; line < end; ++line)
+          {
+            execGroup(reinterpret_cast<R*>(scratch),
+                      LineGroup<InT, OutT, 1>{inBytes, {}, inStrides[axis], outBytes, {}, outStrides[axis]});
+          }
+        });
+      }
+
+      /**
+       * @brief Make the kernel transforming complex lines by a complex plan.
+       * @param plan The pocketfft plan
+       * @param forward The direction
+       * @param normFactor The normalization factor
+       * @return The kernel
+       */
+      [[nodiscard]] static auto makeC2cKernel(const CPlan& plan, bool forward, R normFactor)
+      {
+        return [&plan, forward, normFactor](auto* data, const auto& group)
+        {
+          using V = std::remove_pointer_t<decltype(data)>;
+
+          auto* line = reinterpret_cast<::pocketfft::detail::cmplx<V>*>(data);
+
+          const auto length = plan.length();
+
+          for (std::size_t i{}; i < length; ++i)
+          {
+            for (std::size_t lane{}; lane < group.laneCount; ++lane)
+            {
+              const C& value = group.load(lane, i);
+
+              setLane(line[i].r, lane, value.real());
+              setLane(line[i].i, lane, value.imag());
+            }
+          }
+
+          plan.exec(line, normFactor, forward);
+
+          for (std::size_t i{}; i < length; ++i)
+          {
+            for (std::size_t lane{}; lane < group.laneCount; ++lane)
+            {
+              group.store(lane, i) = C{getLane(line[i].r, lane), getLane(line[i].i, lane)};
+            }
+          }
+        };
+      }
+
+      /**
+       * @brief Make the kernel transforming real lines into the non-redundant halves of the complex spectra.
+       * @param plan The pocketfft plan
+       * @param forward The direction
+       * @param normFactor The normalization factor
+       * @return The kernel
+       */
+      [[nodiscard]] static auto makeR2cKernel(const RPlan& plan, bool forward, R normFactor)
+      {
+        return [&plan, forward, normFactor](auto* data, const auto& group)
+        {
+          const auto length = plan.length();
+          const R    sign   = (forward) ? R{1} : R{-1};
+
+          for (std::size_t i{}; i < length; ++i)
+          {
+            for (std::size_t lane{}; lane < group.laneCount; ++lane)
+            {
+              setLane(data[i], lane, group.load(lane, i));
+            }
+          }
+
+          plan.exec(data, normFactor, true);
 
-      /// @brief Alias for the interleaved complex type
-      using C = std::complex<PrecT>;
-    public:
-      /// @brief inherit constructors
-      using Parent::Parent;
+          // pocketfft stores the halfcomplex order r0, r1, i1, r2, i2, ...
+          for (std::size_t lane{}; lane < group.laneCount; ++lane)
+          {
+            group.store(lane, 0) = C{getLane(data[0], lane), R{}};
+
+            std::size_t i{1};
+            std::size_t k{1};
+
+            for (; i + 1 < length; i += 2, ++k)
+            {
+              group.store(lane, k) = C{getLane(data[i], lane), sign * getLane(data[i + 1], lane)};
+            }
+
+            if (i < length)
+            {
+              group.store(lane, k) = C{getLane(data[i], lane), R{}};
+            }
+          }
+        };
+      }
 
       /**
-       * @brief Constructor
-       * @param Desc The plan description
+       * @brief Make the kernel transforming the non-redundant halves of the complex spectra into real lines.
+       * @param plan The pocketfft plan
+       * @param forward The direction
+       * @param normFactor The normalization factor
+       * @return The kernel
        */
-      Plan(const Desc& desc)
-      : Parent{desc},
-        mShape{mDesc.getShape().begin(), mDesc.getShape().end()},
-        mSrcStrides(mShape.size()),
-        mDstStrides(mShape.size()),
-        mAxes{mDesc.getTransformAxes().begin(), mDesc.getTransformAxes().end()}
+      [[nodiscard]] static auto makeC2rKernel(const RPlan& plan, bool forward, R normFactor)
       {
-        mDesc.fillDefaultMemoryLayoutStrides();
+        return [&plan, forward, normFactor](auto* data, const auto& group)
+        {
+          const auto length = plan.length();
+          const R    sign   = (forward) ? R{-1} : R{1};
 
-        const auto& memLayout = mDesc.template getMemoryLayout<Distribution::spst>();
+          for (std::size_t lane{}; lane < group.laneCount; ++lane)
+          {
+            setLane(data[0], lane, group.load(lane, 0).real());
 
-        std::transform(memLayout.getSrcStrides().begin(),
-                       memLayout.getSrcStrides().end(),
-                       mSrcStrides.begin(),
-                       [this](const auto stride)
+            std::size_t i{1};
+            std::size_t k{1};
+
+            for (; i + 1 < length; i += 2, ++k)
+            {
+              const C& value = group.load(lane, k);
+
+              setLane(data[i], lane, value.real());
+              setLane(data[i + 1], lane, sign * value.imag());
+            }
+
+            if (i < length)
+            {
+              setLane(data[i], lane, group.load(lane, k).real());
+            }
+          }
+
+          plan.exec(data, normFactor, false);
+
+          for (std::size_t i{}; i < length; ++i)
+          {
+            for (std::size_t lane{}; lane < group.laneCount; ++lane)
+            {
+              group.store(lane, i) = getLane(data[i], lane);
+            }
+          }
+        };
+      }
+
+      /**
+       * @brief Make the kernel transforming real lines holding the complex spectra in the halfcomplex order
+       *        r0, r1, i1, r2, i2, ... into real lines.
+       * @param plan The pocketfft plan
+       * @param forward The direction
+       * @param normFactor The normalization factor
+       * @return The kernel
+       */
+      [[nodiscard]] static auto makePackedC2rKernel(const RPlan& plan, bool forward, R normFactor)
+      {
+        return [&plan, forward, normFactor](auto* data, const auto& group)
         {
-          return safeIntCast<std::ptrdiff_t>(stride * mDesc.sizeOfSrcElem());
-        });
+          const auto length = plan.length();
+          const R    sign   = (forward) ? R{-1} : R{1};
 
-        std::transform(memLayout.getDstStrides().begin(),
-                       memLayout.getDstStrides().end(),
-                       mDstStrides.begin(),
-                       [this](const auto stride)
+          for (std::size_t i{}; i < length; ++i)
+          {
+            for (std::size_t lane{}; lane < group.laneCount; ++lane)
+            {
+              // the imaginary parts are at the even positions
+              setLane(data[i], lane, (i > 0 && i % 2 == 0) ? sign * group.load(lane, i) : group.load(lane, i));
+            }
+          }
+
+          plan.exec(data, normFactor, false);
+
+          for (std::size_t i{}; i < length; ++i)
+          {
+            for (std::size_t lane{}; lane < group.laneCount; ++lane)
+            {
+              group.store(lane, i) = getLane(data[i], lane);
+            }
+          }
+        };
+      }
+
+      /**
+       * @brief Make the kernel computing the separable Hartley transform of real lines.
+       * @param plan The pocketfft plan
+       * @param normFactor The normalization factor
+       * @return The kernel
+       */
+      [[nodiscard]] static auto makeHartleyKernel(const RPlan& plan, R normFactor)
+      {
+        return [&plan, normFactor](auto* data, const auto& group)
         {
-          return safeIntCast<std::ptrdiff_t>(stride * mDesc.sizeOfDstElem());
-        });
+          const auto length = plan.length();
+
+          for (std::size_t i{}; i < length; ++i)
+          {
+            for (std::size_t lane{}; lane < group.laneCount; ++lane)
+            {
+              setLane(data[i], lane, group.load(lane, i));
+            }
+          }
+
+          plan.exec(data, normFactor, true);
+
+          // the Hartley transform is the sum and the difference of the real and the imaginary parts
+          for (std::size_t lane{}; lane < group.laneCount; ++lane)
+          {
+            group.store(lane, 0) = getLane(data[0], lane);
+
+            std::size_t i{1};
+            std::size_t k1{1};
+            std::size_t k2{length - 1};
+
+            for (; i + 1 < length; i += 2, ++k1, --k2)
+            {
+              group.store(lane, k1) = getLane(data[i], lane) + getLane(data[i + 1], lane);
+              group.store(lane, k2) = getLane(data[i], lane) - getLane(data[i + 1], lane);
+            }
+
+            if (i < length)
+            {
+              group.store(lane, k1) = getLane(data[i], lane);
+            }
+          }
+        };
       }
 
-      /// @brief Default destructor
-      ~Plan() = default;
+      /**
+       * @brief Make the kernel computing the discrete trigonometric transform of real lines.
+       * @tparam LinePlanT The pocketfft plan type.
+       * @param plan The pocketfft plan
+       * @param type The pocketfft transform type, 1 to 4
+       * @param cosine Compute the cosine transform, the sine one otherwise
+       * @param ortho Use the orthogonal normalization
+       * @param normFactor The normalization factor
+       * @return The kernel
+       */
+      template<typename LinePlanT>
+      [[nodiscard]] static auto makeDttKernel(const LinePlanT& plan, int type, bool cosine, bool ortho, R normFactor)
+      {
+        return [&plan, type, cosine, ortho, normFactor](auto* data, const auto& group)
+        {
+          const auto length = plan.length();
 
-      /// @brief Inherit assignment operator
-      using Parent::operator=;
+          for (std::size_t i{}; i < length; ++i)
+          {
+            for (std::size_t lane{}; lane < group.laneCount; ++lane)
+            {
+              setLane(data[i], lane, group.load(lane, i));
+            }
+          }
+
+          plan.exec(data, normFactor, ortho, type, cosine);
+
+          for (std::size_t i{}; i < length; ++i)
+          {
+            for (std::size_t lane{}; lane < group.laneCount; ++lane)
+            {
+              group.store(lane, i) = getLane(data[i], lane);
+            }
+          }
+        };
+      }
 
       /**
-       * @brief Execute the plan
+       * @brief Execute the complex-to-complex DFT. If an axis prepared for the four-step decomposition has fewer lines
+       *        than threads, the axes are transformed one after another, such axes by the four-step decomposition and
+       *        the other ones threaded across the lines. Otherwise the batch is transformed by parallelCall.
        * @param src The source buffer
        * @param dst The destination buffer
+       * @param normFactor The normalization factor
        */
-      void executeBackendImpl(View<void*> src, View<void*> dst, const afft::spst::cpu::ExecutionParameters&) override
+      void execC2c(C* src, C* dst, R normFactor)
       {
-        switch (mDesc.getTransform())
+        const auto direction   = Parent::getDirection();
+        const auto threadCount = getExecThreadCount();
+
+        auto isFourStepAxis = [&](std::size_t axis)
         {
-        case Transform::dft:
-          execDft(src.front(), dst.front());
-          break;
-        case Transform::dht:
-          execDht(src.front(), dst.front());
-          break;
-        case Transform::dtt:
-          execDtt(src.front(), dst.front());
-          break;
-        default:
-          cxx::unreachable();
+          return mFourStep[axis].has_value() && getLineCount(axis) < threadCount;
+        };
+
+        if (threadCount <= 1 || std::none_of(mAxes.begin(), mAxes.end(), isFourStepAxis))
+        {
+          parallelCall(src, dst, [&, this](const BatchPart& part, C* srcPart, C* dstPart)
+          {
+            // the first axis is transformed from the source into the destination, the other ones in-place
+            for (std::size_t i{}; i < mAxes.size(); ++i)
+            {
+              execAxis(part.shape,
+                       mAxes[i],
+                       (i == 0) ? srcPart : dstPart,
+                       (i == 0) ? mSrcStrides : mDstStrides,
+                       dstPart,
+                       mDstStrides,
+                       part.threadCount,
+                       part.scratchIndex,
+                       makeC2cKernel(getAxisPlan<CPlan>(mAxes[i]), direction, (i == 0) ? normFactor : R{1}));
+            }
+          });
+          return;
+        }
+
+        // the first axis is transformed from the source into the destination, the other ones in-place
+        for (std::size_t i{}; i < mAxes.size(); ++i)
+        {
+          const auto  axis      = mAxes[i];
+          C*          in        = (i == 0) ? src : dst;
+          const auto& inStrides = (i == 0) ? mSrcStrides : mDstStrides;
+          const R     fct       = (i == 0) ? normFactor : R{1};
+
+          if (isFourStepAxis(axis))
+          {
+            execFourStepAxis(axis, in, inStrides, dst, fct, threadCount);
+          }
+          else
+          {
+            safeCall([&]
+            {
+              execAxis(mShape,
+                       axis,
+                       in,
+                       inStrides,
+                       dst,
+                       mDstStrides,
+                       threadCount,
+                       0,
+                       makeC2cKernel(getAxisPlan<CPlan>(axis), direction, fct));
+            });
+          }
         }
       }
-    protected:
-    private:
+
+      /**
+       * @brief Transform the lines of the axis one after another by the four-step decomposition, each pass is threaded
+       *        across its n1 or n2 lines.
+       * @param axis The axis
+       * @param src The source buffer
+       * @param srcStrides The source strides in bytes
+       * @param dst The destination buffer
+       * @param normFactor The normalization factor
+       * @param threadCount The thread count
+       */
+      void execFourStepAxis(std::size_t                  axis,
+                            C*                           src,
+                            const ::pocketfft::stride_t& srcStrides,
+                            C*                           dst,
+                            R                            normFactor,
+                            std::size_t                  threadCount)
+      {
+        const auto direction = Parent::getDirection();
+        auto&      fourStep  = *mFourStep[axis];
+        const auto n1        = fourStep.n1;
+        const auto n2        = fourStep.n2;
+        const auto elemSize  = static_cast<std::ptrdiff_t>(sizeof(C));
+        const auto lineCount = getLineCount(axis);
+
+        const ::pocketfft::shape_t  passShape{n1, n2};
+        const ::pocketfft::stride_t srcPassStrides{static_cast<std::ptrdiff_t>(n2) * srcStrides[axis], srcStrides[axis]};
+        const ::pocketfft::stride_t workStrides{static_cast<std::ptrdiff_t>(n2) * elemSize, elemSize};
+        const ::pocketfft::stride_t dstPassStrides{mDstStrides[axis], static_cast<std::ptrdiff_t>(n1) * mDstStrides[axis]};
+
+        C*                   work = fourStep.work.data();
+        ::pocketfft::shape_t index(mShape.size());
+
+        for (std::size_t line{}; line < lineCount; ++line)
+        {
+          std::ptrdiff_t srcOffset{};
+          std::ptrdiff_t dstOffset{};
+
+          for (std::size_t i{}; i < mShape.size(); ++i)
+          {
+            srcOffset += static_cast<std::ptrdiff_t>(index[i]) * srcStrides[i];
+            dstOffset += static_cast<std::ptrdiff_t>(index[i]) * mDstStrides[i];
+          }
+
+          auto srcLine = reinterpret_cast<C*>(reinterpret_cast<std::byte*>(src) + srcOffset);
+          auto dstLine = reinterpret_cast<C*>(reinterpret_cast<std::byte*>(dst) + dstOffset);
+
+          safeCall([&]
+          {
+            execAxis(passShape,
+                     0,
+                     srcLine,
+                     srcPassStrides,
+                     work,
+                     workStrides,
+                     threadCount,
+                     0,
+                     makeC2cKernel(*fourStep.plan1, direction, R{1}));
+          });
+
+          detail::parallelFor(n1, threadCount, [&](std::size_t k1)
+          {
+            for (std::size_t j{}; j < n2; ++j)
+            {
+              work[k1 * n2 + j] *= fourStep.twiddles[k1 * n2 + j];
+            }
+          });
+
+          safeCall([&]
+          {
+            execAxis(passShape,
+                     1,
+                     work,
+                     workStrides,
+                     dstLine,
+                     dstPassStrides,
+                     threadCount,
+                     0,
+                     makeC2cKernel(*fourStep.plan2, direction, normFactor));
+          });
+
+          for (std::size_t i = mShape.size(); i-- > 0;)
+          {
+            if (i != axis)
+            {
+              if (++index[i] < mShape[i])
+              {
+                break;
+              }
+
+              index[i] = 0;
+            }
+          }
+        }
+      }
+
       /**
        * @brief Execute the DFT
        * @param src The source buffer
@@ -141,50 +1164,97 @@ namespace afft::detail::pocketfft::spst::cpu
 
         const auto direction  = Parent::getDirection();
         const auto normFactor = mDesc.template getNormalizationFactor<R>();
-        const auto nthreads   = getThreadCount();
+        const auto realAxis   = mAxes.back();
 
         switch (dftDesc.type)
         {
         case dft::Type::complexToComplex:
-          safeCall([&, this]
-          {
-            ::pocketfft::c2c(mShape,
-                             mSrcStrides,
-                             mDstStrides,
-                             mAxes,
-                             direction,
-                             static_cast<C*>(src),
-                             static_cast<C*>(dst),
-                             normFactor,
-                             nthreads);
-          });
+          execC2c(static_cast<C*>(src), static_cast<C*>(dst), normFactor);
           break;
         case dft::Type::realToComplex:
-          safeCall([&, this]
-          {
-            ::pocketfft::c2r(mShape,
-                             mSrcStrides,
-                             mDstStrides,
-                             mAxes,
-                             direction,
-                             static_cast<C*>(src),
-                             static_cast<R*>(dst),
-                             normFactor,
-                             nthreads);
+          parallelCall(static_cast<R*>(src),
+                       static_cast<C*>(dst),
+                       [&, this](const BatchPart& part, R* srcPart, C* dstPart)
+          {
+            auto complexShape      = part.shape;
+            complexShape[realAxis] = part.shape[realAxis] / 2 + 1;
+
+            // the last axis is transformed into the destination, the other ones in-place
+            execAxis(part.shape,
+                     realAxis,
+                     srcPart,
+                     mSrcStrides,
+                     dstPart,
+                     mDstStrides,
+                     part.threadCount,
+                     part.scratchIndex,
+                     makeR2cKernel(getAxisPlan<RPlan>(realAxis), direction, normFactor));
+
+            for (std::size_t i{}; i + 1 < mAxes.size(); ++i)
+            {
+              execAxis(complexShape,
+                       mAxes[i],
+                       dstPart,
+                       mDstStrides,
+                       dstPart,
+                       mDstStrides,
+                       part.threadCount,
+                       part.scratchIndex,
+                       makeC2cKernel(getAxisPlan<CPlan>(mAxes[i]), direction, R{1}));
+            }
           });
           break;
         case dft::Type::complexToReal:
-          safeCall([&, this]
-          {
-            ::pocketfft::r2c(mShape,
-                             mSrcStrides,
-                             mDstStrides,
-                             mAxes,
-                             direction,
-                             static_cast<R*>(src),
-                             static_cast<C*>(dst),
-                             normFactor,
-                             nthreads);
+          parallelCall(static_cast<C*>(src),
+                       static_cast<R*>(dst),
+                       [&, this](const BatchPart& part, C* srcPart, R* dstPart)
+          {
+            auto complexShape      = part.shape;
+            complexShape[realAxis] = part.shape[realAxis] / 2 + 1;
+
+            if (mIsC2rStaged)
+            {
+              execStagedC2r(part, complexShape, srcPart, dstPart, direction, normFactor);
+              return;
+            }
+
+            C*                           in        = srcPart;
+            const ::pocketfft::stride_t* inStrides = &mSrcStrides;
+
+            // the complex axes are transformed into the buffer, or in the source if it is not preserved
+            if (mAxes.size() > 1)
+            {
+              if (mC2rBuffer)
+              {
+                const auto offset = (mSplitAxis) ? static_cast<std::ptrdiff_t>(part.offset) * mC2rStrides[*mSplitAxis] : 0;
+
+                in        = reinterpret_cast<C*>(reinterpret_cast<std::byte*>(mC2rBuffer.get()) + offset);
+                inStrides = &mC2rStrides;
+              }
+
+              for (std::size_t i{}; i + 1 < mAxes.size(); ++i)
+              {
+                execAxis(complexShape,
+                         mAxes[i],
+                         (i == 0) ? srcPart : in,
+                         (i == 0) ? mSrcStrides : *inStrides,
+                         in,
+                         *inStrides,
+                         part.threadCount,
+                         part.scratchIndex,
+                         makeC2cKernel(getAxisPlan<CPlan>(mAxes[i]), direction, R{1}));
+              }
+            }
+
+            execAxis(part.shape,
+                     realAxis,
+                     in,
+                     *inStrides,
+                     dstPart,
+                     mDstStrides,
+                     part.threadCount,
+                     part.scratchIndex,
+                     makeC2rKernel(getAxisPlan<RPlan>(realAxis), direction, normFactor));
           });
           break;
         default:
@@ -192,6 +1262,126 @@ namespace afft::detail::pocketfft::spst::cpu
         }
       }
 
+      /**
+       * @brief Transform the complex axes of a complex-to-real DFT, the first one from the input into the output, the
+       *        other ones in the output.
+       * @param shape The shape
+       * @param in The input buffer
+       * @param inStrides The input strides in bytes
+       * @param out The output buffer
+       * @param outStrides The output strides in bytes
+       * @param part The batch part
+       * @param direction The direction
+       */
+      void execC2rComplexAxes(const ::pocketfft::shape_t&  shape,
+                              const C*                     in,
+                              const ::pocketfft::stride_t& inStrides,
+                              C*                           out,
+                              const ::pocketfft::stride_t& outStrides,
+                              const BatchPart&             part,
+                              bool                         direction)
+      {
+        for (std::size_t i{}; i + 1 < mAxes.size(); ++i)
+        {
+          execAxis(shape,
+                   mAxes[i],
+                   (i == 0) ? in : out,
+                   (i == 0) ? inStrides : outStrides,
+                   out,
+                   outStrides,
+                   part.threadCount,
+                   part.scratchIndex,
+                   makeC2cKernel(getAxisPlan<CPlan>(mAxes[i]), direction, R{1}));
+        }
+      }
+
+      /**
+       * @brief Execute the staged complex-to-real DFT preserving the source. The source is read once: the columns
+       *        1 .. (n - 1) / 2 of the real axis are transformed along the complex axes into the destination rows as the
+       *        complex pairs of the halfcomplex order, the columns with a real result are transformed into the buffer
+       *        and their real parts stored at the positions 0 and n - 1. The real axis is then transformed in-place in
+       *        the destination, so the buffer holds only 1 or 2 columns instead of the whole spectrum.
+       * @param part The batch part
+       * @param complexShape The complex shape of the part
+       * @param src The source part
+       * @param dst The destination part
+       * @param direction The direction
+       * @param normFactor The normalization factor
+       */
+      void execStagedC2r(const BatchPart&            part,
+                         const ::pocketfft::shape_t& complexShape,
+                         C*                          src,
+                         R*                          dst,
+                         bool                        direction,
+                         R                           normFactor)
+      {
+        const auto realAxis    = mAxes.back();
+        const auto length      = part.shape[realAxis];
+        const auto columnCount = getC2rRealColumnCount();
+
+        auto* srcBytes = reinterpret_cast<std::byte*>(src);
+        auto* dstBytes = reinterpret_cast<std::byte*>(dst);
+
+        // the complex pair of column k starts at the real position 2k - 1
+        auto packedShape      = complexShape;
+        packedShape[realAxis] = (length - 1) / 2;
+
+        auto packedStrides      = mDstStrides;
+        packedStrides[realAxis] = 2 * mDstStrides[realAxis];
+
+        execC2rComplexAxes(packedShape,
+                           reinterpret_cast<C*>(srcBytes + mSrcStrides[realAxis]),
+                           mSrcStrides,
+                           reinterpret_cast<C*>(dstBytes + mDstStrides[realAxis]),
+                           packedStrides,
+                           part,
+                           direction);
+
+        // the columns 0 and n / 2 are transformed in the buffer
+        auto realShape      = complexShape;
+        realShape[realAxis] = columnCount;
+
+        auto realSrcStrides      = mSrcStrides;
+        realSrcStrides[realAxis] = static_cast<std::ptrdiff_t>(length / 2) * mSrcStrides[realAxis];
+
+        const auto offset = (mSplitAxis) ? static_cast<std::ptrdiff_t>(part.offset) * mC2rStrides[*mSplitAxis] : 0;
+        auto*      buffer = reinterpret_cast<C*>(reinterpret_cast<std::byte*>(mC2rBuffer.get()) + offset);
+
+        execC2rComplexAxes(realShape, src, realSrcStrides, buffer, mC2rStrides, part, direction);
+
+        auto realDstStrides      = mDstStrides;
+        realDstStrides[realAxis] = static_cast<std::ptrdiff_t>(length - 1) * mDstStrides[realAxis];
+
+        execAxis(realShape,
+                 realAxis,
+                 buffer,
+                 mC2rStrides,
+                 dst,
+                 realDstStrides,
+                 part.threadCount,
+                 part.scratchIndex,
+                 [columnCount](auto*, const auto& group)
+        {
+          for (std::size_t lane{}; lane < group.laneCount; ++lane)
+          {
+            for (std::size_t i{}; i < columnCount; ++i)
+            {
+              group.store(lane, i) = group.load(lane, i).real();
+            }
+          }
+        });
+
+        execAxis(part.shape,
+                 realAxis,
+                 dst,
+                 mDstStrides,
+                 dst,
+                 mDstStrides,
+                 part.threadCount,
+                 part.scratchIndex,
+                 makePackedC2rKernel(getAxisPlan<RPlan>(realAxis), direction, normFactor));
+      }
+
       /**
        * @brief Execute the DHT
        * @param src The source buffer
@@ -202,21 +1392,42 @@ namespace afft::detail::pocketfft::spst::cpu
         const auto& dhtDesc = mDesc.template getTransformDesc<Transform::dht>();
 
         const auto normFactor = mDesc.template getNormalizationFactor<R>();
-        const auto nthreads   = getThreadCount();
 
         switch (dhtDesc.type)
         {
         case dht::Type::separable:
-          safeCall([&, this]
-          {
-            ::pocketfft::r2r_separable_hartley(mShape,
-                                               mSrcStrides,
-                                               mDstStrides,
-                                               mAxes,
-                                               static_cast<R*>(src),
-                                               static_cast<R*>(dst),
-                                               normFactor,
-                                               nthreads);
+          parallelCall(static_cast<R*>(src),
+                       static_cast<R*>(dst),
+                       [&, this](const BatchPart& part, R* srcPart, R* dstPart)
+          {
+            // the first axis is transformed from the source into the destination, the other ones in-place
+            for (std::size_t i{}; i < mAxes.size(); ++i)
+            {
+              execAxis(part.shape,
+                       mAxes[i],
+                       (i == 0) ? srcPart : dstPart,
+                       (i == 0) ? mSrcStrides : mDstStrides,
+                       dstPart,
+                       mDstStrides,
+                       part.threadCount,
+                       part.scratchIndex,
+                       makeHartleyKernel(getAxisPlan<RPlan>(mAxes[i]), (i == 0) ? normFactor : R{1}));
+            }
+          });
+          break;
+        case dht::Type::nonSeparable:
+          parallelCall(static_cast<R*>(src),
+                       static_cast<R*>(dst),
+                       [&, this](const BatchPart& part, R* srcPart, R* dstPart)
+          {
+            ::pocketfft::r2r_genuine_hartley(part.shape,
+                                             mSrcStrides,
+                                             mDstStrides,
+                                             mAxes,
+                                             srcPart,
+                                             dstPart,
+                                             normFactor,
+                                             part.threadCount);
           });
           break;
         default:
@@ -231,9 +1442,6 @@ namespace afft::detail::pocketfft::spst::cpu
        */
       void execDtt(void* src, void* dst)
       {
-        static constexpr std::array dttTypes = {dtt::Type::dct1, dtt::Type::dct2, dtt::Type::dct3, dtt::Type::dct4,
-                                                dtt::Type::dst1, dtt::Type::dst2, dtt::Type::dst3, dtt::Type::dst4};
-
         auto cvtDttType = [dir = mDesc.getDirection()](dtt::Type dttType) constexpr -> int
         {
           switch (dttType)
@@ -251,73 +1459,76 @@ namespace afft::detail::pocketfft::spst::cpu
           }
         };
 
-        const auto  axes    = mDesc.getTransformAxes();
         const auto& dttDesc = mDesc.template getTransformDesc<Transform::dtt>();
 
-        auto normFactor = mDesc.template getNormalizationFactor<R>();
+        const auto normFactor = mDesc.template getNormalizationFactor<R>();
 
-        const auto ortho    = (mDesc.getNormalization() == Normalization::orthogonal);
-        const auto nthreads = getThreadCount();
+        const auto ortho = (mDesc.getNormalization() == Normalization::orthogonal);
 
-        for (const auto dttType : dttTypes)
+        parallelCall(static_cast<R*>(src),
+                     static_cast<R*>(dst),
+                     [&, this](const BatchPart& part, R* srcPart, R* dstPart)
         {
-          mAxes.clear();
-
-          for (std::size_t i{}; i < mDesc.getTransformRank(); ++i)
+          // the first axis is transformed from the source into the destination, the other ones in-place
+          for (std::size_t i{}; i < mAxes.size(); ++i)
           {
-            if (dttDesc.types[i] == dttType)
+            const auto axis    = mAxes[i];
+            const auto dttType = dttDesc.types[i];
+            const auto type    = cvtDttType(dttType);
+            const bool cosine  = (dttType == dtt::Type::dct1 || dttType == dtt::Type::dct2 ||
+                                  dttType == dtt::Type::dct3 || dttType == dtt::Type::dct4);
+            const R    fct     = (i == 0) ? normFactor : R{1};
+
+            auto execDttAxis = [&](const auto& plan)
             {
-              mAxes.push_back(axes[i]);
-            }
-          }
+              execAxis(part.shape,
+                       axis,
+                       (i == 0) ? srcPart : dstPart,
+                       (i == 0) ? mSrcStrides : mDstStrides,
+                       dstPart,
+                       mDstStrides,
+                       part.threadCount,
+                       part.scratchIndex,
+                       makeDttKernel(plan, type, cosine, ortho, fct));
+            };
 
-          if (!mAxes.empty())
-          {
             switch (dttType)
             {
-            case dtt::Type::dct1: case dtt::Type::dct2: case dtt::Type::dct3: case dtt::Type::dct4:
-              safeCall([&, this]
-              {
-                ::pocketfft::dct(mShape,
-                                 mSrcStrides,
-                                 mDstStrides,
-                                 mAxes,
-                                 cvtDttType(dttType),
-                                 static_cast<R*>(src),
-                                 static_cast<R*>(dst),
-                                 normFactor,
-                                 ortho,
-                                 nthreads);
-              });
+            case dtt::Type::dct1:
+              execDttAxis(getAxisPlan<Dct1Plan>(axis));
               break;
-            case dtt::Type::dst1: case dtt::Type::dst2: case dtt::Type::dst3: case dtt::Type::dst4:
-              safeCall([&, this]
-              {
-                ::pocketfft::dst(mShape,
-                                 mSrcStrides,
-                                 mDstStrides,
-                                 mAxes,
-                                 cvtDttType(dttType),
-                                 static_cast<R*>(src),
-                                 static_cast<R*>(dst),
-                                 normFactor,
-                                 ortho,
-                                 nthreads);
-              });
+            case dtt::Type::dst1:
+              execDttAxis(getAxisPlan<Dst1Plan>(axis));
+              break;
+            case dtt::Type::dct2: case dtt::Type::dct3: case dtt::Type::dst2: case dtt::Type::dst3:
+              execDttAxis(getAxisPlan<Dcst23Plan>(axis));
+              break;
+            case dtt::Type::dct4: case dtt::Type::dst4:
+              execDttAxis(getAxisPlan<Dcst4Plan>(axis));
               break;
             default:
               cxx::unreachable();
             }
-
-            normFactor = R{1.0};
           }
-        }
+        });
       }
 
-      ::pocketfft::shape_t  mShape{};      ///< The shape of the data
-      ::pocketfft::stride_t mSrcStrides{}; ///< The stride of the source data
-      ::pocketfft::stride_t mDstStrides{}; ///< The stride of the destination data
-      ::pocketfft::shape_t  mAxes{};       ///< The axes to be transformed, valid for DFT, varies for DTT
+      ::pocketfft::shape_t                           mShape{};             ///< The shape of the data
+      ::pocketfft::stride_t                          mSrcStrides{};        ///< The stride of the source data
+      ::pocketfft::stride_t                          mDstStrides{};        ///< The stride of the destination data
+      ::pocketfft::shape_t                           mAxes{};              ///< The axes to be transformed
+      std::optional<std::size_t>                     mSplitAxis{};         ///< The axis not transformed the batch is split along
+      std::vector<std::optional<FourStepAxis>>       mFourStep{};          ///< The four-step decomposition of each long axis
+      std::vector<AxisPlan>                          mAxisPlans{};         ///< The pocketfft plan of each transformed axis
+      std::size_t                                    mMaxLineLength{};     ///< The length of the longest line transformed
+      std::vector<afft::cpu::AlignedUniquePtr<C[]>>  mScratch{};           ///< The scratch buffer of each thread
+      afft::cpu::AlignedUniquePtr<C[]>               mC2rBuffer{};         ///< The buffer of the complex axes of a c2r DFT
+      ::pocketfft::stride_t                          mC2rStrides{};        ///< The strides of the c2r buffer in bytes
+      std::size_t                                    mC2rBufferSize{};     ///< The size of the c2r buffer in bytes
+      bool                                           mIsC2rStaged{};       ///< The c2r buffer holds only the real columns
+      bool                                           mNumaSplit{};         ///< Split the batch per NUMA node
+      std::size_t                                    mBackendMemorySize{}; ///< The estimated size of the pocketfft plans
+      std::mutex                                     mMutex{};             ///< Serializes the executions.
   };
 
   /**
@@ -371,11 +1582,7 @@ namespace afft::detail::pocketfft::spst::cpu
     //   throw std::runtime_error{"Unsupported transform type"};
     // }
 
-    if (!desc.hasUniformPrecision())
-    {
-      throw BackendError{Backend::pocketfft, "only same precision for execution, source and destination is supported"};
-    }
-
+    // the layout is checked by supports() in makePlan.hpp
     switch (const auto precision = desc.getPrecision().execution)
     {
       case Precision::_float:
@@ -173,6 +173,21 @@ namespace afft::detail::rocfft
        */
       [[nodiscard]] constexpr std::unique_ptr<std::remove_pointer_t<rocfft_plan_description>, DescDeleter>
       getRocfftPlanDescription() const
+      {
+        const std::size_t distance = (mDesc.getTransformHowManyRank() == 0)
+                                       ? 0 : mDesc.getTransformHowManyRankDims().first();
+
+        return getRocfftPlanDescription(distance, distance);
+      }
+
+      /**
+       * @brief Get the rocFFT plan description with the given distances between the transforms.
+       * @param srcDistance The distance between the source transforms in elements.
+       * @param dstDistance The distance between the destination transforms in elements.
+       * @return The rocFFT plan description.
+       */
+      [[nodiscard]] constexpr std::unique_ptr<std::remove_pointer_t<rocfft_plan_description>, DescDeleter>
+      getRocfftPlanDescription(std::size_t srcDistance, std::size_t dstDistance) const
       {
         std::unique_ptr<std::remove_pointer_t<rocfft_plan_description>, DescDeleter> rocfftDesc{};
 
@@ -231,10 +246,10 @@ namespace afft::detail::rocfft
                                                            nullptr,
                                                            (isSpst) ? mDesc.getTransformRank() : 0,
                                                            (isSpst) ? srcStrides.data() : nullptr,
-                                                           (mDesc.getTransformHowManyRank() == 0) ? 0 : mDesc.getTransformHowManyRankDims().first(),
+                                                           srcDistance,
                                                            (isSpst) ? mDesc.getTransformRank() : 0,
                                                            (isSpst) ? dstStrides.data() : nullptr,
-                                                           (mDesc.getTransformHowManyRank() == 0) ? 0 : mDesc.getTransformHowManyRankDims().first()));
+                                                           dstDistance));
 
         return rocfftDesc;
       }
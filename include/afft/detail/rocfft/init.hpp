@@ -31,6 +31,16 @@
 
 namespace afft::detail::rocfft
 {
+  /**
+   * @brief Get the path of the rocFFT runtime compilation kernel cache set by afft::rocfft::setCachePath().
+   * @return Cache path, empty for the rocFFT default.
+   */
+  [[nodiscard]] inline std::string& getCachePath()
+  {
+    static std::string cachePath{};
+    return cachePath;
+  }
+
   /// @brief Initialize the rocFFT library.
   void init();
 
@@ -49,6 +59,21 @@ namespace afft::detail::rocfft
   /// @brief Initialize the rocFFT library.
   AFFT_HEADER_ONLY_INLINE void init()
   {
+    // rocFFT reads the cache location from the environment when it is set up
+    if (const auto& cachePath = getCachePath(); !cachePath.empty())
+    {
+#   ifdef _WIN32
+      const bool failed = (_putenv_s("ROCFFT_RTC_CACHE_PATH", cachePath.c_str()) != 0);
+#   else
+      const bool failed = (setenv("ROCFFT_RTC_CACHE_PATH", cachePath.c_str(), 1) != 0);
+#   endif
+
+      if (failed)
+      {
+        throw BackendError{Backend::rocfft, "failed to set the kernel cache path"};
+      }
+    }
+
     checkError(rocfft_setup());
   }
 
@@ -36,36 +36,84 @@
 namespace afft::detail::rocfft
 {
   /**
-   * @brief Create a plan implementation.
-   * @tparam BackendParamsT Backend parameters type.
+   * @brief Check if the plan may be supported by the rocfft backend, without any side effects.
    * @param desc Plan description.
-   * @param backendParams Backend parameters.
-   * @return Plan implementation.
+   * @return Backend support, the reason of the rejection if the plan is not supported.
    */
-  template<typename BackendParamsT>
-  [[nodiscard]] std::unique_ptr<afft::Plan>
-  makePlan([[maybe_unused]] const Desc& desc, const BackendParamsT&)
+  [[nodiscard]] inline BackendSupport supports(const Desc& desc)
   {
     if (const auto tRank = desc.getTransformRank(); tRank > 3 || tRank == 0)
     {
-      throw BackendError{Backend::rocfft, "only 1D, 2D and 3D transforms are supported"};
+      return BackendSupport{"only 1D, 2D and 3D transforms are supported"};
     }
 
     if (const auto hmRank = desc.getTransformHowManyRank(); hmRank > 1)
     {
-      throw BackendError{Backend::rocfft, "only single and batched transforms are supported"};
+      return BackendSupport{"only single and batched transforms are supported"};
     }
 
     if (desc.getTransform() != Transform::dft)
     {
-      throw BackendError{Backend::rocfft, "only dft transform is supported"};
+      return BackendSupport{"only dft transform is supported"};
     }
 
     if (!desc.hasUniformPrecision())
     {
-      throw BackendError{Backend::rocfft, "execution, source and destination precision must match"};
+      return BackendSupport{"execution, source and destination precision must match"};
+    }
+
+    if (const auto prec = desc.getPrecision().execution;
+        prec != Precision::f16 && prec != Precision::f32 && prec != Precision::f64)
+    {
+      return BackendSupport{"only f16, f32 and f64 precisions are supported"};
+    }
+
+    if (desc.getTarget() != Target::gpu)
+    {
+      return BackendSupport{"only gpu target is supported"};
+    }
+
+#ifndef AFFT_DISABLE_GPU
+    switch (desc.getDistribution())
+    {
+    case Distribution::spst:
+    {
+      const auto& gpuDesc = desc.getArchDesc<Target::gpu, Distribution::spst>();
+
+      if (!gpuDesc.loadCallback.srcCode.empty() || !gpuDesc.storeCallback.srcCode.empty())
+      {
+        return BackendSupport{"only precompiled device callbacks are supported"};
+      }
+      break;
     }
-    
+    case Distribution::spmt:
+      break;
+    default:
+      return BackendSupport{"only spst and spmt distributions are supported"};
+    }
+
+    return BackendSupport{};
+#else
+    return BackendSupport{"gpu support is disabled"};
+#endif
+  }
+
+  /**
+   * @brief Create a plan implementation.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Plan description.
+   * @param backendParams Backend parameters.
+   * @return Plan implementation.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] std::unique_ptr<afft::Plan>
+  makePlan([[maybe_unused]] const Desc& desc, const BackendParamsT&)
+  {
+    if (const auto support = supports(desc); !support)
+    {
+      throw BackendError{Backend::rocfft, support.reason};
+    }
+
     if constexpr (BackendParamsT::target == Target::gpu)
     {
 #   ifndef AFFT_DISABLE_GPU
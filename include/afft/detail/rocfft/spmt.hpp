@@ -72,9 +72,13 @@ namespace afft::detail::rocfft::spmt::gpu
       {
         mDesc.fillDefaultMemoryLayoutStrides();
 
-        auto rocfftPlanDescription = mDesc.getRocfftPlanDescription();
+        auto rocfftPlanDescription = getRocfftPlanDescription(0, 0);
 
-        // todo: add bricks and in/out fileds
+        addRocfftField(rocfftPlanDescription.get(), true);
+        addRocfftField(rocfftPlanDescription.get(), false);
+
+        checkError(rocfft_plan_description_set_scale_factor(rocfftPlanDescription.get(),
+                                                            mDesc.getNormalizationFactor<double>()));
 
         {
           rocfft_plan plan{};
@@ -90,9 +94,6 @@ namespace afft::detail::rocfft::spmt::gpu
           mPlan.reset(plan);
         }
 
-        checkError(rocfft_plan_description_set_scale_factor(rocfftPlanDescription.get(),
-                                                            mDesc.getNormalizationFactor<double>()));
-
         mWorkspaceSize = std::make_unique<std::size_t[]>(getDeviceCount());
         checkError(rocfft_plan_get_work_buffer_size(mPlan.get(), mWorkspaceSize.get()));
 
@@ -133,7 +134,11 @@ namespace afft::detail::rocfft::spmt::gpu
           checkError(rocfft_execution_info_set_work_buffer(mExecInfo.get(), execParams.workspace, mWorkspaceSize));
         }
 
-        checkError(rocfft_execute(mPlan.get(), src.data(), dst.data(), mExecInfo.get()));
+        // The buffers are passed in the order of the bricks, one per device
+        checkError(rocfft_execute(mPlan.get(),
+                                  const_cast<void**>(src.data()),
+                                  const_cast<void**>(dst.data()),
+                                  mExecInfo.get()));
       }
 
       /**
@@ -146,6 +151,124 @@ namespace afft::detail::rocfft::spmt::gpu
       }
     protected:
     private:
+      /// @brief The rocFFT field deleter.
+      struct FieldDeleter
+      {
+        void operator()(rocfft_field field) const noexcept
+        {
+          rocfft_field_destroy(field);
+        }
+      };
+
+      /// @brief The maximum rank of a rocFFT brick, the transform dimensions and the batch dimension.
+      static constexpr std::size_t maxBrickRank{4};
+
+      /**
+       * @brief Describe the source or destination memory blocks as a rocFFT field with one brick per device. The brick
+       *        coordinates are ordered from the fastest to the slowest axis followed by the batch axis.
+       * @param rocfftDesc The rocFFT plan description the field is added to.
+       * @param isSrc If true, the source field is added, otherwise the destination field.
+       */
+      void addRocfftField(rocfft_plan_description rocfftDesc, bool isSrc) const
+      {
+        const auto& memLayout   = mDesc.getMemoryLayout<Distribution::spmt>();
+        const auto& gpuDesc     = mDesc.getArchDesc<Target::gpu, Distribution::spmt>();
+        const auto  shapeRank   = mDesc.getShapeRank();
+        const auto  tRank       = mDesc.getTransformRank();
+        const auto  howManyRank = shapeRank - tRank;
+        const auto  tAxes       = mDesc.getTransformAxes();
+
+        if (howManyRank > 1)
+        {
+          throw BackendError{Backend::rocfft, "only single and batched transforms are supported"};
+        }
+
+        for (std::size_t i{}; i < tRank; ++i)
+        {
+          if (tAxes[i] != howManyRank + i)
+          {
+            throw BackendError{Backend::rocfft, "the transformed axes must be the trailing axes"};
+          }
+        }
+
+        if ((isSrc) ? memLayout.hasDefaultSrcMemoryBlocks() : memLayout.hasDefaultDstMemoryBlocks())
+        {
+          throw BackendError{Backend::rocfft, "the memory blocks of each device must be specified"};
+        }
+
+        if (!memLayout.hasDefaultSrcAxesOrder() || !memLayout.hasDefaultDstAxesOrder())
+        {
+          throw BackendError{Backend::rocfft, "custom axes order is not supported"};
+        }
+
+        std::unique_ptr<std::remove_pointer_t<rocfft_field>, FieldDeleter> field{};
+
+        {
+          rocfft_field tmpField{};
+
+          checkError(rocfft_field_create(&tmpField));
+
+          field.reset(tmpField);
+        }
+
+        for (std::size_t i{}; i < gpuDesc.devices.size(); ++i)
+        {
+          const auto starts  = (isSrc) ? memLayout.getSrcStarts(i) : memLayout.getDstStarts(i);
+          const auto sizes   = (isSrc) ? memLayout.getSrcSizes(i) : memLayout.getDstSizes(i);
+          const auto strides = (isSrc) ? memLayout.getSrcStrides(i) : memLayout.getDstStrides(i);
+
+          std::array<std::size_t, maxBrickRank> lower{};
+          std::array<std::size_t, maxBrickRank> upper{};
+          std::array<std::size_t, maxBrickRank> stride{};
+
+          for (std::size_t j{}; j < tRank; ++j)
+          {
+            const auto axis = shapeRank - 1 - j;
+
+            lower[j]  = starts[axis];
+            upper[j]  = starts[axis] + sizes[axis];
+            stride[j] = strides[axis];
+          }
+
+          if (howManyRank == 1)
+          {
+            lower[tRank]  = starts[0];
+            upper[tRank]  = starts[0] + sizes[0];
+            stride[tRank] = strides[0];
+          }
+          else
+          {
+            lower[tRank]  = 0;
+            upper[tRank]  = 1;
+            stride[tRank] = sizes[0] * strides[0];
+          }
+
+          rocfft_brick brick{};
+
+          checkError(rocfft_brick_create(&brick,
+                                         lower.data(),
+                                         upper.data(),
+                                         stride.data(),
+                                         tRank + 1,
+                                         gpuDesc.devices[i]));
+
+          const auto status = rocfft_field_add_brick(field.get(), brick);
+
+          rocfft_brick_destroy(brick);
+
+          checkError(status);
+        }
+
+        if (isSrc)
+        {
+          checkError(rocfft_plan_description_add_infield(rocfftDesc, field.get()));
+        }
+        else
+        {
+          checkError(rocfft_plan_description_add_outfield(rocfftDesc, field.get()));
+        }
+      }
+
       std::unique_ptr<std::size_t[]> mWorkspaceSize{}; ///< The workspace size
   };
 
@@ -30,6 +30,7 @@
 #endif
 
 #include "../../Plan.hpp"
+#include "../../trace.hpp"
 
 #ifndef AFFT_DISABLE_GPU
 
@@ -101,10 +102,14 @@ namespace afft::detail::rocfft::spst::gpu
           mExecInfo.reset(info);
         }
 
+        setCallbacks(mExecInfo.get());
+
         if (!mDesc.useExternalWorkspace())
         {
           hip::checkError(hipMalloc(&mWorkspace, mWorkspaceSize));
 
+          trace::emit(afft::trace::EventType::workspaceAlloc, Backend::rocfft, "plan workspace", {}, mWorkspaceSize);
+
           checkError(rocfft_execution_info_set_work_buffer(mExecInfo.get(), mWorkspace, mWorkspaceSize));
         }
       }  
@@ -116,20 +121,70 @@ namespace afft::detail::rocfft::spst::gpu
       using Parent::operator=;
 
       /**
-       * @brief Execute the plan
+       * @brief Execute the plan. Each stream gets its own execution info and workspace replica, so executions on
+       *        different streams do not serialize. Streams beyond the replica cap share the plan execution info.
        * @param src The source buffer
        * @param dst The destination buffer
        */
       void executeBackendImpl(View<void*> src, View<void*> dst, const afft::spst::gpu::ExecutionParameters& execParams) override
       {
-        checkError(rocfft_execution_info_set_stream(mExecInfo.get(), execParams.stream));
+        if (StreamReplica* replica = getStreamReplica(execParams.stream); replica != nullptr)
+        {
+          const auto lock = lockExecution(replica->mutex);
 
-        if (mDesc.useExternalWorkspace())
+          execute(replica->execInfo.get(), src, dst, execParams);
+        }
+        else
+        {
+          const auto lock = lockExecution(mMutex);
+
+          checkError(rocfft_execution_info_set_stream(mExecInfo.get(), execParams.stream));
+
+          execute(mExecInfo.get(), src, dst, execParams);
+        }
+      }
+
+      /**
+       * @brief Execute the plan for a batch of buffers. Buffers placed at a uniform distance are transformed by a single
+       *        batched rocFFT plan, which is created on the first use and kept for the next batch of the same layout.
+       * @param srcs The source buffers
+       * @param dsts The destination buffers
+       * @param execParams The execution parameters
+       */
+      void executeBatchBackendImpl(View<void*>                                 srcs,
+                                   View<void*>                                 dsts,
+                                   const afft::spst::gpu::ExecutionParameters& execParams) override
+      {
+        const auto srcDistance = getUniformDistance(srcs, mDesc.sizeOfSrcElem());
+        const auto dstDistance = getUniformDistance(dsts, mDesc.sizeOfDstElem());
+
+        // The batched plan has its own workspace, it cannot use the external one sized for this plan
+        if (srcs.size() < 2 ||
+            !srcDistance.has_value() ||
+            !dstDistance.has_value() ||
+            getRocfftNumberOfTransforms() != 1 ||
+            mDesc.useExternalWorkspace() ||
+            mDesc.getArchDesc<Target::gpu, Distribution::spst>().hasCallbacks())
+        {
+          Parent::executeBatchBackendImpl(srcs, dsts, execParams);
+          return;
+        }
+
+        const auto lock = lockExecution(mMutex);
+
+        if (mBatchPlan.count != srcs.size() ||
+            mBatchPlan.srcDistance != *srcDistance ||
+            mBatchPlan.dstDistance != *dstDistance)
         {
-          checkError(rocfft_execution_info_set_work_buffer(mExecInfo.get(), execParams.workspace, mWorkspaceSize));
+          mBatchPlan = makeBatchPlan(srcs.size(), *srcDistance, *dstDistance);
         }
 
-        checkError(rocfft_execute(mPlan.get(), src.data(), dst.data(), mExecInfo.get()));
+        checkError(rocfft_execution_info_set_stream(mBatchPlan.execInfo.get(), execParams.stream));
+
+        void* src = srcs.front();
+        void* dst = dsts.front();
+
+        checkError(rocfft_execute(mBatchPlan.plan.get(), &src, &dst, mBatchPlan.execInfo.get()));
       }
 
       /**
@@ -142,8 +197,247 @@ namespace afft::detail::rocfft::spst::gpu
       }
     protected:
     private:
-      void*       mWorkspace{};     ///< The workspace
-      std::size_t mWorkspaceSize{}; ///< The workspace size
+      /// @brief The workspace deleter
+      struct WorkspaceDeleter
+      {
+        void operator()(void* ptr) const noexcept
+        {
+          hipFree(ptr);
+        }
+      };
+
+      /// @brief Owning rocFFT plan
+      using PlanPtr = std::unique_ptr<std::remove_pointer_t<rocfft_plan>, PlanDeleter>;
+
+      /// @brief Owning rocFFT execution info
+      using ExecInfoPtr = std::unique_ptr<std::remove_pointer_t<rocfft_execution_info>, ExecInfoDeleter>;
+
+      /// @brief Maximum number of streams with their own execution info replica
+      static constexpr std::size_t maxStreamReplicaCount{8};
+
+      /// @brief Execution state of the plan bound to a single stream, the rocFFT plan itself is shared
+      struct StreamReplica
+      {
+        hipStream_t                             stream{};    ///< The stream
+        ExecInfoPtr                             execInfo{};  ///< The rocFFT execution info bound to the stream
+        std::unique_ptr<void, WorkspaceDeleter> workspace{}; ///< The workspace, empty for external workspace
+        std::mutex                              mutex{};     ///< Serializes the executions on the stream
+      };
+
+      /// @brief Batched plan executing transforms placed at a uniform distance
+      {
+        std::size_t                             count{};       ///< The number of transforms
+        std::size_t                             srcDistance{}; ///< The source distance in elements
+        std::size_t                             dstDistance{}; ///< The destination distance in elements
+        PlanPtr                                 plan{};        ///< The rocFFT plan
+        ExecInfoPtr                             execInfo{};    ///< The rocFFT execution info
+        std::unique_ptr<void, WorkspaceDeleter> workspace{};   ///< The workspace
+      };
+
+      /**
+       * @brief Get the uniform distance between the buffers
+       * @param buffers The buffers
+       * @param elemSize The size of the element in bytes
+       * @return The distance in elements, empty if the buffers are not placed at a uniform positive distance
+       */
+      [[nodiscard]] static std::optional<std::size_t> getUniformDistance(View<void*> buffers, std::size_t elemSize)
+      {
+        if (buffers.size() < 2)
+        {
+          return std::nullopt;
+        }
+
+        const auto first = reinterpret_cast<std::uintptr_t>(buffers[0]);
+        const auto next  = reinterpret_cast<std::uintptr_t>(buffers[1]);
+
+        if (next <= first || (next - first) % elemSize != 0)
+        {
+          return std::nullopt;
+        }
+
+        const std::uintptr_t step = next - first;
+
+        for (std::size_t i{2}; i < buffers.size(); ++i)
+        {
+          if (reinterpret_cast<std::uintptr_t>(buffers[i]) != first + i * step)
+          {
+            return std::nullopt;
+          }
+        }
+
+        return static_cast<std::size_t>(step / elemSize);
+      }
+
+      /**
+       * @brief Make the batched plan
+       * @param count The number of transforms
+       * @param srcDistance The source distance in elements
+       * @param dstDistance The destination distance in elements
+       * @return The batched plan
+       */
+      [[nodiscard]] BatchPlan makeBatchPlan(std::size_t count, std::size_t srcDistance, std::size_t dstDistance) const
+      {
+        hip::ScopedDevice device{mDesc.getArchDesc<Target::gpu, Distribution::spst>().device};
+
+        BatchPlan batchPlan{};
+        batchPlan.count       = count;
+        batchPlan.srcDistance = srcDistance;
+        batchPlan.dstDistance = dstDistance;
+
+        auto rocfftDesc = getRocfftPlanDescription(srcDistance, dstDistance);
+
+        checkError(rocfft_plan_description_set_scale_factor(rocfftDesc.get(), mDesc.getNormalizationFactor<double>()));
+
+        {
+          rocfft_plan plan{};
+
+          checkError(rocfft_plan_create(&plan,
+                                        getRocfftPlacement(),
+                                        getRocfftTransformType(),
+                                        getRocfftPrecision(),
+                                        getRocfftDimensions(),
+                                        getRocfftLengths().data(),
+                                        count,
+                                        rocfftDesc.get()));
+          batchPlan.plan.reset(plan);
+        }
+
+        {
+          rocfft_execution_info info{};
+
+          checkError(rocfft_execution_info_create(&info));
+
+          batchPlan.execInfo.reset(info);
+        }
+
+        std::size_t workspaceSize{};
+
+        checkError(rocfft_plan_get_work_buffer_size(batchPlan.plan.get(), &workspaceSize));
+
+        if (workspaceSize > 0)
+        {
+          void* workspace{};
+
+          hip::checkError(hipMalloc(&workspace, workspaceSize));
+
+          trace::emit(afft::trace::EventType::workspaceAlloc, Backend::rocfft, "batch plan workspace", {}, workspaceSize);
+
+          batchPlan.workspace.reset(workspace);
+
+          checkError(rocfft_execution_info_set_work_buffer(batchPlan.execInfo.get(), workspace, workspaceSize));
+        }
+
+        return batchPlan;
+      }
+
+      /**
+       * @brief Execute the shared rocFFT plan with the given execution info
+       * @param execInfo The execution info, its stream is already set
+       * @param src The source buffer
+       * @param dst The destination buffer
+       * @param execParams The execution parameters
+       */
+      void execute(rocfft_execution_info                       execInfo,
+                   View<void*>                                 src,
+                   View<void*>                                 dst,
+                   const afft::spst::gpu::ExecutionParameters& execParams)
+      {
+        if (mDesc.useExternalWorkspace())
+        {
+          checkError(rocfft_execution_info_set_work_buffer(execInfo, execParams.workspace, mWorkspaceSize));
+        }
+
+        checkError(rocfft_execute(mPlan.get(), src.data(), dst.data(), execInfo));
+      }
+
+      /**
+       * @brief Get the replica of the stream, make it on the first use of the stream
+       * @param stream The stream
+       * @return The replica, nullptr if the replica cap is reached
+       */
+      [[nodiscard]] StreamReplica* getStreamReplica(hipStream_t stream)
+      {
+        std::lock_guard lock{mStreamReplicasMutex};
+
+        auto it = std::find_if(mStreamReplicas.begin(), mStreamReplicas.end(), [stream](const auto& replica)
+        {
+          return replica->stream == stream;
+        });
+
+        if (it != mStreamReplicas.end())
+        {
+          return it->get();
+        }
+
+        if (mStreamReplicas.size() >= maxStreamReplicaCount)
+        {
+          return nullptr;
+        }
+
+        hip::ScopedDevice device{mDesc.getArchDesc<Target::gpu, Distribution::spst>().device};
+
+        auto replica = std::make_unique<StreamReplica>();
+        replica->stream = stream;
+
+        {
+          rocfft_execution_info info{};
+
+          checkError(rocfft_execution_info_create(&info));
+
+          replica->execInfo.reset(info);
+        }
+
+        checkError(rocfft_execution_info_set_stream(replica->execInfo.get(), stream));
+
+        setCallbacks(replica->execInfo.get());
+
+        if (!mDesc.useExternalWorkspace() && mWorkspaceSize > 0)
+        {
+          void* workspace{};
+
+          hip::checkError(hipMalloc(&workspace, mWorkspaceSize));
+
+          trace::emit(afft::trace::EventType::workspaceAlloc, Backend::rocfft, "stream replica workspace", {}, mWorkspaceSize);
+
+          replica->workspace.reset(workspace);
+
+          checkError(rocfft_execution_info_set_work_buffer(replica->execInfo.get(), workspace, mWorkspaceSize));
+        }
+
+        return mStreamReplicas.emplace_back(std::move(replica)).get();
+      }
+
+      /**
+       * @brief Set the user load and store callbacks to the execution info
+       * @param execInfo The execution info
+       */
+      void setCallbacks(rocfft_execution_info execInfo)
+      {
+        const auto& gpuDesc = mDesc.getArchDesc<Target::gpu, Distribution::spst>();
+
+        if (gpuDesc.loadCallback.isEnabled())
+        {
+          void* callbackFn   = gpuDesc.loadCallback.devicePtr;
+          void* callbackData = gpuDesc.loadCallback.callerInfo;
+
+          checkError(rocfft_execution_info_set_load_callback(execInfo, &callbackFn, &callbackData, 0));
+        }
+
+        if (gpuDesc.storeCallback.isEnabled())
+        {
+          void* callbackFn   = gpuDesc.storeCallback.devicePtr;
+          void* callbackData = gpuDesc.storeCallback.callerInfo;
+
+          checkError(rocfft_execution_info_set_store_callback(execInfo, &callbackFn, &callbackData, 0));
+        }
+      }
+
+      void*                                       mWorkspace{};           ///< The workspace
+      std::size_t                                 mWorkspaceSize{};       ///< The workspace size
+      BatchPlan                                   mBatchPlan{};           ///< The batched plan of the last batch
+      std::vector<std::unique_ptr<StreamReplica>> mStreamReplicas{};      ///< The per stream replicas
+      std::mutex                                  mStreamReplicasMutex{}; ///< Guards the creation of the replicas
+      std::mutex                                  mMutex{};               ///< Serializes the executions sharing the plan execution info
   };
 
   /**
@@ -0,0 +1,744 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_SERIALIZE_HPP
+#define AFFT_DETAIL_SERIALIZE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "utils.hpp"
+#include "../backend.hpp"
+#include "../exception.hpp"
+#ifdef AFFT_ENABLE_FFTW3
+# include "fftw3/Lib.hpp"
+#endif
+
+namespace afft::detail
+{
+  /// @brief Header of a serialized plan, identifies the format version.
+  inline constexpr std::string_view serializedPlanHeader{"afft-plan 1"};
+
+  /// @brief Header of a serialized plan cache, identifies the format version.
+  inline constexpr std::string_view serializedPlanCacheHeader{"afft-plan-cache 1"};
+
+  /// @brief Header of a serialized plan cache trace, identifies the format version.
+  inline constexpr std::string_view serializedPlanCacheTraceHeader{"afft-plan-cache-trace 1"};
+
+  /**
+   * @class SerialWriter
+   * @brief Writes the serialized text format. Each value is a `name=value` line, lists are comma separated and blobs
+   *        are written as `@name=size` lines followed by the raw bytes and a newline.
+   */
+  class SerialWriter
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param header Format header.
+       */
+      explicit SerialWriter(std::string_view header)
+      : mData{header}
+      {
+        mData += '\n';
+      }
+
+      /**
+       * @brief Write a value.
+       * @tparam T Value type, an integral or an enumeration type.
+       * @param name Name of the value.
+       * @param value Value.
+       */
+      template<typename T>
+      void write(std::string_view name, T value)
+      {
+        mData += name;
+        mData += '=';
+        mData += std::to_string(toInteger(value));
+        mData += '\n';
+      }
+
+      /**
+       * @brief Write a list of values.
+       * @tparam T Value type, an integral or an enumeration type.
+       * @param name Name of the list.
+       * @param values Values.
+       */
+      template<typename T>
+      void writeList(std::string_view name, View<T> values)
+      {
+        mData += name;
+        mData += '=';
+
+        for (std::size_t i{}; i < values.size(); ++i)
+        {
+          mData += (i > 0) ? "," : "";
+          mData += std::to_string(toInteger(values[i]));
+        }
+
+        mData += '\n';
+      }
+
+      /**
+       * @brief Write a blob of raw bytes.
+       * @param name Name of the blob.
+       * @param blob Blob.
+       */
+      void writeBlob(std::string_view name, std::string_view blob)
+      {
+        mData += '@';
+        mData += name;
+        mData += '=';
+        mData += std::to_string(blob.size());
+        mData += '\n';
+        mData += blob;
+        mData += '\n';
+      }
+
+      /**
+       * @brief Release the written data.
+       * @return Written data.
+       */
+      [[nodiscard]] std::string release() &&
+      {
+        return std::move(mData);
+      }
+    private:
+      /**
+       * @brief Convert a value to an unsigned integer.
+       * @tparam T Value type.
+       * @param value Value.
+       * @return Converted value.
+       */
+      template<typename T>
+      [[nodiscard]] static unsigned long long toInteger(T value)
+      {
+        if constexpr (std::is_enum_v<T>)
+        {
+          return static_cast<unsigned long long>(cxx::to_underlying(value));
+        }
+        else
+        {
+          return static_cast<unsigned long long>(value);
+        }
+      }
+
+      std::string mData{}; ///< Written data
+  };
+
+  /**
+   * @class SerialReader
+   * @brief Reads the format written by SerialWriter. The reader refers to the parsed data, so the data must outlive it.
+   */
+  class SerialReader
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param data Serialized data.
+       * @param header Expected format header.
+       */
+      SerialReader(std::string_view data, std::string_view header)
+      {
+        auto readLine = [&]()
+        {
+          const auto end = data.find('\n');
+
+          if (end == std::string_view::npos)
+          {
+            throw std::invalid_argument{"truncated serialized data"};
+          }
+
+          const auto line = data.substr(0, end);
+          data.remove_prefix(end + 1);
+          return line;
+        };
+
+        if (readLine() != header)
+        {
+          throw std::invalid_argument{"invalid serialized data header"};
+        }
+
+        while (!data.empty())
+        {
+          auto       line = readLine();
+          const auto sep  = line.find('=');
+
+          if (sep == std::string_view::npos)
+          {
+            throw std::invalid_argument{"invalid serialized data entry"};
+          }
+
+          if (line.front() == '@')
+          {
+            const auto size = parseInteger(line.substr(sep + 1));
+
+            if (size >= data.size() || data[size] != '\n')
+            {
+              throw std::invalid_argument{"truncated serialized data blob"};
+            }
+
+            mEntries.emplace_back(line.substr(1, sep - 1), data.substr(0, size));
+            data.remove_prefix(size + 1);
+          }
+          else
+          {
+            mEntries.emplace_back(line.substr(0, sep), line.substr(sep + 1));
+          }
+        }
+      }
+
+      /**
+       * @brief Read a value.
+       * @tparam T Value type, an integral or an enumeration type.
+       * @param name Name of the value.
+       * @return Value.
+       */
+      template<typename T>
+      [[nodiscard]] T read(std::string_view name) const
+      {
+        return fromInteger<T>(parseInteger(find(name)));
+      }
+
+      /**
+       * @brief Read a list of values.
+       * @tparam T Value type, an integral or an enumeration type.
+       * @param name Name of the list.
+       * @return Values, empty if the list is empty.
+       */
+      template<typename T>
+      [[nodiscard]] std::vector<T> readList(std::string_view name) const
+      {
+        std::vector<T> values{};
+
+        auto list = find(name);
+
+        while (!list.empty())
+        {
+          const auto end = std::min(list.find(','), list.size());
+
+          values.push_back(fromInteger<T>(parseInteger(list.substr(0, end))));
+          list.remove_prefix(std::min(end + 1, list.size()));
+        }
+
+        return values;
+      }
+
+      /**
+       * @brief Check if an entry exists.
+       * @param name Name of the entry.
+       * @return True if the entry exists, false otherwise.
+       */
+      [[nodiscard]] bool contains(std::string_view name) const
+      {
+        return std::any_of(mEntries.begin(), mEntries.end(), [&](const auto& entry) { return entry.first == name; });
+      }
+
+      /**
+       * @brief Get the entries in the order they were written.
+       * @return Pairs of names and values.
+       */
+      [[nodiscard]] const std::vector<std::pair<std::string_view, std::string_view>>& getEntries() const noexcept
+      {
+        return mEntries;
+      }
+    private:
+      /**
+       * @brief Find an entry.
+       * @param name Name of the entry.
+       * @return Value of the entry.
+       */
+      [[nodiscard]] std::string_view find(std::string_view name) const
+      {
+        const auto it = std::find_if(mEntries.begin(), mEntries.end(), [&](const auto& entry)
+        {
+          return entry.first == name;
+        });
+
+        if (it == mEntries.end())
+        {
+          throw std::invalid_argument{cformat("missing serialized entry '%.*s'",
+                                              static_cast<int>(name.size()),
+                                              name.data())};
+        }
+
+        return it->second;
+      }
+
+      /**
+       * @brief Parse an unsigned integer.
+       * @param str String.
+       * @return Parsed integer.
+       */
+      [[nodiscard]] static unsigned long long parseInteger(std::string_view str)
+      {
+        unsigned long long value{};
+
+        if (str.empty() || !std::all_of(str.begin(), str.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        {
+          throw std::invalid_argument{"invalid serialized integer"};
+        }
+
+        for (const char c : str)
+        {
+          value = value * 10 + static_cast<unsigned long long>(c - '0');
+        }
+
+        return value;
+      }
+
+      /**
+       * @brief Convert an unsigned integer to a value.
+       * @tparam T Value type.
+       * @param value Integer.
+       * @return Converted value.
+       */
+      template<typename T>
+      [[nodiscard]] static T fromInteger(unsigned long long value)
+      {
+        if constexpr (std::is_enum_v<T>)
+        {
+          return static_cast<T>(static_cast<std::underlying_type_t<T>>(value));
+        }
+        else
+        {
+          return static_cast<T>(value);
+        }
+      }
+
+      std::vector<std::pair<std::string_view, std::string_view>> mEntries{}; ///< Names and values of the entries
+  };
+
+  /// @brief Prefix of the FFTW3 wisdom blob names, the precision is appended.
+  inline constexpr std::string_view fftw3WisdomBlobPrefix{"fftw3.wisdom."};
+
+#ifdef AFFT_ENABLE_FFTW3
+  /**
+   * @brief Write the FFTW3 wisdom of a precision.
+   * @tparam prec Precision.
+   * @param writer Writer.
+   */
+  template<Precision prec>
+  void writeFftw3Wisdom([[maybe_unused]] SerialWriter& writer)
+  {
+    if constexpr (fftw3::hasPrecision<prec>)
+    {
+      struct FreeDeleter
+      {
+        void operator()(char* ptr) const
+        {
+          free(ptr);
+        }
+      };
+
+      std::unique_ptr<char, FreeDeleter> wisdom{fftw3::Lib<prec>::exportWisdomToString()};
+
+      if (wisdom)
+      {
+        writer.writeBlob(std::string{fftw3WisdomBlobPrefix} + std::to_string(cxx::to_underlying(prec)), wisdom.get());
+      }
+    }
+  }
+
+  /**
+   * @brief Import the FFTW3 wisdom of a precision.
+   * @tparam prec Precision.
+   * @param wisdom Wisdom.
+   */
+  template<Precision prec>
+  void readFftw3Wisdom([[maybe_unused]] std::string_view wisdom)
+  {
+    if constexpr (fftw3::hasPrecision<prec>)
+    {
+      if (!fftw3::Lib<prec>::importWisdomFromString(std::string{wisdom}.c_str()))
+      {
+        throw BackendError{Backend::fftw3, "failed to import serialized wisdom"};
+      }
+    }
+  }
+#endif
+
+  /**
+   * @brief Write the backend native state needed to restore a plan quickly, the FFTW3 wisdom for now.
+   * @param writer Writer.
+   * @param backend Backend of the plan.
+   * @param prec Execution precision of the plan.
+   */
+  inline void writeBackendState([[maybe_unused]] SerialWriter& writer,
+                                [[maybe_unused]] Backend       backend,
+                                [[maybe_unused]] Precision     prec)
+  {
+#ifdef AFFT_ENABLE_FFTW3
+    if (backend == Backend::fftw3)
+    {
+      switch (prec)
+      {
+      case Precision::f32:
+        writeFftw3Wisdom<Precision::f32>(writer);
+        break;
+      case Precision::f64:
+        writeFftw3Wisdom<Precision::f64>(writer);
+        break;
+      case Precision::f80:
+        writeFftw3Wisdom<Precision::f80>(writer);
+        break;
+      case Precision::f128:
+        writeFftw3Wisdom<Precision::f128>(writer);
+        break;
+      default:
+        break;
+      }
+    }
+#endif
+  }
+
+  /**
+   * @brief Restore the backend native state written by writeBackendState(). Unknown state is ignored, so the data
+   *        remains loadable by builds without the backend.
+   * @param reader Reader.
+   */
+  inline void readBackendState([[maybe_unused]] const SerialReader& reader)
+  {
+#ifdef AFFT_ENABLE_FFTW3
+    for (const auto& [name, value] : reader.getEntries())
+    {
+      if (name.rfind(fftw3WisdomBlobPrefix, 0) != 0)
+      {
+        continue;
+      }
+
+      const auto prec = name.substr(fftw3WisdomBlobPrefix.size());
+
+      if (prec == std::to_string(cxx::to_underlying(Precision::f32)))
+      {
+        readFftw3Wisdom<Precision::f32>(value);
+      }
+      else if (prec == std::to_string(cxx::to_underlying(Precision::f64)))
+      {
+        readFftw3Wisdom<Precision::f64>(value);
+      }
+      else if (prec == std::to_string(cxx::to_underlying(Precision::f80)))
+      {
+        readFftw3Wisdom<Precision::f80>(value);
+      }
+      else if (prec == std::to_string(cxx::to_underlying(Precision::f128)))
+      {
+        readFftw3Wisdom<Precision::f128>(value);
+      }
+    }
+#endif
+  }
+
+  /**
+   * @brief Write the descriptor of a plan. Only spst plans without runtime handles (gpu callbacks, OpenCL context)
+   *        can be written, the plan buffers are not part of the descriptor.
+   * @param writer Writer.
+   * @param desc Descriptor.
+   */
+  inline void writeDesc(SerialWriter& writer, const Desc& desc)
+  {
+    if (desc.getDistribution() != Distribution::spst)
+    {
+      throw std::invalid_argument{"only spst plans can be serialized"};
+    }
+
+    auto writeTransform = [&](const auto& params)
+    {
+      const std::array precision{params.precision.execution, params.precision.source, params.precision.destination};
+
+      writer.write("direction", params.direction);
+      writer.writeList("precision", View<Precision>{precision});
+      writer.writeList("shape", View<std::size_t>{params.shape});
+      writer.writeList("axes", View<std::size_t>{params.axes});
+      writer.write("normalization", params.normalization);
+      writer.write("placement", desc.getPlacement());
+    };
+
+    writer.write("transform", desc.getTransform());
+
+    switch (desc.getTransform())
+    {
+    case Transform::dft:
+    {
+      const auto params = desc.getTransformParameters<Transform::dft>();
+      writeTransform(params);
+      writer.write("type", params.type);
+      writer.writeList("logicalSrcShape", View<std::size_t>{params.logicalSrcShape});
+      writer.writeList("dstWindowStart", View<std::size_t>{params.dstWindowStart});
+      writer.writeList("dstWindowShape", View<std::size_t>{params.dstWindowShape});
+      writer.write("fullSpectrum", params.fullSpectrum);
+      writer.writeList("srcShiftAxes", View<std::size_t>{params.srcShiftAxes});
+      writer.writeList("dstShiftAxes", View<std::size_t>{params.dstShiftAxes});
+      writer.writeList("dttAxes", View<std::size_t>{params.dttAxes});
+      writer.writeList("dttTypes", params.dttTypes);
+      break;
+    }
+    case Transform::dht:
+    {
+      const auto params = desc.getTransformParameters<Transform::dht>();
+      writeTransform(params);
+      writer.write("type", params.type);
+      break;
+    }
+    case Transform::dtt:
+    {
+      const auto params = desc.getTransformParameters<Transform::dtt>();
+      writeTransform(params);
+      writer.writeList("types", params.types);
+      break;
+    }
+    default:
+      cxx::unreachable();
+    }
+
+    auto writeArch = [&](const auto& params)
+    {
+      writer.writeList("srcStrides", View<std::size_t>{params.memoryLayout.srcStrides});
+      writer.writeList("dstStrides", View<std::size_t>{params.memoryLayout.dstStrides});
+      writer.write("complexFormat", params.complexFormat);
+      writer.write("preserveSource", params.preserveSource);
+      writer.write("useExternalWorkspace", params.useExternalWorkspace);
+    };
+
+    writer.write("target", desc.getTarget());
+    writer.write("distribution", desc.getDistribution());
+
+    switch (desc.getTarget())
+    {
+    case Target::cpu:
+    {
+      const auto  params  = desc.getArchitectureParameters<Target::cpu, Distribution::spst>();
+      const auto& cpuDesc = desc.getArchDesc<Target::cpu, Distribution::spst>();
+      writeArch(params);
+      writer.write("alignment", params.alignment);
+      writer.write("acceptUnaligned", params.acceptUnaligned);
+      writer.write("unpaddedInPlaceReal", params.unpaddedInPlaceReal);
+      // the automatic thread limit is selected again up to the requested limit
+      writer.write("threadLimit", (params.autoThreadLimit) ? cpuDesc.maxThreadLimit : params.threadLimit);
+      writer.write("autoThreadLimit", params.autoThreadLimit);
+      writer.write("numaSplit", params.numaSplit);
+      writer.write("hugePagePolicy", params.hugePagePolicy);
+      writer.write("realtime", params.realtime);
+      writer.write("memoryBudget", params.memoryBudget);
+      writer.write("sparseLines", params.sparseLines);
+      break;
+    }
+    case Target::gpu:
+    {
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      const auto params = desc.getArchitectureParameters<Target::gpu, Distribution::spst>();
+
+      auto hasCallback = [](const auto& callback)
+      {
+        return !callback.srcCode.empty() || callback.devicePtr != nullptr;
+      };
+
+      if (hasCallback(params.callbacks.load) || hasCallback(params.callbacks.store))
+      {
+        throw std::invalid_argument{"plans with gpu callbacks cannot be serialized"};
+      }
+
+      writeArch(params);
+      writer.write("device", static_cast<unsigned>(params.device));
+      break;
+#   else
+      throw std::invalid_argument{"only cuda and hip gpu plans can be serialized"};
+#   endif
+    }
+    default:
+      cxx::unreachable();
+    }
+  }
+
+  /**
+   * @brief Read the descriptor written by writeDesc() and pass the reconstructed transform and architecture parameters
+   *        to a function. The parameters refer to storage local to this function, they are valid only during the call.
+   * @tparam FnT Function type.
+   * @param reader Reader.
+   * @param fn Function called with the transform and architecture parameters.
+   * @return Result of the function.
+   */
+  template<typename FnT>
+  auto readDesc(const SerialReader& reader, FnT&& fn)
+  {
+    if (reader.read<Distribution>("distribution") != Distribution::spst)
+    {
+      throw std::invalid_argument{"only spst plans can be deserialized"};
+    }
+
+    const auto precision  = reader.readList<Precision>("precision");
+    const auto shape      = reader.readList<std::size_t>("shape");
+    const auto axes       = reader.readList<std::size_t>("axes");
+    const auto srcStrides = reader.readList<std::size_t>("srcStrides");
+    const auto dstStrides = reader.readList<std::size_t>("dstStrides");
+
+    if (precision.size() != 3)
+    {
+      throw std::invalid_argument{"invalid serialized precision"};
+    }
+
+    auto readTransform = [&](auto& params)
+    {
+      params.direction     = reader.read<Direction>("direction");
+      params.precision     = PrecisionTriad{precision[0], precision[1], precision[2]};
+      params.shape         = View<std::size_t>{shape};
+      params.axes          = View<std::size_t>{axes};
+      params.normalization = reader.read<Normalization>("normalization");
+      params.placement     = reader.read<Placement>("placement");
+    };
+
+    auto readArch = [&](auto& params)
+    {
+      params.memoryLayout.srcStrides = View<std::size_t>{srcStrides};
+      params.memoryLayout.dstStrides = View<std::size_t>{dstStrides};
+      params.complexFormat           = reader.read<ComplexFormat>("complexFormat");
+      params.preserveSource          = reader.read<bool>("preserveSource");
+
+      const bool useExternalWorkspace = reader.read<bool>("useExternalWorkspace");
+
+      if constexpr (std::is_same_v<std::decay_t<decltype(params)>, spst::cpu::Parameters<>>)
+      {
+        if (useExternalWorkspace)
+        {
+          throw std::invalid_argument{"spst cpu plans do not support the external workspace"};
+        }
+      }
+      else
+      {
+        params.useExternalWorkspace = useExternalWorkspace;
+      }
+    };
+
+    auto callWithArch = [&](const auto& transformParams)
+    {
+      switch (reader.read<Target>("target"))
+      {
+      case Target::cpu:
+      {
+        spst::cpu::Parameters<> params{};
+        readArch(params);
+        params.alignment           = reader.read<Alignment>("alignment");
+        params.acceptUnaligned     = reader.read<bool>("acceptUnaligned");
+        params.unpaddedInPlaceReal = reader.read<bool>("unpaddedInPlaceReal");
+        params.threadLimit         = reader.read<unsigned>("threadLimit");
+        params.autoThreadLimit     = reader.read<bool>("autoThreadLimit");
+        params.numaSplit           = reader.read<bool>("numaSplit");
+        params.hugePagePolicy      = reader.read<HugePagePolicy>("hugePagePolicy");
+        params.realtime            = reader.read<bool>("realtime");
+        params.memoryBudget        = reader.read<std::size_t>("memoryBudget");
+        params.sparseLines         = reader.read<bool>("sparseLines");
+
+        return std::invoke(fn, transformParams, params);
+      }
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      case Target::gpu:
+      {
+        spst::gpu::Parameters<> params{};
+        readArch(params);
+        params.device = static_cast<int>(reader.read<unsigned>("device"));
+
+        return std::invoke(fn, transformParams, params);
+      }
+#   endif
+      default:
+        throw std::invalid_argument{"unsupported serialized plan target"};
+      }
+    };
+
+    switch (reader.read<Transform>("transform"))
+    {
+    case Transform::dft:
+    {
+      const auto logicalSrcShape = reader.readList<std::size_t>("logicalSrcShape");
+      const auto dstWindowStart  = reader.readList<std::size_t>("dstWindowStart");
+      const auto dstWindowShape  = reader.readList<std::size_t>("dstWindowShape");
+      const auto srcShiftAxes    = reader.readList<std::size_t>("srcShiftAxes");
+      const auto dstShiftAxes    = reader.readList<std::size_t>("dstShiftAxes");
+      const auto dttAxes         = reader.readList<std::size_t>("dttAxes");
+      const auto dttTypes        = reader.readList<dtt::Type>("dttTypes");
+
+      dft::Parameters<> params{};
+      readTransform(params);
+      params.type            = reader.read<dft::Type>("type");
+      params.logicalSrcShape = View<std::size_t>{logicalSrcShape};
+      params.dstWindowStart  = View<std::size_t>{dstWindowStart};
+      params.dstWindowShape  = View<std::size_t>{dstWindowShape};
+      params.fullSpectrum    = reader.read<bool>("fullSpectrum");
+      params.srcShiftAxes    = View<std::size_t>{srcShiftAxes};
+      params.dstShiftAxes    = View<std::size_t>{dstShiftAxes};
+      params.dttAxes         = View<std::size_t>{dttAxes};
+      params.dttTypes        = View<dtt::Type>{dttTypes};
+
+      return callWithArch(params);
+    }
+    case Transform::dht:
+    {
+      dht::Parameters<> params{};
+      readTransform(params);
+      params.type = reader.read<dht::Type>("type");
+
+      return callWithArch(params);
+    }
+    case Transform::dtt:
+    {
+      const auto types = reader.readList<dtt::Type>("types");
+
+      dtt::Parameters<> params{};
+      readTransform(params);
+      params.types = View<dtt::Type>{types};
+
+      return callWithArch(params);
+    }
+    default:
+      throw std::invalid_argument{"unsupported serialized plan transform"};
+    }
+  }
+
+  /**
+   * @brief Serialize a plan.
+   * @param desc Descriptor of the plan.
+   * @param backend Backend of the plan.
+   * @param withBackendState Serialize the backend native state as well.
+   * @return Serialized plan.
+   */
+  [[nodiscard]] inline std::string serializePlan(const Desc& desc, Backend backend, bool withBackendState = true)
+  {
+    SerialWriter writer{serializedPlanHeader};
+
+    writer.write("backend", backend);
+    writeDesc(writer, desc);
+
+    if (withBackendState)
+    {
+      writeBackendState(writer, backend, desc.getPrecision().execution);
+    }
+
+    return std::move(writer).release();
+  }
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_SERIALIZE_HPP */
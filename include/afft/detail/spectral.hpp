@@ -0,0 +1,188 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_SPECTRAL_HPP
+#define AFFT_DETAIL_SPECTRAL_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "ThreadPool.hpp"
+#include "utils.hpp"
+#include "../common.hpp"
+
+namespace afft::detail::spectral
+{
+  /// @brief Number of spectrum rows multiplied by one task of the thread pool.
+  inline constexpr std::size_t rowsPerTask{64};
+
+  /**
+   * @brief Make the angular wavenumbers of an axis, 2pi m / length for the signed frequency index m.
+   * @param size The number of samples along the axis.
+   * @param length The length of the domain along the axis.
+   * @param isReduced Is it the halved axis of a real-to-complex spectrum?
+   * @return The wavenumbers of the spectrum indices, the Nyquist index of an even size has the positive frequency.
+   */
+  [[nodiscard]] inline std::vector<double> makeWavenumbers(std::size_t size, double length, bool isReduced)
+  {
+    const double step   = 2.0 * 3.14159265358979323846 / length;
+    const auto   extent = (isReduced) ? size / 2 + 1 : size;
+
+    std::vector<double> wavenumbers(extent);
+
+    for (std::size_t j{}; j < extent; ++j)
+    {
+      const auto index = (j <= size / 2) ? static_cast<double>(j) : static_cast<double>(j) - static_cast<double>(size);
+
+      wavenumbers[j] = step * index;
+    }
+
+    return wavenumbers;
+  }
+
+  /**
+   * @brief Pointwise multiplier of a spectrum, f(sum_d t_d[j_d]) for the index j_d along each axis. The function is
+   *        scale * s or scale / s with zero at s = 0, optionally multiplied by the imaginary unit. Derivatives use the
+   *        table (k_a)^p of one axis, the Laplacian and its inverse the tables k_d^2 of all transformed axes.
+   */
+  struct Multiplier
+  {
+    std::size_t                      shapeRank{}; ///< The rank of the spectrum.
+    MaxDimArray<std::size_t>         shape{};     ///< The shape of the contiguous spectrum.
+    std::vector<std::vector<double>> tables{};    ///< The table of each axis, empty if the axis does not contribute.
+    double                           scale{};     ///< The scale of the function, including the inverse normalization.
+    bool                             isInverse{}; ///< Is the function scale / s?
+    bool                             isRotated{}; ///< Is the function multiplied by the imaginary unit?
+  };
+
+  /**
+   * @brief Multiply the rows of the spectrum in place, see apply().
+   * @tparam T Real type.
+   * @tparam isInverse Is the function scale / s?
+   * @tparam isRotated Is the function multiplied by the imaginary unit?
+   * @param spectrum Interleaved complex spectrum.
+   * @param multiplier The multiplier.
+   * @param rowBegin The first row.
+   * @param rowEnd The end of the rows.
+   */
+  template<typename T, bool isInverse, bool isRotated>
+  void applyRows(T* spectrum, const Multiplier& multiplier, std::size_t rowBegin, std::size_t rowEnd) noexcept
+  {
+    const std::size_t innerAxis   = multiplier.shapeRank - 1;
+    const std::size_t innerExtent = multiplier.shape[innerAxis];
+    const double*     innerTable  = (multiplier.tables[innerAxis].empty()) ? nullptr : multiplier.tables[innerAxis].data();
+    const T           scale       = static_cast<T>(multiplier.scale);
+
+    for (std::size_t row = rowBegin; row < rowEnd; ++row)
+    {
+      // the sum of the tables of the outer axes is constant along the row
+      double      base{};
+      std::size_t index = row;
+
+      for (std::size_t i = innerAxis; i > 0; --i)
+      {
+        const auto& table = multiplier.tables[i - 1];
+
+        if (!table.empty())
+        {
+          base += table[index % multiplier.shape[i - 1]];
+        }
+
+        index /= multiplier.shape[i - 1];
+      }
+
+      T* data = spectrum + 2 * row * innerExtent;
+
+      // the loop has no branches, so the compiler vectorizes it
+      for (std::size_t j{}; j < innerExtent; ++j)
+      {
+        const T sum = static_cast<T>((innerTable != nullptr) ? base + innerTable[j] : base);
+        T       factor{};
+
+        if constexpr (isInverse)
+        {
+          factor = (sum != T{}) ? scale / sum : T{};
+        }
+        else
+        {
+          factor = scale * sum;
+        }
+
+        const T re = data[2 * j];
+        const T im = data[2 * j + 1];
+
+        if constexpr (isRotated)
+        {
+          data[2 * j]     = -im * factor;
+          data[2 * j + 1] = re * factor;
+        }
+        else
+        {
+          data[2 * j]     = re * factor;
+          data[2 * j + 1] = im * factor;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Multiply the spectrum in place by the multiplier. The rows along the innermost axis are distributed over
+   *        the cpu thread pool in blocks, each row is multiplied by one pass computing the multiplier on the fly from
+   *        the axis tables, so no table of the spectrum size is read.
+   * @tparam T Real type.
+   * @param spectrum Interleaved complex spectrum.
+   * @param multiplier The multiplier.
+   * @param threadLimit The maximum number of threads, 0 for the thread pool size.
+   */
+  template<typename T>
+  void apply(T* spectrum, const Multiplier& multiplier, std::size_t threadLimit)
+  {
+    const std::size_t rowCount  = std::accumulate(multiplier.shape.data(),
+                                                  multiplier.shape.data() + multiplier.shapeRank - 1,
+                                                  std::size_t{1},
+                                                  std::multiplies<>{});
+    const std::size_t taskCount = (rowCount + rowsPerTask - 1) / rowsPerTask;
+
+    auto applyTask = [&](auto fn)
+    {
+      parallelFor(taskCount, threadLimit, [&](std::size_t task)
+      {
+        fn(spectrum, multiplier, task * rowsPerTask, std::min(rowCount, (task + 1) * rowsPerTask));
+      });
+    };
+
+    if (multiplier.isInverse)
+    {
+      (multiplier.isRotated) ? applyTask(applyRows<T, true, true>) : applyTask(applyRows<T, true, false>);
+    }
+    else
+    {
+      (multiplier.isRotated) ? applyTask(applyRows<T, false, true>) : applyTask(applyRows<T, false, false>);
+    }
+  }
+} // namespace afft::detail::spectral
+
+#endif /* AFFT_DETAIL_SPECTRAL_HPP */
@@ -0,0 +1,185 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_TRACE_HPP
+#define AFFT_DETAIL_TRACE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "../backend.hpp"
+
+namespace afft::detail::trace
+{
+  /**
+   * @brief Make the label of a traced range, e.g. "afft execute PocketFFT dft c2c 64x64".
+   * @param what Traced operation.
+   * @param desc Plan description.
+   * @param backend Backend, not labeled if empty.
+   * @return Label.
+   */
+  [[nodiscard]] inline std::string makeLabel(std::string_view what, const Desc& desc, std::optional<Backend> backend)
+  {
+    std::string label{"afft "};
+
+    label += what;
+
+    if (backend)
+    {
+      label += ' ';
+      label += toString(*backend);
+    }
+
+    switch (desc.getTransform())
+    {
+    case Transform::dft:
+      switch (desc.getTransformDesc<Transform::dft>().type)
+      {
+      case dft::Type::complexToComplex:
+        label += " dft c2c ";
+        break;
+      case dft::Type::realToComplex:
+        label += " dft r2c ";
+        break;
+      case dft::Type::complexToReal:
+        label += " dft c2r ";
+        break;
+      default:
+        label += " dft ";
+        break;
+      }
+      break;
+    case Transform::dht:
+      label += " dht ";
+      break;
+    case Transform::dtt:
+      label += " dtt ";
+      break;
+    default:
+      label += ' ';
+      break;
+    }
+
+    const auto shape = desc.getShape();
+
+    for (std::size_t i{}; i < desc.getShapeRank(); ++i)
+    {
+      if (i > 0)
+      {
+        label += 'x';
+      }
+
+      label += std::to_string(shape[i]);
+    }
+
+    return label;
+  }
+
+  /// @brief Sets the label of the executions of a plan, known only to its creator.
+  struct LabelSetter
+  {
+    /**
+     * @brief Set the label of the plan executions.
+     * @tparam PlanT Plan type.
+     * @param plan The plan.
+     * @param label Label.
+     */
+    template<typename PlanT>
+    static void setExecutionLabel([[maybe_unused]] PlanT& plan, [[maybe_unused]] std::string label)
+    {
+#   if defined(AFFT_ENABLE_TRACING)
+      plan.mTraceLabel = std::move(label);
+#   endif
+    }
+  };
+
+  /**
+   * @class Range
+   * @brief Range annotation visible in the profilers, NVTX for CUDA builds, roctx for HIP builds and ITT otherwise. It
+   *        spans the lifetime of the object. Without AFFT_ENABLE_TRACING it does nothing.
+   */
+  class Range
+  {
+    public:
+      /**
+       * @brief Constructor. Opens the range.
+       * @param label Label of the range.
+       */
+      explicit Range([[maybe_unused]] const std::string& label)
+      {
+#     if defined(AFFT_ENABLE_TRACING)
+#       if defined(AFFT_ENABLE_CUDA)
+        nvtxRangePushA(label.c_str());
+#       elif defined(AFFT_ENABLE_HIP)
+        roctxRangePushA(label.c_str());
+#       else
+        __itt_task_begin(getDomain(), __itt_null, __itt_null, __itt_string_handle_create(label.c_str()));
+#       endif
+#     endif
+      }
+
+      /// @brief Copy constructor is deleted.
+      Range(const Range&) = delete;
+
+      /// @brief Move constructor is deleted.
+      Range(Range&&) = delete;
+
+      /// @brief Destructor. Closes the range.
+      ~Range()
+      {
+#     if defined(AFFT_ENABLE_TRACING)
+#       if defined(AFFT_ENABLE_CUDA)
+        nvtxRangePop();
+#       elif defined(AFFT_ENABLE_HIP)
+        roctxRangePop();
+#       else
+        __itt_task_end(getDomain());
+#       endif
+#     endif
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      Range& operator=(const Range&) = delete;
+
+      /// @brief Move assignment operator is deleted.
+      Range& operator=(Range&&) = delete;
+    private:
+#   if defined(AFFT_ENABLE_TRACING) && !defined(AFFT_ENABLE_CUDA) && !defined(AFFT_ENABLE_HIP)
+      /**
+       * @brief Get the ITT domain of afft.
+       * @return ITT domain.
+       */
+      [[nodiscard]] static __itt_domain* getDomain()
+      {
+        static __itt_domain* domain = __itt_domain_create("afft");
+
+        return domain;
+      }
+#   endif
+  };
+} // namespace afft::detail::trace
+
+#endif /* AFFT_DETAIL_TRACE_HPP */
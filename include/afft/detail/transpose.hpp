@@ -0,0 +1,302 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_TRANSPOSE_HPP
+#define AFFT_DETAIL_TRANSPOSE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "ThreadPool.hpp"
+#include "utils.hpp"
+
+namespace afft::detail::transpose
+{
+  /// @brief Extent of a tile along both blocked axes, a tile of 16 byte elements spans 16 KiB of each buffer.
+  inline constexpr std::size_t tileExtent{32};
+
+  /**
+   * @brief Element of the given size copied as a whole.
+   * @tparam elemSize Size of the element in bytes.
+   */
+  template<std::size_t elemSize>
+  struct Elem
+  {
+    std::byte data[elemSize]; ///< Element bytes.
+  };
+
+  /**
+   * @brief Check if elements of the size can be copied by the kernel.
+   * @param elemSize Size of the element in bytes.
+   * @return True if supported, false otherwise.
+   */
+  [[nodiscard]] constexpr bool isSupportedElemSize(std::size_t elemSize) noexcept
+  {
+    switch (elemSize)
+    {
+    case 2: case 4: case 8: case 16: case 32:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  /**
+   * @brief Get the extent of the square block transposed at once in SIMD registers.
+   * @tparam elemSize Size of the element in bytes.
+   * @return The block extent, zero if the element size has no SIMD kernel on this architecture.
+   */
+  template<std::size_t elemSize>
+  [[nodiscard]] constexpr std::size_t getSimdBlockExtent() noexcept
+  {
+#if defined(__AVX2__)
+    return (elemSize == 8) ? 4 : (elemSize == 16) ? 2 : 0;
+#elif defined(__ARM_NEON)
+    return (elemSize == 8) ? 2 : 0;
+#else
+    return 0;
+#endif
+  }
+
+  /**
+   * @brief Transpose a SIMD block of elements contiguous along a in the source and along b in the destination, see
+   *        getSimdBlockExtent().
+   * @tparam elemSize Size of the element in bytes.
+   * @param src Source block origin.
+   * @param srcStrideB Source stride of axis b in elements.
+   * @param dst Destination block origin.
+   * @param dstStrideA Destination stride of axis a in elements.
+   */
+  template<std::size_t elemSize>
+  inline void transposeBlock([[maybe_unused]] const Elem<elemSize>* src,
+                             [[maybe_unused]] std::size_t           srcStrideB,
+                             [[maybe_unused]] Elem<elemSize>*       dst,
+                             [[maybe_unused]] std::size_t           dstStrideA)
+  {
+#if defined(__AVX2__)
+    if constexpr (elemSize == 8)
+    {
+      // 4x4 block of 64-bit elements, the bits are moved through double registers without any arithmetic
+      const __m256d r0 = _mm256_loadu_pd(reinterpret_cast<const double*>(src));
+      const __m256d r1 = _mm256_loadu_pd(reinterpret_cast<const double*>(src + srcStrideB));
+      const __m256d r2 = _mm256_loadu_pd(reinterpret_cast<const double*>(src + 2 * srcStrideB));
+      const __m256d r3 = _mm256_loadu_pd(reinterpret_cast<const double*>(src + 3 * srcStrideB));
+
+      const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+      const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+      const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+      const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+      _mm256_storeu_pd(reinterpret_cast<double*>(dst), _mm256_permute2f128_pd(t0, t2, 0x20));
+      _mm256_storeu_pd(reinterpret_cast<double*>(dst + dstStrideA), _mm256_permute2f128_pd(t1, t3, 0x20));
+      _mm256_storeu_pd(reinterpret_cast<double*>(dst + 2 * dstStrideA), _mm256_permute2f128_pd(t0, t2, 0x31));
+      _mm256_storeu_pd(reinterpret_cast<double*>(dst + 3 * dstStrideA), _mm256_permute2f128_pd(t1, t3, 0x31));
+    }
+    else if constexpr (elemSize == 16)
+    {
+      // 2x2 block of 128-bit elements
+      const __m256d r0 = _mm256_loadu_pd(reinterpret_cast<const double*>(src));
+      const __m256d r1 = _mm256_loadu_pd(reinterpret_cast<const double*>(src + srcStrideB));
+
+      _mm256_storeu_pd(reinterpret_cast<double*>(dst), _mm256_permute2f128_pd(r0, r1, 0x20));
+      _mm256_storeu_pd(reinterpret_cast<double*>(dst + dstStrideA), _mm256_permute2f128_pd(r0, r1, 0x31));
+    }
+#elif defined(__ARM_NEON)
+    if constexpr (elemSize == 8)
+    {
+      // 2x2 block of 64-bit elements
+      const uint64x2_t r0 = vld1q_u64(reinterpret_cast<const std::uint64_t*>(src));
+      const uint64x2_t r1 = vld1q_u64(reinterpret_cast<const std::uint64_t*>(src + srcStrideB));
+
+      vst1q_u64(reinterpret_cast<std::uint64_t*>(dst), vcombine_u64(vget_low_u64(r0), vget_low_u64(r1)));
+      vst1q_u64(reinterpret_cast<std::uint64_t*>(dst + dstStrideA), vcombine_u64(vget_high_u64(r0), vget_high_u64(r1)));
+    }
+#endif
+  }
+
+  /**
+   * @brief Copy a strided array of elements of the given size, cache blocked if the innermost source and destination
+   *        axes differ.
+   * @tparam elemSize Size of the element in bytes.
+   * @param src Source buffer.
+   * @param srcStrides Source strides in elements.
+   * @param dst Destination buffer, must not overlap the source.
+   * @param dstStrides Destination strides in elements.
+   * @param shape Shape of the array.
+   * @param threadCount Maximum number of threads, 0 for the thread pool size.
+   */
+  template<std::size_t elemSize>
+  void copyImpl(const Elem<elemSize>* src,
+                View<std::size_t>     srcStrides,
+                Elem<elemSize>*       dst,
+                View<std::size_t>     dstStrides,
+                View<std::size_t>     shape,
+                std::size_t           threadCount)
+  {
+    const std::size_t rank = shape.size();
+
+    auto findInnermostAxis = [&](View<std::size_t> strides)
+    {
+      return static_cast<std::size_t>(std::distance(strides.begin(), std::min_element(strides.begin(), strides.end())));
+    };
+
+    // a is the innermost source axis, b the innermost destination axis
+    const std::size_t a = findInnermostAxis(srcStrides);
+    const std::size_t b = (rank > 1) ? findInnermostAxis(dstStrides) : a;
+
+    MaxDimArray<std::size_t> outerAxes{};
+    std::size_t              outerRank{};
+    std::size_t              outerCount{1};
+
+    for (std::size_t i{}; i < rank; ++i)
+    {
+      if (i != a && i != b)
+      {
+        outerAxes[outerRank++] = i;
+        outerCount *= shape[i];
+      }
+    }
+
+    const std::size_t extentA      = shape[a];
+    const std::size_t extentB      = (a != b) ? shape[b] : 1;
+    const std::size_t tileCountB   = (extentB + tileExtent - 1) / tileExtent;
+    const bool        isSimdLayout = (a != b) && (srcStrides[a] == 1) && (dstStrides[b] == 1);
+
+    constexpr std::size_t blockExtent = getSimdBlockExtent<elemSize>();
+
+    // each work item copies one outer index and one row of tiles along b
+    parallelFor(outerCount * tileCountB, threadCount, [&](std::size_t item)
+    {
+      std::size_t outerIndex = item / tileCountB;
+      std::size_t srcOffset{};
+      std::size_t dstOffset{};
+
+      for (std::size_t i = outerRank; i > 0; --i)
+      {
+        const std::size_t axis = outerAxes[i - 1];
+
+        srcOffset  += (outerIndex % shape[axis]) * srcStrides[axis];
+        dstOffset  += (outerIndex % shape[axis]) * dstStrides[axis];
+        outerIndex /= shape[axis];
+      }
+
+      const Elem<elemSize>* srcBase = src + srcOffset;
+      Elem<elemSize>*       dstBase = dst + dstOffset;
+
+      if (a == b)
+      {
+        for (std::size_t ia{}; ia < extentA; ++ia)
+        {
+          dstBase[ia * dstStrides[a]] = srcBase[ia * srcStrides[a]];
+        }
+
+        return;
+      }
+
+      const std::size_t b0 = (item % tileCountB) * tileExtent;
+      const std::size_t b1 = std::min(b0 + tileExtent, extentB);
+
+      for (std::size_t a0{}; a0 < extentA; a0 += tileExtent)
+      {
+        const std::size_t a1 = std::min(a0 + tileExtent, extentA);
+
+        std::size_t simdA1 = a0;
+        std::size_t simdB1 = b0;
+
+        if (isSimdLayout && blockExtent > 0)
+        {
+          simdA1 = a0 + (a1 - a0) / blockExtent * blockExtent;
+          simdB1 = b0 + (b1 - b0) / blockExtent * blockExtent;
+
+          for (std::size_t ia = a0; ia < simdA1; ia += blockExtent)
+          {
+            for (std::size_t ib = b0; ib < simdB1; ib += blockExtent)
+            {
+              transposeBlock<elemSize>(srcBase + ia + ib * srcStrides[b],
+                                       srcStrides[b],
+                                       dstBase + ia * dstStrides[a] + ib,
+                                       dstStrides[a]);
+            }
+          }
+        }
+
+        // the tile remainder not covered by the SIMD blocks
+        for (std::size_t ia = a0; ia < a1; ++ia)
+        {
+          const std::size_t ibStart = (ia < simdA1) ? simdB1 : b0;
+
+          for (std::size_t ib = ibStart; ib < b1; ++ib)
+          {
+            dstBase[ia * dstStrides[a] + ib * dstStrides[b]] = srcBase[ia * srcStrides[a] + ib * srcStrides[b]];
+          }
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Copy a strided array, cache blocked and vectorized if the innermost source and destination axes differ.
+   * @param src Source buffer.
+   * @param srcStrides Source strides in elements.
+   * @param dst Destination buffer, must not overlap the source.
+   * @param dstStrides Destination strides in elements.
+   * @param shape Shape of the array.
+   * @param elemSize Size of the element in bytes, see isSupportedElemSize().
+   * @param threadCount Maximum number of threads, 0 for the thread pool size.
+   */
+  inline void copy(const void*       src,
+                   View<std::size_t> srcStrides,
+                   void*             dst,
+                   View<std::size_t> dstStrides,
+                   View<std::size_t> shape,
+                   std::size_t       elemSize,
+                   std::size_t       threadCount)
+  {
+    if (shape.empty() || cxx::any_of(shape.begin(), shape.end(), IsZero<std::size_t>{}))
+    {
+      return;
+    }
+
+    auto copyAs = [&](auto elem)
+    {
+      using ElemT = decltype(elem);
+
+      copyImpl(static_cast<const ElemT*>(src), srcStrides, static_cast<ElemT*>(dst), dstStrides, shape, threadCount);
+    };
+
+    switch (elemSize)
+    {
+    case 2:  copyAs(Elem<2>{});  break;
+    case 4:  copyAs(Elem<4>{});  break;
+    case 8:  copyAs(Elem<8>{});  break;
+    case 16: copyAs(Elem<16>{}); break;
+    case 32: copyAs(Elem<32>{}); break;
+    default:
+      throw std::invalid_argument{"unsupported element size of the strided copy"};
+    }
+  }
+} // namespace afft::detail::transpose
+
+#endif /* AFFT_DETAIL_TRANSPOSE_HPP */
@@ -0,0 +1,155 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_DETAIL_TUNING_HPP
+#define AFFT_DETAIL_TUNING_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "include.hpp"
+#endif
+
+#include "Desc.hpp"
+#include "utils.hpp"
+#include "../backend.hpp"
+
+namespace afft::detail
+{
+  /**
+   * @brief Append a list of values to the tuning key.
+   * @tparam T Value type.
+   * @param key Tuning key.
+   * @param name Name of the list.
+   * @param values Values.
+   */
+  template<typename T>
+  void appendTuningKeyList(std::string& key, std::string_view name, View<T> values)
+  {
+    key += name;
+    key += '=';
+
+    for (std::size_t i{}; i < values.size(); ++i)
+    {
+      key += (i > 0) ? "," : "";
+      key += std::to_string(static_cast<unsigned long long>(values[i]));
+    }
+
+    key += ';';
+  }
+
+  /**
+   * @brief Make the tuning database key for the descriptor and backend parameters. Backend parameters influencing
+   *        the plan performance are part of the key, so plans tuned with different parameters do not collide.
+   * @tparam BackendParamsT Backend parameters type.
+   * @param desc Descriptor.
+   * @param backendParams Backend parameters.
+   * @return Tuning key.
+   */
+  template<typename BackendParamsT>
+  [[nodiscard]] std::string makeTuningKey(const Desc& desc, const BackendParamsT& backendParams)
+  {
+    const auto& prec = desc.getPrecision();
+
+    std::string key = cformat("tr=%u;dir=%u;prec=%u,%u,%u;norm=%u;place=%u;cf=%u;ps=%u;tgt=%u;dist=%u;cnt=%zu;",
+                              static_cast<unsigned>(cxx::to_underlying(desc.getTransform())),
+                              static_cast<unsigned>(cxx::to_underlying(desc.getDirection())),
+                              static_cast<unsigned>(cxx::to_underlying(prec.execution)),
+                              static_cast<unsigned>(cxx::to_underlying(prec.source)),
+                              static_cast<unsigned>(cxx::to_underlying(prec.destination)),
+                              static_cast<unsigned>(cxx::to_underlying(desc.getNormalization())),
+                              static_cast<unsigned>(cxx::to_underlying(desc.getPlacement())),
+                              static_cast<unsigned>(cxx::to_underlying(desc.getComplexFormat())),
+                              static_cast<unsigned>(desc.getPreserveSource()),
+                              static_cast<unsigned>(cxx::to_underlying(desc.getTarget())),
+                              static_cast<unsigned>(cxx::to_underlying(desc.getDistribution())),
+                              desc.getTargetCount());
+
+    switch (desc.getTransform())
+    {
+    case Transform::dft:
+      key += cformat("type=%u;", static_cast<unsigned>(cxx::to_underlying(desc.getTransformDesc<Transform::dft>().type)));
+      break;
+    case Transform::dht:
+      key += cformat("type=%u;", static_cast<unsigned>(cxx::to_underlying(desc.getTransformDesc<Transform::dht>().type)));
+      break;
+    case Transform::dtt:
+    {
+      MaxDimArray<unsigned> types{};
+
+      const auto& dttDesc = desc.getTransformDesc<Transform::dtt>();
+
+      std::transform(dttDesc.types.begin(),
+                     dttDesc.types.begin() + static_cast<std::ptrdiff_t>(desc.getTransformRank()),
+                     types.begin(),
+                     [](const auto type) { return static_cast<unsigned>(cxx::to_underlying(type)); });
+
+      appendTuningKeyList(key, "type", View<unsigned>{types.data(), desc.getTransformRank()});
+      break;
+    }
+    default:
+      cxx::unreachable();
+    }
+
+    appendTuningKeyList(key, "shape", desc.getShape());
+    appendTuningKeyList(key, "axes", desc.getTransformAxes());
+
+    if (desc.getDistribution() == Distribution::spst)
+    {
+      Desc layoutDesc{desc};
+      layoutDesc.fillDefaultMemoryLayoutStrides();
+
+      const auto& memoryLayout = layoutDesc.getMemoryLayout<Distribution::spst>();
+
+      appendTuningKeyList(key, "sstr", memoryLayout.getSrcStrides());
+      appendTuningKeyList(key, "dstr", memoryLayout.getDstStrides());
+    }
+
+    // the measured time depends on the thread count and on the alignment the backend may vectorize for
+    if (desc.getTarget() == Target::cpu && desc.getDistribution() == Distribution::spst)
+    {
+      const auto& cpuDesc = desc.getArchDesc<Target::cpu, Distribution::spst>();
+
+      key += cformat("thr=%u,%u;align=%zu;",
+                     static_cast<unsigned>(cpuDesc.autoThreadLimit),
+                     (cpuDesc.autoThreadLimit) ? cpuDesc.maxThreadLimit : cpuDesc.threadLimit,
+                     static_cast<std::size_t>(cpuDesc.alignment));
+    }
+
+    if constexpr (BackendParamsT::target == Target::cpu && BackendParamsT::distribution == Distribution::spst)
+    {
+      const auto& fftw3Params = backendParams.fftw3;
+
+      key += cformat("fftw3=%u,%u,%u,%u,%u,%.3e;",
+                     static_cast<unsigned>(cxx::to_underlying(fftw3Params.plannerFlag)),
+                     static_cast<unsigned>(fftw3Params.conserveMemory),
+                     static_cast<unsigned>(fftw3Params.wisdomOnly),
+                     static_cast<unsigned>(fftw3Params.allowLargeGeneric),
+                     static_cast<unsigned>(fftw3Params.allowPruning),
+                     fftw3Params.timeLimit.count());
+    }
+
+    return key;
+  }
+} // namespace afft::detail
+
+#endif /* AFFT_DETAIL_TUNING_HPP */
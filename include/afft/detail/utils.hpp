@@ -273,6 +273,35 @@ namespace afft::detail
     return DivResult<I>{/* .quotient  = */ a / b,
                         /* .remainder = */ a % b};
   }
+
+  /**
+   * @brief Combines the hash seed with the hash of a value.
+   * @tparam T Value type.
+   * @param seed Hash seed.
+   * @param value Value to hash.
+   */
+  template<typename T>
+  void hashCombine(std::size_t& seed, const T& value) noexcept
+  {
+    seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+
+  /**
+   * @brief Combines the hash seed with the hashes of all values in a view.
+   * @tparam T Value type.
+   * @param seed Hash seed.
+   * @param values Values to hash.
+   */
+  template<typename T>
+  void hashCombine(std::size_t& seed, View<T> values) noexcept
+  {
+    hashCombine(seed, values.size());
+
+    for (const auto& value : values)
+    {
+      hashCombine(seed, value);
+    }
+  }
 } // namespace afft::detail
 
 #endif /* AFFT_DETAIL_UTILS_HPP */
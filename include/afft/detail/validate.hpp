@@ -61,6 +61,7 @@ namespace afft::detail
       case Backend::pocketfft:
       case Backend::rocfft:
       case Backend::vkfft:
+      case Backend::codelet:
         return true;
       default:
         return false;
@@ -88,6 +89,7 @@ namespace afft::detail
       {
       case SelectStrategy::first:
       case SelectStrategy::best:
+      case SelectStrategy::progressive:
         return true;
       default:
         return false;
@@ -144,6 +146,44 @@ namespace afft::detail
     }
   };
 
+  /// @brief Validator for the HugePagePolicy enum class.
+  template<>
+  struct Validator<HugePagePolicy>
+  {
+    constexpr bool operator()(HugePagePolicy policy) const noexcept
+    {
+      switch (policy)
+      {
+      case HugePagePolicy::none:
+      case HugePagePolicy::transparent:
+      case HugePagePolicy::huge2MiB:
+      case HugePagePolicy::huge1GiB:
+        return true;
+      default:
+        return false;
+      }
+    }
+  };
+
+  /// @brief Validator for the Transport enum class.
+  template<>
+  struct Validator<Transport>
+  {
+    constexpr bool operator()(Transport transport) const noexcept
+    {
+      switch (transport)
+      {
+      case Transport::automatic:
+      case Transport::hostStaged:
+      case Transport::gpuAware:
+      case Transport::nccl:
+        return true;
+      default:
+        return false;
+      }
+    }
+  };
+
   /// @brief Validator for the ComplexFormat enum class.
   template<>
   struct Validator<ComplexFormat>
@@ -188,6 +228,7 @@ namespace afft::detail
       {
       case Placement::inPlace:
       case Placement::outOfPlace:
+      case Placement::automatic:
         return true;
       default:
         return false;
@@ -287,6 +328,7 @@ namespace afft::detail
       switch (dhtType)
       {
       case dht::Type::separable:
+      case dht::Type::nonSeparable:
         return true;
       default:
         return false;
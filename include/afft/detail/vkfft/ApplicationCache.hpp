@@ -0,0 +1,182 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DETAIL_VKFFT_APPLICATION_CACHE_HPP
+#define AFFT_DETAIL_VKFFT_APPLICATION_CACHE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "../include.hpp"
+#endif
+
+namespace afft::detail::vkfft
+{
+  /**
+   * @class ApplicationCache
+   * @brief Process-wide cache of the VkFFT application strings by the cache key. The key identifies the device model
+   *        and the driver, so plans of the same configuration on other devices of the same model load the kernels
+   *        instead of generating and compiling them again, see Plan::cloneToDevice().
+   */
+  class ApplicationCache
+  {
+    public:
+      /**
+       * @brief Get the singleton instance of the application cache.
+       * @return The application cache.
+       */
+      [[nodiscard]] static ApplicationCache& getInstance()
+      {
+        static ApplicationCache instance{};
+        return instance;
+      }
+
+      /**
+       * @brief Get the application string for the key.
+       * @param key The cache key.
+       * @return The application string or std::nullopt if not cached.
+       */
+      [[nodiscard]] std::optional<std::string> get(const std::string& key) const
+      {
+        std::lock_guard lock{mMutex};
+
+        if (auto it = mApplications.find(key); it != mApplications.end())
+        {
+          return it->second;
+        }
+
+        return std::nullopt;
+      }
+
+      /**
+       * @brief Insert the application string for the key, an already cached string is replaced.
+       * @param key The cache key.
+       * @param data The application string.
+       * @param size The application string size in bytes.
+       */
+      void insert(const std::string& key, const void* data, std::size_t size)
+      {
+        if (data == nullptr || size == 0)
+        {
+          return;
+        }
+
+        std::lock_guard lock{mMutex};
+        mApplications.insert_or_assign(key, std::string{static_cast<const char*>(data), size});
+      }
+
+      /// @brief Clears the cache.
+      void clear()
+      {
+        std::lock_guard lock{mMutex};
+        mApplications.clear();
+      }
+
+    private:
+      /// @brief Default constructor.
+      ApplicationCache() = default;
+
+      mutable std::mutex                           mMutex{};        ///< The mutex guarding the cache.
+      std::unordered_map<std::string, std::string> mApplications{}; ///< The application strings by the key.
+  };
+
+  /**
+   * @brief Get the cache file path for the key.
+   * @param directory The cache directory.
+   * @param key The cache key.
+   * @return The cache file path.
+   */
+  [[nodiscard]] inline std::string getApplicationCacheFilePath(const std::string& directory, const std::string& key)
+  {
+    return directory + "/afft-vkfft-" + std::to_string(std::hash<std::string>{}(key)) + ".bin";
+  }
+
+  /**
+   * @brief Load the VkFFT application string from the cache directory. The file starts with the key line, so hash
+   *        collisions are detected.
+   * @param directory The cache directory.
+   * @param key The cache key.
+   * @return The application string or std::nullopt if not found.
+   */
+  [[nodiscard]] inline std::optional<std::string> loadApplication(const std::string& directory, const std::string& key)
+  {
+    std::ifstream file{getApplicationCacheFilePath(directory, key), std::ios::binary};
+
+    std::string fileKey{};
+
+    if (!std::getline(file, fileKey) || fileKey != key)
+    {
+      return std::nullopt;
+    }
+
+    std::string data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+    if (data.empty())
+    {
+      return std::nullopt;
+    }
+
+    return data;
+  }
+
+  /**
+   * @brief Store the VkFFT application string in the cache directory. The file is written to a temporary file first
+   *        and then renamed, so concurrent processes never read a partially written file. Failures are ignored, the
+   *        cache is only an optimization.
+   * @param directory The cache directory.
+   * @param key The cache key.
+   * @param data The application string.
+   * @param size The application string size in bytes.
+   */
+  inline void storeApplication(const std::string& directory, const std::string& key, const void* data, std::size_t size)
+  {
+    if (data == nullptr || size == 0)
+    {
+      return;
+    }
+
+    const auto filePath     = getApplicationCacheFilePath(directory, key);
+    const auto tempFilePath = filePath + ".tmp" +
+                              std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    {
+      std::ofstream file{tempFilePath, std::ios::binary | std::ios::trunc};
+
+      file << key << '\n';
+      file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+
+      if (!file)
+      {
+        std::remove(tempFilePath.c_str());
+        return;
+      }
+    }
+
+    if (std::rename(tempFilePath.c_str(), filePath.c_str()) != 0)
+    {
+      std::remove(tempFilePath.c_str());
+    }
+  }
+} // namespace afft::detail::vkfft
+
+#endif /* AFFT_DETAIL_VKFFT_APPLICATION_CACHE_HPP */
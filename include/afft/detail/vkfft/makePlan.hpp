@@ -32,8 +32,187 @@
 #include "../../Plan.hpp"
 #include "spst.hpp"
 
+#ifndef AFFT_DISABLE_GPU
+namespace afft::detail::vkfft::spst::gpu
+{
+  /// @brief Number of the measured executions of a tuning candidate, the fastest one is kept.
+  inline constexpr std::size_t tuningMeasuredRunCount{3};
+
+  /// @brief Tuning parameters searched by makeTunedPlan(), zeros keep the VkFFT defaults.
+  struct TuningParameters
+  {
+    std::size_t registerBoost{}; ///< Register boost.
+    int         useLUT{};        ///< Lookup table of the twiddle factors.
+    std::size_t aimThreads{};    ///< Number of threads per block VkFFT aims for.
+  };
+
+  /**
+   * @brief Make the tuning candidates. Only the tuning parameters left zero by the user are searched.
+   * @param vkfftParams VkFFT parameters.
+   * @return Candidate VkFFT parameters, the first one keeps the VkFFT defaults.
+   */
+  [[nodiscard]] inline std::vector<afft::vkfft::spst::gpu::Parameters>
+  makeTuningCandidates(const afft::vkfft::spst::gpu::Parameters& vkfftParams)
+  {
+    auto select = [](auto userValue, std::initializer_list<decltype(userValue)> values)
+    {
+      return (userValue != decltype(userValue){}) ? std::vector<decltype(userValue)>{userValue}
+                                                  : std::vector<decltype(userValue)>(values);
+    };
+
+    const auto registerBoosts = select(vkfftParams.registerBoost, {0, 2, 4});
+    const auto useLUTs        = select(vkfftParams.useLUT, {0, 1});
+    const auto aimThreads     = select(vkfftParams.aimThreads, {0, 256});
+
+    std::vector<afft::vkfft::spst::gpu::Parameters> candidates{};
+    candidates.reserve(registerBoosts.size() * useLUTs.size() * aimThreads.size());
+
+    for (const auto registerBoost : registerBoosts)
+    {
+      for (const auto useLUT : useLUTs)
+      {
+        for (const auto aimThread : aimThreads)
+        {
+          auto& candidate = candidates.emplace_back(vkfftParams);
+          candidate.registerBoost = registerBoost;
+          candidate.useLUT        = useLUT;
+          candidate.aimThreads    = aimThread;
+        }
+      }
+    }
+
+    return candidates;
+  }
+
+  /**
+   * @brief Create a vkfft spst gpu plan with the tuning parameters searched on a small grid. Each candidate is warmed
+   *        up and its fastest execution is measured on scratch buffers. The winner is remembered per descriptor, which
+   *        includes the shape and the device, later plans of the same descriptor reuse it without measuring. Plans
+   *        that cannot be executed on scratch buffers are not tuned.
+   * @param desc Plan description.
+   * @param vkfftParams VkFFT parameters.
+   * @return Plan implementation.
+   */
+  [[nodiscard]] inline std::unique_ptr<afft::Plan>
+  makeTunedPlan(const Desc& desc, const afft::vkfft::spst::gpu::Parameters& vkfftParams)
+  {
+    static std::mutex                                 tunedMutex{};
+    static std::unordered_map<Desc, TuningParameters> tunedParams{};
+
+    auto applyTuning = [&](const TuningParameters& tuning)
+    {
+      auto params = vkfftParams;
+      params.registerBoost = (params.registerBoost != 0) ? params.registerBoost : tuning.registerBoost;
+      params.useLUT        = (params.useLUT != 0) ? params.useLUT : tuning.useLUT;
+      params.aimThreads    = (params.aimThreads != 0) ? params.aimThreads : tuning.aimThreads;
+
+      return params;
+    };
+
+    Desc key{desc};
+    key.fillDefaultMemoryLayoutStrides();
+
+    {
+      std::lock_guard lock{tunedMutex};
+
+      if (auto it = tunedParams.find(key); it != tunedParams.end())
+      {
+        return makePlan(desc, applyTuning(it->second));
+      }
+    }
+
+    std::unique_ptr<afft::Plan>   bestPlan{};
+    std::chrono::duration<double> bestTime{};
+    TuningParameters              bestTuning{};
+
+    for (const auto& candidate : makeTuningCandidates(vkfftParams))
+    {
+      std::unique_ptr<afft::Plan>   plan{};
+      std::chrono::duration<double> time{std::chrono::duration<double>::max()};
+
+      try
+      {
+        plan = makePlan(desc, candidate);
+
+        if (!plan->hasWarmupScratchBuffers())
+        {
+          return plan;
+        }
+
+        (void)plan->warmup();
+
+        for (std::size_t i{}; i < tuningMeasuredRunCount; ++i)
+        {
+          time = std::min(time, plan->warmup().measuredTime);
+        }
+      }
+      catch (const std::exception&)
+      {
+        // VkFFT may reject a candidate configuration, the defaults are the first candidate
+        continue;
+      }
+
+      trace::emit(afft::trace::EventType::autotuneCandidate, Backend::vkfft, {}, time);
+
+      if (!bestPlan || time < bestTime)
+      {
+        bestPlan   = std::move(plan);
+        bestTime   = time;
+        bestTuning = TuningParameters{candidate.registerBoost, candidate.useLUT, candidate.aimThreads};
+      }
+    }
+
+    if (!bestPlan)
+    {
+      return makePlan(desc, vkfftParams);
+    }
+
+    {
+      std::lock_guard lock{tunedMutex};
+      tunedParams.emplace(std::move(key), bestTuning);
+    }
+
+    return bestPlan;
+  }
+} // namespace afft::detail::vkfft::spst::gpu
+#endif
+
 namespace afft::detail::vkfft
 {
+  /**
+   * @brief Check if the plan may be supported by the vkfft backend, without any side effects.
+   * @param desc Plan description.
+   * @return Backend support, the reason of the rejection if the plan is not supported.
+   */
+  [[nodiscard]] inline BackendSupport supports(const Desc& desc)
+  {
+    if (desc.getTarget() != Target::gpu)
+    {
+      return BackendSupport{"only gpu target is supported"};
+    }
+
+#ifndef AFFT_DISABLE_GPU
+    if (desc.getDistribution() != Distribution::spst)
+    {
+      return BackendSupport{"only spst distribution is supported"};
+    }
+
+    if (desc.getArchDesc<Target::gpu, Distribution::spst>().hasCallbacks())
+    {
+      return BackendSupport{"user callbacks are not supported"};
+    }
+
+    if (desc.getPrecision().source != desc.getPrecision().destination)
+    {
+      return BackendSupport{"source and destination precision must match"};
+    }
+
+    return BackendSupport{};
+#else
+    return BackendSupport{"gpu support is disabled"};
+#endif
+  }
+
   /**
    * @brief Create a plan implementation.
    * @tparam BackendParamsT Backend parameters type.
@@ -43,14 +222,24 @@ namespace afft::detail::vkfft
    */
   template<typename BackendParamsT>
   [[nodiscard]] std::unique_ptr<afft::Plan>
-  makePlan([[maybe_unused]] const Desc& desc, const BackendParamsT&)
+  makePlan([[maybe_unused]] const Desc& desc, [[maybe_unused]] const BackendParamsT& backendParams)
   {
+    if (const auto support = supports(desc); !support)
+    {
+      throw BackendError{Backend::vkfft, support.reason};
+    }
+
     if constexpr (BackendParamsT::target == Target::gpu)
     {
 #   ifndef AFFT_DISABLE_GPU
       if constexpr (BackendParamsT::distribution == Distribution::spst)
       {
-        return spst::gpu::makePlan(desc);
+        if (backendParams.strategy == SelectStrategy::best)
+        {
+          return spst::gpu::makeTunedPlan(desc, backendParams.vkfft);
+        }
+
+        return spst::gpu::makePlan(desc, backendParams.vkfft);
       }
       else
       {
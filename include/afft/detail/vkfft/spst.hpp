@@ -38,13 +38,16 @@ namespace afft::detail::vkfft::spst::gpu
   /**
    * @brief Create a vkfft spst gpu plan implementation.
    * @param desc Plan description.
+   * @param vkfftParams VkFFT parameters.
    * @return Plan implementation.
    */
-  [[nodiscard]] std::unique_ptr<afft::Plan> makePlan(const Desc& desc);
+  [[nodiscard]] std::unique_ptr<afft::Plan>
+  makePlan(const Desc& desc, const afft::vkfft::spst::gpu::Parameters& vkfftParams);
 } // namespace afft::detail::vkfft::spst::gpu
 
 #ifdef AFFT_HEADER_ONLY
 
+#include "ApplicationCache.hpp"
 #include "Plan.hpp"
 
 namespace afft::detail::vkfft::spst::gpu
@@ -52,6 +55,9 @@ namespace afft::detail::vkfft::spst::gpu
   /// @brief Alias for the unsigned integer type used by VkFFT
   using UInt = pfUINT;
 
+  /// @brief Alias for the signed integer type used by VkFFT
+  using Int = pfINT;
+
   /**
    * @class Plan
    * @brief Implementation of the plan for the spst gpu architecture using VkFFT
@@ -68,9 +74,10 @@ namespace afft::detail::vkfft::spst::gpu
 
       /**
        * @brief Constructor
-       * @param Desc The plan description
+       * @param desc The plan description
+       * @param vkfftParams The VkFFT parameters
        */
-      Plan(const Desc& desc)
+      Plan(const Desc& desc, const afft::vkfft::spst::gpu::Parameters& vkfftParams)
       : Parent{desc}
       {
         mDesc.fillDefaultMemoryLayoutStrides();
@@ -123,22 +130,31 @@ namespace afft::detail::vkfft::spst::gpu
         vkfftConfig.inputBufferSeparateComplexComponents  = separateComplexComponents;
         vkfftConfig.outputBufferSeparateComplexComponents = separateComplexComponents;
 
-        // Set up VkFFT config GPU memory parameters
-#     if defined(AFFT_ENABLE_CUDA)
-        vkfftConfig.coalescedMemory = 32;
-        vkfftConfig.numSharedBanks  = 32;
-#     elif defined(AFFT_ENABLE_HIP)
-        vkfftConfig.coalescedMemory = 32; // same for NVIDIA and AMD
-        vkfftConfig.numSharedBanks  = 32; // same for NVIDIA and AMD
-#     elif defined(AFFT_ENABLE_OPENCL)
-        // set by VkFFT internally
-#     endif
+        // Set up VkFFT config GPU memory parameters, the parameters left zero are derived by VkFFT
+        {
+#       if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+          const auto deviceParams = getDeviceParameters(gpuDesc.device);
+#       else
+          const afft::vkfft::spst::gpu::Parameters deviceParams{};
+#       endif
+
+          auto select = [](std::size_t value, std::size_t deviceValue)
+          {
+            return safeIntCast<UInt>((value != 0) ? value : deviceValue);
+          };
+
+          vkfftConfig.coalescedMemory  = select(vkfftParams.coalescedMemory, deviceParams.coalescedMemory);
+          vkfftConfig.numSharedBanks   = select(vkfftParams.numSharedBanks, deviceParams.numSharedBanks);
+          vkfftConfig.sharedMemorySize = select(vkfftParams.sharedMemorySize, deviceParams.sharedMemorySize);
+          vkfftConfig.maxThreadsNum    = select(vkfftParams.maxThreadsNum, deviceParams.maxThreadsNum);
+          vkfftConfig.warpSize         = select(vkfftParams.warpSize, deviceParams.warpSize);
+        }
 
-        // Set up VkFFT config 
+        // Set up VkFFT config omitted dimensions, VkFFT uses reverse order of axes
         std::fill_n(vkfftConfig.omitDimension, maxDimCount, UInt{1});
         for (const auto axis : mDesc.getTransformAxes())
         {
-          vkfftConfig.omitDimension[axis] = UInt{0};
+          vkfftConfig.omitDimension[shapeRank - axis - 1] = UInt{0};
         }
 
         // Set up VkFFT config precision
@@ -245,8 +261,8 @@ namespace afft::detail::vkfft::spst::gpu
 
           for (std::size_t i{}; i < mDesc.getTransformRank(); ++i)
           {
-            // VkFFT uses reverse order of axes
-            const auto vkfftAxis = transformAxes[mDesc.getTransformRank() - i - 1];
+            // VkFFT uses reverse order of axes, the i-th type belongs to the i-th transform axis
+            const auto vkfftAxis = shapeRank - transformAxes[i] - 1;
 
             switch (dttAxisTypes[i])
             {
@@ -304,13 +320,45 @@ namespace afft::detail::vkfft::spst::gpu
         // Disable locale
         vkfftConfig.disableSetLocale = 1;
 
-        // vkfftConfig.registerBoost              = getRegisterFileSize(Parent::mDevice) / getSharedMemorySize(Parent::mDevice);
-        // vkfftConfig.registerBoostNonPow2       = 1;
-        // vkfftConfig.registerBoost4Step         = getRegisterFileSize(Parent::mDevice) / getSharedMemorySize(Parent::mDevice);
+        // Set up the tuning parameters, VkFFT keeps its defaults for zeros
+        vkfftConfig.registerBoost          = safeIntCast<UInt>(vkfftParams.registerBoost);
+        vkfftConfig.performBandwidthBoost  = safeIntCast<Int>(vkfftParams.performBandwidthBoost);
+        vkfftConfig.useLUT                 = safeIntCast<Int>(vkfftParams.useLUT);
+        vkfftConfig.aimThreads             = safeIntCast<UInt>(vkfftParams.aimThreads);
+        vkfftConfig.disableReorderFourStep = (vkfftParams.disableReorderFourStep) ? UInt{1} : UInt{0};
+        vkfftConfig.fixMaxRadixBefore87    = safeIntCast<UInt>(vkfftParams.fixMaxRadixBefore87);
 
         // Initialize VkFFT with the configuration
-        checkError(initializeVkFFT(&mApp, std::move(vkfftConfig)));
+        initializeCached(vkfftConfig, std::string{vkfftParams.cacheDirectory});
         mInitialized = true;
+
+        // VkFFT allocates the temporary buffer unless the external workspace is used and three buffers of the chirp and
+        // its transforms for each axis transformed by Bluestein's algorithm
+        if (mApp.configuration.allocateTempBuffer && mApp.configuration.tempBufferSize != nullptr)
+        {
+          mBackendMemorySize += static_cast<std::size_t>(mApp.configuration.tempBufferSize[0]);
+        }
+
+        for (std::size_t i{}; i < static_cast<std::size_t>(mApp.configuration.FFTdim); ++i)
+        {
+          if (mApp.useBluesteinFFT[i])
+          {
+            mBackendMemorySize += 3 * static_cast<std::size_t>(mApp.applicationBluesteinBufferSize[i]);
+          }
+        }
+
+        // The temporary buffer allocated by VkFFT is shared by all executions, executions on different streams have to
+        // be ordered after each other
+        if (mApp.configuration.allocateTempBuffer)
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          cuda::checkError(cudaEventCreateWithFlags(&mTempBufferEvent, cudaEventDisableTiming));
+#       elif defined(AFFT_ENABLE_HIP)
+          hip::checkError(hipEventCreateWithFlags(&mTempBufferEvent, hipEventDisableTiming));
+#       elif defined(AFFT_ENABLE_OPENCL)
+          mOrderTempBuffer = true;
+#       endif
+        }
       }
 
       /// @brief Destructor
@@ -320,15 +368,43 @@ namespace afft::detail::vkfft::spst::gpu
         {
           deleteVkFFT(&mApp);
         }
+
+#     if defined(AFFT_ENABLE_CUDA)
+        if (mTempBufferEvent != nullptr)
+        {
+          cudaEventDestroy(mTempBufferEvent);
+        }
+#     elif defined(AFFT_ENABLE_HIP)
+        if (mTempBufferEvent != nullptr)
+        {
+          hipEventDestroy(mTempBufferEvent);
+        }
+#     elif defined(AFFT_ENABLE_OPENCL)
+        if (mTempBufferEvent != nullptr)
+        {
+          clReleaseEvent(mTempBufferEvent);
+        }
+#     endif
       }
 
       /// @brief Inherit assignment operator
       using Parent::operator=;
 
       /**
-       * @brief Execute the plan
+       * @brief Get the backend memory size, the compiled kernels are not included
+       * @return The size of the buffers allocated by VkFFT
+       */
+      [[nodiscard]] View<std::size_t> getBackendMemorySize() const noexcept override
+      {
+        return View<std::size_t>{&mBackendMemorySize, 1};
+      }
+
+      /**
+       * @brief Execute the plan on the stream of the execution parameters. The plan may be executed concurrently on
+       *        different streams, VkFFT reads the stream through the configuration, so the launches are serialized.
        * @param src The source buffer
        * @param dst The destination buffer
+       * @param execParams The execution parameters
        */
       void executeBackendImpl(View<void*> src, View<void*> dst, const afft::spst::gpu::ExecutionParameters& execParams) override
       {
@@ -364,53 +440,319 @@ namespace afft::detail::vkfft::spst::gpu
           cxx::unreachable();
         }
 
+        if (mDesc.useExternalWorkspace())
+        {
+          launchParams.tempBuffer = const_cast<void**>(&execParams.workspace);
+        }
+
+        std::lock_guard lock{mLaunchMutex};
+
 #     if defined(AFFT_ENABLE_CUDA)
         mStream = execParams.stream;
+
+        if (mTempBufferEvent != nullptr)
+        {
+          cuda::checkError(cudaStreamWaitEvent(mStream, mTempBufferEvent, 0));
+        }
+
+        checkError(VkFFTAppend(&mApp, getDirection(), &launchParams));
+
+        if (mTempBufferEvent != nullptr)
+        {
+          cuda::checkError(cudaEventRecord(mTempBufferEvent, mStream));
+        }
 #     elif defined(AFFT_ENABLE_HIP)
         mStream = execParams.stream;
+
+        if (mTempBufferEvent != nullptr)
+        {
+          hip::checkError(hipStreamWaitEvent(mStream, mTempBufferEvent, 0));
+        }
+
+        checkError(VkFFTAppend(&mApp, getDirection(), &launchParams));
+
+        if (mTempBufferEvent != nullptr)
+        {
+          hip::checkError(hipEventRecord(mTempBufferEvent, mStream));
+        }
 #     elif defined(AFFT_ENABLE_OPENCL)
-        mQueue  = execParams.commandQueue;
-#     endif
+        if (execParams.commandQueues.size() > 1 || execParams.completionEvents.size() > 1)
+        {
+          throw BackendError{Backend::vkfft, "only a single command queue and completion event are supported"};
+        }
 
-        if (mDesc.useExternalWorkspace())
+        mQueue = (execParams.commandQueues.empty()) ? execParams.commandQueue : execParams.commandQueues.front();
+
+        launchParams.commandQueue = &mQueue;
+
+        if (mTempBufferEvent != nullptr)
         {
-          launchParams.tempBuffer = const_cast<void**>(&execParams.workspace);
+          opencl::checkError(clEnqueueBarrierWithWaitList(mQueue, 1, &mTempBufferEvent, nullptr));
+        }
+
+        // VkFFT takes no event lists, the dependencies are expressed by barriers and markers of the queue
+        if (!execParams.waitEvents.empty())
+        {
+          opencl::checkError(clEnqueueBarrierWithWaitList(mQueue,
+                                                          static_cast<cl_uint>(execParams.waitEvents.size()),
+                                                          execParams.waitEvents.data(),
+                                                          nullptr));
         }
 
         checkError(VkFFTAppend(&mApp, getDirection(), &launchParams));
+
+        if (!execParams.completionEvents.empty())
+        {
+          opencl::checkError(clEnqueueMarkerWithWaitList(mQueue, 0, nullptr, execParams.completionEvents.data()));
+        }
+
+        if (mOrderTempBuffer)
+        {
+          cl_event tempBufferEvent{};
+          opencl::checkError(clEnqueueMarkerWithWaitList(mQueue, 0, nullptr, &tempBufferEvent));
+
+          if (mTempBufferEvent != nullptr)
+          {
+            clReleaseEvent(mTempBufferEvent);
+          }
+
+          mTempBufferEvent = tempBufferEvent;
+        }
+#     endif
       }
     protected:
     private:
+      /**
+       * @brief Initialize VkFFT with the kernels loaded from the process-wide application cache or the cache directory.
+       *        If they are not cached yet or cannot be loaded, the kernels are compiled and stored in both caches.
+       * @param vkfftConfig The VkFFT configuration
+       * @param directory The cache directory, empty disables the on-disk cache
+       */
+      void initializeCached(VkFFTConfiguration vkfftConfig, const std::string& directory)
+      {
+        const auto key = makeCacheKey(vkfftConfig);
+
+        auto& applicationCache = ApplicationCache::getInstance();
+
+        auto application = applicationCache.get(key);
+
+        const bool isInMemory = application.has_value();
+
+        if (!isInMemory && !directory.empty())
+        {
+          application = loadApplication(directory, key);
+        }
+
+        if (application)
+        {
+          VkFFTConfiguration loadConfig{vkfftConfig};
+          loadConfig.loadApplicationFromString = 1;
+          loadConfig.loadApplicationString     = application->data();
+
+          if (isOk(initializeVkFFT(&mApp, loadConfig)))
+          {
+            if (!isInMemory)
+            {
+              applicationCache.insert(key, application->data(), application->size());
+            }
+            return;
+          }
+
+          // The cached kernels are stale or corrupted, compile them again
+          mApp = VkFFTApplication{};
+        }
+
+        vkfftConfig.saveApplicationToString = 1;
+
+        checkError(initializeVkFFT(&mApp, vkfftConfig));
+
+        const auto applicationSize = static_cast<std::size_t>(mApp.applicationStringSize);
+
+        applicationCache.insert(key, mApp.saveApplicationString, applicationSize);
+
+        if (!directory.empty())
+        {
+          storeApplication(directory, key, mApp.saveApplicationString, applicationSize);
+        }
+      }
+
+      /**
+       * @brief Make the cache key identifying the kernels generated for the configuration on the plan device
+       * @param vkfftConfig The VkFFT configuration
+       * @return The cache key
+       */
+      [[nodiscard]] std::string makeCacheKey(const VkFFTConfiguration& vkfftConfig) const
+      {
+        std::string key = "vkfft" + std::to_string(VkFFTGetVersion());
+
+        auto append = [&](auto... values)
+        {
+          ((key += ' ', key += std::to_string(values)), ...);
+        };
+
+        auto appendArray = [&](const UInt* values)
+        {
+          for (std::size_t i{}; i < maxDimCount; ++i)
+          {
+            append(values[i]);
+          }
+        };
+
+        // Identify the device and the driver
+#     if defined(AFFT_ENABLE_CUDA)
+        {
+          char name[256]{};
+          int  driverVersion{};
+          int  ccMajor{};
+          int  ccMinor{};
+
+          cuda::checkError(cuDeviceGetName(name, static_cast<int>(sizeof(name)) - 1, mCuDevice));
+          cuda::checkError(cudaDriverGetVersion(&driverVersion));
+          cuda::checkError(cuDeviceGetAttribute(&ccMajor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR, mCuDevice));
+          cuda::checkError(cuDeviceGetAttribute(&ccMinor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR, mCuDevice));
+
+          key += ' ';
+          key += name;
+          append(driverVersion, ccMajor, ccMinor);
+        }
+#     elif defined(AFFT_ENABLE_HIP)
+        {
+          hipDeviceProp_t props{};
+          int             driverVersion{};
+
+          hip::checkError(hipGetDeviceProperties(&props, mHipDevice));
+          hip::checkError(hipDriverGetVersion(&driverVersion));
+
+          key += ' ';
+          key += props.name;
+          key += ' ';
+          key += props.gcnArchName;
+          append(driverVersion);
+        }
+#     elif defined(AFFT_ENABLE_OPENCL)
+        {
+          char name[256]{};
+          char driverVersion[256]{};
+
+          opencl::checkError(clGetDeviceInfo(mDevice, CL_DEVICE_NAME, sizeof(name) - 1, name, nullptr));
+          opencl::checkError(clGetDeviceInfo(mDevice, CL_DRIVER_VERSION, sizeof(driverVersion) - 1, driverVersion, nullptr));
+
+          key += ' ';
+          key += name;
+          key += ' ';
+          key += driverVersion;
+        }
+#     endif
+
+        // Identify the configuration, all the members set by the constructor
+        append(vkfftConfig.FFTdim);
+        appendArray(vkfftConfig.size);
+        appendArray(vkfftConfig.omitDimension);
+        append(vkfftConfig.performR2C);
+        appendArray(vkfftConfig.performR2R);
+        append(vkfftConfig.normalize,
+               vkfftConfig.halfPrecision,
+               vkfftConfig.halfPrecisionMemoryOnly,
+               vkfftConfig.doublePrecision,
+               vkfftConfig.doublePrecisionFloatMemory);
+#     ifdef AFFT_VKFFT_HAS_DOUBLE_DOUBLE
+        append(vkfftConfig.quadDoubleDoublePrecision, vkfftConfig.quadDoubleDoublePrecisionDoubleMemory);
+#     endif
+        append(vkfftConfig.makeForwardPlanOnly,
+               vkfftConfig.makeInversePlanOnly,
+               vkfftConfig.isInputFormatted,
+               vkfftConfig.isOutputFormatted);
+        appendArray(vkfftConfig.inputBufferStride);
+        appendArray(vkfftConfig.bufferStride);
+        appendArray(vkfftConfig.outputBufferStride);
+        append(vkfftConfig.bufferSeparateComplexComponents,
+               vkfftConfig.inputBufferSeparateComplexComponents,
+               vkfftConfig.outputBufferSeparateComplexComponents,
+               vkfftConfig.userTempBuffer,
+               vkfftConfig.coalescedMemory,
+               vkfftConfig.numSharedBanks,
+               vkfftConfig.sharedMemorySize,
+               vkfftConfig.maxThreadsNum,
+               vkfftConfig.warpSize,
+               vkfftConfig.registerBoost,
+               vkfftConfig.performBandwidthBoost,
+               vkfftConfig.useLUT,
+               vkfftConfig.aimThreads,
+               vkfftConfig.disableReorderFourStep,
+               vkfftConfig.fixMaxRadixBefore87);
+
+        return key;
+      }
+
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+      /**
+       * @brief Get the VkFFT memory parameters from the device attributes
+       * @param device The device
+       * @return The VkFFT parameters
+       */
+      [[nodiscard]] static afft::vkfft::spst::gpu::Parameters getDeviceParameters(int device)
+      {
+        int warpSize{};
+        int sharedMemorySize{};
+        int maxThreadsNum{};
+
+#     if defined(AFFT_ENABLE_CUDA)
+        cuda::checkError(cudaDeviceGetAttribute(&warpSize, cudaDevAttrWarpSize, device));
+        cuda::checkError(cudaDeviceGetAttribute(&sharedMemorySize, cudaDevAttrMaxSharedMemoryPerBlockOptin, device));
+        cuda::checkError(cudaDeviceGetAttribute(&maxThreadsNum, cudaDevAttrMaxThreadsPerBlock, device));
+#     elif defined(AFFT_ENABLE_HIP)
+        hip::checkError(hipDeviceGetAttribute(&warpSize, hipDeviceAttributeWarpSize, device));
+        hip::checkError(hipDeviceGetAttribute(&sharedMemorySize, hipDeviceAttributeMaxSharedMemoryPerBlock, device));
+        hip::checkError(hipDeviceGetAttribute(&maxThreadsNum, hipDeviceAttributeMaxThreadsPerBlock, device));
+#     endif
+
+        afft::vkfft::spst::gpu::Parameters params{};
+        params.warpSize         = static_cast<std::size_t>(warpSize);
+        params.sharedMemorySize = static_cast<std::size_t>(sharedMemorySize);
+        params.maxThreadsNum    = static_cast<std::size_t>(maxThreadsNum);
+        params.numSharedBanks   = 32; // 32 banks of 4 bytes on both NVIDIA and AMD
+#     if defined(AFFT_ENABLE_HIP) && defined(__HIP_PLATFORM_AMD__)
+        params.coalescedMemory  = 64; // AMD memory transactions are 64 bytes wide
+#     else
+        params.coalescedMemory  = 32; // NVIDIA memory transactions are 32 byte sectors
+#     endif
+
+        return params;
+      }
+#   endif
+
       VkFFTApplication mApp{};
       bool             mInitialized{false};
+      std::size_t      mBackendMemorySize{};  ///< Size of the buffers allocated by VkFFT
+      std::mutex       mLaunchMutex{};        ///< Serializes the launches, the stream is passed through the configuration
 #   if defined(AFFT_ENABLE_CUDA)
       CUdevice         mCuDevice{};
       cudaStream_t     mStream{0};
+      cudaEvent_t      mTempBufferEvent{};    ///< Orders the executions sharing the VkFFT temporary buffer
 #   elif defined(AFFT_ENABLE_HIP)
       hipDevice_t      mHipDevice{};
       hipStream_t      mStream{0};
+      hipEvent_t       mTempBufferEvent{};    ///< Orders the executions sharing the VkFFT temporary buffer
 #   elif defined(AFFT_ENABLE_OPENCL)
       cl_context       mContext{};
       cl_device_id     mDevice{};
       cl_command_queue mQueue{};
+      bool             mOrderTempBuffer{};    ///< Order the executions sharing the VkFFT temporary buffer
+      cl_event         mTempBufferEvent{};    ///< Marks the completion of the last execution
 #   endif
   };
 
   /**
    * @brief Create a vkfft spst gpu plan implementation.
    * @param desc Plan description.
+   * @param vkfftParams VkFFT parameters.
    * @return Plan implementation.
    */
-  [[nodiscard]] AFFT_HEADER_ONLY_INLINE std::unique_ptr<afft::Plan> makePlan(const Desc& desc)
+  [[nodiscard]] AFFT_HEADER_ONLY_INLINE std::unique_ptr<afft::Plan>
+  makePlan(const Desc& desc, const afft::vkfft::spst::gpu::Parameters& vkfftParams)
   {
-    const auto& precision = desc.getPrecision();
-
-    if (precision.source != precision.destination)
-    {
-      throw BackendError{Backend::vkfft, "source and destination precision must match"};
-    }
-
-    return std::make_unique<Plan>(desc);
+    // the precisions are checked by supports() in makePlan.hpp
+    return std::make_unique<Plan>(desc, vkfftParams);
   }
 } // namespace afft::detail::vkfft::spst::gpu
 
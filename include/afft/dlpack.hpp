@@ -0,0 +1,333 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_DLPACK_HPP
+#define AFFT_DLPACK_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "architecture.hpp"
+#include "common.hpp"
+#include "Plan.hpp"
+#include "utils.hpp"
+
+AFFT_EXPORT namespace afft::dlpack
+{
+#ifdef AFFT_ENABLE_DLPACK
+  /**
+   * @brief DLPack tensor described in afft terms. The tensor memory is not copied, the description views it and is
+   *        valid while the tensor is alive. Complex tensors are interleaved, their strides count complex elements.
+   */
+  struct Tensor
+  {
+    void*                    data{};                                    ///< data pointer with the byte offset applied
+    std::vector<std::size_t> shape{};                                   ///< shape of the tensor
+    std::vector<std::size_t> strides{};                                 ///< strides in elements, the row-major ones if the tensor has none
+    Precision                precision{};                               ///< precision of the elements
+    Complexity               complexity{};                              ///< complexity of the elements
+    ComplexFormat            complexFormat{ComplexFormat::interleaved}; ///< complex format, always interleaved
+    Target                   target{};                                  ///< target owning the memory
+    int                      device{};                                  ///< device index, 0 for cpu memory
+    bool                     readOnly{};                                ///< the producer marked the tensor read only
+
+    /// @brief Get the shape view.
+    [[nodiscard]] View<std::size_t> getShape() const noexcept
+    {
+      return View<std::size_t>{shape.data(), shape.size()};
+    }
+
+    /// @brief Get the strides view.
+    [[nodiscard]] View<std::size_t> getStrides() const noexcept
+    {
+      return View<std::size_t>{strides.data(), strides.size()};
+    }
+
+    /// @brief Get the size of the element in bytes.
+    [[nodiscard]] std::size_t sizeOfElem() const
+    {
+      return detail::sizeOf(precision) * ((complexity == Complexity::complex) ? 2 : 1);
+    }
+  };
+
+  /**
+   * @brief Describe a DLPack tensor. Single lane floating point, bfloat16 and complex tensors with non-negative
+   *        strides are supported. CPU, CUDA/ROCm host and CUDA managed memory are cpu memory, CUDA or ROCm device memory
+   *        is gpu memory if the matching gpu backend is enabled.
+   * @param tensor DLPack tensor.
+   * @return The tensor description.
+   */
+  [[nodiscard]] inline Tensor fromDLPack(const DLTensor& tensor)
+  {
+    if (tensor.ndim <= 0 || static_cast<std::size_t>(tensor.ndim) > maxDimCount)
+    {
+      throw std::invalid_argument{"DLPack tensor rank must be between 1 and maxDimCount"};
+    }
+
+    if (tensor.data == nullptr)
+    {
+      throw std::invalid_argument{"DLPack tensor data must not be null"};
+    }
+
+    if (tensor.dtype.lanes != 1)
+    {
+      throw std::invalid_argument{"vectorized DLPack tensors are not supported"};
+    }
+
+    Tensor desc{};
+
+    switch (tensor.dtype.code)
+    {
+    case kDLFloat:
+      desc.complexity = Complexity::real;
+      switch (tensor.dtype.bits)
+      {
+      case 16: desc.precision = Precision::f16; break;
+      case 32: desc.precision = Precision::f32; break;
+      case 64: desc.precision = Precision::f64; break;
+      default:
+        throw std::invalid_argument{"unsupported DLPack floating point tensor bits"};
+      }
+      break;
+    case kDLBfloat:
+      if (tensor.dtype.bits != 16)
+      {
+        throw std::invalid_argument{"unsupported DLPack bfloat tensor bits"};
+      }
+      desc.complexity = Complexity::real;
+      desc.precision  = Precision::bf16;
+      break;
+    case kDLComplex:
+      desc.complexity = Complexity::complex;
+      switch (tensor.dtype.bits)
+      {
+      case 32:  desc.precision = Precision::f16; break;
+      case 64:  desc.precision = Precision::f32; break;
+      case 128: desc.precision = Precision::f64; break;
+      default:
+        throw std::invalid_argument{"unsupported DLPack complex tensor bits"};
+      }
+      break;
+    default:
+      throw std::invalid_argument{"only floating point and complex DLPack tensors are supported"};
+    }
+
+    switch (tensor.device.device_type)
+    {
+    case kDLCPU:
+    case kDLCUDAHost:
+    case kDLROCMHost:
+      desc.target = Target::cpu;
+      break;
+    case kDLCUDAManaged:
+#   if defined(AFFT_ENABLE_CUDA)
+      desc.target = Target::gpu;
+      desc.device = tensor.device.device_id;
+#   else
+      desc.target = Target::cpu;
+#   endif
+      break;
+#   if defined(AFFT_ENABLE_CUDA)
+    case kDLCUDA:
+      desc.target = Target::gpu;
+      desc.device = tensor.device.device_id;
+      break;
+#   elif defined(AFFT_ENABLE_HIP)
+    case kDLROCM:
+      desc.target = Target::gpu;
+      desc.device = tensor.device.device_id;
+      break;
+#   endif
+    default:
+      throw std::invalid_argument{"unsupported DLPack tensor device"};
+    }
+
+    const auto rank = static_cast<std::size_t>(tensor.ndim);
+
+    desc.shape.resize(rank);
+    desc.strides.resize(rank);
+
+    for (std::size_t i{}; i < rank; ++i)
+    {
+      if (tensor.shape[i] < 0)
+      {
+        throw std::invalid_argument{"DLPack tensor shape must not be negative"};
+      }
+
+      desc.shape[i] = static_cast<std::size_t>(tensor.shape[i]);
+    }
+
+    if (tensor.strides != nullptr)
+    {
+      for (std::size_t i{}; i < rank; ++i)
+      {
+        if (tensor.strides[i] < 0)
+        {
+          throw std::invalid_argument{"negative DLPack tensor strides are not supported"};
+        }
+
+        desc.strides[i] = static_cast<std::size_t>(tensor.strides[i]);
+      }
+    }
+    else
+    {
+      makeStrides(desc.getShape(), Span<std::size_t>{desc.strides.data(), rank});
+    }
+
+    desc.data = static_cast<std::byte*>(tensor.data) + tensor.byte_offset;
+
+    return desc;
+  }
+
+  /**
+   * @brief Describe a managed DLPack tensor, the ownership stays with the caller.
+   * @param managedTensor Managed DLPack tensor.
+   * @return The tensor description.
+   */
+  [[nodiscard]] inline Tensor fromDLPack(const DLManagedTensor* managedTensor)
+  {
+    if (managedTensor == nullptr)
+    {
+      throw std::invalid_argument{"DLPack managed tensor must not be null"};
+    }
+
+    return fromDLPack(managedTensor->dl_tensor);
+  }
+
+# if DLPACK_MAJOR_VERSION >= 1
+  /**
+   * @brief Describe a versioned managed DLPack tensor, the ownership stays with the caller.
+   * @param managedTensor Versioned managed DLPack tensor.
+   * @return The tensor description.
+   */
+  [[nodiscard]] inline Tensor fromDLPack(const DLManagedTensorVersioned* managedTensor)
+  {
+    if (managedTensor == nullptr)
+    {
+      throw std::invalid_argument{"DLPack managed tensor must not be null"};
+    }
+
+    if (managedTensor->version.major != DLPACK_MAJOR_VERSION)
+    {
+      throw std::invalid_argument{"unsupported DLPack major version"};
+    }
+
+    auto desc = fromDLPack(managedTensor->dl_tensor);
+
+    desc.readOnly = (managedTensor->flags & DLPACK_FLAG_BITMASK_READ_ONLY) != 0;
+
+    return desc;
+  }
+# endif
+
+  /**
+   * @brief Make the spst memory layout of a transform from the source tensor to the destination tensor, the plan is
+   *        then made for the source shape directly on the tensor memory.
+   * @param src Source tensor.
+   * @param dst Destination tensor.
+   * @return The memory layout viewing the tensor strides, valid while the descriptions are alive.
+   */
+  [[nodiscard]] inline MemoryLayout<> makeMemoryLayout(const Tensor& src, const Tensor& dst)
+  {
+    if (src.shape.size() != dst.shape.size())
+    {
+      throw std::invalid_argument{"DLPack source and destination tensors must have the same rank"};
+    }
+
+    MemoryLayout<> memoryLayout{};
+    memoryLayout.srcStrides = src.getStrides();
+    memoryLayout.dstStrides = dst.getStrides();
+
+    return memoryLayout;
+  }
+
+  /**
+   * @brief Execute the plan directly on the tensor memory. The tensors are checked to match the plan target and
+   *        precision, the layout must be the one the plan was made with, see makeMemoryLayout().
+   * @tparam ExecParamsT Execution parameters type.
+   * @param plan Plan.
+   * @param src Source tensor.
+   * @param dst Destination tensor, the same as the source for in-place plans.
+   * @param execParams Execution parameters, e.g. the stream of the tensors.
+   */
+  template<typename ExecParamsT>
+  void execute(Plan& plan, const Tensor& src, const Tensor& dst, const ExecParamsT& execParams)
+  {
+    if (dst.readOnly)
+    {
+      throw std::invalid_argument{"DLPack destination tensor is read only"};
+    }
+
+    if (src.target != plan.getTarget() || dst.target != plan.getTarget())
+    {
+      throw std::invalid_argument{"DLPack tensor memory does not match the plan target"};
+    }
+
+    PrecisionTriad precision{};
+
+    switch (plan.getTransform())
+    {
+    case Transform::dft: precision = plan.getTransformParameters<Transform::dft>().precision; break;
+    case Transform::dht: precision = plan.getTransformParameters<Transform::dht>().precision; break;
+    case Transform::dtt: precision = plan.getTransformParameters<Transform::dtt>().precision; break;
+    default:
+      throw std::invalid_argument{"unsupported transform"};
+    }
+
+    if (src.precision != precision.source || dst.precision != precision.destination)
+    {
+      throw std::invalid_argument{"DLPack tensor precision does not match the plan precision"};
+    }
+
+    plan.executeUnsafe(static_cast<const void*>(src.data), dst.data, execParams);
+  }
+
+  /**
+   * @brief Execute the plan directly on the tensor memory with the default execution parameters, see execute() above.
+   * @param plan Plan.
+   * @param src Source tensor.
+   * @param dst Destination tensor, the same as the source for in-place plans.
+   */
+  inline void execute(Plan& plan, const Tensor& src, const Tensor& dst)
+  {
+    switch (plan.getTarget())
+    {
+    case Target::cpu:
+      execute(plan, src, dst, afft::cpu::ExecutionParameters{});
+      break;
+#   if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+    case Target::gpu:
+      execute(plan, src, dst, afft::gpu::ExecutionParameters{});
+      break;
+#   endif
+    default:
+      throw std::invalid_argument{"unsupported plan target"};
+    }
+  }
+#endif /* AFFT_ENABLE_DLPACK */
+} // namespace afft::dlpack
+
+#endif /* AFFT_DLPACK_HPP */
@@ -44,6 +44,8 @@ typedef enum
 
   afft_Error_invalidPrecision,
   afft_Error_invalidAlignment,
+  afft_Error_invalidHugePagePolicy,
+  afft_Error_invalidTransport,
   afft_Error_invalidComplexity,
   afft_Error_invalidComplexFormat,
   afft_Error_invalidDirection,
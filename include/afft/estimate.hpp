@@ -0,0 +1,456 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_ESTIMATE_HPP
+#define AFFT_ESTIMATE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "backend.hpp"
+#include "common.hpp"
+#include "detail/Desc.hpp"
+#include "detail/PlanStatsRecorder.hpp"
+#include "detail/makePlan.hpp"
+
+AFFT_EXPORT namespace afft
+{
+  /// @brief Calibrated cost model of a backend computing in a precision.
+  struct Calibration
+  {
+    Backend                       backend{};         ///< Backend
+    Precision                     precision{};       ///< Execution precision
+    double                        flopsPerSecond{};  ///< Throughput of the floating point operations
+    std::chrono::duration<double> overhead{};        ///< Size independent time of an execution
+    double                        workspaceFactor{}; ///< Workspace bytes per byte moved by an execution
+  };
+
+  /// @brief Predicted cost of a plan executed by a backend.
+  struct Estimate
+  {
+    Backend                                      backend{};       ///< Backend
+    std::size_t                                  workspaceSize{}; ///< Predicted workspace size in bytes
+    double                                       flops{};         ///< Floating point operations of an execution
+    std::size_t                                  bytes{};         ///< Bytes read and written by an execution
+    std::optional<std::chrono::duration<double>> time{};          ///< Predicted execution time, empty if uncalibrated
+  };
+
+  /**
+   * @class CalibrationTable
+   * @brief Calibrations of the backends used by estimate(). The table is usually loaded from the csv output of the
+   *        afft-bench target, run on the machine the estimates are made for. The execution time is modelled as
+   *        overhead + flops / flopsPerSecond fitted by least squares per backend and precision, the workspace as
+   *        proportional to the bytes moved.
+   */
+  class CalibrationTable
+  {
+    public:
+      /**
+       * @brief Insert or replace the calibration of its backend and precision.
+       * @param calibration Calibration.
+       */
+      void insert(const Calibration& calibration)
+      {
+        if (calibration.flopsPerSecond <= 0.0)
+        {
+          throw std::invalid_argument{"calibration throughput must be positive"};
+        }
+
+        auto it = std::find_if(mCalibrations.begin(), mCalibrations.end(), [&](const Calibration& other)
+        {
+          return other.backend == calibration.backend && other.precision == calibration.precision;
+        });
+
+        if (it != mCalibrations.end())
+        {
+          *it = calibration;
+        }
+        else
+        {
+          mCalibrations.push_back(calibration);
+        }
+      }
+
+      /**
+       * @brief Find the calibration of the backend and precision.
+       * @param backend Backend.
+       * @param precision Execution precision.
+       * @return Calibration if found, std::nullopt otherwise.
+       */
+      [[nodiscard]] std::optional<Calibration> find(Backend backend, Precision precision) const
+      {
+        auto it = std::find_if(mCalibrations.begin(), mCalibrations.end(), [&](const Calibration& calibration)
+        {
+          return calibration.backend == backend && calibration.precision == precision;
+        });
+
+        return (it != mCalibrations.end()) ? std::make_optional(*it) : std::nullopt;
+      }
+
+      /**
+       * @brief Get the number of calibrations.
+       * @return Number of calibrations.
+       */
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        return mCalibrations.size();
+      }
+
+      /**
+       * @brief Check if there are no calibrations.
+       * @return True if empty, false otherwise.
+       */
+      [[nodiscard]] bool empty() const noexcept
+      {
+        return mCalibrations.empty();
+      }
+
+      /**
+       * @brief Fit the calibrations to the csv output of afft-bench and merge them into the table. Failed cases are
+       *        skipped. A missing file is not an error.
+       * @param path Path to the file.
+       */
+      void loadBenchmark(const std::string& path)
+      {
+        std::ifstream file{path};
+
+        if (file.is_open())
+        {
+          loadBenchmark(file);
+        }
+      }
+
+      /**
+       * @brief Fit the calibrations to the csv output of afft-bench and merge them into the table. Failed cases are
+       *        skipped.
+       * @param stream Stream with the csv output.
+       */
+      void loadBenchmark(std::istream& stream)
+      {
+        std::string line{};
+
+        if (!std::getline(stream, line))
+        {
+          return;
+        }
+
+        const auto columns = splitCsvLine(line);
+
+        auto findColumn = [&](std::string_view name, bool isRequired) -> std::size_t
+        {
+          const auto it = std::find(columns.begin(), columns.end(), name);
+
+          if (it == columns.end() && isRequired)
+          {
+            throw std::runtime_error{"benchmark output lacks the " + std::string{name} + " column"};
+          }
+
+          return static_cast<std::size_t>(it - columns.begin());
+        };
+
+        const auto backendColumn   = findColumn("backend", true);
+        const auto precisionColumn = findColumn("precision", true);
+        const auto statusColumn    = findColumn("status", true);
+        const auto timeColumn      = findColumn("mean_exec_time_s", true);
+        const auto gflopsColumn    = findColumn("gflops", true);
+        const auto bandwidthColumn = findColumn("bytes_per_s", false);
+        const auto workspaceColumn = findColumn("workspace_bytes", false);
+
+        // Sums of the least squares fit of time = overhead + flops / flopsPerSecond and of the workspace ratio
+        struct Samples
+        {
+          Backend     backend{};
+          Precision   precision{};
+          std::size_t count{};
+          double      flops{};
+          double      time{};
+          double      flopsSquared{};
+          double      flopsTime{};
+          double      bytes{};
+          double      workspace{};
+        };
+
+        std::vector<Samples> samples{};
+
+        while (std::getline(stream, line))
+        {
+          if (line.empty())
+          {
+            continue;
+          }
+
+          const auto fields = splitCsvLine(line);
+
+          auto getField = [&](std::size_t column) -> std::string_view
+          {
+            return (column < fields.size()) ? std::string_view{fields[column]} : std::string_view{};
+          };
+
+          if (getField(statusColumn) != "ok")
+          {
+            continue;
+          }
+
+          const auto backend   = parseBackend(getField(backendColumn));
+          const auto precision = parsePrecision(getField(precisionColumn));
+          const auto time      = parseNumber(getField(timeColumn));
+          const auto flops     = parseNumber(getField(gflopsColumn)) * 1e9 * time;
+          const auto bytes     = parseNumber(getField(bandwidthColumn)) * time;
+
+          if (!backend || !precision || !(time > 0.0) || !(flops > 0.0))
+          {
+            continue;
+          }
+
+          auto it = std::find_if(samples.begin(), samples.end(), [&](const Samples& other)
+          {
+            return other.backend == *backend && other.precision == *precision;
+          });
+
+          if (it == samples.end())
+          {
+            it = samples.insert(samples.end(), Samples{*backend, *precision});
+          }
+
+          it->count        += 1;
+          it->flops        += flops;
+          it->time         += time;
+          it->flopsSquared += flops * flops;
+          it->flopsTime    += flops * time;
+
+          if (bytes > 0.0)
+          {
+            it->bytes     += bytes;
+            it->workspace += parseNumber(getField(workspaceColumn));
+          }
+        }
+
+        for (const auto& sample : samples)
+        {
+          const double n           = static_cast<double>(sample.count);
+          const double denominator = n * sample.flopsSquared - sample.flops * sample.flops;
+
+          Calibration calibration{sample.backend, sample.precision};
+
+          // Fall back to a pure throughput model if the sizes do not determine the overhead
+          double slope     = (denominator > 0.0) ? (n * sample.flopsTime - sample.flops * sample.time) / denominator : 0.0;
+          double intercept = (sample.time - slope * sample.flops) / n;
+
+          if (!(slope > 0.0) || intercept < 0.0)
+          {
+            slope     = sample.time / sample.flops;
+            intercept = 0.0;
+          }
+
+          calibration.flopsPerSecond  = 1.0 / slope;
+          calibration.overhead        = std::chrono::duration<double>{intercept};
+          calibration.workspaceFactor = (sample.bytes > 0.0) ? sample.workspace / sample.bytes : 0.0;
+
+          insert(calibration);
+        }
+      }
+    private:
+      /**
+       * @brief Split a csv line into fields, double quoted fields may contain commas and doubled quotes.
+       * @param line Line.
+       * @return Fields.
+       */
+      [[nodiscard]] static std::vector<std::string> splitCsvLine(std::string_view line)
+      {
+        std::vector<std::string> fields(1);
+        bool                     isQuoted{};
+
+        for (std::size_t i{}; i < line.size(); ++i)
+        {
+          const char c = line[i];
+
+          if (isQuoted)
+          {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+            {
+              fields.back() += '"';
+              ++i;
+            }
+            else if (c == '"')
+            {
+              isQuoted = false;
+            }
+            else
+            {
+              fields.back() += c;
+            }
+          }
+          else if (c == '"')
+          {
+            isQuoted = true;
+          }
+          else if (c == ',')
+          {
+            fields.emplace_back();
+          }
+          else if (c != '\r')
+          {
+            fields.back() += c;
+          }
+        }
+
+        return fields;
+      }
+
+      /**
+       * @brief Parse a backend name as printed by toString(Backend).
+       * @param name Name.
+       * @return Backend, std::nullopt if unknown.
+       */
+      [[nodiscard]] static std::optional<Backend> parseBackend(std::string_view name)
+      {
+        for (std::size_t i{}; i < backendCount; ++i)
+        {
+          const Backend backend = static_cast<Backend>(std::underlying_type_t<Backend>(1) << i);
+
+          if (toString(backend) == name)
+          {
+            return backend;
+          }
+        }
+
+        return std::nullopt;
+      }
+
+      /**
+       * @brief Parse a precision name, e.g. "f32".
+       * @param name Name.
+       * @return Precision, std::nullopt if unknown.
+       */
+      [[nodiscard]] static std::optional<Precision> parsePrecision(std::string_view name)
+      {
+        constexpr std::pair<std::string_view, Precision> precisionNames[]
+        {
+          {"bf16", Precision::bf16}, {"f16", Precision::f16}, {"f32", Precision::f32}, {"f64", Precision::f64},
+          {"f80", Precision::f80}, {"f64f64", Precision::f64f64}, {"f128", Precision::f128},
+        };
+
+        for (const auto& [precisionName, precision] : precisionNames)
+        {
+          if (precisionName == name)
+          {
+            return precision;
+          }
+        }
+
+        return std::nullopt;
+      }
+
+      /**
+       * @brief Parse a number, zero if empty or invalid.
+       * @param str String.
+       * @return Number.
+       */
+      [[nodiscard]] static double parseNumber(std::string_view str)
+      {
+        const std::string copy{str};
+        char*             end{};
+
+        const double value = std::strtod(copy.c_str(), &end);
+
+        return (end != copy.c_str()) ? value : 0.0;
+      }
+
+      std::vector<Calibration> mCalibrations{}; ///< Calibrations
+  };
+
+  /**
+   * @brief Estimate the cost of the plan of each backend selected by the backend parameters without creating any plan
+   *        or allocating memory. The flops and bytes follow the conventions of Plan::getStats(), the time and the
+   *        workspace come from the calibration of the backend in the execution precision. The estimates do not check
+   *        whether a backend supports the transform, nor do they account for the fallback plans.
+   * @tparam TransformParamsT Transform parameters type
+   * @tparam ArchParamsT Architecture parameters type
+   * @tparam BackendParamsT Backend parameters type
+   * @param transformParams Transform parameters
+   * @param archParams Architecture parameters
+   * @param backendParams Backend parameters
+   * @param calibrationTable Calibration table, the time and workspace of an uncalibrated backend are not estimated
+   * @return Estimates in the backend order.
+   */
+  template<typename TransformParamsT, typename ArchParamsT, typename BackendParamsT = detail::DefaultBackendParameters>
+  [[nodiscard]] std::vector<Estimate> estimate(const TransformParamsT& transformParams,
+                                               const ArchParamsT&      archParams,
+                                               const BackendParamsT&   backendParams    = {},
+                                               const CalibrationTable& calibrationTable = {})
+  {
+    static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+    static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+    static_assert(isBackendParameters<BackendParamsT> ||
+                  std::is_same_v<BackendParamsT, detail::DefaultBackendParameters>,
+                  "Invalid backend parameters type");
+
+    static_assert(std::is_same_v<BackendParamsT, detail::DefaultBackendParameters> ||
+                  ((ArchParamsT::target == BackendParamsT::target) &&
+                   (ArchParamsT::distribution == BackendParamsT::distribution)),
+                  "Architecture and backend parameters must share the same target and distribution");
+
+    using ResolvedBackendParamsT = std::conditional_t<std::is_same_v<BackendParamsT, detail::DefaultBackendParameters>,
+                                                      BackendParameters<ArchParamsT::target, ArchParamsT::distribution>,
+                                                      BackendParamsT>;
+
+    ResolvedBackendParamsT resolvedBackendParams{};
+
+    if constexpr (!std::is_same_v<BackendParamsT, detail::DefaultBackendParameters>)
+    {
+      resolvedBackendParams = backendParams;
+    }
+
+    const detail::Desc desc{transformParams, archParams};
+
+    const auto flops     = detail::estimateFlops(desc);
+    const auto bytes     = detail::estimateBytes(desc);
+    const auto precision = desc.getPrecision().execution;
+
+    const auto backendMask = resolvedBackendParams.mask & detail::getEnabledBackendMask() &
+                             detail::getSupportedBackendMask<ArchParamsT::target, ArchParamsT::distribution>();
+
+    std::vector<Estimate> estimates{};
+
+    detail::forEachBackend(backendMask, resolvedBackendParams.order, [&](Backend backend)
+    {
+      Estimate& backendEstimate = estimates.emplace_back();
+      backendEstimate.backend = backend;
+      backendEstimate.flops   = flops;
+      backendEstimate.bytes   = bytes;
+
+      if (const auto calibration = calibrationTable.find(backend, precision))
+      {
+        backendEstimate.workspaceSize = static_cast<std::size_t>(calibration->workspaceFactor * static_cast<double>(bytes));
+        backendEstimate.time          = calibration->overhead +
+                                        std::chrono::duration<double>{flops / calibration->flopsPerSecond};
+      }
+    });
+
+    return estimates;
+  }
+} // namespace afft
+
+#endif /* AFFT_ESTIMATE_HPP */
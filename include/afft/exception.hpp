@@ -163,6 +163,8 @@ AFFT_EXPORT namespace afft
         gpuBackendName = "HIP";
 #     elif defined(AFFT_ENABLE_OPENCL)
         gpuBackendName = "OpenCL";
+#     elif defined(AFFT_ENABLE_SYCL)
+        gpuBackendName = "SYCL";
 #     endif
 
         return detail::cformatNothrow("[%s error] %s", gpuBackendName.data(), msg.data());
@@ -29,6 +29,7 @@
 # include "detail/include.h"
 #endif
 
+#include "backend.h"
 #include "error.h"
 
 #ifdef __cplusplus
@@ -39,6 +40,13 @@ extern "C"
 /// @brief Initialize the library
 afft_Error afft_init();
 
+/**
+ * @brief Initialize the library and the selected backends eagerly, the other backends are initialized on first use
+ * @param backendMask Backends to initialize immediately
+ * @return Error code
+ */
+afft_Error afft_initBackends(afft_BackendMask backendMask);
+
 /// @brief Finalize the library
 afft_Error afft_finalize();
 
@@ -29,9 +29,17 @@
 
 AFFT_EXPORT namespace afft
 {
-  /// @brief Initialize the library. Should be called before any other afft function.
+  /// @brief Initialize the library. Should be called before any other afft function. Backends are initialized lazily
+  ///        on their first use.
   void init();
 
+  /**
+   * @brief Initialize the library and eagerly initialize the selected backends. The other backends are still
+   *        initialized on their first use. Backends that are not enabled are ignored.
+   * @param backendMask Backends to initialize immediately.
+   */
+  void init(BackendMask backendMask);
+
   /// @brief Finalize the library.
   void finalize();
 
@@ -41,6 +49,11 @@ AFFT_EXPORT namespace afft
     detail::Initializer::getInstance().init();
   }
 
+  AFFT_HEADER_ONLY_INLINE void init(BackendMask backendMask)
+  {
+    detail::Initializer::getInstance().init(backendMask);
+  }
+
   /// @brief Finalize the library.
   AFFT_HEADER_ONLY_INLINE void finalize()
   {
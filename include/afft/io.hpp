@@ -0,0 +1,528 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_IO_HPP
+#define AFFT_IO_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "common.hpp"
+#if defined(AFFT_ENABLE_CUDA) && defined(AFFT_ENABLE_GDS)
+# include "detail/cuda/error.hpp"
+#endif
+
+AFFT_EXPORT namespace afft::io
+{
+  /// @brief Mode of mapping a file.
+  enum class MapMode : std::uint8_t
+  {
+    read,      ///< map an existing file read-only
+    readWrite, ///< map an existing file for reading and writing, the writes are stored to the file
+    create,    ///< create or truncate the file to the given size and map it for reading and writing
+  };
+
+  /// @brief Expected access pattern of mapped memory.
+  enum class Access : std::uint8_t
+  {
+    normal,     ///< no special treatment, the default read-ahead
+    sequential, ///< accessed in increasing address order, aggressive read-ahead and early reclaim of the read pages
+    random,     ///< accessed in no particular order, no read-ahead
+  };
+
+  /**
+   * @brief Advise the kernel of the access pattern of mapped memory. The range is widened to whole pages, the advice
+   *        is a hint and its failure is ignored, so it is harmless for memory that is not file-backed.
+   * @param ptr The memory.
+   * @param size The size in bytes.
+   * @param access The access pattern.
+   */
+  inline void advise(const void* ptr, std::size_t size, Access access) noexcept
+  {
+#   if defined(__linux__)
+    if (ptr == nullptr || size == 0)
+    {
+      return;
+    }
+
+    int advice{};
+
+    switch (access)
+    {
+    case Access::sequential: advice = MADV_SEQUENTIAL; break;
+    case Access::random:     advice = MADV_RANDOM;     break;
+    default:                 advice = MADV_NORMAL;     break;
+    }
+
+    static const auto pageSize = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+
+    const auto begin = reinterpret_cast<std::uintptr_t>(ptr) / pageSize * pageSize;
+    const auto end   = reinterpret_cast<std::uintptr_t>(ptr) + size;
+
+    ::madvise(reinterpret_cast<void*>(begin), static_cast<std::size_t>(end - begin), advice);
+#   else
+    static_cast<void>(ptr);
+    static_cast<void>(size);
+    static_cast<void>(access);
+#   endif
+  }
+
+  /**
+   * @brief Start reading mapped memory in the background, the pages are resident by the time they are touched if the
+   *        storage keeps up. The range is widened to whole pages, the failure is ignored.
+   * @param ptr The memory.
+   * @param size The size in bytes.
+   */
+  inline void prefetch(const void* ptr, std::size_t size) noexcept
+  {
+#   if defined(__linux__)
+    if (ptr == nullptr || size == 0)
+    {
+      return;
+    }
+
+    static const auto pageSize = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+
+    const auto begin = reinterpret_cast<std::uintptr_t>(ptr) / pageSize * pageSize;
+    const auto end   = reinterpret_cast<std::uintptr_t>(ptr) + size;
+
+    ::madvise(reinterpret_cast<void*>(begin), static_cast<std::size_t>(end - begin), MADV_WILLNEED);
+#   else
+    static_cast<void>(ptr);
+    static_cast<void>(size);
+#   endif
+  }
+
+  /**
+   * @class MappedArray
+   * @brief File mapped into the address space as a shared mapping, so data larger than the memory can be transformed
+   *        by cpu::OutOfCoreExecutor. The pages are read on the first touch and written back by the kernel, call
+   *        flush() to store them before the file is used elsewhere. Available on Linux only.
+   */
+  class MappedArray
+  {
+    public:
+      /// @brief Default constructor, no file is mapped.
+      MappedArray() = default;
+
+      /**
+       * @brief Constructor, opens and maps the file.
+       * @param path Path to the file.
+       * @param mode The mapping mode.
+       * @param size The size of the created file in bytes, ignored unless the mode is create.
+       */
+      explicit MappedArray(const std::string& path, MapMode mode = MapMode::read, std::size_t size = 0)
+      : mWritable{mode != MapMode::read}
+      {
+#     if defined(__linux__)
+        int flags{};
+
+        switch (mode)
+        {
+        case MapMode::read:      flags = O_RDONLY;                   break;
+        case MapMode::readWrite: flags = O_RDWR;                     break;
+        case MapMode::create:    flags = O_RDWR | O_CREAT | O_TRUNC; break;
+        default:
+          throw std::invalid_argument("invalid map mode");
+        }
+
+        mFd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+
+        if (mFd < 0)
+        {
+          throw std::runtime_error("failed to open " + path + ": " + std::strerror(errno));
+        }
+
+        try
+        {
+          if (mode == MapMode::create)
+          {
+            if (::ftruncate(mFd, static_cast<off_t>(size)) != 0)
+            {
+              throw std::runtime_error("failed to resize " + path + ": " + std::strerror(errno));
+            }
+
+            mSize = size;
+          }
+          else
+          {
+            struct stat fileStat{};
+
+            if (::fstat(mFd, &fileStat) != 0)
+            {
+              throw std::runtime_error("failed to stat " + path + ": " + std::strerror(errno));
+            }
+
+            mSize = static_cast<std::size_t>(fileStat.st_size);
+          }
+
+          // an empty file cannot be mapped, it is represented by a null mapping
+          if (mSize > 0)
+          {
+            const int prot = (mWritable) ? (PROT_READ | PROT_WRITE) : PROT_READ;
+
+            void* ptr = ::mmap(nullptr, mSize, prot, MAP_SHARED, mFd, 0);
+
+            if (ptr == MAP_FAILED)
+            {
+              throw std::runtime_error("failed to map " + path + ": " + std::strerror(errno));
+            }
+
+            mData = static_cast<std::byte*>(ptr);
+          }
+        }
+        catch (...)
+        {
+          ::close(mFd);
+          throw;
+        }
+#     else
+        static_cast<void>(path);
+        static_cast<void>(size);
+
+        throw std::runtime_error("memory-mapped arrays are supported only on Linux");
+#     endif
+      }
+
+      /// @brief Copy constructor is deleted.
+      MappedArray(const MappedArray&) = delete;
+
+      /// @brief Move constructor.
+      MappedArray(MappedArray&& other) noexcept
+      : mFd{std::exchange(other.mFd, -1)},
+        mData{std::exchange(other.mData, nullptr)},
+        mSize{std::exchange(other.mSize, 0)},
+        mWritable{std::exchange(other.mWritable, false)}
+      {}
+
+      /// @brief Destructor, unmaps and closes the file, pending writes are stored by the kernel.
+      ~MappedArray()
+      {
+        release();
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      MappedArray& operator=(const MappedArray&) = delete;
+
+      /// @brief Move assignment operator.
+      MappedArray& operator=(MappedArray&& other) noexcept
+      {
+        if (this != &other)
+        {
+          release();
+
+          mFd       = std::exchange(other.mFd, -1);
+          mData     = std::exchange(other.mData, nullptr);
+          mSize     = std::exchange(other.mSize, 0);
+          mWritable = std::exchange(other.mWritable, false);
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Get the mapped memory.
+       * @return The mapped memory, null if nothing is mapped.
+       */
+      [[nodiscard]] std::byte* data() noexcept
+      {
+        return mData;
+      }
+
+      /// @brief Get the mapped memory.
+      [[nodiscard]] const std::byte* data() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Get the mapped memory as an array of elements.
+       * @tparam T The element type.
+       * @return The mapped memory.
+       */
+      template<typename T>
+      [[nodiscard]] T* data() noexcept
+      {
+        return reinterpret_cast<T*>(mData);
+      }
+
+      /// @brief Get the mapped memory as an array of elements.
+      template<typename T>
+      [[nodiscard]] const T* data() const noexcept
+      {
+        return reinterpret_cast<const T*>(mData);
+      }
+
+      /**
+       * @brief Get the size of the mapping.
+       * @return The size in bytes.
+       */
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Check if the mapping may be written.
+       * @return True if the mapping is writable, false otherwise.
+       */
+      [[nodiscard]] bool isWritable() const noexcept
+      {
+        return mWritable;
+      }
+
+      /**
+       * @brief Advise the kernel of the access pattern of the whole mapping.
+       * @param access The access pattern.
+       */
+      void advise(Access access) const noexcept
+      {
+        io::advise(mData, mSize, access);
+      }
+
+      /**
+       * @brief Start reading a range of the mapping in the background.
+       * @param offset The offset of the range in bytes.
+       * @param size The size of the range in bytes, clamped to the end of the mapping.
+       */
+      void prefetch(std::size_t offset, std::size_t size) const noexcept
+      {
+        if (offset < mSize)
+        {
+          io::prefetch(mData + offset, std::min(size, mSize - offset));
+        }
+      }
+
+      /**
+       * @brief Store the written pages to the file.
+       * @param wait Wait for the pages to be stored, otherwise only start the write back.
+       */
+      void flush(bool wait = true)
+      {
+#     if defined(__linux__)
+        if (mData != nullptr && mWritable && ::msync(mData, mSize, (wait) ? MS_SYNC : MS_ASYNC) != 0)
+        {
+          throw std::runtime_error(std::string{"failed to flush the mapped file: "} + std::strerror(errno));
+        }
+#     else
+        static_cast<void>(wait);
+#     endif
+      }
+    private:
+      /// @brief Unmap and close the file.
+      void release() noexcept
+      {
+#     if defined(__linux__)
+        if (mData != nullptr)
+        {
+          ::munmap(mData, mSize);
+        }
+
+        if (mFd >= 0)
+        {
+          ::close(mFd);
+        }
+#     endif
+
+        mFd   = -1;
+        mData = nullptr;
+        mSize = 0;
+      }
+
+      int         mFd{-1};     ///< The file descriptor.
+      std::byte*  mData{};     ///< The mapped memory.
+      std::size_t mSize{};     ///< The size of the mapping in bytes.
+      bool        mWritable{}; ///< The mapping is writable.
+  };
+
+#if defined(AFFT_ENABLE_CUDA) && defined(AFFT_ENABLE_GDS)
+  /**
+   * @class DeviceFile
+   * @brief File read by GPUDirect Storage straight into device memory, no host bounce buffer is involved, see
+   *        gpu::OutOfCoreExecutor. The file is opened with O_DIRECT, cuFile falls back to its compatibility mode if the
+   *        storage or the file system does not support direct transfers. The cuFile driver is opened with the first
+   *        file and stays open until the process exits.
+   */
+  class DeviceFile
+  {
+    public:
+      /// @brief Default constructor, no file is opened.
+      DeviceFile() = default;
+
+      /**
+       * @brief Constructor, opens the file and registers it with cuFile.
+       * @param path Path to the file.
+       */
+      explicit DeviceFile(const std::string& path)
+      {
+        static const CUfileError_t driverStatus = cuFileDriverOpen();
+
+        detail::cuda::checkError(driverStatus);
+
+        mFd = ::open(path.c_str(), O_RDONLY | O_DIRECT | O_CLOEXEC);
+
+        if (mFd < 0)
+        {
+          throw std::runtime_error("failed to open " + path + ": " + std::strerror(errno));
+        }
+
+        try
+        {
+          struct stat fileStat{};
+
+          if (::fstat(mFd, &fileStat) != 0)
+          {
+            throw std::runtime_error("failed to stat " + path + ": " + std::strerror(errno));
+          }
+
+          mSize = static_cast<std::size_t>(fileStat.st_size);
+
+          CUfileDescr_t descr{};
+          descr.handle.fd = mFd;
+          descr.type      = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+
+          detail::cuda::checkError(cuFileHandleRegister(&mHandle, &descr));
+        }
+        catch (...)
+        {
+          ::close(mFd);
+          throw;
+        }
+      }
+
+      /// @brief Copy constructor is deleted.
+      DeviceFile(const DeviceFile&) = delete;
+
+      /// @brief Move constructor.
+      DeviceFile(DeviceFile&& other) noexcept
+      : mFd{std::exchange(other.mFd, -1)},
+        mHandle{std::exchange(other.mHandle, nullptr)},
+        mSize{std::exchange(other.mSize, 0)}
+      {}
+
+      /// @brief Destructor, deregisters and closes the file.
+      ~DeviceFile()
+      {
+        release();
+      }
+
+      /// @brief Copy assignment operator is deleted.
+      DeviceFile& operator=(const DeviceFile&) = delete;
+
+      /// @brief Move assignment operator.
+      DeviceFile& operator=(DeviceFile&& other) noexcept
+      {
+        if (this != &other)
+        {
+          release();
+
+          mFd     = std::exchange(other.mFd, -1);
+          mHandle = std::exchange(other.mHandle, nullptr);
+          mSize   = std::exchange(other.mSize, 0);
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Get the size of the file.
+       * @return The size in bytes.
+       */
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Read a range of the file into device memory, returns after the data are in the device memory. Offsets
+       *        and sizes that are multiples of 4 KiB keep the transfer direct.
+       * @param devicePtr The device memory, registered buffers avoid the internal cuFile staging.
+       * @param size The size of the range in bytes.
+       * @param offset The offset of the range in the file in bytes.
+       */
+      void read(void* devicePtr, std::size_t size, std::size_t offset) const
+      {
+        if (mHandle == nullptr)
+        {
+          throw std::invalid_argument("no file is opened");
+        }
+
+        if (offset > mSize || size > mSize - offset)
+        {
+          throw std::invalid_argument("the read range exceeds the file");
+        }
+
+        // a read may return fewer bytes than requested, the rest is read from where it stopped
+        for (std::size_t done{}; done < size;)
+        {
+          const ssize_t result = cuFileRead(mHandle,
+                                            devicePtr,
+                                            size - done,
+                                            static_cast<off_t>(offset + done),
+                                            static_cast<off_t>(done));
+
+          if (result < 0)
+          {
+            const char* errorStr = (result == -1) ? std::strerror(errno)
+                                                  : CUFILE_ERRSTR(static_cast<CUfileOpError>(-result));
+
+            throw GpuBackendError{detail::cformatNothrow("cuFile read failed - %s", errorStr)};
+          }
+          else if (result == 0)
+          {
+            throw std::runtime_error("unexpected end of the file read by cuFile");
+          }
+
+          done += static_cast<std::size_t>(result);
+        }
+      }
+    private:
+      /// @brief Deregister and close the file.
+      void release() noexcept
+      {
+        if (mHandle != nullptr)
+        {
+          cuFileHandleDeregister(mHandle);
+        }
+
+        if (mFd >= 0)
+        {
+          ::close(mFd);
+        }
+
+        mFd     = -1;
+        mHandle = nullptr;
+        mSize   = 0;
+      }
+
+      int            mFd{-1};   ///< The file descriptor.
+      CUfileHandle_t mHandle{}; ///< The cuFile handle of the file.
+      std::size_t    mSize{};   ///< The size of the file in bytes.
+  };
+#endif
+} // namespace afft::io
+
+#endif /* AFFT_IO_HPP */
@@ -30,6 +30,7 @@
 #endif
 
 #include "detail/makePlan.hpp"
+#include "detail/ThreadPool.hpp"
 
 AFFT_EXPORT namespace afft
 {
@@ -76,6 +77,438 @@ AFFT_EXPORT namespace afft
     }
   }
 
+  /// @brief Accuracy target of a plan, see makeAccuratePlan()
+  struct AccuracyTarget
+  {
+    double maxRelativeError{}; ///< maximum relative L2 error of the transform result, must be positive
+    bool   validate{true};     ///< validate spst cpu candidates by transforming random data, other targets use the estimate
+  };
+
+  /**
+   * @brief Create a plan executed in the cheapest precision meeting an accuracy target. The execution precision of the
+   *        transform parameters is the most accurate candidate, the less accurate ones are tried first. A candidate
+   *        is rejected if its estimated relative L2 error exceeds the target. Spst cpu candidates passing the estimate are
+   *        validated once by transforming uniformly distributed random data against the plan executed in the requested
+   *        precision, if the source and destination are f32 or f64. The cpu targets skip the 16-bit precisions, their
+   *        backends compute them in f32. The source and destination precisions are kept.
+   *        Each candidate adds a feedback with its estimated or validated error, the last one is the selected plan.
+   * @tparam TransformParamsT Transform parameters type
+   * @tparam ArchParamsT Architecture parameters type
+   * @tparam BackendParamsT Backend parameters type
+   * @param transformParams Transform parameters, the execution precision is the most accurate candidate
+   * @param archParams Architecutre parameters
+   * @param accuracyTarget Accuracy target
+   * @param backendParams Backend parameters
+   * @param feedbacks Feedbacks of the candidates, may be null
+   * @return Plan
+   * @throw std::runtime_error if no execution precision meets the target
+   */
+  template<typename TransformParamsT, typename ArchParamsT, typename BackendParamsT = detail::DefaultBackendParameters>
+  std::unique_ptr<Plan> makeAccuratePlan(const TransformParamsT& transformParams,
+                                         ArchParamsT&            archParams,
+                                         const AccuracyTarget&   accuracyTarget,
+                                         const BackendParamsT&   backendParams = {},
+                                         std::vector<Feedback>*  feedbacks     = nullptr)
+  {
+    if (!(accuracyTarget.maxRelativeError > 0.0))
+    {
+      throw std::invalid_argument("the maximum relative error must be positive");
+    }
+
+    // ordered from the cheapest to the most accurate
+    constexpr Precision candidates[]{Precision::bf16,
+                                     Precision::f16,
+                                     Precision::f32,
+                                     Precision::f64,
+                                     Precision::f80,
+                                     Precision::f64f64,
+                                     Precision::f128};
+
+    constexpr bool canValidate = (ArchParamsT::target == Target::cpu && ArchParamsT::distribution == Distribution::spst);
+
+    const Precision maxPrecision = transformParams.precision.execution;
+
+    std::unique_ptr<Plan> referencePlan{};
+    bool                  hasReferencePlan{};
+
+    auto addFeedback = [&](Feedback&& feedback)
+    {
+      if (feedbacks != nullptr)
+      {
+        feedbacks->push_back(std::move(feedback));
+      }
+    };
+
+    for (const auto precision : candidates)
+    {
+      if (detail::cxx::to_underlying(precision) > detail::cxx::to_underlying(maxPrecision))
+      {
+        break;
+      }
+
+      auto candidateParams = transformParams;
+      candidateParams.precision.execution = precision;
+
+      const detail::Desc desc{candidateParams, archParams};
+
+      Feedback feedback{};
+      feedback.relativeError = detail::estimateRelativeError(desc);
+
+      const std::string name = "execution precision " + std::string{toString(precision)};
+
+      if (feedback.relativeError > accuracyTarget.maxRelativeError)
+      {
+        feedback.message = name + " rejected by the error estimate";
+        addFeedback(std::move(feedback));
+        continue;
+      }
+
+      // the cpu backends compute 16-bit precisions in f32, so they are never cheaper than f32
+      if constexpr (ArchParamsT::target == Target::cpu)
+      {
+        if (detail::cxx::to_underlying(precision) < detail::cxx::to_underlying(Precision::f32))
+        {
+          feedback.message = name + " skipped, the cpu backends compute it in f32";
+          addFeedback(std::move(feedback));
+          continue;
+        }
+      }
+
+      std::unique_ptr<Plan> plan{};
+
+      try
+      {
+        plan = makePlan(candidateParams, archParams, backendParams);
+      }
+      catch (const std::exception& e)
+      {
+        feedback.message = name + " not supported: " + e.what();
+        addFeedback(std::move(feedback));
+        continue;
+      }
+
+      feedback.backend = plan->getBackend();
+
+      bool isValidated{};
+
+      if constexpr (canValidate)
+      {
+        if (accuracyTarget.validate && precision != maxPrecision)
+        {
+          // the reference is planned once, a failure leaves the candidates to the estimate
+          if (!hasReferencePlan)
+          {
+            hasReferencePlan = true;
+
+            try
+            {
+              referencePlan = makePlan(transformParams, archParams, backendParams);
+            }
+            catch (const std::exception&)
+            {
+              referencePlan.reset();
+            }
+          }
+
+          if (referencePlan)
+          {
+            if (const auto error = detail::measureRelativeError(desc, *plan, *referencePlan))
+            {
+              feedback.relativeError = *error;
+              isValidated            = true;
+
+              if (*error > accuracyTarget.maxRelativeError)
+              {
+                feedback.message = name + " rejected by the validation";
+                addFeedback(std::move(feedback));
+                continue;
+              }
+            }
+          }
+        }
+      }
+
+      feedback.message = detail::cformatNothrow("%s selected, %s relative error %.3e",
+                                                name.c_str(),
+                                                (isValidated) ? "validated" : "estimated",
+                                                feedback.relativeError);
+      addFeedback(std::move(feedback));
+
+      return plan;
+    }
+
+    throw std::runtime_error("no execution precision meets the accuracy target");
+  }
+
+  /**
+   * @brief Create a plan asynchronously on the planner thread pool. The parameters are validated and copied before
+   *        the function returns, so they do not need to outlive the call. Memory referenced by the backend parameters
+   *        (e.g. the backend order or the tuning database) must stay valid until the future is ready.
+   * @tparam TransformParamsT Transform parameters type
+   * @tparam ArchParamsT Architecture parameters type
+   * @tparam BackendParamsT Backend parameters type
+   * @param transformParams Transform parameters
+   * @param archParams Architecutre parameters
+   * @param backendParams Backend parameters
+   * @return Future of the plan, rethrows the planning error on get()
+   */
+  template<typename TransformParamsT, typename ArchParamsT, typename BackendParamsT = detail::DefaultBackendParameters>
+  std::future<std::unique_ptr<Plan>> makePlanAsync(const TransformParamsT& transformParams,
+                                                   ArchParamsT&            archParams,
+                                                   const BackendParamsT&   backendParams = {})
+  {
+    static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+    static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+    static_assert(isBackendParameters<BackendParamsT> ||
+                  std::is_same_v<BackendParamsT, detail::DefaultBackendParameters>,
+                  "Invalid backend parameters type");
+
+    static_assert(std::is_same_v<BackendParamsT, detail::DefaultBackendParameters> ||
+                  ((ArchParamsT::target == BackendParamsT::target) &&
+                   (ArchParamsT::distribution == BackendParamsT::distribution)),
+                  "Architecture and backend parameters must share the same target and distribution");
+
+    static_assert((TransformParamsT::shapeExtent == dynamicExtent) ||
+                  (ArchParamsT::shapeExtent == dynamicRank) ||
+                  (TransformParamsT::shapeExtent == ArchParamsT::shapeExtent),
+                  "Transform and target parameters must have the same shape rank");
+
+    return detail::getPlannerThreadPool().submit(
+      detail::makeDeferredPlan<ArchParamsT>(detail::Desc{transformParams, archParams}, backendParams));
+  }
+
+  /// @brief Result of a plan request, see makePlans()
+  struct PlanResult
+  {
+    std::shared_ptr<Plan> plan{};      ///< Plan, shared by the requests of the same descriptor, null on failure
+    std::vector<Feedback> feedbacks{}; ///< Feedbacks of the backends tried during the plan creation
+    std::exception_ptr    error{};     ///< Planning error, null on success
+  };
+
+  /**
+   * @class PlanRequest
+   * @brief Request of a plan created by makePlans(). The parameters are validated and copied by the constructor, so
+   *        they do not need to outlive the request. Memory referenced by the backend parameters (e.g. the backend order
+   *        or the tuning database) must stay valid until makePlans() returns.
+   */
+  class PlanRequest
+  {
+    friend std::vector<PlanResult> makePlans(View<PlanRequest> requests);
+
+    public:
+      /**
+       * @brief Constructor.
+       * @tparam TransformParamsT Transform parameters type
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param transformParams Transform parameters
+       * @param archParams Architecutre parameters
+       * @param backendParams Backend parameters
+       */
+      template<typename TransformParamsT, typename ArchParamsT, typename BackendParamsT = detail::DefaultBackendParameters>
+      PlanRequest(const TransformParamsT& transformParams,
+                  ArchParamsT&            archParams,
+                  const BackendParamsT&   backendParams = {})
+      : mDesc{transformParams, archParams},
+        mMakePlanFn{detail::makeDeferredPlan<ArchParamsT>(mDesc, backendParams)}
+      {
+        static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+        static_assert(isBackendParameters<BackendParamsT> ||
+                      std::is_same_v<BackendParamsT, detail::DefaultBackendParameters>,
+                      "Invalid backend parameters type");
+
+        static_assert(std::is_same_v<BackendParamsT, detail::DefaultBackendParameters> ||
+                      ((ArchParamsT::target == BackendParamsT::target) &&
+                       (ArchParamsT::distribution == BackendParamsT::distribution)),
+                      "Architecture and backend parameters must share the same target and distribution");
+
+        static_assert((TransformParamsT::shapeExtent == dynamicExtent) ||
+                      (ArchParamsT::shapeExtent == dynamicRank) ||
+                      (TransformParamsT::shapeExtent == ArchParamsT::shapeExtent),
+                      "Transform and target parameters must have the same shape rank");
+
+        mDesc.fillDefaultMemoryLayoutStrides();
+      }
+
+    private:
+      detail::Desc                                                 mDesc;         ///< Descriptor with the default strides filled, identifies duplicate requests
+      std::function<std::unique_ptr<Plan>(std::vector<Feedback>*)> mMakePlanFn{}; ///< Function creating the plan
+  };
+
+  /**
+   * @brief Create plans concurrently on the planner thread pool, e.g. all plans an application needs at startup. The
+   *        requests of the same descriptor are planned once and share the plan, the backend parameters of the first of
+   *        them are used. The calling thread plans too, so it may be a planner thread. Failures do not stop the other
+   *        plans, they are reported by the results. Runtime compiled code shared by the plans is compiled once, see
+   *        cuda::setRtcCacheDirectory().
+   * @param requests Plan requests.
+   * @return Results in the order of the requests.
+   */
+  [[nodiscard]] inline std::vector<PlanResult> makePlans(View<PlanRequest> requests)
+  {
+    struct State
+    {
+      const PlanRequest*       requests{};      ///< Requests, accessed only while a request is not planned
+      std::vector<PlanResult>  results{};       ///< Results by the request index
+      std::vector<std::size_t> planIndices{};   ///< Indices of the requests to be planned, the first of each descriptor
+      std::atomic<std::size_t> nextIndex{};     ///< Next index into planIndices
+      std::size_t              doneCount{};     ///< Number of planned requests
+      std::mutex               mutex{};         ///< Guards doneCount
+      std::condition_variable  doneCondition{}; ///< Signals a planned request
+    };
+
+    auto state = std::make_shared<State>();
+    state->requests = requests.data();
+    state->results.resize(requests.size());
+
+    std::vector<std::size_t> sourceIndices(requests.size());
+
+    {
+      std::unordered_map<detail::Desc, std::size_t> firstIndices{};
+
+      for (std::size_t i{}; i < requests.size(); ++i)
+      {
+        const auto [it, isFirst] = firstIndices.try_emplace(requests[i].mDesc, i);
+
+        sourceIndices[i] = it->second;
+
+        if (isFirst)
+        {
+          state->planIndices.push_back(i);
+        }
+      }
+    }
+
+    auto planFn = [state]()
+    {
+      const auto planCount = state->planIndices.size();
+
+      for (std::size_t k = state->nextIndex++; k < planCount; k = state->nextIndex++)
+      {
+        const auto i      = state->planIndices[k];
+        auto&      result = state->results[i];
+
+        try
+        {
+          result.plan = state->requests[i].mMakePlanFn(&result.feedbacks);
+        }
+        catch (...)
+        {
+          result.error = std::current_exception();
+        }
+
+        {
+          std::lock_guard lock{state->mutex};
+          ++state->doneCount;
+        }
+
+        state->doneCondition.notify_all();
+      }
+    };
+
+    // the calling thread plans as well, so one worker less is submitted
+    auto&      threadPool  = detail::getPlannerThreadPool();
+    const auto planCount   = state->planIndices.size();
+    const auto workerCount = (planCount > 1) ? std::min(threadPool.getThreadCount(), planCount - 1) : std::size_t{};
+
+    for (std::size_t i{}; i < workerCount; ++i)
+    {
+      (void)threadPool.submit(planFn);
+    }
+
+    planFn();
+
+    {
+      std::unique_lock lock{state->mutex};
+      state->doneCondition.wait(lock, [&]{ return state->doneCount == planCount; });
+    }
+
+    for (std::size_t i{}; i < requests.size(); ++i)
+    {
+      if (sourceIndices[i] != i)
+      {
+        state->results[i] = state->results[sourceIndices[i]];
+      }
+    }
+
+    return std::move(state->results);
+  }
+
+  /**
+   * @brief Restore a plan serialized by Plan::serialize(). The backend native state is restored first (e.g. the FFTW3
+   *        wisdom is imported), then the plan is created by the backend it was serialized with, so a tuned plan is
+   *        recreated without measuring again.
+   * @param data Serialized plan.
+   * @return Plan
+   */
+  [[nodiscard]] inline std::unique_ptr<Plan> deserializePlan(std::string_view data)
+  {
+    const detail::SerialReader reader{data, detail::serializedPlanHeader};
+
+    detail::readBackendState(reader);
+
+    const auto backend = reader.read<Backend>("backend");
+
+    return detail::readDesc(reader, [&](const auto& transformParams, auto& archParams)
+    {
+      using ArchParamsT = std::decay_t<decltype(archParams)>;
+
+      BackendParameters<ArchParamsT::target, ArchParamsT::distribution> backendParams{};
+      backendParams.mask  = BackendMask::empty | backend;
+      backendParams.order = View<Backend>{&backend, 1};
+
+      return makePlan(transformParams, archParams, backendParams);
+    });
+  }
+
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+  inline std::unique_ptr<Plan> Plan::cloneToDevice(int device) const
+  {
+    return cloneToDevice(device, afft::spst::gpu::BackendParameters{});
+  }
+
+  inline std::unique_ptr<Plan>
+  Plan::cloneToDevice(int device, const afft::spst::gpu::BackendParameters& backendParams) const
+  {
+    if (mDesc.getTarget() != Target::gpu || mDesc.getDistribution() != Distribution::spst)
+    {
+      throw std::invalid_argument{"Only spst gpu plans can be cloned to another device"};
+    }
+
+    detail::Desc desc{mDesc};
+
+    auto& gpuDesc = desc.getArchDesc<Target::gpu, Distribution::spst>();
+
+    if (gpuDesc.loadCallback.devicePtr != nullptr || gpuDesc.storeCallback.devicePtr != nullptr)
+    {
+      throw std::invalid_argument{"Plans with device function pointer callbacks cannot be cloned to another device"};
+    }
+
+#   if defined(AFFT_ENABLE_CUDA)
+    if (!detail::cuda::isValidDevice(device))
+    {
+      throw std::invalid_argument{"invalid CUDA device"};
+    }
+#   else
+    if (!detail::hip::isValidDevice(device))
+    {
+      throw std::invalid_argument{"invalid HIP device"};
+    }
+#   endif
+
+    gpuDesc.device = device;
+
+    const auto backend = getBackend();
+
+    afft::spst::gpu::BackendParameters cloneBackendParams{backendParams};
+    cloneBackendParams.mask  = BackendMask::empty | backend;
+    cloneBackendParams.order = View<Backend>{&backend, 1};
+
+    return detail::makePlan(desc, cloneBackendParams);
+  }
+#endif
+
   /**
    * @brief Create a plan with feedback for the given transform, architecture and backend parameters
    * @tparam TransformParamsT Transform parameters type
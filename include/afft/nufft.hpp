@@ -0,0 +1,795 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_NUFFT_HPP
+#define AFFT_NUFFT_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "alloc.hpp"
+#include "makePlan.hpp"
+#include "Plan.hpp"
+#include "typeTraits.hpp"
+#include "utils.hpp"
+
+AFFT_EXPORT namespace afft::nufft
+{
+  /// @brief Type of the non-uniform transform
+  enum class Type : std::uint8_t
+  {
+    type1, ///< non-uniform points to uniform modes, f[k] = sum_j c[j] exp(+-i k x[j])
+    type2, ///< uniform modes to non-uniform points, c[j] = sum_k f[k] exp(+-i k x[j])
+  };
+
+  /// @brief Parameters of the non-uniform transform
+  struct Parameters
+  {
+    Type              type{Type::type1};              ///< type of the transform
+    View<std::size_t> modes{};                        ///< number of modes along each axis in row-major order, 1 to 3 axes
+    Direction         direction{Direction::forward};  ///< forward for the exponent sign -1, backward for +1
+    double            tolerance{1e-6};                ///< requested relative precision
+    double            upsampling{2.0};                ///< upsampling factor of the fine grid, greater than 1
+    unsigned          threadLimit{};                  ///< thread limit of the spreading and the transform, 0 for no limit
+  };
+
+  /**
+   * @class Plan
+   * @brief Non-uniform FFT of type 1 or 2 spreading the points onto an upsampled uniform grid by the exponential of
+   *        semicircle kernel exp(beta (sqrt(1 - z^2) - 1)) and transforming the grid by an afft complex-to-complex
+   *        plan, then dividing by the Fourier series of the kernel. The modes k of an axis of N modes run from -N / 2 to
+   *        (N - 1) / 2 in row-major order, the points are given in [-pi, pi) and folded periodically otherwise.
+   *
+   *        The points are sorted into cache sized bins of the fine grid by setPoints(), the sorted grid coordinates are
+   *        kept and reused by every execution until the points are set again. Type 1 spreads chunks of the sorted
+   *        points in parallel into small subgrids added into the fine grid, type 2 interpolates the sorted points in
+   *        parallel. Only spst cpu uniform plans are supported. The plan is not thread safe.
+   * @tparam T Real type of the transform, float or double.
+   */
+  template<typename T>
+  class Plan
+  {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "nufft::Plan supports only float and double");
+
+    public:
+      /// @brief Maximum kernel width in grid points.
+      static constexpr std::size_t maxKernelWidth{16};
+
+      /// @brief Number of sorted points spread or interpolated by one task of the thread pool.
+      static constexpr std::size_t pointsPerTask{std::size_t{1} << 13};
+
+      /**
+       * @brief Constructor, selects the kernel and creates the uniform plan of the fine grid.
+       * @tparam BackendParamsT Backend parameters type
+       * @param params Non-uniform transform parameters
+       * @param backendParams Backend parameters
+       */
+      template<typename BackendParamsT = detail::DefaultBackendParameters>
+      explicit Plan(const Parameters& params, const BackendParamsT& backendParams = {})
+      : mType{params.type},
+        mRank{params.modes.size()},
+        mThreadLimit{params.threadLimit}
+      {
+        if (mRank == 0 || mRank > 3)
+        {
+          throw std::invalid_argument("non-uniform transform supports 1 to 3 axes");
+        }
+
+        if (std::find(params.modes.begin(), params.modes.end(), std::size_t{}) != params.modes.end())
+        {
+          throw std::invalid_argument("number of modes must be greater than zero");
+        }
+
+        if (!(params.upsampling > 1.0))
+        {
+          throw std::invalid_argument("upsampling factor must be greater than one");
+        }
+
+        if (!(params.tolerance > 0.0))
+        {
+          throw std::invalid_argument("tolerance must be greater than zero");
+        }
+
+        selectKernel(std::max(params.tolerance, 10.0 * static_cast<double>(std::numeric_limits<T>::epsilon())),
+                     params.upsampling);
+
+        // the kernel must fit the grid, 2^a 3^b 5^c even sizes are fast on every backend
+        const detail::FastSizeRule fastSizeRule{{true, true, false, false, false}, 0};
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          mModes[i] = params.modes[i];
+
+          auto size = std::max(static_cast<std::size_t>(std::ceil(params.upsampling * static_cast<double>(mModes[i]))),
+                               2 * mKernelWidth);
+
+          for (size = detail::nextFastSize(size, fastSizeRule); size % 2 != 0;)
+          {
+            size = detail::nextFastSize(size + 1, fastSizeRule);
+          }
+
+          mGridShape[i] = size;
+        }
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          mBinShape[i] = (i + 1 == mRank) ? 32 : ((mRank == 2) ? 8 : 4);
+          mBinCounts[i] = (mGridShape[i] + mBinShape[i] - 1) / mBinShape[i];
+        }
+
+        mGridSize = std::accumulate(mGridShape.begin(), mGridShape.begin() + mRank, std::size_t{1}, std::multiplies<>{});
+        mModeSize = std::accumulate(mModes.begin(), mModes.begin() + mRank, std::size_t{1}, std::multiplies<>{});
+
+        makeCorrections();
+
+        dft::Parameters<> transformParams{};
+        transformParams.direction = params.direction;
+        transformParams.precision = {typePrecision<T>, typePrecision<T>, typePrecision<T>};
+        transformParams.shape     = View<std::size_t>{mGridShape.data(), mRank};
+        transformParams.placement = Placement::inPlace;
+
+        afft::spst::cpu::Parameters<> archParams{};
+        archParams.threadLimit = params.threadLimit;
+
+        if constexpr (std::is_same_v<BackendParamsT, detail::DefaultBackendParameters>)
+        {
+          mPlan = makePlan(transformParams, archParams);
+        }
+        else
+        {
+          mPlan = makePlan(transformParams, archParams, backendParams);
+        }
+
+        mGrid = cpu::makeAlignedUnique<std::complex<T>[]>(cpu::getDefaultAlignment(), mGridSize);
+      }
+
+      /// @brief Copy constructor is deleted.
+      Plan(const Plan&) = delete;
+
+      /// @brief Move constructor.
+      Plan(Plan&&) = default;
+
+      /// @brief Destructor.
+      ~Plan() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      Plan& operator=(const Plan&) = delete;
+
+      /// @brief Move assignment operator.
+      Plan& operator=(Plan&&) = default;
+
+      /**
+       * @brief Get the kernel width.
+       * @return Kernel width in grid points.
+       */
+      [[nodiscard]] constexpr std::size_t getKernelWidth() const noexcept
+      {
+        return mKernelWidth;
+      }
+
+      /**
+       * @brief Get the shape of the upsampled grid.
+       * @return Grid shape.
+       */
+      [[nodiscard]] View<std::size_t> getGridShape() const noexcept
+      {
+        return View<std::size_t>{mGridShape.data(), mRank};
+      }
+
+      /**
+       * @brief Get the number of points.
+       * @return Point count.
+       */
+      [[nodiscard]] constexpr std::size_t getPointCount() const noexcept
+      {
+        return mSortIndices.size();
+      }
+
+      /**
+       * @brief Get the uniform plan of the grid.
+       * @return The complex-to-complex plan.
+       */
+      [[nodiscard]] afft::Plan& getPlan() noexcept
+      {
+        return *mPlan;
+      }
+
+      /**
+       * @brief Set the non-uniform points and sort them into the bins of the grid. The coordinates are copied, the
+       *        sorted points are reused by the executions until the points are set again.
+       * @param pointCount Number of points.
+       * @param coords Coordinates of the points of each axis in row-major order.
+       */
+      void setPoints(std::size_t pointCount, View<const T*> coords)
+      {
+        constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+        if (coords.size() != mRank)
+        {
+          throw std::invalid_argument("coordinates must be given for each axis");
+        }
+
+        if (pointCount != 0 && std::find(coords.begin(), coords.end(), nullptr) != coords.end())
+        {
+          throw std::invalid_argument("a null pointer was passed as coordinates");
+        }
+
+        std::vector<std::size_t> pointBins(pointCount);
+        detail::MaxDimArray<T>           scales{};
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          scales[i] = static_cast<T>(static_cast<long double>(mGridShape[i]) / (2.0L * pi));
+        }
+
+        // fold the points to the grid coordinates [0, n) and find their bins
+        std::array<std::vector<T>, 3> gridCoords{};
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          gridCoords[i].resize(pointCount);
+        }
+
+        detail::parallelFor((pointCount + pointsPerTask - 1) / pointsPerTask, mThreadLimit, [&](std::size_t task)
+        {
+          const std::size_t end = std::min(pointCount, (task + 1) * pointsPerTask);
+
+          for (std::size_t j = task * pointsPerTask; j < end; ++j)
+          {
+            std::size_t bin{};
+
+            for (std::size_t i{}; i < mRank; ++i)
+            {
+              const T n = static_cast<T>(mGridShape[i]);
+
+              T u = coords[i][j] * scales[i];
+              u -= std::floor(u / n) * n;
+              u  = (u >= n || u < T{}) ? T{} : u;
+
+              gridCoords[i][j] = u;
+
+              bin = bin * mBinCounts[i] + std::min(static_cast<std::size_t>(u) / mBinShape[i], mBinCounts[i] - 1);
+            }
+
+            pointBins[j] = bin;
+          }
+        });
+
+        // counting sort by the bins keeps the points of a bin in their order
+        const std::size_t binCount = std::accumulate(mBinCounts.begin(),
+                                                     mBinCounts.begin() + mRank,
+                                                     std::size_t{1},
+                                                     std::multiplies<>{});
+
+        std::vector<std::size_t> binOffsets(binCount + 1);
+
+        for (const auto bin : pointBins)
+        {
+          ++binOffsets[bin + 1];
+        }
+
+        std::partial_sum(binOffsets.begin(), binOffsets.end(), binOffsets.begin());
+
+        mSortIndices.resize(pointCount);
+
+        for (std::size_t j{}; j < pointCount; ++j)
+        {
+          mSortIndices[binOffsets[pointBins[j]]++] = j;
+        }
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          auto& sortedCoords = mSortedCoords[i];
+          sortedCoords.resize(pointCount);
+
+          for (std::size_t j{}; j < pointCount; ++j)
+          {
+            sortedCoords[j] = gridCoords[i][mSortIndices[j]];
+          }
+        }
+      }
+
+      /**
+       * @brief Execute the transform of the points set by setPoints().
+       * @param src Source, the point strengths for type 1, the modes for type 2.
+       * @param dst Destination, the modes for type 1, the point values for type 2.
+       */
+      void execute(const std::complex<T>* src, std::complex<T>* dst)
+      {
+        if ((src == nullptr && (mType == Type::type2 || getPointCount() != 0)) ||
+            (dst == nullptr && (mType == Type::type1 || getPointCount() != 0)))
+        {
+          throw std::invalid_argument("a null pointer was passed as a buffer");
+        }
+
+        std::fill_n(mGrid.get(), mGridSize, std::complex<T>{});
+
+        if (mType == Type::type1)
+        {
+          spread(src);
+          mPlan->execute(mGrid.get());
+          correct(dst, true);
+        }
+        else
+        {
+          correct(const_cast<std::complex<T>*>(src), false);
+          mPlan->execute(mGrid.get());
+          interpolate(dst);
+        }
+      }
+
+    private:
+      /**
+       * @brief Select the kernel width and shape for the tolerance.
+       * @param tolerance Requested relative precision.
+       * @param upsampling Upsampling factor.
+       */
+      void selectKernel(double tolerance, double upsampling)
+      {
+        constexpr double pi = 3.141592653589793238462643383279502884;
+
+        double width{};
+        double betaOverWidth{};
+
+        if (upsampling == 2.0)
+        {
+          width = std::ceil(-std::log10(tolerance / 10.0));
+        }
+        else
+        {
+          width = std::ceil(-std::log(tolerance) / (pi * std::sqrt(1.0 - 1.0 / upsampling)));
+        }
+
+        mKernelWidth = std::clamp(static_cast<std::size_t>(width), std::size_t{2}, maxKernelWidth);
+
+        if (upsampling == 2.0)
+        {
+          switch (mKernelWidth)
+          {
+          case 2:  betaOverWidth = 2.20; break;
+          case 3:  betaOverWidth = 2.26; break;
+          case 4:  betaOverWidth = 2.38; break;
+          default: betaOverWidth = 2.30; break;
+          }
+        }
+        else
+        {
+          betaOverWidth = 0.97 * pi * (1.0 - 1.0 / (2.0 * upsampling));
+        }
+
+        mBeta = betaOverWidth * static_cast<double>(mKernelWidth);
+      }
+
+      /**
+       * @brief Evaluate the kernel at the offsets of the grid points covered by a point.
+       * @param u Grid coordinate of the point.
+       * @param values Kernel values of the covered points.
+       * @return Index of the first covered grid point, may be negative.
+       */
+      [[nodiscard]] std::ptrdiff_t evaluateKernel(T u, T* values) const
+      {
+        const T              halfWidth = static_cast<T>(mKernelWidth) / T{2};
+        const std::ptrdiff_t first     = static_cast<std::ptrdiff_t>(std::ceil(u - halfWidth));
+        const T              scale     = T{2} / static_cast<T>(mKernelWidth);
+        const T              beta      = static_cast<T>(mBeta);
+
+        for (std::size_t p{}; p < mKernelWidth; ++p)
+        {
+          const T z  = (static_cast<T>(first + static_cast<std::ptrdiff_t>(p)) - u) * scale;
+          const T z2 = z * z;
+
+          values[p] = (z2 < T{1}) ? std::exp(beta * (std::sqrt(T{1} - z2) - T{1})) : T{};
+        }
+
+        return first;
+      }
+
+      /**
+       * @brief Make the inverse Fourier series coefficients of the kernel for the modes of each axis. The series is
+       *        integrated by Gauss-Legendre quadrature, the kernel is even so only the cosine part remains.
+       */
+      void makeCorrections()
+      {
+        constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+        const std::size_t nodeCount = 4 * mKernelWidth + 8;
+
+        std::vector<long double> nodes(nodeCount);
+        std::vector<long double> weights(nodeCount);
+
+        // Newton iterations from the Chebyshev initial guess of the Legendre roots
+        for (std::size_t i{}; i < nodeCount; ++i)
+        {
+          long double x = std::cos(pi * (static_cast<long double>(i) + 0.75L) / (static_cast<long double>(nodeCount) + 0.5L));
+          long double derivative{};
+
+          for (unsigned iteration{}; iteration < 100; ++iteration)
+          {
+            long double p0{1.0L};
+            long double p1{x};
+
+            for (std::size_t k{2}; k <= nodeCount; ++k)
+            {
+              const long double p2 = (static_cast<long double>(2 * k - 1) * x * p1 - static_cast<long double>(k - 1) * p0) /
+                                     static_cast<long double>(k);
+              p0 = p1;
+              p1 = p2;
+            }
+
+            derivative = static_cast<long double>(nodeCount) * (x * p1 - p0) / (x * x - 1.0L);
+
+            const long double step = p1 / derivative;
+
+            x -= step;
+
+            if (std::abs(step) < 1e-19L)
+            {
+              break;
+            }
+          }
+
+          nodes[i]   = x;
+          weights[i] = 2.0L / ((1.0L - x * x) * derivative * derivative);
+        }
+
+        const long double halfWidth = static_cast<long double>(mKernelWidth) / 2.0L;
+        const long double beta      = static_cast<long double>(mBeta);
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          auto& corrections = mCorrections[i];
+          corrections.resize(mModes[i]);
+
+          const long double n = static_cast<long double>(mGridShape[i]);
+
+          for (std::size_t m{}; m < mModes[i]; ++m)
+          {
+            const long double k = static_cast<long double>(m) - static_cast<long double>(mModes[i] / 2);
+
+            long double series{};
+
+            for (std::size_t q{}; q < nodeCount; ++q)
+            {
+              const long double t = halfWidth * nodes[q];
+
+              series += weights[q] * std::exp(beta * (std::sqrt(1.0L - nodes[q] * nodes[q]) - 1.0L)) *
+                        std::cos(2.0L * pi * k * t / n);
+            }
+
+            corrections[m] = static_cast<T>(1.0L / (halfWidth * series));
+          }
+        }
+      }
+
+      /**
+       * @brief Get the grid index of a wrapped unwrapped index.
+       * @param index Unwrapped index, may be negative.
+       * @param n Grid extent.
+       * @return Grid index in [0, n).
+       */
+      [[nodiscard]] static constexpr std::size_t wrap(std::ptrdiff_t index, std::size_t n) noexcept
+      {
+        const auto size = static_cast<std::ptrdiff_t>(n);
+
+        return static_cast<std::size_t>(((index % size) + size) % size);
+      }
+
+      /**
+       * @brief Spread the strengths of the sorted points onto the grid. Each task spreads its chunk into a subgrid
+       *        covering the chunk's points and adds the subgrid into the grid.
+       * @param strengths Strengths of the points.
+       */
+      void spread(const std::complex<T>* strengths)
+      {
+        const std::size_t pointCount = getPointCount();
+        const std::size_t width      = mKernelWidth;
+
+        std::mutex gridMutex{};
+
+        detail::parallelFor((pointCount + pointsPerTask - 1) / pointsPerTask, mThreadLimit, [&](std::size_t task)
+        {
+          const std::size_t begin = task * pointsPerTask;
+          const std::size_t end   = std::min(pointCount, begin + pointsPerTask);
+
+          // the subgrid spans the first covered indices of the chunk's points extended by the kernel width
+          detail::MaxDimArray<std::ptrdiff_t> lo{};
+          detail::MaxDimArray<std::size_t>    extents{};
+          detail::MaxDimArray<std::size_t>    strides{};
+
+          for (std::size_t i{}; i < mRank; ++i)
+          {
+            const auto [minIt, maxIt] = std::minmax_element(mSortedCoords[i].begin() + begin, mSortedCoords[i].begin() + end);
+            const T    halfWidth      = static_cast<T>(width) / T{2};
+
+            lo[i]      = static_cast<std::ptrdiff_t>(std::ceil(*minIt - halfWidth));
+            extents[i] = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(std::ceil(*maxIt - halfWidth)) - lo[i]) + width;
+          }
+
+          std::size_t subgridSize{1};
+
+          for (std::size_t i = mRank; i > 0; --i)
+          {
+            strides[i - 1]  = subgridSize;
+            subgridSize    *= extents[i - 1];
+          }
+
+          std::vector<std::complex<T>>           subgrid(subgridSize);
+          std::array<std::array<T, maxKernelWidth>, 3> values{};
+          detail::MaxDimArray<std::size_t>               offsets{};
+
+          for (std::size_t j = begin; j < end; ++j)
+          {
+            for (std::size_t i{}; i < mRank; ++i)
+            {
+              offsets[i] = static_cast<std::size_t>(evaluateKernel(mSortedCoords[i][j], values[i].data()) - lo[i]);
+            }
+
+            const std::complex<T> strength = strengths[mSortIndices[j]];
+
+            forEachCovered(offsets, strides, values, [&](std::size_t offset, T weight)
+            {
+              subgrid[offset] += strength * weight;
+            });
+          }
+
+          std::lock_guard lock{gridMutex};
+
+          addSubgrid(subgrid, lo, extents);
+        });
+      }
+
+      /**
+       * @brief Interpolate the grid at the sorted points.
+       * @param pointValues Values of the points.
+       */
+      void interpolate(std::complex<T>* pointValues) const
+      {
+        const std::size_t pointCount = getPointCount();
+
+        detail::MaxDimArray<std::size_t> gridStrides{};
+        std::size_t              gridStride{1};
+
+        for (std::size_t i = mRank; i > 0; --i)
+        {
+          gridStrides[i - 1]  = gridStride;
+          gridStride         *= mGridShape[i - 1];
+        }
+
+        detail::parallelFor((pointCount + pointsPerTask - 1) / pointsPerTask, mThreadLimit, [&](std::size_t task)
+        {
+          const std::size_t end = std::min(pointCount, (task + 1) * pointsPerTask);
+
+          std::array<std::array<T, maxKernelWidth>, 3>               values{};
+          std::array<std::array<std::size_t, maxKernelWidth>, 3>     indices{};
+
+          for (std::size_t j = task * pointsPerTask; j < end; ++j)
+          {
+            for (std::size_t i{}; i < mRank; ++i)
+            {
+              const auto first = evaluateKernel(mSortedCoords[i][j], values[i].data());
+
+              for (std::size_t p{}; p < mKernelWidth; ++p)
+              {
+                indices[i][p] = wrap(first + static_cast<std::ptrdiff_t>(p), mGridShape[i]) * gridStrides[i];
+              }
+            }
+
+            std::complex<T> sum{};
+
+            forEachCovered(indices, values, [&](std::size_t offset, T weight)
+            {
+              sum += mGrid[offset] * weight;
+            });
+
+            pointValues[mSortIndices[j]] = sum;
+          }
+        });
+      }
+
+      /**
+       * @brief Call a function for each grid point covered by a point of a subgrid.
+       * @tparam FnT Function type, called with the subgrid offset and the kernel weight.
+       * @param offsets Subgrid index of the first covered point of each axis.
+       * @param strides Subgrid strides.
+       * @param values Kernel values of each axis.
+       * @param fn Function.
+       */
+      template<typename FnT>
+      void forEachCovered(const detail::MaxDimArray<std::size_t>&                     offsets,
+                          const detail::MaxDimArray<std::size_t>&                     strides,
+                          const std::array<std::array<T, maxKernelWidth>, 3>& values,
+                          FnT&&                                               fn) const
+      {
+        std::array<std::array<std::size_t, maxKernelWidth>, 3> indices{};
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          for (std::size_t p{}; p < mKernelWidth; ++p)
+          {
+            indices[i][p] = (offsets[i] + p) * strides[i];
+          }
+        }
+
+        forEachCovered(indices, values, std::forward<FnT>(fn));
+      }
+
+      /**
+       * @brief Call a function for each covered point given the offsets of the covered indices of each axis.
+       * @tparam FnT Function type, called with the offset and the kernel weight.
+       * @param indices Offsets of the covered indices of each axis.
+       * @param values Kernel values of each axis.
+       * @param fn Function.
+       */
+      template<typename FnT>
+      void forEachCovered(const std::array<std::array<std::size_t, maxKernelWidth>, 3>& indices,
+                          const std::array<std::array<T, maxKernelWidth>, 3>&           values,
+                          FnT&&                                                         fn) const
+      {
+        const std::size_t width = mKernelWidth;
+
+        switch (mRank)
+        {
+        case 1:
+          for (std::size_t p{}; p < width; ++p)
+          {
+            fn(indices[0][p], values[0][p]);
+          }
+          break;
+        case 2:
+          for (std::size_t p{}; p < width; ++p)
+          {
+            for (std::size_t q{}; q < width; ++q)
+            {
+              fn(indices[0][p] + indices[1][q], values[0][p] * values[1][q]);
+            }
+          }
+          break;
+        case 3:
+          for (std::size_t p{}; p < width; ++p)
+          {
+            for (std::size_t q{}; q < width; ++q)
+            {
+              const T weight = values[0][p] * values[1][q];
+
+              for (std::size_t r{}; r < width; ++r)
+              {
+                fn(indices[0][p] + indices[1][q] + indices[2][r], weight * values[2][r]);
+              }
+            }
+          }
+          break;
+        default:
+          detail::cxx::unreachable();
+        }
+      }
+
+      /**
+       * @brief Add a subgrid into the grid, wrapping the indices periodically.
+       * @param subgrid Subgrid.
+       * @param lo Unwrapped grid index of the subgrid origin.
+       * @param extents Subgrid extents.
+       */
+      void addSubgrid(const std::vector<std::complex<T>>&  subgrid,
+                      const detail::MaxDimArray<std::ptrdiff_t>&    lo,
+                      const detail::MaxDimArray<std::size_t>&       extents)
+      {
+        const std::size_t lastAxis = mRank - 1;
+        const std::size_t rowCount = subgrid.size() / extents[lastAxis];
+
+        std::size_t srcOffset{};
+
+        for (std::size_t row{}; row < rowCount; ++row)
+        {
+          std::size_t index = row;
+          std::size_t dstRow{};
+          std::size_t stride = mGridShape[lastAxis];
+
+          for (std::size_t i = lastAxis; i > 0; --i)
+          {
+            const std::size_t axis = i - 1;
+
+            dstRow += wrap(lo[axis] + static_cast<std::ptrdiff_t>(index % extents[axis]), mGridShape[axis]) * stride;
+            index  /= extents[axis];
+            stride *= mGridShape[axis];
+          }
+
+          for (std::size_t p{}; p < extents[lastAxis]; ++p)
+          {
+            mGrid[dstRow + wrap(lo[lastAxis] + static_cast<std::ptrdiff_t>(p), mGridShape[lastAxis])] += subgrid[srcOffset++];
+          }
+        }
+      }
+
+      /**
+       * @brief Multiply the modes by the inverse kernel series, between the modes and the grid.
+       * @param modes Modes, the destination for type 1, the source for type 2.
+       * @param isToModes Copy from the grid to the modes for type 1, from the modes to the grid for type 2.
+       */
+      void correct(std::complex<T>* modes, bool isToModes)
+      {
+        const std::size_t lastAxis  = mRank - 1;
+        const std::size_t rowLength = mModes[lastAxis];
+        const std::size_t rowCount  = mModeSize / rowLength;
+
+        detail::parallelFor(rowCount, mThreadLimit, [&](std::size_t row)
+        {
+          std::size_t index = row;
+          std::size_t gridRow{};
+          std::size_t stride = mGridShape[lastAxis];
+          T           factor{1};
+
+          for (std::size_t i = lastAxis; i > 0; --i)
+          {
+            const std::size_t axis = i - 1;
+            const std::size_t m    = index % mModes[axis];
+            const auto        k    = static_cast<std::ptrdiff_t>(m) - static_cast<std::ptrdiff_t>(mModes[axis] / 2);
+
+            gridRow += wrap(k, mGridShape[axis]) * stride;
+            factor  *= mCorrections[axis][m];
+            index   /= mModes[axis];
+            stride  *= mGridShape[axis];
+          }
+
+          std::complex<T>* modeRow = modes + row * rowLength;
+
+          for (std::size_t m{}; m < rowLength; ++m)
+          {
+            const auto        k    = static_cast<std::ptrdiff_t>(m) - static_cast<std::ptrdiff_t>(rowLength / 2);
+            const std::size_t cell = gridRow + wrap(k, mGridShape[lastAxis]);
+            const T           c    = factor * mCorrections[lastAxis][m];
+
+            if (isToModes)
+            {
+              modeRow[m] = mGrid[cell] * c;
+            }
+            else
+            {
+              mGrid[cell] = modeRow[m] * c;
+            }
+          }
+        });
+      }
+
+      Type                                         mType{};          ///< Type of the transform.
+      std::size_t                                  mRank{};          ///< Number of axes.
+      unsigned                                     mThreadLimit{};   ///< Thread limit.
+      std::size_t                                  mKernelWidth{};   ///< Kernel width in grid points.
+      double                                       mBeta{};          ///< Kernel shape parameter.
+      detail::MaxDimArray<std::size_t>                     mModes{};         ///< Number of modes of each axis.
+      detail::MaxDimArray<std::size_t>                     mGridShape{};     ///< Shape of the upsampled grid.
+      detail::MaxDimArray<std::size_t>                     mBinShape{};      ///< Shape of a sorting bin in grid points.
+      detail::MaxDimArray<std::size_t>                     mBinCounts{};     ///< Number of bins of each axis.
+      std::size_t                                  mGridSize{};      ///< Number of grid points.
+      std::size_t                                  mModeSize{};      ///< Number of modes.
+      std::array<std::vector<T>, 3>                mCorrections{};   ///< Inverse kernel series of the modes of each axis.
+      std::array<std::vector<T>, 3>                mSortedCoords{};  ///< Grid coordinates of the sorted points.
+      std::vector<std::size_t>                     mSortIndices{};   ///< Original indices of the sorted points.
+      std::unique_ptr<afft::Plan>                  mPlan{};          ///< Uniform plan of the grid.
+      cpu::AlignedUniquePtr<std::complex<T>[]>     mGrid{};          ///< Upsampled grid.
+  };
+} // namespace afft::nufft
+
+#endif /* AFFT_NUFFT_HPP */
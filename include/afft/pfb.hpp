@@ -0,0 +1,438 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_PFB_HPP
+#define AFFT_PFB_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "alloc.hpp"
+#include "makePlan.hpp"
+#include "Plan.hpp"
+#include "PreprocessingExecutor.hpp"
+#include "typeTraits.hpp"
+
+AFFT_EXPORT namespace afft::pfb
+{
+  /// @brief Parameters of the polyphase filter bank channelizer
+  struct Parameters
+  {
+    std::size_t    channelCount{};                  ///< number of channels, the transform size
+    std::size_t    tapsPerChannel{8};               ///< taps of the prototype filter per channel
+    std::size_t    decimation{};                    ///< samples between the output frames, 0 for the channel count
+    WindowFunction window{WindowFunction::kaiser};  ///< window of the designed prototype filter, ignored if the filter is set
+    double         kaiserBeta{defaultKaiserBeta};   ///< shape parameter of the Kaiser window
+    View<double>   filter{};                        ///< prototype lowpass of channelCount * tapsPerChannel taps, empty to design one
+    std::size_t    maxFrameCount{};                 ///< frames transformed by one plan execution, 0 selects it from the channel count
+    unsigned       threadLimit{};                   ///< thread limit of the folding and the transforms, 0 for no limit
+  };
+
+  /**
+   * @brief Make the prototype lowpass filter of a channelizer, a windowed sinc with the cutoff at half the channel
+   *        spacing. The taps are normalized to unit gain at zero frequency.
+   * @param channelCount Number of channels.
+   * @param tapsPerChannel Taps per channel.
+   * @param window Window function.
+   * @param kaiserBeta Shape parameter of the Kaiser window, ignored by the other windows.
+   * @return The channelCount * tapsPerChannel taps.
+   */
+  [[nodiscard]] inline std::vector<double> makePrototypeFilter(std::size_t    channelCount,
+                                                               std::size_t    tapsPerChannel,
+                                                               WindowFunction window     = WindowFunction::kaiser,
+                                                               double         kaiserBeta = defaultKaiserBeta)
+  {
+    constexpr double pi = 3.141592653589793238462643383279502884;
+
+    if (channelCount == 0 || tapsPerChannel == 0)
+    {
+      throw std::invalid_argument("channel count and taps per channel must be greater than zero");
+    }
+
+    const std::size_t length = channelCount * tapsPerChannel;
+
+    // the periodic window is symmetric around length / 2, so is the sinc
+    auto filter = makeWindow(window, length, kaiserBeta);
+
+    double sum{};
+
+    for (std::size_t i{}; i < length; ++i)
+    {
+      const double x = (static_cast<double>(i) - static_cast<double>(length / 2)) / static_cast<double>(channelCount);
+
+      filter[i] *= (x == 0.0) ? 1.0 : std::sin(pi * x) / (pi * x);
+      sum       += filter[i];
+    }
+
+    for (auto& tap : filter)
+    {
+      tap /= sum;
+    }
+
+    return filter;
+  }
+
+  /**
+   * @class Channelizer
+   * @brief Polyphase filter bank channelizer of an unbounded complex signal. The prototype lowpass of channelCount *
+   *        tapsPerChannel taps is split into channelCount polyphase branches, each output frame folds the last
+   *        channelCount * tapsPerChannel samples through the branches into channelCount values and transforms them
+   *        by a forward DFT. A new frame starts every decimation samples, so channelCount / decimation is the
+   *        oversampling factor, 1 for a critically sampled filter bank. The folded values are rotated by the frame
+   *        position, the channels are therefore basebanded: a tone at the center of a channel is constant in it.
+   *
+   *        The signal is pushed in chunks of any size, as with stft::Plan. The frames are folded in parallel straight
+   *        into a cache sized block, which one batched 1D complex-to-complex plan of maxFrameCount frames transforms
+   *        right after, so the folded block never leaves the cache. Only spst cpu plans are supported. The
+   *        channelizer is not thread safe.
+   * @tparam T Real type of the transform, float or double.
+   */
+  template<typename T>
+  class Channelizer
+  {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "pfb::Channelizer supports only float and double");
+
+    public:
+      /// @brief Size of the block folded for one plan execution when the frame count is selected.
+      static constexpr std::size_t defaultBatchSize{std::size_t{1} << 18};
+
+      /**
+       * @brief Constructor, designs or copies the prototype filter and creates the transform plan.
+       * @tparam BackendParamsT Backend parameters type
+       * @param params Channelizer parameters
+       * @param backendParams Backend parameters
+       */
+      template<typename BackendParamsT = detail::DefaultBackendParameters>
+      explicit Channelizer(const Parameters& params, const BackendParamsT& backendParams = {})
+      : mChannelCount{params.channelCount},
+        mTapsPerChannel{params.tapsPerChannel},
+        mDecimation{(params.decimation != 0) ? params.decimation : params.channelCount},
+        mThreadLimit{params.threadLimit}
+      {
+        if (mChannelCount == 0 || mTapsPerChannel == 0)
+        {
+          throw std::invalid_argument("channel count and taps per channel must be greater than zero");
+        }
+
+        if (mDecimation > mChannelCount)
+        {
+          throw std::invalid_argument("decimation must not be greater than the channel count");
+        }
+
+        const std::size_t length = mChannelCount * mTapsPerChannel;
+
+        if (!params.filter.empty() && params.filter.size() != length)
+        {
+          throw std::invalid_argument("filter must have channel count * taps per channel taps");
+        }
+
+        const auto filter = (params.filter.empty()) ? makePrototypeFilter(mChannelCount,
+                                                                          mTapsPerChannel,
+                                                                          params.window,
+                                                                          params.kaiserBeta)
+                                                    : std::vector<double>(params.filter.begin(), params.filter.end());
+
+        // the taps are reversed to read the samples forwards and duplicated to multiply both components of a sample
+        mTaps.resize(2 * length);
+
+        for (std::size_t i{}; i < length; ++i)
+        {
+          mTaps[2 * i]     = static_cast<T>(filter[length - 1 - i]);
+          mTaps[2 * i + 1] = static_cast<T>(filter[length - 1 - i]);
+        }
+
+        mMaxFrameCount = params.maxFrameCount;
+
+        if (mMaxFrameCount == 0)
+        {
+          mMaxFrameCount = 1;
+
+          while (mMaxFrameCount * 2 * mChannelCount * sizeof(std::complex<T>) <= defaultBatchSize)
+          {
+            mMaxFrameCount *= 2;
+          }
+        }
+
+        const std::array<std::size_t, 2> shape{mMaxFrameCount, mChannelCount};
+        const std::array<std::size_t, 1> axes{1};
+
+        dft::Parameters<> transformParams{};
+        transformParams.direction = Direction::forward;
+        transformParams.precision = {typePrecision<T>, typePrecision<T>, typePrecision<T>};
+        transformParams.shape     = shape;
+        transformParams.axes      = axes;
+        transformParams.type      = dft::Type::complexToComplex;
+
+        afft::spst::cpu::Parameters<> archParams{};
+        archParams.threadLimit = params.threadLimit;
+
+        if constexpr (std::is_same_v<BackendParamsT, detail::DefaultBackendParameters>)
+        {
+          mPlan = makePlan(transformParams, archParams);
+        }
+        else
+        {
+          mPlan = makePlan(transformParams, archParams, backendParams);
+        }
+
+        mBlock = cpu::makeAlignedUnique<std::complex<T>[]>(mMaxFrameCount * mChannelCount);
+
+        mPending.reserve(length + mDecimation);
+        mStage.reserve(2 * length + mDecimation);
+      }
+
+      /// @brief Copy constructor is deleted.
+      Channelizer(const Channelizer&) = delete;
+
+      /// @brief Move constructor.
+      Channelizer(Channelizer&&) = default;
+
+      /// @brief Destructor.
+      ~Channelizer() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      Channelizer& operator=(const Channelizer&) = delete;
+
+      /// @brief Move assignment operator.
+      Channelizer& operator=(Channelizer&&) = default;
+
+      /**
+       * @brief Get the channel count.
+       * @return Number of channels, the values of a frame.
+       */
+      [[nodiscard]] constexpr std::size_t getChannelCount() const noexcept
+      {
+        return mChannelCount;
+      }
+
+      /**
+       * @brief Get the taps per channel.
+       * @return Taps of the prototype filter per channel.
+       */
+      [[nodiscard]] constexpr std::size_t getTapsPerChannel() const noexcept
+      {
+        return mTapsPerChannel;
+      }
+
+      /**
+       * @brief Get the decimation.
+       * @return Samples between the output frames.
+       */
+      [[nodiscard]] constexpr std::size_t getDecimation() const noexcept
+      {
+        return mDecimation;
+      }
+
+      /**
+       * @brief Get the number of frames transformed by one plan execution.
+       * @return Maximum frame count.
+       */
+      [[nodiscard]] constexpr std::size_t getMaxFrameCount() const noexcept
+      {
+        return mMaxFrameCount;
+      }
+
+      /**
+       * @brief Get the number of frames a push of a chunk produces.
+       * @param sampleCount Number of samples of the chunk.
+       * @return Frame count.
+       */
+      [[nodiscard]] constexpr std::size_t getFrameCount(std::size_t sampleCount) const noexcept
+      {
+        const std::size_t length = mChannelCount * mTapsPerChannel;
+        const std::size_t total  = mPending.size() + sampleCount;
+
+        return (total >= length) ? (total - length) / mDecimation + 1 : 0;
+      }
+
+      /**
+       * @brief Get the underlying transform plan.
+       * @return The batched complex-to-complex plan.
+       */
+      [[nodiscard]] afft::Plan& getPlan() noexcept
+      {
+        return *mPlan;
+      }
+
+      /**
+       * @brief Push a chunk of the signal and channelize the frames it completes. The frames are stored from the start
+       *        of the destination, the channels of a frame are contiguous.
+       * @param samples Samples of the chunk.
+       * @param sampleCount Number of samples of the chunk.
+       * @param dst Destination of getFrameCount(sampleCount) * getChannelCount() values.
+       * @return Number of frames produced.
+       */
+      std::size_t push(const std::complex<T>* samples, std::size_t sampleCount, std::complex<T>* dst)
+      {
+        if (sampleCount != 0 && samples == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as samples");
+        }
+
+        const std::size_t frameCount = getFrameCount(sampleCount);
+
+        if (frameCount != 0 && dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as destination");
+        }
+
+        const std::size_t length       = mChannelCount * mTapsPerChannel;
+        const std::size_t pendingCount = mPending.size();
+
+        // frames starting in the pending samples span both chunks, they are staged contiguously
+        const std::size_t stagedCount = std::min(frameCount, (pendingCount + mDecimation - 1) / mDecimation);
+
+        if (stagedCount != 0)
+        {
+          const std::size_t stageSize = (stagedCount - 1) * mDecimation + length;
+
+          mStage.assign(mPending.begin(), mPending.end());
+          mStage.insert(mStage.end(), samples, samples + (stageSize - pendingCount));
+
+          channelizeFrames(mStage.data(), stagedCount, dst);
+        }
+
+        if (frameCount > stagedCount)
+        {
+          channelizeFrames(samples + (stagedCount * mDecimation - pendingCount),
+                           frameCount - stagedCount,
+                           dst + stagedCount * mChannelCount);
+        }
+
+        // keep the samples from the start of the next frame, the decimation never exceeds the filter length
+        const std::size_t next = frameCount * mDecimation;
+
+        if (next < pendingCount)
+        {
+          mPending.erase(mPending.begin(), mPending.begin() + next);
+          mPending.insert(mPending.end(), samples, samples + sampleCount);
+        }
+        else
+        {
+          mPending.assign(samples + (next - pendingCount), samples + sampleCount);
+        }
+
+        return frameCount;
+      }
+
+      /// @brief Drop the pending samples of the unfinished frames, the next push starts a new signal.
+      void reset() noexcept
+      {
+        mPending.clear();
+        mPhase = 0;
+      }
+
+    private:
+      /**
+       * @brief Fold and transform frames decimated from contiguous samples in blocks of at most the maximum frame count.
+       * @param samples Samples of the first frame.
+       * @param frameCount Number of frames.
+       * @param dst Destination of the first frame.
+       */
+      void channelizeFrames(const std::complex<T>* samples, std::size_t frameCount, std::complex<T>* dst)
+      {
+        for (std::size_t done{}; done < frameCount; done += mMaxFrameCount)
+        {
+          const std::size_t count = std::min(mMaxFrameCount, frameCount - done);
+          const std::size_t phase = mPhase;
+
+          detail::parallelFor(count, mThreadLimit, [&](std::size_t i)
+          {
+            const std::size_t frame = done + i;
+
+            foldFrame(samples + frame * mDecimation,
+                      mBlock.get() + i * mChannelCount,
+                      (phase + i * mDecimation) % mChannelCount);
+          });
+
+          mPhase = (phase + count * mDecimation) % mChannelCount;
+
+          afft::spst::cpu::ExecutionParameters execParams{};
+          execParams.batchCount = count;
+
+          mPlan->execute(mBlock.get(), dst + done * mChannelCount, execParams);
+        }
+      }
+
+      /**
+       * @brief Fold a frame through the polyphase branches. The value of branch m is stored at (m + shift) mod
+       *        channelCount, which moves the time origin of the transform to the frame start.
+       * @param frame Samples of the frame.
+       * @param out Folded values.
+       * @param shift Position of the frame start modulo the channel count.
+       */
+      void foldFrame(const std::complex<T>* frame, std::complex<T>* out, std::size_t shift) const
+      {
+        // both components are multiplied by the duplicated taps, the loops are plain real multiply-adds
+        const std::size_t width = 2 * mChannelCount;
+        const std::size_t head  = 2 * (mChannelCount - shift);
+
+        const T* x       = reinterpret_cast<const T*>(frame);
+        T*       o       = reinterpret_cast<T*>(out);
+        T*       rotated = o + 2 * shift;
+
+        for (std::size_t j{}; j < head; ++j)
+        {
+          rotated[j] = mTaps[j] * x[j];
+        }
+
+        for (std::size_t j{head}; j < width; ++j)
+        {
+          o[j - head] = mTaps[j] * x[j];
+        }
+
+        for (std::size_t p{1}; p < mTapsPerChannel; ++p)
+        {
+          const T* taps    = mTaps.data() + p * width;
+          const T* samples = x + p * width;
+
+          for (std::size_t j{}; j < head; ++j)
+          {
+            rotated[j] += taps[j] * samples[j];
+          }
+
+          for (std::size_t j{head}; j < width; ++j)
+          {
+            o[j - head] += taps[j] * samples[j];
+          }
+        }
+      }
+
+      std::size_t                              mChannelCount{};   ///< Number of channels.
+      std::size_t                              mTapsPerChannel{}; ///< Taps of the prototype filter per channel.
+      std::size_t                              mDecimation{};     ///< Samples between the output frames.
+      unsigned                                 mThreadLimit{};    ///< Thread limit of the folding.
+      std::size_t                              mMaxFrameCount{};  ///< Frames transformed by one plan execution.
+      std::vector<T>                           mTaps{};           ///< Reversed prototype taps, each duplicated for both components.
+      std::unique_ptr<afft::Plan>              mPlan{};           ///< Batched complex-to-complex plan.
+      cpu::AlignedUniquePtr<std::complex<T>[]> mBlock{};          ///< Folded frames of one plan execution.
+      std::vector<std::complex<T>>             mPending{};        ///< Samples of the unfinished frames.
+      std::vector<std::complex<T>>             mStage{};          ///< Frames spanning the previous chunk.
+      std::size_t                              mPhase{};          ///< Position of the next frame start modulo the channel count.
+  };
+} // namespace afft::pfb
+
+#endif /* AFFT_PFB_HPP */
@@ -0,0 +1,743 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_REDISTRIBUTE_HPP
+#define AFFT_REDISTRIBUTE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "architecture.hpp"
+#include "utils.hpp"
+#include "detail/halfPrecision.hpp"
+#include "detail/transpose.hpp"
+#include "detail/type.hpp"
+#ifdef AFFT_ENABLE_MPI
+# include "detail/mpi/mpi.hpp"
+#endif
+
+AFFT_EXPORT namespace afft
+{
+#ifdef AFFT_ENABLE_MPI
+  /**
+   * @class Redistributor
+   * @brief Moves a distributed cpu array from one block decomposition to another, e.g. from the blocks of a simulation
+   *        to the pencils of an mpst plan and back. Each process owns one source and one destination block of the
+   *        global shape. The overlaps of the blocks are computed once, an execution packs the parts sent to the other
+   *        processes by the strided copy kernel, exchanges them by a single MPI_Alltoallv and unpacks the received
+   *        parts into the destination block. The part staying on the process is copied directly. The exchanged
+   *        values may be rounded to a narrower precision, e.g. f16 or bf16 for intermediate stages tolerating the
+   *        rounding, which reduces the exchanged volume while the blocks keep their precision. The packing buffers
+   *        are held by the object, so executions must not overlap. All processes of the communicator must construct
+   *        and execute the redistributor collectively.
+   */
+  class Redistributor
+  {
+    public:
+      /// @brief Default constructor is deleted.
+      Redistributor() = delete;
+
+      /**
+       * @brief Constructor, exchanges the blocks of all processes.
+       * @tparam shapeExt Extent of the shape.
+       * @param shape Global shape.
+       * @param srcBlock Source block of the process, empty strides for the row-major strides of its sizes.
+       * @param dstBlock Destination block of the process, empty strides for the row-major strides of its sizes.
+       * @param elemSize Size of the element in bytes, 2, 4, 8, 16 or 32.
+       * @param comm MPI communicator.
+       * @param threadLimit Maximum number of threads of the copies, 0 for no limit.
+       */
+      template<std::size_t shapeExt>
+      Redistributor(View<std::size_t, shapeExt>  shape,
+                    const MemoryBlock<shapeExt>& srcBlock,
+                    const MemoryBlock<shapeExt>& dstBlock,
+                    std::size_t                  elemSize,
+                    MPI_Comm                     comm,
+                    unsigned                     threadLimit = 1)
+      : Redistributor{shape, srcBlock, dstBlock, elemSize, elemSize, comm, threadLimit}
+      {}
+
+      /**
+       * @brief Constructor exchanging the values in a reduced precision, exchanges the blocks of all processes. The
+       *        values are rounded to nearest even when packed and widened back when unpacked, the part staying on the
+       *        process is copied exactly.
+       * @tparam shapeExt Extent of the shape.
+       * @param shape Global shape.
+       * @param srcBlock Source block of the process, empty strides for the row-major strides of its sizes.
+       * @param dstBlock Destination block of the process, empty strides for the row-major strides of its sizes.
+       * @param precision Precision of the values of the blocks, bf16, f16, f32 or f64.
+       * @param complexity Complexity of the elements of the blocks.
+       * @param exchangePrecision Precision of the exchanged values, the precision of the blocks or a narrower one of
+       *                          f32, f16 and bf16.
+       * @param comm MPI communicator.
+       * @param threadLimit Maximum number of threads of the copies and the conversions, 0 for no limit.
+       */
+      template<std::size_t shapeExt>
+      Redistributor(View<std::size_t, shapeExt>  shape,
+                    const MemoryBlock<shapeExt>& srcBlock,
+                    const MemoryBlock<shapeExt>& dstBlock,
+                    Precision                    precision,
+                    Complexity                   complexity,
+                    Precision                    exchangePrecision,
+                    MPI_Comm                     comm,
+                    unsigned                     threadLimit = 1)
+      : Redistributor{shape,
+                      srcBlock,
+                      dstBlock,
+                      getElemSize(precision, complexity),
+                      getExchangeElemSize(precision, complexity, exchangePrecision),
+                      comm,
+                      threadLimit}
+      {
+        mPrecision         = precision;
+        mExchangePrecision = exchangePrecision;
+      }
+
+      /// @brief Copy constructor is deleted.
+      Redistributor(const Redistributor&) = delete;
+
+      /// @brief Move constructor.
+      Redistributor(Redistributor&&) = default;
+
+      /// @brief Destructor.
+      ~Redistributor() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      Redistributor& operator=(const Redistributor&) = delete;
+
+      /// @brief Move assignment operator.
+      Redistributor& operator=(Redistributor&&) = default;
+
+      /**
+       * @brief Redistribute the data, collective over the communicator.
+       * @param src Source block buffer of the process.
+       * @param dst Destination block buffer of the process, must not overlap the source.
+       */
+      void execute(const void* src, void* dst)
+      {
+        const auto* srcBytes = static_cast<const std::byte*>(src);
+        auto*       dstBytes = static_cast<std::byte*>(dst);
+
+        for (std::size_t p{}; p < mSendParts.size(); ++p)
+        {
+          const auto& box = mSendParts[p].box;
+
+          if (p == mCommRank || getBoxSize(box) == 0)
+          {
+            continue;
+          }
+
+          const auto packedStrides = makeRowMajorStrides(box);
+
+          copyBox(box,
+                  srcBytes + getOffset(mSrcBlock, box),
+                  View<std::size_t>{mSrcBlock.strides.data(), mRank},
+                  mSendBuffer.data() + mSendParts[p].offset,
+                  View<std::size_t>{packedStrides.data(), mRank});
+        }
+
+        if (const auto& box = mSendParts[mCommRank].box; getBoxSize(box) > 0)
+        {
+          copyBox(box,
+                  srcBytes + getOffset(mSrcBlock, box),
+                  View<std::size_t>{mSrcBlock.strides.data(), mRank},
+                  dstBytes + getOffset(mDstBlock, box),
+                  View<std::size_t>{mDstBlock.strides.data(), mRank});
+        }
+
+        const bool isConverted = (mExchangeElemSize != mElemSize);
+
+        if (isConverted)
+        {
+          narrowValues(mSendBuffer.data(), mSendExchangeBuffer.data(), mSendBuffer.size() / detail::sizeOf(mPrecision));
+        }
+
+        detail::mpi::checkError(MPI_Alltoallv((isConverted) ? mSendExchangeBuffer.data() : mSendBuffer.data(),
+                                              mSendCounts.data(),
+                                              mSendDispls.data(),
+                                              MPI_BYTE,
+                                              (isConverted) ? mRecvExchangeBuffer.data() : mRecvBuffer.data(),
+                                              mRecvCounts.data(),
+                                              mRecvDispls.data(),
+                                              MPI_BYTE,
+                                              mComm));
+
+        if (isConverted)
+        {
+          widenValues(mRecvExchangeBuffer.data(), mRecvBuffer.data(), mRecvBuffer.size() / detail::sizeOf(mPrecision));
+        }
+
+        for (std::size_t p{}; p < mRecvParts.size(); ++p)
+        {
+          const auto& box = mRecvParts[p].box;
+
+          if (p == mCommRank || getBoxSize(box) == 0)
+          {
+            continue;
+          }
+
+          const auto packedStrides = makeRowMajorStrides(box);
+
+          copyBox(box,
+                  mRecvBuffer.data() + mRecvParts[p].offset,
+                  View<std::size_t>{packedStrides.data(), mRank},
+                  dstBytes + getOffset(mDstBlock, box),
+                  View<std::size_t>{mDstBlock.strides.data(), mRank});
+        }
+      }
+
+    private:
+      /// @brief Number of values converted by one task.
+      static constexpr std::size_t conversionChunkSize{detail::halfPrecision::chunkSize};
+
+      /// @brief Number of double precision values converted through a single precision stack buffer at once.
+      static constexpr std::size_t conversionBlockSize{256};
+
+      /**
+       * @brief Core constructor, exchanges the blocks of all processes.
+       * @tparam shapeExt Extent of the shape.
+       * @param shape Global shape.
+       * @param srcBlock Source block of the process.
+       * @param dstBlock Destination block of the process.
+       * @param elemSize Size of the element in bytes.
+       * @param exchangeElemSize Size of the exchanged element in bytes, elemSize if the values are not converted.
+       * @param comm MPI communicator.
+       * @param threadLimit Maximum number of threads of the copies and the conversions.
+       */
+      template<std::size_t shapeExt>
+      Redistributor(View<std::size_t, shapeExt>  shape,
+                    const MemoryBlock<shapeExt>& srcBlock,
+                    const MemoryBlock<shapeExt>& dstBlock,
+                    std::size_t                  elemSize,
+                    std::size_t                  exchangeElemSize,
+                    MPI_Comm                     comm,
+                    unsigned                     threadLimit)
+      : mRank{shape.size()},
+        mElemSize{elemSize},
+        mExchangeElemSize{exchangeElemSize},
+        mComm{comm},
+        mThreadLimit{threadLimit}
+      {
+        if (mRank == 0 || mRank > maxDimCount)
+        {
+          throw std::invalid_argument{"redistribution rank must be between 1 and maxDimCount"};
+        }
+
+        if (!detail::transpose::isSupportedElemSize(mElemSize))
+        {
+          throw std::invalid_argument{"redistribution supports only element sizes of 2, 4, 8, 16 and 32 bytes"};
+        }
+
+        if (!detail::mpi::isValidComm(mComm))
+        {
+          throw std::invalid_argument{"invalid MPI communicator"};
+        }
+
+        mSrcBlock = makeBlock(shape, srcBlock);
+        mDstBlock = makeBlock(shape, dstBlock);
+
+        int commSize{};
+        int commRank{};
+
+        detail::mpi::checkError(MPI_Comm_size(mComm, &commSize));
+        detail::mpi::checkError(MPI_Comm_rank(mComm, &commRank));
+
+        mCommRank = static_cast<std::size_t>(commRank);
+
+        // starts and sizes of the source and destination blocks of all processes
+        const std::size_t entryCount = 4 * mRank;
+
+        std::vector<std::uint64_t> localBlocks(entryCount);
+        std::vector<std::uint64_t> blocks(entryCount * static_cast<std::size_t>(commSize));
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          localBlocks[i]             = mSrcBlock.starts[i];
+          localBlocks[mRank + i]     = mSrcBlock.sizes[i];
+          localBlocks[2 * mRank + i] = mDstBlock.starts[i];
+          localBlocks[3 * mRank + i] = mDstBlock.sizes[i];
+        }
+
+        detail::mpi::checkError(MPI_Allgather(localBlocks.data(),
+                                              static_cast<int>(entryCount * sizeof(std::uint64_t)),
+                                              MPI_BYTE,
+                                              blocks.data(),
+                                              static_cast<int>(entryCount * sizeof(std::uint64_t)),
+                                              MPI_BYTE,
+                                              mComm));
+
+        mSendParts.resize(static_cast<std::size_t>(commSize));
+        mRecvParts.resize(static_cast<std::size_t>(commSize));
+
+        std::size_t sendSize{};
+        std::size_t recvSize{};
+
+        for (std::size_t p{}; p < mSendParts.size(); ++p)
+        {
+          const std::uint64_t* peer = blocks.data() + p * entryCount;
+
+          Box peerSrc{};
+          Box peerDst{};
+
+          for (std::size_t i{}; i < mRank; ++i)
+          {
+            peerSrc.starts[i] = static_cast<std::size_t>(peer[i]);
+            peerSrc.sizes[i]  = static_cast<std::size_t>(peer[mRank + i]);
+            peerDst.starts[i] = static_cast<std::size_t>(peer[2 * mRank + i]);
+            peerDst.sizes[i]  = static_cast<std::size_t>(peer[3 * mRank + i]);
+          }
+
+          mSendParts[p].box = intersect(mSrcBlock, peerDst);
+          mRecvParts[p].box = intersect(peerSrc, mDstBlock);
+
+          if (p != mCommRank)
+          {
+            mSendParts[p].offset = sendSize;
+            mRecvParts[p].offset = recvSize;
+
+            sendSize += getBoxSize(mSendParts[p].box);
+            recvSize += getBoxSize(mRecvParts[p].box);
+          }
+        }
+
+        if (toExchangeSize(sendSize) > static_cast<std::size_t>(std::numeric_limits<int>::max()) ||
+            toExchangeSize(recvSize) > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        {
+          throw std::invalid_argument{"redistributed parts exceed the MPI count range"};
+        }
+
+        mSendBuffer.resize(sendSize);
+        mRecvBuffer.resize(recvSize);
+
+        if (mExchangeElemSize != mElemSize)
+        {
+          mSendExchangeBuffer.resize(toExchangeSize(sendSize));
+          mRecvExchangeBuffer.resize(toExchangeSize(recvSize));
+        }
+
+        auto fillCounts = [&](const std::vector<Part>& parts, std::vector<int>& counts, std::vector<int>& displs)
+        {
+          counts.resize(parts.size());
+          displs.resize(parts.size());
+
+          for (std::size_t p{}; p < parts.size(); ++p)
+          {
+            counts[p] = (p != mCommRank) ? static_cast<int>(toExchangeSize(getBoxSize(parts[p].box))) : 0;
+            displs[p] = static_cast<int>(toExchangeSize(parts[p].offset));
+          }
+        };
+
+        fillCounts(mSendParts, mSendCounts, mSendDispls);
+        fillCounts(mRecvParts, mRecvCounts, mRecvDispls);
+      }
+
+      /// @brief Block of the global shape.
+      struct Box
+      {
+        detail::MaxDimArray<std::size_t> starts{};  ///< Starts of the block.
+        detail::MaxDimArray<std::size_t> sizes{};   ///< Sizes of the block.
+        detail::MaxDimArray<std::size_t> strides{}; ///< Strides of the block buffer in elements, unused for overlaps.
+      };
+
+      /// @brief Overlap exchanged with a process.
+      struct Part
+      {
+        Box         box{};    ///< The overlap of the blocks.
+        std::size_t offset{}; ///< Byte offset of the packed overlap in the exchange buffer.
+      };
+
+      /**
+       * @brief Get the size of the element of the blocks.
+       * @param precision Precision of the values.
+       * @param complexity Complexity of the elements.
+       * @return The size in bytes.
+       */
+      [[nodiscard]] static std::size_t getElemSize(Precision precision, Complexity complexity)
+      {
+        switch (precision)
+        {
+        case Precision::bf16:
+        case Precision::f16:
+        case Precision::f32:
+        case Precision::f64:
+          break;
+        default:
+          throw std::invalid_argument{"redistribution supports only bf16, f16, f32 and f64 precisions"};
+        }
+
+        return detail::sizeOf(precision) * ((complexity == Complexity::complex) ? 2 : 1);
+      }
+
+      /**
+       * @brief Get the size of the exchanged element.
+       * @param precision Precision of the values of the blocks.
+       * @param complexity Complexity of the elements.
+       * @param exchangePrecision Precision of the exchanged values.
+       * @return The size in bytes.
+       */
+      [[nodiscard]] static std::size_t
+      getExchangeElemSize(Precision precision, Complexity complexity, Precision exchangePrecision)
+      {
+        const bool isNarrower = (precision == Precision::f64 && exchangePrecision == Precision::f32) ||
+                                (!detail::halfPrecision::isHalf(precision) &&
+                                 detail::halfPrecision::isHalf(exchangePrecision));
+
+        if (exchangePrecision != precision && !isNarrower)
+        {
+          throw std::invalid_argument{"exchange precision must be the precision of the blocks or a narrower one"};
+        }
+
+        return getElemSize(exchangePrecision, complexity);
+      }
+
+      /**
+       * @brief Convert a size of the packed values to the size of the exchanged ones.
+       * @param size Size in bytes of the packed values.
+       * @return The size in bytes of the exchanged values.
+       */
+      [[nodiscard]] std::size_t toExchangeSize(std::size_t size) const
+      {
+        return size / mElemSize * mExchangeElemSize;
+      }
+
+      /**
+       * @brief Narrow the packed values to the exchange precision in parallel, rounding to nearest even.
+       * @param src Packed values.
+       * @param dst Exchanged values, must not overlap the packed ones.
+       * @param count Number of values.
+       */
+      void narrowValues(const void* src, void* dst, std::size_t count) const
+      {
+        const std::size_t chunkCount = (count + conversionChunkSize - 1) / conversionChunkSize;
+
+        detail::parallelFor(chunkCount, mThreadLimit, [&](std::size_t chunk)
+        {
+          const std::size_t offset = chunk * conversionChunkSize;
+          const std::size_t size   = std::min(conversionChunkSize, count - offset);
+
+          if (mPrecision == Precision::f32)
+          {
+            detail::halfPrecision::narrowChunk(mExchangePrecision,
+                                               static_cast<const float*>(src) + offset,
+                                               static_cast<std::uint16_t*>(dst) + offset,
+                                               size);
+            return;
+          }
+
+          const double* values = static_cast<const double*>(src) + offset;
+
+          if (mExchangePrecision == Precision::f32)
+          {
+            std::transform(values, values + size, static_cast<float*>(dst) + offset, [](double value)
+            {
+              return static_cast<float>(value);
+            });
+            return;
+          }
+
+          std::array<float, conversionBlockSize> block{};
+
+          for (std::size_t i{}; i < size; i += conversionBlockSize)
+          {
+            const std::size_t blockSize = std::min(conversionBlockSize, size - i);
+
+            std::transform(values + i, values + i + blockSize, block.begin(), [](double value)
+            {
+              return static_cast<float>(value);
+            });
+
+            detail::halfPrecision::narrowChunk(mExchangePrecision,
+                                               block.data(),
+                                               static_cast<std::uint16_t*>(dst) + offset + i,
+                                               blockSize);
+          }
+        });
+      }
+
+      /**
+       * @brief Widen the exchanged values back to the precision of the blocks in parallel.
+       * @param src Exchanged values.
+       * @param dst Packed values, must not overlap the exchanged ones.
+       * @param count Number of values.
+       */
+      void widenValues(const void* src, void* dst, std::size_t count) const
+      {
+        const std::size_t chunkCount = (count + conversionChunkSize - 1) / conversionChunkSize;
+
+        detail::parallelFor(chunkCount, mThreadLimit, [&](std::size_t chunk)
+        {
+          const std::size_t offset = chunk * conversionChunkSize;
+          const std::size_t size   = std::min(conversionChunkSize, count - offset);
+
+          if (mPrecision == Precision::f32)
+          {
+            detail::halfPrecision::widenChunk(mExchangePrecision,
+                                              static_cast<const std::uint16_t*>(src) + offset,
+                                              static_cast<float*>(dst) + offset,
+                                              size);
+            return;
+          }
+
+          double* values = static_cast<double*>(dst) + offset;
+
+          if (mExchangePrecision == Precision::f32)
+          {
+            const float* exchanged = static_cast<const float*>(src) + offset;
+
+            std::copy(exchanged, exchanged + size, values);
+            return;
+          }
+
+          std::array<float, conversionBlockSize> block{};
+
+          for (std::size_t i{}; i < size; i += conversionBlockSize)
+          {
+            const std::size_t blockSize = std::min(conversionBlockSize, size - i);
+
+            detail::halfPrecision::widenChunk(mExchangePrecision,
+                                              static_cast<const std::uint16_t*>(src) + offset + i,
+                                              block.data(),
+                                              blockSize);
+
+            std::copy(block.begin(), block.begin() + blockSize, values + i);
+          }
+        });
+      }
+
+      /**
+       * @brief Make the block of the process, validating it against the global shape.
+       * @tparam shapeExt Extent of the shape.
+       * @param shape Global shape.
+       * @param block Memory block.
+       * @return The block.
+       */
+      template<std::size_t shapeExt>
+      [[nodiscard]] Box makeBlock(View<std::size_t, shapeExt> shape, const MemoryBlock<shapeExt>& block) const
+      {
+        if (block.starts.size() != mRank || block.sizes.size() != mRank)
+        {
+          throw std::invalid_argument{"memory block starts and sizes must have the rank of the shape"};
+        }
+
+        if (!block.strides.empty() && block.strides.size() != mRank)
+        {
+          throw std::invalid_argument{"memory block strides must have the rank of the shape"};
+        }
+
+        Box box{};
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          if (block.starts[i] > shape[i] || block.sizes[i] > shape[i] - block.starts[i])
+          {
+            throw std::invalid_argument{"memory block exceeds the shape"};
+          }
+
+          box.starts[i] = block.starts[i];
+          box.sizes[i]  = block.sizes[i];
+        }
+
+        if (block.strides.empty())
+        {
+          box.strides = makeRowMajorStrides(box);
+        }
+        else
+        {
+          std::copy(block.strides.begin(), block.strides.end(), box.strides.begin());
+        }
+
+        return box;
+      }
+
+      /**
+       * @brief Intersect two blocks.
+       * @param lhs Left-hand side block.
+       * @param rhs Right-hand side block.
+       * @return The overlap, its size is zero if the blocks do not overlap.
+       */
+      [[nodiscard]] Box intersect(const Box& lhs, const Box& rhs) const
+      {
+        Box box{};
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          const std::size_t start = std::max(lhs.starts[i], rhs.starts[i]);
+          const std::size_t end   = std::min(lhs.starts[i] + lhs.sizes[i], rhs.starts[i] + rhs.sizes[i]);
+
+          box.starts[i] = start;
+          box.sizes[i]  = (end > start) ? end - start : 0;
+        }
+
+        return box;
+      }
+
+      /**
+       * @brief Get the size of the packed block.
+       * @param box The block.
+       * @return The size in bytes.
+       */
+      [[nodiscard]] std::size_t getBoxSize(const Box& box) const
+      {
+        return std::accumulate(box.sizes.begin(), box.sizes.begin() + mRank, mElemSize, std::multiplies<>{});
+      }
+
+      /**
+       * @brief Make the row-major strides of the block sizes.
+       * @param box The block.
+       * @return The strides in elements.
+       */
+      [[nodiscard]] detail::MaxDimArray<std::size_t> makeRowMajorStrides(const Box& box) const
+      {
+        detail::MaxDimArray<std::size_t> strides{};
+
+        makeStrides(View<std::size_t>{box.sizes.data(), mRank}, Span<std::size_t>{strides.data(), mRank});
+
+        return strides;
+      }
+
+      /**
+       * @brief Get the byte offset of the overlap origin in the block buffer.
+       * @param block The block of the buffer.
+       * @param box The overlap inside the block.
+       * @return The offset in bytes.
+       */
+      [[nodiscard]] std::size_t getOffset(const Box& block, const Box& box) const
+      {
+        std::size_t offset{};
+
+        for (std::size_t i{}; i < mRank; ++i)
+        {
+          offset += (box.starts[i] - block.starts[i]) * block.strides[i];
+        }
+
+        return offset * mElemSize;
+      }
+
+      /**
+       * @brief Copy the elements of the overlap.
+       * @param box The overlap.
+       * @param src Source origin.
+       * @param srcStrides Source strides in elements.
+       * @param dst Destination origin.
+       * @param dstStrides Destination strides in elements.
+       */
+      void copyBox(const Box&        box,
+                   const void*       src,
+                   View<std::size_t> srcStrides,
+                   void*             dst,
+                   View<std::size_t> dstStrides) const
+      {
+        detail::transpose::copy(src,
+                                srcStrides,
+                                dst,
+                                dstStrides,
+                                View<std::size_t>{box.sizes.data(), mRank},
+                                mElemSize,
+                                mThreadLimit);
+      }
+
+      std::size_t            mRank{};               ///< Rank of the global shape.
+      std::size_t            mElemSize{};           ///< Size of the element in bytes.
+      std::size_t            mExchangeElemSize{};   ///< Size of the exchanged element in bytes.
+      Precision              mPrecision{};          ///< Precision of the values, used only if converted.
+      Precision              mExchangePrecision{};  ///< Precision of the exchanged values, used only if converted.
+      MPI_Comm               mComm{};               ///< MPI communicator.
+      unsigned               mThreadLimit{};        ///< Maximum number of threads of the copies and the conversions.
+      std::size_t            mCommRank{};           ///< Rank of the process in the communicator.
+      Box                    mSrcBlock{};           ///< Source block of the process.
+      Box                    mDstBlock{};           ///< Destination block of the process.
+      std::vector<Part>      mSendParts{};          ///< Overlaps of the source block with all destination blocks.
+      std::vector<Part>      mRecvParts{};          ///< Overlaps of all source blocks with the destination block.
+      std::vector<int>       mSendCounts{};         ///< Sent byte counts.
+      std::vector<int>       mSendDispls{};         ///< Sent byte displacements.
+      std::vector<int>       mRecvCounts{};         ///< Received byte counts.
+      std::vector<int>       mRecvDispls{};         ///< Received byte displacements.
+      std::vector<std::byte> mSendBuffer{};         ///< Packed sent overlaps.
+      std::vector<std::byte> mRecvBuffer{};         ///< Packed received overlaps.
+      std::vector<std::byte> mSendExchangeBuffer{}; ///< Sent overlaps in the exchange precision, or empty.
+      std::vector<std::byte> mRecvExchangeBuffer{}; ///< Received overlaps in the exchange precision, or empty.
+  };
+
+  /**
+   * @brief Redistribute a distributed cpu array from one block decomposition to another, collective over the
+   *        communicator. See Redistributor, which should be kept for repeated redistributions of the same blocks.
+   * @tparam shapeExt Extent of the shape.
+   * @param src Source block buffer of the process.
+   * @param dst Destination block buffer of the process, must not overlap the source.
+   * @param shape Global shape.
+   * @param srcBlock Source block of the process, empty strides for the row-major strides of its sizes.
+   * @param dstBlock Destination block of the process, empty strides for the row-major strides of its sizes.
+   * @param elemSize Size of the element in bytes, 2, 4, 8, 16 or 32.
+   * @param comm MPI communicator.
+   * @param threadLimit Maximum number of threads of the copies, 0 for no limit.
+   */
+  template<std::size_t shapeExt>
+  void redistribute(const void*                  src,
+                    void*                        dst,
+                    View<std::size_t, shapeExt>  shape,
+                    const MemoryBlock<shapeExt>& srcBlock,
+                    const MemoryBlock<shapeExt>& dstBlock,
+                    std::size_t                  elemSize,
+                    MPI_Comm                     comm,
+                    unsigned                     threadLimit = 1)
+  {
+    Redistributor{shape, srcBlock, dstBlock, elemSize, comm, threadLimit}.execute(src, dst);
+  }
+
+  /**
+   * @brief Redistribute a distributed cpu array exchanging the values in a reduced precision, collective over the
+   *        communicator. See Redistributor.
+   * @tparam shapeExt Extent of the shape.
+   * @param src Source block buffer of the process.
+   * @param dst Destination block buffer of the process, must not overlap the source.
+   * @param shape Global shape.
+   * @param srcBlock Source block of the process, empty strides for the row-major strides of its sizes.
+   * @param dstBlock Destination block of the process, empty strides for the row-major strides of its sizes.
+   * @param precision Precision of the values of the blocks, bf16, f16, f32 or f64.
+   * @param complexity Complexity of the elements of the blocks.
+   * @param exchangePrecision Precision of the exchanged values, the precision of the blocks or a narrower one.
+   * @param comm MPI communicator.
+   * @param threadLimit Maximum number of threads of the copies and the conversions, 0 for no limit.
+   */
+  template<std::size_t shapeExt>
+  void redistribute(const void*                  src,
+                    void*                        dst,
+                    View<std::size_t, shapeExt>  shape,
+                    const MemoryBlock<shapeExt>& srcBlock,
+                    const MemoryBlock<shapeExt>& dstBlock,
+                    Precision                    precision,
+                    Complexity                   complexity,
+                    Precision                    exchangePrecision,
+                    MPI_Comm                     comm,
+                    unsigned                     threadLimit = 1)
+  {
+    Redistributor{shape, srcBlock, dstBlock, precision, complexity, exchangePrecision, comm, threadLimit}
+      .execute(src, dst);
+  }
+#endif /* AFFT_ENABLE_MPI */
+} // namespace afft
+
+#endif /* AFFT_REDISTRIBUTE_HPP */
@@ -0,0 +1,164 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_ROCFFT_HPP
+#define AFFT_ROCFFT_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "exception.hpp"
+#include "init.hpp"
+#include "makePlan.hpp"
+#include "detail/serialize.hpp"
+#ifdef AFFT_ENABLE_ROCFFT
+# include "detail/rocfft/error.hpp"
+# include "detail/rocfft/init.hpp"
+#endif
+
+// The kernel cache is global to the process. On the AMD platform hipFFT runs on top of rocFFT and shares the cache, so
+// these functions control the hipFFT kernels as well.
+AFFT_EXPORT namespace afft::rocfft
+{
+  /**
+   * @brief Set the path of the rocFFT runtime compilation kernel cache, e.g. a file on a shared file system. Must be
+   *        called before the rocFFT backend is initialized, i.e. before its first use or afft::init(Backend::rocfft).
+   * @param path Path of the cache file, empty path restores the rocFFT default.
+   */
+  inline void setCachePath([[maybe_unused]] std::string_view path)
+  {
+# ifdef AFFT_ENABLE_ROCFFT
+    if (detail::Initializer::getInstance().isBackendInitialized(Backend::rocfft))
+    {
+      throw std::runtime_error{"rocFFT cache path must be set before the rocFFT backend is initialized"};
+    }
+
+    detail::rocfft::getCachePath() = path;
+# endif
+  }
+
+  /**
+   * @brief Serialize the kernels in the rocFFT kernel cache, so they can be shipped with the application and loaded
+   *        by deserializeCache(). Initializes the rocFFT backend.
+   * @return Serialized kernel cache, empty if rocFFT is not enabled.
+   */
+  [[nodiscard]] inline std::string serializeCache()
+  {
+    std::string cache{};
+
+# ifdef AFFT_ENABLE_ROCFFT
+    detail::Initializer::getInstance().initBackend(Backend::rocfft);
+
+    struct BufferDeleter
+    {
+      void operator()(void* buffer) const
+      {
+        rocfft_cache_buffer_free(buffer);
+      }
+    };
+
+    void*       buffer{};
+    std::size_t bufferSize{};
+
+    detail::rocfft::checkError(rocfft_cache_serialize(&buffer, &bufferSize));
+
+    std::unique_ptr<void, BufferDeleter> bufferHolder{buffer};
+
+    cache.assign(static_cast<const char*>(buffer), bufferSize);
+# endif
+
+    return cache;
+  }
+
+  /**
+   * @brief Load kernels serialized by serializeCache() into the rocFFT kernel cache. Initializes the rocFFT backend.
+   * @param cache Serialized kernel cache.
+   */
+  inline void deserializeCache([[maybe_unused]] std::string_view cache)
+  {
+# ifdef AFFT_ENABLE_ROCFFT
+    detail::Initializer::getInstance().initBackend(Backend::rocfft);
+
+    detail::rocfft::checkError(rocfft_cache_deserialize(cache.data(), cache.size()));
+# endif
+  }
+
+  /**
+   * @brief Compile the rocFFT kernels of a transform into the kernel cache without keeping the plan, e.g. at build or
+   *        deploy time. Later plans of the same transform load the kernels from the cache instead of compiling them.
+   * @tparam TransformParamsT Transform parameters type.
+   * @tparam ArchParamsT Architecture parameters type, must have the gpu target.
+   * @param transformParams Transform parameters.
+   * @param archParams Architecture parameters.
+   */
+  template<typename TransformParamsT, typename ArchParamsT>
+  void precompile([[maybe_unused]] const TransformParamsT& transformParams, [[maybe_unused]] ArchParamsT& archParams)
+  {
+    static_assert(isTransformParameters<TransformParamsT>, "Invalid transform parameters type");
+    static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+    static_assert(ArchParamsT::target == Target::gpu, "rocFFT kernels can be precompiled only for the gpu target");
+
+# ifdef AFFT_ENABLE_ROCFFT
+    static constexpr Backend backend{Backend::rocfft};
+
+    BackendParameters<ArchParamsT::target, ArchParamsT::distribution> backendParams{};
+    backendParams.mask  = BackendMask::empty | backend;
+    backendParams.order = View<Backend>{&backend, 1};
+
+    [[maybe_unused]] const auto plan = makePlan(transformParams, archParams, backendParams);
+# endif
+  }
+
+  /**
+   * @brief Compile the rocFFT kernels of serialized plans, see Plan::serialize(), into the kernel cache. The plans may
+   *        have been serialized with any gpu backend, their transforms are planned with rocFFT.
+   * @param serializedPlans Serialized plans.
+   */
+  inline void precompile([[maybe_unused]] View<std::string> serializedPlans)
+  {
+# ifdef AFFT_ENABLE_ROCFFT
+    for (const auto& serializedPlan : serializedPlans)
+    {
+      const detail::SerialReader reader{serializedPlan, detail::serializedPlanHeader};
+
+      if (reader.read<Target>("target") != Target::gpu)
+      {
+        throw std::invalid_argument{"rocFFT kernels can be precompiled only for gpu plans"};
+      }
+
+      detail::readDesc(reader, [](const auto& transformParams, auto& archParams)
+      {
+        if constexpr (std::decay_t<decltype(archParams)>::target == Target::gpu)
+        {
+          precompile(transformParams, archParams);
+        }
+      });
+    }
+# endif
+  }
+} // namespace afft::rocfft
+
+#endif /* AFFT_ROCFFT_HPP */
@@ -0,0 +1,297 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_SENDER_HPP
+#define AFFT_SENDER_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "architecture.hpp"
+#include "Plan.hpp"
+#include "typeTraits.hpp"
+#if defined(AFFT_ENABLE_CUDA)
+# include "detail/cuda/error.hpp"
+#elif defined(AFFT_ENABLE_HIP)
+# include "detail/hip/error.hpp"
+#endif
+
+namespace afft::detail
+{
+  /// @brief Check if the execution parameters type is supported by the execute senders.
+  template<typename ExecParamsT>
+  inline constexpr bool isSenderExecutionParameters = std::is_same_v<ExecParamsT, afft::spst::cpu::ExecutionParameters>
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+                                                      || std::is_same_v<ExecParamsT, afft::spst::gpu::ExecutionParameters>
+#endif
+                                                      ;
+
+  /**
+   * @brief Complete the receiver by the value channel.
+   * @tparam ReceiverT Receiver type.
+   * @param receiver The receiver.
+   */
+  template<typename ReceiverT>
+  void setReceiverValue(ReceiverT& receiver) noexcept
+  {
+#ifdef AFFT_ENABLE_STDEXEC
+    stdexec::set_value(std::move(receiver));
+#else
+    std::move(receiver).set_value();
+#endif
+  }
+
+  /**
+   * @brief Complete the receiver by the error channel.
+   * @tparam ReceiverT Receiver type.
+   * @param receiver The receiver.
+   * @param error The error.
+   */
+  template<typename ReceiverT>
+  void setReceiverError(ReceiverT& receiver, std::exception_ptr error) noexcept
+  {
+#ifdef AFFT_ENABLE_STDEXEC
+    stdexec::set_error(std::move(receiver), std::move(error));
+#else
+    std::move(receiver).set_error(std::move(error));
+#endif
+  }
+} // namespace afft::detail
+
+AFFT_EXPORT namespace afft
+{
+  /**
+   * @class ExecuteSender
+   * @brief Lazy execution of a plan following the sender/receiver protocol of P2300. Nothing runs until the operation
+   *        returned by connect() is started. A spst cpu plan is executed by a task of the afft executor thread pool, a
+   *        spst gpu plan is enqueued on the stream of the execution parameters by the starting thread and the receiver
+   *        is completed by a host function enqueued after it, so the completion waits for the stream without blocking
+   *        a thread. The receiver is completed by set_value() on success or by set_error(std::exception_ptr) with the
+   *        execution error. With AFFT_ENABLE_STDEXEC the sender and its receivers are stdexec senders and receivers
+   *        and compose with stdexec schedulers and algorithms, otherwise the receiver must provide the `set_value() &&`
+   *        and `set_error(std::exception_ptr) &&` member functions. The plan and the buffers must stay valid until
+   *        the receiver is completed.
+   * @tparam SrcT Source type.
+   * @tparam DstT Destination type.
+   * @tparam ExecParamsT Execution parameters type.
+   */
+  template<typename SrcT, typename DstT, typename ExecParamsT>
+  class ExecuteSender
+  {
+    static_assert(isKnownType<SrcT>, "unknown source type");
+    static_assert(isKnownType<DstT>, "unknown destination type");
+    static_assert(!std::is_const_v<DstT>, "destination type must be non-const");
+
+    public:
+#ifdef AFFT_ENABLE_STDEXEC
+      using sender_concept        = stdexec::sender_t;
+      using completion_signatures = stdexec::completion_signatures<stdexec::set_value_t(),
+                                                                   stdexec::set_error_t(std::exception_ptr)>;
+#endif
+
+      /**
+       * @class Operation
+       * @brief Operation state of a connected execution, it must not be moved after connect().
+       * @tparam ReceiverT Receiver type.
+       */
+      template<typename ReceiverT>
+      class Operation
+      {
+        public:
+#       ifdef AFFT_ENABLE_STDEXEC
+          using operation_state_concept = stdexec::operation_state_t;
+#       endif
+
+          /// @brief Constructor.
+          Operation(const ExecuteSender& sender, ReceiverT receiver)
+          : mSender{sender},
+            mReceiver{std::move(receiver)}
+          {}
+
+          /// @brief Copy constructor is deleted.
+          Operation(const Operation&) = delete;
+
+          /// @brief Move constructor is deleted.
+          Operation(Operation&&) = delete;
+
+          /// @brief Destructor.
+          ~Operation() = default;
+
+          /// @brief Copy assignment operator is deleted.
+          Operation& operator=(const Operation&) = delete;
+
+          /// @brief Move assignment operator is deleted.
+          Operation& operator=(Operation&&) = delete;
+
+          /// @brief Start the execution, the receiver is completed exactly once.
+          void start() & noexcept
+          {
+            if constexpr (std::is_same_v<ExecParamsT, afft::spst::cpu::ExecutionParameters>)
+            {
+              try
+              {
+                (void)detail::getExecutorThreadPool().submit(std::function<void()>{[this]{ run(); }});
+              }
+              catch (...)
+              {
+                detail::setReceiverError(mReceiver, std::current_exception());
+              }
+            }
+#         if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+            else if constexpr (std::is_same_v<ExecParamsT, afft::spst::gpu::ExecutionParameters>)
+            {
+              try
+              {
+                mSender.mPlan->execute(mSender.mSrc, mSender.mDst, mSender.mExecParams);
+#             if defined(AFFT_ENABLE_CUDA)
+                detail::cuda::checkError(cudaLaunchHostFunc(mSender.mExecParams.stream, complete, this));
+#             elif defined(AFFT_ENABLE_HIP)
+                detail::hip::checkError(hipLaunchHostFunc(mSender.mExecParams.stream, complete, this));
+#             endif
+              }
+              catch (...)
+              {
+                detail::setReceiverError(mReceiver, std::current_exception());
+              }
+            }
+#         endif
+          }
+
+        private:
+          /// @brief Execute the plan and complete the receiver.
+          void run() noexcept
+          {
+            try
+            {
+              mSender.mPlan->execute(mSender.mSrc, mSender.mDst, mSender.mExecParams);
+            }
+            catch (...)
+            {
+              detail::setReceiverError(mReceiver, std::current_exception());
+              return;
+            }
+
+            detail::setReceiverValue(mReceiver);
+          }
+
+          /**
+           * @brief Complete the receiver after the stream reached the host function.
+           * @param data The operation.
+           */
+          static void complete(void* data) noexcept
+          {
+            detail::setReceiverValue(static_cast<Operation*>(data)->mReceiver);
+          }
+
+          ExecuteSender mSender;   ///< The connected sender.
+          ReceiverT     mReceiver; ///< The receiver.
+      };
+
+      /// @brief Default constructor is deleted.
+      ExecuteSender() = delete;
+
+      /**
+       * @brief Constructor, the arguments are checked when the sender is made by executeSender().
+       * @param plan The plan.
+       * @param src Source buffer.
+       * @param dst Destination buffer.
+       * @param execParams Execution parameters.
+       */
+      ExecuteSender(Plan& plan, SrcT* src, DstT* dst, const ExecParamsT& execParams)
+      : mPlan{&plan},
+        mSrc{src},
+        mDst{dst},
+        mExecParams{execParams}
+      {}
+
+      /// @brief Copy constructor.
+      ExecuteSender(const ExecuteSender&) = default;
+
+      /// @brief Move constructor.
+      ExecuteSender(ExecuteSender&&) = default;
+
+      /// @brief Destructor.
+      ~ExecuteSender() = default;
+
+      /// @brief Copy assignment operator.
+      ExecuteSender& operator=(const ExecuteSender&) = default;
+
+      /// @brief Move assignment operator.
+      ExecuteSender& operator=(ExecuteSender&&) = default;
+
+      /**
+       * @brief Connect the sender to a receiver.
+       * @tparam ReceiverT Receiver type.
+       * @param receiver The receiver.
+       * @return The operation state, the execution begins by its start().
+       */
+      template<typename ReceiverT>
+      [[nodiscard]] Operation<std::decay_t<ReceiverT>> connect(ReceiverT&& receiver) const
+      {
+        return Operation<std::decay_t<ReceiverT>>{*this, std::forward<ReceiverT>(receiver)};
+      }
+
+    private:
+      Plan*       mPlan{};       ///< The plan.
+      SrcT*       mSrc{};        ///< Source buffer.
+      DstT*       mDst{};        ///< Destination buffer.
+      ExecParamsT mExecParams{}; ///< Execution parameters.
+  };
+
+  /**
+   * @brief Make a sender executing the spst cpu or spst gpu plan, see ExecuteSender. The plan and the argument types
+   *        are checked immediately, the execution errors are delivered to the receiver.
+   * @tparam SrcT Source type.
+   * @tparam DstT Destination type.
+   * @tparam ExecParamsT Execution parameters type.
+   * @param plan The plan.
+   * @param src Source buffer.
+   * @param dst Destination buffer, may be the same as the source buffer for in-place plans.
+   * @param execParams Execution parameters.
+   * @return The sender.
+   */
+  template<typename SrcT, typename DstT, typename ExecParamsT = afft::spst::cpu::ExecutionParameters>
+  [[nodiscard]] ExecuteSender<SrcT, DstT, ExecParamsT>
+  executeSender(Plan& plan, SrcT* src, DstT* dst, const ExecParamsT& execParams = {})
+  {
+    static_assert(detail::isSenderExecutionParameters<ExecParamsT>,
+                  "execute senders support only spst cpu and spst gpu execution parameters");
+
+    if (execParams.target != plan.getTarget() || execParams.distribution != plan.getDistribution())
+    {
+      throw std::invalid_argument{"execution parameters do not match the plan target and distribution"};
+    }
+
+    if (plan.getTargetCount() != 1)
+    {
+      throw std::invalid_argument{"execute senders support only single target plans"};
+    }
+
+    return ExecuteSender<SrcT, DstT, ExecParamsT>{plan, src, dst, execParams};
+  }
+} // namespace afft
+
+#endif /* AFFT_SENDER_HPP */
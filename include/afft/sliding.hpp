@@ -0,0 +1,350 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_SLIDING_HPP
+#define AFFT_SLIDING_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "alloc.hpp"
+#include "makePlan.hpp"
+#include "Plan.hpp"
+#include "typeTraits.hpp"
+
+AFFT_EXPORT namespace afft::sliding
+{
+  /// @brief Parameters of the sliding DFT
+  struct Parameters
+  {
+    std::size_t length{};                        ///< window length in samples, the transform size
+    std::size_t refreshInterval{};               ///< samples between full transforms bounding the drift, 0 selects the length
+    Direction   direction{Direction::forward};   ///< direction of the transform
+    unsigned    threadLimit{};                   ///< thread limit of the full transforms, 0 for no limit
+  };
+
+  /**
+   * @class Dft
+   * @brief Incrementally updated DFT of the last length samples of an unbounded complex or real signal, the bin k of
+   *        the window x[0], ..., x[length - 1] is sum_j x[j] exp(-+2 pi i j k / length), x[0] is the oldest sample.
+   *        Each pushed sample updates every bin in O(length) by X[k] = (X[k] - x[0] + x[length]) exp(+-2 pi i k / length),
+   *        the bins are kept in planar arrays so the update vectorizes. After refreshInterval updated samples the bins
+   *        are recomputed from the window by an afft complex-to-complex plan to bound the numerical drift of the
+   *        recurrence, a push of so many samples that the updates would cost more than a full transform is also
+   *        resolved by one. Only spst cpu plans are supported. The object is not thread safe.
+   * @tparam T Real type of the transform, float or double.
+   */
+  template<typename T>
+  class Dft
+  {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "sliding::Dft supports only float and double");
+
+    public:
+      /**
+       * @brief Constructor, creates the plan of the full transforms, the window starts filled by zeros.
+       * @tparam BackendParamsT Backend parameters type
+       * @param params Sliding DFT parameters
+       * @param backendParams Backend parameters
+       */
+      template<typename BackendParamsT = detail::DefaultBackendParameters>
+      explicit Dft(const Parameters& params, const BackendParamsT& backendParams = {})
+      : mLength{params.length},
+        mRefreshInterval{(params.refreshInterval != 0) ? params.refreshInterval : params.length}
+      {
+        constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+        if (mLength == 0)
+        {
+          throw std::invalid_argument("sliding DFT length must be greater than zero");
+        }
+
+        const std::array<std::size_t, 1> shape{mLength};
+
+        dft::Parameters<> transformParams{};
+        transformParams.direction = params.direction;
+        transformParams.precision = {typePrecision<T>, typePrecision<T>, typePrecision<T>};
+        transformParams.shape     = shape;
+
+        afft::spst::cpu::Parameters<> archParams{};
+        archParams.threadLimit = params.threadLimit;
+
+        if constexpr (std::is_same_v<BackendParamsT, detail::DefaultBackendParameters>)
+        {
+          mPlan = makePlan(transformParams, archParams);
+        }
+        else
+        {
+          mPlan = makePlan(transformParams, archParams, backendParams);
+        }
+
+        // the window rotates towards the newer samples, the opposite of the transform's sign
+        const long double sign = (params.direction == Direction::forward) ? 1.0L : -1.0L;
+
+        mTwiddlesRe.resize(mLength);
+        mTwiddlesIm.resize(mLength);
+
+        for (std::size_t k{}; k < mLength; ++k)
+        {
+          const long double angle = sign * 2.0L * pi * static_cast<long double>(k) / static_cast<long double>(mLength);
+
+          mTwiddlesRe[k] = static_cast<T>(std::cos(angle));
+          mTwiddlesIm[k] = static_cast<T>(std::sin(angle));
+        }
+
+        // an update costs about as much as log2(length) butterflies of a full transform
+        mBulkThreshold = 1;
+
+        while ((std::size_t{1} << mBulkThreshold) < mLength)
+        {
+          ++mBulkThreshold;
+        }
+
+        mBinsRe.resize(mLength);
+        mBinsIm.resize(mLength);
+        mHistory.resize(mLength);
+        mWindow   = cpu::makeAlignedUnique<std::complex<T>[]>(mLength);
+        mSpectrum = cpu::makeAlignedUnique<std::complex<T>[]>(mLength);
+      }
+
+      /// @brief Copy constructor is deleted.
+      Dft(const Dft&) = delete;
+
+      /// @brief Move constructor.
+      Dft(Dft&&) = default;
+
+      /// @brief Destructor.
+      ~Dft() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      Dft& operator=(const Dft&) = delete;
+
+      /// @brief Move assignment operator.
+      Dft& operator=(Dft&&) = default;
+
+      /**
+       * @brief Get the window length.
+       * @return Window length in samples.
+       */
+      [[nodiscard]] constexpr std::size_t getLength() const noexcept
+      {
+        return mLength;
+      }
+
+      /**
+       * @brief Get the number of updated samples between the full transforms.
+       * @return Refresh interval in samples.
+       */
+      [[nodiscard]] constexpr std::size_t getRefreshInterval() const noexcept
+      {
+        return mRefreshInterval;
+      }
+
+      /**
+       * @brief Get the plan of the full transforms.
+       * @return The complex-to-complex plan.
+       */
+      [[nodiscard]] afft::Plan& getPlan() noexcept
+      {
+        return *mPlan;
+      }
+
+      /**
+       * @brief Get a bin of the current window.
+       * @param k Bin index.
+       * @return The bin.
+       */
+      [[nodiscard]] std::complex<T> getBin(std::size_t k) const
+      {
+        if (k >= mLength)
+        {
+          throw std::out_of_range("bin index out of range");
+        }
+
+        return {mBinsRe[k], mBinsIm[k]};
+      }
+
+      /**
+       * @brief Copy the bins of the current window.
+       * @param dst Destination of length bins.
+       */
+      void getBins(std::complex<T>* dst) const
+      {
+        if (dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as a buffer");
+        }
+
+        for (std::size_t k{}; k < mLength; ++k)
+        {
+          dst[k] = {mBinsRe[k], mBinsIm[k]};
+        }
+      }
+
+      /**
+       * @brief Push samples into the window, each sample shifts the window by one.
+       * @param samples Complex samples.
+       * @param count Sample count.
+       */
+      void push(const std::complex<T>* samples, std::size_t count)
+      {
+        pushSamples(samples, count);
+      }
+
+      /**
+       * @brief Push real samples into the window, each sample shifts the window by one.
+       * @param samples Real samples.
+       * @param count Sample count.
+       */
+      void push(const T* samples, std::size_t count)
+      {
+        pushSamples(samples, count);
+      }
+
+      /// @brief Recompute the bins of the current window by the full transform.
+      void refresh()
+      {
+        // the oldest sample is at the head of the circular history
+        std::copy(mHistory.begin() + static_cast<std::ptrdiff_t>(mHead), mHistory.end(), mWindow.get());
+        std::copy(mHistory.begin(), mHistory.begin() + static_cast<std::ptrdiff_t>(mHead), mWindow.get() + (mLength - mHead));
+
+        mPlan->execute(mWindow.get(), mSpectrum.get());
+
+        for (std::size_t k{}; k < mLength; ++k)
+        {
+          mBinsRe[k] = mSpectrum[k].real();
+          mBinsIm[k] = mSpectrum[k].imag();
+        }
+
+        mUpdateCount = 0;
+      }
+
+      /// @brief Fill the window by zeros.
+      void reset()
+      {
+        std::fill(mHistory.begin(), mHistory.end(), std::complex<T>{});
+        std::fill(mBinsRe.begin(), mBinsRe.end(), T{});
+        std::fill(mBinsIm.begin(), mBinsIm.end(), T{});
+
+        mHead        = 0;
+        mUpdateCount = 0;
+      }
+
+    private:
+      /**
+       * @brief Push samples updating the bins or resolving them by one full transform.
+       * @tparam SampleT Sample type.
+       * @param samples Samples.
+       * @param count Sample count.
+       */
+      template<typename SampleT>
+      void pushSamples(const SampleT* samples, std::size_t count)
+      {
+        if (samples == nullptr && count != 0)
+        {
+          throw std::invalid_argument("a null pointer was passed as samples");
+        }
+
+        if (count >= mBulkThreshold)
+        {
+          // only the last length samples remain in the window
+          const std::size_t skip = (count > mLength) ? count - mLength : 0;
+
+          for (std::size_t i = skip; i < count; ++i)
+          {
+            storeSample(std::complex<T>{samples[i]});
+          }
+
+          refresh();
+
+          return;
+        }
+
+        for (std::size_t i{}; i < count; ++i)
+        {
+          const std::complex<T> sample{samples[i]};
+          const std::complex<T> delta = sample - mHistory[mHead];
+
+          update(delta.real(), delta.imag());
+
+          storeSample(sample);
+
+          if (++mUpdateCount >= mRefreshInterval)
+          {
+            refresh();
+          }
+        }
+      }
+
+      /**
+       * @brief Replace the oldest sample of the window.
+       * @param sample The new sample.
+       */
+      void storeSample(std::complex<T> sample) noexcept
+      {
+        mHistory[mHead] = sample;
+
+        mHead = (mHead + 1 == mLength) ? 0 : mHead + 1;
+      }
+
+      /**
+       * @brief Update the bins by one shifted sample.
+       * @param deltaRe Real part of the difference of the new and the oldest sample.
+       * @param deltaIm Imaginary part of the difference of the new and the oldest sample.
+       */
+      void update(T deltaRe, T deltaIm) noexcept
+      {
+        T*       binsRe     = mBinsRe.data();
+        T*       binsIm     = mBinsIm.data();
+        const T* twiddlesRe = mTwiddlesRe.data();
+        const T* twiddlesIm = mTwiddlesIm.data();
+
+        for (std::size_t k{}; k < mLength; ++k)
+        {
+          const T re = binsRe[k] + deltaRe;
+          const T im = binsIm[k] + deltaIm;
+
+          binsRe[k] = re * twiddlesRe[k] - im * twiddlesIm[k];
+          binsIm[k] = re * twiddlesIm[k] + im * twiddlesRe[k];
+        }
+      }
+
+      std::size_t                               mLength{};          ///< Window length.
+      std::size_t                               mRefreshInterval{}; ///< Updated samples between the full transforms.
+      std::size_t                               mBulkThreshold{};   ///< Push size resolved by a full transform.
+      std::size_t                               mHead{};            ///< Index of the oldest sample of the history.
+      std::size_t                               mUpdateCount{};     ///< Samples updated since the last full transform.
+      std::unique_ptr<afft::Plan>               mPlan{};            ///< Complex-to-complex plan of the window.
+      std::vector<T>                            mTwiddlesRe{};      ///< Real parts of the shift twiddles.
+      std::vector<T>                            mTwiddlesIm{};      ///< Imaginary parts of the shift twiddles.
+      std::vector<T>                            mBinsRe{};          ///< Real parts of the bins.
+      std::vector<T>                            mBinsIm{};          ///< Imaginary parts of the bins.
+      std::vector<std::complex<T>>              mHistory{};         ///< Circular history of the window samples.
+      cpu::AlignedUniquePtr<std::complex<T>[]>  mWindow{};          ///< Window ordered from the oldest sample.
+      cpu::AlignedUniquePtr<std::complex<T>[]>  mSpectrum{};        ///< Output of the full transform.
+  };
+} // namespace afft::sliding
+
+#endif /* AFFT_SLIDING_HPP */
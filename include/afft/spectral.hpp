@@ -0,0 +1,514 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_SPECTRAL_HPP
+#define AFFT_SPECTRAL_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "makePlan.hpp"
+#include "Plan.hpp"
+#include "PlanCache.hpp"
+#include "detail/convolve.hpp"
+#include "detail/spectral.hpp"
+#if defined(AFFT_ENABLE_CUDA)
+# include "detail/cuda/cuda.hpp"
+#endif
+
+AFFT_EXPORT namespace afft::spectral
+{
+  /// @brief Type of the spectral operator
+  enum class OperatorType : std::uint8_t
+  {
+    derivative,       ///< derivative of the given order along one axis, multiplies by (i k_a)^p
+    laplacian,        ///< Laplacian, multiplies by -|k|^2
+    inverseLaplacian, ///< solution of the Poisson equation, multiplies by -1/|k|^2, the mean is set to zero
+  };
+
+  /// @brief Parameters of the spectral operator
+  struct Parameters
+  {
+    OperatorType type{OperatorType::derivative}; ///< type of the operator
+    std::size_t  axis{};                         ///< shape axis of the derivative, must be a transform axis
+    unsigned     order{1};                       ///< order of the derivative
+    View<double> lengths{};                      ///< domain length of each transform axis, empty for 2pi
+  };
+
+  /**
+   * @class Operator
+   * @brief Spectral operator applied to real data via real-to-complex transforms, the pseudo-spectral derivatives and
+   *        Poisson solves of time stepping codes. Owns the forward and the inverse plan and the intermediate
+   *        half-spectrum, the wavenumber tables of the axes are built once by the constructor. On cpu the multiplier is
+   *        computed on the fly from the tables by one blocked pass over the half-spectrum distributed over the thread
+   *        pool, on gpu the full multiplier is precomputed and fused into the load callback of the inverse cuFFT plan.
+   *        The 1/N normalization of the inverse transform is folded into the multiplier. Executions must not overlap
+   *        as they share the intermediate spectrum.
+   */
+  class Operator
+  {
+    public:
+      /**
+       * @brief Constructor
+       * @tparam shapeExt Extent of the shape
+       * @tparam transformExt Extent of the transform
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param transformParams Parameters of the forward real-to-complex transform, the normalization and the
+       *                        placement are ignored
+       * @param archParams Architecture parameters, spst distribution only
+       * @param operatorParams Parameters of the operator
+       * @param backendParams Backend parameters
+       */
+      template<std::size_t shapeExt,
+               std::size_t transformExt,
+               typename ArchParamsT,
+               typename BackendParamsT = detail::DefaultBackendParameters>
+      Operator(const dft::Parameters<shapeExt, transformExt>& transformParams,
+               const ArchParamsT&                             archParams,
+               const Parameters&                              operatorParams,
+               const BackendParamsT&                          backendParams = {})
+      {
+        init(transformParams, archParams, operatorParams, [&](const auto& planTransformParams, auto& planArchParams)
+        {
+          return makePlan(planTransformParams, planArchParams, backendParams);
+        });
+      }
+
+      /**
+       * @brief Constructor taking the plans from the plan cache, operators of the same transform share the plans
+       * @tparam shapeExt Extent of the shape
+       * @tparam transformExt Extent of the transform
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam BackendParamsT Backend parameters type
+       * @param planCache Plan cache the plans are found in or inserted into
+       * @param transformParams Parameters of the forward real-to-complex transform, the normalization and the
+       *                        placement are ignored
+       * @param archParams Architecture parameters, spst distribution only
+       * @param operatorParams Parameters of the operator
+       * @param backendParams Backend parameters
+       */
+      template<std::size_t shapeExt,
+               std::size_t transformExt,
+               typename ArchParamsT,
+               typename BackendParamsT = detail::DefaultBackendParameters>
+      Operator(PlanCache&                                     planCache,
+               const dft::Parameters<shapeExt, transformExt>& transformParams,
+               const ArchParamsT&                             archParams,
+               const Parameters&                              operatorParams,
+               const BackendParamsT&                          backendParams = {})
+      {
+        init(transformParams, archParams, operatorParams, [&](const auto& planTransformParams, auto& planArchParams)
+        {
+          return planCache.findOrCreate(planTransformParams, planArchParams, backendParams);
+        });
+      }
+
+      /// @brief Copy constructor is deleted.
+      Operator(const Operator&) = delete;
+
+      /// @brief Move constructor.
+      Operator(Operator&&) = default;
+
+      /// @brief Destructor.
+      ~Operator() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      Operator& operator=(const Operator&) = delete;
+
+      /// @brief Move assignment operator.
+      Operator& operator=(Operator&&) = default;
+
+      /**
+       * @brief Get the type of the operator.
+       * @return Type of the operator.
+       */
+      [[nodiscard]] constexpr OperatorType getType() const noexcept
+      {
+        return mType;
+      }
+
+      /**
+       * @brief Get the forward plan.
+       * @return Forward plan.
+       */
+      [[nodiscard]] const Plan& getForwardPlan() const noexcept
+      {
+        return *mForwardPlan;
+      }
+
+      /**
+       * @brief Get the inverse plan.
+       * @return Inverse plan.
+       */
+      [[nodiscard]] const Plan& getInversePlan() const noexcept
+      {
+        return *mInversePlan;
+      }
+
+      /**
+       * @brief Execute the operator with the default execution parameters.
+       * @param src Source signal, preserved if the plans preserve the source.
+       * @param dst Destination signal.
+       */
+      void execute(const void* src, void* dst)
+      {
+        switch (mTarget)
+        {
+        case Target::cpu:
+          execute(src, dst, afft::spst::cpu::ExecutionParameters{});
+          break;
+        case Target::gpu:
+          execute(src, dst, afft::spst::gpu::ExecutionParameters{});
+          break;
+        default:
+          detail::cxx::unreachable();
+        }
+      }
+
+      /**
+       * @brief Execute the operator.
+       * @tparam ExecParamsT Execution parameters type.
+       * @param src Source signal, preserved if the plans preserve the source.
+       * @param dst Destination signal.
+       * @param execParams Execution parameters shared by both plans.
+       */
+      template<typename ExecParamsT>
+      void execute(const void* src, void* dst, const ExecParamsT& execParams)
+      {
+        static_assert(isExecutionParameters<ExecParamsT>, "Invalid execution parameters type");
+
+        mForwardPlan->executeUnsafe(src, mSpectrum.get(), execParams);
+
+        if constexpr (ExecParamsT::target == Target::cpu)
+        {
+          if (mPrecision == Precision::f32)
+          {
+            detail::spectral::apply(static_cast<float*>(mSpectrum.get()), mMultiplier, mThreadLimit);
+          }
+          else
+          {
+            detail::spectral::apply(static_cast<double*>(mSpectrum.get()), mMultiplier, mThreadLimit);
+          }
+        }
+
+        mInversePlan->executeUnsafe(mSpectrum.get(), dst, execParams);
+      }
+    private:
+      /**
+       * @brief Initialize the operator.
+       * @tparam shapeExt Extent of the shape
+       * @tparam transformExt Extent of the transform
+       * @tparam ArchParamsT Architecture parameters type
+       * @tparam MakePlanFnT Function making a plan from the transform and the architecture parameters
+       * @param transformParams Parameters of the forward real-to-complex transform
+       * @param archParams Architecture parameters
+       * @param operatorParams Parameters of the operator
+       * @param makePlanFn Function making the plans
+       */
+      template<std::size_t shapeExt, std::size_t transformExt, typename ArchParamsT, typename MakePlanFnT>
+      void init(const dft::Parameters<shapeExt, transformExt>& transformParams,
+                const ArchParamsT&                             archParams,
+                const Parameters&                              operatorParams,
+                MakePlanFnT&&                                  makePlanFn)
+      {
+        static_assert(isArchitectureParameters<ArchParamsT>, "Invalid architecture parameters type");
+        static_assert(ArchParamsT::distribution == Distribution::spst, "spectral operator supports only spst distribution");
+
+        if (transformParams.type != dft::Type::realToComplex || transformParams.direction != Direction::forward)
+        {
+          throw std::invalid_argument{"spectral operator requires a forward real-to-complex transform"};
+        }
+
+        const auto& precision = transformParams.precision;
+
+        if (precision.source != precision.execution || precision.destination != precision.execution)
+        {
+          throw std::invalid_argument{"spectral operator requires uniform precision"};
+        }
+
+        if (precision.execution != Precision::f32 && precision.execution != Precision::f64)
+        {
+          throw std::invalid_argument{"spectral operator supports only f32 and f64 precision"};
+        }
+
+        mType      = operatorParams.type;
+        mTarget    = ArchParamsT::target;
+        mPrecision = precision.execution;
+
+        if constexpr (ArchParamsT::target == Target::cpu)
+        {
+          mThreadLimit = archParams.threadLimit;
+        }
+
+        auto fwdParams          = transformParams;
+        fwdParams.normalization = Normalization::none;
+        fwdParams.placement     = Placement::outOfPlace;
+
+        // The intermediate spectrum is always stored contiguously
+        auto fwdArchParams                    = archParams;
+        fwdArchParams.memoryLayout.dstStrides = {};
+
+        makeMultiplier(detail::Desc{fwdParams, fwdArchParams}, operatorParams);
+
+        mSpectrum = allocateSpectrum();
+
+        auto invParams      = fwdParams;
+        invParams.direction = Direction::backward;
+        invParams.type      = dft::Type::complexToReal;
+
+        auto invArchParams                    = archParams;
+        invArchParams.memoryLayout.srcStrides = {};
+        invArchParams.preserveSource          = false;
+
+        if constexpr (ArchParamsT::target == Target::gpu)
+        {
+          if (!archParams.callbacks.load.srcCode.empty() || archParams.callbacks.load.devicePtr != nullptr ||
+              !archParams.callbacks.store.srcCode.empty() || archParams.callbacks.store.devicePtr != nullptr)
+          {
+            throw std::invalid_argument{"spectral operator does not support user callbacks"};
+          }
+
+#       if defined(AFFT_ENABLE_CUDA)
+          mMultiplierTable = allocateSpectrum();
+          uploadMultiplierTable();
+
+          // the scale is already folded into the table
+          mLoadCallbackSrcCode = detail::makeConvolutionLoadCallbackSrcCode(mPrecision, 1.0, false);
+
+          invArchParams.callbacks.load.srcCode      = mLoadCallbackSrcCode;
+          invArchParams.callbacks.load.functionName = detail::convolutionLoadCallbackName;
+          invArchParams.callbacks.load.callerInfo   = mMultiplierTable.get();
+#       else
+          throw std::runtime_error{"gpu spectral operator requires CUDA"};
+#       endif
+        }
+
+        mForwardPlan = makePlanFn(fwdParams, fwdArchParams);
+        mInversePlan = makePlanFn(invParams, invArchParams);
+      }
+
+      /**
+       * @brief Make the multiplier from the wavenumber tables of the transform axes.
+       * @param desc Descriptor of the forward transform.
+       * @param operatorParams Parameters of the operator.
+       */
+      void makeMultiplier(const detail::Desc& desc, const Parameters& operatorParams)
+      {
+        const auto shapeRank     = desc.getShapeRank();
+        const auto transformRank = desc.getTransformRank();
+        const auto shape         = desc.getShape();
+        const auto dstShape      = desc.getDstShape();
+        const auto transformAxes = desc.getTransformAxes();
+
+        if (!operatorParams.lengths.empty() && operatorParams.lengths.size() != transformRank)
+        {
+          throw std::invalid_argument{"spectral operator requires one domain length per transform axis"};
+        }
+
+        if (std::any_of(operatorParams.lengths.begin(), operatorParams.lengths.end(), [](double length)
+        {
+          return !(length > 0.0);
+        }))
+        {
+          throw std::invalid_argument{"spectral operator domain lengths must be positive"};
+        }
+
+        const auto axisIt = std::find(transformAxes.begin(), transformAxes.end(), operatorParams.axis);
+
+        if (mType == OperatorType::derivative)
+        {
+          if (axisIt == transformAxes.end())
+          {
+            throw std::invalid_argument{"spectral derivative axis must be a transform axis"};
+          }
+
+          if (operatorParams.order == 0)
+          {
+            throw std::invalid_argument{"spectral derivative order must be positive"};
+          }
+        }
+
+        mMultiplier.shapeRank = shapeRank;
+        mMultiplier.tables.assign(shapeRank, {});
+        std::copy_n(dstShape.data(), shapeRank, mMultiplier.shape.data());
+
+        mSpectrumCount = std::accumulate(dstShape.data(), dstShape.data() + shapeRank, std::size_t{1}, std::multiplies<>{});
+
+        std::size_t logicalCount{1};
+
+        for (std::size_t i{}; i < transformRank; ++i)
+        {
+          const auto axis      = transformAxes[i];
+          const auto size      = shape[axis];
+          const auto length    = (operatorParams.lengths.empty()) ? 2.0 * 3.14159265358979323846 : operatorParams.lengths[i];
+          const bool isReduced = (dstShape[axis] != size);
+
+          logicalCount *= size;
+
+          if (mType == OperatorType::derivative && axis != operatorParams.axis)
+          {
+            continue;
+          }
+
+          auto table = detail::spectral::makeWavenumbers(size, length, isReduced);
+
+          if (mType == OperatorType::derivative)
+          {
+            for (auto& k : table)
+            {
+              k = std::pow(k, static_cast<double>(operatorParams.order));
+            }
+
+            // the Nyquist mode has no odd derivative of a real signal
+            if (operatorParams.order % 2 == 1 && size % 2 == 0)
+            {
+              table[size / 2] = 0.0;
+            }
+          }
+          else
+          {
+            for (auto& k : table)
+            {
+              k *= k;
+            }
+          }
+
+          mMultiplier.tables[axis] = std::move(table);
+        }
+
+        const double scale = 1.0 / static_cast<double>(logicalCount);
+
+        switch (mType)
+        {
+        case OperatorType::derivative:
+          // i^p is +-1 or +-i
+          mMultiplier.scale     = (operatorParams.order % 4 >= 2) ? -scale : scale;
+          mMultiplier.isInverse = false;
+          mMultiplier.isRotated = (operatorParams.order % 2 == 1);
+          break;
+        case OperatorType::laplacian:
+          mMultiplier.scale     = -scale;
+          mMultiplier.isInverse = false;
+          mMultiplier.isRotated = false;
+          break;
+        case OperatorType::inverseLaplacian:
+          mMultiplier.scale     = -scale;
+          mMultiplier.isInverse = true;
+          mMultiplier.isRotated = false;
+          break;
+        default:
+          throw std::invalid_argument{"invalid spectral operator type"};
+        }
+      }
+
+#   if defined(AFFT_ENABLE_CUDA)
+      /// @brief Compute the full multiplier on the host by applying it to a spectrum of ones and upload it.
+      void uploadMultiplierTable()
+      {
+        auto upload = [&](auto zero)
+        {
+          using T = decltype(zero);
+
+          std::vector<T> table(2 * mSpectrumCount);
+
+          for (std::size_t i{}; i < mSpectrumCount; ++i)
+          {
+            table[2 * i] = T{1};
+          }
+
+          detail::spectral::apply(table.data(), mMultiplier, 0);
+
+          detail::cuda::checkError(cudaMemcpy(mMultiplierTable.get(),
+                                              table.data(),
+                                              table.size() * sizeof(T),
+                                              cudaMemcpyHostToDevice));
+        };
+
+        if (mPrecision == Precision::f32)
+        {
+          upload(float{});
+        }
+        else
+        {
+          upload(double{});
+        }
+      }
+#   endif
+
+      /// @brief Owning pointer to a spectrum buffer.
+      using SpectrumPtr = std::unique_ptr<void, void(*)(void*)>;
+
+      /**
+       * @brief Allocate a spectrum buffer on the target.
+       * @return Spectrum buffer.
+       */
+      [[nodiscard]] SpectrumPtr allocateSpectrum() const
+      {
+        const std::size_t size = mSpectrumCount * 2 * ((mPrecision == Precision::f32) ? sizeof(float) : sizeof(double));
+
+        switch (mTarget)
+        {
+        case Target::cpu:
+          return SpectrumPtr{::operator new(size, static_cast<std::align_val_t>(cpu::getDefaultAlignment())), [](void* ptr)
+          {
+            ::operator delete(ptr, static_cast<std::align_val_t>(cpu::getDefaultAlignment()));
+          }};
+        case Target::gpu:
+        {
+#       if defined(AFFT_ENABLE_CUDA)
+          void* ptr{};
+
+          detail::cuda::checkError(cudaMalloc(&ptr, size));
+
+          return SpectrumPtr{ptr, [](void* ptr)
+          {
+            cudaFree(ptr);
+          }};
+#       else
+          throw std::runtime_error{"gpu spectral operator requires CUDA"};
+#       endif
+        }
+        default:
+          detail::cxx::unreachable();
+        }
+      }
+
+      OperatorType                   mType{};                            ///< Type of the operator.
+      Target                         mTarget{};                          ///< Target of the plans.
+      Precision                      mPrecision{};                       ///< Precision of the plans.
+      std::size_t                    mThreadLimit{};                     ///< Thread limit of the cpu multiply pass.
+      std::size_t                    mSpectrumCount{};                   ///< Number of complex elements of the spectrum.
+      detail::spectral::Multiplier   mMultiplier{};                      ///< Multiplier of the spectrum.
+      SpectrumPtr                    mSpectrum{nullptr, nullptr};        ///< Intermediate spectrum.
+      SpectrumPtr                    mMultiplierTable{nullptr, nullptr}; ///< Full multiplier on gpu.
+      std::string                    mLoadCallbackSrcCode{};             ///< Source code of the fused multiply callback.
+      std::shared_ptr<Plan>          mForwardPlan{};                     ///< Forward plan.
+      std::shared_ptr<Plan>          mInversePlan{};                     ///< Inverse plan.
+  };
+} // namespace afft::spectral
+
+#endif /* AFFT_SPECTRAL_HPP */
@@ -0,0 +1,365 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_STFT_HPP
+#define AFFT_STFT_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "makePlan.hpp"
+#include "Plan.hpp"
+#include "PreprocessingExecutor.hpp"
+#include "typeTraits.hpp"
+
+AFFT_EXPORT namespace afft::stft
+{
+  /// @brief Layout of the short time Fourier transform output
+  enum class Layout : std::uint8_t
+  {
+    framesBins, ///< frames x bins, the bins of a frame are contiguous
+    binsFrames, ///< bins x frames, the frames of a bin are contiguous, the bins are binStride elements apart
+  };
+
+  /// @brief Parameters of the short time Fourier transform
+  struct Parameters
+  {
+    std::size_t    frameLength{};                 ///< frame length in samples, the transform size
+    std::size_t    hopSize{};                     ///< distance of the frames in samples
+    std::size_t    maxFrameCount{};               ///< frames transformed by one plan execution, 0 selects it from the frame length
+    WindowFunction window{WindowFunction::hann};  ///< window function, ignored if the window table is set
+    double         kaiserBeta{defaultKaiserBeta}; ///< shape parameter of the Kaiser window
+    View<double>   windowTable{};                 ///< user window of the frame length, empty for the window function
+    double         sampleScale{1.0};              ///< scale applied to the samples, e.g. 1 / 32768 for full scale int16 samples
+    Layout         layout{Layout::framesBins};    ///< layout of the output
+    std::size_t    binStride{};                   ///< distance of the bins in elements for Layout::binsFrames, the frame capacity of one push
+    unsigned       threadLimit{};                 ///< thread limit of the transforms, 0 for no limit
+  };
+
+  /**
+   * @class Plan
+   * @brief Short time Fourier transform of an unbounded real signal. The signal is pushed in chunks of any size, each
+   *        push transforms every frame completed by the chunk and keeps the samples of the unfinished frames. Frames
+   *        within the chunk are read in place as overlapping views hopSize samples apart, only the frames spanning
+   *        the previous chunk are staged. The samples are converted and windowed by a cpu::PreprocessingExecutor in
+   *        cache sized blocks right before one batched 1D real-to-complex plan of maxFrameCount frames transforms them.
+   *        Each frame produces frameLength / 2 + 1 bins. Only spst cpu plans are supported. The plan is not thread
+   *        safe.
+   * @tparam T Real type of the transform, float or double.
+   */
+  template<typename T>
+  class Plan
+  {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "stft::Plan supports only float and double");
+
+    public:
+      /// @brief Size of the source transformed by one plan execution when the frame count is selected.
+      static constexpr std::size_t defaultBatchSize{std::size_t{1} << 20};
+
+      /**
+       * @brief Constructor, creates the transform plan.
+       * @tparam BackendParamsT Backend parameters type
+       * @param params Short time Fourier transform parameters
+       * @param backendParams Backend parameters
+       */
+      template<typename BackendParamsT = detail::DefaultBackendParameters>
+      explicit Plan(const Parameters& params, const BackendParamsT& backendParams = {})
+      : mFrameLength{params.frameLength},
+        mHopSize{params.hopSize},
+        mBinCount{params.frameLength / 2 + 1},
+        mLayout{params.layout}
+      {
+        if (mFrameLength == 0 || mHopSize == 0)
+        {
+          throw std::invalid_argument("frame length and hop size must be greater than zero");
+        }
+
+        mMaxFrameCount = params.maxFrameCount;
+
+        if (mMaxFrameCount == 0)
+        {
+          mMaxFrameCount = 1;
+
+          while (mMaxFrameCount * 2 * mFrameLength * sizeof(T) <= defaultBatchSize)
+          {
+            mMaxFrameCount *= 2;
+          }
+        }
+
+        mBinStride = (mLayout == Layout::binsFrames) ? ((params.binStride != 0) ? params.binStride : mMaxFrameCount) : 0;
+
+        if (mLayout == Layout::binsFrames && mBinStride < mMaxFrameCount)
+        {
+          throw std::invalid_argument("bin stride must not be smaller than the maximum frame count");
+        }
+
+        const std::array<std::size_t, 2> shape{mMaxFrameCount, mFrameLength};
+        const std::array<std::size_t, 1> axes{1};
+        const std::array<std::size_t, 2> dstStrides{1, mBinStride};
+
+        dft::Parameters<> transformParams{};
+        transformParams.direction = Direction::forward;
+        transformParams.precision = {typePrecision<T>, typePrecision<T>, typePrecision<T>};
+        transformParams.shape     = shape;
+        transformParams.axes      = axes;
+        transformParams.type      = dft::Type::realToComplex;
+
+        afft::spst::cpu::Parameters<> archParams{};
+        archParams.threadLimit = params.threadLimit;
+
+        if (mLayout == Layout::binsFrames)
+        {
+          archParams.memoryLayout.dstStrides = dstStrides;
+        }
+
+        if constexpr (std::is_same_v<BackendParamsT, detail::DefaultBackendParameters>)
+        {
+          mPlan = makePlan(transformParams, archParams);
+        }
+        else
+        {
+          mPlan = makePlan(transformParams, archParams, backendParams);
+        }
+
+        const auto window = (params.windowTable.empty()) ? makeWindow(params.window, mFrameLength, params.kaiserBeta)
+                                                         : std::vector<double>(params.windowTable.begin(),
+                                                                               params.windowTable.end());
+
+        mExecutor = std::make_unique<cpu::PreprocessingExecutor>(*mPlan,
+                                                                 View<double>{window.data(), window.size()},
+                                                                 params.sampleScale);
+
+        mPending.reserve(mFrameLength + mHopSize);
+        mStage.reserve(2 * mFrameLength + mHopSize);
+      }
+
+      /// @brief Copy constructor is deleted.
+      Plan(const Plan&) = delete;
+
+      /// @brief Move constructor.
+      Plan(Plan&&) = default;
+
+      /// @brief Destructor.
+      ~Plan() = default;
+
+      /// @brief Copy assignment operator is deleted.
+      Plan& operator=(const Plan&) = delete;
+
+      /// @brief Move assignment operator.
+      Plan& operator=(Plan&&) = default;
+
+      /**
+       * @brief Get the frame length.
+       * @return Frame length in samples.
+       */
+      [[nodiscard]] constexpr std::size_t getFrameLength() const noexcept
+      {
+        return mFrameLength;
+      }
+
+      /**
+       * @brief Get the hop size.
+       * @return Hop size in samples.
+       */
+      [[nodiscard]] constexpr std::size_t getHopSize() const noexcept
+      {
+        return mHopSize;
+      }
+
+      /**
+       * @brief Get the number of bins of a frame.
+       * @return Bin count, frameLength / 2 + 1.
+       */
+      [[nodiscard]] constexpr std::size_t getBinCount() const noexcept
+      {
+        return mBinCount;
+      }
+
+      /**
+       * @brief Get the number of frames transformed by one plan execution.
+       * @return Maximum frame count.
+       */
+      [[nodiscard]] constexpr std::size_t getMaxFrameCount() const noexcept
+      {
+        return mMaxFrameCount;
+      }
+
+      /**
+       * @brief Get the number of frames a push of a chunk produces.
+       * @param sampleCount Number of samples of the chunk.
+       * @return Frame count.
+       */
+      [[nodiscard]] constexpr std::size_t getFrameCount(std::size_t sampleCount) const noexcept
+      {
+        const std::size_t total = mPending.size() + (sampleCount - std::min(mSkipCount, sampleCount));
+
+        return (total >= mFrameLength) ? (total - mFrameLength) / mHopSize + 1 : 0;
+      }
+
+      /**
+       * @brief Get the underlying transform plan.
+       * @return The batched real-to-complex plan.
+       */
+      [[nodiscard]] afft::Plan& getPlan() noexcept
+      {
+        return *mPlan;
+      }
+
+      /**
+       * @brief Push a chunk of the signal and transform the frames it completes. The frames are stored from the start
+       *        of the destination in the layout of the plan, for Layout::binsFrames at most binStride frames may be
+       *        produced by one push.
+       * @tparam SampleT Sample type, std::int16_t, std::int32_t, float or double.
+       * @param samples Samples of the chunk.
+       * @param sampleCount Number of samples of the chunk.
+       * @param dst Destination of getFrameCount(sampleCount) frames.
+       * @return Number of frames produced.
+       */
+      template<typename SampleT>
+      std::size_t push(const SampleT* samples, std::size_t sampleCount, std::complex<T>* dst)
+      {
+        if (sampleCount != 0 && samples == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as samples");
+        }
+
+        const std::size_t frameCount = getFrameCount(sampleCount);
+
+        if (frameCount != 0 && dst == nullptr)
+        {
+          throw std::invalid_argument("a null pointer was passed as destination");
+        }
+
+        if (mLayout == Layout::binsFrames && frameCount > mBinStride)
+        {
+          throw std::invalid_argument("push produces more frames than the bin stride holds");
+        }
+
+        // a hop longer than the frame leaves samples before the next frame
+        const std::size_t skipCount = std::min(mSkipCount, sampleCount);
+
+        samples     += skipCount;
+        sampleCount -= skipCount;
+        mSkipCount  -= skipCount;
+
+        const std::size_t pendingCount = mPending.size();
+
+        // frames starting in the pending samples span both chunks, they are staged contiguously
+        const std::size_t stagedCount = std::min(frameCount, (pendingCount + mHopSize - 1) / mHopSize);
+
+        if (stagedCount != 0)
+        {
+          const std::size_t stageSize = (stagedCount - 1) * mHopSize + mFrameLength;
+
+          mStage.assign(mPending.begin(), mPending.end());
+          std::transform(samples, samples + (stageSize - pendingCount), std::back_inserter(mStage), [](SampleT s)
+          {
+            return static_cast<T>(s);
+          });
+
+          transformFrames(mStage.data(), stagedCount, dst, 0);
+        }
+
+        if (frameCount > stagedCount)
+        {
+          transformFrames(samples + (stagedCount * mHopSize - pendingCount), frameCount - stagedCount, dst, stagedCount);
+        }
+
+        // keep the samples from the start of the next frame
+        const std::size_t next = frameCount * mHopSize;
+
+        if (next < pendingCount)
+        {
+          mPending.erase(mPending.begin(), mPending.begin() + next);
+          std::transform(samples, samples + sampleCount, std::back_inserter(mPending), [](SampleT s)
+          {
+            return static_cast<T>(s);
+          });
+        }
+        else
+        {
+          const std::size_t skip = std::min(next - pendingCount, sampleCount);
+
+          mSkipCount += next - pendingCount - skip;
+          mPending.clear();
+          std::transform(samples + skip, samples + sampleCount, std::back_inserter(mPending), [](SampleT s)
+          {
+            return static_cast<T>(s);
+          });
+        }
+
+        return frameCount;
+      }
+
+      /// @brief Drop the pending samples of the unfinished frames, the next push starts a new signal.
+      void reset() noexcept
+      {
+        mPending.clear();
+        mSkipCount = 0;
+      }
+
+    private:
+      /**
+       * @brief Transform frames hopped from contiguous samples in parts of at most the maximum frame count.
+       * @tparam SampleT Sample type.
+       * @param samples Samples of the first frame.
+       * @param frameCount Number of frames.
+       * @param dst Destination of the push.
+       * @param firstFrame Index of the first frame in the destination.
+       */
+      template<typename SampleT>
+      void transformFrames(const SampleT* samples, std::size_t frameCount, std::complex<T>* dst, std::size_t firstFrame)
+      {
+        for (std::size_t done{}; done < frameCount; done += mMaxFrameCount)
+        {
+          const std::size_t count = std::min(mMaxFrameCount, frameCount - done);
+          const std::size_t frame = firstFrame + done;
+
+          afft::spst::cpu::ExecutionParameters execParams{};
+          execParams.batchCount = count;
+
+          mExecutor->execute(samples + done * mHopSize,
+                             mHopSize,
+                             dst + ((mLayout == Layout::framesBins) ? frame * mBinCount : frame),
+                             execParams);
+        }
+      }
+
+      std::size_t                                 mFrameLength{};   ///< Frame length in samples.
+      std::size_t                                 mHopSize{};       ///< Distance of the frames in samples.
+      std::size_t                                 mBinCount{};      ///< Number of bins of a frame.
+      Layout                                      mLayout{};        ///< Layout of the output.
+      std::size_t                                 mMaxFrameCount{}; ///< Frames transformed by one plan execution.
+      std::size_t                                 mBinStride{};     ///< Distance of the bins for Layout::binsFrames.
+      std::unique_ptr<afft::Plan>                 mPlan{};          ///< Batched real-to-complex plan.
+      std::unique_ptr<cpu::PreprocessingExecutor> mExecutor{};      ///< Converting and windowing executor of the plan.
+      std::vector<T>                              mPending{};       ///< Samples of the unfinished frames.
+      std::vector<T>                              mStage{};         ///< Frames spanning the previous chunk.
+      std::size_t                                 mSkipCount{};     ///< Samples to skip before the next frame.
+  };
+} // namespace afft::stft
+
+#endif /* AFFT_STFT_HPP */
@@ -0,0 +1,250 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_TRACE_HPP
+#define AFFT_TRACE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "backend.hpp"
+
+AFFT_EXPORT namespace afft::trace
+{
+  /// @brief Type of the traced event.
+  enum class EventType : std::uint8_t
+  {
+    backendAccepted,   ///< A backend created a plan, the time is the planning time of the backend.
+    backendRejected,   ///< A backend failed to create a plan, the message says why.
+    planCreated,       ///< A plan was created, the time is the total planning time including the fallbacks.
+    autotuneCandidate, ///< A candidate plan of the best strategy was measured, the time is its execution time.
+    cacheHit,          ///< A plan cache lookup found the plan.
+    cacheMiss,         ///< A plan cache lookup did not find the plan.
+    cacheEvict,        ///< A plan was evicted from a plan cache or not cached at all because a limit was exceeded.
+    workspaceAlloc,    ///< A workspace was allocated, the size is its size in bytes.
+    rtcCompile,        ///< A gpu code was compiled at runtime, the time is the compilation time.
+    planWarmup,        ///< A plan was warmed up, the time is the time of the warmup execution.
+    cacheHibernate,    ///< A cached plan was hibernated, the size is the released memory size in bytes.
+    cacheRehydrate,    ///< A hibernated plan was recreated, the time is the planning time, the size is its memory size.
+  };
+
+  /// @brief Traced event. The referenced strings are valid only during the Sink::onEvent() call.
+  struct Event
+  {
+    EventType                     type{};    ///< Event type.
+    std::optional<Backend>        backend{}; ///< Backend the event relates to, if any.
+    std::string_view              message{}; ///< Reason of the rejection or the name of the traced object.
+    std::chrono::duration<double> time{};    ///< Measured time, zero if not applicable.
+    std::size_t                   size{};    ///< Size in bytes, zero if not applicable.
+  };
+
+  /**
+   * @class Sink
+   * @brief Interface receiving the traced events, e.g. to forward them to a monitoring system. The events are delivered
+   *        synchronously from the thread doing the work, possibly from several threads at once and with the locks of a
+   *        plan cache held, so the implementation must be thread safe, should be fast and must not call back into afft.
+   *        Exceptions thrown by the sink are ignored.
+   */
+  class Sink
+  {
+    public:
+      /// @brief Destructor.
+      virtual ~Sink() = default;
+
+      /**
+       * @brief Receive the event.
+       * @param event The event.
+       */
+      virtual void onEvent(const Event& event) = 0;
+  };
+
+  /**
+   * @brief Converts an EventType to a string.
+   * @param type Event type.
+   * @return String representation of the event type.
+   */
+  [[nodiscard]] constexpr std::string_view toString(EventType type) noexcept
+  {
+    switch (type)
+    {
+    case EventType::backendAccepted:
+      return "backendAccepted";
+    case EventType::backendRejected:
+      return "backendRejected";
+    case EventType::planCreated:
+      return "planCreated";
+    case EventType::autotuneCandidate:
+      return "autotuneCandidate";
+    case EventType::cacheHit:
+      return "cacheHit";
+    case EventType::cacheMiss:
+      return "cacheMiss";
+    case EventType::cacheEvict:
+      return "cacheEvict";
+    case EventType::workspaceAlloc:
+      return "workspaceAlloc";
+    case EventType::rtcCompile:
+      return "rtcCompile";
+    case EventType::planWarmup:
+      return "planWarmup";
+    case EventType::cacheHibernate:
+      return "cacheHibernate";
+    case EventType::cacheRehydrate:
+      return "cacheRehydrate";
+    default:
+      return "<invalid event type>";
+    }
+  }
+} // namespace afft::trace
+
+namespace afft::detail::trace
+{
+  /**
+   * @brief Get the mutex guarding the installed trace sink.
+   * @return The mutex.
+   */
+  [[nodiscard]] inline std::mutex& getSinkMutex()
+  {
+    static std::mutex mutex{};
+
+    return mutex;
+  }
+
+  /**
+   * @brief Get the installed trace sink.
+   * @return The installed trace sink, null if none.
+   */
+  [[nodiscard]] inline std::shared_ptr<afft::trace::Sink>& getSinkStorage()
+  {
+    static std::shared_ptr<afft::trace::Sink> sink{};
+
+    return sink;
+  }
+
+  /**
+   * @brief Get the flag telling whether a trace sink is installed, read without locking the mutex.
+   * @return The flag.
+   */
+  [[nodiscard]] inline std::atomic<bool>& getHasSink()
+  {
+    static std::atomic<bool> hasSink{};
+
+    return hasSink;
+  }
+
+  /**
+   * @brief Check whether the events should be made, cheap if no trace sink is installed.
+   * @return True if a trace sink is installed.
+   */
+  [[nodiscard]] inline bool isEnabled() noexcept
+  {
+    return getHasSink().load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Deliver the event to the installed trace sink, if any.
+   * @param event The event.
+   */
+  inline void emit(const afft::trace::Event& event) noexcept
+  {
+    if (!isEnabled())
+    {
+      return;
+    }
+
+    std::shared_ptr<afft::trace::Sink> sink{};
+
+    {
+      std::lock_guard lock{getSinkMutex()};
+
+      sink = getSinkStorage();
+    }
+
+    if (sink)
+    {
+      try
+      {
+        sink->onEvent(event);
+      }
+      catch (...)
+      {
+        // A failing sink must not break the traced operation
+      }
+    }
+  }
+
+  /**
+   * @brief Deliver the event to the installed trace sink, if any.
+   * @param type Event type.
+   * @param backend Backend the event relates to, if any.
+   * @param message Message.
+   * @param time Measured time.
+   * @param size Size in bytes.
+   */
+  inline void emit(afft::trace::EventType        type,
+                   std::optional<Backend>        backend,
+                   std::string_view              message = {},
+                   std::chrono::duration<double> time    = {},
+                   std::size_t                   size    = {}) noexcept
+  {
+    if (isEnabled())
+    {
+      emit(afft::trace::Event{type, backend, message, time, size});
+    }
+  }
+} // namespace afft::detail::trace
+
+AFFT_EXPORT namespace afft::trace
+{
+  /**
+   * @brief Get the installed trace sink.
+   * @return The trace sink, null if none is installed.
+   */
+  [[nodiscard]] inline std::shared_ptr<Sink> getSink()
+  {
+    std::lock_guard lock{detail::trace::getSinkMutex()};
+
+    return detail::trace::getSinkStorage();
+  }
+
+  /**
+   * @brief Install the trace sink receiving the events of all plans and plan caches. The events in flight on other
+   *        threads may still be delivered to the previous sink.
+   * @param sink The trace sink, null to stop tracing.
+   * @return The previously installed trace sink.
+   */
+  inline std::shared_ptr<Sink> setSink(std::shared_ptr<Sink> sink)
+  {
+    std::lock_guard lock{detail::trace::getSinkMutex()};
+
+    auto& storage = detail::trace::getSinkStorage();
+
+    detail::trace::getHasSink().store(sink != nullptr, std::memory_order_relaxed);
+
+    return std::exchange(storage, std::move(sink));
+  }
+} // namespace afft::trace
+
+#endif /* AFFT_TRACE_HPP */
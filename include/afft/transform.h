@@ -57,15 +57,18 @@ enum
 /// @brief DFT parameters enumeration
 typedef struct
 {
-  afft_Direction      direction;     ///< Direction of the transform
-  afft_PrecisionTriad precision;     ///< Precision triad
-  size_t              shapeRank;     ///< Rank of the shape
-  const size_t*       shape;         ///< Shape of the transform
-  size_t              axesRank;      ///< Rank of the axes
-  const size_t*       axes;          ///< Axes of the transform
-  afft_Normalization  normalization; ///< Normalization
-  afft_Placement      placement;     ///< Placement of the transform
-  afft_dft_Type       type;          ///< Type of the transform
+  afft_Direction      direction;       ///< Direction of the transform
+  afft_PrecisionTriad precision;       ///< Precision triad
+  size_t              shapeRank;       ///< Rank of the shape
+  const size_t*       shape;           ///< Shape of the transform
+  size_t              axesRank;        ///< Rank of the axes
+  const size_t*       axes;            ///< Axes of the transform
+  afft_Normalization  normalization;   ///< Normalization
+  afft_Placement      placement;       ///< Placement of the transform
+  afft_dft_Type       type;            ///< Type of the transform
+  const size_t*       logicalSrcShape; ///< Logical shape of the source of shapeRank elements, NULL for the full shape
+  const size_t*       dstWindowStart;  ///< Start of the destination window of shapeRank elements, NULL for zeros
+  const size_t*       dstWindowShape;  ///< Shape of the destination window of shapeRank elements, NULL for the full one
 } afft_dft_Parameters;
 
 /**********************************************************************************************************************/
@@ -77,7 +80,8 @@ typedef uint8_t afft_dht_Type;
 /// @brief DHT transform enumeration
 enum
 {
-  afft_dht_Type_separable, ///< Separable DHT, computes the DHT along each axis independently
+  afft_dht_Type_separable,    ///< Separable DHT, computes the DHT along each axis independently
+  afft_dht_Type_nonSeparable, ///< Non-separable DHT, the real minus the imaginary part of the multidimensional DFT
 };
 
 /// @brief DHT parameters structure
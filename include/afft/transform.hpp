@@ -38,6 +38,11 @@ AFFT_EXPORT namespace afft
   template<std::size_t transformExt = dynamicRank>
   inline constexpr View<std::size_t, transformExt> allAxes{};
 
+  namespace dtt
+  {
+    enum class Type : std::uint8_t;
+  } // namespace dtt
+
   /// @brief Namespace for discrete Fourier transform
   namespace dft
   {
@@ -73,6 +78,14 @@ AFFT_EXPORT namespace afft
       Normalization                   normalization{Normalization::none}; ///< normalization
       Placement                       placement{Placement::outOfPlace};   ///< placement of the transform
       Type                            type{Type::complexToComplex};       ///< type of the transform
+      View<std::size_t, shapeExt>     logicalSrcShape{};                  ///< logical source shape zero-padded to the shape, empty for the full shape
+      View<std::size_t, shapeExt>     dstWindowStart{};                   ///< start of the destination window, empty for zeros
+      View<std::size_t, shapeExt>     dstWindowShape{};                   ///< shape of the destination window, empty for the full destination
+      bool                            fullSpectrum{};                     ///< store the full Hermitian spectrum of a real-to-complex transform, the last axis is not reduced
+      View<std::size_t>               srcShiftAxes{};                     ///< axes along which the source is stored centered (ifftshift applied before the transform)
+      View<std::size_t>               dstShiftAxes{};                     ///< axes along which the destination is stored centered (fftshift applied after the transform)
+      View<std::size_t>               dttAxes{};                          ///< axes transformed by the DTT instead of the DFT, excluded from all axes, spst cpu only
+      View<dtt::Type>                 dttTypes{};                         ///< DTT types of the dttAxes, must have size 1 or size equal to the number of dttAxes
     };
   } // namespace dft
 
@@ -82,7 +95,8 @@ AFFT_EXPORT namespace afft
     /// @brief DHT transform type
     enum class Type : std::uint8_t
     {
-      separable, ///< separable DHT, computes the DHT along each axis independently
+      separable,    ///< separable DHT, computes the DHT along each axis independently
+      nonSeparable, ///< non-separable DHT, the real minus the imaginary part of the multidimensional DFT
     };
 
     /**
@@ -0,0 +1,179 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#ifndef AFFT_TRANSPOSE_HPP
+#define AFFT_TRANSPOSE_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "common.hpp"
+#include "utils.hpp"
+#include "detail/transpose.hpp"
+
+AFFT_EXPORT namespace afft
+{
+  /**
+   * @brief Permute the axes of a strided cpu array. The destination axis i is the source axis perm[i], so the element
+   *        of the source index (j[0], ..., j[rank - 1]) is stored at the destination index (j[perm[0]], ...,
+   *        j[perm[rank - 1]]). The copy is cache blocked and vectorized if the innermost source and destination axes
+   *        differ, the same kernel is used by the plans of transposed layouts.
+   * @param src Source buffer.
+   * @param dst Destination buffer, must not overlap the source.
+   * @param shape Source shape.
+   * @param srcStrides Source strides in elements, empty for the row-major strides of the source shape.
+   * @param dstStrides Destination strides in elements, empty for the row-major strides of the permuted shape.
+   * @param perm Permutation of the axes.
+   * @param elemSize Size of the element in bytes, 2, 4, 8, 16 or 32.
+   * @param threadLimit Maximum number of threads, 0 for no limit.
+   */
+  inline void transpose(const void*       src,
+                        void*             dst,
+                        View<std::size_t> shape,
+                        View<std::size_t> srcStrides,
+                        View<std::size_t> dstStrides,
+                        View<std::size_t> perm,
+                        std::size_t       elemSize,
+                        unsigned          threadLimit = {})
+  {
+    const std::size_t rank = shape.size();
+
+    if (rank == 0 || rank > maxDimCount)
+    {
+      throw std::invalid_argument{"transpose rank must be between 1 and maxDimCount"};
+    }
+
+    if (perm.size() != rank)
+    {
+      throw std::invalid_argument{"transpose permutation must have the rank of the shape"};
+    }
+
+    if (!srcStrides.empty() && srcStrides.size() != rank)
+    {
+      throw std::invalid_argument{"transpose source strides must have the rank of the shape"};
+    }
+
+    if (!dstStrides.empty() && dstStrides.size() != rank)
+    {
+      throw std::invalid_argument{"transpose destination strides must have the rank of the shape"};
+    }
+
+    if (!detail::transpose::isSupportedElemSize(elemSize))
+    {
+      throw std::invalid_argument{"transpose supports only element sizes of 2, 4, 8, 16 and 32 bytes"};
+    }
+
+    std::bitset<maxDimCount> seenAxes{};
+
+    for (const auto axis : perm)
+    {
+      if (axis >= rank || seenAxes.test(axis))
+      {
+        throw std::invalid_argument{"transpose permutation must contain each axis exactly once"};
+      }
+
+      seenAxes.set(axis);
+    }
+
+    if (src == nullptr || dst == nullptr)
+    {
+      throw std::invalid_argument{"transpose buffers must not be null"};
+    }
+
+    detail::MaxDimArray<std::size_t> dstShape{};
+
+    for (std::size_t i{}; i < rank; ++i)
+    {
+      dstShape[i] = shape[perm[i]];
+    }
+
+    detail::MaxDimArray<std::size_t> defaultSrcStrides{};
+    detail::MaxDimArray<std::size_t> defaultDstStrides{};
+
+    if (srcStrides.empty())
+    {
+      makeStrides(shape, Span<std::size_t>{defaultSrcStrides.data(), rank});
+      srcStrides = View<std::size_t>{defaultSrcStrides.data(), rank};
+    }
+
+    if (dstStrides.empty())
+    {
+      makeStrides(View<std::size_t>{dstShape.data(), rank}, Span<std::size_t>{defaultDstStrides.data(), rank});
+      dstStrides = View<std::size_t>{defaultDstStrides.data(), rank};
+    }
+
+    // the destination strides along the source axes
+    detail::MaxDimArray<std::size_t> permDstStrides{};
+
+    for (std::size_t i{}; i < rank; ++i)
+    {
+      permDstStrides[perm[i]] = dstStrides[i];
+    }
+
+    detail::transpose::copy(src,
+                            srcStrides,
+                            dst,
+                            View<std::size_t>{permDstStrides.data(), rank},
+                            shape,
+                            elemSize,
+                            threadLimit);
+  }
+
+  /**
+   * @brief Permute the axes of a strided cpu array of elements of the type, see transpose() above.
+   * @tparam T Element type, its size must be 2, 4, 8, 16 or 32 bytes.
+   * @param src Source buffer.
+   * @param dst Destination buffer, must not overlap the source.
+   * @param shape Source shape.
+   * @param srcStrides Source strides in elements, empty for the row-major strides of the source shape.
+   * @param dstStrides Destination strides in elements, empty for the row-major strides of the permuted shape.
+   * @param perm Permutation of the axes.
+   * @param threadLimit Maximum number of threads, 0 for no limit.
+   */
+  template<typename T>
+  void transpose(const T*          src,
+                 T*                dst,
+                 View<std::size_t> shape,
+                 View<std::size_t> srcStrides,
+                 View<std::size_t> dstStrides,
+                 View<std::size_t> perm,
+                 unsigned          threadLimit = {})
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "transpose requires a trivially copyable element type");
+    static_assert(detail::transpose::isSupportedElemSize(sizeof(T)), "transpose does not support the element size");
+
+    transpose(static_cast<const void*>(src),
+              static_cast<void*>(dst),
+              shape,
+              srcStrides,
+              dstStrides,
+              perm,
+              sizeof(T),
+              threadLimit);
+  }
+} // namespace afft
+
+#endif /* AFFT_TRANSPOSE_HPP */
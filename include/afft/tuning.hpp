@@ -0,0 +1,426 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef AFFT_TUNING_HPP
+#define AFFT_TUNING_HPP
+
+#ifndef AFFT_TOP_LEVEL_INCLUDE
+# include "detail/include.hpp"
+#endif
+
+#include "backend.hpp"
+#include "version.hpp"
+#include "detail/utils.hpp"
+#include "detail/validate.hpp"
+
+AFFT_EXPORT namespace afft::tuning
+{
+  /// @brief Result of the backend autotuning for a single transform.
+  struct Record
+  {
+    Backend                       backend{};      ///< Winning backend
+    std::chrono::duration<double> measuredTime{}; ///< Measured execution time of the winning backend
+  };
+
+  /**
+   * @brief Get the default hardware fingerprint. It consists of the afft version, enabled backends, number of hardware
+   *        threads and the CPU model name (only on Linux).
+   * @return Hardware fingerprint.
+   */
+  [[nodiscard]] inline std::string getDefaultFingerprint()
+  {
+    std::string cpuModel{};
+
+# ifdef __linux__
+    {
+      std::ifstream cpuInfo{"/proc/cpuinfo"};
+      std::string   line{};
+
+      while (std::getline(cpuInfo, line))
+      {
+        if (line.rfind("model name", 0) == 0)
+        {
+          if (const auto pos = line.find(':'); pos != std::string::npos)
+          {
+            cpuModel = line.substr(line.find_first_not_of(' ', pos + 1));
+          }
+          break;
+        }
+      }
+    }
+# endif
+
+    std::string backends{};
+
+    [[maybe_unused]] auto appendBackend = [&](Backend backend)
+    {
+      backends += (backends.empty()) ? "" : ",";
+      backends += toString(backend);
+    };
+
+# ifdef AFFT_ENABLE_CLFFT
+    appendBackend(Backend::clfft);
+# endif
+# ifdef AFFT_ENABLE_CUFFT
+    appendBackend(Backend::cufft);
+# endif
+# ifdef AFFT_ENABLE_FFTW3
+    appendBackend(Backend::fftw3);
+# endif
+# ifdef AFFT_ENABLE_HEFFTE
+    appendBackend(Backend::heffte);
+# endif
+# ifdef AFFT_ENABLE_HIPFFT
+    appendBackend(Backend::hipfft);
+# endif
+# ifdef AFFT_ENABLE_MKL
+    appendBackend(Backend::mkl);
+# endif
+# ifdef AFFT_ENABLE_POCKETFFT
+    appendBackend(Backend::pocketfft);
+# endif
+# ifdef AFFT_ENABLE_ROCFFT
+    appendBackend(Backend::rocfft);
+# endif
+# ifdef AFFT_ENABLE_VKFFT
+    appendBackend(Backend::vkfft);
+# endif
+# ifdef AFFT_ENABLE_CODELET
+    appendBackend(Backend::codelet);
+# endif
+
+    return detail::cformat("afft=%s;backends=%s;threads=%u;cpu=%s",
+                           toString(getVersion()).c_str(),
+                           backends.c_str(),
+                           std::thread::hardware_concurrency(),
+                           cpuModel.c_str());
+  }
+
+  /**
+   * @class Database
+   * @brief Persistent storage of the autotuning results. Records are keyed by the transform description and
+   *        the hardware fingerprint, so a database file may be shared by different machines. The database is
+   *        thread-safe, plans may be tuned concurrently against the same database.
+   */
+  class Database
+  {
+    public:
+      /// @brief Default constructor. Uses the default hardware fingerprint.
+      Database()
+      : mFingerprint{getDefaultFingerprint()}
+      {}
+
+      /**
+       * @brief Constructor.
+       * @param fingerprint Hardware fingerprint.
+       */
+      explicit Database(std::string fingerprint)
+      : mFingerprint{std::move(fingerprint)}
+      {
+        if (mFingerprint.find_first_of("\t\n") != std::string::npos)
+        {
+          throw std::invalid_argument{"tuning database fingerprint must not contain tabs or newlines"};
+        }
+      }
+
+      /// @brief Copy constructor.
+      Database(const Database& other)
+      {
+        std::lock_guard lock{other.mMutex};
+
+        mFingerprint  = other.mFingerprint;
+        mRecords      = other.mRecords;
+        mForeignLines = other.mForeignLines;
+      }
+
+      /// @brief Move constructor.
+      Database(Database&& other)
+      {
+        std::lock_guard lock{other.mMutex};
+
+        mFingerprint  = std::move(other.mFingerprint);
+        mRecords      = std::move(other.mRecords);
+        mForeignLines = std::move(other.mForeignLines);
+      }
+
+      /// @brief Destructor.
+      ~Database() = default;
+
+      /// @brief Copy assignment operator.
+      Database& operator=(const Database& other)
+      {
+        if (this != &other)
+        {
+          std::scoped_lock lock{mMutex, other.mMutex};
+
+          mFingerprint  = other.mFingerprint;
+          mRecords      = other.mRecords;
+          mForeignLines = other.mForeignLines;
+        }
+
+        return *this;
+      }
+
+      /// @brief Move assignment operator.
+      Database& operator=(Database&& other)
+      {
+        if (this != &other)
+        {
+          std::scoped_lock lock{mMutex, other.mMutex};
+
+          mFingerprint  = std::move(other.mFingerprint);
+          mRecords      = std::move(other.mRecords);
+          mForeignLines = std::move(other.mForeignLines);
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Get the hardware fingerprint.
+       * @return Hardware fingerprint.
+       */
+      [[nodiscard]] const std::string& getFingerprint() const noexcept
+      {
+        return mFingerprint;
+      }
+
+      /**
+       * @brief Find a record.
+       * @param key Transform key.
+       * @return Record if found, std::nullopt otherwise.
+       */
+      [[nodiscard]] std::optional<Record> find(const std::string& key) const
+      {
+        std::lock_guard lock{mMutex};
+
+        if (auto it = mRecords.find(key); it != mRecords.end())
+        {
+          return it->second;
+        }
+
+        return std::nullopt;
+      }
+
+      /**
+       * @brief Insert or replace a record.
+       * @param key Transform key.
+       * @param record Record.
+       */
+      void insert(std::string key, const Record& record)
+      {
+        std::lock_guard lock{mMutex};
+        mRecords.insert_or_assign(std::move(key), record);
+      }
+
+      /**
+       * @brief Erase a record.
+       * @param key Transform key.
+       */
+      void erase(const std::string& key)
+      {
+        std::lock_guard lock{mMutex};
+        mRecords.erase(key);
+      }
+
+      /// @brief Remove all records of the current fingerprint.
+      void clear()
+      {
+        std::lock_guard lock{mMutex};
+        mRecords.clear();
+      }
+
+      /**
+       * @brief Get the number of records of the current fingerprint.
+       * @return Number of records.
+       */
+      [[nodiscard]] std::size_t size() const
+      {
+        std::lock_guard lock{mMutex};
+        return mRecords.size();
+      }
+
+      /**
+       * @brief Check if there are no records of the current fingerprint.
+       * @return True if empty, false otherwise.
+       */
+      [[nodiscard]] bool empty() const
+      {
+        std::lock_guard lock{mMutex};
+        return mRecords.empty();
+      }
+
+      /**
+       * @brief Load records from a file. Records of the current fingerprint are merged into the database, records of
+       *        other fingerprints replace the previously loaded ones and are written back on save. A missing file
+       *        is not an error. A malformed record, e.g. with an unknown backend, throws std::runtime_error
+       *        naming its line.
+       * @param path Path to the file.
+       */
+      void load(const std::string& path)
+      {
+        std::ifstream file{path};
+
+        if (!file.is_open())
+        {
+          return;
+        }
+
+        std::string line{};
+        std::size_t lineNumber{1};
+
+        std::lock_guard lock{mMutex};
+
+        mForeignLines.clear();
+
+        if (!std::getline(file, line) || line != header)
+        {
+          throw std::runtime_error{"invalid tuning database file"};
+        }
+
+        auto throwInvalidRecord = [&](std::string_view reason)
+        {
+          throw std::runtime_error{"invalid tuning database record on line " + std::to_string(lineNumber) + " of "
+                                   + path + ": " + std::string{reason}};
+        };
+
+        while (std::getline(file, line))
+        {
+          ++lineNumber;
+
+          if (line.empty())
+          {
+            continue;
+          }
+
+          const auto fingerprintEnd = line.find('\t');
+          const auto keyEnd         = line.find('\t', fingerprintEnd + 1);
+          const auto backendEnd     = line.find('\t', keyEnd + 1);
+
+          if (fingerprintEnd == std::string::npos || keyEnd == std::string::npos || backendEnd == std::string::npos)
+          {
+            throwInvalidRecord("missing field");
+          }
+
+          if (line.compare(0, fingerprintEnd, mFingerprint) != 0 || fingerprintEnd != mFingerprint.size())
+          {
+            mForeignLines.push_back(std::move(line));
+            continue;
+          }
+
+          const auto backendField = line.substr(keyEnd + 1, backendEnd - keyEnd - 1);
+          const auto timeField    = line.substr(backendEnd + 1);
+
+          unsigned long backendValue{};
+          double        measuredTime{};
+
+          try
+          {
+            std::size_t backendPos{};
+            std::size_t timePos{};
+
+            backendValue = std::stoul(backendField, &backendPos);
+            measuredTime = std::stod(timeField, &timePos);
+
+            if (backendPos != backendField.size() || timePos != timeField.size())
+            {
+              throwInvalidRecord("trailing characters in a numeric field");
+            }
+          }
+          catch (const std::invalid_argument&)
+          {
+            throwInvalidRecord("malformed numeric field");
+          }
+          catch (const std::out_of_range&)
+          {
+            throwInvalidRecord("numeric field out of range");
+          }
+
+          if (backendValue > std::numeric_limits<std::underlying_type_t<Backend>>::max()
+              || !detail::isValid(static_cast<Backend>(backendValue)))
+          {
+            throwInvalidRecord("unknown backend " + backendField);
+          }
+
+          if (!std::isfinite(measuredTime) || measuredTime < 0.0)
+          {
+            throwInvalidRecord("invalid measured time " + timeField);
+          }
+
+          Record record{};
+          record.backend      = static_cast<Backend>(backendValue);
+          record.measuredTime = std::chrono::duration<double>{measuredTime};
+
+          mRecords.insert_or_assign(line.substr(fingerprintEnd + 1, keyEnd - fingerprintEnd - 1), record);
+        }
+      }
+
+      /**
+       * @brief Save records to a file.
+       * @param path Path to the file.
+       */
+      void save(const std::string& path) const
+      {
+        std::ofstream file{path, std::ios::trunc};
+
+        if (!file.is_open())
+        {
+          throw std::runtime_error{"failed to open tuning database file for writing"};
+        }
+
+        std::lock_guard lock{mMutex};
+
+        file << header << '\n';
+
+        for (const auto& line : mForeignLines)
+        {
+          file << line << '\n';
+        }
+
+        for (const auto& [key, record] : mRecords)
+        {
+          file << detail::cformat("%s\t%s\t%u\t%.9e\n",
+                                  mFingerprint.c_str(),
+                                  key.c_str(),
+                                  static_cast<unsigned>(detail::cxx::to_underlying(record.backend)),
+                                  record.measuredTime.count());
+        }
+
+        if (!file)
+        {
+          throw std::runtime_error{"failed to write tuning database file"};
+        }
+      }
+    private:
+      /// @brief File header, identifies the file format version.
+      static constexpr std::string_view header{"afft-tuning-database 1"};
+
+      mutable std::mutex                      mMutex{};        ///< Guards the records
+      std::string                             mFingerprint{};  ///< Hardware fingerprint
+      std::unordered_map<std::string, Record> mRecords{};      ///< Records of the current fingerprint
+      std::vector<std::string>                mForeignLines{}; ///< Raw records of other fingerprints
+  };
+} // namespace afft::tuning
+
+#endif /* AFFT_TUNING_HPP */
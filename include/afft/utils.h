@@ -29,6 +29,7 @@
 # include "detail/include.h"
 #endif
 
+#include "backend.h"
 #include "common.h"
 #include "error.h"
 
@@ -90,6 +91,31 @@ afft_Error afft_makeTransposedStrides(const size_t  shapeRank,
                                       const size_t  fastestAxisStride,
                                       size_t*       strides);
 
+/**
+ * @brief Get the smallest size greater than or equal to the size all the backends in the mask transform by their own
+ *        kernels.
+ * @param size Size, must not be zero.
+ * @param backendMask Backend mask, must not be empty. A single backend may be passed as its mask.
+ * @param fastSize Fast size.
+ * @return Error code.
+ */
+afft_Error afft_nextFastSize(const size_t           size,
+                             const afft_BackendMask backendMask,
+                             size_t*                fastSize);
+
+/**
+ * @brief Make the shape with every extent padded to the next fast size of all the backends in the mask.
+ * @param shapeRank Rank of the shape.
+ * @param shape Shape of the transformed extents.
+ * @param backendMask Backend mask, must not be empty.
+ * @param fastShape Fast shape.
+ * @return Error code.
+ */
+afft_Error afft_fastShape(const size_t           shapeRank,
+                          const size_t*          shape,
+                          const afft_BackendMask backendMask,
+                          size_t*                fastShape);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,9 +29,176 @@
 # include "detail/include.hpp"
 #endif
 
+#include "backend.hpp"
 #include "common.hpp"
 #include "detail/utils.hpp"
 
+namespace afft::detail
+{
+  /**
+   * @brief Lengths a backend transforms by its own kernels, 2^a 3^b 5^c 7^d 11^e 13^f with the odd radices limited to
+   *        oddRadices and e + f limited to maxRareFactorCount.
+   */
+  struct FastSizeRule
+  {
+    std::array<bool, 5> oddRadices{};         ///< Native radices 3, 5, 7, 11 and 13
+    std::size_t         maxRareFactorCount{}; ///< Maximum number of the factors 11 and 13
+  };
+
+  /// @brief Odd radices of the FastSizeRule.
+  inline constexpr std::array<std::size_t, 5> fastSizeOddRadices{3, 5, 7, 11, 13};
+
+  /**
+   * @brief Get the fast size rule of the backend.
+   * @param backend Backend.
+   * @return Fast size rule.
+   */
+  [[nodiscard]] constexpr FastSizeRule getFastSizeRule(Backend backend)
+  {
+    constexpr auto unlimited = std::numeric_limits<std::size_t>::max();
+
+    switch (backend)
+    {
+    case Backend::clfft:
+    case Backend::cufft:
+    case Backend::heffte:
+    case Backend::codelet:
+      return FastSizeRule{{true, true, true, false, false}, 0};
+    case Backend::fftw3:
+      // FFTW3 is fast on 2^a 3^b 5^c 7^d 11^e 13^f, e + f <= 1
+      return FastSizeRule{{true, true, true, true, true}, 1};
+    case Backend::pocketfft:
+      return FastSizeRule{{true, true, true, true, false}, unlimited};
+    case Backend::hipfft:
+    case Backend::mkl:
+    case Backend::rocfft:
+    case Backend::vkfft:
+      return FastSizeRule{{true, true, true, true, true}, unlimited};
+    default:
+      throw std::invalid_argument("invalid backend");
+    }
+  }
+
+  /**
+   * @brief Get the fast size rule shared by all the backends in the mask.
+   * @param backendMask Backend mask, must not be empty.
+   * @return Fast size rule.
+   */
+  [[nodiscard]] constexpr FastSizeRule getFastSizeRule(BackendMask backendMask)
+  {
+    FastSizeRule rule{{true, true, true, true, true}, std::numeric_limits<std::size_t>::max()};
+    bool         isEmpty{true};
+
+    for (std::size_t i{}; i < backendCount; ++i)
+    {
+      const Backend backend = static_cast<Backend>(std::underlying_type_t<Backend>(1) << i);
+
+      if ((backendMask & backend) != BackendMask::empty)
+      {
+        const auto backendRule = getFastSizeRule(backend);
+
+        for (std::size_t j{}; j < rule.oddRadices.size(); ++j)
+        {
+          rule.oddRadices[j] = rule.oddRadices[j] && backendRule.oddRadices[j];
+        }
+
+        rule.maxRareFactorCount = std::min(rule.maxRareFactorCount, backendRule.maxRareFactorCount);
+        isEmpty                 = false;
+      }
+    }
+
+    if (isEmpty)
+    {
+      throw std::invalid_argument("backend mask must not be empty");
+    }
+
+    return rule;
+  }
+
+  /**
+   * @brief Get the smallest fast size greater than or equal to the size. The odd parts are enumerated, each completed
+   *        by the smallest sufficient power of two.
+   * @param size Size, must not be zero.
+   * @param rule Fast size rule.
+   * @return Fast size.
+   */
+  [[nodiscard]] constexpr std::size_t nextFastSize(std::size_t size, const FastSizeRule& rule)
+  {
+    if (size == 0)
+    {
+      throw std::invalid_argument("size must not be zero");
+    }
+
+    auto completeByPowerOfTwo = [size](std::size_t oddPart)
+    {
+      std::size_t result{oddPart};
+
+      while (result < size)
+      {
+        if (result > std::numeric_limits<std::size_t>::max() / 2)
+        {
+          return std::numeric_limits<std::size_t>::max();
+        }
+
+        result *= 2;
+      }
+
+      return result;
+    };
+
+    std::size_t best = completeByPowerOfTwo(1);
+
+    if (best == std::numeric_limits<std::size_t>::max())
+    {
+      throw std::invalid_argument("size is too large");
+    }
+
+    // Depth first search over the odd parts in non-decreasing radix order, the stack holds the radix index not yet
+    // tried for each factor of the odd part
+    struct Frame
+    {
+      std::size_t oddPart;
+      std::size_t radixIndex;
+      std::size_t rareFactorCount;
+    };
+
+    std::array<Frame, std::numeric_limits<std::size_t>::digits> stack{};
+    std::size_t                                                  stackSize{};
+
+    stack[stackSize++] = Frame{1, 0, 0};
+
+    while (stackSize > 0)
+    {
+      auto& frame = stack[stackSize - 1];
+
+      if (frame.radixIndex >= fastSizeOddRadices.size())
+      {
+        --stackSize;
+        continue;
+      }
+
+      const std::size_t radixIndex = frame.radixIndex++;
+      const std::size_t radix      = fastSizeOddRadices[radixIndex];
+      const bool        isRare     = (radix > 7);
+
+      if (!rule.oddRadices[radixIndex] ||
+          (isRare && frame.rareFactorCount >= rule.maxRareFactorCount) ||
+          frame.oddPart > (best - 1) / radix)
+      {
+        continue;
+      }
+
+      const Frame next{frame.oddPart * radix, radixIndex, frame.rareFactorCount + ((isRare) ? 1 : 0)};
+
+      best = std::min(best, completeByPowerOfTwo(next.oddPart));
+
+      stack[stackSize++] = next;
+    }
+
+    return best;
+  }
+} // namespace afft::detail
+
 AFFT_EXPORT namespace afft
 {
   /**
@@ -322,6 +489,111 @@ AFFT_EXPORT namespace afft
 
     return strides;
   }
+
+  /**
+   * @brief Get the smallest size greater than or equal to the size the backend transforms by its own kernels, e.g. the
+   *        2^a 3^b 5^c 7^d sizes of cuFFT. Pad the transformed extents to it to avoid the slow generic kernels.
+   * @param size Size, must not be zero.
+   * @param backend Backend.
+   * @return Fast size.
+   */
+  [[nodiscard]] constexpr std::size_t nextFastSize(std::size_t size, Backend backend)
+  {
+    return detail::nextFastSize(size, detail::getFastSizeRule(backend));
+  }
+
+  /**
+   * @brief Get the smallest size greater than or equal to the size all the backends in the mask transform by their own
+   *        kernels.
+   * @param size Size, must not be zero.
+   * @param backendMask Backend mask, must not be empty.
+   * @return Fast size.
+   */
+  [[nodiscard]] constexpr std::size_t nextFastSize(std::size_t size, BackendMask backendMask)
+  {
+    return detail::nextFastSize(size, detail::getFastSizeRule(backendMask));
+  }
+
+  /**
+   * @brief Make the shape with every extent padded to the next fast size of all the backends in the mask. Pass only the
+   *        transformed extents, the batch extents need no padding.
+   * @tparam I Integral type
+   * @tparam shapeExt Shape extent
+   * @tparam paddedShapeExt Fast shape extent
+   * @param shape Shape
+   * @param backendMask Backend mask, must not be empty.
+   * @param paddedShape Fast shape
+   */
+  template<typename I, std::size_t shapeExt, std::size_t paddedShapeExt>
+  constexpr void fastShape(View<I, shapeExt> shape, BackendMask backendMask, Span<I, paddedShapeExt> paddedShape)
+  {
+    static_assert(std::is_integral_v<I>, "I must be an integral type");
+    static_assert((paddedShapeExt == dynamicExtent) ||
+                  (shapeExt == dynamicExtent) ||
+                  (paddedShapeExt == shapeExt), "fast shape and shape must have the same size");
+
+    if (paddedShape.size() != shape.size())
+    {
+      throw std::invalid_argument("fast shape and shape must have the same size");
+    }
+
+    const auto rule = detail::getFastSizeRule(backendMask);
+
+    for (std::size_t i{}; i < shape.size(); ++i)
+    {
+      if (shape[i] <= I{0})
+      {
+        throw std::invalid_argument("shape must contain only positive extents");
+      }
+
+      const auto size = detail::nextFastSize(static_cast<std::size_t>(shape[i]), rule);
+
+      if (size > static_cast<std::size_t>(std::numeric_limits<I>::max()))
+      {
+        throw std::invalid_argument("fast shape extent does not fit the integral type");
+      }
+
+      paddedShape[i] = static_cast<I>(size);
+    }
+  }
+
+  /**
+   * @brief Make the shape with every extent padded to the next fast size of all the backends in the mask.
+   * @tparam I Integral type
+   * @tparam shapeExt Shape extent
+   * @param shape Shape
+   * @param backendMask Backend mask, must not be empty.
+   * @return Fast shape
+   */
+  template<typename I, std::size_t shapeExt>
+  [[nodiscard]] constexpr auto fastShape(View<I, shapeExt> shape, BackendMask backendMask = BackendMask::all)
+    -> AFFT_RET_REQUIRES(AFFT_PARAM(std::array<I, shapeExt>), shapeExt != dynamicRank)
+  {
+    std::array<I, shapeExt> result{};
+
+    fastShape(shape, backendMask, Span<I, shapeExt>{result});
+
+    return result;
+  }
+
+  /**
+   * @brief Make the shape with every extent padded to the next fast size of all the backends in the mask.
+   * @tparam I Integral type
+   * @tparam shapeExt Shape extent
+   * @param shape Shape
+   * @param backendMask Backend mask, must not be empty.
+   * @return Fast shape
+   */
+  template<typename I, std::size_t shapeExt>
+  [[nodiscard]] auto fastShape(View<I, shapeExt> shape, BackendMask backendMask = BackendMask::all)
+    -> AFFT_RET_REQUIRES(AFFT_PARAM(std::vector<I>), shapeExt == dynamicRank)
+  {
+    std::vector<I> result(shape.size());
+
+    fastShape(shape, backendMask, Span<I>{result});
+
+    return result;
+  }
 } // namespace afft
 
 #endif /* AFFT_UTILS_HPP */
@@ -4,6 +4,7 @@
 #include "architecture.hpp"
 #include "backend.hpp"
 #include "common.hpp"
+#include "Plan.hpp"
 #include "transform.hpp"
 
 /**
@@ -23,59 +24,14 @@ try
     return afft_Error_invalidArgument;
   }
 
-  auto create2 = [&](auto cxxTransformParams, auto cxxArchParams)
+  return visitParameters(transformParams, archParams, [&](const auto& cxxTransformParams, auto cxxArchParams)
   {
     auto cxxPlan = afft::makePlan(cxxTransformParams, cxxArchParams);
 
     *planPtr = reinterpret_cast<afft_Plan*>(cxxPlan.release());
     
     return afft_Error_success;
-  };
-
-  auto create1 = [&](auto cxxTransformParams)
-  {
-    const std::size_t shapeRank = cxxTransformParams.shape.size();
-
-    switch (archParams.target)
-    {
-    case afft_Target_cpu:
-      switch (archParams.distribution)
-      {
-      case afft_Distribution_spst:
-        return create2(cxxTransformParams, Convert<afft::spst::cpu::Parameters<>>::fromC(archParams.spstCpu, shapeRank));
-      case afft_Distribution_mpst:
-        return create2(cxxTransformParams, Convert<afft::mpst::cpu::Parameters<>>::fromC(archParams.mpstCpu, shapeRank));
-      default:
-        return afft_Error_invalidArchitectureParameters;
-      }
-    case afft_Target_gpu:
-      switch (archParams.distribution)
-      {
-      case afft_Distribution_spst:
-        return create2(cxxTransformParams, Convert<afft::spst::gpu::Parameters<>>::fromC(archParams.spstGpu, shapeRank));
-      // case afft_Distribution_spmt:
-      //   return create2(cxxTransformParams, Convert<afft::spmt::gpu::Parameters<>>::fromC(archParams.spmtGpu, shapeRank));
-      case afft_Distribution_mpst:
-        return create2(cxxTransformParams, Convert<afft::mpst::gpu::Parameters<>>::fromC(archParams.mpstGpu, shapeRank));
-      default:
-        return afft_Error_invalidArchitectureParameters;
-      }
-    default:
-      return afft_Error_invalidArchitectureParameters;
-    }
-  };
-
-  switch (transformParams.transform)
-  {
-  case afft_Transform_dft:
-    return create1(Convert<afft::dft::Parameters<>>::fromC(transformParams.dft));
-  case afft_Transform_dht:
-    return create1(Convert<afft::dht::Parameters<>>::fromC(transformParams.dht));
-  case afft_Transform_dtt:
-    return create1(Convert<afft::dtt::Parameters<>>::fromC(transformParams.dtt));
-  default:
-    return afft_Error_invalidArgument;
-  }
+  });
 }
 catch (...)
 {
@@ -101,74 +57,17 @@ try
     return afft_Error_invalidArgument;
   }
 
-  if (archParams.target != backendParams.target || archParams.distribution != backendParams.distribution)
-  {
-    return afft_Error_architectureMismatch;
-  }
-
-  auto create2 = [&](auto cxxTransformParams, auto cxxArchParams, auto cxxBackendParams)
+  return visitParameters(transformParams,
+                         archParams,
+                         backendParams,
+                         [&](const auto& cxxTransformParams, auto cxxArchParams, const auto& cxxBackendParams)
   {
     auto cxxPlan = afft::makePlan(cxxTransformParams, cxxArchParams, cxxBackendParams);
 
     *planPtr = reinterpret_cast<afft_Plan*>(cxxPlan.release());
 
     return afft_Error_success;
-  };
-
-  auto create1 = [&](auto cxxTransformParams)
-  {
-    const std::size_t shapeRank = cxxTransformParams.shape.size();
-
-    switch (archParams.target)
-    {
-    case afft_Target_cpu:
-      switch (archParams.distribution)
-      {
-      case afft_Distribution_spst:
-        return create2(cxxTransformParams,
-                       Convert<afft::spst::cpu::Parameters<>>::fromC(archParams.spstCpu, shapeRank),
-                       Convert<afft::spst::cpu::BackendParameters>::fromC(backendParams.spstCpu));
-      case afft_Distribution_mpst:
-        return create2(cxxTransformParams,
-                       Convert<afft::mpst::cpu::Parameters<>>::fromC(archParams.mpstCpu, shapeRank),
-                       Convert<afft::mpst::cpu::BackendParameters>::fromC(backendParams.mpstCpu));
-      default:
-        return afft_Error_invalidArchitectureParameters;
-      }
-    case afft_Target_gpu:
-      switch (archParams.distribution)
-      {
-      case afft_Distribution_spst:
-        return create2(cxxTransformParams,
-                       Convert<afft::spst::gpu::Parameters<>>::fromC(archParams.spstGpu, shapeRank),
-                       Convert<afft::spst::gpu::BackendParameters>::fromC(backendParams.spstGpu));
-      // case afft_Distribution_spmt:
-      //   return create2(cxxTransformParams,
-      //                  Convert<afft::spmt::gpu::Parameters<>>::fromC(archParams.spmtGpu, shapeRank),
-      //                  Convert<afft::spmt::gpu::BackendParameters>::fromC(backendParams.spmtGpu));
-      case afft_Distribution_mpst:
-        return create2(cxxTransformParams,
-                       Convert<afft::mpst::gpu::Parameters<>>::fromC(archParams.mpstGpu, shapeRank),
-                       Convert<afft::mpst::gpu::BackendParameters>::fromC(backendParams.mpstGpu));
-      default:
-        return afft_Error_invalidArchitectureParameters;
-      }
-    default:
-      return afft_Error_invalidArchitectureParameters;
-    }
-  };
-
-  switch (transformParams.transform)
-  {
-  case afft_Transform_dft:
-    return create1(Convert<afft::dft::Parameters<>>::fromC(transformParams.dft));
-  case afft_Transform_dht:
-    return create1(Convert<afft::dht::Parameters<>>::fromC(transformParams.dht));
-  case afft_Transform_dtt:
-    return create1(Convert<afft::dtt::Parameters<>>::fromC(transformParams.dtt));
-  default:
-    return afft_Error_invalidArgument;
-  }
+  });
 }
 catch (...)
 {
@@ -372,6 +271,165 @@ extern "C" afft_Error afft_Plan_getWorkspaceSize(const afft_Plan* plan, size_t*
   return afft_Error_success;
 }
 
+/**
+ * @brief Get the plan execution statistics.
+ * @param plan Plan object.
+ * @param stats Pointer to the statistics variable.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_Plan_getStats(const afft_Plan* plan, afft_PlanStats* stats)
+try
+{
+  if (plan == nullptr)
+  {
+    return afft_Error_invalidPlan;
+  }
+
+  if (stats == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto cxxStats = reinterpret_cast<const afft::Plan*>(plan)->getStats();
+
+  stats->executionCount     = cxxStats.executionCount;
+  stats->totalExecutionTime = cxxStats.totalExecutionTime.count();
+  stats->minExecutionTime   = cxxStats.minExecutionTime.count();
+  stats->maxExecutionTime   = cxxStats.maxExecutionTime.count();
+  stats->planningTime       = cxxStats.planningTime.count();
+  stats->flopsPerExecution  = cxxStats.flopsPerExecution;
+  stats->bytesPerExecution  = cxxStats.bytesPerExecution;
+  stats->cycles             = cxxStats.cycles;
+  stats->instructions       = cxxStats.instructions;
+  stats->llcMisses          = cxxStats.llcMisses;
+  stats->dramBytes          = cxxStats.dramBytes;
+
+  return afft_Error_success;
+}
+catch (afft_Error e)
+{
+  return e;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Get a latency percentile of the plan executions, see afft::LatencyHistogram.
+ * @param plan Plan object.
+ * @param percentile Percentile in range [0, 100], e.g. 99 for the p99 latency.
+ * @param latency Pointer to the latency variable, in seconds.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_Plan_getLatencyPercentile(const afft_Plan* plan, double percentile, double* latency)
+try
+{
+  if (plan == nullptr)
+  {
+    return afft_Error_invalidPlan;
+  }
+
+  if (latency == nullptr || !(percentile >= 0.0 && percentile <= 100.0))
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto histogram = reinterpret_cast<const afft::Plan*>(plan)->getLatencyHistogram();
+
+  *latency = std::chrono::duration<double>{histogram.getPercentile(percentile)}.count();
+
+  return afft_Error_success;
+}
+catch (afft_Error e)
+{
+  return e;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Clear the latency histogram of the plan executions.
+ * @param plan Plan object.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_Plan_resetLatencyHistogram(afft_Plan* plan)
+try
+{
+  if (plan == nullptr)
+  {
+    return afft_Error_invalidPlan;
+  }
+
+  (void)reinterpret_cast<afft::Plan*>(plan)->resetLatencyHistogram();
+
+  return afft_Error_success;
+}
+catch (afft_Error e)
+{
+  return e;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Get the plan memory footprint. The workspace allocated by the plan itself is counted to the target memory.
+ * @param plan Plan object.
+ * @param hostSize Pointer to the host memory size variable.
+ * @param deviceSizes Device memory size array of target count size, may be NULL. Zeroed for cpu plans.
+ * @param workspaceSizes External workspace size array of target count size, may be NULL.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_Plan_getMemoryFootprint(const afft_Plan* plan,
+                                                   size_t*          hostSize,
+                                                   size_t*          deviceSizes,
+                                                   size_t*          workspaceSizes)
+try
+{
+  if (plan == nullptr)
+  {
+    return afft_Error_invalidPlan;
+  }
+
+  if (hostSize == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto cxxPlan     = reinterpret_cast<const afft::Plan*>(plan);
+  const auto targetCount = cxxPlan->getTargetCount();
+  const auto footprint   = cxxPlan->getMemoryFootprint();
+
+  const auto copySizes = [targetCount](const std::vector<std::size_t>& sizes, size_t* dst)
+  {
+    if (dst != nullptr)
+    {
+      for (std::size_t i{}; i < targetCount; ++i)
+      {
+        dst[i] = (i < sizes.size()) ? sizes[i] : 0;
+      }
+    }
+  };
+
+  *hostSize = footprint.hostSize;
+  copySizes(footprint.deviceSizes, deviceSizes);
+  copySizes(footprint.workspaceSizes, workspaceSizes);
+
+  return afft_Error_success;
+}
+catch (afft_Error e)
+{
+  return e;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
 /**
  * @brief Execute a plan.
  * @param plan Plan object.
@@ -441,49 +499,264 @@ try
     return afft_Error_invalidArgument;
   }
 
-  auto execute = [&](auto cxxExecParams)
-  {
-    afft::Plan* cxxPlan = reinterpret_cast<afft::Plan*>(plan);
+  afft::Plan* cxxPlan = reinterpret_cast<afft::Plan*>(plan);
 
-    const auto& desc = afft::detail::DescGetter::get(*cxxPlan);
+  const auto& desc = afft::detail::DescGetter::get(*cxxPlan);
 
-    const auto [srcBufferCount, dstBufferCount] = desc.getSrcDstBufferCount();
+  const auto [srcBufferCount, dstBufferCount] = desc.getSrcDstBufferCount();
 
+  return visitExecutionParameters(execParams, [&](const auto& cxxExecParams)
+  {
     cxxPlan->executeUnsafe(afft::View<void*>{src, srcBufferCount},
                            afft::View<void*>{dst, dstBufferCount},
                            cxxExecParams);
 
     return afft_Error_success;
-  };
+  });
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Execute a plan for a batch of unrelated buffers.
+ * @param plan Plan object.
+ * @param batchSize Number of the source and destination buffers.
+ * @param srcs Source buffer array of batchSize size.
+ * @param dsts Destination buffer array of batchSize size.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_Plan_executeBatch(afft_Plan* plan, size_t batchSize, void* const* srcs, void* const* dsts)
+try
+{
+  if (plan == nullptr)
+  {
+    return afft_Error_invalidPlan;
+  }
 
-  switch (execParams.target)
+  if (batchSize > 0 && (srcs == nullptr || dsts == nullptr))
   {
-  case afft_Target_cpu:
-    switch (execParams.distribution)
+    return afft_Error_invalidArgument;
+  }
+
+  afft::Plan* cxxPlan = reinterpret_cast<afft::Plan*>(plan);
+
+  cxxPlan->executeBatch(afft::View<void*>{srcs, batchSize}, afft::View<void*>{dsts, batchSize});
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Execute a plan for a batch of unrelated buffers with parameters.
+ * @param plan Plan object.
+ * @param batchSize Number of the source and destination buffers.
+ * @param srcs Source buffer array of batchSize size.
+ * @param dsts Destination buffer array of batchSize size.
+ * @param execParams Execution parameters.
+ * @return Error code.
+ */
+extern "C" afft_Error _afft_Plan_executeBatchWithParameters(afft_Plan*               plan,
+                                                            size_t                   batchSize,
+                                                            void* const*             srcs,
+                                                            void* const*             dsts,
+                                                            afft_ExecutionParameters execParams)
+try
+{
+  if (plan == nullptr)
+  {
+    return afft_Error_invalidPlan;
+  }
+
+  if (batchSize > 0 && (srcs == nullptr || dsts == nullptr))
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  afft::Plan* cxxPlan = reinterpret_cast<afft::Plan*>(plan);
+
+  return visitExecutionParameters(execParams, [&](const auto& cxxExecParams)
+  {
+    using ExecParamsT = std::decay_t<decltype(cxxExecParams)>;
+
+    if constexpr (ExecParamsT::distribution == afft::Distribution::spst)
+    {
+      cxxPlan->executeBatch(afft::View<void*>{srcs, batchSize}, afft::View<void*>{dsts, batchSize}, cxxExecParams);
+
+      return afft_Error_success;
+    }
+    else
     {
-    case afft_Distribution_spst:
-      return execute(Convert<afft::spst::cpu::ExecutionParameters>::fromC(execParams.spstCpu));
-    case afft_Distribution_mpst:
-      return execute(Convert<afft::mpst::cpu::ExecutionParameters>::fromC(execParams.mpstCpu));
-    default:
       return afft_Error_invalidExecutionParameters;
     }
-  case afft_Target_gpu:
-    switch (execParams.distribution)
+  });
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Execute a spst cpu plan asynchronously on the afft executor thread pool.
+ * @param plan Plan object.
+ * @param src Source data pointer array (x2 if planar complex).
+ * @param dst Destination data pointer array (x2 if planar complex).
+ * @param execParams Execution parameters, may be NULL.
+ * @param callback Completion callback, may be NULL.
+ * @param userData User data passed to the callback.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_Plan_executeAsync(afft_Plan*                               plan,
+                                             void* const*                             src,
+                                             void* const*                             dst,
+                                             const afft_spst_cpu_ExecutionParameters* execParams,
+                                             afft_Plan_CompletionCallback             callback,
+                                             void*                                    userData)
+try
+{
+  if (plan == nullptr)
+  {
+    return afft_Error_invalidPlan;
+  }
+
+  if (src == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  if (dst == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  afft::Plan* cxxPlan = reinterpret_cast<afft::Plan*>(plan);
+
+  if (cxxPlan->getTarget() != afft::Target::cpu || cxxPlan->getDistribution() != afft::Distribution::spst)
+  {
+    return afft_Error_invalidPlan;
+  }
+
+  const auto cxxExecParams = (execParams != nullptr)
+    ? Convert<afft::spst::cpu::ExecutionParameters>::fromC(*execParams)
+    : afft::spst::cpu::ExecutionParameters{};
+
+  const auto& desc = afft::detail::DescGetter::get(*cxxPlan);
+
+  const auto [srcBufferCount, dstBufferCount] = desc.getSrcDstBufferCount();
+
+  std::vector<void*> srcBuffers(src, src + srcBufferCount);
+  std::vector<void*> dstBuffers(dst, dst + dstBufferCount);
+
+  auto task = [=, srcBuffers = std::move(srcBuffers), dstBuffers = std::move(dstBuffers)]
+  {
+    afft_Error error{afft_Error_success};
+
+    try
+    {
+      cxxPlan->executeUnsafe(afft::View<void*>{srcBuffers}, afft::View<void*>{dstBuffers}, cxxExecParams);
+    }
+    catch (...)
+    {
+      error = afft_Error_internal;
+    }
+
+    if (callback != nullptr)
+    {
+      callback(error, userData);
+    }
+  };
+
+  (void)afft::detail::getExecutorThreadPool().submit(std::move(task));
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/// @brief Bound executor structure holding the executor of a spst cpu or gpu plan.
+struct _afft_BoundExecutor
+{
+  std::variant<afft::Plan::BoundExecutor<void, void, afft::spst::cpu::ExecutionParameters>,
+               afft::Plan::BoundExecutor<void, void, afft::spst::gpu::ExecutionParameters>> executor;
+};
+
+/**
+ * @brief Bind a plan to execution parameters.
+ * @param plan Plan object.
+ * @param execParams Execution parameters.
+ * @param executorPtr Pointer to the bound executor.
+ * @return Error code.
+ */
+extern "C" afft_Error _afft_Plan_bind(afft_Plan*               plan,
+                                      afft_ExecutionParameters execParams,
+                                      afft_BoundExecutor**     executorPtr)
+try
+{
+  if (plan == nullptr)
+  {
+    return afft_Error_invalidPlan;
+  }
+
+  if (executorPtr == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  afft::Plan* cxxPlan = reinterpret_cast<afft::Plan*>(plan);
+
+  return visitExecutionParameters(execParams, [&](const auto& cxxExecParams)
+  {
+    using ExecParamsT = std::decay_t<decltype(cxxExecParams)>;
+
+    if constexpr (ExecParamsT::distribution == afft::Distribution::spst)
+    {
+      *executorPtr = new _afft_BoundExecutor{cxxPlan->bind<void, void>(cxxExecParams)};
+
+      return afft_Error_success;
+    }
+    else
     {
-    case afft_Distribution_spst:
-      return execute(Convert<afft::spst::gpu::ExecutionParameters>::fromC(execParams.spstGpu));
-    // case afft_Distribution_spmt:
-    //   return execute(Convert<afft::spmt::gpu::ExecutionParameters>::fromC(execParams.spmtGpu));
-    case afft_Distribution_mpst:
-      return execute(Convert<afft::mpst::gpu::ExecutionParameters>::fromC(execParams.mpstGpu));
-    default:
       return afft_Error_invalidExecutionParameters;
     }
-  default:
-    return afft_Error_invalidExecutionParameters;
+  });
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Destroy a bound executor.
+ * @param executor Bound executor.
+ */
+extern "C" void afft_BoundExecutor_destroy(afft_BoundExecutor* executor)
+{
+  delete executor;
+}
+
+/**
+ * @brief Execute the bound plan.
+ * @param executor Bound executor.
+ * @param src Source buffer.
+ * @param dst Destination buffer.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_BoundExecutor_execute(const afft_BoundExecutor* executor, void* src, void* dst)
+try
+{
+  if (executor == nullptr)
+  {
+    return afft_Error_invalidArgument;
   }
 
+  std::visit([&](const auto& boundExecutor) { boundExecutor(src, dst); }, executor->executor);
+
   return afft_Error_success;
 }
 catch (...)
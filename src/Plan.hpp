@@ -0,0 +1,211 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef PLAN_HPP
+#define PLAN_HPP
+
+#include <afft/afft.h>
+#include <afft/afft.hpp>
+
+#include "architecture.hpp"
+#include "backend.hpp"
+#include "common.hpp"
+#include "transform.hpp"
+
+/**
+ * @brief Convert the C transform and architecture parameters and call a function with the C++ parameters.
+ * @tparam FnT Function type, returns afft_Error.
+ * @param transformParams Transform parameters.
+ * @param archParams Architecture parameters.
+ * @param fn Function called with the C++ transform and architecture parameters.
+ * @return Error code.
+ */
+template<typename FnT>
+[[nodiscard]] afft_Error visitParameters(afft_TransformParameters    transformParams,
+                                         afft_ArchitectureParameters archParams,
+                                         FnT&&                       fn)
+{
+  auto visitArch = [&](auto cxxTransformParams)
+  {
+    const std::size_t shapeRank = cxxTransformParams.shape.size();
+
+    switch (archParams.target)
+    {
+    case afft_Target_cpu:
+      switch (archParams.distribution)
+      {
+      case afft_Distribution_spst:
+        return fn(cxxTransformParams, Convert<afft::spst::cpu::Parameters<>>::fromC(archParams.spstCpu, shapeRank));
+      case afft_Distribution_mpst:
+        return fn(cxxTransformParams, Convert<afft::mpst::cpu::Parameters<>>::fromC(archParams.mpstCpu, shapeRank));
+      default:
+        return afft_Error_invalidArchitectureParameters;
+      }
+    case afft_Target_gpu:
+      switch (archParams.distribution)
+      {
+      case afft_Distribution_spst:
+        return fn(cxxTransformParams, Convert<afft::spst::gpu::Parameters<>>::fromC(archParams.spstGpu, shapeRank));
+      // case afft_Distribution_spmt:
+      //   return fn(cxxTransformParams, Convert<afft::spmt::gpu::Parameters<>>::fromC(archParams.spmtGpu, shapeRank));
+      case afft_Distribution_mpst:
+        return fn(cxxTransformParams, Convert<afft::mpst::gpu::Parameters<>>::fromC(archParams.mpstGpu, shapeRank));
+      default:
+        return afft_Error_invalidArchitectureParameters;
+      }
+    default:
+      return afft_Error_invalidArchitectureParameters;
+    }
+  };
+
+  switch (transformParams.transform)
+  {
+  case afft_Transform_dft:
+    return visitArch(Convert<afft::dft::Parameters<>>::fromC(transformParams.dft));
+  case afft_Transform_dht:
+    return visitArch(Convert<afft::dht::Parameters<>>::fromC(transformParams.dht));
+  case afft_Transform_dtt:
+    return visitArch(Convert<afft::dtt::Parameters<>>::fromC(transformParams.dtt));
+  default:
+    return afft_Error_invalidArgument;
+  }
+}
+
+/**
+ * @brief Convert the C transform, architecture and backend parameters and call a function with the C++ parameters.
+ * @tparam FnT Function type, returns afft_Error.
+ * @param transformParams Transform parameters.
+ * @param archParams Architecture parameters.
+ * @param backendParams Backend parameters.
+ * @param fn Function called with the C++ transform, architecture and backend parameters.
+ * @return Error code.
+ */
+template<typename FnT>
+[[nodiscard]] afft_Error visitParameters(afft_TransformParameters    transformParams,
+                                         afft_ArchitectureParameters archParams,
+                                         afft_BackendParameters      backendParams,
+                                         FnT&&                       fn)
+{
+  if (archParams.target != backendParams.target || archParams.distribution != backendParams.distribution)
+  {
+    return afft_Error_architectureMismatch;
+  }
+
+  auto visitArch = [&](auto cxxTransformParams)
+  {
+    const std::size_t shapeRank = cxxTransformParams.shape.size();
+
+    switch (archParams.target)
+    {
+    case afft_Target_cpu:
+      switch (archParams.distribution)
+      {
+      case afft_Distribution_spst:
+        return fn(cxxTransformParams,
+                  Convert<afft::spst::cpu::Parameters<>>::fromC(archParams.spstCpu, shapeRank),
+                  Convert<afft::spst::cpu::BackendParameters>::fromC(backendParams.spstCpu));
+      case afft_Distribution_mpst:
+        return fn(cxxTransformParams,
+                  Convert<afft::mpst::cpu::Parameters<>>::fromC(archParams.mpstCpu, shapeRank),
+                  Convert<afft::mpst::cpu::BackendParameters>::fromC(backendParams.mpstCpu));
+      default:
+        return afft_Error_invalidArchitectureParameters;
+      }
+    case afft_Target_gpu:
+      switch (archParams.distribution)
+      {
+      case afft_Distribution_spst:
+        return fn(cxxTransformParams,
+                  Convert<afft::spst::gpu::Parameters<>>::fromC(archParams.spstGpu, shapeRank),
+                  Convert<afft::spst::gpu::BackendParameters>::fromC(backendParams.spstGpu));
+      // case afft_Distribution_spmt:
+      //   return fn(cxxTransformParams,
+      //             Convert<afft::spmt::gpu::Parameters<>>::fromC(archParams.spmtGpu, shapeRank),
+      //             Convert<afft::spmt::gpu::BackendParameters>::fromC(backendParams.spmtGpu));
+      case afft_Distribution_mpst:
+        return fn(cxxTransformParams,
+                  Convert<afft::mpst::gpu::Parameters<>>::fromC(archParams.mpstGpu, shapeRank),
+                  Convert<afft::mpst::gpu::BackendParameters>::fromC(backendParams.mpstGpu));
+      default:
+        return afft_Error_invalidArchitectureParameters;
+      }
+    default:
+      return afft_Error_invalidArchitectureParameters;
+    }
+  };
+
+  switch (transformParams.transform)
+  {
+  case afft_Transform_dft:
+    return visitArch(Convert<afft::dft::Parameters<>>::fromC(transformParams.dft));
+  case afft_Transform_dht:
+    return visitArch(Convert<afft::dht::Parameters<>>::fromC(transformParams.dht));
+  case afft_Transform_dtt:
+    return visitArch(Convert<afft::dtt::Parameters<>>::fromC(transformParams.dtt));
+  default:
+    return afft_Error_invalidArgument;
+  }
+}
+
+/**
+ * @brief Convert the C execution parameters and call a function with the C++ parameters. The conversion is a plain
+ *        field copy, no allocation or validation is done.
+ * @tparam FnT Function type, returns afft_Error.
+ * @param execParams Execution parameters.
+ * @param fn Function called with the C++ execution parameters.
+ * @return Error code.
+ */
+template<typename FnT>
+[[nodiscard]] afft_Error visitExecutionParameters(const afft_ExecutionParameters& execParams, FnT&& fn)
+{
+  switch (execParams.target)
+  {
+  case afft_Target_cpu:
+    switch (execParams.distribution)
+    {
+    case afft_Distribution_spst:
+      return fn(Convert<afft::spst::cpu::ExecutionParameters>::fromC(execParams.spstCpu));
+    case afft_Distribution_mpst:
+      return fn(Convert<afft::mpst::cpu::ExecutionParameters>::fromC(execParams.mpstCpu));
+    default:
+      return afft_Error_invalidExecutionParameters;
+    }
+  case afft_Target_gpu:
+    switch (execParams.distribution)
+    {
+    case afft_Distribution_spst:
+      return fn(Convert<afft::spst::gpu::ExecutionParameters>::fromC(execParams.spstGpu));
+    // case afft_Distribution_spmt:
+    //   return fn(Convert<afft::spmt::gpu::ExecutionParameters>::fromC(execParams.spmtGpu));
+    case afft_Distribution_mpst:
+      return fn(Convert<afft::mpst::gpu::ExecutionParameters>::fromC(execParams.mpstGpu));
+    default:
+      return afft_Error_invalidExecutionParameters;
+    }
+  default:
+    return afft_Error_invalidExecutionParameters;
+  }
+}
+
+#endif /* PLAN_HPP */
@@ -0,0 +1,469 @@
+/*
+  This file is part of afft library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#include <afft/afft.h>
+#include <afft/afft.hpp>
+
+#include "Plan.hpp"
+
+/// @brief Plan cache object behind the C handle.
+struct _afft_PlanCache
+{
+  afft::PlanCache cache{};      ///< Plan cache.
+  std::mutex      mutex{};      ///< Mutex guarding the cache if thread safe.
+  bool            threadSafe{}; ///< Thread safe flag.
+
+  /**
+   * @brief Lock the cache if it is thread safe.
+   * @return Lock, owns the mutex only if the cache is thread safe.
+   */
+  [[nodiscard]] std::unique_lock<std::mutex> lock()
+  {
+    return (threadSafe) ? std::unique_lock{mutex} : std::unique_lock<std::mutex>{};
+  }
+};
+
+/**
+ * @brief Convert the C maximum size to the C++ maximum size.
+ * @param maxSize C maximum size, 0 for no limit.
+ * @return C++ maximum size.
+ */
+[[nodiscard]] static std::size_t toMaxSize(size_t maxSize)
+{
+  return (maxSize == 0) ? afft::PlanCache::defaultMaxSize : maxSize;
+}
+
+/**
+ * @brief Create a plan cache.
+ * @param maxSize Maximum number of cached plans, 0 for no limit.
+ * @param threadSafe Thread safe flag.
+ * @param cachePtr Pointer to the plan cache.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_PlanCache_create(size_t maxSize, bool threadSafe, afft_PlanCache** cachePtr)
+try
+{
+  if (cachePtr == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  auto cache = std::make_unique<_afft_PlanCache>();
+  cache->cache.setMaxSize(toMaxSize(maxSize));
+  cache->threadSafe = threadSafe;
+
+  *cachePtr = cache.release();
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Destroy a plan cache.
+ * @param cache Plan cache.
+ */
+extern "C" void afft_PlanCache_destroy(afft_PlanCache* cache)
+{
+  delete cache;
+}
+
+/**
+ * @brief Get the number of the cached plans.
+ * @param cache Plan cache.
+ * @param size Pointer to the size variable.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_PlanCache_getSize(afft_PlanCache* cache, size_t* size)
+try
+{
+  if (cache == nullptr || size == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto lock = cache->lock();
+
+  *size = cache->cache.size();
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Set the maximum number of the cached plans.
+ * @param cache Plan cache.
+ * @param maxSize Maximum number of cached plans, 0 for no limit.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_PlanCache_setMaxSize(afft_PlanCache* cache, size_t maxSize)
+try
+{
+  if (cache == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto lock = cache->lock();
+
+  cache->cache.setMaxSize(toMaxSize(maxSize));
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Set the default maximum memory held by the cached plans in each memory domain.
+ * @param cache Plan cache.
+ * @param maxMemorySize Maximum memory size in bytes.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_PlanCache_setMaxMemorySize(afft_PlanCache* cache, size_t maxMemorySize)
+try
+{
+  if (cache == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto lock = cache->lock();
+
+  cache->cache.setMaxMemorySize(maxMemorySize);
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Set the maximum host memory held by the cached plans.
+ * @param cache Plan cache.
+ * @param maxMemorySize Maximum memory size in bytes.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_PlanCache_setMaxHostMemorySize(afft_PlanCache* cache, size_t maxMemorySize)
+try
+{
+  if (cache == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto lock = cache->lock();
+
+  cache->cache.setMaxHostMemorySize(maxMemorySize);
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+#if defined(AFFT_ENABLE_CUDA) || defined(AFFT_ENABLE_HIP)
+/**
+ * @brief Set the maximum memory of a device held by the cached plans.
+ * @param cache Plan cache.
+ * @param device Device.
+ * @param maxMemorySize Maximum memory size in bytes.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_PlanCache_setMaxDeviceMemorySize(afft_PlanCache* cache, int device, size_t maxMemorySize)
+try
+{
+  if (cache == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto lock = cache->lock();
+
+  cache->cache.setMaxDeviceMemorySize(device, maxMemorySize);
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+#endif
+
+/**
+ * @brief Get the plan cache statistics.
+ * @param cache Plan cache.
+ * @param stats Pointer to the statistics variable.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_PlanCache_getStatistics(afft_PlanCache* cache, afft_PlanCacheStatistics* stats)
+try
+{
+  if (cache == nullptr || stats == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto lock = cache->lock();
+
+  const auto cxxStats = cache->cache.statistics();
+
+  stats->hitCount      = cxxStats.hitCount;
+  stats->missCount     = cxxStats.missCount;
+  stats->evictionCount = cxxStats.evictionCount;
+  stats->memorySize    = cxxStats.memorySize;
+  stats->planningTime  = cxxStats.planningTime.count();
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Reset the plan cache statistics.
+ * @param cache Plan cache.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_PlanCache_resetStatistics(afft_PlanCache* cache)
+try
+{
+  if (cache == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto lock = cache->lock();
+
+  cache->cache.resetStatistics();
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Erase all the cached plans.
+ * @param cache Plan cache.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_PlanCache_clear(afft_PlanCache* cache)
+try
+{
+  if (cache == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  const auto lock = cache->lock();
+
+  cache->cache.clear();
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Insert a plan into the cache, the cache takes the ownership of the plan.
+ * @param cache Plan cache.
+ * @param plan Plan.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_PlanCache_insert(afft_PlanCache* cache, afft_Plan* plan)
+try
+{
+  std::unique_ptr<afft::Plan> cxxPlan{reinterpret_cast<afft::Plan*>(plan)};
+
+  if (cache == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  if (!cxxPlan)
+  {
+    return afft_Error_invalidPlan;
+  }
+
+  const auto lock = cache->lock();
+
+  cache->cache.insert(std::move(cxxPlan));
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Find a cached plan for a given transform and architecture.
+ * @param cache Plan cache.
+ * @param transformParams Transform parameters.
+ * @param archParams Architecture parameters.
+ * @param planPtr Pointer to the plan owned by the cache, NULL if not found.
+ * @return Error code.
+ */
+extern "C" afft_Error _afft_PlanCache_find(afft_PlanCache*             cache,
+                                           afft_TransformParameters    transformParams,
+                                           afft_ArchitectureParameters archParams,
+                                           afft_Plan**                 planPtr)
+try
+{
+  if (cache == nullptr || planPtr == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  return visitParameters(transformParams, archParams, [&](const auto& cxxTransformParams, auto cxxArchParams)
+  {
+    const auto lock = cache->lock();
+
+    *planPtr = reinterpret_cast<afft_Plan*>(cache->cache.find(cxxTransformParams, cxxArchParams).get());
+
+    return afft_Error_success;
+  });
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Erase the cached plan for a given transform and architecture.
+ * @param cache Plan cache.
+ * @param transformParams Transform parameters.
+ * @param archParams Architecture parameters.
+ * @return Error code.
+ */
+extern "C" afft_Error _afft_PlanCache_erase(afft_PlanCache*             cache,
+                                            afft_TransformParameters    transformParams,
+                                            afft_ArchitectureParameters archParams)
+try
+{
+  if (cache == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  return visitParameters(transformParams, archParams, [&](const auto& cxxTransformParams, auto cxxArchParams)
+  {
+    const auto lock = cache->lock();
+
+    cache->cache.erase(cxxTransformParams, cxxArchParams);
+
+    return afft_Error_success;
+  });
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Find a cached plan for a given transform and architecture, create and cache it if there is none.
+ * @param cache Plan cache.
+ * @param transformParams Transform parameters.
+ * @param archParams Architecture parameters.
+ * @param planPtr Pointer to the plan owned by the cache.
+ * @return Error code.
+ */
+extern "C" afft_Error _afft_PlanCache_findOrCreate(afft_PlanCache*             cache,
+                                                   afft_TransformParameters    transformParams,
+                                                   afft_ArchitectureParameters archParams,
+                                                   afft_Plan**                 planPtr)
+try
+{
+  if (cache == nullptr || planPtr == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  return visitParameters(transformParams, archParams, [&](const auto& cxxTransformParams, auto cxxArchParams)
+  {
+    const auto lock = cache->lock();
+
+    *planPtr = reinterpret_cast<afft_Plan*>(cache->cache.findOrCreate(cxxTransformParams, cxxArchParams).get());
+
+    return afft_Error_success;
+  });
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Find a cached plan for a given transform and architecture, create it with the backend parameters and cache
+ *        it if there is none.
+ * @param cache Plan cache.
+ * @param transformParams Transform parameters.
+ * @param archParams Architecture parameters.
+ * @param backendParams Backend parameters.
+ * @param planPtr Pointer to the plan owned by the cache.
+ * @return Error code.
+ */
+extern "C" afft_Error _afft_PlanCache_findOrCreateWithBackendParameters(afft_PlanCache*             cache,
+                                                                        afft_TransformParameters    transformParams,
+                                                                        afft_ArchitectureParameters archParams,
+                                                                        afft_BackendParameters      backendParams,
+                                                                        afft_Plan**                 planPtr)
+try
+{
+  if (cache == nullptr || planPtr == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  return visitParameters(transformParams,
+                         archParams,
+                         backendParams,
+                         [&](const auto& cxxTransformParams, auto cxxArchParams, const auto& cxxBackendParams)
+  {
+    const auto lock = cache->lock();
+
+    auto plan = cache->cache.findOrCreate(cxxTransformParams, cxxArchParams, cxxBackendParams);
+
+    *planPtr = reinterpret_cast<afft_Plan*>(plan.get());
+
+    return afft_Error_success;
+  });
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
@@ -127,11 +127,19 @@ struct Convert<afft::spst::cpu::Parameters<shapeExt>>
     }
 
     CxxType cxxValue{};
-    cxxValue.memoryLayout   = Convert<afft::spst::MemoryLayout<shapeExt>>::fromC(cValue.memoryLayout, shapeRank);
-    cxxValue.complexFormat  = Convert<afft::ComplexFormat>::fromC(cValue.complexFormat);
-    cxxValue.preserveSource = cValue.preserveSource;
-    cxxValue.alignment      = Convert<afft::Alignment>::fromC(cValue.alignment);
-    cxxValue.threadLimit    = cValue.threadLimit;
+    cxxValue.memoryLayout        = Convert<afft::spst::MemoryLayout<shapeExt>>::fromC(cValue.memoryLayout, shapeRank);
+    cxxValue.complexFormat       = Convert<afft::ComplexFormat>::fromC(cValue.complexFormat);
+    cxxValue.preserveSource      = cValue.preserveSource;
+    cxxValue.alignment           = Convert<afft::Alignment>::fromC(cValue.alignment);
+    cxxValue.acceptUnaligned     = cValue.acceptUnaligned;
+    cxxValue.unpaddedInPlaceReal = cValue.unpaddedInPlaceReal;
+    cxxValue.threadLimit         = cValue.threadLimit;
+    cxxValue.autoThreadLimit     = cValue.autoThreadLimit;
+    cxxValue.numaSplit           = cValue.numaSplit;
+    cxxValue.hugePagePolicy      = Convert<afft::HugePagePolicy>::fromC(cValue.hugePagePolicy);
+    cxxValue.realtime            = cValue.realtime;
+    cxxValue.memoryBudget        = cValue.memoryBudget;
+    cxxValue.sparseLines         = cValue.sparseLines;
 
     return cxxValue;
   }
@@ -139,11 +147,51 @@ struct Convert<afft::spst::cpu::Parameters<shapeExt>>
   [[nodiscard]] static constexpr CType toC(const CxxType& cxxValue)
   {
     CType cValue{};
-    cValue.memoryLayout   = Convert<afft::spst::MemoryLayout<shapeExt>>::toC(cxxValue.memoryLayout);
-    cValue.complexFormat  = Convert<afft::ComplexFormat>::toC(cxxValue.complexFormat);
-    cValue.preserveSource = cxxValue.preserveSource;
-    cValue.alignment      = Convert<afft::Alignment>::toC(cxxValue.alignment);
-    cValue.threadLimit    = cxxValue.threadLimit;
+    cValue.memoryLayout        = Convert<afft::spst::MemoryLayout<shapeExt>>::toC(cxxValue.memoryLayout);
+    cValue.complexFormat       = Convert<afft::ComplexFormat>::toC(cxxValue.complexFormat);
+    cValue.preserveSource      = cxxValue.preserveSource;
+    cValue.alignment           = Convert<afft::Alignment>::toC(cxxValue.alignment);
+    cValue.acceptUnaligned     = cxxValue.acceptUnaligned;
+    cValue.unpaddedInPlaceReal = cxxValue.unpaddedInPlaceReal;
+    cValue.threadLimit         = cxxValue.threadLimit;
+    cValue.autoThreadLimit     = cxxValue.autoThreadLimit;
+    cValue.numaSplit           = cxxValue.numaSplit;
+    cValue.hugePagePolicy      = Convert<afft::HugePagePolicy>::toC(cxxValue.hugePagePolicy);
+    cValue.realtime            = cxxValue.realtime;
+    cValue.memoryBudget        = cxxValue.memoryBudget;
+    cValue.sparseLines         = cxxValue.sparseLines;
+
+    return cValue;
+  }
+};
+
+template<>
+struct Convert<afft::spst::gpu::Callback>
+  : StructConvertBase<afft::spst::gpu::Callback, afft_spst_gpu_Callback>
+{
+  using typename StructConvertBase<afft::spst::gpu::Callback, afft_spst_gpu_Callback>::CxxType;
+  using typename StructConvertBase<afft::spst::gpu::Callback, afft_spst_gpu_Callback>::CType;
+
+  [[nodiscard]] static constexpr CxxType fromC(const CType& cValue)
+  {
+    CxxType cxxValue{};
+    cxxValue.srcCode      = (cValue.srcCode != nullptr) ? std::string_view{cValue.srcCode} : std::string_view{};
+    cxxValue.functionName = (cValue.functionName != nullptr)
+                              ? std::string_view{cValue.functionName} : std::string_view{};
+    cxxValue.devicePtr    = cValue.devicePtr;
+    cxxValue.callerInfo   = cValue.callerInfo;
+
+    return cxxValue;
+  }
+
+  // The strings are expected to be null-terminated, which holds for the strings owned by the plan description
+  [[nodiscard]] static constexpr CType toC(const CxxType& cxxValue)
+  {
+    CType cValue{};
+    cValue.srcCode      = (!cxxValue.srcCode.empty()) ? cxxValue.srcCode.data() : nullptr;
+    cValue.functionName = (!cxxValue.functionName.empty()) ? cxxValue.functionName.data() : nullptr;
+    cValue.devicePtr    = cxxValue.devicePtr;
+    cValue.callerInfo   = cxxValue.callerInfo;
 
     return cValue;
   }
@@ -178,6 +226,8 @@ struct Convert<afft::spst::gpu::Parameters<shapeExt>>
     cxxValue.context        = cValue.context;
     cxxValue.device         = cValue.device;
 # endif
+    cxxValue.callbacks      = afft::spst::gpu::Callbacks{Convert<afft::spst::gpu::Callback>::fromC(cValue.callbacks.load),
+                                                         Convert<afft::spst::gpu::Callback>::fromC(cValue.callbacks.store)};
 
     return cxxValue;
   }
@@ -196,6 +246,8 @@ struct Convert<afft::spst::gpu::Parameters<shapeExt>>
     cValue.context        = cxxValue.context;
     cValue.device         = cxxValue.device;
 # endif
+    cValue.callbacks      = afft_spst_gpu_Callbacks{Convert<afft::spst::gpu::Callback>::toC(cxxValue.callbacks.load),
+                                                    Convert<afft::spst::gpu::Callback>::toC(cxxValue.callbacks.store)};
 
     return cValue;
   }
@@ -208,14 +260,24 @@ struct Convert<afft::spst::cpu::ExecutionParameters>
   using typename StructConvertBase<afft::spst::cpu::ExecutionParameters, afft_spst_cpu_ExecutionParameters>::CxxType;
   using typename StructConvertBase<afft::spst::cpu::ExecutionParameters, afft_spst_cpu_ExecutionParameters>::CType;
 
-  [[nodiscard]] static constexpr CxxType fromC(const CType&)
+  [[nodiscard]] static constexpr CxxType fromC(const CType& cValue) noexcept
   {
-    return CxxType{};
+    CxxType cxxValue{};
+    cxxValue.batchCount = cValue.batchCount;
+    cxxValue.lineMask   = (cValue.lineMask != nullptr) ? afft::View<bool>{cValue.lineMask, cValue.lineMaskSize}
+                                                       : afft::View<bool>{};
+
+    return cxxValue;
   }
 
-  [[nodiscard]] static constexpr CType toC(const CxxType&)
+  [[nodiscard]] static constexpr CType toC(const CxxType& cxxValue) noexcept
   {
-    return CType{};
+    CType cValue{};
+    cValue.batchCount   = cxxValue.batchCount;
+    cValue.lineMask     = cxxValue.lineMask.data();
+    cValue.lineMaskSize = cxxValue.lineMask.size();
+
+    return cValue;
   }
 };
 
@@ -226,35 +288,56 @@ struct Convert<afft::spst::gpu::ExecutionParameters>
   using typename StructConvertBase<afft::spst::gpu::ExecutionParameters, afft_spst_gpu_ExecutionParameters>::CxxType;
   using typename StructConvertBase<afft::spst::gpu::ExecutionParameters, afft_spst_gpu_ExecutionParameters>::CType;
 
-  [[nodiscard]] static constexpr CxxType fromC([[maybe_unused]] const CType& cValue)
+  [[nodiscard]] static constexpr CxxType fromC([[maybe_unused]] const CType& cValue) noexcept
   {
     CxxType cxxValue{};
 # if defined(AFFT_ENABLE_CUDA)
-    cxxValue.stream       = cValue.stream;
-    cxxValue.workspace    = cValue.workspace;
+    cxxValue.stream                = cValue.stream;
+    cxxValue.workspace             = cValue.workspace;
+    cxxValue.prefetchManagedMemory = cValue.prefetchManagedMemory;
+    cxxValue.adviseManagedMemory   = cValue.adviseManagedMemory;
+    cxxValue.batchCount            = cValue.batchCount;
 # elif defined(AFFT_ENABLE_HIP)
-    cxxValue.stream       = cValue.stream;
-    cxxValue.workspace    = cValue.workspace;
+    cxxValue.stream                = cValue.stream;
+    cxxValue.workspace             = cValue.workspace;
+    cxxValue.prefetchManagedMemory = cValue.prefetchManagedMemory;
+    cxxValue.adviseManagedMemory   = cValue.adviseManagedMemory;
+    cxxValue.batchCount            = cValue.batchCount;
 # elif defined(AFFT_ENABLE_OPENCL)
-    cxxValue.commandQueue = cValue.commandQueue;
-    cxxValue.workspace    = cValue.workspace;
+    cxxValue.commandQueue     = cValue.commandQueue;
+    cxxValue.commandQueues    = afft::View<cl_command_queue>{cValue.commandQueues, cValue.commandQueueCount};
+    cxxValue.waitEvents       = afft::View<cl_event>{cValue.waitEvents, cValue.waitEventCount};
+    cxxValue.completionEvents = afft::Span<cl_event>{cValue.completionEvents, cValue.completionEventCount};
+    cxxValue.workspace        = cValue.workspace;
 # endif
 
     return cxxValue;
   }
 
-  [[nodiscard]] static constexpr CType toC([[maybe_unused]] const CxxType& cxxValue)
+  [[nodiscard]] static constexpr CType toC([[maybe_unused]] const CxxType& cxxValue) noexcept
   {
     CType cValue{};
 # if defined(AFFT_ENABLE_CUDA)
-    cValue.stream       = cxxValue.stream;
-    cValue.workspace    = cxxValue.workspace;
+    cValue.stream                = cxxValue.stream;
+    cValue.workspace             = cxxValue.workspace;
+    cValue.prefetchManagedMemory = cxxValue.prefetchManagedMemory;
+    cValue.adviseManagedMemory   = cxxValue.adviseManagedMemory;
+    cValue.batchCount            = cxxValue.batchCount;
 # elif defined(AFFT_ENABLE_HIP)
-    cValue.stream       = cxxValue.stream;
-    cValue.workspace    = cxxValue.workspace;
+    cValue.stream                = cxxValue.stream;
+    cValue.workspace             = cxxValue.workspace;
+    cValue.prefetchManagedMemory = cxxValue.prefetchManagedMemory;
+    cValue.adviseManagedMemory   = cxxValue.adviseManagedMemory;
+    cValue.batchCount            = cxxValue.batchCount;
 # elif defined(AFFT_ENABLE_OPENCL)
-    cValue.commandQueue = cxxValue.commandQueue;
-    cValue.workspace    = cxxValue.workspace;
+    cValue.commandQueue         = cxxValue.commandQueue;
+    cValue.commandQueueCount    = cxxValue.commandQueues.size();
+    cValue.commandQueues        = cxxValue.commandQueues.data();
+    cValue.waitEventCount       = cxxValue.waitEvents.size();
+    cValue.waitEvents           = cxxValue.waitEvents.data();
+    cValue.completionEventCount = cxxValue.completionEvents.size();
+    cValue.completionEvents     = cxxValue.completionEvents.data();
+    cValue.workspace            = cxxValue.workspace;
 # endif
 
     return cValue;
@@ -368,6 +451,7 @@ struct Convert<afft::mpst::gpu::Parameters<shapeExt>>
     cxxValue.memoryLayout   = Convert<afft::mpst::MemoryLayout<shapeExt>>::fromC(cValue.memoryLayout, shapeRank);
     cxxValue.complexFormat  = Convert<afft::ComplexFormat>::fromC(cValue.complexFormat);
     cxxValue.preserveSource = cValue.preserveSource;
+    cxxValue.transport      = Convert<afft::Transport>::fromC(cValue.transport);
 # if defined(AFFT_ENABLE_CUDA)
     cxxValue.device         = cValue.device;
 # elif defined(AFFT_ENABLE_HIP)
@@ -386,6 +470,7 @@ struct Convert<afft::mpst::gpu::Parameters<shapeExt>>
     cValue.memoryLayout   = Convert<afft::mpst::MemoryLayout<shapeExt>>::toC(cxxValue.memoryLayout);
     cValue.complexFormat  = Convert<afft::ComplexFormat>::toC(cxxValue.complexFormat);
     cValue.preserveSource = cxxValue.preserveSource;
+    cValue.transport      = Convert<afft::Transport>::toC(cxxValue.transport);
 # if defined(AFFT_ENABLE_CUDA)
     cValue.device         = cxxValue.device;
 # elif defined(AFFT_ENABLE_HIP)
@@ -406,7 +491,7 @@ struct Convert<afft::mpst::cpu::ExecutionParameters>
   using typename StructConvertBase<afft::mpst::cpu::ExecutionParameters, afft_mpst_cpu_ExecutionParameters>::CxxType;
   using typename StructConvertBase<afft::mpst::cpu::ExecutionParameters, afft_mpst_cpu_ExecutionParameters>::CType;
 
-  [[nodiscard]] static constexpr CxxType fromC(const CType& cValue)
+  [[nodiscard]] static constexpr CxxType fromC(const CType& cValue) noexcept
   {
     CxxType cxxValue{};
     cxxValue.workspace = cValue.workspace;
@@ -414,7 +499,7 @@ struct Convert<afft::mpst::cpu::ExecutionParameters>
     return cxxValue;
   }
 
-  [[nodiscard]] static constexpr CType toC(const CxxType& cxxValue)
+  [[nodiscard]] static constexpr CType toC(const CxxType& cxxValue) noexcept
   {
     CType cValue{};
     cValue.workspace = cxxValue.workspace;
@@ -430,7 +515,7 @@ struct Convert<afft::mpst::gpu::ExecutionParameters>
   using typename StructConvertBase<afft::mpst::gpu::ExecutionParameters, afft_mpst_gpu_ExecutionParameters>::CxxType;
   using typename StructConvertBase<afft::mpst::gpu::ExecutionParameters, afft_mpst_gpu_ExecutionParameters>::CType;
 
-  [[nodiscard]] static constexpr CxxType fromC([[maybe_unused]] const CType& cValue)
+  [[nodiscard]] static constexpr CxxType fromC([[maybe_unused]] const CType& cValue) noexcept
   {
     CxxType cxxValue{};
 # if defined(AFFT_ENABLE_CUDA)
@@ -447,7 +532,7 @@ struct Convert<afft::mpst::gpu::ExecutionParameters>
     return cxxValue;
   }
 
-  [[nodiscard]] static constexpr CType toC([[maybe_unused]] const CxxType& cxxValue)
+  [[nodiscard]] static constexpr CType toC([[maybe_unused]] const CxxType& cxxValue) noexcept
   {
     CType cValue{};
 # if defined(AFFT_ENABLE_CUDA)
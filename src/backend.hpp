@@ -44,6 +44,7 @@ struct Convert<afft::Backend>
   static_assert(afft_Backend_pocketfft == afft::Backend::pocketfft);
   static_assert(afft_Backend_rocfft    == afft::Backend::rocfft);
   static_assert(afft_Backend_vkfft     == afft::Backend::vkfft);
+  static_assert(afft_Backend_codelet   == afft::Backend::codelet);
 };
 
 static_assert(AFFT_BACKEND_COUNT == afft::backendCount);
@@ -60,6 +61,7 @@ struct Convert<afft::SelectStrategy>
 {
   static_assert(afft_SelectStrategy_first == afft::SelectStrategy::first);
   static_assert(afft_SelectStrategy_best  == afft::SelectStrategy::best);
+  static_assert(afft_SelectStrategy_progressive == afft::SelectStrategy::progressive);
 };
 
 template<>
@@ -346,10 +348,12 @@ struct Convert<afft::mpst::cpu::heffte::Parameters>
   [[nodiscard]] static constexpr CxxType fromC(const CType& cValue)
   {
     CxxType cxxValue{};
-    cxxValue.backend     = Convert<afft::heffte::cpu::Backend>::fromC(cValue.backend);
-    cxxValue.useReorder  = cValue.useReorder;
-    cxxValue.useAllToAll = cValue.useAllToAll;
-    cxxValue.usePencils  = cValue.usePencils;
+    cxxValue.backend            = Convert<afft::heffte::cpu::Backend>::fromC(cValue.backend);
+    cxxValue.useReorder         = cValue.useReorder;
+    cxxValue.useAllToAll        = cValue.useAllToAll;
+    cxxValue.usePencils         = cValue.usePencils;
+    cxxValue.pipelineChunkCount = cValue.pipelineChunkCount;
+    cxxValue.autoSelect         = cValue.autoSelect;
 
     return cxxValue;
   }
@@ -362,10 +366,12 @@ struct Convert<afft::mpst::cpu::heffte::Parameters>
   [[nodiscard]] static constexpr CType toC(const CxxType& cxxValue)
   {
     CType cValue{};
-    cValue.backend     = Convert<afft::heffte::cpu::Backend>::toC(cxxValue.backend);
-    cValue.useReorder  = cxxValue.useReorder;
-    cValue.useAllToAll = cxxValue.useAllToAll;
-    cValue.usePencils  = cxxValue.usePencils;
+    cValue.backend            = Convert<afft::heffte::cpu::Backend>::toC(cxxValue.backend);
+    cValue.useReorder         = cxxValue.useReorder;
+    cValue.useAllToAll        = cxxValue.useAllToAll;
+    cValue.usePencils         = cxxValue.usePencils;
+    cValue.pipelineChunkCount = cxxValue.pipelineChunkCount;
+    cValue.autoSelect         = cxxValue.autoSelect;
 
     return cValue;
   }
@@ -408,6 +414,60 @@ struct Convert<afft::mpst::gpu::heffte::Parameters>
   }
 };
 
+template<>
+struct Convert<afft::spst::gpu::vkfft::Parameters>
+  : StructConvertBase<afft::spst::gpu::vkfft::Parameters, afft_spst_gpu_vkfft_Parameters>
+{
+  /**
+   * @brief Convert from C to C++.
+   * @param cValue C struct value.
+   * @return C++ struct value.
+   */
+  [[nodiscard]] static constexpr CxxType fromC(const CType& cValue)
+  {
+    CxxType cxxValue{};
+    cxxValue.coalescedMemory        = cValue.coalescedMemory;
+    cxxValue.numSharedBanks         = cValue.numSharedBanks;
+    cxxValue.sharedMemorySize       = cValue.sharedMemorySize;
+    cxxValue.maxThreadsNum          = cValue.maxThreadsNum;
+    cxxValue.warpSize               = cValue.warpSize;
+    cxxValue.cacheDirectory         = (cValue.cacheDirectory != nullptr)
+                                        ? std::string_view{cValue.cacheDirectory} : std::string_view{};
+    cxxValue.registerBoost          = cValue.registerBoost;
+    cxxValue.performBandwidthBoost  = cValue.performBandwidthBoost;
+    cxxValue.useLUT                 = cValue.useLUT;
+    cxxValue.aimThreads             = cValue.aimThreads;
+    cxxValue.disableReorderFourStep = cValue.disableReorderFourStep;
+    cxxValue.fixMaxRadixBefore87    = cValue.fixMaxRadixBefore87;
+
+    return cxxValue;
+  }
+
+  /**
+   * @brief Convert from C++ to C.
+   * @param cxxValue C++ struct value.
+   * @return C struct value.
+   */
+  [[nodiscard]] static constexpr CType toC(const CxxType& cxxValue)
+  {
+    CType cValue{};
+    cValue.coalescedMemory        = cxxValue.coalescedMemory;
+    cValue.numSharedBanks         = cxxValue.numSharedBanks;
+    cValue.sharedMemorySize       = cxxValue.sharedMemorySize;
+    cValue.maxThreadsNum          = cxxValue.maxThreadsNum;
+    cValue.warpSize               = cxxValue.warpSize;
+    cValue.cacheDirectory         = (!cxxValue.cacheDirectory.empty()) ? cxxValue.cacheDirectory.data() : nullptr;
+    cValue.registerBoost          = cxxValue.registerBoost;
+    cValue.performBandwidthBoost  = cxxValue.performBandwidthBoost;
+    cValue.useLUT                 = cxxValue.useLUT;
+    cValue.aimThreads             = cxxValue.aimThreads;
+    cValue.disableReorderFourStep = cxxValue.disableReorderFourStep;
+    cValue.fixMaxRadixBefore87    = cxxValue.fixMaxRadixBefore87;
+
+    return cValue;
+  }
+};
+
 template<>
 struct Convert<afft::spst::cpu::BackendParameters>
   : StructConvertBase<afft::spst::cpu::BackendParameters, afft_spst_cpu_BackendParameters>
@@ -489,6 +549,7 @@ struct Convert<afft::spst::gpu::BackendParameters>
     cxxValue.order    = afft::View<afft::Backend>{reinterpret_cast<const afft::Backend*>(cValue.order), cValue.orderSize};
     cxxValue.clfft    = Convert<afft::spst::gpu::clfft::Parameters>::fromC(cValue.clfft);
     cxxValue.cufft    = Convert<afft::spst::gpu::cufft::Parameters>::fromC(cValue.cufft);
+    cxxValue.vkfft    = Convert<afft::spst::gpu::vkfft::Parameters>::fromC(cValue.vkfft);
 
     if (cValue.orderSize > 0 && cValue.order == nullptr)
     {
@@ -520,6 +581,7 @@ struct Convert<afft::spst::gpu::BackendParameters>
     cValue.order     = reinterpret_cast<const afft_Backend*>(cxxValue.order.data());
     cValue.clfft     = Convert<afft::spst::gpu::clfft::Parameters>::toC(cxxValue.clfft);
     cValue.cufft     = Convert<afft::spst::gpu::cufft::Parameters>::toC(cxxValue.cufft);
+    cValue.vkfft     = Convert<afft::spst::gpu::vkfft::Parameters>::toC(cxxValue.vkfft);
 
     if (cValue.orderSize > 0 && cValue.order == nullptr)
     {
@@ -83,6 +83,28 @@ struct Convert<afft::Complexity>
   static_assert(afft_Complexity_complex == afft::Complexity::complex);
 };
 
+// HugePagePolicy
+template<>
+struct Convert<afft::HugePagePolicy>
+  : EnumConvertBase<afft::HugePagePolicy, afft_HugePagePolicy, afft_Error_invalidHugePagePolicy>
+{
+  static_assert(afft_HugePagePolicy_none        == afft::HugePagePolicy::none);
+  static_assert(afft_HugePagePolicy_transparent == afft::HugePagePolicy::transparent);
+  static_assert(afft_HugePagePolicy_huge2MiB    == afft::HugePagePolicy::huge2MiB);
+  static_assert(afft_HugePagePolicy_huge1GiB    == afft::HugePagePolicy::huge1GiB);
+};
+
+// Transport
+template<>
+struct Convert<afft::Transport>
+  : EnumConvertBase<afft::Transport, afft_Transport, afft_Error_invalidTransport>
+{
+  static_assert(afft_Transport_automatic  == afft::Transport::automatic);
+  static_assert(afft_Transport_hostStaged == afft::Transport::hostStaged);
+  static_assert(afft_Transport_gpuAware   == afft::Transport::gpuAware);
+  static_assert(afft_Transport_nccl       == afft::Transport::nccl);
+};
+
 // ComplexFormat
 template<>
 struct Convert<afft::ComplexFormat>
@@ -112,6 +134,7 @@ struct Convert<afft::Placement>
   static_assert(afft_Placement_outOfPlace == afft::Placement::outOfPlace);
 
   static_assert(afft_Placement_notInPlace == afft::Placement::notInPlace);
+  static_assert(afft_Placement_automatic  == afft::Placement::automatic);
 };
 
 // Transform
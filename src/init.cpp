@@ -25,6 +25,8 @@
 #include <afft/afft.h>
 #include <afft/afft.hpp>
 
+#include "backend.hpp"
+
 /// @brief Initialize the library
 extern "C" afft_Error afft_init()
 try
@@ -37,6 +39,22 @@ catch (...)
   return afft_Error_internal;
 }
 
+/**
+ * @brief Initialize the library and the selected backends eagerly.
+ * @param backendMask Backends to initialize immediately.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_initBackends(afft_BackendMask backendMask)
+try
+{
+  afft::init(Convert<afft::BackendMask>::fromC(backendMask));
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
 /// @brief Finalize the library
 extern "C" afft_Error afft_finalize()
 try
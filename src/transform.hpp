@@ -64,6 +64,21 @@ struct Convert<afft::dft::Parameters<shapeRank, transformRank>>
     cxxType.placement     = Convert<afft::Placement>::fromC(cType.placement);
     cxxType.type          = Convert<afft::dft::Type>::fromC(cType.type);
 
+    if (cType.logicalSrcShape != nullptr)
+    {
+      cxxType.logicalSrcShape = afft::View<std::size_t>{cType.logicalSrcShape, cType.shapeRank};
+    }
+
+    if (cType.dstWindowStart != nullptr)
+    {
+      cxxType.dstWindowStart = afft::View<std::size_t>{cType.dstWindowStart, cType.shapeRank};
+    }
+
+    if (cType.dstWindowShape != nullptr)
+    {
+      cxxType.dstWindowShape = afft::View<std::size_t>{cType.dstWindowShape, cType.shapeRank};
+    }
+
     if (cType.shapeRank > 0 && cType.shape == nullptr)
     {
       throw afft_Error_invalidShape;
@@ -95,6 +110,10 @@ struct Convert<afft::dft::Parameters<shapeRank, transformRank>>
     cType.placement     = Convert<afft::Placement>::toC(cxxType.placement);
     cType.type          = Convert<afft::dft::Type>::toC(cxxType.type);
 
+    cType.logicalSrcShape = (cxxType.logicalSrcShape.empty()) ? nullptr : cxxType.logicalSrcShape.data();
+    cType.dstWindowStart  = (cxxType.dstWindowStart.empty()) ? nullptr : cxxType.dstWindowStart.data();
+    cType.dstWindowShape  = (cxxType.dstWindowShape.empty()) ? nullptr : cxxType.dstWindowShape.data();
+
     if (cType.shapeRank > 0 && cType.shape == nullptr)
     {
       throw afft_Error_internal;
@@ -114,7 +133,8 @@ template<>
 struct Convert<afft::dht::Type>
   : EnumConvertBase<afft::dht::Type, afft_dht_Type, afft_Error_invalidDhtType>
 {
-  static_assert(afft::dht::Type::separable == afft_dht_Type_separable);
+  static_assert(afft::dht::Type::separable    == afft_dht_Type_separable);
+  static_assert(afft::dht::Type::nonSeparable == afft_dht_Type_nonSeparable);
 };
 
 template<std::size_t shapeRank, std::size_t transformRank>
@@ -25,6 +25,8 @@
 #include <afft/afft.h>
 #include <afft/afft.hpp>
 
+#include "backend.hpp"
+
 /**
  * @brief Make strides.
  * @param shapeRank Rank of the shape.
@@ -102,3 +104,88 @@ catch (...)
 {
   return afft_Error_internal;
 }
+
+/**
+ * @brief Get the smallest size greater than or equal to the size all the backends in the mask transform by their own
+ *        kernels.
+ * @param size Size, must not be zero.
+ * @param backendMask Backend mask, must not be empty. A single backend may be passed as its mask.
+ * @param fastSize Fast size.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_nextFastSize(const size_t           size,
+                                        const afft_BackendMask backendMask,
+                                        size_t*                fastSize)
+try
+{
+  if (size == 0)
+  {
+    return afft_Error_invalidShape;
+  }
+
+  if (backendMask == afft_BackendMask_empty)
+  {
+    return afft_Error_invalidBackend;
+  }
+
+  if (fastSize == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  *fastSize = afft::nextFastSize(size, Convert<afft::BackendMask>::fromC(backendMask));
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}
+
+/**
+ * @brief Make the shape with every extent padded to the next fast size of all the backends in the mask.
+ * @param shapeRank Rank of the shape.
+ * @param shape Shape of the transformed extents.
+ * @param backendMask Backend mask, must not be empty.
+ * @param fastShape Fast shape.
+ * @return Error code.
+ */
+extern "C" afft_Error afft_fastShape(const size_t           shapeRank,
+                                     const size_t*          shape,
+                                     const afft_BackendMask backendMask,
+                                     size_t*                fastShape)
+try
+{
+  if (shapeRank > 0 && shape == nullptr)
+  {
+    return afft_Error_invalidShape;
+  }
+
+  if (shapeRank > 0 && fastShape == nullptr)
+  {
+    return afft_Error_invalidArgument;
+  }
+
+  if (backendMask == afft_BackendMask_empty)
+  {
+    return afft_Error_invalidBackend;
+  }
+
+  for (std::size_t i{}; i < shapeRank; ++i)
+  {
+    if (shape[i] == 0)
+    {
+      return afft_Error_invalidShape;
+    }
+  }
+
+  afft::fastShape(afft::View<std::size_t>{shape, shapeRank},
+                  Convert<afft::BackendMask>::fromC(backendMask),
+                  afft::Span<std::size_t>{fastShape, shapeRank});
+
+  return afft_Error_success;
+}
+catch (...)
+{
+  return afft_Error_internal;
+}